@@ -4,6 +4,8 @@
 
 #include "base/allocator/allocator_extension.h"
 
+#include <stdlib.h>
+
 #include "base/logging.h"
 
 namespace base {
@@ -24,6 +26,40 @@ void ReleaseFreeMemory() {
     release_free_memory_function();
 }
 
+void StartHeapProfiling(const char* prefix) {
+  if (thunks::StartHeapProfilingFunction* start_heap_profiling_function =
+          base::allocator::thunks::GetStartHeapProfilingFunction())
+    start_heap_profiling_function(prefix);
+}
+
+void StopHeapProfiling() {
+  if (thunks::StopHeapProfilingFunction* stop_heap_profiling_function =
+          base::allocator::thunks::GetStopHeapProfilingFunction())
+    stop_heap_profiling_function();
+}
+
+bool IsHeapProfilingRunning() {
+  if (thunks::IsHeapProfilingRunningFunction*
+          is_heap_profiling_running_function =
+          base::allocator::thunks::GetIsHeapProfilingRunningFunction())
+    return is_heap_profiling_running_function();
+  return false;
+}
+
+bool GetHeapProfile(std::string* profile) {
+  profile->clear();
+  thunks::GetHeapProfileFunction* get_heap_profile_function =
+      base::allocator::thunks::GetGetHeapProfileFunction();
+  if (!get_heap_profile_function || !IsHeapProfilingRunning())
+    return false;
+  char* result = get_heap_profile_function();
+  if (!result)
+    return false;
+  profile->assign(result);
+  free(result);
+  return true;
+}
+
 void SetGetStatsFunction(thunks::GetStatsFunction* get_stats_function) {
   DCHECK_EQ(base::allocator::thunks::GetGetStatsFunction(),
             reinterpret_cast<thunks::GetStatsFunction*>(NULL));
@@ -38,5 +74,38 @@ void SetReleaseFreeMemoryFunction(
       release_free_memory_function);
 }
 
+void SetStartHeapProfilingFunction(
+    thunks::StartHeapProfilingFunction* start_heap_profiling_function) {
+  DCHECK_EQ(base::allocator::thunks::GetStartHeapProfilingFunction(),
+            reinterpret_cast<thunks::StartHeapProfilingFunction*>(NULL));
+  base::allocator::thunks::SetStartHeapProfilingFunction(
+      start_heap_profiling_function);
+}
+
+void SetStopHeapProfilingFunction(
+    thunks::StopHeapProfilingFunction* stop_heap_profiling_function) {
+  DCHECK_EQ(base::allocator::thunks::GetStopHeapProfilingFunction(),
+            reinterpret_cast<thunks::StopHeapProfilingFunction*>(NULL));
+  base::allocator::thunks::SetStopHeapProfilingFunction(
+      stop_heap_profiling_function);
+}
+
+void SetIsHeapProfilingRunningFunction(
+    thunks::IsHeapProfilingRunningFunction*
+        is_heap_profiling_running_function) {
+  DCHECK_EQ(base::allocator::thunks::GetIsHeapProfilingRunningFunction(),
+            reinterpret_cast<thunks::IsHeapProfilingRunningFunction*>(NULL));
+  base::allocator::thunks::SetIsHeapProfilingRunningFunction(
+      is_heap_profiling_running_function);
+}
+
+void SetGetHeapProfileFunction(
+    thunks::GetHeapProfileFunction* get_heap_profile_function) {
+  DCHECK_EQ(base::allocator::thunks::GetGetHeapProfileFunction(),
+            reinterpret_cast<thunks::GetHeapProfileFunction*>(NULL));
+  base::allocator::thunks::SetGetHeapProfileFunction(
+      get_heap_profile_function);
+}
+
 }  // namespace allocator
 }  // namespace base
@@ -6,6 +6,8 @@
 #define BASE_ALLOCATOR_ALLOCATOR_EXTENSION_H
 #pragma once
 
+#include <string>
+
 #include "base/allocator/allocator_extension_thunks.h"
 #include "base/base_export.h"
 #include "build/build_config.h"
@@ -25,6 +27,21 @@ BASE_EXPORT void GetStats(char* buffer, int buffer_length);
 // system.
 BASE_EXPORT void ReleaseFreeMemory();
 
+// Start recording the call sites of live allocations. Profiles are also
+// dumped periodically to files starting with |prefix|, if the process may
+// write to them. Does nothing if the allocator has no heap profiler.
+BASE_EXPORT void StartHeapProfiling(const char* prefix);
+
+// Stop heap profiling and discard the accumulated profile.
+BASE_EXPORT void StopHeapProfiling();
+
+// Returns true between StartHeapProfiling() and StopHeapProfiling().
+BASE_EXPORT bool IsHeapProfilingRunning();
+
+// Writes the allocated bytes and objects of every recorded call site into
+// |profile|, in the format understood by pprof. Returns false, leaving
+// |profile| empty, if heap profiling is not running.
+BASE_EXPORT bool GetHeapProfile(std::string* profile);
 
 // These settings allow specifying a callback used to implement the allocator
 // extension functions.  These are optional, but if set they must only be set
@@ -39,6 +56,18 @@ BASE_EXPORT void SetGetStatsFunction(
 
 BASE_EXPORT void SetReleaseFreeMemoryFunction(
     thunks::ReleaseFreeMemoryFunction* release_free_memory_function);
+
+BASE_EXPORT void SetStartHeapProfilingFunction(
+    thunks::StartHeapProfilingFunction* start_heap_profiling_function);
+
+BASE_EXPORT void SetStopHeapProfilingFunction(
+    thunks::StopHeapProfilingFunction* stop_heap_profiling_function);
+
+BASE_EXPORT void SetIsHeapProfilingRunningFunction(
+    thunks::IsHeapProfilingRunningFunction* is_heap_profiling_running_function);
+
+BASE_EXPORT void SetGetHeapProfileFunction(
+    thunks::GetHeapProfileFunction* get_heap_profile_function);
 }  // namespace allocator
 }  // namespace base
 
@@ -19,6 +19,11 @@ namespace thunks {
 
 static GetStatsFunction* g_get_stats_function = NULL;
 static ReleaseFreeMemoryFunction* g_release_free_memory_function = NULL;
+static StartHeapProfilingFunction* g_start_heap_profiling_function = NULL;
+static StopHeapProfilingFunction* g_stop_heap_profiling_function = NULL;
+static IsHeapProfilingRunningFunction* g_is_heap_profiling_running_function =
+    NULL;
+static GetHeapProfileFunction* g_get_heap_profile_function = NULL;
 
 void SetGetStatsFunction(GetStatsFunction* get_stats_function) {
   g_get_stats_function = get_stats_function;
@@ -37,6 +42,42 @@ ReleaseFreeMemoryFunction* GetReleaseFreeMemoryFunction() {
   return g_release_free_memory_function;
 }
 
+void SetStartHeapProfilingFunction(
+    StartHeapProfilingFunction* start_heap_profiling_function) {
+  g_start_heap_profiling_function = start_heap_profiling_function;
+}
+
+StartHeapProfilingFunction* GetStartHeapProfilingFunction() {
+  return g_start_heap_profiling_function;
+}
+
+void SetStopHeapProfilingFunction(
+    StopHeapProfilingFunction* stop_heap_profiling_function) {
+  g_stop_heap_profiling_function = stop_heap_profiling_function;
+}
+
+StopHeapProfilingFunction* GetStopHeapProfilingFunction() {
+  return g_stop_heap_profiling_function;
+}
+
+void SetIsHeapProfilingRunningFunction(
+    IsHeapProfilingRunningFunction* is_heap_profiling_running_function) {
+  g_is_heap_profiling_running_function = is_heap_profiling_running_function;
+}
+
+IsHeapProfilingRunningFunction* GetIsHeapProfilingRunningFunction() {
+  return g_is_heap_profiling_running_function;
+}
+
+void SetGetHeapProfileFunction(
+    GetHeapProfileFunction* get_heap_profile_function) {
+  g_get_heap_profile_function = get_heap_profile_function;
+}
+
+GetHeapProfileFunction* GetGetHeapProfileFunction() {
+  return g_get_heap_profile_function;
+}
+
 }  // namespace thunks
 }  // namespace allocator
 }  // namespace base
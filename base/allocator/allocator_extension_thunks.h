@@ -23,6 +23,27 @@ void SetReleaseFreeMemoryFunction(
     ReleaseFreeMemoryFunction* release_free_memory_function);
 ReleaseFreeMemoryFunction* GetReleaseFreeMemoryFunction();
 
+typedef void StartHeapProfilingFunction(const char*);
+void SetStartHeapProfilingFunction(
+    StartHeapProfilingFunction* start_heap_profiling_function);
+StartHeapProfilingFunction* GetStartHeapProfilingFunction();
+
+typedef void StopHeapProfilingFunction();
+void SetStopHeapProfilingFunction(
+    StopHeapProfilingFunction* stop_heap_profiling_function);
+StopHeapProfilingFunction* GetStopHeapProfilingFunction();
+
+typedef bool IsHeapProfilingRunningFunction();
+void SetIsHeapProfilingRunningFunction(
+    IsHeapProfilingRunningFunction* is_heap_profiling_running_function);
+IsHeapProfilingRunningFunction* GetIsHeapProfilingRunningFunction();
+
+// Returns a heap profile allocated with malloc(), or NULL.
+typedef char* GetHeapProfileFunction();
+void SetGetHeapProfileFunction(
+    GetHeapProfileFunction* get_heap_profile_function);
+GetHeapProfileFunction* GetGetHeapProfileFunction();
+
 }  // namespace thunks
 }  // namespace allocator
 }  // namespace base
@@ -123,6 +123,22 @@ TEST_F(CallbackTest, Reset) {
   EXPECT_TRUE(callback_a_.Equals(null_callback_));
 }
 
+TEST_F(CallbackTest, Swap) {
+  Callback<void(void)> callback_a2 = callback_a_;
+  Callback<void(void)> other;
+
+  // Swapping with a null callback moves the state over.
+  other.Swap(&callback_a_);
+  EXPECT_TRUE(callback_a_.is_null());
+  EXPECT_TRUE(other.Equals(callback_a2));
+
+  // Swapping two non-null callbacks exchanges them.
+  Callback<void(void)> callback_b2 = callback_b_;
+  other.Swap(&callback_b2);
+  EXPECT_TRUE(other.Equals(callback_b_));
+  EXPECT_TRUE(callback_b2.Equals(callback_a2));
+}
+
 struct TestForReentrancy {
   TestForReentrancy()
       : cb_already_run(false),
@@ -42,6 +42,9 @@ namespace debug {
 // before throwing them away.
 const size_t kTraceEventBufferSize = 500000;
 const size_t kTraceEventBatchSize = 1000;
+// Controls how many events a thread records before moving them to the main
+// buffer, which is the only point where it takes the TraceLog lock.
+const size_t kTraceEventThreadLocalBufferSize = 256;
 
 #define TRACE_EVENT_MAX_CATEGORIES 100
 
@@ -316,6 +319,24 @@ void TraceResultBuffer::Finish() {
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+struct TraceLog::ThreadLocalEventBuffer {
+  explicit ThreadLocalEventBuffer(TraceLog* trace_log)
+      : trace_log(trace_log),
+        in_use(true) {
+    events.reserve(kTraceEventThreadLocalBufferSize);
+  }
+
+  TraceLog* trace_log;
+
+  // Protects |events|.  Only the owning thread adds events, so this lock is
+  // contended only while another thread collects the events.
+  Lock lock;
+  std::vector<TraceEvent> events;
+
+  // False once the owning thread has exited.  Protected by TraceLog::lock_.
+  bool in_use;
+};
+
 // static
 TraceLog* TraceLog::GetInstance() {
   return Singleton<TraceLog, StaticMemorySingletonTraits<TraceLog> >::get();
@@ -323,6 +344,9 @@ TraceLog* TraceLog::GetInstance() {
 
 TraceLog::TraceLog()
     : enabled_(false)
+    , recording_mode_(RECORD_UNTIL_FULL)
+    , ring_head_(0)
+    , thread_local_event_buffer_(&TraceLog::OnThreadExit)
     , dispatching_to_observer_list_(false) {
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
@@ -343,6 +367,10 @@ TraceLog::TraceLog()
 }
 
 TraceLog::~TraceLog() {
+  // Freeing the slot stops exiting threads from calling OnThreadExit with
+  // buffers that are deleted below.
+  thread_local_event_buffer_.Free();
+  STLDeleteElements(&thread_local_event_buffers_);
 }
 
 const unsigned char* TraceLog::GetCategoryEnabled(const char* name) {
@@ -448,6 +476,7 @@ void TraceLog::SetEnabled(const std::vector<std::string>& included_categories,
   dispatching_to_observer_list_ = false;
 
   logged_events_.reserve(1024);
+  ring_head_ = 0;
   enabled_ = true;
   included_categories_ = included_categories;
   excluded_categories_ = excluded_categories;
@@ -512,6 +541,7 @@ void TraceLog::SetDisabled() {
     excluded_categories_.clear();
     for (int i = 0; i < g_category_index; i++)
       g_category_enabled[i] = 0;
+    LinearizeLoggedEventsWhileLocked();
     AddThreadNameMetadataEvents();
     AddClockSyncMetadataEvents();
   }  // release lock
@@ -534,6 +564,13 @@ void TraceLog::RemoveEnabledStateObserver(
   enabled_state_observer_list_.RemoveObserver(listener);
 }
 
+void TraceLog::SetRecordingMode(RecordingMode mode) {
+  AutoLock lock(lock_);
+  DCHECK(!enabled_) << "Cannot change the recording mode while tracing.";
+  if (!enabled_)
+    recording_mode_ = mode;
+}
+
 float TraceLog::GetBufferPercentFull() const {
   return (float)((double)logged_events_.size()/(double)kTraceEventBufferSize);
 }
@@ -549,10 +586,13 @@ void TraceLog::SetBufferFullCallback(const TraceLog::BufferFullCallback& cb) {
 }
 
 void TraceLog::Flush() {
+  CollectThreadLocalEvents();
+
   std::vector<TraceEvent> previous_logged_events;
   OutputCallback output_callback_copy;
   {
     AutoLock lock(lock_);
+    LinearizeLoggedEventsWhileLocked();
     previous_logged_events.swap(logged_events_);
     output_callback_copy = output_callback_;
   }  // release lock
@@ -586,81 +626,191 @@ int TraceLog::AddTraceEvent(char phase,
                             unsigned char flags) {
   DCHECK(name);
   TimeTicks now = TimeTicks::NowFromSystemTraceTime();
-  BufferFullCallback buffer_full_callback_copy;
-  int ret_begin_id = -1;
-  {
+  if (!*category_enabled)
+    return -1;
+
+  int thread_id = static_cast<int>(PlatformThread::CurrentId());
+
+  const char* new_name = PlatformThread::GetName();
+  // Check if the thread name has been set or changed since the previous
+  // call (if any), but don't bother if the new name is empty. Note this will
+  // not detect a thread name change within the same char* buffer address: we
+  // favor common case performance over corner case correctness.
+  if (new_name != g_current_thread_name.Get().Get() &&
+      new_name && *new_name) {
+    g_current_thread_name.Get().Set(new_name);
     AutoLock lock(lock_);
-    if (!*category_enabled)
-      return -1;
-    if (logged_events_.size() >= kTraceEventBufferSize)
-      return -1;
-
-    int thread_id = static_cast<int>(PlatformThread::CurrentId());
-
-    const char* new_name = PlatformThread::GetName();
-    // Check if the thread name has been set or changed since the previous
-    // call (if any), but don't bother if the new name is empty. Note this will
-    // not detect a thread name change within the same char* buffer address: we
-    // favor common case performance over corner case correctness.
-    if (new_name != g_current_thread_name.Get().Get() &&
-        new_name && *new_name) {
-      g_current_thread_name.Get().Set(new_name);
-      base::hash_map<int, std::string>::iterator existing_name =
-          thread_names_.find(thread_id);
-      if (existing_name == thread_names_.end()) {
-        // This is a new thread id, and a new name.
-        thread_names_[thread_id] = new_name;
-      } else {
-        // This is a thread id that we've seen before, but potentially with a
-        // new name.
-        std::vector<base::StringPiece> existing_names;
-        Tokenize(existing_name->second, ",", &existing_names);
-        bool found = std::find(existing_names.begin(),
-                               existing_names.end(),
-                               new_name) != existing_names.end();
-        if (!found) {
-          existing_name->second.push_back(',');
-          existing_name->second.append(new_name);
-        }
+    base::hash_map<int, std::string>::iterator existing_name =
+        thread_names_.find(thread_id);
+    if (existing_name == thread_names_.end()) {
+      // This is a new thread id, and a new name.
+      thread_names_[thread_id] = new_name;
+    } else {
+      // This is a thread id that we've seen before, but potentially with a
+      // new name.
+      std::vector<base::StringPiece> existing_names;
+      Tokenize(existing_name->second, ",", &existing_names);
+      bool found = std::find(existing_names.begin(),
+                             existing_names.end(),
+                             new_name) != existing_names.end();
+      if (!found) {
+        existing_name->second.push_back(',');
+        existing_name->second.append(new_name);
       }
     }
+  }
+
+  if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
+    id ^= process_id_hash_;
+
+  ThreadLocalEventBuffer* buffer = GetThreadLocalEventBuffer();
+  std::vector<TraceEvent> full_events;
+  int ret_begin_id = -1;
+  {
+    AutoLock lock(buffer->lock);
+    std::vector<TraceEvent>& events = buffer->events;
 
     if (threshold_begin_id > -1) {
       DCHECK(phase == TRACE_EVENT_PHASE_END);
       size_t begin_i = static_cast<size_t>(threshold_begin_id);
-      // Return now if there has been a flush since the begin event was posted.
-      if (begin_i >= logged_events_.size())
-        return -1;
-      // Determine whether to drop the begin/end pair.
-      TimeDelta elapsed = now - logged_events_[begin_i].timestamp();
-      if (elapsed < TimeDelta::FromMicroseconds(threshold)) {
-        // Remove begin event and do not add end event.
-        // This will be expensive if there have been other events in the
-        // mean time (should be rare).
-        logged_events_.erase(logged_events_.begin() + begin_i);
-        return -1;
+      // If the begin event has already been moved to the main buffer, keep
+      // the end event so that the pair stays balanced.
+      if (begin_i < events.size() &&
+          events[begin_i].phase() == TRACE_EVENT_PHASE_BEGIN &&
+          strcmp(events[begin_i].name(), name) == 0) {
+        // Determine whether to drop the begin/end pair.
+        TimeDelta elapsed = now - events[begin_i].timestamp();
+        if (elapsed < TimeDelta::FromMicroseconds(threshold)) {
+          // Remove begin event and do not add end event.
+          // This will be expensive if there have been other events in the
+          // mean time (should be rare).
+          events.erase(events.begin() + begin_i);
+          return -1;
+        }
       }
     }
 
-    if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
-      id ^= process_id_hash_;
-
-    ret_begin_id = static_cast<int>(logged_events_.size());
-    logged_events_.push_back(
+    ret_begin_id = static_cast<int>(events.size());
+    events.push_back(
         TraceEvent(thread_id,
                    now, phase, category_enabled, name, id,
                    num_args, arg_names, arg_types, arg_values,
                    flags));
 
-    if (logged_events_.size() == kTraceEventBufferSize) {
-      buffer_full_callback_copy = buffer_full_callback_;
+    if (events.size() >= kTraceEventThreadLocalBufferSize) {
+      full_events.swap(events);
+      events.reserve(kTraceEventThreadLocalBufferSize);
+    }
+  }  // release lock
+
+  if (!full_events.empty())
+    AddEventsToMainBuffer(full_events);
+
+  return ret_begin_id;
+}
+
+TraceLog::ThreadLocalEventBuffer* TraceLog::GetThreadLocalEventBuffer() {
+  ThreadLocalEventBuffer* buffer = static_cast<ThreadLocalEventBuffer*>(
+      thread_local_event_buffer_.Get());
+  if (buffer)
+    return buffer;
+
+  AutoLock lock(lock_);
+  for (size_t i = 0; i < thread_local_event_buffers_.size(); ++i) {
+    if (!thread_local_event_buffers_[i]->in_use) {
+      buffer = thread_local_event_buffers_[i];
+      buffer->in_use = true;
+      break;
+    }
+  }
+  if (!buffer) {
+    buffer = new ThreadLocalEventBuffer(this);
+    thread_local_event_buffers_.push_back(buffer);
+  }
+  thread_local_event_buffer_.Set(buffer);
+  return buffer;
+}
+
+// static
+void TraceLog::OnThreadExit(void* buffer) {
+  ThreadLocalEventBuffer* event_buffer =
+      static_cast<ThreadLocalEventBuffer*>(buffer);
+  event_buffer->trace_log->ReleaseThreadLocalEventBuffer(event_buffer);
+}
+
+void TraceLog::ReleaseThreadLocalEventBuffer(ThreadLocalEventBuffer* buffer) {
+  std::vector<TraceEvent> events;
+  {
+    AutoLock lock(buffer->lock);
+    events.swap(buffer->events);
+    buffer->events.reserve(kTraceEventThreadLocalBufferSize);
+  }
+  if (!events.empty())
+    AddEventsToMainBuffer(events);
+
+  AutoLock lock(lock_);
+  buffer->in_use = false;
+}
+
+void TraceLog::CollectThreadLocalEvents() {
+  std::vector<ThreadLocalEventBuffer*> buffers;
+  {
+    AutoLock lock(lock_);
+    buffers = thread_local_event_buffers_;
+  }
+
+  std::vector<TraceEvent> events;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    AutoLock lock(buffers[i]->lock);
+    events.insert(events.end(),
+                  buffers[i]->events.begin(), buffers[i]->events.end());
+    buffers[i]->events.clear();
+  }
+  if (!events.empty())
+    AddEventsToMainBuffer(events);
+}
+
+void TraceLog::AddEventsToMainBuffer(const std::vector<TraceEvent>& events) {
+  BufferFullCallback buffer_full_callback_copy;
+  {
+    AutoLock lock(lock_);
+    if (recording_mode_ == RECORD_CONTINUOUSLY) {
+      for (size_t i = 0; i < events.size(); ++i) {
+        if (logged_events_.size() < kTraceEventBufferSize) {
+          logged_events_.push_back(events[i]);
+        } else {
+          logged_events_[ring_head_] = events[i];
+          ring_head_ = (ring_head_ + 1) % logged_events_.size();
+        }
+      }
+    } else if (logged_events_.size() < kTraceEventBufferSize) {
+      size_t count = std::min(kTraceEventBufferSize - logged_events_.size(),
+                              events.size());
+      logged_events_.insert(logged_events_.end(),
+                            events.begin(), events.begin() + count);
+      if (logged_events_.size() == kTraceEventBufferSize)
+        buffer_full_callback_copy = buffer_full_callback_;
     }
   }  // release lock
 
   if (!buffer_full_callback_copy.is_null())
     buffer_full_callback_copy.Run();
+}
 
-  return ret_begin_id;
+void TraceLog::LinearizeLoggedEventsWhileLocked() {
+  lock_.AssertAcquired();
+  if (ring_head_ == 0)
+    return;
+  std::rotate(logged_events_.begin(), logged_events_.begin() + ring_head_,
+              logged_events_.end());
+  ring_head_ = 0;
+}
+
+size_t TraceLog::GetEventsSize() {
+  CollectThreadLocalEvents();
+  AutoLock lock(lock_);
+  LinearizeLoggedEventsWhileLocked();
+  return logged_events_.size();
 }
 
 void TraceLog::AddTraceEventEtw(char phase,
@@ -18,6 +18,7 @@
 #include "base/observer_list.h"
 #include "base/string_util.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
 #include "base/timer.h"
 
 // Older style trace macros with explicit id and extra data
@@ -83,6 +84,7 @@ class BASE_EXPORT TraceEvent {
   void AppendAsJSON(std::string* out) const;
 
   TimeTicks timestamp() const { return timestamp_; }
+  char phase() const { return phase_; }
 
   // Exposed for unittesting:
 
@@ -155,6 +157,16 @@ class BASE_EXPORT TraceResultBuffer {
 
 class BASE_EXPORT TraceLog {
  public:
+  // What to do once the trace buffer is full.
+  enum RecordingMode {
+    // Drop new events and notify the BufferFullCallback.  This is the default.
+    RECORD_UNTIL_FULL,
+    // Keep recording, overwriting the oldest events, so that the buffer
+    // always holds the most recent ones.  The BufferFullCallback is never
+    // called in this mode.
+    RECORD_CONTINUOUSLY,
+  };
+
   static TraceLog* GetInstance();
 
   // Get set of known categories. This can change as new code paths are reached.
@@ -212,6 +224,11 @@ class BASE_EXPORT TraceLog {
   void AddEnabledStateObserver(EnabledStateChangedObserver* listener);
   void RemoveEnabledStateObserver(EnabledStateChangedObserver* listener);
 
+  // Sets the recording mode used by the next SetEnabled call.  Must not be
+  // called while tracing is enabled.
+  void SetRecordingMode(RecordingMode mode);
+  RecordingMode recording_mode() const { return recording_mode_; }
+
   float GetBufferPercentFull() const;
 
   // When enough events are collected, they are handed (in bulk) to
@@ -223,9 +240,10 @@ class BASE_EXPORT TraceLog {
       OutputCallback;
   void SetOutputCallback(const OutputCallback& cb);
 
-  // The trace buffer does not flush dynamically, so when it fills up,
-  // subsequent trace events will be dropped. This callback is generated when
-  // the trace buffer is full. The callback must be thread safe.
+  // The trace buffer does not flush dynamically, so when it fills up in
+  // RECORD_UNTIL_FULL mode, subsequent trace events will be dropped. This
+  // callback is generated when the trace buffer is full. The callback must be
+  // thread safe.
   typedef base::Callback<void(void)> BufferFullCallback;
   void SetBufferFullCallback(const BufferFullCallback& cb);
 
@@ -274,10 +292,13 @@ class BASE_EXPORT TraceLog {
   // Allows resurrecting our singleton instance post-AtExit processing.
   static void Resurrect();
 
-  // Allow tests to inspect TraceEvents.
-  size_t GetEventsSize() const { return logged_events_.size(); }
+  // Allow tests to inspect TraceEvents.  GetEventsSize() first moves any
+  // events still held in per-thread buffers into the main buffer, so call it
+  // before GetEventAt().
+  size_t GetEventsSize();
   const TraceEvent& GetEventAt(size_t index) const {
     DCHECK(index < logged_events_.size());
+    DCHECK_EQ(0u, ring_head_);
     return logged_events_[index];
   }
 
@@ -288,19 +309,50 @@ class BASE_EXPORT TraceLog {
   // by the Singleton class.
   friend struct StaticMemorySingletonTraits<TraceLog>;
 
+  // Events are first recorded into a buffer owned by the thread that adds
+  // them, and moved into |logged_events_| in batches.
+  struct ThreadLocalEventBuffer;
+
   TraceLog();
   ~TraceLog();
   const unsigned char* GetCategoryEnabledInternal(const char* name);
   void AddThreadNameMetadataEvents();
   void AddClockSyncMetadataEvents();
 
-  // TODO(nduca): switch to per-thread trace buffers to reduce thread
-  // synchronization.
+  // Returns the calling thread's event buffer, creating or reusing one if the
+  // thread has none yet.
+  ThreadLocalEventBuffer* GetThreadLocalEventBuffer();
+  // Thread local storage destructor; hands an exiting thread's buffer back.
+  static void OnThreadExit(void* buffer);
+  void ReleaseThreadLocalEventBuffer(ThreadLocalEventBuffer* buffer);
+
+  // Moves the events of every thread local buffer into |logged_events_|.
+  // Must be called without |lock_| held.
+  void CollectThreadLocalEvents();
+  // Appends |events| to |logged_events_| according to |recording_mode_|, and
+  // runs the buffer full callback if that filled the buffer.  Must be called
+  // without |lock_| held.
+  void AddEventsToMainBuffer(const std::vector<TraceEvent>& events);
+  // Puts the oldest event back at the front of |logged_events_| after it has
+  // been used as a ring.
+  void LinearizeLoggedEventsWhileLocked();
+
+  // |lock_| protects everything below, but not the contents of the thread
+  // local buffers, which have their own locks.  The two are never held at the
+  // same time.
   Lock lock_;
   bool enabled_;
+  RecordingMode recording_mode_;
   OutputCallback output_callback_;
   BufferFullCallback buffer_full_callback_;
   std::vector<TraceEvent> logged_events_;
+  // In RECORD_CONTINUOUSLY mode, the index of the oldest event once
+  // |logged_events_| has wrapped around.
+  size_t ring_head_;
+  // Every buffer ever handed out.  Buffers of exited threads are reused
+  // rather than deleted, so pointers stay valid for the life of the TraceLog.
+  std::vector<ThreadLocalEventBuffer*> thread_local_event_buffers_;
+  ThreadLocalStorage::Slot thread_local_event_buffer_;
   std::vector<std::string> included_categories_;
   std::vector<std::string> excluded_categories_;
   bool dispatching_to_observer_list_;
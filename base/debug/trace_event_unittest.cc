@@ -1348,6 +1348,68 @@ TEST_F(TraceEventTestFixture, DeepCopy) {
   EXPECT_EQ("val2", s);
 }
 
+void IncrementCount(int* count) {
+  ++*count;
+}
+
+// Adds instant events until the main trace buffer is full, and returns its
+// size.
+size_t FillTraceBuffer() {
+  TraceLog* tracer = TraceLog::GetInstance();
+  while (tracer->GetBufferPercentFull() < 1.0f) {
+    for (int i = 0; i < 1000; ++i)
+      TRACE_EVENT_INSTANT0("cat", "filler");
+    // Move the events out of this thread's buffer.
+    tracer->GetEventsSize();
+  }
+  return tracer->GetEventsSize();
+}
+
+// Test that once the buffer is full, new events are dropped by default.
+TEST_F(TraceEventTestFixture, RecordUntilFull) {
+  ManualTestSetUp();
+  TraceLog* tracer = TraceLog::GetInstance();
+  // Parsing a full buffer of JSON is slow and not what is tested here.
+  tracer->SetOutputCallback(TraceLog::OutputCallback());
+  int buffer_full_count = 0;
+  tracer->SetBufferFullCallback(base::Bind(&IncrementCount,
+                                           &buffer_full_count));
+  EXPECT_EQ(TraceLog::RECORD_UNTIL_FULL, tracer->recording_mode());
+
+  tracer->SetEnabled(true);
+  TRACE_EVENT_INSTANT0("cat", "oldest");
+  size_t full_size = FillTraceBuffer();
+  TRACE_EVENT_INSTANT0("cat", "dropped");
+
+  EXPECT_EQ(full_size, tracer->GetEventsSize());
+  EXPECT_STREQ("oldest", tracer->GetEventAt(0).name());
+  EXPECT_STREQ("filler", tracer->GetEventAt(full_size - 1).name());
+  EXPECT_EQ(1, buffer_full_count);
+  tracer->SetEnabled(false);
+}
+
+// Test that in continuous mode the buffer keeps the most recent events.
+TEST_F(TraceEventTestFixture, RecordContinuously) {
+  ManualTestSetUp();
+  TraceLog* tracer = TraceLog::GetInstance();
+  tracer->SetOutputCallback(TraceLog::OutputCallback());
+  int buffer_full_count = 0;
+  tracer->SetBufferFullCallback(base::Bind(&IncrementCount,
+                                           &buffer_full_count));
+  tracer->SetRecordingMode(TraceLog::RECORD_CONTINUOUSLY);
+
+  tracer->SetEnabled(true);
+  TRACE_EVENT_INSTANT0("cat", "oldest");
+  size_t full_size = FillTraceBuffer();
+  TRACE_EVENT_INSTANT0("cat", "newest");
+
+  EXPECT_EQ(full_size, tracer->GetEventsSize());
+  EXPECT_STREQ("filler", tracer->GetEventAt(0).name());
+  EXPECT_STREQ("newest", tracer->GetEventAt(full_size - 1).name());
+  EXPECT_EQ(0, buffer_full_count);
+  tracer->SetEnabled(false);
+}
+
 // Test that TraceResultBuffer outputs the correct result whether it is added
 // in chunks or added all at once.
 TEST_F(TraceEventTestFixture, TraceResultBuffer) {
@@ -6,6 +6,7 @@
 
 #include "base/file_util.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/json/json_writer.h"
 #include "base/logging.h"
 
 const char* JSONFileValueSerializer::kAccessDenied = "Access denied.";
@@ -23,22 +24,17 @@ bool JSONFileValueSerializer::SerializeAndOmitBinaryValues(const Value& root) {
 
 bool JSONFileValueSerializer::SerializeInternal(const Value& root,
                                                 bool omit_binary_values) {
-  std::string json_string;
-  JSONStringValueSerializer serializer(&json_string);
-  serializer.set_pretty_print(true);
-  bool result = omit_binary_values ?
-      serializer.SerializeAndOmitBinaryValues(root) :
-      serializer.Serialize(root);
-  if (!result)
-    return false;
+  int options = base::JSONWriter::OPTIONS_PRETTY_PRINT;
+  if (omit_binary_values)
+    options |= base::JSONWriter::OPTIONS_OMIT_BINARY_VALUES;
 
-  int data_size = static_cast<int>(json_string.size());
-  if (file_util::WriteFile(json_file_path_,
-                           json_string.data(),
-                           data_size) != data_size)
+  // Stream the output rather than serializing to a string first; large
+  // documents would otherwise be held in memory twice.
+  FILE* file = file_util::OpenFile(json_file_path_, "wb");
+  if (!file)
     return false;
-
-  return true;
+  bool result = base::JSONWriter::WriteToFile(&root, options, file);
+  return file_util::CloseFile(file) && result;
 }
 
 int JSONFileValueSerializer::ReadFileToString(std::string* json_string) {
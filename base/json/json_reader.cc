@@ -4,6 +4,10 @@
 
 #include "base/json/json_reader.h"
 
+#include <string.h>
+
+#include <vector>
+
 #include "base/float_util.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -65,6 +69,103 @@ bool ReadHexDigits(base::JSONReader::Token& token, int digits) {
 
 namespace base {
 
+namespace {
+
+// Builds a Value tree from the values reported by JSONReader::JsonToEvents().
+class ValueBuilder : public JSONReader::Delegate {
+ public:
+  ValueBuilder() {}
+
+  // Returns the root of the tree, which the caller owns.
+  Value* TakeRoot() { return root_.release(); }
+
+  virtual bool OnNull() OVERRIDE {
+    Attach(Value::CreateNullValue());
+    return true;
+  }
+
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    Attach(Value::CreateBooleanValue(value));
+    return true;
+  }
+
+  virtual bool OnInteger(int value) OVERRIDE {
+    Attach(Value::CreateIntegerValue(value));
+    return true;
+  }
+
+  virtual bool OnDouble(double value) OVERRIDE {
+    Attach(Value::CreateDoubleValue(value));
+    return true;
+  }
+
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    Attach(Value::CreateStringValue(value.as_string()));
+    return true;
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    ListValue* list = new ListValue;
+    Attach(list);
+    containers_.push_back(list);
+    return true;
+  }
+
+  virtual bool OnListEnd() OVERRIDE {
+    containers_.pop_back();
+    return true;
+  }
+
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    DictionaryValue* dictionary = new DictionaryValue;
+    Attach(dictionary);
+    containers_.push_back(dictionary);
+    return true;
+  }
+
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    key.CopyToString(&key_);
+    return true;
+  }
+
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    containers_.pop_back();
+    return true;
+  }
+
+ private:
+  // Adds |value| to the innermost open container, or makes it the root.
+  // Containers are attached as soon as they begin, so |root_| owns everything
+  // built so far even if parsing fails part way.
+  void Attach(Value* value) {
+    if (containers_.empty()) {
+      DCHECK(!root_.get());
+      root_.reset(value);
+      return;
+    }
+    Value* container = containers_.back();
+    if (container->IsType(Value::TYPE_LIST)) {
+      static_cast<ListValue*>(container)->Append(value);
+    } else {
+      static_cast<DictionaryValue*>(container)->SetWithoutPathExpansion(
+          key_, value);
+    }
+  }
+
+  scoped_ptr<Value> root_;
+
+  // The lists and dictionaries that have begun but not ended, innermost last.
+  // They are owned by |root_|.
+  std::vector<Value*> containers_;
+
+  // The key of the next value to add to the innermost dictionary.
+  std::string key_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueBuilder);
+};
+
+}  // namespace
+
 const char* JSONReader::kBadRootElementType =
     "Root value must be an array or object.";
 const char* JSONReader::kInvalidEscape =
@@ -87,6 +188,7 @@ JSONReader::JSONReader()
       json_pos_(NULL),
       end_pos_(NULL),
       stack_depth_(0),
+      delegate_(NULL),
       allow_trailing_comma_(false),
       error_code_(JSON_NO_ERROR),
       error_line_(0),
@@ -156,10 +258,19 @@ std::string JSONReader::GetErrorMessage() const {
 
 Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
                                bool allow_trailing_comma) {
+  ValueBuilder builder;
+  if (!JsonToEvents(json, check_root, allow_trailing_comma, &builder))
+    return NULL;
+  return builder.TakeRoot();
+}
+
+bool JSONReader::JsonToEvents(const std::string& json, bool check_root,
+                              bool allow_trailing_comma, Delegate* delegate) {
+  DCHECK(delegate);
   // The input must be in UTF-8.
   if (!IsStringUTF8(json.data())) {
     error_code_ = JSON_UNSUPPORTED_ENCODING;
-    return NULL;
+    return false;
   }
 
   start_pos_ = json.data();
@@ -178,12 +289,14 @@ Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
   json_pos_ = start_pos_;
   allow_trailing_comma_ = allow_trailing_comma;
   stack_depth_ = 0;
+  delegate_ = delegate;
   error_code_ = JSON_NO_ERROR;
 
-  scoped_ptr<Value> root(BuildValue(check_root));
-  if (root.get()) {
+  bool parsed = ParseValue(check_root);
+  delegate_ = NULL;
+  if (parsed) {
     if (ParseToken().type == Token::END_OF_INPUT) {
-      return root.release();
+      return true;
     } else {
       SetErrorCode(JSON_UNEXPECTED_DATA_AFTER_ROOT, json_pos_);
     }
@@ -193,7 +306,7 @@ Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
   if (error_code_ == 0)
     SetErrorCode(JSON_SYNTAX_ERROR, json_pos_);
 
-  return NULL;
+  return false;
 }
 
 // static
@@ -206,11 +319,11 @@ std::string JSONReader::FormatErrorMessage(int line, int column,
   return description;
 }
 
-Value* JSONReader::BuildValue(bool is_root) {
+bool JSONReader::ParseValue(bool is_root) {
   ++stack_depth_;
   if (stack_depth_ > kStackLimit) {
     SetErrorCode(JSON_TOO_MUCH_NESTING, json_pos_);
-    return NULL;
+    return false;
   }
 
   Token token = ParseToken();
@@ -218,51 +331,52 @@ Value* JSONReader::BuildValue(bool is_root) {
   if (is_root && token.type != Token::OBJECT_BEGIN &&
       token.type != Token::ARRAY_BEGIN) {
     SetErrorCode(JSON_BAD_ROOT_ELEMENT_TYPE, json_pos_);
-    return NULL;
+    return false;
   }
 
-  scoped_ptr<Value> node;
-
   switch (token.type) {
     case Token::END_OF_INPUT:
     case Token::INVALID_TOKEN:
-      return NULL;
+      return false;
 
     case Token::NULL_TOKEN:
-      node.reset(Value::CreateNullValue());
+      if (!delegate_->OnNull())
+        return false;
       break;
 
     case Token::BOOL_TRUE:
-      node.reset(Value::CreateBooleanValue(true));
+      if (!delegate_->OnBoolean(true))
+        return false;
       break;
 
     case Token::BOOL_FALSE:
-      node.reset(Value::CreateBooleanValue(false));
+      if (!delegate_->OnBoolean(false))
+        return false;
       break;
 
     case Token::NUMBER:
-      node.reset(DecodeNumber(token));
-      if (!node.get())
-        return NULL;
+      if (!DecodeNumber(token))
+        return false;
       break;
 
     case Token::STRING:
-      node.reset(DecodeString(token));
-      if (!node.get())
-        return NULL;
-      break;
+      {
+        StringPiece value;
+        if (!DecodeString(token, &value) || !delegate_->OnString(value))
+          return false;
+        break;
+      }
 
     case Token::ARRAY_BEGIN:
       {
         json_pos_ += token.length;
         token = ParseToken();
 
-        node.reset(new ListValue());
+        if (!delegate_->OnListBegin())
+          return false;
         while (token.type != Token::ARRAY_END) {
-          Value* array_node = BuildValue(false);
-          if (!array_node)
-            return NULL;
-          static_cast<ListValue*>(node.get())->Append(array_node);
+          if (!ParseValue(false))
+            return false;
 
           // After a list value, we expect a comma or the end of the list.
           token = ParseToken();
@@ -274,19 +388,21 @@ Value* JSONReader::BuildValue(bool is_root) {
             if (token.type == Token::ARRAY_END) {
               if (!allow_trailing_comma_) {
                 SetErrorCode(JSON_TRAILING_COMMA, json_pos_);
-                return NULL;
+                return false;
               }
               // Trailing comma OK, stop parsing the Array.
               break;
             }
           } else if (token.type != Token::ARRAY_END) {
             // Unexpected value after list value.  Bail out.
-            return NULL;
+            return false;
           }
         }
         if (token.type != Token::ARRAY_END) {
-          return NULL;
+          return false;
         }
+        if (!delegate_->OnListEnd())
+          return false;
         break;
       }
 
@@ -295,33 +411,28 @@ Value* JSONReader::BuildValue(bool is_root) {
         json_pos_ += token.length;
         token = ParseToken();
 
-        node.reset(new DictionaryValue);
+        if (!delegate_->OnDictionaryBegin())
+          return false;
         while (token.type != Token::OBJECT_END) {
           if (token.type != Token::STRING) {
             SetErrorCode(JSON_UNQUOTED_DICTIONARY_KEY, json_pos_);
-            return NULL;
+            return false;
+          }
+          StringPiece dict_key;
+          if (!DecodeString(token, &dict_key) ||
+              !delegate_->OnDictionaryKey(dict_key)) {
+            return false;
           }
-          scoped_ptr<Value> dict_key_value(DecodeString(token));
-          if (!dict_key_value.get())
-            return NULL;
-
-          // Convert the key into a wstring.
-          std::string dict_key;
-          bool success = dict_key_value->GetAsString(&dict_key);
-          DCHECK(success);
 
           json_pos_ += token.length;
           token = ParseToken();
           if (token.type != Token::OBJECT_PAIR_SEPARATOR)
-            return NULL;
+            return false;
 
           json_pos_ += token.length;
           token = ParseToken();
-          Value* dict_value = BuildValue(false);
-          if (!dict_value)
-            return NULL;
-          static_cast<DictionaryValue*>(node.get())->SetWithoutPathExpansion(
-              dict_key, dict_value);
+          if (!ParseValue(false))
+            return false;
 
           // After a key/value pair, we expect a comma or the end of the
           // object.
@@ -334,30 +445,32 @@ Value* JSONReader::BuildValue(bool is_root) {
             if (token.type == Token::OBJECT_END) {
               if (!allow_trailing_comma_) {
                 SetErrorCode(JSON_TRAILING_COMMA, json_pos_);
-                return NULL;
+                return false;
               }
               // Trailing comma OK, stop parsing the Object.
               break;
             }
           } else if (token.type != Token::OBJECT_END) {
             // Unexpected value after last object value.  Bail out.
-            return NULL;
+            return false;
           }
         }
         if (token.type != Token::OBJECT_END)
-          return NULL;
+          return false;
+        if (!delegate_->OnDictionaryEnd())
+          return false;
 
         break;
       }
 
     default:
       // We got a token that's not a value.
-      return NULL;
+      return false;
   }
   json_pos_ += token.length;
 
   --stack_depth_;
-  return node.release();
+  return true;
 }
 
 JSONReader::Token JSONReader::ParseNumberToken() {
@@ -397,18 +510,18 @@ JSONReader::Token JSONReader::ParseNumberToken() {
   return token;
 }
 
-Value* JSONReader::DecodeNumber(const Token& token) {
-  const std::string num_string(token.begin, token.length);
-
+bool JSONReader::DecodeNumber(const Token& token) {
   int num_int;
-  if (StringToInt(num_string, &num_int))
-    return Value::CreateIntegerValue(num_int);
+  if (StringToInt(StringPiece(token.begin, token.length), &num_int))
+    return delegate_->OnInteger(num_int);
 
   double num_double;
-  if (StringToDouble(num_string, &num_double) && base::IsFinite(num_double))
-    return Value::CreateDoubleValue(num_double);
+  if (StringToDouble(std::string(token.begin, token.length), &num_double) &&
+      base::IsFinite(num_double)) {
+    return delegate_->OnDouble(num_double);
+  }
 
-  return NULL;
+  return false;
 }
 
 JSONReader::Token JSONReader::ParseStringToken() {
@@ -456,9 +569,18 @@ JSONReader::Token JSONReader::ParseStringToken() {
   return Token::CreateInvalidToken();
 }
 
-Value* JSONReader::DecodeString(const Token& token) {
-  std::string decoded_str;
-  decoded_str.reserve(token.length - 2);
+bool JSONReader::DecodeString(const Token& token, StringPiece* decoded) {
+  // Most strings have no escape sequences and can be handed out in place.
+  const char* contents = token.begin + 1;
+  size_t contents_length = token.length - 2;
+  if (!memchr(contents, '\\', contents_length)) {
+    decoded->set(contents, contents_length);
+    return true;
+  }
+
+  std::string& decoded_str = string_buffer_;
+  decoded_str.clear();
+  decoded_str.reserve(contents_length);
 
   for (int i = 1; i < token.length - 1; ++i) {
     char c = *(token.begin + i);
@@ -492,31 +614,32 @@ Value* JSONReader::DecodeString(const Token& token) {
 
         case 'x': {
           if (i + 2 >= token.length)
-            return NULL;
+            return false;
           int hex_digit = 0;
           if (!HexStringToInt(StringPiece(token.begin + i + 1, 2), &hex_digit))
-            return NULL;
+            return false;
           decoded_str.push_back(hex_digit);
           i += 2;
           break;
         }
         case 'u':
           if (!ConvertUTF16Units(token, &i, &decoded_str))
-            return NULL;
+            return false;
           break;
 
         default:
           // We should only have valid strings at this point.  If not,
           // ParseStringToken didn't do its job.
           NOTREACHED();
-          return NULL;
+          return false;
       }
     } else {
       // Not escaped
       decoded_str.push_back(c);
     }
   }
-  return Value::CreateStringValue(decoded_str);
+  decoded->set(decoded_str.data(), decoded_str.size());
+  return true;
 }
 
 bool JSONReader::ConvertUTF16Units(const Token& token,
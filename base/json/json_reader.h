@@ -3,7 +3,8 @@
 // found in the LICENSE file.
 //
 // A JSON parser.  Converts strings of JSON into a Value object (see
-// base/values.h).
+// base/values.h), or reports the values it parses one at a time to a
+// JSONReader::Delegate without building a Value tree.
 // http://www.ietf.org/rfc/rfc4627.txt?number=4627
 //
 // Known limitations/deviations from the RFC:
@@ -33,6 +34,7 @@
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
+#include "base/string_piece.h"
 
 // Chromium and Chromium OS check out gtest to different places, so we're
 // unable to compile on both if we include gtest_prod.h here.  Instead, include
@@ -101,6 +103,33 @@ class BASE_EXPORT JSONReader {
     int length;
   };
 
+  // Receives the values of a JSON document in document order, as they are
+  // parsed.  Containers are reported as a Begin call, their contents, and an
+  // End call; every dictionary value is preceded by an OnDictionaryKey call.
+  // Returning false from any method stops parsing, which then fails with
+  // JSON_SYNTAX_ERROR.
+  class BASE_EXPORT Delegate {
+   public:
+    virtual ~Delegate() {}
+
+    virtual bool OnNull() = 0;
+    virtual bool OnBoolean(bool value) = 0;
+    virtual bool OnInteger(int value) = 0;
+    virtual bool OnDouble(double value) = 0;
+
+    // |value| is only valid for the duration of the call.  When the string
+    // has no escape sequences, it points straight into the input.
+    virtual bool OnString(const StringPiece& value) = 0;
+
+    virtual bool OnListBegin() = 0;
+    virtual bool OnListEnd() = 0;
+
+    virtual bool OnDictionaryBegin() = 0;
+    // |key| is only valid for the duration of the call, as for OnString().
+    virtual bool OnDictionaryKey(const StringPiece& key) = 0;
+    virtual bool OnDictionaryEnd() = 0;
+  };
+
   // Error codes during parsing.
   enum JsonParseError {
     JSON_NO_ERROR = 0,
@@ -166,6 +195,13 @@ class BASE_EXPORT JSONReader {
   Value* JsonToValue(const std::string& json, bool check_root,
                      bool allow_trailing_comma);
 
+  // Parses |json| like JsonToValue(), but hands each value to |delegate|
+  // instead of building a Value.  Returns true if the whole input is valid
+  // JSON; otherwise, |delegate| may already have seen part of the document
+  // and error_code() tells why parsing failed.
+  bool JsonToEvents(const std::string& json, bool check_root,
+                    bool allow_trailing_comma, Delegate* delegate);
+
  private:
   FRIEND_TEST_ALL_PREFIXES(JSONReaderTest, Reading);
   FRIEND_TEST_ALL_PREFIXES(JSONReaderTest, ErrorMessages);
@@ -173,10 +209,10 @@ class BASE_EXPORT JSONReader {
   static std::string FormatErrorMessage(int line, int column,
                                         const std::string& description);
 
-  // Recursively build Value.  Returns NULL if we don't have a valid JSON
-  // string.  If |is_root| is true, we verify that the root element is either
-  // an object or an array.
-  Value* BuildValue(bool is_root);
+  // Recursively parses a value and reports it to |delegate_|.  Returns false
+  // if we don't have a valid JSON string.  If |is_root| is true, we verify
+  // that the root element is either an object or an array.
+  bool ParseValue(bool is_root);
 
   // Parses a sequence of characters into a Token::NUMBER. If the sequence of
   // characters is not a valid number, returns a Token::INVALID_TOKEN. Note
@@ -184,9 +220,9 @@ class BASE_EXPORT JSONReader {
   // int/double.
   Token ParseNumberToken();
 
-  // Try and convert the substring that token holds into an int or a double. If
-  // we can (ie., no overflow), return the value, else return NULL.
-  Value* DecodeNumber(const Token& token);
+  // Try and convert the substring that token holds into an int or a double,
+  // and report it to |delegate_|. Returns false if the number overflows.
+  bool DecodeNumber(const Token& token);
 
   // Parses a sequence of characters into a Token::STRING. If the sequence of
   // characters is not a valid string, returns a Token::INVALID_TOKEN. Note
@@ -194,9 +230,11 @@ class BASE_EXPORT JSONReader {
   // actual wstring.
   Token ParseStringToken();
 
-  // Convert the substring into a value string.  This should always succeed
-  // (otherwise ParseStringToken would have failed).
-  Value* DecodeString(const Token& token);
+  // Convert the substring into a string.  This should always succeed
+  // (otherwise ParseStringToken would have failed).  |decoded| points into the
+  // input if the string has no escape sequences, and into |string_buffer_|
+  // otherwise, so it is only valid until the next call.
+  bool DecodeString(const Token& token, StringPiece* decoded);
 
   // Helper function for DecodeString that consumes UTF16 [0,2] code units and
   // convers them to UTF8 code untis.  |token| is the string token in which the
@@ -239,6 +277,13 @@ class BASE_EXPORT JSONReader {
   // Used to keep track of how many nested lists/dicts there are.
   int stack_depth_;
 
+  // Receives the parsed values during JsonToEvents().
+  Delegate* delegate_;
+
+  // Holds the decoded form of strings that contain escape sequences.  It is
+  // reused for every such string to avoid an allocation per string.
+  std::string string_buffer_;
+
   // A parser flag that allows trailing commas in objects and arrays.
   bool allow_trailing_comma_;
 
@@ -6,9 +6,13 @@
 
 #include "base/base_paths.h"
 #include "base/file_util.h"
+#include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
+#include "base/string_number_conversions.h"
 #include "base/string_piece.h"
+#include "base/stringprintf.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -16,6 +20,72 @@
 
 namespace base {
 
+namespace {
+
+// Records the values reported by JSONReader::JsonToEvents() in a compact
+// form, and optionally stops after a number of them.
+class RecordingDelegate : public JSONReader::Delegate {
+ public:
+  explicit RecordingDelegate(int event_limit)
+      : event_limit_(event_limit),
+        string_data_(NULL) {}
+
+  const std::string& events() const { return events_; }
+
+  // The data pointer of the last string reported through OnString().
+  const char* string_data() const { return string_data_; }
+
+  virtual bool OnNull() OVERRIDE {
+    return Record("n");
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "t" : "f");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record("i" + IntToString(value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record("d" + DoubleToString(value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    string_data_ = value.data();
+    return Record("s" + value.as_string());
+  }
+  virtual bool OnListBegin() OVERRIDE {
+    return Record("[");
+  }
+  virtual bool OnListEnd() OVERRIDE {
+    return Record("]");
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    return Record("{");
+  }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return Record("k" + key.as_string());
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    return Record("}");
+  }
+
+ private:
+  bool Record(const std::string& event) {
+    if (event_limit_-- == 0)
+      return false;
+    if (!events_.empty())
+      events_.push_back(' ');
+    events_.append(event);
+    return true;
+  }
+
+  int event_limit_;
+  std::string events_;
+  const char* string_data_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingDelegate);
+};
+
+}  // namespace
+
 TEST(JSONReaderTest, Reading) {
   // some whitespace checking
   scoped_ptr<Value> root;
@@ -607,4 +677,96 @@ TEST(JSONReaderTest, ErrorMessages) {
   EXPECT_EQ(JSONReader::JSON_INVALID_ESCAPE, error_code);
 }
 
+TEST(JSONReaderTest, Events) {
+  const std::string json =
+      "{\"a\": [1, 2.5, \"x\\ny\", null], \"b\": {\"c\": true},"
+      " \"d\": \"plain\"}";
+  JSONReader reader;
+  RecordingDelegate delegate(-1);
+  ASSERT_TRUE(reader.JsonToEvents(json, true, false, &delegate));
+  EXPECT_EQ("{ ka [ i1 d2.5 sx\ny n ] kb { kc t } kd splain }",
+            delegate.events());
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+
+  // Strings without escapes are not copied.
+  EXPECT_EQ(json.data() + json.find("plain"), delegate.string_data());
+}
+
+TEST(JSONReaderTest, EventsStopWhenDelegateFails) {
+  JSONReader reader;
+  RecordingDelegate delegate(3);
+  EXPECT_FALSE(reader.JsonToEvents("[1, 2, 3, 4]", false, false, &delegate));
+  EXPECT_EQ("[ i1 i2", delegate.events());
+  EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, reader.error_code());
+
+  // Errors in the input are reported after the values before them.
+  RecordingDelegate bad_input_delegate(-1);
+  EXPECT_FALSE(reader.JsonToEvents("[true, nul]", false, false,
+                                   &bad_input_delegate));
+  EXPECT_EQ("[ t", bad_input_delegate.events());
+  EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, reader.error_code());
+}
+
+// Parses a document shaped like a large Bookmarks file, both into a Value and
+// with a delegate that discards the values, and logs how long each takes.
+TEST(JSONReaderTest, LargeDocument) {
+  std::string json = "{\"roots\": {\"bookmark_bar\": {\"children\": [";
+  const int kBookmarkCount = 20000;
+  for (int i = 0; i < kBookmarkCount; ++i) {
+    if (i)
+      json.append(",");
+    StringAppendF(&json,
+        "{\"date_added\": \"129%014d\", \"id\": %d, "
+        "\"name\": \"Bookmark \\\"%d\\\"\", \"type\": \"url\", "
+        "\"url\": \"http://www.example.com/%d/index.html\"}", i, i, i, i);
+  }
+  json.append("], \"type\": \"folder\"}}, \"version\": 1}");
+
+  TimeTicks start = TimeTicks::Now();
+  scoped_ptr<Value> root(JSONReader::Read(json));
+  TimeDelta value_time = TimeTicks::Now() - start;
+  ASSERT_TRUE(root.get());
+  DictionaryValue* dict = static_cast<DictionaryValue*>(root.get());
+  ListValue* children = NULL;
+  ASSERT_TRUE(dict->GetList("roots.bookmark_bar.children", &children));
+  EXPECT_EQ(static_cast<size_t>(kBookmarkCount), children->GetSize());
+
+  class CountingDelegate : public JSONReader::Delegate {
+   public:
+    CountingDelegate() : count(0) {}
+    virtual bool OnNull() OVERRIDE { return Count(); }
+    virtual bool OnBoolean(bool value) OVERRIDE { return Count(); }
+    virtual bool OnInteger(int value) OVERRIDE { return Count(); }
+    virtual bool OnDouble(double value) OVERRIDE { return Count(); }
+    virtual bool OnString(const StringPiece& value) OVERRIDE {
+      return Count();
+    }
+    virtual bool OnListBegin() OVERRIDE { return Count(); }
+    virtual bool OnListEnd() OVERRIDE { return true; }
+    virtual bool OnDictionaryBegin() OVERRIDE { return Count(); }
+    virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+      return true;
+    }
+    virtual bool OnDictionaryEnd() OVERRIDE { return true; }
+    int count;
+   private:
+    bool Count() {
+      ++count;
+      return true;
+    }
+  } counter;
+
+  start = TimeTicks::Now();
+  JSONReader reader;
+  ASSERT_TRUE(reader.JsonToEvents(json, true, false, &counter));
+  TimeDelta event_time = TimeTicks::Now() - start;
+  // Each bookmark is a dictionary with five values; the rest of the document
+  // adds the root, "roots", "bookmark_bar", "children", "type" and "version".
+  EXPECT_EQ(kBookmarkCount * 6 + 6, counter.count);
+
+  VLOG(1) << json.size() << " bytes parsed into a Value in "
+          << value_time.InMillisecondsF() << " ms and into events in "
+          << event_time.InMillisecondsF() << " ms";
+}
+
 }  // namespace base
@@ -8,8 +8,8 @@
 
 #include "base/json/string_escape.h"
 #include "base/logging.h"
-#include "base/stringprintf.h"
 #include "base/string_number_conversions.h"
+#include "base/string_util.h"
 #include "base/values.h"
 #include "base/utf_string_conversions.h"
 
@@ -21,6 +21,58 @@ static const char kPrettyPrintLineEnding[] = "\r\n";
 static const char kPrettyPrintLineEnding[] = "\n";
 #endif
 
+// When streaming to a file, the output buffer is written out each time it
+// grows past this many bytes.
+static const size_t kFileChunkSize = 64 * 1024;
+
+namespace {
+
+// Returns a rough upper estimate of the number of bytes needed to serialize
+// |node|, so the output string can be allocated once up front.  Escaping can
+// still make the output longer than this.
+size_t EstimateSerializedSize(const Value* node,
+                              int depth,
+                              bool pretty_print,
+                              std::string* scratch) {
+  switch (node->GetType()) {
+    case Value::TYPE_NULL:
+    case Value::TYPE_BOOLEAN:
+      return 5;
+    case Value::TYPE_INTEGER:
+      return 11;
+    case Value::TYPE_DOUBLE:
+      return 24;
+    case Value::TYPE_STRING:
+      node->GetAsString(scratch);
+      return scratch->size() + 2;
+    case Value::TYPE_LIST: {
+      const ListValue* list = static_cast<const ListValue*>(node);
+      size_t size = pretty_print ? 4 : 2;
+      for (ListValue::const_iterator it = list->begin(); it != list->end();
+           ++it) {
+        size += (pretty_print ? 2 : 1) +
+            EstimateSerializedSize(*it, depth, pretty_print, scratch);
+      }
+      return size;
+    }
+    case Value::TYPE_DICTIONARY: {
+      const DictionaryValue* dict = static_cast<const DictionaryValue*>(node);
+      size_t size = 2 + (pretty_print ? 4 + depth * 3 : 0);
+      for (DictionaryValue::Iterator it(*dict); it.HasNext(); it.Advance()) {
+        size += it.key().size() + 4 +
+            (pretty_print ? (depth + 1) * 3 + 3 : 0) +
+            EstimateSerializedSize(&it.value(), depth + 1, pretty_print,
+                                   scratch);
+      }
+      return size;
+    }
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
 /* static */
 const char* JSONWriter::kEmptyArray = "[]";
 
@@ -33,31 +85,42 @@ void JSONWriter::Write(const Value* const node, std::string* json) {
 void JSONWriter::WriteWithOptions(const Value* const node, int options,
                                   std::string* json) {
   json->clear();
-  // Is there a better way to estimate the size of the output?
-  json->reserve(1024);
-
-  bool escape = !(options & OPTIONS_DO_NOT_ESCAPE);
-  bool omit_binary_values = !!(options & OPTIONS_OMIT_BINARY_VALUES);
-  bool omit_double_type_preservation =
-      !!(options & OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION);
-  bool pretty_print = !!(options & OPTIONS_PRETTY_PRINT);
+  std::string scratch;
+  json->reserve(EstimateSerializedSize(
+      node, 0, !!(options & OPTIONS_PRETTY_PRINT), &scratch));
 
-  JSONWriter writer(escape, omit_binary_values, omit_double_type_preservation,
-                    pretty_print, json);
+  JSONWriter writer(options, json, NULL);
   writer.BuildJSONString(node, 0);
 
-  if (pretty_print)
+  if (writer.pretty_print_)
     json->append(kPrettyPrintLineEnding);
 }
 
-JSONWriter::JSONWriter(bool escape, bool omit_binary_values,
-                       bool omit_double_type_preservation, bool pretty_print,
-                       std::string* json)
-    : escape_(escape),
-      omit_binary_values_(omit_binary_values),
-      omit_double_type_preservation_(omit_double_type_preservation),
-      pretty_print_(pretty_print),
-      json_string_(json) {
+/* static */
+bool JSONWriter::WriteToFile(const Value* const node, int options,
+                             FILE* file) {
+  DCHECK(file);
+  std::string buffer;
+  buffer.reserve(kFileChunkSize * 2);
+
+  JSONWriter writer(options, &buffer, file);
+  writer.BuildJSONString(node, 0);
+
+  if (writer.pretty_print_)
+    buffer.append(kPrettyPrintLineEnding);
+  writer.FlushIfNeeded(true);
+  return !writer.write_failed_;
+}
+
+JSONWriter::JSONWriter(int options, std::string* json, FILE* file)
+    : escape_(!(options & OPTIONS_DO_NOT_ESCAPE)),
+      omit_binary_values_(!!(options & OPTIONS_OMIT_BINARY_VALUES)),
+      omit_double_type_preservation_(
+          !!(options & OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION)),
+      pretty_print_(!!(options & OPTIONS_PRETTY_PRINT)),
+      json_string_(json),
+      file_(file),
+      write_failed_(false) {
   DCHECK(json);
 }
 
@@ -81,7 +144,7 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
         int value;
         bool result = node->GetAsInteger(&value);
         DCHECK(result);
-        base::StringAppendF(json_string_, "%d", value);
+        json_string_->append(IntToString(value));
         break;
       }
 
@@ -124,7 +187,7 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
         bool result = node->GetAsString(&value);
         DCHECK(result);
         if (escape_) {
-          JsonDoubleQuote(UTF8ToUTF16(value), true, json_string_);
+          AppendQuotedString(value);
         } else {
           JsonDoubleQuote(value, true, json_string_);
         }
@@ -154,6 +217,7 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
           }
 
           BuildJSONString(value, depth);
+          FlushIfNeeded(false);
         }
 
         if (pretty_print_)
@@ -196,6 +260,7 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
             json_string_->append(":");
           }
           BuildJSONString(value, depth + 1);
+          FlushIfNeeded(false);
         }
 
         if (pretty_print_) {
@@ -222,15 +287,30 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
 }
 
 void JSONWriter::AppendQuotedString(const std::string& str) {
-  // TODO(viettrungluu): |str| is UTF-8, not ASCII, so to properly escape it we
-  // have to convert it to UTF-16. This round-trip is suboptimal.
-  JsonDoubleQuote(UTF8ToUTF16(str), true, json_string_);
+  // |str| is UTF-8, so to properly escape non-ASCII characters we have to
+  // convert it to UTF-16 first.  Pure ASCII strings, by far the common case,
+  // escape identically either way, so skip the round-trip for them.
+  if (IsStringASCII(str))
+    JsonDoubleQuote(str, true, json_string_);
+  else
+    JsonDoubleQuote(UTF8ToUTF16(str), true, json_string_);
 }
 
 void JSONWriter::IndentLine(int depth) {
-  // It may be faster to keep an indent string so we don't have to keep
-  // reallocating.
-  json_string_->append(std::string(depth * 3, ' '));
+  json_string_->append(depth * 3, ' ');
+}
+
+void JSONWriter::FlushIfNeeded(bool force) {
+  if (!file_ || json_string_->empty())
+    return;
+  if (!force && json_string_->size() < kFileChunkSize)
+    return;
+  if (!write_failed_ &&
+      fwrite(json_string_->data(), 1, json_string_->size(), file_) !=
+          json_string_->size()) {
+    write_failed_ = true;
+  }
+  json_string_->clear();
 }
 
 }  // namespace base
@@ -6,6 +6,8 @@
 #define BASE_JSON_JSON_WRITER_H_
 #pragma once
 
+#include <stdio.h>
+
 #include <string>
 
 #include "base/base_export.h"
@@ -49,14 +51,17 @@ class BASE_EXPORT JSONWriter {
   static void WriteWithOptions(const Value* const node, int options,
                                std::string* json);
 
+  // Same as WriteWithOptions() but streams the output to |file| in chunks
+  // instead of building the whole document in memory first.  Returns false
+  // if writing to |file| failed.  |file| is not closed.
+  static bool WriteToFile(const Value* const node, int options, FILE* file);
+
   // A static, constant JSON string representing an empty array.  Useful
   // for empty JSON argument passing.
   static const char* kEmptyArray;
 
  private:
-  JSONWriter(bool escape, bool omit_binary_values,
-             bool omit_double_type_preservation, bool pretty_print,
-             std::string* json);
+  JSONWriter(int options, std::string* json, FILE* file);
 
   // Called recursively to build the JSON string.  Whe completed, value is
   // json_string_ will contain the JSON.
@@ -68,6 +73,10 @@ class BASE_EXPORT JSONWriter {
   // Adds space to json_string_ for the indent level.
   void IndentLine(int depth);
 
+  // When streaming to |file_|, writes out json_string_ once it has grown
+  // past the chunk size (or unconditionally if |force| is true).
+  void FlushIfNeeded(bool force);
+
   bool escape_;
   bool omit_binary_values_;
   bool omit_double_type_preservation_;
@@ -76,6 +85,11 @@ class BASE_EXPORT JSONWriter {
   // Where we write JSON data as we generate it.
   std::string* json_string_;
 
+  // If non-NULL, json_string_ is only a buffer that is periodically flushed
+  // to this file.
+  FILE* file_;
+  bool write_failed_;
+
   DISALLOW_COPY_AND_ASSIGN(JSONWriter);
 };
 
@@ -3,6 +3,10 @@
 // found in the LICENSE file.
 
 #include "base/json/json_writer.h"
+
+#include "base/file_util.h"
+#include "base/scoped_temp_dir.h"
+#include "base/stringprintf.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -129,4 +133,34 @@ TEST(JSONWriterTest, Writing) {
   ASSERT_EQ("10000000000", output_js);
 }
 
+TEST(JSONWriterTest, WriteToFile) {
+  // Build a document large enough to be written out in several chunks.
+  DictionaryValue root;
+  ListValue* list = new ListValue;
+  root.Set("list", list);
+  for (int i = 0; i < 5000; ++i) {
+    DictionaryValue* entry = new DictionaryValue;
+    entry->SetString("name", StringPrintf("entry \"%d\" <\xc3\xa9>", i));
+    entry->SetInteger("id", i);
+    entry->SetDouble("value", i / 4.0);
+    list->Append(entry);
+  }
+
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath path = temp_dir.path().AppendASCII("out.json");
+  const int options = JSONWriter::OPTIONS_PRETTY_PRINT;
+
+  FILE* file = file_util::OpenFile(path, "wb");
+  ASSERT_TRUE(file);
+  EXPECT_TRUE(JSONWriter::WriteToFile(&root, options, file));
+  ASSERT_TRUE(file_util::CloseFile(file));
+
+  std::string expected;
+  JSONWriter::WriteWithOptions(&root, options, &expected);
+  std::string written;
+  ASSERT_TRUE(file_util::ReadFileToString(path, &written));
+  EXPECT_EQ(expected, written);
+}
+
 }  // namespace base
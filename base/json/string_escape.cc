@@ -6,8 +6,15 @@
 
 #include <string>
 
-#include "base/stringprintf.h"
 #include "base/string_util.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JSON_ESCAPE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 namespace base {
 
@@ -49,6 +56,66 @@ static bool JsonSingleEscapeChar(const CHAR c, std::string* dst) {
   return true;
 }
 
+// Returns true if |c| can be copied to the output without any escaping.
+inline bool IsSafeJsonChar(unsigned char c) {
+  return c >= 32 && c <= 126 && c != '"' && c != '\\' && c != '<' &&
+      c != '>';
+}
+
+// Returns the index of the first byte in [|begin|, |length|) of |data| that
+// has to be escaped, or |length| if there is none.  Most strings written out
+// are long runs of plain ASCII, so this lets the caller copy them in one go.
+size_t FindCharToEscape(const char* data, size_t begin, size_t length) {
+  size_t i = begin;
+#if defined(JSON_ESCAPE_USE_SSE2)
+  // The signed compare against 32 catches both control characters and bytes
+  // with the high bit set, which are escaped as \u00XX.
+  const __m128i space = _mm_set1_epi8(32);
+  const __m128i del = _mm_set1_epi8(127);
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i less = _mm_set1_epi8('<');
+  const __m128i greater = _mm_set1_epi8('>');
+  for (; i + 16 <= length; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i unsafe = _mm_or_si128(
+        _mm_or_si128(_mm_cmplt_epi8(chunk, space),
+                     _mm_cmpeq_epi8(chunk, del)),
+        _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                         _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, less),
+                         _mm_cmpeq_epi8(chunk, greater))));
+    if (_mm_movemask_epi8(unsafe))
+      break;
+  }
+#endif
+  for (; i < length; ++i) {
+    if (!IsSafeJsonChar(static_cast<unsigned char>(data[i])))
+      break;
+  }
+  return i;
+}
+
+// Appends the escaped form of |c|, which IsSafeJsonChar() rejected.
+template<typename CHAR>
+void AppendEscapedChar(CHAR c, std::string* dst) {
+  if (!JsonSingleEscapeChar(c, dst)) {
+    // 1. Escaping <, > to prevent script execution.
+    // 2. Technically, we could also pass through c > 126 as UTF8, but this
+    //    is also optional.  It would also be a pain to implement here.
+    static const char kHexDigits[] = "0123456789ABCDEF";
+    unsigned int as_uint = static_cast<unsigned int>(c);
+    char escape[6] = { '\\', 'u',
+                       kHexDigits[(as_uint >> 12) & 0xF],
+                       kHexDigits[(as_uint >> 8) & 0xF],
+                       kHexDigits[(as_uint >> 4) & 0xF],
+                       kHexDigits[as_uint & 0xF] };
+    dst->append(escape, sizeof(escape));
+  }
+}
+
 template <class STR>
 void JsonDoubleQuoteT(const STR& str,
                       bool put_in_quotes,
@@ -58,18 +125,10 @@ void JsonDoubleQuoteT(const STR& str,
 
   for (typename STR::const_iterator it = str.begin(); it != str.end(); ++it) {
     typename ToUnsigned<typename STR::value_type>::Unsigned c = *it;
-    if (!JsonSingleEscapeChar(c, dst)) {
-      if (c < 32 || c > 126 || c == '<' || c == '>') {
-        // 1. Escaping <, > to prevent script execution.
-        // 2. Technically, we could also pass through c > 126 as UTF8, but this
-        //    is also optional.  It would also be a pain to implement here.
-        unsigned int as_uint = static_cast<unsigned int>(c);
-        base::StringAppendF(dst, "\\u%04X", as_uint);
-      } else {
-        unsigned char ascii = static_cast<unsigned char>(*it);
-        dst->push_back(ascii);
-      }
-    }
+    if (c <= 126 && IsSafeJsonChar(static_cast<unsigned char>(c)))
+      dst->push_back(static_cast<char>(c));
+    else
+      AppendEscapedChar(c, dst);
   }
 
   if (put_in_quotes)
@@ -81,7 +140,26 @@ void JsonDoubleQuoteT(const STR& str,
 void JsonDoubleQuote(const std::string& str,
                      bool put_in_quotes,
                      std::string* dst) {
-  JsonDoubleQuoteT(str, put_in_quotes, dst);
+  // Unlike the UTF-16 version below, work on runs of bytes that need no
+  // escaping and append each with a single call.
+  dst->reserve(dst->size() + str.size() + (put_in_quotes ? 2 : 0));
+  if (put_in_quotes)
+    dst->push_back('"');
+
+  const char* data = str.data();
+  const size_t length = str.size();
+  size_t pos = 0;
+  while (pos < length) {
+    size_t next = FindCharToEscape(data, pos, length);
+    dst->append(data + pos, next - pos);
+    if (next == length)
+      break;
+    AppendEscapedChar(static_cast<unsigned char>(data[next]), dst);
+    pos = next + 1;
+  }
+
+  if (put_in_quotes)
+    dst->push_back('"');
 }
 
 std::string GetDoubleQuotedJson(const std::string& str) {
@@ -97,4 +97,31 @@ TEST(StringEscapeTest, JsonDoubleQuoteWide) {
   EXPECT_EQ(expected, out);
 }
 
+TEST(StringEscapeTest, JsonDoubleQuoteLongRuns) {
+  // The narrow version copies runs of safe bytes in bulk; check that an
+  // escapable byte is found at every offset within and across those runs,
+  // and that the result matches the character-at-a-time UTF-16 version.
+  const char kUnsafe[] = { '"', '\\', '<', '>', '\n', '\x01', '\x7f' };
+  for (size_t u = 0; u < arraysize(kUnsafe); ++u) {
+    for (size_t pos = 0; pos < 40; ++pos) {
+      std::string in(40, 'x');
+      in[pos] = kUnsafe[u];
+      std::string narrow;
+      JsonDoubleQuote(in, true, &narrow);
+      std::string wide;
+      JsonDoubleQuote(ASCIIToUTF16(in), true, &wide);
+      EXPECT_EQ(wide, narrow) << "unsafe char " << u << " at " << pos;
+    }
+  }
+
+  std::string in(100, 'a');
+  std::string out;
+  JsonDoubleQuote(in, false, &out);
+  EXPECT_EQ(in, out);
+  in[99] = '\xff';
+  out.clear();
+  JsonDoubleQuote(in, false, &out);
+  EXPECT_EQ(std::string(99, 'a') + "\\u00FF", out);
+}
+
 }  // namespace base
@@ -0,0 +1,56 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_pressure_listener.h"
+
+#include "base/lazy_instance.h"
+#include "base/observer_list_threadsafe.h"
+
+namespace base {
+
+namespace {
+
+class MemoryPressureObserver {
+ public:
+  MemoryPressureObserver()
+      : observers_(new ObserverListThreadSafe<MemoryPressureListener>) {
+  }
+
+  scoped_refptr<ObserverListThreadSafe<MemoryPressureListener> > observers() {
+    return observers_;
+  }
+
+ private:
+  scoped_refptr<ObserverListThreadSafe<MemoryPressureListener> > observers_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureObserver);
+};
+
+LazyInstance<MemoryPressureObserver>::Leaky g_observer =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+MemoryPressureListener::MemoryPressureListener(
+    const MemoryPressureCallback& callback)
+    : callback_(callback) {
+  g_observer.Get().observers()->AddObserver(this);
+}
+
+MemoryPressureListener::~MemoryPressureListener() {
+  g_observer.Get().observers()->RemoveObserver(this);
+}
+
+void MemoryPressureListener::Notify(MemoryPressureLevel level) {
+  callback_.Run(level);
+}
+
+// static
+void MemoryPressureListener::NotifyMemoryPressure(MemoryPressureLevel level) {
+  DCHECK_LT(level, MEMORY_PRESSURE_LEVEL_COUNT);
+  g_observer.Get().observers()->Notify(&MemoryPressureListener::Notify,
+                                       level);
+}
+
+}  // namespace base
@@ -0,0 +1,65 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_MEMORY_PRESSURE_LISTENER_H_
+#define BASE_MEMORY_MEMORY_PRESSURE_LISTENER_H_
+#pragma once
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+
+namespace base {
+
+// MemoryPressureListener lets caches hear about system-wide memory pressure,
+// as detected by a platform specific monitor, and decide for themselves what
+// to drop.
+//
+// To start listening, create a listener with a callback; to stop, delete it.
+// The callback always runs on the thread that created the listener, which
+// must have a MessageLoop.
+//
+// Example:
+//
+//   void OnMemoryPressure(
+//       base::MemoryPressureListener::MemoryPressureLevel level) {
+//     ...
+//   }
+//
+//   scoped_ptr<base::MemoryPressureListener> listener(
+//       new base::MemoryPressureListener(base::Bind(&OnMemoryPressure)));
+class BASE_EXPORT MemoryPressureListener {
+ public:
+  enum MemoryPressureLevel {
+    // Memory is getting low. Drop what is cheap to recreate, such as data
+    // that was recently used but isn't needed right now.
+    MEMORY_PRESSURE_MODERATE,
+
+    // The system is about to swap heavily or kill processes. Free everything
+    // possible, even if it will cost time to recreate later.
+    MEMORY_PRESSURE_CRITICAL,
+
+    MEMORY_PRESSURE_LEVEL_COUNT
+  };
+
+  typedef base::Callback<void(MemoryPressureLevel)> MemoryPressureCallback;
+
+  explicit MemoryPressureListener(const MemoryPressureCallback& callback);
+  ~MemoryPressureListener();
+
+  // Posts |level| to every listener in this process. Intended for the
+  // platform specific monitors; may be called on any thread.
+  static void NotifyMemoryPressure(MemoryPressureLevel level);
+
+ private:
+  void Notify(MemoryPressureLevel level);
+
+  MemoryPressureCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureListener);
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_MEMORY_PRESSURE_LISTENER_H_
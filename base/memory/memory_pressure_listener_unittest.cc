@@ -0,0 +1,67 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_pressure_listener.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class Recorder {
+ public:
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level) {
+    levels_.push_back(level);
+  }
+
+  const std::vector<MemoryPressureListener::MemoryPressureLevel>&
+  levels() const {
+    return levels_;
+  }
+
+ private:
+  std::vector<MemoryPressureListener::MemoryPressureLevel> levels_;
+};
+
+}  // namespace
+
+TEST(MemoryPressureListenerTest, NotifiesListeners) {
+  MessageLoop message_loop;
+  Recorder first;
+  Recorder second;
+  MemoryPressureListener first_listener(
+      Bind(&Recorder::OnMemoryPressure, Unretained(&first)));
+  scoped_ptr<MemoryPressureListener> second_listener(
+      new MemoryPressureListener(
+          Bind(&Recorder::OnMemoryPressure, Unretained(&second))));
+
+  // Notifications are posted, even to the notifying thread.
+  MemoryPressureListener::NotifyMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+  EXPECT_TRUE(first.levels().empty());
+  message_loop.RunAllPending();
+  ASSERT_EQ(1u, first.levels().size());
+  EXPECT_EQ(MemoryPressureListener::MEMORY_PRESSURE_MODERATE,
+            first.levels()[0]);
+  ASSERT_EQ(1u, second.levels().size());
+
+  // A deleted listener hears nothing more, even of notifications that were
+  // already in flight.
+  MemoryPressureListener::NotifyMemoryPressure(
+      MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  second_listener.reset();
+  message_loop.RunAllPending();
+  ASSERT_EQ(2u, first.levels().size());
+  EXPECT_EQ(MemoryPressureListener::MEMORY_PRESSURE_CRITICAL,
+            first.levels()[1]);
+  EXPECT_EQ(1u, second.levels().size());
+}
+
+}  // namespace base
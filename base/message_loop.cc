@@ -86,6 +86,29 @@ const base::LinearHistogram::DescriptionPair event_descriptions_[] = {
 
 bool enable_histogrammer_ = false;
 
+// Rounds |run_time| up to a multiple of the largest power-of-two number of
+// milliseconds that does not exceed |leeway|.  Timers with similar leeway then
+// share boundaries no matter which thread or process posted them, because
+// TimeTicks values come from a single system-wide clock.
+TimeTicks AlignRunTimeToLeeway(TimeTicks run_time, TimeDelta leeway) {
+  int64 leeway_ms = leeway.InMilliseconds();
+  if (run_time.is_null() || leeway_ms <= 0)
+    return run_time;
+
+  int64 granularity_ms = 1;
+  while (granularity_ms * 2 <= leeway_ms)
+    granularity_ms *= 2;
+
+  int64 granularity_us =
+      granularity_ms * base::Time::kMicrosecondsPerMillisecond;
+  int64 run_time_us = run_time.ToInternalValue();
+  int64 remainder = run_time_us % granularity_us;
+  if (remainder == 0)
+    return run_time;
+  return TimeTicks::FromInternalValue(
+      run_time_us - remainder + granularity_us);
+}
+
 MessageLoop::MessagePumpFactory* message_pump_for_ui_factory_ = NULL;
 
 }  // namespace
@@ -127,6 +150,8 @@ MessageLoop::DestructionObserver::~DestructionObserver() {
 
 MessageLoop::MessageLoop(Type type)
     : type_(type),
+      waiting_for_delayed_work_(false),
+      delayed_work_wakeup_count_(0),
       nestable_tasks_allowed_(true),
       exception_restoration_(false),
       message_histogram_(NULL),
@@ -272,6 +297,18 @@ void MessageLoop::PostDelayedTask(
   PostDelayedTask(from_here, task, delay.InMillisecondsRoundedUp());
 }
 
+void MessageLoop::PostDelayedTask(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    base::TimeDelta delay,
+    base::TimeDelta leeway) {
+  DCHECK(!task.is_null()) << from_here.ToString();
+  TimeTicks delayed_run_time = AlignRunTimeToLeeway(
+      CalculateDelayedRuntime(delay.InMillisecondsRoundedUp()), leeway);
+  PendingTask pending_task(from_here, task, delayed_run_time, true);
+  AddToIncomingQueue(&pending_task);
+}
+
 void MessageLoop::PostNonNestableTask(
     const tracked_objects::Location& from_here, const base::Closure& task) {
   DCHECK(!task.is_null()) << from_here.ToString();
@@ -347,6 +384,12 @@ bool MessageLoop::NestableTasksAllowed() const {
   return nestable_tasks_allowed_;
 }
 
+void MessageLoop::SetDelayedTaskCoalescingInterval(TimeDelta interval) {
+  DCHECK_EQ(this, current());
+  DCHECK(delayed_work_queue_.empty());
+  delayed_work_queue_.set_coalescing_interval(interval);
+}
+
 bool MessageLoop::IsNested() {
   return state_->run_depth > 1;
 }
@@ -362,8 +405,8 @@ void MessageLoop::RemoveTaskObserver(TaskObserver* task_observer) {
 }
 
 void MessageLoop::AssertIdle() const {
-  // We only check |incoming_queue_|, since we don't want to lock |work_queue_|.
-  base::AutoLock lock(incoming_queue_lock_);
+  // We only check |incoming_queue_|, since we don't want to touch |work_queue_|
+  // from another thread.
   DCHECK(incoming_queue_.empty());
 }
 
@@ -424,8 +467,7 @@ bool MessageLoop::ProcessNextDelayedNonNestableTask() {
   if (deferred_non_nestable_work_queue_.empty())
     return false;
 
-  PendingTask pending_task = deferred_non_nestable_work_queue_.front();
-  deferred_non_nestable_work_queue_.pop();
+  PendingTask pending_task = deferred_non_nestable_work_queue_.TakeFront();
 
   RunTask(pending_task);
   return true;
@@ -454,10 +496,10 @@ void MessageLoop::RunTask(const PendingTask& pending_task) {
       tracked_objects::ThreadData::NowForStartOfRun(pending_task.birth_tally);
 
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
-                    WillProcessTask(pending_task.time_posted));
+                    WillProcessTask(pending_task));
   pending_task.task.Run();
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
-                    DidProcessTask(pending_task.time_posted));
+                    DidProcessTask(pending_task));
 
   tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
       start_time, tracked_objects::ThreadData::NowForEndOfRun());
@@ -492,26 +534,19 @@ void MessageLoop::AddToDelayedWorkQueue(const PendingTask& pending_task) {
 void MessageLoop::ReloadWorkQueue() {
   // We can improve performance of our loading tasks from incoming_queue_ to
   // work_queue_ by waiting until the last minute (work_queue_ is empty) to
-  // load.  That reduces the number of locks-per-task significantly when our
-  // queues get large.
+  // load.  That reduces the number of atomic operations per task significantly
+  // when our queues get large.
   if (!work_queue_.empty())
-    return;  // Wait till we *really* need to lock and load.
+    return;  // Wait till we *really* need to load.
 
-  // Acquire all we can from the inter-thread queue with one lock acquisition.
-  {
-    base::AutoLock lock(incoming_queue_lock_);
-    if (incoming_queue_.empty())
-      return;
-    incoming_queue_.Swap(&work_queue_);  // Constant time
-    DCHECK(incoming_queue_.empty());
-  }
+  // Acquire all we can from the inter-thread queue with one atomic exchange.
+  incoming_queue_.ReloadInto(&work_queue_);
 }
 
 bool MessageLoop::DeletePendingTasks() {
   bool did_work = !work_queue_.empty();
   while (!work_queue_.empty()) {
-    PendingTask pending_task = work_queue_.front();
-    work_queue_.pop();
+    PendingTask pending_task = work_queue_.TakeFront();
     if (!pending_task.delayed_run_time.is_null()) {
       // We want to delete delayed tasks in the same order in which they would
       // normally be deleted in case of any funny dependencies between delayed
@@ -581,24 +616,38 @@ void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   // directly, as it could starve handling of foreign threads.  Put every task
   // into this queue.
 
-  scoped_refptr<base::MessagePump> pump;
-  {
-    base::AutoLock locked(incoming_queue_lock_);
+  // Since the incoming_queue_ may contain a task that destroys this message
+  // loop, |this| must not be touched once the task has been published.  We
+  // take a stack-based reference to the message pump beforehand so that we can
+  // still call ScheduleWork afterwards.
+  scoped_refptr<base::MessagePump> pump = pump_;
 
-    bool was_empty = incoming_queue_.empty();
-    incoming_queue_.push(*pending_task);
-    pending_task->task.Reset();
-    if (!was_empty)
-      return;  // Someone else should have started the sub-pump.
+  if (!incoming_queue_.Push(pending_task))
+    return;  // Someone else should have started the sub-pump.
 
-    pump = pump_;
+  pump->ScheduleWork();
+}
+
+void MessageLoop::RecordDelayedWorkWakeup() {
+  delayed_work_wakeup_count_++;
+  if (delayed_work_wakeup_period_start_.is_null()) {
+    delayed_work_wakeup_period_start_ = recent_time_;
+    return;
   }
-  // Since the incoming_queue_ may contain a task that destroys this message
-  // loop, we cannot exit incoming_queue_lock_ until we are done with |this|.
-  // We use a stack-based reference to the message pump so that we can call
-  // ScheduleWork outside of incoming_queue_lock_.
 
-  pump->ScheduleWork();
+  const TimeDelta kReportingPeriod = TimeDelta::FromMinutes(1);
+  TimeDelta elapsed = recent_time_ - delayed_work_wakeup_period_start_;
+  if (elapsed < kReportingPeriod)
+    return;
+
+  // Normalize in case the loop was idle for longer than the reporting period.
+  int wakeups_per_minute = static_cast<int>(
+      delayed_work_wakeup_count_ * kReportingPeriod.InSecondsF() /
+      elapsed.InSecondsF());
+  UMA_HISTOGRAM_COUNTS_10000("MessageLoop.DelayedWorkWakeupsPerMinute",
+                             wakeups_per_minute);
+  delayed_work_wakeup_count_ = 0;
+  delayed_work_wakeup_period_start_ = recent_time_;
 }
 
 //------------------------------------------------------------------------------
@@ -636,13 +685,15 @@ bool MessageLoop::DoWork() {
 
     // Execute oldest task.
     do {
-      PendingTask pending_task = work_queue_.front();
-      work_queue_.pop();
+      PendingTask pending_task = work_queue_.TakeFront();
       if (!pending_task.delayed_run_time.is_null()) {
         AddToDelayedWorkQueue(pending_task);
-        // If we changed the topmost task, then it is time to reschedule.
-        if (delayed_work_queue_.top().task.Equals(pending_task.task))
-          pump_->ScheduleDelayedWork(pending_task.delayed_run_time);
+        // If we changed the topmost task, then it is time to reschedule.  Use
+        // the queued copy's run time, which may have been coalesced.
+        if (delayed_work_queue_.top().task.Equals(pending_task.task)) {
+          pump_->ScheduleDelayedWork(
+              delayed_work_queue_.top().delayed_run_time);
+        }
       } else {
         if (DeferOrRunPendingTask(pending_task))
           return true;
@@ -672,10 +723,16 @@ bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
     recent_time_ = TimeTicks::Now();  // Get a better view of Now();
     if (next_run_time > recent_time_) {
       *next_delayed_work_time = next_run_time;
+      waiting_for_delayed_work_ = true;
       return false;
     }
   }
 
+  if (waiting_for_delayed_work_) {
+    waiting_for_delayed_work_ = false;
+    RecordDelayedWorkWakeup();
+  }
+
   PendingTask pending_task = delayed_work_queue_.top();
   delayed_work_queue_.pop();
 
@@ -171,6 +171,17 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
       const base::Closure& task,
       base::TimeDelta delay);
 
+  // Like PostDelayedTask, but lets the task run up to |leeway| after |delay|
+  // has elapsed.  The run time is rounded up to a boundary shared by all
+  // timers with a similar leeway, on this thread and on others, so that timers
+  // that are not latency sensitive wake the process up together rather than
+  // one at a time.
+  void PostDelayedTask(
+      const tracked_objects::Location& from_here,
+      const base::Closure& task,
+      base::TimeDelta delay,
+      base::TimeDelta leeway);
+
   void PostNonNestableTask(
       const tracked_objects::Location& from_here,
       const base::Closure& task);
@@ -295,6 +306,13 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
     bool old_state_;
   };
 
+  // Rounds the run time of delayed tasks up to a multiple of |interval|, so
+  // that timers expiring close to each other run together in a single wakeup
+  // instead of waking the thread once each.  Delayed tasks may then run up to
+  // |interval| late.  A zero interval, the default, keeps exact run times.
+  // Must be called on this loop's thread while no delayed task is queued.
+  void SetDelayedTaskCoalescingInterval(base::TimeDelta interval);
+
   // Enables or disables the restoration during an exception of the unhandled
   // exception filter that was active when Run() was called. This can happen
   // if some third party code call SetUnhandledExceptionFilter() and never
@@ -315,10 +333,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
     TaskObserver();
 
     // This method is called before processing a task.
-    virtual void WillProcessTask(base::TimeTicks time_posted) = 0;
+    virtual void WillProcessTask(const base::PendingTask& pending_task) = 0;
 
     // This method is called after processing a task.
-    virtual void DidProcessTask(base::TimeTicks time_posted) = 0;
+    virtual void DidProcessTask(const base::PendingTask& pending_task) = 0;
 
    protected:
     virtual ~TaskObserver();
@@ -438,8 +456,8 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   void AddToIncomingQueue(base::PendingTask* pending_task);
 
   // Load tasks from the incoming_queue_ into work_queue_ if the latter is
-  // empty.  The former requires a lock to access, while the latter is directly
-  // accessible on this thread.
+  // empty.  The former is shared with posting threads, while the latter is
+  // directly accessible on this thread.
   void ReloadWorkQueue();
 
   // Delete tasks that haven't run yet without running them.  Used in the
@@ -459,6 +477,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // If message_histogram_ is NULL, this is a no-op.
   void HistogramEvent(int event);
 
+  // Counts a wakeup caused by a delayed task becoming ready, and reports the
+  // number of such wakeups per minute.
+  void RecordDelayedWorkWakeup();
+
   // base::MessagePump::Delegate methods:
   virtual bool DoWork() OVERRIDE;
   virtual bool DoDelayedWork(base::TimeTicks* next_delayed_work_time) OVERRIDE;
@@ -476,6 +498,15 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // A recent snapshot of Time::Now(), used to check delayed_work_queue_.
   base::TimeTicks recent_time_;
 
+  // True if the last call to DoDelayedWork found nothing ready and asked the
+  // pump to wait until the next delayed task is due.
+  bool waiting_for_delayed_work_;
+
+  // Number of wakeups counted by RecordDelayedWorkWakeup() since
+  // |delayed_work_wakeup_period_start_|.
+  int delayed_work_wakeup_count_;
+  base::TimeTicks delayed_work_wakeup_period_start_;
+
   // A queue of non-nestable tasks that we had to defer because when it came
   // time to execute them we were in a nested message loop.  They will execute
   // once we're out of nested message loops.
@@ -495,13 +526,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // A profiling histogram showing the counts of various messages and events.
   base::Histogram* message_histogram_;
 
-  // A null terminated list which creates an incoming_queue of tasks that are
-  // acquired under a mutex for processing on this instance's thread. These
-  // tasks have not yet been sorted out into items for our work_queue_ vs items
-  // that will be handled by the TimerManager.
-  base::TaskQueue incoming_queue_;
-  // Protect access to incoming_queue_.
-  mutable base::Lock incoming_queue_lock_;
+  // A lock-free queue of tasks posted from any thread for processing on this
+  // instance's thread. These tasks have not yet been sorted out into items for
+  // our work_queue_ vs items that will be handled by the TimerManager.
+  base::IncomingTaskQueue incoming_queue_;
 
   RunState* state_;
 
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <vector>
 
 #include "base/bind.h"
@@ -11,6 +12,7 @@
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -207,6 +209,64 @@ void RunTest_PostDelayedTask_InDelayOrder(
   EXPECT_TRUE(run_time2 < run_time1);
 }
 
+void RunTest_PostDelayedTask_Coalesced(MessageLoop::Type message_loop_type) {
+  MessageLoop loop(message_loop_type);
+  loop.SetDelayedTaskCoalescingInterval(TimeDelta::FromMilliseconds(50));
+
+  // Coalescing may delay tasks but must never run them early.
+  int num_tasks = 3;
+  Time run_time1, run_time2, run_time3;
+  Time time_before_run = Time::Now();
+
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunTimeFunc, &run_time1, &num_tasks),
+      TimeDelta::FromMilliseconds(30));
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunTimeFunc, &run_time2, &num_tasks),
+      TimeDelta::FromMilliseconds(10));
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunTimeFunc, &run_time3, &num_tasks),
+      TimeDelta::FromMilliseconds(20));
+
+  loop.Run();
+  EXPECT_EQ(0, num_tasks);
+
+  EXPECT_LE(TimeDelta::FromMilliseconds(30), run_time1 - time_before_run);
+  EXPECT_LE(TimeDelta::FromMilliseconds(10), run_time2 - time_before_run);
+  EXPECT_LE(TimeDelta::FromMilliseconds(20), run_time3 - time_before_run);
+}
+
+void RunTest_PostDelayedTask_Leeway(MessageLoop::Type message_loop_type) {
+  MessageLoop loop(message_loop_type);
+
+  // Leeway may delay tasks but must never run them early, and must not
+  // reorder tasks whose aligned run times differ.
+  int num_tasks = 2;
+  Time run_time1, run_time2;
+  Time time_before_run = Time::Now();
+
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunTimeFunc, &run_time1, &num_tasks),
+      TimeDelta::FromMilliseconds(10),
+      TimeDelta::FromMilliseconds(40));
+  loop.PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordRunTimeFunc, &run_time2, &num_tasks),
+      TimeDelta::FromMilliseconds(100),
+      TimeDelta());
+
+  loop.Run();
+  EXPECT_EQ(0, num_tasks);
+
+  EXPECT_LE(TimeDelta::FromMilliseconds(10), run_time1 - time_before_run);
+  EXPECT_LE(TimeDelta::FromMilliseconds(100), run_time2 - time_before_run);
+  EXPECT_TRUE(run_time1 < run_time2);
+}
+
 void RunTest_PostDelayedTask_InPostOrder(
     MessageLoop::Type message_loop_type) {
   MessageLoop loop(message_loop_type);
@@ -1315,6 +1375,18 @@ TEST(MessageLoopTest, PostDelayedTask_InDelayOrder) {
   RunTest_PostDelayedTask_InDelayOrder(MessageLoop::TYPE_IO);
 }
 
+TEST(MessageLoopTest, PostDelayedTask_Coalesced) {
+  RunTest_PostDelayedTask_Coalesced(MessageLoop::TYPE_DEFAULT);
+  RunTest_PostDelayedTask_Coalesced(MessageLoop::TYPE_UI);
+  RunTest_PostDelayedTask_Coalesced(MessageLoop::TYPE_IO);
+}
+
+TEST(MessageLoopTest, PostDelayedTask_Leeway) {
+  RunTest_PostDelayedTask_Leeway(MessageLoop::TYPE_DEFAULT);
+  RunTest_PostDelayedTask_Leeway(MessageLoop::TYPE_UI);
+  RunTest_PostDelayedTask_Leeway(MessageLoop::TYPE_IO);
+}
+
 TEST(MessageLoopTest, PostDelayedTask_InPostOrder) {
   RunTest_PostDelayedTask_InPostOrder(MessageLoop::TYPE_DEFAULT);
   RunTest_PostDelayedTask_InPostOrder(MessageLoop::TYPE_UI);
@@ -1452,16 +1524,16 @@ class DummyTaskObserver : public MessageLoop::TaskObserver {
 
   virtual ~DummyTaskObserver() {}
 
-  virtual void WillProcessTask(TimeTicks time_posted) OVERRIDE {
+  virtual void WillProcessTask(const PendingTask& pending_task) OVERRIDE {
     num_tasks_started_++;
-    EXPECT_TRUE(time_posted != TimeTicks());
+    EXPECT_TRUE(pending_task.time_posted != TimeTicks());
     EXPECT_LE(num_tasks_started_, num_tasks_);
     EXPECT_EQ(num_tasks_started_, num_tasks_processed_ + 1);
   }
 
-  virtual void DidProcessTask(TimeTicks time_posted) OVERRIDE {
+  virtual void DidProcessTask(const PendingTask& pending_task) OVERRIDE {
     num_tasks_processed_++;
-    EXPECT_TRUE(time_posted != TimeTicks());
+    EXPECT_TRUE(pending_task.time_posted != TimeTicks());
     EXPECT_LE(num_tasks_started_, num_tasks_);
     EXPECT_EQ(num_tasks_started_, num_tasks_processed_);
   }
@@ -1616,6 +1688,108 @@ TEST(MessageLoopTest, FileDescriptorWatcherDoubleStop) {
 
 #endif  // defined(OS_POSIX) && !defined(OS_NACL)
 
+namespace {
+
+// Records the order in which tasks posted by several producer threads run on
+// the consumer loop, and quits the loop once all of them have run.
+class PostOrderRecorder {
+ public:
+  PostOrderRecorder(int num_producers, int tasks_per_producer)
+      : next_expected_(num_producers, 0),
+        remaining_(num_producers * tasks_per_producer),
+        out_of_order_(0) {
+  }
+
+  void Record(int producer, int sequence) {
+    if (next_expected_[producer] != sequence)
+      ++out_of_order_;
+    next_expected_[producer] = sequence + 1;
+    if (--remaining_ == 0)
+      MessageLoop::current()->Quit();
+  }
+
+  int out_of_order() const { return out_of_order_; }
+  int remaining() const { return remaining_; }
+
+ private:
+  std::vector<int> next_expected_;
+  int remaining_;
+  int out_of_order_;
+};
+
+class PostingThread : public PlatformThread::Delegate {
+ public:
+  PostingThread(MessageLoop* target_loop,
+                PostOrderRecorder* recorder,
+                base::WaitableEvent* start_event,
+                int producer,
+                int num_tasks)
+      : target_loop_(target_loop),
+        recorder_(recorder),
+        start_event_(start_event),
+        producer_(producer),
+        num_tasks_(num_tasks) {
+  }
+
+  virtual void ThreadMain() OVERRIDE {
+    start_event_->Wait();
+    for (int i = 0; i < num_tasks_; ++i) {
+      target_loop_->PostTask(
+          FROM_HERE,
+          base::Bind(&PostOrderRecorder::Record,
+                     base::Unretained(recorder_), producer_, i));
+    }
+  }
+
+ private:
+  MessageLoop* target_loop_;
+  PostOrderRecorder* recorder_;
+  base::WaitableEvent* start_event_;
+  int producer_;
+  int num_tasks_;
+};
+
+}  // namespace
+
+// Posts from several threads at once to exercise the lock-free incoming queue.
+// Each producer's tasks must run in the order they were posted.  Run with
+// --v=1 to see the posting throughput.
+TEST(MessageLoopTest, PostTaskFromManyThreads) {
+  const int kNumProducers = 8;
+  const int kTasksPerProducer = 10000;
+
+  MessageLoop loop;
+  PostOrderRecorder recorder(kNumProducers, kTasksPerProducer);
+  base::WaitableEvent start_event(true, false);
+
+  std::vector<PostingThread*> delegates;
+  std::vector<base::PlatformThreadHandle> handles(kNumProducers);
+  for (int i = 0; i < kNumProducers; ++i) {
+    delegates.push_back(new PostingThread(&loop, &recorder, &start_event, i,
+                                          kTasksPerProducer));
+    ASSERT_TRUE(PlatformThread::Create(0, delegates[i], &handles[i]));
+  }
+
+  TimeTicks start = TimeTicks::Now();
+  start_event.Signal();
+  loop.Run();
+  TimeDelta elapsed = TimeTicks::Now() - start;
+
+  for (int i = 0; i < kNumProducers; ++i) {
+    PlatformThread::Join(handles[i]);
+    delete delegates[i];
+  }
+
+  EXPECT_EQ(0, recorder.remaining());
+  EXPECT_EQ(0, recorder.out_of_order());
+  VLOG(1) << kNumProducers << " threads posted "
+          << kNumProducers * kTasksPerProducer << " tasks in "
+          << elapsed.InMillisecondsF() << " ms ("
+          << kNumProducers * kTasksPerProducer /
+                 std::max(elapsed.InSecondsF(), 1e-6)
+          << " tasks/s)";
+}
+
 namespace {
 // Inject a test point for recording the destructor calls for Closure objects
 // send to MessageLoop::PostTask(). It is awkward usage since we are trying to
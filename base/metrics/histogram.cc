@@ -22,6 +22,32 @@
 
 namespace base {
 
+namespace {
+
+// Adds |delta| to |*value| without a memory barrier and returns the result.
+// Histogram counts are only read by snapshots, which tolerate slightly
+// stale values, so no ordering with other memory accesses is needed.
+inline Histogram::Count NoBarrierAdd(Histogram::Count* value,
+                                     Histogram::Count delta) {
+  return subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<volatile subtle::Atomic32*>(value), delta);
+}
+
+inline int64 NoBarrierAdd(int64* value, int64 delta) {
+#if defined(ARCH_CPU_64_BITS)
+  return subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<volatile subtle::Atomic64*>(value), delta);
+#else
+  // There are no 64-bit atomics on 32-bit platforms.  A lost update here only
+  // skews the sum or the redundant count, which FindCorruption() already
+  // allows to race with the bucket counts.
+  *value += delta;
+  return *value;
+#endif
+}
+
+}  // namespace
+
 // Static table of checksums for all possible 8 bit bytes.
 const uint32 Histogram::kCrcTable[256] = {0x0, 0x77073096L, 0xee0e612cL,
 0x990951baL, 0x76dc419L, 0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0xedb8832L,
@@ -393,10 +419,10 @@ size_t Histogram::bucket_count() const {
   return bucket_count_;
 }
 
-// Do a safe atomic snapshot of sample data.
-// This implementation assumes we are on a safe single thread.
+// Snapshot the sample data.  Samples may be accumulated concurrently, so the
+// snapshot is not guaranteed to be consistent; FindCorruption() allows for
+// this.
 void Histogram::SnapshotSample(SampleSet* sample) const {
-  // Note locking not done in this version!!!
   *sample = sample_;
 }
 
@@ -551,9 +577,9 @@ const std::string Histogram::GetAsciiBucketRange(size_t i) const {
   return result;
 }
 
-// Update histogram data with new sample.
+// Update histogram data with new sample.  This is safe to call from any
+// thread; see SampleSet::Accumulate().
 void Histogram::Accumulate(Sample value, Count count, size_t index) {
-  // Note locking not done in this version!!!
   sample_.Accumulate(value, count, index);
 }
 
@@ -721,12 +747,13 @@ void Histogram::SampleSet::CheckSize(const Histogram& histogram) const {
 void Histogram::SampleSet::Accumulate(Sample value,  Count count,
                                       size_t index) {
   DCHECK(count == 1 || count == -1);
-  counts_[index] += count;
-  sum_ += count * value;
-  redundant_count_ += count;
-  DCHECK_GE(counts_[index], 0);
-  DCHECK_GE(sum_, 0);
-  DCHECK_GE(redundant_count_, 0);
+  Count bucket_count = NoBarrierAdd(&counts_[index], count);
+  int64 sum = NoBarrierAdd(&sum_, static_cast<int64>(count) * value);
+  int64 redundant_count = NoBarrierAdd(&redundant_count_,
+                                       static_cast<int64>(count));
+  DCHECK_GE(bucket_count, 0);
+  DCHECK_GE(sum, 0);
+  DCHECK_GE(redundant_count, 0);
 }
 
 Count Histogram::SampleSet::TotalCount() const {
@@ -1042,6 +1069,72 @@ double CustomHistogram::GetBucketSize(Count current, size_t i) const {
 // as startup/teardown of this service.
 //------------------------------------------------------------------------------
 
+// A fixed-size chained hash table from histogram name to histogram.  Insert()
+// must be serialized by the caller; Find() may run concurrently with Insert()
+// on any thread.  Nodes are never removed until the index is destroyed.
+class StatisticsRecorder::HistogramIndex {
+ public:
+  HistogramIndex() {
+    for (size_t i = 0; i < arraysize(buckets_); ++i)
+      buckets_[i] = 0;
+  }
+
+  ~HistogramIndex() {
+    for (size_t i = 0; i < arraysize(buckets_); ++i) {
+      Node* node = reinterpret_cast<Node*>(buckets_[i]);
+      while (node) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+      }
+    }
+  }
+
+  void Insert(Histogram* histogram) {
+    Node* node = new Node;
+    node->hash = Hash(histogram->histogram_name());
+    node->histogram = histogram;
+    subtle::AtomicWord* bucket = &buckets_[node->hash % arraysize(buckets_)];
+    node->next = reinterpret_cast<Node*>(subtle::NoBarrier_Load(bucket));
+    // Publish the fully constructed node.
+    subtle::Release_Store(bucket, reinterpret_cast<subtle::AtomicWord>(node));
+  }
+
+  Histogram* Find(const std::string& name) const {
+    uint32 hash = Hash(name);
+    const Node* node = reinterpret_cast<const Node*>(
+        subtle::Acquire_Load(&buckets_[hash % arraysize(buckets_)]));
+    for (; node; node = node->next) {
+      if (node->hash == hash && node->histogram->histogram_name() == name)
+        return node->histogram;
+    }
+    return NULL;
+  }
+
+ private:
+  struct Node {
+    uint32 hash;
+    Histogram* histogram;
+    // Written before the node is published and never changed afterwards.
+    Node* next;
+  };
+
+  // 32-bit FNV-1a; histogram names are short, so this is cheap.
+  static uint32 Hash(const std::string& name) {
+    uint32 hash = 2166136261u;
+    for (size_t i = 0; i < name.size(); ++i) {
+      hash ^= static_cast<uint8>(name[i]);
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+
+  // Processes typically register a few hundred to a few thousand histograms.
+  subtle::AtomicWord buckets_[1024];
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramIndex);
+};
+
 // This singleton instance should be started during the single threaded portion
 // of main(), and hence it is not thread safe.  It initializes globals to
 // provide support for all future calls.
@@ -1059,6 +1152,8 @@ StatisticsRecorder::StatisticsRecorder() {
   base::AutoLock auto_lock(*lock_);
   histograms_ = new HistogramMap;
   ranges_ = new RangesMap;
+  subtle::Release_Store(&index_, reinterpret_cast<subtle::AtomicWord>(
+      new HistogramIndex));
 }
 
 StatisticsRecorder::~StatisticsRecorder() {
@@ -1082,9 +1177,14 @@ StatisticsRecorder::~StatisticsRecorder() {
     ranges = ranges_;
     ranges_ = NULL;
   }
+  // Like the rest of this class's teardown, this assumes that no other thread
+  // is still looking up histograms.
+  HistogramIndex* index = reinterpret_cast<HistogramIndex*>(
+      subtle::NoBarrier_AtomicExchange(&index_, 0));
   // We are going to leak the histograms and the ranges.
   delete histograms;
   delete ranges;
+  delete index;
   // We don't delete lock_ on purpose to avoid having to properly protect
   // against it going away after we checked for NULL in the static methods.
 }
@@ -1118,6 +1218,8 @@ Histogram* StatisticsRecorder::RegisterOrDeleteDuplicate(Histogram* histogram) {
   // Avoid overwriting a previous registration.
   if (histograms_->end() == it) {
     (*histograms_)[name] = histogram;
+    reinterpret_cast<HistogramIndex*>(subtle::NoBarrier_Load(&index_))->Insert(
+        histogram);
     ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
     RegisterOrDeleteDuplicateRanges(histogram);
     ++number_of_histograms_;
@@ -1268,15 +1370,14 @@ void StatisticsRecorder::GetHistograms(Histograms* output) {
 
 bool StatisticsRecorder::FindHistogram(const std::string& name,
                                        Histogram** histogram) {
-  if (lock_ == NULL)
+  const HistogramIndex* index = reinterpret_cast<const HistogramIndex*>(
+      subtle::Acquire_Load(&index_));
+  if (!index)
     return false;
-  base::AutoLock auto_lock(*lock_);
-  if (!histograms_)
+  Histogram* found = index->Find(name);
+  if (!found)
     return false;
-  HistogramMap::iterator it = histograms_->find(name);
-  if (histograms_->end() == it)
-    return false;
-  *histogram = it->second;
+  *histogram = found;
   return true;
 }
 
@@ -1327,6 +1428,8 @@ StatisticsRecorder::HistogramMap* StatisticsRecorder::histograms_ = NULL;
 // static
 StatisticsRecorder::RangesMap* StatisticsRecorder::ranges_ = NULL;
 // static
+subtle::AtomicWord StatisticsRecorder::index_ = 0;
+// static
 base::Lock* StatisticsRecorder::lock_ = NULL;
 // static
 bool StatisticsRecorder::dump_on_exit_ = false;
@@ -391,7 +391,11 @@ class BASE_EXPORT Histogram {
     void Resize(const Histogram& histogram);
     void CheckSize(const Histogram& histogram) const;
 
-    // Accessor for histogram to make routine additions.
+    // Accessor for histogram to make routine additions.  The bucket count,
+    // sum and redundant count are each updated with a relaxed atomic
+    // increment, so concurrent calls from several threads do not lose
+    // samples.  The three updates are not made atomically as a group, so a
+    // concurrent snapshot may still see them briefly disagree.
     void Accumulate(Sample value, Count count, size_t index);
 
     // Accessor methods.
@@ -820,8 +824,8 @@ class BASE_EXPORT StatisticsRecorder {
   static void GetHistograms(Histograms* output);
 
   // Find a histogram by name. It matches the exact name. This method is thread
-  // safe.  If a matching histogram is not found, then the |histogram| is
-  // not changed.
+  // safe, and does not take |lock_|.  If a matching histogram is not found,
+  // then the |histogram| is not changed.
   static bool FindHistogram(const std::string& query, Histogram** histogram);
 
   static bool dump_on_exit() { return dump_on_exit_; }
@@ -848,7 +852,14 @@ class BASE_EXPORT StatisticsRecorder {
 
   static RangesMap* ranges_;
 
-  // lock protects access to the above map.
+  // Hash index over |histograms_| that FindHistogram() reads without taking
+  // |lock_|.  Entries are only ever added, under |lock_|, so readers just
+  // follow release-published pointers.
+  class HistogramIndex;
+  static base::subtle::AtomicWord index_;
+
+  // lock protects access to the above maps, and serializes additions to
+  // |index_|.
   static base::Lock* lock_;
 
   // Dump all known histograms to log.
@@ -9,6 +9,8 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
+#include "base/stringprintf.h"
+#include "base/threading/simple_thread.h"
 #include "base/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -347,6 +349,112 @@ TEST(HistogramTest, BucketPlacementTest) {
     EXPECT_EQ(i + 1, sample.counts(i));
 }
 
+// Adds |count| samples of |value| to |histogram|.
+class HistogramAdder : public DelegateSimpleThread::Delegate {
+ public:
+  HistogramAdder(Histogram* histogram, int value, int count)
+      : histogram_(histogram), value_(value), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i)
+      histogram_->Add(value_);
+  }
+
+ private:
+  Histogram* histogram_;
+  const int value_;
+  const int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramAdder);
+};
+
+// Samples added from several threads at once must not be lost.
+TEST(HistogramTest, ConcurrentAdd) {
+  StatisticsRecorder recorder;
+  Histogram* histogram(LinearHistogram::FactoryGet(
+      "ConcurrentHistogram", 1, 10, 10, Histogram::kNoFlags));
+
+  const int kThreadCount = 8;
+  const int kSamplesPerThread = 10000;
+  std::vector<HistogramAdder*> adders;
+  std::vector<DelegateSimpleThread*> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    // Every other thread shares a bucket, so buckets see contention too.
+    adders.push_back(new HistogramAdder(histogram, 1 + i % 2,
+                                        kSamplesPerThread));
+    threads.push_back(new DelegateSimpleThread(adders.back(), "adder"));
+    threads.back()->Start();
+  }
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads[i]->Join();
+    delete threads[i];
+    delete adders[i];
+  }
+
+  Histogram::SampleSet sample;
+  histogram->SnapshotSample(&sample);
+  EXPECT_EQ(kThreadCount * kSamplesPerThread, sample.TotalCount());
+  EXPECT_EQ(kThreadCount * kSamplesPerThread, sample.redundant_count());
+  EXPECT_EQ(kThreadCount / 2 * kSamplesPerThread * 3, sample.sum());
+  EXPECT_EQ(0, histogram->FindCorruption(sample));
+}
+
+// Registers |count| histograms named "<prefix>N".
+class HistogramRegisterer : public DelegateSimpleThread::Delegate {
+ public:
+  HistogramRegisterer(const std::string& prefix, int count)
+      : prefix_(prefix), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i) {
+      Histogram::FactoryGet(StringPrintf("%s%d", prefix_.c_str(), i),
+                            1, 100, 10, Histogram::kNoFlags);
+    }
+  }
+
+ private:
+  const std::string prefix_;
+  const int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramRegisterer);
+};
+
+// FindHistogram() does not take the recorder's lock, so check that lookups
+// racing with registrations on other threads still resolve every name to the
+// single registered histogram.
+TEST(HistogramTest, ConcurrentRegistration) {
+  StatisticsRecorder recorder;
+
+  const int kThreadCount = 4;
+  const int kHistogramCount = 500;
+  std::vector<HistogramRegisterer*> registerers;
+  std::vector<DelegateSimpleThread*> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    // All threads register the same names, so most calls find a duplicate.
+    registerers.push_back(new HistogramRegisterer("Race", kHistogramCount));
+    threads.push_back(new DelegateSimpleThread(registerers.back(), "reg"));
+    threads.back()->Start();
+  }
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads[i]->Join();
+    delete threads[i];
+    delete registerers[i];
+  }
+
+  StatisticsRecorder::Histograms histograms;
+  StatisticsRecorder::GetHistograms(&histograms);
+  EXPECT_EQ(static_cast<size_t>(kHistogramCount), histograms.size());
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    Histogram* found = NULL;
+    EXPECT_TRUE(StatisticsRecorder::FindHistogram(
+        histograms[i]->histogram_name(), &found));
+    EXPECT_EQ(histograms[i], found);
+  }
+  Histogram* missing = NULL;
+  EXPECT_FALSE(StatisticsRecorder::FindHistogram("RaceMissing", &missing));
+  EXPECT_EQ(reinterpret_cast<Histogram*>(NULL), missing);
+}
+
 }  // namespace
 
 //------------------------------------------------------------------------------
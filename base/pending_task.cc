@@ -4,6 +4,7 @@
 
 #include "base/pending_task.h"
 
+#include "base/logging.h"
 #include "base/tracked_objects.h"
 
 namespace base {
@@ -51,4 +52,156 @@ void TaskQueue::Swap(TaskQueue* queue) {
   c.swap(queue->c);  // Calls std::deque::swap.
 }
 
+void TaskQueue::MoveToBack(PendingTask* pending_task) {
+  Closure task;
+  task.Swap(&pending_task->task);
+  push(*pending_task);
+  back().task.Swap(&task);
+}
+
+PendingTask TaskQueue::TakeFront() {
+  Closure task;
+  task.Swap(&front().task);
+  PendingTask pending_task(front());
+  pop();
+  pending_task.task.Swap(&task);
+  return pending_task;
+}
+
+DelayedTaskQueue::DelayedTaskQueue() : bucketed_task_count_(0) {
+}
+
+DelayedTaskQueue::~DelayedTaskQueue() {
+}
+
+void DelayedTaskQueue::set_coalescing_interval(TimeDelta interval) {
+  DCHECK(empty());
+  DCHECK_GE(interval.InMicroseconds(), 0);
+  coalescing_interval_ = interval;
+}
+
+void DelayedTaskQueue::push(const PendingTask& pending_task) {
+  int64 interval = coalescing_interval_.InMicroseconds();
+  if (interval <= 0) {
+    heap_.push(pending_task);
+    return;
+  }
+
+  // Round up so that coalescing only ever delays a task.
+  int64 run_time = pending_task.delayed_run_time.ToInternalValue();
+  int64 remainder = run_time % interval;
+  if (remainder < 0)
+    remainder += interval;
+  int64 bucket_time = remainder ? run_time - remainder + interval : run_time;
+
+  TaskQueue& bucket = buckets_[bucket_time];
+  bucket.push(pending_task);
+  bucket.back().delayed_run_time = TimeTicks::FromInternalValue(bucket_time);
+  bucketed_task_count_++;
+}
+
+const PendingTask& DelayedTaskQueue::top() const {
+  if (coalescing_interval_.InMicroseconds() <= 0)
+    return heap_.top();
+  DCHECK(!buckets_.empty());
+  return buckets_.begin()->second.front();
+}
+
+void DelayedTaskQueue::pop() {
+  if (coalescing_interval_.InMicroseconds() <= 0) {
+    heap_.pop();
+    return;
+  }
+  DCHECK(!buckets_.empty());
+  BucketMap::iterator bucket = buckets_.begin();
+  bucket->second.pop();
+  if (bucket->second.empty())
+    buckets_.erase(bucket);
+  bucketed_task_count_--;
+}
+
+bool DelayedTaskQueue::empty() const {
+  return heap_.empty() && buckets_.empty();
+}
+
+size_t DelayedTaskQueue::size() const {
+  return heap_.size() + bucketed_task_count_;
+}
+
+struct IncomingTaskQueue::Node {
+  explicit Node(const PendingTask& pending_task)
+      : pending_task(pending_task),
+        next(NULL) {
+  }
+
+  PendingTask pending_task;
+  Node* next;
+};
+
+IncomingTaskQueue::IncomingTaskQueue() : head_(0) {
+}
+
+IncomingTaskQueue::~IncomingTaskQueue() {
+  Node* node = reinterpret_cast<Node*>(
+      subtle::NoBarrier_AtomicExchange(&head_, 0));
+  while (node) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+bool IncomingTaskQueue::Push(PendingTask* pending_task) {
+  Closure task;
+  task.Swap(&pending_task->task);
+  Node* node = new Node(*pending_task);
+  node->pending_task.task.Swap(&task);
+
+  subtle::AtomicWord head = subtle::NoBarrier_Load(&head_);
+  for (;;) {
+    node->next = reinterpret_cast<Node*>(head);
+    // The release barrier makes the contents of |node| visible to the consumer
+    // before the node itself is.
+    subtle::AtomicWord previous = subtle::Release_CompareAndSwap(
+        &head_, head, reinterpret_cast<subtle::AtomicWord>(node));
+    if (previous == head)
+      break;
+    head = previous;
+  }
+  return head == 0;
+}
+
+bool IncomingTaskQueue::ReloadInto(TaskQueue* work_queue) {
+  if (empty())
+    return false;
+
+  Node* node = reinterpret_cast<Node*>(
+      subtle::NoBarrier_AtomicExchange(&head_, 0));
+  // Pairs with the release barrier in Push().
+  subtle::MemoryBarrier();
+  if (!node)
+    return false;
+
+  // The list is in LIFO order; reverse it so tasks run in posting order.
+  Node* reversed = NULL;
+  while (node) {
+    Node* next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+
+  while (reversed) {
+    Node* next = reversed->next;
+    work_queue->MoveToBack(&reversed->pending_task);
+    delete reversed;
+    reversed = next;
+  }
+  return true;
+}
+
+bool IncomingTaskQueue::empty() const {
+  return subtle::NoBarrier_Load(&head_) == 0;
+}
+
 }  // namespace base
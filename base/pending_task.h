@@ -6,9 +6,12 @@
 #define PENDING_TASK_H_
 #pragma once
 
+#include <map>
 #include <queue>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
+#include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/location.h"
 #include "base/time.h"
@@ -44,14 +47,104 @@ struct BASE_EXPORT PendingTask : public TrackingInfo {
 };
 
 // Wrapper around std::queue specialized for PendingTask which adds a Swap
-// helper method.
+// helper method, and helpers that transfer a task's closure instead of
+// copying it.  Copying a closure costs an atomic increment and, later, an
+// atomic decrement of its bound state's reference count, which adds up when
+// every posted task passes through several queues.
 class BASE_EXPORT TaskQueue : public std::queue<PendingTask> {
  public:
   void Swap(TaskQueue* queue);
+
+  // Adds |pending_task| to the back of the queue, leaving pending_task->task
+  // null.
+  void MoveToBack(PendingTask* pending_task);
+
+  // Removes the task at the front of the queue and returns it.  The queue must
+  // not be empty.
+  PendingTask TakeFront();
+};
+
+// Holds PendingTasks sorted by their |delayed_run_time| property, with the
+// soonest task on top.  The interface mirrors std::priority_queue.
+//
+// By default tasks keep their exact run time and are kept in a binary heap.
+// After set_coalescing_interval() has been called with a non-zero interval,
+// each task's |delayed_run_time| is rounded up to the next multiple of the
+// interval and tasks that land on the same boundary are kept together in a
+// single FIFO bucket.  Pushing onto an existing bucket and popping are then
+// constant time, and all the tasks in a bucket become ready at once, so a loop
+// wakes up once per interval at most instead of once per timer.  Tasks never
+// run early; they may run up to one interval late.
+class BASE_EXPORT DelayedTaskQueue {
+ public:
+  DelayedTaskQueue();
+  ~DelayedTaskQueue();
+
+  // Sets the interval that run times are rounded up to.  A zero interval
+  // disables coalescing.  Must be called while the queue is empty.
+  void set_coalescing_interval(TimeDelta interval);
+  TimeDelta coalescing_interval() const { return coalescing_interval_; }
+
+  void push(const PendingTask& pending_task);
+
+  // Returns the task that should run first.  The queue must not be empty.
+  const PendingTask& top() const;
+
+  // Removes the task returned by top().
+  void pop();
+
+  bool empty() const;
+  size_t size() const;
+
+ private:
+  // Buckets of tasks keyed by their rounded run time, in microseconds.
+  typedef std::map<int64, TaskQueue> BucketMap;
+
+  TimeDelta coalescing_interval_;
+
+  // Used when coalescing is disabled.
+  std::priority_queue<PendingTask> heap_;
+
+  // Used when coalescing is enabled.
+  BucketMap buckets_;
+  size_t bucketed_task_count_;
 };
 
-// PendingTasks are sorted by their |delayed_run_time| property.
-typedef std::priority_queue<base::PendingTask> DelayedTaskQueue;
+// A multi-producer, single-consumer queue of PendingTasks that never takes a
+// lock.  Any thread may call Push(), but only a single consumer thread may call
+// ReloadInto().  Producers link their task onto an intrusive singly linked
+// list with one compare-and-swap; the consumer detaches the whole list with
+// one atomic exchange and hands the tasks over in the order they were pushed.
+class BASE_EXPORT IncomingTaskQueue {
+ public:
+  IncomingTaskQueue();
+  // Deletes any tasks that are still queued.
+  ~IncomingTaskQueue();
+
+  // Adds |pending_task| to the queue.  Like MessageLoop::AddToIncomingQueue,
+  // this takes over pending_task->task, leaving it null, so that the posting
+  // thread never holds the last reference to the task.  Returns true if the
+  // queue was empty, in which case the caller is responsible for waking up the
+  // consumer.
+  bool Push(PendingTask* pending_task);
+
+  // Appends every queued task to |work_queue| in FIFO order.  Returns true if
+  // any task was moved.  Must only be called from the consumer thread.
+  bool ReloadInto(TaskQueue* work_queue);
+
+  // Returns true if there are no queued tasks.  The answer may be stale by the
+  // time it is returned if other threads are pushing concurrently.
+  bool empty() const;
+
+ private:
+  struct Node;
+
+  // The most recently pushed Node, or NULL.  Each Node points to the one that
+  // was pushed before it.
+  subtle::AtomicWord head_;
+
+  DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
+};
 
 }  // namespace base
 
@@ -0,0 +1,74 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/pending_task.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+PendingTask MakeDelayedTask(int64 run_time_us, int sequence_num) {
+  PendingTask pending_task(FROM_HERE, Bind(&DoNothing),
+                           TimeTicks::FromInternalValue(run_time_us), true);
+  pending_task.sequence_num = sequence_num;
+  return pending_task;
+}
+
+}  // namespace
+
+TEST(DelayedTaskQueueTest, ExactOrder) {
+  DelayedTaskQueue queue;
+  queue.push(MakeDelayedTask(3000, 0));
+  queue.push(MakeDelayedTask(1000, 1));
+  queue.push(MakeDelayedTask(2000, 2));
+  queue.push(MakeDelayedTask(1000, 3));
+  EXPECT_EQ(4u, queue.size());
+
+  EXPECT_EQ(1, queue.top().sequence_num);
+  EXPECT_EQ(1000, queue.top().delayed_run_time.ToInternalValue());
+  queue.pop();
+  EXPECT_EQ(3, queue.top().sequence_num);
+  queue.pop();
+  EXPECT_EQ(2, queue.top().sequence_num);
+  queue.pop();
+  EXPECT_EQ(3000, queue.top().delayed_run_time.ToInternalValue());
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(DelayedTaskQueueTest, Coalescing) {
+  DelayedTaskQueue queue;
+  queue.set_coalescing_interval(TimeDelta::FromMicroseconds(1000));
+
+  // 1500 and 1999 share the bucket ending at 2000; 2000 is already on a
+  // boundary and joins them.  3001 lands in the bucket ending at 4000.
+  queue.push(MakeDelayedTask(3001, 0));
+  queue.push(MakeDelayedTask(1999, 1));
+  queue.push(MakeDelayedTask(2000, 2));
+  queue.push(MakeDelayedTask(1500, 3));
+  EXPECT_EQ(4u, queue.size());
+
+  // Tasks in a bucket come out in the order they were pushed, and never
+  // earlier than requested.
+  EXPECT_EQ(1, queue.top().sequence_num);
+  EXPECT_EQ(2000, queue.top().delayed_run_time.ToInternalValue());
+  queue.pop();
+  EXPECT_EQ(2, queue.top().sequence_num);
+  EXPECT_EQ(2000, queue.top().delayed_run_time.ToInternalValue());
+  queue.pop();
+  EXPECT_EQ(3, queue.top().sequence_num);
+  EXPECT_EQ(2000, queue.top().delayed_run_time.ToInternalValue());
+  queue.pop();
+  EXPECT_EQ(0, queue.top().sequence_num);
+  EXPECT_EQ(4000, queue.top().delayed_run_time.ToInternalValue());
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0u, queue.size());
+}
+
+}  // namespace base
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 
 #include <algorithm>  // for max()
+#include <limits>
 
 //------------------------------------------------------------------------------
 
@@ -144,6 +145,30 @@ bool PickleIterator::ReadBytes(const char** data, int length) {
   return true;
 }
 
+bool PickleIterator::ReadStringPiece(base::StringPiece* result) {
+  int len;
+  if (!ReadInt(&len))
+    return false;
+  const char* read_from = GetReadPointerAndAdvance(len);
+  if (!read_from)
+    return false;
+
+  result->set(read_from, len);
+  return true;
+}
+
+bool PickleIterator::ReadStringPiece16(base::StringPiece16* result) {
+  int len;
+  if (!ReadInt(&len))
+    return false;
+  const char* read_from = GetReadPointerAndAdvance(len, sizeof(char16));
+  if (!read_from)
+    return false;
+
+  result->set(reinterpret_cast<const char16*>(read_from), len);
+  return true;
+}
+
 // Payload is uint32 aligned.
 
 Pickle::Pickle()
@@ -224,14 +249,16 @@ Pickle& Pickle::operator=(const Pickle& other) {
 }
 
 bool Pickle::WriteString(const std::string& value) {
-  if (!WriteInt(static_cast<int>(value.size())))
+  if (!Reserve(sizeof(int) + value.size()) ||
+      !WriteInt(static_cast<int>(value.size())))
     return false;
 
   return WriteBytes(value.data(), static_cast<int>(value.size()));
 }
 
 bool Pickle::WriteWString(const std::wstring& value) {
-  if (!WriteInt(static_cast<int>(value.size())))
+  if (!Reserve(sizeof(int) + value.size() * sizeof(wchar_t)) ||
+      !WriteInt(static_cast<int>(value.size())))
     return false;
 
   return WriteBytes(value.data(),
@@ -239,7 +266,8 @@ bool Pickle::WriteWString(const std::wstring& value) {
 }
 
 bool Pickle::WriteString16(const string16& value) {
-  if (!WriteInt(static_cast<int>(value.size())))
+  if (!Reserve(sizeof(int) + value.size() * sizeof(char16)) ||
+      !WriteInt(static_cast<int>(value.size())))
     return false;
 
   return WriteBytes(value.data(),
@@ -247,7 +275,8 @@ bool Pickle::WriteString16(const string16& value) {
 }
 
 bool Pickle::WriteData(const char* data, int length) {
-  return length >= 0 && WriteInt(length) && WriteBytes(data, length);
+  return length >= 0 && Reserve(sizeof(int) + length) && WriteInt(length) &&
+      WriteBytes(data, length);
 }
 
 bool Pickle::WriteBytes(const void* data, int data_len) {
@@ -300,6 +329,20 @@ void Pickle::TrimWriteData(int new_length) {
   *cur_length = new_length;
 }
 
+bool Pickle::Reserve(size_t additional_payload_size) {
+  DCHECK_NE(kCapacityReadOnly, capacity_) << "oops: pickle is readonly";
+
+  // Leave room for the padding of every write as well.
+  size_t needed_size = header_size_ +
+      AlignInt(header_->payload_size, sizeof(uint32)) +
+      AlignInt(additional_payload_size, sizeof(uint32));
+  if (needed_size < additional_payload_size)
+    return false;
+  if (needed_size <= capacity_)
+    return true;
+  return Resize(std::max(capacity_ * 2, needed_size));
+}
+
 char* Pickle::BeginWrite(size_t length) {
   // write at a uint32-aligned offset from the beginning of the header
   size_t offset = AlignInt(header_->payload_size, sizeof(uint32));
@@ -355,3 +398,24 @@ const char* Pickle::FindNext(size_t header_size,
 
   return (payload_end > end) ? NULL : payload_end;
 }
+
+// static
+bool Pickle::PeekNext(size_t header_size,
+                      const char* start,
+                      const char* end,
+                      size_t* pickle_size) {
+  DCHECK_EQ(header_size, AlignInt(header_size, sizeof(uint32)));
+  DCHECK_LE(header_size, static_cast<size_t>(kPayloadUnit));
+
+  size_t length = static_cast<size_t>(end - start);
+  if (length < sizeof(Header))
+    return false;
+
+  const Header* hdr = reinterpret_cast<const Header*>(start);
+  if (length < header_size ||
+      hdr->payload_size > std::numeric_limits<size_t>::max() - header_size)
+    return false;
+
+  *pickle_size = header_size + hdr->payload_size;
+  return true;
+}
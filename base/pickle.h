@@ -14,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 class Pickle;
 
@@ -41,6 +42,12 @@ class BASE_EXPORT PickleIterator {
   bool ReadData(const char** data, int* length) WARN_UNUSED_RESULT;
   bool ReadBytes(const char** data, int length) WARN_UNUSED_RESULT;
 
+  // Like ReadString() and ReadString16(), but instead of copying the string
+  // out, |result| points into the Pickle's buffer.  It stays valid only as
+  // long as the Pickle's data does.
+  bool ReadStringPiece(base::StringPiece* result) WARN_UNUSED_RESULT;
+  bool ReadStringPiece16(base::StringPiece16* result) WARN_UNUSED_RESULT;
+
   // Safer version of ReadInt() checks for the result not being negative.
   // Use it for reading the object sizes.
   bool ReadLength(int* result) WARN_UNUSED_RESULT {
@@ -238,6 +245,13 @@ class BASE_EXPORT Pickle {
   // not been changed.
   void TrimWriteData(int length);
 
+  // Makes sure that |additional_payload_size| more bytes of payload can be
+  // written without growing the buffer again.  Writers that know roughly how
+  // much they are about to write can use this to skip the intermediate
+  // reallocations (and copies) of the doubling growth.  Returns false if the
+  // allocation failed.
+  bool Reserve(size_t additional_payload_size);
+
   // Payload follows after allocation of Header (header size is customizable).
   struct Header {
     uint32 payload_size;  // Specifies the size of the payload.
@@ -311,6 +325,16 @@ class BASE_EXPORT Pickle {
                               const char* range_start,
                               const char* range_end);
 
+  // Reads the header of the pickled data that starts at range_start and
+  // stores the total size of that Pickle, header included, in |pickle_size|.
+  // Unlike FindNext() the data doesn't need to be complete: only the header
+  // has to be in range.  Returns false if the header isn't in range yet or
+  // the size would overflow.
+  static bool PeekNext(size_t header_size,
+                       const char* range_start,
+                       const char* range_end,
+                       size_t* pickle_size);
+
   // The allocation granularity of the payload.
   static const int kPayloadUnit;
 
@@ -326,6 +350,8 @@ class BASE_EXPORT Pickle {
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, PeekNext);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, Reserve);
 };
 
 #endif  // BASE_PICKLE_H__
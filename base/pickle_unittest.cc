@@ -8,6 +8,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/string16.h"
+#include "base/utf_string_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace {
@@ -188,6 +189,27 @@ TEST(PickleTest, FindNextWithIncompleteHeader) {
   EXPECT_TRUE(NULL == Pickle::FindNext(header_size, start, end));
 }
 
+TEST(PickleTest, PeekNext) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(1));
+  EXPECT_TRUE(pickle.WriteString("Domo"));
+
+  const char* start = reinterpret_cast<const char*>(pickle.data());
+  const char* end = start + pickle.size();
+
+  // Only the header needs to be present.
+  size_t pickle_size = 0;
+  EXPECT_TRUE(Pickle::PeekNext(pickle.header_size_, start, end, &pickle_size));
+  EXPECT_EQ(pickle.size(), pickle_size);
+  pickle_size = 0;
+  EXPECT_TRUE(Pickle::PeekNext(pickle.header_size_, start,
+                               start + pickle.header_size_, &pickle_size));
+  EXPECT_EQ(pickle.size(), pickle_size);
+  EXPECT_FALSE(Pickle::PeekNext(pickle.header_size_, start,
+                                start + pickle.header_size_ - 1,
+                                &pickle_size));
+}
+
 TEST(PickleTest, GetReadPointerAndAdvance) {
   Pickle pickle;
 
@@ -334,3 +356,59 @@ TEST(PickleTest, ReadBytes) {
   memcpy(&outdata, outdata_char, sizeof(outdata));
   EXPECT_EQ(data, outdata);
 }
+
+TEST(PickleTest, ReadStringPiece) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteString(teststr));
+  string16 teststr16 = ASCIIToUTF16(teststr);
+  EXPECT_TRUE(pickle.WriteString16(teststr16));
+  EXPECT_TRUE(pickle.WriteString(std::string()));
+
+  PickleIterator iter(pickle);
+  base::StringPiece piece;
+  EXPECT_TRUE(iter.ReadStringPiece(&piece));
+  EXPECT_EQ(teststr, piece.as_string());
+  // The piece points into the pickle rather than at a copy.
+  EXPECT_GE(piece.data(), reinterpret_cast<const char*>(pickle.data()));
+  EXPECT_LT(piece.data(),
+            reinterpret_cast<const char*>(pickle.data()) + pickle.size());
+
+  base::StringPiece16 piece16;
+  EXPECT_TRUE(iter.ReadStringPiece16(&piece16));
+  EXPECT_EQ(teststr16, piece16.as_string());
+
+  EXPECT_TRUE(iter.ReadStringPiece(&piece));
+  EXPECT_TRUE(piece.empty());
+
+  EXPECT_FALSE(iter.ReadStringPiece(&piece));
+  EXPECT_FALSE(iter.ReadStringPiece16(&piece16));
+}
+
+TEST(PickleTest, BadLenStringPiece) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(-2));
+
+  PickleIterator iter(pickle);
+  base::StringPiece piece;
+  EXPECT_FALSE(iter.ReadStringPiece(&piece));
+}
+
+TEST(PickleTest, Reserve) {
+  Pickle pickle;
+  const size_t kSize = 100 * Pickle::kPayloadUnit;
+  EXPECT_TRUE(pickle.Reserve(kSize));
+  size_t capacity = pickle.capacity();
+  EXPECT_LE(kSize, capacity);
+
+  // Writes within the reservation don't grow the buffer.
+  std::string data(Pickle::kPayloadUnit - sizeof(int), 'x');
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(pickle.WriteString(data));
+  EXPECT_EQ(capacity, pickle.capacity());
+  EXPECT_EQ(kSize, pickle.payload_size());
+
+  PickleIterator iter(pickle);
+  std::string outstr;
+  EXPECT_TRUE(pickle.ReadString(&iter, &outstr));
+  EXPECT_EQ(data, outstr);
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/string_builder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+
+namespace base {
+
+namespace {
+
+// The first heap buffer of a builder that started out without one.
+const size_t kMinHeapCapacity = 64;
+
+}  // namespace
+
+StringBuilder::StringBuilder()
+    : data_(NULL),
+      length_(0),
+      capacity_(0) {
+}
+
+StringBuilder::StringBuilder(char* buffer, size_t capacity)
+    : data_(buffer),
+      length_(0),
+      capacity_(capacity) {
+}
+
+StringBuilder::~StringBuilder() {
+}
+
+void StringBuilder::Append(const StringPiece& str) {
+  if (str.empty())
+    return;
+  Reserve(str.size());
+  memcpy(data_ + length_, str.data(), str.size());
+  length_ += str.size();
+}
+
+void StringBuilder::AppendChar(char c) {
+  Reserve(1);
+  data_[length_++] = c;
+}
+
+void StringBuilder::Reserve(size_t extra) {
+  if (capacity_ - length_ >= extra)
+    return;
+
+  CHECK_LE(extra, std::numeric_limits<size_t>::max() / 2 - length_);
+  size_t new_capacity = std::max(std::max(capacity_ * 2, kMinHeapCapacity),
+                                 length_ + extra);
+  char* new_buffer = new char[new_capacity];
+  if (length_)
+    memcpy(new_buffer, data_, length_);
+  heap_buffer_.reset(new_buffer);
+  data_ = new_buffer;
+  capacity_ = new_capacity;
+}
+
+}  // namespace base
@@ -0,0 +1,97 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STRING_BUILDER_H_
+#define BASE_STRING_BUILDER_H_
+#pragma once
+
+#include <stdarg.h>   // va_list
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_piece.h"
+
+namespace base {
+
+class StringBuilder;
+
+// Declared with the other printf routines in stringprintf.h. It's a friend of
+// StringBuilder so that it can format straight into the spare room.
+BASE_EXPORT void StringAppendV(StringBuilder* dst, const char* format,
+                               va_list ap) PRINTF_FORMAT(2, 0);
+
+// Accumulates a string out of many small pieces without allocating for each
+// of them. Building a message with repeated std::string appends and
+// StringPrintf() calls allocates and copies intermediate strings; a
+// StringBuilder grows a single buffer, and StringAppendF() formats directly
+// into it.
+//
+// A plain StringBuilder lives on the heap from its first append. Use a
+// StackStringBuilder for strings that are usually short so that they are
+// built without allocating at all:
+//
+//   StackStringBuilder<256> builder;
+//   builder.Append(name);
+//   StringAppendF(&builder, " = %d", value);
+//   LOG(INFO) << builder.AsStringPiece();
+class BASE_EXPORT StringBuilder {
+ public:
+  StringBuilder();
+  ~StringBuilder();
+
+  void Append(const StringPiece& str);
+  void AppendChar(char c);
+
+  // The contents are not NUL terminated.
+  const char* data() const { return data_; }
+  size_t length() const { return length_; }
+  bool empty() const { return length_ == 0; }
+
+  StringPiece AsStringPiece() const { return StringPiece(data_, length_); }
+  std::string ToString() const { return std::string(data_, length_); }
+
+  // Empties the builder but keeps its buffer.
+  void Clear() { length_ = 0; }
+
+ protected:
+  // Starts out using |buffer|, which must outlive the builder.
+  StringBuilder(char* buffer, size_t capacity);
+
+ private:
+  friend void StringAppendV(StringBuilder* dst, const char* format,
+                            va_list ap);
+
+  // Makes sure there is room for at least |extra| more bytes past the end.
+  void Reserve(size_t extra);
+
+  char* data_;
+  size_t length_;
+  size_t capacity_;
+
+  // Owns |data_| once the contents no longer fit the initial buffer.
+  scoped_array<char> heap_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(StringBuilder);
+};
+
+// A StringBuilder that keeps up to |stack_capacity| bytes in the object
+// itself and only moves to the heap if the string grows larger.
+template <size_t stack_capacity>
+class StackStringBuilder : public StringBuilder {
+ public:
+  StackStringBuilder() : StringBuilder(stack_buffer_, stack_capacity) {}
+
+ private:
+  char stack_buffer_[stack_capacity];
+
+  DISALLOW_COPY_AND_ASSIGN(StackStringBuilder);
+};
+
+}  // namespace base
+
+#endif  // BASE_STRING_BUILDER_H_
@@ -0,0 +1,74 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/string_builder.h"
+
+#include <string>
+
+#include "base/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(StringBuilderTest, Append) {
+  StringBuilder builder;
+  EXPECT_TRUE(builder.empty());
+  EXPECT_EQ("", builder.ToString());
+
+  builder.Append("Hello");
+  builder.AppendChar(',');
+  builder.Append(std::string(" world"));
+  builder.Append(StringPiece());
+  EXPECT_FALSE(builder.empty());
+  EXPECT_EQ(12u, builder.length());
+  EXPECT_EQ("Hello, world", builder.ToString());
+  EXPECT_EQ(StringPiece("Hello, world"), builder.AsStringPiece());
+
+  builder.Clear();
+  EXPECT_TRUE(builder.empty());
+  builder.Append("again");
+  EXPECT_EQ("again", builder.ToString());
+}
+
+TEST(StringBuilderTest, AppendF) {
+  StringBuilder builder;
+  StringAppendF(&builder, "%d %s", 42, "is the answer");
+  StringAppendF(&builder, "%s", "");
+  StringAppendF(&builder, "; %c%c", 'o', 'k');
+  EXPECT_EQ("42 is the answer; ok", builder.ToString());
+}
+
+TEST(StringBuilderTest, StackBufferSpillsToHeap) {
+  StackStringBuilder<8> builder;
+  const char* stack_data = builder.data();
+  builder.Append("1234567");
+  builder.AppendChar('8');
+  EXPECT_EQ(stack_data, builder.data());
+  EXPECT_EQ("12345678", builder.ToString());
+
+  // Growing moves the contents to the heap.
+  builder.AppendChar('9');
+  EXPECT_NE(stack_data, builder.data());
+  EXPECT_EQ("123456789", builder.ToString());
+}
+
+TEST(StringBuilderTest, AppendFLargerThanBuffer) {
+  // Longer than both the stack buffer and the first guess at the room
+  // needed, so the formatting has to be retried.
+  std::string long_string(5000, 'x');
+  StackStringBuilder<16> builder;
+  builder.Append("<");
+  StringAppendF(&builder, "%s", long_string.c_str());
+  StringAppendF(&builder, ">%d", 7);
+  EXPECT_EQ("<" + long_string + ">7", builder.ToString());
+
+  // Matches what StringAppendF() produces into a std::string.
+  std::string expected;
+  StringAppendF(&expected, "%05d|%-6s|%.2f", 12, "ab", 1.5);
+  StringBuilder other;
+  StringAppendF(&other, "%05d|%-6s|%.2f", 12, "ab", 1.5);
+  EXPECT_EQ(expected, other.ToString());
+}
+
+}  // namespace base
@@ -27,6 +27,13 @@
 #include "base/utf_string_conversions.h"
 #include "base/third_party/icu/icu_utf.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STRING_UTIL_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace {
 
 // Force the singleton used by Empty[W]String[16] to be a unique type. This
@@ -304,10 +311,47 @@ TrimPositions TrimWhitespace(const string16& input,
   return TrimStringT(input, kWhitespaceUTF16, positions, output);
 }
 
+// Matches the characters of kWhitespaceASCII.
+static inline bool IsWhitespaceASCII(char c) {
+  return c == ' ' || (c >= 0x09 && c <= 0x0D);
+}
+
 TrimPositions TrimWhitespaceASCII(const std::string& input,
                                   TrimPositions positions,
                                   std::string* output) {
-  return TrimStringT(input, kWhitespaceASCII, positions, output);
+  // Same results as TrimStringT(), which searches the whitespace list for
+  // every character it looks at and copies the result through a temporary.
+  // This is used on every header and URL, so test the characters directly
+  // and copy the trimmed range into |output| in one go.
+  const size_t length = input.length();
+  size_t first = 0;
+  if (positions & TRIM_LEADING) {
+    while (first < length && IsWhitespaceASCII(input[first]))
+      ++first;
+  }
+  size_t last = length;
+  if (positions & TRIM_TRAILING) {
+    while (last > first && IsWhitespaceASCII(input[last - 1]))
+      --last;
+  }
+
+  // As in TrimStringT(), an all-whitespace string was trimmed from wherever
+  // the caller asked, and an empty one from nowhere.
+  if (first == length || last == 0) {
+    bool input_was_empty = input.empty();  // in case output == &input
+    output->clear();
+    return input_was_empty ? TRIM_NONE : positions;
+  }
+
+  if (output == &input) {
+    output->erase(last);
+    output->erase(0, first);
+  } else {
+    output->assign(input, first, last - first);
+  }
+  return static_cast<TrimPositions>(
+      ((first == 0) ? TRIM_NONE : TRIM_LEADING) |
+      ((last == length) ? TRIM_NONE : TRIM_TRAILING));
 }
 
 // This function is only for backward-compatibility.
@@ -464,7 +508,33 @@ bool IsStringASCII(const string16& str) {
 #endif
 
 bool IsStringASCII(const base::StringPiece& str) {
-  return DoIsStringASCII(str);
+  const char* data = str.data();
+  const size_t length = str.length();
+  size_t i = 0;
+#if defined(STRING_UTIL_USE_SSE2)
+  // A byte is non-ASCII exactly when its high bit is set, which is what
+  // _mm_movemask_epi8() collects.  Or the chunks together so the common,
+  // all-ASCII case only tests once per 64 bytes.
+  for (; i + 64 <= length; i += 64) {
+    const __m128i* chunk = reinterpret_cast<const __m128i*>(data + i);
+    __m128i bits = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128(chunk), _mm_loadu_si128(chunk + 1)),
+        _mm_or_si128(_mm_loadu_si128(chunk + 2), _mm_loadu_si128(chunk + 3)));
+    if (_mm_movemask_epi8(bits))
+      return false;
+  }
+  for (; i + 16 <= length; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    if (_mm_movemask_epi8(chunk))
+      return false;
+  }
+#endif
+  for (; i < length; ++i) {
+    if (static_cast<unsigned char>(data[i]) > 0x7F)
+      return false;
+  }
+  return true;
 }
 
 bool IsStringUTF8(const std::string& str) {
@@ -492,9 +562,42 @@ static inline bool DoLowerCaseEqualsASCII(Iter a_begin,
   return *b == 0;
 }
 
+// The narrow case, which compares 16 characters at a time when it can.  This
+// is what header and scheme checks run through.
+static bool DoLowerCaseEqualsASCII(const char* a, size_t a_length,
+                                   const char* b) {
+  if (strlen(b) != a_length)
+    return false;
+
+  size_t i = 0;
+#if defined(STRING_UTIL_USE_SSE2)
+  // |b| is lower case, so lower case |a| by adding 0x20 to the bytes between
+  // 'A' and 'Z'.  Bytes with the high bit set compare as negative and are
+  // left alone, as ToLowerASCII() does.
+  const __m128i before_upper = _mm_set1_epi8('A' - 1);
+  const __m128i after_upper = _mm_set1_epi8('Z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  for (; i + 16 <= a_length; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_upper),
+                                     _mm_cmplt_epi8(chunk, after_upper));
+    __m128i lower = _mm_add_epi8(chunk, _mm_and_si128(is_upper, case_bit));
+    __m128i expected =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(lower, expected)) != 0xFFFF)
+      return false;
+  }
+#endif
+  for (; i < a_length; ++i) {
+    if (base::ToLowerASCII(a[i]) != b[i])
+      return false;
+  }
+  return true;
+}
+
 // Front-ends for LowerCaseEqualsASCII.
 bool LowerCaseEqualsASCII(const std::string& a, const char* b) {
-  return DoLowerCaseEqualsASCII(a.begin(), a.end(), b);
+  return DoLowerCaseEqualsASCII(a.data(), a.length(), b);
 }
 
 bool LowerCaseEqualsASCII(const std::wstring& a, const char* b) {
@@ -532,7 +635,7 @@ bool LowerCaseEqualsASCII(string16::const_iterator a_begin,
 bool LowerCaseEqualsASCII(const char* a_begin,
                           const char* a_end,
                           const char* b) {
-  return DoLowerCaseEqualsASCII(a_begin, a_end, b);
+  return DoLowerCaseEqualsASCII(a_begin, a_end - a_begin, b);
 }
 
 bool LowerCaseEqualsASCII(const wchar_t* a_begin,
@@ -663,14 +766,35 @@ void DoReplaceSubstringsAfterOffset(StringType* str,
     return;
 
   DCHECK(!find_this.empty());
-  for (typename StringType::size_type offs(str->find(find_this, start_offset));
-      offs != StringType::npos; offs = str->find(find_this, offs)) {
-    str->replace(offs, find_this.length(), replace_with);
-    offs += replace_with.length();
+  typename StringType::size_type offs = str->find(find_this, start_offset);
+  if (offs == StringType::npos)
+    return;
 
-    if (!replace_all)
-      break;
+  if (!replace_all || find_this.length() == replace_with.length()) {
+    // Nothing after the replacements needs to move.
+    for (; offs != StringType::npos; offs = str->find(find_this, offs)) {
+      str->replace(offs, find_this.length(), replace_with);
+      offs += replace_with.length();
+
+      if (!replace_all)
+        break;
+    }
+    return;
+  }
+
+  // Replacing in place would shift the rest of the string once per match,
+  // which is quadratic for long strings, so build the result in a new string
+  // instead.
+  StringType result;
+  result.reserve(str->length());
+  typename StringType::size_type copied = 0;
+  for (; offs != StringType::npos; offs = str->find(find_this, copied)) {
+    result.append(str->data() + copied, offs - copied);
+    result.append(replace_with);
+    copied = offs + find_this.length();
   }
+  result.append(str->data() + copied, str->length() - copied);
+  str->swap(result);
 }
 
 void ReplaceFirstSubstringAfterOffset(string16* str,
@@ -759,7 +883,13 @@ static STR JoinStringT(const std::vector<STR>& parts,
   if (parts.empty())
     return STR();
 
-  STR result(parts[0]);
+  typename STR::size_type length = parts.size() - 1;
+  for (size_t i = 0; i < parts.size(); ++i)
+    length += parts[i].length();
+
+  STR result;
+  result.reserve(length);
+  result.append(parts[0]);
   typename std::vector<STR>::const_iterator iter = parts.begin();
   ++iter;
 
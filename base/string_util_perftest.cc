@@ -0,0 +1,109 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/perftimer.h"
+#include "base/string_builder.h"
+#include "base/string_util.h"
+#include "base/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kIterations = 1000000;
+
+// Roughly the shape of the header lines and URLs these functions see.
+const char kHeaderLine[] =
+    "  Content-Type: text/html; charset=utf-8; boundary=something-long   ";
+const char kURL[] =
+    "http://www.example.com/search?q=string+building&ie=utf-8&oe=utf-8&aq=t";
+
+}  // namespace
+
+TEST(StringUtilPerfTest, IsStringASCII) {
+  std::string url(kURL);
+  int ascii = 0;
+  PerfTimeLogger timer("IsStringASCII_URL_AMillion");
+  for (int i = 0; i < kIterations; ++i)
+    ascii += IsStringASCII(url);
+  timer.Done();
+  EXPECT_EQ(kIterations, ascii);
+}
+
+TEST(StringUtilPerfTest, LowerCaseEqualsASCII) {
+  std::string name("Content-Security-Policy-Report-Only");
+  int equal = 0;
+  PerfTimeLogger timer("LowerCaseEqualsASCII_Header_AMillion");
+  for (int i = 0; i < kIterations; ++i)
+    equal += LowerCaseEqualsASCII(name, "content-security-policy-report-only");
+  timer.Done();
+  EXPECT_EQ(kIterations, equal);
+}
+
+TEST(StringUtilPerfTest, TrimWhitespaceASCII) {
+  std::string line(kHeaderLine);
+  std::string trimmed;
+  PerfTimeLogger timer("TrimWhitespaceASCII_Header_AMillion");
+  for (int i = 0; i < kIterations; ++i)
+    TrimWhitespaceASCII(line, TRIM_ALL, &trimmed);
+  timer.Done();
+  EXPECT_EQ(line.length() - 5, trimmed.length());
+}
+
+TEST(StringUtilPerfTest, JoinString) {
+  std::vector<std::string> parts;
+  for (int i = 0; i < 16; ++i)
+    parts.push_back(StringPrintf("part%d", i));
+  size_t length = 0;
+  PerfTimeLogger timer("JoinString_16Parts_HundredThousand");
+  for (int i = 0; i < kIterations / 10; ++i)
+    length += JoinString(parts, ',').length();
+  timer.Done();
+  EXPECT_NE(0u, length);
+}
+
+TEST(StringUtilPerfTest, ReplaceSubstringsAfterOffset) {
+  // About 70 KB with 3000 matches, where replacing in place used to move the
+  // rest of the string for every match.
+  std::string url(kURL);
+  for (int i = 0; i < 10; ++i)
+    url += url;
+  size_t length = 0;
+  PerfTimeLogger timer("ReplaceSubstringsAfterOffset_70KB_Thousand");
+  for (int i = 0; i < kIterations / 1000; ++i) {
+    std::string escaped(url);
+    ReplaceSubstringsAfterOffset(&escaped, 0, "&", "&amp;");
+    length += escaped.length();
+  }
+  timer.Done();
+  EXPECT_GT(length, url.length());
+}
+
+TEST(StringUtilPerfTest, StringAppendF) {
+  size_t length = 0;
+  PerfTimeLogger timer("StringAppendF_String_AMillion");
+  for (int i = 0; i < kIterations; ++i) {
+    std::string line;
+    base::StringAppendF(&line, "%s:%d ", "source", i);
+    base::StringAppendF(&line, "bytes=%d", i * 2);
+    length += line.length();
+  }
+  timer.Done();
+  EXPECT_NE(0u, length);
+}
+
+TEST(StringUtilPerfTest, StringAppendFBuilder) {
+  size_t length = 0;
+  PerfTimeLogger timer("StringAppendF_StackStringBuilder_AMillion");
+  for (int i = 0; i < kIterations; ++i) {
+    base::StackStringBuilder<128> line;
+    base::StringAppendF(&line, "%s:%d ", "source", i);
+    base::StringAppendF(&line, "bytes=%d", i * 2);
+    length += line.length();
+  }
+  timer.Done();
+  EXPECT_NE(0u, length);
+}
@@ -52,6 +52,9 @@ static const struct trim_case_ascii {
   {"  ", TRIM_TRAILING, "", TRIM_TRAILING},
   {"  ", TRIM_ALL, "", TRIM_ALL},
   {"\t\rTest String\n", TRIM_ALL, "Test String", TRIM_ALL},
+  {"\v\fTest String \r\n", TRIM_ALL, "Test String", TRIM_ALL},
+  {" x ", TRIM_NONE, " x ", TRIM_NONE},
+  {"  ", TRIM_NONE, "  ", TRIM_NONE},
 };
 
 namespace {
@@ -252,6 +255,16 @@ TEST(StringUtilTest, TrimWhitespace) {
               TrimWhitespace(value.input, value.positions, &output_ascii));
     EXPECT_EQ(value.output, output_ascii);
   }
+
+  output_ascii = "  This is a test \r\n";
+  EXPECT_EQ(TRIM_ALL, TrimWhitespaceASCII(output_ascii, TRIM_ALL,
+                                          &output_ascii));
+  EXPECT_EQ("This is a test", output_ascii);
+
+  output_ascii = "  \r\n";
+  EXPECT_EQ(TRIM_ALL, TrimWhitespaceASCII(output_ascii, TRIM_ALL,
+                                          &output_ascii));
+  EXPECT_EQ(std::string(), output_ascii);
 }
 
 static const struct collapse_case {
@@ -428,6 +441,17 @@ TEST(StringUtilTest, ConvertASCII) {
   EXPECT_FALSE(IsStringASCII("Google \x80Video"));
   EXPECT_FALSE(IsStringASCII(L"Google \x80Video"));
 
+  // Long enough to go through the vectorized loops, with the non-ASCII byte
+  // at every position.
+  std::string long_ascii(150, 'a');
+  EXPECT_TRUE(IsStringASCII(long_ascii));
+  for (size_t i = 0; i < long_ascii.length(); ++i) {
+    std::string long_non_ascii(long_ascii);
+    long_non_ascii[i] = '\xFF';
+    EXPECT_FALSE(IsStringASCII(long_non_ascii)) << i;
+    EXPECT_TRUE(IsStringASCII(base::StringPiece(long_non_ascii.data(), i)));
+  }
+
   // Convert empty strings.
   std::wstring wempty;
   std::string empty;
@@ -490,6 +514,31 @@ TEST(StringUtilTest, LowerCaseEqualsASCII) {
     EXPECT_TRUE(LowerCaseEqualsASCII(lowercase_cases[i].src_a,
                                      lowercase_cases[i].dst));
   }
+
+  static const struct {
+    const char* a;
+    const char* b;
+    bool expected;
+  } narrow_cases[] = {
+    { "", "", true },
+    { "foo", "fo", false },
+    { "fo", "foo", false },
+    { "FOO", "FOO", false },
+    { "x-Forwarded-FOR: \xC9t\xC9", "x-forwarded-for: \xC9t\xC9", true },
+    { "x-Forwarded-FOR: \xC9t\xC9", "x-forwarded-for: \xE9t\xE9", false },
+    { "@[`{ABCDEFGHIJKLMNOPQRSTUVWXYZ", "@[`{abcdefghijklmnopqrstuvwxyz",
+      true },
+    { "Content-Type-Options", "content-type-optionz", false },
+    { "Content-Type-Options", "Content-type-options", false },
+  };
+
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(narrow_cases); ++i) {
+    const char* a = narrow_cases[i].a;
+    EXPECT_EQ(narrow_cases[i].expected,
+              LowerCaseEqualsASCII(std::string(a), narrow_cases[i].b)) << i;
+    EXPECT_EQ(narrow_cases[i].expected,
+              LowerCaseEqualsASCII(a, a + strlen(a), narrow_cases[i].b)) << i;
+  }
 }
 
 TEST(StringUtilTest, FormatBytesUnlocalized) {
@@ -6,6 +6,9 @@
 
 #include <errno.h>
 
+#include <algorithm>
+
+#include "base/string_builder.h"
 #include "base/string_util.h"
 #include "base/utf_string_conversions.h"
 
@@ -164,6 +167,13 @@ void StringAppendF(std::wstring* dst, const wchar_t* format, ...) {
   va_end(ap);
 }
 
+void StringAppendF(StringBuilder* dst, const char* format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  StringAppendV(dst, format, ap);
+  va_end(ap);
+}
+
 void StringAppendV(std::string* dst, const char* format, va_list ap) {
   StringAppendVT(dst, format, ap);
 }
@@ -172,4 +182,47 @@ void StringAppendV(std::wstring* dst, const wchar_t* format, va_list ap) {
   StringAppendVT(dst, format, ap);
 }
 
+void StringAppendV(StringBuilder* dst, const char* format, va_list ap) {
+  // Most formatted pieces are short, so start with whatever room is left, or
+  // a little more, and only grow when the output turns out to be longer.
+  size_t room = std::max<size_t>(dst->capacity_ - dst->length_, 128);
+  while (true) {
+    dst->Reserve(room);
+
+    va_list ap_copy;
+    GG_VA_COPY(ap_copy, ap);
+#if !defined(OS_WIN)
+    errno = 0;
+#endif
+    int result = vsnprintfT(dst->data_ + dst->length_, room, format, ap_copy);
+    va_end(ap_copy);
+
+    if (result >= 0 && static_cast<size_t>(result) < room) {
+      // It fit. The NUL terminator vsnprintf wrote past the end is not part
+      // of the contents.
+      dst->length_ += result;
+      return;
+    }
+
+    // The same retry rules as StringAppendVT() above.
+    if (result < 0) {
+#if !defined(OS_WIN)
+      if (errno != 0 && errno != EOVERFLOW)
+#endif
+      {
+        DLOG(WARNING) << "Unable to printf the requested string due to error.";
+        return;
+      }
+      room *= 2;
+    } else {
+      room = result + 1;
+    }
+
+    if (room > 32 * 1024 * 1024) {
+      DLOG(WARNING) << "Unable to printf the requested string due to size.";
+      return;
+    }
+  }
+}
+
 }  // namespace base
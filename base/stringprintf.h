@@ -14,6 +14,8 @@
 
 namespace base {
 
+class StringBuilder;
+
 // Return a C++ string given printf-like input.
 BASE_EXPORT std::string StringPrintf(const char* format, ...)
     PRINTF_FORMAT(1, 2);
@@ -39,6 +41,9 @@ BASE_EXPORT void StringAppendF(std::string* dst, const char* format, ...)
 // replace with string16 version.
 BASE_EXPORT void StringAppendF(std::wstring* dst, const wchar_t* format, ...)
     WPRINTF_FORMAT(2, 3);
+// Formats directly into the builder's buffer without an intermediate string.
+BASE_EXPORT void StringAppendF(StringBuilder* dst, const char* format, ...)
+    PRINTF_FORMAT(2, 3);
 
 // Lower-level routine that takes a va_list and appends to a specified
 // string.  All other routines are just convenience wrappers around it.
@@ -47,6 +52,9 @@ BASE_EXPORT void StringAppendV(std::string* dst, const char* format, va_list ap)
 BASE_EXPORT void StringAppendV(std::wstring* dst,
                                const wchar_t* format, va_list ap)
     WPRINTF_FORMAT(2, 0);
+BASE_EXPORT void StringAppendV(StringBuilder* dst,
+                               const char* format, va_list ap)
+    PRINTF_FORMAT(2, 0);
 
 }  // namespace base
 
@@ -4,9 +4,9 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
-#include <list>
+#include <deque>
 #include <map>
-#include <set>
+#include <queue>
 #include <utility>
 #include <vector>
 
@@ -38,16 +38,28 @@ namespace {
 struct SequencedTask {
   SequencedTask()
       : sequence_token_id(0),
+        sequence_task_number(0),
         shutdown_behavior(SequencedWorkerPool::BLOCK_SHUTDOWN) {}
 
   ~SequencedTask() {}
 
   int sequence_token_id;
+  // Order in which the task was posted to the pool, used to run runnable tasks
+  // in FIFO order.
+  int64 sequence_task_number;
   SequencedWorkerPool::WorkerShutdown shutdown_behavior;
   tracked_objects::Location location;
   Closure task;
 };
 
+// Orders a priority queue of SequencedTasks so that the task that was posted
+// first is on top.
+struct SequencedTaskLessThan {
+  bool operator()(const SequencedTask& lhs, const SequencedTask& rhs) const {
+    return lhs.sequence_task_number > rhs.sequence_task_number;
+  }
+};
+
 // SequencedWorkerPoolTaskRunner ---------------------------------------------
 // A TaskRunner which posts tasks to a SequencedWorkerPool with a
 // fixed ShutdownBehavior.
@@ -352,9 +364,15 @@ class SequencedWorkerPool::Inner {
   int WillRunWorkerTask(const SequencedTask& task);
   void DidRunWorkerTask(const SequencedTask& task);
 
-  // Returns true if there are no threads currently running the given
-  // sequence token.
-  bool IsSequenceTokenRunnable(int sequence_token_id) const;
+  // Adds |task| to the runnable queue, or to the queue of its sequence if an
+  // earlier task with the same token is still pending or running.  Must be
+  // called inside the lock.
+  void EnqueueTask(const SequencedTask& task);
+
+  // Called once a task with the given token has been run or discarded, so the
+  // next task in that sequence (if any) becomes runnable.  Must be called
+  // inside the lock.
+  void OnSequenceTaskRetired(int sequence_token_id);
 
   // Checks if all threads are busy and the addition of one more could run an
   // additional task waiting in the queue. This must be called from within
@@ -432,21 +450,30 @@ class SequencedWorkerPool::Inner {
   // flag set.
   size_t blocking_shutdown_thread_count_;
 
-  // In-order list of all pending tasks. These are tasks waiting for a thread
-  // to run on or that are blocked on a previous task in their sequence.
-  //
-  // We maintain the pending_task_count_ separately for metrics because
-  // list.size() can be linear time.
-  std::list<SequencedTask> pending_tasks_;
+  // The number assigned to the next posted task, used to keep
+  // |runnable_tasks_| in posting order.
+  int64 next_sequence_task_number_;
+
+  // Tasks that can be run right away, earliest-posted first. This holds every
+  // pending unsequenced task plus, for each sequence token that is not
+  // currently running, the oldest pending task with that token.
+  typedef std::priority_queue<SequencedTask, std::vector<SequencedTask>,
+                              SequencedTaskLessThan> RunnableTaskQueue;
+  RunnableTaskQueue runnable_tasks_;
+
+  // Associates every sequence token that is running or has a task in
+  // |runnable_tasks_| with the tasks that are blocked behind it, in posting
+  // order. A token is removed once it has nothing left running or pending, so
+  // a token without an entry here has no work in the pool at all.
+  typedef std::map<int, std::deque<SequencedTask> > SequenceQueueMap;
+  SequenceQueueMap sequence_queues_;
+
+  // Total number of tasks in |runnable_tasks_| and |sequence_queues_|.
   size_t pending_task_count_;
 
-  // Number of tasks in the pending_tasks_ list that are marked as blocking
-  // shutdown.
+  // Number of pending tasks that are marked as blocking shutdown.
   size_t blocking_shutdown_pending_task_count_;
 
-  // Lists all sequence tokens currently executing.
-  std::set<int> current_sequences_;
-
   // Set when Shutdown is called and no further tasks should be
   // allowed, though we may still be running existing tasks.
   bool shutdown_called_;
@@ -500,6 +527,7 @@ SequencedWorkerPool::Inner::Inner(
       thread_being_created_(false),
       waiting_thread_count_(0),
       blocking_shutdown_thread_count_(0),
+      next_sequence_task_number_(0),
       pending_task_count_(0),
       blocking_shutdown_pending_task_count_(0),
       shutdown_called_(false),
@@ -554,7 +582,8 @@ bool SequencedWorkerPool::Inner::PostTask(
     if (optional_token_name)
       sequenced.sequence_token_id = LockedGetNamedTokenID(*optional_token_name);
 
-    pending_tasks_.push_back(sequenced);
+    sequenced.sequence_task_number = next_sequence_task_number_++;
+    EnqueueTask(sequenced);
     pending_task_count_++;
     if (shutdown_behavior == BLOCK_SHUTDOWN)
       blocking_shutdown_pending_task_count_++;
@@ -732,45 +761,24 @@ bool SequencedWorkerPool::Inner::GetWork(
     std::vector<Closure>* delete_these_outside_lock) {
   lock_.AssertAcquired();
 
-  DCHECK_EQ(pending_tasks_.size(), pending_task_count_);
   UMA_HISTOGRAM_COUNTS_100("SequencedWorkerPool.TaskCount",
                            static_cast<int>(pending_task_count_));
 
-  // Find the next task with a sequence token that's not currently in use.
-  // If the token is in use, that means another thread is running something
-  // in that sequence, and we can't run it without going out-of-order.
-  //
-  // This algorithm is simple and fair, but inefficient in some cases. For
-  // example, say somebody schedules 1000 slow tasks with the same sequence
-  // number. We'll have to go through all those tasks each time we feel like
-  // there might be work to schedule. If this proves to be a problem, we
-  // should make this more efficient.
-  //
-  // One possible enhancement would be to keep a map from sequence ID to a
-  // list of pending but currently blocked SequencedTasks for that ID.
-  // When a worker finishes a task of one sequence token, it can pick up the
-  // next one from that token right away.
-  //
-  // This may lead to starvation if there are sufficient numbers of sequences
-  // in use. To alleviate this, we could add an incrementing priority counter
-  // to each SequencedTask. Then maintain a priority_queue of all runnable
-  // tasks, sorted by priority counter. When a sequenced task is completed
-  // we would pop the head element off of that tasks pending list and add it
-  // to the priority queue. Then we would run the first item in the priority
-  // queue.
+  // Tasks that are blocked behind a running task with the same sequence token
+  // are kept out of |runnable_tasks_|, so the top of that queue is always the
+  // earliest-posted task we are allowed to run. Each sequence contributes at
+  // most one task to the queue, which keeps a long run of tasks with the same
+  // token from having to be skipped over on every call.
   bool found_task = false;
-  int unrunnable_tasks = 0;
-  std::list<SequencedTask>::iterator i = pending_tasks_.begin();
-  while (i != pending_tasks_.end()) {
-    if (!IsSequenceTokenRunnable(i->sequence_token_id)) {
-      unrunnable_tasks++;
-      ++i;
-      continue;
-    }
+  while (!runnable_tasks_.empty()) {
+    SequencedTask candidate = runnable_tasks_.top();
+    runnable_tasks_.pop();
+    pending_task_count_--;
 
-    if (shutdown_called_ && i->shutdown_behavior != BLOCK_SHUTDOWN) {
+    if (shutdown_called_ && candidate.shutdown_behavior != BLOCK_SHUTDOWN) {
       // We're shutting down and the task we just found isn't blocking
-      // shutdown. Delete it and get more work.
+      // shutdown. Delete it and get more work. The next task in its sequence,
+      // if any, becomes runnable in its place.
       //
       // Note that we do not want to delete unrunnable tasks. Deleting a task
       // can have side effects (like freeing some objects) and deleting a
@@ -784,14 +792,11 @@ bool SequencedWorkerPool::Inner::GetWork(
       // until the lock is exited. The calling code can just clear() the
       // vector they passed to us once the lock is exited to make this
       // happen.
-      delete_these_outside_lock->push_back(i->task);
-      i = pending_tasks_.erase(i);
-      pending_task_count_--;
+      delete_these_outside_lock->push_back(candidate.task);
+      OnSequenceTaskRetired(candidate.sequence_token_id);
     } else {
       // Found a runnable task.
-      *task = *i;
-      i = pending_tasks_.erase(i);
-      pending_task_count_--;
+      *task = candidate;
       if (task->shutdown_behavior == BLOCK_SHUTDOWN) {
         blocking_shutdown_pending_task_count_--;
       }
@@ -801,20 +806,19 @@ bool SequencedWorkerPool::Inner::GetWork(
     }
   }
 
-  // Track the number of tasks we had to skip over to see if we should be
-  // making this more efficient. If this number ever becomes large or is
-  // frequently "some", we should consider the optimization above.
-  UMA_HISTOGRAM_COUNTS_100("SequencedWorkerPool.UnrunnableTaskCount",
-                           unrunnable_tasks);
+  // Track the number of tasks that are waiting on a running task in their
+  // sequence.
+  UMA_HISTOGRAM_COUNTS_100(
+      "SequencedWorkerPool.UnrunnableTaskCount",
+      static_cast<int>(pending_task_count_ - runnable_tasks_.size()));
   return found_task;
 }
 
 int SequencedWorkerPool::Inner::WillRunWorkerTask(const SequencedTask& task) {
   lock_.AssertAcquired();
 
-  // Mark the task's sequence number as in use.
-  if (task.sequence_token_id)
-    current_sequences_.insert(task.sequence_token_id);
+  // The task's sequence token stays in |sequence_queues_| while it runs, which
+  // is what keeps later tasks with the same token from running concurrently.
 
   if (task.shutdown_behavior == BLOCK_SHUTDOWN)
     blocking_shutdown_thread_count_++;
@@ -845,16 +849,38 @@ void SequencedWorkerPool::Inner::DidRunWorkerTask(const SequencedTask& task) {
     blocking_shutdown_thread_count_--;
   }
 
-  if (task.sequence_token_id)
-    current_sequences_.erase(task.sequence_token_id);
+  OnSequenceTaskRetired(task.sequence_token_id);
+}
+
+void SequencedWorkerPool::Inner::EnqueueTask(const SequencedTask& task) {
+  lock_.AssertAcquired();
+  if (task.sequence_token_id) {
+    SequenceQueueMap::iterator found =
+        sequence_queues_.find(task.sequence_token_id);
+    if (found != sequence_queues_.end()) {
+      // An earlier task in this sequence is running or runnable.
+      found->second.push_back(task);
+      return;
+    }
+    // Claim the sequence so that later tasks with this token wait behind us.
+    sequence_queues_[task.sequence_token_id];
+  }
+  runnable_tasks_.push(task);
 }
 
-bool SequencedWorkerPool::Inner::IsSequenceTokenRunnable(
-    int sequence_token_id) const {
+void SequencedWorkerPool::Inner::OnSequenceTaskRetired(int sequence_token_id) {
   lock_.AssertAcquired();
-  return !sequence_token_id ||
-      current_sequences_.find(sequence_token_id) ==
-          current_sequences_.end();
+  if (!sequence_token_id)
+    return;
+
+  SequenceQueueMap::iterator found = sequence_queues_.find(sequence_token_id);
+  DCHECK(found != sequence_queues_.end());
+  if (found->second.empty()) {
+    sequence_queues_.erase(found);
+    return;
+  }
+  runnable_tasks_.push(found->second.front());
+  found->second.pop_front();
 }
 
 int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
@@ -891,16 +917,12 @@ int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
   if (!shutdown_called_ &&
       !thread_being_created_ &&
       threads_.size() < max_threads_ &&
-      waiting_thread_count_ == 0) {
-    // We could use an additional thread if there's work to be done.
-    for (std::list<SequencedTask>::iterator i = pending_tasks_.begin();
-         i != pending_tasks_.end(); ++i) {
-      if (IsSequenceTokenRunnable(i->sequence_token_id)) {
-        // Found a runnable task, mark the thread as being started.
-        thread_being_created_ = true;
-        return static_cast<int>(threads_.size() + 1);
-      }
-    }
+      waiting_thread_count_ == 0 &&
+      !runnable_tasks_.empty()) {
+    // We could use an additional thread since there's work to be done. Mark
+    // the thread as being started.
+    thread_being_created_ = true;
+    return static_cast<int>(threads_.size() + 1);
   }
   return 0;
 }
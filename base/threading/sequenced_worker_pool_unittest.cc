@@ -5,6 +5,7 @@
 #include "base/threading/sequenced_worker_pool.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
@@ -522,6 +523,115 @@ TEST_F(SequencedWorkerPoolTest, IsRunningOnCurrentThread) {
   unused_pool->Shutdown();
 }
 
+// Records, per sequence, the order in which tasks ran. Used by tests that post
+// many interleaved sequences at once.
+class SequenceOrderChecker
+    : public base::RefCountedThreadSafe<SequenceOrderChecker> {
+ public:
+  explicit SequenceOrderChecker(size_t num_sequences)
+      : next_expected_(num_sequences, 0),
+        out_of_order_count_(0),
+        completed_count_(0) {
+  }
+
+  void RunTask(size_t sequence, int index) {
+    base::AutoLock lock(lock_);
+    if (next_expected_[sequence] != index)
+      out_of_order_count_++;
+    next_expected_[sequence] = index + 1;
+    completed_count_++;
+  }
+
+  int out_of_order_count() const {
+    base::AutoLock lock(lock_);
+    return out_of_order_count_;
+  }
+
+  size_t completed_count() const {
+    base::AutoLock lock(lock_);
+    return completed_count_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<SequenceOrderChecker>;
+  ~SequenceOrderChecker() {}
+
+  mutable base::Lock lock_;
+  std::vector<int> next_expected_;
+  int out_of_order_count_;
+  size_t completed_count_;
+};
+
+// Tests that many sequences posted in an interleaved fashion each keep their
+// order while unsequenced tasks run alongside them.
+TEST_F(SequencedWorkerPoolTest, InterleavedSequences) {
+  const size_t kNumSequences = 10;
+  const int kTasksPerSequence = 100;
+  scoped_refptr<SequenceOrderChecker> checker(
+      new SequenceOrderChecker(kNumSequences));
+
+  std::vector<SequencedWorkerPool::SequenceToken> tokens;
+  for (size_t i = 0; i < kNumSequences; i++)
+    tokens.push_back(pool()->GetSequenceToken());
+
+  for (int index = 0; index < kTasksPerSequence; index++) {
+    for (size_t i = 0; i < kNumSequences; i++) {
+      pool()->PostSequencedWorkerTask(
+          tokens[i], FROM_HERE,
+          base::Bind(&SequenceOrderChecker::RunTask, checker, i, index));
+    }
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(),
+                                      index));
+  }
+
+  tracker()->WaitUntilTasksComplete(kTasksPerSequence);
+  pool()->FlushForTesting();
+  EXPECT_EQ(kNumSequences * kTasksPerSequence, checker->completed_count());
+  EXPECT_EQ(0, checker->out_of_order_count());
+}
+
+// Measures how task throughput scales with the number of worker threads for
+// a mix of unsequenced and sequenced tasks. Run with --v=1 to see the timings.
+TEST(SequencedWorkerPoolScalingTest, Throughput) {
+  MessageLoop message_loop;
+  const size_t kMaxWorkers = 8;
+  const size_t kNumSequences = 4;
+  const int kNumTasks = 2000;
+
+  for (size_t workers = 1; workers <= kMaxWorkers; workers *= 2) {
+    SequencedWorkerPoolOwner pool_owner(workers, "scaling");
+    const scoped_refptr<SequencedWorkerPool>& pool = pool_owner.pool();
+    scoped_refptr<SequenceOrderChecker> checker(
+        new SequenceOrderChecker(kNumSequences + 1));
+
+    std::vector<SequencedWorkerPool::SequenceToken> tokens;
+    for (size_t i = 0; i < kNumSequences; i++)
+      tokens.push_back(pool->GetSequenceToken());
+
+    TimeTicks start = TimeTicks::Now();
+    for (int index = 0; index < kNumTasks; index++) {
+      size_t sequence = index % (kNumSequences + 1);
+      if (sequence == kNumSequences) {
+        pool->PostWorkerTask(FROM_HERE, base::Bind(
+            &SequenceOrderChecker::RunTask, checker, sequence, index));
+      } else {
+        pool->PostSequencedWorkerTask(
+            tokens[sequence], FROM_HERE,
+            base::Bind(&SequenceOrderChecker::RunTask, checker, sequence,
+                       index / static_cast<int>(kNumSequences + 1)));
+      }
+    }
+    pool->FlushForTesting();
+    TimeDelta elapsed = TimeTicks::Now() - start;
+
+    EXPECT_EQ(static_cast<size_t>(kNumTasks), checker->completed_count());
+    VLOG(1) << workers << " workers ran " << kNumTasks << " tasks in "
+            << elapsed.InMillisecondsF() << " ms";
+    pool->Shutdown();
+  }
+}
+
 class SequencedWorkerPoolTaskRunnerTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerTestDelegate() {}
@@ -83,7 +83,15 @@ Timer::~Timer() {
 void Timer::Start(const tracked_objects::Location& posted_from,
                   TimeDelta delay,
                   const base::Closure& user_task) {
+  Start(posted_from, delay, TimeDelta(), user_task);
+}
+
+void Timer::Start(const tracked_objects::Location& posted_from,
+                  TimeDelta delay,
+                  TimeDelta leeway,
+                  const base::Closure& user_task) {
   SetTaskInfo(posted_from, delay, user_task);
+  leeway_ = leeway;
   Reset();
 }
 
@@ -131,7 +139,7 @@ void Timer::PostNewScheduledTask(TimeDelta delay) {
   scheduled_task_ = new BaseTimerTaskInternal(this);
   MessageLoop::current()->PostDelayedTask(posted_from_,
       base::Bind(&BaseTimerTaskInternal::Run, base::Owned(scheduled_task_)),
-      delay);
+      delay, leeway_);
   scheduled_run_time_ = desired_run_time_ = TimeTicks::Now() + delay;
   // Remember the thread ID that posts the first task -- this will be verified
   // later when the task is abandoned to detect misuse from multiple threads.
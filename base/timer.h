@@ -93,12 +93,26 @@ class BASE_EXPORT Timer {
     return delay_;
   }
 
+  // Returns how late the timer is allowed to fire.
+  TimeDelta GetCurrentLeeway() const {
+    return leeway_;
+  }
+
   // Start the timer to run at the given |delay| from now. If the timer is
   // already running, it will be replaced to call the given |user_task|.
   void Start(const tracked_objects::Location& posted_from,
              TimeDelta delay,
              const base::Closure& user_task);
 
+  // Like Start above, but allows |user_task| to run up to |leeway| late so
+  // that its wakeups can be shared with other timers.  See the leeway variant
+  // of MessageLoop::PostDelayedTask.  The leeway also applies to later
+  // Reset()s and, for repeating timers, to every repetition.
+  void Start(const tracked_objects::Location& posted_from,
+             TimeDelta delay,
+             TimeDelta leeway,
+             const base::Closure& user_task);
+
   // Call this method to stop and cancel the timer.  It is a no-op if the timer
   // is not running.
   void Stop();
@@ -146,6 +160,8 @@ class BASE_EXPORT Timer {
   tracked_objects::Location posted_from_;
   // Delay requested by user.
   TimeDelta delay_;
+  // How late the user allows user_task_ to run.
+  TimeDelta leeway_;
   // user_task_ is what the user wants to be run at desired_run_time_.
   base::Closure user_task_;
 
@@ -197,6 +213,16 @@ class BaseTimerMethodPointer : public Timer {
     Timer::Start(posted_from, delay,
                  base::Bind(method, base::Unretained(receiver)));
   }
+
+  // Like Start above, but with a |leeway|; see Timer::Start.
+  void Start(const tracked_objects::Location& posted_from,
+             TimeDelta delay,
+             TimeDelta leeway,
+             Receiver* receiver,
+             ReceiverMethod method) {
+    Timer::Start(posted_from, delay, leeway,
+                 base::Bind(method, base::Unretained(receiver)));
+  }
 };
 
 //-----------------------------------------------------------------------------
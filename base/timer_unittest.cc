@@ -474,4 +474,21 @@ TEST(TimerTest, ContinuationReset) {
   }
 }
 
+TEST(TimerTest, StartWithLeeway) {
+  {
+    ClearAllCallbackHappened();
+    MessageLoop loop(MessageLoop::TYPE_DEFAULT);
+    base::Timer timer(false, false);
+    base::TimeTicks start = base::TimeTicks::Now();
+    timer.Start(FROM_HERE, TimeDelta::FromMilliseconds(10),
+                TimeDelta::FromMilliseconds(20),
+                base::Bind(&SetCallbackHappened1));
+    EXPECT_EQ(TimeDelta::FromMilliseconds(20), timer.GetCurrentLeeway());
+    MessageLoop::current()->Run();
+    EXPECT_TRUE(g_callback_happened1);
+    EXPECT_LE(TimeDelta::FromMilliseconds(10),
+              base::TimeTicks::Now() - start);
+  }
+}
+
 }  // namespace
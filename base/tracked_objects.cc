@@ -6,6 +6,10 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <numeric>
 
 #include "base/format_macros.h"
 #include "base/memory/scoped_ptr.h"
@@ -93,6 +97,9 @@ void DeathData::RecordDeath(const int32 queue_duration,
     queue_duration_sample_ = queue_duration;
     run_duration_sample_ = run_duration;
   }
+
+  ++queue_duration_histogram_[DurationBucket(queue_duration)];
+  ++run_duration_histogram_[DurationBucket(run_duration)];
 }
 
 int DeathData::count() const { return count_; }
@@ -117,6 +124,24 @@ int32 DeathData::queue_duration_sample() const {
   return queue_duration_sample_;
 }
 
+const int32* DeathData::run_duration_histogram() const {
+  return run_duration_histogram_;
+}
+
+const int32* DeathData::queue_duration_histogram() const {
+  return queue_duration_histogram_;
+}
+
+// static
+int DeathData::DurationBucket(int32 duration) {
+  int bucket = 0;
+  while (duration > 0 && bucket < kDurationHistogramSize - 1) {
+    duration >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
 void DeathData::ResetMax() {
   run_duration_max_ = 0;
   queue_duration_max_ = 0;
@@ -130,6 +155,8 @@ void DeathData::Clear() {
   queue_duration_sum_ = 0;
   queue_duration_max_ = 0;
   queue_duration_sample_ = 0;
+  memset(run_duration_histogram_, 0, sizeof(run_duration_histogram_));
+  memset(queue_duration_histogram_, 0, sizeof(queue_duration_histogram_));
 }
 
 //------------------------------------------------------------------------------
@@ -152,11 +179,53 @@ DeathDataSnapshot::DeathDataSnapshot(
       queue_duration_sum(death_data.queue_duration_sum()),
       queue_duration_max(death_data.queue_duration_max()),
       queue_duration_sample(death_data.queue_duration_sample()) {
+  // Births that are still alive have nothing in the histograms, so don't
+  // bother sending them around.
+  const int32* run = death_data.run_duration_histogram();
+  const int32* queue = death_data.queue_duration_histogram();
+  if (std::accumulate(run, run + DeathData::kDurationHistogramSize, 0)) {
+    run_duration_histogram.assign(run, run + DeathData::kDurationHistogramSize);
+    queue_duration_histogram.assign(queue,
+                                    queue + DeathData::kDurationHistogramSize);
+  }
 }
 
 DeathDataSnapshot::~DeathDataSnapshot() {
 }
 
+// Walks a histogram (see DeathData::kDurationHistogramSize) up to the bucket
+// holding the |percentile|, and returns the upper end of that bucket.
+static int32 HistogramPercentile(const std::vector<int32>& histogram,
+                                 int percentile,
+                                 int32 max) {
+  int64 total = std::accumulate(histogram.begin(), histogram.end(),
+                                static_cast<int64>(0));
+  if (!total)
+    return 0;
+  // The rank of the sample we want, rounded up and counting from 1.
+  int64 rank = std::max<int64>(1, (total * percentile + 99) / 100);
+  int64 seen = 0;
+  for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+    seen += histogram[bucket];
+    if (seen >= rank) {
+      if (bucket + 1 == histogram.size())
+        return max;
+      return std::min<int32>(max, (1 << bucket) - 1);
+    }
+  }
+  return max;
+}
+
+int32 DeathDataSnapshot::RunDurationPercentile(int percentile) const {
+  return HistogramPercentile(run_duration_histogram, percentile,
+                             run_duration_max);
+}
+
+int32 DeathDataSnapshot::QueueDurationPercentile(int percentile) const {
+  return HistogramPercentile(queue_duration_histogram, percentile,
+                             queue_duration_max);
+}
+
 //------------------------------------------------------------------------------
 BirthOnThread::BirthOnThread(const Location& location,
                              const ThreadData& current)
@@ -229,11 +298,15 @@ base::LazyInstance<base::Lock>::Leaky
 // static
 ThreadData::Status ThreadData::status_ = ThreadData::UNINITIALIZED;
 
+// static
+int ThreadData::sampling_interval_ = 1;
+
 ThreadData::ThreadData(const std::string& suggested_name)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(0),
-      incarnation_count_for_pool_(-1) {
+      incarnation_count_for_pool_(-1),
+      births_until_next_sample_(0) {
   DCHECK_GE(suggested_name.size(), 0u);
   thread_name_ = suggested_name;
   PushToHeadOfList();  // Which sets real incarnation_count_for_pool_.
@@ -243,7 +316,8 @@ ThreadData::ThreadData(int thread_number)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(thread_number),
-      incarnation_count_for_pool_(-1)  {
+      incarnation_count_for_pool_(-1),
+      births_until_next_sample_(0) {
   CHECK_GT(thread_number, 0);
   base::StringAppendF(&thread_name_, "WorkerThread-%d", thread_number);
   PushToHeadOfList();  // Which sets real incarnation_count_for_pool_.
@@ -366,6 +440,23 @@ void ThreadData::Snapshot(bool reset_max, ProcessDataSnapshot* process_data) {
   }
 }
 
+bool ThreadData::ShouldSampleBirth() {
+  int interval = sampling_interval_;
+  if (interval <= 1)
+    return true;
+  if (births_until_next_sample_ > 0) {
+    --births_until_next_sample_;
+    return false;
+  }
+  // Skip somewhere between 0 and 2 * (interval - 1) births before the next
+  // sample, so that we sample one in |interval| on average, without locking
+  // step with any periodic pattern of posting.
+  random_number_ = random_number_ * 1103515245 + 12345;
+  births_until_next_sample_ =
+      static_cast<uint32>(random_number_) % (2 * interval - 1);
+  return true;
+}
+
 Births* ThreadData::TallyABirth(const Location& location) {
   BirthMap::iterator it = birth_map_.find(location);
   Births* child;
@@ -438,6 +529,8 @@ Births* ThreadData::TallyABirthIfActive(const Location& location) {
   ThreadData* current_thread_data = Get();
   if (!current_thread_data)
     return NULL;
+  if (!current_thread_data->ShouldSampleBirth())
+    return NULL;  // No birth means the death won't be tallied either.
   return current_thread_data->TallyABirth(location);
 }
 
@@ -716,6 +809,17 @@ bool ThreadData::InitializeAndSetTrackingStatus(Status status) {
   return true;
 }
 
+// static
+void ThreadData::SetSamplingInterval(int interval) {
+  DCHECK_GE(interval, 1);
+  sampling_interval_ = std::max(1, interval);
+}
+
+// static
+int ThreadData::sampling_interval() {
+  return sampling_interval_;
+}
+
 // static
 ThreadData::Status ThreadData::status() {
   return status_;
@@ -738,6 +842,10 @@ TrackedTime ThreadData::NowForStartOfRun(const Births* parent) {
     if (current_thread_data)
       current_thread_data->parent_stack_.push(parent);
   }
+  // Tasks that weren't sampled (or were born while tracking was off) have no
+  // birth, and won't be tallied, so don't bother reading the clock.
+  if (!parent && sampling_interval_ > 1)
+    return TrackedTime();
   return Now();
 }
 
@@ -801,6 +909,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   cleanup_count_ = 0;
   tls_index_.Set(NULL);
   status_ = DORMANT_DURING_TESTS;  // Almost UNINITIALIZED.
+  sampling_interval_ = 1;
 
   // To avoid any chance of racing in unit tests, which is the only place we
   // call this function, we may sometimes leak all the data structures we
@@ -857,10 +966,11 @@ ParentChildPairSnapshot::~ParentChildPairSnapshot() {
 
 ProcessDataSnapshot::ProcessDataSnapshot()
 #if !defined(OS_NACL)
-    : process_id(base::GetCurrentProcId()) {
+    : process_id(base::GetCurrentProcId()),
 #else
-    : process_id(0) {
+    : process_id(0),
 #endif
+      sampling_interval(ThreadData::sampling_interval()) {
 }
 
 ProcessDataSnapshot::~ProcessDataSnapshot() {
@@ -259,6 +259,12 @@ class BASE_EXPORT Births: public BirthOnThread {
 
 class BASE_EXPORT DeathData {
  public:
+  // Durations are also tallied in histograms, so that percentiles of queue and
+  // run times can be estimated.  Bucket 0 counts durations of 0 ms, bucket i
+  // counts those from 2^(i-1) up to 2^i - 1 ms, and the last bucket also counts
+  // everything longer.
+  enum { kDurationHistogramSize = 16 };
+
   // Default initializer.
   DeathData();
 
@@ -281,6 +287,11 @@ class BASE_EXPORT DeathData {
   int32 queue_duration_sum() const;
   int32 queue_duration_max() const;
   int32 queue_duration_sample() const;
+  const int32* run_duration_histogram() const;
+  const int32* queue_duration_histogram() const;
+
+  // The histogram bucket that |duration| is tallied in.
+  static int DurationBucket(int32 duration);
 
   // Reset the max values to zero.
   void ResetMax();
@@ -304,6 +315,9 @@ class BASE_EXPORT DeathData {
   // and rarely updated.
   int32 run_duration_sample_;
   int32 queue_duration_sample_;
+  // Histograms, used for percentiles.  These are only read when snapshotting.
+  int32 run_duration_histogram_[kDurationHistogramSize];
+  int32 queue_duration_histogram_[kDurationHistogramSize];
 };
 
 //------------------------------------------------------------------------------
@@ -314,6 +328,13 @@ struct BASE_EXPORT DeathDataSnapshot {
   explicit DeathDataSnapshot(const DeathData& death_data);
   ~DeathDataSnapshot();
 
+  // Estimate the |percentile| (0 to 100) of the durations, in milliseconds,
+  // from the histograms.  The estimate is the upper end of the bucket the
+  // percentile falls in (but no more than the max).  Returns 0 if no durations
+  // were tallied in the histograms.
+  int32 RunDurationPercentile(int percentile) const;
+  int32 QueueDurationPercentile(int percentile) const;
+
   int count;
   int32 run_duration_sum;
   int32 run_duration_max;
@@ -321,6 +342,10 @@ struct BASE_EXPORT DeathDataSnapshot {
   int32 queue_duration_sum;
   int32 queue_duration_max;
   int32 queue_duration_sample;
+  // See DeathData::kDurationHistogramSize.  These are empty for tasks that
+  // are still alive.
+  std::vector<int32> run_duration_histogram;
+  std::vector<int32> queue_duration_histogram;
 };
 
 //------------------------------------------------------------------------------
@@ -457,6 +482,16 @@ class BASE_EXPORT ThreadData {
   // on.  This is currently a compiled option, atop TrackingStatus().
   static bool TrackingParentChildStatus();
 
+  // Only track about one in |interval| tasks, so that tracking can stay on in
+  // production at a fraction of the cost.  Tasks are picked at random when
+  // they are born (posted), on each thread without any locking; the ones that
+  // aren't picked are not tallied at all, and don't even read the clock when
+  // they start running.  Counts in snapshots are then of the sampled tasks
+  // only, and should be scaled up by the interval.  An |interval| of 1 (the
+  // default) tracks every task.
+  static void SetSamplingInterval(int interval);
+  static int sampling_interval();
+
   // Special versions of Now() for getting times at start and end of a tracked
   // run.  They are super fast when tracking is disabled, and have some internal
   // side effects when we are tracking, so that we can deduce the amount of time
@@ -516,6 +551,10 @@ class BASE_EXPORT ThreadData {
   ThreadData* next() const;
 
 
+  // Returns true if the birth that is about to be tallied on this thread should
+  // be sampled, see SetSamplingInterval().
+  bool ShouldSampleBirth();
+
   // In this thread's data, record a new birth.
   Births* TallyABirth(const Location& location);
 
@@ -616,6 +655,9 @@ class BASE_EXPORT ThreadData {
   // We set status_ to SHUTDOWN when we shut down the tracking service.
   static Status status_;
 
+  // See SetSamplingInterval().  Like status_, this is read without a lock.
+  static int sampling_interval_;
+
   // Link to next instance (null terminated list). Used to globally track all
   // registered instances (corresponds to all registered threads where we keep
   // data).
@@ -677,6 +719,10 @@ class BASE_EXPORT ThreadData {
   // we stir in more and more as we go.
   int32 random_number_;
 
+  // When sampling, the number of births on this thread to skip before the next
+  // one that is tallied.
+  int births_until_next_sample_;
+
   // Record of what the incarnation_counter_ was when this instance was created.
   // If the incarnation_counter_ has changed, then we avoid pushing into the
   // pool (this is only critical in tests which go through multiple
@@ -712,6 +758,8 @@ struct BASE_EXPORT ProcessDataSnapshot {
   std::vector<TaskSnapshot> tasks;
   std::vector<ParentChildPairSnapshot> descendants;
   int process_id;
+  // The ThreadData::sampling_interval() the tasks were tallied with.
+  int sampling_interval;
 };
 
 }  // namespace tracked_objects
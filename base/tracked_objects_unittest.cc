@@ -578,4 +578,76 @@ TEST_F(TrackedObjectsTest, DifferentLives) {
   EXPECT_EQ(base::GetCurrentProcId(), process_data.process_id);
 }
 
+TEST_F(TrackedObjectsTest, DeathDataPercentiles) {
+  DeathData data;
+  // Queue durations of 0, 1, 2, 3 and 100 ms, and run durations of 5 ms.
+  data.RecordDeath(0, 5, 0);
+  data.RecordDeath(1, 5, 0);
+  data.RecordDeath(2, 5, 0);
+  data.RecordDeath(3, 5, 0);
+  data.RecordDeath(100, 5, 0);
+
+  EXPECT_EQ(1, data.queue_duration_histogram()[0]);
+  EXPECT_EQ(1, data.queue_duration_histogram()[1]);
+  EXPECT_EQ(2, data.queue_duration_histogram()[2]);
+  EXPECT_EQ(1, data.queue_duration_histogram()[7]);
+  EXPECT_EQ(5, data.run_duration_histogram()[3]);
+  EXPECT_EQ(DeathData::kDurationHistogramSize - 1,
+            DeathData::DurationBucket(1000000));
+
+  DeathDataSnapshot snapshot(data);
+  ASSERT_EQ(static_cast<size_t>(DeathData::kDurationHistogramSize),
+            snapshot.queue_duration_histogram.size());
+  EXPECT_EQ(0, snapshot.QueueDurationPercentile(0));
+  EXPECT_EQ(0, snapshot.QueueDurationPercentile(20));
+  EXPECT_EQ(3, snapshot.QueueDurationPercentile(50));
+  EXPECT_EQ(3, snapshot.QueueDurationPercentile(80));
+  EXPECT_EQ(100, snapshot.QueueDurationPercentile(90));
+  EXPECT_EQ(100, snapshot.QueueDurationPercentile(100));
+  // The bucket's upper end is capped by the max.
+  EXPECT_EQ(5, snapshot.RunDurationPercentile(50));
+
+  // Births that are still alive carry no histograms.
+  DeathDataSnapshot still_alive((DeathData(3)));
+  EXPECT_TRUE(still_alive.run_duration_histogram.empty());
+  EXPECT_EQ(0, still_alive.RunDurationPercentile(50));
+
+  data.Clear();
+  EXPECT_EQ(0, data.queue_duration_histogram()[2]);
+}
+
+TEST_F(TrackedObjectsTest, SampledBirths) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_ACTIVE))
+    return;
+
+  const char kFunction[] = "SampledBirths";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+  const int kBirths = 1000;
+
+  // By default, every birth is tallied.
+  EXPECT_EQ(1, ThreadData::sampling_interval());
+  for (int i = 0; i < kBirths; ++i)
+    EXPECT_NE(reinterpret_cast<Births*>(NULL),
+              ThreadData::TallyABirthIfActive(location));
+
+  ThreadData::SetSamplingInterval(10);
+  int sampled = 0;
+  for (int i = 0; i < kBirths; ++i) {
+    if (ThreadData::TallyABirthIfActive(location))
+      ++sampled;
+  }
+  EXPECT_LT(0, sampled);
+  EXPECT_GT(kBirths / 2, sampled);
+
+  // Unsampled tasks don't read the clock when they start running.
+  EXPECT_TRUE(ThreadData::NowForStartOfRun(NULL).is_null());
+
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(false, &process_data);
+  EXPECT_EQ(10, process_data.sampling_interval);
+  ASSERT_EQ(1u, process_data.tasks.size());
+  EXPECT_EQ(kBirths + sampled, process_data.tasks[0].death_data.count);
+}
+
 }  // namespace tracked_objects
@@ -7,6 +7,14 @@
 #include "base/string_piece.h"
 #include "base/string_util.h"
 #include "base/utf_string_conversion_utils.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define UTF_CONVERSIONS_USE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 using base::PrepareForUTF8Output;
 using base::PrepareForUTF16Or32Output;
@@ -15,6 +23,106 @@ using base::WriteUnicodeCharacter;
 
 namespace {
 
+// ASCII runs ------------------------------------------------------------------
+
+// Most text converted by the browser is ASCII, and ASCII converts one code
+// unit for one in every encoding, so ConvertUnicode() copies runs of it in
+// bulk and only decodes the rest one code point at a time.
+
+template<typename CHAR>
+inline bool IsASCIIUnit(CHAR c) {
+  return static_cast<typename ToUnsigned<CHAR>::Unsigned>(c) < 0x80;
+}
+
+// Returns how many of the |len| units at |src| are ASCII before the first
+// one that isn't.
+template<typename CHAR>
+size_t CountASCII(const CHAR* src, size_t len) {
+  size_t i = 0;
+  while (i < len && IsASCIIUnit(src[i]))
+    ++i;
+  return i;
+}
+
+// Copies |len| ASCII units from |src| to |dest|.
+template<typename SRC_CHAR, typename DEST_CHAR>
+void CopyASCII(const SRC_CHAR* src, size_t len, DEST_CHAR* dest) {
+  for (size_t i = 0; i < len; ++i)
+    dest[i] = static_cast<DEST_CHAR>(src[i]);
+}
+
+#if defined(UTF_CONVERSIONS_USE_SSE2)
+
+// A UTF-8 byte is ASCII when its high bit is clear.
+size_t CountASCII(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    int non_ascii = _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    if (non_ascii)
+      break;
+  }
+  while (i < len && IsASCIIUnit(src[i]))
+    ++i;
+  return i;
+}
+
+// A UTF-16 unit is ASCII when none of its top nine bits are set.
+size_t CountASCII(const char16* src, size_t len) {
+  const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i is_ascii =
+        _mm_cmpeq_epi16(_mm_and_si128(units, non_ascii_bits), zero);
+    if (_mm_movemask_epi8(is_ascii) != 0xFFFF)
+      break;
+  }
+  while (i < len && IsASCIIUnit(src[i]))
+    ++i;
+  return i;
+}
+
+// Widens 16 bytes at a time by interleaving them with zeros.
+void CopyASCII(const char* src, size_t len, char16* dest) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_unpacklo_epi8(bytes, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8),
+                     _mm_unpackhi_epi8(bytes, zero));
+  }
+  for (; i < len; ++i)
+    dest[i] = static_cast<char16>(src[i]);
+}
+
+// Narrows 16 units at a time. They're all ASCII, so the saturating pack
+// never changes a value.
+void CopyASCII(const char16* src, size_t len, char* dest) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i* units = reinterpret_cast<const __m128i*>(src + i);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_packus_epi16(_mm_loadu_si128(units),
+                                      _mm_loadu_si128(units + 1)));
+  }
+  for (; i < len; ++i)
+    dest[i] = static_cast<char>(src[i]);
+}
+
+#endif  // defined(UTF_CONVERSIONS_USE_SSE2)
+
+// Appends the |len| ASCII units at |src| to |output|.
+template<typename SRC_CHAR, typename DEST_STRING>
+void AppendASCII(const SRC_CHAR* src, size_t len, DEST_STRING* output) {
+  size_t old_length = output->length();
+  output->resize(old_length + len);
+  CopyASCII(src, len, &(*output)[old_length]);
+}
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Converts the given source Unicode character type to the given destination
@@ -29,6 +137,14 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    if (IsASCIIUnit(src[i])) {
+      size_t ascii_length = CountASCII(src + i, src_len - i);
+      AppendASCII(src + i, ascii_length, output);
+      i += static_cast<int32>(ascii_length);
+      if (i == src_len32)
+        break;
+    }
+
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
@@ -0,0 +1,89 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/perftimer.h"
+#include "base/string16.h"
+#include "base/string_util.h"
+#include "base/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kIterations = 100000;
+
+// Page titles of the kind history, bookmarks and the omnibox convert, in
+// UTF-8: mostly ASCII ones, and a few with accents or in other scripts.
+const char* const kTitles[] = {
+  "Google",
+  "YouTube - Broadcast Yourself",
+  "Chromium Code Reviews - Issue 10388002: Speed up IPC channel dispatch",
+  "Wikipedia, the free encyclopedia",
+  "BBC News - Home",
+  "Amazon.com: Online Shopping for Electronics, Apparel, Computers, Books, "
+      "DVDs & more",
+  "The New York Times - Breaking News, World News & Multimedia",
+  "Stack Overflow - Where Developers Learn, Share, & Build Careers",
+  // "Le Monde.fr - Actualité à la Une"
+  "Le Monde.fr - Actualit\xc3\xa9 \xc3\xa0 la Une",
+  // "Süddeutsche Zeitung - Nachrichten aus München"
+  "S\xc3\xbc" "ddeutsche Zeitung - Nachrichten aus M\xc3\xbc" "nchen",
+  // "Яндекс"
+  "\xd0\xaf\xd0\xbd\xd0\xb4\xd0\xb5\xd0\xba\xd1\x81",
+  // "百度一下，你就知道"
+  "\xe7\x99\xbe\xe5\xba\xa6\xe4\xb8\x80\xe4\xb8\x8b\xef\xbc\x8c"
+      "\xe4\xbd\xa0\xe5\xb0\xb1\xe7\x9f\xa5\xe9\x81\x93",
+};
+
+// Splits the titles into the ASCII and the others.
+void GetTitles(bool ascii, std::vector<std::string>* titles) {
+  for (size_t i = 0; i < arraysize(kTitles); ++i) {
+    if (IsStringASCII(kTitles[i]) == ascii)
+      titles->push_back(kTitles[i]);
+  }
+}
+
+void RunUTF8ToUTF16(const char* name, const std::vector<std::string>& titles) {
+  size_t length = 0;
+  PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < titles.size(); ++j)
+      length += UTF8ToUTF16(titles[j]).length();
+  }
+  timer.Done();
+  EXPECT_NE(0u, length);
+}
+
+void RunUTF16ToUTF8(const char* name, const std::vector<std::string>& titles) {
+  std::vector<string16> titles16;
+  for (size_t i = 0; i < titles.size(); ++i)
+    titles16.push_back(UTF8ToUTF16(titles[i]));
+
+  size_t length = 0;
+  PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < titles16.size(); ++j)
+      length += UTF16ToUTF8(titles16[j]).length();
+  }
+  timer.Done();
+  EXPECT_NE(0u, length);
+}
+
+}  // namespace
+
+TEST(UTFStringConversionsPerfTest, ASCIITitles) {
+  std::vector<std::string> titles;
+  GetTitles(true, &titles);
+  RunUTF8ToUTF16("UTF8ToUTF16_ASCIITitles", titles);
+  RunUTF16ToUTF8("UTF16ToUTF8_ASCIITitles", titles);
+}
+
+TEST(UTFStringConversionsPerfTest, NonASCIITitles) {
+  std::vector<std::string> titles;
+  GetTitles(false, &titles);
+  RunUTF8ToUTF16("UTF8ToUTF16_NonASCIITitles", titles);
+  RunUTF16ToUTF8("UTF16ToUTF8_NonASCIITitles", titles);
+}
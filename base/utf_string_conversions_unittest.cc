@@ -208,4 +208,47 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// Long ASCII runs are copied in bulk, so check conversions with a non-ASCII
+// character, or an invalid sequence, at every offset of a long string.
+TEST(UTFStringConversionsTest, ConvertLongMixedStrings) {
+  const std::string ascii("The quick brown fox jumps over the lazy dog. 0123");
+  EXPECT_EQ(ASCIIToUTF16(ascii), UTF8ToUTF16(ascii));
+  EXPECT_EQ(ascii, UTF16ToUTF8(ASCIIToUTF16(ascii)));
+
+  for (size_t i = 0; i <= ascii.length(); ++i) {
+    // "é" and "网" at offset |i|.
+    std::string utf8 = ascii.substr(0, i) + "\xc3\xa9\xe7\xbd\x91" +
+        ascii.substr(i);
+    string16 utf16 = ASCIIToUTF16(ascii.substr(0, i));
+    utf16.push_back(0x00e9);
+    utf16.push_back(0x7f51);
+    utf16.append(ASCIIToUTF16(ascii.substr(i)));
+
+    string16 converted16;
+    EXPECT_TRUE(UTF8ToUTF16(utf8.data(), utf8.length(), &converted16)) << i;
+    EXPECT_EQ(utf16, converted16) << i;
+    std::string converted8;
+    EXPECT_TRUE(UTF16ToUTF8(utf16.data(), utf16.length(), &converted8)) << i;
+    EXPECT_EQ(utf8, converted8) << i;
+    EXPECT_EQ(UTF8ToWide(utf8), UTF16ToWide(utf16)) << i;
+
+    // A stray continuation byte and a lone surrogate become U+FFFD.
+    std::string bad_utf8 = ascii.substr(0, i) + "\x80" + ascii.substr(i);
+    string16 replaced = ASCIIToUTF16(ascii.substr(0, i));
+    replaced.push_back(0xfffd);
+    replaced.append(ASCIIToUTF16(ascii.substr(i)));
+    EXPECT_FALSE(UTF8ToUTF16(bad_utf8.data(), bad_utf8.length(),
+                             &converted16)) << i;
+    EXPECT_EQ(replaced, converted16) << i;
+
+    string16 bad_utf16 = ASCIIToUTF16(ascii.substr(0, i));
+    bad_utf16.push_back(0xd800);
+    bad_utf16.append(ASCIIToUTF16(ascii.substr(i)));
+    EXPECT_FALSE(UTF16ToUTF8(bad_utf16.data(), bad_utf16.length(),
+                             &converted8)) << i;
+    EXPECT_EQ(ascii.substr(0, i) + "\xef\xbf\xbd" + ascii.substr(i),
+              converted8) << i;
+  }
+}
+
 }  // base
@@ -343,6 +343,118 @@ BinaryValue::BinaryValue(char* buffer, size_t size)
   DCHECK(buffer_);
 }
 
+///////////////////// DictionaryStorage ////////////////////
+
+namespace internal {
+
+namespace {
+
+struct EntryKeyLess {
+  bool operator()(const std::pair<std::string, Value*>& entry,
+                  const std::string& key) const {
+    return entry.first < key;
+  }
+};
+
+}  // namespace
+
+// static
+const size_t DictionaryStorage::kMaxFlatSize;
+
+DictionaryStorage::DictionaryStorage() {
+}
+
+DictionaryStorage::~DictionaryStorage() {
+}
+
+Value* DictionaryStorage::Find(const std::string& key) const {
+  if (!is_flat()) {
+    ValueMap::const_iterator it = map_.find(key);
+    return it == map_.end() ? NULL : it->second;
+  }
+  FlatValueMap::const_iterator it =
+      std::lower_bound(flat_.begin(), flat_.end(), key, EntryKeyLess());
+  return (it == flat_.end() || it->first != key) ? NULL : it->second;
+}
+
+Value* DictionaryStorage::Insert(const std::string& key, Value* value) {
+  if (is_flat()) {
+    if (flat_.empty() || flat_.back().first < key) {
+      if (flat_.size() < kMaxFlatSize) {
+        flat_.push_back(std::make_pair(key, value));
+        return NULL;
+      }
+    } else {
+      FlatValueMap::iterator it =
+          std::lower_bound(flat_.begin(), flat_.end(), key, EntryKeyLess());
+      if (it->first == key) {
+        Value* old_value = it->second;
+        it->second = value;
+        return old_value;
+      }
+      if (flat_.size() < kMaxFlatSize) {
+        flat_.insert(it, std::make_pair(key, value));
+        return NULL;
+      }
+    }
+    ConvertToMap();
+  }
+
+  std::pair<ValueMap::iterator, bool> ins_res =
+      map_.insert(std::make_pair(key, value));
+  if (ins_res.second)
+    return NULL;
+  Value* old_value = ins_res.first->second;
+  ins_res.first->second = value;
+  return old_value;
+}
+
+Value* DictionaryStorage::Erase(const std::string& key) {
+  if (!is_flat()) {
+    ValueMap::iterator it = map_.find(key);
+    if (it == map_.end())
+      return NULL;
+    Value* value = it->second;
+    map_.erase(it);
+    // Large dictionaries that shrink stay maps; converting back and forth
+    // around the threshold isn't worth it.
+    return value;
+  }
+  FlatValueMap::iterator it =
+      std::lower_bound(flat_.begin(), flat_.end(), key, EntryKeyLess());
+  if (it == flat_.end() || it->first != key)
+    return NULL;
+  Value* value = it->second;
+  flat_.erase(it);
+  return value;
+}
+
+void DictionaryStorage::Reserve(size_t size) {
+  if (is_flat() && size <= kMaxFlatSize)
+    flat_.reserve(size);
+}
+
+void DictionaryStorage::Clear() {
+  FlatValueMap().swap(flat_);
+  map_.clear();
+}
+
+void DictionaryStorage::Swap(DictionaryStorage* other) {
+  flat_.swap(other->flat_);
+  map_.swap(other->map_);
+}
+
+void DictionaryStorage::ConvertToMap() {
+  DCHECK(map_.empty());
+  for (FlatValueMap::const_iterator it = flat_.begin(); it != flat_.end();
+       ++it) {
+    map_.insert(map_.end(), *it);
+  }
+  FlatValueMap().swap(flat_);
+}
+
+}  // namespace internal
+
 ///////////////////// DictionaryValue ////////////////////
 
 DictionaryValue::DictionaryValue()
@@ -367,19 +479,16 @@ bool DictionaryValue::GetAsDictionary(const DictionaryValue** out_value) const {
 
 bool DictionaryValue::HasKey(const std::string& key) const {
   DCHECK(IsStringUTF8(key));
-  ValueMap::const_iterator current_entry = dictionary_.find(key);
-  DCHECK((current_entry == dictionary_.end()) || current_entry->second);
-  return current_entry != dictionary_.end();
+  return dictionary_.Find(key) != NULL;
 }
 
 void DictionaryValue::Clear() {
-  ValueMap::iterator dict_iterator = dictionary_.begin();
-  while (dict_iterator != dictionary_.end()) {
-    delete dict_iterator->second;
-    ++dict_iterator;
+  for (internal::DictionaryStorage::const_iterator it = dictionary_.begin();
+       it != dictionary_.end(); ++it) {
+    delete it.value();
   }
 
-  dictionary_.clear();
+  dictionary_.Clear();
 }
 
 void DictionaryValue::Set(const std::string& path, Value* in_value) {
@@ -432,13 +541,9 @@ void DictionaryValue::SetWithoutPathExpansion(const std::string& key,
                                               Value* in_value) {
   // If there's an existing value here, we need to delete it, because
   // we own all our children.
-  std::pair<ValueMap::iterator, bool> ins_res =
-      dictionary_.insert(std::make_pair(key, in_value));
-  if (!ins_res.second) {
-    DCHECK_NE(ins_res.first->second, in_value);  // This would be bogus
-    delete ins_res.first->second;
-    ins_res.first->second = in_value;
-  }
+  Value* old_value = dictionary_.Insert(key, in_value);
+  DCHECK_NE(old_value, in_value);  // This would be bogus
+  delete old_value;
 }
 
 bool DictionaryValue::Get(const std::string& path, Value** out_value) const {
@@ -562,11 +667,10 @@ bool DictionaryValue::GetList(const std::string& path,
 bool DictionaryValue::GetWithoutPathExpansion(const std::string& key,
                                               Value** out_value) const {
   DCHECK(IsStringUTF8(key));
-  ValueMap::const_iterator entry_iterator = dictionary_.find(key);
-  if (entry_iterator == dictionary_.end())
+  Value* entry = dictionary_.Find(key);
+  if (!entry)
     return false;
 
-  Value* entry = entry_iterator->second;
   if (out_value)
     *out_value = entry;
   return true;
@@ -656,16 +760,14 @@ bool DictionaryValue::Remove(const std::string& path, Value** out_value) {
 bool DictionaryValue::RemoveWithoutPathExpansion(const std::string& key,
                                                  Value** out_value) {
   DCHECK(IsStringUTF8(key));
-  ValueMap::iterator entry_iterator = dictionary_.find(key);
-  if (entry_iterator == dictionary_.end())
+  Value* entry = dictionary_.Erase(key);
+  if (!entry)
     return false;
 
-  Value* entry = entry_iterator->second;
   if (out_value)
     *out_value = entry;
   else
     delete entry;
-  dictionary_.erase(entry_iterator);
   return true;
 }
 
@@ -697,10 +799,11 @@ void DictionaryValue::MergeDictionary(const DictionaryValue* dictionary) {
 DictionaryValue* DictionaryValue::DeepCopy() const {
   DictionaryValue* result = new DictionaryValue;
 
-  for (ValueMap::const_iterator current_entry(dictionary_.begin());
-       current_entry != dictionary_.end(); ++current_entry) {
-    result->SetWithoutPathExpansion(current_entry->first,
-                                    current_entry->second->DeepCopy());
+  // Entries come out in key order, so each Insert() is an append.
+  result->dictionary_.Reserve(dictionary_.size());
+  for (internal::DictionaryStorage::const_iterator it = dictionary_.begin();
+       it != dictionary_.end(); ++it) {
+    result->dictionary_.Insert(it.key(), it.value()->DeepCopy());
   }
 
   return result;
@@ -712,22 +815,19 @@ bool DictionaryValue::Equals(const Value* other) const {
 
   const DictionaryValue* other_dict =
       static_cast<const DictionaryValue*>(other);
-  key_iterator lhs_it(begin_keys());
-  key_iterator rhs_it(other_dict->begin_keys());
-  while (lhs_it != end_keys() && rhs_it != other_dict->end_keys()) {
-    Value* lhs;
-    Value* rhs;
-    if (*lhs_it != *rhs_it ||
-        !GetWithoutPathExpansion(*lhs_it, &lhs) ||
-        !other_dict->GetWithoutPathExpansion(*rhs_it, &rhs) ||
-        !lhs->Equals(rhs)) {
+  if (dictionary_.size() != other_dict->dictionary_.size())
+    return false;
+
+  // Both sides iterate in key order, so compare entries pairwise.
+  internal::DictionaryStorage::const_iterator lhs_it(dictionary_.begin());
+  internal::DictionaryStorage::const_iterator rhs_it(
+      other_dict->dictionary_.begin());
+  for (; lhs_it != dictionary_.end(); ++lhs_it, ++rhs_it) {
+    if (lhs_it.key() != rhs_it.key() ||
+        !lhs_it.value()->Equals(rhs_it.value())) {
       return false;
     }
-    ++lhs_it;
-    ++rhs_it;
   }
-  if (lhs_it != end_keys() || rhs_it != other_dict->end_keys())
-    return false;
 
   return true;
 }
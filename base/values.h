@@ -25,6 +25,7 @@
 #include <iterator>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/base_export.h"
@@ -209,6 +210,107 @@ class BASE_EXPORT BinaryValue: public Value {
   DISALLOW_COPY_AND_ASSIGN(BinaryValue);
 };
 
+namespace internal {
+
+// Entry storage for DictionaryValue.  Most dictionaries hold only a handful
+// of entries, so those are kept in a vector sorted by key: one allocation for
+// the whole dictionary rather than one map node per entry, and cheap to walk
+// and copy.  Once a dictionary grows past kMaxFlatSize entries it moves them
+// into a ValueMap so that inserting into large dictionaries stays
+// logarithmic.  The storage does not own the values; DictionaryValue does.
+class BASE_EXPORT DictionaryStorage {
+ private:
+  typedef std::vector<std::pair<std::string, Value*> > FlatValueMap;
+
+ public:
+  static const size_t kMaxFlatSize = 32;
+
+  // Walks the entries in key order, whichever representation is in use.
+  class const_iterator {
+   public:
+    const std::string& key() const {
+      return is_flat_ ? flat_it_->first : map_it_->first;
+    }
+    Value* value() const {
+      return is_flat_ ? flat_it_->second : map_it_->second;
+    }
+
+    const_iterator& operator++() {
+      if (is_flat_)
+        ++flat_it_;
+      else
+        ++map_it_;
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const {
+      return is_flat_ ? flat_it_ == other.flat_it_ : map_it_ == other.map_it_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class DictionaryStorage;
+
+    explicit const_iterator(FlatValueMap::const_iterator it)
+        : is_flat_(true), flat_it_(it) {}
+    explicit const_iterator(ValueMap::const_iterator it)
+        : is_flat_(false), map_it_(it) {}
+
+    bool is_flat_;
+    FlatValueMap::const_iterator flat_it_;
+    ValueMap::const_iterator map_it_;
+  };
+
+  DictionaryStorage();
+  ~DictionaryStorage();
+
+  size_t size() const { return is_flat() ? flat_.size() : map_.size(); }
+  bool empty() const { return flat_.empty() && map_.empty(); }
+
+  const_iterator begin() const {
+    return is_flat() ? const_iterator(flat_.begin()) :
+                       const_iterator(map_.begin());
+  }
+  const_iterator end() const {
+    return is_flat() ? const_iterator(flat_.end()) :
+                       const_iterator(map_.end());
+  }
+
+  // Returns the value stored under |key|, or NULL if there is none.
+  Value* Find(const std::string& key) const;
+
+  // Stores |value| under |key|.  Returns the value previously stored under
+  // |key|, which the caller now owns, or NULL.  Inserting keys in increasing
+  // order, as DeepCopy() and the JSON parser typically do, is O(1).
+  Value* Insert(const std::string& key, Value* value);
+
+  // Removes |key| and returns its value, which the caller now owns, or NULL
+  // if |key| wasn't present.
+  Value* Erase(const std::string& key);
+
+  // Makes room for |size| entries; used when the final size is known.
+  void Reserve(size_t size);
+
+  // Forgets all entries without deleting the values.
+  void Clear();
+
+  void Swap(DictionaryStorage* other);
+
+ private:
+  bool is_flat() const { return map_.empty(); }
+
+  // Moves the flat entries into |map_|.
+  void ConvertToMap();
+
+  FlatValueMap flat_;
+  ValueMap map_;
+
+  DISALLOW_COPY_AND_ASSIGN(DictionaryStorage);
+};
+
+}  // namespace internal
+
 // DictionaryValue provides a key-value dictionary with (optional) "path"
 // parsing for recursive access; see the comment at the top of the file. Keys
 // are |std::string|s and should be UTF-8 encoded.
@@ -321,7 +423,7 @@ class BASE_EXPORT DictionaryValue : public Value {
 
   // Swaps contents with the |other| dictionary.
   void Swap(DictionaryValue* other) {
-    dictionary_.swap(other->dictionary_);
+    dictionary_.Swap(&other->dictionary_);
   }
 
   // This class provides an iterator for the keys in the dictionary.
@@ -333,17 +435,18 @@ class BASE_EXPORT DictionaryValue : public Value {
   class key_iterator
       : private std::iterator<std::input_iterator_tag, const std::string> {
    public:
-    explicit key_iterator(ValueMap::const_iterator itr) { itr_ = itr; }
+    explicit key_iterator(internal::DictionaryStorage::const_iterator itr)
+        : itr_(itr) {}
     key_iterator operator++() {
       ++itr_;
       return *this;
     }
-    const std::string& operator*() { return itr_->first; }
+    const std::string& operator*() { return itr_.key(); }
     bool operator!=(const key_iterator& other) { return itr_ != other.itr_; }
     bool operator==(const key_iterator& other) { return itr_ == other.itr_; }
 
    private:
-    ValueMap::const_iterator itr_;
+    internal::DictionaryStorage::const_iterator itr_;
   };
 
   key_iterator begin_keys() const { return key_iterator(dictionary_.begin()); }
@@ -359,12 +462,12 @@ class BASE_EXPORT DictionaryValue : public Value {
     bool HasNext() const { return it_ != target_.dictionary_.end(); }
     void Advance() { ++it_; }
 
-    const std::string& key() const { return it_->first; }
-    const Value& value() const { return *it_->second; }
+    const std::string& key() const { return it_.key(); }
+    const Value& value() const { return *it_.value(); }
 
    private:
     const DictionaryValue& target_;
-    ValueMap::const_iterator it_;
+    internal::DictionaryStorage::const_iterator it_;
   };
 
   // Overridden from Value:
@@ -372,7 +475,7 @@ class BASE_EXPORT DictionaryValue : public Value {
   virtual bool Equals(const Value* other) const OVERRIDE;
 
  private:
-  ValueMap dictionary_;
+  internal::DictionaryStorage dictionary_;
 
   DISALLOW_COPY_AND_ASSIGN(DictionaryValue);
 };
@@ -6,6 +6,7 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/string16.h"
+#include "base/string_number_conversions.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -755,4 +756,57 @@ TEST(ValuesTest, DictionaryIterator) {
   EXPECT_TRUE(seen2);
 }
 
+TEST(ValuesTest, LargeDictionary) {
+  // Cross the threshold at which dictionaries switch from the flat
+  // representation to a map, inserting keys out of order.
+  const int kSize = 3 * internal::DictionaryStorage::kMaxFlatSize;
+  DictionaryValue dict;
+  for (int i = kSize - 1; i >= 0; i -= 2)
+    dict.SetInteger(IntToString(i), i);
+  for (int i = 0; i < kSize; i += 2)
+    dict.SetInteger(IntToString(i), i);
+  EXPECT_EQ(static_cast<size_t>(kSize), dict.size());
+
+  // Replacing an existing key doesn't add an entry.
+  dict.SetInteger("7", 70);
+  EXPECT_EQ(static_cast<size_t>(kSize), dict.size());
+  int value = 0;
+  EXPECT_TRUE(dict.GetInteger("7", &value));
+  EXPECT_EQ(70, value);
+  dict.SetInteger("7", 7);
+
+  // Iteration is in key order.
+  std::string last_key;
+  int count = 0;
+  for (DictionaryValue::Iterator it(dict); it.HasNext(); it.Advance()) {
+    EXPECT_LT(last_key, it.key());
+    last_key = it.key();
+    ++count;
+  }
+  EXPECT_EQ(kSize, count);
+
+  scoped_ptr<DictionaryValue> copy(dict.DeepCopy());
+  EXPECT_TRUE(dict.Equals(copy.get()));
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_TRUE(copy->GetInteger(IntToString(i), &value));
+    EXPECT_EQ(i, value);
+  }
+
+  EXPECT_TRUE(copy->RemoveWithoutPathExpansion("5", NULL));
+  EXPECT_FALSE(copy->RemoveWithoutPathExpansion("5", NULL));
+  EXPECT_FALSE(copy->HasKey("5"));
+  EXPECT_FALSE(dict.Equals(copy.get()));
+  copy->SetInteger("5", 5);
+  EXPECT_TRUE(dict.Equals(copy.get()));
+
+  // A small dictionary never equals a large one with the same prefix.
+  DictionaryValue small;
+  small.SetInteger("0", 0);
+  EXPECT_FALSE(small.Equals(&dict));
+  EXPECT_FALSE(dict.Equals(&small));
+  small.Swap(copy.get());
+  EXPECT_EQ(1U, copy->size());
+  EXPECT_TRUE(dict.Equals(&small));
+}
+
 }  // namespace base
@@ -33,6 +33,8 @@
 #include "content/public/common/content_client.h"
 #include "content/public/common/content_paths.h"
 #include "content/public/common/content_switches.h"
+#include "ui/base/resource/resource_bundle.h"
+#include "ui/base/resource/resource_handle.h"
 #include "ui/base/ui_base_switches.h"
 
 #if defined(OS_WIN)
@@ -618,6 +620,15 @@ void ChromeMainDelegate::PreSandboxStartup() {
     CHECK(!loaded_locale.empty()) << "Locale could not be found for " <<
         locale;
 
+    // Map the images the browser decoded ahead of time, so that this process
+    // shares them instead of decoding its own copies.
+    FilePath decoded_image_pack_path;
+    if (PathService::Get(chrome::FILE_DECODED_IMAGE_PACK,
+                         &decoded_image_pack_path)) {
+      ResourceBundle::GetSharedInstance().LoadDecodedImagePack(
+          ui::ResourceHandle::kScaleFactor100x, decoded_image_pack_path);
+    }
+
 #if defined(OS_MACOSX)
     // Update the process name (need resources to get the strings, so
     // only do this when ResourcesBundle has been initialized).
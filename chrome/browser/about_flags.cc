@@ -420,11 +420,11 @@ const Experiment kExperiments[] = {
     SINGLE_VALUE_TYPE(switches::kEnableSpdy3)
   },
   {
-    "enable-async-dns",
-    IDS_FLAGS_ENABLE_ASYNC_DNS_NAME,
-    IDS_FLAGS_ENABLE_ASYNC_DNS_DESCRIPTION,
+    "disable-async-dns",
+    IDS_FLAGS_DISABLE_ASYNC_DNS_NAME,
+    IDS_FLAGS_DISABLE_ASYNC_DNS_DESCRIPTION,
     kOsWin | kOsMac | kOsLinux | kOsCrOS,
-    SINGLE_VALUE_TYPE(switches::kEnableAsyncDns)
+    SINGLE_VALUE_TYPE(switches::kDisableAsyncDns)
   },
   {
     "enable-video-track",
@@ -480,15 +480,15 @@ const Experiment kExperiments[] = {
     SINGLE_VALUE_TYPE(switches::kEnableGamepad)
   },
   {
-    "per-tile-painting",
-    IDS_FLAGS_PER_TILE_PAINTING_NAME,
-    IDS_FLAGS_PER_TILE_PAINTING_DESCRIPTION,
+    "disable-per-tile-painting",
+    IDS_FLAGS_DISABLE_PER_TILE_PAINTING_NAME,
+    IDS_FLAGS_DISABLE_PER_TILE_PAINTING_DESCRIPTION,
 #if defined(USE_SKIA)
     kOsMac | kOsLinux | kOsCrOS,
 #else
     0,
 #endif
-    SINGLE_VALUE_TYPE(switches::kEnablePerTilePainting)
+    SINGLE_VALUE_TYPE(switches::kDisablePerTilePainting)
   },
   {
     "enable-javascript-harmony",
@@ -924,9 +924,20 @@ void AutocompleteController::Start(
   base::TimeTicks start_time = base::TimeTicks::Now();
   for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
        ++i) {
+    base::TimeTicks provider_start_time = base::TimeTicks::Now();
     (*i)->Start(input_, minimal_changes);
-    if (matches_requested != AutocompleteInput::ALL_MATCHES)
+    if (matches_requested != AutocompleteInput::ALL_MATCHES) {
       DCHECK((*i)->done());
+      continue;
+    }
+    // Record how long each provider's synchronous pass blocks the UI thread,
+    // so a provider that slows down typing can be singled out.
+    base::Histogram* provider_time = base::Histogram::FactoryTimeGet(
+        std::string("Omnibox.ProviderTime.") + (*i)->name(),
+        base::TimeDelta::FromMilliseconds(1),
+        base::TimeDelta::FromSeconds(1), 50,
+        base::Histogram::kUmaTargetedHistogramFlag);
+    provider_time->AddTime(base::TimeTicks::Now() - provider_start_time);
   }
   if (matches_requested == AutocompleteInput::ALL_MATCHES &&
       (text.length() < 6)) {
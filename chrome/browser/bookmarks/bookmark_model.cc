@@ -10,7 +10,9 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/memory/scoped_vector.h"
+#include "base/metrics/histogram.h"
 #include "base/string_util.h"
+#include "base/time.h"
 #include "build/build_config.h"
 #include "chrome/browser/bookmarks/bookmark_expanded_state_tracker.h"
 #include "chrome/browser/bookmarks/bookmark_index.h"
@@ -627,9 +629,12 @@ void BookmarkModel::DoneLoading(
   root_.Add(mobile_node_, 2);
 
   {
+    base::TimeTicks start_time = base::TimeTicks::Now();
     base::AutoLock url_lock(url_lock_);
     // Update nodes_ordered_by_url_set_ from the nodes.
     PopulateNodesByURL(&root_);
+    UMA_HISTOGRAM_TIMES("Bookmarks.PopulateNodesByURLTime",
+                        base::TimeTicks::Now() - start_time);
   }
 
   loaded_ = true;
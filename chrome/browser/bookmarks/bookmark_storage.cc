@@ -5,6 +5,7 @@
 #include "chrome/browser/bookmarks/bookmark_storage.h"
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
 #include "base/file_util_proxy.h"
@@ -86,6 +87,13 @@ void LoadCallback(const FilePath& path,
                  bookmark_file_exists, path));
 }
 
+// Writes the encoded bookmarks in |value| as JSON to |output|.
+bool SerializeBookmarks(const Value* value, std::string* output) {
+  JSONStringValueSerializer serializer(output);
+  serializer.set_pretty_print(true);
+  return serializer.Serialize(*value);
+}
+
 }  // namespace
 
 // BookmarkLoadDetails ---------------------------------------------------------
@@ -170,7 +178,7 @@ void BookmarkStorage::OnHistoryFinishedWriting() {
 }
 
 void BookmarkStorage::ScheduleSave() {
-  writer_.ScheduleWrite(this);
+  writer_.ScheduleWriteWithBackgroundSerializer(this);
 }
 
 void BookmarkStorage::BookmarkModelDeleted() {
@@ -184,9 +192,12 @@ void BookmarkStorage::BookmarkModelDeleted() {
 bool BookmarkStorage::SerializeData(std::string* output) {
   BookmarkCodec codec;
   scoped_ptr<Value> value(codec.Encode(model_));
-  JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
-  return serializer.Serialize(*(value.get()));
+  return SerializeBookmarks(value.get(), output);
+}
+
+ImportantFileWriter::DataProducer BookmarkStorage::GetSerializedDataProducer() {
+  BookmarkCodec codec;
+  return base::Bind(&SerializeBookmarks, base::Owned(codec.Encode(model_)));
 }
 
 void BookmarkStorage::OnLoadFinished(bool file_exists, const FilePath& path) {
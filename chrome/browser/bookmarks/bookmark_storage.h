@@ -95,6 +95,7 @@ class BookmarkLoadDetails {
 // Internally BookmarkStorage uses BookmarkCodec to do the actual read/write.
 class BookmarkStorage : public content::NotificationObserver,
                         public ImportantFileWriter::DataSerializer,
+                        public ImportantFileWriter::BackgroundDataSerializer,
                         public base::RefCountedThreadSafe<BookmarkStorage> {
  public:
   // Creates a BookmarkStorage for the specified model
@@ -120,6 +121,11 @@ class BookmarkStorage : public content::NotificationObserver,
   // ImportantFileWriter::DataSerializer implementation.
   virtual bool SerializeData(std::string* output) OVERRIDE;
 
+  // ImportantFileWriter::BackgroundDataSerializer implementation. Encodes the
+  // model now, and leaves writing the JSON to the FILE thread.
+  virtual ImportantFileWriter::DataProducer GetSerializedDataProducer()
+      OVERRIDE;
+
  private:
   friend class base::RefCountedThreadSafe<BookmarkStorage>;
 
@@ -50,6 +50,7 @@
 #include "chrome/browser/instant/instant_field_trial.h"
 #include "chrome/browser/jankometer.h"
 #include "chrome/browser/language_usage_metrics.h"
+#include "chrome/browser/memory_pressure_monitor.h"
 #include "chrome/browser/metrics/histogram_synchronizer.h"
 #include "chrome/browser/metrics/field_trial_synchronizer.h"
 #include "chrome/browser/metrics/metrics_log.h"
@@ -78,6 +79,7 @@
 #include "chrome/browser/search_engines/template_url_service_factory.h"
 #include "chrome/browser/service/service_process_control.h"
 #include "chrome/browser/shell_integration.h"
+#include "chrome/browser/startup_task_runner.h"
 #include "chrome/browser/translate/translate_manager.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_init.h"
@@ -107,6 +109,8 @@
 #include "grit/chromium_strings.h"
 #include "grit/generated_resources.h"
 #include "grit/platform_locale_settings.h"
+#include "grit/theme_resources.h"
+#include "grit/theme_resources_standard.h"
 #include "net/base/net_module.h"
 #include "net/base/sdch_manager.h"
 #include "net/base/ssl_config_service.h"
@@ -120,6 +124,7 @@
 #include "net/spdy/spdy_session_pool.h"
 #include "net/url_request/url_request.h"
 #include "net/websockets/websocket_job.h"
+#include "sql/connection.h"
 #include "ui/base/l10n/l10n_util.h"
 #include "ui/base/resource/resource_bundle.h"
 #include "ui/base/resource/resource_handle.h"
@@ -186,6 +191,10 @@ using content::BrowserThread;
 
 namespace {
 
+// Upper bound on the memory SQLite may hold across all databases in the
+// browser process before connections start recycling page cache.
+const int64 kSqliteMemoryLimitBytes = 32 * 1024 * 1024;
+
 // This function provides some ways to test crash and assertion handling
 // behavior of the program.
 void HandleTestParameters(const CommandLine& command_line) {
@@ -360,6 +369,7 @@ PrefService* InitializeLocalState(const CommandLine& parsed_command_line,
 Profile* CreateProfile(const content::MainFunctionParams& parameters,
                        const FilePath& user_data_dir,
                        const CommandLine& parsed_command_line) {
+  TRACE_EVENT0("startup", "ChromeBrowserMainParts::CreateProfile");
   Profile* profile;
   if (ProfileManager::IsMultipleProfilesEnabled() &&
       parsed_command_line.HasSwitch(switches::kProfileDirectory)) {
@@ -472,6 +482,50 @@ void AddPreReadHistogramTime(const char* name, base::TimeDelta time) {
   counter->AddTime(time);
 }
 
+// Decodes the resource images of this version into a pack that later
+// processes map instead of decoding the images themselves. Older versions'
+// packs are deleted. Runs on the FILE thread.
+void BuildDecodedImagePack() {
+  FilePath pack_path;
+  if (!PathService::Get(chrome::FILE_DECODED_IMAGE_PACK, &pack_path) ||
+      file_util::PathExists(pack_path)) {
+    return;
+  }
+
+  FilePath versions_dir = pack_path.DirName().DirName();
+  file_util::FileEnumerator versions(versions_dir, false,
+                                     file_util::FileEnumerator::DIRECTORIES);
+  for (FilePath version = versions.Next(); !version.empty();
+       version = versions.Next()) {
+    if (version != pack_path.DirName())
+      file_util::Delete(version, true);
+  }
+
+  // Write to a temporary file first, so that no process maps a partial pack.
+  FilePath temp_path;
+  if (!file_util::CreateDirectory(pack_path.DirName()) ||
+      !file_util::CreateTemporaryFileInDir(pack_path.DirName(), &temp_path)) {
+    return;
+  }
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!ResourceBundle::GetSharedInstance().WriteDecodedImagePack(
+          ui::ResourceHandle::kScaleFactor100x, temp_path) ||
+      !file_util::Move(temp_path, pack_path)) {
+    file_util::Delete(temp_path, false);
+    return;
+  }
+  UMA_HISTOGRAM_TIMES("Startup.BuildDecodedImagePackTime",
+                      base::TimeTicks::Now() - start);
+}
+
+// Records the languages the user reads and the browser runs in.
+void RecordLanguageUsage(Profile* profile) {
+  LanguageUsageMetrics::RecordAcceptLanguages(
+      profile->GetPrefs()->GetString(prefs::kAcceptLanguages));
+  LanguageUsageMetrics::RecordApplicationLanguage(
+      g_browser_process->GetApplicationLocale());
+}
+
 bool ProcessSingletonNotificationCallback(const CommandLine& command_line,
                                           const FilePath& current_directory) {
   // Drop the request if the browser process is already in shutdown path.
@@ -509,6 +563,19 @@ bool HasImportSwitch(const CommandLine& command_line) {
           command_line.HasSwitch(switches::kImportFromFile));
 }
 
+// Decodes the frame and toolbar images the first browser window paints, so
+// the UI thread finds them already cached.
+void PreloadBrowserWindowImages() {
+  static const int kImages[] = {
+    IDR_THEME_FRAME,
+    IDR_THEME_FRAME_INACTIVE,
+    IDR_THEME_TOOLBAR,
+    IDR_THEME_TAB_BACKGROUND,
+  };
+  ResourceBundle::GetSharedInstance().PreloadImages(
+      std::vector<int>(kImages, kImages + arraysize(kImages)));
+}
+
 }  // namespace
 
 namespace chrome_browser {
@@ -1219,6 +1286,10 @@ int ChromeBrowserMainParts::PreCreateThreadsImpl() {
       !HasImportSwitch(parsed_command_line());
   browser_process_.reset(new BrowserProcessImpl(parsed_command_line()));
 
+  // Share one memory budget between every profile database; busy databases
+  // keep their page cache while idle ones give theirs back.
+  sql::Connection::SetMemoryLimit(kSqliteMemoryLimitBytes);
+
   if (parsed_command_line().HasSwitch(switches::kEnableProfiling)) {
     // User wants to override default tracking status.
     std::string flag =
@@ -1280,6 +1351,14 @@ int ChromeBrowserMainParts::PreCreateThreadsImpl() {
     ResourceBundle::GetSharedInstance().AddDataPack(
         resources_pack_path, ui::ResourceHandle::kScaleFactor100x);
 #endif  // defined(OS_MACOSX)
+
+    // Share the images decoded by an earlier run of this version, if any.
+    FilePath decoded_image_pack_path;
+    if (PathService::Get(chrome::FILE_DECODED_IMAGE_PACK,
+                         &decoded_image_pack_path)) {
+      ResourceBundle::GetSharedInstance().LoadDecodedImagePack(
+          ui::ResourceHandle::kScaleFactor100x, decoded_image_pack_path);
+    }
   }
 
 #if defined(TOOLKIT_GTK)
@@ -1437,6 +1516,9 @@ void ChromeBrowserMainParts::PostBrowserStart() {
 }
 
 int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
+  TRACE_EVENT0("startup", "ChromeBrowserMainParts::PreMainMessageLoopRunImpl");
+  startup_task_runner_.reset(new StartupTaskRunner);
+
   // Now that the file thread has been started, start recording.
   StartMetricsRecording();
 
@@ -1448,6 +1530,14 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
   // running.
   browser_process_->PreMainMessageLoopRun();
 
+  // Let caches know when the system runs low on memory.
+  memory_pressure_monitor_.reset(new MemoryPressureMonitor);
+  memory_pressure_monitor_->Start();
+
+  content::BrowserThread::PostTask(
+      content::BrowserThread::FILE, FROM_HERE,
+      base::Bind(&PreloadBrowserWindowImages));
+
   // Record last shutdown time into a histogram.
   browser_shutdown::ReadLastShutdownInfo();
 
@@ -1731,14 +1821,28 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
 #endif
 
   HandleTestParameters(parsed_command_line());
-  RecordBreakpadStatusUMA(browser_process_->metrics_service());
+
+  // Metrics that nothing at startup depends on wait for the first window.
+  startup_task_runner_->AddTask(
+      "RecordBreakpadStatus", StartupTaskRunner::DEFERRABLE,
+      base::Bind(&RecordBreakpadStatusUMA,
+                 browser_process_->metrics_service()));
 #if !defined(OS_ANDROID)
-  about_flags::RecordUMAStatistics(local_state_);
+  startup_task_runner_->AddTask(
+      "RecordAboutFlags", StartupTaskRunner::DEFERRABLE,
+      base::Bind(&about_flags::RecordUMAStatistics, local_state_));
 #endif
-  LanguageUsageMetrics::RecordAcceptLanguages(
-      profile_->GetPrefs()->GetString(prefs::kAcceptLanguages));
-  LanguageUsageMetrics::RecordApplicationLanguage(
-      browser_process_->GetApplicationLocale());
+  startup_task_runner_->AddTask(
+      "RecordLanguageUsage", StartupTaskRunner::DEFERRABLE,
+      base::Bind(&RecordLanguageUsage, profile_));
+
+  // Decoding every image takes a while; the FILE thread does it once per
+  // version, after the first window is up.
+  startup_task_runner_->AddTask(
+      "BuildDecodedImagePack", StartupTaskRunner::DEFERRABLE,
+      base::Bind(base::IgnoreResult(&content::BrowserThread::PostTask),
+                 content::BrowserThread::FILE, FROM_HERE,
+                 base::Bind(&BuildDecodedImagePack)));
 
   // The extension service may be available at this point. If the command line
   // specifies --uninstall-extension, attempt the uninstall extension startup
@@ -1770,19 +1874,33 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
   // TODO(torne): this should maybe be done with
   // ProfileKeyedServiceFactory::ServiceIsCreatedWithProfile() instead?
 #if !defined(OS_ANDROID)
-  CloudPrintProxyServiceFactory::GetForProfile(profile_);
+  startup_task_runner_->AddTask(
+      "CloudPrintProxyService", StartupTaskRunner::DEFERRABLE,
+      base::Bind(
+          base::IgnoreResult(&CloudPrintProxyServiceFactory::GetForProfile),
+          profile_));
 #endif
 
   // Load GPU Blacklist.
-  InitializeGpuDataManager(parsed_command_line());
+  startup_task_runner_->AddTask(
+      "InitializeGpuDataManager", StartupTaskRunner::CRITICAL,
+      base::Bind(&InitializeGpuDataManager,
+                 base::ConstRef(parsed_command_line())));
 
   // Start watching all browser threads for responsiveness.
-  ThreadWatcherList::StartWatchingAll(parsed_command_line());
+  startup_task_runner_->AddTask(
+      "StartThreadWatchers", StartupTaskRunner::CRITICAL,
+      base::Bind(&ThreadWatcherList::StartWatchingAll,
+                 base::ConstRef(parsed_command_line())));
 
 #if !defined(DISABLE_NACL)
-  NaClProcessHost::EarlyStartup();
+  startup_task_runner_->AddTask(
+      "NaClEarlyStartup", StartupTaskRunner::CRITICAL,
+      base::Bind(&NaClProcessHost::EarlyStartup));
 #endif
 
+  startup_task_runner_->RunCriticalTasks();
+
   PreBrowserStart();
 
   // Instantiate the notification UI manager, as this triggers a perf timer
@@ -1844,11 +1962,19 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
       // If we're running tests (ui_task is non-null), then we don't want to
       // call FetchLanguageListFromTranslateServer
       if (parameters().ui_task == NULL && translate_manager_ != NULL) {
-        translate_manager_->FetchLanguageListFromTranslateServer(
-            profile_->GetPrefs());
+        startup_task_runner_->AddTask(
+            "FetchTranslateLanguageList", StartupTaskRunner::DEFERRABLE,
+            base::Bind(&TranslateManager::FetchLanguageListFromTranslateServer,
+                       base::Unretained(translate_manager_),
+                       profile_->GetPrefs()));
       }
 #endif
 
+      // Everything deferrable runs once the first page has painted.
+      startup_task_runner_->StartDeferredTasks(
+          base::TimeDelta::FromMilliseconds(
+              StartupTaskRunner::kDefaultDeferredTimeoutMs));
+
       run_message_loop_ = true;
     } else {
       run_message_loop_ = false;
@@ -1901,6 +2027,9 @@ void ChromeBrowserMainParts::PostMainMessageLoopRun() {
   for (size_t i = 0; i < chrome_extra_parts_.size(); ++i)
     chrome_extra_parts_[i]->PostMainMessageLoopRun();
 
+  memory_pressure_monitor_.reset();
+  startup_task_runner_.reset();
+
 #if defined(OS_WIN)
   // Log the search engine chosen on first run. Do this at shutdown, after any
   // changes are made from the first run bubble link, etc.
@@ -24,9 +24,11 @@ class BrowserProcessImpl;
 class ChromeBrowserMainExtraParts;
 class FieldTrialSynchronizer;
 class HistogramSynchronizer;
+class MemoryPressureMonitor;
 class MetricsService;
 class PrefService;
 class Profile;
+class StartupTaskRunner;
 class StartupTimeBomb;
 class ShutdownWatcherHelper;
 class TranslateManager;
@@ -192,6 +194,9 @@ class ChromeBrowserMainParts : public content::BrowserMainParts {
       tracking_synchronizer_;
   scoped_ptr<ProcessSingleton> process_singleton_;
   scoped_ptr<first_run::MasterPrefs> master_prefs_;
+  scoped_ptr<MemoryPressureMonitor> memory_pressure_monitor_;
+  // Runs the startup steps; deferrable ones wait for the first paint.
+  scoped_ptr<StartupTaskRunner> startup_task_runner_;
   bool record_search_engine_;
   TranslateManager* translate_manager_;
   Profile* profile_;
@@ -0,0 +1,163 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/component_updater/component_patcher.h"
+
+#include <string>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/json/json_file_value_serializer.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_number_conversions.h"
+#include "base/string_util.h"
+#include "base/values.h"
+#include "chrome/browser/component_updater/component_updater_service.h"
+#include "courgette/courgette.h"
+#include "courgette/streams.h"
+#include "courgette/third_party/bsdiff.h"
+#include "crypto/sha2.h"
+
+namespace {
+
+const FilePath::CharType kCommandsFile[] = FILE_PATH_LITERAL("commands.json");
+
+// Reads the relative path stored under |key| in |command| into |path|.
+// Rejects paths that could escape the directory they are resolved against.
+bool GetRelativePath(const base::DictionaryValue* command,
+                     const char* key,
+                     FilePath* path) {
+  std::string value;
+  if (!command->GetString(key, &value) || value.empty())
+    return false;
+  *path = FilePath::FromUTF8Unsafe(value);
+  return !path->IsAbsolute() && !path->ReferencesParent();
+}
+
+// Finds the file |input| of the installed version of the component.
+bool GetInstalledInput(const base::DictionaryValue* command,
+                       ComponentInstaller* installer,
+                       FilePath* installed_file) {
+  FilePath input;
+  if (!GetRelativePath(command, "input", &input))
+    return false;
+  std::string input_string;
+  command->GetString("input", &input_string);
+  return installer->GetInstalledFile(input_string, installed_file) &&
+         file_util::PathExists(*installed_file);
+}
+
+// Applies the bsdiff patch |patch| to |input| and writes the result to
+// |output|.
+bool ApplyBsdiffPatch(const FilePath& input,
+                      const FilePath& patch,
+                      const FilePath& output) {
+  std::string input_data;
+  std::string patch_data;
+  if (!file_util::ReadFileToString(input, &input_data) ||
+      !file_util::ReadFileToString(patch, &patch_data)) {
+    return false;
+  }
+  courgette::SourceStream input_stream;
+  courgette::SourceStream patch_stream;
+  courgette::SinkStream output_stream;
+  input_stream.Init(input_data);
+  patch_stream.Init(patch_data);
+  if (courgette::ApplyBinaryPatch(&input_stream, &patch_stream,
+                                  &output_stream) != courgette::OK) {
+    return false;
+  }
+  int length = static_cast<int>(output_stream.Length());
+  return file_util::WriteFile(
+      output, reinterpret_cast<const char*>(output_stream.Buffer()),
+      length) == length;
+}
+
+// Checks |output| against the hash in the "sha256" key of |command|, if any.
+bool CheckOutputHash(const base::DictionaryValue* command,
+                     const FilePath& output) {
+  std::string expected_hash;
+  if (!command->GetString("sha256", &expected_hash))
+    return true;
+  std::string output_data;
+  if (!file_util::ReadFileToString(output, &output_data))
+    return false;
+  std::string hash = crypto::SHA256HashString(output_data);
+  return base::HexEncode(hash.data(), hash.size()) ==
+         StringToUpperASCII(expected_hash);
+}
+
+// Runs one command of the differential update.
+ComponentUnpacker::Error ApplyCommand(const base::DictionaryValue* command,
+                                      const FilePath& input_dir,
+                                      const FilePath& output_dir,
+                                      ComponentInstaller* installer) {
+  std::string op;
+  FilePath output_path;
+  if (!command->GetString("op", &op) ||
+      !GetRelativePath(command, "output", &output_path)) {
+    return ComponentUnpacker::kDeltaBadCommands;
+  }
+  const FilePath output = output_dir.Append(output_path);
+  if (!file_util::CreateDirectory(output.DirName()))
+    return ComponentUnpacker::kDeltaOperationFailed;
+
+  FilePath patch_path;
+  bool needs_patch = op != "copy";
+  if (needs_patch && !GetRelativePath(command, "patch", &patch_path))
+    return ComponentUnpacker::kDeltaBadCommands;
+  const FilePath patch = input_dir.Append(patch_path);
+
+  FilePath installed_input;
+  bool needs_input = op != "create";
+  if (needs_input && !GetInstalledInput(command, installer, &installed_input))
+    return ComponentUnpacker::kDeltaMissingInput;
+
+  bool ok;
+  if (op == "copy") {
+    ok = file_util::CopyFile(installed_input, output);
+  } else if (op == "create") {
+    ok = file_util::Move(patch, output);
+  } else if (op == "bsdiff") {
+    ok = ApplyBsdiffPatch(installed_input, patch, output);
+  } else if (op == "courgette") {
+    ok = courgette::ApplyEnsemblePatch(installed_input.value().c_str(),
+                                       patch.value().c_str(),
+                                       output.value().c_str()) ==
+         courgette::C_OK;
+  } else {
+    return ComponentUnpacker::kDeltaBadCommands;
+  }
+  if (!ok)
+    return ComponentUnpacker::kDeltaOperationFailed;
+
+  if (!CheckOutputHash(command, output))
+    return ComponentUnpacker::kDeltaHashMismatch;
+  return ComponentUnpacker::kNone;
+}
+
+}  // namespace
+
+ComponentUnpacker::Error ApplyDifferentialUpdate(
+    const FilePath& input_dir,
+    const FilePath& output_dir,
+    ComponentInstaller* installer) {
+  JSONFileValueSerializer serializer(input_dir.Append(kCommandsFile));
+  std::string error;
+  scoped_ptr<base::Value> root(serializer.Deserialize(NULL, &error));
+  if (!root.get() || !root->IsType(base::Value::TYPE_LIST))
+    return ComponentUnpacker::kDeltaBadCommands;
+
+  const base::ListValue* commands = static_cast<base::ListValue*>(root.get());
+  for (size_t i = 0; i < commands->GetSize(); ++i) {
+    base::DictionaryValue* command = NULL;
+    if (!commands->GetDictionary(i, &command))
+      return ComponentUnpacker::kDeltaBadCommands;
+    ComponentUnpacker::Error result =
+        ApplyCommand(command, input_dir, output_dir, installer);
+    if (result != ComponentUnpacker::kNone)
+      return result;
+  }
+  return ComponentUnpacker::kNone;
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_COMPONENT_UPDATER_COMPONENT_PATCHER_H_
+#define CHROME_BROWSER_COMPONENT_UPDATER_COMPONENT_PATCHER_H_
+#pragma once
+
+#include "chrome/browser/component_updater/component_unpacker.h"
+
+class ComponentInstaller;
+class FilePath;
+
+// A differential update is a CRX signed with the component's key, like a
+// full update. Instead of the files of the new version, it holds the
+// file "commands.json": a list of commands, each of which produces one file
+// of the new version at the relative path "output":
+//
+//   {"op": "copy", "output": ..., "input": ...}
+//       Copies the file "input" of the installed version.
+//   {"op": "create", "output": ..., "patch": ...}
+//       Takes the file "patch" of the differential update as is.
+//   {"op": "bsdiff" or "courgette", "output": ..., "input": ...,
+//    "patch": ...}
+//       Applies the bsdiff or courgette patch "patch" of the differential
+//       update to the file "input" of the installed version.
+//
+// Any command may also carry "sha256", the hex SHA256 hash of its output,
+// which is then checked. All paths are relative and can't reference a
+// parent directory.
+//
+// Applies the differential update unpacked in |input_dir| against the
+// version of the component installed by |installer|, and writes the files of
+// the new version to |output_dir|. Runs on the file thread.
+ComponentUnpacker::Error ApplyDifferentialUpdate(
+    const FilePath& input_dir,
+    const FilePath& output_dir,
+    ComponentInstaller* installer);
+
+#endif  // CHROME_BROWSER_COMPONENT_UPDATER_COMPONENT_PATCHER_H_
@@ -7,12 +7,16 @@
 #include <string>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/memory/scoped_handle.h"
 #include "base/string_number_conversions.h"
 #include "base/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/worker_pool.h"
 #include "chrome/browser/extensions/sandboxed_extension_unpacker.h"
+#include "chrome/browser/component_updater/component_patcher.h"
 #include "chrome/browser/component_updater/component_updater_service.h"
 #include "chrome/common/extensions/extension_constants.h"
 #include "chrome/common/zip.h"
@@ -134,28 +138,18 @@ base::DictionaryValue* ReadManifest(const FilePath& unpack_path) {
   return static_cast<base::DictionaryValue*>(root.release());
 }
 
-}  // namespace.
-
-ComponentUnpacker::ComponentUnpacker(const std::vector<uint8>& pk_hash,
-                                     const FilePath& path,
-                                     ComponentInstaller* installer)
-  : error_(kNone) {
-  if (pk_hash.empty() || path.empty()) {
-    error_ = kInvalidParams;
-    return;
-  }
+// Validates the CRX header and signature of the CRX at |path|, and checks
+// that it was signed with the key whose SHA256 hash is |pk_hash|.
+ComponentUnpacker::Error VerifyCRX(const std::vector<uint8>& pk_hash,
+                                   const FilePath& path) {
   // First, validate the CRX header and signature. As of today
   // this is SHA1 with RSA 1024.
   ScopedStdioHandle file(file_util::OpenFile(path, "rb"));
-  if (!file.get()) {
-    error_ = kInvalidFile;
-    return;
-  }
+  if (!file.get())
+    return ComponentUnpacker::kInvalidFile;
   CRXValidator validator(file.get());
-  if (validator.result() != CRXValidator::kValid) {
-    error_ = kInvalidFile;
-    return;
-  }
+  if (validator.result() != CRXValidator::kValid)
+    return ComponentUnpacker::kInvalidFile;
   file.Close();
 
   // File is valid and the digital signature matches. Now make sure
@@ -166,30 +160,88 @@ ComponentUnpacker::ComponentUnpacker(const std::vector<uint8>& pk_hash,
   sha256->Update(&(validator.public_key()[0]), validator.public_key().size());
   sha256->Finish(hash, arraysize(hash));
 
-  if (!std::equal(pk_hash.begin(), pk_hash.end(), hash)) {
-    error_ = kInvalidId;
+  if (!std::equal(pk_hash.begin(), pk_hash.end(), hash))
+    return ComponentUnpacker::kInvalidId;
+  return ComponentUnpacker::kNone;
+}
+
+// Unzips |path| into |unpack_path| and signals |done|. Runs on a worker
+// thread.
+void UnzipAndSignal(const FilePath& path,
+                    const FilePath& unpack_path,
+                    bool* unzipped,
+                    base::WaitableEvent* done) {
+  *unzipped = zip::Unzip(path, unpack_path);
+  done->Signal();
+}
+
+// Creates an empty directory at |path|, deleting whatever was there.
+bool CreateEmptyDirectory(const FilePath& path) {
+  if (file_util::DirectoryExists(path) && !file_util::Delete(path, true))
+    return false;
+  return file_util::CreateDirectory(path);
+}
+
+}  // namespace.
+
+ComponentUnpacker::ComponentUnpacker(const std::vector<uint8>& pk_hash,
+                                     const FilePath& path,
+                                     bool is_delta,
+                                     ComponentInstaller* installer)
+  : error_(kNone) {
+  if (pk_hash.empty() || path.empty()) {
+    error_ = kInvalidParams;
     return;
   }
   // We want the temporary directory to be unique and yet predictable, so
   // we can easily find the package in a end user machine.
-  std::string dir(StringPrintf("CRX_%s", base::HexEncode(hash, 6).c_str()));
+  std::string dir(
+      StringPrintf("CRX_%s", base::HexEncode(&pk_hash[0], 6).c_str()));
   unpack_path_ = path.DirName().AppendASCII(dir.c_str());
-  if (file_util::DirectoryExists(unpack_path_)) {
-    if (!file_util::Delete(unpack_path_, true)) {
-      unpack_path_.clear();
-      error_ = kUzipPathError;
-      return;
-    }
-  }
-  if (!file_util::CreateDirectory(unpack_path_)) {
+  if (!CreateEmptyDirectory(unpack_path_)) {
     unpack_path_.clear();
     error_ = kUzipPathError;
     return;
   }
-  if (!zip::Unzip(path, unpack_path_)) {
+
+  // Verifying the signature and unzipping both read the whole CRX and are
+  // CPU bound, so the unzip runs on a worker thread in the meantime. Nothing
+  // that was unzipped is used unless the CRX turns out to be trusted; the
+  // destructor deletes it otherwise.
+  bool unzipped = false;
+  base::WaitableEvent unzip_done(true, false);
+  if (!base::WorkerPool::PostTask(
+          FROM_HERE,
+          base::Bind(&UnzipAndSignal, path, unpack_path_, &unzipped,
+                     &unzip_done),
+          true /* task is slow */)) {
+    UnzipAndSignal(path, unpack_path_, &unzipped, &unzip_done);
+  }
+  error_ = VerifyCRX(pk_hash, path);
+  unzip_done.Wait();
+  if (error_ != kNone)
+    return;
+  if (!unzipped) {
     error_ = kUnzipFailed;
     return;
   }
+
+  if (is_delta) {
+    // Build the complete new version next to the differential update.
+    const FilePath delta_path = unpack_path_;
+    unpack_path_ = path.DirName().AppendASCII((dir + "_full").c_str());
+    if (!CreateEmptyDirectory(unpack_path_)) {
+      file_util::Delete(delta_path, true);
+      unpack_path_.clear();
+      error_ = kUzipPathError;
+      return;
+    }
+    error_ = ApplyDifferentialUpdate(delta_path, unpack_path_, installer);
+    file_util::Delete(delta_path, true);
+    if (error_ != kNone)
+      return;
+  }
+
   scoped_ptr<base::DictionaryValue> manifest(ReadManifest(unpack_path_));
   if (!manifest.get()) {
     error_ = kBadManifest;
@@ -24,6 +24,7 @@ class ComponentInstaller;
 // - Does not use a sandboxed unpacker. A valid component is fully trusted.
 // - The manifest can have different attributes and resources are not
 //   transcoded.
+// - The CRX can be a differential update, see component_patcher.h.
 class ComponentUnpacker {
  public:
   // Possible error conditions.
@@ -38,11 +39,18 @@ class ComponentUnpacker {
     kBadExtension,
     kInvalidId,
     kInstallerError,
+    kDeltaBadCommands,
+    kDeltaMissingInput,
+    kDeltaOperationFailed,
+    kDeltaHashMismatch,
   };
   // Unpacks, verifies and calls the installer. |pk_hash| is the expected
   // public key SHA256 hash. |path| is the current location of the CRX.
+  // If |is_delta| is true the CRX is a differential update against the
+  // version currently installed by |installer|.
   ComponentUnpacker(const std::vector<uint8>& pk_hash,
                     const FilePath& path,
+                    bool is_delta,
                     ComponentInstaller* installer);
 
   // If something went wrong during unpacking or installer invocation, the
@@ -203,6 +203,15 @@ void ChromeConfigurator::OnEvent(Events event, int val) {
     case kInstallerError:
       UMA_HISTOGRAM_ENUMERATION("ComponentUpdater.InstallError", val, 100);
       break;
+    case kDiffUpdateFailed:
+      UMA_HISTOGRAM_ENUMERATION("ComponentUpdater.DiffUpdateFailed", val, 100);
+      break;
+    case kFullDownloadSize:
+      UMA_HISTOGRAM_COUNTS("ComponentUpdater.FullDownloadKB", val);
+      break;
+    case kDiffDownloadSize:
+      UMA_HISTOGRAM_COUNTS("ComponentUpdater.DiffDownloadKB", val);
+      break;
     default:
       NOTREACHED();
       break;
@@ -188,12 +188,18 @@ struct CrxUpdateItem {
 
   Status status;
   GURL crx_url;
+  // Differential update against the installed version, if the server
+  // offered one.
+  GURL diff_crx_url;
+  // Set when applying |diff_crx_url| failed, so that the full |crx_url| is
+  // used instead.
+  bool diff_update_failed;
   std::string id;
   base::Time last_check;
   CrxComponent component;
   Version next_version;
 
-  CrxUpdateItem() : status(kNew) {}
+  CrxUpdateItem() : status(kNew), diff_update_failed(false) {}
 
   // Function object used to find a specific component.
   class FindById {
@@ -286,7 +292,8 @@ class CrxUpdateService : public ComponentUpdateService {
     ComponentInstaller* installer;
     std::vector<uint8> pk_hash;
     std::string id;
-    CRXContext() : installer(NULL) {}
+    bool is_delta;
+    CRXContext() : installer(NULL), is_delta(false) {}
   };
 
   void OnURLFetchComplete(const content::URLFetcher* source,
@@ -315,6 +322,7 @@ class CrxUpdateService : public ComponentUpdateService {
   void Install(const CRXContext* context, const FilePath& crx_path);
 
   void DoneInstalling(const std::string& component_id,
+                      bool is_delta,
                       ComponentUnpacker::Error error);
 
   size_t ChangeItemStatus(CrxUpdateItem::Status from,
@@ -505,8 +513,12 @@ void CrxUpdateService::ProcessPendingItems() {
     context->pk_hash = item->component.pk_hash;
     context->id = item->id;
     context->installer = item->component.installer;
+    // Prefer the differential update, it is usually a fraction of the size.
+    context->is_delta =
+        item->diff_crx_url.is_valid() && !item->diff_update_failed;
     url_fetcher_.reset(content::URLFetcher::Create(
-        0, item->crx_url, content::URLFetcher::GET,
+        0, context->is_delta ? item->diff_crx_url : item->crx_url,
+        content::URLFetcher::GET,
         MakeContextDelegate(this, context)));
     StartFetch(url_fetcher_.get(), config_->RequestContext(), true);
     return;
@@ -648,6 +660,8 @@ void CrxUpdateService::OnParseUpdateManifestSucceeded(
     // All test passed. Queue an upgrade for this component and fire the
     // notifications.
     crx->crx_url = it->crx_url;
+    crx->diff_crx_url = it->diff_crx_url;
+    crx->diff_update_failed = false;
     crx->status = CrxUpdateItem::kCanUpdate;
     crx->next_version = Version(it->version);
     ++update_pending;
@@ -724,8 +738,14 @@ void CrxUpdateService::Install(const CRXContext* context,
                                const FilePath& crx_path) {
   // This function owns the |crx_path| and the |context| object.
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
-  ComponentUnpacker
-      unpacker(context->pk_hash, crx_path, context->installer);
+  int64 crx_size = 0;
+  if (file_util::GetFileSize(crx_path, &crx_size)) {
+    config_->OnEvent(context->is_delta ? Configurator::kDiffDownloadSize :
+                                         Configurator::kFullDownloadSize,
+                     static_cast<int>(crx_size / 1024));
+  }
+  ComponentUnpacker unpacker(context->pk_hash, crx_path, context->is_delta,
+                             context->installer);
   if (!file_util::Delete(crx_path, false)) {
     NOTREACHED() << crx_path.value();
   }
@@ -734,7 +754,7 @@ void CrxUpdateService::Install(const CRXContext* context,
       BrowserThread::UI,
       FROM_HERE,
       base::Bind(&CrxUpdateService::DoneInstalling, base::Unretained(this),
-                 context->id, unpacker.error()),
+                 context->id, context->is_delta, unpacker.error()),
       base::TimeDelta::FromMilliseconds(config_->StepDelay()));
   delete context;
 }
@@ -742,10 +762,22 @@ void CrxUpdateService::Install(const CRXContext* context,
 // Installation has been completed. Adjust the component status and
 // schedule the next check.
 void CrxUpdateService::DoneInstalling(const std::string& component_id,
+                                      bool is_delta,
                                       ComponentUnpacker::Error error) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
   CrxUpdateItem* item = FindUpdateItemById(component_id);
+  if (is_delta && error != ComponentUnpacker::kNone) {
+    // The differential update did not apply, most likely because the
+    // installed files are not what the server expected. Fall back to the
+    // full CRX right away.
+    config_->OnEvent(Configurator::kDiffUpdateFailed,
+                     CrxIdtoUMAId(component_id));
+    item->diff_update_failed = true;
+    item->status = CrxUpdateItem::kCanUpdate;
+    ScheduleNextRun(true);
+    return;
+  }
   item->status = (error == ComponentUnpacker::kNone) ? CrxUpdateItem::kUpdated :
                                                        CrxUpdateItem::kNoUpdate;
   if (item->status == CrxUpdateItem::kUpdated)
@@ -40,6 +40,13 @@ class ComponentInstaller {
   // with all the unpacked CRX files.
   virtual bool Install(base::DictionaryValue* manifest,
                        const FilePath& unpack_path) = 0;
+
+  // Called by the component updater on the file thread while applying a
+  // differential update. Sets |installed_file| to the location of |file|,
+  // a path relative to the root of the installed version. Returns false if
+  // the installer can't tell, in which case only full updates are used.
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) = 0;
 };
 
 // Describes a particular component that can be installed or updated. This
@@ -87,7 +94,10 @@ class ComponentUpdateService {
       kManifestError,
       kNetworkError,
       kUnpackError,
-      kInstallerError
+      kInstallerError,
+      kDiffUpdateFailed,
+      kFullDownloadSize,
+      kDiffDownloadSize
     };
 
     virtual ~Configurator() {}
@@ -97,6 +97,11 @@ class TestInstaller : public ComponentInstaller {
     return file_util::Delete(unpack_path, true);
   }
 
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) OVERRIDE {
+    return false;
+  }
+
   int error() const { return error_; }
 
   int install_count() const { return install_count_; }
@@ -76,6 +76,9 @@ class NPAPIFlashComponentInstaller : public ComponentInstaller {
   virtual bool Install(base::DictionaryValue* manifest,
                        const FilePath& unpack_path) OVERRIDE;
 
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) OVERRIDE;
+
  private:
   Version current_version_;
 };
@@ -113,6 +116,11 @@ bool NPAPIFlashComponentInstaller::Install(base::DictionaryValue* manifest,
   return true;
 }
 
+bool NPAPIFlashComponentInstaller::GetInstalledFile(
+    const std::string& file, FilePath* installed_file) {
+  return false;
+}
+
 void FinishFlashUpdateRegistration(ComponentUpdateService* cus,
                                    const webkit::WebPluginInfo& info) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -141,6 +141,9 @@ class PnaclComponentInstaller : public ComponentInstaller {
   virtual bool Install(base::DictionaryValue* manifest,
                        const FilePath& unpack_path) OVERRIDE;
 
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) OVERRIDE;
+
  private:
   Version current_version_;
 };
@@ -185,6 +188,16 @@ bool PnaclComponentInstaller::Install(base::DictionaryValue* manifest,
   return true;
 }
 
+bool PnaclComponentInstaller::GetInstalledFile(
+    const std::string& file, FilePath* installed_file) {
+  FilePath path =
+      GetPnaclBaseDirectory().AppendASCII(current_version_.GetString());
+  if (!file_util::DirectoryExists(path))
+    return false;
+  *installed_file = path.AppendASCII(file);
+  return true;
+}
+
 namespace {
 
 // Finally, do the registration with the right version number.
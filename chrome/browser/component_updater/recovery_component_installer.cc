@@ -55,6 +55,9 @@ class RecoveryComponentInstaller : public ComponentInstaller {
   virtual bool Install(base::DictionaryValue* manifest,
                        const FilePath& unpack_path) OVERRIDE;
 
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) OVERRIDE;
+
  private:
   Version current_version_;
   PrefService* prefs_;
@@ -129,6 +132,11 @@ bool RecoveryComponentInstaller::Install(base::DictionaryValue* manifest,
   return base::LaunchProcess(cmdline, base::LaunchOptions(), NULL);
 }
 
+bool RecoveryComponentInstaller::GetInstalledFile(
+    const std::string& file, FilePath* installed_file) {
+  return false;
+}
+
 void RegisterRecoveryComponent(ComponentUpdateService* cus,
                                PrefService* prefs) {
 #if !defined(OS_CHROMEOS)
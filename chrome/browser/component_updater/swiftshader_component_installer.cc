@@ -96,6 +96,9 @@ class SwiftShaderComponentInstaller : public ComponentInstaller {
   virtual bool Install(base::DictionaryValue* manifest,
                        const FilePath& unpack_path) OVERRIDE;
 
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) OVERRIDE;
+
  private:
   Version current_version_;
 };
@@ -139,6 +142,11 @@ bool SwiftShaderComponentInstaller::Install(base::DictionaryValue* manifest,
   return true;
 }
 
+bool SwiftShaderComponentInstaller::GetInstalledFile(
+    const std::string& file, FilePath* installed_file) {
+  return false;
+}
+
 void FinishSwiftShaderUpdateRegistration(ComponentUpdateService* cus,
                                          const Version& version) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -34,6 +34,7 @@
 #include "chrome/common/extensions/extension_error_utils.h"
 #include "chrome/common/extensions/extension_messages.h"
 #include "chrome/common/extensions/url_pattern.h"
+#include "chrome/common/extensions/url_pattern_index.h"
 #include "chrome/common/url_constants.h"
 #include "content/public/browser/browser_message_filter.h"
 #include "content/public/browser/browser_thread.h"
@@ -287,6 +288,14 @@ struct ExtensionWebRequestEventRouter::EventListener {
   EventListener() : extra_info_spec(0) {}
 };
 
+// The listeners for one event in one profile, indexed by their URL filters.
+// IDs in |urls| are positions in |listeners|, which follows the order of the
+// listener set.
+struct ExtensionWebRequestEventRouter::ListenerIndex {
+  URLPatternIndex urls;
+  std::vector<const EventListener*> listeners;
+};
+
 // Contains info about requests that are blocked waiting for a response from
 // an extension.
 struct ExtensionWebRequestEventRouter::BlockedRequest {
@@ -493,6 +502,29 @@ int ExtensionWebRequestEventRouter::OnBeforeRequest(
   std::vector<const EventListener*> listeners =
       GetMatchingListeners(profile, extension_info_map, keys::kOnBeforeRequest,
                            request, &extra_info_spec);
+
+  // Once a declarative rule cancels the request, nothing a blocking listener
+  // answers can change the outcome. Only notify the non-blocking listeners so
+  // that the request doesn't wait for a round trip to extension processes.
+  if (initialize_blocked_requests &&
+      IsCanceledByDeclarativeRules(request->identifier())) {
+    size_t num_skipped = 0;
+    std::vector<const EventListener*> non_blocking_listeners;
+    for (std::vector<const EventListener*>::const_iterator it =
+             listeners.begin(); it != listeners.end(); ++it) {
+      if ((*it)->extra_info_spec &
+          (ExtraInfoSpec::BLOCKING | ExtraInfoSpec::ASYNC_BLOCKING)) {
+        ++num_skipped;
+      } else {
+        non_blocking_listeners.push_back(*it);
+      }
+    }
+    listeners.swap(non_blocking_listeners);
+    UMA_HISTOGRAM_COUNTS_100(
+        "Extensions.DeclarativeWebRequestSkippedBlockingListeners",
+        num_skipped);
+  }
+
   if (!listeners.empty() &&
       !GetAndSetSignaled(request->identifier(), kOnBeforeRequest)) {
     ListValue args;
@@ -919,8 +951,9 @@ bool ExtensionWebRequestEventRouter::DispatchEvent(
   }
 
   if (num_handlers_blocking > 0) {
-    CHECK(blocked_requests_.find(request->identifier()) ==
-          blocked_requests_.end());
+    // Declarative rules may already have stored deltas for this request, but
+    // no other handler may be outstanding.
+    CHECK_EQ(0, blocked_requests_[request->identifier()].num_handlers_blocking);
     blocked_requests_[request->identifier()].request = request;
     blocked_requests_[request->identifier()].num_handlers_blocking =
         num_handlers_blocking;
@@ -976,6 +1009,7 @@ void ExtensionWebRequestEventRouter::AddEventListener(
   CHECK_EQ(listeners_[profile][event_name].count(listener), 0u) <<
       "extension=" << extension_id << " event=" << event_name;
   listeners_[profile][event_name].insert(listener);
+  listener_indices_[profile].erase(event_name);
 }
 
 void ExtensionWebRequestEventRouter::RemoveEventListener(
@@ -1010,6 +1044,7 @@ void ExtensionWebRequestEventRouter::RemoveEventListener(
   }
 
   listeners_[profile][event_name].erase(listener);
+  listener_indices_[profile].erase(event_name);
 
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
                           base::Bind(&ClearCacheOnNavigationOnUI));
@@ -1071,30 +1106,35 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
     int* extra_info_spec,
     std::vector<const ExtensionWebRequestEventRouter::EventListener*>*
         matching_listeners) {
-  std::set<EventListener>& listeners = listeners_[profile][event_name];
-  for (std::set<EventListener>::iterator it = listeners.begin();
-       it != listeners.end(); ++it) {
-    if (!it->ipc_sender.get()) {
+  const ListenerIndex& index = GetListenerIndex(profile, event_name);
+  std::set<URLPatternIndex::ID> url_matches;
+  index.urls.Match(url, &url_matches);
+
+  // IDs follow the order of the listener set, so iterating them in order
+  // keeps the order in which listeners are notified unchanged.
+  for (std::set<URLPatternIndex::ID>::const_iterator id = url_matches.begin();
+       id != url_matches.end(); ++id) {
+    const EventListener* listener = index.listeners[*id];
+    if (!listener->ipc_sender.get()) {
       // The IPC sender has been deleted. This listener will be removed soon
       // via a call to RemoveEventListener. For now, just skip it.
       continue;
     }
 
-    if (!it->filter.urls.is_empty() && !it->filter.urls.MatchesURL(url))
+    const RequestFilter& filter = listener->filter;
+    if (filter.tab_id != -1 && tab_id != filter.tab_id)
       continue;
-    if (it->filter.tab_id != -1 && tab_id != it->filter.tab_id)
+    if (filter.window_id != -1 && window_id != filter.window_id)
       continue;
-    if (it->filter.window_id != -1 && window_id != it->filter.window_id)
-      continue;
-    if (!it->filter.types.empty() &&
-        std::find(it->filter.types.begin(), it->filter.types.end(),
-                  resource_type) == it->filter.types.end())
+    if (!filter.types.empty() &&
+        std::find(filter.types.begin(), filter.types.end(),
+                  resource_type) == filter.types.end())
       continue;
 
     // extension_info_map can be NULL if this is a system-level request.
     if (extension_info_map) {
       const Extension* extension =
-          extension_info_map->extensions().GetByID(it->extension_id);
+          extension_info_map->extensions().GetByID(listener->extension_id);
 
       // Check if this event crosses incognito boundaries when it shouldn't.
       if (!extension ||
@@ -1103,7 +1143,7 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
         continue;
 
       bool blocking_listener =
-          (it->extra_info_spec &
+          (listener->extra_info_spec &
               (ExtraInfoSpec::BLOCKING | ExtraInfoSpec::ASYNC_BLOCKING)) != 0;
 
       // We do not want to notify extensions about XHR requests that are
@@ -1122,9 +1162,27 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
       }
     }
 
-    matching_listeners->push_back(&(*it));
-    *extra_info_spec |= it->extra_info_spec;
+    matching_listeners->push_back(listener);
+    *extra_info_spec |= listener->extra_info_spec;
+  }
+}
+
+const ExtensionWebRequestEventRouter::ListenerIndex&
+ExtensionWebRequestEventRouter::GetListenerIndex(
+    void* profile, const std::string& event_name) {
+  linked_ptr<ListenerIndex>& index = listener_indices_[profile][event_name];
+  if (index.get())
+    return *index;
+
+  index.reset(new ListenerIndex);
+  const std::set<EventListener>& listeners = listeners_[profile][event_name];
+  for (std::set<EventListener>::const_iterator it = listeners.begin();
+       it != listeners.end(); ++it) {
+    index->urls.Add(static_cast<URLPatternIndex::ID>(index->listeners.size()),
+                    it->filter.urls);
+    index->listeners.push_back(&(*it));
   }
+  return *index;
 }
 
 std::vector<const ExtensionWebRequestEventRouter::EventListener*>
@@ -1156,6 +1214,7 @@ ExtensionWebRequestEventRouter::GetMatchingListeners(
   bool is_request_from_extension =
       IsRequestFromExtension(request, extension_info_map);
 
+  base::TimeTicks start = base::TimeTicks::HighResNow();
   GetMatchingListenersImpl(
       profile, extension_info_map, false, event_name, url,
       tab_id, window_id, resource_type, is_request_from_extension,
@@ -1168,6 +1227,8 @@ ExtensionWebRequestEventRouter::GetMatchingListeners(
         tab_id, window_id, resource_type, is_request_from_extension,
         extra_info_spec, &matching_listeners);
   }
+  request_time_tracker_->IncrementListenerMatchingTime(
+      request->identifier(), base::TimeTicks::HighResNow() - start);
 
   return matching_listeners;
 }
@@ -1371,25 +1432,46 @@ bool ExtensionWebRequestEventRouter::ProcessDeclarativeRules(
   if (!rules_registry_.get())
     return false;
 
-  base::Time start = base::Time::Now();
+  base::TimeTicks start = base::TimeTicks::HighResNow();
 
   std::list<linked_ptr<helpers::EventResponseDelta> > result =
       rules_registry_->CreateDeltas(request, request_stage);
 
-  base::TimeDelta elapsed_time = start - base::Time::Now();
+  base::TimeDelta elapsed_time = base::TimeTicks::HighResNow() - start;
   UMA_HISTOGRAM_TIMES("Extensions.DeclarativeWebRequestNetworkDelay",
                       elapsed_time);
+  request_time_tracker_->IncrementListenerMatchingTime(request->identifier(),
+                                                       elapsed_time);
 
   if (result.empty())
     return false;
 
-  helpers::EventResponseDeltas& deltas =
-      blocked_requests_[request->identifier()].response_deltas;
-  CHECK(deltas.empty());
-  deltas.swap(result);
+  BlockedRequest& blocked_request = blocked_requests_[request->identifier()];
+  CHECK(blocked_request.response_deltas.empty());
+  blocked_request.response_deltas.swap(result);
+  // If no listener blocks, the deltas are executed right away. Without this
+  // the time tracker would be charged for the time since the epoch.
+  blocked_request.blocking_time = base::Time::Now();
   return true;
 }
 
+bool ExtensionWebRequestEventRouter::IsCanceledByDeclarativeRules(
+    uint64 request_id) const {
+  BlockedRequestMap::const_iterator blocked_request =
+      blocked_requests_.find(request_id);
+  if (blocked_request == blocked_requests_.end())
+    return false;
+
+  const helpers::EventResponseDeltas& deltas =
+      blocked_request->second.response_deltas;
+  for (helpers::EventResponseDeltas::const_iterator delta = deltas.begin();
+       delta != deltas.end(); ++delta) {
+    if ((*delta)->cancel)
+      return true;
+  }
+  return false;
+}
+
 bool ExtensionWebRequestEventRouter::GetAndSetSignaled(uint64 request_id,
                                                        EventTypes event_type) {
   SignaledRequestMap::iterator iter = signaled_requests_.find(request_id);
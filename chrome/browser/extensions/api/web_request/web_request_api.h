@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/linked_ptr.h"
 #include "base/memory/singleton.h"
 #include "base/time.h"
 #include "chrome/browser/extensions/api/declarative_webrequest/request_stages.h"
@@ -260,8 +261,12 @@ class ExtensionWebRequestEventRouter {
   friend struct DefaultSingletonTraits<ExtensionWebRequestEventRouter>;
 
   struct EventListener;
+  struct ListenerIndex;
   typedef std::map<std::string, std::set<EventListener> > ListenerMapForProfile;
   typedef std::map<void*, ListenerMapForProfile> ListenerMap;
+  typedef std::map<std::string, linked_ptr<ListenerIndex> >
+      ListenerIndexMapForProfile;
+  typedef std::map<void*, ListenerIndexMapForProfile> ListenerIndexMap;
   typedef std::map<uint64, BlockedRequest> BlockedRequestMap;
   // Map of request_id -> bit vector of EventTypes already signaled
   typedef std::map<uint64, int> SignaledRequestMap;
@@ -308,6 +313,11 @@ class ExtensionWebRequestEventRouter {
       std::vector<const ExtensionWebRequestEventRouter::EventListener*>*
           matching_listeners);
 
+  // Returns the URL index over the listeners for |event_name| in |profile|,
+  // building it if the listeners changed since it was last used.
+  const ListenerIndex& GetListenerIndex(void* profile,
+                                        const std::string& event_name);
+
   // Decrements the count of event handlers blocking the given request. When the
   // count reaches 0, we stop blocking the request and proceed it using the
   // method requested by the extension with the highest precedence. Precedence
@@ -335,6 +345,10 @@ class ExtensionWebRequestEventRouter {
   bool ProcessDeclarativeRules(net::URLRequest* request,
                                extensions::RequestStages request_stage);
 
+  // Returns whether the deltas stored by ProcessDeclarativeRules() for
+  // |request_id| cancel the request.
+  bool IsCanceledByDeclarativeRules(uint64 request_id) const;
+
   // Sets the flag that |event_type| has been signaled for |request_id|.
   // Returns the value of the flag before setting it.
   bool GetAndSetSignaled(uint64 request_id, EventTypes event_type);
@@ -352,6 +366,10 @@ class ExtensionWebRequestEventRouter {
   // are listening to that event.
   ListenerMap listeners_;
 
+  // Indexes of |listeners_| by URL pattern. An entry is dropped whenever the
+  // listeners it covers change and is rebuilt on the next lookup.
+  ListenerIndexMap listener_indices_;
+
   // A map of network requests that are waiting for at least one event handler
   // to respond.
   BlockedRequestMap blocked_requests_;
@@ -145,6 +145,12 @@ void ExtensionWebRequestTimeTracker::LogRequestEndTime(
   log.request_duration = end_time - log.request_start_time;
   log.completed = true;
 
+  // Matching usually takes microseconds, below the resolution of
+  // UMA_HISTOGRAM_TIMES.
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Extensions.WebRequestListenerMatchingTime",
+                              log.matching_duration.InMicroseconds(),
+                              1, 100000, 50);
+
   if (log.extension_block_durations.empty())
     return;
 
@@ -230,6 +236,15 @@ void ExtensionWebRequestTimeTracker::IncrementTotalBlockTime(
   log.block_duration += block_time;
 }
 
+void ExtensionWebRequestTimeTracker::IncrementListenerMatchingTime(
+    int64 request_id,
+    const base::TimeDelta& matching_time) {
+  if (request_time_logs_.find(request_id) == request_time_logs_.end())
+    return;
+  RequestTimeLog& log = request_time_logs_[request_id];
+  log.matching_duration += matching_time;
+}
+
 void ExtensionWebRequestTimeTracker::SetRequestCanceled(int64 request_id) {
   // Canceled requests won't actually hit the network, so we can't compare
   // their request time to the time spent waiting on the extension. Just ignore
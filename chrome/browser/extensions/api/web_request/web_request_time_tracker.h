@@ -68,6 +68,12 @@ class ExtensionWebRequestTimeTracker {
       int64 request_id,
       const base::TimeDelta& block_time);
 
+  // Records time spent deciding which webRequest listeners the given request
+  // should be dispatched to and evaluating declarative rules against it.
+  void IncrementListenerMatchingTime(
+      int64 request_id,
+      const base::TimeDelta& matching_time);
+
   // Called when an extension has canceled the given request.
   void SetRequestCanceled(int64 request_id);
 
@@ -86,6 +92,7 @@ class ExtensionWebRequestTimeTracker {
     base::Time request_start_time;
     base::TimeDelta request_duration;
     base::TimeDelta block_duration;
+    base::TimeDelta matching_duration;
     std::map<std::string, base::TimeDelta> extension_block_durations;
     RequestTimeLog();
     ~RequestTimeLog();
@@ -6,6 +6,7 @@
 #include "base/command_line.h"
 #include "base/lazy_instance.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/string_number_conversions.h"
 #include "base/time.h"
 #include "chrome/browser/extensions/extension_event_router.h"
@@ -16,6 +17,7 @@
 #include "chrome/browser/extensions/extension_system.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_list.h"
 #include "chrome/browser/ui/browser_window.h"
 #include "chrome/common/chrome_notification_types.h"
 #include "chrome/common/chrome_switches.h"
@@ -133,6 +135,11 @@ ExtensionProcessManager::ExtensionProcessManager(Profile* profile)
   Profile* original_profile = profile->GetOriginalProfile();
   registrar_.Add(this, chrome::NOTIFICATION_EXTENSIONS_READY,
                  content::Source<Profile>(original_profile));
+  // IncognitoExtensionProcessManager watches for its own windows.
+  if (!profile->IsOffTheRecord()) {
+    registrar_.Add(this, chrome::NOTIFICATION_BROWSER_WINDOW_READY,
+                   content::NotificationService::AllSources());
+  }
   registrar_.Add(this, chrome::NOTIFICATION_EXTENSION_LOADED,
                  content::Source<Profile>(original_profile));
   registrar_.Add(this, chrome::NOTIFICATION_EXTENSION_UNLOADED,
@@ -288,6 +295,17 @@ void ExtensionProcessManager::CreateBackgroundHost(
   OnExtensionHostCreated(host, true);
 }
 
+bool ExtensionProcessManager::ShouldDeferStartupBackgroundHosts() {
+  // Incognito background pages already wait for an incognito window.
+  if (GetProfile()->IsOffTheRecord())
+    return false;
+  // Without a window to show there is nothing to wait for, and apps with the
+  // background permission are the reason Chrome was started.
+  if (CommandLine::ForCurrentProcess()->HasSwitch(switches::kNoStartupWindow))
+    return false;
+  return !BrowserList::FindAnyBrowser(GetProfile(), true);
+}
+
 void ExtensionProcessManager::OpenOptionsPage(const Extension* extension,
                                               Browser* browser) {
   DCHECK(!extension->options_url().is_empty());
@@ -516,12 +534,35 @@ void ExtensionProcessManager::Observe(
     const content::NotificationDetails& details) {
   switch (type) {
     case chrome::NOTIFICATION_EXTENSIONS_READY: {
+      if (ShouldDeferStartupBackgroundHosts()) {
+        startup_background_hosts_deferred_time_ = base::TimeTicks::Now();
+        break;
+      }
       CreateBackgroundHostsForProfileStartup(this,
           content::Source<Profile>(source).ptr()->
               GetExtensionService()->extensions());
       break;
     }
 
+    case chrome::NOTIFICATION_BROWSER_WINDOW_READY: {
+      // The first window of this profile has been shown; start the background
+      // pages that were held back at startup.
+      if (startup_background_hosts_deferred_time_.is_null())
+        break;
+      Browser* browser = content::Source<Browser>(source).ptr();
+      if (browser->profile()->GetOriginalProfile() != GetProfile())
+        break;
+      ExtensionService* service = GetProfile()->GetExtensionService();
+      if (!service)
+        break;
+      UMA_HISTOGRAM_TIMES(
+          "Extensions.BackgroundHostsDeferredTime",
+          base::TimeTicks::Now() - startup_background_hosts_deferred_time_);
+      startup_background_hosts_deferred_time_ = base::TimeTicks();
+      CreateBackgroundHostsForProfileStartup(this, service->extensions());
+      break;
+    }
+
     case chrome::NOTIFICATION_EXTENSION_LOADED: {
       ExtensionService* service =
           content::Source<Profile>(source).ptr()->GetExtensionService();
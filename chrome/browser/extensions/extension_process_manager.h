@@ -197,6 +197,11 @@ class ExtensionProcessManager : public content::NotificationObserver {
   // Clears background page data for this extension.
   void ClearBackgroundPageData(const std::string& extension_id);
 
+  // Returns true if background pages loaded at startup should wait for the
+  // profile's first browser window, so that they don't compete with it for
+  // the UI thread and the disk.
+  bool ShouldDeferStartupBackgroundHosts();
+
   BackgroundPageDataMap background_page_data_;
 
   // The time to delay between an extension becoming idle and
@@ -207,6 +212,10 @@ class ExtensionProcessManager : public content::NotificationObserver {
   // sending a Unload message; read from command-line switch.
   base::TimeDelta event_page_unloading_time_;
 
+  // When the creation of startup background hosts was deferred, or null if
+  // it wasn't or they have since been created.
+  base::TimeTicks startup_background_hosts_deferred_time_;
+
   base::WeakPtrFactory<ExtensionProcessManager> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(ExtensionProcessManager);
@@ -116,6 +116,7 @@ void InstalledLoader::LoadAllExtensions() {
 
   std::vector<int> reload_reason_counts(NUM_MANIFEST_RELOAD_REASONS, 0);
   bool should_write_prefs = false;
+  base::TimeDelta reload_time;
 
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     ExtensionInfo* info = extensions_info->at(i).get();
@@ -133,6 +134,7 @@ void InstalledLoader::LoadAllExtensions() {
       // |allow_io| disables tests that file operations run on the file
       // thread.
       base::ThreadRestrictions::ScopedAllowIO allow_io;
+      base::TimeTicks reload_start_time = base::TimeTicks::Now();
 
       std::string error;
       scoped_refptr<const Extension> extension(
@@ -141,6 +143,7 @@ void InstalledLoader::LoadAllExtensions() {
               info->extension_location,
               GetCreationFlags(info),
               &error));
+      reload_time += base::TimeTicks::Now() - reload_start_time;
 
       if (!extension.get()) {
         extension_service_->
@@ -155,9 +158,12 @@ void InstalledLoader::LoadAllExtensions() {
     }
   }
 
+  base::TimeTicks create_start_time = base::TimeTicks::Now();
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     Load(*extensions_info->at(i), should_write_prefs);
   }
+  UMA_HISTOGRAM_TIMES("Extensions.LoadAllCreateTime",
+                      base::TimeTicks::Now() - create_start_time);
 
   extension_service_->OnLoadedInstalledExtensions();
 
@@ -169,6 +175,7 @@ void InstalledLoader::LoadAllExtensions() {
                            reload_reason_counts[UNPACKED_DIR]);
   UMA_HISTOGRAM_COUNTS_100("Extensions.ManifestReloadNeedsRelocalization",
                            reload_reason_counts[NEEDS_RELOCALIZATION]);
+  UMA_HISTOGRAM_TIMES("Extensions.ManifestReloadTime", reload_time);
 
   UMA_HISTOGRAM_COUNTS_100("Extensions.LoadAll",
                            extension_service_->extensions()->size());
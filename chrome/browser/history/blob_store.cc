@@ -0,0 +1,135 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/blob_store.h"
+
+#include "base/compiler_specific.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/sha1.h"
+#include "base/string_number_conversions.h"
+#include "base/string_util.h"
+#include "base/threading/thread_restrictions.h"
+
+namespace history {
+
+namespace {
+
+// RefCountedMemory backed by a read-only mapping of a blob file. The file
+// stays mapped for as long as anyone holds a reference, so thumbnails can be
+// handed to the UI without copying them into the heap.
+class RefCountedMappedFile : public base::RefCountedMemory {
+ public:
+  explicit RefCountedMappedFile(file_util::MemoryMappedFile* file)
+      : file_(file) {
+  }
+
+  // Overridden from base::RefCountedMemory:
+  virtual const unsigned char* front() const OVERRIDE {
+    return file_->data();
+  }
+
+  virtual size_t size() const OVERRIDE {
+    return file_->length();
+  }
+
+ private:
+  virtual ~RefCountedMappedFile() {
+    // The last reference is often dropped on the UI thread. Unmapping and
+    // closing an open descriptor doesn't wait on the disk.
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    file_.reset();
+  }
+
+  scoped_ptr<file_util::MemoryMappedFile> file_;
+
+  DISALLOW_COPY_AND_ASSIGN(RefCountedMappedFile);
+};
+
+}  // namespace
+
+BlobStore::BlobStore(const FilePath& directory) : directory_(directory) {
+}
+
+BlobStore::~BlobStore() {
+}
+
+bool BlobStore::Init() {
+  return file_util::CreateDirectory(directory_);
+}
+
+std::string BlobStore::Put(const base::RefCountedMemory* data) {
+  if (!data || !data->size())
+    return std::string();
+
+  unsigned char hash[base::kSHA1Length];
+  base::SHA1HashBytes(data->front(), data->size(), hash);
+  std::string key = StringToLowerASCII(base::HexEncode(hash, sizeof(hash)));
+
+  FilePath path = GetPath(key);
+  if (file_util::PathExists(path))
+    return key;
+
+  // Write to a temporary file and rename it so that a crash never leaves a
+  // truncated file under a valid key.
+  FilePath temp_path;
+  if (!file_util::CreateTemporaryFileInDir(directory_, &temp_path))
+    return std::string();
+  int size = static_cast<int>(data->size());
+  if (file_util::WriteFile(temp_path,
+                           reinterpret_cast<const char*>(data->front()),
+                           size) != size ||
+      !file_util::ReplaceFile(temp_path, path)) {
+    file_util::Delete(temp_path, false);
+    return std::string();
+  }
+  return key;
+}
+
+scoped_refptr<base::RefCountedMemory> BlobStore::Get(
+    const std::string& key) const {
+  if (!IsValidKey(key))
+    return NULL;
+
+  scoped_ptr<file_util::MemoryMappedFile> file(
+      new file_util::MemoryMappedFile);
+  if (!file->Initialize(GetPath(key)))
+    return NULL;
+  return new RefCountedMappedFile(file.release());
+}
+
+void BlobStore::Delete(const std::string& key) {
+  if (IsValidKey(key))
+    file_util::Delete(GetPath(key), false);
+}
+
+void BlobStore::DeleteAllExcept(const std::set<std::string>& live_keys) {
+  file_util::FileEnumerator enumerator(directory_, false,
+                                       file_util::FileEnumerator::FILES);
+  for (FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (live_keys.count(path.BaseName().MaybeAsASCII()) == 0)
+      file_util::Delete(path, false);
+  }
+}
+
+// static
+bool BlobStore::IsValidKey(const std::string& key) {
+  if (key.size() != base::kSHA1Length * 2)
+    return false;
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (!IsAsciiDigit(key[i]) && (key[i] < 'a' || key[i] > 'f'))
+      return false;
+  }
+  return true;
+}
+
+FilePath BlobStore::GetPath(const std::string& key) const {
+  DCHECK(IsValidKey(key));
+  return directory_.AppendASCII(key);
+}
+
+}  // namespace history
@@ -0,0 +1,69 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_HISTORY_BLOB_STORE_H_
+#define CHROME_BROWSER_HISTORY_BLOB_STORE_H_
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/file_path.h"
+#include "base/memory/ref_counted.h"
+
+namespace base {
+class RefCountedMemory;
+}
+
+namespace history {
+
+// A content-addressed store for image data that would otherwise live as
+// blobs inside a history database. Each blob is a file in |directory| named
+// after the SHA-1 of its contents, so identical images are stored once and a
+// database row only needs to keep the key. Reads map the file rather than
+// copying it.
+//
+// The store keeps no index of its own; the owning database is the source of
+// truth for which keys are referenced. All methods do file I/O and must be
+// called on the owning database's thread.
+class BlobStore {
+ public:
+  explicit BlobStore(const FilePath& directory);
+  ~BlobStore();
+
+  // Creates the directory if needed. Returns false if it can't be created, in
+  // which case no other methods should be called.
+  bool Init();
+
+  // Stores |data| and returns its key, or an empty string on failure. Storing
+  // contents that are already present is cheap and returns the same key.
+  std::string Put(const base::RefCountedMemory* data);
+
+  // Returns the blob for |key|, or NULL if there is none. The returned memory
+  // is a read-only mapping of the file.
+  scoped_refptr<base::RefCountedMemory> Get(const std::string& key) const;
+
+  // Removes the blob for |key|. Callers must make sure no row still refers to
+  // it, since keys are shared between identical blobs.
+  void Delete(const std::string& key);
+
+  // Removes every blob whose key is not in |live_keys|. Used at startup to
+  // drop files written before a crash but never committed to the database.
+  void DeleteAllExcept(const std::set<std::string>& live_keys);
+
+  // Returns true if |key| has the form of a key returned by Put().
+  static bool IsValidKey(const std::string& key);
+
+ private:
+  FilePath GetPath(const std::string& key) const;
+
+  const FilePath directory_;
+
+  DISALLOW_COPY_AND_ASSIGN(BlobStore);
+};
+
+}  // namespace history
+
+#endif  // CHROME_BROWSER_HISTORY_BLOB_STORE_H_
@@ -0,0 +1,90 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <set>
+#include <string>
+
+#include "base/file_util.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/scoped_temp_dir.h"
+#include "chrome/browser/history/blob_store.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace history {
+
+namespace {
+
+scoped_refptr<base::RefCountedMemory> MakeBlob(const char* data) {
+  return new base::RefCountedStaticMemory(
+      reinterpret_cast<const unsigned char*>(data), strlen(data));
+}
+
+}  // namespace
+
+class BlobStoreTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    directory_ = temp_dir_.path().AppendASCII("Blobs");
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath directory_;
+};
+
+TEST_F(BlobStoreTest, PutAndGet) {
+  BlobStore store(directory_);
+  ASSERT_TRUE(store.Init());
+
+  std::string key = store.Put(MakeBlob("thumbnail"));
+  ASSERT_TRUE(BlobStore::IsValidKey(key));
+
+  // Identical contents map to the same key.
+  EXPECT_EQ(key, store.Put(MakeBlob("thumbnail")));
+  EXPECT_NE(key, store.Put(MakeBlob("favicon")));
+
+  scoped_refptr<base::RefCountedMemory> blob = store.Get(key);
+  ASSERT_TRUE(blob.get());
+  EXPECT_EQ("thumbnail",
+            std::string(reinterpret_cast<const char*>(blob->front()),
+                        blob->size()));
+  blob = NULL;
+
+  store.Delete(key);
+  EXPECT_FALSE(store.Get(key).get());
+
+  // Empty data isn't stored.
+  EXPECT_TRUE(store.Put(MakeBlob("")).empty());
+}
+
+TEST_F(BlobStoreTest, RejectsMalformedKeys) {
+  BlobStore store(directory_);
+  ASSERT_TRUE(store.Init());
+
+  EXPECT_FALSE(BlobStore::IsValidKey(""));
+  EXPECT_FALSE(BlobStore::IsValidKey("../../../../../../../../etc/passwd"));
+  EXPECT_FALSE(BlobStore::IsValidKey(std::string(40, 'A')));
+  EXPECT_TRUE(BlobStore::IsValidKey(std::string(40, 'a')));
+  EXPECT_FALSE(store.Get("..").get());
+}
+
+TEST_F(BlobStoreTest, DeleteAllExcept) {
+  BlobStore store(directory_);
+  ASSERT_TRUE(store.Init());
+
+  std::string live = store.Put(MakeBlob("live"));
+  std::string dead = store.Put(MakeBlob("dead"));
+  // A leftover temporary file is collected as well.
+  ASSERT_EQ(1, file_util::WriteFile(directory_.AppendASCII("tmp"), "x", 1));
+
+  std::set<std::string> live_keys;
+  live_keys.insert(live);
+  store.DeleteAllExcept(live_keys);
+
+  EXPECT_TRUE(store.Get(live).get());
+  EXPECT_FALSE(store.Get(dead).get());
+  EXPECT_FALSE(file_util::PathExists(directory_.AppendASCII("tmp")));
+}
+
+}  // namespace history
@@ -85,6 +85,17 @@ sql::InitStatus HistoryDatabase::Init(const FilePath& history_name,
   // TODO(brettw) scale this value to the amount of available memory.
   db_.set_cache_size(6000);
 
+  // Commit through a write-ahead log. Visits are committed in batches on a
+  // timer, and with a rollback journal each batch rewrites every touched page
+  // twice and blocks readers of the file (such as the in-memory backend while
+  // it attaches) for the duration of the commit.
+  db_.set_write_ahead_logging();
+  db_.set_histogram_tag("History");
+
+  // Keep the temporary b-trees built for ORDER BY and DISTINCT queries out
+  // of the file system.
+  db_.set_temp_store_in_memory();
+
   // Note that we don't set exclusive locking here. That's done by
   // BeginExclusiveMode below which is called later (we have to be in shared
   // mode to start out for the in-memory backend to read the data).
@@ -656,7 +656,7 @@ struct Images {
   Images();
   ~Images();
 
-  scoped_refptr<base::RefCountedBytes> thumbnail;
+  scoped_refptr<base::RefCountedMemory> thumbnail;
   ThumbnailScore thumbnail_score;
 
   // TODO(brettw): this will eventually store the favicon.
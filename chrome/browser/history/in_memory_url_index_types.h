@@ -6,6 +6,8 @@
 #define CHROME_BROWSER_HISTORY_IN_MEMORY_URL_INDEX_TYPES_H_
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <map>
 #include <set>
 #include <vector>
@@ -149,6 +151,33 @@ typedef std::vector<HistoryID> HistoryIDVector;
 typedef std::map<WordID, HistoryIDSet> WordIDHistoryMap;
 typedef std::map<HistoryID, WordIDSet> HistoryIDWordMap;
 
+// Returns the items common to |set1| and |set2|. When one set is much smaller
+// than the other, which is typical when a rare word is intersected with a
+// common one, each item of the smaller set is looked up in the larger one
+// instead of walking both sets in step. This makes the cost proportional to
+// the smaller set rather than to the sum of both.
+template <typename T>
+std::set<T> IntersectSets(const std::set<T>& set1, const std::set<T>& set2) {
+  // Above this size ratio lookups beat a linear merge.
+  const size_t kLookupSizeRatio = 16;
+  const bool first_is_smaller = set1.size() <= set2.size();
+  const std::set<T>& smaller(first_is_smaller ? set1 : set2);
+  const std::set<T>& larger(first_is_smaller ? set2 : set1);
+  std::set<T> result;
+  if (smaller.size() * kLookupSizeRatio < larger.size()) {
+    for (typename std::set<T>::const_iterator iter = smaller.begin();
+         iter != smaller.end(); ++iter) {
+      if (larger.find(*iter) != larger.end())
+        result.insert(result.end(), *iter);
+    }
+  } else {
+    std::set_intersection(smaller.begin(), smaller.end(),
+                          larger.begin(), larger.end(),
+                          std::inserter(result, result.end()));
+  }
+  return result;
+}
+
 // A map from history_id to the history's URL and title.
 typedef std::map<HistoryID, URLRow> HistoryInfoMap;
 
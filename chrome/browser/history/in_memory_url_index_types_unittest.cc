@@ -120,6 +120,35 @@ TEST_F(InMemoryURLIndexTypesTest, StaticFunctions) {
     EXPECT_EQ(expected_offsets[i], matches_g[i].offset);
 }
 
+TEST_F(InMemoryURLIndexTypesTest, IntersectSets) {
+  std::set<int> small_set;
+  std::set<int> large_set;
+  for (int i = 0; i < 1000; ++i)
+    large_set.insert(i * 2);
+  EXPECT_TRUE(IntersectSets(small_set, large_set).empty());
+
+  // Exercise the lookup path, in both argument orders.
+  small_set.insert(3);
+  small_set.insert(4);
+  small_set.insert(1998);
+  small_set.insert(5000);
+  std::set<int> expected;
+  expected.insert(4);
+  expected.insert(1998);
+  EXPECT_TRUE(expected == IntersectSets(small_set, large_set));
+  EXPECT_TRUE(expected == IntersectSets(large_set, small_set));
+
+  // Exercise the merge path with sets of similar size.
+  std::set<int> odd_set;
+  for (int i = 0; i < 1000; ++i)
+    odd_set.insert(i * 3);
+  std::set<int> merged(IntersectSets(odd_set, large_set));
+  EXPECT_EQ(334u, merged.size());
+  for (std::set<int>::const_iterator iter = merged.begin();
+       iter != merged.end(); ++iter)
+    EXPECT_EQ(0, *iter % 6);
+}
+
 TEST_F(InMemoryURLIndexTypesTest, OffsetsAndTermMatches) {
   // Test OffsetsFromTermMatches
   history::TermMatches matches_a;
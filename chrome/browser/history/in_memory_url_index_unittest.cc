@@ -1038,6 +1038,32 @@ TEST_F(InMemoryURLIndexTest, CacheSaveRestore) {
   }
 }
 
+TEST_F(InMemoryURLIndexTest, RestoreVersion1Cache) {
+  URLIndexPrivateData& private_data(*GetPrivateData());
+
+  // Caches written before the posting lists were delta encoded must still
+  // restore to the same data as current ones.
+  private_data.saved_cache_version_ = 1;
+  imui::InMemoryURLIndexCacheItem version_1_cache;
+  private_data.SavePrivateData(&version_1_cache);
+  private_data.saved_cache_version_ = kCurrentCacheFileVersion;
+  imui::InMemoryURLIndexCacheItem current_cache;
+  private_data.SavePrivateData(&current_cache);
+  EXPECT_LE(current_cache.ByteSize(), version_1_cache.ByteSize());
+
+  scoped_refptr<URLIndexPrivateData> version_1_data(new URLIndexPrivateData);
+  EXPECT_TRUE(version_1_data->RestorePrivateData(version_1_cache,
+                                                 "en,ja,hi,zh"));
+  EXPECT_EQ(1, version_1_data->restored_cache_version_);
+  ExpectPrivateDataEqual(private_data, *version_1_data);
+
+  scoped_refptr<URLIndexPrivateData> current_data(new URLIndexPrivateData);
+  EXPECT_TRUE(current_data->RestorePrivateData(current_cache,
+                                               "en,ja,hi,zh"));
+  EXPECT_EQ(kCurrentCacheFileVersion, current_data->restored_cache_version_);
+  ExpectPrivateDataEqual(private_data, *current_data);
+}
+
 class InMemoryURLIndexCacheTest : public testing::Test {
  public:
   InMemoryURLIndexCacheTest() {}
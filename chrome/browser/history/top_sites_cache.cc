@@ -34,7 +34,7 @@ bool TopSitesCache::GetPageThumbnail(
   std::map<GURL, Images>::const_iterator found =
       images_.find(GetCanonicalURL(url));
   if (found != images_.end()) {
-    base::RefCountedBytes* data = found->second.thumbnail.get();
+    base::RefCountedMemory* data = found->second.thumbnail.get();
     if (data) {
       *bytes = data;
       return true;
@@ -2,11 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <set>
+
 #include "base/file_util.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/string_split.h"
 #include "base/string_util.h"
 #include "chrome/browser/diagnostics/sqlite_diagnostics.h"
+#include "chrome/browser/history/blob_store.h"
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/history/top_sites.h"
 #include "chrome/browser/history/top_sites_database.h"
@@ -17,7 +21,14 @@ namespace history {
 
 // From the version 1 to 2, one column was added. Old versions of Chrome
 // should be able to read version 2 files just fine.
-static const int kVersionNumber = 2;
+// Version 3 moved the images out of the thumbnail column and into a BlobStore,
+// which earlier versions don't know to look in.
+static const int kVersionNumber = 3;
+static const int kCompatibleVersionNumber = 3;
+
+// Appended to the database file name to name the directory holding images.
+static const FilePath::CharType kBlobDirectorySuffix[] =
+    FILE_PATH_LITERAL(" Thumbnails");
 
 TopSitesDatabase::TopSitesDatabase() : may_need_history_migration_(false) {
 }
@@ -54,14 +65,24 @@ bool TopSitesDatabase::Init(const FilePath& db_name) {
       return false;
   }
 
+  blobs_.reset(
+      new BlobStore(FilePath(db_name.value() + kBlobDirectorySuffix)));
+  if (!blobs_->Init())
+    return false;
+
   // Scope initialization in a transaction so we can't be partially
   // initialized.
   sql::Transaction transaction(db_.get());
   transaction.Begin();
 
-  if (!meta_table_.Init(db_.get(), kVersionNumber, kVersionNumber))
+  if (!meta_table_.Init(db_.get(), kVersionNumber, kCompatibleVersionNumber))
     return false;
 
+  if (meta_table_.GetCompatibleVersionNumber() > kVersionNumber) {
+    LOG(WARNING) << "Top sites database is too new.";
+    return false;
+  }
+
   if (!InitThumbnailTable())
     return false;
 
@@ -72,6 +93,15 @@ bool TopSitesDatabase::Init(const FilePath& db_name) {
     }
   }
 
+  bool moved_images = false;
+  if (meta_table_.GetVersionNumber() == 2) {
+    if (!UpgradeToVersion3()) {
+      LOG(WARNING) << "Unable to upgrade top sites database to version 3.";
+      return false;
+    }
+    moved_images = true;
+  }
+
   // Version check.
   if (meta_table_.GetVersionNumber() != kVersionNumber)
     return false;
@@ -80,6 +110,12 @@ bool TopSitesDatabase::Init(const FilePath& db_name) {
   if (!transaction.Commit())
     return false;
 
+  // The images left behind a lot of free pages; give them back. This can't
+  // run inside a transaction.
+  if (moved_images)
+    ignore_result(db_->Execute("VACUUM"));
+
+  DeleteUnreferencedThumbnails();
   return true;
 }
 
@@ -95,7 +131,8 @@ bool TopSitesDatabase::InitThumbnailTable() {
                       "good_clipping INTEGER DEFAULT 0, "
                       "at_top INTEGER DEFAULT 0, "
                       "last_updated INTEGER DEFAULT 0, "
-                      "load_completed INTEGER DEFAULT 0) ")) {
+                      "load_completed INTEGER DEFAULT 0, "
+                      "thumbnail_key LONGVARCHAR) ")) {
       LOG(WARNING) << db_->GetErrorMessage();
       return false;
     }
@@ -114,11 +151,54 @@ bool TopSitesDatabase::UpgradeToVersion2() {
   return true;
 }
 
+bool TopSitesDatabase::UpgradeToVersion3() {
+  if (!db_->Execute("ALTER TABLE thumbnails ADD thumbnail_key LONGVARCHAR")) {
+    NOTREACHED();
+    return false;
+  }
+
+  std::vector<std::pair<std::string, std::string> > keys;
+  {
+    sql::Statement statement(db_->GetUniqueStatement(
+        "SELECT url, thumbnail FROM thumbnails WHERE thumbnail IS NOT NULL"));
+    while (statement.Step()) {
+      std::vector<unsigned char> data;
+      statement.ColumnBlobAsVector(1, &data);
+      if (data.empty())
+        continue;
+      scoped_refptr<base::RefCountedBytes> bytes(
+          base::RefCountedBytes::TakeVector(&data));
+      std::string key = blobs_->Put(bytes);
+      if (key.empty())
+        return false;
+      keys.push_back(std::make_pair(statement.ColumnString(0), key));
+    }
+    if (!statement.Succeeded())
+      return false;
+  }
+
+  sql::Statement update(db_->GetUniqueStatement(
+      "UPDATE thumbnails SET thumbnail_key = ? WHERE url = ?"));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    update.Reset(true);
+    update.BindString(0, keys[i].second);
+    update.BindString(1, keys[i].first);
+    if (!update.Run())
+      return false;
+  }
+  if (!db_->Execute("UPDATE thumbnails SET thumbnail = NULL"))
+    return false;
+
+  meta_table_.SetVersionNumber(3);
+  meta_table_.SetCompatibleVersionNumber(3);
+  return true;
+}
+
 void TopSitesDatabase::GetPageThumbnails(MostVisitedURLList* urls,
                                          URLToImagesMap* thumbnails) {
   sql::Statement statement(db_->GetCachedStatement(
       SQL_FROM_HERE,
-      "SELECT url, url_rank, title, thumbnail, redirects, "
+      "SELECT url, url_rank, title, thumbnail_key, redirects, "
       "boring_score, good_clipping, at_top, last_updated, load_completed "
       "FROM thumbnails ORDER BY url_rank "));
 
@@ -140,11 +220,10 @@ void TopSitesDatabase::GetPageThumbnails(MostVisitedURLList* urls,
     SetRedirects(redirects, &url);
     urls->push_back(url);
 
-    std::vector<unsigned char> data;
-    statement.ColumnBlobAsVector(3, &data);
     Images thumbnail;
-    if (!data.empty())
-      thumbnail.thumbnail = base::RefCountedBytes::TakeVector(&data);
+    std::string thumbnail_key = statement.ColumnString(3);
+    if (!thumbnail_key.empty())
+      thumbnail.thumbnail = blobs_->Get(thumbnail_key);
     thumbnail.thumbnail_score.boring_score = statement.ColumnDouble(5);
     thumbnail.thumbnail_score.good_clipping = statement.ColumnBool(6);
     thumbnail.thumbnail_score.at_top = statement.ColumnBool(7);
@@ -176,34 +255,42 @@ void TopSitesDatabase::SetRedirects(const std::string& redirects,
 void TopSitesDatabase::SetPageThumbnail(const MostVisitedURL& url,
                                             int new_rank,
                                             const Images& thumbnail) {
+  // Write the image before the row that refers to it. If the transaction
+  // fails the image is collected on the next start.
+  std::string thumbnail_key;
+  if (thumbnail.thumbnail.get() && thumbnail.thumbnail->front())
+    thumbnail_key = blobs_->Put(thumbnail.thumbnail);
+
   sql::Transaction transaction(db_.get());
   transaction.Begin();
 
+  std::string old_thumbnail_key;
   int rank = GetURLRank(url);
   if (rank == -1) {
-    AddPageThumbnail(url, new_rank, thumbnail);
+    AddPageThumbnail(url, new_rank, thumbnail, thumbnail_key);
   } else {
+    old_thumbnail_key = GetThumbnailKey(url);
     UpdatePageRankNoTransaction(url, new_rank);
-    UpdatePageThumbnail(url, thumbnail);
+    UpdatePageThumbnail(url, thumbnail, thumbnail_key);
   }
 
-  transaction.Commit();
+  if (transaction.Commit() && old_thumbnail_key != thumbnail_key)
+    ReleaseThumbnail(old_thumbnail_key);
 }
 
 bool TopSitesDatabase::UpdatePageThumbnail(
-    const MostVisitedURL& url, const Images& thumbnail) {
+    const MostVisitedURL& url, const Images& thumbnail,
+    const std::string& thumbnail_key) {
   sql::Statement statement(db_->GetCachedStatement(
       SQL_FROM_HERE,
       "UPDATE thumbnails SET "
-      "title = ?, thumbnail = ?, redirects = ?, "
+      "title = ?, thumbnail_key = ?, redirects = ?, "
       "boring_score = ?, good_clipping = ?, at_top = ?, last_updated = ?, "
       "load_completed = ? "
       "WHERE url = ? "));
   statement.BindString16(0, url.title);
-  if (thumbnail.thumbnail.get() && thumbnail.thumbnail->front()) {
-    statement.BindBlob(1, thumbnail.thumbnail->front(),
-                       static_cast<int>(thumbnail.thumbnail->size()));
-  }
+  if (!thumbnail_key.empty())
+    statement.BindString(1, thumbnail_key);
   statement.BindString(2, GetRedirects(url));
   const ThumbnailScore& score = thumbnail.thumbnail_score;
   statement.BindDouble(3, score.boring_score);
@@ -217,23 +304,22 @@ bool TopSitesDatabase::UpdatePageThumbnail(
 }
 
 void TopSitesDatabase::AddPageThumbnail(const MostVisitedURL& url,
-                                            int new_rank,
-                                            const Images& thumbnail) {
+                                        int new_rank,
+                                        const Images& thumbnail,
+                                        const std::string& thumbnail_key) {
   int count = GetRowCount();
 
   sql::Statement statement(db_->GetCachedStatement(
       SQL_FROM_HERE,
       "INSERT OR REPLACE INTO thumbnails "
-      "(url, url_rank, title, thumbnail, redirects, "
+      "(url, url_rank, title, thumbnail_key, redirects, "
       "boring_score, good_clipping, at_top, last_updated, load_completed) "
       "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
   statement.BindString(0, url.url.spec());
   statement.BindInt(1, count);  // Make it the last url.
   statement.BindString16(2, url.title);
-  if (thumbnail.thumbnail.get() && thumbnail.thumbnail->front()) {
-    statement.BindBlob(3, thumbnail.thumbnail->front(),
-                       static_cast<int>(thumbnail.thumbnail->size()));
-  }
+  if (!thumbnail_key.empty())
+    statement.BindString(3, thumbnail_key);
   statement.BindString(4, GetRedirects(url));
   const ThumbnailScore& score = thumbnail.thumbnail_score;
   statement.BindDouble(5, score.boring_score);
@@ -302,15 +388,15 @@ bool TopSitesDatabase::GetPageThumbnail(const GURL& url,
                                             Images* thumbnail) {
   sql::Statement statement(db_->GetCachedStatement(
       SQL_FROM_HERE,
-      "SELECT thumbnail, boring_score, good_clipping, at_top, last_updated "
-      "FROM thumbnails WHERE url=?"));
+      "SELECT thumbnail_key, boring_score, good_clipping, at_top, "
+      "last_updated FROM thumbnails WHERE url=?"));
   statement.BindString(0, url.spec());
   if (!statement.Step())
     return false;
 
-  std::vector<unsigned char> data;
-  statement.ColumnBlobAsVector(0, &data);
-  thumbnail->thumbnail = base::RefCountedBytes::TakeVector(&data);
+  std::string thumbnail_key = statement.ColumnString(0);
+  thumbnail->thumbnail =
+      thumbnail_key.empty() ? NULL : blobs_->Get(thumbnail_key);
   thumbnail->thumbnail_score.boring_score = statement.ColumnDouble(1);
   thumbnail->thumbnail_score.good_clipping = statement.ColumnBool(2);
   thumbnail->thumbnail_score.at_top = statement.ColumnBool(3);
@@ -329,6 +415,43 @@ int TopSitesDatabase::GetRowCount() {
   return 0;
 }
 
+std::string TopSitesDatabase::GetThumbnailKey(const MostVisitedURL& url) {
+  sql::Statement select_statement(db_->GetCachedStatement(
+      SQL_FROM_HERE,
+      "SELECT thumbnail_key "
+      "FROM thumbnails WHERE url=?"));
+  select_statement.BindString(0, url.url.spec());
+  if (select_statement.Step())
+    return select_statement.ColumnString(0);
+
+  return std::string();
+}
+
+void TopSitesDatabase::ReleaseThumbnail(const std::string& thumbnail_key) {
+  if (thumbnail_key.empty())
+    return;
+
+  // Identical images share a key, so another URL may still use this one.
+  sql::Statement select_statement(db_->GetCachedStatement(
+      SQL_FROM_HERE,
+      "SELECT COUNT (url) FROM thumbnails WHERE thumbnail_key=?"));
+  select_statement.BindString(0, thumbnail_key);
+  if (select_statement.Step() && select_statement.ColumnInt(0) == 0)
+    blobs_->Delete(thumbnail_key);
+}
+
+void TopSitesDatabase::DeleteUnreferencedThumbnails() {
+  sql::Statement statement(db_->GetUniqueStatement(
+      "SELECT thumbnail_key FROM thumbnails WHERE thumbnail_key IS NOT NULL"));
+  std::set<std::string> live_keys;
+  while (statement.Step())
+    live_keys.insert(statement.ColumnString(0));
+
+  // Don't collect anything if the table couldn't be read completely.
+  if (statement.Succeeded())
+    blobs_->DeleteAllExcept(live_keys);
+}
+
 int TopSitesDatabase::GetURLRank(const MostVisitedURL& url) {
   sql::Statement select_statement(db_->GetCachedStatement(
       SQL_FROM_HERE,
@@ -346,6 +469,7 @@ bool TopSitesDatabase::RemoveURL(const MostVisitedURL& url) {
   int old_rank = GetURLRank(url);
   if (old_rank < 0)
     return false;
+  std::string thumbnail_key = GetThumbnailKey(url);
 
   sql::Transaction transaction(db_.get());
   transaction.Begin();
@@ -368,7 +492,11 @@ bool TopSitesDatabase::RemoveURL(const MostVisitedURL& url) {
   if (!delete_statement.Run())
     return false;
 
-  return transaction.Commit();
+  if (!transaction.Commit())
+    return false;
+
+  ReleaseThumbnail(thumbnail_key);
+  return true;
 }
 
 sql::Connection* TopSitesDatabase::CreateDB(const FilePath& db_name) {
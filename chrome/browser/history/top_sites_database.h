@@ -10,6 +10,7 @@
 #include <string>
 
 #include "base/gtest_prod_util.h"
+#include "base/memory/scoped_ptr.h"
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/history/url_database.h"  // For DBCloseScoper.
 #include "sql/meta_table.h"
@@ -22,6 +23,10 @@ class Connection;
 
 namespace history {
 
+class BlobStore;
+
+// Thumbnail images are kept out of the database in a BlobStore next to it;
+// each row only stores the key of its image.
 class TopSitesDatabase {
  public:
   TopSitesDatabase();
@@ -65,6 +70,7 @@ class TopSitesDatabase {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(TopSitesDatabaseTest, UpgradeToVersion2);
+  FRIEND_TEST_ALL_PREFIXES(TopSitesDatabaseTest, UpgradeToVersion3);
 
   // Creates the thumbnail table, returning true if the table already exists
   // or was successfully created.
@@ -74,10 +80,16 @@ class TopSitesDatabase {
   // upgrade was successful.
   bool UpgradeToVersion2();
 
-  // Adds a new URL to the database.
+  // Upgrades the thumbnail table to version 3 by moving the images stored in
+  // the database into |blobs_|, returning true if the upgrade was successful.
+  bool UpgradeToVersion3();
+
+  // Adds a new URL to the database. |thumbnail_key| names the image in
+  // |blobs_|, and is empty if there is none.
   void AddPageThumbnail(const MostVisitedURL& url,
                         int new_rank,
-                        const Images& thumbnail);
+                        const Images& thumbnail,
+                        const std::string& thumbnail_key);
 
   // Sets the page rank. Should be called within an open transaction.
   void UpdatePageRankNoTransaction(const MostVisitedURL& url, int new_rank);
@@ -85,7 +97,19 @@ class TopSitesDatabase {
   // Updates thumbnail of a URL that's already in the database.
   // Returns true if the database query succeeds.
   bool UpdatePageThumbnail(const MostVisitedURL& url,
-                           const Images& thumbnail);
+                           const Images& thumbnail,
+                           const std::string& thumbnail_key);
+
+  // Returns the key of the URL's image, or an empty string if it has none.
+  std::string GetThumbnailKey(const MostVisitedURL& url);
+
+  // Deletes the image for |thumbnail_key| from |blobs_| unless another row
+  // still refers to it.
+  void ReleaseThumbnail(const std::string& thumbnail_key);
+
+  // Deletes images that no row refers to, such as ones written just before a
+  // crash.
+  void DeleteUnreferencedThumbnails();
 
   // Returns the URL's current rank or -1 if it is not present.
   int GetURLRank(const MostVisitedURL& url);
@@ -103,6 +127,7 @@ class TopSitesDatabase {
 
   scoped_ptr<sql::Connection> db_;
   sql::MetaTable meta_table_;
+  scoped_ptr<BlobStore> blobs_;
 
   // See description above class.
   bool may_need_history_migration_;
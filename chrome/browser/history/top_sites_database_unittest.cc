@@ -4,8 +4,11 @@
 
 #include "base/file_path.h"
 #include "base/file_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/scoped_temp_dir.h"
 #include "chrome/browser/history/top_sites_database.h"
+#include "sql/connection.h"
+#include "sql/statement.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace history {
@@ -53,4 +56,77 @@ TEST_F(TopSitesDatabaseTest, UpgradeToVersion2) {
   ASSERT_TRUE(db.db_->DoesColumnExist("thumbnails", "load_completed"));
 }
 
+TEST_F(TopSitesDatabaseTest, UpgradeToVersion3) {
+  const char kImage[] = "jpeg";
+  const GURL kURL("http://www.google.com/");
+
+  TopSitesDatabase db;
+  ASSERT_TRUE(db.Init(file_name_));
+
+  // Recreate a version 2 table with its image stored inline.
+  ASSERT_TRUE(db.db_->Execute("DROP TABLE IF EXISTS thumbnails"));
+  ASSERT_TRUE(db.db_->Execute("CREATE TABLE thumbnails ("
+                              "url LONGVARCHAR PRIMARY KEY,"
+                              "url_rank INTEGER ,"
+                              "title LONGVARCHAR,"
+                              "thumbnail BLOB,"
+                              "redirects LONGVARCHAR,"
+                              "boring_score DOUBLE DEFAULT 1.0, "
+                              "good_clipping INTEGER DEFAULT 0, "
+                              "at_top INTEGER DEFAULT 0, "
+                              "last_updated INTEGER DEFAULT 0, "
+                              "load_completed INTEGER DEFAULT 0)"));
+  sql::Statement insert(db.db_->GetUniqueStatement(
+      "INSERT INTO thumbnails (url, url_rank, thumbnail) VALUES (?, 0, ?)"));
+  insert.BindString(0, kURL.spec());
+  insert.BindBlob(1, kImage, sizeof(kImage));
+  ASSERT_TRUE(insert.Run());
+  db.meta_table_.SetVersionNumber(2);
+
+  ASSERT_TRUE(db.UpgradeToVersion3());
+  EXPECT_EQ(3, db.meta_table_.GetVersionNumber());
+
+  // The image now comes from the blob store.
+  sql::Statement select(db.db_->GetUniqueStatement(
+      "SELECT thumbnail, thumbnail_key FROM thumbnails"));
+  ASSERT_TRUE(select.Step());
+  EXPECT_EQ(sql::COLUMN_TYPE_NULL, select.ColumnType(0));
+  EXPECT_FALSE(select.ColumnString(1).empty());
+
+  Images images;
+  ASSERT_TRUE(db.GetPageThumbnail(kURL, &images));
+  ASSERT_TRUE(images.thumbnail.get());
+  ASSERT_EQ(sizeof(kImage), images.thumbnail->size());
+  EXPECT_EQ(0, memcmp(kImage, images.thumbnail->front(), sizeof(kImage)));
+}
+
+TEST_F(TopSitesDatabaseTest, SharedThumbnailOutlivesOneURL) {
+  const char kImage[] = "jpeg";
+  MostVisitedURL url1(GURL("http://www.google.com/"), string16());
+  MostVisitedURL url2(GURL("http://www.example.com/"), string16());
+
+  Images images;
+  images.thumbnail = new base::RefCountedStaticMemory(
+      reinterpret_cast<const unsigned char*>(kImage), sizeof(kImage));
+
+  TopSitesDatabase db;
+  ASSERT_TRUE(db.Init(file_name_));
+  db.SetPageThumbnail(url1, 0, images);
+  db.SetPageThumbnail(url2, 1, images);
+
+  // Both URLs share one file; removing one must leave the other's image.
+  ASSERT_TRUE(db.RemoveURL(url1));
+  Images result;
+  ASSERT_TRUE(db.GetPageThumbnail(url2.url, &result));
+  ASSERT_TRUE(result.thumbnail.get());
+  EXPECT_EQ(sizeof(kImage), result.thumbnail->size());
+  result.thumbnail = NULL;
+
+  ASSERT_TRUE(db.RemoveURL(url2));
+  file_util::FileEnumerator enumerator(
+      FilePath(file_name_.value() + FILE_PATH_LITERAL(" Thumbnails")), false,
+      file_util::FileEnumerator::FILES);
+  EXPECT_TRUE(enumerator.Next().empty());
+}
+
 }  // namespace history
@@ -773,11 +773,8 @@ HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
     if (iter == words.begin()) {
       history_id_set.swap(term_history_set);
     } else {
-      HistoryIDSet new_history_id_set;
-      std::set_intersection(history_id_set.begin(), history_id_set.end(),
-                            term_history_set.begin(), term_history_set.end(),
-                            std::inserter(new_history_id_set,
-                                          new_history_id_set.begin()));
+      HistoryIDSet new_history_id_set(
+          IntersectSets(history_id_set, term_history_set));
       history_id_set.swap(new_history_id_set);
     }
   }
@@ -850,11 +847,7 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       if (prefix_chars.empty()) {
         word_id_set.swap(leftover_set);
       } else {
-        WordIDSet new_word_id_set;
-        std::set_intersection(word_id_set.begin(), word_id_set.end(),
-                              leftover_set.begin(), leftover_set.end(),
-                              std::inserter(new_word_id_set,
-                                            new_word_id_set.begin()));
+        WordIDSet new_word_id_set(IntersectSets(word_id_set, leftover_set));
         word_id_set.swap(new_word_id_set);
       }
     }
@@ -920,12 +913,10 @@ WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
       word_id_set = char_word_id_set;
     } else {
       // Subsequent character results get intersected in.
-      WordIDSet new_word_id_set;
-      std::set_intersection(word_id_set.begin(), word_id_set.end(),
-                            char_word_id_set.begin(), char_word_id_set.end(),
-                            std::inserter(new_word_id_set,
-                                          new_word_id_set.begin()));
+      WordIDSet new_word_id_set(IntersectSets(word_id_set, char_word_id_set));
       word_id_set.swap(new_word_id_set);
+      if (word_id_set.empty())
+        break;
     }
   }
   return word_id_set;
@@ -1014,9 +1005,17 @@ void URLIndexPrivateData::SaveCharWordMap(
     map_entry->set_char_16(iter->first);
     const WordIDSet& word_id_set(iter->second);
     map_entry->set_item_count(word_id_set.size());
+    WordID previous_id = 0;
     for (WordIDSet::const_iterator set_iter = word_id_set.begin();
-         set_iter != word_id_set.end(); ++set_iter)
-      map_entry->add_word_id(*set_iter);
+         set_iter != word_id_set.end(); ++set_iter) {
+      if (saved_cache_version_ < 2) {
+        map_entry->add_word_id(*set_iter);
+        continue;
+      }
+      map_entry->add_word_id_delta(
+          static_cast<uint32>(*set_iter - previous_id));
+      previous_id = *set_iter;
+    }
   }
 }
 
@@ -1033,9 +1032,17 @@ void URLIndexPrivateData::SaveWordIDHistoryMap(
     map_entry->set_word_id(iter->first);
     const HistoryIDSet& history_id_set(iter->second);
     map_entry->set_item_count(history_id_set.size());
+    HistoryID previous_id = 0;
     for (HistoryIDSet::const_iterator set_iter = history_id_set.begin();
-         set_iter != history_id_set.end(); ++set_iter)
-      map_entry->add_history_id(*set_iter);
+         set_iter != history_id_set.end(); ++set_iter) {
+      if (saved_cache_version_ < 2) {
+        map_entry->add_history_id(*set_iter);
+        continue;
+      }
+      map_entry->add_history_id_delta(
+          static_cast<uint64>(*set_iter - previous_id));
+      previous_id = *set_iter;
+    }
   }
 }
 
@@ -1220,16 +1227,24 @@ bool URLIndexPrivateData::RestoreCharWordMap(
   for (RepeatedPtrField<CharWordMapEntry>::const_iterator iter =
        entries.begin(); iter != entries.end(); ++iter) {
     expected_item_count = iter->item_count();
-    actual_item_count = iter->word_id_size();
+    actual_item_count = iter->word_id_size() + iter->word_id_delta_size();
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     char16 uni_char = static_cast<char16>(iter->char_16());
-    WordIDSet word_id_set;
+    // The ids were saved in ascending order so each one is inserted at the
+    // end of the set, which avoids searching the tree.
+    WordIDSet& word_id_set(char_word_map_[uni_char]);
     const RepeatedField<int32>& word_ids(iter->word_id());
     for (RepeatedField<int32>::const_iterator jiter = word_ids.begin();
          jiter != word_ids.end(); ++jiter)
-      word_id_set.insert(*jiter);
-    char_word_map_[uni_char] = word_id_set;
+      word_id_set.insert(word_id_set.end(), *jiter);
+    WordID word_id = 0;
+    const RepeatedField<uint32>& word_id_deltas(iter->word_id_delta());
+    for (RepeatedField<uint32>::const_iterator jiter = word_id_deltas.begin();
+         jiter != word_id_deltas.end(); ++jiter) {
+      word_id += *jiter;
+      word_id_set.insert(word_id_set.end(), word_id);
+    }
   }
   return true;
 }
@@ -1248,18 +1263,25 @@ bool URLIndexPrivateData::RestoreWordIDHistoryMap(
   for (RepeatedPtrField<WordIDHistoryMapEntry>::const_iterator iter =
        entries.begin(); iter != entries.end(); ++iter) {
     expected_item_count = iter->item_count();
-    actual_item_count = iter->history_id_size();
+    actual_item_count = iter->history_id_size() + iter->history_id_delta_size();
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     WordID word_id = iter->word_id();
-    HistoryIDSet history_id_set;
+    HistoryIDSet& history_id_set(word_id_history_map_[word_id]);
     const RepeatedField<int64>& history_ids(iter->history_id());
     for (RepeatedField<int64>::const_iterator jiter = history_ids.begin();
          jiter != history_ids.end(); ++jiter) {
-      history_id_set.insert(*jiter);
+      history_id_set.insert(history_id_set.end(), *jiter);
       AddToHistoryIDWordMap(*jiter, word_id);
     }
-    word_id_history_map_[word_id] = history_id_set;
+    HistoryID history_id = 0;
+    const RepeatedField<uint64>& history_id_deltas(iter->history_id_delta());
+    for (RepeatedField<uint64>::const_iterator jiter =
+         history_id_deltas.begin(); jiter != history_id_deltas.end(); ++jiter) {
+      history_id += *jiter;
+      history_id_set.insert(history_id_set.end(), history_id);
+      AddToHistoryIDWordMap(history_id, word_id);
+    }
   }
   return true;
 }
@@ -11,7 +11,11 @@
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/debug/leak_tracker.h"
+#include "base/base64.h"
 #include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/path_service.h"
+#include "base/rand_util.h"
 #include "base/stl_util.h"
 #include "base/string_number_conversions.h"
 #include "base/string_split.h"
@@ -25,10 +29,14 @@
 #include "chrome/browser/net/chrome_url_request_context.h"
 #include "chrome/browser/net/connect_interceptor.h"
 #include "chrome/browser/net/http_pipelining_compatibility_client.h"
+#include "chrome/browser/net/load_timing_observer.h"
 #include "chrome/browser/net/pref_proxy_config_tracker.h"
 #include "chrome/browser/net/proxy_service_factory.h"
 #include "chrome/browser/net/sdch_dictionary_fetcher.h"
+#include "chrome/browser/password_manager/encryptor.h"
 #include "chrome/browser/prefs/pref_service.h"
+#include "chrome/common/chrome_constants.h"
+#include "chrome/common/chrome_paths.h"
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/pref_names.h"
 #include "content/public/browser/browser_thread.h"
@@ -52,6 +60,7 @@
 #include "net/proxy/proxy_config_service.h"
 #include "net/proxy/proxy_script_fetcher_impl.h"
 #include "net/proxy/proxy_service.h"
+#include "net/socket/ssl_host_info.h"
 #include "net/url_request/url_request_throttler_manager.h"
 
 #if defined(USE_NSS)
@@ -71,6 +80,34 @@ class SafeBrowsingURLRequestContext;
 
 namespace {
 
+// How often the wait of the tasks of the IO thread is sampled.
+const int kTaskQueueSampleIntervalSeconds = 10;
+
+// Size of the secret that protects the TLS sessions saved to disk.
+const size_t kSSLSessionPersistenceSecretSize = 32;
+
+// Enables saving TLS sessions to disk, with a secret generated on first use and
+// kept in |local_state|, protected like the saved passwords.
+void InitializeSSLSessionPersistence(PrefService* local_state) {
+  std::string secret;
+  std::string encrypted_secret;
+  if (!base::Base64Decode(
+          local_state->GetString(prefs::kSSLSessionPersistenceSecret),
+          &encrypted_secret) ||
+      !Encryptor::DecryptString(encrypted_secret, &secret) ||
+      secret.size() != kSSLSessionPersistenceSecretSize) {
+    secret = base::RandBytesAsString(kSSLSessionPersistenceSecretSize);
+    std::string encoded_secret;
+    if (!Encryptor::EncryptString(secret, &encrypted_secret) ||
+        !base::Base64Encode(encrypted_secret, &encoded_secret)) {
+      return;
+    }
+    local_state->SetString(prefs::kSSLSessionPersistenceSecret,
+                           encoded_secret);
+  }
+  net::SSLHostInfo::EnableSessionPersistence(secret);
+}
+
 // Custom URLRequestContext used by requests which aren't associated with a
 // particular profile. We need to use a subclass of URLRequestContext in order
 // to provide the correct User-Agent.
@@ -139,7 +176,7 @@ net::HostResolver* CreateGlobalHostResolver(net::NetLog* net_log) {
   }
 
   net::HostResolver* global_host_resolver = NULL;
-  if (command_line.HasSwitch(switches::kEnableAsyncDns)) {
+  if (!command_line.HasSwitch(switches::kDisableAsyncDns)) {
     global_host_resolver =
         net::CreateAsyncHostResolver(parallelism, retry_attempts, net_log);
   }
@@ -337,6 +374,10 @@ IOThread::IOThread(
                                                     local_state);
   ssl_config_service_manager_.reset(
       SSLConfigServiceManager::CreateDefaultManager(local_state));
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableSSLSessionPersistence)) {
+    InitializeSSLSessionPersistence(local_state);
+  }
 
   BrowserThread::SetDelegate(BrowserThread::IO, this);
 }
@@ -459,6 +500,15 @@ void IOThread::Init() {
 
   sdch_manager_ = new net::SdchManager();
 
+  // Some tests run without a NetLog, and so without stats to record into.
+  if (net_log_) {
+    task_queue_sampler_.Start(
+        FROM_HERE,
+        base::TimeDelta::FromSeconds(kTaskQueueSampleIntervalSeconds),
+        this,
+        &IOThread::SampleTaskQueueDelay);
+  }
+
   // InitSystemRequestContext turns right around and posts a task back
   // to the IO thread, so we can't let it run until we know the IO
   // thread has started.
@@ -483,6 +533,8 @@ void IOThread::Init() {
 void IOThread::CleanUp() {
   base::debug::LeakTracker<SafeBrowsingURLRequestContext>::CheckForLeaks();
 
+  task_queue_sampler_.Stop();
+
   delete sdch_manager_;
   sdch_manager_ = NULL;
 
@@ -517,6 +569,7 @@ void IOThread::RegisterPrefs(PrefService* local_state) {
   local_state->RegisterStringPref(prefs::kAuthNegotiateDelegateWhitelist, "");
   local_state->RegisterStringPref(prefs::kGSSAPILibraryName, "");
   local_state->RegisterBooleanPref(prefs::kEnableReferrers, true);
+  local_state->RegisterStringPref(prefs::kSSLSessionPersistenceSecret, "");
 }
 
 net::HttpAuthHandlerFactory* IOThread::CreateDefaultAuthHandlerFactory(
@@ -566,6 +619,20 @@ void IOThread::ChangedToOnTheRecordOnIOThread() {
   ClearHostCache();
 }
 
+void IOThread::SampleTaskQueueDelay() {
+  MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&IOThread::OnTaskQueueSampled, base::Unretained(this),
+                 base::TimeTicks::Now()));
+}
+
+void IOThread::OnTaskQueueSampled(base::TimeTicks post_time) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  net_log_->load_timing_observer()->stats()->AddSample(
+      LoadTimingStats::PHASE_IO_THREAD_QUEUE, std::string(),
+      base::TimeTicks::Now() - post_time);
+}
+
 void IOThread::InitSystemRequestContext() {
   if (system_url_request_context_getter_)
     return;
@@ -628,4 +695,10 @@ void IOThread::InitSystemRequestContextOnIOThread() {
 
   sdch_manager_->set_sdch_fetcher(
       new SdchDictionaryFetcher(system_url_request_context_getter_.get()));
+  FilePath user_data_dir;
+  if (PathService::Get(chrome::DIR_USER_DATA, &user_data_dir)) {
+    sdch_manager_->EnablePersistence(
+        user_data_dir.Append(chrome::kSdchDictionariesDirname),
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE));
+  }
 }
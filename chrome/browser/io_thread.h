@@ -13,6 +13,8 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time.h"
+#include "base/timer.h"
 #include "chrome/browser/net/ssl_config_service_manager.h"
 #include "chrome/browser/prefs/pref_member.h"
 #include "content/public/browser/browser_thread.h"
@@ -165,6 +167,11 @@ class IOThread : public content::BrowserThreadDelegate {
 
   void ChangedToOnTheRecordOnIOThread();
 
+  // Posts a task that measures how long tasks wait in the IO thread's queue,
+  // for the performance view of about:net-internals.
+  void SampleTaskQueueDelay();
+  void OnTaskQueueSampled(base::TimeTicks post_time);
+
   // The NetLog is owned by the browser process, to allow logging from other
   // threads during shutdown, but is used most frequently on the IOThread.
   ChromeNetLog* net_log_;
@@ -212,6 +219,9 @@ class IOThread : public content::BrowserThreadDelegate {
 
   net::SdchManager* sdch_manager_;
 
+  // Runs SampleTaskQueueDelay() while the IO thread is up.
+  base::RepeatingTimer<IOThread> task_queue_sampler_;
+
   base::WeakPtrFactory<IOThread> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(IOThread);
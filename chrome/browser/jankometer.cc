@@ -247,15 +247,15 @@ class IOJankObserver : public base::RefCountedThreadSafe<IOJankObserver>,
     helper_.EndProcessingTimers();
   }
 
-  virtual void WillProcessTask(base::TimeTicks time_posted) OVERRIDE {
+  virtual void WillProcessTask(const base::PendingTask& pending_task) OVERRIDE {
     if (!helper_.MessageWillBeMeasured())
       return;
     base::TimeTicks now = base::TimeTicks::Now();
-    const base::TimeDelta queueing_time = now - time_posted;
+    const base::TimeDelta queueing_time = now - pending_task.time_posted;
     helper_.StartProcessingTimers(queueing_time);
   }
 
-  virtual void DidProcessTask(base::TimeTicks time_posted) OVERRIDE {
+  virtual void DidProcessTask(const base::PendingTask& pending_task) OVERRIDE {
     helper_.EndProcessingTimers();
   }
 
@@ -293,15 +293,15 @@ class UIJankObserver : public base::RefCountedThreadSafe<UIJankObserver>,
     MessageLoopForUI::current()->RemoveObserver(this);
   }
 
-  virtual void WillProcessTask(base::TimeTicks time_posted) OVERRIDE {
+  virtual void WillProcessTask(const base::PendingTask& pending_task) OVERRIDE {
     if (!helper_.MessageWillBeMeasured())
       return;
     base::TimeTicks now = base::TimeTicks::Now();
-    const base::TimeDelta queueing_time = now - time_posted;
+    const base::TimeDelta queueing_time = now - pending_task.time_posted;
     helper_.StartProcessingTimers(queueing_time);
   }
 
-  virtual void DidProcessTask(base::TimeTicks time_posted) OVERRIDE {
+  virtual void DidProcessTask(const base::PendingTask& pending_task) OVERRIDE {
     helper_.EndProcessingTimers();
   }
 
@@ -83,7 +83,7 @@ class LowMemoryObserverImpl
     // Overrides for MessageLoopForIO::Watcher
     virtual void OnFileCanWriteWithoutBlocking(int fd) OVERRIDE {}
     virtual void OnFileCanReadWithoutBlocking(int fd) OVERRIDE {
-      LOG(WARNING) << "Low memory condition detected.  Discarding a tab.";
+      LOG(WARNING) << "Low memory condition detected.  Freeing memory.";
       // We can only discard tabs on the UI thread.
       base::Callback<void(void)> callback = base::Bind(&DiscardTab);
       BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, callback);
@@ -95,7 +95,7 @@ class LowMemoryObserverImpl
     static void DiscardTab() {
       CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
       if (g_browser_process && g_browser_process->oom_priority_manager())
-        g_browser_process->oom_priority_manager()->LogMemoryAndDiscardTab();
+        g_browser_process->oom_priority_manager()->HandleLowMemory();
     }
    private:
     LowMemoryObserverImpl* owner_;
@@ -0,0 +1,155 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/memory_pressure_monitor.h"
+
+#include <algorithm>
+
+#include "base/allocator/allocator_extension.h"
+#include "base/bind.h"
+#include "base/metrics/histogram.h"
+#include "base/process_util.h"
+#include "chrome/browser/memory_purger.h"
+#include "content/public/browser/browser_thread.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#endif
+
+using content::BrowserThread;
+
+namespace {
+
+// How often system memory is sampled.
+const int kCheckIntervalSeconds = 5;
+
+// How long listeners get to free memory before the amount reclaimed is
+// measured.
+const int kReclaimDelaySeconds = 3;
+
+// Pressure levels, as a percentage of physical memory left available.
+const int kModeratePressurePercent = 10;
+const int kCriticalPressurePercent = 5;
+
+MemoryPressureMonitor::MemoryInfo SampleMemoryOnFileThread() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  MemoryPressureMonitor::MemoryInfo info;
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  base::SystemMemoryInfoKB meminfo;
+  if (base::GetSystemMemoryInfo(&meminfo)) {
+    info.total_kb = meminfo.total;
+    // Clean page cache is given back to whoever needs it, so count it as
+    // available.
+    info.available_kb = meminfo.free + meminfo.buffers + meminfo.cached;
+  }
+#elif defined(OS_WIN)
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  if (::GlobalMemoryStatusEx(&status)) {
+    info.total_kb = static_cast<int>(status.ullTotalPhys / 1024);
+    info.available_kb = static_cast<int>(status.ullAvailPhys / 1024);
+  }
+  // The handle is owned by the FILE thread for the life of the process.
+  static HANDLE low_memory_notification =
+      ::CreateMemoryResourceNotification(LowMemoryResourceNotification);
+  BOOL low_memory = FALSE;
+  if (low_memory_notification &&
+      ::QueryMemoryResourceNotification(low_memory_notification,
+                                        &low_memory)) {
+    info.low_memory_signaled = low_memory != FALSE;
+  }
+#endif
+  return info;
+}
+
+}  // namespace
+
+MemoryPressureMonitor::MemoryInfo::MemoryInfo()
+    : total_kb(0),
+      available_kb(0),
+      low_memory_signaled(false) {
+}
+
+MemoryPressureMonitor::MemoryPressureMonitor()
+    : current_level_(-1),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+}
+
+void MemoryPressureMonitor::Start() {
+  timer_.Start(FROM_HERE, base::TimeDelta::FromSeconds(kCheckIntervalSeconds),
+               this, &MemoryPressureMonitor::CheckMemory);
+}
+
+// static
+int MemoryPressureMonitor::GetPressureLevel(const MemoryInfo& info) {
+  if (info.low_memory_signaled)
+    return base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL;
+  if (info.total_kb <= 0)
+    return -1;
+  int64 available_percent =
+      static_cast<int64>(info.available_kb) * 100 / info.total_kb;
+  if (available_percent < kCriticalPressurePercent)
+    return base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL;
+  if (available_percent < kModeratePressurePercent)
+    return base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE;
+  return -1;
+}
+
+void MemoryPressureMonitor::CheckMemory() {
+  BrowserThread::PostTaskAndReplyWithResult<MemoryInfo>(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&SampleMemoryOnFileThread),
+      base::Bind(&MemoryPressureMonitor::OnMemorySampled,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void MemoryPressureMonitor::OnMemorySampled(MemoryInfo info) {
+  int level = GetPressureLevel(info);
+  if (level <= current_level_) {
+    if (level < 0)
+      current_level_ = -1;
+    return;
+  }
+  current_level_ = level;
+
+  MemoryPressureLevel pressure_level = static_cast<MemoryPressureLevel>(level);
+  base::MemoryPressureListener::NotifyMemoryPressure(pressure_level);
+  // Renderers don't watch system memory themselves; have them drop their
+  // WebKit, font and V8 caches when things get critical.
+  if (pressure_level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    MemoryPurger::PurgeRenderers();
+
+  BrowserThread::PostDelayedTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&MemoryPressureMonitor::MeasureReclaimedMemory,
+                 weak_factory_.GetWeakPtr(), pressure_level, info),
+      base::TimeDelta::FromSeconds(kReclaimDelaySeconds));
+}
+
+void MemoryPressureMonitor::MeasureReclaimedMemory(MemoryPressureLevel level,
+                                                   MemoryInfo before) {
+  // By now the listeners have dropped what they could; hand the allocator's
+  // free pages back too before measuring.
+  base::allocator::ReleaseFreeMemory();
+  BrowserThread::PostTaskAndReplyWithResult<MemoryInfo>(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&SampleMemoryOnFileThread),
+      base::Bind(&MemoryPressureMonitor::RecordReclaimedMemory,
+                 weak_factory_.GetWeakPtr(), level, before));
+}
+
+void MemoryPressureMonitor::RecordReclaimedMemory(MemoryPressureLevel level,
+                                                  MemoryInfo before,
+                                                  MemoryInfo after) {
+  int reclaimed_kb = std::max(after.available_kb - before.available_kb, 0);
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    UMA_HISTOGRAM_MEMORY_KB("Memory.PressureReclaimed.Critical", reclaimed_kb);
+  else
+    UMA_HISTOGRAM_MEMORY_KB("Memory.PressureReclaimed.Moderate", reclaimed_kb);
+}
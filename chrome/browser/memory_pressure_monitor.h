@@ -0,0 +1,68 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// MemoryPressureMonitor watches how much physical memory is left on the
+// system and broadcasts base::MemoryPressureListener notifications when it
+// runs low, so that caches across the browser can trim themselves before the
+// system starts swapping.
+
+#ifndef CHROME_BROWSER_MEMORY_PRESSURE_MONITOR_H_
+#define CHROME_BROWSER_MEMORY_PRESSURE_MONITOR_H_
+#pragma once
+
+#include "base/basictypes.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer.h"
+
+class MemoryPressureMonitor {
+ public:
+  // A snapshot of system memory, in KB. |low_memory_signaled| is set if the
+  // platform itself reported low memory.
+  struct MemoryInfo {
+    MemoryInfo();
+
+    int total_kb;
+    int available_kb;
+    bool low_memory_signaled;
+  };
+
+  // Must be created and destroyed on the UI thread.
+  MemoryPressureMonitor();
+  ~MemoryPressureMonitor();
+
+  // Starts sampling system memory on the FILE thread.
+  void Start();
+
+  // Returns the pressure level for |info|, or -1 if there is none. Exposed
+  // for testing.
+  static int GetPressureLevel(const MemoryInfo& info);
+
+ private:
+  typedef base::MemoryPressureListener::MemoryPressureLevel
+      MemoryPressureLevel;
+
+  void CheckMemory();
+  void OnMemorySampled(MemoryInfo info);
+
+  // Samples memory again once listeners have had time to react, and records
+  // how much they freed.
+  void MeasureReclaimedMemory(MemoryPressureLevel level, MemoryInfo before);
+  void RecordReclaimedMemory(MemoryPressureLevel level,
+                             MemoryInfo before,
+                             MemoryInfo after);
+
+  base::RepeatingTimer<MemoryPressureMonitor> timer_;
+
+  // The level last broadcast, or -1 if memory was fine at the last sample.
+  // Levels are only broadcast when pressure gets worse, so a sustained
+  // shortage doesn't make caches thrash.
+  int current_level_;
+
+  base::WeakPtrFactory<MemoryPressureMonitor> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureMonitor);
+};
+
+#endif  // CHROME_BROWSER_MEMORY_PRESSURE_MONITOR_H_
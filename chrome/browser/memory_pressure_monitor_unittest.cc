@@ -0,0 +1,36 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/memory_pressure_monitor.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+MemoryPressureMonitor::MemoryInfo MakeInfo(int total_kb, int available_kb) {
+  MemoryPressureMonitor::MemoryInfo info;
+  info.total_kb = total_kb;
+  info.available_kb = available_kb;
+  return info;
+}
+
+}  // namespace
+
+TEST(MemoryPressureMonitorTest, GetPressureLevel) {
+  EXPECT_EQ(-1, MemoryPressureMonitor::GetPressureLevel(MakeInfo(0, 0)));
+  EXPECT_EQ(-1, MemoryPressureMonitor::GetPressureLevel(MakeInfo(1000, 500)));
+  EXPECT_EQ(-1, MemoryPressureMonitor::GetPressureLevel(MakeInfo(1000, 100)));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE,
+            MemoryPressureMonitor::GetPressureLevel(MakeInfo(1000, 99)));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE,
+            MemoryPressureMonitor::GetPressureLevel(MakeInfo(1000, 50)));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL,
+            MemoryPressureMonitor::GetPressureLevel(MakeInfo(1000, 49)));
+
+  // The platform's own low memory signal wins.
+  MemoryPressureMonitor::MemoryInfo signaled = MakeInfo(1000, 900);
+  signaled.low_memory_signaled = true;
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL,
+            MemoryPressureMonitor::GetPressureLevel(signaled));
+}
@@ -1,16 +1,35 @@
-// Copyright (c) 2011 The Chromium Authors. All rights reserved.
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
 #include "chrome/browser/metrics/metrics_log_serializer.h"
 
+#include <string.h>
+
 #include "base/base64.h"
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
+#include "base/path_service.h"
+#include "base/string_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/prefs/pref_service.h"
 #include "chrome/browser/prefs/scoped_user_pref_update.h"
+#include "chrome/common/chrome_constants.h"
+#include "chrome/common/chrome_paths.h"
+#include "chrome/common/important_file_writer.h"
 #include "chrome/common/pref_names.h"
+#include "content/public/browser/browser_thread.h"
+#include "third_party/zlib/zlib.h"
+
+using content::BrowserThread;
 
 namespace {
 
@@ -30,10 +49,18 @@ const size_t kMaxInitialLogsPersisted = 20;
 // ongoing_log_ at startup).
 const size_t kMaxOngoingLogsPersisted = 8;
 
+// The total size of the logs of each type that we're willing to save. Older
+// logs are dropped first.
+const size_t kMaxBytesPersisted = 300 * 1024;
+
 // We append (2) more elements to persisted lists: the size of the list and a
 // checksum of the elements.
 const size_t kChecksumEntryCount = 2;
 
+// Keys of the XML and protobuf log lists in a logs file.
+const char kXmlLogsKey[] = "xml";
+const char kProtoLogsKey[] = "proto";
+
 // TODO(isherman): Remove this histogram once it's confirmed that there are no
 // encoding failures for protobuf logs.
 enum LogStoreStatus {
@@ -61,6 +88,51 @@ void MakeStoreStatusHistogram(LogStoreStatus status) {
                             END_STORE_STATUS);
 }
 
+// Compresses |input| with zlib, storing the result in |output|.
+bool ZlibCompress(const std::string& input, std::string* output) {
+  uLongf output_size = compressBound(input.size());
+  output->resize(output_size);
+  int result = compress2(reinterpret_cast<Bytef*>(string_as_array(output)),
+                         &output_size,
+                         reinterpret_cast<const Bytef*>(input.data()),
+                         input.size(),
+                         Z_DEFAULT_COMPRESSION);
+  if (result != Z_OK) {
+    output->clear();
+    return false;
+  }
+  output->resize(output_size);
+  return true;
+}
+
+// Decompresses |input| written by ZlibCompress(), storing the result in
+// |output|.
+bool ZlibUncompress(const std::string& input, std::string* output) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK)
+    return false;
+
+  output->clear();
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  int result;
+  do {
+    char buffer[16 * 1024];
+    stream.next_out = reinterpret_cast<Bytef*>(buffer);
+    stream.avail_out = sizeof(buffer);
+    result = inflate(&stream, Z_NO_FLUSH);
+    output->append(buffer, sizeof(buffer) - stream.avail_out);
+  } while (result == Z_OK);
+  inflateEnd(&stream);
+
+  if (result != Z_STREAM_END) {
+    output->clear();
+    return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 
@@ -71,8 +143,6 @@ MetricsLogSerializer::~MetricsLogSerializer() {}
 void MetricsLogSerializer::SerializeLogs(
     const std::vector<MetricsLogManager::SerializedLog>& logs,
     MetricsLogManager::LogType log_type) {
-  PrefService* local_state = g_browser_process->local_state();
-  DCHECK(local_state);
   const char* pref_xml = NULL;
   const char* pref_proto = NULL;
   size_t max_store_count = 0;
@@ -92,19 +162,42 @@ void MetricsLogSerializer::SerializeLogs(
       return;
   };
 
-  // Write the XML version.
-  ListPrefUpdate update_xml(local_state, pref_xml);
-  WriteLogsToPrefList(logs, true, max_store_count, update_xml.Get());
+  // Tasks posted to the FILE thread still run during shutdown, so the logs
+  // persisted as the browser exits make it to disk.
+  size_t start =
+      GetFirstPersistedLogIndex(logs, max_store_count, kMaxBytesPersisted);
+  std::vector<MetricsLogManager::SerializedLog>* persisted_logs =
+      new std::vector<MetricsLogManager::SerializedLog>(logs.begin() + start,
+                                                        logs.end());
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&MetricsLogSerializer::WriteLogsToFile,
+                 GetLogsFilePath(log_type), base::Owned(persisted_logs)));
 
-  // Write the protobuf version.
-  ListPrefUpdate update_proto(local_state, pref_proto);
-  WriteLogsToPrefList(logs, false, max_store_count, update_proto.Get());
+  // Drop any logs left in Local State by earlier versions; they were read
+  // back by DeserializeLogs() and are now in the file.
+  PrefService* local_state = g_browser_process->local_state();
+  DCHECK(local_state);
+  local_state->ClearPref(pref_xml);
+  local_state->ClearPref(pref_proto);
 }
 
 void MetricsLogSerializer::DeserializeLogs(
     MetricsLogManager::LogType log_type,
     std::vector<MetricsLogManager::SerializedLog>* logs) {
   DCHECK(logs);
+  {
+    // The file is small, and is read once per session when the first log is
+    // staged.
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    std::string data;
+    if (file_util::ReadFileToString(GetLogsFilePath(log_type), &data)) {
+      DecodeLogs(data, logs);
+      return;
+    }
+  }
+
+  // Fall back to logs persisted to Local State by earlier versions.
   PrefService* local_state = g_browser_process->local_state();
   DCHECK(local_state);
 
@@ -127,6 +220,107 @@ void MetricsLogSerializer::DeserializeLogs(
   }
 }
 
+// static
+FilePath MetricsLogSerializer::GetLogsFilePath(
+    MetricsLogManager::LogType log_type) {
+  FilePath user_data_dir;
+  PathService::Get(chrome::DIR_USER_DATA, &user_data_dir);
+  return user_data_dir.Append(log_type == MetricsLogManager::INITIAL_LOG ?
+                              chrome::kMetricsInitialLogsFilename :
+                              chrome::kMetricsOngoingLogsFilename);
+}
+
+// static
+size_t MetricsLogSerializer::GetFirstPersistedLogIndex(
+    const std::vector<MetricsLogManager::SerializedLog>& logs,
+    size_t max_count,
+    size_t max_bytes) {
+  size_t start = logs.size();
+  size_t total_bytes = 0;
+  while (start > 0 && logs.size() - start < max_count) {
+    const MetricsLogManager::SerializedLog& log = logs[start - 1];
+    total_bytes += log.xml.length() + log.proto.length();
+    if (total_bytes > max_bytes)
+      break;
+    --start;
+  }
+  return start;
+}
+
+// static
+bool MetricsLogSerializer::EncodeLogs(
+    std::vector<MetricsLogManager::SerializedLog>* logs,
+    std::string* data) {
+  // The XML is already compressed with bzip2 for upload; the protobuf data is
+  // sent as is, so compress it here.
+  std::string compressed_proto;
+  for (std::vector<MetricsLogManager::SerializedLog>::iterator it =
+           logs->begin();
+       it != logs->end(); ++it) {
+    if (!ZlibCompress(it->proto, &compressed_proto))
+      return false;
+    it->proto.swap(compressed_proto);
+  }
+
+  base::ListValue* xml_list = new base::ListValue;
+  WriteLogsToPrefList(*logs, true, logs->size(), xml_list);
+  base::ListValue* proto_list = new base::ListValue;
+  WriteLogsToPrefList(*logs, false, logs->size(), proto_list);
+
+  base::DictionaryValue dict;
+  dict.Set(kXmlLogsKey, xml_list);
+  dict.Set(kProtoLogsKey, proto_list);
+  base::JSONWriter::Write(&dict, data);
+  return true;
+}
+
+// static
+MetricsLogSerializer::LogReadStatus MetricsLogSerializer::DecodeLogs(
+    const std::string& data,
+    std::vector<MetricsLogManager::SerializedLog>* logs) {
+  scoped_ptr<base::Value> value(base::JSONReader::Read(data));
+  base::DictionaryValue* dict = NULL;
+  base::ListValue* xml_list = NULL;
+  base::ListValue* proto_list = NULL;
+  if (!value.get() || !value->GetAsDictionary(&dict) ||
+      !dict->GetList(kXmlLogsKey, &xml_list) ||
+      !dict->GetList(kProtoLogsKey, &proto_list)) {
+    return MakeRecallStatusHistogram(FILE_CORRUPTION, true);
+  }
+
+  LogReadStatus status = ReadLogsFromPrefList(*xml_list, true, logs);
+  if (status != RECALL_SUCCESS)
+    return status;
+  // As with prefs, only read the protobuf data if the XML data was read.
+  if (ReadLogsFromPrefList(*proto_list, false, logs) != RECALL_SUCCESS)
+    return status;
+
+  std::string proto;
+  for (std::vector<MetricsLogManager::SerializedLog>::iterator it =
+           logs->begin();
+       it != logs->end(); ++it) {
+    if (!ZlibUncompress(it->proto, &proto)) {
+      logs->clear();
+      return MakeRecallStatusHistogram(DECOMPRESS_FAIL, false);
+    }
+    it->proto.swap(proto);
+  }
+  return status;
+}
+
+// static
+void MetricsLogSerializer::WriteLogsToFile(
+    const FilePath& path,
+    std::vector<MetricsLogManager::SerializedLog>* logs) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  std::string data;
+  if (!EncodeLogs(logs, &data)) {
+    MakeStoreStatusHistogram(COMPRESS_FAIL);
+    return;
+  }
+  ImportantFileWriter::WriteFileAtomically(path, data);
+}
+
 // static
 void MetricsLogSerializer::WriteLogsToPrefList(
     const std::vector<MetricsLogManager::SerializedLog>& local_list,
@@ -6,15 +6,22 @@
 #define CHROME_BROWSER_METRICS_METRICS_LOG_SERIALIZER_H_
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
 #include "chrome/common/metrics/metrics_log_manager.h"
 
+class FilePath;
+
 namespace base {
 class ListValue;
 }
 
-// Serializer for persisting metrics logs to prefs.
+// Serializer for persisting metrics logs to a file per log type in the user
+// data directory. Logs persisted to Local State prefs by earlier versions are
+// read back once, and then dropped from prefs.
 class MetricsLogSerializer : public MetricsLogManager::LogSerializer {
  public:
   // Used to produce a histogram that keeps track of the status of recalling
@@ -31,6 +38,8 @@ class MetricsLogSerializer : public MetricsLogManager::LogSerializer {
                                  // GetAsString().
     DECODE_FAIL,            // Failed to decode log.
     XML_PROTO_MISMATCH,     // The XML and protobuf logs have inconsistent data.
+    FILE_CORRUPTION,        // Failed to parse the logs file.
+    DECOMPRESS_FAIL,        // Failed to decompress a protobuf log.
     END_RECALL_STATUS       // Number of bins to use to create the histogram.
   };
 
@@ -46,6 +55,34 @@ class MetricsLogSerializer : public MetricsLogManager::LogSerializer {
       std::vector<MetricsLogManager::SerializedLog>* logs) OVERRIDE;
 
  private:
+  // Returns the file that logs of |log_type| are persisted to.
+  static FilePath GetLogsFilePath(MetricsLogManager::LogType log_type);
+
+  // Returns the index of the oldest of |logs| that gets persisted, so that at
+  // most |max_count| of the most recent logs, totalling at most |max_bytes|,
+  // are kept.
+  static size_t GetFirstPersistedLogIndex(
+      const std::vector<MetricsLogManager::SerializedLog>& logs,
+      size_t max_count,
+      size_t max_bytes);
+
+  // Compresses the protobuf data of |logs| in place, and encodes |logs| into
+  // |data|. Returns false if compression fails.
+  static bool EncodeLogs(std::vector<MetricsLogManager::SerializedLog>* logs,
+                         std::string* data);
+
+  // Decodes |data| written by EncodeLogs() into |logs|, decompressing the
+  // protobuf data, and returns a status code for the XML data.
+  static LogReadStatus DecodeLogs(
+      const std::string& data,
+      std::vector<MetricsLogManager::SerializedLog>* logs);
+
+  // Encodes |logs| and atomically replaces |path| with them. Runs on the FILE
+  // thread, so that compression and disk access stay off the UI thread.
+  static void WriteLogsToFile(
+      const FilePath& path,
+      std::vector<MetricsLogManager::SerializedLog>* logs);
+
   // Encodes the textual log data from |local_list| and writes it to the given
   // pref list, along with list size and checksum.  If |is_xml| is true, writes
   // the XML data from |local_list|; otherwise writes the protobuf data.
@@ -70,6 +107,9 @@ class MetricsLogSerializer : public MetricsLogManager::LogSerializer {
   FRIEND_TEST_ALL_PREFIXES(MetricsLogSerializerTest, RemoveSizeFromLogList);
   FRIEND_TEST_ALL_PREFIXES(MetricsLogSerializerTest, CorruptSizeOfLogList);
   FRIEND_TEST_ALL_PREFIXES(MetricsLogSerializerTest, CorruptChecksumOfLogList);
+  FRIEND_TEST_ALL_PREFIXES(MetricsLogSerializerTest, EncodeAndDecodeLogs);
+  FRIEND_TEST_ALL_PREFIXES(MetricsLogSerializerTest, DecodeCorruptLogs);
+  FRIEND_TEST_ALL_PREFIXES(MetricsLogSerializerTest, PersistedLogsByteLimit);
 
   DISALLOW_COPY_AND_ASSIGN(MetricsLogSerializer);
 };
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "base/base64.h"
+#include "base/json/json_writer.h"
 #include "base/md5.h"
 #include "base/values.h"
 #include "chrome/browser/metrics/metrics_log_serializer.h"
@@ -198,3 +199,74 @@ TEST(MetricsLogSerializerTest, CorruptChecksumOfLogList) {
       MetricsLogSerializer::CHECKSUM_CORRUPTION,
       MetricsLogSerializer::ReadLogsFromPrefList(list, true, &local_list));
 }
+
+// Encode logs for a logs file and decode them back.
+TEST(MetricsLogSerializerTest, EncodeAndDecodeLogs) {
+  std::vector<SerializedLog> local_list(2);
+  local_list[0].xml = "one";
+  local_list[0].proto = std::string(1000, 'a');
+  local_list[1].xml = "two";
+  local_list[1].proto = "two";
+
+  std::vector<SerializedLog> encoded_list(local_list);
+  std::string data;
+  ASSERT_TRUE(MetricsLogSerializer::EncodeLogs(&encoded_list, &data));
+  // The protobuf data is compressed before it is stored.
+  EXPECT_LT(encoded_list[0].proto.length(), local_list[0].proto.length());
+
+  std::vector<SerializedLog> decoded_list;
+  EXPECT_EQ(MetricsLogSerializer::RECALL_SUCCESS,
+            MetricsLogSerializer::DecodeLogs(data, &decoded_list));
+  ASSERT_EQ(2U, decoded_list.size());
+  for (size_t i = 0; i < local_list.size(); ++i) {
+    EXPECT_EQ(local_list[i].xml, decoded_list[i].xml);
+    EXPECT_EQ(local_list[i].proto, decoded_list[i].proto);
+  }
+}
+
+// Decode a logs file that is not valid.
+TEST(MetricsLogSerializerTest, DecodeCorruptLogs) {
+  std::vector<SerializedLog> local_list;
+  EXPECT_EQ(MetricsLogSerializer::FILE_CORRUPTION,
+            MetricsLogSerializer::DecodeLogs("not json", &local_list));
+  EXPECT_EQ(0U, local_list.size());
+
+  // Protobuf data that is not zlib compressed.
+  local_list.resize(1);
+  local_list[0].xml = "Hello world!";
+  local_list[0].proto = "Hello world!";
+  ListValue* xml_list = new ListValue;
+  MetricsLogSerializer::WriteLogsToPrefList(local_list, true,
+                                            kMaxLocalListSize, xml_list);
+  ListValue* proto_list = new ListValue;
+  MetricsLogSerializer::WriteLogsToPrefList(local_list, false,
+                                            kMaxLocalListSize, proto_list);
+  DictionaryValue dict;
+  dict.Set("xml", xml_list);
+  dict.Set("proto", proto_list);
+  std::string data;
+  base::JSONWriter::Write(&dict, &data);
+
+  local_list.clear();
+  EXPECT_EQ(MetricsLogSerializer::DECOMPRESS_FAIL,
+            MetricsLogSerializer::DecodeLogs(data, &local_list));
+  EXPECT_EQ(0U, local_list.size());
+}
+
+// Only the most recent logs that fit in the byte limit are persisted.
+TEST(MetricsLogSerializerTest, PersistedLogsByteLimit) {
+  std::vector<SerializedLog> local_list(4);
+  for (size_t i = 0; i < local_list.size(); ++i) {
+    local_list[i].xml = std::string(10, 'x');
+    local_list[i].proto = std::string(10, 'p');
+  }
+
+  EXPECT_EQ(0U, MetricsLogSerializer::GetFirstPersistedLogIndex(
+      local_list, kMaxLocalListSize + 1, 80));
+  EXPECT_EQ(1U, MetricsLogSerializer::GetFirstPersistedLogIndex(
+      local_list, kMaxLocalListSize, 80));
+  EXPECT_EQ(2U, MetricsLogSerializer::GetFirstPersistedLogIndex(
+      local_list, kMaxLocalListSize, 59));
+  EXPECT_EQ(4U, MetricsLogSerializer::GetFirstPersistedLogIndex(
+      local_list, kMaxLocalListSize, 19));
+}
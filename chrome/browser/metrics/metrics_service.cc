@@ -17,8 +17,9 @@
 // transmission.  Transmission includes submitting a compressed log as data in a
 // URL-post, and retransmitting (or retaining at process termination) if the
 // attempted transmission failed.  Retention across process terminations is done
-// using the the PrefServices facilities. The retained logs (the ones that never
-// got transmitted) are compressed and base64-encoded before being persisted.
+// by MetricsLogSerializer, which writes the retained logs (the ones that never
+// got transmitted) to files in the user data directory, off the UI thread.
+// The logs are compressed and base64-encoded before being persisted.
 //
 // Logs fall into one of two categories: "initial logs," and "ongoing logs."
 // There is at most one initial log sent for each complete run of the chromium
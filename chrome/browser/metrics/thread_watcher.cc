@@ -6,11 +6,14 @@
 
 #include <math.h>  // ceil
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/debug/alias.h"
 #include "base/lazy_instance.h"
 #include "base/string_tokenizer.h"
+#include "base/threading/thread_local.h"
 #include "base/threading/thread_restrictions.h"
 #include "build/build_config.h"
 #include "chrome/browser/metrics/metrics_service.h"
@@ -107,6 +110,55 @@ void CrashBecauseThreadWasUnresponsive(BrowserThread::ID thread_id) {
   CHECK(false);  // Shouldn't be reached.
 }
 
+// Number of answered pings over which queueing latency percentiles are
+// computed.
+const size_t kLatencyWindowSize = 60;
+
+// Pings that wait longer than this in the watched thread's queue are blamed
+// on the slowest task that ran ahead of them.
+const int kJankThresholdMs = 100;
+
+// Remembers the slowest task run on the watched thread since the last ping.
+// One is attached to each watched thread by its first ping, and lives as long
+// as the process.
+class SlowTaskObserver : public MessageLoop::TaskObserver {
+ public:
+  SlowTaskObserver() {}
+
+  virtual void WillProcessTask(const base::PendingTask& pending_task) OVERRIDE {
+    task_start_time_ = base::TimeTicks::Now();
+  }
+
+  virtual void DidProcessTask(const base::PendingTask& pending_task) OVERRIDE {
+    base::TimeDelta run_time = base::TimeTicks::Now() - task_start_time_;
+    if (run_time > slowest_task_time_) {
+      slowest_task_time_ = run_time;
+      slowest_task_posted_from_ = pending_task.posted_from;
+    }
+  }
+
+  // Returns the slowest task since the last call, and starts over.
+  void TakeSlowestTask(base::TimeDelta* run_time,
+                       tracked_objects::Location* posted_from) {
+    *run_time = slowest_task_time_;
+    *posted_from = slowest_task_posted_from_;
+    slowest_task_time_ = base::TimeDelta();
+    slowest_task_posted_from_ = tracked_objects::Location();
+  }
+
+ private:
+  virtual ~SlowTaskObserver() {}
+
+  base::TimeTicks task_start_time_;
+  base::TimeDelta slowest_task_time_;
+  tracked_objects::Location slowest_task_posted_from_;
+
+  DISALLOW_COPY_AND_ASSIGN(SlowTaskObserver);
+};
+
+base::LazyInstance<base::ThreadLocalPointer<SlowTaskObserver> >::Leaky
+    g_slow_task_observer = LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // ThreadWatcher methods and members.
@@ -123,6 +175,11 @@ ThreadWatcher::ThreadWatcher(const WatchingParams& params)
       active_(false),
       ping_count_(params.unresponsive_threshold),
       response_time_histogram_(NULL),
+      queueing_latency_histogram_(NULL),
+      queueing_latency_p50_histogram_(NULL),
+      queueing_latency_p95_histogram_(NULL),
+      queueing_latency_p99_histogram_(NULL),
+      jank_task_time_histogram_(NULL),
       unresponsive_time_histogram_(NULL),
       unresponsive_count_(0),
       hung_processing_complete_(false),
@@ -221,10 +278,12 @@ void ThreadWatcher::PostPingMessage() {
   base::Closure callback(
       base::Bind(&ThreadWatcher::OnPongMessage, weak_ptr_factory_.GetWeakPtr(),
                  ping_sequence_number_));
+  ProbeCallback probe_callback(
+      base::Bind(&ThreadWatcher::OnProbe, weak_ptr_factory_.GetWeakPtr()));
   if (watched_loop_->PostTask(
           FROM_HERE,
-          base::Bind(&ThreadWatcher::OnPingMessage, thread_id_,
-                     callback))) {
+          base::Bind(&ThreadWatcher::OnPingMessage, thread_id_, ping_time_,
+                     probe_callback, callback))) {
       // Post a task to check the responsiveness of watched thread.
       MessageLoop::current()->PostDelayedTask(
           FROM_HERE,
@@ -311,6 +370,46 @@ void ThreadWatcher::Initialize() {
       base::TimeDelta::FromSeconds(100), 50,
       base::Histogram::kUmaTargetedHistogramFlag);
 
+  const std::string queueing_latency_histogram_name =
+      "ThreadWatcher.QueueingLatency." + thread_name_;
+  queueing_latency_histogram_ = base::Histogram::FactoryTimeGet(
+      queueing_latency_histogram_name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(100), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+
+  const std::string queueing_latency_p50_histogram_name =
+      "ThreadWatcher.QueueingLatencyP50." + thread_name_;
+  queueing_latency_p50_histogram_ = base::Histogram::FactoryTimeGet(
+      queueing_latency_p50_histogram_name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(100), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+
+  const std::string queueing_latency_p95_histogram_name =
+      "ThreadWatcher.QueueingLatencyP95." + thread_name_;
+  queueing_latency_p95_histogram_ = base::Histogram::FactoryTimeGet(
+      queueing_latency_p95_histogram_name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(100), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+
+  const std::string queueing_latency_p99_histogram_name =
+      "ThreadWatcher.QueueingLatencyP99." + thread_name_;
+  queueing_latency_p99_histogram_ = base::Histogram::FactoryTimeGet(
+      queueing_latency_p99_histogram_name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(100), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+
+  const std::string jank_task_time_histogram_name =
+      "ThreadWatcher.JankTaskTime." + thread_name_;
+  jank_task_time_histogram_ = base::Histogram::FactoryTimeGet(
+      jank_task_time_histogram_name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(100), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+
   const std::string unresponsive_time_histogram_name =
       "ThreadWatcher.Unresponsive." + thread_name_;
   unresponsive_time_histogram_ = base::Histogram::FactoryTimeGet(
@@ -334,12 +433,71 @@ void ThreadWatcher::Initialize() {
 
 // static
 void ThreadWatcher::OnPingMessage(const BrowserThread::ID& thread_id,
+                                  base::TimeTicks ping_time,
+                                  const ProbeCallback& probe_callback,
                                   const base::Closure& callback_task) {
   // This method is called on watched thread.
   DCHECK(BrowserThread::CurrentlyOn(thread_id));
+  base::TimeDelta queueing_latency = base::TimeTicks::Now() - ping_time;
+
+  SlowTaskObserver* observer = g_slow_task_observer.Get().Get();
+  base::TimeDelta slowest_task_time;
+  tracked_objects::Location slowest_task_posted_from;
+  if (observer) {
+    observer->TakeSlowestTask(&slowest_task_time, &slowest_task_posted_from);
+  } else {
+    observer = new SlowTaskObserver;
+    MessageLoop::current()->AddTaskObserver(observer);
+    g_slow_task_observer.Get().Set(observer);
+  }
+
+  WatchDogThread::PostTask(
+      FROM_HERE,
+      base::Bind(probe_callback, queueing_latency, slowest_task_time,
+                 slowest_task_posted_from));
   WatchDogThread::PostTask(FROM_HERE, callback_task);
 }
 
+void ThreadWatcher::OnProbe(
+    base::TimeDelta queueing_latency,
+    base::TimeDelta slowest_task_time,
+    const tracked_objects::Location& slowest_task_posted_from) {
+  DCHECK(WatchDogThread::CurrentlyOnWatchDogThread());
+  queueing_latency_histogram_->AddTime(queueing_latency);
+
+  if (queueing_latency.InMilliseconds() >= kJankThresholdMs &&
+      slowest_task_time > base::TimeDelta()) {
+    jank_task_time_histogram_->AddTime(slowest_task_time);
+    DVLOG(1) << thread_name_ << " thread was janked for "
+             << queueing_latency.InMilliseconds() << " ms by a task posted at "
+             << slowest_task_posted_from.ToString();
+  }
+
+  recent_latencies_.push_back(queueing_latency);
+  if (recent_latencies_.size() < kLatencyWindowSize)
+    return;
+  std::sort(recent_latencies_.begin(), recent_latencies_.end());
+  queueing_latency_p50_histogram_->AddTime(
+      GetPercentile(recent_latencies_, 50));
+  queueing_latency_p95_histogram_->AddTime(
+      GetPercentile(recent_latencies_, 95));
+  queueing_latency_p99_histogram_->AddTime(
+      GetPercentile(recent_latencies_, 99));
+  recent_latencies_.clear();
+}
+
+// static
+base::TimeDelta ThreadWatcher::GetPercentile(
+    const std::vector<base::TimeDelta>& sorted_latencies,
+    int percentile) {
+  DCHECK(!sorted_latencies.empty());
+  // Nearest rank: the smallest latency that at least |percentile|% of the
+  // latencies are less than or equal to.
+  size_t rank = static_cast<size_t>(
+      ceil(percentile * sorted_latencies.size() / 100.0));
+  return sorted_latencies[std::max<size_t>(rank, 1) - 1];
+}
+
 void ThreadWatcher::ResetHangCounters() {
   DCHECK(WatchDogThread::CurrentlyOnWatchDogThread());
   unresponsive_count_ = 0;
@@ -10,7 +10,10 @@
 //
 // ThreadWatcher class sends ping message to the watched thread and the watched
 // thread responds back with a pong message. It uploads response time
-// (difference between ping and pong times) as a histogram.
+// (difference between ping and pong times) as a histogram. It also uploads how
+// long each ping waited in the watched thread's queue, along with the 50th,
+// 95th and 99th percentiles of that wait over a window of pings, and the run
+// time of the slowest task the watched thread ran while a late ping waited.
 //
 // TODO(raman): ThreadWatcher can detect hung threads. If a hung thread is
 // detected, we should probably just crash, and allow the crash system to gather
@@ -60,6 +63,7 @@
 #include "base/threading/thread.h"
 #include "base/threading/watchdog.h"
 #include "base/time.h"
+#include "base/tracked_objects.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
@@ -192,15 +196,39 @@ class ThreadWatcher {
   FRIEND_TEST_ALL_PREFIXES(ThreadWatcherTest, ThreadNotResponding);
   FRIEND_TEST_ALL_PREFIXES(ThreadWatcherTest, MultipleThreadsResponding);
   FRIEND_TEST_ALL_PREFIXES(ThreadWatcherTest, MultipleThreadsNotResponding);
+  FRIEND_TEST_ALL_PREFIXES(ThreadWatcherTest, QueueingLatencyPercentiles);
 
   // Post constructor initialization.
   void Initialize();
 
-  // Watched thread does nothing except post callback_task to the WATCHDOG
-  // Thread. This method is called on watched thread.
+  // Reports how long a ping waited in the watched thread's queue, and the
+  // run time and origin of the slowest task the watched thread ran since the
+  // previous ping.
+  typedef base::Callback<void(base::TimeDelta,
+                              base::TimeDelta,
+                              const tracked_objects::Location&)>
+      ProbeCallback;
+
+  // Watched thread does nothing except post probe_callback and callback_task
+  // to the WATCHDOG Thread. This method is called on watched thread.
   static void OnPingMessage(const content::BrowserThread::ID& thread_id,
+                            base::TimeTicks ping_time,
+                            const ProbeCallback& probe_callback,
                             const base::Closure& callback_task);
 
+  // Records the queueing latency of a ping, and once |kLatencyWindowSize|
+  // pings have been answered, the percentiles of their latencies. If the ping
+  // was late, it also records the slowest task that ran ahead of it.
+  void OnProbe(base::TimeDelta queueing_latency,
+               base::TimeDelta slowest_task_time,
+               const tracked_objects::Location& slowest_task_posted_from);
+
+  // Returns the |percentile|th percentile of |sorted_latencies|, which must
+  // be sorted and non-empty.
+  static base::TimeDelta GetPercentile(
+      const std::vector<base::TimeDelta>& sorted_latencies,
+      int percentile);
+
   // This method resets |unresponsive_count_| to zero because watched thread is
   // responding to the ping message with a pong message.
   void ResetHangCounters();
@@ -254,6 +282,21 @@ class ThreadWatcher {
   // Histogram that keeps track of response times for the watched thread.
   base::Histogram* response_time_histogram_;
 
+  // Histograms that keep track of how long pings wait in the watched thread's
+  // queue, and of the percentiles of that wait over windows of pings.
+  base::Histogram* queueing_latency_histogram_;
+  base::Histogram* queueing_latency_p50_histogram_;
+  base::Histogram* queueing_latency_p95_histogram_;
+  base::Histogram* queueing_latency_p99_histogram_;
+
+  // Histogram that keeps track of the run time of the slowest task that ran
+  // ahead of a late ping.
+  base::Histogram* jank_task_time_histogram_;
+
+  // Queueing latencies of the pings answered since percentiles were last
+  // recorded.
+  std::vector<base::TimeDelta> recent_latencies_;
+
   // Histogram that keeps track of unresponsive time since the last pong message
   // when we got no response (GotNoResponse()) from the watched thread.
   base::Histogram* unresponsive_time_histogram_;
@@ -554,3 +554,23 @@ TEST_F(ThreadWatcherTest, MultipleThreadsNotResponding) {
   // Wait for the io_watcher_'s VeryLongMethod to finish.
   io_watcher_->WaitForWaitStateChange(kUnresponsiveTime * 10, ALL_DONE);
 }
+
+// Test that queueing latency percentiles use the nearest rank.
+TEST_F(ThreadWatcherTest, QueueingLatencyPercentiles) {
+  std::vector<base::TimeDelta> latencies;
+  for (int i = 1; i <= 200; ++i)
+    latencies.push_back(base::TimeDelta::FromMilliseconds(i));
+
+  EXPECT_EQ(100, ThreadWatcher::GetPercentile(latencies, 50).InMilliseconds());
+  EXPECT_EQ(190, ThreadWatcher::GetPercentile(latencies, 95).InMilliseconds());
+  EXPECT_EQ(198, ThreadWatcher::GetPercentile(latencies, 99).InMilliseconds());
+  EXPECT_EQ(200,
+            ThreadWatcher::GetPercentile(latencies, 100).InMilliseconds());
+
+  std::vector<base::TimeDelta> single_latency(
+      1, base::TimeDelta::FromMilliseconds(7));
+  EXPECT_EQ(7,
+            ThreadWatcher::GetPercentile(single_latency, 50).InMilliseconds());
+  EXPECT_EQ(7,
+            ThreadWatcher::GetPercentile(single_latency, 99).InMilliseconds());
+}
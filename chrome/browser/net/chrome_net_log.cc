@@ -5,11 +5,13 @@
 #include "chrome/browser/net/chrome_net_log.h"
 
 #include "base/command_line.h"
+#include "base/file_path.h"
 #include "base/logging.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/values.h"
 #include "chrome/browser/net/load_timing_observer.h"
+#include "chrome/browser/net/net_log_binary_logger.h"
 #include "chrome/browser/net/net_log_logger.h"
 #include "chrome/common/chrome_switches.h"
 
@@ -40,6 +42,28 @@ ChromeNetLog::ChromeNetLog()
         command_line->GetSwitchValuePath(switches::kLogNetLog)));
     net_log_logger_->StartObserving(this);
   }
+
+  if (command_line->HasSwitch(switches::kLogNetLogBinary)) {
+    FilePath log_path =
+        command_line->GetSwitchValuePath(switches::kLogNetLogBinary);
+    size_t ring_buffer_size = 0;
+    if (command_line->HasSwitch(switches::kNetLogRingBufferSize)) {
+      base::StringToSizeT(
+          command_line->GetSwitchValueASCII(switches::kNetLogRingBufferSize),
+          &ring_buffer_size);
+    }
+    // Parameters are captured unless --net-log-level asks for LOG_BASIC.
+    LogLevel log_level = LOG_ALL_BUT_BYTES;
+    if (command_line->HasSwitch(switches::kNetLogLevel) &&
+        base_log_level_ == LOG_BASIC) {
+      log_level = LOG_BASIC;
+    }
+    if (!log_path.empty()) {
+      net_log_binary_logger_.reset(
+          new NetLogBinaryLogger(log_path, log_level, ring_buffer_size));
+      net_log_binary_logger_->StartObserving(this);
+    }
+  }
 }
 
 ChromeNetLog::~ChromeNetLog() {
@@ -47,6 +71,8 @@ ChromeNetLog::~ChromeNetLog() {
   RemoveThreadSafeObserver(load_timing_observer_.get());
   if (net_log_logger_.get())
     RemoveThreadSafeObserver(net_log_logger_.get());
+  if (net_log_binary_logger_.get())
+    RemoveThreadSafeObserver(net_log_binary_logger_.get());
 }
 
 void ChromeNetLog::AddEntry(
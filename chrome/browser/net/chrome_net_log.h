@@ -14,6 +14,7 @@
 #include "net/base/net_log.h"
 
 class LoadTimingObserver;
+class NetLogBinaryLogger;
 class NetLogLogger;
 
 // ChromeNetLog is an implementation of NetLog that dispatches network log
@@ -66,6 +67,7 @@ class ChromeNetLog : public net::NetLog {
 
   scoped_ptr<LoadTimingObserver> load_timing_observer_;
   scoped_ptr<NetLogLogger> net_log_logger_;
+  scoped_ptr<NetLogBinaryLogger> net_log_binary_logger_;
 
   // |lock_| must be acquired whenever reading or writing to this.
   ObserverList<ThreadSafeObserver, true> observers_;
@@ -204,4 +204,9 @@ bool CRLSetFetcher::Install(base::DictionaryValue* manifest,
   return true;
 }
 
+bool CRLSetFetcher::GetInstalledFile(
+    const std::string& file, FilePath* installed_file) {
+  return false;
+}
+
 CRLSetFetcher::~CRLSetFetcher() {}
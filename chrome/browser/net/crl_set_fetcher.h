@@ -36,6 +36,8 @@ class CRLSetFetcher : public ComponentInstaller,
   virtual void OnUpdateError(int error) OVERRIDE;
   virtual bool Install(base::DictionaryValue* manifest,
                        const FilePath& unpack_path) OVERRIDE;
+  virtual bool GetInstalledFile(const std::string& file,
+                                FilePath* installed_file) OVERRIDE;
 
  private:
   friend class base::RefCountedThreadSafe<CRLSetFetcher>;
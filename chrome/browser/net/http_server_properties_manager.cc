@@ -199,6 +199,26 @@ HttpServerPropertiesManager::GetPipelineCapabilityMap() const {
   return http_server_properties_impl_->GetPipelineCapabilityMap();
 }
 
+int HttpServerPropertiesManager::GetConnectionDemand(
+    const net::HostPortPair& server) const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->GetConnectionDemand(server);
+}
+
+void HttpServerPropertiesManager::SetConnectionDemand(
+    const net::HostPortPair& server,
+    int demand) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  http_server_properties_impl_->SetConnectionDemand(server, demand);
+  ScheduleUpdatePrefsOnIO();
+}
+
+const net::ConnectionDemandMap&
+HttpServerPropertiesManager::connection_demand_map() const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->connection_demand_map();
+}
+
 //
 // Update the HttpServerPropertiesImpl's cache with data from preferences.
 //
@@ -238,6 +258,9 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnUI() {
   net::PipelineCapabilityMap* pipeline_capability_map =
       new net::PipelineCapabilityMap;
 
+  net::ConnectionDemandMap* connection_demand_map =
+      new net::ConnectionDemandMap;
+
   bool detected_corrupted_prefs = false;
   const base::DictionaryValue& http_server_properties_dict =
       *pref_service_->GetDictionary(prefs::kHttpServerProperties);
@@ -319,6 +342,12 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnUI() {
           static_cast<net::HttpPipelinedHostCapability>(pipeline_capability);
     }
 
+    int connection_demand = 0;
+    if (server_pref_dict->GetInteger("connection_demand", &connection_demand) &&
+        connection_demand > 0) {
+      (*connection_demand_map)[server] = connection_demand;
+    }
+
     // Get alternate_protocol server.
     DCHECK(!ContainsKey(*alternate_protocol_map, server));
     base::DictionaryValue* port_alternate_protocol_dict = NULL;
@@ -368,6 +397,7 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnUI() {
                  base::Owned(spdy_settings_map),
                  base::Owned(alternate_protocol_map),
                  base::Owned(pipeline_capability_map),
+                 base::Owned(connection_demand_map),
                  detected_corrupted_prefs));
 }
 
@@ -376,6 +406,7 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnIO(
     net::SpdySettingsMap* spdy_settings_map,
     net::AlternateProtocolMap* alternate_protocol_map,
     net::PipelineCapabilityMap* pipeline_capability_map,
+    net::ConnectionDemandMap* connection_demand_map,
     bool detected_corrupted_prefs) {
   // Preferences have the master data because admins might have pushed new
   // preferences. Update the cached data with new data from preferences.
@@ -395,6 +426,9 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnIO(
   http_server_properties_impl_->InitializePipelineCapabilities(
       pipeline_capability_map);
 
+  http_server_properties_impl_->InitializeConnectionDemand(
+      connection_demand_map);
+
   // Update the prefs with what we have read (delete all corrupted prefs).
   if (detected_corrupted_prefs)
     ScheduleUpdatePrefsOnIO();
@@ -440,6 +474,11 @@ void HttpServerPropertiesManager::UpdatePrefsFromCacheOnIO() {
   *pipeline_capability_map =
       http_server_properties_impl_->GetPipelineCapabilityMap();
 
+  net::ConnectionDemandMap* connection_demand_map =
+      new net::ConnectionDemandMap;
+  *connection_demand_map =
+      http_server_properties_impl_->connection_demand_map();
+
   // Update the preferences on the UI thread.
   BrowserThread::PostTask(
       BrowserThread::UI,
@@ -449,18 +488,20 @@ void HttpServerPropertiesManager::UpdatePrefsFromCacheOnIO() {
                  base::Owned(spdy_server_list),
                  base::Owned(spdy_settings_map),
                  base::Owned(alternate_protocol_map),
-                 base::Owned(pipeline_capability_map)));
+                 base::Owned(pipeline_capability_map),
+                 base::Owned(connection_demand_map)));
 }
 
 // A local or temporary data structure to hold |supports_spdy|, SpdySettings,
-// PortAlternateProtocolPair, and |pipeline_capability| preferences for a
-// server. This is used only in UpdatePrefsOnUI.
+// PortAlternateProtocolPair, |pipeline_capability| and |connection_demand|
+// preferences for a server. This is used only in UpdatePrefsOnUI.
 struct ServerPref {
   ServerPref()
       : supports_spdy(false),
         settings_map(NULL),
         alternate_protocol(NULL),
-        pipeline_capability(net::PIPELINE_UNKNOWN) {
+        pipeline_capability(net::PIPELINE_UNKNOWN),
+        connection_demand(0) {
   }
   ServerPref(bool supports_spdy,
              const net::SettingsMap* settings_map,
@@ -468,19 +509,22 @@ struct ServerPref {
       : supports_spdy(supports_spdy),
         settings_map(settings_map),
         alternate_protocol(alternate_protocol),
-        pipeline_capability(net::PIPELINE_UNKNOWN) {
+        pipeline_capability(net::PIPELINE_UNKNOWN),
+        connection_demand(0) {
   }
   bool supports_spdy;
   const net::SettingsMap* settings_map;
   const net::PortAlternateProtocolPair* alternate_protocol;
   net::HttpPipelinedHostCapability pipeline_capability;
+  int connection_demand;
 };
 
 void HttpServerPropertiesManager::UpdatePrefsOnUI(
     base::ListValue* spdy_server_list,
     net::SpdySettingsMap* spdy_settings_map,
     net::AlternateProtocolMap* alternate_protocol_map,
-    net::PipelineCapabilityMap* pipeline_capability_map) {
+    net::PipelineCapabilityMap* pipeline_capability_map,
+    net::ConnectionDemandMap* connection_demand_map) {
 
   typedef std::map<net::HostPortPair, ServerPref> ServerPrefMap;
   ServerPrefMap server_pref_map;
@@ -557,6 +601,21 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
     }
   }
 
+  for (net::ConnectionDemandMap::const_iterator map_it =
+           connection_demand_map->begin();
+       map_it != connection_demand_map->end(); ++map_it) {
+    const net::HostPortPair& server = map_it->first;
+
+    ServerPrefMap::iterator it = server_pref_map.find(server);
+    if (it == server_pref_map.end()) {
+      ServerPref server_pref;
+      server_pref.connection_demand = map_it->second;
+      server_pref_map[server] = server_pref;
+    } else {
+      it->second.connection_demand = map_it->second;
+    }
+  }
+
   // Persist the prefs::kHttpServerProperties.
   base::DictionaryValue http_server_properties_dict;
   for (ServerPrefMap::const_iterator map_it =
@@ -606,6 +665,11 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
                                    server_pref.pipeline_capability);
     }
 
+    if (server_pref.connection_demand > 0) {
+      server_pref_dict->SetInteger("connection_demand",
+                                   server_pref.connection_demand);
+    }
+
     http_server_properties_dict.SetWithoutPathExpansion(server.ToString(),
                                                         server_pref_dict);
   }
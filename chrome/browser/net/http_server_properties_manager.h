@@ -136,6 +136,15 @@ class HttpServerPropertiesManager
 
   virtual net::PipelineCapabilityMap GetPipelineCapabilityMap() const OVERRIDE;
 
+  virtual int GetConnectionDemand(
+      const net::HostPortPair& server) const OVERRIDE;
+
+  virtual void SetConnectionDemand(const net::HostPortPair& server,
+                                   int demand) OVERRIDE;
+
+  virtual const net::ConnectionDemandMap&
+      connection_demand_map() const OVERRIDE;
+
  protected:
   // --------------------
   // SPDY related methods
@@ -161,6 +170,7 @@ class HttpServerPropertiesManager
       net::SpdySettingsMap* spdy_settings_map,
       net::AlternateProtocolMap* alternate_protocol_map,
       net::PipelineCapabilityMap* pipeline_capability_map,
+      net::ConnectionDemandMap* connection_demand_map,
       bool detected_corrupted_prefs);
 
   // These are used to delay updating the preferences when cached data in
@@ -184,7 +194,8 @@ class HttpServerPropertiesManager
       base::ListValue* spdy_server_list,
       net::SpdySettingsMap* spdy_settings_map,
       net::AlternateProtocolMap* alternate_protocol_map,
-      net::PipelineCapabilityMap* pipeline_capability_map);
+      net::PipelineCapabilityMap* pipeline_capability_map,
+      net::ConnectionDemandMap* connection_demand_map);
 
  private:
   // Callback for preference changes.
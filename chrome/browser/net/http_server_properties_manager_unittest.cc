@@ -60,17 +60,19 @@ class TestingHttpServerPropertiesManager : public HttpServerPropertiesManager {
 
   MOCK_METHOD0(UpdateCacheFromPrefsOnUI, void());
   MOCK_METHOD0(UpdatePrefsFromCacheOnIO, void());
-  MOCK_METHOD5(UpdateCacheFromPrefsOnIO,
+  MOCK_METHOD6(UpdateCacheFromPrefsOnIO,
                void(std::vector<std::string>* spdy_servers,
                     net::SpdySettingsMap* spdy_settings_map,
                     net::AlternateProtocolMap* alternate_protocol_map,
                     net::PipelineCapabilityMap* pipeline_capability_map,
+                    net::ConnectionDemandMap* connection_demand_map,
                     bool detected_corrupted_prefs));
-  MOCK_METHOD4(UpdatePrefsOnUI,
+  MOCK_METHOD5(UpdatePrefsOnUI,
                void(base::ListValue* spdy_server_list,
                     net::SpdySettingsMap* spdy_settings_map,
                     net::AlternateProtocolMap* alternate_protocol_map,
-                    net::PipelineCapabilityMap* pipeline_capability_map));
+                    net::PipelineCapabilityMap* pipeline_capability_map,
+                    net::ConnectionDemandMap* connection_demand_map));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(TestingHttpServerPropertiesManager);
@@ -149,6 +151,9 @@ TEST_F(HttpServerPropertiesManagerTest,
   // Set pipeline capability for www.google.com:80.
   server_pref_dict->SetInteger("pipeline_capability", net::PIPELINE_CAPABLE);
 
+  // Set connection demand for www.google.com:80.
+  server_pref_dict->SetInteger("connection_demand", 4);
+
   // Set the server preference for www.google.com:80.
   base::DictionaryValue* http_server_properties_dict =
       new base::DictionaryValue;
@@ -218,6 +223,12 @@ TEST_F(HttpServerPropertiesManagerTest,
   EXPECT_EQ(net::PIPELINE_INCAPABLE,
             http_server_props_manager_->GetPipelineCapability(
                 net::HostPortPair::FromString("mail.google.com:80")));
+
+  // Verify connection demand.
+  EXPECT_EQ(4, http_server_props_manager_->GetConnectionDemand(
+      net::HostPortPair::FromString("www.google.com:80")));
+  EXPECT_EQ(0, http_server_props_manager_->GetConnectionDemand(
+      net::HostPortPair::FromString("mail.google.com:80")));
 }
 
 TEST_F(HttpServerPropertiesManagerTest, SupportsSpdy) {
@@ -312,6 +323,23 @@ TEST_F(HttpServerPropertiesManagerTest, PipelineCapability) {
   Mock::VerifyAndClearExpectations(http_server_props_manager_.get());
 }
 
+TEST_F(HttpServerPropertiesManagerTest, ConnectionDemand) {
+  ExpectPrefsUpdate();
+
+  net::HostPortPair busy_server("images.example.com", 80);
+  EXPECT_EQ(0, http_server_props_manager_->GetConnectionDemand(busy_server));
+
+  // Post an update task to the IO thread. SetConnectionDemand calls
+  // ScheduleUpdatePrefsOnIO.
+  http_server_props_manager_->SetConnectionDemand(busy_server, 5);
+
+  // Run the task.
+  loop_.RunAllPending();
+
+  EXPECT_EQ(5, http_server_props_manager_->GetConnectionDemand(busy_server));
+  Mock::VerifyAndClearExpectations(http_server_props_manager_.get());
+}
+
 TEST_F(HttpServerPropertiesManagerTest, Clear) {
   ExpectPrefsUpdate();
 
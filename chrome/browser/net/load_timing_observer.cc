@@ -4,10 +4,13 @@
 
 #include "chrome/browser/net/load_timing_observer.h"
 
+#include "base/memory/scoped_ptr.h"
 #include "base/time.h"
+#include "base/values.h"
 #include "chrome/browser/net/chrome_net_log.h"
 #include "content/public/common/resource_response.h"
 #include "content/public/browser/browser_thread.h"
+#include "googleurl/src/gurl.h"
 #include "net/base/load_flags.h"
 #include "net/url_request/url_request.h"
 #include "net/url_request/url_request_netlog_params.h"
@@ -42,6 +45,21 @@ static Time TimeTicksToTime(const TimeTicks& time_ticks) {
                                  tick_to_time_offset);
 }
 
+// Returns the host an HTTP stream job connects to, from the parameters of its
+// TYPE_HTTP_STREAM_JOB begin event.
+std::string GetHTTPStreamJobHost(net::NetLog::EventParameters* params) {
+  if (!params)
+    return std::string();
+  scoped_ptr<Value> value(params->ToValue());
+  DictionaryValue* dict = NULL;
+  std::string url;
+  if (!value.get() || !value->GetAsDictionary(&dict) ||
+      !dict->GetString("url", &url)) {
+    return std::string();
+  }
+  return GURL(url).host();
+}
+
 static int32 TimeTicksToOffset(
     const TimeTicks& time_ticks,
     LoadTimingObserver::URLRequestRecord* record) {
@@ -243,10 +261,15 @@ void LoadTimingObserver::OnAddHTTPStreamJobEntry(
         http_stream_job_to_record_.clear();
       }
 
-      http_stream_job_to_record_.insert(
-          std::make_pair(source.id, HTTPStreamJobRecord()));
+      HTTPStreamJobRecord& record = http_stream_job_to_record_[source.id];
+      record.host = GetHTTPStreamJobHost(params);
     } else if (is_end) {
-      http_stream_job_to_record_.erase(source.id);
+      HTTPStreamJobToRecordMap::iterator it =
+          http_stream_job_to_record_.find(source.id);
+      if (it != http_stream_job_to_record_.end()) {
+        AddHTTPStreamJobStats(it->second);
+        http_stream_job_to_record_.erase(it);
+      }
     }
     return;
   }
@@ -379,3 +402,19 @@ void LoadTimingObserver::OnAddSocketEntry(
       it->second.ssl_end = time;
   }
 }
+
+void LoadTimingObserver::AddHTTPStreamJobStats(
+    const HTTPStreamJobRecord& record) {
+  if (!record.connect_start.is_null() && !record.connect_end.is_null()) {
+    stats_.AddSample(LoadTimingStats::PHASE_SOCKET_POOL, record.host,
+                     record.connect_end - record.connect_start);
+  }
+  if (!record.dns_start.is_null() && !record.dns_end.is_null()) {
+    stats_.AddSample(LoadTimingStats::PHASE_DNS, record.host,
+                     record.dns_end - record.dns_start);
+  }
+  if (!record.ssl_start.is_null() && !record.ssl_end.is_null()) {
+    stats_.AddSample(LoadTimingStats::PHASE_SSL, record.host,
+                     record.ssl_end - record.ssl_start);
+  }
+}
@@ -9,6 +9,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/hash_tables.h"
 #include "base/time.h"
+#include "chrome/browser/net/load_timing_stats.h"
 #include "net/base/net_log.h"
 #include "webkit/glue/resource_loader_bridge.h"
 
@@ -40,6 +41,8 @@ class LoadTimingObserver : public net::NetLog::ThreadSafeObserver {
   struct HTTPStreamJobRecord {
     HTTPStreamJobRecord();
 
+    // The host the job connects to, for the per host stats.
+    std::string host;
     uint32 socket_log_id;
     bool socket_reused;
     base::TimeTicks connect_start;
@@ -69,6 +72,10 @@ class LoadTimingObserver : public net::NetLog::ThreadSafeObserver {
 
   URLRequestRecord* GetURLRequestRecord(uint32 source_id);
 
+  // Aggregated timings of all the HTTP stream jobs, whether or not their
+  // requests asked for load timing. Must be used on the IO thread.
+  LoadTimingStats* stats() { return &stats_; }
+
   // net::NetLog::ThreadSafeObserver implementation:
   virtual void OnAddEntry(net::NetLog::EventType type,
                           const base::TimeTicks& time,
@@ -114,6 +121,9 @@ class LoadTimingObserver : public net::NetLog::ThreadSafeObserver {
   URLRequestRecord* CreateURLRequestRecord(uint32 source_id);
   void DeleteURLRequestRecord(uint32 source_id);
 
+  // Adds the phases of a finished HTTP stream job to |stats_|.
+  void AddHTTPStreamJobStats(const HTTPStreamJobRecord& record);
+
   typedef base::hash_map<uint32, URLRequestRecord> URLRequestToRecordMap;
   typedef base::hash_map<uint32, HTTPStreamJobRecord> HTTPStreamJobToRecordMap;
   typedef base::hash_map<uint32, ConnectJobRecord> ConnectJobToRecordMap;
@@ -124,6 +134,7 @@ class LoadTimingObserver : public net::NetLog::ThreadSafeObserver {
   SocketToRecordMap socket_to_record_;
   uint32 last_connect_job_id_;
   ConnectJobRecord last_connect_job_record_;
+  LoadTimingStats stats_;
 
   DISALLOW_COPY_AND_ASSIGN(LoadTimingObserver);
 };
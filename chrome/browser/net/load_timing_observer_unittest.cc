@@ -9,6 +9,7 @@
 #include "base/message_loop.h"
 #include "base/stringprintf.h"
 #include "base/time.h"
+#include "base/values.h"
 #include "content/test/test_browser_thread.h"
 #include "net/base/load_flags.h"
 #include "net/url_request/url_request_netlog_params.h"
@@ -78,6 +79,33 @@ void AddStartHTTPStreamJobEntries(LoadTimingObserver& observer, uint32 id) {
   AddStartEntry(observer, source, NetLog::TYPE_HTTP_STREAM_JOB, NULL);
 }
 
+// The parameters of the TYPE_HTTP_STREAM_JOB begin event.
+class HTTPStreamJobParameters : public NetLog::EventParameters {
+ public:
+  explicit HTTPStreamJobParameters(const std::string& url) : url_(url) {}
+
+  virtual Value* ToValue() const OVERRIDE {
+    DictionaryValue* dict = new DictionaryValue();
+    dict->SetString("original_url", url_);
+    dict->SetString("url", url_);
+    return dict;
+  }
+
+ private:
+  virtual ~HTTPStreamJobParameters() {}
+
+  const std::string url_;
+};
+
+void AddStartHTTPStreamJobEntriesForURL(LoadTimingObserver& observer,
+                                        uint32 id,
+                                        const std::string& url) {
+  scoped_refptr<HTTPStreamJobParameters> params(
+      new HTTPStreamJobParameters(url));
+  NetLog::Source source(NetLog::SOURCE_HTTP_STREAM_JOB, id);
+  AddStartEntry(observer, source, NetLog::TYPE_HTTP_STREAM_JOB, params.get());
+}
+
 void AddEndHTTPStreamJobEntries(LoadTimingObserver& observer, uint32 id) {
   NetLog::Source source(NetLog::SOURCE_HTTP_STREAM_JOB, id);
   AddEndEntry(observer, source, NetLog::TYPE_HTTP_STREAM_JOB, NULL);
@@ -402,3 +430,59 @@ TEST_F(LoadTimingObserverTest, SslTime) {
   ASSERT_EQ(1000, record->timing.ssl_start);
   ASSERT_EQ(3000, record->timing.ssl_end);
 }
+
+// Test that the phases of finished HTTP stream jobs are aggregated, whether
+// or not their requests asked for load timing.
+TEST_F(LoadTimingObserverTest, Stats) {
+  LoadTimingObserver observer;
+
+  // Resolve and connect a socket with SSL.
+  AddStartConnectJobEntries(observer, 1);
+  NetLog::Source connect_source(NetLog::SOURCE_CONNECT_JOB, 1);
+  AddStartEntry(observer,
+                connect_source,
+                NetLog::TYPE_HOST_RESOLVER_IMPL,
+                NULL);
+  current_time += TimeDelta::FromMilliseconds(20);
+  AddEndEntry(observer, connect_source, NetLog::TYPE_HOST_RESOLVER_IMPL, NULL);
+  AddEndConnectJobEntries(observer, 1);
+
+  AddStartSocketEntries(observer, 2);
+  NetLog::Source socket_source(NetLog::SOURCE_SOCKET, 2);
+  AddStartEntry(observer, socket_source, NetLog::TYPE_SSL_CONNECT, NULL);
+  current_time += TimeDelta::FromMilliseconds(50);
+  AddEndEntry(observer, socket_source, NetLog::TYPE_SSL_CONNECT, NULL);
+
+  NetLog::Source http_stream_job_source(NetLog::SOURCE_HTTP_STREAM_JOB, 3);
+  AddStartHTTPStreamJobEntriesForURL(observer, 3, "https://www.google.com/");
+  AddStartEntry(observer, http_stream_job_source, NetLog::TYPE_SOCKET_POOL,
+                NULL);
+  BindHTTPStreamJobToConnectJob(observer, http_stream_job_source,
+                                connect_source);
+  BindHTTPStreamJobToSocket(observer, http_stream_job_source, socket_source);
+  current_time += TimeDelta::FromMilliseconds(100);
+  AddEndEntry(observer, http_stream_job_source, NetLog::TYPE_SOCKET_POOL, NULL);
+
+  // Nothing is aggregated until the job is done.
+  LoadTimingStats* stats = observer.stats();
+  EXPECT_EQ(0, stats->GetHistogram(LoadTimingStats::PHASE_SOCKET_POOL).count());
+  AddEndHTTPStreamJobEntries(observer, 3);
+
+  EXPECT_EQ(1, stats->GetHistogram(LoadTimingStats::PHASE_SOCKET_POOL).count());
+  EXPECT_EQ(1, stats->GetHistogram(LoadTimingStats::PHASE_DNS).count());
+  EXPECT_EQ(1, stats->GetHistogram(LoadTimingStats::PHASE_SSL).count());
+  const LoadTimingStats::Histogram* dns = stats->GetHostHistogram(
+      LoadTimingStats::PHASE_DNS, "www.google.com");
+  ASSERT_TRUE(dns);
+  EXPECT_EQ(1, dns->count());
+
+  // A job on a reused socket only spends time in the socket pool.
+  AddStartHTTPStreamJobEntries(observer, 4);
+  NetLog::Source reused_job_source(NetLog::SOURCE_HTTP_STREAM_JOB, 4);
+  AddStartEntry(observer, reused_job_source, NetLog::TYPE_SOCKET_POOL, NULL);
+  AddEndEntry(observer, reused_job_source, NetLog::TYPE_SOCKET_POOL, NULL);
+  AddEndHTTPStreamJobEntries(observer, 4);
+
+  EXPECT_EQ(2, stats->GetHistogram(LoadTimingStats::PHASE_SOCKET_POOL).count());
+  EXPECT_EQ(1, stats->GetHistogram(LoadTimingStats::PHASE_DNS).count());
+}
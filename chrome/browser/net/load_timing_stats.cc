@@ -0,0 +1,146 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/load_timing_stats.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/values.h"
+
+namespace {
+
+// The number of hosts with their own histograms.
+const size_t kMaxHosts = 100;
+
+const char* const kPhaseNames[] = {
+  "socket_pool",
+  "dns",
+  "ssl",
+  "io_thread_queue",
+};
+
+// Adds the histograms of |phases| to |dict|, leaving out the empty ones.
+void AddPhasesToValue(const LoadTimingStats::Histogram* phases,
+                      base::DictionaryValue* dict) {
+  for (int i = 0; i < LoadTimingStats::NUM_PHASES; ++i) {
+    if (phases[i].count())
+      dict->Set(kPhaseNames[i], phases[i].ToValue());
+  }
+}
+
+}  // namespace
+
+LoadTimingStats::Histogram::Histogram()
+    : count_(0),
+      sum_ms_(0),
+      max_ms_(0) {
+  std::fill(buckets_, buckets_ + kNumBuckets, 0);
+}
+
+void LoadTimingStats::Histogram::Add(base::TimeDelta sample) {
+  int64 ms = std::max(sample.InMilliseconds(), static_cast<int64>(0));
+  count_++;
+  sum_ms_ += ms;
+  max_ms_ = std::max(max_ms_, ms);
+
+  int i = 0;
+  for (int64 bits = ms; bits > 0 && i < kNumBuckets - 1; bits >>= 1)
+    i++;
+  buckets_[i]++;
+}
+
+// static
+int64 LoadTimingStats::Histogram::BucketMin(int i) {
+  DCHECK(i >= 0 && i < kNumBuckets);
+  return i ? static_cast<int64>(1) << (i - 1) : 0;
+}
+
+base::DictionaryValue* LoadTimingStats::Histogram::ToValue() const {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetInteger("count", count_);
+  // Milliseconds fit in a double, unlike in the int of a Value.
+  dict->SetDouble("sum_ms", static_cast<double>(sum_ms_));
+  dict->SetDouble("max_ms", static_cast<double>(max_ms_));
+
+  base::ListValue* buckets = new base::ListValue();
+  for (int i = 0; i < kNumBuckets; ++i) {
+    if (!buckets_[i])
+      continue;
+    base::ListValue* bucket = new base::ListValue();
+    bucket->Append(base::Value::CreateDoubleValue(
+        static_cast<double>(BucketMin(i))));
+    bucket->Append(base::Value::CreateIntegerValue(buckets_[i]));
+    buckets->Append(bucket);
+  }
+  dict->Set("buckets", buckets);
+  return dict;
+}
+
+LoadTimingStats::LoadTimingStats() : hosts_(kMaxHosts) {
+  COMPILE_ASSERT(arraysize(kPhaseNames) == NUM_PHASES,
+                 phase_names_mismatch);
+}
+
+LoadTimingStats::~LoadTimingStats() {
+}
+
+void LoadTimingStats::AddSample(Phase phase,
+                                const std::string& host,
+                                base::TimeDelta sample) {
+  DCHECK(phase >= 0 && phase < NUM_PHASES);
+  phases_[phase].Add(sample);
+  if (host.empty())
+    return;
+
+  HostStatsMap::iterator it = hosts_.Get(host);
+  if (it == hosts_.end())
+    it = hosts_.Put(host, HostStats());
+  it->second.phases[phase].Add(sample);
+}
+
+const LoadTimingStats::Histogram& LoadTimingStats::GetHistogram(
+    Phase phase) const {
+  DCHECK(phase >= 0 && phase < NUM_PHASES);
+  return phases_[phase];
+}
+
+const LoadTimingStats::Histogram* LoadTimingStats::GetHostHistogram(
+    Phase phase,
+    const std::string& host) const {
+  DCHECK(phase >= 0 && phase < NUM_PHASES);
+  // MRUCache has no const lookup, but the number of hosts is bounded.
+  for (HostStatsMap::const_iterator it = hosts_.begin(); it != hosts_.end();
+       ++it) {
+    if (it->first == host)
+      return &it->second.phases[phase];
+  }
+  return NULL;
+}
+
+void LoadTimingStats::Reset() {
+  for (int i = 0; i < NUM_PHASES; ++i)
+    phases_[i] = Histogram();
+  hosts_.Clear();
+}
+
+base::DictionaryValue* LoadTimingStats::ToValue() const {
+  base::DictionaryValue* phases = new base::DictionaryValue();
+  AddPhasesToValue(phases_, phases);
+
+  // Host names can contain dots, which DictionaryValue::Set() would take as
+  // paths.
+  base::DictionaryValue* hosts = new base::DictionaryValue();
+  for (HostStatsMap::const_iterator it = hosts_.begin(); it != hosts_.end();
+       ++it) {
+    base::DictionaryValue* host_phases = new base::DictionaryValue();
+    AddPhasesToValue(it->second.phases, host_phases);
+    hosts->SetWithoutPathExpansion(it->first, host_phases);
+  }
+
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->Set("phases", phases);
+  dict->Set("hosts", hosts);
+  return dict;
+}
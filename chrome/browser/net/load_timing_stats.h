@@ -0,0 +1,100 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_NET_LOAD_TIMING_STATS_H_
+#define CHROME_BROWSER_NET_LOAD_TIMING_STATS_H_
+#pragma once
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/mru_cache.h"
+#include "base/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+// LoadTimingStats aggregates the latency of the phases of network loads, as
+// seen by LoadTimingObserver, overall and per host. It only keeps counters,
+// so unlike a full NetLog capture it is cheap enough to always be enabled.
+// The aggregates are shown in the performance view of about:net-internals.
+//
+// LoadTimingStats lives on the IO thread.
+class LoadTimingStats {
+ public:
+  enum Phase {
+    // Time spent in the socket pool: waiting for a socket, and connecting it
+    // when no idle one could be reused.
+    PHASE_SOCKET_POOL,
+    PHASE_DNS,
+    PHASE_SSL,
+    // Time a task posted to the IO thread waits in its queue.
+    PHASE_IO_THREAD_QUEUE,
+    NUM_PHASES
+  };
+
+  // A latency histogram with exponential buckets. Bucket 0 counts samples
+  // under 1 ms, bucket i samples in [2^(i-1), 2^i) ms, and the last bucket
+  // everything above.
+  class Histogram {
+   public:
+    static const int kNumBuckets = 16;
+
+    Histogram();
+
+    void Add(base::TimeDelta sample);
+
+    int count() const { return count_; }
+    int bucket(int i) const { return buckets_[i]; }
+
+    // Returns the lower bound of bucket |i|, in milliseconds.
+    static int64 BucketMin(int i);
+
+    // Returns a dictionary with the "count", "sum_ms" and "max_ms" of the
+    // samples, and the "buckets" as a list of [min_ms, count] pairs, leaving
+    // out the empty ones. The caller takes ownership.
+    base::DictionaryValue* ToValue() const;
+
+   private:
+    int count_;
+    int64 sum_ms_;
+    int64 max_ms_;
+    int buckets_[kNumBuckets];
+  };
+
+  LoadTimingStats();
+  ~LoadTimingStats();
+
+  // Adds |sample| to the histogram of |phase|, and to the one of |host| for
+  // that phase unless |host| is empty.
+  void AddSample(Phase phase, const std::string& host, base::TimeDelta sample);
+
+  const Histogram& GetHistogram(Phase phase) const;
+
+  // Returns the histogram of |phase| for |host|, or NULL if no sample was
+  // recorded for |host| since it was last evicted.
+  const Histogram* GetHostHistogram(Phase phase,
+                                    const std::string& host) const;
+
+  void Reset();
+
+  // Returns a dictionary with the histograms of the "phases", and the ones
+  // of each host in "hosts". The caller takes ownership.
+  base::DictionaryValue* ToValue() const;
+
+ private:
+  struct HostStats {
+    Histogram phases[NUM_PHASES];
+  };
+  // Only the most recently used hosts are kept, to bound the memory.
+  typedef base::MRUCache<std::string, HostStats> HostStatsMap;
+
+  Histogram phases_[NUM_PHASES];
+  HostStatsMap hosts_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadTimingStats);
+};
+
+#endif  // CHROME_BROWSER_NET_LOAD_TIMING_STATS_H_
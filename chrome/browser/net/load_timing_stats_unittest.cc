@@ -0,0 +1,107 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/load_timing_stats.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "base/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using base::TimeDelta;
+
+TEST(LoadTimingStatsTest, HistogramBuckets) {
+  LoadTimingStats::Histogram histogram;
+  histogram.Add(TimeDelta::FromMicroseconds(500));
+  histogram.Add(TimeDelta::FromMilliseconds(1));
+  histogram.Add(TimeDelta::FromMilliseconds(3));
+  histogram.Add(TimeDelta::FromMilliseconds(4));
+  histogram.Add(TimeDelta::FromHours(1));
+
+  EXPECT_EQ(5, histogram.count());
+  EXPECT_EQ(1, histogram.bucket(0));
+  EXPECT_EQ(1, histogram.bucket(1));
+  EXPECT_EQ(1, histogram.bucket(2));
+  EXPECT_EQ(1, histogram.bucket(3));
+  EXPECT_EQ(1, histogram.bucket(LoadTimingStats::Histogram::kNumBuckets - 1));
+
+  EXPECT_EQ(0, LoadTimingStats::Histogram::BucketMin(0));
+  EXPECT_EQ(1, LoadTimingStats::Histogram::BucketMin(1));
+  EXPECT_EQ(4, LoadTimingStats::Histogram::BucketMin(3));
+}
+
+TEST(LoadTimingStatsTest, HistogramToValue) {
+  LoadTimingStats::Histogram histogram;
+  histogram.Add(TimeDelta::FromMilliseconds(3));
+  histogram.Add(TimeDelta::FromMilliseconds(5));
+
+  scoped_ptr<DictionaryValue> dict(histogram.ToValue());
+  int count = 0;
+  EXPECT_TRUE(dict->GetInteger("count", &count));
+  EXPECT_EQ(2, count);
+  double sum_ms = 0;
+  EXPECT_TRUE(dict->GetDouble("sum_ms", &sum_ms));
+  EXPECT_EQ(8, sum_ms);
+  double max_ms = 0;
+  EXPECT_TRUE(dict->GetDouble("max_ms", &max_ms));
+  EXPECT_EQ(5, max_ms);
+
+  // Only the non-empty buckets are listed.
+  ListValue* buckets = NULL;
+  ASSERT_TRUE(dict->GetList("buckets", &buckets));
+  ASSERT_EQ(2u, buckets->GetSize());
+  ListValue* bucket = NULL;
+  ASSERT_TRUE(buckets->GetList(1, &bucket));
+  double bucket_min = 0;
+  EXPECT_TRUE(bucket->GetDouble(0, &bucket_min));
+  EXPECT_EQ(4, bucket_min);
+}
+
+TEST(LoadTimingStatsTest, PerHost) {
+  LoadTimingStats stats;
+  stats.AddSample(LoadTimingStats::PHASE_DNS, "www.google.com",
+                  TimeDelta::FromMilliseconds(10));
+  stats.AddSample(LoadTimingStats::PHASE_DNS, "mail.google.com",
+                  TimeDelta::FromMilliseconds(10));
+  stats.AddSample(LoadTimingStats::PHASE_IO_THREAD_QUEUE, "",
+                  TimeDelta::FromMilliseconds(1));
+
+  EXPECT_EQ(2, stats.GetHistogram(LoadTimingStats::PHASE_DNS).count());
+  EXPECT_EQ(1,
+            stats.GetHistogram(LoadTimingStats::PHASE_IO_THREAD_QUEUE).count());
+  const LoadTimingStats::Histogram* histogram =
+      stats.GetHostHistogram(LoadTimingStats::PHASE_DNS, "www.google.com");
+  ASSERT_TRUE(histogram);
+  EXPECT_EQ(1, histogram->count());
+  EXPECT_FALSE(stats.GetHostHistogram(LoadTimingStats::PHASE_DNS, ""));
+
+  // Host names are not taken as paths.
+  scoped_ptr<DictionaryValue> dict(stats.ToValue());
+  DictionaryValue* hosts = NULL;
+  ASSERT_TRUE(dict->GetDictionary("hosts", &hosts));
+  EXPECT_EQ(2u, hosts->size());
+  EXPECT_TRUE(hosts->HasKey("www.google.com"));
+
+  stats.Reset();
+  EXPECT_EQ(0, stats.GetHistogram(LoadTimingStats::PHASE_DNS).count());
+  EXPECT_FALSE(
+      stats.GetHostHistogram(LoadTimingStats::PHASE_DNS, "www.google.com"));
+}
+
+TEST(LoadTimingStatsTest, HostsAreBounded) {
+  LoadTimingStats stats;
+  for (int i = 0; i < 1000; ++i) {
+    stats.AddSample(LoadTimingStats::PHASE_SSL,
+                    base::StringPrintf("host%d", i),
+                    TimeDelta::FromMilliseconds(1));
+  }
+
+  EXPECT_EQ(1000, stats.GetHistogram(LoadTimingStats::PHASE_SSL).count());
+  EXPECT_FALSE(stats.GetHostHistogram(LoadTimingStats::PHASE_SSL, "host0"));
+  EXPECT_TRUE(stats.GetHostHistogram(LoadTimingStats::PHASE_SSL, "host999"));
+}
+
+}  // namespace
@@ -0,0 +1,237 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/net_log_binary_logger.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/pickle.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/values.h"
+#include "chrome/browser/ui/webui/net_internals/net_internals_ui.h"
+
+namespace {
+
+// Identifies a binary capture, and its format version.  Bump the version
+// whenever the record layout changes.
+const char kMagic[] = "NetLogBinary";
+const int kVersion = 1;
+
+// Parameters of a converted event, already parsed from JSON.
+class ParsedParameters : public net::NetLog::EventParameters {
+ public:
+  explicit ParsedParameters(Value* value) : value_(value) {}
+
+  virtual Value* ToValue() const OVERRIDE {
+    return value_->DeepCopy();
+  }
+
+ private:
+  virtual ~ParsedParameters() {}
+
+  scoped_ptr<Value> value_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParsedParameters);
+};
+
+// Reads the size-prefixed pickle at |*offset| in |data| into |pickle|, and
+// advances |*offset| past it.  Returns false at the end of |data|, or if the
+// record is truncated.
+bool ReadPickle(const std::string& data, size_t* offset,
+                scoped_ptr<Pickle>* pickle) {
+  uint32 size;
+  if (data.size() - *offset < sizeof(size))
+    return false;
+  memcpy(&size, data.data() + *offset, sizeof(size));
+  *offset += sizeof(size);
+  if (data.size() - *offset < size)
+    return false;
+  pickle->reset(new Pickle(data.data() + *offset, size));
+  *offset += size;
+  // Pickle drops data whose header doesn't match |size|.
+  return (*pickle)->data() != NULL;
+}
+
+}  // namespace
+
+NetLogBinaryLogger::Entry::Entry(net::NetLog::EventType type,
+                                 const base::TimeTicks& time,
+                                 const net::NetLog::Source& source,
+                                 net::NetLog::EventPhase phase,
+                                 net::NetLog::EventParameters* params)
+    : type(type),
+      time(time),
+      source(source),
+      phase(phase),
+      params(params) {
+}
+
+NetLogBinaryLogger::Entry::~Entry() {
+}
+
+NetLogBinaryLogger::NetLogBinaryLogger(const FilePath& log_path,
+                                       net::NetLog::LogLevel log_level,
+                                       size_t ring_buffer_size)
+    : log_level_(log_level),
+      ring_buffer_size_(ring_buffer_size) {
+  DCHECK(!log_path.empty());
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  file_.Set(file_util::OpenFile(log_path, "wb"));
+  if (!file_.get()) {
+    LOG(ERROR) << "Could not open NetLog capture file";
+    return;
+  }
+
+  // As with NetLogLogger, the constants are captured so that the log can be
+  // loaded by other Chrome versions.
+  scoped_ptr<Value> value(NetInternalsUI::GetConstants());
+  std::string json;
+  base::JSONWriter::Write(value.get(), &json);
+
+  Pickle header;
+  header.WriteString(kMagic);
+  header.WriteInt(kVersion);
+  header.WriteString(json);
+  WritePickle(header);
+}
+
+NetLogBinaryLogger::~NetLogBinaryLogger() {
+  if (!file_.get())
+    return;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  for (std::deque<Entry>::const_iterator it = ring_buffer_.begin();
+       it != ring_buffer_.end(); ++it) {
+    WriteEntry(it->type, it->time, it->source, it->phase, it->params);
+  }
+}
+
+void NetLogBinaryLogger::StartObserving(net::NetLog* net_log) {
+  net_log->AddThreadSafeObserver(this, log_level_);
+}
+
+// static
+bool NetLogBinaryLogger::ConvertToJSON(const FilePath& binary_path,
+                                       const FilePath& json_path) {
+  std::string data;
+  if (!file_util::ReadFileToString(binary_path, &data))
+    return false;
+
+  size_t offset = 0;
+  scoped_ptr<Pickle> pickle;
+  if (!ReadPickle(data, &offset, &pickle))
+    return false;
+  PickleIterator header(*pickle);
+  std::string magic;
+  int version;
+  std::string constants;
+  if (!header.ReadString(&magic) || magic != kMagic ||
+      !header.ReadInt(&version) || version != kVersion ||
+      !header.ReadString(&constants)) {
+    return false;
+  }
+
+  ScopedStdioHandle file(file_util::OpenFile(json_path, "w"));
+  if (!file.get())
+    return false;
+  fprintf(file.get(), "{\"constants\": %s,\n", constants.c_str());
+  fprintf(file.get(), "\"events\": [\n");
+
+  bool first = true;
+  while (ReadPickle(data, &offset, &pickle)) {
+    PickleIterator iter(*pickle);
+    uint32 type;
+    uint32 source_type;
+    uint32 source_id;
+    uint32 phase;
+    int64 time;
+    bool has_params;
+    if (!iter.ReadUInt32(&type) || !iter.ReadUInt32(&source_type) ||
+        !iter.ReadUInt32(&source_id) || !iter.ReadUInt32(&phase) ||
+        !iter.ReadInt64(&time) || !iter.ReadBool(&has_params)) {
+      break;
+    }
+    scoped_refptr<net::NetLog::EventParameters> params;
+    if (has_params) {
+      std::string params_json;
+      if (!iter.ReadString(&params_json))
+        break;
+      Value* params_value = base::JSONReader::Read(params_json);
+      if (params_value)
+        params = new ParsedParameters(params_value);
+    }
+
+    scoped_ptr<Value> value(net::NetLog::EntryToDictionaryValue(
+        static_cast<net::NetLog::EventType>(type),
+        base::TimeTicks::FromInternalValue(time),
+        net::NetLog::Source(
+            static_cast<net::NetLog::SourceType>(source_type), source_id),
+        static_cast<net::NetLog::EventPhase>(phase),
+        params, false));
+    std::string json;
+    base::JSONWriter::Write(value.get(), &json);
+    fprintf(file.get(), "%s%s", first ? "" : ",\n", json.c_str());
+    first = false;
+  }
+
+  fprintf(file.get(), "\n]}\n");
+  return true;
+}
+
+void NetLogBinaryLogger::OnAddEntry(net::NetLog::EventType type,
+                                    const base::TimeTicks& time,
+                                    const net::NetLog::Source& source,
+                                    net::NetLog::EventPhase phase,
+                                    net::NetLog::EventParameters* params) {
+  if (!file_.get())
+    return;
+
+  if (ring_buffer_size_ == 0) {
+    WriteEntry(type, time, source, phase, params);
+    return;
+  }
+
+  if (ring_buffer_.size() == ring_buffer_size_)
+    ring_buffer_.pop_front();
+  ring_buffer_.push_back(Entry(type, time, source, phase, params));
+}
+
+void NetLogBinaryLogger::WriteEntry(net::NetLog::EventType type,
+                                    const base::TimeTicks& time,
+                                    const net::NetLog::Source& source,
+                                    net::NetLog::EventPhase phase,
+                                    net::NetLog::EventParameters* params) {
+  Pickle pickle;
+  pickle.WriteUInt32(static_cast<uint32>(type));
+  pickle.WriteUInt32(static_cast<uint32>(source.type));
+  pickle.WriteUInt32(source.id);
+  pickle.WriteUInt32(static_cast<uint32>(phase));
+  pickle.WriteInt64(time.ToInternalValue());
+
+  // This is the only place event parameters are evaluated.
+  scoped_ptr<Value> value;
+  if (params && log_level_ != net::NetLog::LOG_BASIC)
+    value.reset(params->ToValue());
+  pickle.WriteBool(value.get() != NULL);
+  if (value.get()) {
+    std::string json;
+    base::JSONWriter::Write(value.get(), &json);
+    pickle.WriteString(json);
+  }
+  WritePickle(pickle);
+}
+
+void NetLogBinaryLogger::WritePickle(const Pickle& pickle) {
+  uint32 size = static_cast<uint32>(pickle.size());
+  fwrite(&size, sizeof(size), 1, file_.get());
+  fwrite(pickle.data(), 1, pickle.size(), file_.get());
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_NET_NET_LOG_BINARY_LOGGER_H_
+#define CHROME_BROWSER_NET_NET_LOG_BINARY_LOGGER_H_
+#pragma once
+
+#include <deque>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_handle.h"
+#include "base/time.h"
+#include "net/base/net_log.h"
+
+class FilePath;
+class Pickle;
+
+// NetLogBinaryLogger is a low overhead alternative to NetLogLogger for
+// capturing NetLog events in production.  Instead of building and writing a
+// JSON object per event, it writes each event as a small binary record.
+//
+// Event parameters are evaluated lazily: at LOG_BASIC they are not recorded
+// at all, so EventParameters::ToValue() is never run.  In ring buffer mode,
+// only the last |ring_buffer_size| events are kept, and their parameters are
+// only serialized when the buffer is written out on destruction, so events
+// that fall out of the buffer cost next to nothing.
+//
+// ConvertToJSON() turns a capture into the JSON format NetLogLogger writes,
+// which can be loaded by about:net-internals.
+//
+// Relies on ChromeNetLog only calling an Observer once at a time for
+// thread-safety.
+class NetLogBinaryLogger : public net::NetLog::ThreadSafeObserver {
+ public:
+  // Writes to |log_path|, which must not be empty.  If |ring_buffer_size| is
+  // non-zero, only the last |ring_buffer_size| events are written, on
+  // destruction.  Otherwise events are written as they are observed.
+  NetLogBinaryLogger(const FilePath& log_path,
+                     net::NetLog::LogLevel log_level,
+                     size_t ring_buffer_size);
+  virtual ~NetLogBinaryLogger();
+
+  // Starts observing specified NetLog.  Must not already be watching a NetLog.
+  // Separate from constructor to enforce thread safety.
+  void StartObserving(net::NetLog* net_log);
+
+  // Converts the binary capture at |binary_path| into a JSON file at
+  // |json_path|.  Returns false if |binary_path| can't be read, is not a
+  // capture, or |json_path| can't be written.  A truncated capture is
+  // converted up to its last complete event.
+  static bool ConvertToJSON(const FilePath& binary_path,
+                            const FilePath& json_path);
+
+  // net::NetLog::ThreadSafeObserver implementation:
+  virtual void OnAddEntry(net::NetLog::EventType type,
+                          const base::TimeTicks& time,
+                          const net::NetLog::Source& source,
+                          net::NetLog::EventPhase phase,
+                          net::NetLog::EventParameters* params) OVERRIDE;
+
+ private:
+  // An event retained in ring buffer mode.
+  struct Entry {
+    Entry(net::NetLog::EventType type,
+          const base::TimeTicks& time,
+          const net::NetLog::Source& source,
+          net::NetLog::EventPhase phase,
+          net::NetLog::EventParameters* params);
+    ~Entry();
+
+    net::NetLog::EventType type;
+    base::TimeTicks time;
+    net::NetLog::Source source;
+    net::NetLog::EventPhase phase;
+    scoped_refptr<net::NetLog::EventParameters> params;
+  };
+
+  // Writes a single event record to |file_|.
+  void WriteEntry(net::NetLog::EventType type,
+                  const base::TimeTicks& time,
+                  const net::NetLog::Source& source,
+                  net::NetLog::EventPhase phase,
+                  net::NetLog::EventParameters* params);
+
+  // Writes |pickle| to |file_|, prefixed by its size.
+  void WritePickle(const Pickle& pickle);
+
+  ScopedStdioHandle file_;
+  const net::NetLog::LogLevel log_level_;
+  const size_t ring_buffer_size_;
+  std::deque<Entry> ring_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetLogBinaryLogger);
+};
+
+#endif  // CHROME_BROWSER_NET_NET_LOG_BINARY_LOGGER_H_
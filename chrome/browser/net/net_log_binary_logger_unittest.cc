@@ -0,0 +1,179 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/net_log_binary_logger.h"
+
+#include <string>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/scoped_temp_dir.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Parameters that count how often they are evaluated.
+class CountingParameters : public net::NetLog::EventParameters {
+ public:
+  explicit CountingParameters(int value) : value_(value), to_value_calls_(0) {}
+
+  virtual Value* ToValue() const OVERRIDE {
+    ++to_value_calls_;
+    DictionaryValue* dict = new DictionaryValue();
+    dict->SetInteger("value", value_);
+    return dict;
+  }
+
+  int to_value_calls() const { return to_value_calls_; }
+
+ private:
+  virtual ~CountingParameters() {}
+
+  const int value_;
+  mutable int to_value_calls_;
+};
+
+class NetLogBinaryLoggerTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    binary_path_ = temp_dir_.path().AppendASCII("net_log.bin");
+    json_path_ = temp_dir_.path().AppendASCII("net_log.json");
+  }
+
+  // Adds an event with a source ID of |id| to |logger|.
+  void AddEvent(NetLogBinaryLogger* logger, uint32 id,
+                net::NetLog::EventParameters* params) {
+    logger->OnAddEntry(
+        net::NetLog::TYPE_REQUEST_ALIVE, base::TimeTicks::Now(),
+        net::NetLog::Source(net::NetLog::SOURCE_URL_REQUEST, id),
+        net::NetLog::PHASE_BEGIN, params);
+  }
+
+  // Converts the capture to JSON, and returns its list of events.
+  scoped_ptr<ListValue> ConvertEvents() {
+    scoped_ptr<ListValue> events;
+    EXPECT_TRUE(NetLogBinaryLogger::ConvertToJSON(binary_path_, json_path_));
+    std::string json;
+    EXPECT_TRUE(file_util::ReadFileToString(json_path_, &json));
+    scoped_ptr<Value> root(base::JSONReader::Read(json));
+    DictionaryValue* dict;
+    ListValue* list;
+    if (root.get() && root->GetAsDictionary(&dict) &&
+        dict->HasKey("constants") && dict->GetList("events", &list)) {
+      events.reset(list->DeepCopy());
+    }
+    return events.Pass();
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath binary_path_;
+  FilePath json_path_;
+};
+
+TEST_F(NetLogBinaryLoggerTest, ConvertToJSON) {
+  scoped_refptr<CountingParameters> params(new CountingParameters(42));
+  {
+    NetLogBinaryLogger logger(binary_path_, net::NetLog::LOG_ALL_BUT_BYTES, 0);
+    AddEvent(&logger, 1, params);
+    AddEvent(&logger, 2, NULL);
+  }
+  EXPECT_EQ(1, params->to_value_calls());
+
+  scoped_ptr<ListValue> events(ConvertEvents());
+  ASSERT_TRUE(events.get());
+  ASSERT_EQ(2U, events->GetSize());
+
+  DictionaryValue* event;
+  ASSERT_TRUE(events->GetDictionary(0, &event));
+  int value;
+  EXPECT_TRUE(event->GetInteger("source.id", &value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(event->GetInteger("type", &value));
+  EXPECT_EQ(net::NetLog::TYPE_REQUEST_ALIVE, value);
+  EXPECT_TRUE(event->GetInteger("phase", &value));
+  EXPECT_EQ(net::NetLog::PHASE_BEGIN, value);
+  EXPECT_TRUE(event->GetInteger("params.value", &value));
+  EXPECT_EQ(42, value);
+
+  ASSERT_TRUE(events->GetDictionary(1, &event));
+  EXPECT_TRUE(event->GetInteger("source.id", &value));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(event->HasKey("params"));
+}
+
+// At LOG_BASIC, parameters are never evaluated.
+TEST_F(NetLogBinaryLoggerTest, BasicSkipsParameters) {
+  scoped_refptr<CountingParameters> params(new CountingParameters(42));
+  {
+    NetLogBinaryLogger logger(binary_path_, net::NetLog::LOG_BASIC, 0);
+    AddEvent(&logger, 1, params);
+  }
+  EXPECT_EQ(0, params->to_value_calls());
+
+  scoped_ptr<ListValue> events(ConvertEvents());
+  ASSERT_TRUE(events.get());
+  ASSERT_EQ(1U, events->GetSize());
+  DictionaryValue* event;
+  ASSERT_TRUE(events->GetDictionary(0, &event));
+  EXPECT_FALSE(event->HasKey("params"));
+}
+
+// In ring buffer mode, only the most recent events are written, and only
+// their parameters are evaluated.
+TEST_F(NetLogBinaryLoggerTest, RingBuffer) {
+  scoped_refptr<CountingParameters> dropped_params(new CountingParameters(1));
+  scoped_refptr<CountingParameters> kept_params(new CountingParameters(2));
+  {
+    NetLogBinaryLogger logger(binary_path_, net::NetLog::LOG_ALL_BUT_BYTES, 2);
+    AddEvent(&logger, 1, dropped_params);
+    AddEvent(&logger, 2, kept_params);
+    AddEvent(&logger, 3, NULL);
+    EXPECT_EQ(0, kept_params->to_value_calls());
+  }
+  EXPECT_EQ(0, dropped_params->to_value_calls());
+  EXPECT_EQ(1, kept_params->to_value_calls());
+
+  scoped_ptr<ListValue> events(ConvertEvents());
+  ASSERT_TRUE(events.get());
+  ASSERT_EQ(2U, events->GetSize());
+  DictionaryValue* event;
+  int value;
+  ASSERT_TRUE(events->GetDictionary(0, &event));
+  EXPECT_TRUE(event->GetInteger("source.id", &value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(events->GetDictionary(1, &event));
+  EXPECT_TRUE(event->GetInteger("source.id", &value));
+  EXPECT_EQ(3, value);
+}
+
+// A capture cut short, e.g. by a crash, converts up to its last full event.
+TEST_F(NetLogBinaryLoggerTest, Truncated) {
+  {
+    NetLogBinaryLogger logger(binary_path_, net::NetLog::LOG_ALL_BUT_BYTES, 0);
+    AddEvent(&logger, 1, NULL);
+    AddEvent(&logger, 2, NULL);
+  }
+  std::string data;
+  ASSERT_TRUE(file_util::ReadFileToString(binary_path_, &data));
+  data.resize(data.size() - 1);
+  ASSERT_EQ(static_cast<int>(data.size()),
+            file_util::WriteFile(binary_path_, data.data(), data.size()));
+
+  scoped_ptr<ListValue> events(ConvertEvents());
+  ASSERT_TRUE(events.get());
+  EXPECT_EQ(1U, events->GetSize());
+}
+
+TEST_F(NetLogBinaryLoggerTest, NotACapture) {
+  const char kData[] = "{\"constants\": {}}";
+  ASSERT_EQ(static_cast<int>(sizeof(kData)),
+            file_util::WriteFile(binary_path_, kData, sizeof(kData)));
+  EXPECT_FALSE(NetLogBinaryLogger::ConvertToJSON(binary_path_, json_path_));
+}
+
+}  // namespace
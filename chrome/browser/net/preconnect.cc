@@ -4,14 +4,18 @@
 
 #include "chrome/browser/net/preconnect.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "content/public/browser/browser_thread.h"
+#include "net/base/host_port_pair.h"
 #include "net/base/net_log.h"
 #include "net/base/ssl_config_service.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_request_info.h"
+#include "net/http/http_server_properties.h"
 #include "net/http/http_stream_factory.h"
 #include "net/http/http_transaction_factory.h"
 #include "net/url_request/url_request_context.h"
@@ -47,14 +51,31 @@ void PreconnectOnIOThread(
   }
   if (!getter)
     return;
-  // We are now commited to doing the async preconnection call.
-  UMA_HISTOGRAM_ENUMERATION("Net.PreconnectMotivation", motivation,
-                            UrlInfo::MAX_MOTIVATED);
 
   net::URLRequestContext* context = getter->GetURLRequestContext();
   net::HttpTransactionFactory* factory = context->http_transaction_factory();
   net::HttpNetworkSession* session = factory->GetSession();
 
+  // Open as many connections as the server needed the last time, except for
+  // SPDY servers, which only ever need one.
+  net::HttpServerProperties* http_server_properties =
+      session->http_server_properties();
+  if (http_server_properties) {
+    net::HostPortPair origin(url.host(), url.EffectiveIntPort());
+    if (http_server_properties->SupportsSpdy(origin)) {
+      count = 1;
+    } else {
+      count = std::max(count,
+                       http_server_properties->GetConnectionDemand(origin));
+    }
+  }
+  if (count <= 0)
+    return;
+
+  // We are now commited to doing the async preconnection call.
+  UMA_HISTOGRAM_ENUMERATION("Net.PreconnectMotivation", motivation,
+                            UrlInfo::MAX_MOTIVATED);
+
   net::HttpRequestInfo request_info;
   request_info.url = url;
   request_info.method = "GET";
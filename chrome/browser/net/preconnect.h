@@ -29,7 +29,9 @@ void PreconnectOnUIThread(const GURL& url,
 
 // Try to preconnect.  Typically used by predictor when a subresource probably
 // needs a connection. |count| may be used to request more than one connection
-// be established in parallel.
+// be established in parallel. It is raised to the number of connections that
+// the server needed at once in the past, as recorded in HttpServerProperties,
+// unless the server supports SPDY, in which case a single connection is made.
 void PreconnectOnIOThread(const GURL& url,
                           UrlInfo::ResolutionMotivation motivation,
                           int count,
@@ -51,6 +51,9 @@ using content::BrowserThread;
 // that single domain key (eTLD+1)'s cookies, and posts a Backend::
 // CompleteLoadForKeyOnIOThread to the IO thread to notify the caller of
 // SQLitePersistentCookieStore::LoadCookiesForKey that that load is complete.
+// Only the cookies of that key are passed back, so that a request blocked on
+// its domain does not also wait for the IO thread to take in every cookie
+// the chain load has read so far.
 //
 // Subsequent to loading, mutations may be queued by any thread using
 // AddCookie, UpdateCookieAccessTime, and DeleteCookie. These are flushed to
@@ -128,19 +131,21 @@ class SQLitePersistentCookieStore::Backend
     net::CookieMonster::CanonicalCookie cc_;
   };
 
+  typedef std::list<PendingOperation*> PendingOperationsList;
+
  private:
   // Creates or loads the SQLite database on DB thread.
   void LoadAndNotifyOnDBThread(const LoadedCallback& loaded_callback,
                                const base::Time& posted_at);
 
   // Loads cookies for the domain key (eTLD+1) on DB thread.
-  void LoadKeyAndNotifyOnDBThread(const std::string& domains,
+  void LoadKeyAndNotifyOnDBThread(const std::string& key,
                                   const LoadedCallback& loaded_callback,
                                   const base::Time& posted_at);
 
-  // Notifies the CookieMonster when loading completes for a specific domain key
-  // or for all domain keys. Triggers the callback and passes it all cookies
-  // that have been loaded from DB since last IO notification.
+  // Notifies the CookieMonster when loading completes for all domain keys.
+  // Triggers the callback and passes it all cookies that have been loaded from
+  // DB since last IO notification.
   void Notify(const LoadedCallback& loaded_callback, bool load_success);
 
   // Sends notification when the entire store is loaded, and reports metrics
@@ -149,9 +154,13 @@ class SQLitePersistentCookieStore::Backend
   void CompleteLoadOnIOThread(const LoadedCallback& loaded_callback,
                               bool load_success);
 
-  // Sends notification when a single priority load completes. Updates priority
-  // load metric data. The data is sent only after the final load completes.
-  void CompleteLoadForKeyOnIOThread(const LoadedCallback& loaded_callback,
+  // Sends notification when a single priority load completes, passing the
+  // cookies of |key| that have not been sent yet. Updates priority load metric
+  // data. The data is sent only after the final load completes.
+  // |requested_at| is when LoadCookiesForKey was called.
+  void CompleteLoadForKeyOnIOThread(const std::string& key,
+                                    const LoadedCallback& loaded_callback,
+                                    const base::Time& requested_at,
                                     bool load_success);
 
   // Sends all metrics, including posting a ReportMetricsOnDBThread task.
@@ -170,12 +179,16 @@ class SQLitePersistentCookieStore::Backend
   // domains are loaded).
   void ChainLoadCookies(const LoadedCallback& loaded_callback);
 
-  // Load all cookies for a set of domains/hosts
-  bool LoadCookiesForDomains(const std::set<std::string>& key);
+  // Load all cookies for a set of domains/hosts under the domain key |key|.
+  bool LoadCookiesForDomains(const std::string& key,
+                             const std::set<std::string>& domains);
 
   // Batch a cookie operation (add or delete)
   void BatchOperation(PendingOperation::OperationType op,
                       const net::CookieMonster::CanonicalCookie& cc);
+  // Removes the operations of |ops| that later operations on the same cookie
+  // make redundant, and folds access time updates into pending additions.
+  static void CoalesceOperations(PendingOperationsList* ops);
   // Commit our pending operations to the database.
   void Commit();
   // Close() executed on the background thread.
@@ -187,7 +200,6 @@ class SQLitePersistentCookieStore::Backend
   scoped_ptr<sql::Connection> db_;
   sql::MetaTable meta_table_;
 
-  typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
   // True if the persistent store should be deleted upon destruction.
@@ -195,10 +207,14 @@ class SQLitePersistentCookieStore::Backend
   // Guard |cookies_|, |pending_|, |num_pending_|, |clear_local_state_on_exit_|
   base::Lock lock_;
 
-  // Temporary buffer for cookies loaded from DB. Accumulates cookies to reduce
-  // the number of messages sent to the IO thread. Sent back in response to
-  // individual load requests for domain keys or when all loading completes.
-  std::vector<net::CookieMonster::CanonicalCookie*> cookies_;
+  // Temporary buffer for cookies loaded from DB, by domain key. Accumulates
+  // cookies to reduce the number of messages sent to the IO thread. The
+  // cookies of a key are sent back in response to a load request for that key,
+  // and all the others when all loading completes.
+  typedef std::map<std::string,
+                   std::vector<net::CookieMonster::CanonicalCookie*> >
+      KeyedCookies;
+  KeyedCookies cookies_;
 
   // Map of domain keys(eTLD+1) to domains/hosts that are to be loaded from DB.
   std::map<std::string, std::set<std::string> > keys_to_load_;
@@ -374,7 +390,7 @@ void SQLitePersistentCookieStore::Backend::LoadKeyAndNotifyOnDBThread(
     std::map<std::string, std::set<std::string> >::iterator
       it = keys_to_load_.find(key);
     if (it != keys_to_load_.end()) {
-      success = LoadCookiesForDomains(it->second);
+      success = LoadCookiesForDomains(key, it->second);
       keys_to_load_.erase(it);
     } else {
       success = true;
@@ -385,13 +401,36 @@ void SQLitePersistentCookieStore::Backend::LoadKeyAndNotifyOnDBThread(
     BrowserThread::IO, FROM_HERE,
     base::Bind(
         &SQLitePersistentCookieStore::Backend::CompleteLoadForKeyOnIOThread,
-        this, loaded_callback, success));
+        this, key, loaded_callback, posted_at, success));
 }
 
 void SQLitePersistentCookieStore::Backend::CompleteLoadForKeyOnIOThread(
+    const std::string& key,
     const LoadedCallback& loaded_callback,
+    const base::Time& requested_at,
     bool load_success) {
-  Notify(loaded_callback, load_success);
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  std::vector<net::CookieMonster::CanonicalCookie*> cookies;
+  {
+    base::AutoLock locked(lock_);
+    KeyedCookies::iterator it = cookies_.find(key);
+    if (it != cookies_.end()) {
+      cookies.swap(it->second);
+      cookies_.erase(it);
+    }
+  }
+
+  UMA_HISTOGRAM_CUSTOM_TIMES(
+      "Cookie.TimeKeyLoadBlocked",
+      base::Time::Now() - requested_at,
+      base::TimeDelta::FromMilliseconds(1), base::TimeDelta::FromMinutes(1),
+      50);
+  UMA_HISTOGRAM_COUNTS_10000(
+      "Cookie.NumberOfCookiesPerKeyLoad",
+      cookies.size());
+
+  loaded_callback.Run(cookies);
 
   {
     base::AutoLock locked(metrics_lock_);
@@ -450,7 +489,11 @@ void SQLitePersistentCookieStore::Backend::Notify(
   std::vector<net::CookieMonster::CanonicalCookie*> cookies;
   {
     base::AutoLock locked(lock_);
-    cookies.swap(cookies_);
+    for (KeyedCookies::iterator it = cookies_.begin(); it != cookies_.end();
+         ++it) {
+      cookies.insert(cookies.end(), it->second.begin(), it->second.end());
+    }
+    cookies_.clear();
   }
 
   loaded_callback.Run(cookies);
@@ -479,6 +522,9 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
   }
 
   db_.reset(new sql::Connection);
+  // Commits are frequent and small; appending them to a write-ahead log is
+  // cheaper than rewriting the pages and a rollback journal each time.
+  db_->set_write_ahead_logging();
   if (!db_->Open(path_)) {
     NOTREACHED() << "Unable to open cookie DB.";
     db_.reset();
@@ -548,7 +594,7 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
     // Load cookies for the first domain key.
     std::map<std::string, std::set<std::string> >::iterator
       it = keys_to_load_.begin();
-    load_success = LoadCookiesForDomains(it->second);
+    load_success = LoadCookiesForDomains(it->first, it->second);
     keys_to_load_.erase(it);
   }
 
@@ -570,6 +616,7 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
 }
 
 bool SQLitePersistentCookieStore::Backend::LoadCookiesForDomains(
+  const std::string& key,
   const std::set<std::string>& domains) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
 
@@ -624,7 +671,9 @@ bool SQLitePersistentCookieStore::Backend::LoadCookiesForDomains(
   }
   {
     base::AutoLock locked(lock_);
-    cookies_.insert(cookies_.end(), cookies.begin(), cookies.end());
+    std::vector<net::CookieMonster::CanonicalCookie*>& key_cookies =
+        cookies_[key];
+    key_cookies.insert(key_cookies.end(), cookies.begin(), cookies.end());
   }
   return true;
 }
@@ -721,6 +770,7 @@ bool SQLitePersistentCookieStore::Backend::EnsureDatabaseVersion() {
 
     meta_table_.Reset();
     db_.reset(new sql::Connection);
+    db_->set_write_ahead_logging();
     if (!file_util::Delete(path_, false) ||
         !db_->Open(path_) ||
         !meta_table_.Init(
@@ -784,6 +834,82 @@ void SQLitePersistentCookieStore::Backend::BatchOperation(
   }
 }
 
+// static
+void SQLitePersistentCookieStore::Backend::CoalesceOperations(
+    PendingOperationsList* ops) {
+  // Cookies are identified by their creation time, the primary key. For each
+  // cookie: its last pending addition or access update, whether its row is
+  // first created by |ops|, and whether |ops| deletes it last.
+  std::map<int64, PendingOperationsList::iterator> writes;
+  std::set<int64> seen;
+  std::set<int64> added;
+  std::set<int64> deleted;
+
+  for (PendingOperationsList::iterator it = ops->begin(); it != ops->end();) {
+    int64 key = (*it)->cc().CreationDate().ToInternalValue();
+    bool first = seen.insert(key).second;
+    std::map<int64, PendingOperationsList::iterator>::iterator write =
+        writes.find(key);
+
+    switch ((*it)->op()) {
+      case PendingOperation::COOKIE_ADD:
+        if (write != writes.end()) {
+          delete *write->second;
+          ops->erase(write->second);
+        }
+        if (first)
+          added.insert(key);
+        deleted.erase(key);
+        writes[key] = it++;
+        break;
+
+      case PendingOperation::COOKIE_UPDATEACCESS:
+        if (write != writes.end() &&
+            (*write->second)->op() == PendingOperation::COOKIE_ADD) {
+          // Add the cookie with its latest access time.
+          PendingOperation* add =
+              new PendingOperation(PendingOperation::COOKIE_ADD, (*it)->cc());
+          delete *write->second;
+          *write->second = add;
+          delete *it;
+          it = ops->erase(it);
+        } else if (write != writes.end()) {
+          delete *write->second;
+          ops->erase(write->second);
+          writes[key] = it++;
+        } else if (deleted.count(key)) {
+          // The row is gone by then.
+          delete *it;
+          it = ops->erase(it);
+        } else {
+          writes[key] = it++;
+        }
+        break;
+
+      case PendingOperation::COOKIE_DELETE:
+        if (write != writes.end()) {
+          delete *write->second;
+          ops->erase(write->second);
+          writes.erase(write);
+        }
+        if (added.erase(key)) {
+          // The row was never written.
+          delete *it;
+          it = ops->erase(it);
+        } else {
+          deleted.insert(key);
+          ++it;
+        }
+        break;
+
+      default:
+        NOTREACHED();
+        ++it;
+        break;
+    }
+  }
+}
+
 void SQLitePersistentCookieStore::Backend::Commit() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
 
@@ -798,6 +924,8 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   if (!db_.get() || ops.empty())
     return;
 
+  CoalesceOperations(&ops);
+
   sql::Statement add_smt(db_->GetCachedStatement(SQL_FROM_HERE,
       "INSERT INTO cookies (creation_utc, host_key, name, value, path, "
       "expires_utc, secure, httponly, last_access_utc, has_expires, "
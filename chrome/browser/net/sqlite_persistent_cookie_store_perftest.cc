@@ -114,3 +114,33 @@ TEST_F(SQLitePersistentCookieStorePerfTest, TestLoadPerformance) {
 
   ASSERT_EQ(15000U, cookies_.size());
 }
+
+// Test the performance of committing a batch in which the same cookies are
+// repeatedly touched, added and deleted, as session cookies tend to be.
+TEST_F(SQLitePersistentCookieStorePerfTest, TestCommitPerformance) {
+  Load();
+  ASSERT_EQ(15000U, cookies_.size());
+
+  PerfTimeLogger timer("Commit coalesced cookie updates");
+  base::Time t = base::Time::Now();
+  for (int round = 0; round < 20; ++round) {
+    for (size_t i = 0; i < 50; ++i) {
+      net::CookieMonster::CanonicalCookie* cc = cookies_[i];
+      t += base::TimeDelta::FromInternalValue(10);
+      cc->SetLastAccessDate(t);
+      store_->UpdateCookieAccessTime(*cc);
+    }
+    GURL gurl("www.transient.com");
+    net::CookieMonster::CanonicalCookie transient(gurl, "Transient", "1",
+        ".transient.com", "/", std::string(), std::string(),
+        t, t, t, false, false, true);
+    store_->AddCookie(transient);
+    store_->DeleteCookie(transient);
+  }
+  store_->Flush(base::Closure());
+  scoped_refptr<base::ThreadTestHelper> helper(
+      new base::ThreadTestHelper(
+          BrowserThread::GetMessageLoopProxyForThread(BrowserThread::DB)));
+  ASSERT_TRUE(helper->Run());
+  timer.Done();
+}
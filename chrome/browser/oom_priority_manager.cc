@@ -24,6 +24,10 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/low_memory_observer.h"
 #include "chrome/browser/memory_details.h"
+#include "chrome/browser/prerender/prerender_manager.h"
+#include "chrome/browser/prerender/prerender_manager_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/tabs/tab_strip_model.h"
 #include "chrome/browser/ui/browser_list.h"
 #include "chrome/browser/ui/tab_contents/tab_contents_wrapper.h"
@@ -225,6 +229,31 @@ void OomPriorityManager::LogMemoryAndDiscardTab() {
   details->StartFetch(MemoryDetails::SKIP_USER_METRICS);
 }
 
+void OomPriorityManager::HandleLowMemory() {
+  if (CancelPrerenders()) {
+    LOG(WARNING) << "Cancelled prerenders to free memory";
+    return;
+  }
+  LogMemoryAndDiscardTab();
+}
+
+bool OomPriorityManager::CancelPrerenders() {
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  if (!profile_manager)
+    return false;
+  bool cancelled = false;
+  std::vector<Profile*> profiles = profile_manager->GetLoadedProfiles();
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    prerender::PrerenderManager* prerender_manager =
+        prerender::PrerenderManagerFactory::GetForProfile(profiles[i]);
+    if (prerender_manager &&
+        prerender_manager->CancelPrerendersForMemoryPressure()) {
+      cancelled = true;
+    }
+  }
+  return cancelled;
+}
+
 bool OomPriorityManager::DiscardTabById(int64 target_web_contents_id) {
   for (BrowserList::const_iterator browser_iterator = BrowserList::begin();
        browser_iterator != BrowserList::end(); ++browser_iterator) {
@@ -55,6 +55,11 @@ class OomPriorityManager : public content::NotificationObserver {
   // multiple threads and takes time.
   void LogMemoryAndDiscardTab();
 
+  // Called when the kernel signals low memory. Prerenders are cancelled first
+  // since the user loses nothing they can see; a tab is discarded only when
+  // there were none.
+  void HandleLowMemory();
+
  private:
   FRIEND_TEST_ALL_PREFIXES(OomPriorityManagerTest, Comparator);
 
@@ -74,6 +79,10 @@ class OomPriorityManager : public content::NotificationObserver {
   // Discards a tab with the given unique ID.  Returns true if discard occurred.
   bool DiscardTabById(int64 target_web_contents_id);
 
+  // Cancels the prerenders of every loaded profile. Returns true if any were
+  // cancelled.
+  bool CancelPrerenders();
+
   // Records UMA histogram statistics for a tab discard. We record statistics
   // for user triggered discards via chrome://discards/ because that allows us
   // to manually test the system.
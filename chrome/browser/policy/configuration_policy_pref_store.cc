@@ -9,7 +9,9 @@
 
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/string16.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/policy/browser_policy_connector.h"
@@ -111,6 +113,7 @@ ConfigurationPolicyPrefStore::~ConfigurationPolicyPrefStore() {
 }
 
 void ConfigurationPolicyPrefStore::Refresh() {
+  base::TimeTicks start_time = base::TimeTicks::Now();
   scoped_ptr<PrefValueMap> new_prefs(CreatePreferencesFromPolicies());
   std::vector<std::string> changed_prefs;
   new_prefs->GetDifferingKeys(prefs_.get(), &changed_prefs);
@@ -123,6 +126,11 @@ void ConfigurationPolicyPrefStore::Refresh() {
     FOR_EACH_OBSERVER(PrefStore::Observer, observers_,
                       OnPrefValueChanged(*pref));
   }
+
+  // Observers run synchronously, so this is the time the UI thread spent
+  // applying the refresh.
+  UMA_HISTOGRAM_TIMES("Enterprise.PolicyPrefRefreshTime",
+                      base::TimeTicks::Now() - start_time);
 }
 
 PrefValueMap* ConfigurationPolicyPrefStore::CreatePreferencesFromPolicies() {
@@ -11,6 +11,7 @@
 #include "base/logging.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
+#include "chrome/browser/prefs/scoped_user_pref_update.h"
 #include "chrome/browser/sync/api/sync_change.h"
 #include "chrome/browser/sync/api/sync_error_factory.h"
 #include "chrome/common/chrome_notification_types.h"
@@ -119,6 +120,9 @@ SyncError PrefModelAssociator::MergeDataAndStartSyncing(
   sync_processor_ = sync_processor.Pass();
   sync_error_factory_ = sync_error_factory.Pass();
 
+  // Observers hear about each merged preference once, after all of them have
+  // been applied.
+  ScopedPrefUpdateBatch batch(pref_service_);
   SyncChangeList new_changes;
   std::set<std::string> remaining_preferences = registered_preferences_;
 
@@ -303,6 +307,7 @@ SyncError PrefModelAssociator::ProcessSyncChanges(
     return error;
   }
   AutoReset<bool> processing_changes(&processing_syncer_changes_, true);
+  ScopedPrefUpdateBatch batch(pref_service_);
   SyncChangeList::const_iterator iter;
   for (iter = change_list.begin(); iter != change_list.end(); ++iter) {
     DCHECK_EQ(PREFERENCES, iter->sync_data().GetDataType());
@@ -11,15 +11,18 @@
 #include "content/public/browser/notification_service.h"
 
 PrefNotifierImpl::PrefNotifierImpl()
-    : pref_service_(NULL) {
+    : pref_service_(NULL),
+      batch_depth_(0) {
 }
 
 PrefNotifierImpl::PrefNotifierImpl(PrefService* service)
-    : pref_service_(service) {
+    : pref_service_(service),
+      batch_depth_(0) {
 }
 
 PrefNotifierImpl::~PrefNotifierImpl() {
   DCHECK(CalledOnValidThread());
+  DCHECK_EQ(0, batch_depth_);
 
   // Verify that there are no pref observers when we shut down.
   for (PrefObserverMap::iterator it = pref_observers_.begin();
@@ -76,6 +79,11 @@ void PrefNotifierImpl::RemovePrefObserver(const char* path,
 }
 
 void PrefNotifierImpl::OnPreferenceChanged(const std::string& path) {
+  if (batch_depth_ > 0) {
+    if (batched_path_set_.insert(path).second)
+      batched_paths_.push_back(path);
+    return;
+  }
   FireObservers(path);
 }
 
@@ -113,3 +121,25 @@ void PrefNotifierImpl::SetPrefService(PrefService* pref_service) {
   DCHECK(pref_service_ == NULL);
   pref_service_ = pref_service;
 }
+
+void PrefNotifierImpl::BeginBatch() {
+  DCHECK(CalledOnValidThread());
+  ++batch_depth_;
+}
+
+void PrefNotifierImpl::EndBatch() {
+  DCHECK(CalledOnValidThread());
+  DCHECK_GT(batch_depth_, 0);
+  if (--batch_depth_ > 0)
+    return;
+
+  // Observers may change prefs again, which notifies them directly now that
+  // the batch is closed.
+  std::vector<std::string> paths;
+  paths.swap(batched_paths_);
+  batched_path_set_.clear();
+  for (std::vector<std::string>::const_iterator path = paths.begin();
+       path != paths.end(); ++path) {
+    FireObservers(*path);
+  }
+}
@@ -6,7 +6,9 @@
 #define CHROME_BROWSER_PREFS_PREF_NOTIFIER_IMPL_H_
 #pragma once
 
+#include <set>
 #include <string>
+#include <vector>
 
 #include "base/hash_tables.h"
 #include "base/observer_list.h"
@@ -38,6 +40,12 @@ class PrefNotifierImpl : public PrefNotifier,
 
   void SetPrefService(PrefService* pref_service);
 
+  // Between BeginBatch() and the matching EndBatch(), change notifications
+  // are held back. The outermost EndBatch() fires the observers of each
+  // changed path once, in the order the paths first changed. Batches nest.
+  void BeginBatch();
+  void EndBatch();
+
  protected:
   // A map from pref names to a list of observers. Observers get fired in the
   // order they are added. These should only be accessed externally for unit
@@ -58,6 +66,14 @@ class PrefNotifierImpl : public PrefNotifier,
 
   PrefObserverMap pref_observers_;
 
+  // Number of open batches.
+  int batch_depth_;
+
+  // Paths that changed during the current batch, in order of first change.
+  // |batched_path_set_| holds the same paths for quick duplicate checks.
+  std::vector<std::string> batched_paths_;
+  std::set<std::string> batched_path_set_;
+
   DISALLOW_COPY_AND_ASSIGN(PrefNotifierImpl);
 };
 
@@ -78,6 +78,28 @@ TEST_F(PrefNotifierTest, OnPreferenceChanged) {
   notifier.OnPreferenceChanged(kChangedPref);
 }
 
+TEST_F(PrefNotifierTest, Batch) {
+  MockPrefNotifier notifier(&pref_service_);
+  EXPECT_CALL(notifier, FireObservers(_)).Times(0);
+  notifier.BeginBatch();
+  notifier.OnPreferenceChanged(kChangedPref);
+  notifier.BeginBatch();
+  notifier.OnPreferenceChanged(kUnchangedPref);
+  notifier.OnPreferenceChanged(kChangedPref);
+  notifier.EndBatch();
+  Mock::VerifyAndClearExpectations(&notifier);
+
+  // Each path fires once, in the order it first changed.
+  testing::InSequence sequence;
+  EXPECT_CALL(notifier, FireObservers(kChangedPref)).Times(1);
+  EXPECT_CALL(notifier, FireObservers(kUnchangedPref)).Times(1);
+  notifier.EndBatch();
+  Mock::VerifyAndClearExpectations(&notifier);
+
+  EXPECT_CALL(notifier, FireObservers(kChangedPref)).Times(1);
+  notifier.OnPreferenceChanged(kChangedPref);
+}
+
 TEST_F(PrefNotifierTest, OnInitializationCompleted) {
   MockPrefNotifier notifier(&pref_service_);
   content::NotificationObserverMock observer;
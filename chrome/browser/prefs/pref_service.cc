@@ -891,6 +891,16 @@ void PrefService::ReportUserPrefChanged(const std::string& key) {
   user_pref_store_->ReportValueChanged(key);
 }
 
+void PrefService::BeginUpdateBatch() {
+  DCHECK(CalledOnValidThread());
+  pref_notifier_->BeginBatch();
+}
+
+void PrefService::EndUpdateBatch() {
+  DCHECK(CalledOnValidThread());
+  pref_notifier_->EndBatch();
+}
+
 void PrefService::SetUserPrefValue(const char* path, Value* new_value) {
   scoped_ptr<Value> owned_value(new_value);
   DCHECK(CalledOnValidThread());
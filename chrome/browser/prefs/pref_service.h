@@ -31,6 +31,7 @@ class PrefNotifierImpl;
 class PrefStore;
 class PrefValueStore;
 class Profile;
+class ScopedPrefUpdateBatch;
 class SyncableService;
 
 namespace content {
@@ -356,6 +357,14 @@ class PrefService : public base::NonThreadSafe {
   // Give access to ReportUserPrefChanged() and GetMutableUserPref().
   friend class subtle::ScopedUserPrefUpdateBase;
 
+  // Give access to BeginUpdateBatch() and EndUpdateBatch().
+  friend class ScopedPrefUpdateBatch;
+
+  // Holds back pref change notifications until the matching
+  // EndUpdateBatch(), then sends one per changed pref.
+  void BeginUpdateBatch();
+  void EndUpdateBatch();
+
   // Sends notification of a changed preference. This needs to be called by
   // a ScopedUserPrefUpdate if a DictionaryValue or ListValue is changed.
   void ReportUserPrefChanged(const std::string& key);
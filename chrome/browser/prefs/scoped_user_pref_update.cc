@@ -34,3 +34,12 @@ void ScopedUserPrefUpdateBase::Notify() {
 }
 
 }  // namespace subtle
+
+ScopedPrefUpdateBatch::ScopedPrefUpdateBatch(PrefService* service)
+    : service_(service) {
+  service_->BeginUpdateBatch();
+}
+
+ScopedPrefUpdateBatch::~ScopedPrefUpdateBatch() {
+  service_->EndUpdateBatch();
+}
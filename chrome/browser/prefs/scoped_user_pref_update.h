@@ -99,6 +99,26 @@ class ScopedUserPrefUpdate : public subtle::ScopedUserPrefUpdateBase {
   DISALLOW_COPY_AND_ASSIGN(ScopedUserPrefUpdate);
 };
 
+// Coalesces the change notifications of |service| for as long as it is in
+// scope. Observers of a pref that changed any number of times are notified
+// once when the outermost batch goes away. Use it around bulk updates, such
+// as applying a set of synced preferences, so observers don't react to each
+// intermediate state.
+//
+// This class may only be used on the UI thread as it requires access to the
+// PrefService.
+class ScopedPrefUpdateBatch {
+ public:
+  explicit ScopedPrefUpdateBatch(PrefService* service);
+  ~ScopedPrefUpdateBatch();
+
+ private:
+  // Weak pointer.
+  PrefService* service_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedPrefUpdateBatch);
+};
+
 typedef ScopedUserPrefUpdate<base::DictionaryValue, Value::TYPE_DICTIONARY>
     DictionaryPrefUpdate;
 typedef ScopedUserPrefUpdate<base::ListValue, Value::TYPE_LIST> ListPrefUpdate;
@@ -54,6 +54,7 @@ enum FinalStatus {
   FINAL_STATUS_DUPLICATE = 39,
   FINAL_STATUS_OPEN_URL = 40,
   FINAL_STATUS_WOULD_HAVE_BEEN_USED = 41,
+  FINAL_STATUS_MEMORY_PRESSURE = 42,
   FINAL_STATUS_MAX,
 };
 
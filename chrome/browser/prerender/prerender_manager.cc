@@ -327,6 +327,17 @@ void PrerenderManager::CancelOmniboxPrerenders() {
   }
 }
 
+bool PrerenderManager::CancelPrerendersForMemoryPressure() {
+  DCHECK(CalledOnValidThread());
+  bool had_prerenders = !prerender_list_.empty();
+  while (!prerender_list_.empty()) {
+    PrerenderContentsData data = prerender_list_.front();
+    DCHECK(data.contents_);
+    data.contents_->Destroy(FINAL_STATUS_MEMORY_PRESSURE);
+  }
+  return had_prerenders;
+}
+
 bool PrerenderManager::MaybeUsePrerenderedPage(WebContents* web_contents,
                                                const GURL& url) {
   DCHECK(CalledOnValidThread());
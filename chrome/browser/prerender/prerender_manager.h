@@ -125,6 +125,10 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
   // Cancels all active prerenders with the ORIGIN_OMNIBOX origin.
   void CancelOmniboxPrerenders();
 
+  // Cancels all active prerenders because the system is low on memory.
+  // Returns true if there were any to cancel.
+  bool CancelPrerendersForMemoryPressure();
+
   // If |url| matches a valid prerendered page, try to swap it into
   // |web_contents| and merge browsing histories. Returns |true| if a
   // prerendered page is swapped in, |false| otherwise.
@@ -16,6 +16,7 @@
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/content_settings/cookie_settings.h"
 #include "chrome/browser/content_settings/host_content_settings_map.h"
@@ -54,6 +55,8 @@
 #include "net/proxy/proxy_script_fetcher_impl.h"
 #include "net/proxy/proxy_service.h"
 #include "net/url_request/url_request.h"
+#include "net/url_request/url_request_replay_archive.h"
+#include "net/url_request/url_request_replay_job.h"
 
 #if defined(OS_CHROMEOS)
 #include "chrome/browser/chromeos/cros_settings.h"
@@ -520,6 +523,22 @@ void ProfileIOData::LazyInitialize() const {
       chrome::kChromeDevToolsScheme,
       CreateDevToolsProtocolHandler(chrome_url_data_manager_backend_.get()));
   DCHECK(set_protocol);
+  if (command_line.HasSwitch(switches::kReplayArchive)) {
+    // Benchmark-only switch; the archive must be in memory before the first
+    // request can be answered.
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    scoped_refptr<net::URLRequestReplayArchive> archive(
+        new net::URLRequestReplayArchive);
+    archive->Load(command_line.GetSwitchValuePath(switches::kReplayArchive));
+    set_protocol = job_factory_->SetProtocolHandler(
+        chrome::kHttpScheme,
+        new net::URLRequestReplayProtocolHandler(archive, true));
+    DCHECK(set_protocol);
+    set_protocol = job_factory_->SetProtocolHandler(
+        chrome::kHttpsScheme,
+        new net::URLRequestReplayProtocolHandler(archive, true));
+    DCHECK(set_protocol);
+  }
 #if defined(OS_CHROMEOS) && !defined(GOOGLE_CHROME_BUILD)
   // Install the GView request interceptor that will redirect requests
   // of compatible documents (PDF, etc) to the GView document viewer.
@@ -653,6 +653,8 @@ bool SafeBrowsingDatabaseNew::ContainsBrowseUrl(
   // Used to double-check in case of a hit mis-match.
   std::vector<SBPrefix> restored;
 
+  const base::Time miss_expire_time =
+      base::Time::Now() - base::TimeDelta::FromMinutes(kMaxStalenessMinutes);
   size_t miss_count = 0;
   for (size_t i = 0; i < full_hashes.size(); ++i) {
     bool found = prefix_set_->Exists(full_hashes[i].prefix);
@@ -662,7 +664,9 @@ bool SafeBrowsingDatabaseNew::ContainsBrowseUrl(
       if (found)
         RecordPrefixSetInfo(PREFIX_SET_EVENT_HIT);
       prefix_hits->push_back(full_hashes[i].prefix);
-      if (prefix_miss_cache_.count(full_hashes[i].prefix) > 0)
+      PrefixMissCache::const_iterator miss =
+          prefix_miss_cache_.find(full_hashes[i].prefix);
+      if (miss != prefix_miss_cache_.end() && miss_expire_time < miss->second)
         ++miss_count;
     } else {
       // Bloom filter misses should never be in prefix set.  Re-create
@@ -953,6 +957,8 @@ void SafeBrowsingDatabaseNew::InsertChunks(const std::string& list_name,
   if (!store) return;
 
   change_detected_ = true;
+  if (store == browse_store_.get())
+    browse_change_detected_ = true;
 
   store->BeginChunk();
   if (chunks.front().is_add) {
@@ -979,6 +985,8 @@ void SafeBrowsingDatabaseNew::DeleteChunks(
   if (!store) return;
 
   change_detected_ = true;
+  if (store == browse_store_.get())
+    browse_change_detected_ = true;
 
   for (size_t i = 0; i < chunk_deletes.size(); ++i) {
     std::vector<int> chunk_numbers;
@@ -1000,7 +1008,9 @@ void SafeBrowsingDatabaseNew::CacheHashResults(
   base::AutoLock locked(lookup_lock_);
 
   if (full_hits.empty()) {
-    prefix_miss_cache_.insert(prefixes.begin(), prefixes.end());
+    const base::Time now = base::Time::Now();
+    for (size_t i = 0; i < prefixes.size(); ++i)
+      prefix_miss_cache_[prefixes[i]] = now;
     return;
   }
 
@@ -1096,6 +1106,7 @@ bool SafeBrowsingDatabaseNew::UpdateStarted(
 
   corruption_detected_ = false;
   change_detected_ = false;
+  browse_change_detected_ = false;
   return true;
 }
 
@@ -1146,8 +1157,17 @@ void SafeBrowsingDatabaseNew::UpdateFinished(bool update_succeeded) {
 
   // for download
   UpdateDownloadStore();
-  // for browsing
-  UpdateBrowseStore();
+  // for browsing.  Rebuilding the filter and prefix set reads the whole
+  // store, so skip it when the update only touched other lists.
+  bool have_pending_hashes;
+  {
+    base::AutoLock locked(lookup_lock_);
+    have_pending_hashes = !pending_browse_hashes_.empty();
+  }
+  if (browse_change_detected_ || have_pending_hashes)
+    UpdateBrowseStore();
+  else
+    browse_store_->CancelUpdate();
   // for csd and download whitelists.
   UpdateWhitelistStore(csd_whitelist_filename_,
                        csd_whitelist_store_.get(),
@@ -1253,9 +1273,18 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
 
   const base::Time before = base::Time::Now();
 
+  std::set<SBPrefix> prefix_misses;
+  {
+    base::AutoLock locked(lookup_lock_);
+    for (PrefixMissCache::const_iterator iter = prefix_miss_cache_.begin();
+         iter != prefix_miss_cache_.end(); ++iter) {
+      prefix_misses.insert(prefix_misses.end(), iter->first);
+    }
+  }
+
   SBAddPrefixes add_prefixes;
   std::vector<SBAddFullHash> add_full_hashes;
-  if (!browse_store_->FinishUpdate(pending_add_hashes, prefix_miss_cache_,
+  if (!browse_store_->FinishUpdate(pending_add_hashes, prefix_misses,
                                    &add_prefixes, &add_full_hashes)) {
     RecordFailure(FAILURE_BROWSE_DATABASE_UPDATE_FINISH);
     return;
@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_SAFE_BROWSING_SAFE_BROWSING_DATABASE_H_
 #pragma once
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -361,9 +362,11 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   std::vector<SBAddFullHash> pending_browse_hashes_;
 
   // Cache of prefixes that returned empty results (no full hash
-  // match) to |CacheHashResults()|.  Cached to prevent asking for
-  // them every time.  Cleared on next update.
-  std::set<SBPrefix> prefix_miss_cache_;
+  // match) to |CacheHashResults()|, with the time each was received.
+  // Cached to prevent asking for them every time.  Entries expire
+  // like cached full hashes do, and are cleared on next update.
+  typedef std::map<SBPrefix, base::Time> PrefixMissCache;
+  PrefixMissCache prefix_miss_cache_;
 
   // Used to schedule resetting the database because of corruption.
   base::WeakPtrFactory<SafeBrowsingDatabaseNew> reset_factory_;
@@ -377,6 +380,10 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   // Used to optimize away database update.
   bool change_detected_;
 
+  // Set to true if chunks are added to or deleted from |browse_store_|
+  // during an update.  Used to skip rebuilding the browse filter.
+  bool browse_change_detected_;
+
   // Used to check if a prefix was in the database.
   scoped_ptr<safe_browsing::PrefixSet> prefix_set_;
 };
@@ -979,6 +979,18 @@ TEST_F(SafeBrowsingDatabaseTest, HashCaching) {
   prefixes.clear();
   full_hashes.clear();
 
+  // Once the miss is older than the cache lifetime it no longer hides the
+  // prefix.
+  database_->prefix_miss_cache_[Sha256Prefix("www.evil.com/phishing.html")] =
+      base::Time::Now() - base::TimeDelta::FromMinutes(60);
+  EXPECT_TRUE(database_->ContainsBrowseUrl(
+      GURL("http://www.evil.com/phishing.html"),
+      &listname, &prefixes,
+      &full_hashes, Time::Now()));
+
+  prefixes.clear();
+  full_hashes.clear();
+
   // Test receiving a full add chunk.
   chunk.hosts.clear();
   InsertAddChunkHost2FullHashes(&chunk, 20, "www.fullevil.com/",
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_service.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/callback.h"
@@ -70,6 +72,11 @@ const int64 kDownloadUrlCheckTimeoutMs = 10000;
 // Similar to kDownloadUrlCheckTimeoutMs, but for download hash checks.
 const int64 kDownloadHashCheckTimeoutMs = 10000;
 
+// Browse checks that need a GetHash within this long of each other share one
+// request. A page load often hits several prefixes from its subresources at
+// once, and serializing their round trips delays the navigation.
+const int64 kGetHashBatchDelayMs = 10;
+
 // Records disposition information about the check.  |hit| should be
 // |true| if there were any prefix hits in |full_hashes|.
 void RecordGetHashCheckStatus(
@@ -744,6 +751,8 @@ void SafeBrowsingService::StopOnIOThread() {
   STLDeleteElements(&checks_);
 
   gethash_requests_.clear();
+  pending_gethash_checks_.clear();
+  gethash_batches_.clear();
 }
 
 bool SafeBrowsingService::DatabaseAvailable() const {
@@ -856,7 +865,13 @@ void SafeBrowsingService::OnCheckDone(SafeBrowsingCheck* check) {
     // Reset the start time so that we can measure the network time without the
     // database time.
     check->start = base::TimeTicks::Now();
-    protocol_manager_->GetFullHash(check, check->prefix_hits);
+    if (pending_gethash_checks_.empty()) {
+      BrowserThread::PostDelayedTask(
+          BrowserThread::IO, FROM_HERE,
+          base::Bind(&SafeBrowsingService::IssueGetHashRequests, this),
+          kGetHashBatchDelayMs);
+    }
+    pending_gethash_checks_.push_back(check);
   } else {
     // We may have cached results for previous GetHash queries.  Since
     // this data comes from cache, don't histogram hits.
@@ -864,6 +879,45 @@ void SafeBrowsingService::OnCheckDone(SafeBrowsingCheck* check) {
   }
 }
 
+void SafeBrowsingService::IssueGetHashRequests() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  if (!enabled_ || pending_gethash_checks_.empty())
+    return;
+
+  GetHashRequestors checks;
+  checks.swap(pending_gethash_checks_);
+  UMA_HISTOGRAM_COUNTS_100("SB2.GetHashBatchSize", checks.size());
+
+  if (checks.size() == 1) {
+    protocol_manager_->GetFullHash(checks[0], checks[0]->prefix_hits);
+    return;
+  }
+
+  // Ask for the union of the prefixes on behalf of a check which stands for
+  // the whole batch. OnHandleGetHashResults() hands the response to each
+  // member.
+  SafeBrowsingCheck* batch = new SafeBrowsingCheck();
+  batch->client = NULL;
+  batch->result = SAFE;
+  batch->is_download = false;
+  batch->need_get_hash = true;
+  batch->start = checks[0]->start;
+  for (size_t i = 0; i < checks.size(); ++i) {
+    batch->prefix_hits.insert(batch->prefix_hits.end(),
+                              checks[i]->prefix_hits.begin(),
+                              checks[i]->prefix_hits.end());
+  }
+  std::sort(batch->prefix_hits.begin(), batch->prefix_hits.end());
+  batch->prefix_hits.erase(
+      std::unique(batch->prefix_hits.begin(), batch->prefix_hits.end()),
+      batch->prefix_hits.end());
+  checks_.insert(batch);
+  gethash_batches_[batch].swap(checks);
+
+  protocol_manager_->GetFullHash(batch, batch->prefix_hits);
+}
+
 void SafeBrowsingService::GetAllChunksFromDatabase() {
   DCHECK_EQ(MessageLoop::current(), safe_browsing_thread_->message_loop());
 
@@ -1045,6 +1099,25 @@ void SafeBrowsingService::OnHandleGetHashResults(
     SafeBrowsingCheck* check,
     const std::vector<SBFullHashResult>& full_hashes) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  GetHashBatches::iterator batch = gethash_batches_.find(check);
+  if (batch == gethash_batches_.end()) {
+    HandleGetHashResultsForCheck(check, full_hashes);
+    return;
+  }
+
+  GetHashRequestors checks;
+  checks.swap(batch->second);
+  gethash_batches_.erase(batch);
+  checks_.erase(check);
+  delete check;
+  for (size_t i = 0; i < checks.size(); ++i)
+    HandleGetHashResultsForCheck(checks[i], full_hashes);
+}
+
+void SafeBrowsingService::HandleGetHashResultsForCheck(
+    SafeBrowsingCheck* check,
+    const std::vector<SBFullHashResult>& full_hashes) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   bool is_download = check->is_download;
   SBPrefix prefix = check->prefix_hits[0];
   GetHashRequests::iterator it = gethash_requests_.find(prefix);
@@ -325,6 +325,7 @@ class SafeBrowsingService
   typedef std::set<SafeBrowsingCheck*> CurrentChecks;
   typedef std::vector<SafeBrowsingCheck*> GetHashRequestors;
   typedef base::hash_map<SBPrefix, GetHashRequestors> GetHashRequests;
+  typedef std::map<SafeBrowsingCheck*, GetHashRequestors> GetHashBatches;
 
   // Used for whitelisting a render view when the user ignores our warning.
   struct WhiteListedEntry;
@@ -380,6 +381,9 @@ class SafeBrowsingService
   // Called on the IO thread with the check result.
   void OnCheckDone(SafeBrowsingCheck* info);
 
+  // Sends one GetHash request for all of |pending_gethash_checks_|.
+  void IssueGetHashRequests();
+
   // Called on the database thread to retrieve chunks.
   void GetAllChunksFromDatabase();
 
@@ -428,10 +432,17 @@ class SafeBrowsingService
   void CacheHashResults(const std::vector<SBPrefix>& prefixes,
                         const std::vector<SBFullHashResult>& full_hashes);
 
-  // Internal worker function for processing full hashes.
+  // Internal worker function for processing full hashes. |check| may stand
+  // for a batch, in which case each of its members is handled.
   void OnHandleGetHashResults(SafeBrowsingCheck* check,
                               const std::vector<SBFullHashResult>& full_hashes);
 
+  // Handles |full_hashes| for a single check and any checks waiting on the
+  // same prefix.
+  void HandleGetHashResultsForCheck(
+      SafeBrowsingCheck* check,
+      const std::vector<SBFullHashResult>& full_hashes);
+
   // Run one check against |full_hashes|.  Returns |true| if the check
   // finds a match in |full_hashes|.
   bool HandleOneCheck(SafeBrowsingCheck* check,
@@ -501,6 +512,14 @@ class SafeBrowsingService
   // Used for issuing only one GetHash request for a given prefix.
   GetHashRequests gethash_requests_;
 
+  // Browse checks waiting for the batching window to close before their
+  // GetHash request is sent.
+  GetHashRequestors pending_gethash_checks_;
+
+  // Checks sent together in one GetHash request, keyed by the check that
+  // stands for the batch.
+  GetHashBatches gethash_batches_;
+
   // The persistent database.  We don't use a scoped_ptr because it
   // needs to be destructed on a different thread than this object.
   SafeBrowsingDatabase* database_;
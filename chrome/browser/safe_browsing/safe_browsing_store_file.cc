@@ -567,6 +567,20 @@ bool SafeBrowsingStoreFile::DoUpdate(
   }
   DCHECK(!file_.get());
 
+  // If this store took no part in the update, the file on disk is already
+  // what would be written.  Hand back its contents without rewriting it.
+  if (chunks_written_ == 0 && add_del_cache_.empty() &&
+      sub_del_cache_.empty() && pending_adds.empty()) {
+    SBCheckPrefixMisses(add_prefixes, prefix_misses);
+    new_file_.reset();
+    file_util::Delete(TemporaryFileForFilename(filename_), false);
+    UMA_HISTOGRAM_COUNTS("SB2.AddPrefixes", add_prefixes.size());
+    UMA_HISTOGRAM_COUNTS("SB2.SubPrefixes", sub_prefixes.size());
+    add_prefixes_result->swap(add_prefixes);
+    add_full_hashes_result->swap(add_full_hashes);
+    return true;
+  }
+
   // Rewind the temporary storage.
   if (!FileRewind(new_file_.get()))
     return false;
@@ -97,6 +97,8 @@
 //   - Rewind and write the buffers out to temp file.
 //   - Delete original file.
 //   - Rename temp file to original filename.
+// If no chunks were written or deleted and there are no pending adds,
+// the original file is left untouched and only read.
 
 // TODO(shess): By using a checksum, this code can avoid doing an
 // fsync(), at the possible cost of more frequently retrieving the
@@ -131,6 +131,31 @@ TEST_F(SafeBrowsingStoreFileTest, DetectsCorruption) {
   EXPECT_TRUE(corruption_detected_);
 }
 
+// Test that an update which doesn't touch the store returns its
+// contents and leaves the file as it was.
+TEST_F(SafeBrowsingStoreFileTest, EmptyUpdateKeepsFile) {
+  SafeBrowsingStoreTestStorePrefix(store_.get());
+
+  std::string orig_contents;
+  ASSERT_TRUE(file_util::ReadFileToString(filename_, &orig_contents));
+
+  std::vector<SBAddFullHash> pending_adds;
+  std::set<SBPrefix> prefix_misses;
+  SBAddPrefixes add_prefixes;
+  std::vector<SBAddFullHash> add_hashes;
+  EXPECT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, prefix_misses,
+                                   &add_prefixes, &add_hashes));
+  EXPECT_GT(add_prefixes.size(), 0U);
+  EXPECT_GT(add_hashes.size(), 0U);
+
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(filename_, &contents));
+  EXPECT_EQ(orig_contents, contents);
+  EXPECT_FALSE(file_util::PathExists(
+      SafeBrowsingStoreFile::TemporaryFileForFilename(filename_)));
+}
+
 TEST_F(SafeBrowsingStoreFileTest, CheckValidity) {
   // Empty store is valid.
   EXPECT_FALSE(file_util::PathExists(filename_));
@@ -18,6 +18,7 @@
 #include "base/platform_file.h"
 #include "base/stl_util.h"
 #include "base/stringprintf.h"
+#include "base/sys_info.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/profiles/profile.h"
@@ -66,11 +67,35 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// Bounds on the number of tabs loading at once, before adjusting for memory.
+static const int kMinConcurrentTabLoads = 2;
+static const int kMaxConcurrentTabLoads = 6;
+
+// Machines with less physical memory than this get half as many concurrent
+// loads.
+static const int kLowMemoryMB = 1024;
+
+// Once the force load delay has grown this long the tabs that are loading are
+// assumed to be stuck, and the limit on concurrent loads no longer applies.
+static const int kStalledLoadDelayMS = 6400;
+
+// Returns how many restored tabs may load at once on this machine.
+size_t GetMaxConcurrentTabLoads() {
+  int loads = std::max(kMinConcurrentTabLoads,
+                       std::min(kMaxConcurrentTabLoads,
+                                base::SysInfo::NumberOfProcessors()));
+  if (base::SysInfo::AmountOfPhysicalMemoryMB() < kLowMemoryMB)
+    loads = std::max(1, loads / 2);
+  return static_cast<size_t>(loads);
+}
+
 // TabLoader is responsible for loading tabs after session restore creates
 // tabs. New tabs are loaded after the current tab finishes loading, or a delay
 // is reached (initially kInitialDelayTimerMS). If the delay is reached before
 // a tab finishes loading a new tab is loaded and the time of the delay
-// doubled.
+// doubled. No more than GetMaxConcurrentTabLoads() tabs load at once unless
+// the delay has grown past kStalledLoadDelayMS. Tabs the user selects load
+// right away regardless.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -110,9 +135,10 @@ class TabLoader : public content::NotificationObserver,
   explicit TabLoader(base::TimeTicks restore_started);
   virtual ~TabLoader();
 
-  // Loads the next tab. If there are no more tabs to load this deletes itself,
-  // otherwise |force_load_timer_| is restarted.
-  void LoadNextTab();
+  // Loads the next tab, unless |max_concurrent_tab_loads_| tabs are already
+  // loading and |ignore_limit| is false. If there are no more tabs to load
+  // this deletes itself, otherwise |force_load_timer_| is restarted.
+  void LoadNextTab(bool ignore_limit);
 
   // NotificationObserver method. Removes the specified tab and loads the next
   // tab.
@@ -178,6 +204,13 @@ class TabLoader : public content::NotificationObserver,
   // Max number of tabs that were loaded in parallel (for metrics).
   size_t max_parallel_tab_loads_;
 
+  // Number of tabs allowed to load in parallel.
+  const size_t max_concurrent_tab_loads_;
+
+  // Number of times a load was held back by |max_concurrent_tab_loads_| (for
+  // metrics).
+  int throttled_tab_loads_;
+
   // For keeping TabLoader alive while it's loading even if no
   // SessionRestoreImpls reference it.
   scoped_refptr<TabLoader> this_retainer_;
@@ -224,13 +257,13 @@ void TabLoader::StartLoading() {
 #if defined(OS_CHROMEOS)
   if (!net::NetworkChangeNotifier::IsOffline()) {
     loading_ = true;
-    LoadNextTab();
+    LoadNextTab(false);
   } else {
     net::NetworkChangeNotifier::AddOnlineStateObserver(this);
   }
 #else
   loading_ = true;
-  LoadNextTab();
+  LoadNextTab(false);
 #endif
 }
 
@@ -240,7 +273,9 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
       got_first_paint_(false),
       tab_count_(0),
       restore_started_(restore_started),
-      max_parallel_tab_loads_(0) {
+      max_parallel_tab_loads_(0),
+      max_concurrent_tab_loads_(GetMaxConcurrentTabLoads()),
+      throttled_tab_loads_(0) {
 }
 
 TabLoader::~TabLoader() {
@@ -250,8 +285,12 @@ TabLoader::~TabLoader() {
   shared_tab_loader = NULL;
 }
 
-void TabLoader::LoadNextTab() {
-  if (!tabs_to_load_.empty()) {
+void TabLoader::LoadNextTab(bool ignore_limit) {
+  if (!tabs_to_load_.empty() && !ignore_limit &&
+      tabs_loading_.size() >= max_concurrent_tab_loads_) {
+    // A load finishing or the force load timer will try again.
+    ++throttled_tab_loads_;
+  } else if (!tabs_to_load_.empty()) {
     NavigationController* tab = tabs_to_load_.front();
     DCHECK(tab);
     tabs_loading_.insert(tab);
@@ -373,7 +412,7 @@ void TabLoader::OnOnlineStateChanged(bool online) {
   if (online) {
     if (!loading_) {
       loading_ = true;
-      LoadNextTab();
+      LoadNextTab(false);
     }
   } else {
     loading_ = false;
@@ -400,7 +439,7 @@ void TabLoader::RemoveTab(NavigationController* tab) {
 
 void TabLoader::ForceLoadTimerFired() {
   force_load_delay_ *= 2;
-  LoadNextTab();
+  LoadNextTab(force_load_delay_ >= kStalledLoadDelayMS);
 }
 
 RenderWidgetHost* TabLoader::GetRenderWidgetHost(NavigationController* tab) {
@@ -427,7 +466,7 @@ void TabLoader::RegisterForNotifications(NavigationController* controller) {
 void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
   RemoveTab(tab);
   if (loading_)
-    LoadNextTab();
+    LoadNextTab(false);
   if (tabs_loading_.empty() && tabs_to_load_.empty()) {
     base::TimeDelta time_to_load =
         base::TimeTicks::Now() - restore_started_;
@@ -451,6 +490,8 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
 
     UMA_HISTOGRAM_COUNTS_100("SessionRestore.ParallelTabLoads",
                              max_parallel_tab_loads_);
+    UMA_HISTOGRAM_COUNTS_1000("SessionRestore.ThrottledTabLoads",
+                              throttled_tab_loads_);
   }
 }
 
@@ -5,6 +5,7 @@
 #include "chrome/browser/sessions/session_service.h"
 
 #include <algorithm>
+#include <limits>
 #include <set>
 #include <utility>
 #include <vector>
@@ -75,6 +76,9 @@ static const SessionCommand::id_type kCommandWindowClosed = 17;
 // Every kWritesPerReset commands triggers recreating the file.
 static const int kWritesPerReset = 250;
 
+// Upper bound on the serialized navigations kept for reuse by resets.
+static const size_t kMaxNavigationCommandCacheBytes = 4 * 1024 * 1024;
+
 namespace {
 
 // The callback from GetLastSession is internally routed to SessionService
@@ -192,8 +196,18 @@ bool MigrateClosedPayload(const SessionCommand& command,
 
 // SessionService -------------------------------------------------------------
 
+SessionService::CachedNavigationCommand::CachedNavigationCommand()
+    : unique_id(0) {
+}
+
+SessionService::CachedNavigationCommand::~CachedNavigationCommand() {
+}
+
 SessionService::SessionService(Profile* profile)
     : BaseSessionService(SESSION_RESTORE, profile, FilePath()),
+      navigation_command_cache_bytes_(0),
+      navigation_command_cache_hits_(0),
+      navigation_command_cache_misses_(0),
       has_open_trackable_browsers_(false),
       move_on_new_browser_(false),
       save_delay_in_millis_(base::TimeDelta::FromMilliseconds(2500)),
@@ -205,6 +219,9 @@ SessionService::SessionService(Profile* profile)
 
 SessionService::SessionService(const FilePath& save_path)
     : BaseSessionService(SESSION_RESTORE, NULL, save_path),
+      navigation_command_cache_bytes_(0),
+      navigation_command_cache_hits_(0),
+      navigation_command_cache_misses_(0),
       has_open_trackable_browsers_(false),
       move_on_new_browser_(false),
       save_delay_in_millis_(base::TimeDelta::FromMilliseconds(2500)),
@@ -279,6 +296,8 @@ void SessionService::TabClosed(const SessionID& window_id,
   if (!tab_id.id())
     return;  // Hapens when the tab is replaced.
 
+  RemoveCachedNavigationCommands(tab_id.id());
+
   if (!ShouldTrackChangesToWindow(window_id))
     return;
 
@@ -384,6 +403,8 @@ void SessionService::SetWindowAppName(
 void SessionService::TabNavigationPathPrunedFromBack(const SessionID& window_id,
                                                      const SessionID& tab_id,
                                                      int count) {
+  RemoveCachedNavigationCommands(tab_id.id());
+
   if (!ShouldTrackChangesToWindow(window_id))
     return;
 
@@ -401,6 +422,9 @@ void SessionService::TabNavigationPathPrunedFromFront(
     const SessionID& window_id,
     const SessionID& tab_id,
     int count) {
+  // Pruning from the front shifts the index of every remaining navigation.
+  RemoveCachedNavigationCommands(tab_id.id());
+
   if (!ShouldTrackChangesToWindow(window_id))
     return;
 
@@ -427,6 +451,8 @@ void SessionService::UpdateTabNavigation(
     const SessionID& tab_id,
     int index,
     const NavigationEntry& entry) {
+  RemoveCachedNavigationCommand(tab_id.id(), index);
+
   if (!ShouldTrackEntry(entry.GetVirtualURL()) ||
       !ShouldTrackChangesToWindow(window_id)) {
     return;
@@ -438,8 +464,10 @@ void SessionService::UpdateTabNavigation(
     range.first = std::min(index, range.first);
     range.second = std::max(index, range.second);
   }
-  ScheduleCommand(CreateUpdateTabNavigationCommand(kCommandUpdateTabNavigation,
-                                                   tab_id.id(), index, entry));
+  SessionCommand* command = CreateUpdateTabNavigationCommand(
+      kCommandUpdateTabNavigation, tab_id.id(), index, entry);
+  CacheNavigationCommand(tab_id.id(), index, entry, *command);
+  ScheduleCommand(command);
 }
 
 void SessionService::TabRestored(TabContentsWrapper* tab, bool pinned) {
@@ -1234,10 +1262,18 @@ void SessionService::BuildCommandsForTab(
         tab->web_contents()->GetController().GetPendingEntry() :
         tab->web_contents()->GetController().GetEntryAtIndex(i);
     DCHECK(entry);
-    if (ShouldTrackEntry(entry->GetVirtualURL())) {
+    if (!ShouldTrackEntry(entry->GetVirtualURL()))
+      continue;
+    if (i == pending_index) {
+      // The pending entry isn't committed yet and may still change without
+      // notification, so it is never cached.
       commands->push_back(
           CreateUpdateTabNavigationCommand(
               kCommandUpdateTabNavigation, session_id.id(), i, *entry));
+    } else {
+      commands->push_back(
+          CreateUpdateTabNavigationCommandForReset(session_id.id(), i,
+                                                   *entry));
     }
   }
   commands->push_back(
@@ -1321,13 +1357,91 @@ void SessionService::BuildCommandsFromBrowsers(
   }
 }
 
+SessionCommand* SessionService::CreateUpdateTabNavigationCommandForReset(
+    SessionID::id_type tab_id,
+    int index,
+    const NavigationEntry& entry) {
+  NavigationCommandCache::const_iterator cached =
+      navigation_command_cache_.find(std::make_pair(tab_id, index));
+  if (cached != navigation_command_cache_.end() &&
+      cached->second.unique_id == entry.GetUniqueID()) {
+    ++navigation_command_cache_hits_;
+    const SessionCommand& command = *cached->second.command;
+    SessionCommand* copy = new SessionCommand(command.id(), command.size());
+    if (command.size())
+      memcpy(copy->contents(), command.contents(), command.size());
+    return copy;
+  }
+
+  ++navigation_command_cache_misses_;
+  SessionCommand* command = CreateUpdateTabNavigationCommand(
+      kCommandUpdateTabNavigation, tab_id, index, entry);
+  CacheNavigationCommand(tab_id, index, entry, *command);
+  return command;
+}
+
+void SessionService::CacheNavigationCommand(SessionID::id_type tab_id,
+                                            int index,
+                                            const NavigationEntry& entry,
+                                            const SessionCommand& command) {
+  RemoveCachedNavigationCommand(tab_id, index);
+  // Changes to a pending entry are reported with an index of -1.
+  if (index < 0 ||
+      navigation_command_cache_bytes_ + command.size() >
+          kMaxNavigationCommandCacheBytes) {
+    return;
+  }
+
+  CachedNavigationCommand& cached =
+      navigation_command_cache_[std::make_pair(tab_id, index)];
+  cached.unique_id = entry.GetUniqueID();
+  cached.command.reset(new SessionCommand(command.id(), command.size()));
+  if (command.size())
+    memcpy(cached.command->contents(), command.contents(), command.size());
+  navigation_command_cache_bytes_ += command.size();
+}
+
+void SessionService::RemoveCachedNavigationCommand(SessionID::id_type tab_id,
+                                                   int index) {
+  NavigationCommandCache::iterator cached =
+      navigation_command_cache_.find(std::make_pair(tab_id, index));
+  if (cached == navigation_command_cache_.end())
+    return;
+  navigation_command_cache_bytes_ -= cached->second.command->size();
+  navigation_command_cache_.erase(cached);
+}
+
+void SessionService::RemoveCachedNavigationCommands(
+    SessionID::id_type tab_id) {
+  NavigationCommandCache::iterator i = navigation_command_cache_.lower_bound(
+      std::make_pair(tab_id, std::numeric_limits<int>::min()));
+  while (i != navigation_command_cache_.end() && i->first.first == tab_id) {
+    navigation_command_cache_bytes_ -= i->second.command->size();
+    navigation_command_cache_.erase(i++);
+  }
+}
+
 void SessionService::ScheduleReset() {
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  navigation_command_cache_hits_ = 0;
+  navigation_command_cache_misses_ = 0;
+
   set_pending_reset(true);
   STLDeleteElements(&pending_commands());
   tab_to_available_range_.clear();
   windows_tracking_.clear();
   BuildCommandsFromBrowsers(&pending_commands(), &tab_to_available_range_,
                             &windows_tracking_);
+
+  UMA_HISTOGRAM_TIMES("SessionRestore.ResetTime",
+                      base::TimeTicks::Now() - start_time);
+  int navigations =
+      navigation_command_cache_hits_ + navigation_command_cache_misses_;
+  if (navigations) {
+    UMA_HISTOGRAM_PERCENTAGE("SessionRestore.ResetNavigationsReused",
+                             navigation_command_cache_hits_ * 100 /
+                                 navigations);
+  }
   if (!windows_tracking_.empty()) {
     // We're lazily created on startup and won't get an initial batch of
     // SetWindowType messages. Set these here to make sure our state is correct.
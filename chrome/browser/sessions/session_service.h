@@ -11,6 +11,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback.h"
+#include "base/memory/linked_ptr.h"
 #include "base/time.h"
 #include "chrome/browser/defaults.h"
 #include "chrome/browser/sessions/base_session_service.h"
@@ -195,6 +196,20 @@ class SessionService : public BaseSessionService,
   typedef std::map<SessionID::id_type, SessionTab*> IdToSessionTab;
   typedef std::map<SessionID::id_type, SessionWindow*> IdToSessionWindow;
 
+  // A kCommandUpdateTabNavigation command kept around so that the next reset
+  // can copy it instead of serializing the NavigationEntry again.
+  struct CachedNavigationCommand {
+    CachedNavigationCommand();
+    ~CachedNavigationCommand();
+
+    // NavigationEntry::GetUniqueID() of the entry |command| was built from.
+    int unique_id;
+    linked_ptr<SessionCommand> command;
+  };
+  // Keyed by tab id and navigation index.
+  typedef std::map<std::pair<SessionID::id_type, int>,
+                   CachedNavigationCommand> NavigationCommandCache;
+
 
   // These types mirror Browser::Type, but are re-defined here because these
   // specific enumeration _values_ are written into the session database and
@@ -345,6 +360,26 @@ class SessionService : public BaseSessionService,
       IdToRange* tab_to_available_range,
       std::set<SessionID::id_type>* windows_to_track);
 
+  // Returns a kCommandUpdateTabNavigation command for |entry|, copied from
+  // |navigation_command_cache_| if the entry hasn't changed since it was last
+  // serialized.
+  SessionCommand* CreateUpdateTabNavigationCommandForReset(
+      SessionID::id_type tab_id,
+      int index,
+      const content::NavigationEntry& entry);
+
+  // Stores a copy of |command|, built from |entry|, in
+  // |navigation_command_cache_| unless the cache is full.
+  void CacheNavigationCommand(SessionID::id_type tab_id,
+                              int index,
+                              const content::NavigationEntry& entry,
+                              const SessionCommand& command);
+
+  // Drops the cached commands for one navigation, or for all navigations of
+  // |tab_id|.
+  void RemoveCachedNavigationCommand(SessionID::id_type tab_id, int index);
+  void RemoveCachedNavigationCommands(SessionID::id_type tab_id);
+
   // Schedules a reset. A reset means the contents of the file are recreated
   // from the state of the browser.
   void ScheduleReset();
@@ -422,6 +457,18 @@ class SessionService : public BaseSessionService,
   // written.
   IdToRange tab_to_available_range_;
 
+  // Serialized navigations of open tabs. A reset walks every tab's history on
+  // the UI thread; with many tabs, re-serializing each entry dominates it.
+  // Entries that changed since they were cached are detected through their
+  // unique ID or dropped when SessionService is told about the change.
+  NavigationCommandCache navigation_command_cache_;
+  size_t navigation_command_cache_bytes_;
+
+  // Counts of reset navigations served from and missing in
+  // |navigation_command_cache_|, reported per reset.
+  int navigation_command_cache_hits_;
+  int navigation_command_cache_misses_;
+
   // When the user closes the last window, where the last window is the
   // last tabbed browser and no more tabbed browsers are open with the same
   // profile, the window ID is added here. These IDs are only committed (which
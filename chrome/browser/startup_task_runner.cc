@@ -0,0 +1,172 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/startup_task_runner.h"
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "base/stl_util.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_types.h"
+
+using content::BrowserThread;
+
+namespace {
+
+// Records |time| in a histogram named after the step. The histogram name
+// varies, so the UMA_HISTOGRAM_* macros, which cache the first histogram they
+// see, can't be used.
+void RecordTaskTime(const std::string& name, base::TimeDelta time) {
+  base::Histogram* histogram = base::Histogram::FactoryTimeGet(
+      "Startup.Task." + name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(10),
+      50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+  histogram->AddTime(time);
+}
+
+}  // namespace
+
+const int StartupTaskRunner::kDefaultDeferredTimeoutMs = 10000;
+
+StartupTaskRunner::Task::Task() : kind(CRITICAL), done(false) {}
+
+StartupTaskRunner::Task::~Task() {}
+
+StartupTaskRunner::StartupTaskRunner()
+    : deferred_started_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+}
+
+StartupTaskRunner::~StartupTaskRunner() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  STLDeleteElements(&tasks_);
+}
+
+void StartupTaskRunner::AddTask(const std::string& name,
+                                Kind kind,
+                                const std::vector<std::string>& dependencies,
+                                const base::Closure& task) {
+  DCHECK(!FindTask(name)) << name;
+  for (size_t i = 0; i < dependencies.size(); ++i) {
+    Task* dependency = FindTask(dependencies[i]);
+    DCHECK(dependency) << name << " depends on unknown " << dependencies[i];
+    DCHECK(kind == DEFERRABLE || dependency->kind == CRITICAL)
+        << "critical " << name << " depends on deferrable " << dependencies[i];
+  }
+
+  Task* new_task = new Task;
+  new_task->name = name;
+  new_task->kind = kind;
+  new_task->dependencies = dependencies;
+  new_task->closure = task;
+  tasks_.push_back(new_task);
+  if (kind == DEFERRABLE) {
+    deferred_tasks_.push_back(new_task);
+    // Registered after the first paint; it is the only pending step.
+    if (deferred_started_ && deferred_tasks_.size() == 1)
+      ScheduleNextDeferredTask();
+  }
+}
+
+void StartupTaskRunner::AddTask(const std::string& name,
+                                Kind kind,
+                                const base::Closure& task) {
+  AddTask(name, kind, std::vector<std::string>(), task);
+}
+
+void StartupTaskRunner::RunCriticalTasks() {
+  TRACE_EVENT0("startup", "StartupTaskRunner::RunCriticalTasks");
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 0; i < tasks_.size(); ++i) {
+    if (tasks_[i]->kind == CRITICAL && !tasks_[i]->done)
+      RunTask(tasks_[i]);
+  }
+  UMA_HISTOGRAM_TIMES("Startup.CriticalTasksTime",
+                      base::TimeTicks::Now() - start);
+}
+
+void StartupTaskRunner::StartDeferredTasks(base::TimeDelta timeout) {
+  DCHECK(deferred_requested_.is_null());
+  deferred_requested_ = base::TimeTicks::Now();
+  // Any page painting means the first window is up.
+  registrar_.Add(this, content::NOTIFICATION_RENDER_WIDGET_HOST_DID_PAINT,
+                 content::NotificationService::AllSources());
+  deferred_timeout_.Start(FROM_HERE, timeout, this,
+                          &StartupTaskRunner::OnDeferredStart);
+}
+
+void StartupTaskRunner::Observe(int type,
+                                const content::NotificationSource& source,
+                                const content::NotificationDetails& details) {
+  DCHECK_EQ(content::NOTIFICATION_RENDER_WIDGET_HOST_DID_PAINT, type);
+  OnDeferredStart();
+}
+
+void StartupTaskRunner::OnDeferredStart() {
+  if (deferred_started_)
+    return;
+  deferred_started_ = true;
+  registrar_.RemoveAll();
+  deferred_timeout_.Stop();
+  UMA_HISTOGRAM_TIMES("Startup.DeferredTasksDelay",
+                      base::TimeTicks::Now() - deferred_requested_);
+  ScheduleNextDeferredTask();
+}
+
+void StartupTaskRunner::ScheduleNextDeferredTask() {
+  // Posting each step separately lets input and paint tasks queued in the
+  // meantime run in between. Non-nestable, so steps don't run from inside a
+  // modal dialog's loop.
+  MessageLoop::current()->PostNonNestableTask(
+      FROM_HERE,
+      base::Bind(&StartupTaskRunner::RunNextDeferredTask,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void StartupTaskRunner::RunNextDeferredTask() {
+  // Steps already run as a dependency of an earlier one are skipped.
+  while (!deferred_tasks_.empty() && deferred_tasks_.front()->done)
+    deferred_tasks_.pop_front();
+  if (deferred_tasks_.empty())
+    return;
+  Task* task = deferred_tasks_.front();
+  deferred_tasks_.pop_front();
+  RunTask(task);
+  if (!deferred_tasks_.empty())
+    ScheduleNextDeferredTask();
+}
+
+void StartupTaskRunner::RunTask(Task* task) {
+  DCHECK(!task->done);
+  // Marked first so that a dependency cycle can't recurse forever.
+  task->done = true;
+  for (size_t i = 0; i < task->dependencies.size(); ++i) {
+    Task* dependency = FindTask(task->dependencies[i]);
+    if (dependency && !dependency->done)
+      RunTask(dependency);
+  }
+
+  TRACE_EVENT1("startup", "StartupTaskRunner::RunTask",
+               "name", TRACE_STR_COPY(task->name.c_str()));
+  base::TimeTicks start = base::TimeTicks::Now();
+  task->closure.Run();
+  RecordTaskTime(task->name, base::TimeTicks::Now() - start);
+  // The closure may hold references that are no longer needed.
+  task->closure.Reset();
+}
+
+StartupTaskRunner::Task* StartupTaskRunner::FindTask(const std::string& name) {
+  for (size_t i = 0; i < tasks_.size(); ++i) {
+    if (tasks_[i]->name == name)
+      return tasks_[i];
+  }
+  return NULL;
+}
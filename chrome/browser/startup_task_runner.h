@@ -0,0 +1,108 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// StartupTaskRunner runs the browser's startup initialization steps. Each
+// step is registered under a name, as either critical or deferrable, with the
+// names of the steps it depends on. Critical steps run synchronously from
+// RunCriticalTasks(), since the first window needs them. Deferrable steps
+// wait until the first page has painted, or until a timeout, and then run one
+// per message loop turn so that input and painting are not held up.
+//
+// Every step emits a "startup" trace event and its time is recorded in the
+// "Startup.Task.<name>" histogram.
+
+#ifndef CHROME_BROWSER_STARTUP_TASK_RUNNER_H_
+#define CHROME_BROWSER_STARTUP_TASK_RUNNER_H_
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+
+class StartupTaskRunner : public content::NotificationObserver {
+ public:
+  enum Kind {
+    CRITICAL,
+    DEFERRABLE,
+  };
+
+  // Must be created and destroyed on the UI thread.
+  StartupTaskRunner();
+  virtual ~StartupTaskRunner();
+
+  // Registers |task| under |name|, which must be unique. |dependencies| are
+  // the names of steps that must run first; they must have been registered
+  // already. A critical step can't depend on a deferrable one.
+  void AddTask(const std::string& name,
+               Kind kind,
+               const std::vector<std::string>& dependencies,
+               const base::Closure& task);
+  void AddTask(const std::string& name, Kind kind, const base::Closure& task);
+
+  // Runs the critical steps registered so far, in dependency order and
+  // otherwise in registration order.
+  void RunCriticalTasks();
+
+  // Starts running the deferrable steps once the first page has painted, or
+  // after |timeout| at the latest. Deferrable steps registered later are
+  // still run. Steps that are pending when the runner is destroyed never run.
+  void StartDeferredTasks(base::TimeDelta timeout);
+
+  // The delay from StartDeferredTasks() to running the deferrable steps when
+  // no page paints.
+  static const int kDefaultDeferredTimeoutMs;
+
+ private:
+  struct Task {
+    Task();
+    ~Task();
+
+    std::string name;
+    Kind kind;
+    std::vector<std::string> dependencies;
+    base::Closure closure;
+    bool done;
+  };
+
+  // content::NotificationObserver:
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  // Stops waiting for the first paint and schedules the deferrable steps.
+  void OnDeferredStart();
+
+  // Runs the next deferrable step and schedules the one after it.
+  void RunNextDeferredTask();
+  void ScheduleNextDeferredTask();
+
+  // Runs |task| after its dependencies, which are run first if needed.
+  void RunTask(Task* task);
+
+  Task* FindTask(const std::string& name);
+
+  // Owned. Kept in registration order.
+  std::vector<Task*> tasks_;
+
+  // Deferrable steps not yet run, in registration order.
+  std::deque<Task*> deferred_tasks_;
+
+  bool deferred_started_;
+  base::TimeTicks deferred_requested_;
+  base::OneShotTimer<StartupTaskRunner> deferred_timeout_;
+  content::NotificationRegistrar registrar_;
+  base::WeakPtrFactory<StartupTaskRunner> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTaskRunner);
+};
+
+#endif  // CHROME_BROWSER_STARTUP_TASK_RUNNER_H_
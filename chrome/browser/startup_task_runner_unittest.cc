@@ -0,0 +1,112 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/startup_task_runner.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_types.h"
+#include "content/test/test_browser_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using content::BrowserThread;
+
+namespace {
+
+void AppendName(std::string* log, const std::string& name) {
+  if (!log->empty())
+    log->append(",");
+  log->append(name);
+}
+
+class StartupTaskRunnerTest : public testing::Test {
+ public:
+  StartupTaskRunnerTest()
+      : ui_thread_(BrowserThread::UI, &message_loop_) {
+  }
+
+ protected:
+  void AddTask(const std::string& name,
+               StartupTaskRunner::Kind kind,
+               const std::string& dependency) {
+    std::vector<std::string> dependencies;
+    if (!dependency.empty())
+      dependencies.push_back(dependency);
+    runner_.AddTask(name, kind, dependencies,
+                    base::Bind(&AppendName, &log_, name));
+  }
+
+  void SimulatePaint() {
+    content::NotificationService::current()->Notify(
+        content::NOTIFICATION_RENDER_WIDGET_HOST_DID_PAINT,
+        content::NotificationService::AllSources(),
+        content::NotificationService::NoDetails());
+  }
+
+  MessageLoopForUI message_loop_;
+  content::TestBrowserThread ui_thread_;
+  StartupTaskRunner runner_;
+  std::string log_;
+};
+
+}  // namespace
+
+TEST_F(StartupTaskRunnerTest, CriticalTasksRunInDependencyOrder) {
+  AddTask("a", StartupTaskRunner::CRITICAL, "");
+  AddTask("b", StartupTaskRunner::CRITICAL, "");
+  AddTask("c", StartupTaskRunner::CRITICAL, "a");
+  AddTask("deferred", StartupTaskRunner::DEFERRABLE, "c");
+  runner_.RunCriticalTasks();
+  EXPECT_EQ("a,b,c", log_);
+
+  // Critical steps run only once.
+  runner_.RunCriticalTasks();
+  EXPECT_EQ("a,b,c", log_);
+}
+
+TEST_F(StartupTaskRunnerTest, DeferredTasksWaitForFirstPaint) {
+  AddTask("critical", StartupTaskRunner::CRITICAL, "");
+  AddTask("x", StartupTaskRunner::DEFERRABLE, "");
+  AddTask("y", StartupTaskRunner::DEFERRABLE, "critical");
+  runner_.RunCriticalTasks();
+  runner_.StartDeferredTasks(base::TimeDelta::FromHours(1));
+  message_loop_.RunAllPending();
+  EXPECT_EQ("critical", log_);
+
+  SimulatePaint();
+  EXPECT_EQ("critical", log_);
+  message_loop_.RunAllPending();
+  EXPECT_EQ("critical,x,y", log_);
+
+  // Steps added once deferred steps have started still run.
+  AddTask("z", StartupTaskRunner::DEFERRABLE, "");
+  message_loop_.RunAllPending();
+  EXPECT_EQ("critical,x,y,z", log_);
+}
+
+TEST_F(StartupTaskRunnerTest, DependenciesRunFirst) {
+  AddTask("critical", StartupTaskRunner::CRITICAL, "");
+  AddTask("x", StartupTaskRunner::DEFERRABLE, "critical");
+  runner_.StartDeferredTasks(base::TimeDelta::FromHours(1));
+  SimulatePaint();
+  message_loop_.RunAllPending();
+  EXPECT_EQ("critical,x", log_);
+
+  // Already run as a dependency.
+  runner_.RunCriticalTasks();
+  EXPECT_EQ("critical,x", log_);
+}
+
+TEST_F(StartupTaskRunnerTest, DeferredTasksRunAfterTimeout) {
+  AddTask("x", StartupTaskRunner::DEFERRABLE, "");
+  runner_.StartDeferredTasks(base::TimeDelta());
+  message_loop_.PostDelayedTask(FROM_HERE, MessageLoop::QuitClosure(),
+                                base::TimeDelta::FromMilliseconds(50));
+  message_loop_.Run();
+  EXPECT_EQ("x", log_);
+}
@@ -7,6 +7,7 @@
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/stringprintf.h"
 #include "base/time.h"
 #include "base/tracked_objects.h"
 #include "content/public/common/content_client.h"
@@ -71,6 +72,17 @@ void DeathDataSnapshotToValue(const DeathDataSnapshot& death_data,
   dictionary->Set("queue_ms_sample",
                   Value::CreateIntegerValue(death_data.queue_duration_sample));
 
+  // Tasks that are still alive have no histograms to estimate percentiles from.
+  if (death_data.run_duration_histogram.empty())
+    return;
+  const int kPercentiles[] = { 50, 90, 99 };
+  for (size_t i = 0; i < arraysize(kPercentiles); ++i) {
+    std::string suffix = base::StringPrintf("_p%d", kPercentiles[i]);
+    dictionary->Set("run_ms" + suffix, Value::CreateIntegerValue(
+        death_data.RunDurationPercentile(kPercentiles[i])));
+    dictionary->Set("queue_ms" + suffix, Value::CreateIntegerValue(
+        death_data.QueueDurationPercentile(kPercentiles[i])));
+  }
 }
 
 // Re-serializes the |snapshot| into |dictionary|.
@@ -107,6 +119,9 @@ void TaskProfilerDataSerializer::ToValue(
   dictionary->Set("list", tasks_list.release());
 
   dictionary->SetInteger("process_id", process_data.process_id);
+  // Counts are of one in |sampling_interval| tasks.
+  if (process_data.sampling_interval > 1)
+    dictionary->SetInteger("sampling_interval", process_data.sampling_interval);
   dictionary->SetString("process_type",
                         content::GetProcessTypeNameInEnglish(process_type));
 
@@ -159,3 +159,56 @@ TEST(TaskProfilerDataSerializerTest, SerializeProcessDataToJson) {
                         "}");
   }
 }
+
+// Tests that sampled data carries its interval, and that percentiles are
+// serialized for tasks that have run.
+TEST(TaskProfilerDataSerializerTest, SerializeSampledProcessDataToJson) {
+  tracked_objects::DeathData death_data;
+  death_data.RecordDeath(10, 1, 0);
+  death_data.RecordDeath(10, 1, 0);
+  death_data.RecordDeath(100, 3, 0);
+
+  tracked_objects::ProcessDataSnapshot process_data;
+  process_data.sampling_interval = 10;
+  process_data.tasks.push_back(tracked_objects::TaskSnapshot());
+  process_data.tasks.back().birth.location.file_name = "path/to/foo.cc";
+  process_data.tasks.back().birth.location.function_name = "WhizBang";
+  process_data.tasks.back().birth.location.line_number = 101;
+  process_data.tasks.back().birth.thread_name = "CrBrowserMain";
+  process_data.tasks.back().death_data =
+      tracked_objects::DeathDataSnapshot(death_data);
+  process_data.tasks.back().death_thread_name = "CrBrowserMain";
+
+  ExpectSerialization(process_data, content::PROCESS_TYPE_BROWSER,
+                      "{"
+                        "\"descendants\":["
+                        "],"
+                        "\"list\":[{"
+                           "\"birth_location\":{"
+                              "\"file_name\":\"path/to/foo.cc\","
+                              "\"function_name\":\"WhizBang\","
+                              "\"line_number\":101"
+                           "},"
+                           "\"birth_thread\":\"CrBrowserMain\","
+                           "\"death_data\":{"
+                              "\"count\":3,"
+                              "\"queue_ms\":120,"
+                              "\"queue_ms_max\":100,"
+                              "\"queue_ms_p50\":15,"
+                              "\"queue_ms_p90\":100,"
+                              "\"queue_ms_p99\":100,"
+                              "\"queue_ms_sample\":100,"
+                              "\"run_ms\":5,"
+                              "\"run_ms_max\":3,"
+                              "\"run_ms_p50\":1,"
+                              "\"run_ms_p90\":3,"
+                              "\"run_ms_p99\":3,"
+                              "\"run_ms_sample\":3"
+                           "},"
+                           "\"death_thread\":\"CrBrowserMain\""
+                        "}],"
+                        "\"process_id\":" + GetProcessIdString() + ","
+                        "\"process_type\":\"Browser\","
+                        "\"sampling_interval\":10"
+                      "}");
+}
@@ -20,6 +20,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop.h"
 #include "base/message_loop_helpers.h"
+#include "base/metrics/histogram.h"
 #include "base/path_service.h"
 #include "base/platform_file.h"
 #include "base/string_number_conversions.h"
@@ -33,6 +34,8 @@
 #include "chrome/browser/io_thread.h"
 #include "chrome/browser/net/chrome_net_log.h"
 #include "chrome/browser/net/connection_tester.h"
+#include "chrome/browser/net/load_timing_observer.h"
+#include "chrome/browser/net/load_timing_stats.h"
 #include "chrome/browser/net/url_fixer_upper.h"
 #include "chrome/browser/prefs/pref_member.h"
 #include "chrome/browser/prerender/prerender_manager.h"
@@ -120,6 +123,33 @@ disk_cache::Backend* GetDiskCacheBackend(net::URLRequestContext* context) {
   return http_cache->GetCurrentBackend();
 }
 
+// Returns the samples of the UMA histogram |name| in the form of
+// LoadTimingStats::Histogram::ToValue(), or NULL if the histogram has not been
+// created yet.
+Value* UMAHistogramToValue(const std::string& name) {
+  base::Histogram* histogram = NULL;
+  if (!base::StatisticsRecorder::FindHistogram(name, &histogram))
+    return NULL;
+
+  base::Histogram::SampleSet snapshot;
+  histogram->SnapshotSample(&snapshot);
+  ListValue* buckets = new ListValue();
+  for (size_t i = 0; i < histogram->bucket_count(); ++i) {
+    if (!snapshot.counts(i))
+      continue;
+    ListValue* bucket = new ListValue();
+    bucket->Append(Value::CreateDoubleValue(histogram->ranges(i)));
+    bucket->Append(Value::CreateIntegerValue(snapshot.counts(i)));
+    buckets->Append(bucket);
+  }
+
+  DictionaryValue* dict = new DictionaryValue();
+  dict->SetInteger("count", snapshot.TotalCount());
+  dict->SetDouble("sum_ms", static_cast<double>(snapshot.sum()));
+  dict->Set("buckets", buckets);
+  return dict;
+}
+
 // Returns the http network session for |context| if there is one.
 // Otherwise, returns NULL.
 net::HttpNetworkSession* GetHttpNetworkSession(
@@ -411,6 +441,8 @@ class NetInternalsMessageHandler::IOThreadImpl
   void OnGetServiceProviders(const ListValue* list);
 #endif
   void OnGetHttpPipeliningStatus(const ListValue* list);
+  void OnGetPerformanceStats(const ListValue* list);
+  void OnResetPerformanceStats(const ListValue* list);
   void OnSetLogLevel(const ListValue* list);
 
   // ChromeNetLog::ThreadSafeObserver implementation:
@@ -605,6 +637,14 @@ void NetInternalsMessageHandler::RegisterMessages() {
       "getHttpPipeliningStatus",
       base::Bind(&IOThreadImpl::CallbackHelper,
                  &IOThreadImpl::OnGetHttpPipeliningStatus, proxy_));
+  web_ui()->RegisterMessageCallback(
+      "getPerformanceStats",
+      base::Bind(&IOThreadImpl::CallbackHelper,
+                 &IOThreadImpl::OnGetPerformanceStats, proxy_));
+  web_ui()->RegisterMessageCallback(
+      "resetPerformanceStats",
+      base::Bind(&IOThreadImpl::CallbackHelper,
+                 &IOThreadImpl::OnResetPerformanceStats, proxy_));
   web_ui()->RegisterMessageCallback(
       "setLogLevel",
       base::Bind(&IOThreadImpl::CallbackHelper,
@@ -1420,6 +1460,28 @@ void NetInternalsMessageHandler::IOThreadImpl::OnGetHttpPipeliningStatus(
   SendJavascriptCommand("receivedHttpPipeliningStatus", status_dict);
 }
 
+void NetInternalsMessageHandler::IOThreadImpl::OnGetPerformanceStats(
+    const ListValue* list) {
+  // The latency of the network phases, overall and per host, and the wait of
+  // the IO thread's tasks.
+  DictionaryValue* stats_dict =
+      io_thread_->net_log()->load_timing_observer()->stats()->ToValue();
+
+  // The wait of the operations of the HTTP cache on the cache thread, which
+  // the disk cache records itself.
+  Value* cache_thread_queue =
+      UMAHistogramToValue("DiskCache.0.CacheThreadQueueTime");
+  if (cache_thread_queue)
+    stats_dict->Set("cache_thread_queue", cache_thread_queue);
+
+  SendJavascriptCommand("receivedPerformanceStats", stats_dict);
+}
+
+void NetInternalsMessageHandler::IOThreadImpl::OnResetPerformanceStats(
+    const ListValue* list) {
+  io_thread_->net_log()->load_timing_observer()->stats()->Reset();
+}
+
 void NetInternalsMessageHandler::IOThreadImpl::OnSetLogLevel(
     const ListValue* list) {
   int log_level;
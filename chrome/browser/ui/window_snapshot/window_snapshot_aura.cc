@@ -14,6 +14,14 @@
 
 namespace browser {
 
+namespace {
+
+// zlib's Z_BEST_SPEED. Screenshots are large and short-lived, so encoding
+// quickly matters more than a smaller file.
+const int kCompressionLevel = 1;
+
+}  // namespace
+
 bool GrabWindowSnapshot(gfx::NativeWindow window,
                         std::vector<unsigned char>* png_representation,
                         const gfx::Rect& snapshot_bounds) {
@@ -37,11 +45,10 @@ bool GrabWindowSnapshot(gfx::NativeWindow window,
 
   unsigned char* pixels = reinterpret_cast<unsigned char*>(bitmap.getPixels());
 
-  gfx::PNGCodec::Encode(pixels, gfx::PNGCodec::FORMAT_BGRA,
-                        snapshot_bounds.size(),
-                        bitmap.rowBytes(), true,
-                        std::vector<gfx::PNGCodec::Comment>(),
-                        png_representation);
+  gfx::PNGCodec::EncodeWithCompressionLevel(
+      pixels, gfx::PNGCodec::FORMAT_BGRA, snapshot_bounds.size(),
+      bitmap.rowBytes(), true, std::vector<gfx::PNGCodec::Comment>(),
+      kCompressionLevel, png_representation);
   return true;
 }
 
@@ -295,9 +295,9 @@ void VisitedLinkMaster::DeleteURLs(const history::URLRows& rows) {
   if (rows.empty())
     return;
 
-  listener_->Reset();
-
   if (table_builder_) {
+    listener_->Reset();
+
     // A rebuild is in progress, save this deletion in the temporary list so
     // it can be added once rebuild is complete.
     for (history::URLRows::const_iterator i = rows.begin(); i != rows.end();
@@ -334,7 +334,21 @@ void VisitedLinkMaster::DeleteURLs(const history::URLRows& rows) {
     deleted_fingerprints.insert(
         ComputeURLFingerprint(url.spec().data(), url.spec().size(), salt_));
   }
+
+  // Slaves only need to re-check the links that were deleted, which is much
+  // cheaper for them than recomputing the state of every link. Past a point
+  // it is cheaper to reset them.
+  if (deleted_fingerprints.size() > kBigDeleteThreshold)
+    listener_->Reset();
+
   DeleteFingerprintsFromCurrentTable(deleted_fingerprints);
+
+  if (deleted_fingerprints.size() <= kBigDeleteThreshold) {
+    for (std::set<Fingerprint>::const_iterator i =
+             deleted_fingerprints.begin();
+         i != deleted_fingerprints.end(); ++i)
+      listener_->Add(*i);
+  }
 }
 
 // See VisitedLinkCommon::IsVisited which should be in sync with this algorithm
@@ -43,12 +43,13 @@ class VisitedLinkMaster : public VisitedLinkCommon {
     // argument is the new table handle.
     virtual void NewTable(base::SharedMemory*) = 0;
 
-    // Called when new link has been added. The argument is the fingerprint
+    // Called when new link has been added, or when a few links were deleted
+    // and slaves should re-check just those. The argument is the fingerprint
     // (hash) of the link.
     virtual void Add(Fingerprint fingerprint) = 0;
 
     // Called when link coloring state has been reset. This may occur when
-    // entire or parts of history were deleted.
+    // entire or large parts of history were deleted.
     virtual void Reset() = 0;
   };
 
@@ -12,6 +12,7 @@
 #include "base/shared_memory.h"
 #include "base/stringprintf.h"
 #include "base/test/test_file_util.h"
+#include "chrome/browser/history/history_types.h"
 #include "chrome/browser/visitedlink/visitedlink_master.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -195,3 +196,32 @@ TEST_F(VisitedLink, TestLoad) {
   LogPerfResult("Visited_link_hot_load_time",
                 hot_sum / hot_load_times.size(), "ms");
 }
+
+// Tests how long it takes to grow the table from empty through all of its
+// resizes, and to shrink it again after most of history is deleted.
+TEST_F(VisitedLink, TestResize) {
+  VisitedLinkMaster master(DummyVisitedLinkEventListener::GetInstance(),
+                           NULL, true, db_path_, 0);
+  ASSERT_TRUE(master.Init());
+
+  std::vector<GURL> urls;
+  for (int i = 0; i < load_test_add_count; i++)
+    urls.push_back(TestURL(added_prefix, i));
+
+  // AddURLs writes the file once at the end, so this mostly measures the
+  // resizes.
+  PerfTimeLogger grow_timer("Visited_link_grow");
+  master.AddURLs(urls);
+  grow_timer.Done();
+  ASSERT_EQ(load_test_add_count, master.GetUsedCount());
+
+  // Delete nine tenths of the URLs so the table shrinks.
+  history::URLRows deleted_urls;
+  for (int i = 0; i < load_test_add_count / 10 * 9; i++)
+    deleted_urls.push_back(history::URLRow(urls[i]));
+
+  PerfTimeLogger shrink_timer("Visited_link_shrink");
+  master.DeleteURLs(deleted_urls);
+  shrink_timer.Done();
+  ASSERT_EQ(load_test_add_count / 10, master.GetUsedCount());
+}
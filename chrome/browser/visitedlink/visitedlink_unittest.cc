@@ -454,11 +454,12 @@ TEST_F(VisitedLinkTest, Listener) {
   // ... and all of the remaining ones.
   master_->DeleteAllURLs();
 
-  // Verify that VisitedLinkMaster::Listener::Add was called for each added URL.
-  EXPECT_EQ(g_test_count, listener_.add_count());
-  // Verify that VisitedLinkMaster::Listener::Reset was called both when one and
-  // all URLs are deleted.
-  EXPECT_EQ(2, listener_.reset_count());
+  // Verify that VisitedLinkMaster::Listener::Add was called for each added URL
+  // and for the single deleted one.
+  EXPECT_EQ(g_test_count + 1, listener_.add_count());
+  // Verify that VisitedLinkMaster::Listener::Reset was called only when all
+  // URLs are deleted.
+  EXPECT_EQ(1, listener_.reset_count());
 }
 
 class VisitCountingProfile : public TestingProfile {
@@ -15,6 +15,7 @@
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/chrome_paths_internal.h"
 #include "chrome/common/chrome_switches.h"
+#include "chrome/common/chrome_version_info.h"
 
 #if defined(OS_MACOSX)
 #include "base/mac/mac_util.h"
@@ -232,6 +233,22 @@ bool PathProvider(int key, FilePath* result) {
         return false;
       cur = cur.Append(FILE_PATH_LITERAL("PepperFlash"));
       break;
+    case chrome::DIR_DECODED_RESOURCES:
+      if (!PathService::Get(chrome::DIR_USER_DATA, &cur))
+        return false;
+      cur = cur.Append(FILE_PATH_LITERAL("Decoded Resources"));
+      break;
+    case chrome::FILE_DECODED_IMAGE_PACK: {
+      // The pixel layout depends on the build, so every version gets its own.
+      chrome::VersionInfo version_info;
+      if (!version_info.is_valid() ||
+          !PathService::Get(chrome::DIR_DECODED_RESOURCES, &cur)) {
+        return false;
+      }
+      cur = cur.AppendASCII(version_info.Version())
+               .Append(FILE_PATH_LITERAL("images_100_percent.pak"));
+      break;
+    }
     case chrome::FILE_LOCAL_STATE:
       if (!PathService::Get(chrome::DIR_USER_DATA, &cur))
         return false;
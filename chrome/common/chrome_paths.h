@@ -67,6 +67,9 @@ enum {
                                 // to be installed when chrome is first run.
   DIR_PEPPER_FLASH_PLUGIN,      // Directory to the Pepper Flash plugin,
                                 // containing the plugin and the manifest.
+  DIR_DECODED_RESOURCES,        // Directory where resources decoded ahead of
+                                // time are stored, one subdirectory per
+                                // version.
   FILE_RESOURCE_MODULE,         // Full path and filename of the module that
                                 // contains embedded resources (version,
                                 // strings, images, etc.).
@@ -95,6 +98,8 @@ enum {
   FILE_RESOURCES_PACK,          // Full path to the .pak file containing
                                 // binary data (e.g., html files and images
                                 // used by interal pages).
+  FILE_DECODED_IMAGE_PACK,      // Full path to the images of this version's
+                                // resource packs, decoded ahead of time.
 #if defined(OS_CHROMEOS)
   FILE_CHROMEOS_API,            // Full path to chrome os api shared object.
 #endif
@@ -234,6 +234,10 @@ const char kDiagnostics[]                   = "diagnostics";
 // device, useful when using remote desktop or machines without sound cards.
 // This is temporary until we fix the underlying problem.
 
+// Disables the built-in asynchronous DNS client, so that host names are
+// resolved by the system on worker threads.
+const char kDisableAsyncDns[]               = "disable-async-dns";
+
 // Disables asynchronous spellchecking features for all time. Disabling this
 // feature also disables unified spellchecking.
 const char kDisableAsynchronousSpellChecking[] =
@@ -452,9 +456,6 @@ const char kEnableActionBox[]               = "enable-action-box";
 // Enables AeroPeek for each tab. (This switch only works on Windows 7).
 const char kEnableAeroPeekTabs[]            = "enable-aero-peek-tabs";
 
-// Enables the experimental asynchronous DNS client.
-const char kEnableAsyncDns[]                = "enable-async-dns";
-
 // Enables the inclusion of non-standard ports when generating the Kerberos SPN
 // in response to a Negotiate challenge. See
 // HttpAuthHandlerNegotiate::CreateSPN for more background.
@@ -598,6 +599,11 @@ const char kEnableSdch[]                    = "enable-sdch";
 // Enable SPDY/3. This is a temporary testing flag.
 const char kEnableSpdy3[]                   = "enable-spdy3";
 
+// Saves TLS sessions, encrypted, with the SSL host information in the disk
+// cache, so that they can be resumed after a restart.
+const char kEnableSSLSessionPersistence[]   =
+    "enable-ssl-session-persistence";
+
 // Enables the stacked tabstrip.
 const char kEnableStackedTabStrip[]         = "enable-stacked-tab-strip";
 
@@ -814,6 +820,12 @@ const char kLoadOpencryptoki[]              = "load-opencryptoki";
 // to a separate file if a file name is given.
 const char kLogNetLog[]                     = "log-net-log";
 
+// Writes net log events to the given file in a compact binary format, which
+// costs much less to capture than --log-net-log. The capture can be converted
+// to JSON for about:net-internals with NetLogBinaryLogger::ConvertToJSON().
+// Event parameters are not captured at --net-log-level=2.
+const char kLogNetLogBinary[]               = "log-net-log-binary";
+
 // Uninstalls an extension with the specified extension id.
 const char kUninstallExtension[]            = "uninstall-extension";
 
@@ -858,6 +870,10 @@ const char kNaClLoaderCmdPrefix[]           = "nacl-loader-cmd-prefix";
 // Intended primarily for use with --log-net-log.
 const char kNetLogLevel[]                   = "net-log-level";
 
+// With --log-net-log-binary, only keeps the given number of most recent events
+// in memory, and writes them on shutdown.
+const char kNetLogRingBufferSize[]          = "net-log-ring-buffer-size";
+
 // Disables the default browser check. Useful for UI/browser tests where we
 // want to avoid having the default browser info-bar displayed.
 const char kNoDefaultBrowserCheck[]         = "no-default-browser-check";
@@ -1084,6 +1100,11 @@ const char kRemoteDebuggingFrontend[]       = "remote-debugging-frontend";
 // Chrome and does nothing when directly passed to the browser.
 const char kRendererPrintPreview[]          = "renderer-print-preview";
 
+// Serves all http and https requests from the given archive of recorded
+// responses, with their recorded latency, instead of from the network.
+// Requests missing from the archive fail. Used by the page load benchmarks.
+const char kReplayArchive[]                 = "replay-archive";
+
 // Indicates the last session should be restored on startup. This overrides the
 // preferences value and is primarily intended for testing. The value of this
 // switch is the number of tabs to wait until loaded before 'load completed' is
@@ -74,6 +74,7 @@ extern const char kDebugEnableFrameToggle[];
 extern const char kDebugPrint[];
 extern const char kDeviceManagementUrl[];
 extern const char kDiagnostics[];
+extern const char kDisableAsyncDns[];
 extern const char kDisableAsynchronousSpellChecking[];
 extern const char kDisableAuthNegotiateCnameLookup[];
 extern const char kDisableBackgroundMode[];
@@ -133,7 +134,6 @@ extern const char kDownloadsNewUI[];
 extern const char kDumpHistogramsOnExit[];
 extern const char kEnableActionBox[];
 extern const char kEnableAeroPeekTabs[];
-extern const char kEnableAsyncDns[];
 extern const char kEnableAuthNegotiatePort[];
 extern const char kEnableAutofillFeedback[];
 extern const char kEnableAutologin[];
@@ -171,6 +171,7 @@ extern const char kEnableResourceContentSettings[];
 extern const char kEnableSdch[];
 extern const char kEnableSpdy3[];
 extern const char kEnableSpdyFlowControl[];
+extern const char kEnableSSLSessionPersistence[];
 extern const char kEnableStackedTabStrip[];
 extern const char kEnableSuggestionsTabPage[];
 extern const char kEnableSyncSignin[];
@@ -226,6 +227,7 @@ extern const char kLoadExtension[];
 extern const char kLoadOpencryptoki[];
 extern const char kUninstallExtension[];
 extern const char kLogNetLog[];
+extern const char kLogNetLogBinary[];
 extern const char kMakeDefaultBrowser[];
 extern const char kManaged[];
 extern const char kMediaCacheSize[];
@@ -236,6 +238,7 @@ extern const char kMultiProfiles[];
 extern const char kNaClGdb[];
 extern const char kNaClLoaderCmdPrefix[];
 extern const char kNetLogLevel[];
+extern const char kNetLogRingBufferSize[];
 extern const char kNoDefaultBrowserCheck[];
 extern const char kNoDisplayingInsecureContent[];
 extern const char kNoEvents[];
@@ -294,6 +297,7 @@ extern const char kRecordMode[];
 extern const char kReloadKilledTabs[];
 extern const char kRemoteDebuggingFrontend[];
 extern const char kRendererPrintPreview[];
+extern const char kReplayArchive[];
 extern const char kRestoreLastSession[];
 extern const char kSbURLPrefix[];
 extern const char kSbDisableAutoUpdate[];
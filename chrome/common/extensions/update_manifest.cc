@@ -159,6 +159,12 @@ static bool ParseSingleAppTag(xmlNode* app_node, xmlNs* xml_namespace,
     return false;
   }
 
+  // Find the url to the differential package (not required). An invalid url
+  // only disables the differential update.
+  GURL diff_crx_url(GetAttribute(updatecheck, "codebasediff"));
+  if (diff_crx_url.is_valid())
+    result->diff_crx_url = diff_crx_url;
+
   // Get the version.
   result->version = GetAttribute(updatecheck, "version");
   if (result->version.length() == 0) {
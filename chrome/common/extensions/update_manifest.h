@@ -44,6 +44,9 @@ class UpdateManifest {
     std::string browser_min_version;
     std::string package_hash;
     GURL crx_url;
+    // Optional. A differential package that updates the version the client
+    // reported in its update check to |version|.
+    GURL diff_crx_url;
   };
 
   static const int kNoDaystart = -1;
@@ -116,6 +116,17 @@ static const char* kTwoAppsOneError =
 " </app>"
 "</gupdate>";
 
+// Includes a differential package.
+static const char* kWithDiffCodebase =
+"<?xml version='1.0' encoding='UTF-8'?>"
+"<gupdate xmlns='http://www.google.com/update2/response' protocol='2.0'>"
+" <app appid='12345'>"
+"  <updatecheck codebase='http://example.com/extension_1.2.3.4.crx'"
+"               codebasediff='http://example.com/diff_1.2.3.3_1.2.3.4.crx'"
+"               version='1.2.3.4' />"
+" </app>"
+"</gupdate>";
+
 TEST(ExtensionUpdateManifestTest, TestUpdateManifest) {
   UpdateManifest parser;
 
@@ -149,6 +160,7 @@ TEST(ExtensionUpdateManifestTest, TestUpdateManifest) {
 
   EXPECT_EQ("1.2.3.4", firstResult->version);
   EXPECT_EQ("2.0.143.0", firstResult->browser_min_version);
+  EXPECT_TRUE(firstResult->diff_crx_url.is_empty());
 
   // Parse some xml that uses namespace prefixes.
   EXPECT_TRUE(parser.Parse(kUsesNamespacePrefix));
@@ -170,6 +182,14 @@ TEST(ExtensionUpdateManifestTest, TestUpdateManifest) {
   EXPECT_FALSE(parser.results().list.empty());
   EXPECT_EQ(parser.results().daystart_elapsed_seconds, 456);
 
+  // Parse xml with a differential package.
+  EXPECT_TRUE(parser.Parse(kWithDiffCodebase));
+  EXPECT_TRUE(parser.errors().empty());
+  EXPECT_FALSE(parser.results().list.empty());
+  firstResult = &parser.results().list.at(0);
+  EXPECT_EQ(GURL("http://example.com/diff_1.2.3.3_1.2.3.4.crx"),
+            firstResult->diff_crx_url);
+
   // Parse a no-update response.
   EXPECT_TRUE(parser.Parse(kNoUpdate));
   EXPECT_TRUE(parser.errors().empty());
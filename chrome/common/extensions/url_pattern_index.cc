@@ -0,0 +1,81 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/common/extensions/url_pattern_index.h"
+
+#include "chrome/common/extensions/url_pattern_set.h"
+#include "chrome/common/url_constants.h"
+#include "googleurl/src/gurl.h"
+
+URLPatternIndex::URLPatternIndex() {
+}
+
+URLPatternIndex::~URLPatternIndex() {
+}
+
+void URLPatternIndex::Add(ID id, const URLPatternSet& patterns) {
+  if (patterns.is_empty()) {
+    match_all_.push_back(id);
+    return;
+  }
+
+  for (URLPatternSet::const_iterator pattern = patterns.begin();
+       pattern != patterns.end(); ++pattern) {
+    // file: patterns ignore the host, and an empty host with subdomain
+    // matching means "any host".
+    if (pattern->match_all_urls() || pattern->host().empty() ||
+        pattern->MatchesScheme(chrome::kFileScheme)) {
+      unindexed_.push_back(std::make_pair(id, *pattern));
+    } else if (pattern->match_subdomains()) {
+      domain_hosts_[pattern->host()].push_back(std::make_pair(id, *pattern));
+    } else {
+      exact_hosts_[pattern->host()].push_back(std::make_pair(id, *pattern));
+    }
+  }
+}
+
+void URLPatternIndex::Clear() {
+  exact_hosts_.clear();
+  domain_hosts_.clear();
+  unindexed_.clear();
+  match_all_.clear();
+}
+
+void URLPatternIndex::Match(const GURL& url, std::set<ID>* ids) const {
+  ids->insert(match_all_.begin(), match_all_.end());
+  MatchList(unindexed_, url, ids);
+
+  // URLPattern matches filesystem: URLs against their inner origin.
+  const GURL* origin = &url;
+  if (url.SchemeIsFileSystem() && url.inner_url())
+    origin = url.inner_url();
+  const std::string host = origin->host();
+  if (host.empty())
+    return;
+
+  HostMap::const_iterator found = exact_hosts_.find(host);
+  if (found != exact_hosts_.end())
+    MatchList(found->second, url, ids);
+
+  // Look up "a.b.example.com", "b.example.com", "example.com" and "com".
+  for (size_t start = 0; start != std::string::npos;) {
+    found = domain_hosts_.find(host.substr(start));
+    if (found != domain_hosts_.end())
+      MatchList(found->second, url, ids);
+    start = host.find('.', start);
+    if (start != std::string::npos)
+      ++start;
+  }
+}
+
+// static
+void URLPatternIndex::MatchList(const PatternList& patterns,
+                                const GURL& url,
+                                std::set<ID>* ids) {
+  for (PatternList::const_iterator it = patterns.begin();
+       it != patterns.end(); ++it) {
+    if (ids->count(it->first) == 0 && it->second.MatchesURL(url))
+      ids->insert(it->first);
+  }
+}
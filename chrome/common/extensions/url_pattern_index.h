@@ -0,0 +1,72 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_COMMON_EXTENSIONS_URL_PATTERN_INDEX_H_
+#define CHROME_COMMON_EXTENSIONS_URL_PATTERN_INDEX_H_
+#pragma once
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/hash_tables.h"
+#include "chrome/common/extensions/url_pattern.h"
+
+class GURL;
+class URLPatternSet;
+
+// Answers "which of these URLPatternSets match this URL?" for many sets at
+// once without testing every pattern. Patterns are bucketed by the host they
+// name, so a lookup only evaluates the patterns registered for the URL's host
+// and its parent domains, plus the few patterns that can't be bucketed
+// (<all_urls>, "*://*/*", file: patterns).
+//
+// The index is a snapshot: it copies the patterns it is given and must be
+// rebuilt when the sets change.
+class URLPatternIndex {
+ public:
+  typedef int ID;
+
+  URLPatternIndex();
+  ~URLPatternIndex();
+
+  // Adds the patterns of |patterns| under |id|. An empty set matches every
+  // URL, which is how URL filters treat a missing "urls" list.
+  void Add(ID id, const URLPatternSet& patterns);
+
+  // Removes everything from the index.
+  void Clear();
+
+  // Inserts into |ids| the ID of every set that has a pattern matching |url|.
+  // The result is exact; callers need not re-check the sets.
+  void Match(const GURL& url, std::set<ID>* ids) const;
+
+ private:
+  typedef std::vector<std::pair<ID, URLPattern> > PatternList;
+  typedef base::hash_map<std::string, PatternList> HostMap;
+
+  // Tests the patterns in |patterns| against |url|, skipping IDs that have
+  // already matched.
+  static void MatchList(const PatternList& patterns,
+                        const GURL& url,
+                        std::set<ID>* ids);
+
+  // Patterns that only match a single host, keyed by that host.
+  HostMap exact_hosts_;
+
+  // Patterns of the form "*.example.com", keyed by "example.com".
+  HostMap domain_hosts_;
+
+  // Patterns that may match any host.
+  PatternList unindexed_;
+
+  // IDs added with an empty set.
+  std::vector<ID> match_all_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternIndex);
+};
+
+#endif  // CHROME_COMMON_EXTENSIONS_URL_PATTERN_INDEX_H_
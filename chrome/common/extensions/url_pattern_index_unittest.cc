@@ -0,0 +1,108 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/common/extensions/url_pattern_index.h"
+
+#include "chrome/common/extensions/url_pattern_set.h"
+#include "googleurl/src/gurl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+URLPatternSet MakeSet(const char* pattern1, const char* pattern2) {
+  URLPatternSet set;
+  set.AddPattern(URLPattern(URLPattern::SCHEME_ALL, pattern1));
+  if (pattern2)
+    set.AddPattern(URLPattern(URLPattern::SCHEME_ALL, pattern2));
+  return set;
+}
+
+std::set<URLPatternIndex::ID> Match(const URLPatternIndex& index,
+                                    const char* url) {
+  std::set<URLPatternIndex::ID> ids;
+  index.Match(GURL(url), &ids);
+  return ids;
+}
+
+}  // namespace
+
+TEST(URLPatternIndexTest, Hosts) {
+  URLPatternIndex index;
+  index.Add(1, MakeSet("http://www.google.com/*", NULL));
+  index.Add(2, MakeSet("*://*.google.com/mail/*", "http://yahoo.com/*"));
+  index.Add(3, MakeSet("https://*.com/*", NULL));
+
+  std::set<URLPatternIndex::ID> ids = Match(index, "http://www.google.com/");
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(1u, ids.count(1));
+
+  ids = Match(index, "https://mail.google.com/mail/u/0");
+  ASSERT_EQ(2u, ids.size());
+  EXPECT_EQ(1u, ids.count(2));
+  EXPECT_EQ(1u, ids.count(3));
+
+  // "*.google.com" matches google.com itself.
+  ids = Match(index, "http://google.com/mail/");
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(1u, ids.count(2));
+
+  ids = Match(index, "http://yahoo.com/");
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(1u, ids.count(2));
+
+  EXPECT_TRUE(Match(index, "http://notgoogle.com/mail/").empty());
+  EXPECT_TRUE(Match(index, "http://www.google.com.evil.org/").empty());
+}
+
+TEST(URLPatternIndexTest, Unindexed) {
+  URLPatternIndex index;
+  index.Add(1, URLPatternSet());
+  index.Add(2, MakeSet("<all_urls>", NULL));
+  index.Add(3, MakeSet("*://*/*.js", NULL));
+  index.Add(4, MakeSet("file:///tmp/*", NULL));
+
+  std::set<URLPatternIndex::ID> ids = Match(index, "http://example.com/a.js");
+  ASSERT_EQ(3u, ids.size());
+  EXPECT_EQ(0u, ids.count(4));
+
+  ids = Match(index, "file:///tmp/a.html");
+  ASSERT_EQ(3u, ids.size());
+  EXPECT_EQ(0u, ids.count(3));
+
+  index.Clear();
+  EXPECT_TRUE(Match(index, "http://example.com/a.js").empty());
+}
+
+TEST(URLPatternIndexTest, AgreesWithURLPatternSet) {
+  const char* kPatterns[] = {
+    "http://www.google.com/*",
+    "*://*.google.com/*",
+    "https://*/secure/*",
+    "http://127.0.0.1/*",
+    "http://*.0.0.1/*",
+    "*://*.co.uk:8080/*",
+  };
+  const char* kURLs[] = {
+    "http://www.google.com/search",
+    "https://docs.google.com/",
+    "https://example.com/secure/page",
+    "http://127.0.0.1/",
+    "http://bbc.co.uk:8080/",
+    "http://bbc.co.uk/",
+    "filesystem:http://www.google.com/temporary/file",
+    "ftp://www.google.com/",
+  };
+
+  URLPatternIndex index;
+  for (size_t i = 0; i < arraysize(kPatterns); ++i)
+    index.Add(i, MakeSet(kPatterns[i], NULL));
+
+  for (size_t i = 0; i < arraysize(kURLs); ++i) {
+    std::set<URLPatternIndex::ID> ids = Match(index, kURLs[i]);
+    for (size_t j = 0; j < arraysize(kPatterns); ++j) {
+      EXPECT_EQ(MakeSet(kPatterns[j], NULL).MatchesURL(GURL(kURLs[i])),
+                ids.count(j) == 1) << kURLs[i] << " " << kPatterns[j];
+    }
+  }
+}
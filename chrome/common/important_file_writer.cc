@@ -1,4 +1,4 @@
-// Copyright (c) 2011 The Chromium Authors. All rights reserved.
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
@@ -8,6 +8,7 @@
 
 #include <string>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
@@ -19,6 +20,7 @@
 #include "base/time.h"
 
 using base::TimeDelta;
+using base::TimeTicks;
 
 namespace {
 
@@ -41,15 +43,58 @@ void LogFailure(const FilePath& path, TempFileFailure failure_code,
                  << " : " << message;
 }
 
-void WriteToDiskTask(const FilePath& path, const std::string& data) {
+// Records |time| in the histogram |name| for the file at |path|.
+void RecordTimeForFile(const std::string& name,
+                       const FilePath& path,
+                       TimeDelta time) {
+  base::Histogram* histogram = base::Histogram::FactoryTimeGet(
+      name + "." + path.BaseName().MaybeAsASCII(),
+      TimeDelta::FromMilliseconds(1), TimeDelta::FromSeconds(10), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+  histogram->AddTime(time);
+}
+
+}  // namespace
+
+// The number of the latest write posted to the blocking task runner. A write
+// that has been superseded by the time it runs is skipped, since the write
+// that superseded it is queued behind it.
+class ImportantFileWriter::LatestWrite
+    : public base::RefCountedThreadSafe<LatestWrite> {
+ public:
+  LatestWrite() : number_(0) {}
+
+  // Makes a new write the latest one, and returns its number.
+  int Next() {
+    return base::subtle::Barrier_AtomicIncrement(&number_, 1);
+  }
+
+  bool IsLatest(int number) const {
+    return base::subtle::Acquire_Load(&number_) == number;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<LatestWrite>;
+
+  ~LatestWrite() {}
+
+  base::subtle::Atomic32 number_;
+
+  DISALLOW_COPY_AND_ASSIGN(LatestWrite);
+};
+
+// static
+bool ImportantFileWriter::WriteFileAtomically(const FilePath& path,
+                                              const std::string& data) {
   // Write the data to a temp file then rename to avoid data loss if we crash
   // while writing the file. Ensure that the temp file is on the same volume
   // as target file, so it can be moved in one step, and that the temp file
   // is securely created.
+  TimeTicks start_time = TimeTicks::Now();
   FilePath tmp_file_path;
   if (!file_util::CreateTemporaryFileInDir(path.DirName(), &tmp_file_path)) {
     LogFailure(path, FAILED_CREATING, "could not create temporary file");
-    return;
+    return false;
   }
 
   int flags = base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_WRITE;
@@ -57,7 +102,7 @@ void WriteToDiskTask(const FilePath& path, const std::string& data) {
       base::CreatePlatformFile(tmp_file_path, flags, NULL, NULL);
   if (tmp_file == base::kInvalidPlatformFileValue) {
     LogFailure(path, FAILED_OPENING, "could not open temporary file");
-    return;
+    return false;
   }
 
   // If this happens in the wild something really bad is going on.
@@ -69,24 +114,56 @@ void WriteToDiskTask(const FilePath& path, const std::string& data) {
   if (!base::ClosePlatformFile(tmp_file)) {
     LogFailure(path, FAILED_CLOSING, "failed to close temporary file");
     file_util::Delete(tmp_file_path, false);
-    return;
+    return false;
   }
 
   if (bytes_written < static_cast<int>(data.length())) {
     LogFailure(path, FAILED_WRITING, "error writing, bytes_written=" +
                base::IntToString(bytes_written));
     file_util::Delete(tmp_file_path, false);
-    return;
+    return false;
   }
 
   if (!file_util::ReplaceFile(tmp_file_path, path)) {
     LogFailure(path, FAILED_RENAMING, "could not rename temporary file");
     file_util::Delete(tmp_file_path, false);
-    return;
+    return false;
   }
+  RecordTimeForFile("ImportantFile.WriteTime", path,
+                    TimeTicks::Now() - start_time);
+  return true;
 }
 
-}  // namespace
+// static
+void ImportantFileWriter::WriteIfLatest(
+    const FilePath& path,
+    scoped_refptr<LatestWrite> latest_write,
+    int number,
+    const std::string& data) {
+  if (latest_write->IsLatest(number))
+    WriteFileAtomically(path, data);
+}
+
+// static
+void ImportantFileWriter::SerializeAndWriteIfLatest(
+    const FilePath& path,
+    scoped_refptr<LatestWrite> latest_write,
+    int number,
+    const DataProducer& producer) {
+  if (!latest_write->IsLatest(number))
+    return;
+
+  TimeTicks start_time = TimeTicks::Now();
+  std::string data;
+  if (!producer.Run(&data)) {
+    DLOG(WARNING) << "failed to serialize data to be saved in "
+                  << path.value();
+    return;
+  }
+  RecordTimeForFile("ImportantFile.SerializeTime", path,
+                    TimeTicks::Now() - start_time);
+  WriteFileAtomically(path, data);
+}
 
 ImportantFileWriter::ImportantFileWriter(
     const FilePath& path,
@@ -94,6 +171,8 @@ ImportantFileWriter::ImportantFileWriter(
     : path_(path),
       blocking_task_runner_(blocking_task_runner),
       serializer_(NULL),
+      background_serializer_(NULL),
+      latest_write_(new LatestWrite),
       commit_interval_(TimeDelta::FromMilliseconds(
           kDefaultCommitIntervalMs)) {
   DCHECK(CalledOnValidThread());
@@ -122,15 +201,8 @@ void ImportantFileWriter::WriteNow(const std::string& data) {
   if (HasPendingWrite())
     timer_.Stop();
 
-  if (!blocking_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&WriteToDiskTask, path_, data))) {
-    // Posting the task to background message loop is not expected
-    // to fail, but if it does, avoid losing data and just hit the disk
-    // on the current thread.
-    NOTREACHED();
-
-    WriteToDiskTask(path_, data);
-  }
+  PostWriteTask(base::Bind(&WriteIfLatest, path_, latest_write_,
+                           latest_write_->Next(), data));
 }
 
 void ImportantFileWriter::ScheduleWrite(DataSerializer* serializer) {
@@ -138,6 +210,21 @@ void ImportantFileWriter::ScheduleWrite(DataSerializer* serializer) {
 
   DCHECK(serializer);
   serializer_ = serializer;
+  background_serializer_ = NULL;
+
+  if (!timer_.IsRunning()) {
+    timer_.Start(FROM_HERE, commit_interval_, this,
+                 &ImportantFileWriter::DoScheduledWrite);
+  }
+}
+
+void ImportantFileWriter::ScheduleWriteWithBackgroundSerializer(
+    BackgroundDataSerializer* serializer) {
+  DCHECK(CalledOnValidThread());
+
+  DCHECK(serializer);
+  serializer_ = NULL;
+  background_serializer_ = serializer;
 
   if (!timer_.IsRunning()) {
     timer_.Start(FROM_HERE, commit_interval_, this,
@@ -146,13 +233,37 @@ void ImportantFileWriter::ScheduleWrite(DataSerializer* serializer) {
 }
 
 void ImportantFileWriter::DoScheduledWrite() {
-  DCHECK(serializer_);
-  std::string data;
-  if (serializer_->SerializeData(&data)) {
-    WriteNow(data);
+  DCHECK(serializer_ || background_serializer_);
+  if (background_serializer_) {
+    if (HasPendingWrite())
+      timer_.Stop();
+    PostWriteTask(base::Bind(
+        &SerializeAndWriteIfLatest, path_, latest_write_,
+        latest_write_->Next(),
+        background_serializer_->GetSerializedDataProducer()));
   } else {
-    DLOG(WARNING) << "failed to serialize data to be saved in "
-                  << path_.value();
+    TimeTicks start_time = TimeTicks::Now();
+    std::string data;
+    if (serializer_->SerializeData(&data)) {
+      RecordTimeForFile("ImportantFile.SerializeTime", path_,
+                        TimeTicks::Now() - start_time);
+      WriteNow(data);
+    } else {
+      DLOG(WARNING) << "failed to serialize data to be saved in "
+                    << path_.value();
+    }
   }
   serializer_ = NULL;
+  background_serializer_ = NULL;
+}
+
+void ImportantFileWriter::PostWriteTask(const base::Closure& task) {
+  if (!blocking_task_runner_->PostTask(FROM_HERE, task)) {
+    // Posting the task to background message loop is not expected
+    // to fail, but if it does, avoid losing data and just hit the disk
+    // on the current thread.
+    NOTREACHED();
+
+    task.Run();
+  }
 }
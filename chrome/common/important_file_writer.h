@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/callback_forward.h"
 #include "base/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/threading/non_thread_safe.h"
@@ -36,8 +37,17 @@ class Thread;
 //
 // If you want to know more about this approach and ext3/ext4 fsync issues, see
 // http://valhenson.livejournal.com/37921.html
+//
+// Writes are run in order on the blocking task runner. A write that has been
+// superseded by a newer one by the time it runs is skipped, so a burst of
+// writes to the file costs one write to disk. The time taken to serialize and
+// to write the data is recorded per file, in the ImportantFile.SerializeTime
+// and ImportantFile.WriteTime histograms suffixed with the file name.
 class ImportantFileWriter : public base::NonThreadSafe {
  public:
+  // Puts serialized data in its argument and returns true on success.
+  typedef base::Callback<bool(std::string*)> DataProducer;
+
   // Used by ScheduleSave to lazily provide the data to be saved. Allows us
   // to also batch data serializations.
   class DataSerializer {
@@ -50,6 +60,25 @@ class ImportantFileWriter : public base::NonThreadSafe {
     virtual bool SerializeData(std::string* data) = 0;
   };
 
+  // Used by ScheduleWriteWithBackgroundSerializer to take a snapshot of the
+  // data on the writer's thread, and serialize the snapshot on the blocking
+  // task runner. Suits data that is much cheaper to copy than to serialize.
+  class BackgroundDataSerializer {
+   public:
+    virtual ~BackgroundDataSerializer() {}
+
+    // Should return a DataProducer that serializes a snapshot of the data as
+    // it is now. Will be called on the same thread on which
+    // ImportantFileWriter has been created; the DataProducer is run on the
+    // blocking task runner, so it must own everything it uses.
+    virtual DataProducer GetSerializedDataProducer() = 0;
+  };
+
+  // Save |data| to |path| in an atomic manner (see the class comment above).
+  // Blocks and writes data on the current thread.
+  static bool WriteFileAtomically(const FilePath& path,
+                                  const std::string& data);
+
   // Initialize the writer.
   // |path| is the name of file to write.
   // |file_message_loop_proxy| is the MessageLoopProxy for a thread on which
@@ -80,6 +109,12 @@ class ImportantFileWriter : public base::NonThreadSafe {
   // ImportantFileWriter.
   void ScheduleWrite(DataSerializer* serializer);
 
+  // Like ScheduleWrite, but only the snapshot is taken on this thread when the
+  // commit interval expires; the data is serialized on the blocking task
+  // runner.
+  void ScheduleWriteWithBackgroundSerializer(
+      BackgroundDataSerializer* serializer);
+
   // Serialize data pending to be saved and execute write on backend thread.
   void DoScheduledWrite();
 
@@ -92,6 +127,22 @@ class ImportantFileWriter : public base::NonThreadSafe {
   }
 
  private:
+  class LatestWrite;
+
+  // Posts |task| to the blocking task runner.
+  void PostWriteTask(const base::Closure& task);
+
+  // Write tasks for the blocking task runner. They do nothing if write
+  // |number| is no longer the latest one in |latest_write|.
+  static void WriteIfLatest(const FilePath& path,
+                            scoped_refptr<LatestWrite> latest_write,
+                            int number,
+                            const std::string& data);
+  static void SerializeAndWriteIfLatest(const FilePath& path,
+                                        scoped_refptr<LatestWrite> latest_write,
+                                        int number,
+                                        const DataProducer& producer);
+
   // Path being written to.
   const FilePath path_;
 
@@ -101,8 +152,13 @@ class ImportantFileWriter : public base::NonThreadSafe {
   // Timer used to schedule commit after ScheduleWrite.
   base::OneShotTimer<ImportantFileWriter> timer_;
 
-  // Serializer which will provide the data to be saved.
+  // Serializer which will provide the data to be saved. At most one of these
+  // is set.
   DataSerializer* serializer_;
+  BackgroundDataSerializer* background_serializer_;
+
+  // Number of the latest write posted to |blocking_task_runner_|.
+  scoped_refptr<LatestWrite> latest_write_;
 
   // Time delta after which scheduled data will be written to disk.
   base::TimeDelta commit_interval_;
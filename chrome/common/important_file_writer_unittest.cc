@@ -4,6 +4,7 @@
 
 #include "chrome/common/important_file_writer.h"
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
@@ -38,6 +39,33 @@ class DataSerializer : public ImportantFileWriter::DataSerializer {
   const std::string data_;
 };
 
+bool ProduceData(const std::string& data, int* produce_count,
+                 std::string* output) {
+  ++*produce_count;
+  output->assign(data);
+  return true;
+}
+
+class BackgroundDataSerializer
+    : public ImportantFileWriter::BackgroundDataSerializer {
+ public:
+  explicit BackgroundDataSerializer(const std::string& data)
+      : data_(data),
+        produce_count_(0) {
+  }
+
+  virtual ImportantFileWriter::DataProducer GetSerializedDataProducer() {
+    return base::Bind(&ProduceData, data_, &produce_count_);
+  }
+
+  // Number of times data was serialized.
+  int produce_count() const { return produce_count_; }
+
+ private:
+  const std::string data_;
+  int produce_count_;
+};
+
 }  // namespace
 
 class ImportantFileWriterTest : public testing::Test {
@@ -120,3 +148,33 @@ TEST_F(ImportantFileWriterTest, DISABLED_BatchingWrites) {
   ASSERT_TRUE(file_util::PathExists(writer.path()));
   EXPECT_EQ("baz", GetFileContent(writer.path()));
 }
+
+TEST_F(ImportantFileWriterTest, BackgroundSerializer) {
+  ImportantFileWriter writer(file_,
+                             base::MessageLoopProxy::current());
+  BackgroundDataSerializer serializer("foo");
+  writer.ScheduleWriteWithBackgroundSerializer(&serializer);
+  EXPECT_TRUE(writer.HasPendingWrite());
+  writer.DoScheduledWrite();
+  EXPECT_FALSE(writer.HasPendingWrite());
+  // Serialization happens on the blocking task runner.
+  EXPECT_EQ(0, serializer.produce_count());
+  loop_.RunAllPending();
+  EXPECT_EQ(1, serializer.produce_count());
+  ASSERT_TRUE(file_util::PathExists(writer.path()));
+  EXPECT_EQ("foo", GetFileContent(writer.path()));
+}
+
+TEST_F(ImportantFileWriterTest, CoalescesPendingWrites) {
+  ImportantFileWriter writer(file_,
+                             base::MessageLoopProxy::current());
+  BackgroundDataSerializer foo("foo");
+  writer.ScheduleWriteWithBackgroundSerializer(&foo);
+  writer.DoScheduledWrite();
+  writer.WriteNow("bar");
+  loop_.RunAllPending();
+  // The first write was superseded before it ran, so it was never serialized.
+  EXPECT_EQ(0, foo.produce_count());
+  ASSERT_TRUE(file_util::PathExists(writer.path()));
+  EXPECT_EQ("bar", GetFileContent(writer.path()));
+}
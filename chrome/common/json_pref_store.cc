@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/file_util.h"
 #include "base/json/json_file_value_serializer.h"
@@ -134,6 +135,13 @@ void FileThreadDeserializer::HandleErrors(
   }
 }
 
+// Serializes |prefs| into |output|. Runs on the blocking task runner.
+bool SerializePrefs(const DictionaryValue* prefs, std::string* output) {
+  JSONStringValueSerializer serializer(output);
+  serializer.set_pretty_print(true);
+  return serializer.Serialize(*prefs);
+}
+
 }  // namespace
 
 JsonPrefStore::JsonPrefStore(const FilePath& filename,
@@ -199,7 +207,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key, Value* value) {
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, new_value.release());
     if (!read_only_)
-      writer_.ScheduleWrite(this);
+      writer_.ScheduleWriteWithBackgroundSerializer(this);
   }
 }
 
@@ -256,7 +264,7 @@ void JsonPrefStore::CommitPendingWrite() {
 void JsonPrefStore::ReportValueChanged(const std::string& key) {
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
   if (!read_only_)
-    writer_.ScheduleWrite(this);
+    writer_.ScheduleWriteWithBackgroundSerializer(this);
 }
 
 void JsonPrefStore::OnFileRead(Value* value_owned,
@@ -308,12 +316,10 @@ JsonPrefStore::~JsonPrefStore() {
   CommitPendingWrite();
 }
 
-bool JsonPrefStore::SerializeData(std::string* output) {
+ImportantFileWriter::DataProducer JsonPrefStore::GetSerializedDataProducer() {
   // TODO(tc): Do we want to prune webkit preferences that match the default
   // value?
-  JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
-  scoped_ptr<DictionaryValue> copy(prefs_->DeepCopyWithoutEmptyChildren());
+  DictionaryValue* copy = prefs_->DeepCopyWithoutEmptyChildren();
 
   // Iterates |keys_need_empty_value_| and if the key exists in |prefs_|,
   // ensure its empty ListValue or DictonaryValue is preserved.
@@ -338,5 +344,5 @@ bool JsonPrefStore::SerializeData(std::string* output) {
     }
   }
 
-  return serializer.Serialize(*(copy.get()));
+  return base::Bind(&SerializePrefs, base::Owned(copy));
 }
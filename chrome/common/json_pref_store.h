@@ -27,7 +27,7 @@ class FilePath;
 
 // A writable PrefStore implementation that is used for user preferences.
 class JsonPrefStore : public PersistentPrefStore,
-                      public ImportantFileWriter::DataSerializer {
+                      public ImportantFileWriter::BackgroundDataSerializer {
  public:
   // |blocking_task_runner| is the SequencedTaskRunner on which file
   // I/O can be done.
@@ -66,8 +66,9 @@ class JsonPrefStore : public PersistentPrefStore,
  private:
   virtual ~JsonPrefStore();
 
-  // ImportantFileWriter::DataSerializer overrides:
-  virtual bool SerializeData(std::string* output) OVERRIDE;
+  // ImportantFileWriter::BackgroundDataSerializer overrides:
+  virtual ImportantFileWriter::DataProducer GetSerializedDataProducer()
+      OVERRIDE;
 
   FilePath path_;
   scoped_refptr<base::SequencedTaskRunner> blocking_task_runner_;
@@ -383,6 +383,10 @@ const char kDnsHostReferralList[] = "HostReferralList";
 const char kDnsPrefetchingHostReferralList[] =
     "dns_prefetching.host_referral_list";
 
+// A snapshot of the host resolver cache, restored at the next startup so that
+// the first navigations do not wait for DNS.
+const char kDnsPrefetchingHostCache[] = "dns_prefetching.host_cache";
+
 // Disables the SPDY protocol.
 const char kDisableSpdy[] = "spdy.disabled";
 
@@ -990,6 +994,9 @@ const char kTLS1Enabled[] = "ssl.tls1.enabled";
 const char kCipherSuiteBlacklist[] = "ssl.cipher_suites.blacklist";
 const char kEnableOriginBoundCerts[] = "ssl.origin_bound_certs.enabled";
 const char kDisableSSLRecordSplitting[] = "ssl.ssl_record_splitting.disabled";
+// The secret that protects the TLS sessions saved in the disk cache, encrypted
+// with the Encryptor and base64 encoded.
+const char kSSLSessionPersistenceSecret[] = "ssl.session_persistence.secret";
 
 // The metrics client GUID and session ID.
 const char kMetricsClientID[] = "user_experience_metrics.client_id";
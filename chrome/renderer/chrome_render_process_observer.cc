@@ -9,6 +9,7 @@
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/message_loop.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/weak_ptr.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
@@ -35,7 +36,6 @@
 #include "net/base/net_errors.h"
 #include "net/base/net_module.h"
 #include "third_party/sqlite/sqlite3.h"
-#include "third_party/tcmalloc/chromium/src/gperftools/heap-profiler.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebCache.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebCrossOriginPreflightResultCache.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebDocument.h"
@@ -43,6 +43,7 @@
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebFrame.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebRuntimeFeatures.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebView.h"
+#include "ui/base/resource/resource_bundle.h"
 #include "v8/include/v8.h"
 
 #if defined(OS_WIN)
@@ -259,38 +260,41 @@ void ChromeRenderProcessObserver::OnGetCacheResourceStats() {
   WebCache::ResourceTypeStats stats;
   WebCache::getResourceTypeStats(&stats);
   RenderThread::Get()->Send(new ChromeViewHostMsg_ResourceTypeStats(stats));
+
+  // The browser asks every renderer for these at each metrics upload, so
+  // sample the memory used by resource images here too.
+  size_t decoded_bytes = 0;
+  size_t mapped_bytes = 0;
+  ResourceBundle::GetSharedInstance().GetImageMemoryStats(&decoded_bytes,
+                                                          &mapped_bytes);
+  UMA_HISTOGRAM_MEMORY_KB("Memory.Renderer.ResourceImagesPrivate",
+                          decoded_bytes / 1024);
+  UMA_HISTOGRAM_MEMORY_KB("Memory.Renderer.ResourceImagesShared",
+                          mapped_bytes / 1024);
 }
 
 #if defined(USE_TCMALLOC)
 void ChromeRenderProcessObserver::OnSetTcmallocHeapProfiling(
     bool profiling, const std::string& filename_prefix) {
-#if !defined(OS_WIN)
-  // TODO(stevenjb): Create MallocExtension wrappers for HeapProfile functions.
   if (profiling)
-    HeapProfilerStart(filename_prefix.c_str());
+    base::allocator::StartHeapProfiling(filename_prefix.c_str());
   else
-    HeapProfilerStop();
-#endif
+    base::allocator::StopHeapProfiling();
 }
 
 void ChromeRenderProcessObserver::OnWriteTcmallocHeapProfile(
     const FilePath::StringType& filename) {
-#if !defined(OS_WIN)
-  // TODO(stevenjb): Create MallocExtension wrappers for HeapProfile functions.
-  if (!IsHeapProfilerRunning())
+  if (!base::allocator::IsHeapProfilingRunning())
     return;
-  char* profile = GetHeapProfile();
-  if (!profile) {
+  // The render process can not write to a file, so copy the result into
+  // a string and pass it to the handler (which runs on the browser host).
+  std::string result;
+  if (!base::allocator::GetHeapProfile(&result)) {
     LOG(WARNING) << "Unable to get heap profile.";
     return;
   }
-  // The render process can not write to a file, so copy the result into
-  // a string and pass it to the handler (which runs on the browser host).
-  std::string result(profile);
-  delete profile;
   RenderThread::Get()->Send(
       new ChromeViewHostMsg_WriteTcmallocHeapProfile_ACK(filename, result));
-#endif
 }
 
 #endif
@@ -312,6 +316,11 @@ void ChromeRenderProcessObserver::OnGetV8HeapStats() {
 void ChromeRenderProcessObserver::OnPurgeMemory() {
   RenderThread::Get()->EnsureWebKitInitialized();
 
+  // Let the renderer's own caches, such as the spellchecker's dictionary,
+  // know too.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+
   // Clear the object cache (as much as possible; some live objects cannot be
   // freed).
   WebCache::clear();
@@ -133,6 +133,7 @@ void UserScriptSlave::GetActiveExtensions(
 
 bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
   scripts_.clear();
+  script_index_.Clear();
 
   bool only_inject_incognito =
       ChromeRenderProcessObserver::is_incognito_process();
@@ -192,6 +193,10 @@ bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
     }
   }
 
+  for (size_t i = 0; i < scripts_.size(); ++i)
+    script_index_.Add(static_cast<URLPatternIndex::ID>(i),
+                      scripts_[i]->url_patterns());
+
   // Push user styles down into WebCore
   RenderThread::Get()->EnsureWebKitInitialized();
   WebView::removeAllUserContent();
@@ -259,9 +264,15 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
   int num_css = 0;
   int num_scripts = 0;
 
-  for (size_t i = 0; i < scripts_.size(); ++i) {
+  // Only scripts whose "matches" patterns accept the URL can run. IDs are
+  // indices into |scripts_|, so this keeps the injection order.
+  std::set<URLPatternIndex::ID> candidates;
+  script_index_.Match(data_source_url, &candidates);
+
+  for (std::set<URLPatternIndex::ID>::const_iterator i = candidates.begin();
+       i != candidates.end(); ++i) {
     std::vector<WebScriptSource> sources;
-    UserScript* script = scripts_[i];
+    UserScript* script = scripts_[*i];
 
     if (frame->parent() && !script->match_all_frames())
       continue;  // Only match subframes if the script declared it wanted to.
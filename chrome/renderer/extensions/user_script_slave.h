@@ -15,6 +15,7 @@
 #include "base/shared_memory.h"
 #include "base/stl_util.h"
 #include "base/string_piece.h"
+#include "chrome/common/extensions/url_pattern_index.h"
 #include "chrome/common/extensions/user_script.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebScriptSource.h"
 
@@ -73,6 +74,10 @@ class UserScriptSlave {
   std::vector<UserScript*> scripts_;
   STLElementDeleter<std::vector<UserScript*> > script_deleter_;
 
+  // The "matches" patterns of |scripts_|, keyed by index into |scripts_|, so
+  // that a frame load only looks at scripts that can apply to its host.
+  URLPatternIndex script_index_;
+
   // Greasemonkey API source that is injected with the scripts.
   base::StringPiece api_js_;
 
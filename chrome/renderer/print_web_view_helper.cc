@@ -7,10 +7,12 @@
 #include <string>
 
 #include "base/auto_reset.h"
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/string_number_conversions.h"
+#include "base/threading/worker_pool.h"
 #include "base/utf_string_conversions.h"
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/print_messages.h"
@@ -674,10 +676,15 @@ PrintWebViewHelper::PrintWebViewHelper(content::RenderView* render_view)
       user_cancelled_scripted_print_count_(0),
       is_scripted_printing_blocked_(false),
       notify_browser_of_print_failure_(true),
-      print_for_preview_(false) {
+      print_for_preview_(false),
+      pending_page_number_(-1),
+      pending_page_success_(false),
+      pending_page_serialized_(false, false) {
 }
 
-PrintWebViewHelper::~PrintWebViewHelper() {}
+PrintWebViewHelper::~PrintWebViewHelper() {
+  CancelPreviewPage();
+}
 
 bool PrintWebViewHelper::IsScriptInitiatedPrintAllowed(
     WebKit::WebFrame* frame) {
@@ -881,7 +888,10 @@ void PrintWebViewHelper::OnPrintPreview(const DictionaryValue& settings) {
   }
   print_preview_context_.set_generate_draft_pages(generate_draft_pages);
 
-  if (CreatePreviewDocument()) {
+  bool success = CreatePreviewDocument();
+  // Rendering may have stopped while a page was being serialized.
+  CancelPreviewPage();
+  if (success) {
     DidFinishPrinting(OK);
   } else {
     if (notify_browser_of_print_failure_)
@@ -952,13 +962,18 @@ bool PrintWebViewHelper::CreatePreviewDocument() {
     // generate draft pages for PDFs, so IsFinalPageRendered() and
     // IsLastPageOfPrintReadyMetafile() will be true in the same iteration of
     // the loop.
-    if (print_preview_context_.IsFinalPageRendered())
+    if (print_preview_context_.IsFinalPageRendered()) {
+      if (!FlushPreviewPage())
+        return false;
       print_preview_context_.AllPagesRendered();
+    }
 
     if (print_preview_context_.IsLastPageOfPrintReadyMetafile()) {
       DCHECK(print_preview_context_.IsModifiable() ||
              print_preview_context_.IsFinalPageRendered());
-      if (!FinalizePrintReadyDocument())
+      // The draft page being serialized shares its content with the print
+      // ready document.
+      if (!FlushPreviewPage() || !FinalizePrintReadyDocument())
         return false;
     }
   }
@@ -1594,15 +1609,81 @@ bool PrintWebViewHelper::PreviewPageRendered(int page_number,
       print_pages_params_->params.preview_request_id;
 
   Send(new PrintHostMsg_DidPreviewPage(routing_id(), preview_page_params));
+  print_preview_context_.SentPreviewPage();
+  return true;
+}
+
+bool PrintWebViewHelper::PreviewPageRenderedAsync(
+    int page_number, printing::Metafile* metafile) {
+  DCHECK(metafile);
+  scoped_ptr<printing::Metafile> owned_metafile(metafile);
+  if (!FlushPreviewPage())
+    return false;
+
+  pending_page_number_ = page_number;
+  pending_page_metafile_.swap(owned_metafile);
+  base::WorkerPool::PostTask(
+      FROM_HERE,
+      base::Bind(&PrintWebViewHelper::SerializePreviewPage,
+                 pending_page_metafile_.get(), &pending_page_success_,
+                 &pending_page_serialize_time_, &pending_page_serialized_),
+      true);
+
+  // Let the browser show something as soon as possible.
+  if (!print_preview_context_.HasSentPreviewPage())
+    return FlushPreviewPage();
   return true;
 }
 
+bool PrintWebViewHelper::FlushPreviewPage() {
+  if (pending_page_number_ < 0)
+    return true;
+
+  base::TimeTicks begin_time = base::TimeTicks::Now();
+  pending_page_serialized_.Wait();
+  UMA_HISTOGRAM_TIMES("PrintPreview.SerializePDFPageWaitTime",
+                      base::TimeTicks::Now() - begin_time);
+  UMA_HISTOGRAM_TIMES("PrintPreview.SerializePDFPageTime",
+                      pending_page_serialize_time_);
+
+  int page_number = pending_page_number_;
+  scoped_ptr<printing::Metafile> metafile(pending_page_metafile_.release());
+  pending_page_number_ = -1;
+  if (!pending_page_success_) {
+    LOG(ERROR) << "Draft page serialization failed";
+    print_preview_context_.set_error(
+        PREVIEW_ERROR_DRAFT_PAGE_SERIALIZATION_FAILED);
+    return false;
+  }
+  return PreviewPageRendered(page_number, metafile.get());
+}
+
+void PrintWebViewHelper::CancelPreviewPage() {
+  if (pending_page_number_ < 0)
+    return;
+  pending_page_serialized_.Wait();
+  pending_page_metafile_.reset();
+  pending_page_number_ = -1;
+}
+
+// static
+void PrintWebViewHelper::SerializePreviewPage(printing::Metafile* metafile,
+                                              bool* success,
+                                              base::TimeDelta* serialize_time,
+                                              base::WaitableEvent* done) {
+  base::TimeTicks begin_time = base::TimeTicks::Now();
+  *success = metafile->FinishDocument() && metafile->GetDataSize() > 0;
+  *serialize_time = base::TimeTicks::Now() - begin_time;
+  done->Signal();
+}
+
 PrintWebViewHelper::PrintPreviewContext::PrintPreviewContext()
     : frame_(NULL),
       total_page_count_(0),
       current_page_index_(0),
       generate_draft_pages_(true),
       print_ready_metafile_page_count_(0),
+      sent_page_count_(0),
       error_(PREVIEW_ERROR_NONE),
       state_(UNINITIALIZED) {
 }
@@ -1686,6 +1767,7 @@ bool PrintWebViewHelper::PrintPreviewContext::CreatePreviewDocument(
 
   document_render_time_ = base::TimeDelta();
   begin_time_ = base::TimeTicks::Now();
+  sent_page_count_ = 0;
 
   return true;
 }
@@ -1697,6 +1779,14 @@ void PrintWebViewHelper::PrintPreviewContext::RenderedPreviewPage(
   UMA_HISTOGRAM_TIMES("PrintPreview.RenderPDFPageTime", page_time);
 }
 
+void PrintWebViewHelper::PrintPreviewContext::SentPreviewPage() {
+  DCHECK(IsRendering());
+  if (sent_page_count_++ == 0) {
+    UMA_HISTOGRAM_MEDIUM_TIMES("PrintPreview.TimeToFirstPage",
+                               base::TimeTicks::Now() - begin_time_);
+  }
+}
+
 void PrintWebViewHelper::PrintPreviewContext::AllPagesRendered() {
   DCHECK_EQ(RENDERING, state_);
   state_ = DONE;
@@ -1768,6 +1858,10 @@ bool  PrintWebViewHelper::PrintPreviewContext::IsFinalPageRendered() const {
   return static_cast<size_t>(current_page_index_) == pages_to_render_.size();
 }
 
+bool PrintWebViewHelper::PrintPreviewContext::HasSentPreviewPage() const {
+  return sent_page_count_ > 0;
+}
+
 void PrintWebViewHelper::PrintPreviewContext::set_generate_draft_pages(
     bool generate_draft_pages) {
   DCHECK_EQ(INITIALIZED, state_);
@@ -10,6 +10,7 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/shared_memory.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/time.h"
 #include "content/public/renderer/render_view_observer.h"
 #include "content/public/renderer/render_view_observer_tracker.h"
@@ -126,6 +127,7 @@ class PrintWebViewHelper
     PREVIEW_ERROR_PAGE_RENDERED_WITHOUT_METAFILE,
     PREVIEW_ERROR_UPDATING_PRINT_SETTINGS,
     PREVIEW_ERROR_INVALID_PRINTER_SETTINGS,
+    PREVIEW_ERROR_DRAFT_PAGE_SERIALIZATION_FAILED,
     PREVIEW_ERROR_LAST_ENUM  // Always last.
   };
 
@@ -345,6 +347,26 @@ class PrintWebViewHelper
   // Returns true if print preview should continue, false on failure.
   bool PreviewPageRendered(int page_number, printing::Metafile* metafile);
 
+  // Like PreviewPageRendered(), but |metafile| is not finished yet. It is
+  // serialized on a worker thread while the next page renders, and sent by
+  // the next call or by FlushPreviewPage(). The first page of a document is
+  // sent right away. Takes ownership of |metafile|.
+  bool PreviewPageRenderedAsync(int page_number, printing::Metafile* metafile);
+
+  // Waits for the page passed to PreviewPageRenderedAsync() to be serialized
+  // and sends it. Returns false on failure.
+  bool FlushPreviewPage();
+
+  // Waits for the page passed to PreviewPageRenderedAsync() to be serialized
+  // and drops it.
+  void CancelPreviewPage();
+
+  // Runs on a worker thread to serialize a draft page.
+  static void SerializePreviewPage(printing::Metafile* metafile,
+                                   bool* success,
+                                   base::TimeDelta* serialize_time,
+                                   base::WaitableEvent* done);
+
   // WebView used only to print the selection.
   WebKit::WebView* print_web_view_;
 
@@ -365,6 +387,15 @@ class PrintWebViewHelper
   // True, when printing from print preview.
   bool print_for_preview_;
 
+  // The draft page being serialized by SerializePreviewPage(), if
+  // |pending_page_number_| is not -1. The other members are written by the
+  // worker thread before it signals |pending_page_serialized_|.
+  int pending_page_number_;
+  scoped_ptr<printing::Metafile> pending_page_metafile_;
+  bool pending_page_success_;
+  base::TimeDelta pending_page_serialize_time_;
+  base::WaitableEvent pending_page_serialized_;
+
   scoped_ptr<PrintMsg_PrintPages_Params> old_print_pages_params_;
 
   // Strings generated by the browser process to be printed as headers and
@@ -394,6 +425,9 @@ class PrintWebViewHelper
     // rendering took.
     void RenderedPreviewPage(const base::TimeDelta& page_time);
 
+    // Called after a page is sent to the browser.
+    void SentPreviewPage();
+
     // Updates the print preview context when the required pages are rendered.
     void AllPagesRendered();
 
@@ -412,6 +446,7 @@ class PrintWebViewHelper
     bool IsModifiable() const;
     bool IsLastPageOfPrintReadyMetafile() const;
     bool IsFinalPageRendered() const;
+    bool HasSentPreviewPage() const;
 
     // Setters
     void set_generate_draft_pages(bool generate_draft_pages);
@@ -464,6 +499,9 @@ class PrintWebViewHelper
     base::TimeDelta document_render_time_;
     base::TimeTicks begin_time_;
 
+    // Number of pages sent to the browser for the current document.
+    int sent_page_count_;
+
     enum PrintPreviewErrorBuckets error_;
 
     State state_;
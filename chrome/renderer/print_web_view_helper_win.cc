@@ -201,15 +201,15 @@ bool PrintWebViewHelper::RenderPreviewPage(int page_number) {
   print_preview_context_.RenderedPreviewPage(
       base::TimeTicks::Now() - begin_time);
 
-  if (draft_metafile.get()) {
-    draft_metafile->FinishDocument();
-  } else if (print_preview_context_.IsModifiable() &&
-             print_preview_context_.generate_draft_pages()) {
-    DCHECK(!draft_metafile.get());
-    draft_metafile.reset(
-        print_preview_context_.metafile()->GetMetafileForCurrentPage());
+  if (!draft_metafile.get() && print_preview_context_.IsModifiable() &&
+      print_preview_context_.generate_draft_pages()) {
+    draft_metafile.reset(print_preview_context_.metafile()->
+        GetUnfinishedMetafileForCurrentPage());
   }
-  return PreviewPageRendered(page_number, draft_metafile.get());
+  // The draft is serialized on a worker thread while the next page renders.
+  if (draft_metafile.get())
+    return PreviewPageRenderedAsync(page_number, draft_metafile.release());
+  return PreviewPageRendered(page_number, NULL);
 }
 
 Metafile* PrintWebViewHelper::RenderPage(
@@ -8,6 +8,7 @@
 #include "base/file_util.h"
 #include "base/metrics/histogram.h"
 #include "base/message_loop_proxy.h"
+#include "base/process_util.h"
 #include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "chrome/common/render_messages.h"
@@ -25,6 +26,25 @@ using WebKit::WebVector;
 using WebKit::WebTextCheckingResult;
 using WebKit::WebTextCheckingType;
 
+namespace {
+
+// Enough words for the paragraphs of a large document. Suggestions are only
+// kept for misspellings, which are rarer and bigger.
+const size_t kWordCacheSize = 4096;
+const size_t kSuggestionCacheSize = 256;
+
+base::ProcessMetrics* CreateCurrentProcessMetrics() {
+#if defined(OS_MACOSX)
+  return base::ProcessMetrics::CreateProcessMetrics(
+      base::GetCurrentProcessHandle(), NULL);
+#else
+  return base::ProcessMetrics::CreateProcessMetrics(
+      base::GetCurrentProcessHandle());
+#endif
+}
+
+}  // namespace
+
 namespace spellcheck {
 void ToWebResultList(
     int offset,
@@ -92,8 +112,12 @@ SpellCheck::SpellCheck()
     : file_(base::kInvalidPlatformFileValue),
       auto_spell_correct_turned_on_(false),
       is_using_platform_spelling_engine_(false),
+      word_cache_(kWordCacheSize),
+      suggestion_cache_(kSuggestionCacheSize),
       initialized_(false),
-      dictionary_requested_(false) {
+      dictionary_requested_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(memory_pressure_listener_(
+          base::Bind(&SpellCheck::OnMemoryPressure, base::Unretained(this)))) {
   // Wait till we check the first word before doing any initializing.
 }
 
@@ -128,12 +152,12 @@ void SpellCheck::OnWordAdded(const std::string& word) {
   if (is_using_platform_spelling_engine_)
     return;
 
-  if (!hunspell_.get()) {
-    // Save it for later---add it when hunspell is initialized.
-    custom_words_.push_back(word);
-  } else {
+  // Keep it for when hunspell is (re)initialized.
+  custom_words_.push_back(word);
+  if (hunspell_.get())
     AddWordToHunspell(word);
-  }
+  // The new word may also complete affixed forms that were misspelled.
+  ClearCaches();
 }
 
 void SpellCheck::OnEnableAutoSpellCorrect(bool enable) {
@@ -146,6 +170,7 @@ void SpellCheck::Init(base::PlatformFile file,
   initialized_ = true;
   hunspell_.reset();
   bdict_file_.reset();
+  ClearCaches();
   file_ = file;
   is_using_platform_spelling_engine_ =
       file == base::kInvalidPlatformFileValue && !language.empty();
@@ -353,7 +378,12 @@ void SpellCheck::InitializeHunspell() {
 
   if (bdict_file_->Initialize(file_)) {
     TimeTicks debug_start_time = base::Histogram::DebugNow();
+    scoped_ptr<base::ProcessMetrics> metrics(CreateCurrentProcessMetrics());
+    base::WorkingSetKBytes usage_before;
+    bool measured = metrics->GetWorkingSetKBytes(&usage_before);
 
+    // The dictionary is mapped read-only, so its pages are shared with every
+    // other renderer; only what Hunspell builds on top of it is private.
     hunspell_.reset(
         new Hunspell(bdict_file_->data(), bdict_file_->length()));
 
@@ -365,6 +395,13 @@ void SpellCheck::InitializeHunspell() {
 
     DHISTOGRAM_TIMES("Spellcheck.InitTime",
                      base::Histogram::DebugNow() - debug_start_time);
+    // The sandbox can keep a renderer from reading its own memory usage.
+    base::WorkingSetKBytes usage_after;
+    if (measured && metrics->GetWorkingSetKBytes(&usage_after) &&
+        usage_after.priv >= usage_before.priv) {
+      UMA_HISTOGRAM_MEMORY_KB("SpellCheck.HunspellPrivateMemory",
+                              usage_after.priv - usage_before.priv);
+    }
   } else {
     NOTREACHED() << "Could not mmap spellchecker dictionary.";
   }
@@ -375,6 +412,20 @@ void SpellCheck::AddWordToHunspell(const std::string& word) {
     hunspell_->add(word.c_str());
 }
 
+void SpellCheck::ClearCaches() {
+  word_cache_.Clear();
+  suggestion_cache_.Clear();
+}
+
+void SpellCheck::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level != base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    return;
+  hunspell_.reset();
+  bdict_file_.reset();
+  ClearCaches();
+}
+
 bool SpellCheck::InitializeIfNeeded() {
   if (is_using_platform_spelling_engine_)
     return false;
@@ -405,6 +456,11 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         word_to_check, tag, &word_correct));
 #endif
   } else {
+    base::MRUCache<string16, bool>::iterator cached =
+        word_cache_.Get(word_to_check);
+    if (cached != word_cache_.end())
+      return cached->second;
+
     std::string word_to_check_utf8(UTF16ToUTF8(word_to_check));
     // Hunspell shouldn't let us exceed its max, but check just in case
     if (word_to_check_utf8.length() < MAXWORDUTF8LEN) {
@@ -412,6 +468,7 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         // |hunspell_->spell| returns 0 if the word is spelled correctly and
         // non-zero otherwsie.
         word_correct = (hunspell_->spell(word_to_check_utf8.c_str()) != 0);
+        word_cache_.Put(word_to_check, word_correct);
       } else {
         // If |hunspell_| is NULL here, an error has occurred, but it's better
         // to check rather than crash.
@@ -473,6 +530,16 @@ void SpellCheck::FillSuggestionList(
   if (!hunspell_.get())
     return;
 
+  base::MRUCache<string16, std::vector<string16> >::iterator cached =
+      suggestion_cache_.Get(wrong_word);
+  if (cached != suggestion_cache_.end()) {
+    optional_suggestions->insert(optional_suggestions->end(),
+                                 cached->second.begin(),
+                                 cached->second.end());
+    return;
+  }
+
+  std::vector<string16> new_suggestions;
   char** suggestions;
   int number_of_suggestions =
       hunspell_->suggest(&suggestions, UTF16ToUTF8(wrong_word).c_str());
@@ -480,11 +547,16 @@ void SpellCheck::FillSuggestionList(
   // Populate the vector of WideStrings.
   for (int i = 0; i < number_of_suggestions; i++) {
     if (i < SpellCheckCommon::kMaxSuggestions)
-      optional_suggestions->push_back(UTF8ToUTF16(suggestions[i]));
+      new_suggestions.push_back(UTF8ToUTF16(suggestions[i]));
     free(suggestions[i]);
   }
   if (suggestions != NULL)
     free(suggestions);
+
+  optional_suggestions->insert(optional_suggestions->end(),
+                               new_suggestions.begin(),
+                               new_suggestions.end());
+  suggestion_cache_.Put(wrong_word, new_suggestions);
 }
 
 // Returns whether or not the given string is a valid contraction.
@@ -11,6 +11,8 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -107,6 +109,9 @@ class SpellCheck : public content::RenderProcessObserver,
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, GetAutoCorrectionWord_EN_US);
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest,
       RequestSpellCheckMultipleTimesWithoutInitialization);
+  FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, CachesWordResults);
+  FRIEND_TEST_ALL_PREFIXES(SpellCheckTest,
+                           ReleasesDictionaryUnderMemoryPressure);
 
   class SpellCheckRequestParam;
 
@@ -155,6 +160,14 @@ class SpellCheck : public content::RenderProcessObserver,
   // Add the given custom word to |hunspell_|.
   void AddWordToHunspell(const std::string& word);
 
+  // Forgets all cached results, for when the dictionary changes.
+  void ClearCaches();
+
+  // Drops Hunspell and unmaps the dictionary under critical memory pressure.
+  // The dictionary file stays open, so both are reloaded on the next check.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   // We memory-map the BDict file.
   scoped_ptr<file_util::MemoryMappedFile> bdict_file_;
 
@@ -162,6 +175,9 @@ class SpellCheck : public content::RenderProcessObserver,
   scoped_ptr<Hunspell> hunspell_;
 
   base::PlatformFile file_;
+
+  // Custom words, including those added since Hunspell was loaded, so that
+  // they survive a reload.
   std::vector<std::string> custom_words_;
 
   // Represents character attributes used for filtering out characters which
@@ -176,6 +192,13 @@ class SpellCheck : public content::RenderProcessObserver,
   SpellcheckWordIterator text_iterator_;
   SpellcheckWordIterator contraction_iterator_;
 
+  // Hunspell results of recently checked words, and the suggestions for
+  // recently misspelled ones. WebKit asks for a whole paragraph to be checked
+  // again on every edit, so with these only the edited words reach Hunspell.
+  // Not used with the platform spelling engine.
+  base::MRUCache<string16, bool> word_cache_;
+  base::MRUCache<string16, std::vector<string16> > suggestion_cache_;
+
   // Remember state for auto spell correct.
   bool auto_spell_correct_turned_on_;
 
@@ -203,6 +226,8 @@ class SpellCheck : public content::RenderProcessObserver,
   // should be removed from the set.
   std::queue<scoped_refptr<SpellCheckRequestParam> > requested_params_;
 
+  base::MemoryPressureListener memory_pressure_listener_;
+
   DISALLOW_COPY_AND_ASSIGN(SpellCheck);
 };
 
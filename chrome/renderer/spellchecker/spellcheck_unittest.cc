@@ -840,6 +840,59 @@ TEST_F(SpellCheckTest, SpellCheckParagraphLongSentenceMultipleMisspellings) {
   TestSpellCheckParagraph(text, expected);
 }
 
+// Checking a paragraph again only looks up words that aren't cached, and
+// adding a custom word invalidates the cached results.
+TEST_F(SpellCheckTest, CachesWordResults) {
+  std::vector<SpellCheckResult> results;
+  spell_check()->SpellCheckParagraph(ASCIIToUTF16("This is a helllo test"),
+                                     &results);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(10, results[0].location);
+  EXPECT_EQ(6, results[0].length);
+  size_t cached_words = spell_check()->word_cache_.size();
+  EXPECT_LT(0U, cached_words);
+  EXPECT_EQ(1U, spell_check()->suggestion_cache_.size());
+
+  // Only the edited word is new.
+  results.clear();
+  spell_check()->SpellCheckParagraph(ASCIIToUTF16("This is a helllo quiz"),
+                                     &results);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(cached_words + 1, spell_check()->word_cache_.size());
+  EXPECT_EQ(1U, spell_check()->suggestion_cache_.size());
+
+  spell_check()->OnWordAdded("helllo");
+  EXPECT_EQ(0U, spell_check()->word_cache_.size());
+  EXPECT_EQ(0U, spell_check()->suggestion_cache_.size());
+  results.clear();
+  spell_check()->SpellCheckParagraph(ASCIIToUTF16("This is a helllo quiz"),
+                                     &results);
+  EXPECT_TRUE(results.empty());
+}
+
+// Hunspell is dropped under critical memory pressure and reloaded, with the
+// custom words, on the next check.
+TEST_F(SpellCheckTest, ReleasesDictionaryUnderMemoryPressure) {
+  std::vector<SpellCheckResult> results;
+  spell_check()->OnWordAdded("helllo");
+  spell_check()->SpellCheckParagraph(ASCIIToUTF16("This is a helllo test"),
+                                     &results);
+  EXPECT_TRUE(results.empty());
+  EXPECT_TRUE(spell_check()->hunspell_.get());
+
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(spell_check()->hunspell_.get());
+  EXPECT_FALSE(spell_check()->bdict_file_.get());
+
+  spell_check()->SpellCheckParagraph(ASCIIToUTF16("This is a helllo tesst"),
+                                     &results);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(17, results[0].location);
+  EXPECT_TRUE(spell_check()->hunspell_.get());
+}
+
 // We also skip RequestSpellCheck tests on Mac, because a system spellchecker
 // is used on Mac instead of SpellCheck::RequestTextChecking.
 
@@ -6,9 +6,12 @@
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/mru_cache.h"
 #include "base/message_loop.h"
 #include "base/metrics/histogram.h"
+#include "base/threading/worker_pool.h"
 #include "base/utf_string_conversions.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/render_messages.h"
@@ -44,6 +47,38 @@ static const int kTranslateStatusCheckDelayMs = 400;
 // Language name passed to the Translate element for it to detect the language.
 static const char* const kAutoDetectionLanguage = "auto";
 
+// Pages with less text than this are detected on the render thread, where the
+// CLD is quicker than a round trip to a worker thread.
+static const size_t kMinTextLengthForWorker = 4 * 1024;
+
+// The number of characters the CLD looks at, and the number of places of the
+// page text they are taken from.
+static const size_t kMaxDetectionChars = 16 * 1024;
+static const size_t kDetectionSampleCount = 8;
+
+// The number of pages whose detected language is remembered, so that reloads
+// and history navigations don't run the CLD again.
+static const size_t kLanguageCacheSize = 32;
+
+namespace {
+
+// Detected languages by URL, shared by the RenderViews of the process. Only
+// used on the render thread.
+class LanguageCache : public base::MRUCache<GURL, std::string> {
+ public:
+  LanguageCache() : base::MRUCache<GURL, std::string>(kLanguageCacheSize) {}
+};
+
+base::LazyInstance<LanguageCache> g_language_cache = LAZY_INSTANCE_INITIALIZER;
+
+GURL StripRef(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return url.ReplaceComponents(replacements);
+}
+
+}  // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 // TranslateHelper, public:
 //
@@ -51,7 +86,9 @@ TranslateHelper::TranslateHelper(content::RenderView* render_view)
     : content::RenderViewObserver(render_view),
       translation_pending_(false),
       page_id_(-1),
-      ALLOW_THIS_IN_INITIALIZER_LIST(weak_method_factory_(this)) {
+      detection_id_(0),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_method_factory_(this)),
+      ALLOW_THIS_IN_INITIALIZER_LIST(detection_weak_factory_(this)) {
 }
 
 TranslateHelper::~TranslateHelper() {
@@ -63,17 +100,46 @@ void TranslateHelper::PageCaptured(const string16& contents) {
   // If the page explicitly specifies a language, use it, otherwise we'll
   // determine it based on the text content using the CLD.
   std::string language = GetPageLanguageFromMetaTag(&document);
-  if (language.empty()) {
+  bool translatable = IsPageTranslatable(&document);
+  // Any detection still running is for a previous capture.
+  detection_id_++;
+  if (!language.empty()) {
+    VLOG(1) << "PageLanguageFromMetaTag: " << language;
+    NotifyBrowserLanguageDetermined(language, translatable);
+    return;
+  }
+
+  if (contents.size() < kMinTextLengthForWorker) {
     base::TimeTicks begin_time = base::TimeTicks::Now();
     language = DetermineTextLanguage(contents);
     UMA_HISTOGRAM_MEDIUM_TIMES("Renderer4.LanguageDetection",
                                base::TimeTicks::Now() - begin_time);
-  } else {
-    VLOG(1) << "PageLanguageFromMetaTag: " << language;
+    NotifyBrowserLanguageDetermined(language, translatable);
+    return;
   }
 
-  Send(new ChromeViewHostMsg_TranslateLanguageDetermined(
-      routing_id(), language, IsPageTranslatable(&document)));
+  GURL url = StripRef(document.url());
+  LanguageCache* cache = g_language_cache.Pointer();
+  LanguageCache::iterator it = cache->Get(url);
+  UMA_HISTOGRAM_BOOLEAN("Renderer4.LanguageDetectionCacheHit",
+                        it != cache->end());
+  if (it != cache->end()) {
+    NotifyBrowserLanguageDetermined(it->second, translatable);
+    return;
+  }
+
+  std::string* detected_language = new std::string;
+  base::TimeDelta* detection_time = new base::TimeDelta;
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&TranslateHelper::DetermineTextLanguageOnWorker,
+                 SampleTextForDetection(contents, kMaxDetectionChars),
+                 detected_language, detection_time),
+      base::Bind(&TranslateHelper::OnTextLanguageDetermined,
+                 detection_weak_factory_.GetWeakPtr(), detection_id_, url,
+                 translatable, base::Owned(detected_language),
+                 base::Owned(detection_time)),
+      false);
 }
 
 void TranslateHelper::CancelPendingTranslation() {
@@ -165,6 +231,42 @@ std::string TranslateHelper::DetermineTextLanguage(const string16& text) {
   return language;
 }
 
+// static
+void TranslateHelper::DetermineTextLanguageOnWorker(
+    const string16& text,
+    std::string* language,
+    base::TimeDelta* detection_time) {
+  base::TimeTicks begin_time = base::TimeTicks::Now();
+  *language = DetermineTextLanguage(text);
+  *detection_time = base::TimeTicks::Now() - begin_time;
+}
+
+void TranslateHelper::OnTextLanguageDetermined(
+    int detection_id,
+    const GURL& url,
+    bool translatable,
+    std::string* language,
+    base::TimeDelta* detection_time) {
+  // This is the time the render thread would have been busy for.
+  UMA_HISTOGRAM_MEDIUM_TIMES("Renderer4.LanguageDetectionOffMainThread",
+                             *detection_time);
+  g_language_cache.Get().Put(url, *language);
+
+  WebFrame* main_frame = GetMainFrame();
+  if (detection_id != detection_id_ || !main_frame ||
+      StripRef(main_frame->document().url()) != url) {
+    return;
+  }
+  NotifyBrowserLanguageDetermined(*language, translatable);
+}
+
+void TranslateHelper::NotifyBrowserLanguageDetermined(
+    const std::string& language,
+    bool translatable) {
+  Send(new ChromeViewHostMsg_TranslateLanguageDetermined(
+      routing_id(), language, translatable));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // TranslateHelper, protected:
 //
@@ -228,6 +330,32 @@ std::string TranslateHelper::GetOriginalPageLanguage() {
   return lang;
 }
 
+// static
+string16 TranslateHelper::SampleTextForDetection(const string16& text,
+                                                 size_t max_chars) {
+  if (text.size() <= max_chars)
+    return text;
+
+  // Leave room for the space that separates the pieces.
+  DCHECK_GT(max_chars, 2 * kDetectionSampleCount);
+  size_t piece_size = max_chars / kDetectionSampleCount - 1;
+  size_t stride = text.size() / kDetectionSampleCount;
+  string16 sample;
+  sample.reserve(max_chars);
+  for (size_t i = 0; i < kDetectionSampleCount; ++i) {
+    size_t start = i * stride;
+    // Don't feed the CLD a partial word.
+    if (start > 0) {
+      size_t space = text.find(' ', start);
+      if (space != string16::npos && space < start + piece_size / 2)
+        start = space + 1;
+    }
+    sample.append(text, start, piece_size);
+    sample.push_back(' ');
+  }
+  return sample;
+}
+
 bool TranslateHelper::DontDelayTasks() {
   return false;
 }
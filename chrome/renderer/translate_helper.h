@@ -9,8 +9,10 @@
 #include <string>
 
 #include "base/memory/weak_ptr.h"
+#include "base/time.h"
 #include "chrome/common/translate_errors.h"
 #include "content/public/renderer/render_view_observer.h"
+#include "googleurl/src/gurl.h"
 
 namespace WebKit {
 class WebDocument;
@@ -25,7 +27,9 @@ class TranslateHelper : public content::RenderViewObserver {
   explicit TranslateHelper(content::RenderView* render_view);
   virtual ~TranslateHelper();
 
-  // Informs us that the page's text has been extracted.
+  // Informs us that the page's text has been extracted. The language of large
+  // pages is detected on a worker thread, so the browser may be told about it
+  // after this returns.
   void PageCaptured(const string16& contents);
 
  protected:
@@ -65,6 +69,12 @@ class TranslateHelper : public content::RenderViewObserver {
   // the tests don't have to wait before checking states.
   virtual bool DontDelayTasks();
 
+  // Returns at most |max_chars| characters of |text| to run the language
+  // detection on. Longer texts are sampled at evenly spaced places, so that
+  // the sample represents the whole page rather than its header.
+  static string16 SampleTextForDetection(const string16& text,
+                                         size_t max_chars);
+
  private:
   // Returns whether the page associated with |document| is a candidate for
   // translation.  Some pages can explictly specify (via a meta-tag) that they
@@ -82,6 +92,25 @@ class TranslateHelper : public content::RenderViewObserver {
   // if it failed.
   static std::string DetermineTextLanguage(const string16& text);
 
+  // Runs DetermineTextLanguage() on a worker thread, setting |language| and
+  // the time it took in |detection_time|.
+  static void DetermineTextLanguageOnWorker(const string16& text,
+                                            std::string* language,
+                                            base::TimeDelta* detection_time);
+
+  // Called on the render thread once the worker thread has determined the
+  // |language| of the page at |url|. |detection_id| identifies the request,
+  // a newer capture of the page makes it obsolete.
+  void OnTextLanguageDetermined(int detection_id,
+                                const GURL& url,
+                                bool translatable,
+                                std::string* language,
+                                base::TimeDelta* detection_time);
+
+  // Sends the page language to the browser.
+  void NotifyBrowserLanguageDetermined(const std::string& language,
+                                       bool translatable);
+
   // RenderViewObserver implementation.
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
@@ -130,9 +159,16 @@ class TranslateHelper : public content::RenderViewObserver {
   std::string source_lang_;
   std::string target_lang_;
 
+  // Incremented for each language detection run on the worker thread.
+  int detection_id_;
+
   // Method factory used to make calls to TranslatePageImpl.
   base::WeakPtrFactory<TranslateHelper> weak_method_factory_;
 
+  // Used for the replies of the worker thread. Not invalidated when a
+  // translation is cancelled.
+  base::WeakPtrFactory<TranslateHelper> detection_weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(TranslateHelper);
 };
 
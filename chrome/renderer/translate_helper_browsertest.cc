@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/string_split.h"
+#include "base/stringprintf.h"
+#include "base/utf_string_conversions.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/render_messages.h"
 #include "chrome/renderer/translate_helper.h"
@@ -28,6 +31,10 @@ class TestTranslateHelper : public TranslateHelper {
     OnTranslatePage(page_id, translate_script, source_lang, target_lang);
   }
 
+  static string16 SampleText(const string16& text, size_t max_chars) {
+    return SampleTextForDetection(text, max_chars);
+  }
+
   MOCK_METHOD0(IsTranslateLibAvailable, bool());
   MOCK_METHOD0(IsTranslateLibReady, bool());
   MOCK_METHOD0(HasTranslationFinished, bool());
@@ -370,3 +377,25 @@ TEST_F(ChromeRenderViewTest, LanguageMetaTag) {
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_EQ("fr", params.a);
 }
+
+// Tests that the text given to the CLD is bounded and spread over the page.
+TEST(TranslateHelperSampleTest, SampleTextForDetection) {
+  string16 text = ASCIIToUTF16("A short page.");
+  EXPECT_EQ(text, TestTranslateHelper::SampleText(text, 400));
+
+  std::string long_text;
+  for (int i = 0; i < 1000; ++i)
+    long_text += base::StringPrintf("w%d ", i);
+  string16 sample =
+      TestTranslateHelper::SampleText(ASCIIToUTF16(long_text), 400);
+  EXPECT_LE(sample.size(), 400u);
+  EXPECT_EQ(0u, sample.find(ASCIIToUTF16("w0 w1 ")));
+  EXPECT_NE(string16::npos, sample.find(ASCIIToUTF16(" w880 ")));
+  // Pieces start at word boundaries.
+  std::vector<string16> words;
+  base::SplitString(sample, ' ', &words);
+  for (size_t i = 0; i < words.size(); ++i) {
+    if (!words[i].empty())
+      EXPECT_EQ('w', words[i][0]);
+  }
+}
@@ -453,6 +453,34 @@ class PageCyclerIndexedDatabaseReferenceTest : public PageCyclerReferenceTest {
   }
 };
 
+static FilePath GetPageCyclerWprPath(const char* name) {
+  FilePath wpr_path;
+  PathService::Get(base::DIR_SOURCE_ROOT, &wpr_path);
+  wpr_path = wpr_path.AppendASCII("tools");
+  wpr_path = wpr_path.AppendASCII("page_cycler");
+  wpr_path = wpr_path.AppendASCII("webpagereplay");
+  wpr_path = wpr_path.AppendASCII(name);
+  return wpr_path;
+}
+
+// Returns the start page of the Web Page Replay page cycler, which loads the
+// pages listed in tests/|name|.js |iterations| times.
+static GURL GetPageCyclerWprUrl(const char* name, int iterations) {
+  FilePath start_path = GetPageCyclerWprPath("start.html");
+
+  // Add query parameters for iterations and test name.
+  const std::string query_string =
+      "iterations=" + base::IntToString(iterations) +
+      "&test=" + name +
+      "&auto=1";
+  GURL::Replacements replacements;
+  replacements.SetQuery(
+      query_string.c_str(),
+      url_parse::Component(0, query_string.length()));
+
+  return net::FilePathToFileURL(start_path).ReplaceComponents(replacements);
+}
+
 // Web Page Replay is a proxy server to record and serve pages
 // with realistic network delays and bandwidth throttling.
 // runtest.py launches replay.py to support these tests.
@@ -480,36 +508,13 @@ class PageCyclerWebPageReplayTest : public PageCyclerTest {
     launch_arguments_.AppendSwitch(switches::kNoProxyServer);
   }
 
-  FilePath GetPageCyclerWprPath(const char* name) {
-    FilePath wpr_path;
-    PathService::Get(base::DIR_SOURCE_ROOT, &wpr_path);
-    wpr_path = wpr_path.AppendASCII("tools");
-    wpr_path = wpr_path.AppendASCII("page_cycler");
-    wpr_path = wpr_path.AppendASCII("webpagereplay");
-    wpr_path = wpr_path.AppendASCII(name);
-    return wpr_path;
-  }
-
   virtual int GetTestIterations() OVERRIDE {
     return kWebPageReplayIterations;
   }
 
   virtual void GetTestUrl(const char* name, bool use_http,
                           GURL *test_url) OVERRIDE {
-    FilePath start_path = GetPageCyclerWprPath("start.html");
-
-    // Add query parameters for iterations and test name.
-    const std::string query_string =
-        "iterations=" + base::IntToString(GetTestIterations()) +
-        "&test=" + name +
-        "&auto=1";
-    GURL::Replacements replacements;
-    replacements.SetQuery(
-        query_string.c_str(),
-        url_parse::Component(0, query_string.length()));
-
-    *test_url = net::FilePathToFileURL(start_path);
-    *test_url = test_url->ReplaceComponents(replacements);
+    *test_url = GetPageCyclerWprUrl(name, GetTestIterations());
   }
 
   void RunTest(const char* graph, const char* name) {
@@ -524,6 +529,49 @@ class PageCyclerWebPageReplayTest : public PageCyclerTest {
   }
 };
 
+// Replays the pages of a Web Page Replay test from an in-process archive
+// (see net::URLRequestReplayArchive) with the recorded latency of every
+// response. No proxy is needed, so runs are reproducible on any platform;
+// everything above the URLRequestJob, including the renderer, is measured.
+class PageCyclerReplayArchiveTest : public PageCyclerTest {
+ public:
+  PageCyclerReplayArchiveTest() {
+    launch_arguments_.AppendSwitchPath(
+        switches::kLoadExtension, GetPageCyclerWprPath("extension"));
+    launch_arguments_.AppendSwitch(switches::kEnableExperimentalExtensionApis);
+    launch_arguments_.AppendSwitch(switches::kEnableStatsTable);
+    launch_arguments_.AppendSwitch(switches::kEnableBenchmarking);
+  }
+
+  virtual int GetTestIterations() OVERRIDE {
+    return kWebPageReplayIterations;
+  }
+
+  virtual void GetTestUrl(const char* name, bool use_http,
+                          GURL *test_url) OVERRIDE {
+    *test_url = GetPageCyclerWprUrl(name, GetTestIterations());
+  }
+
+  // Note: we delay the SetUp until RunTest is called so that the archive can
+  // be picked based on the test name.
+  virtual void SetUp() {}
+  void RunTest(const char* graph, const char* name) {
+    // Archives live next to the Web Page Replay test lists.
+    FilePath archive_path = GetPageCyclerWprPath("archives");
+    archive_path = archive_path.AppendASCII(name);
+    archive_path = archive_path.ReplaceExtension(
+        FILE_PATH_LITERAL(".archive"));
+    ASSERT_TRUE(file_util::PathExists(archive_path))
+        << "Missing replay archive " << archive_path.value();
+    launch_arguments_.AppendSwitchPath(switches::kReplayArchive,
+                                       archive_path);
+
+    PageCyclerTest::SetUp();
+    const bool use_http = false;  // always use a file
+    PageCyclerTest::RunTestWithSuffix(graph, name, use_http, "_replay");
+  }
+};
+
 // This macro simplifies setting up regular and reference build tests.
 #define PAGE_CYCLER_TESTS(test, name, use_http) \
 TEST_F(PageCyclerTest, name) { \
@@ -583,6 +631,11 @@ TEST_F(PageCyclerWebPageReplayTest, name) { \
   RunTest("times", test); \
 }
 
+#define PAGE_CYCLER_REPLAY_ARCHIVE_TESTS(test, name) \
+TEST_F(PageCyclerReplayArchiveTest, name) { \
+  RunTest("times", test); \
+}
+
 // file-URL tests
 PAGE_CYCLER_FILE_TESTS("moz", MozFile);
 PAGE_CYCLER_EXTENSIONS_FILE_TESTS("moz", MozFile);
@@ -614,6 +667,9 @@ PAGE_CYCLER_HTTP_TESTS("bloat", BloatHttp);
 PAGE_CYCLER_WEBPAGEREPLAY_TESTS("2012Q2", 2012Q2);
 #endif
 
+// In-process replay (simulated network) tests.
+PAGE_CYCLER_REPLAY_ARCHIVE_TESTS("2012Q2", 2012Q2);
+
 // HTML5 database tests
 // These tests are _really_ slow on XP/Vista.
 #if !defined(OS_WIN)
@@ -40,6 +40,9 @@
 
 #if defined(USE_TCMALLOC)
 #include "third_party/tcmalloc/chromium/src/gperftools/malloc_extension.h"
+#if !defined(OS_WIN)
+#include "third_party/tcmalloc/chromium/src/gperftools/heap-profiler.h"
+#endif
 #endif
 
 #if defined(OS_WIN)
@@ -327,6 +330,12 @@ static void GetStatsThunk(char* buffer, int buffer_length) {
 static void ReleaseFreeMemoryThunk() {
   MallocExtension::instance()->ReleaseFreeMemory();
 }
+
+#if !defined(OS_WIN)
+static bool IsHeapProfilerRunningThunk() {
+  return ::IsHeapProfilerRunning() != 0;
+}
+#endif
 #endif
 
 
@@ -363,6 +372,13 @@ static void ReleaseFreeMemoryThunk() {
     // On windows, we've already set these thunks up in _heap_init()
     base::allocator::SetGetStatsFunction(GetStatsThunk);
     base::allocator::SetReleaseFreeMemoryFunction(ReleaseFreeMemoryThunk);
+
+    // The heap profiler is not built into the Windows allocator.
+    base::allocator::SetStartHeapProfilingFunction(::HeapProfilerStart);
+    base::allocator::SetStopHeapProfilingFunction(::HeapProfilerStop);
+    base::allocator::SetIsHeapProfilingRunningFunction(
+        IsHeapProfilerRunningThunk);
+    base::allocator::SetGetHeapProfileFunction(::GetHeapProfile);
 #endif
 
 #if !defined(OS_ANDROID)
@@ -8,6 +8,7 @@
 #include "content/browser/dom_storage/dom_storage_context_impl.h"
 #include "content/browser/fileapi/browser_file_system_helper.h"
 #include "content/browser/in_process_webkit/indexed_db_context_impl.h"
+#include "content/browser/renderer_host/spare_render_process_host_pool.h"
 #include "content/browser/resource_context_impl.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/common/content_constants.h"
@@ -231,6 +232,9 @@ void BrowserContext::PurgeMemory(BrowserContext* browser_context) {
 }
 
 BrowserContext::~BrowserContext() {
+  if (BrowserThread::CurrentlyOn(BrowserThread::UI))
+    SpareRenderProcessHostPool::GetInstance()->DiscardSpareHosts(this);
+
   // These message loop checks are just to avoid leaks in unittests.
   if (GetUserData(kDatabaseTrackerKeyName) &&
       BrowserThread::IsMessageLoopValid(BrowserThread::FILE)) {
@@ -4,9 +4,11 @@
 
 #include "content/browser/download/base_file.h"
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/pickle.h"
 #include "base/stringprintf.h"
 #include "base/threading/thread_restrictions.h"
@@ -198,6 +200,10 @@ net::Error RenameFileAndResetSecurityDescriptor(
 
 }  // namespace
 
+// Number of copied chunks that may be waiting to be hashed. Download data
+// arrives in 32K reads, so this is at most a couple of megabytes.
+static const int kMaxPendingHashUpdates = 64;
+
 // This will initialize the entire array to zero.
 const unsigned char BaseFile::kEmptySha256Hash[] = { 0 };
 
@@ -216,6 +222,8 @@ BaseFile::BaseFile(const FilePath& full_path,
       bytes_so_far_(received_bytes),
       start_tick_(base::TimeTicks::Now()),
       calculate_hash_(calculate_hash),
+      pending_hash_updates_(0),
+      hash_updates_done_(&hash_lock_),
       detached_(false),
       bound_net_log_(bound_net_log) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
@@ -226,6 +234,7 @@ BaseFile::BaseFile(const FilePath& full_path,
   }
 
   if (calculate_hash_) {
+    hash_sequence_token_ = BrowserThread::GetBlockingPool()->GetSequenceToken();
     secure_hash_.reset(crypto::SecureHash::Create(crypto::SecureHash::SHA256));
     if ((bytes_so_far_ > 0) &&  // Not starting at the beginning.
         (hash_state != "") &&  // Reasonably sure we have a hash state.
@@ -237,6 +246,7 @@ BaseFile::BaseFile(const FilePath& full_path,
 
 BaseFile::~BaseFile() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  WaitForPendingHashUpdates();
   if (detached_)
     Close();
   else
@@ -318,7 +328,7 @@ net::Error BaseFile::AppendDataToFile(const char* data, size_t data_len) {
   download_stats::RecordDownloadWriteLoopCount(write_count);
 
   if (calculate_hash_)
-    secure_hash_->Update(data, data_len);
+    UpdateHash(data, data_len);
 
   return net::OK;
 }
@@ -424,8 +434,10 @@ void BaseFile::Cancel() {
 void BaseFile::Finish() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
 
-  if (calculate_hash_)
+  if (calculate_hash_) {
+    WaitForPendingHashUpdates();
     secure_hash_->Finish(sha256_hash_, kSha256HashLen);
+  }
 
   Close();
 }
@@ -441,6 +453,7 @@ std::string BaseFile::GetHashState() {
   if (!calculate_hash_)
     return "";
 
+  WaitForPendingHashUpdates();
   Pickle hash_state;
   if (!secure_hash_->Serialize(&hash_state))
     return "";
@@ -459,6 +472,50 @@ bool BaseFile::SetHashState(const std::string& hash_state_bytes) {
   return secure_hash_->Deserialize(&data_iterator);
 }
 
+void BaseFile::UpdateHash(const char* data, size_t data_len) {
+  // The caller's buffer is only valid for the duration of the append, so the
+  // worker hashes a copy. Copying is far cheaper than hashing.
+  scoped_refptr<base::RefCountedString> copy(new base::RefCountedString);
+  copy->data().assign(data, data_len);
+  {
+    // Bound the memory held by copies if hashing falls behind the disk.
+    base::AutoLock lock(hash_lock_);
+    while (pending_hash_updates_ >= kMaxPendingHashUpdates)
+      hash_updates_done_.Wait();
+    ++pending_hash_updates_;
+  }
+  if (BrowserThread::GetBlockingPool()->
+          PostSequencedWorkerTaskWithShutdownBehavior(
+              hash_sequence_token_, FROM_HERE,
+              base::Bind(&BaseFile::UpdateHashOnWorker,
+                         base::Unretained(this), copy),
+              base::SequencedWorkerPool::BLOCK_SHUTDOWN)) {
+    return;
+  }
+
+  // The pool is shutting down; hash here once earlier updates are done.
+  {
+    base::AutoLock lock(hash_lock_);
+    --pending_hash_updates_;
+  }
+  WaitForPendingHashUpdates();
+  secure_hash_->Update(data, data_len);
+}
+
+void BaseFile::UpdateHashOnWorker(
+    scoped_refptr<base::RefCountedString> data) {
+  secure_hash_->Update(data->data().data(), data->data().size());
+  base::AutoLock lock(hash_lock_);
+  --pending_hash_updates_;
+  hash_updates_done_.Signal();
+}
+
+void BaseFile::WaitForPendingHashUpdates() {
+  base::AutoLock lock(hash_lock_);
+  while (pending_hash_updates_ > 0)
+    hash_updates_done_.Wait();
+}
+
 bool BaseFile::IsEmptyHash(const std::string& hash) {
   return (hash.size() == kSha256HashLen &&
           0 == memcmp(hash.data(), kEmptySha256Hash, sizeof(kSha256HashLen)));
@@ -11,7 +11,11 @@
 #include "base/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/time.h"
 #include "content/common/content_export.h"
 #include "googleurl/src/gurl.h"
@@ -19,6 +23,9 @@
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
 
+namespace base {
+class RefCountedString;
+}
 namespace crypto {
 class SecureHash;
 }
@@ -106,6 +113,16 @@ class CONTENT_EXPORT BaseFile {
 
   net::Error ClearStream(net::Error error);
 
+  // Adds |data| to the hash. The hash is computed on this file's sequence of
+  // the blocking pool, so it overlaps with writing the next chunk rather
+  // than adding to the time spent on the FILE thread.
+  void UpdateHash(const char* data, size_t data_len);
+  void UpdateHashOnWorker(scoped_refptr<base::RefCountedString> data);
+
+  // Blocks until every queued hash update has been applied. Must be called
+  // before |secure_hash_| is used on the FILE thread.
+  void WaitForPendingHashUpdates();
+
   static const size_t kSha256HashLen = 32;
   static const unsigned char kEmptySha256Hash[kSha256HashLen];
 
@@ -133,6 +150,16 @@ class CONTENT_EXPORT BaseFile {
 
   unsigned char sha256_hash_[kSha256HashLen];
 
+  // Hash updates for one file run in order; different files hash in
+  // parallel.
+  base::SequencedWorkerPool::SequenceToken hash_sequence_token_;
+
+  // Number of hash updates posted but not yet applied. Guarded by
+  // |hash_lock_|; |hash_updates_done_| is signalled as each one is applied.
+  int pending_hash_updates_;
+  base::Lock hash_lock_;
+  base::ConditionVariable hash_updates_done_;
+
   // Indicates that this class no longer owns the associated file, and so
   // won't delete it on destruction.
   bool detached_;
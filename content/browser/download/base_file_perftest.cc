@@ -0,0 +1,83 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/download/base_file.h"
+
+#include <string>
+
+#include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "content/browser/browser_thread_impl.h"
+#include "net/base/file_stream.h"
+#include "net/base/net_errors.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using content::BrowserThread;
+using content::BrowserThreadImpl;
+
+namespace {
+
+// The size of the reads DownloadResourceHandler hands to the FILE thread.
+const size_t kChunkSize = 32 * 1024;
+
+// Total bytes written by each test case.
+const size_t kTotalSize = 128 * 1024 * 1024;
+
+class BaseFilePerfTest : public testing::Test {
+ public:
+  BaseFilePerfTest()
+      : file_thread_(BrowserThread::FILE, &message_loop_),
+        chunk_(kChunkSize, 'x') {
+  }
+
+ protected:
+  // Writes |kTotalSize| bytes spread round robin over |file_count| files,
+  // the way concurrent downloads share the FILE thread.
+  void WriteFiles(int file_count, bool calculate_hash) {
+    ScopedVector<BaseFile> files;
+    for (int i = 0; i < file_count; ++i) {
+      files.push_back(new BaseFile(FilePath(), GURL(), GURL(), 0,
+                                   calculate_hash, "",
+                                   linked_ptr<net::FileStream>(),
+                                   net::BoundNetLog()));
+      ASSERT_EQ(net::OK, files[i]->Initialize());
+    }
+
+    PerfTimeLogger timer(base::StringPrintf(
+        "Download_write_%d_files%s", file_count,
+        calculate_hash ? "_with_hash" : "").c_str());
+    for (size_t written = 0; written < kTotalSize;
+         written += kChunkSize * file_count) {
+      for (int i = 0; i < file_count; ++i) {
+        ASSERT_EQ(net::OK,
+                  files[i]->AppendDataToFile(chunk_.data(), chunk_.size()));
+      }
+    }
+    for (int i = 0; i < file_count; ++i) {
+      files[i]->Finish();
+      std::string hash;
+      EXPECT_EQ(calculate_hash, files[i]->GetHash(&hash));
+    }
+    timer.Done();
+  }
+
+  MessageLoop message_loop_;
+  BrowserThreadImpl file_thread_;
+  std::string chunk_;
+};
+
+}  // namespace
+
+TEST_F(BaseFilePerfTest, SingleDownload) {
+  WriteFiles(1, false);
+  WriteFiles(1, true);
+}
+
+TEST_F(BaseFilePerfTest, ConcurrentDownloads) {
+  WriteFiles(4, false);
+  WriteFiles(4, true);
+}
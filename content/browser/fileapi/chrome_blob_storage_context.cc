@@ -38,7 +38,8 @@ ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
 
 void ChromeBlobStorageContext::InitializeOnIOThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
-  controller_.reset(new BlobStorageController());
+  controller_.reset(new BlobStorageController(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE)));
 }
 
 ChromeBlobStorageContext::~ChromeBlobStorageContext() {}
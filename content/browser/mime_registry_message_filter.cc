@@ -37,6 +37,12 @@ bool MimeRegistryMessageFilter::OnMessageReceived(const IPC::Message& message,
   return handled;
 }
 
+bool MimeRegistryMessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  supported_message_classes->push_back(MimeRegistryMsgStart);
+  return true;
+}
+
 void MimeRegistryMessageFilter::OnGetMimeTypeFromExtension(
     const FilePath::StringType& ext, std::string* mime_type) {
   net::GetMimeTypeFromExtension(ext, mime_type);
@@ -5,6 +5,8 @@
 #ifndef CONTENT_BROWSER_MIME_REGISTRY_MESSAGE_FILTER_H_
 #define CONTENT_BROWSER_MIME_REGISTRY_MESSAGE_FILTER_H_
 
+#include <vector>
+
 #include "base/file_path.h"
 #include "content/public/browser/browser_message_filter.h"
 
@@ -17,6 +19,8 @@ class MimeRegistryMessageFilter : public content::BrowserMessageFilter {
       content::BrowserThread::ID* thread) OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message& message,
                                  bool* message_was_ok) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
 
  private:
   virtual ~MimeRegistryMessageFilter();
@@ -8,7 +8,10 @@
 #include "chrome/browser/ui/browser.h"
 #include "chrome/test/base/in_process_browser_test.h"
 #include "chrome/test/base/ui_test_utils.h"
+#include "chrome/test/perf/perf_test.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/web_contents.h"
 #include "content/public/common/content_switches.h"
 #include "content/test/net/url_request_mock_http_job.h"
 
@@ -197,6 +200,51 @@ IN_PROC_BROWSER_TEST_F(PluginTest, NPObjectProxy) {
   LoadAndWait(GetURL("npobject_proxy.html"), "OK");
 }
 
+class PluginScriptingPerfTest : public PluginTest {
+ protected:
+  PluginScriptingPerfTest() {
+    EnableDOMAutomation();
+  }
+
+  // Runs the scripting benchmark and prints its results with |trace|.
+  void RunBenchmark(const std::string& trace) {
+    LoadAndWait(GetURL("npobject_scripting_perf.html"), "OK");
+    content::RenderViewHost* render_view_host =
+        browser()->GetSelectedWebContents()->GetRenderViewHost();
+    int invokes_per_second = 0;
+    int gets_per_second = 0;
+    ASSERT_TRUE(ui_test_utils::ExecuteJavaScriptAndExtractInt(
+        render_view_host, L"",
+        L"window.domAutomationController.send(invokesPerSecond)",
+        &invokes_per_second));
+    ASSERT_TRUE(ui_test_utils::ExecuteJavaScriptAndExtractInt(
+        render_view_host, L"",
+        L"window.domAutomationController.send(getsPerSecond)",
+        &gets_per_second));
+    perf_test::PrintResult("npobject_invoke", "", trace, invokes_per_second,
+                           "calls/s", true);
+    perf_test::PrintResult("npobject_get_property", "", trace,
+                           gets_per_second, "calls/s", true);
+  }
+};
+
+class PluginScriptBatchingPerfTest : public PluginScriptingPerfTest {
+ protected:
+  virtual void SetUpCommandLine(CommandLine* command_line) OVERRIDE {
+    PluginScriptingPerfTest::SetUpCommandLine(command_line);
+    command_line->AppendSwitch(switches::kEnablePluginScriptBatching);
+  }
+};
+
+// Measures NPAPI scripting calls per second from the plugin into the page.
+IN_PROC_BROWSER_TEST_F(PluginScriptingPerfTest, NPObjectScripting) {
+  RunBenchmark("sync");
+}
+
+IN_PROC_BROWSER_TEST_F(PluginScriptBatchingPerfTest, NPObjectScripting) {
+  RunBenchmark("batched");
+}
+
 #if defined(OS_WIN) || defined(OS_MACOSX)
 // Tests if a plugin executing a self deleting script in the context of
 // a synchronous paint event works correctly
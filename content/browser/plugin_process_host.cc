@@ -224,6 +224,7 @@ bool PluginProcessHost::Init(const webkit::WebPluginInfo& info) {
     switches::kDisableLogging,
     switches::kEnableDCHECK,
     switches::kEnableLogging,
+    switches::kEnablePluginScriptBatching,
     switches::kEnableStatsTable,
     switches::kFullMemoryCrashReport,
     switches::kLoggingLevel,
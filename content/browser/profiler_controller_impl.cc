@@ -117,4 +117,33 @@ void ProfilerControllerImpl::GetProfilerData(int sequence_number) {
                  sequence_number));
 }
 
+void ProfilerControllerImpl::SetProfilerSamplingIntervalInChildProcesses(
+    int interval) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  for (BrowserChildProcessHostIterator iter; !iter.Done(); ++iter)
+    iter.Send(new ChildProcessMsg_SetProfilerSamplingInterval(interval));
+}
+
+void ProfilerControllerImpl::SetProfilerSamplingInterval(int interval) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  // Processes that are launched later pick this up when they connect.
+  tracked_objects::ThreadData::SetSamplingInterval(interval);
+
+  for (RenderProcessHost::iterator it(RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    it.GetCurrentValue()->Send(
+        new ChildProcessMsg_SetProfilerSamplingInterval(interval));
+  }
+
+  BrowserThread::PostTask(
+      BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(
+          &ProfilerControllerImpl::SetProfilerSamplingIntervalInChildProcesses,
+          base::Unretained(this),
+          interval));
+}
+
 }  // namespace content
@@ -45,6 +45,7 @@ class ProfilerControllerImpl : public ProfilerController {
   virtual void Register(ProfilerSubscriber* subscriber) OVERRIDE;
   virtual void Unregister(const ProfilerSubscriber* subscriber) OVERRIDE;
   virtual void GetProfilerData(int sequence_number) OVERRIDE;
+  virtual void SetProfilerSamplingInterval(int interval) OVERRIDE;
 
  private:
   friend struct DefaultSingletonTraits<ProfilerControllerImpl>;
@@ -52,6 +53,9 @@ class ProfilerControllerImpl : public ProfilerController {
   // Contact child processes and get their profiler data.
   void GetProfilerDataFromChildProcesses(int sequence_number);
 
+  // Tell the child processes to sample one in |interval| tasks.
+  void SetProfilerSamplingIntervalInChildProcesses(int interval);
+
   ProfilerSubscriber* subscriber_;
 
   DISALLOW_COPY_AND_ASSIGN(ProfilerControllerImpl);
@@ -22,6 +22,8 @@ void ProfilerMessageFilter::OnChannelConnected(int32 peer_pid) {
   tracked_objects::ThreadData::Status status =
       tracked_objects::ThreadData::status();
   Send(new ChildProcessMsg_SetProfilerStatus(status));
+  Send(new ChildProcessMsg_SetProfilerSamplingInterval(
+      tracked_objects::ThreadData::sampling_interval()));
 }
 
 bool ProfilerMessageFilter::OnMessageReceived(const IPC::Message& message,
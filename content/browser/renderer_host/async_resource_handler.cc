@@ -10,9 +10,11 @@
 #include "base/debug/alias.h"
 #include "base/hash_tables.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/shared_memory.h"
 #include "content/browser/debugger/devtools_netlog_observer.h"
 #include "content/browser/host_zoom_map_impl.h"
+#include "content/browser/renderer_host/resource_buffer_pool.h"
 #include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
 #include "content/browser/renderer_host/resource_message_filter.h"
 #include "content/browser/resource_context_impl.h"
@@ -22,11 +24,13 @@
 #include "content/public/browser/resource_dispatcher_host_delegate.h"
 #include "content/public/browser/resource_request_info.h"
 #include "content/public/common/resource_response.h"
+#include "content/public/common/url_constants.h"
 #include "net/base/io_buffer.h"
 #include "net/base/load_flags.h"
 #include "net/base/net_log.h"
 #include "webkit/glue/resource_loader_bridge.h"
 
+using base::TimeDelta;
 using base::TimeTicks;
 
 namespace content {
@@ -44,6 +48,20 @@ const int kInitialReadBufSize = 32768;
 // The maximum size of the shared memory buffer. (512 kilobytes).
 const int kMaxReadBufSize = 524288;
 
+// Pooled data is held back for coalescing until there is this much of it,
+// (32 kilobytes), or for at most kDataCoalescingDelayMs.
+const int kMinDataMessageSize = 32768;
+const int kDataCoalescingDelayMs = 2;
+
+// Returns true if all of the data for |url| is available right away, as
+// opposed to trickling in from the network.
+bool IsLocalDataURL(const GURL& url) {
+  return url.SchemeIs(chrome::kBlobScheme) ||
+         url.SchemeIs(chrome::kDataScheme) ||
+         url.SchemeIs(chrome::kFileScheme) ||
+         url.SchemeIs(chrome::kFileSystemScheme);
+}
+
 }  // namespace
 
 // Our version of IOBuffer that uses shared memory.
@@ -87,10 +105,26 @@ AsyncResourceHandler::AsyncResourceHandler(
       routing_id_(routing_id),
       rdh_(rdh),
       next_buffer_size_(kInitialReadBufSize),
+      pooled_buffer_id_(-1),
+      pooled_offset_(0),
+      pooled_request_id_(-1),
+      pending_offset_(0),
+      pending_size_(0),
+      pending_reads_(0),
+      sent_data_(false),
+      bytes_sent_(0),
+      all_data_pooled_(true),
       url_(url) {
 }
 
 AsyncResourceHandler::~AsyncResourceHandler() {
+  // The request is gone, so nothing reads into the pooled buffer anymore.
+  if (pooled_request_id_ != -1) {
+    // Data that was never sent won't be ACKed either.
+    if (pending_size_ > 0)
+      filter_->buffer_pool()->OnDataReceivedACK(pooled_request_id_);
+    filter_->buffer_pool()->ReleaseRequest(pooled_request_id_);
+  }
 }
 
 bool AsyncResourceHandler::OnUploadProgress(int request_id,
@@ -147,6 +181,16 @@ bool AsyncResourceHandler::OnResponseStarted(
             request_url))));
   }
 
+  // Local data, such as a blob, is read in as few chunks as possible rather
+  // than growing the reads from kInitialReadBufSize, so that it takes fewer
+  // data messages to the renderer.
+  if (IsLocalDataURL(request->url()) &&
+      response->content_length > kInitialReadBufSize) {
+    next_buffer_size_ = static_cast<int>(
+        std::min(response->content_length,
+                 static_cast<int64>(kMaxReadBufSize)));
+  }
+
   response->request_start = request->creation_time();
   response->response_start = TimeTicks::Now();
   filter_->Send(new ResourceMsg_ReceivedResponse(
@@ -173,6 +217,12 @@ bool AsyncResourceHandler::OnWillRead(int request_id, net::IOBuffer** buf,
                                       int* buf_size, int min_size) {
   DCHECK_EQ(-1, min_size);
 
+  if (first_read_time_.is_null())
+    first_read_time_ = TimeTicks::Now();
+  if (WillReadIntoPool(request_id, buf, buf_size))
+    return true;
+  all_data_pooled_ = false;
+
   if (g_spare_read_buffer) {
     DCHECK(!read_buffer_);
     read_buffer_.swap(&g_spare_read_buffer);
@@ -195,10 +245,111 @@ bool AsyncResourceHandler::OnWillRead(int request_id, net::IOBuffer** buf,
   return true;
 }
 
+bool AsyncResourceHandler::WillReadIntoPool(int request_id,
+                                            net::IOBuffer** buf,
+                                            int* buf_size) {
+  DCHECK(!pooled_read_buffer_);
+  DCHECK(pooled_request_id_ == -1 || pooled_request_id_ == request_id);
+  int size;
+  char* data = filter_->buffer_pool()->Allocate(
+      request_id, std::min(kInitialReadBufSize, next_buffer_size_),
+      next_buffer_size_, &pooled_buffer_id_, &pooled_offset_, &size);
+  if (!data)
+    return false;
+  pooled_request_id_ = request_id;
+  pooled_read_buffer_ = new net::WrappedIOBuffer(data);
+  *buf = pooled_read_buffer_.get();
+  *buf_size = size;
+  return true;
+}
+
+bool AsyncResourceHandler::SendPooledData(int request_id, int bytes_read) {
+  ResourceBufferPool* pool = filter_->buffer_pool();
+  if (!pool->IsBufferShared(pooled_buffer_id_)) {
+    base::SharedMemoryHandle handle;
+    if (!pool->ShareBuffer(pooled_buffer_id_, filter_->peer_handle(),
+                           &handle)) {
+      // Fake the ACK, as for unpooled data below.
+      rdh_->DataReceivedACK(filter_->child_id(), request_id);
+      pooled_read_buffer_ = NULL;
+      return false;
+    }
+    filter_->Send(new ResourceMsg_SetDataBuffer(
+        routing_id_, pooled_buffer_id_, handle,
+        ResourceBufferPool::kBufferSize));
+  }
+  pool->Commit(request_id, pooled_offset_, bytes_read);
+  pooled_read_buffer_ = NULL;
+
+  pending_offset_ = pooled_offset_;
+  pending_size_ = bytes_read;
+  pending_reads_ = 1;
+  // The first data goes out right away, so that the renderer can start
+  // parsing as soon as possible.
+  if (!sent_data_ || pending_size_ >= kMinDataMessageSize) {
+    FlushPendingData();
+  } else {
+    flush_timer_.Start(FROM_HERE,
+                       TimeDelta::FromMilliseconds(kDataCoalescingDelayMs),
+                       this, &AsyncResourceHandler::FlushPendingData);
+  }
+  return true;
+}
+
+void AsyncResourceHandler::FlushPendingData() {
+  flush_timer_.Stop();
+  if (!pending_size_)
+    return;
+
+  UMA_HISTOGRAM_COUNTS_100("Net.AsyncResourceHandler_ReadsPerDataMessage",
+                           pending_reads_);
+  net::URLRequest* request = rdh_->GetURLRequest(
+      GlobalRequestID(filter_->child_id(), pooled_request_id_));
+  int encoded_data_length =
+      DevToolsNetLogObserver::GetAndResetEncodedDataLength(request);
+  filter_->Send(new ResourceMsg_DataReceivedInBuffer(
+      routing_id_, pooled_request_id_, pooled_buffer_id_, pending_offset_,
+      pending_size_, encoded_data_length));
+  pending_size_ = 0;
+  pending_reads_ = 0;
+  sent_data_ = true;
+}
+
 bool AsyncResourceHandler::OnReadCompleted(int request_id, int* bytes_read) {
-  if (!*bytes_read)
+  if (!*bytes_read) {
+    pooled_read_buffer_ = NULL;
     return true;
+  }
+
+  if (pooled_read_buffer_) {
+    // Grow the reads the same way as for unpooled buffers below.
+    if (next_buffer_size_ == *bytes_read)
+      next_buffer_size_ = std::min(next_buffer_size_ * 2, kMaxReadBufSize);
+    // Data right after the held back data joins its message, which was
+    // already counted by WillSendData().
+    if (pending_size_ > 0 &&
+        filter_->buffer_pool()->ExtendLastCommit(request_id, pooled_offset_,
+                                                 *bytes_read)) {
+      pooled_read_buffer_ = NULL;
+      pending_size_ += *bytes_read;
+      ++pending_reads_;
+      bytes_sent_ += *bytes_read;
+      if (pending_size_ >= kMinDataMessageSize)
+        FlushPendingData();
+      return true;
+    }
+    FlushPendingData();
+    // If we may not send the data now, the request is paused, and this is
+    // called again once it resumes.
+    if (!rdh_->WillSendData(filter_->child_id(), request_id))
+      return true;
+    bytes_sent_ += *bytes_read;
+    return SendPooledData(request_id, *bytes_read);
+  }
+
   DCHECK(read_buffer_.get());
+  // Keep the data in order.
+  FlushPendingData();
 
   if (read_buffer_->buffer_size() == *bytes_read) {
     // The network layer has saturated our buffer. Next time, we should give it
@@ -226,6 +377,9 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int* bytes_read) {
   }
   // We just unmapped the memory.
   read_buffer_ = NULL;
+  // Keep the ACKs for this request matched up with the pooled data.
+  filter_->buffer_pool()->Commit(request_id, -1, *bytes_read);
+  bytes_sent_ += *bytes_read;
 
   net::URLRequest* request = rdh_->GetURLRequest(
       GlobalRequestID(filter_->child_id(), request_id));
@@ -253,7 +407,21 @@ bool AsyncResourceHandler::OnResponseCompleted(
   base::strlcpy(url_buf, url_.spec().c_str(), arraysize(url_buf));
   base::debug::Alias(url_buf);
 
+  FlushPendingData();
+
   TimeTicks completion_time = TimeTicks::Now();
+  int elapsed_ms = static_cast<int>(
+      (completion_time - first_read_time_).InMilliseconds());
+  if (bytes_sent_ > 0 && elapsed_ms > 0) {
+    int kbytes_per_second = static_cast<int>(bytes_sent_ / elapsed_ms);
+    if (all_data_pooled_) {
+      UMA_HISTOGRAM_COUNTS("Net.AsyncResourceHandler_Throughput_Pooled",
+                           kbytes_per_second);
+    } else {
+      UMA_HISTOGRAM_COUNTS("Net.AsyncResourceHandler_Throughput_Unpooled",
+                           kbytes_per_second);
+    }
+  }
   filter_->Send(new ResourceMsg_RequestComplete(routing_id_,
                                                 request_id,
                                                 status,
@@ -8,6 +8,8 @@
 
 #include <string>
 
+#include "base/time.h"
+#include "base/timer.h"
 #include "content/browser/renderer_host/resource_handler.h"
 #include "googleurl/src/gurl.h"
 
@@ -57,7 +59,42 @@ class AsyncResourceHandler : public ResourceHandler {
  private:
   virtual ~AsyncResourceHandler();
 
+  // Tries to read into the filter's buffer pool. Returns false if the pool
+  // has no room.
+  bool WillReadIntoPool(int request_id, net::IOBuffer** buf, int* buf_size);
+
+  // Sends the data read into the pool, or holds it back to be coalesced
+  // with the next reads.
+  bool SendPooledData(int request_id, int bytes_read);
+
+  // Sends the pooled data held back for coalescing, if any.
+  void FlushPendingData();
+
+  // Unpooled shared memory, used when the pool has no room.
   scoped_refptr<SharedIOBuffer> read_buffer_;
+
+  // The space in the pool that the current read goes to, if
+  // |pooled_read_buffer_| is set.
+  scoped_refptr<net::IOBuffer> pooled_read_buffer_;
+  int pooled_buffer_id_;
+  int pooled_offset_;
+
+  // The request that leased a buffer from the pool, or -1.
+  int pooled_request_id_;
+
+  // Small pooled reads that follow each other in the buffer are sent as one
+  // message. This is the data not sent yet, and the number of reads in it.
+  int pending_offset_;
+  int pending_size_;
+  int pending_reads_;
+  base::OneShotTimer<AsyncResourceHandler> flush_timer_;
+  bool sent_data_;
+
+  // For the throughput histograms.
+  int64 bytes_sent_;
+  bool all_data_pooled_;
+  base::TimeTicks first_read_time_;
+
   scoped_refptr<ResourceMessageFilter> filter_;
   int routing_id_;
   ResourceDispatcherHostImpl* rdh_;
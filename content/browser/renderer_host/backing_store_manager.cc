@@ -4,8 +4,11 @@
 
 #include "content/browser/renderer_host/backing_store_manager.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/mru_cache.h"
 #include "base/sys_info.h"
 #include "content/browser/renderer_host/backing_store.h"
@@ -26,6 +29,9 @@ typedef base::OwningMRUCache<RenderWidgetHost*, BackingStore*>
 static BackingStoreCache* large_cache = NULL;
 static BackingStoreCache* small_cache = NULL;
 
+// Created along with the caches, and like them never deleted.
+static base::MemoryPressureListener* memory_pressure_listener = NULL;
+
 // Threshold is based on a single large-monitor-width toolstrip.
 // (32bpp, 32 pixels high, 1920 pixels wide)
 // TODO(aa): The extension system no longer supports toolstrips, but we think
@@ -35,77 +41,98 @@ static BackingStoreCache* small_cache = NULL;
 // For more background, see: crbug.com/100506.
 const size_t kSmallThreshold = 4 * 32 * 1920;
 
-// Pick a large monitor size to use as a multiplier.  This is multiplied by the
-// max number of large backing stores (usually tabs) to pick a ceiling on the
-// max memory to use.
-// TODO(erikkay) Perhaps we should actually use monitor size?  That way we
-// could make an assertion like "worse case, there are two tabs in the cache".
-// However, the small_cache might mess up these calculations a bit.
+// Pick a large monitor size, which is the least memory we allow for backing
+// stores, so that the visible tab always fits.
 // TODO(erikkay) 32bpp assumption isn't great.
 const size_t kMemoryMultiplier = 4 * 1920 * 1200;  // ~9MB
 
-// The maximum number of large BackingStoreCache objects (tabs) to use.
-// Use a minimum of 2, and add one for each 256MB of physical memory you have.
-// Cap at 5, the thinking being that even if you have a gigantic amount of
-// RAM, there's a limit to how much caching helps beyond a certain number
-// of tabs. If users *really* want unlimited stores, allow it via the
-// --disable-backing-store-limit flag.
-static size_t MaxNumberOfBackingStores() {
-  static bool unlimited = false;
-  const CommandLine& command = *CommandLine::ForCurrentProcess();
-  unlimited = command.HasSwitch(switches::kDisableBackingStoreLimit);
-
-
-  if (unlimited) {
-    // 100 isn't truly unlimited, but given that backing stores count against
-    // GDI memory, it's well past any reasonable number. Many systems will
-    // begin to fail in strange ways well before they hit 100 stores.
-    return 100;
-  } else {
-    return std::min(5, 2 + (base::SysInfo::AmountOfPhysicalMemoryMB() / 256));
-  }
-}
+// Backing stores may use this fraction of physical memory: 16MB on a 1GB
+// device, so that hidden tabs don't crowd it, and 512MB on a 32GB desktop,
+// so that switching between many tabs doesn't need repaints.
+const int64 kPhysicalMemoryFraction = 64;
 
 // The maximum about of memory to use for all BackingStoreCache object combined.
+// If users *really* want unlimited stores, allow it via the
+// --disable-backing-store-limit flag.
 static size_t MaxBackingStoreMemory() {
-  // Compute in terms of the number of large monitor's worth of backing-store.
-  return MaxNumberOfBackingStores() * kMemoryMultiplier;
-}
-
-// Expires the given |backing_store| from |cache|.
-void ExpireBackingStoreAt(BackingStoreCache* cache,
-                          BackingStoreCache::iterator backing_store) {
-  cache->Erase(backing_store);
+  static size_t max_memory = 0;
+  if (!max_memory) {
+    const CommandLine& command = *CommandLine::ForCurrentProcess();
+    if (command.HasSwitch(switches::kDisableBackingStoreLimit)) {
+      // 100 large monitors isn't truly unlimited, but given that backing
+      // stores count against GDI memory, it's well past any reasonable
+      // number. Many systems will begin to fail in strange ways well before
+      // they hit 100 stores.
+      max_memory = 100 * kMemoryMultiplier;
+    } else {
+      int64 budget =
+          base::SysInfo::AmountOfPhysicalMemory() / kPhysicalMemoryFraction;
+      max_memory = std::max(static_cast<size_t>(budget), kMemoryMultiplier);
+    }
+  }
+  return max_memory;
 }
 
-size_t ExpireLastBackingStore(BackingStoreCache* cache) {
-  if (cache->size() < 1)
+// Expires the backing store that is cheapest to lose, and returns its size,
+// or 0 if there is none to expire. The most recently used store of each cache
+// is kept, as it is most likely visible. Stores of hidden widgets go first;
+// among the others, the one with the largest size times its position from
+// the front of the MRU goes, so large stores that haven't been used for a
+// while are preferred over small or recent ones.
+size_t ExpireBackingStore() {
+  BackingStoreCache* caches[] = { large_cache, small_cache };
+  BackingStoreCache* victim_cache = NULL;
+  BackingStoreCache::iterator victim;
+  bool victim_hidden = false;
+  uint64 victim_score = 0;
+  for (size_t i = 0; i < arraysize(caches); ++i) {
+    BackingStoreCache* cache = caches[i];
+    if (cache->size() < 2)
+      continue;
+    BackingStoreCache::iterator it = cache->begin();
+    uint64 rank = 1;
+    for (++it; it != cache->end(); ++it, ++rank) {
+      bool hidden =
+          content::RenderWidgetHostImpl::From(it->first)->is_hidden();
+      uint64 score = it->second->MemorySize() * rank;
+      if (!victim_cache || (hidden && !victim_hidden) ||
+          (hidden == victim_hidden && score > victim_score)) {
+        victim_cache = cache;
+        victim = it;
+        victim_hidden = hidden;
+        victim_score = score;
+      }
+    }
+  }
+  if (!victim_cache)
     return 0;
 
-  // Crazy C++ alert: rbegin.base() is a forward iterator pointing to end(),
-  // so we need to do -- to move one back to the actual last item.
-  BackingStoreCache::iterator entry = --cache->rbegin().base();
-  size_t entry_size = entry->second->MemorySize();
-  ExpireBackingStoreAt(cache, entry);
+  size_t entry_size = victim->second->MemorySize();
+  victim_cache->Erase(victim);
   return entry_size;
 }
 
+void OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL) {
+    BackingStoreManager::RemoveAllBackingStores();
+    return;
+  }
+  // Keep only the most recently used store of each cache, so the visible tab
+  // doesn't need a repaint.
+  while (ExpireBackingStore()) {
+  }
+}
+
 void CreateCacheSpace(size_t size) {
-  // Given a request for |size|, first free from the large cache (until there's
-  // only one item left) and then do the same from the small cache if we still
-  // don't have enough.
-  while (size > 0 && (large_cache->size() > 1 || small_cache->size() > 1)) {
-    BackingStoreCache* cache =
-        (large_cache->size() > 1) ? large_cache : small_cache;
-    while (size > 0 && cache->size() > 1) {
-      size_t entry_size = ExpireLastBackingStore(cache);
-      if (size > entry_size)
-        size -= entry_size;
-      else
-        size = 0;
-    }
+  // If the most recently used stores alone are over the budget, there is
+  // nothing more to free; they are needed for painting.
+  while (size > 0) {
+    size_t entry_size = ExpireBackingStore();
+    if (!entry_size)
+      break;
+    size -= std::min(size, entry_size);
   }
-  DCHECK(size == 0);
 }
 
 // Creates the backing store for the host based on the dimensions passed in.
@@ -118,13 +145,14 @@ BackingStore* CreateBackingStore(RenderWidgetHost* host,
   if (!large_cache) {
     large_cache = new BackingStoreCache(BackingStoreCache::NO_AUTO_EVICT);
     small_cache = new BackingStoreCache(BackingStoreCache::NO_AUTO_EVICT);
+    memory_pressure_listener = new base::MemoryPressureListener(
+        base::Bind(&OnMemoryPressure));
   }
 
   // TODO(erikkay) 32bpp is not always accurate
   size_t new_mem = backing_store_size.GetArea() * 4;
   size_t current_mem = BackingStoreManager::MemorySize();
   size_t max_mem = MaxBackingStoreMemory();
-  DCHECK(new_mem < max_mem);
   if (current_mem + new_mem > max_mem) {
     // Need to remove old backing stores to make room for the new one. We
     // don't want to do this when the backing store is being replace by a new
@@ -133,20 +161,9 @@ BackingStore* CreateBackingStore(RenderWidgetHost* host,
     // won't be over-sized.
     CreateCacheSpace((current_mem + new_mem) - max_mem);
   }
-  DCHECK((BackingStoreManager::MemorySize() + new_mem) <= max_mem);
-
-  BackingStoreCache* cache;
-  if (new_mem > kSmallThreshold) {
-    // Limit the number of large backing stores (tabs) to the memory tier number
-    // (between 2-5). While we allow a larger amount of memory for people who
-    // have large windows, this means that those who use small browser windows
-    // won't ever cache more than 5 tabs, so they pay a smaller memory cost.
-    if (large_cache->size() >= MaxNumberOfBackingStores())
-      ExpireLastBackingStore(large_cache);
-    cache = large_cache;
-  } else {
-    cache = small_cache;
-  }
+
+  BackingStoreCache* cache =
+      new_mem > kSmallThreshold ? large_cache : small_cache;
   BackingStore* backing_store = content::RenderWidgetHostImpl::From(
       host)->AllocBackingStore(backing_store_size);
   if (backing_store)
@@ -85,6 +85,12 @@ bool ClipboardMessageFilter::OnMessageReceived(const IPC::Message& message,
   return handled;
 }
 
+bool ClipboardMessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  supported_message_classes->push_back(ClipboardMsgStart);
+  return true;
+}
+
 ClipboardMessageFilter::~ClipboardMessageFilter() {
 }
 
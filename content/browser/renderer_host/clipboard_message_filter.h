@@ -23,6 +23,8 @@ class ClipboardMessageFilter : public content::BrowserMessageFilter {
       content::BrowserThread::ID* thread) OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message& message,
                                  bool* message_was_ok) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
  private:
   virtual ~ClipboardMessageFilter();
 
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "base/metrics/histogram.h"
 #include "base/process_util.h"
 #include "base/shared_memory.h"
 #include "base/threading/platform_thread.h"
@@ -15,7 +16,10 @@
 const int kMinIntervalBetweenReadCallsInMs = 10;
 
 AudioSyncReader::AudioSyncReader(base::SharedMemory* shared_memory)
-    : shared_memory_(shared_memory) {
+    : shared_memory_(shared_memory),
+      renderer_writes_size_(false),
+      read_count_(0),
+      missed_read_count_(0) {
 }
 
 AudioSyncReader::~AudioSyncReader() {
@@ -62,6 +66,12 @@ uint32 AudioSyncReader::Read(void* data, uint32 size) {
   previous_call_time_ = base::Time::Now();
 #endif
 
+  ++read_count_;
+  if (DataReady())
+    renderer_writes_size_ = true;
+  else if (renderer_writes_size_)
+    ++missed_read_count_;
+
   uint32 read_size = std::min(media::GetActualDataSizeInBytes(shared_memory_,
                                                               max_size),
                               size);
@@ -84,6 +94,12 @@ uint32 AudioSyncReader::Read(void* data, uint32 size) {
 }
 
 void AudioSyncReader::Close() {
+  if (renderer_writes_size_ && read_count_ > 0) {
+    UMA_HISTOGRAM_COUNTS("Media.AudioRendererMissedReads", missed_read_count_);
+    UMA_HISTOGRAM_PERCENTAGE("Media.AudioRendererMissedReadPercentage",
+                             100 * missed_read_count_ / read_count_);
+  }
+
   if (socket_.get()) {
     socket_->Close();
   }
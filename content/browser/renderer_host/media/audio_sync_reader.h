@@ -45,6 +45,16 @@ class AudioSyncReader : public media::AudioOutputController::SyncReader {
   base::SharedMemory* shared_memory_;
   base::Time previous_call_time_;
 
+  // Set once the renderer has written a packet size, proving it is a
+  // renderer that does so. Only those renderers can be checked for missed
+  // packets, since others never mark a packet as ready.
+  bool renderer_writes_size_;
+
+  // Number of Read() calls, and how many of those found the renderer hadn't
+  // filled the packet yet, i.e. audible glitches.
+  int read_count_;
+  int missed_read_count_;
+
   // Socket for transmitting audio data.
   scoped_ptr<base::CancelableSyncSocket> socket_;
 
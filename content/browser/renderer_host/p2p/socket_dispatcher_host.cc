@@ -134,6 +134,7 @@ bool P2PSocketDispatcherHost::OnMessageReceived(const IPC::Message& message,
     IPC_MESSAGE_HANDLER(P2PHostMsg_AcceptIncomingTcpConnection,
                         OnAcceptIncomingTcpConnection)
     IPC_MESSAGE_HANDLER(P2PHostMsg_Send, OnSend)
+    IPC_MESSAGE_HANDLER(P2PHostMsg_SendBatch, OnSendBatch)
     IPC_MESSAGE_HANDLER(P2PHostMsg_DestroySocket, OnDestroySocket)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP_EX()
@@ -248,6 +249,18 @@ void P2PSocketDispatcherHost::OnSend(const IPC::Message& msg, int socket_id,
   socket->Send(socket_address, data);
 }
 
+void P2PSocketDispatcherHost::OnSendBatch(
+    const IPC::Message& msg, int socket_id,
+    const std::vector<P2PPacket>& packets) {
+  P2PSocketHost* socket = LookupSocket(msg.routing_id(), socket_id);
+  if (!socket) {
+    LOG(ERROR) << "Received P2PHostMsg_SendBatch for invalid socket_id.";
+    return;
+  }
+  for (size_t i = 0; i < packets.size(); ++i)
+    socket->Send(packets[i].address, packets[i].data);
+}
+
 void P2PSocketDispatcherHost::OnDestroySocket(const IPC::Message& msg,
                                               int socket_id) {
   SocketsMap::iterator it = sockets_.find(
@@ -67,6 +67,8 @@ class P2PSocketDispatcherHost
   void OnSend(const IPC::Message& msg, int socket_id,
               const net::IPEndPoint& socket_address,
               const std::vector<char>& data);
+  void OnSendBatch(const IPC::Message& msg, int socket_id,
+                   const std::vector<P2PPacket>& packets);
   void OnDestroySocket(const IPC::Message& msg, int socket_id);
 
   void DoGetNetworkList();
@@ -274,6 +274,14 @@ MATCHER_P(MatchPacketMessage, packet_content, "") {
   return params.c == packet_content;
 }
 
+MATCHER_P(MatchPacketBatchMessage, packet_count, "") {
+  if (arg->type() != P2PMsg_OnDataReceivedBatch::ID)
+    return false;
+  P2PMsg_OnDataReceivedBatch::Param params;
+  P2PMsg_OnDataReceivedBatch::Read(arg, &params);
+  return params.b.size() == static_cast<size_t>(packet_count);
+}
+
 MATCHER_P(MatchIncomingSocketMessage, address, "") {
   if (arg->type() != P2PMsg_OnIncomingTcpConnection::ID)
     return false;
@@ -15,6 +15,11 @@ namespace {
 // UDP packets cannot be bigger than 64k.
 const int kReadBufferSize = 65536;
 
+// Maximum number of packets sent to the renderer in one message. Packets
+// that are already queued in the socket are read without waiting, so under
+// load one read completion yields many packets.
+const size_t kMaxPacketsPerMessage = 32;
+
 }  // namespace
 
 namespace content {
@@ -77,6 +82,9 @@ bool P2PSocketHostUdp::Init(const net::IPEndPoint& local_address,
 }
 
 void P2PSocketHostUdp::OnError() {
+  // Deliver what was read before the error.
+  FlushReceivedPackets();
+
   socket_.reset();
   send_queue_.clear();
 
@@ -94,6 +102,7 @@ void P2PSocketHostUdp::DoRead() {
                                           base::Unretained(this)));
     DidCompleteRead(result);
   } while (result > 0);
+  FlushReceivedPackets();
 }
 
 void P2PSocketHostUdp::OnRecv(int result) {
@@ -122,14 +131,30 @@ void P2PSocketHostUdp::DidCompleteRead(int result) {
       }
     }
 
-    message_sender_->Send(new P2PMsg_OnDataReceived(routing_id_, id_,
-                                                    recv_address_, data));
+    received_packets_.push_back(P2PPacket(recv_address_, data));
+    if (received_packets_.size() >= kMaxPacketsPerMessage)
+      FlushReceivedPackets();
   } else if (result < 0 && result != net::ERR_IO_PENDING) {
     LOG(ERROR) << "Error when reading from UDP socket: " << result;
     OnError();
   }
 }
 
+void P2PSocketHostUdp::FlushReceivedPackets() {
+  if (received_packets_.empty())
+    return;
+
+  if (received_packets_.size() == 1) {
+    message_sender_->Send(new P2PMsg_OnDataReceived(
+        routing_id_, id_, received_packets_[0].address,
+        received_packets_[0].data));
+  } else {
+    message_sender_->Send(new P2PMsg_OnDataReceivedBatch(
+        routing_id_, id_, received_packets_));
+  }
+  received_packets_.clear();
+}
+
 void P2PSocketHostUdp::Send(const net::IPEndPoint& to,
                             const std::vector<char>& data) {
   if (!socket_.get()) {
@@ -53,6 +53,9 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   void DoSend(const PendingPacket& packet);
   void DidCompleteRead(int result);
 
+  // Sends the packets read so far to the renderer, in one message.
+  void FlushReceivedPackets();
+
   // Callbacks for RecvFrom() and SendTo().
   void OnRecv(int result);
   void OnSend(int result);
@@ -60,6 +63,8 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   scoped_ptr<net::DatagramServerSocket> socket_;
   scoped_refptr<net::IOBuffer> recv_buffer_;
   net::IPEndPoint recv_address_;
+  // Packets read since the last FlushReceivedPackets().
+  std::vector<P2PPacket> received_packets_;
 
   std::deque<PendingPacket> send_queue_;
   int send_queue_bytes_;
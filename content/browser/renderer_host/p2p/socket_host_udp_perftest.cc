@@ -0,0 +1,150 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/p2p/socket_host_udp.h"
+
+#include <vector>
+
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/time.h"
+#include "content/browser/renderer_host/p2p/socket_host_test_utils.h"
+#include "content/common/p2p_messages.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/base/test_completion_callback.h"
+#include "net/udp/udp_server_socket.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Packets are sent in bursts small enough not to overflow the receive
+// buffer of the socket, as an audio/video stream would arrive.
+const int kBurstSize = 64;
+const int kPacketCount = 64 * 1000;
+
+// Gives up on a burst if some of its packets were dropped.
+const int kBurstTimeoutMs = 2000;
+
+// Counts the packets P2PSocketHostUdp passes to the renderer and the number
+// of messages it takes.
+class CountingIPCSender : public IPC::Message::Sender {
+ public:
+  CountingIPCSender() : packets_(0), messages_(0) {}
+
+  virtual bool Send(IPC::Message* msg) OVERRIDE {
+    if (msg->type() == P2PMsg_OnSocketCreated::ID) {
+      P2PMsg_OnSocketCreated::Param params;
+      P2PMsg_OnSocketCreated::Read(msg, &params);
+      address_ = params.b;
+    } else if (msg->type() == P2PMsg_OnDataReceived::ID) {
+      packets_++;
+      messages_++;
+    } else if (msg->type() == P2PMsg_OnDataReceivedBatch::ID) {
+      P2PMsg_OnDataReceivedBatch::Param params;
+      P2PMsg_OnDataReceivedBatch::Read(msg, &params);
+      packets_ += params.b.size();
+      messages_++;
+    }
+    delete msg;
+    return true;
+  }
+
+  const net::IPEndPoint& address() const { return address_; }
+  int packets() const { return packets_; }
+  int messages() const { return messages_; }
+
+ private:
+  net::IPEndPoint address_;
+  int packets_;
+  int messages_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingIPCSender);
+};
+
+net::IPEndPoint LoopbackAddress() {
+  net::IPAddressNumber loopback;
+  CHECK(net::ParseIPLiteralToNumber("127.0.0.1", &loopback));
+  return net::IPEndPoint(loopback, 0);
+}
+
+}  // namespace
+
+namespace content {
+
+// Measures how fast packets arriving from the network reach the renderer,
+// and how many IPC messages they take.
+TEST(P2PSocketHostUdpPerfTest, ReceivePacketRate) {
+  MessageLoopForIO message_loop;
+  CountingIPCSender sender;
+  P2PSocketHostUdp socket_host(&sender, 0, 0);
+  ASSERT_TRUE(socket_host.Init(LoopbackAddress(), net::IPEndPoint()));
+
+  net::UDPServerSocket peer(NULL, net::NetLog::Source());
+  ASSERT_EQ(net::OK, peer.Listen(LoopbackAddress()));
+
+  // STUN requests are accepted from any peer.
+  std::vector<char> packet;
+  CreateStunRequest(&packet);
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(packet.size()));
+  memcpy(buffer->data(), &packet[0], packet.size());
+
+  int sent = 0;
+  PerfTimeLogger timer("P2P_UDP_receive");
+  base::TimeTicks start = base::TimeTicks::Now();
+  while (sent < kPacketCount) {
+    for (int i = 0; i < kBurstSize; ++i, ++sent) {
+      net::TestCompletionCallback callback;
+      ASSERT_EQ(static_cast<int>(packet.size()), callback.GetResult(
+          peer.SendTo(buffer, packet.size(), sender.address(),
+                      callback.callback())));
+    }
+    base::TimeTicks deadline = base::TimeTicks::Now() +
+        base::TimeDelta::FromMilliseconds(kBurstTimeoutMs);
+    while (sender.packets() < sent && base::TimeTicks::Now() < deadline)
+      message_loop.RunAllPending();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  timer.Done();
+
+  EXPECT_GT(sender.packets(), 0);
+  printf("Received %d of %d packets in %d messages, %.0f packets/s, "
+         "%.1f packets per message\n",
+         sender.packets(), kPacketCount, sender.messages(),
+         sender.packets() / elapsed.InSecondsF(),
+         static_cast<double>(sender.packets()) / sender.messages());
+}
+
+// Measures the IPC cost of the renderer sending packets to the browser one
+// message per packet, and in batches.
+TEST(P2PSocketHostUdpPerfTest, SendMessageCost) {
+  net::IPEndPoint address = LoopbackAddress();
+  std::vector<char> data;
+  CreateRandomPacket(&data);
+
+  {
+    PerfTimeLogger timer("P2P_UDP_send_messages_single");
+    for (int i = 0; i < kPacketCount; ++i) {
+      P2PHostMsg_Send msg(0, 0, address, data);
+      P2PHostMsg_Send::Param params;
+      ASSERT_TRUE(P2PHostMsg_Send::Read(&msg, &params));
+    }
+    timer.Done();
+  }
+
+  {
+    std::vector<P2PPacket> packets(kBurstSize, P2PPacket(address, data));
+    PerfTimeLogger timer("P2P_UDP_send_messages_batched");
+    for (int i = 0; i < kPacketCount; i += kBurstSize) {
+      P2PHostMsg_SendBatch msg(0, 0, packets);
+      P2PHostMsg_SendBatch::Param params;
+      ASSERT_TRUE(P2PHostMsg_SendBatch::Read(&msg, &params));
+    }
+    timer.Done();
+  }
+}
+
+}  // namespace content
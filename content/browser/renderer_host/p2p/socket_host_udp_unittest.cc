@@ -89,6 +89,13 @@ class FakeDatagramServerSocket : public net::DatagramServerSocket {
     return true;
   }
 
+  // Adds a packet that is returned by the next RecvFrom() call, as if it
+  // arrived while the previous one was being handled.
+  void QueuePacket(const net::IPEndPoint& address,
+                   const std::vector<char>& data) {
+    incoming_packets_.push_back(UDPPacket(address, data));
+  }
+
   void ReceivePacket(const net::IPEndPoint& address, std::vector<char> data) {
     if (!recv_callback_.is_null()) {
       int size = std::min(recv_size_, static_cast<int>(data.size()));
@@ -247,4 +254,20 @@ TEST_F(P2PSocketHostUdpTest, SendAfterStunResponseDifferentHost) {
   socket_host_->Send(dest2_, packet);
 }
 
+// Verify that packets that are already queued in the socket are passed
+// to the renderer in one message.
+TEST_F(P2PSocketHostUdpTest, ReceiveBatch) {
+  std::vector<char> request_packet;
+  CreateStunRequest(&request_packet);
+  for (int i = 0; i < 4; ++i) {
+    std::vector<char> packet;
+    CreateRandomPacket(&packet);
+    socket_->QueuePacket(dest1_, packet);
+  }
+
+  EXPECT_CALL(sender_, Send(MatchPacketBatchMessage(5)))
+      .WillOnce(DoAll(DeleteArg<0>(), Return(true)));
+  socket_->ReceivePacket(dest1_, request_packet);
+}
+
 }  // namespace content
@@ -76,6 +76,7 @@
 #include "content/browser/renderer_host/render_widget_helper.h"
 #include "content/browser/renderer_host/resource_message_filter.h"
 #include "content/browser/renderer_host/socket_stream_dispatcher_host.h"
+#include "content/browser/renderer_host/spare_render_process_host_pool.h"
 #include "content/browser/renderer_host/text_input_client_message_filter.h"
 #include "content/browser/resolve_proxy_msg_helper.h"
 #include "content/browser/trace_message_filter.h"
@@ -183,6 +184,11 @@ class RendererMainThread : public base::Thread {
 
 namespace {
 
+// How long a renderer has to stay in the background before it is asked to
+// reclaim memory. Long enough that switching back and forth between tabs
+// doesn't throw away caches that are about to be used again.
+const int kReclaimMemoryDelaySeconds = 30;
+
 // Helper class that we pass to ResourceMessageFilter so that it can find the
 // right net::URLRequestContext for a request.
 class RendererURLRequestContextSelector
@@ -700,6 +706,7 @@ void RenderProcessHostImpl::PropagateBrowserCommandLineToRenderer(
     switches::kEnablePointerLock,
     switches::kEnablePreparsedJsCaching,
     switches::kEnablePruneGpuCommandBuffers,
+    switches::kEnableRendererSeccompFilterSandbox,
 #if defined(OS_MACOSX)
     // Allow this to be set when invoking the browser and relayed along.
     switches::kEnableSandboxLogging,
@@ -948,6 +955,8 @@ void RenderProcessHostImpl::OnChannelConnected(int32 peer_pid) {
   tracked_objects::ThreadData::Status status =
       tracked_objects::ThreadData::status();
   Send(new ChildProcessMsg_SetProfilerStatus(status));
+  Send(new ChildProcessMsg_SetProfilerSamplingInterval(
+      tracked_objects::ThreadData::sampling_interval()));
 }
 
 void RenderProcessHostImpl::OnChannelError() {
@@ -1139,6 +1148,10 @@ bool RenderProcessHostImpl::IsSuitableHost(
   if (host->GetBrowserContext() != browser_context)
     return false;
 
+  // Spares are handed out whole, never shared.
+  if (content::SpareRenderProcessHostPool::GetInstance()->IsSpareHost(host))
+    return false;
+
   WebUIControllerFactory* factory =
       content::GetContentClient()->browser()->GetWebUIControllerFactory();
   if (factory &&
@@ -1285,6 +1298,13 @@ void RenderProcessHostImpl::SetBackgrounded(bool backgrounded) {
   // (and hence hasn't been created yet), we will set the process priority
   // later when we create the process.
   backgrounded_ = backgrounded;
+  if (backgrounded) {
+    reclaim_memory_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromSeconds(kReclaimMemoryDelaySeconds),
+        this, &RenderProcessHostImpl::ReclaimBackgroundMemory);
+  } else {
+    reclaim_memory_timer_.Stop();
+  }
   if (!child_process_launcher_.get() || child_process_launcher_->IsStarting())
     return;
 
@@ -1302,6 +1322,11 @@ void RenderProcessHostImpl::SetBackgrounded(bool backgrounded) {
   child_process_launcher_->SetProcessBackgrounded(backgrounded);
 }
 
+void RenderProcessHostImpl::ReclaimBackgroundMemory() {
+  if (backgrounded_ && channel_.get())
+    Send(new ViewMsg_ReclaimMemory());
+}
+
 void RenderProcessHostImpl::OnProcessLaunched() {
   // No point doing anything, since this object will be destructed soon.  We
   // especially don't want to send the RENDERER_PROCESS_CREATED notification,
@@ -181,6 +181,9 @@ class CONTENT_EXPORT RenderProcessHostImpl
   // Callers can reduce the RenderProcess' priority.
   void SetBackgrounded(bool backgrounded);
 
+  // Asks a renderer that stayed backgrounded to shrink its memory.
+  void ReclaimBackgroundMemory();
+
   // Handle termination of our process. |was_alive| indicates that when we
   // tried to retrieve the exit code the process had not finished yet.
   void ProcessDied(base::ProcessHandle handle,
@@ -196,6 +199,10 @@ class CONTENT_EXPORT RenderProcessHostImpl
   // Does this process have backgrounded priority.
   bool backgrounded_;
 
+  // Runs ReclaimBackgroundMemory() once the process has been backgrounded
+  // for a while.
+  base::OneShotTimer<RenderProcessHostImpl> reclaim_memory_timer_;
+
   // Used to allow a RenderWidgetHost to intercept various messages on the
   // IO thread.
   scoped_refptr<RenderWidgetHelper> widget_helper_;
@@ -212,8 +219,10 @@ class CONTENT_EXPORT RenderProcessHostImpl
   std::map<TransportDIB::Id, TransportDIB*> cached_dibs_;
 
   enum {
-    // This is the maximum size of |cached_dibs_|
-    MAX_MAPPED_TRANSPORT_DIBS = 3,
+    // This is the maximum size of |cached_dibs_|. It is one more than the
+    // renderer's own cache of DIBs, so that the DIBs the renderer reuses from
+    // frame to frame stay mapped here too.
+    MAX_MAPPED_TRANSPORT_DIBS = 4,
   };
 
   // Map a transport DIB from its Id and return it. Returns NULL on error.
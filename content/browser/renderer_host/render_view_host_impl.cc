@@ -209,6 +209,7 @@ bool RenderViewHostImpl::CreateRenderView(const string16& frame_name,
                                           int opener_route_id,
                                           int32 max_page_id) {
   DCHECK(!IsRenderViewLive()) << "Creating view twice";
+  create_view_time_ = base::TimeTicks::Now();
 
   // The process may (if we're sharing a process with another host that already
   // initialized it) or may not (we have our own process or the old process
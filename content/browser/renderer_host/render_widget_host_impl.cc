@@ -23,11 +23,14 @@
 #include "content/browser/renderer_host/render_process_host_impl.h"
 #include "content/browser/renderer_host/render_view_host_impl.h"
 #include "content/browser/renderer_host/render_widget_helper.h"
+#include "content/browser/renderer_host/spare_render_process_host_pool.h"
+#include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
 #include "content/browser/renderer_host/tap_suppression_controller.h"
 #include "content/common/accessibility_messages.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/view_messages.h"
 #include "content/port/browser/render_widget_host_view_port.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/native_web_keyboard_event.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_types.h"
@@ -58,6 +61,8 @@ using WebKit::WebKeyboardEvent;
 using WebKit::WebMouseEvent;
 using WebKit::WebMouseWheelEvent;
 using WebKit::WebTextDirection;
+using WebKit::WebTouchEvent;
+using WebKit::WebTouchPoint;
 
 namespace {
 
@@ -81,6 +86,39 @@ bool ShouldCoalesceMouseWheelEvents(const WebMouseWheelEvent& last_event,
          last_event.momentumPhase == new_event.momentumPhase;
 }
 
+// Returns |true| if |new_event| only moves the same touch points as
+// |last_event|, so that the two can be sent as one event.
+bool ShouldCoalesceTouchEvents(const WebTouchEvent& last_event,
+                               const WebTouchEvent& new_event) {
+  if (last_event.type != WebInputEvent::TouchMove ||
+      new_event.type != WebInputEvent::TouchMove ||
+      last_event.modifiers != new_event.modifiers ||
+      last_event.touchesLength != new_event.touchesLength) {
+    return false;
+  }
+  for (unsigned i = 0; i < new_event.touchesLength; ++i) {
+    if (last_event.touches[i].id != new_event.touches[i].id)
+      return false;
+  }
+  return true;
+}
+
+// Folds |new_event| into |last_event|. A point that moved in either event has
+// moved in the result.
+void CoalesceTouchEvents(const WebTouchEvent& new_event,
+                         WebTouchEvent* last_event) {
+  WebTouchEvent coalesced = new_event;
+  coalesced.changedTouchesLength = 0;
+  for (unsigned i = 0; i < coalesced.touchesLength; ++i) {
+    WebTouchPoint& point = coalesced.touches[i];
+    if (last_event->touches[i].state == WebTouchPoint::StateMoved)
+      point.state = WebTouchPoint::StateMoved;
+    if (point.state == WebTouchPoint::StateMoved)
+      coalesced.changedTouches[coalesced.changedTouchesLength++] = point;
+  }
+  *last_event = coalesced;
+}
+
 }  // namespace
 
 namespace content {
@@ -153,6 +191,7 @@ RenderWidgetHostImpl::RenderWidgetHostImpl(RenderProcessHost* process,
   // Because the widget initializes as is_hidden_ == false,
   // tell the process host that we're alive.
   process_->WidgetRestored();
+  NotifyResourceDispatcherHostOfVisibility(true);
 }
 
 RenderWidgetHostImpl::~RenderWidgetHostImpl() {
@@ -323,6 +362,18 @@ bool RenderWidgetHostImpl::Send(IPC::Message* msg) {
   return process_->Send(msg);
 }
 
+void RenderWidgetHostImpl::NotifyResourceDispatcherHostOfVisibility(
+    bool visible) {
+  ResourceDispatcherHostImpl* rdh = ResourceDispatcherHostImpl::Get();
+  if (!rdh)  // NULL in unittests.
+    return;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResourceDispatcherHostImpl::OnVisibilityChanged,
+                 base::Unretained(rdh), process_->GetID(), routing_id_,
+                 visible));
+}
+
 void RenderWidgetHostImpl::WasHidden() {
   is_hidden_ = true;
 
@@ -335,6 +386,7 @@ void RenderWidgetHostImpl::WasHidden() {
 
   // Tell the RenderProcessHost we were hidden.
   process_->WidgetHidden();
+  NotifyResourceDispatcherHostOfVisibility(false);
 
   bool is_visible = false;
   NotificationService::current()->Notify(
@@ -925,6 +977,8 @@ void RenderWidgetHostImpl::ForwardInputEvent(const WebInputEvent& input_event,
   if (input_event.type == WebInputEvent::RawKeyDown)
     message->WriteBool(is_keyboard_shortcut);
   input_event_start_time_ = TimeTicks::Now();
+  if (first_unpainted_input_event_time_.is_null())
+    first_unpainted_input_event_time_ = input_event_start_time_;
   Send(message);
 
   // Any non-wheel input event cancels pending wheel events.
@@ -947,8 +1001,32 @@ void RenderWidgetHostImpl::ForwardTouchEvent(
   if (ignore_input_events_ || process_->IgnoreInputEvents())
     return;
 
-  // TODO(sad): Do touch-event coalescing when appropriate.
-  ForwardInputEvent(touch_event, sizeof(WebKit::WebTouchEvent), false);
+  // Don't queue events that can't be sent, since they would never be acked.
+  if (!process_->HasConnection())
+    return;
+
+  // Only one touch event is sent to the renderer at a time. Touch moves that
+  // arrive in the meantime are coalesced, like wheel events, so that a busy
+  // renderer isn't handed more moves than it can handle in a frame. The
+  // front of the queue is the event in flight, so it is never coalesced into.
+  if (touch_event_queue_.size() > 1 &&
+      ShouldCoalesceTouchEvents(touch_event_queue_.back().event,
+                                touch_event)) {
+    QueuedTouchEvent* last_touch_event = &touch_event_queue_.back();
+    CoalesceTouchEvents(touch_event, &last_touch_event->event);
+    ++last_touch_event->num_events;
+    return;
+  }
+
+  QueuedTouchEvent queued_event;
+  queued_event.event = touch_event;
+  queued_event.num_events = 1;
+  touch_event_queue_.push_back(queued_event);
+  HISTOGRAM_COUNTS_100("MPArch.RWH_TouchQueueSize", touch_event_queue_.size());
+  if (touch_event_queue_.size() == 1) {
+    ForwardInputEvent(touch_event_queue_.front().event,
+                      sizeof(WebTouchEvent), false);
+  }
 }
 
 #if defined(TOOLKIT_GTK)
@@ -987,6 +1065,8 @@ void RenderWidgetHostImpl::RendererExited(base::TerminationStatus status,
   next_mouse_move_.reset();
   mouse_wheel_pending_ = false;
   coalesced_mouse_wheel_events_.clear();
+  touch_event_queue_.clear();
+  first_unpainted_input_event_time_ = TimeTicks();
 
   // Must reset these to ensure that keyboard events work with a new renderer.
   key_queue_.clear();
@@ -1261,6 +1341,26 @@ void RenderWidgetHostImpl::OnMsgUpdateRect(
 
   DCHECK(!params.view_size.IsEmpty());
 
+  if (!create_view_time_.is_null()) {
+    TimeDelta delta = TimeTicks::Now() - create_view_time_;
+    if (content::SpareRenderProcessHostPool::GetInstance()->WasSpareHost(
+            GetProcess()->GetID())) {
+      UMA_HISTOGRAM_TIMES("MPArch.RWH_CreateViewToFirstPaint_SpareProcess",
+                          delta);
+    } else {
+      UMA_HISTOGRAM_TIMES("MPArch.RWH_CreateViewToFirstPaint", delta);
+    }
+    create_view_time_ = TimeTicks();
+  }
+
+  // Log how long the input sent since the last paint took to show up on
+  // screen. This includes the time the renderer spent handling it.
+  if (!first_unpainted_input_event_time_.is_null()) {
+    UMA_HISTOGRAM_TIMES("MPArch.RWH_InputEventToPaint",
+                        TimeTicks::Now() - first_unpainted_input_event_time_);
+    first_unpainted_input_event_time_ = TimeTicks();
+  }
+
   bool was_async = false;
 
   // If this is a GPU UpdateRect, params.bitmap is invalid and dib will be NULL.
@@ -1457,8 +1557,24 @@ void RenderWidgetHostImpl::ProcessWheelAck(bool processed) {
 
 void RenderWidgetHostImpl::ProcessTouchAck(
     WebInputEvent::Type type, bool processed) {
-  if (view_)
-    view_->ProcessTouchAck(type, processed);
+  // An ack with nothing in flight is for an event sent before the renderer
+  // was replaced.
+  if (touch_event_queue_.empty())
+    return;
+
+  // The view expects one ack per event it forwarded, in order.
+  int num_events = touch_event_queue_.front().num_events;
+  touch_event_queue_.pop_front();
+  if (view_) {
+    for (int i = 0; i < num_events; ++i)
+      view_->ProcessTouchAck(type, processed);
+  }
+
+  // Now send the next (coalesced) touch event.
+  if (!touch_event_queue_.empty()) {
+    ForwardInputEvent(touch_event_queue_.front().event,
+                      sizeof(WebTouchEvent), false);
+  }
 }
 
 void RenderWidgetHostImpl::OnMsgFocus() {
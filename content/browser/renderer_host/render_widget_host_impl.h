@@ -175,6 +175,9 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
     return is_accelerated_compositing_active_;
   }
 
+  // Tells us whether the page is hidden, e.g. in a background tab.
+  bool is_hidden() const { return is_hidden_; }
+
   // Notifies the RenderWidgetHost that the View was destroyed.
   void ViewDestroyed();
 
@@ -452,12 +455,19 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
   // This value indicates how long to wait before we consider a renderer hung.
   int hung_renderer_delay_ms_;
 
+  // Set by RenderViewHostImpl when it creates its view, for the histograms
+  // of the time to the first paint. Null once that paint is in.
+  base::TimeTicks create_view_time_;
+
  private:
   friend class ::MockRenderWidgetHost;
 
   // Tell this object to destroy itself.
   void Destroy();
 
+  // Lets the ResourceDispatcherHost favor the requests of visible widgets.
+  void NotifyResourceDispatcherHostOfVisibility(bool visible);
+
   // Checks whether the renderer is hung and calls NotifyRendererUnresponsive
   // if it is.
   void CheckRendererIsUnresponsive();
@@ -637,9 +647,25 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
   // would be queued) results in very slow scrolling.
   WheelEventQueue coalesced_mouse_wheel_events_;
 
+  // A touch event to send, along with how many of the view's events were
+  // coalesced into it.
+  struct QueuedTouchEvent {
+    WebKit::WebTouchEvent event;
+    int num_events;
+  };
+  typedef std::deque<QueuedTouchEvent> TouchEventQueue;
+
+  // Touch events not acked yet. The front one has been sent to the renderer;
+  // touch moves behind it are coalesced if they move the same points.
+  TouchEventQueue touch_event_queue_;
+
   // The time when an input event was sent to the RenderWidget.
   base::TimeTicks input_event_start_time_;
 
+  // The time the first input event since the last paint was sent to the
+  // RenderWidget, or null if there was none.
+  base::TimeTicks first_unpainted_input_event_time_;
+
   // Keyboard event listeners.
   std::list<KeyboardListener*> keyboard_listeners_;
 
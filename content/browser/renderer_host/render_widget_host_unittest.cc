@@ -34,6 +34,8 @@ using content::RenderWidgetHost;
 using content::RenderWidgetHostImpl;
 using WebKit::WebInputEvent;
 using WebKit::WebMouseWheelEvent;
+using WebKit::WebTouchEvent;
+using WebKit::WebTouchPoint;
 
 namespace gfx {
 class Size;
@@ -123,9 +125,12 @@ bool RenderWidgetHostProcess::WaitForBackingStoreMsg(
 class TestView : public content::TestRenderWidgetHostView {
  public:
   explicit TestView(RenderWidgetHostImpl* rwh)
-      : content::TestRenderWidgetHostView(rwh) {
+      : content::TestRenderWidgetHostView(rwh),
+        touch_ack_count_(0) {
   }
 
+  int touch_ack_count() const { return touch_ack_count_; }
+
   // Sets the bounds returned by GetViewBounds.
   void set_bounds(const gfx::Rect& bounds) {
     bounds_ = bounds;
@@ -136,6 +141,10 @@ class TestView : public content::TestRenderWidgetHostView {
     return bounds_;
   }
 
+  virtual void ProcessTouchAck(WebInputEvent::Type type, bool processed) {
+    ++touch_ack_count_;
+  }
+
 #if defined(OS_MACOSX)
   virtual gfx::Rect GetViewCocoaBounds() const {
     return bounds_;
@@ -144,6 +153,7 @@ class TestView : public content::TestRenderWidgetHostView {
 
  protected:
   gfx::Rect bounds_;
+  int touch_ack_count_;
   DISALLOW_COPY_AND_ASSIGN(TestView);
 };
 
@@ -316,6 +326,19 @@ class RenderWidgetHostTest : public testing::Test {
     host_->ForwardWheelEvent(wheel_event);
   }
 
+  // Sends a touch event of |type| with a single touch point at |x|, |y|.
+  void SimulateTouchEvent(WebInputEvent::Type type, int x, int y) {
+    WebTouchEvent touch_event;
+    touch_event.type = type;
+    touch_event.touchesLength = 1;
+    touch_event.touches[0].id = 0;
+    touch_event.touches[0].state = type == WebInputEvent::TouchMove ?
+        WebTouchPoint::StateMoved : WebTouchPoint::StatePressed;
+    touch_event.touches[0].position.x = x;
+    touch_event.touches[0].position.y = y;
+    host_->ForwardTouchEvent(touch_event);
+  }
+
   MessageLoopForUI message_loop_;
 
   scoped_ptr<TestBrowserContext> browser_context_;
@@ -746,6 +769,34 @@ TEST_F(RenderWidgetHostTest, CoalescesWheelEvents) {
   EXPECT_EQ(0U, process_->sink().message_count());
 }
 
+TEST_F(RenderWidgetHostTest, CoalescesTouchMoves) {
+  process_->sink().ClearMessages();
+
+  SimulateTouchEvent(WebInputEvent::TouchStart, 0, 0);  // sent directly
+  SimulateTouchEvent(WebInputEvent::TouchMove, 1, 1);  // enqueued
+  SimulateTouchEvent(WebInputEvent::TouchMove, 2, 2);  // coalesced
+  SimulateTouchEvent(WebInputEvent::TouchMove, 3, 3);  // coalesced
+
+  // Check that only the first event was sent.
+  EXPECT_EQ(1U, process_->sink().message_count());
+  EXPECT_TRUE(process_->sink().GetUniqueMessageMatching(
+                  ViewMsg_HandleInputEvent::ID));
+  process_->sink().ClearMessages();
+
+  // The ACK sends the coalesced move.
+  SendInputEventACK(WebInputEvent::TouchStart, true);
+  EXPECT_EQ(1, view_->touch_ack_count());
+  EXPECT_EQ(1U, process_->sink().message_count());
+  EXPECT_TRUE(process_->sink().GetUniqueMessageMatching(
+                  ViewMsg_HandleInputEvent::ID));
+  process_->sink().ClearMessages();
+
+  // The view gets an ACK for each of the moves it sent.
+  SendInputEventACK(WebInputEvent::TouchMove, true);
+  EXPECT_EQ(4, view_->touch_ack_count());
+  EXPECT_EQ(0U, process_->sink().message_count());
+}
+
 // Test that the hang monitor timer expires properly if a new timer is started
 // while one is in progress (see crbug.com/11007).
 TEST_F(RenderWidgetHostTest, DontPostponeHangMonitorTimeout) {
@@ -0,0 +1,178 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_buffer_pool.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+
+namespace content {
+
+// The same as the largest unpooled read buffer. (512 kilobytes).
+const int ResourceBufferPool::kBufferSize = 524288;
+
+const int ResourceBufferPool::kMaxBuffers = 8;
+
+ResourceBufferPool::Buffer::Buffer() : shared(false) {
+}
+
+ResourceBufferPool::Buffer::~Buffer() {
+}
+
+ResourceBufferPool::Lease::Lease() : buffer_id(-1), released(false) {
+}
+
+ResourceBufferPool::Lease::~Lease() {
+}
+
+ResourceBufferPool::ResourceBufferPool() {
+}
+
+ResourceBufferPool::~ResourceBufferPool() {
+}
+
+char* ResourceBufferPool::Allocate(int request_id,
+                                   int min_size,
+                                   int max_size,
+                                   int* buffer_id,
+                                   int* offset,
+                                   int* size) {
+  DCHECK_LE(min_size, max_size);
+  DCHECK_LE(max_size, kBufferSize);
+  LeaseMap::iterator it = leases_.find(request_id);
+  if (it == leases_.end()) {
+    int id = TakeFreeBuffer();
+    if (id < 0)
+      return NULL;
+    it = leases_.insert(std::make_pair(request_id, Lease())).first;
+    it->second.buffer_id = id;
+  }
+  Lease& lease = it->second;
+  DCHECK(!lease.released);
+
+  // Find the oldest and newest pooled data still in the ring.
+  const std::pair<int, int>* oldest = NULL;
+  const std::pair<int, int>* newest = NULL;
+  for (size_t i = 0; i < lease.in_flight.size(); ++i) {
+    if (lease.in_flight[i].first < 0)
+      continue;
+    if (!oldest)
+      oldest = &lease.in_flight[i];
+    newest = &lease.in_flight[i];
+  }
+
+  // The free space is either the end and the start of the buffer, around the
+  // data in flight, or the gap between the newest data and the oldest one,
+  // once writing wrapped around.
+  int start = 0;
+  int available = kBufferSize;
+  if (oldest) {
+    int newest_end = newest->first + newest->second;
+    if (newest->first >= oldest->first) {
+      start = newest_end;
+      available = kBufferSize - newest_end;
+      if (available < min_size) {
+        start = 0;
+        available = oldest->first;
+      }
+    } else {
+      start = newest_end;
+      available = oldest->first - newest_end;
+    }
+  }
+  if (available < min_size)
+    return NULL;
+
+  *buffer_id = lease.buffer_id;
+  *offset = start;
+  *size = std::min(available, max_size);
+  return static_cast<char*>(buffers_[lease.buffer_id]->memory.memory()) +
+      start;
+}
+
+void ResourceBufferPool::Commit(int request_id, int offset, int size) {
+  LeaseMap::iterator it = leases_.find(request_id);
+  if (it == leases_.end()) {
+    DCHECK_EQ(-1, offset);
+    return;
+  }
+  it->second.in_flight.push_back(std::make_pair(offset, size));
+}
+
+bool ResourceBufferPool::ExtendLastCommit(int request_id,
+                                          int offset,
+                                          int size) {
+  LeaseMap::iterator it = leases_.find(request_id);
+  if (it == leases_.end() || it->second.in_flight.empty())
+    return false;
+  std::pair<int, int>& last = it->second.in_flight.back();
+  if (last.first < 0 || last.first + last.second != offset)
+    return false;
+  last.second += size;
+  return true;
+}
+
+void ResourceBufferPool::OnDataReceivedACK(int request_id) {
+  LeaseMap::iterator it = leases_.find(request_id);
+  if (it == leases_.end() || it->second.in_flight.empty())
+    return;
+  it->second.in_flight.pop_front();
+  MaybeReturnBuffer(it);
+}
+
+void ResourceBufferPool::ReleaseRequest(int request_id) {
+  LeaseMap::iterator it = leases_.find(request_id);
+  if (it == leases_.end())
+    return;
+  it->second.released = true;
+  MaybeReturnBuffer(it);
+}
+
+bool ResourceBufferPool::HasBuffer(int request_id) const {
+  return leases_.find(request_id) != leases_.end();
+}
+
+bool ResourceBufferPool::IsBufferShared(int buffer_id) const {
+  return buffers_[buffer_id]->shared;
+}
+
+bool ResourceBufferPool::ShareBuffer(int buffer_id,
+                                     base::ProcessHandle process,
+                                     base::SharedMemoryHandle* handle) {
+  Buffer* buffer = buffers_[buffer_id];
+  DCHECK(!buffer->shared);
+  // Unlike GiveToProcess(), this keeps our own mapping.
+  if (!buffer->memory.ShareToProcess(process, handle))
+    return false;
+  buffer->shared = true;
+  return true;
+}
+
+int ResourceBufferPool::TakeFreeBuffer() {
+  if (!free_buffers_.empty()) {
+    int id = free_buffers_.back();
+    free_buffers_.pop_back();
+    return id;
+  }
+  if (num_buffers() >= kMaxBuffers)
+    return -1;
+  scoped_ptr<Buffer> buffer(new Buffer);
+  if (!buffer->memory.CreateAndMapAnonymous(kBufferSize)) {
+    DLOG(ERROR) << "Couldn't allocate a pooled resource buffer";
+    return -1;
+  }
+  buffers_.push_back(buffer.release());
+  return num_buffers() - 1;
+}
+
+void ResourceBufferPool::MaybeReturnBuffer(LeaseMap::iterator it) {
+  if (!it->second.released || !it->second.in_flight.empty())
+    return;
+  free_buffers_.push_back(it->second.buffer_id);
+  leases_.erase(it);
+}
+
+}  // namespace content
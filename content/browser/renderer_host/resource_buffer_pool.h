@@ -0,0 +1,126 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_RESOURCE_BUFFER_POOL_H_
+#define CONTENT_BROWSER_RENDERER_HOST_RESOURCE_BUFFER_POOL_H_
+#pragma once
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "base/process.h"
+#include "base/shared_memory.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+// A pool of shared memory buffers that AsyncResourceHandler reads response
+// data into, kept per renderer by its ResourceMessageFilter.
+//
+// Rather than mapping fresh shared memory for every read, each request leases
+// one buffer and uses it as a ring: data is handed to the renderer as an
+// offset into the buffer, and its space is reused once the renderer ACKs it.
+// A buffer is shared with the renderer the first time it is used, and goes
+// back to the pool once its request is done and all of its data was ACKed.
+//
+// Lives on the IO thread.
+class CONTENT_EXPORT ResourceBufferPool {
+ public:
+  // Size of each buffer, which is also the largest read.
+  static const int kBufferSize;
+
+  // Most buffers the pool creates. Requests that find none free fall back to
+  // unpooled shared memory.
+  static const int kMaxBuffers;
+
+  ResourceBufferPool();
+  ~ResourceBufferPool();
+
+  // Returns space for up to |max_size| bytes of |request_id|'s data, leasing
+  // a buffer to the request if it has none. Returns NULL if no buffer can be
+  // leased, or if the request's buffer has no |min_size| contiguous bytes
+  // free. Otherwise |*buffer_id|, |*offset| and |*size| describe the space.
+  // The space is only used once passed to Commit().
+  char* Allocate(int request_id,
+                 int min_size,
+                 int max_size,
+                 int* buffer_id,
+                 int* offset,
+                 int* size);
+
+  // Records that |size| bytes at |offset| in the request's buffer were sent
+  // to the renderer. An |offset| of -1 records data sent outside the pool,
+  // so that ACKs can be matched with the data they are for.
+  void Commit(int request_id, int offset, int size);
+
+  // Adds |size| bytes at |offset| to the data last committed for
+  // |request_id|, so that one ACK covers both. Returns false, and does
+  // nothing, unless the space directly follows that data.
+  bool ExtendLastCommit(int request_id, int offset, int size);
+
+  // Called when the renderer ACKs the oldest data sent for |request_id|.
+  void OnDataReceivedACK(int request_id);
+
+  // Called when |request_id| is done. Its buffer returns to the pool once
+  // all of the data in it has been ACKed.
+  void ReleaseRequest(int request_id);
+
+  // Returns true if |request_id| has leased a buffer.
+  bool HasBuffer(int request_id) const;
+
+  // Returns true if |buffer_id| was shared with the renderer already.
+  bool IsBufferShared(int buffer_id) const;
+
+  // Shares |buffer_id| with |process|. Returns false on failure.
+  bool ShareBuffer(int buffer_id,
+                   base::ProcessHandle process,
+                   base::SharedMemoryHandle* handle);
+
+  int num_buffers() const { return static_cast<int>(buffers_.size()); }
+  int num_free_buffers() const {
+    return static_cast<int>(free_buffers_.size());
+  }
+
+ private:
+  struct Buffer {
+    Buffer();
+    ~Buffer();
+
+    base::SharedMemory memory;
+    bool shared;
+  };
+
+  // Data sent to the renderer and not ACKed yet, oldest first.
+  struct Lease {
+    Lease();
+    ~Lease();
+
+    int buffer_id;
+    // Pairs of offset and size. The offset is -1 for unpooled data.
+    std::deque<std::pair<int, int> > in_flight;
+    bool released;
+  };
+
+  typedef std::map<int, Lease> LeaseMap;
+
+  // Returns the id of a free buffer, creating one if needed, or -1.
+  int TakeFreeBuffer();
+
+  // Returns the buffer of |it| to the pool if it was released and all of its
+  // data was ACKed.
+  void MaybeReturnBuffer(LeaseMap::iterator it);
+
+  ScopedVector<Buffer> buffers_;
+  std::vector<int> free_buffers_;
+  LeaseMap leases_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceBufferPool);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_RESOURCE_BUFFER_POOL_H_
@@ -0,0 +1,134 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_buffer_pool.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const int kReadSize = 32 * 1024;
+
+// Allocates and commits a full |kReadSize| read for |request_id|, and returns
+// its offset, or -1 if there was no room.
+int ReadInto(ResourceBufferPool* pool, int request_id) {
+  int buffer_id, offset, size;
+  if (!pool->Allocate(request_id, kReadSize, kReadSize, &buffer_id, &offset,
+                      &size)) {
+    return -1;
+  }
+  EXPECT_EQ(kReadSize, size);
+  pool->Commit(request_id, offset, size);
+  return offset;
+}
+
+}  // namespace
+
+TEST(ResourceBufferPoolTest, ReadsFollowEachOther) {
+  ResourceBufferPool pool;
+  int buffer_id, offset, size;
+  char* data = pool.Allocate(1, kReadSize, kReadSize, &buffer_id, &offset,
+                             &size);
+  ASSERT_TRUE(data);
+  EXPECT_TRUE(pool.HasBuffer(1));
+  EXPECT_EQ(0, offset);
+  EXPECT_EQ(kReadSize, size);
+  pool.Commit(1, offset, size);
+
+  char* next = pool.Allocate(1, kReadSize, kReadSize, &buffer_id, &offset,
+                             &size);
+  EXPECT_EQ(data + kReadSize, next);
+  EXPECT_EQ(kReadSize, offset);
+  EXPECT_EQ(1, pool.num_buffers());
+}
+
+TEST(ResourceBufferPoolTest, WrapsAroundOnceACKed) {
+  ResourceBufferPool pool;
+  const int kReads = ResourceBufferPool::kBufferSize / kReadSize;
+  for (int i = 0; i < kReads; ++i)
+    EXPECT_EQ(i * kReadSize, ReadInto(&pool, 1));
+
+  // The buffer is full until the renderer ACKs the oldest data.
+  EXPECT_EQ(-1, ReadInto(&pool, 1));
+  pool.OnDataReceivedACK(1);
+  EXPECT_EQ(0, ReadInto(&pool, 1));
+  EXPECT_EQ(-1, ReadInto(&pool, 1));
+
+  pool.OnDataReceivedACK(1);
+  pool.OnDataReceivedACK(1);
+  EXPECT_EQ(kReadSize, ReadInto(&pool, 1));
+}
+
+TEST(ResourceBufferPoolTest, UnpooledDataKeepsACKsMatched) {
+  ResourceBufferPool pool;
+  EXPECT_EQ(0, ReadInto(&pool, 1));
+  pool.Commit(1, -1, 100);
+  EXPECT_EQ(kReadSize, ReadInto(&pool, 1));
+
+  // The first ACK frees the start of the buffer; the second is for the
+  // unpooled data and frees nothing.
+  pool.OnDataReceivedACK(1);
+  pool.OnDataReceivedACK(1);
+  pool.ReleaseRequest(1);
+  EXPECT_TRUE(pool.HasBuffer(1));
+  EXPECT_EQ(0, pool.num_free_buffers());
+
+  pool.OnDataReceivedACK(1);
+  EXPECT_FALSE(pool.HasBuffer(1));
+  EXPECT_EQ(1, pool.num_free_buffers());
+}
+
+TEST(ResourceBufferPoolTest, ExtendLastCommit) {
+  ResourceBufferPool pool;
+  EXPECT_EQ(0, ReadInto(&pool, 1));
+  EXPECT_FALSE(pool.ExtendLastCommit(1, 2 * kReadSize, 100));
+  EXPECT_TRUE(pool.ExtendLastCommit(1, kReadSize, 100));
+  EXPECT_EQ(kReadSize + 100, ReadInto(&pool, 1));
+
+  // Unpooled data can't be extended.
+  pool.Commit(1, -1, 100);
+  EXPECT_FALSE(pool.ExtendLastCommit(1, 2 * kReadSize + 100, 100));
+
+  // One ACK covers the extended data.
+  pool.ReleaseRequest(1);
+  pool.OnDataReceivedACK(1);
+  pool.OnDataReceivedACK(1);
+  EXPECT_TRUE(pool.HasBuffer(1));
+  pool.OnDataReceivedACK(1);
+  EXPECT_FALSE(pool.HasBuffer(1));
+}
+
+TEST(ResourceBufferPoolTest, ReleasedBufferIsReused) {
+  ResourceBufferPool pool;
+  int buffer_id, offset, size;
+  ASSERT_TRUE(pool.Allocate(1, kReadSize, kReadSize, &buffer_id, &offset,
+                            &size));
+  int first_buffer_id = buffer_id;
+  pool.ReleaseRequest(1);
+  EXPECT_EQ(1, pool.num_free_buffers());
+
+  ASSERT_TRUE(pool.Allocate(2, kReadSize, kReadSize, &buffer_id, &offset,
+                            &size));
+  EXPECT_EQ(first_buffer_id, buffer_id);
+  EXPECT_EQ(0, offset);
+  EXPECT_EQ(1, pool.num_buffers());
+}
+
+TEST(ResourceBufferPoolTest, LimitsNumberOfBuffers) {
+  ResourceBufferPool pool;
+  for (int i = 0; i < ResourceBufferPool::kMaxBuffers; ++i)
+    EXPECT_EQ(0, ReadInto(&pool, i));
+  EXPECT_EQ(-1, ReadInto(&pool, ResourceBufferPool::kMaxBuffers));
+  EXPECT_FALSE(pool.HasBuffer(ResourceBufferPool::kMaxBuffers));
+
+  // Once a request is done and ACKed, its buffer may be leased again.
+  pool.ReleaseRequest(0);
+  pool.OnDataReceivedACK(0);
+  EXPECT_EQ(0, ReadInto(&pool, ResourceBufferPool::kMaxBuffers));
+  EXPECT_EQ(ResourceBufferPool::kMaxBuffers, pool.num_buffers());
+}
+
+}  // namespace content
@@ -38,9 +38,11 @@
 #include "content/browser/renderer_host/doomed_resource_handler.h"
 #include "content/browser/renderer_host/redirect_to_file_resource_handler.h"
 #include "content/browser/renderer_host/render_view_host_impl.h"
+#include "content/browser/renderer_host/resource_buffer_pool.h"
 #include "content/browser/renderer_host/resource_message_filter.h"
 #include "content/public/browser/resource_request_details.h"
 #include "content/browser/renderer_host/resource_request_info_impl.h"
+#include "content/browser/renderer_host/resource_scheduler.h"
 #include "content/browser/renderer_host/sync_resource_handler.h"
 #include "content/browser/renderer_host/throttling_resource_handler.h"
 #include "content/browser/resource_context_impl.h"
@@ -328,6 +330,9 @@ ResourceDispatcherHostImpl::ResourceDispatcherHostImpl()
       delegate_(NULL),
       allow_cross_origin_auth_prompt_(false) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  scheduler_.reset(new ResourceScheduler(
+      base::Bind(&ResourceDispatcherHostImpl::StartRequest,
+                 base::Unretained(this))));
   DCHECK(!g_resource_dispatcher_host);
   g_resource_dispatcher_host = this;
 
@@ -962,6 +967,9 @@ void ResourceDispatcherHostImpl::OnReleaseDownloadedFile(int request_id) {
 }
 
 void ResourceDispatcherHostImpl::OnDataReceivedACK(int request_id) {
+  // The renderer is done with the oldest data it was sent for the request,
+  // so that space in the pooled buffer may be read into again.
+  filter_->buffer_pool()->OnDataReceivedACK(request_id);
   DataReceivedACK(filter_->child_id(), request_id);
 }
 
@@ -1229,7 +1237,7 @@ void ResourceDispatcherHostImpl::StartDeferredRequest(int child_id,
   // TODO(eroman): are there other considerations for paused or blocked
   //               requests?
 
-  StartRequest(i->second);
+  ScheduleRequest(i->second);
 }
 
 bool ResourceDispatcherHostImpl::WillSendData(int child_id,
@@ -1371,6 +1379,8 @@ void ResourceDispatcherHostImpl::CancelRequestsForRoute(int child_id,
       CancelBlockedRequestsForRoute(child_id, *iter);
     }
   }
+
+  scheduler_->OnClientDeleted(child_id, route_id);
 }
 
 // Cancels the request and removes it from the list.
@@ -1403,9 +1413,13 @@ void ResourceDispatcherHostImpl::RemovePendingRequest(
   transferred_navigations_.erase(
       GlobalRequestID(info->GetChildID(), info->GetRequestID()));
 
-  delete iter->second;
+  net::URLRequest* request = iter->second;
+  delete request;
   pending_requests_.erase(iter);
 
+  // This may start requests that were held back for this one.
+  scheduler_->RemoveRequest(request);
+
   // If we have no more pending requests, then stop the load state monitor
   if (pending_requests_.empty() && update_load_states_timer_.get())
     update_load_states_timer_->Stop();
@@ -1763,7 +1777,12 @@ void ResourceDispatcherHostImpl::BeginRequestInternal(
   }
 
   if (!defer_start)
-    StartRequest(request);
+    ScheduleRequest(request);
+}
+
+void ResourceDispatcherHostImpl::ScheduleRequest(net::URLRequest* request) {
+  ResourceRequestInfoImpl* info = ResourceRequestInfoImpl::ForRequest(request);
+  scheduler_->ScheduleRequest(info->GetChildID(), info->GetRouteID(), request);
 }
 
 void ResourceDispatcherHostImpl::StartRequest(net::URLRequest* request) {
@@ -2029,6 +2048,13 @@ void ResourceDispatcherHostImpl::ContinueSSLRequest(
   request->ContinueDespiteLastError();
 }
 
+void ResourceDispatcherHostImpl::OnVisibilityChanged(int child_id,
+                                                     int route_id,
+                                                     bool visible) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  scheduler_->OnVisibilityChanged(child_id, route_id, visible);
+}
+
 void ResourceDispatcherHostImpl::OnUserGesture(WebContentsImpl* contents) {
   last_user_gesture_time_ = TimeTicks::Now();
 }
@@ -55,6 +55,7 @@ namespace content {
 class ResourceContext;
 class ResourceDispatcherHostDelegate;
 class ResourceRequestInfoImpl;
+class ResourceScheduler;
 struct DownloadSaveInfo;
 struct GlobalRequestID;
 
@@ -207,6 +208,10 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
 
   void OnUserGesture(WebContentsImpl* contents);
 
+  // Called when the view identified by |child_id| and |route_id| is shown or
+  // hidden, so that the requests of the foreground tab go first.
+  void OnVisibilityChanged(int child_id, int route_id, bool visible);
+
   // Retrieves a net::URLRequest.  Must be called from the IO thread.
   net::URLRequest* GetURLRequest(
       const GlobalRequestID& request_id) const;
@@ -286,6 +291,9 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   // this method with the proper value for the timed_out parameter.
   void HandleSwapOutACK(const ViewMsg_SwapOut_Params& params, bool timed_out);
 
+  // Hands |request| to |scheduler_|, which starts it when it's its turn.
+  void ScheduleRequest(net::URLRequest* request);
+
   void StartRequest(net::URLRequest* request);
 
   // Returns true if the request is paused.
@@ -494,6 +502,10 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   //       kAvgBytesPerOutstandingRequest)
   int max_outstanding_requests_cost_per_process_;
 
+  // Holds back low priority requests of a tab while the ones that block its
+  // rendering are in flight.
+  scoped_ptr<ResourceScheduler> scheduler_;
+
   // Time of the last user gesture. Stored so that we can add a load
   // flag to requests occurring soon after a gesture to indicate they
   // may be because of explicit user action.
@@ -4,6 +4,7 @@
 
 #include "content/browser/renderer_host/resource_message_filter.h"
 
+#include "content/browser/renderer_host/resource_buffer_pool.h"
 #include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/resource_context.h"
@@ -19,7 +20,8 @@ ResourceMessageFilter::ResourceMessageFilter(
     : child_id_(child_id),
       process_type_(process_type),
       resource_context_(resource_context),
-      url_request_context_selector_(url_request_context_selector) {
+      url_request_context_selector_(url_request_context_selector),
+      buffer_pool_(new content::ResourceBufferPool) {
   DCHECK(resource_context);
   DCHECK(url_request_context_selector);
 }
@@ -12,6 +12,7 @@
 #include "webkit/glue/resource_type.h"
 
 namespace content {
+class ResourceBufferPool;
 class ResourceContext;
 }  // namespace content
 
@@ -62,6 +63,9 @@ class CONTENT_EXPORT ResourceMessageFilter
   int child_id() const { return child_id_; }
   content::ProcessType process_type() const { return process_type_; }
 
+  // The buffers that response data for this child is read into.
+  content::ResourceBufferPool* buffer_pool() { return buffer_pool_.get(); }
+
  protected:
   // Protected destructor so that we can be overriden in tests.
   virtual ~ResourceMessageFilter();
@@ -77,6 +81,8 @@ class CONTENT_EXPORT ResourceMessageFilter
 
   const scoped_ptr<URLRequestContextSelector> url_request_context_selector_;
 
+  scoped_ptr<content::ResourceBufferPool> buffer_pool_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(ResourceMessageFilter);
 };
 
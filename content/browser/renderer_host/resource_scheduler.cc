@@ -0,0 +1,201 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_scheduler.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "net/url_request/url_request.h"
+
+namespace content {
+
+const int ResourceScheduler::kMaxLowPriorityRequestsPerHost = 1;
+
+ResourceScheduler::RequestInfo::RequestInfo()
+    : original_priority(net::LOWEST),
+      started(false) {
+}
+
+ResourceScheduler::Client::Client()
+    : visible(true),
+      blocking_requests_in_flight(0) {
+}
+
+ResourceScheduler::Client::~Client() {
+}
+
+ResourceScheduler::ResourceScheduler(const StartCallback& start_callback)
+    : start_callback_(start_callback) {
+}
+
+ResourceScheduler::~ResourceScheduler() {
+}
+
+void ResourceScheduler::ScheduleRequest(int child_id,
+                                        int route_id,
+                                        net::URLRequest* request) {
+  DCHECK(requests_.find(request) == requests_.end());
+  ClientId client_id(child_id, route_id);
+  Client* client = &clients_[client_id];
+
+  RequestInfo* info = &requests_[request];
+  info->client_id = client_id;
+  info->host = request->url().host();
+  info->original_priority = request->priority();
+  info->queued_time = base::TimeTicks::Now();
+  request->set_priority(EffectivePriority(*info, *client));
+
+  if (CanStartRequest(*info, *client)) {
+    StartRequest(request, info, client);
+    return;
+  }
+  client->queued_requests.push_back(request);
+}
+
+void ResourceScheduler::RemoveRequest(net::URLRequest* request) {
+  RequestMap::iterator it = requests_.find(request);
+  if (it == requests_.end())
+    return;
+  RequestInfo info = it->second;
+  requests_.erase(it);
+
+  ClientMap::iterator client_it = clients_.find(info.client_id);
+  DCHECK(client_it != clients_.end());
+  Client* client = &client_it->second;
+  if (!info.started) {
+    std::vector<net::URLRequest*>& queue = client->queued_requests;
+    queue.erase(std::find(queue.begin(), queue.end(), request));
+  } else if (IsBlocking(info.original_priority)) {
+    --client->blocking_requests_in_flight;
+  } else if (--client->low_priority_requests_in_flight[info.host] == 0) {
+    client->low_priority_requests_in_flight.erase(info.host);
+  }
+
+  LoadQueuedRequests(client);
+
+  // Hidden clients are kept, so that they stay hidden.
+  if (client->visible && client->queued_requests.empty() &&
+      client->blocking_requests_in_flight == 0 &&
+      client->low_priority_requests_in_flight.empty()) {
+    clients_.erase(client_it);
+  }
+}
+
+void ResourceScheduler::OnVisibilityChanged(int child_id,
+                                            int route_id,
+                                            bool visible) {
+  Client* client = &clients_[ClientId(child_id, route_id)];
+  if (client->visible == visible)
+    return;
+  client->visible = visible;
+
+  // Only requests that haven't started can still change priority.
+  for (size_t i = 0; i < client->queued_requests.size(); ++i) {
+    net::URLRequest* request = client->queued_requests[i];
+    request->set_priority(EffectivePriority(requests_[request], *client));
+  }
+}
+
+void ResourceScheduler::OnClientDeleted(int child_id, int route_id) {
+  ClientMap::iterator it = clients_.begin();
+  while (it != clients_.end()) {
+    ClientMap::iterator current = it++;
+    if (current->first.first != child_id ||
+        (route_id != -1 && current->first.second != route_id)) {
+      continue;
+    }
+    // Requests that outlive their view, e.g. transferred navigations or
+    // downloads, keep their client until they are removed.
+    const Client& client = current->second;
+    if (client.queued_requests.empty() &&
+        client.blocking_requests_in_flight == 0 &&
+        client.low_priority_requests_in_flight.empty()) {
+      clients_.erase(current);
+    } else {
+      current->second.visible = true;
+    }
+  }
+}
+
+bool ResourceScheduler::IsRequestQueued(net::URLRequest* request) const {
+  RequestMap::const_iterator it = requests_.find(request);
+  return it != requests_.end() && !it->second.started;
+}
+
+// static
+bool ResourceScheduler::IsBlocking(net::RequestPriority priority) {
+  return priority >= net::MEDIUM;
+}
+
+// static
+net::RequestPriority ResourceScheduler::EffectivePriority(
+    const RequestInfo& info,
+    const Client& client) {
+  if (!client.visible || IsBlocking(info.original_priority) ||
+      info.original_priority >= net::LOW) {
+    return info.original_priority;
+  }
+  // Promoted requests stay below the blocking ones.
+  return static_cast<net::RequestPriority>(info.original_priority + 1);
+}
+
+bool ResourceScheduler::CanStartRequest(const RequestInfo& info,
+                                        const Client& client) const {
+  if (IsBlocking(info.original_priority) ||
+      client.blocking_requests_in_flight == 0) {
+    return true;
+  }
+  std::map<std::string, int>::const_iterator it =
+      client.low_priority_requests_in_flight.find(info.host);
+  return it == client.low_priority_requests_in_flight.end() ||
+      it->second < kMaxLowPriorityRequestsPerHost;
+}
+
+void ResourceScheduler::StartRequest(net::URLRequest* request,
+                                     RequestInfo* info,
+                                     Client* client) {
+  info->started = true;
+  if (IsBlocking(info->original_priority))
+    ++client->blocking_requests_in_flight;
+  else
+    ++client->low_priority_requests_in_flight[info->host];
+
+  base::TimeDelta queueing_time = base::TimeTicks::Now() - info->queued_time;
+  if (client->visible) {
+    UMA_HISTOGRAM_TIMES("Net.ResourceScheduler.QueueingTime_Foreground",
+                        queueing_time);
+  } else {
+    UMA_HISTOGRAM_TIMES("Net.ResourceScheduler.QueueingTime_Background",
+                        queueing_time);
+  }
+
+  start_callback_.Run(request);
+}
+
+void ResourceScheduler::LoadQueuedRequests(Client* client) {
+  if (client->queued_requests.empty())
+    return;
+
+  // Copy the queue, as starting a request may change it.
+  std::vector<net::URLRequest*> queue(client->queued_requests);
+  for (int priority = net::NUM_PRIORITIES - 1;
+       priority >= net::MINIMUM_PRIORITY; --priority) {
+    for (size_t i = 0; i < queue.size(); ++i) {
+      net::URLRequest* request = queue[i];
+      RequestMap::iterator it = requests_.find(request);
+      if (it == requests_.end() || it->second.started ||
+          request->priority() != priority ||
+          !CanStartRequest(it->second, *client)) {
+        continue;
+      }
+      std::vector<net::URLRequest*>& queued = client->queued_requests;
+      queued.erase(std::find(queued.begin(), queued.end(), request));
+      StartRequest(request, &it->second, client);
+    }
+  }
+}
+
+}  // namespace content
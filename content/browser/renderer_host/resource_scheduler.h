@@ -0,0 +1,125 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
+#define CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/time.h"
+#include "content/common/content_export.h"
+#include "net/base/request_priority.h"
+
+namespace net {
+class URLRequest;
+}
+
+namespace content {
+
+// Decides when the requests of each tab are started. Requests are grouped by
+// the (child_id, route_id) of the view that issued them, which is called a
+// client here.
+//
+// Requests at MEDIUM priority or above (frames, stylesheets, scripts and
+// fonts) always start right away. While a client has any of those in flight,
+// its lower priority requests, such as images, are held back so that at most
+// |kMaxLowPriorityRequestsPerHost| of them are in flight to each host. The
+// held requests start, most important first, as the blocking ones finish.
+//
+// Low priority requests of visible clients are also promoted one level, so
+// that the foreground tab wins over background tabs for sockets.
+//
+// Lives on the IO thread.
+class CONTENT_EXPORT ResourceScheduler {
+ public:
+  // How many low priority requests a client may have in flight to one host
+  // while its blocking requests are in flight.
+  static const int kMaxLowPriorityRequestsPerHost;
+
+  // Called to actually start a request.
+  typedef base::Callback<void(net::URLRequest*)> StartCallback;
+
+  explicit ResourceScheduler(const StartCallback& start_callback);
+  ~ResourceScheduler();
+
+  // Starts |request| through the start callback, either right away or once
+  // it is no longer held back. The request's priority must already be set.
+  void ScheduleRequest(int child_id, int route_id, net::URLRequest* request);
+
+  // Called when |request| is about to be destroyed, whether or not it was
+  // started. This may start other requests.
+  void RemoveRequest(net::URLRequest* request);
+
+  // Called when the view of a client is shown or hidden. Clients are visible
+  // until told otherwise.
+  void OnVisibilityChanged(int child_id, int route_id, bool visible);
+
+  // Called when a client goes away, after its requests were removed. A
+  // |route_id| of -1 stands for all the clients of |child_id|.
+  void OnClientDeleted(int child_id, int route_id);
+
+  // Returns true if |request| was scheduled and is still held back.
+  bool IsRequestQueued(net::URLRequest* request) const;
+
+ private:
+  typedef std::pair<int, int> ClientId;
+
+  struct RequestInfo {
+    RequestInfo();
+
+    ClientId client_id;
+    std::string host;
+    // The priority the request was scheduled with, before any promotion.
+    net::RequestPriority original_priority;
+    bool started;
+    base::TimeTicks queued_time;
+  };
+
+  struct Client {
+    Client();
+    ~Client();
+
+    bool visible;
+    // Requests at MEDIUM priority or above in flight.
+    int blocking_requests_in_flight;
+    // Number of low priority requests in flight, per host.
+    std::map<std::string, int> low_priority_requests_in_flight;
+    // Requests held back, in the order they were scheduled.
+    std::vector<net::URLRequest*> queued_requests;
+  };
+
+  typedef std::map<net::URLRequest*, RequestInfo> RequestMap;
+  typedef std::map<ClientId, Client> ClientMap;
+
+  static bool IsBlocking(net::RequestPriority priority);
+
+  // Returns the priority |info|'s request should have for |client|.
+  static net::RequestPriority EffectivePriority(const RequestInfo& info,
+                                                const Client& client);
+
+  // Returns true if the request described by |info| may start now.
+  bool CanStartRequest(const RequestInfo& info, const Client& client) const;
+
+  void StartRequest(net::URLRequest* request, RequestInfo* info,
+                    Client* client);
+
+  // Starts the queued requests of |client| that can start, in priority order.
+  void LoadQueuedRequests(Client* client);
+
+  StartCallback start_callback_;
+  RequestMap requests_;
+  ClientMap clients_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceScheduler);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
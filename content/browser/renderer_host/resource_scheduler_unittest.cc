@@ -0,0 +1,159 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_scheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "googleurl/src/gurl.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const int kChildId = 30;
+const int kRouteId = 75;
+const int kBackgroundRouteId = 76;
+
+class ResourceSchedulerTest : public testing::Test {
+ protected:
+  ResourceSchedulerTest()
+      : scheduler_(base::Bind(&ResourceSchedulerTest::OnStart,
+                              base::Unretained(this))) {
+  }
+
+  virtual ~ResourceSchedulerTest() {
+    for (size_t i = 0; i < requests_.size(); ++i)
+      scheduler_.RemoveRequest(requests_[i]);
+  }
+
+  // Schedules a request for |url| at |priority| on |route_id|. The request is
+  // never actually started.
+  net::URLRequest* Schedule(const char* url,
+                            net::RequestPriority priority,
+                            int route_id) {
+    net::URLRequest* request = new net::URLRequest(GURL(url), &delegate_);
+    request->set_priority(priority);
+    requests_.push_back(request);
+    scheduler_.ScheduleRequest(kChildId, route_id, request);
+    return request;
+  }
+
+  net::URLRequest* Schedule(const char* url, net::RequestPriority priority) {
+    return Schedule(url, priority, kRouteId);
+  }
+
+  void OnStart(net::URLRequest* request) {
+    started_.push_back(request);
+  }
+
+  bool WasStarted(net::URLRequest* request) const {
+    return std::find(started_.begin(), started_.end(), request) !=
+        started_.end();
+  }
+
+  TestDelegate delegate_;
+  ResourceScheduler scheduler_;
+  ScopedVector<net::URLRequest> requests_;
+  std::vector<net::URLRequest*> started_;
+};
+
+}  // namespace
+
+TEST_F(ResourceSchedulerTest, OneLowPriorityRequestPerHostWhileBlocked) {
+  net::URLRequest* css = Schedule("http://host/style.css", net::MEDIUM);
+  net::URLRequest* image1 = Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* image2 = Schedule("http://host/2.png", net::LOWEST);
+  net::URLRequest* other_host = Schedule("http://other/3.png", net::LOWEST);
+  EXPECT_TRUE(WasStarted(css));
+  EXPECT_TRUE(WasStarted(image1));
+  EXPECT_FALSE(WasStarted(image2));
+  EXPECT_TRUE(scheduler_.IsRequestQueued(image2));
+  EXPECT_TRUE(WasStarted(other_host));
+
+  scheduler_.RemoveRequest(css);
+  EXPECT_TRUE(WasStarted(image2));
+}
+
+TEST_F(ResourceSchedulerTest, BlockingRequestsAlwaysStart) {
+  Schedule("http://host/index.html", net::HIGHEST);
+  Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* script = Schedule("http://host/a.js", net::MEDIUM);
+  EXPECT_TRUE(WasStarted(script));
+}
+
+TEST_F(ResourceSchedulerTest, UnblockedWhenNoBlockingRequests) {
+  net::URLRequest* image1 = Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* image2 = Schedule("http://host/2.png", net::LOWEST);
+  EXPECT_TRUE(WasStarted(image1));
+  EXPECT_TRUE(WasStarted(image2));
+}
+
+TEST_F(ResourceSchedulerTest, QueuedRequestsStartInPriorityOrder) {
+  net::URLRequest* css = Schedule("http://host/style.css", net::MEDIUM);
+  net::URLRequest* image1 = Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* image2 = Schedule("http://host/2.png", net::LOWEST);
+  net::URLRequest* xhr = Schedule("http://host/data", net::LOW);
+  EXPECT_FALSE(WasStarted(image2));
+  EXPECT_FALSE(WasStarted(xhr));
+
+  // Once |image1| is done, one more request fits, and the XHR goes first.
+  scheduler_.RemoveRequest(image1);
+  EXPECT_TRUE(WasStarted(xhr));
+  EXPECT_FALSE(WasStarted(image2));
+
+  scheduler_.RemoveRequest(css);
+  EXPECT_TRUE(WasStarted(image2));
+}
+
+TEST_F(ResourceSchedulerTest, ClientsAreIndependent) {
+  Schedule("http://host/style.css", net::MEDIUM);
+  Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* other_tab =
+      Schedule("http://host/2.png", net::LOWEST, kBackgroundRouteId);
+  EXPECT_TRUE(WasStarted(other_tab));
+}
+
+TEST_F(ResourceSchedulerTest, RemoveQueuedRequest) {
+  net::URLRequest* css = Schedule("http://host/style.css", net::MEDIUM);
+  Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* image2 = Schedule("http://host/2.png", net::LOWEST);
+  scheduler_.RemoveRequest(image2);
+  EXPECT_FALSE(scheduler_.IsRequestQueued(image2));
+  scheduler_.RemoveRequest(css);
+  EXPECT_FALSE(WasStarted(image2));
+}
+
+TEST_F(ResourceSchedulerTest, ForegroundRequestsArePromoted) {
+  scheduler_.OnVisibilityChanged(kChildId, kBackgroundRouteId, false);
+  net::URLRequest* foreground = Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* background =
+      Schedule("http://host/2.png", net::LOWEST, kBackgroundRouteId);
+  EXPECT_EQ(net::LOW, foreground->priority());
+  EXPECT_EQ(net::LOWEST, background->priority());
+
+  // Blocking requests keep their priority.
+  net::URLRequest* css = Schedule("http://host/style.css", net::MEDIUM);
+  EXPECT_EQ(net::MEDIUM, css->priority());
+}
+
+TEST_F(ResourceSchedulerTest, QueuedRequestsPromotedWhenShown) {
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, false);
+  Schedule("http://host/style.css", net::MEDIUM);
+  Schedule("http://host/1.png", net::LOWEST);
+  net::URLRequest* image2 = Schedule("http://host/2.png", net::LOWEST);
+  ASSERT_TRUE(scheduler_.IsRequestQueued(image2));
+  EXPECT_EQ(net::LOWEST, image2->priority());
+
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, true);
+  EXPECT_EQ(net::LOW, image2->priority());
+}
+
+}  // namespace content
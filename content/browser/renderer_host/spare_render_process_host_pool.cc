@@ -0,0 +1,198 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/spare_render_process_host_pool.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/message_loop.h"
+#include "base/string_number_conversions.h"
+#include "content/browser/renderer_host/render_process_host_impl.h"
+#include "content/common/view_messages.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_types.h"
+#include "content/public/common/content_switches.h"
+#include "content/public/common/url_constants.h"
+#include "googleurl/src/gurl.h"
+
+namespace content {
+
+namespace {
+
+// How long to wait before launching a new spare, so that it doesn't compete
+// with the tab that took the last one.
+const int kRefillDelayMs = 1000;
+
+// Returns true if a process launched without knowing its site may be used
+// for |site_url|.
+bool CanUseSpareHostForSite(const GURL& site_url) {
+  return site_url.is_empty() ||
+         site_url.SchemeIs(chrome::kHttpScheme) ||
+         site_url.SchemeIs(chrome::kHttpsScheme) ||
+         site_url.SchemeIs(chrome::kChromeUIScheme);
+}
+
+bool IsAtProcessLimit() {
+  size_t count = 0;
+  for (RenderProcessHost::iterator it(RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    ++count;
+  }
+  return count >= RenderProcessHost::GetMaxRendererProcessCount();
+}
+
+}  // namespace
+
+// static
+SpareRenderProcessHostPool* SpareRenderProcessHostPool::GetInstance() {
+  return Singleton<SpareRenderProcessHostPool>::get();
+}
+
+SpareRenderProcessHostPool::SpareRenderProcessHostPool()
+    : pool_size_(0),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(switches::kSpareRendererProcesses) &&
+      !RenderProcessHost::run_renderer_in_process()) {
+    int pool_size;
+    if (base::StringToInt(command_line.GetSwitchValueASCII(
+            switches::kSpareRendererProcesses), &pool_size) &&
+        pool_size > 0) {
+      pool_size_ = pool_size;
+    }
+  }
+
+  registrar_.Add(this, NOTIFICATION_RENDERER_PROCESS_TERMINATED,
+                 NotificationService::AllBrowserContextsAndSources());
+  registrar_.Add(this, NOTIFICATION_RENDERER_PROCESS_CLOSED,
+                 NotificationService::AllBrowserContextsAndSources());
+}
+
+SpareRenderProcessHostPool::~SpareRenderProcessHostPool() {
+}
+
+RenderProcessHost* SpareRenderProcessHostPool::TakeSpareHost(
+    BrowserContext* browser_context,
+    const GURL& site_url) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // Off the record contexts are destroyed once their last process is gone,
+  // so they get no spares.
+  if (!pool_size_ || browser_context->IsOffTheRecord() ||
+      !CanUseSpareHostForSite(site_url)) {
+    return NULL;
+  }
+
+  ScheduleRefill(browser_context);
+  for (std::vector<RenderProcessHost*>::iterator it = spare_hosts_.begin();
+       it != spare_hosts_.end(); ++it) {
+    RenderProcessHost* host = *it;
+    if (host->GetBrowserContext() == browser_context) {
+      spare_hosts_.erase(it);
+      taken_host_ids_.insert(host->GetID());
+      return host;
+    }
+  }
+  return NULL;
+}
+
+bool SpareRenderProcessHostPool::IsSpareHost(RenderProcessHost* host) const {
+  return std::find(spare_hosts_.begin(), spare_hosts_.end(), host) !=
+      spare_hosts_.end();
+}
+
+bool SpareRenderProcessHostPool::WasSpareHost(int render_process_id) const {
+  return taken_host_ids_.count(render_process_id) > 0;
+}
+
+void SpareRenderProcessHostPool::DiscardSpareHosts(
+    BrowserContext* browser_context) {
+  pending_refills_.erase(browser_context);
+  std::vector<RenderProcessHost*> discarded;
+  for (std::vector<RenderProcessHost*>::iterator it = spare_hosts_.begin();
+       it != spare_hosts_.end();) {
+    if ((*it)->GetBrowserContext() == browser_context) {
+      discarded.push_back(*it);
+      it = spare_hosts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Spares have no views, so this deletes them.
+  for (size_t i = 0; i < discarded.size(); ++i)
+    discarded[i]->Cleanup();
+}
+
+void SpareRenderProcessHostPool::Observe(int type,
+                                         const NotificationSource& source,
+                                         const NotificationDetails& details) {
+  RenderProcessHost* host = Source<RenderProcessHost>(source).ptr();
+  switch (type) {
+    case NOTIFICATION_RENDERER_PROCESS_CLOSED:
+      // A spare that died is no use, and nothing else would delete it.
+      if (RemoveSpareHost(host))
+        host->Cleanup();
+      break;
+    case NOTIFICATION_RENDERER_PROCESS_TERMINATED:
+      RemoveSpareHost(host);
+      taken_host_ids_.erase(host->GetID());
+      break;
+    default:
+      NOTREACHED();
+  }
+}
+
+void SpareRenderProcessHostPool::ScheduleRefill(
+    BrowserContext* browser_context) {
+  if (!pending_refills_.insert(browser_context).second)
+    return;
+  MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&SpareRenderProcessHostPool::Refill,
+                 weak_factory_.GetWeakPtr(), browser_context),
+      base::TimeDelta::FromMilliseconds(kRefillDelayMs));
+}
+
+void SpareRenderProcessHostPool::Refill(BrowserContext* browser_context) {
+  // The context may have gone away since.
+  if (!pending_refills_.erase(browser_context))
+    return;
+
+  while (CountSpareHosts(browser_context) < pool_size_ &&
+         !IsAtProcessLimit()) {
+    RenderProcessHostImpl* host = new RenderProcessHostImpl(browser_context);
+    if (!host->Init()) {
+      host->Cleanup();
+      return;
+    }
+    // Have the renderer initialize WebKit now rather than when it gets its
+    // first view.
+    host->Send(new ViewMsg_WarmUp());
+    spare_hosts_.push_back(host);
+  }
+}
+
+size_t SpareRenderProcessHostPool::CountSpareHosts(
+    BrowserContext* browser_context) const {
+  size_t count = 0;
+  for (size_t i = 0; i < spare_hosts_.size(); ++i) {
+    if (spare_hosts_[i]->GetBrowserContext() == browser_context)
+      ++count;
+  }
+  return count;
+}
+
+bool SpareRenderProcessHostPool::RemoveSpareHost(RenderProcessHost* host) {
+  std::vector<RenderProcessHost*>::iterator it =
+      std::find(spare_hosts_.begin(), spare_hosts_.end(), host);
+  if (it == spare_hosts_.end())
+    return false;
+  spare_hosts_.erase(it);
+  return true;
+}
+
+}  // namespace content
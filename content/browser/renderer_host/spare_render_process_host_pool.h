@@ -0,0 +1,92 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_SPARE_RENDER_PROCESS_HOST_POOL_H_
+#define CONTENT_BROWSER_RENDERER_HOST_SPARE_RENDER_PROCESS_HOST_POOL_H_
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/singleton.h"
+#include "base/memory/weak_ptr.h"
+#include "content/common/content_export.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+
+class GURL;
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+
+// Keeps renderer processes launched and initialized ahead of time, so that a
+// new tab doesn't wait for a process to start and for WebKit to initialize.
+// Up to --spare-renderer-processes spares are kept per browser context; none
+// by default. The pool is refilled in the background once a spare is taken.
+//
+// Spares are only handed out for web and WebUI pages, since other processes,
+// such as extension processes, are set up differently when launched.
+//
+// Lives on the UI thread.
+class CONTENT_EXPORT SpareRenderProcessHostPool : public NotificationObserver {
+ public:
+  static SpareRenderProcessHostPool* GetInstance();
+
+  // Returns a spare process of |browser_context| for a SiteInstance of
+  // |site_url|, or NULL if there is none, and schedules the pool to be
+  // refilled. |site_url| is empty if the site isn't known yet.
+  RenderProcessHost* TakeSpareHost(BrowserContext* browser_context,
+                                   const GURL& site_url);
+
+  // Returns true if |host| is a spare that wasn't taken yet. Spares must not
+  // be picked for process sharing.
+  bool IsSpareHost(RenderProcessHost* host) const;
+
+  // Returns true if the process with |render_process_id| was a spare.
+  bool WasSpareHost(int render_process_id) const;
+
+  // Shuts down the spares of |browser_context|, which is going away.
+  void DiscardSpareHosts(BrowserContext* browser_context);
+
+  // NotificationObserver implementation:
+  virtual void Observe(int type,
+                       const NotificationSource& source,
+                       const NotificationDetails& details) OVERRIDE;
+
+ private:
+  friend struct DefaultSingletonTraits<SpareRenderProcessHostPool>;
+
+  SpareRenderProcessHostPool();
+  virtual ~SpareRenderProcessHostPool();
+
+  void ScheduleRefill(BrowserContext* browser_context);
+  void Refill(BrowserContext* browser_context);
+
+  size_t CountSpareHosts(BrowserContext* browser_context) const;
+
+  // Removes |host| from |spare_hosts_|. Returns false if it wasn't there.
+  bool RemoveSpareHost(RenderProcessHost* host);
+
+  // Spares kept per browser context.
+  size_t pool_size_;
+
+  std::vector<RenderProcessHost*> spare_hosts_;
+
+  // Ids of the live processes that were taken from the pool.
+  std::set<int> taken_host_ids_;
+
+  // Browser contexts with a refill scheduled.
+  std::set<BrowserContext*> pending_refills_;
+
+  NotificationRegistrar registrar_;
+  base::WeakPtrFactory<SpareRenderProcessHostPool> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRenderProcessHostPool);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_SPARE_RENDER_PROCESS_HOST_POOL_H_
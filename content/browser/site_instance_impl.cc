@@ -8,6 +8,7 @@
 #include "content/browser/browsing_instance.h"
 #include "content/browser/child_process_security_policy_impl.h"
 #include "content/browser/renderer_host/render_process_host_impl.h"
+#include "content/browser/renderer_host/spare_render_process_host_pool.h"
 #include "content/public/browser/content_browser_client.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_types.h"
@@ -82,14 +83,19 @@ content::RenderProcessHost* SiteInstanceImpl::GetProcess() {
       process_ = content::RenderProcessHost::GetExistingProcessHost(
           browsing_instance_->browser_context(), site_);
 
-    // Otherwise (or if that fails), create a new one.
+    // Otherwise (or if that fails), use a spare or create a new one.
     if (!process_) {
       if (render_process_host_factory_) {
         process_ = render_process_host_factory_->CreateRenderProcessHost(
             browsing_instance_->browser_context());
       } else {
-        process_ =
-            new RenderProcessHostImpl(browsing_instance_->browser_context());
+        process_ = content::SpareRenderProcessHostPool::GetInstance()->
+            TakeSpareHost(browsing_instance_->browser_context(),
+                          has_site_ ? site_ : GURL());
+        if (!process_) {
+          process_ =
+              new RenderProcessHostImpl(browsing_instance_->browser_context());
+        }
       }
     }
 
@@ -90,7 +90,11 @@ void AboutTcmalloc(std::string* data) {
   char buffer[1024 * 32];
   base::allocator::GetStats(buffer, sizeof(buffer));
   std::string browser("Browser");
-  AboutTcmallocOutputs::GetInstance()->SetOutput(browser, buffer);
+  std::string browser_output(buffer);
+  std::string profile;
+  if (base::allocator::GetHeapProfile(&profile))
+    browser_output.append("\n").append(profile);
+  AboutTcmallocOutputs::GetInstance()->SetOutput(browser, browser_output);
 
   for (BrowserChildProcessHostIterator iter; !iter.Done(); ++iter) {
     iter.Send(new ChildProcessMsg_GetTcmallocStats);
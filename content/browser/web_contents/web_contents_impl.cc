@@ -474,8 +474,16 @@ WebPreferences WebContentsImpl::GetWebkitPrefs(RenderViewHost* rvh,
 
   prefs.visual_word_movement_enabled =
       command_line.HasSwitch(switches::kEnableVisualWordMovement);
+  // With per-tile painting, the compositor paints and uploads only the
+  // invalidated tiles of a layer, closest to the viewport first, instead of
+  // the whole invalidated region of the layer. It requires Skia.
+#if defined(USE_SKIA)
+  prefs.per_tile_painting_enabled =
+      !command_line.HasSwitch(switches::kDisablePerTilePainting);
+#else
   prefs.per_tile_painting_enabled =
       command_line.HasSwitch(switches::kEnablePerTilePainting);
+#endif
 
   {  // Certain GPU features might have been blacklisted.
     GpuDataManagerImpl* gpu_data_manager = GpuDataManagerImpl::GetInstance();
@@ -41,6 +41,7 @@
 #include "content/public/common/content_switches.h"
 #include "content/public/common/main_function_params.h"
 #include "content/public/common/result_codes.h"
+#include "content/public/common/sandbox_init.h"
 #include "content/public/common/zygote_fork_delegate_linux.h"
 #include "skia/ext/SkFontHost_fontconfig_control.h"
 #include "unicode/timezone.h"
@@ -485,6 +486,12 @@ class Zygote {
       // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
       // (we don't have the original argv at this point).
       SetProcessTitleFromCommandLine(NULL);
+
+      // Seccomp filters only apply to the thread that installs them and the
+      // threads it creates, so the renderer's filter goes on now, while the
+      // child is single threaded.
+      if (process_type == switches::kRendererProcess)
+        content::InitializeSandbox();
     } else if (child_pid < 0) {
       LOG(ERROR) << "Zygote could not fork: process_type " << process_type
           << " numfds " << numfds << " child_pid " << child_pid;
@@ -33,6 +33,8 @@ IPC_STRUCT_TRAITS_BEGIN(tracked_objects::DeathDataSnapshot)
   IPC_STRUCT_TRAITS_MEMBER(queue_duration_sum)
   IPC_STRUCT_TRAITS_MEMBER(queue_duration_max)
   IPC_STRUCT_TRAITS_MEMBER(queue_duration_sample)
+  IPC_STRUCT_TRAITS_MEMBER(run_duration_histogram)
+  IPC_STRUCT_TRAITS_MEMBER(queue_duration_histogram)
 IPC_STRUCT_TRAITS_END()
 
 IPC_STRUCT_TRAITS_BEGIN(tracked_objects::TaskSnapshot)
@@ -50,6 +52,7 @@ IPC_STRUCT_TRAITS_BEGIN(tracked_objects::ProcessDataSnapshot)
   IPC_STRUCT_TRAITS_MEMBER(tasks)
   IPC_STRUCT_TRAITS_MEMBER(descendants)
   IPC_STRUCT_TRAITS_MEMBER(process_id)
+  IPC_STRUCT_TRAITS_MEMBER(sampling_interval)
 IPC_STRUCT_TRAITS_END()
 
 #undef IPC_MESSAGE_EXPORT
@@ -84,6 +87,10 @@ IPC_MESSAGE_CONTROL0(ChildProcessMsg_GetTraceBufferPercentFull)
 IPC_MESSAGE_CONTROL1(ChildProcessMsg_SetProfilerStatus,
                      tracked_objects::ThreadData::Status /* profiler status */)
 
+// Tell the child process to only profile about one in |interval| tasks.
+IPC_MESSAGE_CONTROL1(ChildProcessMsg_SetProfilerSamplingInterval,
+                     int /* interval */)
+
 // Send to all the child processes to send back profiler data (ThreadData in
 // tracked_objects).
 IPC_MESSAGE_CONTROL1(ChildProcessMsg_GetChildProfilerData,
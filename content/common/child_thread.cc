@@ -189,6 +189,8 @@ bool ChildThread::OnMessageReceived(const IPC::Message& msg) {
 #endif
     IPC_MESSAGE_HANDLER(ChildProcessMsg_SetProfilerStatus,
                         OnSetProfilerStatus)
+    IPC_MESSAGE_HANDLER(ChildProcessMsg_SetProfilerSamplingInterval,
+                        OnSetProfilerSamplingInterval)
     IPC_MESSAGE_HANDLER(ChildProcessMsg_GetChildProfilerData,
                         OnGetChildProfilerData)
     IPC_MESSAGE_HANDLER(ChildProcessMsg_DumpHandles, OnDumpHandles)
@@ -228,6 +230,10 @@ void ChildThread::OnSetProfilerStatus(ThreadData::Status status) {
   ThreadData::InitializeAndSetTrackingStatus(status);
 }
 
+void ChildThread::OnSetProfilerSamplingInterval(int interval) {
+  ThreadData::SetSamplingInterval(interval);
+}
+
 void ChildThread::OnGetChildProfilerData(int sequence_number) {
   tracked_objects::ProcessDataSnapshot process_data;
   ThreadData::Snapshot(false, &process_data);
@@ -256,6 +262,11 @@ void ChildThread::OnGetTcmallocStats() {
   char buffer[1024 * 32];
   base::allocator::GetStats(buffer, sizeof(buffer));
   result.append(buffer);
+  // While the heap profiler runs, also report where the live bytes were
+  // allocated from.
+  std::string profile;
+  if (base::allocator::GetHeapProfile(&profile))
+    result.append("\n").append(profile);
   Send(new ChildProcessHostMsg_TcmallocStats(result));
 }
 #endif
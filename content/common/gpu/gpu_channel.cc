@@ -294,9 +294,11 @@ void GpuChannel::HandleMessage() {
         Send(reply);
       }
     } else {
-      // If the command buffer becomes unscheduled as a result of handling the
-      // message but still has more commands to process, synthesize an IPC
-      // message to flush that command buffer.
+      // If the command buffer becomes unscheduled or is preempted as a result
+      // of handling the message but still has more commands to process,
+      // synthesize an IPC message to flush that command buffer. It stays at
+      // the head of the queue, but is handled in a new task so that other
+      // channels get to run first.
       if (stub) {
         if (stub->HasUnprocessedCommands()) {
           deferred_messages_.push_front(new GpuCommandBufferMsg_Rescheduled(
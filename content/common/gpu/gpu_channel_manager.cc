@@ -5,10 +5,13 @@
 #include "content/common/gpu/gpu_channel_manager.h"
 
 #include "base/bind.h"
+#include "base/command_line.h"
 #include "content/common/child_thread.h"
 #include "content/common/gpu/gpu_channel.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/gpu_memory_manager.h"
+#include "gpu/command_buffer/service/gpu_switches.h"
+#include "gpu/command_buffer/service/program_cache.h"
 #include "ui/gfx/gl/gl_share_group.h"
 
 GpuChannelManager::GpuChannelManager(ChildThread* gpu_child_thread,
@@ -25,6 +28,11 @@ GpuChannelManager::GpuChannelManager(ChildThread* gpu_child_thread,
   DCHECK(gpu_child_thread);
   DCHECK(io_message_loop);
   DCHECK(shutdown_event);
+  if (!CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableGpuProgramCache)) {
+    program_cache_.reset(new gpu::gles2::ProgramCache(
+        gpu::gles2::ProgramCache::kDefaultMaxSizeBytes));
+  }
 }
 
 GpuChannelManager::~GpuChannelManager() {
@@ -8,6 +8,7 @@
 #include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/shared_memory.h"
 #include "base/time.h"
 #include "build/build_config.h"
@@ -20,6 +21,7 @@
 #include "content/common/gpu/image_transport_surface.h"
 #include "gpu/command_buffer/common/constants.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
+#include "gpu/command_buffer/service/texture_manager.h"
 #include "ui/gfx/gl/gl_bindings.h"
 #include "ui/gfx/gl/gl_switches.h"
 
@@ -27,6 +29,15 @@
 #include "content/public/common/sandbox_init.h"
 #endif
 
+namespace {
+
+// How long a context that doesn't draw to a visible surface may process
+// commands before it yields to other work, such as the contexts of other
+// channels.
+const int64 kTimeSliceMs = 8;
+
+}  // namespace
+
 GpuCommandBufferStub::SurfaceState::SurfaceState(int32 surface_id,
                                                  bool visible,
                                                  base::TimeTicks last_used_time)
@@ -70,6 +81,8 @@ GpuCommandBufferStub::GpuCommandBufferStub(
     context_group_ = share_group->context_group_;
   } else {
     context_group_ = new gpu::gles2::ContextGroup(mailbox_manager, true);
+    context_group_->set_program_cache(
+        channel->gpu_channel_manager()->program_cache());
   }
   if (surface_id != 0)
     surface_state_.reset(new GpuCommandBufferStubBase::SurfaceState(
@@ -332,6 +345,9 @@ void GpuCommandBufferStub::OnInitialize(
   scheduler_->SetScheduledCallback(
       base::Bind(&GpuCommandBufferStub::OnReschedule, base::Unretained(this)));
 
+  scheduler_->SetPreemptionCallback(
+      base::Bind(&GpuCommandBufferStub::ShouldPreempt, base::Unretained(this)));
+
   if (watchdog_) {
     scheduler_->SetCommandProcessedCallback(
         base::Bind(&GpuCommandBufferStub::OnCommandProcessed,
@@ -442,7 +458,7 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
   DCHECK(command_buffer_.get());
   if (flush_count - last_flush_count_ < 0x8000000U) {
     last_flush_count_ = flush_count;
-    command_buffer_->Flush(put_offset);
+    Flush(put_offset);
   } else {
     // We received this message out-of-order. This should not happen but is here
     // to catch regressions. Ignore the message.
@@ -454,7 +470,7 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
 
 void GpuCommandBufferStub::OnRescheduled() {
   gpu::CommandBuffer::State pre_state = command_buffer_->GetLastState();
-  command_buffer_->Flush(pre_state.put_offset);
+  Flush(pre_state.put_offset);
   gpu::CommandBuffer::State post_state = command_buffer_->GetLastState();
 
   if (pre_state.get_offset != post_state.get_offset)
@@ -536,6 +552,31 @@ void GpuCommandBufferStub::OnGetTransferBuffer(
   Send(reply_message);
 }
 
+void GpuCommandBufferStub::Flush(int32 put_offset) {
+  flush_start_time_ = base::TimeTicks::Now();
+  command_buffer_->Flush(put_offset);
+  base::TimeDelta delta = base::TimeTicks::Now() - flush_start_time_;
+  flush_start_time_ = base::TimeTicks();
+
+  if (surface_state_.get() && surface_state_->visible)
+    UMA_HISTOGRAM_TIMES("GPU.FlushTime_VisibleSurface", delta);
+  else
+    UMA_HISTOGRAM_TIMES("GPU.FlushTime_Other", delta);
+}
+
+bool GpuCommandBufferStub::ShouldPreempt() {
+  // Contexts drawing to a visible surface, such as compositors, are never
+  // preempted, so that they get the GPU as soon as their channel comes up.
+  // Other contexts yield once their time slice is used up. GpuChannel then
+  // finishes the flush in a later task, after the tasks of other channels.
+  if (flush_start_time_.is_null() ||
+      (surface_state_.get() && surface_state_->visible)) {
+    return false;
+  }
+  return base::TimeTicks::Now() - flush_start_time_ >
+      base::TimeDelta::FromMilliseconds(kTimeSliceMs);
+}
+
 void GpuCommandBufferStub::OnCommandProcessed() {
   if (watchdog_)
     watchdog_->CheckArmed();
@@ -629,6 +670,13 @@ bool GpuCommandBufferStub::IsInSameContextShareGroup(
       static_cast<const GpuCommandBufferStub&>(other).context_group_;
 }
 
+size_t GpuCommandBufferStub::GetMemoryUsage() const {
+  // The texture manager is only created once the group is initialized.
+  gpu::gles2::TextureManager* texture_manager =
+      context_group_->texture_manager();
+  return texture_manager ? texture_manager->mem_represented() : 0;
+}
+
 bool GpuCommandBufferStub::
     client_has_memory_allocation_changed_callback() const {
   return client_has_memory_allocation_changed_callback_;
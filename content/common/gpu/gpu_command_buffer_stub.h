@@ -70,6 +70,9 @@ class CONTENT_EXPORT GpuCommandBufferStubBase {
   virtual bool IsInSameContextShareGroup(
       const GpuCommandBufferStubBase& other) const = 0;
 
+  // Estimated bytes of texture memory used by the context share group.
+  virtual size_t GetMemoryUsage() const = 0;
+
   virtual void SendMemoryAllocationToProxy(
       const GpuMemoryAllocation& allocation) = 0;
 
@@ -124,6 +127,8 @@ class GpuCommandBufferStub
   virtual bool IsInSameContextShareGroup(
       const GpuCommandBufferStubBase& other) const OVERRIDE;
 
+  virtual size_t GetMemoryUsage() const OVERRIDE;
+
   // Sends memory allocation limits to render process.
   virtual void SendMemoryAllocationToProxy(
       const GpuMemoryAllocation& allocation) OVERRIDE;
@@ -214,6 +219,13 @@ class GpuCommandBufferStub
   void OnCommandProcessed();
   void OnParseError();
 
+  // Processes commands up to |put_offset|, unless preempted.
+  void Flush(int32 put_offset);
+
+  // Returns true if this context has run for its time slice and should let
+  // other work run.
+  bool ShouldPreempt();
+
   void ReportState();
 
   // The lifetime of objects of this class is managed by a GpuChannel. The
@@ -234,6 +246,8 @@ class GpuCommandBufferStub
   bool software_;
   bool client_has_memory_allocation_changed_callback_;
   uint32 last_flush_count_;
+  // When the current Flush() started.
+  base::TimeTicks flush_start_time_;
   scoped_ptr<GpuCommandBufferStubBase::SurfaceState> surface_state_;
   GpuMemoryAllocation allocation_;
 
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/message_loop.h"
 #include "content/common/gpu/gpu_command_buffer_stub.h"
 #include "content/common/gpu/gpu_memory_allocation.h"
@@ -34,6 +35,59 @@ void AssignMemoryAllocations(std::vector<GpuCommandBufferStubBase*>& stubs,
   }
 }
 
+// Returns the bytes |stubs[index]| uses beyond |base_allocation|. Usage is
+// reported for a whole share group, so it is only counted for the first stub
+// of each group.
+size_t GetExcessMemoryUsage(const std::vector<GpuCommandBufferStubBase*>& stubs,
+                            size_t index,
+                            size_t base_allocation) {
+  std::vector<GpuCommandBufferStubBase*> preceding_stubs(
+      stubs.begin(), stubs.begin() + index);
+  if (IsInSameContextShareGroupAsAnyOf(stubs[index], preceding_stubs))
+    return 0;
+  size_t usage = stubs[index]->GetMemoryUsage();
+  return usage > base_allocation ? usage - base_allocation : 0;
+}
+
+// Splits |bonus_pool| bytes among |stubs|, on top of |base_allocation| each.
+// Stubs whose textures already need more than |base_allocation| are covered
+// first, in proportion to their needs if the pool can't cover them all. What
+// is left is split evenly.
+void ComputeBonusAllocations(
+    const std::vector<GpuCommandBufferStubBase*>& stubs,
+    size_t base_allocation,
+    size_t bonus_pool,
+    std::vector<size_t>* bonuses) {
+  bonuses->assign(stubs.size(), 0);
+  if (stubs.empty())
+    return;
+
+  std::vector<size_t> excess_usage(stubs.size());
+  uint64 total_excess_usage = 0;
+  for (size_t i = 0; i < stubs.size(); ++i) {
+    excess_usage[i] = GetExcessMemoryUsage(stubs, i, base_allocation);
+    total_excess_usage += excess_usage[i];
+  }
+
+  size_t remaining_pool = bonus_pool;
+  if (total_excess_usage > 0) {
+    for (size_t i = 0; i < stubs.size(); ++i) {
+      size_t bonus = excess_usage[i];
+      if (total_excess_usage > bonus_pool) {
+        bonus = static_cast<size_t>(
+            excess_usage[i] * static_cast<uint64>(bonus_pool) /
+            total_excess_usage);
+      }
+      (*bonuses)[i] = bonus;
+      remaining_pool -= bonus;
+    }
+  }
+
+  size_t even_share = remaining_pool / stubs.size();
+  for (size_t i = 0; i < stubs.size(); ++i)
+    (*bonuses)[i] += even_share;
+}
+
 }
 
 GpuMemoryManager::GpuMemoryManager(GpuMemoryManagerClient* client,
@@ -98,6 +152,14 @@ void GpuMemoryManager::ScheduleManage() {
 // As such, the rule for categorizing contexts without a surface is:
 //  1. Find the most visible context-with-a-surface within each
 //     context-without-a-surface's share group, and inherit its visibilty.
+//
+// Memory is then budgeted in bytes:
+//  1. Each foreground context, and each background context without a surface,
+//     gets kMinimumAllocationForTab. Background contexts without a surface
+//     are hibernated instead if these exceed kMaximumAllocationForTabs.
+//  2. The rest of kMaximumAllocationForTabs goes to the foreground surfaces,
+//     covering the texture memory their share groups report beyond the
+//     minimum first, and then split evenly.
 void GpuMemoryManager::Manage() {
   manage_scheduled_ = false;
 
@@ -162,23 +224,42 @@ void GpuMemoryManager::Manage() {
       stubs_without_surface_hibernated.push_back(stub);
   }
 
-  // Calculate memory allocation size in bytes given to each stub, by sharing
-  // global limit equally among those that need it.
+  // Every stub that needs memory gets kMinimumAllocationForTab. If that
+  // exceeds the global limit, contexts without a surface that only serve non
+  // visible surfaces are evicted, since nothing on screen depends on them.
   size_t num_stubs_need_mem = stubs_with_surface_foreground.size() +
                               stubs_without_surface_foreground.size() +
                               stubs_without_surface_background.size();
+  while (kMinimumAllocationForTab * num_stubs_need_mem >
+             kMaximumAllocationForTabs &&
+         !stubs_without_surface_background.empty()) {
+    stubs_without_surface_hibernated.push_back(
+        stubs_without_surface_background.back());
+    stubs_without_surface_background.pop_back();
+    --num_stubs_need_mem;
+  }
+
+  // What is left of the global limit goes to the visible surfaces, according
+  // to the texture memory they report.
   size_t base_allocation_size = kMinimumAllocationForTab * num_stubs_need_mem;
-  size_t bonus_allocation = 0;
-  if (base_allocation_size < kMaximumAllocationForTabs &&
-      !stubs_with_surface_foreground.empty())
-    bonus_allocation = (kMaximumAllocationForTabs - base_allocation_size) /
-                           stubs_with_surface_foreground.size();
+  size_t bonus_pool = 0;
+  if (base_allocation_size < kMaximumAllocationForTabs)
+    bonus_pool = kMaximumAllocationForTabs - base_allocation_size;
+  std::vector<size_t> bonus_allocations;
+  ComputeBonusAllocations(stubs_with_surface_foreground,
+                          kMinimumAllocationForTab,
+                          bonus_pool,
+                          &bonus_allocations);
 
   // Now give out allocations to everyone.
-  AssignMemoryAllocations(stubs_with_surface_foreground,
-      GpuMemoryAllocation(kMinimumAllocationForTab + bonus_allocation,
-          GpuMemoryAllocation::kHasFrontbuffer |
-          GpuMemoryAllocation::kHasBackbuffer));
+  size_t total_allocation_size = base_allocation_size;
+  for (size_t i = 0; i < stubs_with_surface_foreground.size(); ++i) {
+    stubs_with_surface_foreground[i]->SetMemoryAllocation(
+        GpuMemoryAllocation(kMinimumAllocationForTab + bonus_allocations[i],
+            GpuMemoryAllocation::kHasFrontbuffer |
+            GpuMemoryAllocation::kHasBackbuffer));
+    total_allocation_size += bonus_allocations[i];
+  }
 
   AssignMemoryAllocations(stubs_with_surface_background,
       GpuMemoryAllocation(0, GpuMemoryAllocation::kHasFrontbuffer));
@@ -196,6 +277,8 @@ void GpuMemoryManager::Manage() {
 
   AssignMemoryAllocations(stubs_without_surface_hibernated,
       GpuMemoryAllocation(0, GpuMemoryAllocation::kHasNoBuffers));
+
+  TRACE_COUNTER1("gpu", "GpuMemoryAllocation", total_allocation_size);
 }
 
 #endif
@@ -12,15 +12,18 @@ class FakeCommandBufferStub : public GpuCommandBufferStubBase {
  public:
   SurfaceState surface_state_;
   GpuMemoryAllocation allocation_;
+  size_t memory_usage_;
 
   FakeCommandBufferStub()
-      : surface_state_(0, false, base::TimeTicks()) {
+      : surface_state_(0, false, base::TimeTicks()),
+        memory_usage_(0) {
   }
 
   FakeCommandBufferStub(int32 surface_id,
                         bool visible,
                         base::TimeTicks last_used_time)
-      : surface_state_(surface_id, visible, last_used_time) {
+      : surface_state_(surface_id, visible, last_used_time),
+        memory_usage_(0) {
   }
 
   virtual bool client_has_memory_allocation_changed_callback() const {
@@ -37,6 +40,9 @@ class FakeCommandBufferStub : public GpuCommandBufferStubBase {
       const GpuCommandBufferStubBase& stub) const {
     return false;
   }
+  virtual size_t GetMemoryUsage() const {
+    return memory_usage_;
+  }
   virtual void SendMemoryAllocationToProxy(const GpuMemoryAllocation& alloc) {
   }
   virtual void SetMemoryAllocation(const GpuMemoryAllocation& alloc) {
@@ -70,6 +76,9 @@ class FakeCommandBufferStubWithoutSurface : public GpuCommandBufferStubBase {
                      share_group_.end(),
                      &stub) != share_group_.end();
   }
+  virtual size_t GetMemoryUsage() const {
+    return 0;
+  }
   virtual void SendMemoryAllocationToProxy(const GpuMemoryAllocation& alloc) {
   }
   virtual void SetMemoryAllocation(const GpuMemoryAllocation& alloc) {
@@ -523,6 +532,70 @@ TEST_F(GpuMemoryManagerTest, TestForegroundStubsGetBonusAllocation) {
             GpuMemoryManager::kMinimumAllocationForTab);
 }
 
+// Test that a visible stub whose textures need more than
+// kMinimumAllocationForTab gets what it needs before the rest of the bonus is
+// split evenly.
+TEST_F(GpuMemoryManagerTest, TestForegroundBonusFollowsMemoryUsage) {
+  const size_t kExcessUsage = (GpuMemoryManager::kMaximumAllocationForTabs -
+      2 * GpuMemoryManager::kMinimumAllocationForTab) / 4;
+  FakeCommandBufferStub stub1(GenerateUniqueSurfaceId(), true, older_),
+                        stub2(GenerateUniqueSurfaceId(), true, older_);
+  stub1.memory_usage_ = GpuMemoryManager::kMinimumAllocationForTab +
+                        kExcessUsage;
+  client_.stubs_.push_back(&stub1);
+  client_.stubs_.push_back(&stub2);
+
+  Manage();
+  EXPECT_TRUE(IsAllocationForegroundForSurfaceYes(stub1.allocation_));
+  EXPECT_TRUE(IsAllocationForegroundForSurfaceYes(stub2.allocation_));
+  EXPECT_EQ(stub2.allocation_.gpu_resource_size_in_bytes + kExcessUsage,
+            stub1.allocation_.gpu_resource_size_in_bytes);
+  EXPECT_LE(stub1.allocation_.gpu_resource_size_in_bytes +
+                stub2.allocation_.gpu_resource_size_in_bytes,
+            static_cast<size_t>(GpuMemoryManager::kMaximumAllocationForTabs));
+
+  // When the needs exceed the limit, the stub can't have more than the limit.
+  stub1.memory_usage_ = 2 * GpuMemoryManager::kMaximumAllocationForTabs;
+  Manage();
+  EXPECT_LE(stub1.allocation_.gpu_resource_size_in_bytes +
+                stub2.allocation_.gpu_resource_size_in_bytes,
+            static_cast<size_t>(GpuMemoryManager::kMaximumAllocationForTabs));
+  EXPECT_EQ(stub2.allocation_.gpu_resource_size_in_bytes,
+            GpuMemoryManager::kMinimumAllocationForTab);
+}
+
+// Test that background stubs without a surface are hibernated when the
+// minimum allocations would exceed the global limit, and visible ones are not.
+TEST_F(GpuMemoryManagerTest, TestBackgroundStubsWithoutSurfaceEvictedFirst) {
+  const size_t kNumStubs = GpuMemoryManager::kMaximumAllocationForTabs /
+                           GpuMemoryManager::kMinimumAllocationForTab;
+  FakeCommandBufferStub stub_visible(GenerateUniqueSurfaceId(), true, older_),
+                        stub_hidden(GenerateUniqueSurfaceId(), false, older_);
+  client_.stubs_.push_back(&stub_visible);
+  client_.stubs_.push_back(&stub_hidden);
+
+  std::vector<FakeCommandBufferStubWithoutSurface> offscreen(2 * kNumStubs);
+  for (size_t i = 0; i < offscreen.size(); ++i) {
+    offscreen[i].share_group_.push_back(
+        i < kNumStubs ? &stub_hidden : &stub_visible);
+    client_.stubs_.push_back(&offscreen[i]);
+  }
+
+  Manage();
+  EXPECT_TRUE(IsAllocationForegroundForSurfaceYes(stub_visible.allocation_));
+  size_t num_hibernated = 0;
+  for (size_t i = 0; i < offscreen.size(); ++i) {
+    if (i >= kNumStubs) {
+      EXPECT_TRUE(IsAllocationForegroundForSurfaceNo(offscreen[i].allocation_));
+    } else if (IsAllocationHibernatedForSurfaceNo(offscreen[i].allocation_)) {
+      ++num_hibernated;
+    } else {
+      EXPECT_TRUE(IsAllocationBackgroundForSurfaceNo(offscreen[i].allocation_));
+    }
+  }
+  EXPECT_EQ(kNumStubs, num_hibernated);
+}
+
 // Test GpuMemoryAllocation comparison operators: Iterate over all possible
 // combinations of gpu_resource_size_in_bytes, suggest_have_backbuffer, and
 // suggest_have_frontbuffer, and make sure allocations with equal values test
@@ -4,6 +4,8 @@
 
 #include "content/common/indexed_db/proxy_webidbcursor_impl.h"
 
+#include <algorithm>
+
 #include "content/common/child_thread.h"
 #include "content/common/indexed_db/indexed_db_messages.h"
 #include "content/common/indexed_db/indexed_db_dispatcher.h"
@@ -67,6 +69,18 @@ void RendererWebIDBCursorImpl::advance(unsigned long count,
   IndexedDBDispatcher* dispatcher =
       IndexedDBDispatcher::ThreadSpecificInstance();
   scoped_ptr<WebIDBCallbacks> callbacks(callbacks_ptr);
+  if (count > 0 && prefetch_keys_.size() >= count) {
+    // The destination is already in the prefetch cache, skip over the
+    // records in between and serve the result from there.
+    for (unsigned long i = 1; i < count; ++i) {
+      prefetch_keys_.pop_front();
+      prefetch_primary_keys_.pop_front();
+      prefetch_values_.pop_front();
+      used_prefetches_++;
+    }
+    CachedContinue(callbacks.get());
+    return;
+  }
   ResetPrefetchCache();
   dispatcher->RequestIDBCursorAdvance(count, callbacks.release(),
                                       idb_cursor_id_, &ec);
@@ -151,6 +165,17 @@ void RendererWebIDBCursorImpl::SetPrefetchData(
 
   used_prefetches_ = 0;
   pending_onsuccess_callbacks_ = 0;
+
+  // Records can be arbitrarily large, so besides the count also bound the
+  // number of bytes held by the next batch.
+  size_t batch_bytes = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+    batch_bytes += values[i].data().size() * sizeof(char16);
+  if (batch_bytes > static_cast<size_t>(kMaxPrefetchBytes)) {
+    prefetch_amount_ = std::max<int>(
+        kMinPrefetchAmount,
+        static_cast<int>(values.size() * kMaxPrefetchBytes / batch_bytes));
+  }
 }
 
 void RendererWebIDBCursorImpl::CachedContinue(
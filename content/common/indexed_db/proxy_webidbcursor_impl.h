@@ -72,7 +72,8 @@ class RendererWebIDBCursorImpl : public WebKit::WebIDBCursor {
 
   enum { kPrefetchContinueThreshold = 2 };
   enum { kMinPrefetchAmount = 5 };
-  enum { kMaxPrefetchAmount = 100 };
+  enum { kMaxPrefetchAmount = 1000 };
+  enum { kMaxPrefetchBytes = 1024 * 1024 };
 };
 
 #endif  // CONTENT_COMMON_INDEXED_DB_PROXY_WEBIDBCURSOR_IMPL_H_
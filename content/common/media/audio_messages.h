@@ -23,10 +23,10 @@
 
 IPC_ENUM_TRAITS(AudioStreamState)
 
-IPC_STRUCT_TRAITS_BEGIN(media::AudioBuffersState)
-  IPC_STRUCT_TRAITS_MEMBER(pending_bytes)
-  IPC_STRUCT_TRAITS_MEMBER(hardware_delay_bytes)
-IPC_STRUCT_TRAITS_END()
+IPC_POD_STRUCT_TRAITS_BEGIN(media::AudioBuffersState)
+  IPC_POD_STRUCT_TRAITS_MEMBER(pending_bytes)
+  IPC_POD_STRUCT_TRAITS_MEMBER(hardware_delay_bytes)
+IPC_POD_STRUCT_TRAITS_END()
 
 // Messages sent from the browser to the renderer.
 
@@ -145,9 +145,11 @@ bool NPChannelBase::Send(IPC::Message* message) {
     return false;
   }
 
+  // Deferred NPObject calls are marked unblocking like the synchronous calls
+  // they replace, and must follow the same rule.
   if (send_unblocking_only_during_unblock_dispatch_ &&
       in_unblock_dispatch_ == 0 &&
-      message->is_sync()) {
+      (message->is_sync() || message->should_unblock())) {
     message->set_unblock(false);
   }
 
@@ -4,9 +4,13 @@
 
 #include "content/common/npobject_proxy.h"
 
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/message_loop.h"
 #include "content/common/np_channel_base.h"
 #include "content/common/npobject_util.h"
 #include "content/common/plugin_messages.h"
+#include "content/public/common/content_switches.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebBindings.h"
 #include "webkit/glue/webkit_glue.h"
 #include "webkit/plugins/npapi/plugin_instance.h"
@@ -14,6 +18,34 @@
 
 using WebKit::WebBindings;
 
+namespace {
+
+// Number of times in a row a method must return void before it is deferred.
+const int kVoidInvokesBeforeDeferring = 3;
+
+// Marks a method that must not be deferred anymore.
+const int kNeverDefer = -1;
+
+const size_t kMaxCachedProperties = 32;
+
+// Bumped whenever the cached property values may be stale. Proxies drop their
+// cache when they see a new value.
+int g_property_cache_generation = 0;
+bool g_end_of_task_invalidation_pending = false;
+
+bool ScriptBatchingEnabled() {
+  static bool enabled = CommandLine::ForCurrentProcess()->HasSwitch(
+      switches::kEnablePluginScriptBatching);
+  return enabled;
+}
+
+void InvalidatePropertyCachesAtEndOfTask() {
+  g_end_of_task_invalidation_pending = false;
+  NPObjectProxy::InvalidatePropertyCaches();
+}
+
+}  // namespace
+
 struct NPObjectWrapper {
     NPObject object;
     NPObjectProxy* proxy;
@@ -35,6 +67,10 @@ NPClass NPObjectProxy::npclass_proxy_ = {
   NPObjectProxy::NPNConstruct
 };
 
+void NPObjectProxy::InvalidatePropertyCaches() {
+  g_property_cache_generation++;
+}
+
 NPObjectProxy* NPObjectProxy::GetProxy(NPObject* object) {
   NPObjectProxy* proxy = NULL;
 
@@ -63,7 +99,8 @@ NPObjectProxy::NPObjectProxy(
     : channel_(channel),
       route_id_(route_id),
       containing_window_(containing_window),
-      page_url_(page_url) {
+      page_url_(page_url),
+      property_cache_generation_(g_property_cache_generation) {
   channel_->AddRoute(route_id, this, this);
 }
 
@@ -111,8 +148,14 @@ void NPObjectProxy::NPDeallocate(NPObject* npObj) {
 }
 
 bool NPObjectProxy::OnMessageReceived(const IPC::Message& msg) {
-  NOTREACHED();
-  return false;
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(NPObjectProxy, msg)
+    IPC_MESSAGE_HANDLER(NPObjectMsg_DeferredInvokeFailed,
+                        OnDeferredInvokeFailed)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  DCHECK(handled);
+  return handled;
 }
 
 void NPObjectProxy::OnChannelError() {
@@ -121,6 +164,66 @@ void NPObjectProxy::OnChannelError() {
   channel_ = NULL;
 }
 
+bool NPObjectProxy::CanDeferInvoke(NPIdentifier name) const {
+  InvokeResultMap::const_iterator it = void_invokes_.find(name);
+  return it != void_invokes_.end() &&
+      it->second >= kVoidInvokesBeforeDeferring;
+}
+
+void NPObjectProxy::OnInvokeResult(NPIdentifier name, bool returned_void) {
+  int& count = void_invokes_[name];
+  if (count == kNeverDefer)
+    return;
+  if (!returned_void)
+    count = 0;
+  else if (count < kVoidInvokesBeforeDeferring)
+    count++;
+}
+
+void NPObjectProxy::OnDeferredInvokeFailed(const NPIdentifier_Param& name) {
+  // The caller was already told that the call succeeded; make sure it does
+  // not happen again.
+  DLOG(WARNING) << "Deferred NPObject invoke did not return void";
+  void_invokes_[CreateNPIdentifier(name)] = kNeverDefer;
+}
+
+bool NPObjectProxy::GetCachedProperty(NPIdentifier name,
+                                      NPVariant_Param* value) {
+  if (property_cache_generation_ != g_property_cache_generation) {
+    property_cache_.clear();
+    property_cache_generation_ = g_property_cache_generation;
+    return false;
+  }
+  PropertyCache::const_iterator it = property_cache_.find(name);
+  if (it == property_cache_.end())
+    return false;
+  *value = it->second;
+  return true;
+}
+
+void NPObjectProxy::CacheProperty(NPIdentifier name,
+                                  const NPVariant_Param& value) {
+  // Objects are not cached, their proxies have their own lifetime.
+  if (value.type == NPVARIANT_PARAM_SENDER_OBJECT_ROUTING_ID ||
+      value.type == NPVARIANT_PARAM_RECEIVER_OBJECT_ROUTING_ID) {
+    return;
+  }
+  if (property_cache_generation_ != g_property_cache_generation ||
+      property_cache_.size() >= kMaxCachedProperties) {
+    property_cache_.clear();
+    property_cache_generation_ = g_property_cache_generation;
+  }
+  property_cache_[name] = value;
+
+  // The other process keeps running, so values are only trusted for the rest
+  // of the current task.
+  if (!g_end_of_task_invalidation_pending && MessageLoop::current()) {
+    g_end_of_task_invalidation_pending = true;
+    MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&InvalidatePropertyCachesAtEndOfTask));
+  }
+}
+
 bool NPObjectProxy::NPHasMethod(NPObject *obj,
                                 NPIdentifier name) {
   if (obj == NULL)
@@ -175,6 +278,9 @@ bool NPObjectProxy::NPInvokePrivate(NPP npp,
     }
   }
 
+  // The call may run script, which may change any property.
+  InvalidatePropertyCaches();
+
   bool result = false;
   gfx::NativeViewId containing_window = proxy->containing_window_;
   NPIdentifier_Param name_param;
@@ -198,6 +304,18 @@ bool NPObjectProxy::NPInvokePrivate(NPP npp,
     args_param.push_back(param);
   }
 
+  const bool batching = !is_default && ScriptBatchingEnabled();
+  if (batching && proxy->CanDeferInvoke(name)) {
+    IPC::Message* msg = new NPObjectMsg_InvokeDeferred(
+        proxy->route_id_, name_param, args_param);
+    // Like the synchronous calls it stands for, so that it is dispatched
+    // before any of them that follows.
+    msg->set_unblock(true);
+    proxy->Send(msg);
+    VOID_TO_NPVARIANT(*np_result);
+    return true;
+  }
+
   NPVariant_Param param_result;
   NPObjectMsg_Invoke* msg = new NPObjectMsg_Invoke(
       proxy->route_id_, is_default, name_param, args_param, &param_result,
@@ -214,10 +332,15 @@ bool NPObjectProxy::NPInvokePrivate(NPP npp,
   }
 
   GURL page_url = proxy->page_url_;
+  base::WeakPtr<NPObjectProxy> weak_proxy = proxy->AsWeakPtr();
   proxy->Send(msg);
 
   // Send may delete proxy.
   proxy = NULL;
+  if (batching && weak_proxy) {
+    weak_proxy->OnInvokeResult(
+        name, result && param_result.type == NPVARIANT_PARAM_VOID);
+  }
 
   if (!result)
     return false;
@@ -271,19 +394,29 @@ bool NPObjectProxy::NPGetProperty(NPObject *obj,
 
   bool result = false;
   gfx::NativeViewId containing_window = proxy->containing_window_;
-  NPIdentifier_Param name_param;
-  CreateNPIdentifierParam(name, &name_param);
-
   NPVariant_Param param;
   scoped_refptr<NPChannelBase> channel(proxy->channel_);
-
   GURL page_url = proxy->page_url_;
+
+  const bool batching = ScriptBatchingEnabled();
+  if (batching && proxy->GetCachedProperty(name, &param)) {
+    CreateNPVariant(
+        param, channel.get(), np_result, containing_window, page_url);
+    return true;
+  }
+
+  NPIdentifier_Param name_param;
+  CreateNPIdentifierParam(name, &name_param);
+
+  base::WeakPtr<NPObjectProxy> weak_proxy = proxy->AsWeakPtr();
   proxy->Send(new NPObjectMsg_GetProperty(
       proxy->route_id(), name_param, &param, &result));
   // Send may delete proxy.
   proxy = NULL;
   if (!result)
     return false;
+  if (batching && weak_proxy)
+    weak_proxy->CacheProperty(name, param);
 
   CreateNPVariant(
       param, channel.get(), np_result, containing_window, page_url);
@@ -302,6 +435,8 @@ bool NPObjectProxy::NPSetProperty(NPObject *obj,
     return obj->_class->setProperty(obj, name, value);
   }
 
+  InvalidatePropertyCaches();
+
   bool result = false;
   gfx::NativeViewId containing_window = proxy->containing_window_;
   NPIdentifier_Param name_param;
@@ -331,6 +466,8 @@ bool NPObjectProxy::NPRemoveProperty(NPObject *obj,
     return obj->_class->removeProperty(obj, name);
   }
 
+  InvalidatePropertyCaches();
+
   NPIdentifier_Param name_param;
   CreateNPIdentifierParam(name, &name_param);
 
@@ -353,6 +490,7 @@ void NPObjectProxy::NPPInvalidate(NPObject *obj) {
     return;
   }
 
+  InvalidatePropertyCaches();
   proxy->Send(new NPObjectMsg_Invalidate(proxy->route_id()));
   // Send may delete proxy.
   proxy = NULL;
@@ -409,6 +547,8 @@ bool NPObjectProxy::NPNConstruct(NPObject *obj,
     }
   }
 
+  InvalidatePropertyCaches();
+
   bool result = false;
   gfx::NativeViewId containing_window = proxy->containing_window_;
 
@@ -457,6 +597,8 @@ bool NPObjectProxy::NPNEvaluate(NPP npp,
     return false;
   }
 
+  InvalidatePropertyCaches();
+
   bool result = false;
   gfx::NativeViewId containing_window = proxy->containing_window_;
   bool popups_allowed = false;
@@ -9,8 +9,12 @@
 #define CONTENT_COMMON_NPOBJECT_PROXY_H_
 #pragma once
 
+#include <map>
+
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "content/common/npobject_base.h"
+#include "content/public/common/webkit_param_traits.h"
 #include "googleurl/src/gurl.h"
 #include "ipc/ipc_channel.h"
 #include "third_party/npapi/bindings/npruntime.h"
@@ -27,8 +31,14 @@ struct NPObject;
 // channel (specifically, a NPChannelBase).  The NPObjectStub on the other
 // side translates the IPC messages into calls to the actual NPObject, and
 // returns the marshalled result.
+//
+// With --enable-plugin-script-batching, a method that returned void a few times
+// in a row is then called without waiting for the result, and property values
+// are cached until the end of the task or until anything could have changed
+// them: a call that may run script, or a call from the other side.
 class NPObjectProxy : public IPC::Channel::Listener,
                       public IPC::Message::Sender,
+                      public base::SupportsWeakPtr<NPObjectProxy>,
                       public NPObjectBase {
  public:
   virtual ~NPObjectProxy();
@@ -87,6 +97,9 @@ class NPObjectProxy : public IPC::Channel::Listener,
                               uint32_t arg_count,
                               NPVariant *result);
 
+  // Forgets the property values cached by all the proxies in this process.
+  static void InvalidatePropertyCaches();
+
   static NPObjectProxy* GetProxy(NPObject* object);
   static const NPClass* npclass() { return &npclass_proxy_; }
 
@@ -105,6 +118,17 @@ class NPObjectProxy : public IPC::Channel::Listener,
   virtual bool OnMessageReceived(const IPC::Message& msg) OVERRIDE;
   virtual void OnChannelError() OVERRIDE;
 
+  // Returns true if |name| can be invoked without waiting for the result.
+  bool CanDeferInvoke(NPIdentifier name) const;
+  // Learns from a synchronous invoke of |name| whether later ones can be
+  // deferred.
+  void OnInvokeResult(NPIdentifier name, bool returned_void);
+  void OnDeferredInvokeFailed(const NPIdentifier_Param& name);
+
+  // Returns true and the cached value of |name| if there is one.
+  bool GetCachedProperty(NPIdentifier name, NPVariant_Param* value);
+  void CacheProperty(NPIdentifier name, const NPVariant_Param& value);
+
   static NPObject* NPAllocate(NPP, NPClass*);
   static void NPDeallocate(NPObject* npObj);
 
@@ -118,6 +142,16 @@ class NPObjectProxy : public IPC::Channel::Listener,
 
   // The url of the main frame hosting the plugin.
   GURL page_url_;
+
+  // How many times in a row each method returned void; negative if the
+  // method must never be deferred.
+  typedef std::map<NPIdentifier, int> InvokeResultMap;
+  InvokeResultMap void_invokes_;
+
+  typedef std::map<NPIdentifier, NPVariant_Param> PropertyCache;
+  PropertyCache property_cache_;
+  // The value of the global cache generation |property_cache_| was filled in.
+  int property_cache_generation_;
 };
 
 #endif  // CONTENT_COMMON_NPOBJECT_PROXY_H_
@@ -6,6 +6,7 @@
 
 #include "base/command_line.h"
 #include "content/common/np_channel_base.h"
+#include "content/common/npobject_proxy.h"
 #include "content/common/npobject_util.h"
 #include "content/common/plugin_messages.h"
 #include "content/public/common/content_client.h"
@@ -71,6 +72,10 @@ IPC::Channel::Listener* NPObjectStub::GetChannelListener() {
 
 bool NPObjectStub::OnMessageReceived(const IPC::Message& msg) {
   content::GetContentClient()->SetActiveURL(page_url_);
+  // The other side is calling into this process, so what it learned about
+  // the objects here may be stale.
+  NPObjectProxy::InvalidatePropertyCaches();
+
   if (!npobject_) {
     if (msg.is_sync()) {
       // The object could be garbage because the frame has gone away, so
@@ -88,6 +93,7 @@ bool NPObjectStub::OnMessageReceived(const IPC::Message& msg) {
     IPC_MESSAGE_HANDLER_DELAY_REPLY(NPObjectMsg_Release, OnRelease);
     IPC_MESSAGE_HANDLER(NPObjectMsg_HasMethod, OnHasMethod);
     IPC_MESSAGE_HANDLER_DELAY_REPLY(NPObjectMsg_Invoke, OnInvoke);
+    IPC_MESSAGE_HANDLER(NPObjectMsg_InvokeDeferred, OnInvokeDeferred);
     IPC_MESSAGE_HANDLER(NPObjectMsg_HasProperty, OnHasProperty);
     IPC_MESSAGE_HANDLER(NPObjectMsg_GetProperty, OnGetProperty);
     IPC_MESSAGE_HANDLER_DELAY_REPLY(NPObjectMsg_SetProperty, OnSetProperty);
@@ -133,24 +139,46 @@ void NPObjectStub::OnInvoke(bool is_default,
                             const NPIdentifier_Param& method,
                             const std::vector<NPVariant_Param>& args,
                             IPC::Message* reply_msg) {
-  bool return_value = false;
   NPVariant_Param result_param;
   NPVariant result_var;
 
   VOID_TO_NPVARIANT(result_var);
   result_param.type = NPVARIANT_PARAM_VOID;
 
+  bool return_value = CallInvoke(is_default, method, args, &result_var);
+  CreateNPVariantParam(
+      result_var, channel_, &result_param, true, containing_window_,
+      page_url_);
+  NPObjectMsg_Invoke::WriteReplyParams(reply_msg, result_param, return_value);
+  channel_->Send(reply_msg);
+}
+
+void NPObjectStub::OnInvokeDeferred(const NPIdentifier_Param& method,
+                                    const std::vector<NPVariant_Param>& args) {
+  NPVariant result_var;
+  VOID_TO_NPVARIANT(result_var);
+
+  // Nobody waits for the result, so the proxy only needs to hear about calls
+  // that did not behave like the ones it learned from.
+  bool return_value = CallInvoke(false, method, args, &result_var);
+  if (!return_value || !NPVARIANT_IS_VOID(result_var))
+    Send(new NPObjectMsg_DeferredInvokeFailed(route_id_, method));
+  WebBindings::releaseVariantValue(&result_var);
+}
+
+bool NPObjectStub::CallInvoke(bool is_default,
+                              const NPIdentifier_Param& method,
+                              const std::vector<NPVariant_Param>& args,
+                              NPVariant* result_var) {
+  bool return_value = false;
   int arg_count = static_cast<int>(args.size());
   NPVariant* args_var = new NPVariant[arg_count];
   for (int i = 0; i < arg_count; ++i) {
     if (!CreateNPVariant(
             args[i], channel_, &(args_var[i]), containing_window_,
             page_url_)) {
-      NPObjectMsg_Invoke::WriteReplyParams(reply_msg, result_param,
-                                           return_value);
-      channel_->Send(reply_msg);
       delete[] args_var;
-      return;
+      return false;
     }
   }
 
@@ -158,26 +186,26 @@ void NPObjectStub::OnInvoke(bool is_default,
     if (IsPluginProcess()) {
       if (npobject_->_class->invokeDefault) {
         return_value = npobject_->_class->invokeDefault(
-            npobject_, args_var, arg_count, &result_var);
+            npobject_, args_var, arg_count, result_var);
       } else {
         return_value = false;
       }
     } else {
       return_value = WebBindings::invokeDefault(
-          0, npobject_, args_var, arg_count, &result_var);
+          0, npobject_, args_var, arg_count, result_var);
     }
   } else {
     NPIdentifier id = CreateNPIdentifier(method);
     if (IsPluginProcess()) {
       if (npobject_->_class->invoke) {
         return_value = npobject_->_class->invoke(
-            npobject_, id, args_var, arg_count, &result_var);
+            npobject_, id, args_var, arg_count, result_var);
       } else {
         return_value = false;
       }
     } else {
       return_value = WebBindings::invoke(
-          0, npobject_, id, args_var, arg_count, &result_var);
+          0, npobject_, id, args_var, arg_count, result_var);
     }
   }
 
@@ -185,12 +213,7 @@ void NPObjectStub::OnInvoke(bool is_default,
     WebBindings::releaseVariantValue(&(args_var[i]));
 
   delete[] args_var;
-
-  CreateNPVariantParam(
-      result_var, channel_, &result_param, true, containing_window_,
-      page_url_);
-  NPObjectMsg_Invoke::WriteReplyParams(reply_msg, result_param, return_value);
-  channel_->Send(reply_msg);
+  return return_value;
 }
 
 void NPObjectStub::OnHasProperty(const NPIdentifier_Param& name,
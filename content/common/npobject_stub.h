@@ -65,6 +65,8 @@ class NPObjectStub : public IPC::Channel::Listener,
                 const NPIdentifier_Param& method,
                 const std::vector<NPVariant_Param>& args,
                 IPC::Message* reply_msg);
+  void OnInvokeDeferred(const NPIdentifier_Param& method,
+                        const std::vector<NPVariant_Param>& args);
   void OnHasProperty(const NPIdentifier_Param& name,
                      bool* result);
   void OnGetProperty(const NPIdentifier_Param& name,
@@ -83,6 +85,13 @@ class NPObjectStub : public IPC::Channel::Listener,
   void OnEvaluate(const std::string& script, bool popups_allowed,
                   IPC::Message* reply_msg);
 
+  // Invokes |method|, or the default method, of the object with |args|.
+  // Returns false if the call failed or |args| could not be converted.
+  bool CallInvoke(bool is_default,
+                  const NPIdentifier_Param& method,
+                  const std::vector<NPVariant_Param>& args,
+                  NPVariant* result_var);
+
  private:
   NPObject* npobject_;
   scoped_refptr<NPChannelBase> channel_;
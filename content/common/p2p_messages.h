@@ -22,6 +22,11 @@ IPC_STRUCT_TRAITS_BEGIN(net::NetworkInterface)
   IPC_STRUCT_TRAITS_MEMBER(address)
 IPC_STRUCT_TRAITS_END()
 
+IPC_STRUCT_TRAITS_BEGIN(content::P2PPacket)
+  IPC_STRUCT_TRAITS_MEMBER(address)
+  IPC_STRUCT_TRAITS_MEMBER(data)
+IPC_STRUCT_TRAITS_END()
+
 // P2P Socket messages sent from the browser to the renderer.
 
 IPC_MESSAGE_ROUTED1(P2PMsg_NetworkListChanged,
@@ -47,6 +52,11 @@ IPC_MESSAGE_ROUTED3(P2PMsg_OnDataReceived,
                     net::IPEndPoint /* socket_address */,
                     std::vector<char> /* data */)
 
+// Several datagrams read from a UDP socket at once, in order.
+IPC_MESSAGE_ROUTED2(P2PMsg_OnDataReceivedBatch,
+                    int /* socket_id */,
+                    std::vector<content::P2PPacket> /* packets */)
+
 // P2P Socket messages sent from the renderer to the browser.
 
 // Start/stop sending P2PMsg_NetworkListChanged messages when network
@@ -75,5 +85,10 @@ IPC_MESSAGE_ROUTED3(P2PHostMsg_Send,
                     net::IPEndPoint /* socket_address */,
                     std::vector<char> /* data */)
 
+// Several datagrams queued for a UDP socket while the IPC thread was busy.
+IPC_MESSAGE_ROUTED2(P2PHostMsg_SendBatch,
+                    int /* socket_id */,
+                    std::vector<content::P2PPacket> /* packets */)
+
 IPC_MESSAGE_ROUTED1(P2PHostMsg_DestroySocket,
                     int /* socket_id */)
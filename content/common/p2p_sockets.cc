@@ -0,0 +1,21 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/common/p2p_sockets.h"
+
+namespace content {
+
+P2PPacket::P2PPacket() {
+}
+
+P2PPacket::P2PPacket(const net::IPEndPoint& address,
+                     const std::vector<char>& data)
+    : address(address),
+      data(data) {
+}
+
+P2PPacket::~P2PPacket() {
+}
+
+}  // namespace content
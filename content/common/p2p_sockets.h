@@ -1,4 +1,4 @@
-// Copyright (c) 2011 The Chromium Authors. All rights reserved.
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
@@ -8,6 +8,11 @@
 #ifndef CONTENT_COMMON_P2P_SOCKETS_H_
 #define CONTENT_COMMON_P2P_SOCKETS_H_
 
+#include <vector>
+
+#include "content/common/content_export.h"
+#include "net/base/ip_endpoint.h"
+
 namespace content {
 
 // Type of P2P Socket.
@@ -17,6 +22,16 @@ enum P2PSocketType {
   P2P_SOCKET_TCP_CLIENT,
 };
 
+// A datagram and its peer, as carried by the batched UDP messages.
+struct CONTENT_EXPORT P2PPacket {
+  P2PPacket();
+  P2PPacket(const net::IPEndPoint& address, const std::vector<char>& data);
+  ~P2PPacket();
+
+  net::IPEndPoint address;
+  std::vector<char> data;
+};
+
 }  // namespace content
 
 #endif  // CONTENT_COMMON_P2P_SOCKETS_H_
@@ -524,3 +524,13 @@ IPC_SYNC_MESSAGE_ROUTED2_2(NPObjectMsg_Evaluate,
                            bool /* popups_allowed */,
                            NPVariant_Param /* result_param */,
                            bool /* result */)
+
+// Like NPObjectMsg_Invoke, for a method that returned void the last few times
+// it was called, without waiting for the result. The stub answers with
+// NPObjectMsg_DeferredInvokeFailed if the call fails or returns a value.
+IPC_MESSAGE_ROUTED2(NPObjectMsg_InvokeDeferred,
+                    NPIdentifier_Param /* method */,
+                    std::vector<NPVariant_Param> /* args */)
+
+IPC_MESSAGE_ROUTED1(NPObjectMsg_DeferredInvokeFailed,
+                    NPIdentifier_Param /* method */)
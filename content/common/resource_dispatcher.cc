@@ -293,6 +293,14 @@ bool ResourceDispatcher::OnMessageReceived(const IPC::Message& message) {
     return false;
   }
 
+  // Buffers aren't tied to a request.
+  if (message.type() == ResourceMsg_SetDataBuffer::ID) {
+    IPC_BEGIN_MESSAGE_MAP(ResourceDispatcher, message)
+      IPC_MESSAGE_HANDLER(ResourceMsg_SetDataBuffer, OnSetDataBuffer)
+    IPC_END_MESSAGE_MAP()
+    return true;
+  }
+
   int request_id;
 
   PickleIterator iter(message);
@@ -405,6 +413,40 @@ void ResourceDispatcher::OnReceivedData(const IPC::Message& message,
   }
 }
 
+void ResourceDispatcher::OnReceivedDataInBuffer(const IPC::Message& message,
+                                                int request_id,
+                                                int buffer_id,
+                                                int data_offset,
+                                                int data_len,
+                                                int encoded_data_length) {
+  PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
+  DataBufferMap::iterator it = data_buffers_.find(buffer_id);
+  if (request_info && it != data_buffers_.end() && data_len > 0 &&
+      data_offset >= 0 && data_len <= it->second.size - data_offset) {
+    const char* data =
+        static_cast<char*>(it->second.memory->memory()) + data_offset;
+    request_info->peer->OnReceivedData(data, data_len, encoded_data_length);
+  }
+
+  // Unlike for unpooled data, only ACK once the data was consumed, as the
+  // browser reads into the same space again after the ACK.
+  message_sender()->Send(
+      new ResourceHostMsg_DataReceived_ACK(message.routing_id(), request_id));
+}
+
+void ResourceDispatcher::OnSetDataBuffer(int buffer_id,
+                                         base::SharedMemoryHandle handle,
+                                         int buffer_size) {
+  DataBuffer buffer;
+  buffer.memory.reset(new base::SharedMemory(handle, true));  // read only
+  buffer.size = buffer_size;
+  if (buffer_size <= 0 || !buffer.memory->Map(buffer_size)) {
+    DLOG(ERROR) << "Couldn't map a resource data buffer";
+    return;
+  }
+  data_buffers_[buffer_id] = buffer;
+}
+
 void ResourceDispatcher::OnDownloadedData(const IPC::Message& message,
                                           int request_id,
                                           int data_len) {
@@ -557,6 +599,8 @@ void ResourceDispatcher::DispatchMessage(const IPC::Message& message) {
                         OnReceivedCachedMetadata)
     IPC_MESSAGE_HANDLER(ResourceMsg_ReceivedRedirect, OnReceivedRedirect)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataReceived, OnReceivedData)
+    IPC_MESSAGE_HANDLER(ResourceMsg_DataReceivedInBuffer,
+                        OnReceivedDataInBuffer)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataDownloaded, OnDownloadedData)
     IPC_MESSAGE_HANDLER(ResourceMsg_RequestComplete, OnRequestComplete)
   IPC_END_MESSAGE_MAP()
@@ -665,6 +709,8 @@ bool ResourceDispatcher::IsResourceDispatcherMessage(
     case ResourceMsg_ReceivedCachedMetadata::ID:
     case ResourceMsg_ReceivedRedirect::ID:
     case ResourceMsg_DataReceived::ID:
+    case ResourceMsg_DataReceivedInBuffer::ID:
+    case ResourceMsg_SetDataBuffer::ID:
     case ResourceMsg_DataDownloaded::ID:
     case ResourceMsg_RequestComplete::ID:
       return true;
@@ -676,7 +722,6 @@ bool ResourceDispatcher::IsResourceDispatcherMessage(
   return false;
 }
 
-// static
 void ResourceDispatcher::ReleaseResourcesInDataMessage(
     const IPC::Message& message) {
   PickleIterator iter(message);
@@ -695,10 +740,12 @@ void ResourceDispatcher::ReleaseResourcesInDataMessage(
                                                          &shm_handle)) {
       base::SharedMemory::CloseHandle(shm_handle);
     }
+  } else if (message.type() == ResourceMsg_DataReceivedInBuffer::ID) {
+    message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(
+        message.routing_id(), request_id));
   }
 }
 
-// static
 void ResourceDispatcher::ReleaseResourcesInMessageQueue(MessageQueue* queue) {
   while (!queue->empty()) {
     IPC::Message* message = queue->front();
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <deque>
+#include <map>
 #include <string>
 
 #include "base/hash_tables.h"
@@ -122,6 +123,16 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
       base::SharedMemoryHandle data,
       int data_len,
       int encoded_data_length);
+  void OnReceivedDataInBuffer(
+      const IPC::Message& message,
+      int request_id,
+      int buffer_id,
+      int data_offset,
+      int data_len,
+      int encoded_data_length);
+  void OnSetDataBuffer(int buffer_id,
+                       base::SharedMemoryHandle handle,
+                       int buffer_size);
   void OnDownloadedData(
       const IPC::Message& message,
       int request_id,
@@ -155,15 +166,25 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
   // handle in it that we should cleanup it up nicely. This method accepts any
   // message and determine whether the message is
   // ViewHostMsg_Resource_DataReceived and clean up the shared memory handle.
-  static void ReleaseResourcesInDataMessage(const IPC::Message& message);
+  // Data sent in a pooled buffer is ACKed instead, so that the browser may
+  // reuse the space.
+  void ReleaseResourcesInDataMessage(const IPC::Message& message);
 
   // Iterate through a message queue and clean up the messages by calling
   // ReleaseResourcesInDataMessage and removing them from the queue. Intended
   // for use on deferred message queues that are no longer needed.
-  static void ReleaseResourcesInMessageQueue(MessageQueue* queue);
+  void ReleaseResourcesInMessageQueue(MessageQueue* queue);
 
   IPC::Message::Sender* message_sender_;
 
+  // The browser's pooled data buffers, mapped read only, by buffer id.
+  struct DataBuffer {
+    linked_ptr<base::SharedMemory> memory;
+    int size;
+  };
+  typedef std::map<int, DataBuffer> DataBufferMap;
+  DataBufferMap data_buffers_;
+
   // All pending requests issued to the host
   PendingRequestList pending_requests_;
 
@@ -161,6 +161,25 @@ IPC_MESSAGE_ROUTED4(ResourceMsg_DataReceived,
                     int /* data_len */,
                     int /* encoded_data_length */)
 
+// Shares one of the browser's pooled response data buffers with the renderer.
+// ResourceMsg_DataReceivedInBuffer messages refer to it by |buffer_id| from
+// then on, for any request.
+IPC_MESSAGE_ROUTED3(ResourceMsg_SetDataBuffer,
+                    int /* buffer_id */,
+                    base::SharedMemoryHandle /* buffer */,
+                    int /* buffer_size */)
+
+// Like ResourceMsg_DataReceived, but the data is at |data_offset| in a buffer
+// shared by ResourceMsg_SetDataBuffer. The browser reuses the space once the
+// message is ACKed, so the renderer must be done with the data by then, and
+// must ACK the message even if it drops it.
+IPC_MESSAGE_ROUTED5(ResourceMsg_DataReceivedInBuffer,
+                    int /* request_id */,
+                    int /* buffer_id */,
+                    int /* data_offset */,
+                    int /* data_len */,
+                    int /* encoded_data_length */)
+
 // Sent when some data from a resource request has been downloaded to
 // file. This is only called in the 'download_to_file' case and replaces
 // ResourceMsg_DataReceived in the call sequence in that case.
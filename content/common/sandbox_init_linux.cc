@@ -8,8 +8,10 @@
 
 #include <asm/unistd.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <linux/audit.h>
 #include <linux/filter.h>
+#include <sched.h>
 #include <signal.h>
 #include <string.h>
 #include <sys/prctl.h>
@@ -22,6 +24,7 @@
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/time.h"
+#include "content/common/seccomp_sandbox.h"
 #include "content/public/common/content_switches.h"
 
 #ifndef PR_SET_NO_NEW_PRIVS
@@ -172,6 +175,30 @@ static void EmitAllowSyscallArgN(int nr,
   EmitLoad(0, program);
 }
 
+static void EmitJSETJF(int value,
+                      int jf,
+                      std::vector<struct sock_filter>* program) {
+  struct sock_filter filter;
+  filter.code = BPF_JMP+BPF_JSET+BPF_K;
+  filter.jt = 0;
+  filter.jf = jf;
+  filter.k = value;
+  program->push_back(filter);
+}
+
+static void EmitAllowSyscallArgBit(int nr,
+                                   int arg_nr,
+                                   int bit,
+                                   std::vector<struct sock_filter>* program) {
+  // Same layout as EmitAllowSyscallArgN(), but allows the syscall if |bit| is
+  // set in the argument rather than if the argument equals a value.
+  EmitJEQJF(nr, 4, program);
+  EmitLoadArg(arg_nr, program);
+  EmitJSETJF(bit, 1, program);
+  EmitRet(SECCOMP_RET_ALLOW, program);
+  EmitLoad(0, program);
+}
+
 static void EmitFailSyscall(int nr, int err,
                             std::vector<struct sock_filter>* program) {
   EmitJEQJF(nr, 1, program);
@@ -295,6 +322,85 @@ static void ApplyFlashPolicy(std::vector<struct sock_filter>* program) {
   EmitFailSyscall(__NR_access, ENOENT, program);
 }
 
+static void ApplyRendererPolicy(std::vector<struct sock_filter>* program) {
+  // "Hot" syscalls go first. Allocation and timing syscalls are checked in the
+  // kernel rather than proxied, which is the point of this policy.
+  EmitAllowSyscall(__NR_futex, program);
+  EmitAllowSyscall(__NR_read, program);
+  EmitAllowSyscall(__NR_write, program);
+  EmitAllowSyscall(__NR_recvmsg, program);
+  EmitAllowSyscall(__NR_sendmsg, program);
+  EmitAllowSyscall(__NR_gettimeofday, program);
+  EmitAllowSyscall(__NR_clock_gettime, program);
+  EmitAllowSyscall(__NR_mmap, program);
+  EmitAllowSyscall(__NR_munmap, program);
+  EmitAllowSyscall(__NR_mprotect, program);
+  EmitAllowSyscall(__NR_madvise, program);
+  EmitAllowSyscall(__NR_epoll_wait, program);
+  EmitAllowSyscall(__NR_poll, program);
+  EmitAllowSyscall(__NR_gettid, program);
+  EmitAllowSyscall(__NR_sched_yield, program);
+
+  // Less hot syscalls.
+  EmitAllowSyscall(__NR_brk, program);
+  EmitAllowSyscall(__NR_mremap, program);
+  EmitAllowSyscall(__NR_close, program);
+  EmitAllowSyscall(__NR_dup, program);
+  EmitAllowSyscall(__NR_fstat, program);
+  EmitAllowSyscall(__NR_lseek, program);
+  EmitAllowSyscall(__NR_pread64, program);
+  EmitAllowSyscall(__NR_readv, program);
+  EmitAllowSyscall(__NR_writev, program);
+  EmitAllowSyscall(__NR_ftruncate, program);
+  EmitAllowSyscall(__NR_pipe, program);
+  EmitAllowSyscall(__NR_socketpair, program);
+  EmitAllowSyscall(__NR_shutdown, program);
+  EmitAllowSyscall(__NR_select, program);
+  EmitAllowSyscall(__NR_epoll_create, program);
+  EmitAllowSyscall(__NR_epoll_ctl, program);
+  EmitAllowSyscall(__NR_eventfd2, program);
+  EmitAllowSyscall(__NR_nanosleep, program);
+  EmitAllowSyscall(__NR_clock_getres, program);
+  EmitAllowSyscall(__NR_time, program);
+  EmitAllowSyscall(__NR_getpid, program);
+  EmitAllowSyscall(__NR_getuid, program);
+  EmitAllowSyscall(__NR_geteuid, program);
+  EmitAllowSyscall(__NR_getgid, program);
+  EmitAllowSyscall(__NR_getegid, program);
+  EmitAllowSyscall(__NR_getrlimit, program);
+  EmitAllowSyscall(__NR_getrusage, program);
+  EmitAllowSyscall(__NR_sched_getaffinity, program);
+  EmitAllowSyscall(__NR_uname, program);
+  EmitAllowSyscall(__NR_sysinfo, program);
+  EmitAllowSyscall(__NR_prctl, program);
+  EmitAllowSyscall(__NR_set_robust_list, program);
+  EmitAllowSyscall(__NR_sigaltstack, program);
+  EmitAllowSyscall(__NR_rt_sigaction, program);
+  EmitAllowSyscall(__NR_rt_sigprocmask, program);
+  EmitAllowSyscall(__NR_rt_sigreturn, program);
+  EmitAllowSyscall(__NR_restart_syscall, program);
+  EmitAllowSyscall(__NR_exit, program);
+  EmitAllowSyscall(__NR_exit_group, program);
+
+  // Threads may be created, but not processes.
+  EmitAllowSyscallArgBit(__NR_clone, 1, CLONE_THREAD, program);
+  // Only file descriptor flags may be changed.
+  EmitAllowSyscallArgN(__NR_fcntl, 2, F_GETFD, program);
+  EmitAllowSyscallArgN(__NR_fcntl, 2, F_SETFD, program);
+  EmitAllowSyscallArgN(__NR_fcntl, 2, F_GETFL, program);
+  EmitAllowSyscallArgN(__NR_fcntl, 2, F_SETFL, program);
+  // Signals may only be sent to our own threads, e.g. by abort().
+  EmitAllowSyscallArgN(__NR_tgkill, 1, getpid(), program);
+
+  // The setuid sandbox already denies the renderer a file system; fail
+  // filename-based syscalls the way it would.
+  EmitFailSyscall(__NR_open, ENOENT, program);
+  EmitFailSyscall(__NR_access, ENOENT, program);
+  EmitFailSyscall(__NR_stat, ENOENT, program);
+  EmitFailSyscall(__NR_lstat, ENOENT, program);
+  EmitFailSyscall(__NR_readlink, ENOENT, program);
+}
+
 static bool CanUseSeccompFilters() {
   int ret = prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, 0, 0, 0);
   if (ret != 0 && errno == EFAULT)
@@ -330,6 +436,18 @@ void InitializeSandbox() {
       command_line.HasSwitch(switches::kDisableGpuSandbox))
     return;
 
+  if (process_type == switches::kRendererProcess) {
+    // The renderer policy is opt-in until it has seen more use.
+    if (!command_line.HasSwitch(switches::kEnableRendererSeccompFilterSandbox))
+      return;
+#if defined(SECCOMP_SANDBOX)
+    // The legacy seccomp sandbox proxies syscalls through a trusted thread,
+    // which this filter would break.
+    if (SeccompSandboxEnabled())
+      return;
+#endif
+  }
+
   if (!CanUseSeccompFilters())
     return;
 
@@ -342,6 +460,8 @@ void InitializeSandbox() {
     ApplyGPUPolicy(&program);
   } else if (process_type == switches::kPpapiPluginProcess) {
     ApplyFlashPolicy(&program);
+  } else if (process_type == switches::kRendererProcess) {
+    ApplyRendererPolicy(&program);
   } else {
     NOTREACHED();
   }
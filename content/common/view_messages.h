@@ -110,12 +110,12 @@ IPC_STRUCT_TRAITS_BEGIN(WebKit::WebPluginAction)
   IPC_STRUCT_TRAITS_MEMBER(enable)
 IPC_STRUCT_TRAITS_END()
 
-IPC_STRUCT_TRAITS_BEGIN(WebKit::WebRect)
-  IPC_STRUCT_TRAITS_MEMBER(x)
-  IPC_STRUCT_TRAITS_MEMBER(y)
-  IPC_STRUCT_TRAITS_MEMBER(width)
-  IPC_STRUCT_TRAITS_MEMBER(height)
-IPC_STRUCT_TRAITS_END()
+IPC_POD_STRUCT_TRAITS_BEGIN(WebKit::WebRect)
+  IPC_POD_STRUCT_TRAITS_MEMBER(x)
+  IPC_POD_STRUCT_TRAITS_MEMBER(y)
+  IPC_POD_STRUCT_TRAITS_MEMBER(width)
+  IPC_POD_STRUCT_TRAITS_MEMBER(height)
+IPC_POD_STRUCT_TRAITS_END()
 
 IPC_STRUCT_TRAITS_BEGIN(WebKit::WebScreenInfo)
   IPC_STRUCT_TRAITS_MEMBER(verticalDPI)
@@ -1166,6 +1166,14 @@ IPC_MESSAGE_ROUTED3(ViewMsg_PpapiBrokerChannelCreated,
 IPC_MESSAGE_CONTROL1(ViewMsg_PurgePluginListCache,
                      bool /* reload_pages */)
 
+// Sent to a spare renderer, which has no views yet, so that it does the
+// initialization the first view would otherwise wait for.
+IPC_MESSAGE_CONTROL0(ViewMsg_WarmUp)
+
+// Sent once every widget of the renderer has been hidden for a while, so that
+// it gives back the memory held by its caches and heaps.
+IPC_MESSAGE_CONTROL0(ViewMsg_ReclaimMemory)
+
 // Sent to the renderer when a popup window should no longer count against
 // the current popup count (either because it's not a popup or because it was
 // a generated by a user action).
@@ -43,6 +43,12 @@ class CONTENT_EXPORT ProfilerController {
 
   // Contact all processes and get their profiler data.
   virtual void GetProfilerData(int sequence_number) = 0;
+
+  // Profile about one in |interval| tasks in all processes, including the ones
+  // launched from now on, so that profiling can stay on with little overhead.
+  // GetProfilerData() can then be called periodically; the counts it returns
+  // are cumulative, and are of the sampled tasks only.
+  virtual void SetProfilerSamplingInterval(int interval) = 0;
 };
 
 }  // namespace content
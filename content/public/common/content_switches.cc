@@ -282,6 +282,10 @@ const char kEnableOriginBoundCerts[]  = "enable-origin-bound-certs";
 // Enables partial swaps in the WK compositor on platforms that support it.
 const char kEnablePartialSwap[]             = "enable-partial-swap";
 
+// Lets NPObject proxies send calls to methods that keep returning void without
+// waiting for the result, and cache property values within a task.
+const char kEnablePluginScriptBatching[]    = "enable-plugin-script-batching";
+
 // Enable caching of pre-parsed JS script data.  See http://crbug.com/32407.
 const char kEnablePreparsedJsCaching[]      = "enable-preparsed-js-caching";
 
@@ -294,6 +298,10 @@ const char kEnablePrivilegedWebGLExtensions[] =
 const char kEnablePruneGpuCommandBuffers[] =
     "enable-prune-gpu-command-buffers";
 
+// Enable the seccomp filter sandbox in renderers (Linux only)
+const char kEnableRendererSeccompFilterSandbox[] =
+    "enable-renderer-seccomp-filter-sandbox";
+
 // Enables TLS cached info extension.
 const char kEnableSSLCachedInfo[]  = "enable-ssl-cached-info";
 
@@ -534,6 +542,10 @@ const char kSingleProcess[]                 = "single-process";
 // content. The switch is intended only for tests.
 const char kSkipGpuDataLoading[]            = "skip-gpu-data-loading";
 
+// Number of renderer processes to keep started and initialized per browser
+// context, ready for new tabs. The default is none.
+const char kSpareRendererProcesses[]        = "spare-renderer-processes";
+
 // Runs the security test for the renderer sandbox.
 const char kTestSandbox[]                   = "test-sandbox";
 
@@ -617,6 +629,9 @@ const char kScrollPixels[]                  = "scroll-pixels";
 const char kUseSystemSSL[]                  = "use-system-ssl";
 #endif
 
+// Disable per-tile page painting, where it is on by default.
+const char kDisablePerTilePainting[]        = "disable-per-tile-painting";
+
 // Enable per-tile page painting.
 const char kEnablePerTilePainting[]         = "enable-per-tile-painting";
 
@@ -96,9 +96,11 @@ extern const char kEnablePeerConnection[];
 extern const char kEnableMonitorProfile[];
 extern const char kEnableOriginBoundCerts[];
 extern const char kEnablePartialSwap[];
+CONTENT_EXPORT extern const char kEnablePluginScriptBatching[];
 extern const char kEnablePreparsedJsCaching[];
 CONTENT_EXPORT extern const char kEnablePrivilegedWebGLExtensions[];
 extern const char kEnablePruneGpuCommandBuffers[];
+extern const char kEnableRendererSeccompFilterSandbox[];
 extern const char kEnableSSLCachedInfo[];
 extern const char kEnableSandboxLogging[];
 extern const char kEnableSeccompSandbox[];
@@ -166,6 +168,7 @@ extern const char kShowFPSCounter[];
 extern const char kShowPaintRects[];
 CONTENT_EXPORT extern const char kSingleProcess[];
 CONTENT_EXPORT extern const char kSkipGpuDataLoading[];
+CONTENT_EXPORT extern const char kSpareRendererProcesses[];
 CONTENT_EXPORT extern const char kTestSandbox[];
 extern const char kTraceStartup[];
 extern const char kTraceStartupFile[];
@@ -194,6 +197,7 @@ extern const char kScrollPixels[];
 extern const char kUseSystemSSL[];
 #endif
 
+extern const char kDisablePerTilePainting[];
 extern const char kEnablePerTilePainting[];
 
 #if defined(USE_AURA)
@@ -0,0 +1,208 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/renderer/dom_storage_dispatcher.h"
+
+#include <map>
+
+#include "base/string_number_conversions.h"
+#include "content/common/dom_storage_messages.h"
+#include "webkit/dom_storage/dom_storage_cached_area.h"
+#include "webkit/dom_storage/dom_storage_proxy.h"
+#include "webkit/dom_storage/dom_storage_types.h"
+
+using dom_storage::DomStorageCachedArea;
+using dom_storage::DomStorageProxy;
+using dom_storage::ValuesMap;
+
+// ProxyImpl -----------------------------------------------------
+// An implementation of the DomStorageProxy interface in terms of IPC.
+// This class also manages the collection of cached areas and pending
+// operations awaiting completion callbacks.
+class DomStorageDispatcher::ProxyImpl : public DomStorageProxy {
+ public:
+  explicit ProxyImpl(IPC::Message::Sender* sender);
+
+  // Methods for use by DomStorageDispatcher directly.
+  DomStorageCachedArea* OpenCachedArea(int64 namespace_id,
+                                       const GURL& origin);
+  void CloseCachedArea(DomStorageCachedArea* area);
+  DomStorageCachedArea* LookupCachedArea(int64 namespace_id,
+                                         const GURL& origin);
+  void CompleteOperation(int operation_id, bool success);
+
+  // DomStorageProxy interface for use by DomStorageCachedArea.
+  virtual void LoadArea(int connection_id, ValuesMap* values) OVERRIDE;
+  virtual void SetItem(int connection_id, const string16& key,
+                       const string16& value, const GURL& page_url,
+                       const CompletionCallback& callback) OVERRIDE;
+  virtual void RemoveItem(int connection_id, const string16& key,
+                          const GURL& page_url,
+                          const CompletionCallback& callback) OVERRIDE;
+  virtual void ClearArea(int connection_id,
+                         const GURL& page_url,
+                         const CompletionCallback& callback) OVERRIDE;
+
+ private:
+  // Struct to hold references to our contained areas and
+  // to keep track of how many connections have a given area open.
+  struct CachedAreaHolder {
+    scoped_refptr<DomStorageCachedArea> area_;
+    int open_count_;
+    CachedAreaHolder() : open_count_(0) {}
+    CachedAreaHolder(DomStorageCachedArea* area, int count)
+        : area_(area), open_count_(count) {}
+  };
+  typedef std::map<std::string, CachedAreaHolder> CachedAreaMap;
+  typedef std::map<int, CompletionCallback> CallbackMap;
+
+  virtual ~ProxyImpl() {
+  }
+
+  static std::string GetCachedAreaKey(int64 namespace_id, const GURL& origin) {
+    return base::Int64ToString(namespace_id) + origin.spec();
+  }
+
+  CachedAreaHolder* GetAreaHolder(const std::string& key) {
+    CachedAreaMap::iterator found = cached_areas_.find(key);
+    if (found == cached_areas_.end())
+      return NULL;
+    return &(found->second);
+  }
+
+  // Returns the id to send along with the operation.
+  int PushPendingCallback(const CompletionCallback& callback) {
+    int operation_id = next_operation_id_++;
+    pending_callbacks_[operation_id] = callback;
+    return operation_id;
+  }
+
+  IPC::Message::Sender* sender_;
+  CachedAreaMap cached_areas_;
+  CallbackMap pending_callbacks_;
+  int next_operation_id_;
+};
+
+DomStorageDispatcher::ProxyImpl::ProxyImpl(IPC::Message::Sender* sender)
+    : sender_(sender),
+      next_operation_id_(1) {
+}
+
+DomStorageCachedArea* DomStorageDispatcher::ProxyImpl::OpenCachedArea(
+    int64 namespace_id, const GURL& origin) {
+  std::string key = GetCachedAreaKey(namespace_id, origin);
+  if (CachedAreaHolder* holder = GetAreaHolder(key)) {
+    ++(holder->open_count_);
+    return holder->area_;
+  }
+  scoped_refptr<DomStorageCachedArea> area =
+      new DomStorageCachedArea(namespace_id, origin, this);
+  cached_areas_[key] = CachedAreaHolder(area, 1);
+  return area.get();
+}
+
+void DomStorageDispatcher::ProxyImpl::CloseCachedArea(
+    DomStorageCachedArea* area) {
+  std::string key = GetCachedAreaKey(area->namespace_id(), area->origin());
+  CachedAreaHolder* holder = GetAreaHolder(key);
+  DCHECK(holder);
+  DCHECK_EQ(holder->area_.get(), area);
+  DCHECK_GT(holder->open_count_, 0);
+  if (--(holder->open_count_) == 0)
+    cached_areas_.erase(key);
+}
+
+DomStorageCachedArea* DomStorageDispatcher::ProxyImpl::LookupCachedArea(
+    int64 namespace_id, const GURL& origin) {
+  std::string key = GetCachedAreaKey(namespace_id, origin);
+  CachedAreaHolder* holder = GetAreaHolder(key);
+  if (!holder)
+    return NULL;
+  return holder->area_;
+}
+
+void DomStorageDispatcher::ProxyImpl::CompleteOperation(
+    int operation_id, bool success) {
+  CallbackMap::iterator found = pending_callbacks_.find(operation_id);
+  if (found == pending_callbacks_.end()) {
+    NOTREACHED();
+    return;
+  }
+  CompletionCallback callback = found->second;
+  pending_callbacks_.erase(found);
+  callback.Run(success);
+}
+
+void DomStorageDispatcher::ProxyImpl::LoadArea(
+    int connection_id, ValuesMap* values) {
+  sender_->Send(new DOMStorageHostMsg_LoadStorageArea(connection_id, values));
+}
+
+void DomStorageDispatcher::ProxyImpl::SetItem(
+    int connection_id, const string16& key,
+    const string16& value, const GURL& page_url,
+    const CompletionCallback& callback) {
+  sender_->Send(new DOMStorageHostMsg_SetItemAsync(
+      connection_id, PushPendingCallback(callback), key, value, page_url));
+}
+
+void DomStorageDispatcher::ProxyImpl::RemoveItem(
+    int connection_id, const string16& key, const GURL& page_url,
+    const CompletionCallback& callback) {
+  sender_->Send(new DOMStorageHostMsg_RemoveItemAsync(
+      connection_id, PushPendingCallback(callback), key, page_url));
+}
+
+void DomStorageDispatcher::ProxyImpl::ClearArea(
+    int connection_id, const GURL& page_url,
+    const CompletionCallback& callback) {
+  sender_->Send(new DOMStorageHostMsg_ClearAsync(
+      connection_id, PushPendingCallback(callback), page_url));
+}
+
+// DomStorageDispatcher ------------------------------------------------
+
+DomStorageDispatcher::DomStorageDispatcher(IPC::Message::Sender* sender)
+    : sender_(sender),
+      proxy_(new ProxyImpl(sender)) {
+}
+
+DomStorageDispatcher::~DomStorageDispatcher() {
+}
+
+scoped_refptr<DomStorageCachedArea> DomStorageDispatcher::OpenCachedArea(
+    int connection_id, int64 namespace_id, const GURL& origin) {
+  sender_->Send(new DOMStorageHostMsg_OpenStorageArea(
+      connection_id, namespace_id, origin));
+  return proxy_->OpenCachedArea(namespace_id, origin);
+}
+
+void DomStorageDispatcher::CloseCachedArea(
+    int connection_id, DomStorageCachedArea* area) {
+  sender_->Send(new DOMStorageHostMsg_CloseStorageArea(connection_id));
+  proxy_->CloseCachedArea(area);
+}
+
+void DomStorageDispatcher::ApplyMutation(
+    const DOMStorageMsg_Event_Params& params) {
+  DomStorageCachedArea* cached_area = proxy_->LookupCachedArea(
+      params.namespace_id, params.origin);
+  if (cached_area)
+    cached_area->ApplyMutation(params.key, params.new_value);
+}
+
+bool DomStorageDispatcher::OnMessageReceived(const IPC::Message& msg) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(DomStorageDispatcher, msg)
+    IPC_MESSAGE_HANDLER(DOMStorageMsg_AsyncOperationComplete,
+                        OnAsyncOperationComplete)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void DomStorageDispatcher::OnAsyncOperationComplete(
+    int operation_id, bool success) {
+  proxy_->CompleteOperation(operation_id, success);
+}
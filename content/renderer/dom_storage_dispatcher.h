@@ -0,0 +1,56 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_RENDERER_DOM_STORAGE_DISPATCHER_H_
+#define CONTENT_RENDERER_DOM_STORAGE_DISPATCHER_H_
+#pragma once
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "ipc/ipc_message.h"
+
+class GURL;
+struct DOMStorageMsg_Event_Params;
+
+namespace dom_storage {
+class DomStorageCachedArea;
+}
+
+// Dispatches DomStorage related messages sent to a renderer process from the
+// main browser process and owns the process wide set of cached areas, so
+// that every frame showing an origin shares a single cache of its values.
+// There is one instance per renderer process, messages are dispatched on the
+// main renderer thread. The RenderThreadImpl creates an instance and
+// delegates calls to it.
+class DomStorageDispatcher {
+ public:
+  explicit DomStorageDispatcher(IPC::Message::Sender* sender);
+  ~DomStorageDispatcher();
+
+  // Opens a connection to the area and returns the cached area shared by
+  // all connections to it. Each call to open should be balanced with a
+  // call to close.
+  scoped_refptr<dom_storage::DomStorageCachedArea> OpenCachedArea(
+      int connection_id, int64 namespace_id, const GURL& origin);
+  void CloseCachedArea(int connection_id,
+                       dom_storage::DomStorageCachedArea* area);
+
+  // Applies a change broadcast by the browser to the matching cached area.
+  void ApplyMutation(const DOMStorageMsg_Event_Params& params);
+
+  bool OnMessageReceived(const IPC::Message& msg);
+
+ private:
+  class ProxyImpl;
+
+  // IPC message handlers
+  void OnAsyncOperationComplete(int operation_id, bool success);
+
+  IPC::Message::Sender* sender_;
+  scoped_refptr<ProxyImpl> proxy_;
+
+  DISALLOW_COPY_AND_ASSIGN(DomStorageDispatcher);
+};
+
+#endif  // CONTENT_RENDERER_DOM_STORAGE_DISPATCHER_H_
@@ -45,17 +45,42 @@ void P2PSocketClient::Init(
 
 void P2PSocketClient::Send(const net::IPEndPoint& address,
                            const std::vector<char>& data) {
-  if (!ipc_message_loop_->BelongsToCurrentThread()) {
+  {
+    base::AutoLock auto_lock(send_lock_);
+    pending_sends_.push_back(P2PPacket(address, data));
+    // A flush is already on its way to the IPC thread.
+    if (pending_sends_.size() > 1)
+      return;
+  }
+
+  if (ipc_message_loop_->BelongsToCurrentThread()) {
+    FlushSends();
+  } else {
     ipc_message_loop_->PostTask(
-        FROM_HERE, base::Bind(&P2PSocketClient::Send, this, address, data));
-    return;
+        FROM_HERE, base::Bind(&P2PSocketClient::FlushSends, this));
+  }
+}
+
+void P2PSocketClient::FlushSends() {
+  DCHECK(ipc_message_loop_->BelongsToCurrentThread());
+
+  std::vector<P2PPacket> packets;
+  {
+    base::AutoLock auto_lock(send_lock_);
+    packets.swap(pending_sends_);
   }
 
   // Can send data only when the socket is open.
   DCHECK(state_ == STATE_OPEN || state_ == STATE_ERROR);
-  if (state_ == STATE_OPEN) {
+  if (state_ != STATE_OPEN || packets.empty())
+    return;
+
+  if (packets.size() == 1) {
+    dispatcher_->SendP2PMessage(new P2PHostMsg_Send(
+        0, socket_id_, packets[0].address, packets[0].data));
+  } else {
     dispatcher_->SendP2PMessage(
-        new P2PHostMsg_Send(0, socket_id_, address, data));
+        new P2PHostMsg_SendBatch(0, socket_id_, packets));
   }
 }
 
@@ -151,6 +176,22 @@ void P2PSocketClient::DeliverOnDataReceived(const net::IPEndPoint& address,
     delegate_->OnDataReceived(address, data);
 }
 
+void P2PSocketClient::OnDataReceivedBatch(
+    const std::vector<P2PPacket>& packets) {
+  DCHECK(ipc_message_loop_->BelongsToCurrentThread());
+  DCHECK_EQ(STATE_OPEN, state_);
+  delegate_message_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&P2PSocketClient::DeliverOnDataReceivedBatch, this, packets));
+}
+
+void P2PSocketClient::DeliverOnDataReceivedBatch(
+    const std::vector<P2PPacket>& packets) {
+  // The delegate may close the socket while handling a packet.
+  for (size_t i = 0; i < packets.size() && delegate_; ++i)
+    delegate_->OnDataReceived(packets[i].address, packets[i].data);
+}
+
 void P2PSocketClient::Detach() {
   DCHECK(ipc_message_loop_->BelongsToCurrentThread());
   dispatcher_ = NULL;
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
 #include "content/common/p2p_sockets.h"
 #include "net/base/ip_endpoint.h"
 
@@ -50,7 +51,8 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
             const net::IPEndPoint& remote_address,
             Delegate* delegate);
 
-  // Send the |data| to the |address|.
+  // Send the |data| to the |address|. Packets sent while the IPC thread is
+  // busy are passed to the browser together.
   void Send(const net::IPEndPoint& address, const std::vector<char>& data);
 
   // Must be called before the socket is destroyed. The delegate may
@@ -83,6 +85,10 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   void OnError();
   void OnDataReceived(const net::IPEndPoint& address,
                       const std::vector<char>& data);
+  void OnDataReceivedBatch(const std::vector<P2PPacket>& packets);
+
+  // Sends the packets queued by Send() on the IPC thread.
+  void FlushSends();
 
   // Proxy methods that deliver messages to the delegate thread.
   void DeliverOnSocketCreated(const net::IPEndPoint& address);
@@ -92,6 +98,7 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   void DeliverOnError();
   void DeliverOnDataReceived(const net::IPEndPoint& address,
                              const std::vector<char>& data);
+  void DeliverOnDataReceivedBatch(const std::vector<P2PPacket>& packets);
 
   // Scheduled on the IPC thread to finish closing the connection.
   void DoClose();
@@ -106,6 +113,11 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   Delegate* delegate_;
   State state_;
 
+  // Packets passed to Send() and not yet handed to the dispatcher. Send()
+  // runs on the delegate thread, so this is guarded by |send_lock_|.
+  base::Lock send_lock_;
+  std::vector<P2PPacket> pending_sends_;
+
   DISALLOW_COPY_AND_ASSIGN(P2PSocketClient);
 };
 
@@ -91,6 +91,7 @@ bool P2PSocketDispatcher::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(P2PMsg_OnIncomingTcpConnection, OnIncomingTcpConnection)
     IPC_MESSAGE_HANDLER(P2PMsg_OnError, OnError)
     IPC_MESSAGE_HANDLER(P2PMsg_OnDataReceived, OnDataReceived)
+    IPC_MESSAGE_HANDLER(P2PMsg_OnDataReceivedBatch, OnDataReceivedBatch)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -172,6 +173,14 @@ void P2PSocketDispatcher::OnDataReceived(
   }
 }
 
+void P2PSocketDispatcher::OnDataReceivedBatch(
+    int socket_id, const std::vector<P2PPacket>& packets) {
+  P2PSocketClient* client = GetClient(socket_id);
+  if (client) {
+    client->OnDataReceivedBatch(packets);
+  }
+}
+
 P2PSocketClient* P2PSocketDispatcher::GetClient(int socket_id) {
   P2PSocketClient* client = clients_.Lookup(socket_id);
   if (client == NULL) {
@@ -97,6 +97,8 @@ class CONTENT_EXPORT P2PSocketDispatcher : public content::RenderViewObserver {
   void OnError(int socket_id);
   void OnDataReceived(int socket_id, const net::IPEndPoint& address,
                       const std::vector<char>& data);
+  void OnDataReceivedBatch(int socket_id,
+                           const std::vector<P2PPacket>& packets);
 
   P2PSocketClient* GetClient(int socket_id);
 
@@ -34,6 +34,15 @@
 #include "base/mac/mac_util.h"
 #endif
 
+namespace {
+
+// Transport DIBs are allocated in multiples of this size (256 kilobytes), so
+// that paints of slightly different sizes, such as the frames of a scrolling
+// page, can reuse the same cached DIB.
+const size_t kTransportDIBSizeGranularity = 256 * 1024;
+
+}  // namespace
+
 RenderProcessImpl::RenderProcessImpl()
     : ALLOW_THIS_IN_INITIALIZER_LIST(shared_mem_cache_cleaner_(
           FROM_HERE, base::TimeDelta::FromSeconds(5),
@@ -165,7 +174,12 @@ skia::PlatformCanvas* RenderProcessImpl::GetDrawingCanvas(
   const size_t size = height * stride;
 
   if (!GetTransportDIBFromCache(memory, size)) {
-    *memory = CreateTransportDIB(size);
+    size_t allocation_size =
+        (size + kTransportDIBSizeGranularity - 1) /
+        kTransportDIBSizeGranularity * kTransportDIBSizeGranularity;
+    if (max_size != 0 && allocation_size > max_size)
+      allocation_size = size;
+    *memory = CreateTransportDIB(allocation_size);
     if (!*memory)
       return NULL;
   }
@@ -188,17 +202,24 @@ bool RenderProcessImpl::UseInProcessPlugins() const {
 
 bool RenderProcessImpl::GetTransportDIBFromCache(TransportDIB** mem,
                                              size_t size) {
-  // look for a cached object that is suitable for the requested size.
+  // Look for the smallest cached object that is suitable for the requested
+  // size, so that the larger ones stay available for larger paints.
+  int best_index = -1;
   for (size_t i = 0; i < arraysize(shared_mem_cache_); ++i) {
     if (shared_mem_cache_[i] &&
-        size <= shared_mem_cache_[i]->size()) {
-      *mem = shared_mem_cache_[i];
-      shared_mem_cache_[i] = NULL;
-      return true;
+        size <= shared_mem_cache_[i]->size() &&
+        (best_index == -1 ||
+         shared_mem_cache_[i]->size() <
+             shared_mem_cache_[best_index]->size())) {
+      best_index = i;
     }
   }
+  if (best_index == -1)
+    return false;
 
-  return false;
+  *mem = shared_mem_cache_[best_index];
+  shared_mem_cache_[best_index] = NULL;
+  return true;
 }
 
 int RenderProcessImpl::FindFreeCacheSlot(size_t size) {
@@ -213,7 +234,7 @@ int RenderProcessImpl::FindFreeCacheSlot(size_t size) {
   size_t smallest_size = size;
   int smallest_index = -1;
 
-  for (size_t i = 1; i < arraysize(shared_mem_cache_); ++i) {
+  for (size_t i = 0; i < arraysize(shared_mem_cache_); ++i) {
     const size_t entry_size = shared_mem_cache_[i]->size();
     if (entry_size < smallest_size) {
       smallest_size = entry_size;
@@ -61,7 +61,9 @@ class RenderProcessImpl : public RenderProcess {
 
   // A very simplistic and small cache.  If an entry in this array is non-null,
   // then it points to a SharedMemory object that is available for reuse.
-  TransportDIB* shared_mem_cache_[2];
+  // There is room for a DIB per frame in flight while scrolling, plus one for
+  // a smaller paint.
+  TransportDIB* shared_mem_cache_[3];
 
   // This DelayTimer cleans up our cache 5 seconds after the last use.
   base::DelayTimer<RenderProcessImpl> shared_mem_cache_cleaner_;
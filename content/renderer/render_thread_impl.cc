@@ -15,9 +15,11 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/metrics/field_trial.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/stats_table.h"
 #include "base/path_service.h"
+#include "base/process_util.h"
 #include "base/shared_memory.h"
 #include "base/string_number_conversions.h"  // Temporary
 #include "base/threading/thread_local.h"
@@ -47,6 +49,7 @@
 #include "content/public/renderer/render_process_observer.h"
 #include "content/public/renderer/render_view_visitor.h"
 #include "content/renderer/devtools_agent_filter.h"
+#include "content/renderer/dom_storage_dispatcher.h"
 #include "content/renderer/gpu/compositor_thread.h"
 #include "content/renderer/media/audio_input_message_filter.h"
 #include "content/renderer/media/audio_message_filter.h"
@@ -65,10 +68,12 @@
 #include "media/base/media.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_util.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/WebCache.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebColorName.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebCompositor.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebDatabase.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebDocument.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/WebFontCache.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebFrame.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebKit.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebNetworkStateNotifier.h"
@@ -210,6 +215,7 @@ void RenderThreadImpl::Init() {
   compositor_initialized_ = false;
 
   appcache_dispatcher_.reset(new AppCacheDispatcher(Get()));
+  dom_storage_dispatcher_.reset(new DomStorageDispatcher(Get()));
   main_thread_indexed_db_dispatcher_.reset(new IndexedDBDispatcher());
 
   media_stream_center_ = NULL;
@@ -808,6 +814,9 @@ void RenderThreadImpl::OnSetZoomLevelForCurrentURL(const std::string& host,
 
 void RenderThreadImpl::OnDOMStorageEvent(
     const DOMStorageMsg_Event_Params& params) {
+  // Bring the renderer-side cache up to date before script sees the event.
+  dom_storage_dispatcher_->ApplyMutation(params);
+
   EnsureWebKitInitialized();
 
   bool originated_in_process = params.connection_id != 0;
@@ -855,6 +864,8 @@ bool RenderThreadImpl::OnControlMessageReceived(const IPC::Message& msg) {
   // Some messages are handled by delegates.
   if (appcache_dispatcher_->OnMessageReceived(msg))
     return true;
+  if (dom_storage_dispatcher_->OnMessageReceived(msg))
+    return true;
 
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(RenderThreadImpl, msg)
@@ -866,6 +877,8 @@ bool RenderThreadImpl::OnControlMessageReceived(const IPC::Message& msg) {
     IPC_MESSAGE_HANDLER(ViewMsg_New, OnCreateNewView)
     IPC_MESSAGE_HANDLER(ViewMsg_PurgePluginListCache, OnPurgePluginListCache)
     IPC_MESSAGE_HANDLER(ViewMsg_NetworkStateChanged, OnNetworkStateChanged)
+    IPC_MESSAGE_HANDLER(ViewMsg_WarmUp, OnWarmUp)
+    IPC_MESSAGE_HANDLER(ViewMsg_ReclaimMemory, OnReclaimMemory)
     IPC_MESSAGE_HANDLER(DOMStorageMsg_Event, OnDOMStorageEvent)
     IPC_MESSAGE_HANDLER(ViewMsg_TempCrashWithData, OnTempCrashWithData)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -996,6 +1009,50 @@ void RenderThreadImpl::OnNetworkStateChanged(bool online) {
   WebNetworkStateNotifier::setOnLine(online);
 }
 
+void RenderThreadImpl::OnWarmUp() {
+  EnsureWebKitInitialized();
+}
+
+void RenderThreadImpl::OnReclaimMemory() {
+  // Nothing to give back if WebKit never started.
+  if (!webkit_platform_support_.get())
+    return;
+  TRACE_EVENT0("renderer", "RenderThreadImpl::OnReclaimMemory");
+
+  // The sandbox can keep a renderer from reading its own memory usage, in
+  // which case the sizes come back as 0.
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+  size_t resident_before = metrics->GetWorkingSetSize();
+
+  // Let the embedder's caches shrink too.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+
+  // Every page of this process is hidden, so the decoded images and glyphs
+  // in these caches would most likely be evicted before they are used again.
+  WebKit::WebCache::clear();
+  WebKit::WebFontCache::clear();
+
+  // Full garbage collection, compacting the heap, then hand the pages that
+  // freed up back to the system.
+  v8::V8::LowMemoryNotification();
+  base::allocator::ReleaseFreeMemory();
+
+  size_t resident_after = metrics->GetWorkingSetSize();
+  if (resident_before && resident_after) {
+    UMA_HISTOGRAM_MEMORY_KB("Memory.Renderer.BackgroundReclaimBefore",
+                            resident_before / 1024);
+    UMA_HISTOGRAM_MEMORY_KB("Memory.Renderer.BackgroundReclaimAfter",
+                            resident_after / 1024);
+    UMA_HISTOGRAM_MEMORY_KB(
+        "Memory.Renderer.BackgroundReclaimed",
+        resident_before > resident_after ?
+            (resident_before - resident_after) / 1024 : 0);
+  }
+}
+
 void RenderThreadImpl::OnTempCrashWithData(const GURL& data) {
   content::GetContentClient()->SetActiveURL(data);
   CHECK(false);
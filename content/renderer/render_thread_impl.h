@@ -30,6 +30,7 @@ class AudioMessageFilter;
 class CompositorThread;
 class DBMessageFilter;
 class DevToolsAgentFilter;
+class DomStorageDispatcher;
 struct DOMStorageMsg_Event_Params;
 class GpuChannelHost;
 class IndexedDBDispatcher;
@@ -167,6 +168,10 @@ class CONTENT_EXPORT RenderThreadImpl : public content::RenderThread,
     return appcache_dispatcher_.get();
   }
 
+  DomStorageDispatcher* dom_storage_dispatcher() const {
+    return dom_storage_dispatcher_.get();
+  }
+
   AudioInputMessageFilter* audio_input_message_filter() {
     return audio_input_message_filter_.get();
   }
@@ -212,6 +217,8 @@ class CONTENT_EXPORT RenderThreadImpl : public content::RenderThread,
   void OnTransferBitmap(const SkBitmap& bitmap, int resource_id);
   void OnPurgePluginListCache(bool reload_pages);
   void OnNetworkStateChanged(bool online);
+  void OnWarmUp();
+  void OnReclaimMemory();
   void OnGetAccessibilityTree();
   void OnTempCrashWithData(const GURL& data);
 
@@ -219,6 +226,7 @@ class CONTENT_EXPORT RenderThreadImpl : public content::RenderThread,
 
   // These objects live solely on the render thread.
   scoped_ptr<AppCacheDispatcher> appcache_dispatcher_;
+  scoped_ptr<DomStorageDispatcher> dom_storage_dispatcher_;
   scoped_ptr<IndexedDBDispatcher> main_thread_indexed_db_dispatcher_;
   scoped_ptr<RendererWebKitPlatformSupportImpl> webkit_platform_support_;
 
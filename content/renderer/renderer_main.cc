@@ -137,11 +137,11 @@ class RendererMessageLoopObserver : public MessageLoop::TaskObserver {
             1, 3600000, 50, base::Histogram::kUmaTargetedHistogramFlag)) {}
   virtual ~RendererMessageLoopObserver() {}
 
-  virtual void WillProcessTask(base::TimeTicks time_posted) {
+  virtual void WillProcessTask(const base::PendingTask& pending_task) {
     begin_process_message_ = base::TimeTicks::Now();
   }
 
-  virtual void DidProcessTask(base::TimeTicks time_posted) {
+  virtual void DidProcessTask(const base::PendingTask& pending_task) {
     if (!begin_process_message_.is_null())
       process_times_->AddTime(base::TimeTicks::Now() - begin_process_message_);
   }
@@ -5,14 +5,13 @@
 #include "content/renderer/renderer_webstoragearea_impl.h"
 
 #include "base/lazy_instance.h"
-#include "base/metrics/histogram.h"
-#include "base/time.h"
 #include "base/utf_string_conversions.h"
-#include "content/common/dom_storage_messages.h"
+#include "content/renderer/dom_storage_dispatcher.h"
 #include "content/renderer/render_thread_impl.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebURL.h"
-#include "webkit/dom_storage/dom_storage_types.h"
+#include "webkit/dom_storage/dom_storage_cached_area.h"
 
+using dom_storage::DomStorageCachedArea;
 using WebKit::WebString;
 using WebKit::WebURL;
 
@@ -34,15 +33,13 @@ RendererWebStorageAreaImpl::RendererWebStorageAreaImpl(
   // TODO(michaeln): fix the webkit api to have the 'origin' input
   // be a URL instead of a string.
   DCHECK(connection_id_);
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_OpenStorageArea(
-          connection_id_, namespace_id, GURL(origin)));
+  cached_area_ = dispatcher()->OpenCachedArea(
+      connection_id_, namespace_id, GURL(origin));
 }
 
 RendererWebStorageAreaImpl::~RendererWebStorageAreaImpl() {
   g_all_areas_map.Pointer()->Remove(connection_id_);
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_CloseStorageArea(connection_id_));
+  dispatcher()->CloseCachedArea(connection_id_, cached_area_);
 }
 
 // In November 2011 stats were recorded about performance of each of the
@@ -58,51 +55,45 @@ RendererWebStorageAreaImpl::~RendererWebStorageAreaImpl() {
 // length       .017     0.6     2.0     12.0
 // key          .591     0.6     2.0     29.9
 // clear        1e-6     1.0     32.4    605.2
+//
+// Each of those used to be a sync IPC. All operations are now served from
+// the renderer-side cache, which is primed with a single sync IPC on first
+// access, and mutations are forwarded to the browser asynchronously.
 
 unsigned RendererWebStorageAreaImpl::length() {
-  unsigned length;
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_Length(connection_id_, &length));
-  return length;
+  return cached_area_->GetLength(connection_id_);
 }
 
 WebString RendererWebStorageAreaImpl::key(unsigned index) {
-  NullableString16 key;
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_Key(connection_id_, index, &key));
-  return key;
+  return cached_area_->GetKey(connection_id_, index);
 }
 
 WebString RendererWebStorageAreaImpl::getItem(const WebString& key) {
-  NullableString16 value;
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_GetItem(connection_id_, key, &value));
-  return value;
+  return cached_area_->GetItem(connection_id_, key);
 }
 
 void RendererWebStorageAreaImpl::setItem(
     const WebString& key, const WebString& value, const WebURL& url,
     WebStorageArea::Result& result, WebString& old_value_webkit) {
-  if (key.length() + value.length() > dom_storage::kPerAreaQuota) {
+  old_value_webkit = cached_area_->GetItem(connection_id_, key);
+  if (cached_area_->SetItem(connection_id_, key, value, url))
+    result = ResultOK;
+  else
     result = ResultBlockedByQuota;
-    return;
-  }
-  NullableString16 old_value;
-  RenderThreadImpl::current()->Send(new DOMStorageHostMsg_SetItem(
-      connection_id_, key, value, url, &result, &old_value));
-  old_value_webkit = old_value;
 }
 
 void RendererWebStorageAreaImpl::removeItem(
     const WebString& key, const WebURL& url, WebString& old_value_webkit) {
-  NullableString16 old_value;
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_RemoveItem(connection_id_, key, url, &old_value));
-  old_value_webkit = old_value;
+  old_value_webkit = cached_area_->GetItem(connection_id_, key);
+  cached_area_->RemoveItem(connection_id_, key, url);
 }
 
 void RendererWebStorageAreaImpl::clear(
     const WebURL& url, bool& cleared_something) {
-  RenderThreadImpl::current()->Send(
-      new DOMStorageHostMsg_Clear(connection_id_, url, &cleared_something));
+  cleared_something = cached_area_->GetLength(connection_id_) != 0;
+  cached_area_->Clear(connection_id_, url);
+}
+
+DomStorageDispatcher* RendererWebStorageAreaImpl::dispatcher() {
+  return RenderThreadImpl::current()->dom_storage_dispatcher();
 }
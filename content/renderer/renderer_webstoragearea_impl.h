@@ -7,9 +7,16 @@
 #pragma once
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebStorageArea.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebString.h"
 
+class DomStorageDispatcher;
+
+namespace dom_storage {
+class DomStorageCachedArea;
+}
+
 class RendererWebStorageAreaImpl : public WebKit::WebStorageArea {
  public:
   static RendererWebStorageAreaImpl* FromConnectionId(int id);
@@ -32,7 +39,10 @@ class RendererWebStorageAreaImpl : public WebKit::WebStorageArea {
   virtual void clear(const WebKit::WebURL& url, bool& cleared_something);
 
  private:
+  static DomStorageDispatcher* dispatcher();
+
   int connection_id_;
+  scoped_refptr<dom_storage::DomStorageCachedArea> cached_area_;
 };
 
 #endif  // CONTENT_RENDERER_RENDERER_WEBSTORAGEAREA_IMPL_H_
@@ -123,3 +123,33 @@ TEST_F(BSDiffMemoryTest, TestDifferentElfs) {
   std::string file2 = FileContents("elf-32-2");
   GenerateAndTestPatch(file1, file2);
 }
+
+TEST_F(BSDiffMemoryTest, TestOldInTwoPieces) {
+  std::string old_text = GenerateSyntheticInput(10000, 0);
+  std::string new_text = old_text.substr(5000) + GenerateSyntheticInput(300, 1)
+      + old_text.substr(0, 5000);
+
+  courgette::SourceStream old1;
+  courgette::SourceStream new1;
+  old1.Init(old_text.c_str(), old_text.length());
+  new1.Init(new_text.c_str(), new_text.length());
+  courgette::SinkStream patch1;
+  EXPECT_EQ(courgette::OK, CreateBinaryPatch(&old1, &new1, &patch1));
+
+  // Splitting the old text anywhere, including at either end, must give the
+  // same result as applying the patch to it whole.
+  const size_t kSplits[] = { 0, 1, 4999, 5000, 9999, 10000 };
+  for (size_t i = 0; i < arraysize(kSplits); ++i) {
+    courgette::SourceStream head;
+    courgette::SourceStream tail;
+    courgette::SourceStream patch2;
+    head.Init(old_text.c_str(), kSplits[i]);
+    tail.Init(old_text.c_str() + kSplits[i], old_text.length() - kSplits[i]);
+    patch2.Init(patch1.Buffer(), patch1.Length());
+
+    courgette::SinkStream new2;
+    EXPECT_EQ(courgette::OK, ApplyBinaryPatch(&head, &tail, &patch2, &new2));
+    ASSERT_EQ(new_text.length(), new2.Length());
+    EXPECT_EQ(0, memcmp(new_text.c_str(), new2.Buffer(), new_text.length()));
+  }
+}
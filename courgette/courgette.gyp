@@ -39,6 +39,8 @@
       'simple_delta.h',
       'streams.cc',
       'streams.h',
+      'suffix_array.cc',
+      'suffix_array.h',
       'types_elf.h',
       'types_win_pe.h',
       'patch_generator_x86_32.h',
@@ -100,6 +102,7 @@
         'ensemble_unittest.cc',
         'run_all_unittests.cc',
         'streams_unittest.cc',
+        'suffix_array_unittest.cc',
         'versioning_unittest.cc',
         'third_party/paged_array_unittest.cc'
       ],
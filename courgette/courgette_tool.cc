@@ -10,9 +10,13 @@
 #include "base/command_line.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
+#include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process_util.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "courgette/third_party/bsdiff.h"
 #include "courgette/courgette.h"
@@ -70,6 +74,23 @@ void WriteSinkToFile(const courgette::SinkStream *sink,
     Problem("Incomplete write.");
 }
 
+// Prints how long generating or applying a patch took and the peak memory of
+// the process, so runs can be compared across builds of this tool. Run with
+// --v=1 for the time spent on each element.
+void ReportStats(const char* name, base::TimeTicks start_time) {
+  scoped_ptr<base::ProcessMetrics> metrics(
+#if defined(OS_MACOSX)
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle(), NULL));
+#else
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+#endif
+  fprintf(stderr, "%s: %.2fs, peak working set %" PRIuS " KB\n", name,
+          (base::TimeTicks::Now() - start_time).InSecondsF(),
+          metrics->GetPeakWorkingSetSize() / 1024);
+}
+
 void Disassemble(const FilePath& input_file,
                  const FilePath& output_file) {
   std::string buffer = ReadOrFail(input_file, "input");
@@ -308,12 +329,15 @@ void GenerateEnsemblePatch(const FilePath& old_file,
   old_stream.Init(old_buffer);
   new_stream.Init(new_buffer);
 
+  base::TimeTicks start_time = base::TimeTicks::Now();
   courgette::SinkStream patch_stream;
   courgette::Status status =
       courgette::GenerateEnsemblePatch(&old_stream, &new_stream, &patch_stream);
 
   if (status != courgette::C_OK) Problem("-gen failed.");
 
+  ReportStats("ensemble", start_time);
+
   WriteSinkToFile(&patch_stream, patch_file);
 }
 
@@ -324,13 +348,16 @@ void ApplyEnsemblePatch(const FilePath& old_file,
   // entry point as the installer.  That entry point point takes file names and
   // returns an status code but does not output any diagnostics.
 
+  base::TimeTicks start_time = base::TimeTicks::Now();
   courgette::Status status =
       courgette::ApplyEnsemblePatch(old_file.value().c_str(),
                                     patch_file.value().c_str(),
                                     new_file.value().c_str());
 
-  if (status == courgette::C_OK)
+  if (status == courgette::C_OK) {
+    ReportStats("apply", start_time);
     return;
+  }
 
   // Diagnose the error.
   switch (status) {
@@ -377,20 +404,29 @@ void ApplyEnsemblePatch(const FilePath& old_file,
 void GenerateBSDiffPatch(const FilePath& old_file,
                          const FilePath& new_file,
                          const FilePath& patch_file) {
-  std::string old_buffer = ReadOrFail(old_file, "'old' input");
-  std::string new_buffer = ReadOrFail(new_file, "'new' input");
+  // Map the inputs rather than copying them; for large binaries the copies
+  // would add to the peak memory reported below.
+  file_util::MemoryMappedFile old_mapped;
+  file_util::MemoryMappedFile new_mapped;
+  if (!old_mapped.Initialize(old_file))
+    Problem("Can't read 'old' input file.");
+  if (!new_mapped.Initialize(new_file))
+    Problem("Can't read 'new' input file.");
 
   courgette::SourceStream old_stream;
   courgette::SourceStream new_stream;
-  old_stream.Init(old_buffer);
-  new_stream.Init(new_buffer);
+  old_stream.Init(old_mapped.data(), old_mapped.length());
+  new_stream.Init(new_mapped.data(), new_mapped.length());
 
+  base::TimeTicks start_time = base::TimeTicks::Now();
   courgette::SinkStream patch_stream;
   courgette::BSDiffStatus status =
       courgette::CreateBinaryPatch(&old_stream, &new_stream, &patch_stream);
 
   if (status != courgette::OK) Problem("-genbsdiff failed.");
 
+  ReportStats("bsdiff", start_time);
+
   WriteSinkToFile(&patch_stream, patch_file);
 }
 
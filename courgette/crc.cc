@@ -31,4 +31,19 @@ uint32 CalculateCrc(const uint8* buffer, size_t size) {
   return ~crc;
 }
 
+uint32 CalculateCrc(const uint8* buffer1, size_t size1,
+                    const uint8* buffer2, size_t size2) {
+  uint32 crc;
+
+#ifdef COURGETTE_USE_CRC_LIB
+  crc = crc32(crc32(0, buffer1, size1), buffer2, size2);
+#else
+  CrcGenerateTable();
+  crc = CRC_GET_DIGEST(
+      CrcUpdate(CrcUpdate(CRC_INIT_VAL, buffer1, size1), buffer2, size2));
+#endif
+
+  return ~crc;
+}
+
 }  // namespace
@@ -13,5 +13,9 @@ namespace courgette {
 //
 uint32 CalculateCrc(const uint8* buffer, size_t size);
 
+// Calculates the same Crc as above for |buffer1| followed by |buffer2|.
+uint32 CalculateCrc(const uint8* buffer1, size_t size1,
+                    const uint8* buffer2, size_t size2);
+
 }  // namespace courgette
 #endif  // COURGETTE_CRC_H_
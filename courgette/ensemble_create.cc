@@ -14,11 +14,16 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
 #include <vector>
 #include <limits>
 
 #include "base/basictypes.h"
+#include "base/compiler_specific.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/time.h"
 
 #include "courgette/third_party/bsdiff.h"
@@ -33,6 +38,67 @@
 
 namespace courgette {
 
+namespace {
+
+// Upper bound on the number of elements transformed at once. Each transform
+// holds the disassembled old and new programs, so this also bounds the extra
+// memory used by running them in parallel.
+const int kMaxParallelTransforms = 4;
+
+// Runs the Transform step for one element, which disassembles, adjusts and
+// encodes it. Transforms of different elements are independent, so several
+// of these run at once on a thread pool.
+class TransformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  TransformTask(TransformationPatchGenerator* generator, size_t index)
+      : generator_(generator),
+        index_(index),
+        status_(C_OK) {
+  }
+
+  // Overridden from base::DelegateSimpleThread::Delegate:
+  virtual void Run() OVERRIDE {
+    base::Time start_time = base::Time::Now();
+    status_ = generator_->Transform(&parameters_, &predicted_, &corrected_);
+    VLOG(1) << "done Transform element " << index_ << " in "
+            << (base::Time::Now() - start_time).InSecondsF() << "s";
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* predicted() { return &predicted_; }
+  SinkStreamSet* corrected() { return &corrected_; }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  size_t index_;
+  SourceStreamSet parameters_;
+  SinkStreamSet predicted_;
+  SinkStreamSet corrected_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformTask);
+};
+
+// Runs |tasks|, in parallel when there is more than one.
+void RunTransformTasks(ScopedVector<TransformTask>* tasks) {
+  int thread_count = std::min(static_cast<int>(tasks->size()),
+                              base::SysInfo::NumberOfProcessors());
+  if (thread_count <= 1) {
+    for (size_t i = 0; i < tasks->size(); ++i)
+      (*tasks)[i]->Run();
+    return;
+  }
+
+  base::DelegateSimpleThreadPool pool("CourgetteTransform", thread_count);
+  for (size_t i = 0; i < tasks->size(); ++i)
+    pool.AddWork((*tasks)[i]);
+  pool.Start();
+  pool.JoinAll();
+}
+
+}  // namespace
+
 TransformationPatchGenerator::TransformationPatchGenerator(
     Element* old_element,
     Element* new_element,
@@ -317,27 +383,37 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
-  for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
-      return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
-      return C_STREAM_NOT_CONSUMED;
-    if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
-      return C_STREAM_ERROR;
-    if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
-      return C_STREAM_ERROR;
+  // Transform the elements in batches, appending each batch's output in
+  // element order before starting the next so that only one batch of
+  // per-element streams is alive at a time.
+  base::Time start_transform_time = base::Time::Now();
+  for (size_t batch_start = 0;  batch_start < number_of_transformations;
+       batch_start += kMaxParallelTransforms) {
+    size_t batch_end = std::min(number_of_transformations,
+                                batch_start + kMaxParallelTransforms);
+    ScopedVector<TransformTask> tasks;
+    for (size_t i = batch_start;  i < batch_end;  ++i) {
+      TransformTask* task = new TransformTask(generators[i], i);
+      tasks.push_back(task);
+      if (!corrected_parameters_source_set.ReadSet(task->parameters()))
+        return C_STREAM_ERROR;
+    }
+
+    RunTransformTasks(&tasks);
+
+    for (size_t i = 0;  i < tasks.size();  ++i) {
+      if (tasks[i]->status() != C_OK)
+        return tasks[i]->status();
+      if (!tasks[i]->parameters()->Empty())
+        return C_STREAM_NOT_CONSUMED;
+      if (!predicted_transformed_elements.WriteSet(tasks[i]->predicted()))
+        return C_STREAM_ERROR;
+      if (!corrected_transformed_elements.WriteSet(tasks[i]->corrected()))
+        return C_STREAM_ERROR;
+    }
   }
+  VLOG(1) << "done Transform " << number_of_transformations << " elements in "
+          << (base::Time::Now() - start_transform_time).InSecondsF() << "s";
 
   if (!corrected_parameters_source_set.Empty())
     return C_STREAM_NOT_CONSUMED;
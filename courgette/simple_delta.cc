@@ -31,6 +31,12 @@ Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
   return BSDiffStatusToStatus(ApplyBinaryPatch(old, delta, target));
 }
 
+Status ApplySimpleDelta(SourceStream* old_head, SourceStream* old_tail,
+                        SourceStream* delta, SinkStream* target) {
+  return BSDiffStatusToStatus(
+      ApplyBinaryPatch(old_head, old_tail, delta, target));
+}
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta) {
   VLOG(1) << "GenerateSimpleDelta " << old->Remaining()
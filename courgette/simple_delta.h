@@ -15,6 +15,10 @@ namespace courgette {
 Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
                         SinkStream* target);
 
+// As above, where the old data is |old_head| followed by |old_tail|.
+Status ApplySimpleDelta(SourceStream* old_head, SourceStream* old_tail,
+                        SourceStream* delta, SinkStream* target);
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta);
 
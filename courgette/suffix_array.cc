@@ -0,0 +1,212 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/suffix_array.h"
+
+#include <vector>
+
+#include "base/logging.h"
+
+namespace courgette {
+
+namespace {
+
+// The input bytes followed by a sentinel that sorts before every byte. SA-IS
+// needs the sentinel; it is implied here rather than copying the input.
+class ByteText {
+ public:
+  ByteText(const uint8* bytes, int size) : bytes_(bytes), size_(size) {}
+
+  int length() const { return size_ + 1; }
+  int alphabet_size() const { return 256 + 1; }
+
+  int operator[](int i) const { return i == size_ ? 0 : bytes_[i] + 1; }
+
+ private:
+  const uint8* bytes_;
+  int size_;
+};
+
+// A reduced problem: the names of the LMS substrings of the level above,
+// stored in the unused tail of the suffix array. The last name is already a
+// unique smallest sentinel.
+class NameText {
+ public:
+  NameText(PagedArray<int>* array, int offset, int length, int alphabet_size)
+      : array_(array),
+        offset_(offset),
+        length_(length),
+        alphabet_size_(alphabet_size) {
+  }
+
+  int length() const { return length_; }
+  int alphabet_size() const { return alphabet_size_; }
+
+  int operator[](int i) const { return (*array_)[offset_ + i]; }
+
+ private:
+  PagedArray<int>* array_;
+  int offset_;
+  int length_;
+  int alphabet_size_;
+};
+
+// Suffix types: S-type suffixes are smaller than the suffix that follows
+// them, L-type suffixes are larger.
+typedef std::vector<bool> TypeArray;
+
+bool IsLMS(const TypeArray& is_s, int i) {
+  return i > 0 && is_s[i] && !is_s[i - 1];
+}
+
+// Sets |buckets| to the start (or one past the end) of each character's
+// bucket in the suffix array.
+template <typename Text>
+void GetBuckets(const Text& s, PagedArray<int>* buckets, bool end) {
+  const int k = s.alphabet_size();
+  for (int c = 0; c < k; ++c)
+    (*buckets)[c] = 0;
+  for (int i = 0; i < s.length(); ++i)
+    ++(*buckets)[s[i]];
+  int sum = 0;
+  for (int c = 0; c < k; ++c) {
+    sum += (*buckets)[c];
+    (*buckets)[c] = end ? sum : sum - (*buckets)[c];
+  }
+}
+
+// Places the L-type suffixes, given sorted LMS suffixes in |sa|.
+template <typename Text>
+void InduceL(const Text& s, const TypeArray& is_s, PagedArray<int>* buckets,
+             PagedArray<int>* sa) {
+  GetBuckets(s, buckets, false);
+  for (int i = 0; i < s.length(); ++i) {
+    int j = (*sa)[i] - 1;
+    if (j >= 0 && !is_s[j])
+      (*sa)[(*buckets)[s[j]]++] = j;
+  }
+}
+
+// Places the S-type suffixes, given sorted L-type suffixes in |sa|.
+template <typename Text>
+void InduceS(const Text& s, const TypeArray& is_s, PagedArray<int>* buckets,
+             PagedArray<int>* sa) {
+  GetBuckets(s, buckets, true);
+  for (int i = s.length() - 1; i >= 0; --i) {
+    int j = (*sa)[i] - 1;
+    if (j >= 0 && is_s[j])
+      (*sa)[--(*buckets)[s[j]]] = j;
+  }
+}
+
+// Returns true if the LMS substrings starting at |a| and |b| differ.
+template <typename Text>
+bool LMSSubstringsDiffer(const Text& s, const TypeArray& is_s, int a, int b) {
+  for (int d = 0; ; ++d) {
+    if (s[a + d] != s[b + d] || is_s[a + d] != is_s[b + d])
+      return true;
+    if (d > 0 && (IsLMS(is_s, a + d) || IsLMS(is_s, b + d)))
+      return false;
+  }
+}
+
+// Sorts the suffixes of |s| into the first s.length() entries of |sa|. The
+// last character of |s| must be a unique smallest sentinel.
+template <typename Text>
+bool SAIS(const Text& s, PagedArray<int>* sa) {
+  const int n = s.length();
+  if (n == 1) {
+    (*sa)[0] = 0;
+    return true;
+  }
+
+  TypeArray is_s(n);
+  is_s[n - 1] = true;
+  is_s[n - 2] = false;
+  for (int i = n - 3; i >= 0; --i)
+    is_s[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && is_s[i + 1]);
+
+  PagedArray<int> buckets;
+  if (!buckets.Allocate(s.alphabet_size()))
+    return false;
+
+  // Stage 1: sort the LMS substrings by inducing from their first character.
+  GetBuckets(s, &buckets, true);
+  for (int i = 0; i < n; ++i)
+    (*sa)[i] = -1;
+  for (int i = 1; i < n; ++i) {
+    if (IsLMS(is_s, i))
+      (*sa)[--buckets[s[i]]] = i;
+  }
+  InduceL(s, is_s, &buckets, sa);
+  InduceS(s, is_s, &buckets, sa);
+
+  // Move the sorted LMS substrings to the front and name them. No two LMS
+  // positions are adjacent, so position / 2 gives each a distinct slot in the
+  // back half.
+  int n1 = 0;
+  for (int i = 0; i < n; ++i) {
+    if (IsLMS(is_s, (*sa)[i]))
+      (*sa)[n1++] = (*sa)[i];
+  }
+  for (int i = n1; i < n; ++i)
+    (*sa)[i] = -1;
+  int name = 0;
+  int prev = -1;
+  for (int i = 0; i < n1; ++i) {
+    int pos = (*sa)[i];
+    if (prev == -1 || LMSSubstringsDiffer(s, is_s, pos, prev)) {
+      ++name;
+      prev = pos;
+    }
+    (*sa)[n1 + pos / 2] = name - 1;
+  }
+  for (int i = n - 1, j = n - 1; i >= n1; --i) {
+    if ((*sa)[i] >= 0)
+      (*sa)[j--] = (*sa)[i];
+  }
+
+  // Stage 2: sort the reduced string, which now sits in sa[n - n1, n), into
+  // sa[0, n1). Recursion is only needed when some names repeat.
+  const int s1_offset = n - n1;
+  if (name < n1) {
+    buckets.clear();
+    if (!SAIS(NameText(sa, s1_offset, n1, name), sa))
+      return false;
+    if (!buckets.Allocate(s.alphabet_size()))
+      return false;
+  } else {
+    for (int i = 0; i < n1; ++i)
+      (*sa)[(*sa)[s1_offset + i]] = i;
+  }
+
+  // Stage 3: map the reduced suffixes back to LMS positions, drop them into
+  // the ends of their buckets in sorted order and induce the rest.
+  for (int i = 1, j = 0; i < n; ++i) {
+    if (IsLMS(is_s, i))
+      (*sa)[s1_offset + j++] = i;
+  }
+  for (int i = 0; i < n1; ++i)
+    (*sa)[i] = (*sa)[s1_offset + (*sa)[i]];
+  for (int i = n1; i < n; ++i)
+    (*sa)[i] = -1;
+  GetBuckets(s, &buckets, true);
+  for (int i = n1 - 1; i >= 0; --i) {
+    int j = (*sa)[i];
+    (*sa)[i] = -1;
+    (*sa)[--buckets[s[j]]] = j;
+  }
+  InduceL(s, is_s, &buckets, sa);
+  InduceS(s, is_s, &buckets, sa);
+  return true;
+}
+
+}  // namespace
+
+bool SuffixSort(const uint8* text, int size, PagedArray<int>* sa) {
+  DCHECK_GE(size, 0);
+  return SAIS(ByteText(text, size), sa);
+}
+
+}  // namespace courgette
@@ -0,0 +1,31 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Linear time suffix array construction for bsdiff.
+
+#ifndef COURGETTE_SUFFIX_ARRAY_H_
+#define COURGETTE_SUFFIX_ARRAY_H_
+
+#include "base/basictypes.h"
+#include "courgette/third_party/paged_array.h"
+
+namespace courgette {
+
+// Fills |sa| with the suffix array of the |size| bytes at |text|, using the
+// SA-IS algorithm of Nong, Zhang and Chan, "Two Efficient Algorithms for
+// Linear Time Suffix Array Construction".
+//
+// |sa| must already hold |size| + 1 elements. On return sa[0] is |size|, the
+// empty suffix, followed by the start of every non-empty suffix in
+// lexicographic order. This is the layout bsdiff's qsufsort produced, but it
+// takes O(|size|) time and needs no second array for suffix ranks; the only
+// extra storage is a bit per byte and, while sorting the reduced problem, a
+// bucket array of at most |size| / 2 ints.
+//
+// Returns false if the extra storage could not be allocated.
+bool SuffixSort(const uint8* text, int size, PagedArray<int>* sa);
+
+}  // namespace courgette
+
+#endif  // COURGETTE_SUFFIX_ARRAY_H_
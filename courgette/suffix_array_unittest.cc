@@ -0,0 +1,81 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/suffix_array.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace courgette {
+
+namespace {
+
+// Orders suffixes of |text_| by direct comparison.
+class SuffixLess {
+ public:
+  explicit SuffixLess(const std::string& text) : text_(text) {}
+
+  bool operator()(int a, int b) const {
+    return text_.compare(a, std::string::npos,
+                         text_, b, std::string::npos) < 0;
+  }
+
+ private:
+  const std::string& text_;
+};
+
+void ExpectSorted(const std::string& text) {
+  const int size = static_cast<int>(text.size());
+  PagedArray<int> sa;
+  ASSERT_TRUE(sa.Allocate(size + 1));
+  ASSERT_TRUE(SuffixSort(reinterpret_cast<const uint8*>(text.data()), size,
+                         &sa));
+
+  std::vector<int> expected(size + 1);
+  for (int i = 0; i <= size; ++i)
+    expected[i] = i;
+  std::sort(expected.begin(), expected.end(), SuffixLess(text));
+
+  for (int i = 0; i <= size; ++i)
+    ASSERT_EQ(expected[i], sa[i]) << "index " << i << " of \"" << text << "\"";
+}
+
+}  // namespace
+
+TEST(SuffixArrayTest, Small) {
+  ExpectSorted("");
+  ExpectSorted("a");
+  ExpectSorted("banana");
+  ExpectSorted("mississippi");
+  ExpectSorted("abracadabra");
+}
+
+TEST(SuffixArrayTest, Repetitive) {
+  // Repeats force several levels of recursion.
+  ExpectSorted(std::string(1000, 'x'));
+  std::string text;
+  for (int i = 0; i < 500; ++i)
+    text.append("ab");
+  ExpectSorted(text);
+  text.clear();
+  for (int i = 0; i < 300; ++i)
+    text.append(i % 7 ? "abc" : "abd");
+  ExpectSorted(text);
+}
+
+TEST(SuffixArrayTest, AllBytes) {
+  // Bytes 0 and 0xFF must sort after the implied sentinel.
+  std::string text;
+  unsigned int seed = 1;
+  for (int i = 0; i < 5000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    text.push_back(static_cast<char>((seed >> 16) & (i % 2 ? 0xFF : 0x03)));
+  }
+  ExpectSorted(text);
+}
+
+}  // namespace courgette
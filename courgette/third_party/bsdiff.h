@@ -30,6 +30,7 @@
  * 2009-03-31 - Change to use Streams.  Move CRC code to crc.{h,cc}
  *              Changed status to an enum, removed unused status codes.
  *                --Stephen Adams <sra@chromium.org>
+ * 2012-06-14 - Allow the file to be patched to be given in two pieces.
  */
 
 #ifndef COURGETTE_BSDIFF_H_
@@ -64,6 +65,14 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
                               SourceStream* patch_stream,
                               SinkStream* new_stream);
 
+// As above, but the file to be patched is |old_head| followed by |old_tail|.
+// This saves callers from copying two large buffers into one.
+//
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_head,
+                              SourceStream* old_tail,
+                              SourceStream* patch_stream,
+                              SinkStream* new_stream);
+
 
 // The following declarations are common to the patch-creation and
 // patch-application code.
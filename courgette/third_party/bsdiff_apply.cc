@@ -26,6 +26,8 @@
  * Changelog:
  * 2009-03-31 - Change to use Streams.  Move CRC code to crc.{h,cc}
  *                --Stephen Adams <sra@chromium.org>
+ * 2012-06-14 - Allow the old file to be in two pieces, and return errors from
+ *              MBS_ApplyPatch.
  */
 
 // Copyright (c) 2009 The Chromium Authors. All rights reserved.
@@ -54,11 +56,13 @@ BSDiffStatus MBS_ReadHeader(SourceStream* stream, MBSPatchHeader* header) {
   return OK;
 }
 
+// The old file is |old_head| followed by |old_tail|; either may be empty.
 BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
                             SourceStream* patch_stream,
-                            const uint8* old_start, size_t old_size,
+                            const uint8* old_head, size_t old_head_size,
+                            const uint8* old_tail, size_t old_tail_size,
                             SinkStream* new_stream) {
-  const uint8* old_end = old_start + old_size;
+  const size_t old_size = old_head_size + old_tail_size;
 
   SourceStreamSet patch_streams;
   if (!patch_streams.Init(patch_stream))
@@ -75,7 +79,7 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
   const uint8* extra_end = extra_start + extra_bytes->Remaining();
   const uint8* extra_position = extra_start;
 
-  const uint8* old_position = old_start;
+  size_t old_position = 0;
 
   if (header->dlen && !new_stream->Reserve(header->dlen))
     return MEM_ERROR;
@@ -100,7 +104,7 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
 #endif
     // Byte-wise arithmetically add bytes from old file to bytes from the diff
     // block.
-    if (copy_count > static_cast<size_t>(old_end - old_position))
+    if (copy_count > old_size - old_position)
       return UNEXPECTED_ERROR;
 
     // Add together bytes from the 'old' file and the 'diff' stream.
@@ -114,7 +118,10 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
         if (!diff_bytes->Read(&diff_byte, 1))
           return UNEXPECTED_ERROR;
       }
-      uint8 byte = old_position[i] + diff_byte;
+      size_t position = old_position + i;
+      uint8 old_byte = position < old_head_size ?
+          old_head[position] : old_tail[position - old_head_size];
+      uint8 byte = old_byte + diff_byte;
       if (!new_stream->Write(&byte, 1))
         return MEM_ERROR;
     }
@@ -130,11 +137,11 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
     extra_position += extra_count;
 
     // "seek" forwards (or backwards) in oldfile.
-    if (old_position + seek_adjustment < old_start ||
-        old_position + seek_adjustment > old_end)
+    int64 new_position = static_cast<int64>(old_position) + seek_adjustment;
+    if (new_position < 0 || new_position > static_cast<int64>(old_size))
       return UNEXPECTED_ERROR;
 
-    old_position += seek_adjustment;
+    old_position = static_cast<size_t>(new_position);
   }
 
   if (!control_stream_copy_counts->Empty() ||
@@ -163,9 +170,31 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
   if (CalculateCrc(old_start, old_size) != header.scrc32)
     return CRC_ERROR;
 
-  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, new_stream);
+  return MBS_ApplyPatch(&header, patch_stream, old_start, old_size, NULL, 0,
+                        new_stream);
+}
 
-  return OK;
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_head,
+                              SourceStream* old_tail,
+                              SourceStream* patch_stream,
+                              SinkStream* new_stream) {
+  MBSPatchHeader header;
+  BSDiffStatus ret = MBS_ReadHeader(patch_stream, &header);
+  if (ret != OK) return ret;
+
+  const uint8* head_start = old_head->Buffer();
+  size_t head_size = old_head->Remaining();
+  const uint8* tail_start = old_tail->Buffer();
+  size_t tail_size = old_tail->Remaining();
+
+  if (head_size + tail_size != header.slen) return UNEXPECTED_ERROR;
+
+  if (CalculateCrc(head_start, head_size, tail_start, tail_size) !=
+      header.scrc32)
+    return CRC_ERROR;
+
+  return MBS_ApplyPatch(&header, patch_stream, head_start, head_size,
+                        tail_start, tail_size, new_stream);
 }
 
 }  // namespace
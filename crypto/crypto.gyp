@@ -287,6 +287,20 @@
         }],
       ],
     },
+    {
+      'target_name': 'crypto_perftests',
+      'type': 'executable',
+      'sources': [
+        'encryptor_perftest.cc',
+        'p224_perftest.cc',
+      ],
+      'dependencies': [
+        'crypto',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+    },
   ],
   'conditions': [
     [ 'OS == "win"', {
@@ -54,6 +54,8 @@ bool Encryptor::SetCounter(const base::StringPiece& counter) {
     return false;
 
   counter_.reset(new Counter(counter));
+  keystream_.clear();
+  keystream_offset_ = 0;
   return true;
 }
 
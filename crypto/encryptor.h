@@ -86,7 +86,13 @@ class CRYPTO_EXPORT Encryptor {
   // Returns true only if update was successful.
   bool SetCounter(const base::StringPiece& counter);
 
-  // TODO(albertb): Support streaming encryption.
+  // Encrypts or decrypts |length| bytes at |data| in place, continuing the
+  // keystream where the previous call left off, so that a large message can
+  // be processed in pieces of any size without copying it. Only supported in
+  // CTR mode, where encryption and decryption are the same operation.
+  // SetCounter() restarts the stream. Don't interleave with Encrypt() or
+  // Decrypt(), which advance the same counter.
+  bool CryptInPlace(char* data, size_t length);
 
  private:
   // Generates a mask using |counter_| to be used for encryption in CTR mode.
@@ -116,6 +122,11 @@ class CRYPTO_EXPORT Encryptor {
   Mode mode_;
   scoped_ptr<Counter> counter_;
 
+  // Keystream generated by CryptInPlace() but not used yet, starting at
+  // |keystream_offset_|.
+  std::string keystream_;
+  size_t keystream_offset_;
+
 #if defined(USE_OPENSSL)
   bool Crypt(bool encrypt,  // Pass true to encrypt, false to decrypt.
              const base::StringPiece& input,
@@ -130,6 +141,8 @@ class CRYPTO_EXPORT Encryptor {
                 std::string* output);
   ScopedPK11Slot slot_;
   ScopedSECItem param_;
+  // The context used by CryptInPlace(), kept across calls.
+  ScopedPK11Context stream_context_;
 #elif defined(OS_MACOSX)
   bool Crypt(int /*CCOperation*/ op,
              const base::StringPiece& input,
@@ -14,7 +14,8 @@ namespace crypto {
 
 Encryptor::Encryptor()
     : key_(NULL),
-      mode_(CBC) {
+      mode_(CBC),
+      keystream_offset_(0) {
 }
 
 Encryptor::~Encryptor() {
@@ -81,4 +82,10 @@ bool Encryptor::Decrypt(const base::StringPiece& ciphertext,
   return Crypt(kCCDecrypt, ciphertext, plaintext);
 }
 
+bool Encryptor::CryptInPlace(char* data, size_t length) {
+  // CTR mode is only implemented using NSS.
+  NOTIMPLEMENTED();
+  return false;
+}
+
 }  // namespace crypto
@@ -5,6 +5,8 @@
 #include "crypto/encryptor.h"
 
 #include <cryptohi.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "base/logging.h"
@@ -30,11 +32,15 @@ inline CK_MECHANISM_TYPE GetMechanism(Encryptor::Mode mode) {
   return static_cast<CK_MECHANISM_TYPE>(-1);
 }
 
+// The most keystream CryptInPlace() generates with one call into NSS.
+const size_t kMaxKeystreamLength = 4096;
+
 }  // namespace
 
 Encryptor::Encryptor()
     : key_(NULL),
-      mode_(CBC) {
+      mode_(CBC),
+      keystream_offset_(0) {
   EnsureNSSInit();
 }
 
@@ -49,6 +55,7 @@ bool Encryptor::Init(SymmetricKey* key,
 
   key_ = key;
   mode_ = mode;
+  stream_context_.reset();
 
   if (mode == CBC && iv.size() != AES_BLOCK_SIZE)
     return false;
@@ -194,4 +201,57 @@ bool Encryptor::CryptCTR(PK11Context* context,
   return true;
 }
 
+bool Encryptor::CryptInPlace(char* data, size_t length) {
+  if (mode_ != CTR || !counter_.get()) {
+    LOG(ERROR) << "Streaming requires CTR mode and a counter value.";
+    return false;
+  }
+
+  if (!stream_context_.get()) {
+    stream_context_.reset(PK11_CreateContextBySymKey(GetMechanism(mode_),
+                                                     CKA_ENCRYPT,
+                                                     key_->key(),
+                                                     param_.get()));
+    if (!stream_context_.get())
+      return false;
+  }
+
+  while (length > 0) {
+    if (keystream_offset_ == keystream_.size()) {
+      // Encrypt the next counter blocks to refill the keystream. This is done
+      // in batches so that small pieces don't each cost a call into NSS.
+      size_t wanted = std::min(length + AES_BLOCK_SIZE - 1,
+                               kMaxKeystreamLength);
+      wanted -= wanted % AES_BLOCK_SIZE;
+      keystream_.resize(wanted + AES_BLOCK_SIZE);
+      uint8* keystream_data =
+          reinterpret_cast<uint8*>(const_cast<char*>(keystream_.data()));
+      size_t mask_len;
+      if (!GenerateCounterMask(wanted, keystream_data, &mask_len))
+        return false;
+      CHECK_EQ(wanted, mask_len);
+
+      int op_len;
+      SECStatus rv = PK11_CipherOp(stream_context_.get(),
+                                   keystream_data,
+                                   &op_len,
+                                   mask_len,
+                                   keystream_data,
+                                   mask_len);
+      if (SECSuccess != rv)
+        return false;
+      CHECK_EQ(static_cast<int>(mask_len), op_len);
+      keystream_.resize(mask_len);
+      keystream_offset_ = 0;
+    }
+
+    size_t chunk = std::min(length, keystream_.size() - keystream_offset_);
+    MaskMessage(data, chunk, keystream_.data() + keystream_offset_, data);
+    keystream_offset_ += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+  return true;
+}
+
 }  // namespace crypto
@@ -46,7 +46,8 @@ class ScopedCipherCTX {
 
 Encryptor::Encryptor()
     : key_(NULL),
-      mode_(CBC) {
+      mode_(CBC),
+      keystream_offset_(0) {
 }
 
 Encryptor::~Encryptor() {
@@ -132,4 +133,10 @@ bool Encryptor::Crypt(bool do_encrypt,
   return true;
 }
 
+bool Encryptor::CryptInPlace(char* data, size_t length) {
+  // CTR mode is only implemented using NSS.
+  NOTIMPLEMENTED();
+  return false;
+}
+
 }  // namespace crypto
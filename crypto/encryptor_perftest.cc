@@ -0,0 +1,63 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "crypto/encryptor.h"
+
+#include <string>
+
+#include "base/format_macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "crypto/symmetric_key.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace crypto {
+
+// CTR mode is only implemented using NSS.
+#if defined(USE_NSS)
+
+namespace {
+
+// Bytes encrypted for each piece size.
+const size_t kTotalBytes = 64 * 1024 * 1024;
+
+const char kInitialCounter[] = "0000000000000000";
+
+}  // namespace
+
+// Compares encrypting a large blob in pieces through Encrypt(), which copies
+// every piece and creates an NSS context per call, with CryptInPlace().
+TEST(EncryptorPerfTest, CTR) {
+  scoped_ptr<SymmetricKey> key(
+      SymmetricKey::GenerateRandomKey(SymmetricKey::AES, 128));
+  ASSERT_TRUE(key.get());
+  Encryptor encryptor;
+  ASSERT_TRUE(encryptor.Init(key.get(), Encryptor::CTR, ""));
+
+  const size_t kPieceSizes[] = { 1024, 32 * 1024 };
+  for (size_t i = 0; i < arraysize(kPieceSizes); ++i) {
+    const size_t piece_size = kPieceSizes[i];
+    std::string piece(piece_size, 'x');
+    std::string ciphertext;
+
+    ASSERT_TRUE(encryptor.SetCounter(kInitialCounter));
+    PerfTimeLogger copy_timer(base::StringPrintf(
+        "Encryptor_ctr_encrypt_%" PRIuS, piece_size).c_str());
+    for (size_t done = 0; done < kTotalBytes; done += piece_size)
+      ASSERT_TRUE(encryptor.Encrypt(piece, &ciphertext));
+    copy_timer.Done();
+
+    ASSERT_TRUE(encryptor.SetCounter(kInitialCounter));
+    PerfTimeLogger in_place_timer(base::StringPrintf(
+        "Encryptor_ctr_in_place_%" PRIuS, piece_size).c_str());
+    for (size_t done = 0; done < kTotalBytes; done += piece_size)
+      ASSERT_TRUE(encryptor.CryptInPlace(&piece[0], piece.size()));
+    in_place_timer.Done();
+  }
+}
+
+#endif  // defined(USE_NSS)
+
+}  // namespace crypto
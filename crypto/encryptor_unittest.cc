@@ -4,6 +4,7 @@
 
 #include "crypto/encryptor.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/memory/scoped_ptr.h"
@@ -128,6 +129,43 @@ TEST(EncryptorTest, EncryptDecryptCTR) {
   EXPECT_EQ(plaintext, decypted);
 }
 
+TEST(EncryptorTest, CryptInPlaceCTR) {
+  scoped_ptr<crypto::SymmetricKey> key(
+      crypto::SymmetricKey::GenerateRandomKey(
+          crypto::SymmetricKey::AES, 128));
+  ASSERT_TRUE(NULL != key.get());
+  const std::string kInitialCounter = "0000000000000000";
+
+  crypto::Encryptor encryptor;
+  ASSERT_TRUE(encryptor.Init(key.get(), crypto::Encryptor::CTR, ""));
+  ASSERT_TRUE(encryptor.SetCounter(kInitialCounter));
+
+  std::string plaintext;
+  for (int i = 0; i < 10000; ++i)
+    plaintext.push_back(static_cast<char>(i));
+  std::string expected;
+  ASSERT_TRUE(encryptor.Encrypt(plaintext, &expected));
+
+  // Pieces that straddle block boundaries must continue the keystream.
+  const size_t kPieceSizes[] = { 1, 15, 17, 32, 4095, 5000 };
+  std::string streamed(plaintext);
+  ASSERT_TRUE(encryptor.SetCounter(kInitialCounter));
+  size_t offset = 0;
+  for (size_t i = 0; i < arraysize(kPieceSizes); ++i) {
+    size_t piece = std::min(kPieceSizes[i], streamed.size() - offset);
+    EXPECT_TRUE(encryptor.CryptInPlace(&streamed[offset], piece));
+    offset += piece;
+  }
+  ASSERT_TRUE(encryptor.CryptInPlace(&streamed[offset],
+                                     streamed.size() - offset));
+  EXPECT_EQ(expected, streamed);
+
+  // Decryption is the same operation.
+  ASSERT_TRUE(encryptor.SetCounter(kInitialCounter));
+  ASSERT_TRUE(encryptor.CryptInPlace(&streamed[0], streamed.size()));
+  EXPECT_EQ(plaintext, streamed);
+}
+
 TEST(EncryptorTest, CTRCounter) {
   const int kCounterSize = 16;
   const char kTest1[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
@@ -6,6 +6,7 @@
 
 #include <string.h>
 
+#include "base/logging.h"
 #include "base/string_util.h"
 #include "crypto/symmetric_key.h"
 
@@ -32,6 +33,7 @@ DWORD GetCipherBlockSize(HCRYPTKEY key) {
 Encryptor::Encryptor()
     : key_(NULL),
       mode_(CBC),
+      keystream_offset_(0),
       block_size_(0) {
 }
 
@@ -125,4 +127,10 @@ bool Encryptor::Decrypt(const base::StringPiece& ciphertext,
   return true;
 }
 
+bool Encryptor::CryptInPlace(char* data, size_t length) {
+  // CTR mode is only implemented using NSS.
+  NOTIMPLEMENTED();
+  return false;
+}
+
 }  // namespace crypto
@@ -4,6 +4,8 @@
 
 // This is an implementation of the P224 elliptic curve group. It's written to
 // be short and simple rather than fast, although it's still constant-time.
+// Scalar multiplication uses 4-bit windows and, for the base point, a table of
+// precomputed multiples so that it needs no doublings at all.
 //
 // See http://www.imperialviolet.org/2010/12/04/ecc.html ([1]) for background.
 
@@ -11,6 +13,7 @@
 
 #include <string.h>
 
+#include "base/lazy_instance.h"
 #include "base/sys_byteorder.h"
 
 namespace {
@@ -535,25 +538,113 @@ void CopyConditional(Point* out,
   }
 }
 
+// NonZeroMask returns 0xffffffff if |nibble| is non-zero and 0 otherwise.
+// |nibble| must be < 16.
+uint32 NonZeroMask(uint32 nibble) {
+  nibble |= nibble >> 2;
+  nibble |= nibble >> 1;
+  return 0u - (nibble & 1);
+}
+
+// SelectJacobianPoint sets *out = table[index-1] if |index| is non-zero and
+// leaves *out unchanged otherwise. Every entry of |table| is read so that the
+// memory access pattern doesn't depend on |index|. |index| must be < 16.
+void SelectJacobianPoint(Point* out, const Point* table, uint32 index) {
+  for (uint32 i = 1; i < 16; i++) {
+    CopyConditional(out, table[i-1], ~NonZeroMask(i ^ index));
+  }
+}
+
+// MakeWindowTable sets table[i] = (i+1)*a for i in [0, 15).
+void MakeWindowTable(Point* table, const Point& a) {
+  table[0] = a;
+  for (int i = 1; i < 15; i++) {
+    if (i & 1) {
+      DoubleJacobian(&table[i], table[i/2]);
+    } else {
+      AddJacobian(&table[i], table[i-1], a);
+    }
+  }
+}
+
+// AddNibble sets *out += table[nibble-1], treating *out as the point at
+// infinity while |*first_nibble| is 0xffffffff. It's a no-op if |nibble| is
+// zero.
+void AddNibble(Point* out, const Point* table, uint32 nibble,
+               uint32* first_nibble) {
+  Point selected, sum;
+  memset(&selected, 0, sizeof(selected));
+  SelectJacobianPoint(&selected, table, nibble);
+  AddJacobian(&sum, selected, *out);
+
+  uint32 non_zero = NonZeroMask(nibble);
+  CopyConditional(out, selected, *first_nibble & non_zero);
+  CopyConditional(out, sum, ~*first_nibble & non_zero);
+  *first_nibble &= ~non_zero;
+}
+
 // ScalarMult calculates *out = a*scalar where scalar is a big-endian number of
 // length scalar_len and != 0.
 void ScalarMult(Point* out, const Point& a,
                 const uint8* scalar, size_t scalar_len) {
-  memset(out, 0, sizeof(*out));
-  Point tmp;
+  Point table[15];
+  MakeWindowTable(table, a);
 
-  uint32 first_bit = 0xffffffff;
+  memset(out, 0, sizeof(*out));
+  uint32 first_nibble = 0xffffffff;
   for (size_t i = 0; i < scalar_len; i++) {
-    for (unsigned int bit_num = 0; bit_num < 8; bit_num++) {
-      DoubleJacobian(out, *out);
-      uint32 bit = static_cast<uint32>(static_cast<int32>(
-          (((scalar[i] >> (7 - bit_num)) & 1) << 31) >> 31));
-      AddJacobian(&tmp, a, *out);
-      CopyConditional(out, a, first_bit & bit);
-      CopyConditional(out, tmp, ~first_bit & bit);
-      first_bit = first_bit & ~bit;
+    for (int shift = 4; shift >= 0; shift -= 4) {
+      for (int j = 0; j < 4; j++) {
+        DoubleJacobian(out, *out);
+      }
+      AddNibble(out, table, (scalar[i] >> shift) & 0xf, &first_nibble);
+    }
+  }
+}
+
+// kBasePoint is the base point (generator) of the elliptic curve group.
+const Point kBasePoint = {
+  {22813985, 52956513, 34677300, 203240812,
+   12143107, 133374265, 225162431, 191946955},
+  {83918388, 223877528, 122119236, 123340192,
+   266784067, 263504429, 146143011, 198407736},
+  {1, 0, 0, 0, 0, 0, 0, 0},
+};
+
+// kScalarNibbles is the number of 4-bit windows in a 28-byte scalar.
+const int kScalarNibbles = 56;
+
+// BasePointTable holds j*16**i*G for every nibble position i and nibble value
+// j in [1, 16), so that a multiple of the base point costs one addition per
+// nibble of the scalar. It's about 80KB and is built on first use.
+struct BasePointTable {
+  BasePointTable() {
+    Point row_base = kBasePoint;
+    for (int i = 0; i < kScalarNibbles; i++) {
+      MakeWindowTable(multiples[i], row_base);
+      for (int j = 0; j < 4; j++) {
+        DoubleJacobian(&row_base, row_base);
+      }
     }
   }
+
+  Point multiples[kScalarNibbles][15];
+};
+
+base::LazyInstance<BasePointTable>::Leaky g_base_point_table =
+    LAZY_INSTANCE_INITIALIZER;
+
+// ScalarBaseMult calculates *out = g*scalar where scalar is a 28-byte,
+// big-endian number and != 0.
+void ScalarBaseMult(Point* out, const uint8* scalar) {
+  const BasePointTable& table = g_base_point_table.Get();
+
+  memset(out, 0, sizeof(*out));
+  uint32 first_nibble = 0xffffffff;
+  for (int i = 0; i < kScalarNibbles; i++) {
+    uint32 nibble = (scalar[27 - i/2] >> (4 * (i & 1))) & 0xf;
+    AddNibble(out, table.multiples[i], nibble, &first_nibble);
+  }
 }
 
 // Get224Bits reads 7 words from in and scatters their contents in
@@ -647,17 +738,8 @@ void ScalarMult(const Point& in, const uint8* scalar, Point* out) {
   ::ScalarMult(out, in, scalar, 28);
 }
 
-// kBasePoint is the base point (generator) of the elliptic curve group.
-static const Point kBasePoint = {
-  {22813985, 52956513, 34677300, 203240812,
-   12143107, 133374265, 225162431, 191946955},
-  {83918388, 223877528, 122119236, 123340192,
-   266784067, 263504429, 146143011, 198407736},
-  {1, 0, 0, 0, 0, 0, 0, 0},
-};
-
 void ScalarBaseMult(const uint8* scalar, Point* out) {
-  ::ScalarMult(out, kBasePoint, scalar, 28);
+  ::ScalarBaseMult(out, scalar);
 }
 
 void Add(const Point& a, const Point& b, Point* out) {
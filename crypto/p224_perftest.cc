@@ -0,0 +1,53 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "crypto/p224.h"
+
+#include "base/perftimer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace crypto {
+
+namespace {
+
+const int kIterations = 1000;
+
+// Fills |scalar| with a value that varies with |i|.
+void MakeScalar(int i, uint8* scalar) {
+  for (size_t j = 0; j < p224::kScalarBytes; ++j)
+    scalar[j] = static_cast<uint8>(i * 31 + j * 7 + 1);
+}
+
+}  // namespace
+
+TEST(P224PerfTest, ScalarBaseMult) {
+  uint8 scalar[p224::kScalarBytes];
+  p224::Point point;
+  // The first call builds the table of base point multiples.
+  MakeScalar(0, scalar);
+  p224::ScalarBaseMult(scalar, &point);
+
+  PerfTimeLogger timer("P224_scalar_base_mult");
+  for (int i = 0; i < kIterations; ++i) {
+    MakeScalar(i, scalar);
+    p224::ScalarBaseMult(scalar, &point);
+  }
+  timer.Done();
+}
+
+TEST(P224PerfTest, ScalarMult) {
+  uint8 scalar[p224::kScalarBytes];
+  p224::Point base, point;
+  MakeScalar(0, scalar);
+  p224::ScalarBaseMult(scalar, &base);
+
+  PerfTimeLogger timer("P224_scalar_mult");
+  for (int i = 0; i < kIterations; ++i) {
+    MakeScalar(i, scalar);
+    p224::ScalarMult(base, scalar, &point);
+  }
+  timer.Done();
+}
+
+}  // namespace crypto
@@ -574,26 +574,36 @@ void Bus::AddMatch(const std::string& match_rule, DBusError* error) {
   DCHECK(connection_);
   AssertOnDBusThread();
 
-  if (match_rules_added_.find(match_rule) != match_rules_added_.end()) {
+  std::map<std::string, int>::iterator iter =
+      match_rules_added_.find(match_rule);
+  if (iter != match_rules_added_.end()) {
+    // Save the round trip to the bus daemon.
     VLOG(1) << "Match rule already exists: " << match_rule;
+    iter->second++;
     return;
   }
 
   dbus_bus_add_match(connection_, match_rule.c_str(), error);
-  match_rules_added_.insert(match_rule);
+  match_rules_added_[match_rule] = 1;
 }
 
 void Bus::RemoveMatch(const std::string& match_rule, DBusError* error) {
   DCHECK(connection_);
   AssertOnDBusThread();
 
-  if (match_rules_added_.find(match_rule) == match_rules_added_.end()) {
+  std::map<std::string, int>::iterator iter =
+      match_rules_added_.find(match_rule);
+  if (iter == match_rules_added_.end()) {
     LOG(ERROR) << "Requested to remove an unknown match rule: " << match_rule;
     return;
   }
 
+  // Other users still need the rule.
+  if (--iter->second > 0)
+    return;
+
   dbus_bus_remove_match(connection_, match_rule.c_str(), error);
-  match_rules_added_.erase(match_rule);
+  match_rules_added_.erase(iter);
 }
 
 bool Bus::TryRegisterObjectPath(const ObjectPath& object_path,
@@ -367,8 +367,9 @@ class Bus : public base::RefCountedThreadSafe<Bus> {
   // Instead, you should check if an incoming message is what you are
   // interested in, in the filter functions.
   //
-  // The same match rule can be added more than once, but ignored from the
-  // second time.
+  // The same match rule can be added more than once, e.g. by object proxies
+  // for the same object. Only the first call asks the bus daemon to add the
+  // rule; the others just count the additional user.
   //
   // The match rule looks like:
   // "type='signal', interface='org.chromium.SomeInterface'".
@@ -380,7 +381,9 @@ class Bus : public base::RefCountedThreadSafe<Bus> {
   // BLOCKING CALL.
   virtual void AddMatch(const std::string& match_rule, DBusError* error);
 
-  // Removes the match rule previously added by AddMatch().
+  // Removes the match rule previously added by AddMatch(). The rule is
+  // removed from the bus daemon once RemoveMatch() has been called as many
+  // times as AddMatch().
   //
   // BLOCKING CALL.
   virtual void RemoveMatch(const std::string& match_rule, DBusError* error);
@@ -517,7 +520,8 @@ class Bus : public base::RefCountedThreadSafe<Bus> {
   std::set<std::string> owned_service_names_;
   // The following sets are used to check if rules/object_paths/filters
   // are properly cleaned up before destruction of the bus object.
-  std::set<std::string> match_rules_added_;
+  // |match_rules_added_| maps each rule to the number of its users.
+  std::map<std::string, int> match_rules_added_;
   std::set<ObjectPath> registered_object_paths_;
   std::set<std::pair<DBusHandleMessageFunction, void*> >
       filter_functions_added_;
@@ -8,11 +8,13 @@
 
 #include "base/bind.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop.h"
 #include "base/stl_util.h"
 #include "base/test/test_timeouts.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/time.h"
 #include "dbus/bus.h"
 #include "dbus/message.h"
 #include "dbus/object_path.h"
@@ -24,7 +26,7 @@
 // ExportedObject.
 class EndToEndAsyncTest : public testing::Test {
  public:
-  EndToEndAsyncTest() {
+  EndToEndAsyncTest() : num_batch_responses_(0) {
   }
 
   virtual void SetUp() {
@@ -161,6 +163,16 @@ class EndToEndAsyncTest : public testing::Test {
         base::Bind(&EndToEndAsyncTest::OnError, base::Unretained(this)));
   }
 
+  // Calls the methods asynchronously as a batch. OnBatchResponse() will be
+  // called once all the responses are received.
+  void CallMethods(const std::vector<dbus::MethodCall*>& method_calls,
+                   int timeout_ms) {
+    object_proxy_->CallMethods(method_calls,
+                               timeout_ms,
+                               base::Bind(&EndToEndAsyncTest::OnBatchResponse,
+                                          base::Unretained(this)));
+  }
+
   // Wait for the give number of responses.
   void WaitForResponses(size_t num_responses) {
     while (response_strings_.size() < num_responses) {
@@ -183,6 +195,13 @@ class EndToEndAsyncTest : public testing::Test {
     message_loop_.Quit();
   };
 
+  // Called when all the responses of a batch are received.
+  void OnBatchResponse(const std::vector<dbus::Response*>& responses) {
+    ++num_batch_responses_;
+    for (size_t i = 0; i < responses.size(); ++i)
+      OnResponse(responses[i]);
+  }
+
   // Wait for the given number of errors.
   void WaitForErrors(size_t num_errors) {
     while (error_names_.size() < num_errors) {
@@ -243,6 +262,7 @@ class EndToEndAsyncTest : public testing::Test {
   MessageLoop message_loop_;
   std::vector<std::string> response_strings_;
   std::vector<std::string> error_names_;
+  int num_batch_responses_;
   scoped_ptr<base::Thread> dbus_thread_;
   scoped_refptr<dbus::Bus> bus_;
   dbus::ObjectProxy* object_proxy_;
@@ -354,6 +374,119 @@ TEST_F(EndToEndAsyncTest, BrokenBusWithErrorCallback) {
   ASSERT_EQ("", error_names_[0]);
 }
 
+// Call Echo method three times in a batch.
+TEST_F(EndToEndAsyncTest, BatchedEcho) {
+  const char* kMessages[] = { "foo", "bar", "baz" };
+
+  ScopedVector<dbus::MethodCall> method_calls;
+  for (size_t i = 0; i < arraysize(kMessages); ++i) {
+    dbus::MethodCall* method_call =
+        new dbus::MethodCall("org.chromium.TestInterface", "Echo");
+    dbus::MessageWriter writer(method_call);
+    writer.AppendString(kMessages[i]);
+    method_calls.push_back(method_call);
+  }
+
+  // Call the methods.
+  const int timeout_ms = dbus::ObjectProxy::TIMEOUT_USE_DEFAULT;
+  CallMethods(method_calls.get(), timeout_ms);
+
+  // The responses are delivered together, in the order of the calls.
+  WaitForResponses(3);
+  EXPECT_EQ(1, num_batch_responses_);
+  EXPECT_EQ("foo", response_strings_[0]);
+  EXPECT_EQ("bar", response_strings_[1]);
+  EXPECT_EQ("baz", response_strings_[2]);
+}
+
+// A failing call does not fail the other calls of the batch.
+TEST_F(EndToEndAsyncTest, BatchedEchoWithNonexistentMethod) {
+  ScopedVector<dbus::MethodCall> method_calls;
+  dbus::MethodCall* method_call =
+      new dbus::MethodCall("org.chromium.TestInterface", "Echo");
+  dbus::MessageWriter writer(method_call);
+  writer.AppendString("hello");
+  method_calls.push_back(method_call);
+  method_calls.push_back(
+      new dbus::MethodCall("org.chromium.TestInterface", "Nonexistent"));
+
+  const int timeout_ms = dbus::ObjectProxy::TIMEOUT_USE_DEFAULT;
+  CallMethods(method_calls.get(), timeout_ms);
+
+  WaitForResponses(2);
+  EXPECT_EQ(1, num_batch_responses_);
+  EXPECT_EQ("hello", response_strings_[0]);
+  EXPECT_EQ("", response_strings_[1]);
+}
+
+TEST_F(EndToEndAsyncTest, BatchedBrokenBus) {
+  // Set up a broken bus.
+  SetUpBrokenBus();
+
+  ScopedVector<dbus::MethodCall> method_calls;
+  for (int i = 0; i < 2; ++i) {
+    dbus::MethodCall* method_call =
+        new dbus::MethodCall("org.chromium.TestInterface", "Echo");
+    dbus::MessageWriter writer(method_call);
+    writer.AppendString("hello");
+    method_calls.push_back(method_call);
+  }
+
+  const int timeout_ms = dbus::ObjectProxy::TIMEOUT_USE_DEFAULT;
+  CallMethods(method_calls.get(), timeout_ms);
+  WaitForResponses(2);
+
+  // Should fail because of the broken bus.
+  EXPECT_EQ(1, num_batch_responses_);
+  EXPECT_EQ("", response_strings_[0]);
+  EXPECT_EQ("", response_strings_[1]);
+}
+
+// Compares a burst of calls made one by one, as clients typically do at
+// startup, with the same calls made as a batch.
+TEST_F(EndToEndAsyncTest, StartupBurstTiming) {
+  const size_t kNumCalls = 100;
+  const int timeout_ms = dbus::ObjectProxy::TIMEOUT_USE_DEFAULT;
+
+  // A message can be sent only once, so each run has its own calls.
+  ScopedVector<dbus::MethodCall> individual_calls;
+  ScopedVector<dbus::MethodCall> batched_calls;
+  for (size_t i = 0; i < 2 * kNumCalls + 1; ++i) {
+    dbus::MethodCall* method_call =
+        new dbus::MethodCall("org.chromium.TestInterface", "Echo");
+    dbus::MessageWriter writer(method_call);
+    writer.AppendString("hello");
+    if (i <= kNumCalls)
+      individual_calls.push_back(method_call);
+    else
+      batched_calls.push_back(method_call);
+  }
+
+  // Warm up the connection, so that neither run pays for it.
+  CallMethod(individual_calls[kNumCalls], timeout_ms);
+  WaitForResponses(1);
+  response_strings_.clear();
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 0; i < kNumCalls; ++i)
+    CallMethod(individual_calls[i], timeout_ms);
+  WaitForResponses(kNumCalls);
+  const base::TimeDelta individual_time = base::TimeTicks::Now() - start;
+  response_strings_.clear();
+
+  start = base::TimeTicks::Now();
+  CallMethods(batched_calls.get(), timeout_ms);
+  WaitForResponses(kNumCalls);
+  const base::TimeDelta batch_time = base::TimeTicks::Now() - start;
+
+  EXPECT_EQ(1, num_batch_responses_);
+  for (size_t i = 0; i < kNumCalls; ++i)
+    EXPECT_EQ("hello", response_strings_[i]);
+  LOG(INFO) << kNumCalls << " calls: "
+            << individual_time.InMillisecondsF() << " ms one by one, "
+            << batch_time.InMillisecondsF() << " ms as a batch";
+}
+
 TEST_F(EndToEndAsyncTest, Timeout) {
   const char* kHello = "hello";
 
@@ -31,6 +31,9 @@ class MockObjectProxy : public ObjectProxy {
                                                  int timeout_ms,
                                                  ResponseCallback callback,
                                                  ErrorCallback error_callback));
+  MOCK_METHOD3(CallMethods, void(const std::vector<MethodCall*>& method_calls,
+                                 int timeout_ms,
+                                 BatchResponseCallback callback));
   MOCK_METHOD4(ConnectToSignal,
                void(const std::string& interface_name,
                     const std::string& signal_name,
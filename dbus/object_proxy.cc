@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/string_piece.h"
@@ -128,6 +129,31 @@ void ObjectProxy::CallMethodWithErrorCallback(MethodCall* method_call,
   bus_->PostTaskToDBusThread(FROM_HERE, task);
 }
 
+void ObjectProxy::CallMethods(const std::vector<MethodCall*>& method_calls,
+                              int timeout_ms,
+                              BatchResponseCallback callback) {
+  bus_->AssertOnOriginThread();
+
+  std::vector<DBusMessage*> request_messages;
+  for (size_t i = 0; i < method_calls.size(); ++i) {
+    method_calls[i]->SetDestination(service_name_);
+    method_calls[i]->SetPath(object_path_);
+    // This will be unref'ed in StartAsyncMethodCalls().
+    DBusMessage* request_message = method_calls[i]->raw_message();
+    dbus_message_ref(request_message);
+    request_messages.push_back(request_message);
+  }
+
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+  base::Closure task = base::Bind(&ObjectProxy::StartAsyncMethodCalls,
+                                  this,
+                                  timeout_ms,
+                                  request_messages,
+                                  callback,
+                                  start_time);
+  bus_->PostTaskToDBusThread(FROM_HERE, task);
+}
+
 void ObjectProxy::ConnectToSignal(const std::string& interface_name,
                                   const std::string& signal_name,
                                   SignalCallback signal_callback,
@@ -289,6 +315,137 @@ void ObjectProxy::OnPendingCallIsCompleteThunk(DBusPendingCall* pending_call,
   delete data;
 }
 
+ObjectProxy::BatchCallData::BatchCallData(
+    ObjectProxy* in_object_proxy,
+    BatchResponseCallback in_response_callback,
+    size_t num_calls,
+    base::TimeTicks in_start_time)
+    : object_proxy(in_object_proxy),
+      response_callback(in_response_callback),
+      start_time(in_start_time),
+      response_messages(num_calls),
+      num_pending_calls(num_calls) {
+}
+
+ObjectProxy::BatchCallData::~BatchCallData() {
+}
+
+void ObjectProxy::StartAsyncMethodCalls(
+    int timeout_ms,
+    const std::vector<DBusMessage*>& request_messages,
+    BatchResponseCallback response_callback,
+    base::TimeTicks start_time) {
+  bus_->AssertOnDBusThread();
+
+  // Deleted once the last reply is in. The replies are dispatched in the
+  // D-Bus thread, so none can arrive before this function returns.
+  BatchCallData* batch = new BatchCallData(this, response_callback,
+                                           request_messages.size(),
+                                           start_time);
+  const bool connected = bus_->Connect() && bus_->SetUpAsyncOperations();
+  for (size_t i = 0; i < request_messages.size(); ++i) {
+    DBusPendingCall* pending_call = NULL;
+    if (connected)
+      bus_->SendWithReply(request_messages[i], &pending_call, timeout_ms);
+
+    if (pending_call) {
+      BatchCallEntry* entry = new BatchCallEntry;
+      entry->batch = batch;
+      entry->index = i;
+      // This returns false only when unable to allocate memory.
+      const bool success = dbus_pending_call_set_notify(
+          pending_call,
+          &ObjectProxy::OnBatchCallIsCompleteThunk,
+          entry,
+          NULL);
+      CHECK(success) << "Unable to allocate memory";
+      dbus_pending_call_unref(pending_call);
+    } else {
+      // The response of a call that could not be sent stays NULL.
+      batch->num_pending_calls--;
+    }
+    dbus_message_unref(request_messages[i]);
+  }
+
+  if (batch->num_pending_calls == 0) {
+    bus_->PostTaskToOriginThread(
+        FROM_HERE,
+        base::Bind(&ObjectProxy::RunBatchResponseCallback,
+                   this,
+                   batch->response_callback,
+                   batch->start_time,
+                   batch->response_messages));
+    delete batch;
+  }
+}
+
+void ObjectProxy::OnBatchCallIsComplete(BatchCallData* batch,
+                                        size_t index,
+                                        DBusMessage* response_message) {
+  bus_->AssertOnDBusThread();
+
+  batch->response_messages[index] = response_message;
+  if (--batch->num_pending_calls > 0)
+    return;
+
+  // Deliver all the responses with a single task.
+  bus_->PostTaskToOriginThread(
+      FROM_HERE,
+      base::Bind(&ObjectProxy::RunBatchResponseCallback,
+                 this,
+                 batch->response_callback,
+                 batch->start_time,
+                 batch->response_messages));
+  delete batch;
+}
+
+void ObjectProxy::RunBatchResponseCallback(
+    BatchResponseCallback response_callback,
+    base::TimeTicks start_time,
+    const std::vector<DBusMessage*>& response_messages) {
+  bus_->AssertOnOriginThread();
+
+  // Owns the successful responses until the callback returns.
+  ScopedVector<Response> responses;
+  std::vector<Response*> results;
+  for (size_t i = 0; i < response_messages.size(); ++i) {
+    DBusMessage* response_message = response_messages[i];
+    if (!response_message) {
+      results.push_back(NULL);
+    } else if (dbus_message_get_type(response_message) ==
+               DBUS_MESSAGE_TYPE_ERROR) {
+      // This will take |response_message| and release (unref) it.
+      scoped_ptr<ErrorResponse> error_response(
+          ErrorResponse::FromRawMessage(response_message));
+      OnCallMethodError(base::Bind(&EmptyResponseCallbackBody),
+                        error_response.get());
+      results.push_back(NULL);
+    } else {
+      // This will take |response_message| and release (unref) it.
+      Response* response = Response::FromRawMessage(response_message);
+      responses.push_back(response);
+      results.push_back(response);
+    }
+  }
+  response_callback.Run(results);
+
+  // Record time spent for the batch, and its size.
+  UMA_HISTOGRAM_TIMES("DBus.AsyncBatchMethodCallTime",
+                      base::TimeTicks::Now() - start_time);
+  UMA_HISTOGRAM_COUNTS_100("DBus.AsyncBatchMethodCallCount",
+                           response_messages.size());
+}
+
+void ObjectProxy::OnBatchCallIsCompleteThunk(DBusPendingCall* pending_call,
+                                             void* user_data) {
+  BatchCallEntry* entry = reinterpret_cast<BatchCallEntry*>(user_data);
+  ObjectProxy* self = entry->batch->object_proxy;
+  self->OnBatchCallIsComplete(entry->batch,
+                              entry->index,
+                              dbus_pending_call_steal_reply(pending_call));
+  delete entry;
+}
+
 void ObjectProxy::ConnectToSignalInternal(
     const std::string& interface_name,
     const std::string& signal_name,
@@ -11,6 +11,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
@@ -67,6 +68,12 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
   // Called when the response is returned. Used for CallMethod().
   typedef base::Callback<void(Response*)> ResponseCallback;
 
+  // Called when the responses of all the calls of CallMethods() are
+  // returned. The responses are in the order of the calls; a response is NULL
+  // if its call failed.
+  typedef base::Callback<void(const std::vector<Response*>&)>
+      BatchResponseCallback;
+
   // Called when a signal is received. Signal* is the incoming signal.
   typedef base::Callback<void (Signal*)> SignalCallback;
 
@@ -124,6 +131,19 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
                                            ResponseCallback callback,
                                            ErrorCallback error_callback);
 
+  // Requests to call several methods of the remote object at once.
+  //
+  // The calls are sent one after another in a single task of the D-Bus
+  // thread, without waiting for the replies of the previous ones, and
+  // |callback| is called once in the origin thread with all of the
+  // responses. This is cheaper than calling CallMethod() for each of them
+  // when many calls are made together, e.g. reading properties at startup.
+  //
+  // Must be called in the origin thread.
+  virtual void CallMethods(const std::vector<MethodCall*>& method_calls,
+                           int timeout_ms,
+                           BatchResponseCallback callback);
+
   // Requests to connect to the signal from the remote object, replacing
   // any previous |signal_callback| connected to that signal.
   //
@@ -197,6 +217,52 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
   static void OnPendingCallIsCompleteThunk(DBusPendingCall* pending_call,
                                            void* user_data);
 
+  // State of a CallMethods() request, owned by the D-Bus thread until all
+  // the replies are in.
+  struct BatchCallData {
+    BatchCallData(ObjectProxy* in_object_proxy,
+                  BatchResponseCallback in_response_callback,
+                  size_t num_calls,
+                  base::TimeTicks in_start_time);
+    ~BatchCallData();
+
+    ObjectProxy* object_proxy;
+    BatchResponseCallback response_callback;
+    base::TimeTicks start_time;
+    // The reply messages, NULL until received or if the call failed.
+    std::vector<DBusMessage*> response_messages;
+    size_t num_pending_calls;
+  };
+
+  // Data passed to OnBatchCallIsCompleteThunk() for each call.
+  struct BatchCallEntry {
+    BatchCallData* batch;
+    size_t index;
+  };
+
+  // Starts the calls of CallMethods() in the D-Bus thread.
+  void StartAsyncMethodCalls(int timeout_ms,
+                             const std::vector<DBusMessage*>& request_messages,
+                             BatchResponseCallback response_callback,
+                             base::TimeTicks start_time);
+
+  // Called when the reply of one of the calls of |batch| is received, or
+  // the call failed. Posts the responses to the origin thread once the last
+  // reply is in.
+  void OnBatchCallIsComplete(BatchCallData* batch,
+                             size_t index,
+                             DBusMessage* response_message);
+
+  // Runs the callback of CallMethods() with the response messages.
+  void RunBatchResponseCallback(
+      BatchResponseCallback response_callback,
+      base::TimeTicks start_time,
+      const std::vector<DBusMessage*>& response_messages);
+
+  // Redirects the function call to OnBatchCallIsComplete().
+  static void OnBatchCallIsCompleteThunk(DBusPendingCall* pending_call,
+                                         void* user_data);
+
   // Helper function for ConnectToSignal().
   void ConnectToSignalInternal(
       const std::string& interface_name,
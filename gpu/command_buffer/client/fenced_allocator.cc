@@ -16,7 +16,8 @@ const FencedAllocator::Offset FencedAllocator::kInvalidOffset;
 
 FencedAllocator::FencedAllocator(unsigned int size,
                                  CommandBufferHelper *helper)
-    : helper_(helper) {
+    : helper_(helper),
+      num_pending_blocks_(0) {
   Block block = { FREE, 0, size, kUnusedToken };
   blocks_.push_back(block);
 }
@@ -34,21 +35,28 @@ FencedAllocator::~FencedAllocator() {
 }
 
 // Looks for a non-allocated block that is big enough. Search in the FREE
-// blocks first (for direct usage), first-fit, then in the FREE_PENDING_TOKEN
-// blocks, waiting for them. The current implementation isn't smart about
-// optimizing what to wait for, just looks inside the block in order (first-fit
-// as well).
+// blocks first (for direct usage), first-fit, then in the blocks whose token
+// has already passed, then in the FREE_PENDING_TOKEN blocks, waiting for them.
+// The current implementation isn't smart about optimizing what to wait for,
+// just looks inside the block in order (first-fit as well).
 FencedAllocator::Offset FencedAllocator::Alloc(unsigned int size) {
   // Similarly to malloc, an allocation of 0 allocates at least 1 byte, to
   // return different pointers every time.
   if (size == 0) size = 1;
 
   // Try first to allocate in a free block.
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    Block &block = blocks_[i];
-    if (block.state == FREE && block.size >= size) {
-      return AllocInBlock(i, size);
-    }
+  Offset offset = AllocInFreeBlock(size);
+  if (offset != kInvalidOffset)
+    return offset;
+
+  // Reclaiming the blocks whose token has passed doesn't need to wait, unlike
+  // the loop below which waits for the first pending block it finds.
+  unsigned int num_pending_blocks = num_pending_blocks_;
+  FreeUnused();
+  if (num_pending_blocks_ != num_pending_blocks) {
+    offset = AllocInFreeBlock(size);
+    if (offset != kInvalidOffset)
+      return offset;
   }
 
   // No free block is available. Look for blocks pending tokens, and wait for
@@ -68,6 +76,8 @@ FencedAllocator::Offset FencedAllocator::Alloc(unsigned int size) {
 void FencedAllocator::Free(FencedAllocator::Offset offset) {
   BlockIndex index = GetBlockByOffset(offset);
   GPU_DCHECK_NE(blocks_[index].state, FREE);
+  if (blocks_[index].state == FREE_PENDING_TOKEN)
+    --num_pending_blocks_;
   blocks_[index].state = FREE;
   CollapseFreeBlock(index);
 }
@@ -77,6 +87,8 @@ void FencedAllocator::FreePendingToken(
     FencedAllocator::Offset offset, int32 token) {
   BlockIndex index = GetBlockByOffset(offset);
   Block &block = blocks_[index];
+  if (block.state != FREE_PENDING_TOKEN)
+    ++num_pending_blocks_;
   block.state = FREE_PENDING_TOKEN;
   block.token = token;
 }
@@ -163,16 +175,22 @@ FencedAllocator::BlockIndex FencedAllocator::WaitForTokenAndFreeBlock(
   GPU_DCHECK_EQ(block.state, FREE_PENDING_TOKEN);
   helper_->WaitForToken(block.token);
   block.state = FREE;
+  --num_pending_blocks_;
   return CollapseFreeBlock(index);
 }
 
 // Frees any blocks pending a token for which the token has been read.
 void FencedAllocator::FreeUnused() {
+  // This is called before most allocations, so skip the scan when there is
+  // nothing to reclaim.
+  if (!num_pending_blocks_)
+    return;
   int32 last_token_read = helper_->last_token_read();
   for (unsigned int i = 0; i < blocks_.size();) {
     Block& block = blocks_[i];
     if (block.state == FREE_PENDING_TOKEN && block.token <= last_token_read) {
       block.state = FREE;
+      --num_pending_blocks_;
       i = CollapseFreeBlock(i);
     } else {
       ++i;
@@ -180,6 +198,16 @@ void FencedAllocator::FreeUnused() {
   }
 }
 
+FencedAllocator::Offset FencedAllocator::AllocInFreeBlock(unsigned int size) {
+  for (unsigned int i = 0; i < blocks_.size(); ++i) {
+    Block &block = blocks_[i];
+    if (block.state == FREE && block.size >= size) {
+      return AllocInBlock(i, size);
+    }
+  }
+  return kInvalidOffset;
+}
+
 // If the block is exactly the requested size, simply mark it IN_USE, otherwise
 // split it and mark the first one (of the requested size) IN_USE.
 FencedAllocator::Offset FencedAllocator::AllocInBlock(BlockIndex index,
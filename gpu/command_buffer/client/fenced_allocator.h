@@ -115,6 +115,10 @@ class GPU_EXPORT FencedAllocator {
   // Gets the index of a memory block, given its offset.
   BlockIndex GetBlockByOffset(Offset offset);
 
+  // Allocates size bytes in the first FREE block that is big enough, without
+  // waiting. Returns kInvalidOffset if there is none.
+  Offset AllocInFreeBlock(unsigned int size);
+
   // Collapse a free block with its neighbours if they are free. Returns the
   // index of the collapsed block.
   // NOTE: this will invalidate block indices.
@@ -135,6 +139,9 @@ class GPU_EXPORT FencedAllocator {
   CommandBufferHelper *helper_;
   Container blocks_;
 
+  // Number of blocks in the FREE_PENDING_TOKEN state.
+  unsigned int num_pending_blocks_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(FencedAllocator);
 };
 
@@ -271,6 +271,40 @@ TEST_F(FencedAllocatorTest, FreeUnused) {
   EXPECT_FALSE(allocator_->InUse());
 }
 
+// Checks that Alloc reuses a block whose token has passed rather than wait
+// for an earlier block whose token hasn't.
+TEST_F(FencedAllocatorTest, AllocPrefersPassedTokens) {
+  const unsigned int kSize = 16;
+  const unsigned int kAllocCount = kBufferSize / kSize;
+  CHECK(kAllocCount * kSize == kBufferSize);
+
+  FencedAllocator::Offset offsets[kAllocCount];
+  for (unsigned int i = 0; i < kAllocCount; ++i) {
+    offsets[i] = allocator_->Alloc(kSize);
+    EXPECT_NE(FencedAllocator::kInvalidOffset, offsets[i]);
+  }
+
+  // Free the last block and let its token pass.
+  int32 token = helper_.get()->InsertToken();
+  allocator_->FreePendingToken(offsets[kAllocCount - 1], token);
+  helper_->Finish();
+  EXPECT_LE(token, GetToken());
+
+  // Free the first block with a token that isn't processed yet.
+  int32 pending_token = helper_.get()->InsertToken();
+  allocator_->FreePendingToken(offsets[0], pending_token);
+
+  EXPECT_EQ(offsets[kAllocCount - 1], allocator_->Alloc(kSize));
+  EXPECT_GT(pending_token, GetToken());
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  allocator_->Free(offsets[kAllocCount - 1]);
+  for (unsigned int i = 1; i < kAllocCount - 1; ++i)
+    allocator_->Free(offsets[i]);
+  // The first block is still pending; destroying the allocator waits for it.
+  EXPECT_TRUE(allocator_->InUse());
+}
+
 // Tests GetLargestFreeSize
 TEST_F(FencedAllocatorTest, TestGetLargestFreeSize) {
   EXPECT_TRUE(allocator_->CheckConsistency());
@@ -1526,6 +1526,17 @@ void GLES2Implementation::CompressedTexSubImage2D(
 
 namespace {
 
+// Texture uploads larger than this are sent as several commands, so that the
+// service can run other contexts in between instead of stalling on one large
+// image.
+const uint32 kMaxTextureUploadChunkSize = 512 * 1024;
+
+// Returns how much transfer buffer to ask for to upload |size| bytes of rows
+// of |padded_row_size| bytes. This is at least one row.
+uint32 ComputeTextureUploadChunkSize(uint32 size, uint32 padded_row_size) {
+  return std::min(size, std::max(kMaxTextureUploadChunkSize, padded_row_size));
+}
+
 void CopyRectToBuffer(
     const void* pixels,
     uint32 height,
@@ -1617,7 +1628,9 @@ void GLES2Implementation::TexImage2D(
   }
 
   // Check if we can send it all at once.
-  ScopedTransferBufferPtr buffer(size, helper_, transfer_buffer_);
+  ScopedTransferBufferPtr buffer(
+      ComputeTextureUploadChunkSize(size, padded_row_size),
+      helper_, transfer_buffer_);
   if (!buffer.valid()) {
     return;
   }
@@ -1694,7 +1707,9 @@ void GLES2Implementation::TexSubImage2D(
         unpack_skip_pixels_ * group_size;
   }
 
-  ScopedTransferBufferPtr buffer(temp_size, helper_, transfer_buffer_);
+  ScopedTransferBufferPtr buffer(
+      ComputeTextureUploadChunkSize(temp_size, padded_row_size),
+      helper_, transfer_buffer_);
   TexSubImage2DImpl(
       target, level, xoffset, yoffset, width, height, format, type,
       unpadded_row_size, pixels, src_padded_row_size, GL_FALSE, &buffer,
@@ -1729,7 +1744,8 @@ void GLES2Implementation::TexSubImage2DImpl(
     unsigned int desired_size =
         buffer_padded_row_size * (height - 1) + unpadded_row_size;
     if (!buffer->valid() || buffer->size() == 0) {
-      buffer->Reset(desired_size);
+      buffer->Reset(ComputeTextureUploadChunkSize(
+          desired_size, buffer_padded_row_size));
       if (!buffer->valid()) {
         return;
       }
@@ -9,6 +9,11 @@
 
 namespace gpu {
 
+// Number of allocations that wait for the service before the ring buffer is
+// grown. One wait may just be a burst; repeated waits mean the buffer is too
+// small for the workload.
+static const unsigned int kWaitingAllocationsBeforeGrowing = 2;
+
 AlignedRingBuffer::~AlignedRingBuffer() {
 }
 
@@ -22,6 +27,7 @@ TransferBuffer::TransferBuffer(
       alignment_(0),
       size_to_flush_(0),
       bytes_since_last_flush_(0),
+      allocations_that_waited_(0),
       buffer_id_(-1),
       result_buffer_(NULL),
       result_shm_offset_(0),
@@ -94,6 +100,7 @@ void TransferBuffer::AllocateRingBuffer(unsigned int size) {
       buffer_id_ = id;
       result_buffer_ = buffer_.ptr;
       result_shm_offset_ = 0;
+      allocations_that_waited_ = 0;
       return;
     }
     // we failed so don't try larger than this.
@@ -149,11 +156,27 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
   }
 }
 
+void TransferBuffer::GrowIfAllocationWouldWait(unsigned int size) {
+  if (!HaveBuffer() || buffer_.size >= max_buffer_size_)
+    return;
+  size = std::min(size, ring_buffer_->GetLargestFreeOrPendingSize());
+  if (ring_buffer_->GetLargestFreeSizeNoWaiting() >= size)
+    return;
+  if (++allocations_that_waited_ < kWaitingAllocationsBeforeGrowing)
+    return;
+
+  // Growing waits for the service too, but only once.
+  unsigned int new_size = std::min(buffer_.size * 2, max_buffer_size_);
+  Free();
+  AllocateRingBuffer(new_size);
+}
+
 void* TransferBuffer::AllocUpTo(
     unsigned int size, unsigned int* size_allocated) {
   GPU_DCHECK(size_allocated);
 
   ReallocateRingBuffer(size);
+  GrowIfAllocationWouldWait(size);
 
   if (!HaveBuffer()) {
     return NULL;
@@ -167,6 +190,7 @@ void* TransferBuffer::AllocUpTo(
 
 void* TransferBuffer::Alloc(unsigned int size) {
   ReallocateRingBuffer(size);
+  GrowIfAllocationWouldWait(size);
 
   if (!HaveBuffer()) {
     return NULL;
@@ -119,6 +119,10 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
 
   void AllocateRingBuffer(unsigned int size);
 
+  // Grows the ring buffer if allocations keep having to wait for the service
+  // to consume earlier data, so that sustained uploads stop stalling on it.
+  void GrowIfAllocationWouldWait(unsigned int size);
+
   CommandBufferHelper* helper_;
   scoped_ptr<AlignedRingBuffer> ring_buffer_;
 
@@ -143,6 +147,10 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   // Number of bytes since we last flushed.
   unsigned int bytes_since_last_flush_;
 
+  // Number of allocations since the buffer was allocated that had to wait
+  // for the service.
+  unsigned int allocations_that_waited_;
+
   // the current buffer.
   gpu::Buffer buffer_;
 
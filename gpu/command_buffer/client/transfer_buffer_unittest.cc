@@ -347,6 +347,37 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   transfer_buffer_->FreePendingToken(ptr, 1);
 }
 
+TEST_F(TransferBufferExpandContractTest, GrowsWhenAllocationsWait) {
+  const size_t kSize = 100;
+  unsigned int size_allocated = 0;
+  void* ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  transfer_buffer_->FreePendingToken(ptr, 1);
+
+  // The data above is still pending, so this has to wait for it once.
+  ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize, size_allocated);
+  transfer_buffer_->FreePendingToken(ptr, 1);
+
+  // Waiting again grows the buffer instead.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize * 2, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize, size_allocated);
+  EXPECT_EQ(kStartTransferBufferSize * 2 - kStartingOffset,
+            transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+  transfer_buffer_->FreePendingToken(ptr, 1);
+}
+
 TEST_F(TransferBufferExpandContractTest, Contract) {
   // Check it starts at starting size.
   EXPECT_EQ(
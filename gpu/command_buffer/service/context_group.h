@@ -27,6 +27,7 @@ class GLES2Decoder;
 class FramebufferManager;
 class MailboxManager;
 class RenderbufferManager;
+class ProgramCache;
 class ProgramManager;
 class ShaderManager;
 class TextureManager;
@@ -55,6 +56,13 @@ class GPU_EXPORT ContextGroup : public base::RefCounted<ContextGroup> {
     return mailbox_manager_.get();
   }
 
+  // Sets the cache programs are linked through, if the driver supports
+  // program binaries. Must be called before Initialize. The cache must
+  // outlive the group.
+  void set_program_cache(ProgramCache* program_cache) {
+    program_cache_ = program_cache;
+  }
+
   bool bind_generates_resource() {
     return bind_generates_resource_;
   }
@@ -124,6 +132,7 @@ class GPU_EXPORT ContextGroup : public base::RefCounted<ContextGroup> {
   bool QueryGLFeatureU(GLenum pname, GLint min_required, uint32* v);
 
   scoped_refptr<MailboxManager> mailbox_manager_;
+  ProgramCache* program_cache_;
 
   // Whether or not this context is initialized.
   int num_contexts_;
@@ -462,6 +462,11 @@ void FeatureInfo::AddFeatures(const char* desired_features) {
     validators_.vertex_attribute.AddValue(GL_VERTEX_ATTRIB_ARRAY_DIVISOR_ANGLE);
   }
 
+  if (ext.Have("GL_OES_get_program_binary") ||
+      ext.Have("GL_ARB_get_program_binary")) {
+    feature_flags_.program_binary = true;
+  }
+
   if (!disallowed_features_.swap_buffer_complete_callback)
     AddExtensionString("GL_CHROMIUM_swapbuffers_complete_callback");
 }
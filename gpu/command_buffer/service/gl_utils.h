@@ -85,6 +85,9 @@
 // GL_CHROMIUM_command_buffer_query
 #define GL_COMMANDS_ISSUED_CHROMIUM            0x84F2
 
+// GL_OES_get_program_binary
+#define GL_PROGRAM_BINARY_LENGTH_OES           0x8741
+
 
 #define GL_GLEXT_PROTOTYPES 1
 
@@ -3182,6 +3182,10 @@ void GLES2DecoderImpl::DoActiveTexture(GLenum texture_unit) {
     SetGLError(GL_INVALID_ENUM, "glActiveTexture: texture_unit out of range.");
     return;
   }
+  // Internal uses of glActiveTexture restore the active unit, so the driver
+  // already has it.
+  if (texture_index == active_texture_unit_)
+    return;
   active_texture_unit_ = texture_index;
   glActiveTexture(texture_unit);
 }
@@ -4805,6 +4809,10 @@ void GLES2DecoderImpl::DoUseProgram(GLuint program) {
     }
     service_id = info->service_id();
   }
+  // Clients often use the same program for consecutive draws. Internal uses
+  // of glUseProgram restore the current program, so there is nothing to do.
+  if (info == current_program_)
+    return;
   if (current_program_) {
     program_manager()->UnuseProgram(shader_manager(), current_program_);
   }
@@ -1907,6 +1907,26 @@ TEST_F(GLES2DecoderTest, ActiveTextureValidArgs) {
   EXPECT_EQ(GL_NO_ERROR, GetGLError());
 }
 
+TEST_F(GLES2DecoderTest, ActiveTextureSkipsRedundantCalls) {
+  EXPECT_CALL(*gl_, ActiveTexture(GL_TEXTURE1))
+      .Times(1)
+      .RetiresOnSaturation();
+  ActiveTexture cmd;
+  cmd.Init(GL_TEXTURE1);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+}
+
+TEST_F(GLES2DecoderWithShaderTest, UseProgramSkipsRedundantCalls) {
+  // The fixture already made the program current.
+  EXPECT_CALL(*gl_, UseProgram(_)).Times(0);
+  UseProgram cmd;
+  cmd.Init(client_program_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+}
+
 TEST_F(GLES2DecoderTest, ActiveTextureInvalidArgs) {
   EXPECT_CALL(*gl_, ActiveTexture(_)).Times(0);
   SpecializedSetup<ActiveTexture, 0>(false);
@@ -13,6 +13,9 @@ const char kCompileShaderAlwaysSucceeds[]   = "compile-shader-always-succeeds";
 // Disable the GLSL translator.
 const char kDisableGLSLTranslator[]         = "disable-glsl-translator";
 
+// Always link programs rather than reuse the binaries of earlier links.
+const char kDisableGpuProgramCache[]        = "disable-gpu-program-cache";
+
 // Turn on Logging GPU commands.
 const char kEnableGPUCommandLogging[]       = "enable-gpu-command-logging";
 
@@ -25,6 +28,7 @@ const char kEnforceGLMinimums[]             = "enforce-gl-minimums";
 const char* kGpuSwitches[] = {
   kCompileShaderAlwaysSucceeds,
   kDisableGLSLTranslator,
+  kDisableGpuProgramCache,
   kEnableGPUCommandLogging,
   kEnableGPUDebugging,
   kEnforceGLMinimums,
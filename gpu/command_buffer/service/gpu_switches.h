@@ -14,6 +14,7 @@ namespace switches {
 
 GPU_EXPORT extern const char kCompileShaderAlwaysSucceeds[];
 GPU_EXPORT extern const char kDisableGLSLTranslator[];
+GPU_EXPORT extern const char kDisableGpuProgramCache[];
 GPU_EXPORT extern const char kEnableGPUCommandLogging[];
 GPU_EXPORT extern const char kEnableGPUDebugging[];
 GPU_EXPORT extern const char kEnforceGLMinimums[];
@@ -0,0 +1,114 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/program_cache.h"
+
+#include "base/logging.h"
+#include "base/sha1.h"
+#include "base/string_number_conversions.h"
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+// Appends |str| to |data| such that no two sequences of strings append the
+// same data.
+void AppendField(std::string* data, const std::string& str) {
+  data->append(base::Uint64ToString(str.size()));
+  data->push_back(':');
+  data->append(str);
+}
+
+}  // anonymous namespace
+
+const size_t ProgramCache::kDefaultMaxSizeBytes = 6 * 1024 * 1024;
+
+ProgramCache::ProgramBinary::ProgramBinary()
+    : format(0) {
+}
+
+ProgramCache::ProgramBinary::~ProgramBinary() {
+}
+
+ProgramCache::ProgramCache(size_t max_size_bytes)
+    : max_size_bytes_(max_size_bytes),
+      size_bytes_(0),
+      binaries_(BinaryCache::NO_AUTO_EVICT) {
+}
+
+ProgramCache::~ProgramCache() {
+}
+
+// static
+std::string ProgramCache::ComputeKey(
+    const std::string& vertex_source,
+    const std::string& fragment_source,
+    const std::map<std::string, GLint>& bind_attrib_location_map) {
+  std::string data;
+  AppendField(&data, vertex_source);
+  AppendField(&data, fragment_source);
+  for (std::map<std::string, GLint>::const_iterator it =
+           bind_attrib_location_map.begin();
+       it != bind_attrib_location_map.end(); ++it) {
+    AppendField(&data, it->first);
+    AppendField(&data, base::IntToString(it->second));
+  }
+  return base::SHA1HashString(data);
+}
+
+bool ProgramCache::LoadProgram(const std::string& key, GLuint program) {
+  BinaryCache::iterator it = binaries_.Get(key);
+  if (it == binaries_.end())
+    return false;
+
+  const ProgramBinary& binary = it->second;
+  glProgramBinary(program, binary.format, binary.data.data(),
+                  binary.data.size());
+  GLint success = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (success != GL_TRUE) {
+    // The driver refused its own binary; don't offer it again.
+    Evict(key);
+    return false;
+  }
+  return true;
+}
+
+void ProgramCache::SaveProgram(const std::string& key, GLuint program) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+  if (length <= 0 || static_cast<size_t>(length) > max_size_bytes_)
+    return;
+
+  Evict(key);
+  ProgramBinary binary;
+  binary.data.resize(length);
+  GLsizei written = 0;
+  glGetProgramBinary(program, length, &written, &binary.format,
+                     &binary.data[0]);
+  if (written <= 0)
+    return;
+  binary.data.resize(written);
+
+  size_bytes_ += binary.data.size();
+  binaries_.Put(key, binary);
+  while (size_bytes_ > max_size_bytes_) {
+    BinaryCache::reverse_iterator oldest = binaries_.rbegin();
+    DCHECK(oldest != binaries_.rend());
+    size_bytes_ -= oldest->second.data.size();
+    binaries_.Erase(oldest);
+  }
+}
+
+void ProgramCache::Evict(const std::string& key) {
+  BinaryCache::iterator it = binaries_.Peek(key);
+  if (it == binaries_.end())
+    return;
+  size_bytes_ -= it->second.data.size();
+  binaries_.Erase(it);
+}
+
+}  // namespace gles2
+}  // namespace gpu
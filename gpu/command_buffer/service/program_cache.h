@@ -0,0 +1,75 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_PROGRAM_CACHE_H_
+#define GPU_COMMAND_BUFFER_SERVICE_PROGRAM_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/mru_cache.h"
+#include "gpu/command_buffer/service/gl_utils.h"
+#include "gpu/gpu_export.h"
+
+namespace gpu {
+namespace gles2 {
+
+// Keeps the driver binaries of linked programs, so that linking the same
+// shaders again, in any context of the process, is a glProgramBinary call
+// instead of a full link by the driver. Only used when the driver supports
+// program binaries. The least recently used binaries are dropped once they
+// take more than |max_size_bytes|.
+//
+// Binaries are only valid for the driver that produced them, which doesn't
+// change during the life of the process, so the driver isn't part of the key.
+class GPU_EXPORT ProgramCache {
+ public:
+  static const size_t kDefaultMaxSizeBytes;
+
+  explicit ProgramCache(size_t max_size_bytes);
+  ~ProgramCache();
+
+  // Returns the key of a program linked from the given shader sources, with
+  // the given glBindAttribLocation bindings.
+  static std::string ComputeKey(
+      const std::string& vertex_source,
+      const std::string& fragment_source,
+      const std::map<std::string, GLint>& bind_attrib_location_map);
+
+  // Loads the binary saved for |key| into |program|. Returns true if
+  // |program| is now linked. On failure, |program| must be linked normally.
+  bool LoadProgram(const std::string& key, GLuint program);
+
+  // Saves the binary of |program|, which was just linked, for |key|.
+  void SaveProgram(const std::string& key, GLuint program);
+
+  size_t size_bytes() const {
+    return size_bytes_;
+  }
+
+ private:
+  struct ProgramBinary {
+    ProgramBinary();
+    ~ProgramBinary();
+
+    GLenum format;
+    std::string data;
+  };
+
+  typedef base::MRUCache<std::string, ProgramBinary> BinaryCache;
+
+  void Evict(const std::string& key);
+
+  size_t max_size_bytes_;
+  size_t size_bytes_;
+  BinaryCache binaries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProgramCache);
+};
+
+}  // namespace gles2
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_PROGRAM_CACHE_H_
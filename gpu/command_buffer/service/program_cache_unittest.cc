@@ -0,0 +1,121 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/program_cache.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "gpu/command_buffer/common/gl_mock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::SetArgumentPointee;
+
+namespace gpu {
+namespace gles2 {
+
+class ProgramCacheTest : public testing::Test {
+ public:
+  static const GLenum kBinaryFormat = 0x1234;
+  static const size_t kMaxSizeBytes = 1000;
+
+  ProgramCacheTest() : cache_(kMaxSizeBytes) { }
+
+ protected:
+  virtual void SetUp() {
+    gl_.reset(new ::testing::StrictMock< ::gfx::MockGLInterface>());
+    ::gfx::GLInterface::SetGLInterface(gl_.get());
+  }
+
+  virtual void TearDown() {
+    ::gfx::GLInterface::SetGLInterface(NULL);
+    gl_.reset();
+  }
+
+  void SaveProgram(const std::string& key, GLuint program, GLint length) {
+    EXPECT_CALL(*gl_, GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, _))
+        .WillOnce(SetArgumentPointee<2>(length))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*gl_, GetProgramBinary(program, length, _, _, _))
+        .WillOnce(DoAll(SetArgumentPointee<2>(length),
+                        SetArgumentPointee<3>(kBinaryFormat)))
+        .RetiresOnSaturation();
+    cache_.SaveProgram(key, program);
+  }
+
+  void ExpectLoad(GLuint program, GLint length, GLint link_status) {
+    EXPECT_CALL(*gl_, ProgramBinary(program, kBinaryFormat, _, length))
+        .Times(1)
+        .RetiresOnSaturation();
+    EXPECT_CALL(*gl_, GetProgramiv(program, GL_LINK_STATUS, _))
+        .WillOnce(SetArgumentPointee<2>(link_status))
+        .RetiresOnSaturation();
+  }
+
+  scoped_ptr< ::testing::StrictMock< ::gfx::MockGLInterface> > gl_;
+  ProgramCache cache_;
+};
+
+// GCC requires these declarations, but MSVC requires they not be present
+#ifndef COMPILER_MSVC
+const GLenum ProgramCacheTest::kBinaryFormat;
+const size_t ProgramCacheTest::kMaxSizeBytes;
+#endif
+
+TEST_F(ProgramCacheTest, ComputeKey) {
+  std::map<std::string, GLint> bindings;
+  std::string key = ProgramCache::ComputeKey("vs", "fs", bindings);
+  EXPECT_EQ(key, ProgramCache::ComputeKey("vs", "fs", bindings));
+  EXPECT_NE(key, ProgramCache::ComputeKey("vsf", "s", bindings));
+  bindings["a_position"] = 0;
+  EXPECT_NE(key, ProgramCache::ComputeKey("vs", "fs", bindings));
+}
+
+TEST_F(ProgramCacheTest, LoadSavedProgram) {
+  const GLuint kProgram1 = 11;
+  const GLuint kProgram2 = 12;
+  EXPECT_FALSE(cache_.LoadProgram("key", kProgram2));
+
+  SaveProgram("key", kProgram1, 100);
+  EXPECT_EQ(100u, cache_.size_bytes());
+
+  ExpectLoad(kProgram2, 100, GL_TRUE);
+  EXPECT_TRUE(cache_.LoadProgram("key", kProgram2));
+}
+
+TEST_F(ProgramCacheTest, EmptyBinaryNotSaved) {
+  const GLuint kProgram = 11;
+  EXPECT_CALL(*gl_, GetProgramiv(kProgram, GL_PROGRAM_BINARY_LENGTH_OES, _))
+      .WillOnce(SetArgumentPointee<2>(0));
+  cache_.SaveProgram("key", kProgram);
+  EXPECT_EQ(0u, cache_.size_bytes());
+  EXPECT_FALSE(cache_.LoadProgram("key", kProgram));
+}
+
+TEST_F(ProgramCacheTest, RejectedBinaryDropped) {
+  const GLuint kProgram = 11;
+  SaveProgram("key", kProgram, 100);
+  ExpectLoad(kProgram, 100, GL_FALSE);
+  EXPECT_FALSE(cache_.LoadProgram("key", kProgram));
+  EXPECT_EQ(0u, cache_.size_bytes());
+  EXPECT_FALSE(cache_.LoadProgram("key", kProgram));
+}
+
+TEST_F(ProgramCacheTest, LeastRecentlyUsedEvicted) {
+  const GLuint kProgram = 11;
+  SaveProgram("a", kProgram, 400);
+  SaveProgram("b", kProgram, 400);
+  ExpectLoad(kProgram, 400, GL_TRUE);
+  EXPECT_TRUE(cache_.LoadProgram("a", kProgram));
+
+  // "b" is the least recently used, so it makes room for "c".
+  SaveProgram("c", kProgram, 400);
+  EXPECT_EQ(800u, cache_.size_bytes());
+  EXPECT_FALSE(cache_.LoadProgram("b", kProgram));
+  ExpectLoad(kProgram, 400, GL_TRUE);
+  EXPECT_TRUE(cache_.LoadProgram("a", kProgram));
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -10,10 +10,13 @@
 #include "base/basictypes.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
 #include "base/string_number_conversions.h"
+#include "base/time.h"
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/program_cache.h"
 
 namespace gpu {
 namespace gles2 {
@@ -30,6 +33,14 @@ static int ShaderTypeToIndex(GLenum shader_type) {
   }
 }
 
+// Returns the source the driver compiled for |info|.
+static std::string GetShaderSource(const ShaderManager::ShaderInfo* info) {
+  const std::string* source = info->translated_source();
+  if (!source)
+    source = info->source();
+  return source ? *source : std::string();
+}
+
 ProgramManager::ProgramInfo::UniformInfo::UniformInfo(
     GLsizei _size,
     GLenum _type,
@@ -260,10 +271,36 @@ bool ProgramManager::ProgramInfo::Link() {
     return false;
   }
   ExecuteBindAttribLocationCalls();
-  glLinkProgram(service_id());
-  GLint success = 0;
-  glGetProgramiv(service_id(), GL_LINK_STATUS, &success);
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  ProgramCache* cache = manager_->program_cache_;
+  std::string cache_key;
+  bool loaded = false;
+  if (cache) {
+    cache_key = ProgramCache::ComputeKey(
+        GetShaderSource(
+            attached_shaders_[ShaderTypeToIndex(GL_VERTEX_SHADER)].get()),
+        GetShaderSource(
+            attached_shaders_[ShaderTypeToIndex(GL_FRAGMENT_SHADER)].get()),
+        bind_attrib_location_map_);
+    loaded = cache->LoadProgram(cache_key, service_id());
+  }
+  GLint success = GL_TRUE;
+  if (!loaded) {
+    glLinkProgram(service_id());
+    glGetProgramiv(service_id(), GL_LINK_STATUS, &success);
+    if (cache && success == GL_TRUE)
+      cache->SaveProgram(cache_key, service_id());
+  }
   if (success == GL_TRUE) {
+    base::TimeDelta link_time = base::TimeTicks::Now() - start_time;
+    if (loaded) {
+      UMA_HISTOGRAM_TIMES("GPU.ProgramCache.LoadBinaryTime", link_time);
+    } else {
+      UMA_HISTOGRAM_TIMES("GPU.ProgramLinkTime", link_time);
+    }
+    if (cache)
+      UMA_HISTOGRAM_BOOLEAN("GPU.ProgramCache.Hit", loaded);
     Update();
   } else {
     UpdateLogInfo();
@@ -679,8 +716,9 @@ ProgramManager::ProgramInfo::~ProgramInfo() {
 // by at least 1 bit each time chrome is run.
 static int uniform_random_offset_ = 3;
 
-ProgramManager::ProgramManager()
-    : uniform_swizzle_(uniform_random_offset_++ % 15),
+ProgramManager::ProgramManager(ProgramCache* program_cache)
+    : program_cache_(program_cache),
+      uniform_swizzle_(uniform_random_offset_++ % 15),
       program_info_count_(0),
       have_context_(true) {
 }
@@ -20,6 +20,8 @@
 namespace gpu {
 namespace gles2 {
 
+class ProgramCache;
+
 // Tracks the Programs.
 //
 // NOTE: To support shared resources an instance of this class will
@@ -289,7 +291,8 @@ class GPU_EXPORT ProgramManager {
     std::map<std::string, GLint> bind_attrib_location_map_;
   };
 
-  ProgramManager();
+  // |program_cache| may be NULL; otherwise it must outlive this manager.
+  explicit ProgramManager(ProgramCache* program_cache);
   ~ProgramManager();
 
   // Must call before destruction.
@@ -334,6 +337,9 @@ class GPU_EXPORT ProgramManager {
   typedef std::map<GLuint, ProgramInfo::Ref> ProgramInfoMap;
   ProgramInfoMap program_infos_;
 
+  // Binaries of previously linked programs. May be NULL.
+  ProgramCache* program_cache_;
+
   int uniform_swizzle_;
 
   // Counts the number of ProgramInfo allocated with 'this' as its manager.
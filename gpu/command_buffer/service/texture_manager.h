@@ -493,6 +493,11 @@ class GPU_EXPORT TextureManager {
     return num_uncleared_mips_ > 0;
   }
 
+  // Estimated bytes of texture memory used by the textures of this manager.
+  uint32 mem_represented() const {
+    return mem_represented_;
+  }
+
   GLuint black_texture_id(GLenum target) const {
     switch (target) {
       case GL_SAMPLER_2D:
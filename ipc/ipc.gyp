@@ -50,11 +50,13 @@
         'ipc_fuzzing_tests.cc',
         'ipc_message_unittest.cc',
         'ipc_send_fds_test.cc',
+        'ipc_shared_memory_ring_unittest.cc',
         'ipc_sync_channel_unittest.cc',
         'ipc_sync_message_unittest.cc',
         'ipc_sync_message_unittest.h',
         'ipc_tests.cc',
         'ipc_tests.h',
+        'ipc_traffic_recorder_unittest.cc',
         'sync_socket_unittest.cc',
       ],
       'conditions': [
@@ -102,18 +102,26 @@ class IPC_EXPORT Channel : public Message::Sender {
   // just the process id (pid).  The message has a special routing_id
   // (MSG_ROUTING_NONE) and type (HELLO_MESSAGE_TYPE).
   enum {
-    HELLO_MESSAGE_TYPE = kuint16max  // Maximum value of message type (uint16),
-                                     // to avoid conflicting with normal
-                                     // message types, which are enumeration
-                                     // constants starting from 0.
+    HELLO_MESSAGE_TYPE = kuint16max,  // Maximum value of message type (uint16),
+                                      // to avoid conflicting with normal
+                                      // message types, which are enumeration
+                                      // constants starting from 0.
+
+    // Internal messages of the shared memory transport, which share the
+    // routing id of the Hello message. The first hands the peer the ring it
+    // will read from; the second tells it how many bytes to take from there.
+    // See EnableSharedMemoryTransport().
+    SHARED_MEMORY_SETUP_MESSAGE_TYPE = kuint16max - 1,
+    SHARED_MEMORY_DATA_MESSAGE_TYPE = kuint16max - 2
   };
 
   // The maximum message size in bytes. Attempting to receive a message of this
   // size or bigger results in a channel error.
   static const size_t kMaximumMessageSize = 128 * 1024 * 1024;
 
-  // Ammount of data to read at once from the pipe.
-  static const size_t kReadBufferSize = 4 * 1024;
+  // Ammount of data to read at once from the pipe.  Large enough that a
+  // burst of small messages is usually picked up by a single read.
+  static const size_t kReadBufferSize = 16 * 1024;
 
   // Initialize a Channel.
   //
@@ -191,6 +199,17 @@ class IPC_EXPORT Channel : public Message::Sender {
   // Closes any currently connected socket, and returns to a listening state
   // for more connections.
   void ResetToAcceptingConnectionState();
+
+  // Sends large messages through a shared memory ring of |ring_size| bytes
+  // (a power of two) instead of the socket, which then only carries a short
+  // notification for each of them. Messages with file descriptors, and any
+  // that don't fit in the ring's free space, still go over the socket.
+  // Takes effect when the channel next connects, so call it before Connect().
+  // Returns false if |ring_size| isn't usable.
+  //
+  // The peer can shrink the segment out from under this process and make it
+  // fault, so only use this with peers that are trusted not to.
+  bool EnableSharedMemoryTransport(size_t ring_size);
 #endif  // defined(OS_POSIX) && !defined(OS_NACL)
 
   // Returns true if a named server channel is initialized on the given channel
@@ -64,6 +64,11 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
   NOTIMPLEMENTED();
 }
 
+bool Channel::ChannelImpl::EnableSharedMemoryTransport(size_t ring_size) {
+  NOTIMPLEMENTED();
+  return false;
+}
+
 Channel::ChannelImpl::ReadState
     Channel::ChannelImpl::ReadData(char* buffer,
                                    int buffer_len,
@@ -141,6 +146,10 @@ void Channel::ResetToAcceptingConnectionState() {
   channel_impl_->ResetToAcceptingConnectionState();
 }
 
+bool Channel::EnableSharedMemoryTransport(size_t ring_size) {
+  return channel_impl_->EnableSharedMemoryTransport(ring_size);
+}
+
 base::ProcessId Channel::peer_pid() const { return 0; }
 
 // static
@@ -32,6 +32,7 @@ class Channel::ChannelImpl : public internal::ChannelReader {
   bool HasAcceptedConnection() const;
   bool GetClientEuid(uid_t* client_euid) const;
   void ResetToAcceptingConnectionState();
+  bool EnableSharedMemoryTransport(size_t ring_size);
   static bool IsNamedServerInitialized(const std::string& channel_id);
 
   virtual ReadState ReadData(char* buffer,
@@ -10,11 +10,8 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
-#include <sys/un.h>
-
-#if defined(OS_OPENBSD)
 #include <sys/uio.h>
-#endif
+#include <sys/un.h>
 
 #include <string>
 #include <map>
@@ -315,7 +312,8 @@ Channel::ChannelImpl::ChannelImpl(const IPC::ChannelHandle& channel_handle,
       remote_fd_pipe_(-1),
 #endif  // IPC_USES_READWRITE
       pipe_name_(channel_handle.name),
-      must_unlink_(false) {
+      must_unlink_(false),
+      shared_memory_ring_size_(0) {
   memset(input_cmsg_buf_, 0, sizeof(input_cmsg_buf_));
   if (!CreatePipe(channel_handle)) {
     // The pipe may have been closed already.
@@ -499,8 +497,10 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         message_send_bytes_written_;
 
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
+    struct iovec iov[kMaxMessagesPerWrite];
+    iov[0].iov_base = const_cast<char*>(out_bytes);
+    iov[0].iov_len = amt_to_write;
+    msgh.msg_iov = iov;
     msgh.msg_iovlen = 1;
     char buf[CMSG_SPACE(
         sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
@@ -548,7 +548,7 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         msgh.msg_iov = &fd_pipe_iov;
         fd_written = fd_pipe_;
         bytes_written = HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
-        msgh.msg_iov = &iov;
+        msgh.msg_iov = iov;
         msgh.msg_controllen = 0;
         if (bytes_written > 0) {
           msg->file_descriptor_set()->CommitAll();
@@ -557,6 +557,23 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
 #endif  // IPC_USES_READWRITE
     }
 
+    // Unless descriptors are attached to this write, gather the messages
+    // queued behind this one into it as well, up to the next message that
+    // carries descriptors: those always have to start a write of their own.
+    size_t iov_count = 1;
+    if (!msgh.msg_controllen) {
+      for (std::deque<Message*>::const_iterator it = output_queue_.begin() + 1;
+           it != output_queue_.end() && iov_count < kMaxMessagesPerWrite &&
+               (*it)->file_descriptor_set()->empty();
+           ++it) {
+        iov[iov_count].iov_base = const_cast<void*>((*it)->data());
+        iov[iov_count].iov_len = (*it)->size();
+        amt_to_write += (*it)->size();
+        ++iov_count;
+      }
+      msgh.msg_iovlen = iov_count;
+    }
+
     if (bytes_written == 1) {
       fd_written = pipe_;
 #if defined(IPC_USES_READWRITE)
@@ -564,7 +581,7 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
       }
       if (!msgh.msg_controllen) {
-        bytes_written = HANDLE_EINTR(write(pipe_, out_bytes, amt_to_write));
+        bytes_written = HANDLE_EINTR(writev(pipe_, iov, iov_count));
       } else
 #endif  // IPC_USES_READWRITE
       {
@@ -593,11 +610,25 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       return false;
     }
 
+    // Retire the messages that went out completely.  If write() failed with
+    // EAGAIN then bytes_written will be -1 and nothing was sent.
+    size_t bytes_left = bytes_written > 0 ? bytes_written : 0;
+    for (size_t i = 0; i < iov_count && bytes_left >= iov[i].iov_len; ++i) {
+      bytes_left -= iov[i].iov_len;
+      message_send_bytes_written_ = 0;
+
+      // Message sent OK!
+      DVLOG(2) << "sent message @" << output_queue_.front()
+               << " on channel @" << this
+               << " with type " << output_queue_.front()->type()
+               << " on fd " << pipe_;
+      delete output_queue_.front();
+      output_queue_.pop_front();
+    }
+
     if (static_cast<size_t>(bytes_written) != amt_to_write) {
-      if (bytes_written > 0) {
-        // If write() fails with EAGAIN then bytes_written will be -1.
-        message_send_bytes_written_ += bytes_written;
-      }
+      // The message at the front of the queue was only partially written.
+      message_send_bytes_written_ += bytes_left;
 
       // Tell libevent to call us back once things are unblocked.
       is_blocked_on_write_ = true;
@@ -608,14 +639,6 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
           &write_watcher_,
           this);
       return true;
-    } else {
-      message_send_bytes_written_ = 0;
-
-      // Message sent OK!
-      DVLOG(2) << "sent message @" << msg << " on channel @" << this
-               << " with type " << msg->type() << " on fd " << pipe_;
-      delete output_queue_.front();
-      output_queue_.pop();
     }
   }
   return true;
@@ -630,7 +653,13 @@ bool Channel::ChannelImpl::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, "");
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
-  output_queue_.push(message);
+  Message* notification = WriteToSharedMemory(message);
+  if (notification) {
+    delete message;
+    message = notification;
+  }
+
+  output_queue_.push_back(message);
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
   }
@@ -724,12 +753,23 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
 
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
 
   // Close any outstanding, received file descriptors.
   ClearInputFDs();
+
+  // A new connection gets new rings.
+  output_ring_.reset();
+  input_ring_.reset();
+}
+
+bool Channel::ChannelImpl::EnableSharedMemoryTransport(size_t ring_size) {
+  if (!internal::SharedMemoryRing::IsValidCapacity(ring_size))
+    return false;
+  shared_memory_ring_size_ = ring_size;
+  return true;
 }
 
 // static
@@ -827,6 +867,7 @@ bool Channel::ChannelImpl::AcceptConnection() {
                                                    &read_watcher_,
                                                    this);
   QueueHelloMessage();
+  QueueSharedMemorySetupMessage();
 
   if (mode_ & MODE_CLIENT_FLAG) {
     // If we are a client we want to send a hello message out immediately.
@@ -886,7 +927,53 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  output_queue_.push_back(msg.release());
+}
+
+void Channel::ChannelImpl::QueueSharedMemorySetupMessage() {
+  output_ring_.reset();
+  if (!shared_memory_ring_size_)
+    return;
+
+  scoped_ptr<internal::SharedMemoryRing> ring(new internal::SharedMemoryRing);
+  if (!ring->CreateForWriting(shared_memory_ring_size_)) {
+    LOG(WARNING) << "Unable to create shared memory ring for channel "
+                 << pipe_name_ << "; sending everything over the socket";
+    return;
+  }
+
+  // The setup message carries a descriptor, so it reaches the peer on its
+  // own and ahead of any notification for data written to the ring.
+  scoped_ptr<Message> msg(new Message(MSG_ROUTING_NONE,
+                                      SHARED_MEMORY_SETUP_MESSAGE_TYPE,
+                                      IPC::Message::PRIORITY_NORMAL));
+  if (!msg->WriteUInt32(static_cast<uint32>(ring->capacity())) ||
+      !msg->WriteFileDescriptor(base::FileDescriptor(ring->handle().fd,
+                                                     false))) {
+    NOTREACHED() << "Unable to pickle shared memory setup message";
+    return;
+  }
+  output_queue_.push_back(msg.release());
+  output_ring_.swap(ring);
+}
+
+Message* Channel::ChannelImpl::WriteToSharedMemory(Message* message) {
+  if (!output_ring_.get() ||
+      message->size() < kMinSharedMemoryMessageSize ||
+      !message->file_descriptor_set()->empty() ||
+      !output_ring_->Write(message->data(), message->size())) {
+    return NULL;
+  }
+
+  // The notification takes the message's place in |output_queue_|, so the
+  // peer reads the data from the ring in the order it was sent.
+  Message* notification = new Message(MSG_ROUTING_NONE,
+                                      SHARED_MEMORY_DATA_MESSAGE_TYPE,
+                                      message->priority());
+  if (!notification->WriteUInt32(static_cast<uint32>(message->size()))) {
+    NOTREACHED() << "Unable to pickle shared memory notification";
+  }
+  return notification;
 }
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
@@ -1089,6 +1176,34 @@ void Channel::ChannelImpl::HandleHelloMessage(const Message& msg) {
   listener()->OnChannelConnected(pid);
 }
 
+bool Channel::ChannelImpl::HandleSharedMemoryMessage(const Message& msg) {
+  PickleIterator iter(msg);
+  if (msg.type() == SHARED_MEMORY_SETUP_MESSAGE_TYPE) {
+    uint32 capacity;
+    base::FileDescriptor descriptor;
+    if (!msg.ReadUInt32(&iter, &capacity) ||
+        !msg.ReadFileDescriptor(&iter, &descriptor)) {
+      LOG(ERROR) << "Malformed shared memory setup message";
+      return false;
+    }
+    input_ring_.reset(new internal::SharedMemoryRing);
+    if (!input_ring_->MapForReading(descriptor, capacity)) {
+      LOG(ERROR) << "Unable to map the peer's shared memory ring";
+      input_ring_.reset();
+      return false;
+    }
+    return true;
+  }
+
+  uint32 size;
+  if (!input_ring_.get() || !msg.ReadUInt32(&iter, &size) ||
+      !input_ring_->Read(size, &input_ring_buf_)) {
+    LOG(ERROR) << "Bad shared memory notification";
+    return false;
+  }
+  return DispatchOutOfBandData(input_ring_buf_.data(), input_ring_buf_.size());
+}
+
 void Channel::ChannelImpl::Close() {
   // Close can be called multiple time, so we need to make sure we're
   // idempotent.
@@ -1165,6 +1280,10 @@ void Channel::ResetToAcceptingConnectionState() {
   channel_impl_->ResetToAcceptingConnectionState();
 }
 
+bool Channel::EnableSharedMemoryTransport(size_t ring_size) {
+  return channel_impl_->EnableSharedMemoryTransport(ring_size);
+}
+
 // static
 bool Channel::IsNamedServerInitialized(const std::string& channel_id) {
   return ChannelImpl::IsNamedServerInitialized(channel_id);
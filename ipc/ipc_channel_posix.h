@@ -10,14 +10,16 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
 #include "base/process.h"
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_channel_reader.h"
+#include "ipc/ipc_shared_memory_ring.h"
 
 #if !defined(OS_MACOSX)
 // On Linux, the seccomp sandbox makes it very expensive to call
@@ -66,6 +68,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   bool HasAcceptedConnection() const;
   bool GetClientEuid(uid_t* client_euid) const;
   void ResetToAcceptingConnectionState();
+  bool EnableSharedMemoryTransport(size_t ring_size);
   base::ProcessId peer_pid() const { return peer_pid_; }
   static bool IsNamedServerInitialized(const std::string& channel_id);
 #if defined(OS_LINUX)
@@ -82,6 +85,15 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   int GetHelloMessageProcId();
   void QueueHelloMessage();
 
+  // Creates |output_ring_| and queues the message that hands it to the peer,
+  // if the shared memory transport is enabled.
+  void QueueSharedMemorySetupMessage();
+
+  // Copies |message| into |output_ring_| if it is worth sending that way and
+  // there is room, returning the notification to send in its place. Returns
+  // NULL if |message| should go over the socket as usual.
+  Message* WriteToSharedMemory(Message* message);
+
   // ChannelReader implementation.
   virtual ReadState ReadData(char* buffer,
                              int buffer_len,
@@ -89,6 +101,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   virtual bool WillDispatchInputMessage(Message* msg) OVERRIDE;
   virtual bool DidEmptyInputBuffers() OVERRIDE;
   virtual void HandleHelloMessage(const Message& msg) OVERRIDE;
+  virtual bool HandleSharedMemoryMessage(const Message& msg) OVERRIDE;
 
 #if defined(IPC_USES_READWRITE)
   // Reads the next message from the fd_pipe_ and appends them to the
@@ -154,7 +167,10 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   std::string pipe_name_;
 
   // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  std::deque<Message*> output_queue_;
+
+  // The most messages ProcessOutgoingMessages() gathers into one write.
+  static const size_t kMaxMessagesPerWrite = 64;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
@@ -187,6 +203,23 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   // True if we are responsible for unlinking the unix domain socket file.
   bool must_unlink_;
 
+  // Size of the ring to set up for outgoing messages when connecting, or zero
+  // to send everything over the socket. See EnableSharedMemoryTransport().
+  size_t shared_memory_ring_size_;
+
+  // The ring our large outgoing messages are copied into, and the one the
+  // peer handed us for its own.
+  scoped_ptr<internal::SharedMemoryRing> output_ring_;
+  scoped_ptr<internal::SharedMemoryRing> input_ring_;
+
+  // Data taken out of |input_ring_| is copied here before it is parsed, so
+  // that the peer can't change it in the meantime.
+  std::string input_ring_buf_;
+
+  // Smaller messages go over the socket even with the shared memory transport
+  // enabled: for them the notification costs about as much as the copy saved.
+  static const size_t kMinSharedMemoryMessageSize = 4 * 1024;
+
 #if defined(OS_LINUX)
   // If non-zero, overrides the process ID sent in the hello message.
   static int global_pid_;
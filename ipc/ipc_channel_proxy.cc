@@ -3,17 +3,39 @@
 // found in the LICENSE file.
 
 #include "base/bind.h"
+#include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/debug/trace_event.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_logging.h"
+#include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
+#include "ipc/ipc_switches.h"
+#include "ipc/ipc_traffic_recorder.h"
 
 namespace IPC {
 
+namespace {
+
+// Returns the file name a --ipc-record-traffic recording of the channel named
+// |channel_id| is written to.
+std::string RecordingFileName(const std::string& channel_id) {
+  std::string name;
+  for (size_t i = 0; i < channel_id.size(); ++i) {
+    char c = channel_id[i];
+    bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') || c == '.' || c == '-';
+    name.push_back(safe ? c : '_');
+  }
+  return name + ".ipctraffic";
+}
+
+}  // namespace
+
 //------------------------------------------------------------------------------
 
 ChannelProxy::MessageFilter::MessageFilter() {}
@@ -32,6 +54,11 @@ bool ChannelProxy::MessageFilter::OnMessageReceived(const Message& message) {
   return false;
 }
 
+bool ChannelProxy::MessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  return false;
+}
+
 void ChannelProxy::MessageFilter::OnDestruct() const {
   delete this;
 }
@@ -40,16 +67,45 @@ ChannelProxy::MessageFilter::~MessageFilter() {}
 
 //------------------------------------------------------------------------------
 
+struct ChannelProxy::Context::FilterEntry {
+  explicit FilterEntry(MessageFilter* filter)
+      : filter(filter),
+        index(0),
+        all_message_classes(
+            !filter->GetSupportedMessageClasses(&message_classes)),
+        messages_offered(0) {
+  }
+
+  scoped_refptr<MessageFilter> filter;
+
+  // Position in |filters_|, which TryFilters() uses to keep the order filters
+  // were added in across |global_filters_| and |message_class_filters_|.
+  size_t index;
+
+  // The IPC_MESSAGE_START values from GetSupportedMessageClasses(), unless
+  // the filter wants every message.
+  std::vector<uint32> message_classes;
+  bool all_message_classes;
+
+  int messages_offered;
+  base::TimeDelta time_spent;
+};
+
+//------------------------------------------------------------------------------
+
 ChannelProxy::Context::Context(Channel::Listener* listener,
                                base::MessageLoopProxy* ipc_message_loop)
     : listener_message_loop_(base::MessageLoopProxy::current()),
       listener_(listener),
+      message_class_filters_(LastIPCMsgStart),
       ipc_message_loop_(ipc_message_loop),
       channel_connected_called_(false),
-      peer_pid_(base::kNullProcessId) {
+      peer_pid_(base::kNullProcessId),
+      prioritize_sync_messages_(false) {
 }
 
 ChannelProxy::Context::~Context() {
+  STLDeleteElements(&priority_messages_);
 }
 
 void ChannelProxy::Context::CreateChannel(const IPC::ChannelHandle& handle,
@@ -59,15 +115,73 @@ void ChannelProxy::Context::CreateChannel(const IPC::ChannelHandle& handle,
   channel_.reset(new Channel(handle, mode, this));
 }
 
+void ChannelProxy::Context::UpdateFilterRouting() {
+  global_filters_.clear();
+  for (size_t i = 0; i < message_class_filters_.size(); ++i)
+    message_class_filters_[i].clear();
+
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    FilterEntry* entry = filters_[i];
+    entry->index = i;
+    if (entry->all_message_classes) {
+      global_filters_.push_back(entry);
+      continue;
+    }
+    for (size_t j = 0; j < entry->message_classes.size(); ++j) {
+      uint32 message_class = entry->message_classes[j];
+      if (message_class >= message_class_filters_.size()) {
+        NOTREACHED() << "Bad message class " << message_class;
+        continue;
+      }
+      std::vector<FilterEntry*>& class_filters =
+          message_class_filters_[message_class];
+      if (class_filters.empty() || class_filters.back() != entry)
+        class_filters.push_back(entry);
+    }
+  }
+}
+
+bool ChannelProxy::Context::TryFilter(FilterEntry* entry,
+                                      const Message& message) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  bool handled = entry->filter->OnMessageReceived(message);
+  entry->time_spent += base::TimeTicks::Now() - start;
+  entry->messages_offered++;
+  return handled;
+}
+
 bool ChannelProxy::Context::TryFilters(const Message& message) {
+  uint32 message_class = IPC_MESSAGE_CLASS(message);
+  const std::vector<FilterEntry*>* class_filters =
+      message_class < message_class_filters_.size() ?
+          &message_class_filters_[message_class] : NULL;
+  // Most messages aren't of interest to any filter.
+  if (global_filters_.empty() && (!class_filters || class_filters->empty()))
+    return false;
+
 #ifdef IPC_MESSAGE_LOG_ENABLED
   Logging* logger = Logging::GetInstance();
   if (logger->Enabled())
     logger->OnPreDispatchMessage(message);
 #endif
 
-  for (size_t i = 0; i < filters_.size(); ++i) {
-    if (filters_[i]->OnMessageReceived(message)) {
+  // Both lists are in the order the filters were added; merge them to try
+  // the filters in that order.
+  size_t next_global = 0;
+  size_t next_class = 0;
+  size_t class_count = class_filters ? class_filters->size() : 0;
+  while (next_global < global_filters_.size() || next_class < class_count) {
+    FilterEntry* entry;
+    if (next_class == class_count ||
+        (next_global < global_filters_.size() &&
+         global_filters_[next_global]->index <
+             (*class_filters)[next_class]->index)) {
+      entry = global_filters_[next_global++];
+    } else {
+      entry = (*class_filters)[next_class++];
+    }
+
+    if (TryFilter(entry, message)) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
       if (logger->Enabled())
         logger->OnPostDispatchMessage(message, channel_id_);
@@ -78,6 +192,19 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
   return false;
 }
 
+bool ChannelProxy::Context::GetFilterStats(MessageFilter* filter,
+                                           int* messages_offered,
+                                           base::TimeDelta* time_spent) const {
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    if (filters_[i]->filter.get() == filter) {
+      *messages_offered = filters_[i]->messages_offered;
+      *time_spent = filters_[i]->time_spent;
+      return true;
+    }
+  }
+  return false;
+}
+
 // Called on the IPC::Channel thread
 bool ChannelProxy::Context::OnMessageReceived(const Message& message) {
   // First give a chance to the filters to process this message.
@@ -92,6 +219,22 @@ bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
   // this thread is active.  That should be a reasonable assumption, but it
   // feels risky.  We may want to invent some more indirect way of referring to
   // a MessageLoop if this becomes a problem.
+  if (prioritize_sync_messages_) {
+    if (message.is_sync()) {
+      {
+        base::AutoLock auto_lock(priority_messages_lock_);
+        priority_messages_.push_back(new Message(message));
+      }
+      listener_message_loop_->PostTask(
+          FROM_HERE, base::Bind(&Context::OnDispatchPriorityMessages, this));
+    } else {
+      listener_message_loop_->PostTask(
+          FROM_HERE,
+          base::Bind(&Context::OnDispatchMessageAfterPriority, this, message));
+    }
+    return true;
+  }
+
   listener_message_loop_->PostTask(
       FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
   return true;
@@ -108,7 +251,7 @@ void ChannelProxy::Context::OnChannelConnected(int32 peer_pid) {
   // We cache off the peer_pid so it can be safely accessed from both threads.
   peer_pid_ = channel_->peer_pid();
   for (size_t i = 0; i < filters_.size(); ++i)
-    filters_[i]->OnChannelConnected(peer_pid);
+    filters_[i]->filter->OnChannelConnected(peer_pid);
 
   // See above comment about using listener_message_loop_ here.
   listener_message_loop_->PostTask(
@@ -118,7 +261,7 @@ void ChannelProxy::Context::OnChannelConnected(int32 peer_pid) {
 // Called on the IPC::Channel thread
 void ChannelProxy::Context::OnChannelError() {
   for (size_t i = 0; i < filters_.size(); ++i)
-    filters_[i]->OnChannelError();
+    filters_[i]->filter->OnChannelError();
 
   // See above comment about using listener_message_loop_ here.
   listener_message_loop_->PostTask(
@@ -139,7 +282,7 @@ void ChannelProxy::Context::OnChannelOpened() {
   }
 
   for (size_t i = 0; i < filters_.size(); ++i)
-    filters_[i]->OnFilterAdded(channel_.get());
+    filters_[i]->filter->OnFilterAdded(channel_.get());
 }
 
 // Called on the IPC::Channel thread
@@ -150,12 +293,13 @@ void ChannelProxy::Context::OnChannelClosed() {
     return;
 
   for (size_t i = 0; i < filters_.size(); ++i) {
-    filters_[i]->OnChannelClosing();
-    filters_[i]->OnFilterRemoved();
+    filters_[i]->filter->OnChannelClosing();
+    filters_[i]->filter->OnFilterRemoved();
   }
 
   // We don't need the filters anymore.
-  filters_.clear();
+  filters_.reset();
+  UpdateFilterRouting();
 
   channel_.reset();
 
@@ -183,7 +327,7 @@ void ChannelProxy::Context::OnAddFilter() {
   }
 
   for (size_t i = 0; i < new_filters.size(); ++i) {
-    filters_.push_back(new_filters[i]);
+    filters_.push_back(new FilterEntry(new_filters[i]));
 
     // If the channel has already been created, then we need to send this
     // message so that the filter gets access to the Channel.
@@ -193,14 +337,17 @@ void ChannelProxy::Context::OnAddFilter() {
     if (peer_pid_)
       new_filters[i]->OnChannelConnected(peer_pid_);
   }
+
+  UpdateFilterRouting();
 }
 
 // Called on the IPC::Channel thread
 void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   for (size_t i = 0; i < filters_.size(); ++i) {
-    if (filters_[i].get() == filter) {
+    if (filters_[i]->filter.get() == filter) {
       filter->OnFilterRemoved();
       filters_.erase(filters_.begin() + i);
+      UpdateFilterRouting();
       return;
     }
   }
@@ -252,6 +399,30 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
 #endif
 }
 
+// Called on the listener's thread
+void ChannelProxy::Context::OnDispatchPriorityMessages() {
+  // A sync message's own task may find the queue already drained by an
+  // earlier task; that's expected.
+  while (true) {
+    scoped_ptr<Message> message;
+    {
+      base::AutoLock auto_lock(priority_messages_lock_);
+      if (priority_messages_.empty())
+        return;
+      message.reset(priority_messages_.front());
+      priority_messages_.pop_front();
+    }
+    OnDispatchMessage(*message);
+  }
+}
+
+// Called on the listener's thread
+void ChannelProxy::Context::OnDispatchMessageAfterPriority(
+    const Message& message) {
+  OnDispatchPriorityMessages();
+  OnDispatchMessage(message);
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchConnected() {
   if (channel_connected_called_)
@@ -316,6 +487,14 @@ void ChannelProxy::Init(const IPC::ChannelHandle& channel_handle,
                               channel_handle, mode));
   }
 
+  // Add the recorder ahead of any other filter so it sees every message.
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(switches::kIPCRecordTraffic)) {
+    FilePath dir = command_line.GetSwitchValuePath(switches::kIPCRecordTraffic);
+    context_->AddFilter(new TrafficRecorder(
+        dir.AppendASCII(RecordingFileName(channel_handle.name))));
+  }
+
   // complete initialization on the background thread
   context_->ipc_message_loop()->PostTask(
       FROM_HERE, base::Bind(&Context::OnChannelOpened, context_.get()));
@@ -351,6 +530,11 @@ bool ChannelProxy::Send(Message* message) {
   return true;
 }
 
+void ChannelProxy::set_prioritize_sync_messages(bool value) {
+  DCHECK(!did_init_);
+  context_->prioritize_sync_messages_ = value;
+}
+
 void ChannelProxy::AddFilter(MessageFilter* filter) {
   context_->AddFilter(filter);
 }
@@ -6,12 +6,15 @@
 #define IPC_IPC_CHANNEL_PROXY_H_
 #pragma once
 
+#include <deque>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop_proxy.h"
 #include "base/synchronization/lock.h"
+#include "base/time.h"
 #include "ipc/ipc_channel.h"
 #include "ipc/ipc_channel_handle.h"
 
@@ -85,6 +88,15 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     // the message be handled in the default way.
     virtual bool OnMessageReceived(const Message& message);
 
+    // Called on the background thread when the filter is added, to find out
+    // which messages OnMessageReceived() should be offered. Return true and
+    // fill in |supported_message_classes| with the IPC_MESSAGE_START values of
+    // the message classes the filter handles, and messages of other classes
+    // will pass it by. The default returns false, which offers the filter
+    // every message.
+    virtual bool GetSupportedMessageClasses(
+        std::vector<uint32>* supported_message_classes) const;
+
     // Called when the message filter is about to be deleted.  This gives
     // derived classes the option of controlling which thread they're deleted
     // on etc.
@@ -172,6 +184,14 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     outgoing_message_filter_ = filter;
   }
 
+  // When set, incoming sync messages that reach the listener thread are
+  // dispatched ahead of the async messages still queued there, so that the
+  // peer blocked on them doesn't wait behind bulk traffic.  This reorders a
+  // sync message relative to async messages sent before it, so only use it
+  // when the listener doesn't depend on that order.  Must be called before
+  // the channel is initialized.
+  void set_prioritize_sync_messages(bool value);
+
   // Called to clear the pointer to the IPC message loop when it's going away.
   void ClearIPCMessageLoop();
 
@@ -218,10 +238,19 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     // Like OnMessageReceived but doesn't try the filters.
     bool OnMessageReceivedNoFilter(const Message& message);
 
-    // Gives the filters a chance at processing |message|.
+    // Gives the filters a chance at processing |message|, in the order they
+    // were added, skipping those that don't handle its message class.
     // Returns true if the message was processed, false otherwise.
     bool TryFilters(const Message& message);
 
+    // Returns how many messages |filter| has been offered, and the time its
+    // OnMessageReceived() has taken for them, in |messages_offered| and
+    // |time_spent|.  Returns false if |filter| isn't installed.  Only call
+    // this on the IPC thread.
+    bool GetFilterStats(MessageFilter* filter,
+                        int* messages_offered,
+                        base::TimeDelta* time_spent) const;
+
     // Like Open and Close, but called on the IPC thread.
     virtual void OnChannelOpened();
     virtual void OnChannelClosed();
@@ -235,6 +264,17 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     friend class ChannelProxy;
     friend class SendCallbackHelper;
 
+    // An installed filter, the message classes it handles and the time it
+    // has taken handling them.
+    struct FilterEntry;
+
+    // Rebuilds |global_filters_| and |message_class_filters_| from |filters_|.
+    void UpdateFilterRouting();
+
+    // Offers |message| to the filter in |entry|, accounting for the time it
+    // takes. Returns true if the filter handled the message.
+    bool TryFilter(FilterEntry* entry, const Message& message);
+
     // Create the Channel
     void CreateChannel(const IPC::ChannelHandle& channel_handle,
                        const Channel::Mode& mode);
@@ -249,11 +289,22 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     void OnDispatchConnected();
     void OnDispatchError();
 
+    // Dispatches the sync messages queued in |priority_messages_|, then, for
+    // the second, |message|.
+    void OnDispatchPriorityMessages();
+    void OnDispatchMessageAfterPriority(const Message& message);
+
     scoped_refptr<base::MessageLoopProxy> listener_message_loop_;
     Channel::Listener* listener_;
 
     // List of filters.  This is only accessed on the IPC thread.
-    std::vector<scoped_refptr<MessageFilter> > filters_;
+    ScopedVector<FilterEntry> filters_;
+
+    // The entries of |filters_| that are offered every message, and those
+    // offered each message class, indexed by IPC_MESSAGE_START value.  A
+    // message only walks the filters that asked for it.
+    std::vector<FilterEntry*> global_filters_;
+    std::vector<std::vector<FilterEntry*> > message_class_filters_;
     scoped_refptr<base::MessageLoopProxy> ipc_message_loop_;
     scoped_ptr<Channel> channel_;
     std::string channel_id_;
@@ -268,6 +319,14 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     // Cached copy of the peer process ID. Set on IPC but read on both IPC and
     // listener threads.
     base::ProcessId peer_pid_;
+
+    // See ChannelProxy::set_prioritize_sync_messages().  Incoming sync
+    // messages wait in |priority_messages_| between the IPC thread and the
+    // listener thread, which takes them before any other queued message.
+    bool prioritize_sync_messages_;
+    std::deque<Message*> priority_messages_;
+    // Lock for priority_messages_.
+    base::Lock priority_messages_lock_;
   };
 
   Context* context() { return context_; }
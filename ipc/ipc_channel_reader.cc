@@ -40,13 +40,50 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
          m.type() == Channel::HELLO_MESSAGE_TYPE;
 }
 
+bool ChannelReader::IsSharedMemoryMessage(const Message& m) const {
+  return m.routing_id() == MSG_ROUTING_NONE &&
+         (m.type() == Channel::SHARED_MEMORY_SETUP_MESSAGE_TYPE ||
+          m.type() == Channel::SHARED_MEMORY_DATA_MESSAGE_TYPE);
+}
+
+bool ChannelReader::HandleSharedMemoryMessage(const Message& msg) {
+  LOG(ERROR) << "Unexpected shared memory transport message";
+  return false;
+}
+
+bool ChannelReader::DispatchOutOfBandData(const char* data, size_t data_len) {
+  const char* p = data;
+  const char* end = data + data_len;
+  while (p < end) {
+    const char* message_tail = Message::FindNext(p, end);
+    if (!message_tail) {
+      LOG(ERROR) << "Partial IPC message outside of the pipe";
+      return false;
+    }
+    Message m(p, static_cast<int>(message_tail - p));
+    // Descriptors and setup messages only travel through the pipe.
+    bool has_descriptors = false;
+#if defined(OS_POSIX)
+    has_descriptors = m.header()->num_fds != 0;
+#endif
+    if (has_descriptors || IsHelloMessage(m) || IsSharedMemoryMessage(m)) {
+      LOG(ERROR) << "Unexpected IPC message outside of the pipe";
+      return false;
+    }
+    listener_->OnMessageReceived(m);
+    p = message_tail;
+  }
+  return true;
+}
+
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
   const char* p;
   const char* end;
+  bool reading_overflow_buf = !input_overflow_buf_.empty();
 
   // Possibly combine with the overflow buffer to make a larger buffer.
-  if (input_overflow_buf_.empty()) {
+  if (!reading_overflow_buf) {
     p = input_data;
     end = input_data + input_data_len;
   } else {
@@ -70,10 +107,14 @@ bool ChannelReader::DispatchInputData(const char* input_data,
       if (!WillDispatchInputMessage(&m))
         return false;
 
-      if (IsHelloMessage(m))
+      if (IsHelloMessage(m)) {
         HandleHelloMessage(m);
-      else
+      } else if (IsSharedMemoryMessage(m)) {
+        if (!HandleSharedMemoryMessage(m))
+          return false;
+      } else {
         listener_->OnMessageReceived(m);
+      }
       p = message_tail;
     } else {
       // Last message is partial.
@@ -81,8 +122,25 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     }
   }
 
-  // Save any partial data in the overflow buffer.
-  input_overflow_buf_.assign(p, end - p);
+  // Save any partial data in the overflow buffer.  If it is already there,
+  // just drop the messages dispatched above rather than copying the
+  // remainder over itself; a large message arrives in many reads and would
+  // otherwise be copied again on each of them.
+  if (reading_overflow_buf)
+    input_overflow_buf_.erase(0, p - input_overflow_buf_.data());
+  else
+    input_overflow_buf_.assign(p, end - p);
+
+  // Once the header of a partial message is in, the buffer can be sized for
+  // the whole message up front instead of growing with every read.
+  size_t message_size;
+  if (Message::PeekNext(input_overflow_buf_.data(),
+                        input_overflow_buf_.data() + input_overflow_buf_.size(),
+                        &message_size) &&
+      message_size <= Channel::kMaximumMessageSize &&
+      message_size > input_overflow_buf_.capacity()) {
+    input_overflow_buf_.reserve(message_size);
+  }
 
   if (input_overflow_buf_.empty() && !DidEmptyInputBuffers())
     return false;
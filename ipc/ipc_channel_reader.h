@@ -46,6 +46,10 @@ class ChannelReader {
   // set-up.
   bool IsHelloMessage(const Message& m) const;
 
+  // Returns true if the given message is one of the internal messages of the
+  // shared memory transport.
+  bool IsSharedMemoryMessage(const Message& m) const;
+
  protected:
   enum ReadState { READ_SUCCEEDED, READ_FAILED, READ_PENDING };
 
@@ -79,6 +83,17 @@ class ChannelReader {
   // Handles the first message sent over the pipe which contains setup info.
   virtual void HandleHelloMessage(const Message& msg) = 0;
 
+  // Handles an internal message of the shared memory transport. Returns
+  // false on channel error, which is what channels without the transport
+  // treat these messages as.
+  virtual bool HandleSharedMemoryMessage(const Message& msg);
+
+  // Dispatches |data_len| bytes of complete messages that arrived outside of
+  // the pipe, such as through the shared memory transport. Returns false on
+  // channel error, including when the data doesn't end on a message boundary
+  // or contains messages that may only come through the pipe.
+  bool DispatchOutOfBandData(const char* data, size_t data_len);
+
  private:
   // Takes the given data received from the IPC channel and dispatches any
   // fully completed messages.
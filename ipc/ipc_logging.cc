@@ -14,6 +14,7 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/process_util.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
@@ -166,6 +167,42 @@ void Logging::OnPostDispatchMessage(const Message& message,
   }
 }
 
+void Logging::OnSyncSendCompleted(uint32 type,
+                                  base::TimeDelta blocked_time) {
+  base::Histogram* histogram;
+  {
+    base::AutoLock auto_lock(sync_send_histograms_lock_);
+    SyncSendHistogramMap::iterator it = sync_send_histograms_.find(type);
+    if (it != sync_send_histograms_.end()) {
+      histogram = it->second;
+    } else {
+      // Fall back to the type when the message's name isn't known, rather
+      // than using GetMessageText()'s placeholder for it.
+      std::string name;
+      if (log_function_map_ &&
+          log_function_map_->find(type) != log_function_map_->end()) {
+        GetMessageText(type, &name, NULL, NULL);
+      } else {
+        name = base::UintToString(type);
+      }
+      // The histograms are owned by the StatisticsRecorder and outlive us.
+      histogram = base::Histogram::FactoryTimeGet(
+          "IPC.SyncSendBlockedTime." + name,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromSeconds(10), 50,
+          base::Histogram::kNoFlags);
+      sync_send_histograms_[type] = histogram;
+    }
+  }
+  histogram->AddTime(blocked_time);
+}
+
+base::Histogram* Logging::GetSyncSendHistogram(uint32 type) {
+  base::AutoLock auto_lock(sync_send_histograms_lock_);
+  SyncSendHistogramMap::iterator it = sync_send_histograms_.find(type);
+  return it == sync_send_histograms_.end() ? NULL : it->second;
+}
+
 void Logging::GetMessageText(uint32 type, std::string* name,
                              const Message* message,
                              std::string* params) {
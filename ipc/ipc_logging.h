@@ -16,6 +16,8 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/singleton.h"
 #include "base/message_loop.h"
+#include "base/synchronization/lock.h"
+#include "base/time.h"
 #include "ipc/ipc_export.h"
 
 // Logging function. |name| is a string in ASCII and |params| is a string in
@@ -26,6 +28,10 @@ typedef void (*LogFunction)(std::string* name,
 
 typedef base::hash_map<uint32, LogFunction > LogFunctionMap;
 
+namespace base {
+class Histogram;
+}
+
 namespace IPC {
 
 class Message;
@@ -70,6 +76,17 @@ class IPC_EXPORT Logging {
   void OnPostDispatchMessage(const Message& message,
                              const std::string& channel_id);
 
+  // Called by SyncChannel when a Send() of a sync message of type |type|
+  // returns, with the time the sending thread was blocked waiting for the
+  // reply.  Unlike the other hooks this is recorded whether or not logging is
+  // enabled, into an "IPC.SyncSendBlockedTime.<message name>" histogram per
+  // message type.  May be called on any thread.
+  void OnSyncSendCompleted(uint32 type, base::TimeDelta blocked_time);
+
+  // Returns the histogram OnSyncSendCompleted() records |type| into, or NULL
+  // if no sync message of that type has been sent yet.
+  base::Histogram* GetSyncSendHistogram(uint32 type);
+
   // Like the *MsgLog functions declared for each message class, except this
   // calls the correct one based on the message type automatically.  Defined in
   // ipc_logging.cc.
@@ -117,6 +134,11 @@ class IPC_EXPORT Logging {
 
   Consumer* consumer_;
 
+  // Blocked time histograms by message type, see OnSyncSendCompleted().
+  typedef base::hash_map<uint32, base::Histogram*> SyncSendHistogramMap;
+  SyncSendHistogramMap sync_send_histograms_;
+  base::Lock sync_send_histograms_lock_;
+
   static LogFunctionMap* log_function_map_;
 };
 
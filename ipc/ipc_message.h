@@ -35,6 +35,11 @@ namespace IPC {
 
 class Channel;
 class Message;
+
+namespace internal {
+class ChannelReader;
+}  // namespace internal
+
 struct LogData;
 
 class IPC_EXPORT Message : public Pickle {
@@ -190,6 +195,15 @@ class IPC_EXPORT Message : public Pickle {
     return Pickle::FindNext(sizeof(Header), range_start, range_end);
   }
 
+  // Stores the total size of the message that starts at range_start in
+  // |message_size|.  Only its header needs to be within the range.  Returns
+  // false if the header is incomplete.
+  static bool PeekNext(const char* range_start, const char* range_end,
+                       size_t* message_size) {
+    return Pickle::PeekNext(sizeof(Header), range_start, range_end,
+                            message_size);
+  }
+
 #if defined(OS_POSIX)
   // On POSIX, a message supports reading / writing FileDescriptor objects.
   // This is used to pass a file descriptor to the peer of an IPC channel.
@@ -224,6 +238,7 @@ class IPC_EXPORT Message : public Pickle {
 
  protected:
   friend class Channel;
+  friend class internal::ChannelReader;
   friend class MessageReplyDeserializer;
   friend class SyncMessage;
 
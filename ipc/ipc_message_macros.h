@@ -141,6 +141,15 @@
 // inside matching calls to IPC_STRUCT_TRAITS_BEGIN() /
 // IPC_STRUCT_TRAITS_END().
 //
+// Small structs on hot paths whose members are all fixed size numbers (or
+// other such structs) can instead be registered with
+// IPC_POD_STRUCT_TRAITS_BEGIN(), IPC_POD_STRUCT_TRAITS_MEMBER() and
+// IPC_POD_STRUCT_TRAITS_END().  They're written and read with a single copy
+// rather than member by member.  Every member must be listed: it fails to
+// compile if the members don't add up to the size of the struct (so there is
+// padding that would leak uninitialized memory) or if one of them is a bool,
+// enum, pointer or other type for which some bytes aren't a valid value.
+//
 // Enum types are registered with a single IPC_ENUM_TRAITS() macro.  There
 // is no need to enumerate each value to the IPC mechanism.
 //
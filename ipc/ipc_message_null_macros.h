@@ -14,6 +14,9 @@
 #undef IPC_STRUCT_TRAITS_MEMBER
 #undef IPC_STRUCT_TRAITS_PARENT
 #undef IPC_STRUCT_TRAITS_END
+#undef IPC_POD_STRUCT_TRAITS_BEGIN
+#undef IPC_POD_STRUCT_TRAITS_MEMBER
+#undef IPC_POD_STRUCT_TRAITS_END
 #undef IPC_ENUM_TRAITS
 #undef IPC_MESSAGE_DECL
 
@@ -25,6 +28,9 @@
 #define IPC_STRUCT_TRAITS_MEMBER(name)
 #define IPC_STRUCT_TRAITS_PARENT(type)
 #define IPC_STRUCT_TRAITS_END()
+#define IPC_POD_STRUCT_TRAITS_BEGIN(struct_name)
+#define IPC_POD_STRUCT_TRAITS_MEMBER(name)
+#define IPC_POD_STRUCT_TRAITS_END()
 #define IPC_ENUM_TRAITS(enum_name)
 #define IPC_MESSAGE_DECL(sync, kind, msg_class, \
                          in_cnt, out_cnt, in_list, out_list)
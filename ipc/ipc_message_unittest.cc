@@ -8,9 +8,46 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/values.h"
+#include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+struct PodStruct {
+  int x;
+  unsigned int flags;
+  double value;
+};
+
+}  // namespace
+
+// Registers PodStruct the way a _messages.h file would, once for each of the
+// passes that generate its traits.
+#define POD_STRUCT_TRAITS() \
+  IPC_POD_STRUCT_TRAITS_BEGIN(PodStruct) \
+    IPC_POD_STRUCT_TRAITS_MEMBER(x) \
+    IPC_POD_STRUCT_TRAITS_MEMBER(flags) \
+    IPC_POD_STRUCT_TRAITS_MEMBER(value) \
+  IPC_POD_STRUCT_TRAITS_END()
+
+POD_STRUCT_TRAITS()
+
+#include "ipc/param_traits_write_macros.h"
+namespace IPC {
+POD_STRUCT_TRAITS()
+}  // namespace IPC
+
+#include "ipc/param_traits_read_macros.h"
+namespace IPC {
+POD_STRUCT_TRAITS()
+}  // namespace IPC
+
+#include "ipc/param_traits_log_macros.h"
+namespace IPC {
+POD_STRUCT_TRAITS()
+}  // namespace IPC
+
 TEST(IPCMessageTest, ListValue) {
   ListValue input;
   input.Set(0, Value::CreateDoubleValue(42.42));
@@ -67,3 +104,32 @@ TEST(IPCMessageTest, DictionaryValue) {
   iter = PickleIterator(bad_msg);
   EXPECT_FALSE(IPC::ReadParam(&bad_msg, &iter, &output));
 }
+
+TEST(IPCMessageTest, PodStruct) {
+  PodStruct input;
+  input.x = -7;
+  input.flags = 0x80000001;
+  input.value = 42.42;
+
+  IPC::Message msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+  IPC::WriteParam(&msg, input);
+  // The struct is written as is, without per-member framing.
+  EXPECT_EQ(sizeof(PodStruct), msg.payload_size());
+
+  PodStruct output;
+  PickleIterator iter(msg);
+  EXPECT_TRUE(IPC::ReadParam(&msg, &iter, &output));
+  EXPECT_EQ(input.x, output.x);
+  EXPECT_EQ(input.flags, output.flags);
+  EXPECT_EQ(input.value, output.value);
+
+  std::string log;
+  IPC::LogParam(input, &log);
+  EXPECT_EQ(0u, log.find("(-7, 2147483649, "));
+
+  // Also test the truncated case.
+  IPC::Message bad_msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+  bad_msg.WriteInt(99);
+  iter = PickleIterator(bad_msg);
+  EXPECT_FALSE(IPC::ReadParam(&bad_msg, &iter, &output));
+}
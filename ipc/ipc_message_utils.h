@@ -184,6 +184,32 @@ static inline void LogParam(const P& p, std::string* l) {
   ParamTraits<Type>::Log(static_cast<const Type& >(p), l);
 }
 
+//-----------------------------------------------------------------------------
+// Support for the IPC_POD_STRUCT_TRAITS_* macros.
+
+namespace internal {
+
+// Whether a struct member can be copied byte for byte between processes: its
+// size is the same on every platform and any bytes make a valid value.  So no
+// bools, enums, pointers or longs.  Structs registered with
+// IPC_POD_STRUCT_TRAITS_BEGIN() qualify as well.
+template <class P> struct IsPodParam { enum { value = false }; };
+template <> struct IsPodParam<int> { enum { value = true }; };
+template <> struct IsPodParam<unsigned int> { enum { value = true }; };
+template <> struct IsPodParam<long long> { enum { value = true }; };
+template <> struct IsPodParam<unsigned long long> { enum { value = true }; };
+template <> struct IsPodParam<unsigned short> { enum { value = true }; };
+template <> struct IsPodParam<float> { enum { value = true }; };
+template <> struct IsPodParam<double> { enum { value = true }; };
+
+template <class P>
+inline void CheckPodMember(const P&) {
+  COMPILE_ASSERT(IsPodParam<P>::value,
+                 pod_struct_member_must_be_a_fixed_size_number_or_pod_struct);
+}
+
+}  // namespace internal
+
 template <>
 struct ParamTraits<bool> {
   typedef bool param_type;
@@ -0,0 +1,140 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_shared_memory_ring.h"
+
+#include "build/build_config.h"
+
+#if defined(OS_POSIX)
+#include <sys/stat.h>
+#endif
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+// Keeps the free-running uint32 positions unambiguous and the whole segment
+// within what SharedMemory can map.
+const size_t kMaxCapacity = 1 << 30;
+
+}  // namespace
+
+// Lives at the start of the segment. Padded to a cache line so that the
+// reader updating its position doesn't contend with the writer's copies.
+struct SharedMemoryRing::Header {
+  base::subtle::Atomic32 read_position;
+  char padding[64 - sizeof(base::subtle::Atomic32)];
+};
+
+SharedMemoryRing::SharedMemoryRing()
+    : header_(NULL),
+      data_(NULL),
+      capacity_(0),
+      position_(0) {
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+}
+
+// static
+bool SharedMemoryRing::IsValidCapacity(size_t capacity) {
+  return capacity && capacity <= kMaxCapacity &&
+         (capacity & (capacity - 1)) == 0;
+}
+
+bool SharedMemoryRing::CreateForWriting(size_t capacity) {
+  DCHECK(!data_);
+  if (!IsValidCapacity(capacity))
+    return false;
+  shared_memory_.reset(new base::SharedMemory);
+  if (!shared_memory_->CreateAndMapAnonymous(
+          static_cast<uint32>(sizeof(Header) + capacity))) {
+    shared_memory_.reset();
+    return false;
+  }
+  header_ = static_cast<Header*>(shared_memory_->memory());
+  base::subtle::NoBarrier_Store(&header_->read_position, 0);
+  data_ = static_cast<char*>(shared_memory_->memory()) + sizeof(Header);
+  capacity_ = capacity;
+  return true;
+}
+
+bool SharedMemoryRing::MapForReading(const base::SharedMemoryHandle& handle,
+                                     size_t capacity) {
+  DCHECK(!data_);
+  // Adopt the handle first so that it is closed even if |capacity| is bad.
+  shared_memory_.reset(new base::SharedMemory(handle, false));
+  if (!IsValidCapacity(capacity) ||
+      !shared_memory_->Map(static_cast<uint32>(sizeof(Header) + capacity))) {
+    shared_memory_.reset();
+    return false;
+  }
+#if defined(OS_POSIX)
+  // Touching pages past the end of a short segment would fault.
+  struct stat info;
+  if (fstat(handle.fd, &info) != 0 ||
+      static_cast<size_t>(info.st_size) < sizeof(Header) + capacity) {
+    shared_memory_.reset();
+    return false;
+  }
+#endif
+  header_ = static_cast<Header*>(shared_memory_->memory());
+  data_ = static_cast<char*>(shared_memory_->memory()) + sizeof(Header);
+  capacity_ = capacity;
+  return true;
+}
+
+bool SharedMemoryRing::Write(const void* data, size_t len) {
+  DCHECK(data_);
+  // A reader that reports a position ahead of what was written has lost
+  // track; treat the ring as full rather than overwrite unread data.
+  uint32 used = position_ -
+      base::subtle::Acquire_Load(&header_->read_position);
+  if (used > capacity_ || len > capacity_ - used)
+    return false;
+
+  CopyIn(static_cast<const char*>(data), len);
+  // The reader only looks at these bytes after it is told about them over
+  // the socket, but don't rely on the system call for the ordering.
+  base::subtle::MemoryBarrier();
+  return true;
+}
+
+bool SharedMemoryRing::Read(size_t len, std::string* out) {
+  DCHECK(data_);
+  if (len > capacity_)
+    return false;
+
+  out->resize(len);
+  if (len)
+    CopyOut(&(*out)[0], len);
+  base::subtle::Release_Store(&header_->read_position, position_);
+  return true;
+}
+
+void SharedMemoryRing::CopyIn(const char* buffer, size_t len) {
+  size_t offset = position_ & (capacity_ - 1);
+  size_t first = std::min(len, capacity_ - offset);
+  memcpy(data_ + offset, buffer, first);
+  memcpy(data_, buffer + first, len - first);
+  position_ += static_cast<uint32>(len);
+}
+
+void SharedMemoryRing::CopyOut(char* buffer, size_t len) {
+  size_t offset = position_ & (capacity_ - 1);
+  size_t first = std::min(len, capacity_ - offset);
+  memcpy(buffer, data_ + offset, first);
+  memcpy(buffer + first, data_, len - first);
+  position_ += static_cast<uint32>(len);
+}
+
+}  // namespace internal
+}  // namespace IPC
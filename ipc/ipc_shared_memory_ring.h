@@ -0,0 +1,83 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_SHARED_MEMORY_RING_H_
+#define IPC_IPC_SHARED_MEMORY_RING_H_
+#pragma once
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
+#include "ipc/ipc_export.h"
+
+namespace IPC {
+namespace internal {
+
+// A single-producer, single-consumer byte ring in a shared memory segment.
+//
+// The writing side creates the segment and hands its handle to the reading
+// side. The reader is told out of band how many bytes to take each time (the
+// channel sends that count over its socket), so the only state the two sides
+// share is the reader's position, which the writer consults to find free
+// space. Nothing the peer writes into the segment is trusted beyond that: a
+// misbehaving peer can garble the bytes passing through the ring, but can't
+// make either side read or write outside of it.
+class IPC_EXPORT SharedMemoryRing {
+ public:
+  SharedMemoryRing();
+  ~SharedMemoryRing();
+
+  // Returns true if |capacity| is a power of two no larger than the ring
+  // supports.
+  static bool IsValidCapacity(size_t capacity);
+
+  // Creates and maps a new segment with room for |capacity| bytes of data.
+  // |capacity| must be valid, see IsValidCapacity(). Returns false on
+  // failure.
+  bool CreateForWriting(size_t capacity);
+
+  // Maps a segment created by a peer's CreateForWriting() with the same
+  // |capacity|. Takes ownership of |handle|. Returns false on failure.
+  bool MapForReading(const base::SharedMemoryHandle& handle, size_t capacity);
+
+  // The handle to send to the reading side.
+  base::SharedMemoryHandle handle() const { return shared_memory_->handle(); }
+
+  size_t capacity() const { return capacity_; }
+
+  // Copies |len| bytes into the ring. Returns false without copying anything
+  // if the reader hasn't yet freed enough room for all of them.
+  bool Write(const void* data, size_t len);
+
+  // Replaces the contents of |out| with the next |len| bytes of the ring and
+  // frees their room for the writer. Returns false if |len| is more than the
+  // ring can hold.
+  bool Read(size_t len, std::string* out);
+
+ private:
+  struct Header;
+
+  // Copy |len| bytes into or out of the ring at |position_|, wrapping around
+  // the end of the data area, and advance |position_| past them.
+  void CopyIn(const char* buffer, size_t len);
+  void CopyOut(char* buffer, size_t len);
+
+  scoped_ptr<base::SharedMemory> shared_memory_;
+  Header* header_;
+  char* data_;
+  size_t capacity_;
+
+  // The write position for the writing side and the read position for the
+  // reading side. Positions run freely and are reduced modulo |capacity_|.
+  uint32 position_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+}  // namespace internal
+}  // namespace IPC
+
+#endif  // IPC_IPC_SHARED_MEMORY_RING_H_
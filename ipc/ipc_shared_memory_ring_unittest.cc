@@ -0,0 +1,111 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "build/build_config.h"
+
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif
+
+#include <string>
+
+#include "ipc/ipc_shared_memory_ring.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using IPC::internal::SharedMemoryRing;
+
+namespace {
+
+const size_t kCapacity = 64;
+
+// Returns a handle to |ring|'s segment that a second SharedMemoryRing can
+// adopt, as the receiving process would after the handle is sent to it.
+base::SharedMemoryHandle DuplicateHandle(const SharedMemoryRing& ring) {
+#if defined(OS_POSIX)
+  return base::FileDescriptor(dup(ring.handle().fd), true);
+#elif defined(OS_WIN)
+  HANDLE handle = NULL;
+  ::DuplicateHandle(GetCurrentProcess(), ring.handle(), GetCurrentProcess(),
+                    &handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
+  return handle;
+#endif
+}
+
+class SharedMemoryRingTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(writer_.CreateForWriting(kCapacity));
+    ASSERT_TRUE(reader_.MapForReading(DuplicateHandle(writer_), kCapacity));
+  }
+
+  SharedMemoryRing writer_;
+  SharedMemoryRing reader_;
+};
+
+TEST_F(SharedMemoryRingTest, WriteAndRead) {
+  ASSERT_TRUE(writer_.Write("hello", 5));
+  ASSERT_TRUE(writer_.Write(" world", 6));
+
+  std::string out;
+  ASSERT_TRUE(reader_.Read(5, &out));
+  EXPECT_EQ("hello", out);
+  ASSERT_TRUE(reader_.Read(6, &out));
+  EXPECT_EQ(" world", out);
+  ASSERT_TRUE(reader_.Read(0, &out));
+  EXPECT_TRUE(out.empty());
+}
+
+TEST_F(SharedMemoryRingTest, WrapAround) {
+  std::string out;
+  for (int i = 0; i < 10; ++i) {
+    // 40 doesn't divide the capacity, so most of these straddle the end.
+    std::string data(40, static_cast<char>('a' + i));
+    data[0] = 'x';
+    data[39] = 'y';
+    ASSERT_TRUE(writer_.Write(data.data(), data.size()));
+    ASSERT_TRUE(reader_.Read(data.size(), &out));
+    EXPECT_EQ(data, out);
+  }
+}
+
+TEST_F(SharedMemoryRingTest, Full) {
+  std::string data(kCapacity - 4, 'a');
+  ASSERT_TRUE(writer_.Write(data.data(), data.size()));
+
+  // Writes are all or nothing.
+  EXPECT_FALSE(writer_.Write("12345", 5));
+  EXPECT_TRUE(writer_.Write("1234", 4));
+  EXPECT_FALSE(writer_.Write("1", 1));
+
+  std::string out;
+  ASSERT_TRUE(reader_.Read(10, &out));
+  EXPECT_TRUE(writer_.Write("0123456789", 10));
+  EXPECT_FALSE(writer_.Write("1", 1));
+}
+
+TEST_F(SharedMemoryRingTest, TooLarge) {
+  std::string data(kCapacity + 1, 'a');
+  EXPECT_FALSE(writer_.Write(data.data(), data.size()));
+
+  std::string out;
+  EXPECT_FALSE(reader_.Read(kCapacity + 1, &out));
+}
+
+TEST(SharedMemoryRingCreateTest, BadCapacity) {
+  SharedMemoryRing ring;
+  EXPECT_FALSE(ring.CreateForWriting(0));
+  EXPECT_FALSE(ring.CreateForWriting(100));
+}
+
+TEST(SharedMemoryRingCreateTest, MapLargerThanSegment) {
+  SharedMemoryRing writer;
+  ASSERT_TRUE(writer.CreateForWriting(kCapacity));
+
+  // A peer claiming a bigger ring than it actually created is refused
+  // rather than mapped past the end of the segment.
+  SharedMemoryRing reader;
+  EXPECT_FALSE(reader.MapForReading(DuplicateHandle(writer), 64 * 1024));
+}
+
+}  // namespace
@@ -20,5 +20,10 @@ const char kProcessChannelID[]              = "channel";
 // kDebugOnStart flag passed on or not.
 const char kDebugChildren[]                 = "debug-children";
 
+// Records the shape of the messages each channel receives (type, size and
+// timing, not contents) into a file per channel in the given directory, for
+// replaying offline. See ipc/ipc_traffic_recorder.h.
+const char kIPCRecordTraffic[]              = "ipc-record-traffic";
+
 }  // namespace switches
 
@@ -14,6 +14,7 @@ namespace switches {
 
 IPC_EXPORT extern const char kProcessChannelID[];
 IPC_EXPORT extern const char kDebugChildren[];
+IPC_EXPORT extern const char kIPCRecordTraffic[];
 
 }  // namespace switches
 
@@ -11,6 +11,7 @@
 #include "base/threading/thread_local.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/synchronization/waitable_event_watcher.h"
+#include "ipc/ipc_logging.h"
 #include "ipc/ipc_sync_message.h"
 
 using base::TimeDelta;
@@ -436,6 +437,10 @@ bool SyncChannel::SendWithTimeout(Message* message, int timeout_ms) {
   context->Push(sync_msg);
   int message_id = SyncMessage::GetMessageId(*sync_msg);
   WaitableEvent* pump_messages_event = sync_msg->pump_messages_event();
+#ifdef IPC_MESSAGE_LOG_ENABLED
+  uint32 message_type = sync_msg->type();
+  TimeTicks send_start = TimeTicks::Now();
+#endif
 
   ChannelProxy::Send(message);
 
@@ -453,6 +458,11 @@ bool SyncChannel::SendWithTimeout(Message* message, int timeout_ms) {
   // *this* might get deleted, so only call static functions at this point.
   WaitForReply(context, pump_messages_event);
 
+#ifdef IPC_MESSAGE_LOG_ENABLED
+  Logging::GetInstance()->OnSyncSendCompleted(
+      message_type, TimeTicks::Now() - send_start);
+#endif
+
   return context->Pop();
 }
 
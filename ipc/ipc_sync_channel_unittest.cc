@@ -1176,6 +1176,95 @@ TEST_F(IPCSyncChannelTest, SyncMessageFilter) {
   RunTest(workers);
 }
 
+//-----------------------------------------------------------------------------
+
+namespace {
+
+// Counts the messages it is offered, optionally only asking for one class.
+class CountingFilter : public ChannelProxy::MessageFilter {
+ public:
+  explicit CountingFilter(int message_class)
+      : message_class_(message_class),
+        messages_offered_(0) {
+  }
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    messages_offered_++;
+    return false;
+  }
+
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (message_class_ < 0)
+      return false;
+    supported_message_classes->push_back(message_class_);
+    return true;
+  }
+
+  int messages_offered() const { return messages_offered_; }
+
+ private:
+  virtual ~CountingFilter() {}
+
+  int message_class_;
+  int messages_offered_;
+};
+
+class MessageClassFilterClient : public Worker {
+ public:
+  MessageClassFilterClient()
+      : Worker(Channel::MODE_CLIENT, "simple_client"),
+        test_filter_(new CountingFilter(TestMsgStart)),
+        other_filter_(new CountingFilter(ClipboardMsgStart)),
+        global_filter_(new CountingFilter(-1)) {
+  }
+
+  void OnAnswer(int* answer) {
+    *answer = 42;
+    Done();
+  }
+
+  // Adds the filters before the channel connects so that none of them can
+  // miss the server's message.
+  virtual SyncChannel* CreateChannel() OVERRIDE {
+    SyncChannel* channel = new SyncChannel(
+        this, ipc_thread().message_loop_proxy(), shutdown_event());
+    channel->AddFilter(test_filter_.get());
+    channel->AddFilter(other_filter_.get());
+    channel->AddFilter(global_filter_.get());
+    channel->Init(channel_name(), mode(), false);
+    return channel;
+  }
+
+  scoped_refptr<CountingFilter> test_filter_;
+  scoped_refptr<CountingFilter> other_filter_;
+  scoped_refptr<CountingFilter> global_filter_;
+};
+
+}  // namespace
+
+// Tests that filters are only offered the message classes they ask for.
+TEST_F(IPCSyncChannelTest, MessageClassFilters) {
+  scoped_refptr<CountingFilter> test_filter;
+  scoped_refptr<CountingFilter> other_filter;
+  scoped_refptr<CountingFilter> global_filter;
+  {
+    std::vector<Worker*> workers;
+    workers.push_back(new SimpleServer(false));
+    MessageClassFilterClient* client = new MessageClassFilterClient();
+    test_filter = client->test_filter_;
+    other_filter = client->other_filter_;
+    global_filter = client->global_filter_;
+    workers.push_back(client);
+    RunTest(workers);
+  }
+
+  // The server sends a single TestMsgStart message.
+  EXPECT_EQ(1, test_filter->messages_offered());
+  EXPECT_EQ(0, other_filter->messages_offered());
+  EXPECT_EQ(1, global_filter->messages_offered());
+}
+
 // Test the case when the channel is closed and a Send is attempted after that.
 TEST_F(IPCSyncChannelTest, SendAfterClose) {
   ServerSendAfterClose server;
@@ -1958,4 +2047,118 @@ TEST_F(IPCSyncChannelTest, Verified) {
   Verified();
 }
 
+//-----------------------------------------------------------------------------
+
+namespace {
+
+// Signals |event| once |count| messages have been through the IPC thread.
+class ArrivalFilter : public ChannelProxy::MessageFilter {
+ public:
+  ArrivalFilter(int count, WaitableEvent* event)
+      : remaining_(count),
+        event_(event) {
+  }
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    // The channel queues the message for the listener thread only after the
+    // filters pass on it, so signal once it is done with this one.
+    if (--remaining_ == 0) {
+      MessageLoop::current()->PostTask(
+          FROM_HERE,
+          base::Bind(&WaitableEvent::Signal, base::Unretained(event_)));
+    }
+    return false;
+  }
+
+ private:
+  virtual ~ArrivalFilter() {}
+
+  int remaining_;
+  WaitableEvent* event_;
+};
+
+class PrioritizedServer : public Worker {
+ public:
+  explicit PrioritizedServer(std::vector<int>* dispatch_order)
+      : Worker("prioritized_channel", Channel::MODE_SERVER),
+        all_arrived_(false, false),
+        dispatch_order_(dispatch_order) {
+  }
+
+  // Keeps the listener thread busy until every message has reached the IPC
+  // thread, so they are all queued for it when it gets to them.
+  virtual void Run() OVERRIDE {
+    all_arrived_.Wait();
+  }
+
+ private:
+  virtual SyncChannel* CreateChannel() OVERRIDE {
+    SyncChannel* channel = new SyncChannel(
+        this, ipc_thread().message_loop_proxy(), shutdown_event());
+    channel->set_prioritize_sync_messages(true);
+    channel->AddFilter(new ArrivalFilter(3, &all_arrived_));
+    channel->Init(channel_name(), mode(), true);
+    return channel;
+  }
+
+  bool OnMessageReceived(const Message& message) {
+    IPC_BEGIN_MESSAGE_MAP(PrioritizedServer, message)
+     IPC_MESSAGE_HANDLER(SyncChannelTestMsg_Ping, OnPing)
+     IPC_MESSAGE_HANDLER(SyncChannelTestMsg_PingTTL, OnPingTTL)
+    IPC_END_MESSAGE_MAP()
+    return true;
+  }
+
+  void OnPing(int ping) {
+    dispatch_order_->push_back(ping);
+    if (ping == 2)
+      Done();
+  }
+
+  void OnPingTTL(int ping, int* out) {
+    dispatch_order_->push_back(ping);
+    *out = ping;
+  }
+
+  WaitableEvent all_arrived_;
+  std::vector<int>* dispatch_order_;
+};
+
+class PrioritizedClient : public Worker {
+ public:
+  PrioritizedClient()
+      : Worker("prioritized_channel", Channel::MODE_CLIENT) {
+  }
+
+  virtual void Run() OVERRIDE {
+    Send(new SyncChannelTestMsg_Ping(1));
+    Send(new SyncChannelTestMsg_Ping(2));
+    int value = 0;
+    SyncMessage* msg = new SyncChannelTestMsg_PingTTL(3, &value);
+    // Without the unblock flag the server dispatches the message like any
+    // other, as a plain ChannelProxy would.
+    msg->set_unblock(false);
+    Send(msg);
+    DCHECK_EQ(3, value);
+    Done();
+  }
+};
+
+}  // namespace
+
+// Tests that a channel prioritizing sync messages dispatches them ahead of
+// async messages that are already queued.
+TEST_F(IPCSyncChannelTest, PrioritizeSyncMessages) {
+  std::vector<int> dispatch_order;
+  std::vector<Worker*> workers;
+  workers.push_back(new PrioritizedServer(&dispatch_order));
+  workers.push_back(new PrioritizedClient());
+  RunTest(workers);
+
+  ASSERT_EQ(3u, dispatch_order.size());
+  EXPECT_EQ(3, dispatch_order[0]);
+  EXPECT_EQ(1, dispatch_order[1]);
+  EXPECT_EQ(2, dispatch_order[2]);
+}
+
 }  // namespace IPC
@@ -17,7 +17,8 @@ enum ChildType {
   TEST_DESCRIPTOR_CLIENT_SANDBOXED,
   TEST_REFLECTOR,
   FUZZER_SERVER,
-  SYNC_SOCKET_SERVER
+  SYNC_SOCKET_SERVER,
+  REPLAY_SINK
 };
 
 // The different channel names for the child processes.
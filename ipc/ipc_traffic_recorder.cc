@@ -0,0 +1,145 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_traffic_recorder.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/threading/thread_restrictions.h"
+
+namespace IPC {
+
+namespace {
+
+// Identifies a recording file, and its format.
+const uint32 kRecordingMagic = 0x49504354;  // 'IPCT'
+const int kRecordingVersion = 1;
+
+}  // namespace
+
+RecordedMessage::RecordedMessage()
+    : time_offset_us(0),
+      routing_id(0),
+      type(0),
+      priority(Message::PRIORITY_NORMAL),
+      is_sync(false),
+      is_reply(false),
+      payload_size(0) {
+}
+
+TrafficRecorder::TrafficRecorder(const FilePath& path)
+    : path_(path) {
+}
+
+TrafficRecorder::~TrafficRecorder() {
+}
+
+bool TrafficRecorder::OnMessageReceived(const Message& message) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (messages_.empty())
+    start_time_ = now;
+
+  RecordedMessage recorded;
+  recorded.time_offset_us = (now - start_time_).InMicroseconds();
+  recorded.routing_id = message.routing_id();
+  recorded.type = message.type();
+  recorded.priority = message.priority();
+  recorded.is_sync = message.is_sync();
+  recorded.is_reply = message.is_reply();
+  recorded.payload_size = static_cast<uint32>(message.payload_size());
+  messages_.push_back(recorded);
+  return false;
+}
+
+void TrafficRecorder::OnChannelClosing() {
+  if (path_.empty())
+    return;
+  // This is a debugging aid, so writing from the IPC thread is acceptable.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!WriteToFile(path_, messages_))
+    LOG(ERROR) << "Failed to write IPC traffic to " << path_.value();
+}
+
+// static
+bool TrafficRecorder::WriteToFile(
+    const FilePath& path,
+    const std::vector<RecordedMessage>& messages) {
+  Pickle pickle;
+  pickle.WriteUInt32(kRecordingMagic);
+  pickle.WriteInt(kRecordingVersion);
+  pickle.WriteInt(static_cast<int>(messages.size()));
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const RecordedMessage& recorded = messages[i];
+    pickle.WriteInt64(recorded.time_offset_us);
+    pickle.WriteInt(recorded.routing_id);
+    pickle.WriteUInt32(recorded.type);
+    pickle.WriteInt(recorded.priority);
+    pickle.WriteBool(recorded.is_sync);
+    pickle.WriteBool(recorded.is_reply);
+    pickle.WriteUInt32(recorded.payload_size);
+  }
+
+  int size = static_cast<int>(pickle.size());
+  return file_util::WriteFile(
+      path, static_cast<const char*>(pickle.data()), size) == size;
+}
+
+// static
+bool TrafficRecorder::ReadFromFile(const FilePath& path,
+                                   std::vector<RecordedMessage>* messages) {
+  std::string data;
+  if (!file_util::ReadFileToString(path, &data))
+    return false;
+
+  Pickle pickle(data.data(), static_cast<int>(data.size()));
+  PickleIterator iter(pickle);
+  uint32 magic;
+  int version;
+  int count;
+  if (!iter.ReadUInt32(&magic) || magic != kRecordingMagic ||
+      !iter.ReadInt(&version) || version != kRecordingVersion ||
+      !iter.ReadInt(&count) || count < 0) {
+    return false;
+  }
+
+  messages->clear();
+  for (int i = 0; i < count; ++i) {
+    RecordedMessage recorded;
+    int priority;
+    if (!iter.ReadInt64(&recorded.time_offset_us) ||
+        !iter.ReadInt(&recorded.routing_id) ||
+        !iter.ReadUInt32(&recorded.type) ||
+        !iter.ReadInt(&priority) ||
+        !iter.ReadBool(&recorded.is_sync) ||
+        !iter.ReadBool(&recorded.is_reply) ||
+        !iter.ReadUInt32(&recorded.payload_size)) {
+      return false;
+    }
+    if (priority < Message::PRIORITY_LOW || priority > Message::PRIORITY_HIGH)
+      return false;
+    recorded.priority = static_cast<Message::PriorityValue>(priority);
+    messages->push_back(recorded);
+  }
+  return true;
+}
+
+// static
+Message* TrafficRecorder::CreateReplayMessage(const RecordedMessage& recorded) {
+  Message* message = new Message(recorded.routing_id, recorded.type,
+                                 recorded.priority);
+  if (recorded.is_sync)
+    message->set_sync();
+  if (recorded.is_reply)
+    message->set_reply();
+  if (recorded.payload_size) {
+    std::string filler(recorded.payload_size, 'x');
+    message->WriteBytes(filler.data(), static_cast<int>(filler.size()));
+  }
+  return message;
+}
+
+}  // namespace IPC
@@ -0,0 +1,81 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_TRAFFIC_RECORDER_H_
+#define IPC_IPC_TRAFFIC_RECORDER_H_
+#pragma once
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/file_path.h"
+#include "base/time.h"
+#include "ipc/ipc_channel_proxy.h"
+#include "ipc/ipc_export.h"
+#include "ipc/ipc_message.h"
+
+namespace IPC {
+
+// The shape of one message seen by a TrafficRecorder: everything needed to
+// send a look-alike message again, but none of its contents.
+struct IPC_EXPORT RecordedMessage {
+  RecordedMessage();
+
+  // Microseconds since the first message of the recording arrived.
+  int64 time_offset_us;
+  int32 routing_id;
+  uint32 type;
+  Message::PriorityValue priority;
+  bool is_sync;
+  bool is_reply;
+  // Bytes of payload, not counting the message header.
+  uint32 payload_size;
+};
+
+// Records the type, size and arrival time of every message a ChannelProxy
+// receives, so that real traffic can be replayed offline to benchmark the
+// channel, dispatch and filter code (see the PERFORMANCE_TEST section of
+// ipc_tests.cc).  Message contents are never recorded.
+//
+// The recorder is a filter that never handles a message; add it first so it
+// sees everything.  ChannelProxy adds one to each channel when the process
+// runs with --ipc-record-traffic.
+class IPC_EXPORT TrafficRecorder : public ChannelProxy::MessageFilter {
+ public:
+  // If |path| isn't empty the recording is written there when the channel
+  // closes.
+  explicit TrafficRecorder(const FilePath& path);
+
+  // ChannelProxy::MessageFilter methods:
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE;
+  virtual void OnChannelClosing() OVERRIDE;
+
+  // The messages recorded so far.  Only use this on the IPC thread, or once
+  // the channel has closed.
+  const std::vector<RecordedMessage>& messages() const { return messages_; }
+
+  // Write and read recordings.  Return false if the file can't be written, or
+  // can't be read or isn't a recording.
+  static bool WriteToFile(const FilePath& path,
+                          const std::vector<RecordedMessage>& messages);
+  static bool ReadFromFile(const FilePath& path,
+                           std::vector<RecordedMessage>* messages);
+
+  // Returns a new message with the header of |recorded| and as many bytes of
+  // filler as its payload had.
+  static Message* CreateReplayMessage(const RecordedMessage& recorded);
+
+ private:
+  virtual ~TrafficRecorder();
+
+  FilePath path_;
+  base::TimeTicks start_time_;
+  std::vector<RecordedMessage> messages_;
+
+  DISALLOW_COPY_AND_ASSIGN(TrafficRecorder);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_TRAFFIC_RECORDER_H_
@@ -0,0 +1,109 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_traffic_recorder.h"
+
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+
+namespace {
+
+TEST(TrafficRecorderTest, RecordsMessageShape) {
+  scoped_refptr<TrafficRecorder> recorder(new TrafficRecorder(FilePath()));
+
+  Message async(3, 100, Message::PRIORITY_LOW);
+  async.WriteString("some contents");
+  Message sync(MSG_ROUTING_CONTROL, 200, Message::PRIORITY_HIGH);
+  sync.set_sync();
+
+  EXPECT_FALSE(recorder->OnMessageReceived(async));
+  EXPECT_FALSE(recorder->OnMessageReceived(sync));
+
+  const std::vector<RecordedMessage>& messages = recorder->messages();
+  ASSERT_EQ(2u, messages.size());
+  EXPECT_EQ(0, messages[0].time_offset_us);
+  EXPECT_EQ(3, messages[0].routing_id);
+  EXPECT_EQ(100u, messages[0].type);
+  EXPECT_EQ(Message::PRIORITY_LOW, messages[0].priority);
+  EXPECT_FALSE(messages[0].is_sync);
+  EXPECT_EQ(async.payload_size(), messages[0].payload_size);
+  EXPECT_LE(0, messages[1].time_offset_us);
+  EXPECT_EQ(MSG_ROUTING_CONTROL, messages[1].routing_id);
+  EXPECT_TRUE(messages[1].is_sync);
+  EXPECT_EQ(0u, messages[1].payload_size);
+}
+
+TEST(TrafficRecorderTest, FileRoundTrip) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath path = temp_dir.path().AppendASCII("recording");
+
+  std::vector<RecordedMessage> written(2);
+  written[0].time_offset_us = 0;
+  written[0].routing_id = 7;
+  written[0].type = 0x10005;
+  written[0].payload_size = 64;
+  written[1].time_offset_us = 1500;
+  written[1].routing_id = MSG_ROUTING_CONTROL;
+  written[1].type = 0x20001;
+  written[1].priority = Message::PRIORITY_HIGH;
+  written[1].is_sync = true;
+  ASSERT_TRUE(TrafficRecorder::WriteToFile(path, written));
+
+  std::vector<RecordedMessage> read;
+  ASSERT_TRUE(TrafficRecorder::ReadFromFile(path, &read));
+  ASSERT_EQ(2u, read.size());
+  for (size_t i = 0; i < read.size(); ++i) {
+    EXPECT_EQ(written[i].time_offset_us, read[i].time_offset_us);
+    EXPECT_EQ(written[i].routing_id, read[i].routing_id);
+    EXPECT_EQ(written[i].type, read[i].type);
+    EXPECT_EQ(written[i].priority, read[i].priority);
+    EXPECT_EQ(written[i].is_sync, read[i].is_sync);
+    EXPECT_EQ(written[i].is_reply, read[i].is_reply);
+    EXPECT_EQ(written[i].payload_size, read[i].payload_size);
+  }
+}
+
+TEST(TrafficRecorderTest, RejectsOtherFiles) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath path = temp_dir.path().AppendASCII("not_a_recording");
+  const char kData[] = "not a recording at all";
+  ASSERT_EQ(static_cast<int>(sizeof(kData)),
+            file_util::WriteFile(path, kData, sizeof(kData)));
+
+  std::vector<RecordedMessage> read;
+  EXPECT_FALSE(TrafficRecorder::ReadFromFile(path, &read));
+  EXPECT_FALSE(TrafficRecorder::ReadFromFile(
+      temp_dir.path().AppendASCII("missing"), &read));
+}
+
+TEST(TrafficRecorderTest, CreateReplayMessage) {
+  RecordedMessage recorded;
+  recorded.routing_id = 5;
+  recorded.type = 0x30002;
+  recorded.priority = Message::PRIORITY_LOW;
+  recorded.is_sync = true;
+  recorded.payload_size = 128;
+
+  scoped_ptr<Message> message(TrafficRecorder::CreateReplayMessage(recorded));
+  EXPECT_EQ(5, message->routing_id());
+  EXPECT_EQ(0x30002u, message->type());
+  EXPECT_EQ(Message::PRIORITY_LOW, message->priority());
+  EXPECT_TRUE(message->is_sync());
+  EXPECT_FALSE(message->is_reply());
+  EXPECT_EQ(128u, message->payload_size());
+}
+
+}  // namespace
+
+}  // namespace IPC
@@ -45,6 +45,14 @@
     l->append(")"); \
   }
 
+#undef IPC_POD_STRUCT_TRAITS_BEGIN
+#undef IPC_POD_STRUCT_TRAITS_MEMBER
+#undef IPC_POD_STRUCT_TRAITS_END
+#define IPC_POD_STRUCT_TRAITS_BEGIN(struct_name) \
+  IPC_STRUCT_TRAITS_BEGIN(struct_name)
+#define IPC_POD_STRUCT_TRAITS_MEMBER(name) IPC_STRUCT_TRAITS_MEMBER(name)
+#define IPC_POD_STRUCT_TRAITS_END() IPC_STRUCT_TRAITS_END()
+
 #undef IPC_ENUM_TRAITS
 #define IPC_ENUM_TRAITS(enum_name) \
   void ParamTraits<enum_name>::Log(const param_type& p, std::string* l) { \
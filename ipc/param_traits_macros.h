@@ -23,6 +23,27 @@
 #define IPC_STRUCT_TRAITS_PARENT(type)
 #define IPC_STRUCT_TRAITS_END()
 
+// Traits generation for structs that are sent as a single block of bytes.
+#define IPC_POD_STRUCT_TRAITS_BEGIN(struct_name) \
+  namespace IPC { \
+    template <> \
+    struct IPC_MESSAGE_EXPORT ParamTraits<struct_name> { \
+      typedef struct_name param_type; \
+      static void Write(Message* m, const param_type& p); \
+      static bool Read(const Message* m, PickleIterator* iter, param_type* p); \
+      static void Log(const param_type& p, std::string* l); \
+    }; \
+    namespace internal { \
+      template <> \
+      struct IsPodParam<struct_name> { \
+        enum { value = true }; \
+      }; \
+    } \
+  }
+
+#define IPC_POD_STRUCT_TRAITS_MEMBER(name)
+#define IPC_POD_STRUCT_TRAITS_END()
+
 // Traits generation for enums.
 #define IPC_ENUM_TRAITS(enum_name) \
   namespace IPC { \
@@ -6,6 +6,8 @@
 #define IPC_PARAM_TRAITS_READ_MACROS_H_
 #pragma once
 
+#include <string.h>
+
 // Null out all the macros that need nulling.
 #include "ipc/ipc_message_null_macros.h"
 
@@ -33,6 +35,23 @@
 #define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Read(m, iter, p) &&
 #define IPC_STRUCT_TRAITS_END() 1; }
 
+// POD structs are read with one copy, which is only safe if any bytes make
+// valid members; the member list is checked for that.
+#undef IPC_POD_STRUCT_TRAITS_BEGIN
+#undef IPC_POD_STRUCT_TRAITS_MEMBER
+#undef IPC_POD_STRUCT_TRAITS_END
+#define IPC_POD_STRUCT_TRAITS_BEGIN(struct_name) \
+  bool ParamTraits<struct_name>:: \
+      Read(const Message* m, PickleIterator* iter, param_type* p) {
+#define IPC_POD_STRUCT_TRAITS_MEMBER(name) internal::CheckPodMember(p->name);
+#define IPC_POD_STRUCT_TRAITS_END() \
+    const char* data; \
+    if (!m->ReadBytes(iter, &data, sizeof(param_type))) \
+      return false; \
+    memcpy(p, data, sizeof(param_type)); \
+    return true; \
+  }
+
 #undef IPC_ENUM_TRAITS
 #define IPC_ENUM_TRAITS(enum_name) \
   bool ParamTraits<enum_name>:: \
@@ -31,6 +31,24 @@
 #define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Write(m, p);
 #define IPC_STRUCT_TRAITS_END() }
 
+// POD structs are written with one copy. Listing every member lets the
+// compiler check that they cover the whole struct, so no padding (or
+// uninitialized memory) is sent.
+#undef IPC_POD_STRUCT_TRAITS_BEGIN
+#undef IPC_POD_STRUCT_TRAITS_MEMBER
+#undef IPC_POD_STRUCT_TRAITS_END
+#define IPC_POD_STRUCT_TRAITS_BEGIN(struct_name) \
+  void ParamTraits<struct_name>::Write(Message* m, const param_type& p) { \
+    enum { kListedSize = 0
+#define IPC_POD_STRUCT_TRAITS_MEMBER(name) \
+        + sizeof(static_cast<const param_type*>(NULL)->name)
+#define IPC_POD_STRUCT_TRAITS_END() \
+    }; \
+    COMPILE_ASSERT(kListedSize == sizeof(param_type), \
+                   pod_struct_has_padding_or_unlisted_members); \
+    m->WriteBytes(&p, sizeof(param_type)); \
+  }
+
 #undef IPC_ENUM_TRAITS
 #define IPC_ENUM_TRAITS(enum_name) \
   void ParamTraits<enum_name>::Write(Message* m, const param_type& p) { \
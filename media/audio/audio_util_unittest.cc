@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "base/basictypes.h"
 #include "media/audio/audio_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -161,6 +163,34 @@ TEST(AudioUtilTest, MixStreams_s32_FullVolume) {
   EXPECT_EQ(0, expected_test);
 }
 
+// Covers buffers longer than the 4 sample tests above, so that vectorized
+// implementations are exercised both in their main loop and on the tail.
+TEST(AudioUtilTest, MixStreams_s16_LongBuffer) {
+  const int kSamples = 37;
+  const float kVolumes[] = { 1.0f, 0.75f, 0.25f };
+  for (size_t v = 0; v < arraysize(kVolumes); ++v) {
+    int16 dst_s16[kSamples];
+    int16 src_s16[kSamples];
+    int16 expected_s16[kSamples];
+    const int fixed_volume = static_cast<int>(kVolumes[v] * 65536);
+    for (int i = 0; i < kSamples; ++i) {
+      dst_s16[i] = static_cast<int16>((i * 7919) % 65536 - 32768);
+      src_s16[i] = static_cast<int16>(32767 - (i * 4099) % 65536);
+      int scaled = (src_s16[i] * fixed_volume) >> 16;
+      int sum = dst_s16[i] + scaled;
+      expected_s16[i] = static_cast<int16>(std::max(-32768,
+                                                    std::min(32767, sum)));
+    }
+    media::MixStreams(dst_s16,
+                      src_s16,
+                      sizeof(dst_s16),
+                      sizeof(src_s16[0]),
+                      kVolumes[v]);
+    EXPECT_EQ(0, memcmp(dst_s16, expected_s16, sizeof(expected_s16)))
+        << "volume " << kVolumes[v];
+  }
+}
+
 TEST(AudioUtilTest, FoldChannels_u8) {
   // Test FoldChannels() on 8 bit samples.
   uint8 samples_u8[6] = { 100, 150, 130, 70, 130, 170 };
@@ -0,0 +1,46 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "media/base/simd/filter_yuv.h"
+
+namespace media {
+
+void FilterYUVRows_NEON(uint8* dest,
+                        const uint8* src0,
+                        const uint8* src1,
+                        int width,
+                        int fraction) {
+  // 256 - 0 doesn't fit in a byte, but a zero fraction is just a copy.
+  if (!fraction) {
+    memcpy(dest, src0, width);
+    return;
+  }
+
+  uint8x8_t src0_fraction = vdup_n_u8(256 - fraction);
+  uint8x8_t src1_fraction = vdup_n_u8(fraction);
+  int pixel = 0;
+
+  // The weighted sum is at most 255 * 256, so 16 bit lanes can't overflow.
+  for (; pixel + 16 <= width; pixel += 16) {
+    uint8x16_t row0 = vld1q_u8(src0 + pixel);
+    uint8x16_t row1 = vld1q_u8(src1 + pixel);
+    uint16x8_t low = vmull_u8(vget_low_u8(row0), src0_fraction);
+    uint16x8_t high = vmull_u8(vget_high_u8(row0), src0_fraction);
+    low = vmlal_u8(low, vget_low_u8(row1), src1_fraction);
+    high = vmlal_u8(high, vget_high_u8(row1), src1_fraction);
+    vst1q_u8(dest + pixel,
+             vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8)));
+  }
+
+  while (pixel < width) {
+    dest[pixel] = (src0[pixel] * (256 - fraction) +
+                   src1[pixel] * fraction) >> 8;
+    ++pixel;
+  }
+}
+
+}  // namespace media
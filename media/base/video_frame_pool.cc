@@ -0,0 +1,54 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+namespace media {
+
+VideoFramePool::VideoFramePool(size_t max_frames)
+    : max_frames_(max_frames) {
+}
+
+VideoFramePool::~VideoFramePool() {
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::CreateFrame(
+    VideoFrame::Format format,
+    size_t width,
+    size_t height,
+    base::TimeDelta timestamp,
+    base::TimeDelta duration) {
+  FrameList::iterator stale = frames_.end();
+  for (FrameList::iterator it = frames_.begin(); it != frames_.end(); ++it) {
+    // Only the pool references a free frame, so nobody else can take a new
+    // reference to it while we look at it.
+    if (!(*it)->HasOneRef())
+      continue;
+
+    if ((*it)->format() == format && (*it)->width() == width &&
+        (*it)->height() == height) {
+      (*it)->SetTimestamp(timestamp);
+      (*it)->SetDuration(duration);
+      return *it;
+    }
+    stale = it;
+  }
+
+  // A free frame of another size won't be wanted again once the stream has
+  // changed size; make room for one that will.
+  if (stale != frames_.end())
+    frames_.erase(stale);
+
+  scoped_refptr<VideoFrame> frame =
+      VideoFrame::CreateFrame(format, width, height, timestamp, duration);
+  if (frames_.size() < max_frames_)
+    frames_.push_back(frame);
+  return frame;
+}
+
+void VideoFramePool::Clear() {
+  frames_.clear();
+}
+
+}  // namespace media
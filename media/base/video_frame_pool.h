@@ -0,0 +1,60 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_BASE_VIDEO_FRAME_POOL_H_
+#define MEDIA_BASE_VIDEO_FRAME_POOL_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/time.h"
+#include "media/base/media_export.h"
+#include "media/base/video_frame.h"
+
+namespace media {
+
+// Recycles system memory VideoFrames so that a decoder producing a steady
+// stream of same-sized frames doesn't allocate a new frame for each one.
+//
+// The pool keeps a reference to every frame it hands out. A frame becomes
+// reusable once every other reference to it has been dropped, so consumers
+// release frames the usual way and need not know about the pool.
+//
+// Not thread safe; must be used on a single thread. Frames may be released on
+// any thread.
+class MEDIA_EXPORT VideoFramePool {
+ public:
+  // At most |max_frames| frames are kept for reuse. Frames requested while
+  // all of those are in use are allocated outside the pool.
+  explicit VideoFramePool(size_t max_frames);
+  ~VideoFramePool();
+
+  // Returns a frame with the given parameters, reusing a free pooled frame if
+  // one matches |format|, |width| and |height|. The contents of the frame's
+  // planes are undefined.
+  scoped_refptr<VideoFrame> CreateFrame(VideoFrame::Format format,
+                                        size_t width,
+                                        size_t height,
+                                        base::TimeDelta timestamp,
+                                        base::TimeDelta duration);
+
+  // Drops the pool's references to all frames.
+  void Clear();
+
+  // Number of frames held by the pool, whether in use or not.
+  size_t size() const { return frames_.size(); }
+
+ private:
+  typedef std::vector<scoped_refptr<VideoFrame> > FrameList;
+
+  const size_t max_frames_;
+  FrameList frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoFramePool);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_BASE_VIDEO_FRAME_POOL_H_
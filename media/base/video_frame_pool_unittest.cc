@@ -0,0 +1,71 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static scoped_refptr<VideoFrame> CreateFrame(VideoFramePool* pool,
+                                             size_t width,
+                                             int64 timestamp_ms) {
+  return pool->CreateFrame(VideoFrame::YV12, width, 240,
+                           base::TimeDelta::FromMilliseconds(timestamp_ms),
+                           base::TimeDelta::FromMilliseconds(33));
+}
+
+TEST(VideoFramePoolTest, ReusesReleasedFrames) {
+  VideoFramePool pool(2);
+
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, 320, 0);
+  VideoFrame* first = frame.get();
+
+  // Still in use, so a second frame must be allocated.
+  scoped_refptr<VideoFrame> second = CreateFrame(&pool, 320, 33);
+  EXPECT_NE(first, second.get());
+  EXPECT_EQ(2u, pool.size());
+
+  frame = NULL;
+  frame = CreateFrame(&pool, 320, 66);
+  EXPECT_EQ(first, frame.get());
+  EXPECT_EQ(66, frame->GetTimestamp().InMilliseconds());
+  EXPECT_EQ(2u, pool.size());
+}
+
+TEST(VideoFramePoolTest, AllocatesPastLimit) {
+  VideoFramePool pool(1);
+
+  scoped_refptr<VideoFrame> first = CreateFrame(&pool, 320, 0);
+  scoped_refptr<VideoFrame> second = CreateFrame(&pool, 320, 33);
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(1u, pool.size());
+
+  // |second| isn't pooled, so releasing it frees nothing for reuse.
+  second = NULL;
+  scoped_refptr<VideoFrame> third = CreateFrame(&pool, 320, 66);
+  EXPECT_NE(first.get(), third.get());
+}
+
+TEST(VideoFramePoolTest, DropsFramesOfOtherSizes) {
+  VideoFramePool pool(1);
+
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, 320, 0);
+  frame = NULL;
+
+  frame = CreateFrame(&pool, 640, 33);
+  EXPECT_EQ(640u, frame->width());
+  EXPECT_EQ(1u, pool.size());
+
+  // The new size took the old frame's place in the pool.
+  VideoFrame* pooled = frame.get();
+  frame = NULL;
+  frame = CreateFrame(&pool, 640, 66);
+  EXPECT_EQ(pooled, frame.get());
+
+  pool.Clear();
+  EXPECT_EQ(0u, pool.size());
+}
+
+}  // namespace media
@@ -41,6 +41,8 @@ static FilterYUVRowsProc ChooseFilterYUVRowsProc() {
     return &FilterYUVRows_SSE2;
   if (hasMMX())
     return &FilterYUVRows_MMX;
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+  return &FilterYUVRows_NEON;
 #endif
   return &FilterYUVRows_C;
 }
@@ -0,0 +1,154 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "build/build_config.h"
+#include "media/base/cpu_features.h"
+#include "media/base/simd/filter_yuv.h"
+#include "media/base/yuv_convert.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+// A 720p YV12 frame.
+const int kSourceWidth = 1280;
+const int kSourceHeight = 720;
+const int kSourceYSize = kSourceWidth * kSourceHeight;
+const int kSourceUVSize = kSourceYSize / 4;
+const int kBpp = 4;
+
+// Frames converted per measurement.
+const int kPerfTestIterations = 100;
+
+struct ScaleSize {
+  const char* name;
+  int width;
+  int height;
+};
+
+// Upscaling to full HD and downscaling to a video wall tile.
+const ScaleSize kScaleSizes[] = {
+  { "up", 1920, 1080 },
+  { "down", 480, 270 },
+};
+
+struct FilterMode {
+  const char* name;
+  ScaleFilter filter;
+};
+
+const FilterMode kFilterModes[] = {
+  { "none", FILTER_NONE },
+  { "bilinear_h", FILTER_BILINEAR_H },
+  { "bilinear_v", FILTER_BILINEAR_V },
+  { "bilinear", FILTER_BILINEAR },
+};
+
+class YUVConvertPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    // A gradient keeps the bilinear paths from seeing constant rows.
+    yuv_bytes_.reset(new uint8[kSourceYSize + 2 * kSourceUVSize]);
+    for (int i = 0; i < kSourceYSize + 2 * kSourceUVSize; ++i)
+      yuv_bytes_[i] = static_cast<uint8>(i * 7);
+    rgb_bytes_.reset(new uint8[1920 * 1080 * kBpp]);
+  }
+
+  uint8* y_plane() { return yuv_bytes_.get(); }
+  uint8* u_plane() { return yuv_bytes_.get() + kSourceYSize; }
+  uint8* v_plane() { return yuv_bytes_.get() + kSourceYSize + kSourceUVSize; }
+
+  scoped_array<uint8> yuv_bytes_;
+  scoped_array<uint8> rgb_bytes_;
+};
+
+}  // namespace
+
+TEST_F(YUVConvertPerfTest, ConvertYUVToRGB32) {
+  PerfTimeLogger timer("YUV_convert_yv12_720p");
+  for (int i = 0; i < kPerfTestIterations; ++i) {
+    ConvertYUVToRGB32(y_plane(), u_plane(), v_plane(), rgb_bytes_.get(),
+                      kSourceWidth, kSourceHeight,
+                      kSourceWidth, kSourceWidth / 2, kSourceWidth * kBpp,
+                      YV12);
+  }
+  timer.Done();
+}
+
+// Times every filter mode at every output size, since each combination
+// takes a different set of row procs.
+TEST_F(YUVConvertPerfTest, ScaleYUVToRGB32) {
+  for (size_t s = 0; s < arraysize(kScaleSizes); ++s) {
+    for (size_t f = 0; f < arraysize(kFilterModes); ++f) {
+      const ScaleSize& size = kScaleSizes[s];
+      std::string name = base::StringPrintf("YUV_scale_%s_%s",
+                                            size.name, kFilterModes[f].name);
+      PerfTimeLogger timer(name.c_str());
+      for (int i = 0; i < kPerfTestIterations; ++i) {
+        ScaleYUVToRGB32(y_plane(), u_plane(), v_plane(), rgb_bytes_.get(),
+                        kSourceWidth, kSourceHeight, size.width, size.height,
+                        kSourceWidth, kSourceWidth / 2, size.width * kBpp,
+                        YV12, ROTATE_0, kFilterModes[f].filter);
+      }
+      timer.Done();
+    }
+  }
+}
+
+TEST_F(YUVConvertPerfTest, ScaleYUVToRGB32WithRect) {
+  const ScaleSize& size = kScaleSizes[1];
+  PerfTimeLogger timer("YUV_scale_with_rect_down");
+  for (int i = 0; i < kPerfTestIterations; ++i) {
+    ScaleYUVToRGB32WithRect(y_plane(), u_plane(), v_plane(), rgb_bytes_.get(),
+                            kSourceWidth, kSourceHeight,
+                            size.width, size.height,
+                            0, 0, size.width, size.height,
+                            kSourceWidth, kSourceWidth / 2,
+                            size.width * kBpp);
+  }
+  timer.Done();
+}
+
+// Times each vertical filter kernel the CPU supports over a full frame of
+// rows.
+TEST_F(YUVConvertPerfTest, FilterYUVRows) {
+  struct {
+    const char* name;
+    FilterYUVRowsProc proc;
+    bool supported;
+  } const kKernels[] = {
+    { "c", &FilterYUVRows_C, true },
+#if defined(ARCH_CPU_X86_FAMILY)
+    { "mmx", &FilterYUVRows_MMX, hasMMX() },
+    { "sse2", &FilterYUVRows_SSE2, hasSSE2() },
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+    { "neon", &FilterYUVRows_NEON, true },
+#endif
+  };
+
+  for (size_t k = 0; k < arraysize(kKernels); ++k) {
+    if (!kKernels[k].supported)
+      continue;
+    std::string name =
+        base::StringPrintf("YUV_filter_rows_%s", kKernels[k].name);
+    PerfTimeLogger timer(name.c_str());
+    for (int i = 0; i < kPerfTestIterations; ++i) {
+      for (int row = 0; row < kSourceHeight - 1; ++row) {
+        const uint8* src0 = y_plane() + row * kSourceWidth;
+        kKernels[k].proc(rgb_bytes_.get(), src0, src0 + kSourceWidth,
+                         kSourceWidth, 96);
+      }
+    }
+    EmptyRegisterState();
+    timer.Done();
+  }
+}
+
+}  // namespace media
@@ -836,6 +836,38 @@ TEST(YUVConvertTest, FilterYUVRows_SSE2_UnalignedDestination) {
   EXPECT_EQ(0, memcmp(dst_sample.get(), dst_ptr, 37));
 }
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+
+TEST(YUVConvertTest, FilterYUVRows_NEON_MatchReference) {
+  const int kSize = 64;
+  const int kWidth = 37;
+  scoped_array<uint8> src0(new uint8[kSize]);
+  scoped_array<uint8> src1(new uint8[kSize]);
+  scoped_array<uint8> dst_sample(new uint8[kSize]);
+  scoped_array<uint8> dst(new uint8[kSize]);
+
+  for (int i = 0; i < kSize; ++i) {
+    src0[i] = 100 + i;
+    src1[i] = 255 - i * 3;
+  }
+
+  const int kFractions[] = { 0, 1, 128, 255 };
+  for (size_t i = 0; i < arraysize(kFractions); ++i) {
+    memset(dst_sample.get(), 0, kSize);
+    memset(dst.get(), 0, kSize);
+    media::FilterYUVRows_C(dst_sample.get(), src0.get(), src1.get(),
+                           kWidth, kFractions[i]);
+    media::FilterYUVRows_NEON(dst.get(), src0.get(), src1.get(),
+                              kWidth, kFractions[i]);
+
+    // Compare past |kWidth| too, to catch out of bounds writes.
+    EXPECT_EQ(0, memcmp(dst_sample.get(), dst.get(), kSize))
+        << "fraction " << kFractions[i];
+  }
+}
+
+#endif  // defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+
 #if defined(ARCH_CPU_X86_64)
 
 TEST(YUVConvertTest, ScaleYUVToRGB32Row_SSE2_X64) {
@@ -9,7 +9,9 @@
 
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time.h"
 #include "media/base/video_decoder.h"
+#include "media/base/video_frame_pool.h"
 #include "media/crypto/aes_decryptor.h"
 
 class MessageLoop;
@@ -62,6 +64,9 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // and resets them to NULL.
   void ReleaseFFmpegResources();
 
+  // Records how long one avcodec_decode_video2() call took, per codec.
+  void RecordDecodeTime(base::TimeDelta decode_time);
+
   // Reset decoder and call |reset_cb_|.
   void DoReset();
 
@@ -93,6 +98,9 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // on information provided by VideoDecoders (i.e., aspect ratio).
   gfx::Size natural_size_;
 
+  // Recycles the frames decoded pictures are copied into.
+  VideoFramePool frame_pool_;
+
   // Pointer to the demuxer stream that will feed us compressed buffers.
   scoped_refptr<DemuxerStream> demuxer_stream_;
 
@@ -223,14 +223,25 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
   if (state_ == kError)
     return false;
 
-  byte_queue_.Push(buf, size);
-
   int result = 0;
   int bytes_parsed = 0;
   const uint8* cur = NULL;
   int cur_size = 0;
 
+  // When nothing is left over from an earlier call, parse straight out of
+  // |buf| and queue only the unparsed tail. Segments usually arrive whole, so
+  // this avoids copying most appended bytes into |byte_queue_|. The parsers
+  // copy whatever they keep, so |buf| isn't referenced after we return.
   byte_queue_.Peek(&cur, &cur_size);
+  bool parse_in_place = (cur_size == 0);
+  if (parse_in_place) {
+    cur = buf;
+    cur_size = size;
+  } else {
+    byte_queue_.Push(buf, size);
+    byte_queue_.Peek(&cur, &cur_size);
+  }
+
   do {
     switch (state_) {
       case kParsingHeaders:
@@ -256,7 +267,10 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
     bytes_parsed += result;
   } while (result > 0 && cur_size > 0);
 
-  byte_queue_.Pop(bytes_parsed);
+  if (!parse_in_place)
+    byte_queue_.Pop(bytes_parsed);
+  else if (cur_size > 0)
+    byte_queue_.Push(cur, cur_size);
   return true;
 }
 
@@ -396,7 +396,26 @@ void Filter::InitBuffer(int buffer_size) {
   stream_buffer_size_ = buffer_size;
 }
 
+bool Filter::IsPassThrough() const {
+  return false;
+}
+
 void Filter::PushDataIntoNextFilter() {
+  // A whole buffer of data that passes through unchanged trades places with
+  // the empty buffer of the next filter.
+  if (IsPassThrough() && stream_data_len_ > 0 &&
+      next_stream_data_ == stream_buffer_->data() &&
+      !next_filter_->stream_data_len_ &&
+      next_filter_->stream_buffer_size_ == stream_buffer_size_) {
+    int len = stream_data_len_;
+    next_stream_data_ = NULL;
+    stream_data_len_ = 0;
+    stream_buffer_.swap(next_filter_->stream_buffer_);
+    last_status_ = FILTER_NEED_MORE_DATA;
+    next_filter_->FlushStreamBuffer(len);
+    return;
+  }
+
   IOBuffer* next_buffer = next_filter_->stream_buffer();
   int next_size = next_filter_->stream_buffer_size();
   last_status_ = ReadFilteredData(next_buffer->data(), &next_size);
@@ -0,0 +1,140 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/filter.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if defined(USE_SYSTEM_ZLIB)
+#include <zlib.h>
+#else
+#include "third_party/zlib/zlib.h"
+#endif
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "googleurl/src/gurl.h"
+#include "net/base/io_buffer.h"
+#include "net/base/mock_filter_context.h"
+#include "net/base/sdch_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A large text body, read from the network in 32KB pieces.
+const int kContentSize = 8 * 1024 * 1024;
+const int kReadSize = 32 * 1024;
+const int kNumIterations = 5;
+
+std::string BuildContent() {
+  std::string content;
+  content.reserve(kContentSize);
+  uint32 state = 1;
+  while (content.size() < static_cast<size_t>(kContentSize)) {
+    state = state * 1103515245 + 12345;
+    content.append("<div class=\"item\">");
+    content.append(static_cast<size_t>((state >> 16) % 40), 'a' + state % 26);
+    content.append("</div>\n");
+  }
+  content.resize(kContentSize);
+  return content;
+}
+
+// Returns |input| with a gzip header and footer.
+std::string GZipCompress(const std::string& input) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  CHECK_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                              MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY));
+  std::string output(deflateBound(&stream, input.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+  stream.avail_out = output.size();
+  CHECK_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+  return output;
+}
+
+class FilterPerfTest : public testing::Test {
+ protected:
+  FilterPerfTest()
+      : content_(BuildContent()),
+        compressed_(GZipCompress(content_)),
+        sdch_manager_(new SdchManager) {
+    filter_context_.SetResponseCode(200);
+    filter_context_.SetURL(GURL("http://www.example.com/"));
+  }
+
+  // Runs the compressed content through a chain of |filter_types| the way
+  // URLRequestJob does, and returns the number of bytes that came out.
+  int FilterContent(const std::vector<Filter::FilterType>& filter_types) {
+    scoped_ptr<Filter> filter(Filter::Factory(filter_types, filter_context_));
+    CHECK(filter.get());
+    scoped_refptr<IOBuffer> output(new IOBuffer(kReadSize));
+    size_t offset = 0;
+    int total = 0;
+    Filter::FilterStatus status = Filter::FILTER_NEED_MORE_DATA;
+    while (status != Filter::FILTER_ERROR) {
+      if (status == Filter::FILTER_NEED_MORE_DATA) {
+        if (offset == compressed_.size())
+          break;
+        int len = static_cast<int>(std::min<size_t>(
+            std::min(kReadSize, filter->stream_buffer_size()),
+            compressed_.size() - offset));
+        memcpy(filter->stream_buffer()->data(), compressed_.data() + offset,
+               len);
+        filter->FlushStreamBuffer(len);
+        offset += len;
+      }
+      int output_len = kReadSize;
+      status = filter->ReadData(output->data(), &output_len);
+      total += output_len;
+      if (status == Filter::FILTER_OK && !output_len)
+        break;
+    }
+    return total;
+  }
+
+  const std::string content_;
+  const std::string compressed_;
+  scoped_ptr<SdchManager> sdch_manager_;
+  MockFilterContext filter_context_;
+};
+
+}  // namespace
+
+TEST_F(FilterPerfTest, GZip) {
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP);
+
+  PerfTimeLogger timer("Filter_GZip");
+  for (int i = 0; i < kNumIterations; ++i)
+    EXPECT_EQ(kContentSize, FilterContent(filter_types));
+  timer.Done();
+}
+
+// Content that was tagged sdch,gzip but is only gzipped: the sdch filter
+// passes its input through to the gzip filter.
+TEST_F(FilterPerfTest, SdchPassThroughGZip) {
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP);
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH);
+
+  PerfTimeLogger timer("Filter_SdchPassThrough_GZip");
+  for (int i = 0; i < kNumIterations; ++i)
+    EXPECT_EQ(kContentSize, FilterContent(filter_types));
+  timer.Done();
+}
+
+}  // namespace net
@@ -151,6 +151,12 @@ Filter::FilterStatus GZipFilter::ReadFilteredData(char* dest_buffer,
   return status;
 }
 
+bool GZipFilter::IsPassThrough() const {
+  return decoding_status_ == DECODING_DONE &&
+         (GZIP_GET_INVALID_HEADER == gzip_header_status_ ||
+          gzip_footer_bytes_ == kGZipFooterSize);
+}
+
 Filter::FilterStatus GZipFilter::CheckGZipHeader() {
   DCHECK_EQ(gzip_header_status_, GZIP_CHECK_HEADER_IN_PROGRESS);
 
@@ -4,16 +4,37 @@
 
 #include "net/base/host_cache.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/base/sys_addrinfo.h"
 
 namespace net {
 
+namespace {
+
+// Restored entries are usable at least this long.
+const int kMinStaleEntryTTLSeconds = 60;
+
+const char kHostnameKey[] = "hostname";
+const char kAddressFamilyKey[] = "address_family";
+const char kFlagsKey[] = "flags";
+const char kAddressesKey[] = "addresses";
+const char kTTLKey[] = "ttl";
+const char kStaleKey[] = "stale";
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist)
     : error(error),
-      addrlist(addrlist) {
+      addrlist(addrlist),
+      hit_count(0),
+      stale(false) {
 }
 
 HostCache::Entry::~Entry() {
@@ -34,7 +55,10 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   if (caching_is_disabled())
     return NULL;
 
-  return entries_.Get(key, now);
+  const Entry* entry = entries_.Get(key, now);
+  if (entry)
+    entry->hit_count++;
+  return entry;
 }
 
 void HostCache::Set(const Key& key,
@@ -46,7 +70,10 @@ void HostCache::Set(const Key& key,
   if (caching_is_disabled())
     return;
 
-  entries_.Put(key, Entry(error, addrlist), now, ttl);
+  Entry entry(error, addrlist);
+  entry.ttl = ttl;
+  entry.expiration = now + ttl;
+  entries_.Put(key, entry, now, ttl);
 }
 
 void HostCache::clear() {
@@ -54,6 +81,91 @@ void HostCache::clear() {
   entries_.Clear();
 }
 
+void HostCache::GetAsListValue(base::TimeTicks now,
+                               base::ListValue* list) const {
+  DCHECK(CalledOnValidThread());
+  DCHECK(list);
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Entry& entry = it.value();
+    if (entry.error != OK || !entry.addrlist.head())
+      continue;
+
+    base::ListValue* addresses = new base::ListValue();
+    for (const struct addrinfo* ai = entry.addrlist.head(); ai;
+         ai = ai->ai_next) {
+      addresses->Append(base::Value::CreateStringValue(NetAddressToString(ai)));
+    }
+
+    base::DictionaryValue* dict = new base::DictionaryValue();
+    dict->SetString(kHostnameKey, it.key().hostname);
+    dict->SetInteger(kAddressFamilyKey, it.key().address_family);
+    dict->SetInteger(kFlagsKey, it.key().host_resolver_flags);
+    dict->Set(kAddressesKey, addresses);
+    dict->SetInteger(kTTLKey,
+                     static_cast<int>((it.expiration() - now).InSeconds()));
+    dict->SetBoolean(kStaleKey, entry.stale || it.expiration() <= now);
+    list->Append(dict);
+  }
+}
+
+bool HostCache::RestoreFromListValue(const base::ListValue& list,
+                                     base::TimeTicks now) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return true;
+
+  for (size_t i = 0; i < list.GetSize(); ++i) {
+    base::DictionaryValue* dict;
+    std::string hostname;
+    int address_family;
+    int flags;
+    base::ListValue* addresses;
+    int ttl_seconds;
+    if (!list.GetDictionary(i, &dict) ||
+        !dict->GetString(kHostnameKey, &hostname) ||
+        !dict->GetInteger(kAddressFamilyKey, &address_family) ||
+        address_family < ADDRESS_FAMILY_UNSPECIFIED ||
+        address_family > ADDRESS_FAMILY_IPV6 ||
+        !dict->GetInteger(kFlagsKey, &flags) ||
+        !dict->GetList(kAddressesKey, &addresses) ||
+        !dict->GetInteger(kTTLKey, &ttl_seconds)) {
+      return false;
+    }
+
+    IPAddressList ip_addresses;
+    for (size_t j = 0; j < addresses->GetSize(); ++j) {
+      std::string address;
+      IPAddressNumber ip;
+      if (!addresses->GetString(j, &address) ||
+          !ParseIPLiteralToNumber(address, &ip)) {
+        return false;
+      }
+      ip_addresses.push_back(ip);
+    }
+    if (ip_addresses.empty())
+      continue;
+
+    // Entries that were already stale only get the minimum TTL.
+    bool stale = false;
+    if (dict->GetBoolean(kStaleKey, &stale) && stale)
+      ttl_seconds = 0;
+
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    if (entries_.Get(key, now))
+      continue;  // The entry of this session is fresher.
+
+    base::TimeDelta ttl = base::TimeDelta::FromSeconds(
+        std::max(ttl_seconds, kMinStaleEntryTTLSeconds));
+    Entry entry(OK, AddressList::CreateFromIPAddressList(ip_addresses,
+                                                         std::string()));
+    entry.ttl = ttl;
+    entry.expiration = now + ttl;
+    entry.stale = true;
+    entries_.Put(key, entry, now, ttl);
+  }
+  return true;
+}
+
 size_t HostCache::size() const {
   DCHECK(CalledOnValidThread());
   return entries_.size();
@@ -16,6 +16,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -29,6 +33,17 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
     // The resolve results for this entry.
     int error;
     AddressList addrlist;
+
+    // The "time to live" of the results, and when they expire.
+    base::TimeDelta ttl;
+    base::TimeTicks expiration;
+
+    // Number of lookups served by this entry. Updated by Lookup().
+    mutable int hit_count;
+
+    // True if the entry was restored from a previous session. It stays usable
+    // until the resolver refreshes it.
+    bool stale;
   };
 
   struct Key {
@@ -62,7 +77,8 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   ~HostCache();
 
   // Returns a pointer to the entry for |key|, which is valid at time
-  // |now|. If there is no such entry, returns NULL.
+  // |now|, and counts the hit in the entry. If there is no such entry,
+  // returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
   // Overwrites or creates an entry for |key|.
@@ -77,6 +93,15 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // Empties the cache
   void clear();
 
+  // Appends the successful entries to |list|, with their remaining TTL at
+  // |now|, so that RestoreFromListValue() can load them in another session.
+  void GetAsListValue(base::TimeTicks now, base::ListValue* list) const;
+
+  // Adds the entries of |list| for keys that have no valid entry at |now|.
+  // The entries are stale, and usable for at least a minute so that the
+  // resolver can refresh them. Returns false if |list| is malformed.
+  bool RestoreFromListValue(const base::ListValue& list, base::TimeTicks now);
+
   // Returns the number of entries in the cache.
   size_t size() const;
 
@@ -8,7 +8,9 @@
 #include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -85,6 +87,34 @@ TEST(HostCacheTest, Basic) {
 
 // Try caching entries for a failed resolve attempt -- since we set the TTL of
 // such entries to 0 it won't store, but it will kick out the previous result.
+// Lookups count the hits, and entries know their TTL.
+TEST(HostCacheTest, HitCount) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+
+  HostCache::Key key1 = Key("foobar.com");
+  cache.Set(key1, OK, AddressList(), now, kTTL);
+
+  const HostCache::Entry* entry = cache.Lookup(key1, now);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(1, entry->hit_count);
+  EXPECT_EQ(kTTL, entry->ttl);
+  EXPECT_EQ(now + kTTL, entry->expiration);
+
+  EXPECT_EQ(entry, cache.Lookup(key1, now));
+  EXPECT_EQ(2, entry->hit_count);
+
+  // Overwriting the entry resets the count.
+  cache.Set(key1, OK, AddressList(), now, kTTL);
+  entry = cache.Lookup(key1, now);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(1, entry->hit_count);
+}
+
 TEST(HostCacheTest, NoCacheNegative) {
   const base::TimeDelta kSuccessEntryTTL = base::TimeDelta::FromSeconds(10);
   const base::TimeDelta kFailureEntryTTL = base::TimeDelta::FromSeconds(0);
@@ -376,4 +406,44 @@ TEST(HostCacheTest, KeyComparators) {
   }
 }
 
+// Successful entries survive a snapshot, as stale entries.
+TEST(HostCacheTest, RestoreFromListValue) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(600);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+
+  IPAddressNumber ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &ip));
+  cache.Set(Key("foobar.com"), OK, AddressList::CreateFromIPAddress(ip, 80),
+            now, kTTL);
+  cache.Set(Key("failure.com"), ERR_NAME_NOT_RESOLVED, AddressList(), now,
+            kTTL);
+
+  base::ListValue list;
+  cache.GetAsListValue(now + base::TimeDelta::FromSeconds(100), &list);
+  EXPECT_EQ(1u, list.GetSize());
+
+  // Entries of the new session are not replaced.
+  HostCache restored(kMaxCacheEntries);
+  base::TimeTicks later = now + base::TimeDelta::FromDays(1);
+  restored.Set(Key("other.com"), OK, AddressList(), later, kTTL);
+  EXPECT_TRUE(restored.RestoreFromListValue(list, later));
+  EXPECT_EQ(2u, restored.size());
+
+  const HostCache::Entry* entry = restored.Lookup(Key("foobar.com"), later);
+  ASSERT_TRUE(entry);
+  EXPECT_TRUE(entry->stale);
+  EXPECT_EQ(OK, entry->error);
+  EXPECT_EQ(base::TimeDelta::FromSeconds(500), entry->ttl);
+  ASSERT_TRUE(entry->addrlist.head());
+  EXPECT_EQ("192.168.1.1", NetAddressToString(entry->addrlist.head()));
+  EXPECT_FALSE(restored.Lookup(Key("failure.com"), later));
+
+  // Malformed snapshots are rejected.
+  base::ListValue bad_list;
+  bad_list.Append(base::Value::CreateStringValue("foobar.com"));
+  EXPECT_FALSE(restored.RestoreFromListValue(bad_list, later));
+}
+
 }  // namespace net
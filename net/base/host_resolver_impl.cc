@@ -63,6 +63,12 @@ const unsigned kCacheEntryTTLSeconds = 60;
 // Default TTL for unsuccessful resolutions with ProcTask.
 const unsigned kNegativeCacheEntryTTLSeconds = 0;
 
+// A cache entry that served this many lookups is refreshed with the built-in
+// DNS client when a lookup hits it in the last |1 / kCacheRefreshFraction| of
+// its TTL, so that popular names do not expire.
+const int kMinCacheHitsForRefresh = 3;
+const int kCacheRefreshFraction = 10;
+
 // Maximum of 6 concurrent resolver threads (excluding retries).
 // Some routers (or resolvers) appear to start to provide host-not-found if
 // too many simultaneous resolutions are pending.  This number needs to be
@@ -1043,7 +1049,9 @@ class HostResolverImpl::IPv6ProbeJob
 
 //-----------------------------------------------------------------------------
 
-// Resolves the hostname using DnsTransaction.
+// Resolves the hostname using DnsTransaction. Unless |key| asks for a single
+// address family, the A and AAAA queries are sent in parallel and their
+// results merged.
 // TODO(szym): This could be moved to separate source file as well.
 class HostResolverImpl::DnsTask {
  public:
@@ -1055,27 +1063,41 @@ class HostResolverImpl::DnsTask {
           const Key& key,
           const Callback& callback,
           const BoundNetLog& job_net_log)
-      : callback_(callback), net_log_(job_net_log) {
+      : callback_(callback),
+        net_log_(job_net_log),
+        num_pending_transactions_(0),
+        net_error_(ERR_NAME_NOT_RESOLVED),
+        parse_result_(DnsResponse::DNS_SUCCESS) {
     DCHECK(factory);
     DCHECK(!callback.is_null());
 
-    // For now we treat ADDRESS_FAMILY_UNSPEC as if it was IPV4.
-    uint16 qtype = (key.address_family == ADDRESS_FAMILY_IPV6)
-                   ? dns_protocol::kTypeAAAA
-                   : dns_protocol::kTypeA;
-    // TODO(szym): Implement "happy eyeballs".
-    transaction_ = factory->CreateTransaction(
-        key.hostname,
-        qtype,
-        base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
-                   base::TimeTicks::Now()),
-        net_log_);
-    DCHECK(transaction_.get());
+    base::TimeTicks now = base::TimeTicks::Now();
+    if (key.address_family != ADDRESS_FAMILY_IPV4) {
+      transaction_aaaa_ = factory->CreateTransaction(
+          key.hostname,
+          dns_protocol::kTypeAAAA,
+          base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
+                     now),
+          net_log_);
+      DCHECK(transaction_aaaa_.get());
+    }
+    if (key.address_family != ADDRESS_FAMILY_IPV6) {
+      transaction_a_ = factory->CreateTransaction(
+          key.hostname,
+          dns_protocol::kTypeA,
+          base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
+                     now),
+          net_log_);
+      DCHECK(transaction_a_.get());
+    }
   }
 
+  // Returns ERR_IO_PENDING, or the net error if no transaction could start.
   int Start() {
     net_log_.BeginEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK, NULL);
-    return transaction_->Start();
+    StartTransaction(&transaction_aaaa_);
+    StartTransaction(&transaction_a_);
+    return num_pending_transactions_ ? ERR_IO_PENDING : net_error_;
   }
 
   void OnTransactionComplete(const base::TimeTicks& start_time,
@@ -1083,41 +1105,98 @@ class HostResolverImpl::DnsTask {
                              int net_error,
                              const DnsResponse* response) {
     DCHECK(transaction);
-    // Run |callback_| last since the owning Job will then delete this DnsTask.
-    DnsResponse::Result result = DnsResponse::DNS_SUCCESS;
+    DCHECK_GT(num_pending_transactions_, 0);
+    num_pending_transactions_--;
+
+    bool is_a = transaction->GetType() == dns_protocol::kTypeA;
     if (net_error == OK) {
       CHECK(response);
       DNS_HISTOGRAM("AsyncDNS.TransactionSuccess",
                     base::TimeTicks::Now() - start_time);
       AddressList addr_list;
       base::TimeDelta ttl;
-      result = response->ParseToAddressList(&addr_list, &ttl);
+      DnsResponse::Result result = response->ParseToAddressList(&addr_list,
+                                                                &ttl);
       UMA_HISTOGRAM_ENUMERATION("AsyncDNS.ParseToAddressList",
                                 result,
                                 DnsResponse::DNS_PARSE_RESULT_MAX);
       if (result == DnsResponse::DNS_SUCCESS) {
-        net_log_.EndEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
-                          new AddressListNetLogParam(addr_list));
-        callback_.Run(net_error, addr_list, ttl);
-        return;
+        if (!has_result() || ttl < ttl_)
+          ttl_ = ttl;
+        (is_a ? addr_list_a_ : addr_list_aaaa_) = addr_list;
+      } else {
+        OnTransactionFailed(is_a, ERR_DNS_MALFORMED_RESPONSE, result);
       }
-      net_error = ERR_DNS_MALFORMED_RESPONSE;
     } else {
       DNS_HISTOGRAM("AsyncDNS.TransactionFailure",
                     base::TimeTicks::Now() - start_time);
+      OnTransactionFailed(is_a, net_error, DnsResponse::DNS_SUCCESS);
+    }
+
+    if (num_pending_transactions_)
+      return;
+
+    // Run |callback_| last since the owning Job will then delete this DnsTask.
+    if (has_result()) {
+      // Prefer IPv6, as getaddrinfo does on hosts with IPv6 connectivity.
+      AddressList addr_list = addr_list_aaaa_.head() ? addr_list_aaaa_
+                                                     : addr_list_a_;
+      if (addr_list_aaaa_.head() && addr_list_a_.head())
+        addr_list.Append(addr_list_a_.head());
+      net_log_.EndEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
+                        new AddressListNetLogParam(addr_list));
+      callback_.Run(OK, addr_list, ttl_);
+      return;
     }
     net_log_.EndEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
-                      new DnsTaskFailedParams(net_error, result));
-    callback_.Run(net_error, AddressList(), base::TimeDelta());
+                      new DnsTaskFailedParams(net_error_, parse_result_));
+    callback_.Run(net_error_, AddressList(), base::TimeDelta());
   }
 
  private:
+  void StartTransaction(scoped_ptr<DnsTransaction>* transaction) {
+    if (!transaction->get())
+      return;
+    int rv = (*transaction)->Start();
+    if (rv == ERR_IO_PENDING) {
+      num_pending_transactions_++;
+    } else {
+      OnTransactionFailed((*transaction)->GetType() == dns_protocol::kTypeA,
+                          rv, DnsResponse::DNS_SUCCESS);
+    }
+  }
+
+  // Keeps the error to report if no transaction succeeds. The error of the A
+  // query wins, since a host without IPv6 addresses is common.
+  void OnTransactionFailed(bool is_a, int net_error,
+                           DnsResponse::Result parse_result) {
+    if (is_a || !transaction_a_.get()) {
+      net_error_ = net_error;
+      parse_result_ = parse_result;
+    }
+  }
+
+  bool has_result() const {
+    return addr_list_a_.head() || addr_list_aaaa_.head();
+  }
+
   // The listener to the results of this DnsTask.
   Callback callback_;
 
   const BoundNetLog net_log_;
 
-  scoped_ptr<DnsTransaction> transaction_;
+  scoped_ptr<DnsTransaction> transaction_a_;
+  scoped_ptr<DnsTransaction> transaction_aaaa_;
+  int num_pending_transactions_;
+
+  // Results of the successful transactions, and the lowest of their TTLs.
+  AddressList addr_list_a_;
+  AddressList addr_list_aaaa_;
+  base::TimeDelta ttl_;
+
+  // Failure to report if no transaction succeeds.
+  int net_error_;
+  DnsResponse::Result parse_result_;
 };
 
 //-----------------------------------------------------------------------------
@@ -1126,12 +1205,15 @@ class HostResolverImpl::DnsTask {
 class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
  public:
   // Creates new job for |key| where |request_net_log| is bound to the
-  // request that spawned it.
+  // request that spawned it. A job with |is_refresh| updates the cache entry
+  // of |key| even if it has no requests.
   Job(HostResolverImpl* resolver,
       const Key& key,
+      bool is_refresh,
       const BoundNetLog& request_net_log)
       : resolver_(resolver->AsWeakPtr()),
         key_(key),
+        is_refresh_(is_refresh),
         had_non_speculative_request_(false),
         had_dns_config_(false),
         net_log_(BoundNetLog::Make(request_net_log.net_log(),
@@ -1227,7 +1309,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
         make_scoped_refptr(new JobAttachParameters(
             req->request_net_log().source(), priority())));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_refresh_) {
       if (is_queued())
         handle_ = resolver_->dispatcher_.ChangePriority(handle_, priority());
     } else {
@@ -1263,7 +1345,10 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
-    DCHECK_GT(num_active_requests(), 0u);
+    if (requests_.empty()) {
+      DCHECK(is_refresh_);
+      return false;
+    }
     AddressList addr_list;
     if (resolver_->ServeFromHosts(key(),
                                   requests_->front()->info(),
@@ -1415,7 +1500,10 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
       handle_.Reset();
     }
 
-    if (num_active_requests() == 0) {
+    bool did_complete = (net_error != ERR_ABORTED) &&
+                        (net_error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE);
+
+    if (num_active_requests() == 0 && !(is_refresh_ && did_complete)) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED, NULL);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1425,17 +1513,16 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                       net_error);
 
-    DCHECK(!requests_.empty());
+    DCHECK(!requests_.empty() || is_refresh_);
 
     // We are the only consumer of |list|, so we can safely change the port
     // without copy-on-write. This pays off, when job has only one request.
-    if (net_error == OK)
+    if (net_error == OK && !requests_.empty())
       MutableSetPort(requests_->front()->info().port(), &list);
 
-    if ((net_error != ERR_ABORTED) &&
-        (net_error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE)) {
+    // A refresh that nobody waits for keeps the entry it refreshes on failure.
+    if (did_complete && (net_error == OK || num_active_requests() > 0))
       resolver_->CacheResult(key_, net_error, list, ttl);
-    }
 
     // Complete all of the requests that were attached to the job.
     for (RequestsList::const_iterator it = requests_.begin();
@@ -1480,6 +1567,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
 
   Key key_;
 
+  // True if this job was started to refresh the cache entry of |key_|.
+  bool is_refresh_;
+
   // Tracks the highest priority across |requests_|.
   PriorityTracker priority_tracker_;
 
@@ -1531,7 +1621,10 @@ HostResolverImpl::HostResolverImpl(
       dns_config_service_(dns_config_service.Pass()),
       ipv6_probe_monitoring_(false),
       additional_resolver_flags_(0),
-      net_log_(net_log) {
+      net_log_(net_log),
+      ALLOW_THIS_IN_INITIALIZER_LIST(memory_pressure_listener_(
+          base::Bind(&HostResolverImpl::OnMemoryPressure,
+                     base::Unretained(this)))) {
 
   DCHECK_GE(dispatcher_.num_priorities(), static_cast<size_t>(NUM_PRIORITIES));
 
@@ -1614,7 +1707,7 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   Job* job;
   if (jobit == jobs_.end()) {
     // Create new Job.
-    job = new Job(this, key, request_net_log);
+    job = new Job(this, key, false, request_net_log);
     job->Schedule(info.priority());
 
     // Check for queue overflow.
@@ -1660,7 +1753,7 @@ int HostResolverImpl::ResolveHelper(const Key& key,
   int net_error = ERR_UNEXPECTED;
   if (ResolveAsIP(key, info, &net_error, addresses))
     return net_error;
-  if (ServeFromCache(key, info, &net_error, addresses)) {
+  if (ServeFromCache(key, info, &net_error, addresses, request_net_log)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT, NULL);
     return net_error;
   }
@@ -1768,23 +1861,52 @@ bool HostResolverImpl::ResolveAsIP(const Key& key,
 bool HostResolverImpl::ServeFromCache(const Key& key,
                                       const RequestInfo& info,
                                       int* net_error,
-                                      AddressList* addresses) {
+                                      AddressList* addresses,
+                                      const BoundNetLog& request_net_log) {
   DCHECK(addresses);
   DCHECK(net_error);
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
+  base::TimeTicks now = base::TimeTicks::Now();
+  const HostCache::Entry* cache_entry = cache_->Lookup(key, now);
   if (!cache_entry)
     return false;
 
   *net_error = cache_entry->error;
-  if (*net_error == OK)
+  if (*net_error == OK) {
     *addresses = CreateAddressListUsingPort(cache_entry->addrlist, info.port());
+    // Entries restored from a previous session are served while they are
+    // refreshed. Refreshing other entries is only cheap with the built-in DNS
+    // client.
+    if (cache_entry->stale ||
+        (HaveDnsConfig() &&
+         cache_entry->hit_count >= kMinCacheHitsForRefresh &&
+         cache_entry->expiration - now <
+             cache_entry->ttl / kCacheRefreshFraction)) {
+      RefreshCacheEntry(key, request_net_log);
+    }
+  }
   return true;
 }
 
+void HostResolverImpl::RefreshCacheEntry(const Key& key,
+                                         const BoundNetLog& request_net_log) {
+  // Refreshing should not delay the resolutions that are waiting for a slot.
+  if (dispatcher_.num_queued_jobs() > 0)
+    return;
+
+  JobMap::iterator jobit = jobs_.find(key);
+  if (jobit != jobs_.end())
+    return;
+
+  request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_REFRESH,
+                           NULL);
+  Job* job = new Job(this, key, true, request_net_log);
+  jobs_.insert(jobit, std::make_pair(key, job));
+  job->Schedule(IDLE);
+}
+
 bool HostResolverImpl::ServeFromHosts(const Key& key,
                                       const RequestInfo& info,
                                       AddressList* addresses) {
@@ -1946,6 +2068,16 @@ void HostResolverImpl::OnDNSChanged(unsigned detail) {
   // |this| may be deleted inside AbortAllInProgressJobs().
 }
 
+void HostResolverImpl::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  // Entries are cheap to refetch, but the cache is small, so only give it up
+  // when memory is critically low.
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL &&
+      cache_.get()) {
+    cache_->clear();
+  }
+}
+
 void HostResolverImpl::OnDnsConfigChanged(const DnsConfig& dns_config) {
   if (net_log_) {
     net_log_->AddGlobalEntry(
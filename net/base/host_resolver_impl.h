@@ -10,6 +10,7 @@
 
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
@@ -145,6 +146,10 @@ class NET_EXPORT HostResolverImpl
   virtual HostCache* GetHostCache() OVERRIDE;
   virtual base::Value* GetDnsConfigAsValue() const OVERRIDE;
 
+  void set_dns_client_for_tests(scoped_ptr<DnsClient> client) {
+    dns_client_ = client.Pass();
+  }
+
  private:
   friend class HostResolverImplTest;
   class Job;
@@ -156,10 +161,6 @@ class NET_EXPORT HostResolverImpl
   typedef std::map<Key, Job*> JobMap;
   typedef ScopedVector<Request> RequestsList;
 
-  void set_dns_client_for_tests(scoped_ptr<DnsClient> client) {
-    dns_client_ = client.Pass();
-  }
-
   // Helper used by |Resolve()| and |ResolveFromCache()|.  Performs IP
   // literal, cache and HOSTS lookup (if enabled), returns OK if successful,
   // ERR_NAME_NOT_RESOLVED if either hostname is invalid or IP literal is
@@ -178,11 +179,17 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry. Refreshes stale entries, and popular entries
+  // about to expire.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
-                      AddressList* addresses);
+                      AddressList* addresses,
+                      const BoundNetLog& request_net_log);
+
+  // Starts a Job without requests which updates the cache entry of |key|,
+  // unless one is already running or other Jobs are waiting.
+  void RefreshCacheEntry(const Key& key, const BoundNetLog& request_net_log);
 
   // If |key| is not found in the HOSTS file or no HOSTS file known, returns
   // false, otherwise returns true and fills |addresses|.
@@ -226,6 +233,10 @@ class NET_EXPORT HostResolverImpl
   // DnsConfigService callback:
   void OnDnsConfigChanged(const DnsConfig& dns_config);
 
+  // MemoryPressureListener callback:
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   // True if have fully configured DNS client.
   bool HaveDnsConfig() const;
   // Allows the tests to catch slots leaking out of the dispatcher.
@@ -268,6 +279,8 @@ class NET_EXPORT HostResolverImpl
 
   NetLog* net_log_;
 
+  base::MemoryPressureListener memory_pressure_listener_;
+
   DISALLOW_COPY_AND_ASSIGN(HostResolverImpl);
 };
 
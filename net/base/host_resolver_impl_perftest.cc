@@ -0,0 +1,128 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/host_resolver_impl.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "net/base/address_list.h"
+#include "net/base/host_cache.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/mock_host_resolver.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/base/net_util.h"
+#include "net/dns/dns_client.h"
+#include "net/dns/dns_config_service.h"
+#include "net/dns/dns_protocol.h"
+#include "net/dns/dns_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A browsing session: page loads which each resolve a burst of names, most
+// of them popular.
+const int kNumNames = 300;
+const int kNumPageLoads = 200;
+const int kNamesPerPageLoad = 20;
+
+// Returns the names looked up by each page load of the session. The trace is
+// deterministic, and the popularity of the names is roughly Zipf-like.
+std::vector<std::vector<std::string> > BuildTrace() {
+  std::vector<std::vector<std::string> > trace(kNumPageLoads);
+  uint32 state = 1;
+  for (int i = 0; i < kNumPageLoads; ++i) {
+    for (int j = 0; j < kNamesPerPageLoad; ++j) {
+      state = state * 1103515245 + 12345;
+      int rank = static_cast<int>((state >> 16) % kNumNames) + 1;
+      // Names starting with "ok" are answered by the mock DnsClient.
+      trace[i].push_back(base::StringPrintf("ok%d.example.com",
+                                            kNumNames / rank));
+    }
+  }
+  return trace;
+}
+
+class HostResolverImplPerfTest : public testing::Test {
+ protected:
+  HostResolverImplPerfTest()
+      : proc_(new RuleBasedHostResolverProc(NULL)),
+        num_pending_(0) {
+    proc_->AddRule("*", "127.0.0.1");
+    resolver_.reset(new HostResolverImpl(
+        HostCache::CreateDefaultCache(),
+        PrioritizedDispatcher::Limits(NUM_PRIORITIES, 6),
+        HostResolverImpl::ProcTaskParams(proc_, 1),
+        scoped_ptr<DnsConfigService>(NULL),
+        NULL));
+  }
+
+  void UseDnsClient() {
+    IPAddressNumber dns_ip;
+    ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.0", &dns_ip));
+    DnsConfig config;
+    config.nameservers.push_back(IPEndPoint(dns_ip,
+                                            dns_protocol::kDefaultPort));
+    resolver_->set_dns_client_for_tests(CreateMockDnsClient(config));
+  }
+
+  // Resolves the names of each page load, waiting for a page load to
+  // complete before starting the next one.
+  void Replay(const char* name) {
+    std::vector<std::vector<std::string> > trace = BuildTrace();
+
+    PerfTimeLogger timer(name);
+    for (size_t i = 0; i < trace.size(); ++i) {
+      std::vector<AddressList> addresses(trace[i].size());
+      for (size_t j = 0; j < trace[i].size(); ++j) {
+        HostResolver::RequestInfo info(HostPortPair(trace[i][j], 80));
+        int rv = resolver_->Resolve(
+            info, &addresses[j],
+            base::Bind(&HostResolverImplPerfTest::OnResolved,
+                       base::Unretained(this)),
+            NULL, BoundNetLog());
+        if (rv == ERR_IO_PENDING)
+          num_pending_++;
+        else
+          EXPECT_EQ(OK, rv);
+      }
+      if (num_pending_)
+        MessageLoop::current()->Run();
+    }
+    timer.Done();
+  }
+
+  void OnResolved(int result) {
+    EXPECT_EQ(OK, result);
+    if (!--num_pending_)
+      MessageLoop::current()->Quit();
+  }
+
+  MessageLoopForIO message_loop_;
+  scoped_refptr<RuleBasedHostResolverProc> proc_;
+  scoped_ptr<HostResolverImpl> resolver_;
+  int num_pending_;
+};
+
+TEST_F(HostResolverImplPerfTest, ReplayTraceWithDnsClient) {
+  UseDnsClient();
+  Replay("HostResolverImpl_ReplayTrace_DnsClient");
+}
+
+TEST_F(HostResolverImplPerfTest, ReplayTraceWithProc) {
+  Replay("HostResolverImpl_ReplayTrace_Proc");
+}
+
+}  // namespace
+
+}  // namespace net
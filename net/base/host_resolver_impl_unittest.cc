@@ -1293,8 +1293,10 @@ TEST_F(HostResolverImplTest, DnsTask) {
   }
 
   EXPECT_EQ(OK, requests_[1]->result());
-  // Resolved by MockDnsClient.
-  EXPECT_TRUE(requests_[1]->HasOneAddress("127.0.0.1", 80));
+  // Resolved by MockDnsClient, with parallel A and AAAA queries.
+  EXPECT_EQ(2u, requests_[1]->NumberOfAddresses());
+  EXPECT_TRUE(requests_[1]->HasAddress("127.0.0.1", 80));
+  EXPECT_TRUE(requests_[1]->HasAddress("::1", 80));
   EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[2]->result());
   EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[3]->result());
   EXPECT_EQ(OK, requests_[4]->result());
@@ -1303,6 +1305,55 @@ TEST_F(HostResolverImplTest, DnsTask) {
   EXPECT_TRUE(requests_[5]->HasOneAddress("192.168.1.102", 80));
 }
 
+// Requests for a single address family only send the matching query.
+TEST_F(HostResolverImplTest, DnsTaskAddressFamily) {
+  set_dns_client(CreateMockDnsClient(CreateValidDnsConfig()));
+
+  Request* req0 = CreateRequest("ok_ipv4", 80, MEDIUM, ADDRESS_FAMILY_IPV4);
+  Request* req1 = CreateRequest("ok_ipv6", 80, MEDIUM, ADDRESS_FAMILY_IPV6);
+  EXPECT_EQ(ERR_IO_PENDING, req0->Resolve());
+  EXPECT_EQ(ERR_IO_PENDING, req1->Resolve());
+
+  EXPECT_EQ(OK, req0->WaitForResult());
+  EXPECT_TRUE(req0->HasOneAddress("127.0.0.1", 80));
+  EXPECT_EQ(OK, req1->WaitForResult());
+  EXPECT_TRUE(req1->HasOneAddress("::1", 80));
+}
+
+// Popular cache entries are refreshed before they expire.
+TEST_F(HostResolverImplTest, RefreshPopularCacheEntry) {
+  set_dns_client(CreateMockDnsClient(CreateValidDnsConfig()));
+
+  Request* req0 = CreateRequest("ok_popular", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req0->Resolve());
+  EXPECT_EQ(OK, req0->WaitForResult());
+  EXPECT_EQ(2u, req0->NumberOfAddresses());
+
+  // Replace the entry with one that is about to expire.
+  HostCache* cache = resolver_->GetHostCache();
+  ASSERT_EQ(1u, cache->size());
+  HostCache::EntryMap::Iterator it(cache->entries());
+  HostCache::Key key = it.key();
+  IPAddressNumber ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &ip));
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(100);
+  cache->Set(key, OK, AddressList::CreateFromIPAddress(ip, 80),
+             base::TimeTicks::Now() - base::TimeDelta::FromSeconds(95), kTTL);
+
+  // The last of these hits starts a refresh.
+  for (int i = 0; i < 3; ++i) {
+    Request* req = CreateRequest("ok_popular", 80);
+    EXPECT_EQ(OK, req->Resolve());
+    EXPECT_TRUE(req->HasOneAddress("192.168.1.1", 80));
+  }
+  MessageLoop::current()->RunAllPending();
+
+  Request* req1 = CreateRequest("ok_popular", 80);
+  EXPECT_EQ(OK, req1->Resolve());
+  EXPECT_EQ(2u, req1->NumberOfAddresses());
+  EXPECT_TRUE(req1->HasAddress("127.0.0.1", 80));
+}
+
 TEST_F(HostResolverImplTest, ServeFromHosts) {
   // Initially, there's DnsConfigService, but no DnsConfig.
   MockDnsConfigService* config_service = new MockDnsConfigService();
@@ -4,6 +4,7 @@
 
 #include "net/base/multi_threaded_cert_verifier.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/bind.h"
@@ -71,15 +72,39 @@ namespace net {
 
 namespace {
 
-// The default value of max_cache_entries_.
-const unsigned kMaxCacheEntries = 256;
+// The default value of max_cache_entries_. Large enough to hold the chains
+// of every host a busy profile talks to, so that new connections to a host
+// don't rebuild and recheck its chain.
+const unsigned kMaxCacheEntries = 2048;
 
-// The number of seconds for which we'll cache a cache entry.
+// The number of seconds for which we'll cache a failed verification, or one
+// that did online revocation checking. NSS keeps its own OCSP and CRL caches,
+// but the validity of the responses it used isn't reported back to us.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// The number of seconds for which we'll cache a successful verification that
+// only relied on the CRLSet for revocation. Such entries are dropped as soon
+// as a newer CRLSet arrives.
+const unsigned kCRLSetOnlyTTLSecs = 4 * 3600;  // 4 hours.
+
+// The outcome of looking up a request in the cache, for UMA. Don't reorder.
+enum CacheLookupResult {
+  CACHE_LOOKUP_HIT = 0,
+  CACHE_LOOKUP_MISS = 1,
+  CACHE_LOOKUP_STALE_CRL_SET = 2,
+  CACHE_LOOKUP_MAX
+};
+
+uint32 GetCRLSetSequence(const CRLSet* crl_set) {
+  return crl_set ? crl_set->sequence() : 0;
+}
+
 }  // namespace
 
-MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
+MultiThreadedCertVerifier::CachedResult::CachedResult()
+    : error(ERR_FAILED),
+      crl_set_sequence(0) {
+}
 
 MultiThreadedCertVerifier::CachedResult::~CachedResult() {}
 
@@ -199,7 +224,8 @@ class CertVerifierWorker {
       base::AutoLock locked(lock_);
       if (!canceled_) {
         cert_verifier_->HandleResult(cert_, hostname_, flags_,
-                                     error_, verify_result_);
+                                     GetCRLSetSequence(crl_set_), error_,
+                                     verify_result_);
       }
     }
     delete this;
@@ -363,7 +389,15 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
                           hostname, flags);
   const CertVerifierCache::value_type* cached_entry =
       cache_.Get(key, base::TimeTicks::Now());
+  CacheLookupResult lookup_result = CACHE_LOOKUP_MISS;
   if (cached_entry) {
+    lookup_result =
+        cached_entry->crl_set_sequence == GetCRLSetSequence(crl_set) ?
+            CACHE_LOOKUP_HIT : CACHE_LOOKUP_STALE_CRL_SET;
+  }
+  UMA_HISTOGRAM_ENUMERATION("Net.CertVerifier_CacheLookup", lookup_result,
+                            CACHE_LOOKUP_MAX);
+  if (lookup_result == CACHE_LOOKUP_HIT) {
     ++cache_hits_;
     *out_req = NULL;
     *verify_result = cached_entry->result;
@@ -417,6 +451,7 @@ void MultiThreadedCertVerifier::HandleResult(
     X509Certificate* cert,
     const std::string& hostname,
     int flags,
+    uint32 crl_set_sequence,
     int error,
     const CertVerifyResult& verify_result) {
   DCHECK(CalledOnValidThread());
@@ -427,8 +462,9 @@ void MultiThreadedCertVerifier::HandleResult(
   CachedResult cached_result;
   cached_result.error = error;
   cached_result.result = verify_result;
+  cached_result.crl_set_sequence = crl_set_sequence;
   cache_.Put(key, cached_result, base::TimeTicks::Now(),
-             base::TimeDelta::FromSeconds(kTTLSecs));
+             GetCacheTTL(cert, flags, error, base::Time::Now()));
 
   std::map<RequestParams, CertVerifierJob*>::iterator j;
   j = inflight_.find(key);
@@ -443,6 +479,37 @@ void MultiThreadedCertVerifier::HandleResult(
   delete job;
 }
 
+// static
+base::TimeDelta MultiThreadedCertVerifier::GetCacheTTL(
+    const X509Certificate* cert,
+    int flags,
+    int error,
+    base::Time now) {
+  base::TimeDelta ttl = base::TimeDelta::FromSeconds(kTTLSecs);
+  if (error == OK && !(flags & X509Certificate::VERIFY_REV_CHECKING_ENABLED))
+    ttl = base::TimeDelta::FromSeconds(kCRLSetOnlyTTLSecs);
+
+  // The result changes once the certificate expires, so don't let the entry
+  // outlive it. Already expired certificates are cached as usual.
+  const base::Time& expiry = cert->valid_expiry();
+  if (!expiry.is_null() && expiry > now)
+    ttl = std::min(ttl, expiry - now);
+  return ttl;
+}
+
+void MultiThreadedCertVerifier::OnUserCertAdded(const X509Certificate* cert) {
+  DCHECK(CalledOnValidThread());
+
+  ClearCache();
+}
+
+void MultiThreadedCertVerifier::OnUserCertRemoved(
+    const X509Certificate* cert) {
+  DCHECK(CalledOnValidThread());
+
+  ClearCache();
+}
+
 void MultiThreadedCertVerifier::OnCertTrustChanged(
     const X509Certificate* cert) {
   DCHECK(CalledOnValidThread());
@@ -14,6 +14,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time.h"
 #include "net/base/cert_database.h"
 #include "net/base/cert_verifier.h"
 #include "net/base/cert_verify_result.h"
@@ -65,6 +66,10 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, CancelRequest);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
                            RequestParamsComparators);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
+                           CRLSetSequenceInvalidatesCache);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
+                           CertDatabaseChangeClearsCache);
 
   // Input parameters of a certificate verification request.
   struct RequestParams {
@@ -107,15 +112,28 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
 
     int error;  // The return value of CertVerifier::Verify.
     CertVerifyResult result;  // The output of CertVerifier::Verify.
+    // The sequence number of the CRLSet the result was computed against, or
+    // 0 if there was none. The result is stale once the CRLSet changes.
+    uint32 crl_set_sequence;
   };
 
   void HandleResult(X509Certificate* cert,
                     const std::string& hostname,
                     int flags,
+                    uint32 crl_set_sequence,
                     int error,
                     const CertVerifyResult& verify_result);
 
+  // Returns how long the result of verifying |cert| with |flags| may be
+  // cached, starting at |now|.
+  static base::TimeDelta GetCacheTTL(const X509Certificate* cert,
+                                     int flags,
+                                     int error,
+                                     base::Time now);
+
   // CertDatabase::Observer methods:
+  virtual void OnUserCertAdded(const X509Certificate* cert) OVERRIDE;
+  virtual void OnUserCertRemoved(const X509Certificate* cert) OVERRIDE;
   virtual void OnCertTrustChanged(const X509Certificate* cert) OVERRIDE;
 
   // For unit testing.
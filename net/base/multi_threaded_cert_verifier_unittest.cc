@@ -242,6 +242,71 @@ TEST_F(MultiThreadedCertVerifierTest, CancelRequestThenQuit) {
   // Destroy |verifier| by going out of scope.
 }
 
+// Tests that a cached result computed against one CRLSet isn't used once the
+// CRLSet changes.
+TEST_F(MultiThreadedCertVerifierTest, CRLSetSequenceInvalidatesCache) {
+  FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  // Pretend that an earlier verification ran against CRLSet sequence 1.
+  MultiThreadedCertVerifier::CachedResult cached_result;
+  cached_result.error = OK;
+  cached_result.crl_set_sequence = 1;
+  verifier_.cache_.Put(
+      MultiThreadedCertVerifier::RequestParams(test_cert->fingerprint(),
+                                               test_cert->ca_fingerprint(),
+                                               "www.example.com", 0),
+      cached_result, base::TimeTicks::Now(), base::TimeDelta::FromHours(1));
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+
+  int error;
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  // Without a CRLSet the entry is stale and the chain is verified again.
+  error = verifier_.Verify(test_cert, "www.example.com", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  error = callback.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(0u, verifier_.cache_hits());
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+
+  // The fresh result replaced the stale one.
+  error = verifier_.Verify(test_cert, "www.example.com", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_TRUE(request_handle == NULL);
+  ASSERT_EQ(1u, verifier_.cache_hits());
+}
+
+// Tests that changes to the certificate database drop all cached results.
+TEST_F(MultiThreadedCertVerifierTest, CertDatabaseChangeClearsCache) {
+  FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  int error = verifier_.Verify(test_cert, "www.example.com", 0, NULL,
+                               &verify_result, callback.callback(),
+                               &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  callback.WaitForResult();
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+
+  verifier_.OnUserCertAdded(test_cert);
+  EXPECT_EQ(0u, verifier_.GetCacheSize());
+}
+
 TEST_F(MultiThreadedCertVerifierTest, RequestParamsComparators) {
   SHA1Fingerprint a_key;
   memset(a_key.data, 'a', sizeof(a_key.data));
@@ -62,6 +62,10 @@ EVENT_TYPE(HOST_RESOLVER_IMPL_REQUEST)
 // This event is logged when a request is handled by a cache entry.
 EVENT_TYPE(HOST_RESOLVER_IMPL_CACHE_HIT)
 
+// This event is logged when a cache hit starts a Job to refresh the entry
+// before it expires.
+EVENT_TYPE(HOST_RESOLVER_IMPL_CACHE_REFRESH)
+
 // This event is logged when a request is handled by a HOSTS entry.
 EVENT_TYPE(HOST_RESOLVER_IMPL_HOSTS_HIT)
 
@@ -18,6 +18,7 @@
 #include <string>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/time.h"
 #include "net/base/filter.h"
 #include "net/base/net_export.h"
 #include "net/base/sdch_manager.h"
@@ -44,6 +45,9 @@ class NET_EXPORT_PRIVATE SdchFilter : public Filter {
   virtual FilterStatus ReadFilteredData(char* dest_buffer,
                                         int* dest_len) OVERRIDE;
 
+ protected:
+  virtual bool IsPassThrough() const OVERRIDE;
+
  private:
   // Internal status.  Once we enter an error state, we stop processing data.
   enum DecodingStatus {
@@ -107,6 +111,8 @@ class NET_EXPORT_PRIVATE SdchFilter : public Filter {
   // Visit about:histograms/Sdch to see histogram data.
   size_t source_bytes_;
   size_t output_bytes_;
+  // Time spent in the vcdiff decoder, reported to |dictionary_|.
+  base::TimeDelta decode_time_;
 
   // Error recovery in content type may add an sdch filter type, in which case
   // we should gracefully perform pass through if the format is incorrect, or
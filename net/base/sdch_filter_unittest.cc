@@ -16,6 +16,10 @@
 
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
+#include "base/scoped_temp_dir.h"
+#include "base/values.h"
 #include "net/base/filter.h"
 #include "net/base/io_buffer.h"
 #include "net/base/mock_filter_context.h"
@@ -443,6 +447,54 @@ TEST_F(SdchFilterTest, BasicDictionary) {
   EXPECT_EQ(output, expanded_);
 }
 
+// A dictionary persisted by one session is mapped back in by the next one,
+// without being fetched again, and decodes the same.
+TEST_F(SdchFilterTest, PersistedDictionary) {
+  MessageLoop message_loop;
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  const std::string kSampleDomain = "sdchtest.com";
+  std::string dictionary(NewSdchDictionary(kSampleDomain));
+  GURL url("http://" + kSampleDomain);
+
+  sdch_manager_->EnablePersistence(temp_dir.path(),
+                                   base::MessageLoopProxy::current());
+  message_loop.RunAllPending();
+  EXPECT_TRUE(sdch_manager_->AddSdchDictionary(dictionary, url));
+  message_loop.RunAllPending();
+
+  // Only one manager may exist at a time.
+  sdch_manager_.reset();
+  sdch_manager_.reset(new SdchManager);
+  sdch_manager_->EnablePersistence(temp_dir.path(),
+                                   base::MessageLoopProxy::current());
+  message_loop.RunAllPending();
+  EXPECT_FALSE(sdch_manager_->AddSdchDictionary(dictionary, url));
+
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH);
+  MockFilterContext filter_context;
+  filter_context.SetURL(url);
+  scoped_ptr<Filter> filter(Filter::Factory(filter_types, filter_context));
+  std::string output;
+  EXPECT_TRUE(FilterTestData(NewSdchCompressedData(dictionary), 100, 100,
+                             filter.get(), &output));
+  EXPECT_EQ(output, expanded_);
+  filter.reset();
+
+  scoped_ptr<base::ListValue> stats(sdch_manager_->GetDictionaryStats());
+  ASSERT_EQ(1U, stats->GetSize());
+  base::DictionaryValue* dictionary_stats;
+  ASSERT_TRUE(stats->GetDictionary(0, &dictionary_stats));
+  bool mapped = false;
+  EXPECT_TRUE(dictionary_stats->GetBoolean("mapped", &mapped));
+  EXPECT_TRUE(mapped);
+  int decode_count = 0;
+  EXPECT_TRUE(dictionary_stats->GetInteger("decode_count", &decode_count));
+  EXPECT_EQ(1, decode_count);
+}
+
 TEST_F(SdchFilterTest, NoDecodeHttps) {
   // Construct a valid SDCH dictionary from a VCDIFF dictionary.
   const std::string kSampleDomain = "sdchtest.com";
@@ -908,6 +960,46 @@ TEST_F(SdchFilterTest, FilterChaining) {
   EXPECT_EQ(output, expanded_);
 }
 
+// Test that a filter which passes its data through hands whole buffers on to
+// the next filter in the chain.
+TEST_F(SdchFilterTest, PassThroughChaining) {
+  // Content that compresses poorly, so that it spans many input buffers.
+  std::string content;
+  uint32 state = 1;
+  for (int i = 0; i < 4000; ++i) {
+    state = state * 1103515245 + 12345;
+    content.push_back('a' + (state >> 16) % 26);
+  }
+  std::string gzip_compressed(gzip_compress(content));
+
+  // The gzip content was tagged sdch,gzip but is only gzipped.
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP);
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH);
+
+  const size_t kInputBufferSize(100);
+  CHECK_LT(kInputBufferSize * 2, gzip_compressed.size());
+  MockFilterContext filter_context;
+  filter_context.SetResponseCode(200);
+  filter_context.SetURL(GURL("http://passthrough.com"));
+  scoped_ptr<Filter> filter(
+      SdchFilterChainingTest::Factory(filter_types, filter_context,
+                                      kInputBufferSize));
+
+  std::string output;
+  EXPECT_TRUE(FilterTestData(gzip_compressed, kInputBufferSize,
+                             kInputBufferSize, filter.get(), &output));
+  EXPECT_EQ(content, output);
+
+  // Partially consumed buffers are copied.
+  filter.reset(SdchFilterChainingTest::Factory(filter_types, filter_context,
+                                               kInputBufferSize));
+  output.clear();
+  EXPECT_TRUE(FilterTestData(gzip_compressed, kInputBufferSize, 7,
+                             filter.get(), &output));
+  EXPECT_EQ(content, output);
+}
+
 TEST_F(SdchFilterTest, DefaultGzipIfSdch) {
   // Construct a valid SDCH dictionary from a VCDIFF dictionary.
   const std::string kSampleDomain = "sdchtest.com";
@@ -5,10 +5,15 @@
 #include "net/base/sdch_manager.h"
 
 #include "base/base64.h"
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/file_util.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
+#include "base/task_runner.h"
+#include "base/values.h"
 #include "crypto/sha2.h"
 #include "net/base/registry_controlled_domain.h"
 #include "net/url_request/url_request_http_job.h"
@@ -28,6 +33,41 @@ SdchManager* SdchManager::global_ = NULL;
 // static
 bool SdchManager::g_sdch_enabled_ = true;
 
+namespace {
+
+// Length of the URL safe base64 encoding of a 48 bit hash.
+const size_t kHashLength = 8;
+
+// Extension of dictionary files that are still being written.
+const FilePath::CharType kTemporaryExtension[] = FILE_PATH_LITERAL("tmp");
+
+// Returns the next line of |text| from |*pos| on, and moves |*pos| past it.
+// Returns false if there is no complete line.
+bool ReadLine(const base::StringPiece& text, size_t* pos,
+              base::StringPiece* line) {
+  size_t line_end = text.find('\n', *pos);
+  if (base::StringPiece::npos == line_end)
+    return false;
+  *line = text.substr(*pos, line_end - *pos);
+  *pos = line_end + 1;
+  return true;
+}
+
+}  // namespace
+
+// A dictionary file mapped by LoadPersistedDictionaries().
+struct SdchManager::PersistedDictionary {
+  PersistedDictionary() : text_offset(0) {}
+
+  scoped_ptr<file_util::MemoryMappedFile> mapped_file;
+  // Where the dictionary, as it was fetched, starts in |mapped_file|.
+  size_t text_offset;
+  GURL url;
+  base::Time expiration;
+  std::string client_hash;
+  std::string server_hash;
+};
+
 //------------------------------------------------------------------------------
 SdchManager::Dictionary::Dictionary(const std::string& dictionary_text,
                                     size_t offset,
@@ -38,17 +78,60 @@ SdchManager::Dictionary::Dictionary(const std::string& dictionary_text,
                                     const base::Time& expiration,
                                     const std::set<int>& ports)
     : text_(dictionary_text, offset),
+      mapped_offset_(0),
       client_hash_(client_hash),
       url_(gurl),
       domain_(domain),
       path_(path),
       expiration_(expiration),
-      ports_(ports) {
+      ports_(ports),
+      decode_count_(0),
+      decode_bytes_in_(0),
+      decode_bytes_out_(0) {
+}
+
+SdchManager::Dictionary::Dictionary(file_util::MemoryMappedFile* mapped_file,
+                                    size_t offset,
+                                    const std::string& client_hash,
+                                    const GURL& gurl,
+                                    const std::string& domain,
+                                    const std::string& path,
+                                    const base::Time& expiration,
+                                    const std::set<int>& ports)
+    : mapped_file_(mapped_file),
+      mapped_offset_(offset),
+      client_hash_(client_hash),
+      url_(gurl),
+      domain_(domain),
+      path_(path),
+      expiration_(expiration),
+      ports_(ports),
+      decode_count_(0),
+      decode_bytes_in_(0),
+      decode_bytes_out_(0) {
+  DCHECK_LE(offset, mapped_file->length());
 }
 
 SdchManager::Dictionary::~Dictionary() {
 }
 
+base::StringPiece SdchManager::Dictionary::text() const {
+  if (!mapped_file_.get())
+    return text_;
+  // The pages of the file are only read in as the decoder touches them.
+  return base::StringPiece(
+      reinterpret_cast<const char*>(mapped_file_->data()) + mapped_offset_,
+      mapped_file_->length() - mapped_offset_);
+}
+
+void SdchManager::Dictionary::RecordDecode(size_t bytes_in, size_t bytes_out,
+                                           base::TimeDelta decode_time) {
+  ++decode_count_;
+  decode_bytes_in_ += bytes_in;
+  decode_bytes_out_ += bytes_out;
+  decode_time_ += decode_time;
+}
+
 bool SdchManager::Dictionary::CanAdvertise(const GURL& target_url) {
   if (!SdchManager::Global()->IsInSupportedDomain(target_url))
     return false;
@@ -204,7 +287,8 @@ bool SdchManager::Dictionary::DomainMatch(const GURL& gurl,
 }
 
 //------------------------------------------------------------------------------
-SdchManager::SdchManager() {
+SdchManager::SdchManager()
+    : ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
   DCHECK(!global_);
   DCHECK(CalledOnValidThread());
   global_ = this;
@@ -244,6 +328,22 @@ void SdchManager::set_sdch_fetcher(SdchFetcher* fetcher) {
   fetcher_.reset(fetcher);
 }
 
+void SdchManager::EnablePersistence(const FilePath& directory,
+                                    base::TaskRunner* file_task_runner) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!file_task_runner_);
+  persistence_directory_ = directory;
+  file_task_runner_ = file_task_runner;
+
+  PersistedDictionaryList* dictionaries = new PersistedDictionaryList;
+  file_task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&SdchManager::LoadPersistedDictionaries, directory,
+                 dictionaries),
+      base::Bind(&SdchManager::OnPersistedDictionariesLoaded,
+                 weak_factory_.GetWeakPtr(), base::Owned(dictionaries)));
+}
+
 // static
 void SdchManager::EnableSdchSupport(bool enabled) {
   g_sdch_enabled_ = enabled;
@@ -332,6 +432,15 @@ bool SdchManager::IsInSupportedDomain(const GURL& url) {
 void SdchManager::FetchDictionary(const GURL& request_url,
                                   const GURL& dictionary_url) {
   DCHECK(CalledOnValidThread());
+  // Dictionaries loaded from disk need not be fetched again.
+  for (DictionaryMap::const_iterator it = dictionaries_.begin();
+       it != dictionaries_.end(); ++it) {
+    if (it->second->url() == dictionary_url &&
+        base::Time::Now() <= it->second->expiration()) {
+      SdchErrorRecovery(DICTIONARY_ALREADY_LOADED);
+      return;
+    }
+  }
   if (SdchManager::Global()->CanFetchDictionary(request_url, dictionary_url) &&
       fetcher_.get())
     fetcher_->Schedule(dictionary_url);
@@ -376,6 +485,32 @@ bool SdchManager::AddSdchDictionary(const std::string& dictionary_text,
   std::string client_hash;
   std::string server_hash;
   GenerateHash(dictionary_text, &client_hash, &server_hash);
+  if (!AddDictionary(dictionary_text, dictionary_url, client_hash, server_hash,
+                     NULL, NULL)) {
+    return false;
+  }
+
+  if (file_task_runner_) {
+    const Dictionary* dictionary = dictionaries_[server_hash];
+    std::string contents = dictionary_url.spec() + "\n" +
+        base::Int64ToString(dictionary->expiration().ToInternalValue()) +
+        "\n" + client_hash + "\n" + dictionary_text;
+    file_task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(&SdchManager::PersistDictionary, persistence_directory_,
+                   server_hash, contents));
+  }
+  return true;
+}
+
+bool SdchManager::AddDictionary(const base::StringPiece& dictionary_text,
+                                const GURL& dictionary_url,
+                                const std::string& client_hash,
+                                const std::string& server_hash,
+                                file_util::MemoryMappedFile* mapped_file,
+                                const base::Time* persisted_expiration) {
+  // Free |mapped_file| if the dictionary is refused.
+  scoped_ptr<file_util::MemoryMappedFile> scoped_mapped_file(mapped_file);
   if (dictionaries_.find(server_hash) != dictionaries_.end()) {
     SdchErrorRecovery(DICTIONARY_ALREADY_LOADED);
     return false;  // Already loaded.
@@ -391,18 +526,18 @@ bool SdchManager::AddSdchDictionary(const std::string& dictionary_text,
   }
 
   size_t header_end = dictionary_text.find("\n\n");
-  if (std::string::npos == header_end) {
+  if (base::StringPiece::npos == header_end) {
     SdchErrorRecovery(DICTIONARY_HAS_NO_HEADER);
     return false;  // Missing header.
   }
   size_t line_start = 0;  // Start of line being parsed.
   while (1) {
     size_t line_end = dictionary_text.find('\n', line_start);
-    DCHECK(std::string::npos != line_end);
+    DCHECK(base::StringPiece::npos != line_end);
     DCHECK_LE(line_end, header_end);
 
     size_t colon_index = dictionary_text.find(':', line_start);
-    if (std::string::npos == colon_index) {
+    if (base::StringPiece::npos == colon_index) {
       SdchErrorRecovery(DICTIONARY_HEADER_LINE_MISSING_COLON);
       return false;  // Illegal line missing a colon.
     }
@@ -412,11 +547,13 @@ bool SdchManager::AddSdchDictionary(const std::string& dictionary_text,
 
     size_t value_start = dictionary_text.find_first_not_of(" \t",
                                                            colon_index + 1);
-    if (std::string::npos != value_start) {
+    if (base::StringPiece::npos != value_start) {
       if (value_start >= line_end)
         break;
-      std::string name(dictionary_text, line_start, colon_index - line_start);
-      std::string value(dictionary_text, value_start, line_end - value_start);
+      std::string name = dictionary_text.substr(
+          line_start, colon_index - line_start).as_string();
+      std::string value = dictionary_text.substr(
+          value_start, line_end - value_start).as_string();
       name = StringToLowerASCII(name);
       if (name == "domain") {
         domain = value;
@@ -441,6 +578,8 @@ bool SdchManager::AddSdchDictionary(const std::string& dictionary_text,
       break;
     line_start = line_end + 1;
   }
+  if (persisted_expiration)
+    expiration = *persisted_expiration;
 
   if (!Dictionary::CanSet(domain, path, ports, dictionary_url))
     return false;
@@ -458,17 +597,121 @@ bool SdchManager::AddSdchDictionary(const std::string& dictionary_text,
     return false;
   }
 
-  UMA_HISTOGRAM_COUNTS("Sdch3.Dictionary size loaded", dictionary_text.size());
   DVLOG(1) << "Loaded dictionary with client hash " << client_hash
            << " and server hash " << server_hash;
-  Dictionary* dictionary =
-      new Dictionary(dictionary_text, header_end + 2, client_hash,
-                     dictionary_url, domain, path, expiration, ports);
+  Dictionary* dictionary;
+  if (scoped_mapped_file.get()) {
+    UMA_HISTOGRAM_COUNTS("Sdch3.Dictionary size mapped",
+                         dictionary_text.size());
+    size_t offset = dictionary_text.data() -
+        reinterpret_cast<const char*>(scoped_mapped_file->data());
+    dictionary = new Dictionary(scoped_mapped_file.release(),
+                                offset + header_end + 2, client_hash,
+                                dictionary_url, domain, path, expiration,
+                                ports);
+  } else {
+    UMA_HISTOGRAM_COUNTS("Sdch3.Dictionary size loaded",
+                         dictionary_text.size());
+    dictionary = new Dictionary(dictionary_text.as_string(), header_end + 2,
+                                client_hash, dictionary_url, domain, path,
+                                expiration, ports);
+  }
   dictionary->AddRef();
   dictionaries_[server_hash] = dictionary;
   return true;
 }
 
+// static
+void SdchManager::LoadPersistedDictionaries(
+    const FilePath& directory,
+    PersistedDictionaryList* dictionaries) {
+  file_util::FileEnumerator enumerator(directory, false,
+                                       file_util::FileEnumerator::FILES);
+  for (FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    std::string server_hash = path.BaseName().MaybeAsASCII();
+    if (server_hash.size() != kHashLength ||
+        dictionaries->size() >= kMaxDictionaryCount) {
+      // A file that was never completely written, or more than we'd keep.
+      file_util::Delete(path, false);
+      continue;
+    }
+
+    scoped_ptr<PersistedDictionary> dictionary(new PersistedDictionary);
+    dictionary->server_hash = server_hash;
+    dictionary->mapped_file.reset(new file_util::MemoryMappedFile);
+    if (!dictionary->mapped_file->Initialize(path))
+      continue;
+
+    // Only the small preamble is read here; the text stays on disk until a
+    // decode needs it.
+    base::StringPiece contents(
+        reinterpret_cast<const char*>(dictionary->mapped_file->data()),
+        dictionary->mapped_file->length());
+    base::StringPiece url, expiration, client_hash;
+    size_t pos = 0;
+    int64 expiration_value;
+    if (!ReadLine(contents, &pos, &url) ||
+        !ReadLine(contents, &pos, &expiration) ||
+        !ReadLine(contents, &pos, &client_hash) ||
+        !base::StringToInt64(expiration, &expiration_value) ||
+        client_hash.size() != kHashLength) {
+      dictionary.reset();
+      file_util::Delete(path, false);
+      continue;
+    }
+    dictionary->url = GURL(url.as_string());
+    dictionary->expiration = base::Time::FromInternalValue(expiration_value);
+    dictionary->client_hash = client_hash.as_string();
+    dictionary->text_offset = pos;
+    if (!dictionary->url.is_valid() ||
+        base::Time::Now() > dictionary->expiration) {
+      dictionary.reset();
+      file_util::Delete(path, false);
+      continue;
+    }
+    dictionaries->push_back(dictionary.release());
+  }
+}
+
+// static
+void SdchManager::PersistDictionary(const FilePath& directory,
+                                    const std::string& server_hash,
+                                    const std::string& contents) {
+  if (!file_util::CreateDirectory(directory))
+    return;
+  // Write under a temporary name first, so that a file named by its hash is
+  // always complete.
+  FilePath path = directory.AppendASCII(server_hash);
+  FilePath temporary_path = path.AddExtension(kTemporaryExtension);
+  int size = static_cast<int>(contents.size());
+  if (file_util::WriteFile(temporary_path, contents.data(), size) != size ||
+      !file_util::Move(temporary_path, path)) {
+    file_util::Delete(temporary_path, false);
+  }
+}
+
+void SdchManager::OnPersistedDictionariesLoaded(
+    PersistedDictionaryList* dictionaries) {
+  DCHECK(CalledOnValidThread());
+  int count = 0;
+  for (size_t i = 0; i < dictionaries->size(); ++i) {
+    PersistedDictionary* persisted = (*dictionaries)[i];
+    file_util::MemoryMappedFile* mapped_file = persisted->mapped_file.get();
+    base::StringPiece text(
+        reinterpret_cast<const char*>(mapped_file->data()) +
+            persisted->text_offset,
+        mapped_file->length() - persisted->text_offset);
+    if (AddDictionary(text, persisted->url, persisted->client_hash,
+                      persisted->server_hash,
+                      persisted->mapped_file.release(),
+                      &persisted->expiration)) {
+      ++count;
+    }
+  }
+  UMA_HISTOGRAM_COUNTS_100("Sdch3.Dictionaries_Preloaded", count);
+}
+
 void SdchManager::GetVcdiffDictionary(const std::string& server_hash,
     const GURL& referring_url, Dictionary** dictionary) {
   DCHECK(CalledOnValidThread());
@@ -504,6 +747,34 @@ void SdchManager::GetAvailDictionaryList(const GURL& target_url,
     UMA_HISTOGRAM_COUNTS("Sdch3.Advertisement_Count", count);
 }
 
+base::ListValue* SdchManager::GetDictionaryStats() const {
+  DCHECK(CalledOnValidThread());
+  base::ListValue* list = new base::ListValue();
+  for (DictionaryMap::const_iterator it = dictionaries_.begin();
+       it != dictionaries_.end(); ++it) {
+    const Dictionary* dictionary = it->second;
+    base::DictionaryValue* dict = new base::DictionaryValue();
+    dict->SetString("url", dictionary->url().spec());
+    dict->SetString("client_hash", dictionary->client_hash());
+    dict->SetString("server_hash", it->first);
+    dict->SetBoolean("mapped", dictionary->mapped_file_.get() != NULL);
+    dict->SetInteger("decode_count", dictionary->decode_count_);
+    // Byte counts are strings, as a Value can't hold an int64.
+    dict->SetString("bytes_in",
+                    base::Int64ToString(dictionary->decode_bytes_in_));
+    dict->SetString("bytes_out",
+                    base::Int64ToString(dictionary->decode_bytes_out_));
+    int64 decode_ms = dictionary->decode_time_.InMilliseconds();
+    dict->SetString("decode_ms", base::Int64ToString(decode_ms));
+    if (decode_ms > 0) {
+      dict->SetString("output_kbytes_per_second", base::Int64ToString(
+          dictionary->decode_bytes_out_ * 1000 / 1024 / decode_ms));
+    }
+    list->Append(dict);
+  }
+  return list;
+}
+
 // static
 void SdchManager::GenerateHash(const std::string& dictionary_text,
     std::string* client_hash, std::string* server_hash) {
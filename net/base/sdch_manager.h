@@ -15,7 +15,9 @@
 
 // These dictionaries are acquired over the net, and include a header
 // (containing metadata) as well as a VCDIFF dictionary (for use by a VCDIFF
-// module) to decompress data.
+// module) to decompress data.  When persistence is enabled, dictionaries are
+// also saved to disk, and the ones saved by earlier sessions are mapped back
+// into memory at startup, so that they need not be fetched again.
 
 #ifndef NET_BASE_SDCH_MANAGER_H_
 #define NET_BASE_SDCH_MANAGER_H_
@@ -25,14 +27,27 @@
 #include <set>
 #include <string>
 
+#include "base/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
+#include "base/string_piece.h"
 #include "base/time.h"
 #include "base/threading/non_thread_safe.h"
 #include "googleurl/src/gurl.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+class TaskRunner;
+}
+
+namespace file_util {
+class MemoryMappedFile;
+}
+
 namespace net {
 
 //------------------------------------------------------------------------------
@@ -166,7 +181,12 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   class NET_EXPORT_PRIVATE Dictionary : public base::RefCounted<Dictionary> {
    public:
     // Sdch filters can get our text to use in decoding compressed data.
-    const std::string& text() const { return text_; }
+    base::StringPiece text() const;
+
+    // Accumulates the stats of one SDCH filter that decoded with this
+    // dictionary.
+    void RecordDecode(size_t bytes_in, size_t bytes_out,
+                      base::TimeDelta decode_time);
 
    private:
     friend class base::RefCounted<Dictionary>;
@@ -184,10 +204,21 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
                const std::string& path,
                const base::Time& expiration,
                const std::set<int>& ports);
+    // As above, but the dictionary text is the part of |mapped_file| that
+    // starts at |offset|.  Takes ownership of |mapped_file|.
+    Dictionary(file_util::MemoryMappedFile* mapped_file,
+               size_t offset,
+               const std::string& client_hash,
+               const GURL& url,
+               const std::string& domain,
+               const std::string& path,
+               const base::Time& expiration,
+               const std::set<int>& ports);
     ~Dictionary();
 
     const GURL& url() const { return url_; }
     const std::string& client_hash() const { return client_hash_; }
+    const base::Time& expiration() const { return expiration_; }
 
     // Security method to check if we can advertise this dictionary for use
     // if the |target_url| returns SDCH compressed data.
@@ -210,8 +241,11 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
     static bool DomainMatch(const GURL& url, const std::string& restriction);
 
 
-    // The actual text of the dictionary.
+    // The actual text of the dictionary, unless it is |mapped_file_|, from
+    // |mapped_offset_| on.
     std::string text_;
+    scoped_ptr<file_util::MemoryMappedFile> mapped_file_;
+    size_t mapped_offset_;
 
     // Part of the hash of text_ that the client uses to advertise the fact that
     // it has a specific dictionary pre-cached.
@@ -229,6 +263,12 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
     const base::Time expiration_;  // Implied by max-age.
     const std::set<int> ports_;
 
+    // Totals over all the filters that decoded with this dictionary.
+    int decode_count_;
+    int64 decode_bytes_in_;
+    int64 decode_bytes_out_;
+    base::TimeDelta decode_time_;
+
     DISALLOW_COPY_AND_ASSIGN(Dictionary);
   };
 
@@ -247,6 +287,15 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // Register a fetcher that this class can use to obtain dictionaries.
   void set_sdch_fetcher(SdchFetcher* fetcher);
 
+  // Saves the dictionaries added from now on as files in |directory|, and
+  // starts loading the ones saved there by earlier sessions.  The files are
+  // named by the server hash of their dictionary, and hold the dictionary's
+  // URL, expiration and client hash ahead of the text as it was fetched.
+  // Loaded dictionaries are memory mapped rather than copied.  All file
+  // operations are posted to |file_task_runner|.
+  void EnablePersistence(const FilePath& directory,
+                         base::TaskRunner* file_task_runner);
+
   // Enables or disables SDCH compression.
   static void EnableSdchSupport(bool enabled);
 
@@ -318,6 +367,11 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // the SDCH spec.
   void GetAvailDictionaryList(const GURL& target_url, std::string* list);
 
+  // Returns a list with the decode stats of each loaded dictionary: its URL,
+  // client hash, how many responses it decoded, the bytes in and out, and the
+  // decode throughput.  The caller takes ownership.
+  base::ListValue* GetDictionaryStats() const;
+
   // Construct the pair of hashes for client and server to identify an SDCH
   // dictionary.  This is only made public to facilitate unit testing, but is
   // otherwise private
@@ -333,8 +387,10 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   void SetAllowLatencyExperiment(const GURL& url, bool enable);
 
  private:
+  struct PersistedDictionary;
   typedef std::map<std::string, int> DomainCounter;
   typedef std::set<std::string> ExperimentSet;
+  typedef ScopedVector<PersistedDictionary> PersistedDictionaryList;
 
   // A map of dictionaries info indexed by the hash that the server provides.
   typedef std::map<std::string, Dictionary*> DictionaryMap;
@@ -348,8 +404,37 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // A simple implementation of a RFC 3548 "URL safe" base64 encoder.
   static void UrlSafeBase64Encode(const std::string& input,
                                   std::string* output);
+
+  // Validates |dictionary_text|, which arrived from |dictionary_url|, and
+  // adds it with the given hashes.  If |mapped_file| is non-NULL, the text
+  // lies in it, and the dictionary takes ownership of it; a NULL
+  // |persisted_expiration| means the expiration is computed from max-age.
+  bool AddDictionary(const base::StringPiece& dictionary_text,
+                     const GURL& dictionary_url,
+                     const std::string& client_hash,
+                     const std::string& server_hash,
+                     file_util::MemoryMappedFile* mapped_file,
+                     const base::Time* persisted_expiration);
+
+  // Runs on the file thread.  Maps the dictionary files in |directory| into
+  // |dictionaries|, and deletes the expired or malformed ones.
+  static void LoadPersistedDictionaries(const FilePath& directory,
+                                        PersistedDictionaryList* dictionaries);
+
+  // Runs on the file thread.  Writes the file for one dictionary.
+  static void PersistDictionary(const FilePath& directory,
+                                const std::string& server_hash,
+                                const std::string& contents);
+
+  // Adds the dictionaries found by LoadPersistedDictionaries().
+  void OnPersistedDictionariesLoaded(PersistedDictionaryList* dictionaries);
+
   DictionaryMap dictionaries_;
 
+  // Where dictionaries are persisted, if EnablePersistence() was called.
+  FilePath persistence_directory_;
+  scoped_refptr<base::TaskRunner> file_task_runner_;
+
   // An instance that can fetch a dictionary given a URL.
   scoped_ptr<SdchFetcher> fetcher_;
 
@@ -365,6 +450,8 @@ class NET_EXPORT SdchManager : public NON_EXPORTED_BASE(base::NonThreadSafe) {
   // round trip test has recently passed).
   ExperimentSet allow_latency_experiment_;
 
+  base::WeakPtrFactory<SdchManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(SdchManager);
 };
 
@@ -19,6 +19,8 @@
 #include <utility>
 
 #include "base/base64.h"
+#include "base/hash_tables.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
@@ -128,6 +130,10 @@ bool TransportSecurityState::GetDomainState(const std::string& host,
       return true;
     }
 
+    // Skip hashing the remaining labels when there are no dynamic entries.
+    if (enabled_hosts_.empty())
+      continue;
+
     std::map<std::string, DomainState>::iterator j =
         enabled_hosts_.find(HashHost(host_sub_chunk));
     if (j == enabled_hosts_.end())
@@ -588,67 +594,91 @@ struct HSTSPreload {
   SecondLevelDomainName second_level_domain_name;
 };
 
-static bool HasPreload(const struct HSTSPreload* entries, size_t num_entries,
-                       const std::string& canonicalized_host, size_t i,
-                       TransportSecurityState::DomainState* out, bool* ret) {
-  for (size_t j = 0; j < num_entries; j++) {
-    if (entries[j].length == canonicalized_host.size() - i &&
-        memcmp(entries[j].dns_name, &canonicalized_host[i],
-               entries[j].length) == 0) {
-      if (!entries[j].include_subdomains && i != 0) {
-        *ret = false;
-      } else {
-        out->include_subdomains = entries[j].include_subdomains;
-        *ret = true;
-        if (!entries[j].https_required)
-          out->upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
-        if (entries[j].pins.required_hashes) {
-          const char* const* hash = entries[j].pins.required_hashes;
-          while (*hash) {
-            bool ok = AddHash(*hash, &out->static_spki_hashes);
-            DCHECK(ok) << " failed to parse " << *hash;
-            hash++;
-          }
-        }
-        if (entries[j].pins.excluded_hashes) {
-          const char* const* hash = entries[j].pins.excluded_hashes;
-          while (*hash) {
-            bool ok = AddHash(*hash, &out->bad_static_spki_hashes);
-            DCHECK(ok) << " failed to parse " << *hash;
-            hash++;
-          }
-        }
-      }
-      return true;
+// HasPreload applies |entry|, which matched the host starting at offset |i|
+// of its canonicalized form, to |out|. Returns false if the entry only covers
+// the exact host and |i| is not zero.
+static bool HasPreload(const struct HSTSPreload* entry, size_t i,
+                       TransportSecurityState::DomainState* out) {
+  if (!entry->include_subdomains && i != 0)
+    return false;
+
+  out->include_subdomains = entry->include_subdomains;
+  if (!entry->https_required)
+    out->upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
+  if (entry->pins.required_hashes) {
+    const char* const* hash = entry->pins.required_hashes;
+    while (*hash) {
+      bool ok = AddHash(*hash, &out->static_spki_hashes);
+      DCHECK(ok) << " failed to parse " << *hash;
+      hash++;
     }
   }
-  return false;
+  if (entry->pins.excluded_hashes) {
+    const char* const* hash = entry->pins.excluded_hashes;
+    while (*hash) {
+      bool ok = AddHash(*hash, &out->bad_static_spki_hashes);
+      DCHECK(ok) << " failed to parse " << *hash;
+      hash++;
+    }
+  }
+  return true;
 }
 
 #include "net/base/transport_security_state_static.h"
 
-// Returns the HSTSPreload entry for the |canonicalized_host| in |entries|,
-// or NULL if there is none. Prefers exact hostname matches to those that
-// match only because HSTSPreload.include_subdomains is true.
+namespace {
+
+// Maps the DNS-form names of a preload table to their entries.
+typedef base::hash_map<std::string, const HSTSPreload*> PreloadMap;
+
+// PreloadIndex indexes the generated preload tables by name, so that looking
+// up a host costs one hash lookup per label rather than a walk over a whole
+// table per label. It's built on first use.
+struct PreloadIndex {
+  PreloadIndex() {
+    AddEntries(kPreloadedSTS, kNumPreloadedSTS, &sts);
+    AddEntries(kPreloadedSNISTS, kNumPreloadedSNISTS, &sni_sts);
+  }
+
+  static void AddEntries(const struct HSTSPreload* entries,
+                         size_t num_entries,
+                         PreloadMap* map) {
+    for (size_t i = 0; i < num_entries; i++) {
+      map->insert(std::make_pair(
+          std::string(entries[i].dns_name, entries[i].length), entries + i));
+    }
+  }
+
+  PreloadMap sts;
+  PreloadMap sni_sts;
+};
+
+base::LazyInstance<PreloadIndex>::Leaky g_preload_index =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Returns the entry of |map| named |dns_name|, or NULL if there is none.
+const struct HSTSPreload* FindPreload(const PreloadMap& map,
+                                      const std::string& dns_name) {
+  PreloadMap::const_iterator it = map.find(dns_name);
+  return it == map.end() ? NULL : it->second;
+}
+
+}  // namespace
+
+// Returns the HSTSPreload entry for the |canonicalized_host| in |map|, or
+// NULL if there is none. Prefers exact hostname matches to those that match
+// only because HSTSPreload.include_subdomains is true.
 //
 // |canonicalized_host| should be the hostname as canonicalized by
 // CanonicalizeHost.
 static const struct HSTSPreload* GetHSTSPreload(
     const std::string& canonicalized_host,
-    const struct HSTSPreload* entries,
-    size_t num_entries) {
+    const PreloadMap& map) {
   for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
-    for (size_t j = 0; j < num_entries; j++) {
-      const struct HSTSPreload* entry = entries + j;
-
-      if (i != 0 && !entry->include_subdomains)
-        continue;
-
-      if (entry->length == canonicalized_host.size() - i &&
-          memcmp(entry->dns_name, &canonicalized_host[i], entry->length) == 0) {
-        return entry;
-      }
-    }
+    const struct HSTSPreload* entry = FindPreload(
+        map, canonicalized_host.substr(i));
+    if (entry && (i == 0 || entry->include_subdomains))
+      return entry;
   }
 
   return NULL;
@@ -658,15 +688,15 @@ static const struct HSTSPreload* GetHSTSPreload(
 bool TransportSecurityState::IsGooglePinnedProperty(const std::string& host,
                                                     bool sni_enabled) {
   std::string canonicalized_host = CanonicalizeHost(host);
+  const PreloadIndex& index = g_preload_index.Get();
   const struct HSTSPreload* entry =
-      GetHSTSPreload(canonicalized_host, kPreloadedSTS, kNumPreloadedSTS);
+      GetHSTSPreload(canonicalized_host, index.sts);
 
   if (entry && entry->pins.required_hashes == kGoogleAcceptableCerts)
     return true;
 
   if (sni_enabled) {
-    entry = GetHSTSPreload(canonicalized_host, kPreloadedSNISTS,
-                           kNumPreloadedSNISTS);
+    entry = GetHSTSPreload(canonicalized_host, index.sni_sts);
     if (entry && entry->pins.required_hashes == kGoogleAcceptableCerts)
       return true;
   }
@@ -677,14 +707,13 @@ bool TransportSecurityState::IsGooglePinnedProperty(const std::string& host,
 // static
 void TransportSecurityState::ReportUMAOnPinFailure(const std::string& host) {
   std::string canonicalized_host = CanonicalizeHost(host);
+  const PreloadIndex& index = g_preload_index.Get();
 
   const struct HSTSPreload* entry =
-      GetHSTSPreload(canonicalized_host, kPreloadedSTS, kNumPreloadedSTS);
+      GetHSTSPreload(canonicalized_host, index.sts);
 
-  if (!entry) {
-    entry = GetHSTSPreload(canonicalized_host, kPreloadedSNISTS,
-                           kNumPreloadedSNISTS);
-  }
+  if (!entry)
+    entry = GetHSTSPreload(canonicalized_host, index.sni_sts);
 
   DCHECK(entry);
   DCHECK(entry->pins.required_hashes);
@@ -703,26 +732,27 @@ bool TransportSecurityState::GetStaticDomainState(
   out->upgrade_mode = DomainState::MODE_FORCE_HTTPS;
   out->include_subdomains = false;
 
+  const PreloadIndex& index = g_preload_index.Get();
   for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
     std::string host_sub_chunk(&canonicalized_host[i],
                                canonicalized_host.size() - i);
     out->domain = DNSDomainToString(host_sub_chunk);
-    std::string hashed_host(HashHost(host_sub_chunk));
-    if (forced_hosts_.find(hashed_host) != forced_hosts_.end()) {
-      *out = forced_hosts_[hashed_host];
-      out->domain = DNSDomainToString(host_sub_chunk);
-      return true;
-    }
-    bool ret;
-    if (HasPreload(kPreloadedSTS, kNumPreloadedSTS, canonicalized_host, i, out,
-                   &ret)) {
-      return ret;
-    }
-    if (sni_enabled &&
-        HasPreload(kPreloadedSNISTS, kNumPreloadedSNISTS, canonicalized_host, i,
-                   out, &ret)) {
-      return ret;
+    // Hashing is the expensive part of a lookup, and there are usually no
+    // forced hosts at all.
+    if (!forced_hosts_.empty()) {
+      std::map<std::string, DomainState>::const_iterator j =
+          forced_hosts_.find(HashHost(host_sub_chunk));
+      if (j != forced_hosts_.end()) {
+        *out = j->second;
+        out->domain = DNSDomainToString(host_sub_chunk);
+        return true;
+      }
     }
+    const struct HSTSPreload* entry = FindPreload(index.sts, host_sub_chunk);
+    if (!entry && sni_enabled)
+      entry = FindPreload(index.sni_sts, host_sub_chunk);
+    if (entry)
+      return HasPreload(entry, i, out);
   }
 
   return false;
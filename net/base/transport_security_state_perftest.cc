@@ -0,0 +1,62 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/transport_security_state.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 100000;
+
+// Hosts of the kinds a browsing session looks up: preloaded hosts,
+// subdomains of preloaded hosts and hosts with no state at all.
+const char* const kHosts[] = {
+  "www.google.com",
+  "mail.google.com",
+  "a.b.c.docs.google.com",
+  "www.paypal.com",
+  "twitter.com",
+  "www.example.com",
+  "static.assets.cdn.example.net",
+  "localhost",
+};
+
+// Looks up every host in |kHosts| |kIterations| times.
+void LookUpHosts(TransportSecurityState* state, const char* name) {
+  PerfTimeLogger timer(name);
+  TransportSecurityState::DomainState domain_state;
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kHosts); ++j)
+      state->GetDomainState(kHosts[j], true /* sni_enabled */, &domain_state);
+  }
+  timer.Done();
+}
+
+}  // namespace
+
+TEST(TransportSecurityStatePerfTest, PreloadedOnly) {
+  TransportSecurityState state;
+  LookUpHosts(&state, "TransportSecurityState_lookup_preloaded");
+}
+
+TEST(TransportSecurityStatePerfTest, WithDynamicEntries) {
+  TransportSecurityState state;
+  TransportSecurityState::DomainState domain_state;
+  domain_state.upgrade_expiry =
+      base::Time::Now() + base::TimeDelta::FromDays(365);
+  for (int i = 0; i < 1000; ++i)
+    state.EnableHost(base::StringPrintf("host%d.example.org", i), domain_state);
+  LookUpHosts(&state, "TransportSecurityState_lookup_dynamic");
+}
+
+}  // namespace net
@@ -4,6 +4,9 @@
 
 #include "net/base/upload_data_stream.h"
 
+#include <algorithm>
+
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/threading/thread_restrictions.h"
@@ -13,6 +16,17 @@
 
 namespace net {
 
+namespace {
+
+// Size of each read from a file element.
+const int kFileBufferSize = 64 * 1024;
+
+// Number of file buffers that may hold data at once: one being handed out by
+// Read() while the next one is read from the file.
+const size_t kNumFileBuffers = 2;
+
+}  // namespace
+
 bool UploadDataStream::merge_chunks_ = true;
 
 UploadDataStream::UploadDataStream(UploadData* upload_data)
@@ -20,7 +34,14 @@ UploadDataStream::UploadDataStream(UploadData* upload_data)
       element_index_(0),
       total_size_(0),
       current_position_(0),
-      initialized_successfully_(false) {
+      initialized_successfully_(false),
+      file_bytes_remaining_(0),
+      file_bytes_unread_(0),
+      file_operation_pending_(false),
+      file_failed_(false),
+      waiting_for_file_data_(false),
+      chunk_callback_(NULL),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_ptr_factory_(this)) {
 }
 
 UploadDataStream::~UploadDataStream() {
@@ -66,6 +87,57 @@ int UploadDataStream::Init() {
 int UploadDataStream::Read(IOBuffer* buf, int buf_len) {
   std::vector<UploadData::Element>& elements = *upload_data_->elements();
 
+  int bytes_copied = 0;
+  while (bytes_copied < buf_len && element_index_ < elements.size()) {
+    UploadData::Element& element = elements[element_index_];
+
+    if (element.type() == UploadData::TYPE_FILE) {
+      if (!file_stream_.get())
+        StartFileElement();
+
+      int bytes_read = ReadFromFile(buf->data() + bytes_copied,
+                                    buf_len - bytes_copied);
+      bytes_copied += bytes_read;
+      if (file_bytes_remaining_ > 0) {
+        // The file has not been read far enough yet.
+        if (bytes_read == 0)
+          break;
+        continue;
+      }
+
+      DCHECK(!file_operation_pending_);
+      file_stream_.reset();
+      file_buffers_.clear();
+      ++element_index_;
+      continue;
+    }
+
+    bytes_copied += element.ReadSync(buf->data() + bytes_copied,
+                                     buf_len - bytes_copied);
+
+    if (element.BytesRemaining() == 0)
+        ++element_index_;
+
+    if (is_chunked() && !merge_chunks_)
+      break;
+  }
+
+  current_position_ += bytes_copied;
+  if (!IsEOF() && bytes_copied == 0) {
+    // Either more chunks are to come, or the file element is still being
+    // read.
+    DCHECK(is_chunked() || file_stream_.get());
+    waiting_for_file_data_ = !is_chunked();
+    return ERR_IO_PENDING;
+  }
+
+  return bytes_copied;
+}
+
+int UploadDataStream::ReadSync(IOBuffer* buf, int buf_len) {
+  std::vector<UploadData::Element>& elements = *upload_data_->elements();
+  DCHECK(!file_stream_.get());
+
   int bytes_copied = 0;
   while (bytes_copied < buf_len && element_index_ < elements.size()) {
     UploadData::Element& element = elements[element_index_];
@@ -87,6 +159,136 @@ int UploadDataStream::Read(IOBuffer* buf, int buf_len) {
   return bytes_copied;
 }
 
+int UploadDataStream::ReadFromFile(char* buf, int buf_len) {
+  int bytes_copied = 0;
+  while (bytes_copied < buf_len && !file_buffers_.empty()) {
+    DrainableIOBuffer* data = file_buffers_.front();
+    int num_bytes = std::min(buf_len - bytes_copied, data->BytesRemaining());
+    memcpy(buf + bytes_copied, data->data(), num_bytes);
+    data->DidConsume(num_bytes);
+    bytes_copied += num_bytes;
+    if (data->BytesRemaining() == 0)
+      file_buffers_.pop_front();
+  }
+
+  if (file_failed_ && file_buffers_.empty()) {
+    // If there's less data to read than we initially observed, then pad with
+    // zero. Otherwise the server will hang waiting for the rest of the data.
+    int num_bytes = static_cast<int>(std::min(
+        file_bytes_remaining_ - bytes_copied,
+        static_cast<uint64>(buf_len - bytes_copied)));
+    memset(buf + bytes_copied, 0, num_bytes);
+    bytes_copied += num_bytes;
+  }
+
+  file_bytes_remaining_ -= bytes_copied;
+
+  // A buffer may have been freed up.
+  ReadAheadFromFile();
+  return bytes_copied;
+}
+
+void UploadDataStream::StartFileElement() {
+  UploadData::Element& element = (*upload_data_->elements())[element_index_];
+  DCHECK_EQ(UploadData::TYPE_FILE, element.type());
+  DCHECK(file_buffers_.empty());
+
+  file_stream_.reset(new FileStream(NULL));
+  file_bytes_remaining_ = element.BytesRemaining();
+  file_bytes_unread_ = file_bytes_remaining_;
+  file_failed_ = false;
+  if (file_bytes_remaining_ == 0)
+    return;
+
+  file_operation_pending_ = true;
+  int rv = file_stream_->Open(
+      element.file_path(),
+      base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ |
+          base::PLATFORM_FILE_ASYNC,
+      base::Bind(&UploadDataStream::OnFileOpened,
+                 weak_ptr_factory_.GetWeakPtr()));
+  if (rv != ERR_IO_PENDING)
+    OnFileOpened(rv);
+}
+
+void UploadDataStream::OnFileOpened(int result) {
+  file_operation_pending_ = false;
+  const UploadData::Element& element =
+      (*upload_data_->elements())[element_index_];
+  if (result != OK) {
+    // If the file can't be opened, we'll just upload zeros.
+    DLOG(WARNING) << "Failed to open \"" << element.file_path().value()
+                  << "\" for reading: " << result;
+    file_failed_ = true;
+    NotifyFileDataAvailable();
+    return;
+  }
+
+  if (element.file_range_offset()) {
+    file_operation_pending_ = true;
+    int rv = file_stream_->Seek(
+        FROM_BEGIN, element.file_range_offset(),
+        base::Bind(&UploadDataStream::OnFileSeeked,
+                   weak_ptr_factory_.GetWeakPtr()));
+    if (rv != ERR_IO_PENDING)
+      OnFileSeeked(rv);
+    return;
+  }
+
+  ReadAheadFromFile();
+}
+
+void UploadDataStream::OnFileSeeked(int64 result) {
+  file_operation_pending_ = false;
+  if (result < 0) {
+    DLOG(WARNING) << "Failed to seek upload file: " << result;
+    file_failed_ = true;
+    NotifyFileDataAvailable();
+    return;
+  }
+
+  ReadAheadFromFile();
+}
+
+void UploadDataStream::ReadAheadFromFile() {
+  if (!file_stream_.get() || file_operation_pending_ || file_failed_ ||
+      file_bytes_unread_ == 0 || file_buffers_.size() >= kNumFileBuffers) {
+    return;
+  }
+
+  int num_bytes = static_cast<int>(std::min(
+      file_bytes_unread_, static_cast<uint64>(kFileBufferSize)));
+  scoped_refptr<IOBuffer> buf(new IOBuffer(num_bytes));
+  file_operation_pending_ = true;
+  int rv = file_stream_->Read(
+      buf, num_bytes,
+      base::Bind(&UploadDataStream::OnFileRead,
+                 weak_ptr_factory_.GetWeakPtr(), buf));
+  if (rv != ERR_IO_PENDING)
+    OnFileRead(buf, rv);
+}
+
+void UploadDataStream::OnFileRead(scoped_refptr<IOBuffer> buf, int result) {
+  file_operation_pending_ = false;
+  if (result <= 0) {
+    // The file is shorter than we initially observed.
+    file_failed_ = true;
+  } else {
+    file_bytes_unread_ -= result;
+    file_buffers_.push_back(new DrainableIOBuffer(buf, result));
+    ReadAheadFromFile();
+  }
+  NotifyFileDataAvailable();
+}
+
+void UploadDataStream::NotifyFileDataAvailable() {
+  if (!waiting_for_file_data_)
+    return;
+  waiting_for_file_data_ = false;
+  if (chunk_callback_)
+    chunk_callback_->OnChunkAvailable();
+}
+
 bool UploadDataStream::IsEOF() const {
   const std::vector<UploadData::Element>& elements = *upload_data_->elements();
 
@@ -6,12 +6,16 @@
 #define NET_BASE_UPLOAD_DATA_STREAM_H_
 #pragma once
 
+#include <deque>
+
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "net/base/net_export.h"
 #include "net/base/upload_data.h"
 
 namespace net {
 
+class DrainableIOBuffer;
 class FileStream;
 class IOBuffer;
 
@@ -38,14 +42,23 @@ class NET_EXPORT UploadDataStream {
   // upload data is smaller than size()), zeros are padded to ensure that
   // size() bytes can be read, which can happen for TYPE_FILE payloads.
   //
-  // If the upload data stream is chunked (i.e. is_chunked() is true),
-  // ERR_IO_PENDING is returned to indicate there is nothing to read at the
-  // moment, but more data to come at a later time. If not chunked, reads
-  // won't fail.
+  // File elements are read asynchronously, ahead of the caller: while one
+  // buffer of file data is being handed out, the next one is being read. If
+  // the stream is chunked (i.e. is_chunked() is true) or the next file data
+  // is still being read, ERR_IO_PENDING is returned to indicate there is
+  // nothing to read at the moment, and the chunk callback is invoked once
+  // there is. Reads won't fail otherwise.
   int Read(IOBuffer* buf, int buf_len);
 
-  // Sets the callback to be invoked when new chunks are available to upload.
+  // Like Read(), but reads file elements synchronously on the calling thread,
+  // so it never returns ERR_IO_PENDING unless the stream is chunked. For
+  // callers without an IO message loop. Must not be mixed with Read().
+  int ReadSync(IOBuffer* buf, int buf_len);
+
+  // Sets the callback to be invoked when new chunks, or file data, are
+  // available to upload.
   void set_chunk_callback(ChunkCallback* callback) {
+    chunk_callback_ = callback;
     upload_data_->set_chunk_callback(callback);
   }
 
@@ -69,6 +82,27 @@ class NET_EXPORT UploadDataStream {
   static void set_merge_chunks(bool merge) { merge_chunks_ = merge; }
 
  private:
+  // Copies up to |buf_len| bytes of the current file element into |buf|.
+  // Returns the number of bytes copied, which is 0 if none have been read
+  // from the file yet.
+  int ReadFromFile(char* buf, int buf_len);
+
+  // Opens the file of the element at |element_index_| and starts reading
+  // ahead from it.
+  void StartFileElement();
+
+  // Callbacks for the steps of StartFileElement().
+  void OnFileOpened(int result);
+  void OnFileSeeked(int64 result);
+
+  // Starts reading the next buffer of the current file element, unless a
+  // read is in flight, all buffers are full, or the element is fully read.
+  void ReadAheadFromFile();
+  void OnFileRead(scoped_refptr<IOBuffer> buf, int result);
+
+  // Called when file data becomes available to Read().
+  void NotifyFileDataAvailable();
+
   scoped_refptr<UploadData> upload_data_;
 
   // Index of the current upload element (i.e. the element currently being
@@ -83,6 +117,28 @@ class NET_EXPORT UploadDataStream {
   // True if the initialization was successful.
   bool initialized_successfully_;
 
+  // State for the file element at |element_index_|, if it is one.
+  // |file_stream_| is NULL until the element is reached, and after it has
+  // been read.
+  scoped_ptr<FileStream> file_stream_;
+  // Bytes of the element not yet returned by Read(), and not yet requested
+  // from |file_stream_|, respectively.
+  uint64 file_bytes_remaining_;
+  uint64 file_bytes_unread_;
+  // Data read from |file_stream_| that Read() has not returned yet.
+  std::deque<scoped_refptr<DrainableIOBuffer> > file_buffers_;
+  // True while |file_stream_| is opening, seeking or reading.
+  bool file_operation_pending_;
+  // True if the file could not be read, or ended early. The rest of the
+  // element is then padded with zeros.
+  bool file_failed_;
+  // True if Read() returned ERR_IO_PENDING while waiting for file data.
+  bool waiting_for_file_data_;
+
+  ChunkCallback* chunk_callback_;
+
+  base::WeakPtrFactory<UploadDataStream> weak_ptr_factory_;
+
   // TODO(satish): Remove this once we have a better way to unit test POST
   // requests with chunked uploads.
   static bool merge_chunks_;
@@ -0,0 +1,108 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/upload_data_stream.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/upload_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A large file, sent in pieces of the size HttpStreamParser uses.
+const int kFileSize = 32 * 1024 * 1024;
+const int kReadSize = 16 * 1024;
+
+// Time spent "writing" each piece to the network.
+const int kWriteDelayMicroseconds = 50;
+
+class QuitOnDataCallback : public ChunkCallback {
+ public:
+  virtual void OnChunkAvailable() OVERRIDE {
+    MessageLoop::current()->Quit();
+  }
+};
+
+class UploadDataStreamPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(file_util::CreateTemporaryFile(&file_path_));
+    std::string data(kFileSize, 'x');
+    ASSERT_EQ(kFileSize,
+              file_util::WriteFile(file_path_, data.data(), data.size()));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    file_util::Delete(file_path_, false);
+  }
+
+  // Reads the whole file through an UploadDataStream, sleeping after each
+  // piece to stand in for the network write. Returns the bytes read.
+  int64 Upload(bool read_async) {
+    scoped_refptr<UploadData> upload_data(new UploadData);
+    upload_data->AppendFileRange(file_path_, 0, kuint64max, base::Time());
+    UploadDataStream stream(upload_data);
+    EXPECT_EQ(OK, stream.Init());
+
+    QuitOnDataCallback callback;
+    stream.set_chunk_callback(&callback);
+    scoped_refptr<IOBuffer> buf(new IOBuffer(kReadSize));
+    int64 bytes_read = 0;
+    while (!stream.IsEOF()) {
+      int rv = read_async ? stream.Read(buf, kReadSize) :
+                            stream.ReadSync(buf, kReadSize);
+      if (rv == ERR_IO_PENDING) {
+        MessageLoop::current()->Run();
+        continue;
+      }
+      EXPECT_LE(0, rv);
+      if (rv < 0)
+        break;
+      bytes_read += rv;
+      base::PlatformThread::Sleep(
+          base::TimeDelta::FromMicroseconds(kWriteDelayMicroseconds));
+    }
+    stream.set_chunk_callback(NULL);
+    return bytes_read;
+  }
+
+  FilePath file_path_;
+};
+
+TEST_F(UploadDataStreamPerfTest, FileThroughput) {
+  const bool kReadAsync[] = { false, true };
+  for (size_t i = 0; i < arraysize(kReadAsync); ++i) {
+    base::TimeTicks start = base::TimeTicks::Now();
+    int64 bytes_read = 0;
+    {
+      PerfTimeLogger timer(kReadAsync[i] ? "Upload_file_async" :
+                                           "Upload_file_sync");
+      bytes_read = Upload(kReadAsync[i]);
+    }
+    EXPECT_EQ(kFileSize, bytes_read);
+    double seconds = (base::TimeTicks::Now() - start).InSecondsF();
+    LOG(ERROR) << base::StringPrintf(
+        "%s upload: %.1f MB/s", kReadAsync[i] ? "async" : "sync",
+        bytes_read / (1024.0 * 1024.0) / seconds);
+  }
+}
+
+}  // namespace
+
+}  // namespace net
@@ -4,10 +4,12 @@
 
 #include "net/base/upload_data_stream.h"
 
+#include <string>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
+#include "base/compiler_specific.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/memory/scoped_ptr.h"
@@ -27,6 +29,37 @@ const char kTestData[] = "0123456789";
 const size_t kTestDataSize = arraysize(kTestData) - 1;
 const size_t kTestBufferSize = 1 << 14;  // 16KB.
 
+// Quits the current message loop when the stream has more data to read.
+class QuitOnDataCallback : public ChunkCallback {
+ public:
+  virtual void OnChunkAvailable() OVERRIDE {
+    MessageLoop::current()->Quit();
+  }
+};
+
+// Reads |stream| to the end, waiting for file data as needed, and returns
+// the data read.
+std::string ReadAll(UploadDataStream* stream) {
+  QuitOnDataCallback callback;
+  stream->set_chunk_callback(&callback);
+  std::string data;
+  scoped_refptr<IOBuffer> buf = new IOBuffer(kTestBufferSize);
+  while (!stream->IsEOF()) {
+    int bytes_read = stream->Read(buf, kTestBufferSize);
+    if (bytes_read == ERR_IO_PENDING) {
+      MessageLoop::current()->Run();
+      continue;
+    }
+    EXPECT_LE(0, bytes_read);  // Not an error.
+    if (bytes_read < 0)
+      break;
+    data.append(buf->data(), bytes_read);
+    EXPECT_EQ(data.size(), stream->position());
+  }
+  stream->set_chunk_callback(NULL);
+  return data;
+}
+
 }  // namespace
 
 class UploadDataStreamTest : public PlatformTest {
@@ -88,22 +121,69 @@ TEST_F(UploadDataStreamTest, FileSmallerThanLength) {
   EXPECT_EQ(kFakeSize, stream->size());
   EXPECT_EQ(0U, stream->position());
   EXPECT_FALSE(stream->IsEOF());
-  uint64 read_counter = 0;
-  scoped_refptr<IOBuffer> buf = new IOBuffer(kTestBufferSize);
-  while (!stream->IsEOF()) {
-    int bytes_read = stream->Read(buf, kTestBufferSize);
-    ASSERT_LE(0, bytes_read);  // Not an error.
-    read_counter += bytes_read;
-    EXPECT_EQ(read_counter, stream->position());
-  }
+  const std::string data = ReadAll(stream.get());
   // UpdateDataStream will pad out the file with 0 bytes so that the HTTP
   // transaction doesn't hang.  Therefore we expected the full size.
-  EXPECT_EQ(kFakeSize, read_counter);
-  EXPECT_EQ(read_counter, stream->position());
+  EXPECT_EQ(kFakeSize, data.size());
+  EXPECT_EQ(data.size(), stream->position());
+  EXPECT_EQ(std::string(kTestData, kTestDataSize) +
+                std::string(kFakeSize - kTestDataSize, '\0'),
+            data);
 
   file_util::Delete(temp_file_path, false);
 }
 
+// Reads a file range spanning several file buffers, between memory elements.
+TEST_F(UploadDataStreamTest, FileRangeBetweenBytes) {
+  std::string file_data;
+  for (int i = 0; file_data.size() < 300 * 1024; ++i)
+    file_data.append(1, static_cast<char>('a' + i % 26));
+  FilePath temp_file_path;
+  ASSERT_TRUE(file_util::CreateTemporaryFile(&temp_file_path));
+  ASSERT_EQ(static_cast<int>(file_data.size()),
+            file_util::WriteFile(temp_file_path, file_data.data(),
+                                 file_data.size()));
+  const uint64 kOffset = 1000;
+  const uint64 kLength = 200 * 1024;
+
+  upload_data_->AppendBytes(kTestData, kTestDataSize);
+  upload_data_->AppendFileRange(temp_file_path, kOffset, kLength,
+                                base::Time());
+  upload_data_->AppendBytes(kTestData, kTestDataSize);
+
+  scoped_ptr<UploadDataStream> stream(new UploadDataStream(upload_data_));
+  ASSERT_EQ(OK, stream->Init());
+  EXPECT_EQ(kLength + 2 * kTestDataSize, stream->size());
+  EXPECT_FALSE(stream->IsInMemory());
+
+  const std::string data = ReadAll(stream.get());
+  EXPECT_EQ(std::string(kTestData, kTestDataSize) +
+                file_data.substr(kOffset, kLength) +
+                std::string(kTestData, kTestDataSize),
+            data);
+  EXPECT_TRUE(stream->IsEOF());
+
+  file_util::Delete(temp_file_path, false);
+}
+
+// A file that can't be opened is uploaded as zeros.
+TEST_F(UploadDataStreamTest, MissingFile) {
+  FilePath temp_file_path;
+  ASSERT_TRUE(file_util::CreateTemporaryFile(&temp_file_path));
+  ASSERT_TRUE(file_util::Delete(temp_file_path, false));
+
+  std::vector<UploadData::Element> elements;
+  UploadData::Element element;
+  element.SetToFilePath(temp_file_path);
+  element.SetContentLength(kTestDataSize);
+  elements.push_back(element);
+  upload_data_->SetElements(elements);
+
+  scoped_ptr<UploadDataStream> stream(new UploadDataStream(upload_data_));
+  ASSERT_EQ(OK, stream->Init());
+  EXPECT_EQ(std::string(kTestDataSize, '\0'), ReadAll(stream.get()));
+}
+
 void UploadDataStreamTest::FileChangedHelper(const FilePath& file_path,
                                              const base::Time& time,
                                              bool error_expected) {
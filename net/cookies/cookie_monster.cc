@@ -108,6 +108,9 @@ typedef std::vector<CookieMonster::CanonicalCookie*> CanonicalCookieVector;
 // will update it again.
 const int kDefaultAccessUpdateThresholdSeconds = 60;
 
+// The number of domains whose keys are remembered by GetKey().
+const size_t kMaxCachedKeys = 1000;
+
 // Comparator to sort cookies from highest creation date to lowest
 // creation date.
 struct OrderByCreationTimeDesc {
@@ -1258,7 +1261,6 @@ CookieList CookieMonster::GetAllCookiesForURLWithOptions(
 
   std::vector<CanonicalCookie*> cookie_ptrs;
   FindCookiesForHostAndDomain(url, options, false, &cookie_ptrs);
-  std::sort(cookie_ptrs.begin(), cookie_ptrs.end(), CookieSorter);
 
   CookieList cookies;
   for (std::vector<CanonicalCookie*>::const_iterator it = cookie_ptrs.begin();
@@ -1414,7 +1416,6 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
 
   std::vector<CanonicalCookie*> cookies;
   FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
 
   std::string cookie_line = BuildCookieLine(cookies);
 
@@ -1441,7 +1442,6 @@ void CookieMonster::GetCookiesWithInfo(const GURL& url,
 
   std::vector<CanonicalCookie*> cookies;
   FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
   *cookie_line = BuildCookieLine(cookies);
 
   histogram_time_get_->AddTime(TimeTicks::Now() - start_time);
@@ -1786,19 +1786,24 @@ void CookieMonster::FindCookiesForKey(
     std::vector<CanonicalCookie*>* cookies) {
   lock_.AssertAcquired();
 
+  SortedCookieMap::const_iterator bucket = sorted_cookies_.find(key);
+  if (bucket == sorted_cookies_.end())
+    return;
+
   const std::string scheme(url.scheme());
   const std::string host(url.host());
+  const std::string path(url.path());
   bool secure = url.SchemeIsSecure();
+  bool found_expired = false;
 
-  for (CookieMapItPair its = cookies_.equal_range(key);
-       its.first != its.second; ) {
-    CookieMap::iterator curit = its.first;
-    CanonicalCookie* cc = curit->second;
-    ++its.first;
+  for (std::vector<CanonicalCookie*>::const_iterator it =
+           bucket->second.begin();
+       it != bucket->second.end(); ++it) {
+    CanonicalCookie* cc = *it;
 
-    // If the cookie is expired, delete it.
+    // Expired cookies are deleted below.
     if (cc->IsExpired(current) && !keep_expired_cookies_) {
-      InternalDeleteCookie(curit, true, DELETE_COOKIE_EXPIRED);
+      found_expired = true;
       continue;
     }
 
@@ -1814,7 +1819,7 @@ void CookieMonster::FindCookiesForKey(
     if (!cc->IsDomainMatch(scheme, host))
       continue;
 
-    if (!cc->IsOnPath(url.path()))
+    if (!cc->IsOnPath(path))
       continue;
 
     // Add this cookie to the set of matching cookies.  Update the access
@@ -1824,6 +1829,16 @@ void CookieMonster::FindCookiesForKey(
     }
     cookies->push_back(cc);
   }
+
+  if (!found_expired)
+    return;
+  for (CookieMapItPair its = cookies_.equal_range(key);
+       its.first != its.second; ) {
+    CookieMap::iterator curit = its.first;
+    ++its.first;
+    if (curit->second->IsExpired(current))
+      InternalDeleteCookie(curit, true, DELETE_COOKIE_EXPIRED);
+  }
 }
 
 bool CookieMonster::DeleteAnyEquivalentCookie(const std::string& key,
@@ -1866,6 +1881,10 @@ void CookieMonster::InternalInsertCookie(const std::string& key,
       store_ && sync_to_store)
     store_->AddCookie(*cc);
   cookies_.insert(CookieMap::value_type(key, cc));
+  std::vector<CanonicalCookie*>& sorted = sorted_cookies_[key];
+  sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), cc,
+                                 CookieSorter),
+                cc);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonster::Delegate::CHANGE_COOKIE_EXPLICIT);
@@ -2011,6 +2030,12 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     if (mapping.notify)
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
+  SortedCookieMap::iterator bucket = sorted_cookies_.find(it->first);
+  DCHECK(bucket != sorted_cookies_.end());
+  std::vector<CanonicalCookie*>& sorted = bucket->second;
+  sorted.erase(std::find(sorted.begin(), sorted.end(), cc));
+  if (sorted.empty())
+    sorted_cookies_.erase(bucket);
   cookies_.erase(it);
   delete cc;
 }
@@ -2162,13 +2187,21 @@ int CookieMonster::GarbageCollectDeleteList(
 // be worth it, but is still too much trouble to solve what is currently a
 // non-problem).
 std::string CookieMonster::GetKey(const std::string& domain) const {
+  base::hash_map<std::string, std::string>::const_iterator cached =
+      key_cache_.find(domain);
+  if (cached != key_cache_.end())
+    return cached->second;
+
   std::string effective_domain(
       RegistryControlledDomainService::GetDomainAndRegistry(domain));
   if (effective_domain.empty())
     effective_domain = domain;
-
   if (!effective_domain.empty() && effective_domain[0] == '.')
-    return effective_domain.substr(1);
+    effective_domain.erase(0, 1);
+
+  if (key_cache_.size() >= kMaxCachedKeys)
+    key_cache_.clear();
+  key_cache_[domain] = effective_domain;
   return effective_domain;
 }
 
@@ -2787,7 +2820,7 @@ bool CookieMonster::CanonicalCookie::IsOnPath(
   // Make sure the cookie path is a prefix of the url path.  If the
   // url path is shorter than the cookie path, then the cookie path
   // can't be a prefix.
-  if (url_path.find(path_) != 0)
+  if (url_path.compare(0, path_.length(), path_) != 0)
     return false;
 
   // Now we know that url_path is >= cookie_path, and that cookie_path
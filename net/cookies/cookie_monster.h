@@ -18,6 +18,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
+#include "base/hash_tables.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -301,6 +302,7 @@ class NET_EXPORT CookieMonster : public CookieStore {
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, TestImport);
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, GetKey);
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, TestGetKey);
+  FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, TestGetKeyManyDomains);
 
   // For FindCookiesForKey.
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, ShortLivedSessionCookies);
@@ -471,6 +473,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   void SetDefaultCookieableSchemes();
 
+  // Finds the cookies that apply to |url|, longest path first and then
+  // oldest first, as they are sent in a Cookie header.
   void FindCookiesForHostAndDomain(const GURL& url,
                                    const CookieOptions& options,
                                    bool update_access_time,
@@ -548,7 +552,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
                                std::vector<CookieMap::iterator>& cookie_its);
 
   // Find the key (for lookup in cookies_) based on the given domain.
-  // See comment on keys before the CookieMap typedef.
+  // See comment on keys before the CookieMap typedef. Results are cached in
+  // |key_cache_|.
   std::string GetKey(const std::string& domain) const;
 
   bool HasCookieableScheme(const GURL& url);
@@ -593,6 +598,18 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // The cookies of each CookieMap key, kept in the order in which they are
+  // sent (longest path first, then oldest first) so that lookups need no
+  // sort. Mirrors |cookies_|; updated by InternalInsertCookie and
+  // InternalDeleteCookie.
+  typedef base::hash_map<std::string, std::vector<CanonicalCookie*> >
+      SortedCookieMap;
+  SortedCookieMap sorted_cookies_;
+
+  // GetKey() results for recently seen domains. The registry lookup
+  // canonicalizes the domain on every call.
+  mutable base::hash_map<std::string, std::string> key_cache_;
+
   // Indicates whether the cookie store has been initialized. This happens
   // lazily in InitStoreIfNecessary().
   bool initialized_;
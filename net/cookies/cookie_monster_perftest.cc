@@ -321,6 +321,49 @@ TEST_F(CookieMonsterTest, TestDomainLine) {
   timer2.Done();
 }
 
+// A large jar, as seen with single sign-on heavy sites: 3000 cookies over 20
+// sites, each with a few hosts and paths, queried for many pages.
+TEST_F(CookieMonsterTest, TestQueryLargeJar) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  SetCookieCallback setCookieCallback;
+  GetCookiesCallback getCookiesCallback;
+  const int kNumSites = 20;
+  const int kCookiesPerSite = 150;
+  const int kHostsPerSite = 5;
+  const int kPathsPerSite = 3;
+
+  std::vector<GURL> gurls;
+  for (int site = 0; site < kNumSites; ++site) {
+    for (int host = 0; host < kHostsPerSite; ++host) {
+      for (int path = 0; path < kPathsPerSite; ++path) {
+        gurls.push_back(GURL(base::StringPrintf(
+            "https://h%d.site%02d.com/p%d/page", host, site, path)));
+      }
+    }
+    for (int i = 0; i < kCookiesPerSite; ++i) {
+      GURL gurl(base::StringPrintf("https://h%d.site%02d.com/",
+                                   i % kHostsPerSite, site));
+      // Half of the cookies are domain cookies.
+      std::string cookie(base::StringPrintf("c%03d=v; path=/p%d", i,
+                                            i % kPathsPerSite));
+      if (i % 2)
+        cookie += base::StringPrintf("; domain=.site%02d.com", site);
+      setCookieCallback.SetCookie(cm, gurl, cookie);
+    }
+  }
+
+  PerfTimeLogger timer("Cookie_monster_query_large_jar");
+  for (int i = 0; i < kNumCookies; ++i)
+    getCookiesCallback.GetCookies(cm, gurls[i % gurls.size()]);
+  timer.Done();
+
+  GetCookiesWithInfoCallback getCookiesWithInfoCallback;
+  PerfTimeLogger timer2("Cookie_monster_get_cookie_info_large_jar");
+  for (int i = 0; i < kNumCookies; ++i)
+    getCookiesWithInfoCallback.GetCookiesWithInfo(cm, gurls[i % gurls.size()]);
+  timer2.Done();
+}
+
 TEST_F(CookieMonsterTest, TestImport) {
   scoped_refptr<MockPersistentCookieStore> store(new MockPersistentCookieStore);
   std::vector<CookieMonster::CanonicalCookie*> initial_cookies;
@@ -365,6 +408,17 @@ TEST_F(CookieMonsterTest, TestGetKey) {
   timer.Done();
 }
 
+TEST_F(CookieMonsterTest, TestGetKeyManyDomains) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  std::vector<std::string> domains;
+  for (int i = 0; i < 500; ++i)
+    domains.push_back(base::StringPrintf("www%d.example%d.co.uk", i, i % 50));
+  PerfTimeLogger timer("Cookie_monster_get_key_many_domains");
+  for (int i = 0; i < kNumCookies; i++)
+    cm->GetKey(domains[i % domains.size()]);
+  timer.Done();
+}
+
 // This test is probing for whether garbage collection happens when it
 // shouldn't.  This will not in general be visible functionally, since
 // if GC runs twice in a row without any change to the store, the second
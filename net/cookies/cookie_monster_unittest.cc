@@ -2070,6 +2070,31 @@ TEST_F(CookieMonsterTest, CookieListOrdering) {
   }
 }
 
+// Test that the order is kept as cookies are overwritten and deleted.
+TEST_F(CookieMonsterTest, CookieOrderingAfterChanges) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  GURL url("http://www.google.izzle/aa/bb/x.html");
+  EXPECT_TRUE(SetCookie(cm, url, "a=1; path=/aa"));
+  EXPECT_TRUE(SetCookie(cm, url, "b=1; path=/aa/bb"));
+  EXPECT_TRUE(SetCookie(cm, url, "c=1; path=/aa"));
+  EXPECT_TRUE(SetCookie(cm, url, "d=1; path=/"));
+  EXPECT_EQ("b=1; a=1; c=1; d=1", GetCookies(cm, url));
+
+  // An overwritten cookie is newer than the others on its path.
+  EXPECT_TRUE(SetCookie(cm, url, "a=2; path=/aa"));
+  EXPECT_EQ("b=1; c=1; a=2; d=1", GetCookies(cm, url));
+
+  DeleteCookie(cm, url, "b");
+  EXPECT_EQ("c=1; a=2; d=1", GetCookies(cm, url));
+  DeleteCookie(cm, url, "c");
+  DeleteCookie(cm, url, "a");
+  DeleteCookie(cm, url, "d");
+  EXPECT_EQ("", GetCookies(cm, url));
+
+  EXPECT_TRUE(SetCookie(cm, url, "e=1; path=/aa"));
+  EXPECT_EQ("e=1", GetCookies(cm, url));
+}
+
 // This test and CookieMonstertest.TestGCTimes (in cookie_monster_perftest.cc)
 // are somewhat complementary twins.  This test is probing for whether
 // garbage collection always happens when it should (i.e. that we actually
@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/backend_impl.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_path.h"
@@ -13,6 +15,7 @@
 #include "base/metrics/histogram.h"
 #include "base/metrics/stats_counters.h"
 #include "base/rand_util.h"
+#include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/sys_info.h"
@@ -52,6 +55,10 @@ const int kDefaultCacheSize = 80 * 1024 * 1024;
 // Avoid trimming the cache for the first 5 minutes (10 timer ticks).
 const int kTrimDelay = 10;
 
+// Number of blocks to check for entries on every task while the index is
+// rebuilt.
+const int kRebuildBlocksPerTask = 128;
+
 int DesiredIndexTableLen(int32 storage_size) {
   if (storage_size <= k64kEntriesStore)
     return kBaseTableLen;
@@ -255,6 +262,8 @@ void FinalCleanupCallback(disk_cache::BackendImpl* backend) {
 
 namespace disk_cache {
 
+const char kAccessTraceName[] = "access_trace";
+
 int CreateCacheBackend(net::CacheType type, const FilePath& path, int max_bytes,
                        bool force, base::MessageLoopProxy* thread,
                        net::NetLog* net_log, Backend** backend,
@@ -321,6 +330,8 @@ BackendImpl::BackendImpl(const FilePath& path,
       new_eviction_(false),
       first_timer_(true),
       user_load_(false),
+      rebuilding_index_(false),
+      batch_deletes_(false),
       net_log_(net_log),
       done_(true, false),
       ALLOW_THIS_IN_INITIALIZER_LIST(ptr_factory_(this)) {
@@ -347,6 +358,8 @@ BackendImpl::BackendImpl(const FilePath& path,
       new_eviction_(false),
       first_timer_(true),
       user_load_(false),
+      rebuilding_index_(false),
+      batch_deletes_(false),
       net_log_(net_log),
       done_(true, false),
       ALLOW_THIS_IN_INITIALIZER_LIST(ptr_factory_(this)) {
@@ -445,9 +458,13 @@ int BackendImpl::SyncInit() {
     new_eviction_ = (cache_type_ == net::DISK_CACHE);
   }
 
+  bool rebuild_index = false;
   if (!CheckIndex()) {
-    ReportError(ERR_INIT_FAILED);
-    return net::ERR_FAILED;
+    if (create_files || !RecreateIndex()) {
+      ReportError(ERR_INIT_FAILED);
+      return net::ERR_FAILED;
+    }
+    rebuild_index = true;
   }
 
   if (create_files || !data_->header.num_entries)
@@ -490,6 +507,9 @@ int BackendImpl::SyncInit() {
 
   disabled_ = !rankings_.Init(this, new_eviction_);
 
+  if (!disabled_ && rebuild_index)
+    StartIndexRebuild();
+
   if (!disabled_ && !(user_flags_ & kNoRandom) && base::RandInt(0, 99) < 2)
     rankings_.SelfCheck();  // Ignore return value for now.
 
@@ -508,6 +528,7 @@ void BackendImpl::CleanupCache() {
   Trace("Backend Cleanup");
   eviction_.Stop();
   timer_.reset();
+  access_trace_.reset();
 
   if (init_) {
     stats_.Store();
@@ -788,6 +809,7 @@ EntryImpl* BackendImpl::CreateEntryImpl(const std::string& key) {
   } else {
     data_->table[hash & mask_] = entry_address.value();
   }
+  AddSignature(hash);
 
   // Link this entry through the lists.
   eviction_.OnCreateEntry(cache_entry);
@@ -830,6 +852,10 @@ void BackendImpl::SetType(net::CacheType type) {
   cache_type_ = type;
 }
 
+void BackendImpl::SetHotEntriesSize(int max_bytes) {
+  background_queue_.hot_entries()->SetMaxSize(max_bytes);
+}
+
 FilePath BackendImpl::GetFileName(Addr address) const {
   if (!address.is_separate_file() || !address.is_initialized()) {
     NOTREACHED();
@@ -894,9 +920,26 @@ bool BackendImpl::CreateBlock(FileType block_type, int block_count,
 }
 
 void BackendImpl::DeleteBlock(Addr block_address, bool deep) {
+  if (batch_deletes_ && deep) {
+    deleted_blocks_.push_back(block_address.value());
+    return;
+  }
   block_files_.DeleteBlock(block_address, deep);
 }
 
+void BackendImpl::BeginDeleteBatch() {
+  DCHECK(!batch_deletes_);
+  batch_deletes_ = true;
+}
+
+void BackendImpl::EndDeleteBatch() {
+  DCHECK(batch_deletes_);
+  batch_deletes_ = false;
+  if (!deleted_blocks_.empty())
+    block_files_.DeleteBlocks(deleted_blocks_);
+  deleted_blocks_.clear();
+}
+
 LruData* BackendImpl::GetLruData() {
   return &data_->header.lru;
 }
@@ -923,6 +966,7 @@ void BackendImpl::RecoveredEntry(CacheRankingsBlock* rankings) {
     return;
 
   data_->table[hash & mask_] = address.value();
+  ForgetBucket(hash);
 }
 
 void BackendImpl::InternalDoomEntry(EntryImpl* entry) {
@@ -951,6 +995,7 @@ void BackendImpl::InternalDoomEntry(EntryImpl* entry) {
   } else if (!error) {
     data_->table[hash & mask_] = child;
   }
+  ForgetBucket(hash);
 }
 
 #if defined(NET_BUILD_STRESS_CACHE)
@@ -1188,6 +1233,15 @@ void BackendImpl::OnWrite(int32 bytes) {
   OnRead(bytes);
 }
 
+void BackendImpl::RecordAccess(const AccessTrace::Record& record) {
+  if (!(user_flags_ & kAccessTrace))
+    return;
+
+  if (!access_trace_.get())
+    access_trace_.reset(new AccessTrace(path_.AppendASCII(kAccessTraceName)));
+  access_trace_->Add(record);
+}
+
 void BackendImpl::OnStatsTimer() {
   stats_.OnEvent(Stats::TIMER);
   int64 time = stats_.GetCounter(Stats::TIMER);
@@ -1206,6 +1260,9 @@ void BackendImpl::OnStatsTimer() {
 
   CACHE_UMA(COUNTS, "NumberOfReferences", 0, num_refs_);
 
+  if (access_trace_.get())
+    access_trace_->Flush();
+
   CACHE_UMA(COUNTS_10000, "EntryAccessRate", 0, entry_count_);
   CACHE_UMA(COUNTS, "ByteIORate", 0, byte_count_ / 1024);
 
@@ -1397,6 +1454,7 @@ void BackendImpl::GetStats(StatsItems* stats) {
   item.second = base::StringPrintf("%d", data_->header.num_bytes);
   stats->push_back(item);
 
+  background_queue_.hot_entries()->GetStats(stats);
   stats_.GetItems(stats);
 }
 
@@ -1540,6 +1598,9 @@ void BackendImpl::PrepareForRestart() {
   disabled_ = true;
   data_->header.crash = 0;
   index_ = NULL;
+  signatures_.clear();
+  rebuilding_index_ = false;
+  unclaimed_files_.clear();
   data_ = NULL;
   block_files_.CloseFiles();
   rankings_.Reset();
@@ -1627,12 +1688,16 @@ int BackendImpl::NewEntry(Addr address, EntryImpl** entry) {
 EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
                                    bool find_parent, Addr entry_addr,
                                    bool* match_error) {
+  *match_error = false;
+  if (!find_parent && IsKnownMiss(hash))
+    return NULL;
+
   Addr address(data_->table[hash & mask_]);
   scoped_refptr<EntryImpl> cache_entry, parent_entry;
   EntryImpl* tmp = NULL;
   bool found = false;
   std::set<CacheAddr> visited;
-  *match_error = false;
+  std::vector<uint16> signatures;
 
   for (;;) {
     if (disabled_)
@@ -1650,6 +1715,8 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
     if (!address.is_initialized()) {
       if (find_parent)
         found = true;
+      // We have seen every entry on this bucket.
+      signatures_[hash & mask_].swap(signatures);
       break;
     }
 
@@ -1669,6 +1736,7 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
       } else {
         data_->table[hash & mask_] = child.value();
       }
+      ForgetBucket(hash);
 
       Trace("MatchEntry dirty %d 0x%x 0x%x", find_parent, entry_addr.value(),
             address.value());
@@ -1685,10 +1753,12 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
       // Restart the search.
       address.set_value(data_->table[hash & mask_]);
       visited.clear();
+      signatures.clear();
       continue;
     }
 
     DCHECK_EQ(hash & mask_, cache_entry->entry()->Data()->hash & mask_);
+    signatures.push_back(cache_entry->entry()->Data()->hash >> 16);
     if (cache_entry->IsSameEntry(key, hash)) {
       if (!cache_entry->Update())
         cache_entry = NULL;
@@ -1725,6 +1795,28 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
   return tmp;
 }
 
+// The signature of a key is the upper part of its hash, as the lower part is
+// what selects the bucket.
+bool BackendImpl::IsKnownMiss(uint32 hash) const {
+  BucketSignatures::const_iterator it = signatures_.find(hash & mask_);
+  if (it == signatures_.end())
+    return false;
+
+  uint16 signature = static_cast<uint16>(hash >> 16);
+  return std::find(it->second.begin(), it->second.end(), signature) ==
+         it->second.end();
+}
+
+void BackendImpl::AddSignature(uint32 hash) {
+  BucketSignatures::iterator it = signatures_.find(hash & mask_);
+  if (it != signatures_.end())
+    it->second.push_back(static_cast<uint16>(hash >> 16));
+}
+
+void BackendImpl::ForgetBucket(uint32 hash) {
+  signatures_.erase(hash & mask_);
+}
+
 // This is the actual implementation for OpenNextEntry and OpenPrevEntry.
 EntryImpl* BackendImpl::OpenFollowingEntry(bool forward, void** iter) {
   if (disabled_)
@@ -2109,6 +2201,171 @@ bool BackendImpl::CheckIndex() {
   return index_->Read(buf.get(), current_size, 0);
 }
 
+bool BackendImpl::RecreateIndex() {
+  if (cache_type() == net::APP_CACHE)
+    return false;
+
+  // An index from a different version may come with block files that we don't
+  // understand.
+  if (kIndexMagic != data_->header.magic)
+    return false;
+  if (new_eviction_ ? kCurrentVersion >> 16 != data_->header.version >> 16 :
+                      kCurrentVersion != data_->header.version)
+    return false;
+
+  LOG(WARNING) << "Rebuilding the cache index";
+  Trace("Rebuild index");
+
+  // Keep the new external files away from the ones we already have.
+  int32 last_file = data_->header.last_file;
+  index_ = NULL;
+  data_ = NULL;
+  if (!(user_flags_ & kMask))
+    mask_ = 0;
+
+  if (!file_util::Delete(path_.AppendASCII(kIndexName), false))
+    return false;
+
+  bool file_created = false;
+  if (!InitBackingStore(&file_created) || !file_created || !CheckIndex())
+    return false;
+
+  if (last_file > 0)
+    data_->header.last_file = last_file;
+  return true;
+}
+
+void BackendImpl::StartIndexRebuild() {
+  rebuilding_index_ = true;
+  rebuild_address_ = Addr();
+
+  // Any external file that is not claimed by an entry by the end of the scan
+  // belongs to an entry that can't be recovered.
+  unclaimed_files_.clear();
+  file_util::FileEnumerator iter(path_, false,
+                                 file_util::FileEnumerator::FILES,
+                                 FILE_PATH_LITERAL("f_*"));
+  for (FilePath file = iter.Next(); !file.value().empty(); file = iter.Next()) {
+    std::string name = file.BaseName().MaybeAsASCII();
+    int file_number;
+    if (name.size() > 2 && base::HexStringToInt(name.substr(2), &file_number))
+      unclaimed_files_.insert(file_number);
+  }
+
+  MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&BackendImpl::RebuildIndexStep, GetWeakPtr()));
+}
+
+void BackendImpl::RebuildIndexStep() {
+  if (!rebuilding_index_ || disabled_)
+    return;
+
+  for (int i = 0; i < kRebuildBlocksPerTask; i++) {
+    if (!block_files_.NextUsedBlock(BLOCK_256, &rebuild_address_))
+      return FinishIndexRebuild();
+
+    RecoverEntry(&rebuild_address_);
+    if (disabled_)
+      return;
+  }
+
+  // Let other requests go ahead of the rest of the scan.
+  MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&BackendImpl::RebuildIndexStep, GetWeakPtr()));
+}
+
+void BackendImpl::FinishIndexRebuild() {
+  Trace("Rebuild index done: %d entries", data_->header.num_entries);
+  for (std::set<int>::const_iterator it = unclaimed_files_.begin();
+       it != unclaimed_files_.end(); ++it) {
+    Addr address(0);
+    if (address.SetFileNumber(*it))
+      DeleteCacheFile(GetFileName(address));
+  }
+  unclaimed_files_.clear();
+  rebuilding_index_ = false;
+}
+
+bool BackendImpl::RecoverEntry(Addr* address) {
+  CacheEntryBlock block(File(*address), *address);
+  if (!block.Load())
+    return false;
+
+  int num_blocks = EntryImpl::NumBlocksForEntry(block.Data()->key_len);
+  Addr entry_address(BLOCK_256, num_blocks, address->FileNumber(),
+                     address->start_block());
+
+  // Entries that are open were created (or recovered) after the scan started.
+  if (open_entries_.find(entry_address.value()) != open_entries_.end()) {
+    *address = entry_address;
+    return false;
+  }
+
+  scoped_refptr<EntryImpl> cache_entry(
+      new EntryImpl(this, entry_address, false));
+  IncreaseNumRefs();
+
+  if (!cache_entry->entry()->Load() || !cache_entry->SanityCheck())
+    return false;
+
+  *address = entry_address;
+  if (!cache_entry->LoadNodeAddress())
+    return false;
+
+  // Entries that were open when the index was lost are not trusted, and the
+  // rankings node must belong to this entry.
+  EntryStore* stored = cache_entry->entry()->Data();
+  RankingsNode* node = cache_entry->rankings()->Data();
+  bool valid = cache_entry->rankings()->VerifyHash() &&
+               node->contents == entry_address.value() && !node->dirty &&
+               cache_entry->DataSanityCheck();
+  if (stored->state != ENTRY_NORMAL &&
+      (!new_eviction_ || stored->state != ENTRY_EVICTED))
+    valid = false;
+
+  // This entry may also be linked already, or replaced by a newer version.
+  EntryImpl* current = NULL;
+  if (valid) {
+    bool error;
+    open_entries_[entry_address.value()] = cache_entry;
+    current = MatchEntry(cache_entry->GetKey(), stored->hash, false, Addr(),
+                         &error);
+    if (current)
+      current->Release();
+    if (error || disabled_)
+      valid = false;
+  }
+
+  if (current == cache_entry.get())
+    return false;
+
+  if (!valid || current) {
+    // Don't let the destructor touch this entry.
+    cache_entry->SetDirtyFlag(0);
+    return false;
+  }
+
+  uint32 hash = stored->hash;
+  cache_entry->SetNextAddress(Addr(data_->table[hash & mask_]));
+  data_->table[hash & mask_] = entry_address.value();
+  AddSignature(hash);
+  IncreaseNumEntries();
+
+  ModifyStorageSize(0, stored->key_len);
+  Addr key_addr(stored->long_key);
+  if (key_addr.is_initialized() && key_addr.is_separate_file())
+    unclaimed_files_.erase(key_addr.FileNumber());
+  for (size_t i = 0; i < arraysize(stored->data_addr); i++) {
+    ModifyStorageSize(0, stored->data_size[i]);
+    Addr data_addr(stored->data_addr[i]);
+    if (data_addr.is_initialized() && data_addr.is_separate_file())
+      unclaimed_files_.erase(data_addr.FileNumber());
+  }
+
+  eviction_.OnRecoverEntry(cache_entry);
+  return true;
+}
+
 int BackendImpl::CheckAllEntries() {
   int num_dirty = 0;
   int num_entries = 0;
@@ -8,6 +8,9 @@
 #define NET_DISK_CACHE_BACKEND_IMPL_H_
 #pragma once
 
+#include <set>
+#include <vector>
+
 #include "base/file_path.h"
 #include "base/hash_tables.h"
 #include "base/timer.h"
@@ -35,9 +38,13 @@ enum BackendFlags {
   kNewEviction = 1 << 4,        // Use of new eviction was specified.
   kNoRandom = 1 << 5,           // Don't add randomness to the behavior.
   kNoLoadProtection = 1 << 6,   // Don't act conservatively under load.
-  kNoBuffering = 1 << 7         // Disable extended IO buffering.
+  kNoBuffering = 1 << 7,        // Disable extended IO buffering.
+  kAccessTrace = 1 << 8         // Keep an access trace (see trace.h).
 };
 
+// Name of the access trace file kept with kAccessTrace.
+NET_EXPORT_PRIVATE extern const char kAccessTraceName[];
+
 // This class implements the Backend interface. An object of this
 // class handles the operations of the cache for a particular profile.
 class NET_EXPORT_PRIVATE BackendImpl : public Backend {
@@ -94,6 +101,10 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // Sets the cache type for this backend.
   void SetType(net::CacheType type);
 
+  // Keeps in memory up to |max_bytes| of copies of small entries that are
+  // read often. Zero (the default) disables the copies.
+  void SetHotEntriesSize(int max_bytes);
+
   // Returns the full name for an external storage file.
   FilePath GetFileName(Addr address) const;
 
@@ -114,6 +125,11 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // the related storage in addition of releasing the related block.
   void DeleteBlock(Addr block_address, bool deep);
 
+  // While a batch is open, the blocks released with DeleteBlock() and |deep|
+  // set are kept aside and released together when the batch is closed.
+  void BeginDeleteBatch();
+  void EndDeleteBatch();
+
   // Retrieves a pointer to the LRU-related data.
   LruData* GetLruData();
 
@@ -211,6 +227,13 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   void OnRead(int bytes);
   void OnWrite(int bytes);
 
+  // Appends |record| to the access trace of this cache, if kAccessTrace is
+  // set. The trace is kept as kAccessTraceName, in the cache directory.
+  void RecordAccess(const AccessTrace::Record& record);
+  bool access_trace_enabled() const {
+    return (user_flags_ & kAccessTrace) != 0;
+  }
+
   // Timer callback to calculate usage statistics.
   void OnStatsTimer();
 
@@ -275,6 +298,7 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
 
  private:
   typedef base::hash_map<CacheAddr, EntryImpl*> EntriesMap;
+  typedef base::hash_map<uint32, std::vector<uint16> > BucketSignatures;
 
   // Creates a new backing file for the cache index.
   bool CreateBackingStore(disk_cache::File* file);
@@ -299,6 +323,14 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   EntryImpl* MatchEntry(const std::string& key, uint32 hash, bool find_parent,
                         Addr entry_addr, bool* match_error);
 
+  // Remembers the signatures of the keys on the bucket of the index for |hash|,
+  // once the whole bucket has been walked, so that later lookups of keys that
+  // are not there don't have to load any entry from disk. Returns true if the
+  // lookup of a key with this |hash| is known to miss.
+  bool IsKnownMiss(uint32 hash) const;
+  void AddSignature(uint32 hash);
+  void ForgetBucket(uint32 hash);
+
   // Opens the next or previous entry on a cache iteration.
   EntryImpl* OpenFollowingEntry(bool forward, void** iter);
 
@@ -339,6 +371,23 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // Performs basic checks on the index file. Returns false on failure.
   bool CheckIndex();
 
+  // Replaces an index that failed CheckIndex() with an empty one, as long as
+  // the block files use the current format, so that the entries can be linked
+  // back while the cache is in use. Returns false if the whole cache has to be
+  // discarded.
+  bool RecreateIndex();
+
+  // Scans the block files looking for the entries that were reachable through
+  // the discarded index, a few blocks per task.
+  void StartIndexRebuild();
+  void RebuildIndexStep();
+  void FinishIndexRebuild();
+
+  // Links back the entry stored at |*address| if it is valid and nothing
+  // replaced it yet. When the entry passes the basic checks, |*address| is
+  // updated to cover all of its blocks. Returns true if the entry was linked.
+  bool RecoverEntry(Addr* address);
+
   // Part of the self test. Returns the number or dirty entries, or an error.
   int CheckAllEntries();
 
@@ -358,6 +407,10 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   int32 max_size_;  // Maximum data size for this instance.
   Eviction eviction_;  // Handler of the eviction algorithm.
   EntriesMap open_entries_;  // Map of open entries.
+  BucketSignatures signatures_;  // Keys on the buckets walked so far.
+  Addr rebuild_address_;  // Last block visited while rebuilding the index.
+  std::set<int> unclaimed_files_;  // External files not used by any entry yet.
+  std::vector<CacheAddr> deleted_blocks_;  // Blocks waiting to be released.
   int num_refs_;  // Number of referenced cache entries.
   int max_refs_;  // Max number of referenced cache entries.
   int num_pending_io_;  // Number of pending IO operations.
@@ -376,6 +429,8 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   bool new_eviction_;  // What eviction algorithm should be used.
   bool first_timer_;  // True if the timer has not been called.
   bool user_load_;  // True if we see a high load coming from the caller.
+  bool rebuilding_index_;  // True while the index is rebuilt from the files.
+  bool batch_deletes_;  // True while DeleteBlock() calls are batched.
 
   net::NetLog* net_log_;
 
@@ -383,6 +438,7 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   scoped_ptr<base::RepeatingTimer<BackendImpl> > timer_;  // Usage timer.
   base::WaitableEvent done_;  // Signals the end of background work.
   scoped_refptr<TraceObject> trace_object_;  // Initializes internal tracing.
+  scoped_ptr<AccessTrace> access_trace_;  // Created by the first access.
   base::WeakPtrFactory<BackendImpl> ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(BackendImpl);
@@ -4,6 +4,7 @@
 
 #include "base/basictypes.h"
 #include "base/file_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/third_party/dynamic_annotations/dynamic_annotations.h"
@@ -17,6 +18,7 @@
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
 #include "net/disk_cache/entry_impl.h"
+#include "net/disk_cache/hash.h"
 #include "net/disk_cache/histogram_macros.h"
 #include "net/disk_cache/mapped_file.h"
 #include "net/disk_cache/mem_backend_impl.h"
@@ -73,6 +75,7 @@ class DiskCacheBackendTest : public DiskCacheTestWithCache {
   void BackendDisable2();
   void BackendDisable3();
   void BackendDisable4();
+  void BackendRebuildIndex();
 };
 
 void DiskCacheBackendTest::BackendBasics() {
@@ -505,6 +508,7 @@ void DiskCacheBackendTest::BackendSetSize() {
   EXPECT_EQ(cache_size / 10, WriteData(entry2, 0, 0, buffer, cache_size / 10,
                                        false));
   entry2->Close();  // This will trigger the cache trim.
+  FlushQueueForTest();  // The trim job runs in the background.
 
   EXPECT_NE(net::OK, OpenEntry(first, &entry2));
 
@@ -531,6 +535,33 @@ TEST_F(DiskCacheBackendTest, MemoryOnlySetSize) {
   BackendSetSize();
 }
 
+// Entries that are not in use are given up under critical memory pressure.
+TEST_F(DiskCacheBackendTest, MemoryOnlyMemoryPressure) {
+  SetMemoryOnlyMode();
+  InitCache();
+
+  const int kSize = 1024;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* open_entry;
+  ASSERT_EQ(net::OK, CreateEntry("open", &open_entry));
+  EXPECT_EQ(kSize, WriteData(open_entry, 0, 0, buffer, kSize, false));
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("closed", &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 0, 0, buffer, kSize, false));
+  entry->Close();
+  EXPECT_EQ(2, cache_->GetEntryCount());
+
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  MessageLoop::current()->RunAllPending();
+
+  EXPECT_EQ(1, cache_->GetEntryCount());
+  EXPECT_NE(net::OK, OpenEntry("closed", &entry));
+  open_entry->Close();
+}
+
 void DiskCacheBackendTest::BackendLoad() {
   InitCache();
   int seed = static_cast<int>(Time::Now().ToInternalValue());
@@ -620,6 +651,112 @@ TEST_F(DiskCacheBackendTest, AppCacheChain) {
   BackendChain();
 }
 
+// Tests lookups on long chains of entries, as they are answered from the keys
+// remembered for each bucket once it has been walked.
+TEST_F(DiskCacheBackendTest, ChainLookups) {
+  SetMask(0x1);  // 2-entry table.
+  SetDirectMode();
+  InitCache();
+
+  disk_cache::Entry* entry;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(net::OK, CreateEntry(StringPrintf("Key %d", i), &entry));
+    entry->Close();
+  }
+
+  // Misses, before and after walking the buckets.
+  for (int i = 10; i < 30; i++)
+    EXPECT_NE(net::OK, OpenEntry(StringPrintf("Key %d", i), &entry));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(net::OK, OpenEntry(StringPrintf("Key %d", i), &entry));
+    entry->Close();
+  }
+  for (int i = 10; i < 30; i++)
+    EXPECT_NE(net::OK, OpenEntry(StringPrintf("Key %d", i), &entry));
+
+  // Entries created or doomed after the buckets were walked.
+  ASSERT_EQ(net::OK, CreateEntry("Key 10", &entry));
+  entry->Close();
+  ASSERT_EQ(net::OK, DoomEntry("Key 3"));
+  ASSERT_EQ(net::OK, OpenEntry("Key 10", &entry));
+  entry->Close();
+  EXPECT_NE(net::OK, OpenEntry("Key 3", &entry));
+  for (int i = 4; i < 10; i++) {
+    ASSERT_EQ(net::OK, OpenEntry(StringPrintf("Key %d", i), &entry));
+    entry->Close();
+  }
+  ASSERT_EQ(net::OK, CreateEntry("Key 3", &entry));
+  entry->Close();
+  ASSERT_EQ(net::OK, OpenEntry("Key 3", &entry));
+  entry->Close();
+  EXPECT_EQ(11, cache_->GetEntryCount());
+}
+
+// Tests that the entries survive an index that has to be discarded.
+void DiskCacheBackendTest::BackendRebuildIndex() {
+  SetDirectMode();
+  InitCache();
+
+  const int kNumEntries = 10;
+  const int kSize = 20000;  // Stored on a separate file.
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+  disk_cache::Entry* entry;
+  for (int i = 0; i < kNumEntries; i++) {
+    ASSERT_EQ(net::OK, CreateEntry(StringPrintf("Key %d", i), &entry));
+    int size = i ? i * 100 : kSize;
+    EXPECT_EQ(size, WriteData(entry, 1, 0, buffer, size, false));
+    entry->Close();
+  }
+  FlushQueueForTest();
+  delete cache_;
+  cache_ = NULL;
+  cache_impl_ = NULL;
+
+  // A file that no entry uses, and the mark left by a critical error.
+  FilePath orphan = cache_path_.AppendASCII("f_0fffff");
+  ASSERT_EQ(1, file_util::WriteFile(orphan, "a", 1));
+  {
+    scoped_refptr<disk_cache::MappedFile> file(new disk_cache::MappedFile);
+    disk_cache::Index* index = reinterpret_cast<disk_cache::Index*>(
+        file->Init(cache_path_.AppendASCII("index"), 0));
+    ASSERT_TRUE(NULL != index);
+    index->header.table_len = 1;
+  }
+
+  DisableFirstCleanup();
+  InitCache();
+  FlushQueueForTest();
+  EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+  EXPECT_FALSE(file_util::PathExists(orphan));
+
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  for (int i = 0; i < kNumEntries; i++) {
+    ASSERT_EQ(net::OK, OpenEntry(StringPrintf("Key %d", i), &entry));
+    int size = i ? i * 100 : kSize;
+    ASSERT_EQ(size, entry->GetDataSize(1));
+    EXPECT_EQ(size, ReadData(entry, 1, 0, buffer2, size));
+    EXPECT_EQ(0, memcmp(buffer->data(), buffer2->data(), size));
+    entry->Close();
+  }
+
+  // The rebuilt index works as usual.
+  ASSERT_EQ(net::OK, CreateEntry("Key 10", &entry));
+  entry->Close();
+  ASSERT_EQ(net::OK, DoomEntry("Key 0"));
+  EXPECT_NE(net::OK, OpenEntry("Key 0", &entry));
+  EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+}
+
+TEST_F(DiskCacheBackendTest, RebuildIndex) {
+  BackendRebuildIndex();
+}
+
+TEST_F(DiskCacheBackendTest, NewEvictionRebuildIndex) {
+  SetNewEviction();
+  BackendRebuildIndex();
+}
+
 TEST_F(DiskCacheBackendTest, NewEvictionTrim) {
   SetNewEviction();
   SetDirectMode();
@@ -2576,3 +2713,52 @@ TEST_F(DiskCacheBackendTest, UpdateRankForExternalCacheHit) {
   ASSERT_EQ(net::OK, OpenEntry("key0", &entry));
   entry->Close();
 }
+
+TEST_F(DiskCacheBackendTest, AccessTrace) {
+  SetDirectMode();
+  InitCache();
+  cache_impl_->SetFlags(disk_cache::kAccessTrace);
+
+  const int kSize = 100;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer, kSize, false));
+  entry->Close();
+  ASSERT_EQ(net::OK, OpenEntry("the first key", &entry));
+  EXPECT_EQ(kSize, ReadData(entry, 1, 0, buffer, kSize));
+  entry->Doom();
+  entry->Close();
+  EXPECT_NE(net::OK, OpenEntry("the first key", &entry));
+  FlushQueueForTest();
+  delete cache_;
+  cache_ = NULL;
+  cache_impl_ = NULL;
+
+  std::vector<disk_cache::AccessTrace::Record> records;
+  ASSERT_TRUE(disk_cache::AccessTrace::ReadTrace(
+      cache_path_.AppendASCII(disk_cache::kAccessTraceName), &records));
+  const disk_cache::AccessTrace::Operation kExpected[] = {
+    disk_cache::AccessTrace::CREATE,
+    disk_cache::AccessTrace::WRITE,
+    disk_cache::AccessTrace::CLOSE,
+    disk_cache::AccessTrace::OPEN,
+    disk_cache::AccessTrace::READ,
+    disk_cache::AccessTrace::DOOM,
+    disk_cache::AccessTrace::CLOSE,
+    disk_cache::AccessTrace::OPEN,
+  };
+  ASSERT_EQ(arraysize(kExpected), records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    EXPECT_EQ(kExpected[i], records[i].operation);
+    EXPECT_EQ(disk_cache::Hash("the first key"), records[i].hash);
+    EXPECT_EQ(13, records[i].key_len);
+  }
+  EXPECT_EQ(kSize, records[1].size);
+  EXPECT_EQ(kSize, records[1].result);
+  EXPECT_EQ(1, records[4].index);
+  EXPECT_EQ(kSize, records[4].result);
+  EXPECT_EQ(net::OK, records[3].result);
+  EXPECT_NE(net::OK, records[7].result);
+}
@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/block_files.h"
 
+#include <algorithm>
+
 #include "base/atomicops.h"
 #include "base/file_util.h"
 #include "base/metrics/histogram.h"
@@ -338,6 +340,52 @@ void BlockFiles::DeleteBlock(Addr address, bool deep) {
   }
 }
 
+void BlockFiles::DeleteBlocks(const std::vector<CacheAddr>& addresses) {
+  DCHECK(thread_checker_->CalledOnValidThread());
+  if (!zero_buffer_) {
+    zero_buffer_ = new char[Addr::BlockSizeForFileType(BLOCK_4K) * 4];
+    memset(zero_buffer_, 0, Addr::BlockSizeForFileType(BLOCK_4K) * 4);
+  }
+
+  // Sorting the addresses groups them by file, and by position on each file.
+  std::vector<CacheAddr> sorted(addresses);
+  std::sort(sorted.begin(), sorted.end());
+
+  size_t i = 0;
+  while (i < sorted.size()) {
+    Addr first(sorted[i]);
+    if (!first.is_initialized() || first.is_separate_file()) {
+      i++;
+      continue;
+    }
+
+    size_t end = i + 1;
+    int next_block = first.start_block() + first.num_blocks();
+    size_t size = first.BlockSize() * first.num_blocks();
+    for (; end < sorted.size(); end++) {
+      Addr next(sorted[end]);
+      size_t next_size = next.BlockSize() * next.num_blocks();
+      if (next.file_type() != first.file_type() ||
+          next.FileNumber() != first.FileNumber() ||
+          next.start_block() != next_block ||
+          size + next_size > static_cast<size_t>(kMaxBlockSize))
+        break;
+      next_block += next.num_blocks();
+      size += next_size;
+    }
+
+    MappedFile* file = GetFile(first);
+    if (file) {
+      size_t offset = first.start_block() * first.BlockSize() +
+                      kBlockHeaderSize;
+      file->Write(zero_buffer_, size, offset);
+    }
+
+    for (; i < end; i++)
+      DeleteBlock(Addr(sorted[i]), false);
+  }
+}
+
 void BlockFiles::CloseFiles() {
   if (init_) {
     DCHECK(thread_checker_->CalledOnValidThread());
@@ -400,6 +448,46 @@ bool BlockFiles::IsValid(Addr address) {
 #endif
 }
 
+bool BlockFiles::NextUsedBlock(FileType block_type, Addr* address) {
+  DCHECK(thread_checker_->CalledOnValidThread());
+  int file_index = block_type - 1;
+  int index = 0;
+  if (address->is_initialized()) {
+    DCHECK_EQ(block_type, address->file_type());
+    file_index = address->FileNumber();
+    index = address->start_block() + address->num_blocks();
+  }
+
+  // The files of a chain can't link back to a previous one, but we don't want
+  // to loop forever on a broken header either.
+  for (int i = 0; i <= kMaxBlockFile; i++) {
+    MappedFile* file = GetFile(Addr(block_type, 1, file_index, 0));
+    if (!file)
+      return false;
+
+    BlockFileHeader* header =
+        reinterpret_cast<BlockFileHeader*>(file->buffer());
+    uint8* byte_map = reinterpret_cast<uint8*>(header->allocation_map);
+    int max_entries = std::min(header->max_entries, kMaxBlocks);
+    for (; index < max_entries; index++) {
+      if (!(index % 8) && !byte_map[index / 8]) {
+        index += 7;
+        continue;
+      }
+      if (byte_map[index / 8] & (1 << (index % 8))) {
+        *address = Addr(block_type, 1, file_index, index);
+        return true;
+      }
+    }
+
+    if (!header->next_file)
+      return false;
+    file_index = header->next_file;
+    index = 0;
+  }
+  return false;
+}
+
 bool BlockFiles::CreateBlockFile(int index, FileType file_type, bool force) {
   FilePath name = Name(index);
   int flags =
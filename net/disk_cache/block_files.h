@@ -46,6 +46,10 @@ class NET_EXPORT_PRIVATE BlockFiles {
   // already zeroed).
   void DeleteBlock(Addr address, bool deep);
 
+  // Removes a set of entries as DeleteBlock() does with |deep| set, filling
+  // with zeros the storage of contiguous blocks of the same file at once.
+  void DeleteBlocks(const std::vector<CacheAddr>& addresses);
+
   // Close all the files and set the internal state to be initializad again. The
   // cache is being purged.
   void CloseFiles();
@@ -57,6 +61,13 @@ class NET_EXPORT_PRIVATE BlockFiles {
   // This method is only intended for debugging.
   bool IsValid(Addr address);
 
+  // Walks the used blocks of the chain of files for |block_type|. On input,
+  // |address| is the last record returned (or an uninitialized address to
+  // start from the beginning), and on output it is the first block used after
+  // all the blocks of that record. Returns false when there are no more used
+  // blocks.
+  bool NextUsedBlock(FileType block_type, Addr* address);
+
  private:
   // Set force to true to overwrite the file if it exists.
   bool CreateBlockFile(int index, FileType file_type, bool force);
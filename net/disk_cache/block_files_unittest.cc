@@ -75,6 +75,103 @@ TEST_F(DiskCacheTest, BlockFiles_Shrink) {
   EXPECT_EQ(4, NumberOfFiles(cache_path_));
 }
 
+// We should be able to walk all the used blocks of a chain of files.
+TEST_F(DiskCacheTest, BlockFiles_NextUsedBlock) {
+  ASSERT_TRUE(CleanupCacheDir());
+  ASSERT_TRUE(file_util::CreateDirectory(cache_path_));
+
+  BlockFiles files(cache_path_);
+  ASSERT_TRUE(files.Init(true));
+
+  Addr address;
+  EXPECT_FALSE(files.NextUsedBlock(RANKINGS, &address));
+
+  const int kMaxSize = 35000;
+  Addr entries[kMaxSize];
+
+  // Use three files, and leave every other record unused.
+  for (int i = 0; i < kMaxSize; i++) {
+    EXPECT_TRUE(files.CreateBlock(RANKINGS, 4, &entries[i]));
+  }
+  for (int i = 0; i < kMaxSize; i += 2) {
+    files.DeleteBlock(entries[i], false);
+  }
+  EXPECT_EQ(6, NumberOfFiles(cache_path_));
+
+  int num_blocks = 0;
+  int num_files = 0;
+  int file = -1;
+  while (files.NextUsedBlock(RANKINGS, &address)) {
+    EXPECT_EQ(1, address.num_blocks());
+    if (address.FileNumber() != file) {
+      file = address.FileNumber();
+      num_files++;
+    }
+    num_blocks++;
+  }
+  EXPECT_EQ(kMaxSize / 2 * 4, num_blocks);
+  EXPECT_EQ(3, num_files);
+
+  // Skipping a whole record.
+  Addr record(RANKINGS, 4, entries[1].FileNumber(), entries[1].start_block());
+  ASSERT_TRUE(files.NextUsedBlock(RANKINGS, &record));
+  EXPECT_EQ(entries[3].start_block(), record.start_block());
+}
+
+// Deleting a set of blocks at once should clear their contents and free them.
+TEST_F(DiskCacheTest, BlockFiles_DeleteBlocks) {
+  ASSERT_TRUE(CleanupCacheDir());
+  ASSERT_TRUE(file_util::CreateDirectory(cache_path_));
+
+  BlockFiles files(cache_path_);
+  ASSERT_TRUE(files.Init(true));
+
+  const int kNumEntries = 40;
+  const int kBlockSize = 256;
+  Addr address[kNumEntries];
+  char buffer[kBlockSize * 2];
+  memset(buffer, 'a', sizeof(buffer));
+  for (int i = 0; i < kNumEntries; i++) {
+    EXPECT_TRUE(files.CreateBlock(BLOCK_256, 1 + i % 2, &address[i]));
+    MappedFile* file = files.GetFile(address[i]);
+    ASSERT_TRUE(NULL != file);
+    EXPECT_TRUE(file->Write(buffer, kBlockSize * address[i].num_blocks(),
+                            address[i].start_block() * kBlockSize +
+                                kBlockHeaderSize));
+  }
+
+  BlockFileHeader* header =
+      reinterpret_cast<BlockFileHeader*>(files.GetFile(address[0])->buffer());
+  EXPECT_EQ(kNumEntries, header->num_entries);
+
+  // Delete all but the last entry, in no particular order.
+  std::vector<CacheAddr> deleted;
+  for (int i = kNumEntries - 2; i >= 0; i -= 2)
+    deleted.push_back(address[i].value());
+  for (int i = 1; i < kNumEntries - 1; i += 2)
+    deleted.push_back(address[i].value());
+  files.DeleteBlocks(deleted);
+  EXPECT_EQ(1, header->num_entries);
+
+  for (int i = 0; i < kNumEntries; i++) {
+    MappedFile* file = files.GetFile(address[i]);
+    ASSERT_TRUE(NULL != file);
+    char data[kBlockSize * 2];
+    size_t size = kBlockSize * address[i].num_blocks();
+    EXPECT_TRUE(file->Read(data, size, address[i].start_block() * kBlockSize +
+                                           kBlockHeaderSize));
+    char expected = (i == kNumEntries - 1) ? 'a' : 0;
+    for (size_t j = 0; j < size; j++)
+      ASSERT_EQ(expected, data[j]);
+  }
+
+  // The space is available again.
+  Addr new_address;
+  EXPECT_TRUE(files.CreateBlock(BLOCK_256, 2, &new_address));
+  EXPECT_LT(new_address.start_block(),
+            address[kNumEntries - 1].start_block());
+}
+
 // Handling of block files not properly closed.
 TEST_F(DiskCacheTest, BlockFiles_Recover) {
   ASSERT_TRUE(CleanupCacheDir());
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
@@ -138,6 +139,61 @@ bool TimeRead(int num_entries, disk_cache::Backend* cache,
   return (expected == helper.callbacks_called());
 }
 
+// Keeps reads and writes in flight for every entry listed on |entries| at the
+// same time, each entry with a write to the first half of its data and a read
+// of the second half. Entries are opened (and left open) by this function.
+bool TimeMixedIO(disk_cache::Backend* cache, const TestEntries& entries,
+                 int data_len) {
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(data_len));
+  CacheTestFillBuffer(buffer->data(), data_len, false);
+  std::vector<scoped_refptr<net::IOBuffer> > read_buffers;
+  std::vector<disk_cache::Entry*> cache_entries;
+
+  int expected = 0;
+  int half = data_len / 2;
+
+  MessageLoopHelper helper;
+  CallbackTest callback(&helper, true);
+
+  PerfTimeLogger timer("Concurrent read and write of disk cache entries");
+
+  bool ok = true;
+  for (size_t i = 0; i < entries.size() && ok; i++) {
+    disk_cache::Entry* cache_entry;
+    net::TestCompletionCallback cb;
+    int rv = cache->OpenEntry(entries[i].key, &cache_entry, cb.callback());
+    if (net::OK != cb.GetResult(rv))
+      break;
+    cache_entries.push_back(cache_entry);
+
+    int ret = cache_entry->WriteData(
+        1, 0, buffer, half,
+        base::Bind(&CallbackTest::Run, base::Unretained(&callback)), false);
+    if (net::ERR_IO_PENDING == ret)
+      expected++;
+    else if (half != ret)
+      ok = false;
+
+    read_buffers.push_back(new net::IOBuffer(half));
+    ret = cache_entry->ReadData(
+        1, half, read_buffers.back(), half,
+        base::Bind(&CallbackTest::Run, base::Unretained(&callback)));
+    if (net::ERR_IO_PENDING == ret)
+      expected++;
+    else if (half != ret)
+      ok = false;
+  }
+
+  helper.WaitUntilCacheIoFinished(expected);
+  timer.Done();
+
+  for (size_t i = 0; i < cache_entries.size(); i++)
+    cache_entries[i]->Close();
+
+  return ok && cache_entries.size() == entries.size() &&
+         expected == helper.callbacks_called();
+}
+
 int BlockSize() {
   // We can use form 1 to 4 blocks.
   return (rand() & 0x3) + 1;
@@ -206,6 +262,48 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   delete cache;
 }
 
+// Measures entry IO when lots of it is in flight at the same time, as it is
+// when a page loads many resources from the cache. The data is stored on
+// external files, so the IO is done by the worker pool.
+TEST_F(DiskCacheTest, CacheBackendConcurrentIOPerformance) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+
+  ASSERT_TRUE(CleanupCacheDir());
+  net::TestCompletionCallback cb;
+  disk_cache::Backend* cache;
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, cache_path_, 0, false,
+      cache_thread.message_loop_proxy(), NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+  const int kNumEntries = 200;
+  const int kDataSize = 64 * 1024;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kDataSize));
+  CacheTestFillBuffer(buffer->data(), kDataSize, false);
+
+  TestEntries entries;
+  for (int i = 0; i < kNumEntries; i++) {
+    TestEntry entry;
+    entry.key = GenerateKey(true);
+    entry.data_len = kDataSize;
+    entries.push_back(entry);
+
+    disk_cache::Entry* cache_entry;
+    rv = cache->CreateEntry(entry.key, &cache_entry, cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    rv = cache_entry->WriteData(1, 0, buffer, kDataSize, cb.callback(), false);
+    EXPECT_EQ(kDataSize, cb.GetResult(rv));
+    cache_entry->Close();
+  }
+
+  EXPECT_TRUE(TimeMixedIO(cache, entries, kDataSize));
+
+  MessageLoop::current()->RunAllPending();
+  delete cache;
+}
+
 // Creating and deleting "entries" on a block-file is something quite frequent
 // (after all, almost everything is stored on block files). The operation is
 // almost free when the file is empty, but can be expensive if the file gets
@@ -79,6 +79,14 @@ void SyncCallback::Discard() {
 
 const int kMaxBufferSize = 1024 * 1024;  // 1 MB.
 
+// Limits for the data read ahead of a sequential reader. The window doubles
+// on every read from disk, as long as the stream is read in order.
+const int kMinReadAhead = 64 * 1024;
+const int kMaxReadAhead = 512 * 1024;
+
+// Reads in order needed before we start to read ahead.
+const int kMinSequentialReads = 2;
+
 }  // namespace
 
 namespace disk_cache {
@@ -291,10 +299,136 @@ bool EntryImpl::UserBuffer::GrowBuffer(int required, int limit) {
 
 // ------------------------------------------------------------------------
 
+// This class keeps the data read ahead of a sequential reader of a stream
+// stored on an external file, so that the data can be read from disk with a
+// few large reads instead of many small ones. The memory used counts against
+// the same limit as the buffers of UserBuffer.
+class EntryImpl::ReadAhead {
+ public:
+  explicit ReadAhead(BackendImpl* backend)
+      : backend_(backend->GetWeakPtr()), offset_(0), length_(0),
+        size_(0), next_offset_(0), sequential_reads_(0),
+        window_(kMinReadAhead), pending_(false) {}
+  ~ReadAhead() {
+    ReleaseBuffer();
+  }
+
+  // Records a read of |len| bytes at |offset|. Returns true if the reader
+  // seems to be going through the stream in order.
+  bool OnRead(int offset, int len);
+
+  // Marks |offset| as the place where a sequential reader will continue.
+  void ExpectRead(int offset);
+
+  // Copies up to |len| bytes at |offset| to |buf|, if they are available.
+  // Returns the number of bytes copied, or -1 if the data is not buffered.
+  int Read(int offset, IOBuffer* buf, int len);
+
+  // Returns a buffer to read ahead |len| bytes or more, ending before |eof|,
+  // or NULL if we should read just what was requested. |len| is updated with
+  // the size to read.
+  IOBuffer* StartRead(int offset, int eof, int* len);
+
+  // Stores the result of a read into |buffer| started with StartRead(),
+  // unless the data was invalidated since then.
+  void OnReadComplete(IOBuffer* buffer, int result);
+
+  // Discards the buffered data, because the stream is being modified.
+  void Invalidate();
+
+ private:
+  void ReleaseBuffer();
+
+  base::WeakPtr<BackendImpl> backend_;
+  scoped_refptr<IOBuffer> buffer_;
+  int offset_;  // Stream offset of |buffer_|.
+  int length_;  // Bytes stored on |buffer_|.
+  int size_;  // Bytes allocated for |buffer_|.
+  int next_offset_;  // Where the next read in order should start.
+  int sequential_reads_;  // Reads in order so far.
+  int window_;  // Bytes to read ahead next time.
+  bool pending_;  // True while we are reading ahead.
+  DISALLOW_COPY_AND_ASSIGN(ReadAhead);
+};
+
+bool EntryImpl::ReadAhead::OnRead(int offset, int len) {
+  if (offset == next_offset_) {
+    sequential_reads_++;
+  } else {
+    sequential_reads_ = 1;
+    window_ = kMinReadAhead;
+  }
+  next_offset_ = offset + len;
+  return sequential_reads_ >= kMinSequentialReads;
+}
+
+void EntryImpl::ReadAhead::ExpectRead(int offset) {
+  if (offset != next_offset_)
+    sequential_reads_ = 0;
+  next_offset_ = offset;
+  sequential_reads_ = std::max(sequential_reads_, kMinSequentialReads - 1);
+}
+
+int EntryImpl::ReadAhead::Read(int offset, IOBuffer* buf, int len) {
+  if (!length_ || offset < offset_ || offset >= offset_ + length_)
+    return -1;
+
+  len = std::min(len, offset_ + length_ - offset);
+  memcpy(buf->data(), buffer_->data() + offset - offset_, len);
+  return len;
+}
+
+net::IOBuffer* EntryImpl::ReadAhead::StartRead(int offset, int eof, int* len) {
+  if (pending_ || !backend_)
+    return NULL;
+
+  int size = std::min(std::max(window_, *len), eof - offset);
+  if (size <= *len)
+    return NULL;
+
+  ReleaseBuffer();
+  if (!backend_->IsAllocAllowed(0, size))
+    return NULL;
+
+  buffer_ = new IOBuffer(size);
+  size_ = size;
+  offset_ = offset;
+  window_ = std::min(window_ * 2, kMaxReadAhead);
+  pending_ = true;
+  *len = size;
+  return buffer_;
+}
+
+void EntryImpl::ReadAhead::OnReadComplete(IOBuffer* buffer, int result) {
+  if (buffer != buffer_.get())
+    return;
+
+  pending_ = false;
+  if (result <= 0)
+    return ReleaseBuffer();
+
+  length_ = result;
+}
+
+void EntryImpl::ReadAhead::Invalidate() {
+  pending_ = false;
+  ReleaseBuffer();
+}
+
+void EntryImpl::ReadAhead::ReleaseBuffer() {
+  if (size_ && backend_)
+    backend_->BufferDeleted(size_);
+  buffer_ = NULL;
+  size_ = 0;
+  length_ = 0;
+}
+
+// ------------------------------------------------------------------------
+
 EntryImpl::EntryImpl(BackendImpl* backend, Addr address, bool read_only)
     : entry_(NULL, Addr(0)), node_(NULL, Addr(0)),
-      backend_(backend->GetWeakPtr()), doomed_(false), read_only_(read_only),
-      dirty_(false) {
+      backend_(backend->GetWeakPtr()), hot_reads_(0), doomed_(false),
+      read_only_(read_only), dirty_(false) {
   entry_.LazyInit(backend->File(address), address);
   for (int i = 0; i < kNumStreams; i++) {
     unreported_size_[i] = 0;
@@ -824,6 +958,13 @@ int EntryImpl::ReadData(int index, int offset, IOBuffer* buf, int buf_len,
   if (!background_queue_)
     return net::ERR_UNEXPECTED;
 
+  int rv = background_queue_->hot_entries()->ReadData(this, index, offset, buf,
+                                                      buf_len);
+  if (rv >= 0) {
+    hot_reads_++;
+    return rv;
+  }
+
   background_queue_->ReadData(this, index, offset, buf, buf_len, callback);
   return net::ERR_IO_PENDING;
 }
@@ -935,6 +1076,11 @@ EntryImpl::~EntryImpl() {
     SanityCheck();
 #endif
     net_log_.AddEvent(net::NetLog::TYPE_ENTRY_CLOSE, NULL);
+
+    // Reads served from memory did not update the rankings.
+    if (hot_reads_)
+      UpdateRank(false);
+
     bool ret = true;
     for (int index = 0; index < kNumStreams; index++) {
       if (user_buffers_[index].get()) {
@@ -1017,6 +1163,17 @@ int EntryImpl::InternalReadData(int index, int offset,
     return net::ERR_FAILED;
   }
 
+  if (address.is_separate_file() && !user_buffers_[index].get()) {
+    int rv;
+    if (ReadThroughReadAhead(index, offset, buf, buf_len, file, callback,
+                             &rv)) {
+      if (rv == net::ERR_FAILED)
+        DoomImpl();
+      ReportIOTime(kRead, start);
+      return rv;
+    }
+  }
+
   size_t file_offset = offset;
   if (address.is_block_file()) {
     DCHECK_LE(offset + buf_len, kMaxBlockSize);
@@ -1050,6 +1207,86 @@ int EntryImpl::InternalReadData(int index, int offset,
   return (completed || callback.is_null()) ? buf_len : net::ERR_IO_PENDING;
 }
 
+bool EntryImpl::ReadThroughReadAhead(int index, int offset, IOBuffer* buf,
+                                     int buf_len, File* file,
+                                     const CompletionCallback& callback,
+                                     int* result) {
+  if (!read_ahead_[index].get())
+    read_ahead_[index].reset(new ReadAhead(backend_));
+
+  ReadAhead* read_ahead = read_ahead_[index].get();
+  bool sequential = read_ahead->OnRead(offset, buf_len);
+  *result = read_ahead->Read(offset, buf, buf_len);
+  if (*result >= 0)
+    return true;
+
+  if (!sequential)
+    return false;
+
+  int len = buf_len;
+  scoped_refptr<IOBuffer> read_ahead_buf = read_ahead->StartRead(
+      offset, entry_.Data()->data_size[index], &len);
+  if (!read_ahead_buf)
+    return false;
+
+  SyncCallback* io_callback = NULL;
+  if (!callback.is_null()) {
+    io_callback = new SyncCallback(
+        this, read_ahead_buf,
+        base::Bind(&EntryImpl::OnReadAheadCompleted, this, index,
+                   read_ahead_buf, make_scoped_refptr(buf), buf_len,
+                   callback),
+        net::NetLog::TYPE_ENTRY_READ_DATA);
+  }
+
+  bool completed;
+  if (!file->Read(read_ahead_buf->data(), len, offset, io_callback,
+                  &completed)) {
+    if (io_callback)
+      io_callback->Discard();
+    read_ahead->OnReadComplete(read_ahead_buf, net::ERR_FAILED);
+    *result = net::ERR_FAILED;
+    return true;
+  }
+
+  if (io_callback && completed)
+    io_callback->Discard();
+
+  if (!completed) {
+    *result = net::ERR_IO_PENDING;
+    return true;
+  }
+
+  read_ahead->OnReadComplete(read_ahead_buf, len);
+  *result = std::min(len, buf_len);
+  memcpy(buf->data(), read_ahead_buf->data(), *result);
+  return true;
+}
+
+void EntryImpl::OnReadAheadCompleted(int index,
+                                     scoped_refptr<IOBuffer> read_ahead_buf,
+                                     scoped_refptr<IOBuffer> buf, int buf_len,
+                                     const CompletionCallback& callback,
+                                     int result) {
+  if (read_ahead_[index].get())
+    read_ahead_[index]->OnReadComplete(read_ahead_buf, result);
+
+  if (result > 0) {
+    result = std::min(result, buf_len);
+    memcpy(buf->data(), read_ahead_buf->data(), result);
+  }
+  callback.Run(result);
+}
+
+void EntryImpl::ExpectSequentialRead(int index, int offset) {
+  if (!backend_)
+    return;
+
+  if (!read_ahead_[index].get())
+    read_ahead_[index].reset(new ReadAhead(backend_));
+  read_ahead_[index]->ExpectRead(offset);
+}
+
 int EntryImpl::InternalWriteData(int index, int offset,
                                  IOBuffer* buf, int buf_len,
                                  const CompletionCallback& callback,
@@ -1083,6 +1320,9 @@ int EntryImpl::InternalWriteData(int index, int offset,
   int entry_size = entry_.Data()->data_size[index];
   bool extending = entry_size < offset + buf_len;
   truncate = truncate && entry_size > offset + buf_len;
+  if (read_ahead_[index].get())
+    read_ahead_[index]->Invalidate();
+
   Trace("To PrepareTarget 0x%x", entry_.address().value());
   if (!PrepareTarget(index, offset, buf_len, truncate))
     return net::ERR_FAILED;
@@ -171,6 +171,7 @@ class NET_EXPORT_PRIVATE EntryImpl
      kNumStreams = 3
   };
   class UserBuffer;
+  class ReadAhead;
 
   virtual ~EntryImpl();
 
@@ -181,6 +182,23 @@ class NET_EXPORT_PRIVATE EntryImpl
   int InternalWriteData(int index, int offset, IOBuffer* buf, int buf_len,
                         const CompletionCallback& callback, bool truncate);
 
+  // Reads from the external |file| of a stream through the data read ahead of
+  // a sequential reader. Returns false if the read should go directly to the
+  // file instead, or true with the result of the operation in |result|.
+  bool ReadThroughReadAhead(int index, int offset, IOBuffer* buf, int buf_len,
+                            File* file, const CompletionCallback& callback,
+                            int* result);
+
+  // Completes an asynchronous read started by ReadThroughReadAhead().
+  void OnReadAheadCompleted(int index, scoped_refptr<IOBuffer> read_ahead_buf,
+                            scoped_refptr<IOBuffer> buf, int buf_len,
+                            const CompletionCallback& callback, int result);
+
+  // Tells the read-ahead logic of a stream that a sequential reader will
+  // continue at |offset|. Used by SparseControl when a read in order moves
+  // from one child entry to the next one.
+  void ExpectSequentialRead(int index, int offset);
+
   // Initializes the storage for an internal or external data block.
   bool CreateDataBlock(int index, int size);
 
@@ -257,10 +275,12 @@ class NET_EXPORT_PRIVATE EntryImpl
   base::WeakPtr<BackendImpl> backend_;  // Back pointer to the cache.
   base::WeakPtr<InFlightBackendIO> background_queue_;  // In-progress queue.
   scoped_ptr<UserBuffer> user_buffers_[kNumStreams];  // Stores user data.
+  scoped_ptr<ReadAhead> read_ahead_[kNumStreams];  // For sequential readers.
   // Files to store external user data and key.
   scoped_refptr<File> files_[kNumStreams + 1];
   mutable std::string key_;           // Copy of the key.
   int unreported_size_[kNumStreams];  // Bytes not reported yet to the backend.
+  int hot_reads_;             // Reads served by the HotEntryCache.
   bool doomed_;               // True if this entry was removed from the cache.
   bool read_only_;            // True if not yet writing.
   bool dirty_;                // True if we detected that this is a dirty entry.
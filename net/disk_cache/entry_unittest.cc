@@ -510,6 +510,156 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyExternalAsyncIO) {
   ExternalAsyncIO();
 }
 
+// Tests that small reads in order from an external file return the right
+// data while the entry reads ahead of them, also after the stream changes.
+TEST_F(DiskCacheEntryTest, ExternalSequentialRead) {
+  InitCache();
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
+
+  const int kSize = 200000;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer1->data(), kSize, false);
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer1, kSize, false));
+  entry->Close();
+  ASSERT_EQ(net::OK, OpenEntry("the first key", &entry));
+
+  const int kReadSize = 8192;
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kReadSize));
+  for (int offset = 0; offset < kSize; offset += kReadSize) {
+    int expected = std::min(kReadSize, kSize - offset);
+    ASSERT_EQ(expected, ReadData(entry, 1, offset, buffer2, kReadSize));
+    ASSERT_EQ(0, memcmp(buffer1->data() + offset, buffer2->data(), expected));
+
+    if (offset == kReadSize * 4) {
+      // Change the data that was already read ahead.
+      int target = offset + kReadSize * 2;
+      memset(buffer1->data() + target, 'x', kReadSize);
+      scoped_refptr<net::WrappedIOBuffer> new_data(
+          new net::WrappedIOBuffer(buffer1->data() + target));
+      EXPECT_EQ(kReadSize,
+                WriteData(entry, 1, target, new_data, kReadSize, false));
+    }
+  }
+
+  // Going back to the start is not a problem.
+  ASSERT_EQ(kReadSize, ReadData(entry, 1, 0, buffer2, kReadSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kReadSize));
+  entry->Close();
+}
+
+// Returns the value of the stat |name| of |cache|.
+static std::string GetCacheStat(disk_cache::Backend* cache,
+                                const std::string& name) {
+  std::vector<std::pair<std::string, std::string> > stats;
+  cache->GetStats(&stats);
+  for (size_t i = 0; i < stats.size(); i++) {
+    if (stats[i].first == name)
+      return stats[i].second;
+  }
+  return std::string();
+}
+
+// Tests that small entries are read from memory once they are read from disk,
+// and that the copy is discarded when the entry changes.
+TEST_F(DiskCacheEntryTest, HotEntries) {
+  InitCache();
+  cache_impl_->SetHotEntriesSize(1024 * 1024);
+
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
+
+  const int kSize = 2000;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer1->data(), kSize, false);
+  EXPECT_EQ(kSize, WriteData(entry, 0, 0, buffer1, kSize, false));
+  entry->Close();
+
+  ASSERT_EQ(net::OK, OpenEntry("the first key", &entry));
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer2, kSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize));
+  EXPECT_EQ("0", GetCacheStat(cache_, "Saved thread hops"));
+
+  // Now the data comes from memory, synchronously.
+  memset(buffer2->data(), 0, kSize);
+  net::TestCompletionCallback cb;
+  EXPECT_EQ(100, entry->ReadData(0, 50, buffer2, 100, cb.callback()));
+  EXPECT_EQ(0, memcmp(buffer1->data() + 50, buffer2->data(), 100));
+  EXPECT_EQ("1", GetCacheStat(cache_, "Saved thread hops"));
+  EXPECT_EQ("1", GetCacheStat(cache_, "Hot entries"));
+
+  // Writing to the entry discards the copy.
+  memset(buffer1->data(), 'x', kSize);
+  EXPECT_EQ(kSize, WriteData(entry, 0, 0, buffer1, kSize, false));
+  EXPECT_EQ("0", GetCacheStat(cache_, "Hot entries"));
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer2, kSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize));
+  entry->Close();
+
+  // And so does dooming it.
+  EXPECT_EQ("1", GetCacheStat(cache_, "Hot entries"));
+  EXPECT_EQ(net::OK, DoomEntry("the first key"));
+  EXPECT_EQ("0", GetCacheStat(cache_, "Hot entries"));
+}
+
+// Tests that pipelined IO to the same part of an external file is performed in
+// the order it was issued.
+TEST_F(DiskCacheEntryTest, ExternalAsyncIOOrdering) {
+  SetDirectMode();
+  InitCache();
+  cache_impl_->SetFlags(disk_cache::kNoBuffering);
+
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
+
+  MessageLoopHelper helper;
+  CallbackTest callback1(&helper, false);
+  CallbackTest callback2(&helper, false);
+  CallbackTest callback3(&helper, false);
+
+  const int kSize = 50000;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> buffer3(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer1->data(), kSize, false);
+  CacheTestFillBuffer(buffer2->data(), kSize, false);
+  memset(buffer3->data(), 0, kSize);
+
+  // Issue everything without waiting.
+  int expected = 0;
+  int ret = entry->WriteData(
+      1, 0, buffer1, kSize,
+      base::Bind(&CallbackTest::Run, base::Unretained(&callback1)), false);
+  EXPECT_TRUE(kSize == ret || net::ERR_IO_PENDING == ret);
+  if (net::ERR_IO_PENDING == ret)
+    expected++;
+  ret = entry->WriteData(
+      1, 10, buffer2, kSize - 10,
+      base::Bind(&CallbackTest::Run, base::Unretained(&callback2)), false);
+  EXPECT_TRUE(kSize - 10 == ret || net::ERR_IO_PENDING == ret);
+  if (net::ERR_IO_PENDING == ret)
+    expected++;
+  ret = entry->ReadData(
+      1, 0, buffer3, kSize,
+      base::Bind(&CallbackTest::Run, base::Unretained(&callback3)));
+  EXPECT_TRUE(kSize == ret || net::ERR_IO_PENDING == ret);
+  if (net::ERR_IO_PENDING == ret)
+    expected++;
+
+  EXPECT_TRUE(helper.WaitUntilCacheIoFinished(expected));
+  // The read sees the first ten bytes of the first write, followed by all of
+  // the second write.
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer3->data(), 10));
+  EXPECT_EQ(0, memcmp(buffer2->data(), buffer3->data() + 10, kSize - 10));
+  EXPECT_FALSE(helper.callback_reused_error());
+
+  entry->Doom();
+  entry->Close();
+  FlushQueueForTest();
+  EXPECT_EQ(0, cache_->GetEntryCount());
+}
+
 void DiskCacheEntryTest::StreamAccess() {
   disk_cache::Entry* entry = NULL;
   ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
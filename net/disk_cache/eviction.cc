@@ -49,6 +49,7 @@ const int kCleanUpMargin = 1024 * 1024;
 const int kHighUse = 10;  // Reuse count to be on the HIGH_USE list.
 const int kTargetTime = 24 * 7;  // Time to be evicted (hours since last use).
 const int kMaxDelayedTrims = 60;
+const int kTrimBatchDelayMs = 20;  // Pause between batches of evictions.
 
 int LowWaterAdjust(int high_water) {
   if (high_water < kCleanUpMargin)
@@ -84,6 +85,9 @@ void Eviction::Init(BackendImpl* backend) {
   first_trim_ = true;
   trimming_ = false;
   delay_trim_ = false;
+  trim_pending_ = false;
+  trim_requests_ = 0;
+  trim_start_ = TimeTicks();
   trim_delays_ = 0;
   init_ = true;
   test_mode_ = false;
@@ -106,12 +110,71 @@ void Eviction::TrimCache(bool empty) {
   if (backend_->disabled_ || trimming_)
     return;
 
+  if (!empty && !test_mode_ && !trim_start_.is_null()) {
+    // The trim job is already running.
+    trim_requests_++;
+    return;
+  }
+
   if (!empty && !ShouldTrim())
     return PostDelayedTrim();
 
+  if (!empty && !test_mode_)
+    return StartTrimJob();
+
   if (new_eviction_)
     return TrimCacheV2(empty);
 
+  TrimCacheV1(empty);
+}
+void Eviction::StartTrimJob() {
+  Trace("*** Trim Job start ***");
+  trim_start_ = TimeTicks::Now();
+  trim_requests_ = 0;
+  trim_pending_ = true;
+  MessageLoop::current()->PostTask(FROM_HERE, base::Bind(
+      &Eviction::TrimBatch, ptr_factory_.GetWeakPtr()));
+}
+
+void Eviction::PostTrimBatch() {
+  // Give way to other work between batches, unless we are already above the
+  // hard limit of the cache.
+  int delay_ms = header_->num_bytes > backend_->max_size_ ? 0 :
+                 kTrimBatchDelayMs;
+  trim_pending_ = true;
+  MessageLoop::current()->PostDelayedTask(FROM_HERE, base::Bind(
+      &Eviction::TrimBatch, ptr_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(delay_ms));
+}
+
+void Eviction::TrimBatch() {
+  trim_pending_ = false;
+  if (backend_->disabled_) {
+    trim_start_ = TimeTicks();
+    return;
+  }
+
+  if (new_eviction_)
+    return TrimCacheV2(false);
+
+  TrimCacheV1(false);
+}
+
+void Eviction::EndTrimBatch(bool empty) {
+  if (empty || trim_pending_ || trim_start_.is_null())
+    return;
+
+  CACHE_UMA(AGE_MS, "TrimJobTime", 0, trim_start_);
+  if (new_eviction_) {
+    CACHE_UMA(COUNTS, "TrimBlockedRequestsV2", 0, trim_requests_);
+  } else {
+    CACHE_UMA(COUNTS, "TrimBlockedRequestsV1", 0, trim_requests_);
+  }
+  trim_start_ = TimeTicks();
+  Trace("*** Trim Job end ***");
+}
+
+void Eviction::TrimCacheV1(bool empty) {
   Trace("*** Trim Cache ***");
   trimming_ = true;
   TimeTicks start = TimeTicks::Now();
@@ -120,6 +183,7 @@ void Eviction::TrimCache(bool empty) {
       rankings_, rankings_->GetPrev(node.get(), Rankings::NO_USE));
   int deleted_entries = 0;
   int target_size = empty ? 0 : max_size_;
+  backend_->BeginDeleteBatch();
   while ((header_->num_bytes > target_size || test_mode_) && next.get()) {
     // The iterator could be invalidated within EvictEntry().
     if (!next->HasData())
@@ -138,11 +202,11 @@ void Eviction::TrimCache(bool empty) {
     }
     if (!empty && (deleted_entries > 20 ||
                    (TimeTicks::Now() - start).InMilliseconds() > 20)) {
-      MessageLoop::current()->PostTask(FROM_HERE, base::Bind(
-          &Eviction::TrimCache, ptr_factory_.GetWeakPtr(), false));
+      PostTrimBatch();
       break;
     }
   }
+  backend_->EndDeleteBatch();
 
   if (empty) {
     CACHE_UMA(AGE_MS, "TotalClearTimeV1", 0, start);
@@ -150,6 +214,7 @@ void Eviction::TrimCache(bool empty) {
     CACHE_UMA(AGE_MS, "TotalTrimTimeV1", 0, start);
   }
   CACHE_UMA(COUNTS, "TrimItemsV1", 0, deleted_entries);
+  EndTrimBatch(empty);
 
   trimming_ = false;
   Trace("*** Trim Cache end ***");
@@ -190,6 +255,20 @@ void Eviction::OnDestroyEntry(EntryImpl* entry) {
     return OnDestroyEntryV2(entry);
 }
 
+void Eviction::OnRecoverEntry(EntryImpl* entry) {
+  Rankings::List list = GetListForEntry(entry);
+  if (new_eviction_) {
+    list = entry->entry()->Data()->state == ENTRY_EVICTED ?
+           Rankings::DELETED : GetListForEntryV2(entry);
+  }
+
+  CacheRankingsBlock* node = entry->rankings();
+  int64 last_used = node->Data()->last_used;
+  rankings_->Insert(node, false, list);
+  node->Data()->last_used = last_used;
+  node->Store();
+}
+
 void Eviction::SetTestMode() {
   test_mode_ = true;
 }
@@ -334,6 +413,7 @@ void Eviction::TrimCacheV2(bool empty) {
   int deleted_entries = 0;
   int target_size = empty ? 0 : max_size_;
 
+  backend_->BeginDeleteBatch();
   for (; list < kListsToSearch; list++) {
     while ((header_->num_bytes > target_size || test_mode_) &&
            next[list].get()) {
@@ -355,14 +435,14 @@ void Eviction::TrimCacheV2(bool empty) {
       }
       if (!empty && (deleted_entries > 20 ||
                      (TimeTicks::Now() - start).InMilliseconds() > 20)) {
-        MessageLoop::current()->PostTask(FROM_HERE, base::Bind(
-            &Eviction::TrimCache, ptr_factory_.GetWeakPtr(), false));
+        PostTrimBatch();
         break;
       }
     }
     if (!empty)
       list = kListsToSearch;
   }
+  backend_->EndDeleteBatch();
 
   if (empty) {
     TrimDeleted(true);
@@ -377,6 +457,7 @@ void Eviction::TrimCacheV2(bool empty) {
     CACHE_UMA(AGE_MS, "TotalTrimTimeV2", 0, start);
   }
   CACHE_UMA(COUNTS, "TrimItemsV2", 0, deleted_entries);
+  EndTrimBatch(empty);
 
   Trace("*** Trim Cache end ***");
   trimming_ = false;
@@ -487,6 +568,7 @@ void Eviction::TrimDeleted(bool empty) {
   Rankings::ScopedRankingsBlock next(
     rankings_, rankings_->GetPrev(node.get(), Rankings::DELETED));
   int deleted_entries = 0;
+  backend_->BeginDeleteBatch();
   while (next.get() &&
          (empty || (deleted_entries < 20 &&
                     (TimeTicks::Now() - start).InMilliseconds() < 20))) {
@@ -497,6 +579,7 @@ void Eviction::TrimDeleted(bool empty) {
     if (test_mode_)
       break;
   }
+  backend_->EndDeleteBatch();
 
   if (deleted_entries && !empty && ShouldTrimDeleted()) {
     MessageLoop::current()->PostTask(FROM_HERE,
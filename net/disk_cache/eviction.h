@@ -8,6 +8,7 @@
 
 #include "base/basictypes.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time.h"
 #include "net/disk_cache/disk_format.h"
 #include "net/disk_cache/rankings.h"
 
@@ -28,7 +29,7 @@ class Eviction {
 
   // Deletes entries from the cache until the current size is below the limit.
   // If empty is true, the whole cache will be trimmed, regardless of being in
-  // use.
+  // use. Otherwise the entries are evicted by a background job, in batches.
   void TrimCache(bool empty);
 
   // Updates the ranking information for an entry.
@@ -40,6 +41,10 @@ class Eviction {
   void OnDoomEntry(EntryImpl* entry);
   void OnDestroyEntry(EntryImpl* entry);
 
+  // Links back an entry found while rebuilding the index, keeping the time it
+  // was last used.
+  void OnRecoverEntry(EntryImpl* entry);
+
   // Testing interface.
   void SetTestMode();
   void TrimDeletedList(bool empty);
@@ -47,6 +52,14 @@ class Eviction {
  private:
   void PostDelayedTrim();
   void DelayedTrim();
+
+  // The background trim job evicts a batch of entries per task, and yields to
+  // other work between batches.
+  void StartTrimJob();
+  void PostTrimBatch();
+  void TrimBatch();
+  void EndTrimBatch(bool empty);
+  void TrimCacheV1(bool empty);
   bool ShouldTrim();
   bool ShouldTrimDeleted();
   void ReportTrimTimes(EntryImpl* entry);
@@ -80,6 +93,9 @@ class Eviction {
   bool first_trim_;
   bool trimming_;
   bool delay_trim_;
+  bool trim_pending_;  // True if a batch of the trim job is posted.
+  int trim_requests_;  // Requests to trim made while the job is running.
+  base::TimeTicks trim_start_;  // When the current trim job started.
   bool init_;
   bool test_mode_;
   base::WeakPtrFactory<Eviction> ptr_factory_;
@@ -6,9 +6,14 @@
 
 #include <fcntl.h>
 
+#include <map>
+#include <vector>
+
 #include "base/bind.h"
+#include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/worker_pool.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/disk_cache.h"
@@ -16,8 +21,21 @@
 
 namespace {
 
+// Protects the ordering state of all FileBackgroundIO objects. It is global
+// (instead of being part of the controller) because worker threads may still
+// be using it after the controller is gone (see DropPendingIO).
+base::LazyInstance<base::Lock>::Leaky g_ordering_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
 // This class represents a single asynchronous IO operation while it is being
 // bounced between threads.
+//
+// Operations on different files, or on different parts of the same file, run
+// in parallel on the worker pool. However, an operation that touches bytes
+// that an earlier one (still in flight) also touches, and where at least one
+// of them is a write, waits until the earlier one is done. Each entry stream
+// has its own external file or blocks, so this keeps the IO for a given entry
+// in order without serializing IO for different entries.
 class FileBackgroundIO : public disk_cache::BackgroundIO {
  public:
   // Other than the actual parameters for the IO operation (including the
@@ -26,10 +44,12 @@ class FileBackgroundIO : public disk_cache::BackgroundIO {
   // (we do NOT invoke the callback), in the worker thead that completed the
   // operation.
   FileBackgroundIO(disk_cache::File* file, const void* buf, size_t buf_len,
-                   size_t offset, disk_cache::FileIOCallback* callback,
+                   size_t offset, bool is_write,
+                   disk_cache::FileIOCallback* callback,
                    disk_cache::InFlightIO* controller)
       : disk_cache::BackgroundIO(controller), callback_(callback), file_(file),
-        buf_(buf), buf_len_(buf_len), offset_(offset) {
+        buf_(buf), buf_len_(buf_len), offset_(offset), is_write_(is_write),
+        io_done_(false), pending_predecessors_(0) {
   }
 
   disk_cache::FileIOCallback* callback() {
@@ -48,15 +68,37 @@ class FileBackgroundIO : public disk_cache::BackgroundIO {
   void Read();
   void Write();
 
+  // Makes this operation wait for |predecessor| if they would conflict and
+  // |predecessor| is not done yet. Returns false if |predecessor| is done (so
+  // it no longer has to be tracked). Must be called with g_ordering_lock held.
+  bool WaitIfConflicting(FileBackgroundIO* predecessor);
+
+  // Posts the operation to the worker pool, unless it has to wait for earlier
+  // operations. Must be called with g_ordering_lock held.
+  void StartOrWait();
+
  private:
   ~FileBackgroundIO() {}
 
+  // Posts the actual IO to the worker pool.
+  void Start();
+
+  // Marks this operation as done and starts the operations waiting for it.
+  // Runs on a worker thread.
+  void ReleaseSuccessors();
+
   disk_cache::FileIOCallback* callback_;
 
   disk_cache::File* file_;
   const void* buf_;
   size_t buf_len_;
   size_t offset_;
+  bool is_write_;
+
+  // Ordering state, protected by g_ordering_lock.
+  bool io_done_;
+  int pending_predecessors_;
+  std::vector<scoped_refptr<FileBackgroundIO> > successors_;
 
   DISALLOW_COPY_AND_ASSIGN(FileBackgroundIO);
 };
@@ -85,6 +127,15 @@ class FileInFlightIO : public disk_cache::InFlightIO {
                                    bool cancel);
 
  private:
+  typedef std::multimap<disk_cache::File*, scoped_refptr<FileBackgroundIO> >
+      FileOperations;
+
+  // Starts |operation| once the conflicting operations on its file are done.
+  void PostOperation(FileBackgroundIO* operation);
+
+  // Operations that may still be running, by file. Only used on the IO thread.
+  FileOperations in_flight_;
+
   DISALLOW_COPY_AND_ASSIGN(FileInFlightIO);
 };
 
@@ -97,6 +148,7 @@ void FileBackgroundIO::Read() {
   } else {
     result_ = net::ERR_CACHE_READ_FAILURE;
   }
+  ReleaseSuccessors();
   NotifyController();
 }
 
@@ -105,19 +157,58 @@ void FileBackgroundIO::Write() {
   bool rv = file_->Write(buf_, buf_len_, offset_);
 
   result_ = rv ? static_cast<int>(buf_len_) : net::ERR_CACHE_WRITE_FAILURE;
+  ReleaseSuccessors();
   NotifyController();
 }
 
+bool FileBackgroundIO::WaitIfConflicting(FileBackgroundIO* predecessor) {
+  g_ordering_lock.Get().AssertAcquired();
+  if (predecessor->io_done_)
+    return false;
+
+  DCHECK_EQ(file_, predecessor->file_);
+  bool overlaps = offset_ < predecessor->offset_ + predecessor->buf_len_ &&
+                  predecessor->offset_ < offset_ + buf_len_;
+  if (overlaps && (is_write_ || predecessor->is_write_)) {
+    predecessor->successors_.push_back(make_scoped_refptr(this));
+    pending_predecessors_++;
+  }
+  return true;
+}
+
+void FileBackgroundIO::StartOrWait() {
+  g_ordering_lock.Get().AssertAcquired();
+  if (!pending_predecessors_)
+    Start();
+}
+
+void FileBackgroundIO::Start() {
+  base::WorkerPool::PostTask(FROM_HERE,
+      base::Bind(is_write_ ? &FileBackgroundIO::Write : &FileBackgroundIO::Read,
+                 this), true);
+}
+
+// Runs on a worker thread.
+void FileBackgroundIO::ReleaseSuccessors() {
+  base::AutoLock lock(g_ordering_lock.Get());
+  io_done_ = true;
+  for (size_t i = 0; i < successors_.size(); i++) {
+    DCHECK_GT(successors_[i]->pending_predecessors_, 0);
+    if (!--successors_[i]->pending_predecessors_)
+      successors_[i]->Start();
+  }
+  successors_.clear();
+}
+
 // ---------------------------------------------------------------------------
 
 void FileInFlightIO::PostRead(disk_cache::File *file, void* buf, size_t buf_len,
                           size_t offset, disk_cache::FileIOCallback *callback) {
   scoped_refptr<FileBackgroundIO> operation(
-      new FileBackgroundIO(file, buf, buf_len, offset, callback, this));
+      new FileBackgroundIO(file, buf, buf_len, offset, false, callback, this));
   file->AddRef();  // Balanced on OnOperationComplete()
 
-  base::WorkerPool::PostTask(FROM_HERE,
-      base::Bind(&FileBackgroundIO::Read, operation.get()), true);
+  PostOperation(operation);
   OnOperationPosted(operation);
 }
 
@@ -125,19 +216,42 @@ void FileInFlightIO::PostWrite(disk_cache::File* file, const void* buf,
                            size_t buf_len, size_t offset,
                            disk_cache::FileIOCallback* callback) {
   scoped_refptr<FileBackgroundIO> operation(
-      new FileBackgroundIO(file, buf, buf_len, offset, callback, this));
+      new FileBackgroundIO(file, buf, buf_len, offset, true, callback, this));
   file->AddRef();  // Balanced on OnOperationComplete()
 
-  base::WorkerPool::PostTask(FROM_HERE,
-      base::Bind(&FileBackgroundIO::Write, operation.get()), true);
+  PostOperation(operation);
   OnOperationPosted(operation);
 }
 
+void FileInFlightIO::PostOperation(FileBackgroundIO* operation) {
+  disk_cache::File* file = operation->file();
+  base::AutoLock lock(g_ordering_lock.Get());
+  std::pair<FileOperations::iterator, FileOperations::iterator> range =
+      in_flight_.equal_range(file);
+  for (FileOperations::iterator it = range.first; it != range.second;) {
+    if (operation->WaitIfConflicting(it->second))
+      ++it;
+    else
+      in_flight_.erase(it++);
+  }
+  in_flight_.insert(std::make_pair(file, make_scoped_refptr(operation)));
+  operation->StartOrWait();
+}
+
 // Runs on the IO thread.
 void FileInFlightIO::OnOperationComplete(disk_cache::BackgroundIO* operation,
                                          bool cancel) {
   FileBackgroundIO* op = static_cast<FileBackgroundIO*>(operation);
 
+  std::pair<FileOperations::iterator, FileOperations::iterator> range =
+      in_flight_.equal_range(op->file());
+  for (FileOperations::iterator it = range.first; it != range.second; ++it) {
+    if (it->second == op) {
+      in_flight_.erase(it);
+      break;
+    }
+  }
+
   disk_cache::FileIOCallback* callback = op->callback();
   int bytes = operation->result();
 
@@ -0,0 +1,87 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_HOT_ENTRY_CACHE_H_
+#define NET_DISK_CACHE_HOT_ENTRY_CACHE_H_
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/disk_cache/stats.h"
+
+namespace net {
+class IOBuffer;
+}  // namespace net
+
+namespace disk_cache {
+
+class EntryImpl;
+class MemBackendImpl;
+
+// This class keeps in memory a copy of the small streams of the entries that
+// are read often, in front of BackendImpl, so that reads can be served without
+// going to the cache thread. The data is stored with a MemBackendImpl, which
+// takes care of the memory limit and of discarding the least used entries.
+//
+// The copies are populated with the complete reads of a stream that go to the
+// disk, and are discarded when an entry is written, doomed or created again.
+// Only reads and writes done with the asynchronous interface of the entries
+// go through this object. All methods must be called on the primary thread of
+// the cache.
+class HotEntryCache {
+ public:
+  HotEntryCache();
+  ~HotEntryCache();
+
+  // Enables this object, to store up to |max_bytes|. Zero disables it.
+  void SetMaxSize(int max_bytes);
+
+  bool enabled() const { return backend_.get() != NULL; }
+
+  // Copies up to |buf_len| bytes at |offset| of stream |index| of |entry| to
+  // |buf|. Returns the number of bytes copied, or -1 if the stream is not here.
+  int ReadData(EntryImpl* entry, int index, int offset, net::IOBuffer* buf,
+               int buf_len);
+
+  // Returns true if a read of |buf_len| bytes at |offset| of stream |index| of
+  // |entry| should be stored here, updating |key| with the key of the entry.
+  // FinishFill() must be called when the read completes.
+  bool StartFill(EntryImpl* entry, int index, int offset, int buf_len,
+                 std::string* key);
+
+  // Stores the |result| bytes of stream |index| read into |buf| for the entry
+  // with |key|, unless the entry was modified while the read was in progress.
+  void FinishFill(const std::string& key, int index, net::IOBuffer* buf,
+                  int result);
+
+  // Discards the data of the entry with |key|, or of every entry.
+  void Invalidate(const std::string& key);
+  void Clear();
+
+  // Appends the hit rate and the saved round trips to the cache thread.
+  void GetStats(StatsItems* stats) const;
+
+ private:
+  // Reads that will store their result, for a given key.
+  struct PendingFill {
+    PendingFill() : count(0), invalidated(false) {}
+    int count;
+    bool invalidated;  // True if the entry changed while reading.
+  };
+  typedef std::map<std::string, PendingFill> PendingFills;
+
+  scoped_ptr<MemBackendImpl> backend_;
+  PendingFills pending_fills_;
+  int hits_;
+  int misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(HotEntryCache);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_HOT_ENTRY_CACHE_H_
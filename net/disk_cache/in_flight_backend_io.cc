@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/in_flight_backend_io.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/compiler_specific.h"
@@ -11,6 +13,7 @@
 #include "net/base/net_errors.h"
 #include "net/disk_cache/backend_impl.h"
 #include "net/disk_cache/entry_impl.h"
+#include "net/disk_cache/hash.h"
 #include "net/disk_cache/histogram_macros.h"
 
 namespace disk_cache {
@@ -29,13 +32,32 @@ BackendIO::BackendIO(InFlightIO* controller, BackendImpl* backend,
       offset_(0),
       buf_len_(0),
       truncate_(false),
+      hot_entry_fill_(false),
       offset64_(0),
-      start_(NULL) {
+      start_(NULL),
+      trace_access_(false),
+      trace_hash_(0),
+      trace_key_len_(0) {
   start_time_ = base::TimeTicks::Now();
 }
 
 // Runs on the background thread.
 void BackendIO::ExecuteOperation() {
+  // The operation was created just before being posted, so this is how long
+  // it waited behind the work of the cache thread.
+  CACHE_UMA(TIMES, "CacheThreadQueueTime", 0, ElapsedTime());
+
+  trace_access_ = backend_->access_trace_enabled();
+  if (trace_access_) {
+    if (entry_) {
+      trace_hash_ = entry_->GetHash();
+      trace_key_len_ = entry_->entry()->Data()->key_len;
+    } else {
+      trace_hash_ = Hash(key_);
+      trace_key_len_ = static_cast<int>(key_.size());
+    }
+  }
+
   if (IsEntryOperation())
     return ExecuteEntryOperation();
 
@@ -47,6 +69,7 @@ void BackendIO::OnIOComplete(int result) {
   DCHECK(IsEntryOperation());
   DCHECK_NE(result, net::ERR_IO_PENDING);
   result_ = result;
+  RecordAccess();
   NotifyController();
 }
 
@@ -75,6 +98,21 @@ void BackendIO::ReferenceEntry() {
   entry_->AddRef();
 }
 
+void BackendIO::SetHotEntryFill(const std::string& key) {
+  DCHECK_EQ(OP_READ, operation_);
+  key_ = key;
+  hot_entry_fill_ = true;
+}
+
+// Runs on the primary thread.
+void BackendIO::FinishHotEntryFill(HotEntryCache* hot_entries, bool cancel) {
+  if (!hot_entry_fill_)
+    return;
+
+  hot_entries->FinishFill(key_, index_, buf_,
+                          cancel ? net::ERR_ABORTED : result_);
+}
+
 void BackendIO::Init() {
   operation_ = OP_INIT;
 }
@@ -280,6 +318,7 @@ void BackendIO::ExecuteBackendOperation() {
       result_ = net::ERR_UNEXPECTED;
   }
   DCHECK_NE(net::ERR_IO_PENDING, result_);
+  RecordAccess();
   NotifyController();
 }
 
@@ -322,8 +361,54 @@ void BackendIO::ExecuteEntryOperation() {
       NOTREACHED() << "Invalid Operation";
       result_ = net::ERR_UNEXPECTED;
   }
-  if (result_ != net::ERR_IO_PENDING)
+  if (result_ != net::ERR_IO_PENDING) {
+    RecordAccess();
     NotifyController();
+  }
+}
+
+// Runs on the background thread.
+void BackendIO::RecordAccess() {
+  if (!trace_access_)
+    return;
+
+  AccessTrace::Record record;
+  memset(&record, 0, sizeof(record));
+  switch (operation_) {
+    case OP_OPEN:
+      record.operation = AccessTrace::OPEN;
+      break;
+    case OP_CREATE:
+      record.operation = AccessTrace::CREATE;
+      break;
+    case OP_DOOM:
+    case OP_DOOM_ENTRY:
+      record.operation = AccessTrace::DOOM;
+      break;
+    case OP_CLOSE_ENTRY:
+      record.operation = AccessTrace::CLOSE;
+      break;
+    case OP_READ:
+      record.operation = AccessTrace::READ;
+      break;
+    case OP_WRITE:
+      record.operation = AccessTrace::WRITE;
+      break;
+    default:
+      return;
+  }
+
+  base::TimeDelta latency = ElapsedTime();
+  record.time = (base::Time::Now() - latency).ToInternalValue();
+  record.hash = trace_hash_;
+  record.key_len = static_cast<uint16>(
+      std::min(trace_key_len_, static_cast<int>(kuint16max)));
+  record.index = static_cast<uint8>(index_);
+  record.offset = offset_;
+  record.size = buf_len_;
+  record.result = result_;
+  record.latency_us = static_cast<uint32>(latency.InMicroseconds());
+  backend_->RecordAccess(record);
 }
 
 InFlightBackendIO::InFlightBackendIO(BackendImpl* backend,
@@ -351,6 +436,7 @@ void InFlightBackendIO::OpenEntry(const std::string& key, Entry** entry,
 
 void InFlightBackendIO::CreateEntry(const std::string& key, Entry** entry,
                                     const net::CompletionCallback& callback) {
+  hot_entries_.Invalidate(key);
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->CreateEntry(key, entry);
   PostOperation(operation);
@@ -358,6 +444,7 @@ void InFlightBackendIO::CreateEntry(const std::string& key, Entry** entry,
 
 void InFlightBackendIO::DoomEntry(const std::string& key,
                                   const net::CompletionCallback& callback) {
+  hot_entries_.Invalidate(key);
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->DoomEntry(key);
   PostOperation(operation);
@@ -365,6 +452,7 @@ void InFlightBackendIO::DoomEntry(const std::string& key,
 
 void InFlightBackendIO::DoomAllEntries(
     const net::CompletionCallback& callback) {
+  hot_entries_.Clear();
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->DoomAllEntries();
   PostOperation(operation);
@@ -373,6 +461,7 @@ void InFlightBackendIO::DoomAllEntries(
 void InFlightBackendIO::DoomEntriesBetween(const base::Time initial_time,
                         const base::Time end_time,
                         const net::CompletionCallback& callback) {
+  hot_entries_.Clear();
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->DoomEntriesBetween(initial_time, end_time);
   PostOperation(operation);
@@ -380,6 +469,7 @@ void InFlightBackendIO::DoomEntriesBetween(const base::Time initial_time,
 
 void InFlightBackendIO::DoomEntriesSince(
     const base::Time initial_time, const net::CompletionCallback& callback) {
+  hot_entries_.Clear();
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->DoomEntriesSince(initial_time);
   PostOperation(operation);
@@ -421,6 +511,8 @@ void InFlightBackendIO::CloseEntryImpl(EntryImpl* entry) {
 }
 
 void InFlightBackendIO::DoomEntryImpl(EntryImpl* entry) {
+  if (hot_entries_.enabled())
+    hot_entries_.Invalidate(entry->GetKey());
   scoped_refptr<BackendIO> operation(
       new BackendIO(this, backend_, net::CompletionCallback()));
   operation->DoomEntryImpl(entry);
@@ -445,6 +537,9 @@ void InFlightBackendIO::ReadData(EntryImpl* entry, int index, int offset,
                                  const net::CompletionCallback& callback) {
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->ReadData(entry, index, offset, buf, buf_len);
+  std::string key;
+  if (hot_entries_.StartFill(entry, index, offset, buf_len, &key))
+    operation->SetHotEntryFill(key);
   PostOperation(operation);
 }
 
@@ -452,6 +547,8 @@ void InFlightBackendIO::WriteData(EntryImpl* entry, int index, int offset,
                                   net::IOBuffer* buf, int buf_len,
                                   bool truncate,
                                   const net::CompletionCallback& callback) {
+  if (hot_entries_.enabled())
+    hot_entries_.Invalidate(entry->GetKey());
   scoped_refptr<BackendIO> operation(new BackendIO(this, backend_, callback));
   operation->WriteData(entry, index, offset, buf, buf_len, truncate);
   PostOperation(operation);
@@ -503,6 +600,7 @@ void InFlightBackendIO::OnOperationComplete(BackgroundIO* operation,
                                             bool cancel) {
   BackendIO* op = static_cast<BackendIO*>(operation);
   op->OnDone(cancel);
+  op->FinishHotEntryFill(&hot_entries_, cancel);
 
   if (!op->callback().is_null() && (!cancel || op->IsEntryOperation()))
     op->callback().Run(op->result());
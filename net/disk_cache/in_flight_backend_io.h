@@ -13,6 +13,7 @@
 #include "base/time.h"
 #include "net/base/completion_callback.h"
 #include "net/base/io_buffer.h"
+#include "net/disk_cache/hot_entry_cache.h"
 #include "net/disk_cache/in_flight_io.h"
 
 namespace disk_cache {
@@ -46,6 +47,11 @@ class BackendIO : public BackgroundIO {
   // Grabs an extra reference of entry_.
   void ReferenceEntry();
 
+  // Marks a read whose result should be stored by the HotEntryCache, for the
+  // entry with |key|, and hands the result of that read to |hot_entries|.
+  void SetHotEntryFill(const std::string& key);
+  void FinishHotEntryFill(HotEntryCache* hot_entries, bool cancel);
+
   // The operations we proxy:
   void Init();
   void OpenEntry(const std::string& key, Entry** entry);
@@ -119,6 +125,10 @@ class BackendIO : public BackgroundIO {
   void ExecuteBackendOperation();
   void ExecuteEntryOperation();
 
+  // Adds the finished operation to the access trace of the backend, if it
+  // is one that replay_cache.cc can reproduce.
+  void RecordAccess();
+
   BackendImpl* backend_;
   net::CompletionCallback callback_;
   Operation operation_;
@@ -136,10 +146,16 @@ class BackendIO : public BackgroundIO {
   scoped_refptr<net::IOBuffer> buf_;
   int buf_len_;
   bool truncate_;
+  bool hot_entry_fill_;
   int64 offset64_;
   int64* start_;
   base::TimeTicks start_time_;
   base::Closure task_;
+  // The key of the operation for the access trace, taken before the entry
+  // can go away.
+  bool trace_access_;
+  uint32 trace_hash_;
+  int trace_key_len_;
 
   DISALLOW_COPY_AND_ASSIGN(BackendIO);
 };
@@ -205,6 +221,10 @@ class InFlightBackendIO : public InFlightIO {
 
   base::WeakPtr<InFlightBackendIO> GetWeakPtr();
 
+  // The copies of small entries that are read often, to serve them without
+  // going to the background thread.
+  HotEntryCache* hot_entries() { return &hot_entries_; }
+
  protected:
   virtual void OnOperationComplete(BackgroundIO* operation,
                                    bool cancel) OVERRIDE;
@@ -214,6 +234,7 @@ class InFlightBackendIO : public InFlightIO {
 
   BackendImpl* backend_;
   scoped_refptr<base::MessageLoopProxy> background_thread_;
+  HotEntryCache hot_entries_;
   base::WeakPtrFactory<InFlightBackendIO> ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(InFlightBackendIO);
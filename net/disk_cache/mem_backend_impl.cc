@@ -4,6 +4,7 @@
 
 #include "net/disk_cache/mem_backend_impl.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/sys_info.h"
 #include "net/base/net_errors.h"
@@ -29,7 +30,13 @@ int LowWaterAdjust(int high_water) {
 namespace disk_cache {
 
 MemBackendImpl::MemBackendImpl(net::NetLog* net_log)
-    : max_size_(0), current_size_(0), net_log_(net_log) {}
+    : max_size_(0),
+      current_size_(0),
+      net_log_(net_log),
+      ALLOW_THIS_IN_INITIALIZER_LIST(memory_pressure_listener_(
+          base::Bind(&MemBackendImpl::OnMemoryPressure,
+                     base::Unretained(this)))) {
+}
 
 MemBackendImpl::~MemBackendImpl() {
   EntryMap::iterator it = entries_.begin();
@@ -311,6 +318,24 @@ void MemBackendImpl::TrimCache(bool empty) {
   return;
 }
 
+void MemBackendImpl::EvictUnusedEntries(int32 target_size) {
+  MemEntryImpl* next = rankings_.GetPrev(NULL);
+  while (current_size_ > target_size && next) {
+    MemEntryImpl* node = next;
+    next = rankings_.GetPrev(next);
+    if (!node->InUse())
+      node->Doom();
+  }
+}
+
+void MemBackendImpl::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    EvictUnusedEntries(0);
+  else
+    EvictUnusedEntries(current_size_ / 2);
+}
+
 void MemBackendImpl::AddStorageSize(int32 bytes) {
   current_size_ += bytes;
   DCHECK_GE(current_size_, 0);
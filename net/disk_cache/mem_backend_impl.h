@@ -10,6 +10,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/hash_tables.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/mem_rankings.h"
 
@@ -101,6 +102,15 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // use.
   void TrimCache(bool empty);
 
+  // Deletes entries that are not in use, least recently used first, until
+  // the current size is at most |target_size|.
+  void EvictUnusedEntries(int32 target_size);
+
+  // Gives up half of the cache under moderate memory pressure, and all
+  // entries that are not in use under critical pressure.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   // Handles the used storage count.
   void AddStorageSize(int32 bytes);
   void SubstractStorageSize(int32 bytes);
@@ -112,6 +122,8 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
 
   net::NetLog* net_log_;
 
+  base::MemoryPressureListener memory_pressure_listener_;
+
   DISALLOW_COPY_AND_ASSIGN(MemBackendImpl);
 };
 
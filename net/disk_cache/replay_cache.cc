@@ -0,0 +1,298 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This is a simple application that drives a disk cache with the operations of
+// an access trace (see AccessTrace in trace.h), recorded by a cache running
+// with kAccessTrace. It reports the latency of each kind of operation, the hit
+// rate and the amount of data moved, so that changes to the eviction or the
+// file layout can be compared against real access patterns.
+//
+// Usage: replay_cache <trace file> <cache directory> [options]
+//   --max-size=<bytes>  Maximum size of the cache (default: 80 MB).
+//   --new-eviction      Use the second version of the eviction algorithm.
+//   --realtime          Wait between operations as long as the trace did, up
+//                       to one second.
+// The cache directory is deleted first, unless --reuse is given.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/message_loop.h"
+#include "base/string_number_conversions.h"
+#include "base/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
+#include "base/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/disk_cache/backend_impl.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/trace.h"
+
+using base::TimeDelta;
+using base::TimeTicks;
+using disk_cache::AccessTrace;
+
+namespace {
+
+const int kDefaultCacheSize = 80 * 1024 * 1024;
+const char* const kOperationNames[] = {
+  "Open", "Create", "Read", "Write", "Doom", "Close"
+};
+
+// Builds a key with the hash and length of the traced one. Only the identity
+// and the length of keys matter to the cache layout.
+std::string ReplayKey(uint32 hash, int key_len) {
+  std::string key = base::StringPrintf("%08x", hash);
+  if (key_len > static_cast<int>(key.size()))
+    key.append(key_len - key.size(), 'k');
+  return key;
+}
+
+class CacheReplayer {
+ public:
+  explicit CacheReplayer(disk_cache::Backend* cache)
+      : cache_(cache),
+        hits_(0),
+        misses_(0),
+        bytes_read_(0),
+        bytes_written_(0),
+        skipped_(0) {
+    COMPILE_ASSERT(arraysize(kOperationNames) == AccessTrace::MAX_OPERATION,
+                   operation_names_mismatch);
+  }
+
+  ~CacheReplayer() {
+    for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it) {
+      for (size_t i = 0; i < it->second.size(); ++i)
+        it->second[i]->Close();
+    }
+  }
+
+  void Replay(const AccessTrace::Record& record) {
+    std::string key = ReplayKey(record.hash, record.key_len);
+    TimeTicks start = TimeTicks::Now();
+    int rv = net::OK;
+    switch (record.operation) {
+      case AccessTrace::OPEN:
+      case AccessTrace::CREATE: {
+        disk_cache::Entry* entry = NULL;
+        net::TestCompletionCallback cb;
+        if (record.operation == AccessTrace::OPEN)
+          rv = cb.GetResult(cache_->OpenEntry(key, &entry, cb.callback()));
+        else
+          rv = cb.GetResult(cache_->CreateEntry(key, &entry, cb.callback()));
+        if (rv == net::OK)
+          entries_[record.hash].push_back(entry);
+        if (record.operation == AccessTrace::OPEN && rv == net::OK)
+          hits_++;
+        else if (record.operation == AccessTrace::OPEN)
+          misses_++;
+        break;
+      }
+      case AccessTrace::READ:
+      case AccessTrace::WRITE: {
+        disk_cache::Entry* entry = GetEntry(record.hash);
+        if (!entry || record.size < 0) {
+          skipped_++;
+          return;
+        }
+        scoped_refptr<net::IOBuffer> buffer(
+            new net::IOBuffer(std::max(record.size, 1)));
+        net::TestCompletionCallback cb;
+        if (record.operation == AccessTrace::READ) {
+          rv = cb.GetResult(entry->ReadData(record.index, record.offset,
+                                            buffer, record.size,
+                                            cb.callback()));
+          if (rv > 0)
+            bytes_read_ += rv;
+        } else {
+          memset(buffer->data(), 'r', record.size);
+          rv = cb.GetResult(entry->WriteData(record.index, record.offset,
+                                             buffer, record.size,
+                                             cb.callback(), false));
+          if (rv > 0)
+            bytes_written_ += rv;
+        }
+        break;
+      }
+      case AccessTrace::DOOM: {
+        // Dooming through an open entry keeps it open until it is closed.
+        disk_cache::Entry* entry = GetEntry(record.hash);
+        if (entry) {
+          entry->Doom();
+          break;
+        }
+        net::TestCompletionCallback cb;
+        cb.GetResult(cache_->DoomEntry(key, cb.callback()));
+        break;
+      }
+      case AccessTrace::CLOSE: {
+        EntryMap::iterator it = entries_.find(record.hash);
+        if (it == entries_.end() || it->second.empty()) {
+          skipped_++;
+          return;
+        }
+        it->second.back()->Close();
+        it->second.pop_back();
+        break;
+      }
+      default:
+        skipped_++;
+        return;
+    }
+    latencies_[record.operation].push_back(TimeTicks::Now() - start);
+  }
+
+  void PrintResults(const disk_cache::Backend* cache) const {
+    printf("%-8s %9s %10s %10s %10s %10s\n", "op", "count", "p50 us",
+           "p90 us", "p99 us", "max us");
+    for (int op = 0; op < AccessTrace::MAX_OPERATION; ++op) {
+      LatencyMap::const_iterator it = latencies_.find(op);
+      if (it == latencies_.end())
+        continue;
+      std::vector<TimeDelta> times = it->second;
+      std::sort(times.begin(), times.end());
+      printf("%-8s %9d %10d %10d %10d %10d\n", kOperationNames[op],
+             static_cast<int>(times.size()), Percentile(times, 50),
+             Percentile(times, 90), Percentile(times, 99),
+             Percentile(times, 100));
+    }
+    int opens = hits_ + misses_;
+    printf("Open hit rate: %.1f%% (%d of %d)\n",
+           opens ? hits_ * 100.0 / opens : 0.0, hits_, opens);
+    printf("Payload read: %s KB, written: %s KB\n",
+           base::Int64ToString(bytes_read_ / 1024).c_str(),
+           base::Int64ToString(bytes_written_ / 1024).c_str());
+    printf("Entries at the end: %d\n", cache->GetEntryCount());
+    if (skipped_)
+      printf("Skipped %d operations on entries that were not open\n",
+             skipped_);
+  }
+
+ private:
+  typedef std::map<uint32, std::vector<disk_cache::Entry*> > EntryMap;
+  typedef std::map<int, std::vector<TimeDelta> > LatencyMap;
+
+  static int Percentile(const std::vector<TimeDelta>& sorted, int percent) {
+    size_t index = (sorted.size() - 1) * percent / 100;
+    return static_cast<int>(sorted[index].InMicroseconds());
+  }
+
+  disk_cache::Entry* GetEntry(uint32 hash) {
+    EntryMap::iterator it = entries_.find(hash);
+    if (it == entries_.end() || it->second.empty())
+      return NULL;
+    return it->second.back();
+  }
+
+  disk_cache::Backend* cache_;
+  EntryMap entries_;
+  LatencyMap latencies_;
+  int hits_;
+  int misses_;
+  int64 bytes_read_;
+  int64 bytes_written_;
+  int skipped_;
+
+  DISALLOW_COPY_AND_ASSIGN(CacheReplayer);
+};
+
+int ReplayTrace(const std::vector<AccessTrace::Record>& records,
+                const FilePath& cache_path, const CommandLine& command_line) {
+  int max_size = kDefaultCacheSize;
+  if (command_line.HasSwitch("max-size") &&
+      !base::StringToInt(command_line.GetSwitchValueASCII("max-size"),
+                         &max_size)) {
+    printf("Invalid --max-size\n");
+    return 1;
+  }
+  if (!command_line.HasSwitch("reuse"))
+    file_util::Delete(cache_path, true);
+  int64 initial_size = file_util::ComputeDirectorySize(cache_path);
+
+  base::Thread cache_thread("CacheThread");
+  if (!cache_thread.StartWithOptions(
+          base::Thread::Options(MessageLoop::TYPE_IO, 0)))
+    return 1;
+
+  disk_cache::BackendImpl* cache = new disk_cache::BackendImpl(
+      cache_path, cache_thread.message_loop_proxy(), NULL);
+  cache->SetMaxSize(max_size);
+  cache->SetType(net::DISK_CACHE);
+  // The replay controls the behavior; no experiments or load shedding.
+  uint32 flags = disk_cache::kNoRandom | disk_cache::kNoLoadProtection;
+  if (command_line.HasSwitch("new-eviction"))
+    flags |= disk_cache::kNewEviction;
+  cache->SetFlags(flags);
+
+  net::TestCompletionCallback cb;
+  if (cb.GetResult(cache->Init(cb.callback())) != net::OK) {
+    printf("Unable to initialize the cache at %s\n",
+           cache_path.MaybeAsASCII().c_str());
+    delete cache;
+    return 1;
+  }
+
+  const bool realtime = command_line.HasSwitch("realtime");
+  const TimeDelta kMaxGap = TimeDelta::FromSeconds(1);
+  TimeTicks start = TimeTicks::Now();
+  {
+    CacheReplayer replayer(cache);
+    for (size_t i = 0; i < records.size(); ++i) {
+      if (realtime && i) {
+        TimeDelta gap = base::Time::FromInternalValue(records[i].time) -
+            base::Time::FromInternalValue(records[i - 1].time);
+        if (gap > TimeDelta())
+          base::PlatformThread::Sleep(std::min(gap, kMaxGap));
+      }
+      replayer.Replay(records[i]);
+    }
+    printf("Replayed %d operations in %d ms\n",
+           static_cast<int>(records.size()),
+           static_cast<int>((TimeTicks::Now() - start).InMilliseconds()));
+    replayer.PrintResults(cache);
+  }
+  delete cache;
+
+  printf("Cache files grew by %s KB\n",
+         base::Int64ToString(
+             (file_util::ComputeDirectorySize(cache_path) - initial_size) /
+             1024).c_str());
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  // Setup an AtExitManager so Singleton objects will be destructed.
+  base::AtExitManager at_exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+
+  CommandLine::StringVector args = command_line.GetArgs();
+  if (args.size() != 2) {
+    printf("Usage: replay_cache <trace file> <cache directory> [--max-size=N] "
+           "[--new-eviction] [--realtime] [--reuse]\n");
+    return 1;
+  }
+
+  std::vector<AccessTrace::Record> records;
+  if (!AccessTrace::ReadTrace(FilePath(args[0]), &records)) {
+    printf("Unable to read the trace\n");
+    return 1;
+  }
+
+  MessageLoop message_loop(MessageLoop::TYPE_IO);
+  return ReplayTrace(records, FilePath(args[1]), command_line);
+}
@@ -189,6 +189,7 @@ SparseControl::SparseControl(EntryImpl* entry)
       child_(NULL),
       operation_(kNoOperation),
       init_(false),
+      next_read_offset_(-1),
       child_map_(child_data_.bitmap, kNumSparseBits, kNumSparseBits / 32) {
 }
 
@@ -716,6 +717,10 @@ bool SparseControl::DoChildIO() {
                 child_->net_log().source(),
                 child_len_)));
       }
+      // Keep reading ahead when a reader that goes in order moves to a new
+      // child.
+      if (offset_ == next_read_offset_)
+        child_->ExpectSequentialRead(kSparseData, child_offset_);
       rv = child_->ReadDataImpl(kSparseData, child_offset_, user_buf_,
                                 child_len_, callback);
       break;
@@ -815,6 +820,8 @@ void SparseControl::DoChildIOCompleted(int result) {
   result_ += result;
   offset_ += result;
   buf_len_ -= result;
+  if (kReadOperation == operation_)
+    next_read_offset_ = offset_;
 
   // We'll be reusing the user provided buffer for the next chunk.
   if (buf_len_ && user_buf_)
@@ -164,6 +164,7 @@ class SparseControl {
   CompletionCallback user_callback_;
   std::vector<CompletionCallback> abort_callbacks_;
   int64 offset_;  // Current sparse offset.
+  int64 next_read_offset_;  // Where the last read ended.
   scoped_refptr<net::DrainableIOBuffer> user_buf_;
   int buf_len_;  // Bytes to read or write.
   int child_offset_;  // Offset to use for the current child.
@@ -9,6 +9,7 @@
 #include <windows.h>
 #endif
 
+#include "base/file_util.h"
 #include "base/logging.h"
 #include "net/disk_cache/stress_support.h"
 
@@ -176,4 +177,44 @@ void Trace(const char* format, ...) {
 
 #endif  // ENABLE_TRACING
 
+// Access traces are independent of ENABLE_TRACING; the backend only keeps one
+// when asked to with kAccessTrace.
+
+AccessTrace::AccessTrace(const FilePath& path) {
+  COMPILE_ASSERT(sizeof(Record) == 32, bad_access_record_size);
+  file_ = file_util::OpenFile(path, "ab");
+  LOG_IF(ERROR, !file_) << "Unable to open access trace " << path.value();
+}
+
+AccessTrace::~AccessTrace() {
+  if (file_)
+    file_util::CloseFile(file_);
+}
+
+void AccessTrace::Add(const Record& record) {
+  // Writes go to the stdio buffer; a failure just means a shorter trace.
+  if (file_)
+    fwrite(&record, sizeof(record), 1, file_);
+}
+
+void AccessTrace::Flush() {
+  if (file_)
+    fflush(file_);
+}
+
+// Static.
+bool AccessTrace::ReadTrace(const FilePath& path,
+                            std::vector<Record>* records) {
+  std::string contents;
+  if (!file_util::ReadFileToString(path, &contents))
+    return false;
+
+  // A trailing partial record is what a crash leaves behind; drop it.
+  size_t count = contents.size() / sizeof(Record);
+  records->resize(count);
+  if (count)
+    memcpy(&(*records)[0], contents.data(), count * sizeof(Record));
+  return true;
+}
+
 }  // namespace disk_cache
@@ -10,7 +10,12 @@
 #define NET_DISK_CACHE_TRACE_H__
 #pragma once
 
+#include <stdio.h>
+
+#include <vector>
+
 #include "base/basictypes.h"
+#include "base/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/net_export.h"
 
@@ -37,6 +42,55 @@ class TraceObject : public base::RefCounted<TraceObject> {
 // Traces to the internal buffer.
 NET_EXPORT_PRIVATE void Trace(const char* format, ...);
 
+// Unlike the debug trace above, an access trace is a file with one record per
+// cache operation, meant to be replayed against another cache (see
+// replay_cache.cc) to measure the effect of eviction or layout changes with
+// real access patterns. Keys are only stored as hashes and lengths.
+class NET_EXPORT_PRIVATE AccessTrace {
+ public:
+  enum Operation {
+    OPEN,
+    CREATE,
+    READ,
+    WRITE,
+    DOOM,
+    CLOSE,
+    MAX_OPERATION
+  };
+
+#pragma pack(push, 4)
+  struct Record {
+    int64 time;  // When the caller issued the operation, Time internal value.
+    uint32 hash;  // Hash of the key.
+    uint16 key_len;
+    uint8 operation;
+    uint8 index;  // The stream of a read or write.
+    int32 offset;
+    int32 size;  // The length requested by a read or write.
+    int32 result;  // Bytes read or written, or a net error code.
+    uint32 latency_us;  // From the caller's request to the completion.
+  };
+#pragma pack(pop)
+
+  // Appends to the trace at |path|, creating it if needed.
+  explicit AccessTrace(const FilePath& path);
+  ~AccessTrace();
+
+  bool IsValid() const { return file_ != NULL; }
+
+  // Adds |record|. Records are buffered until Flush() or destruction.
+  void Add(const Record& record);
+  void Flush();
+
+  // Reads all the records of the trace at |path|.
+  static bool ReadTrace(const FilePath& path, std::vector<Record>* records);
+
+ private:
+  FILE* file_;
+
+  DISALLOW_COPY_AND_ASSIGN(AccessTrace);
+};
+
 }  // namespace disk_cache
 
 #endif  // NET_DISK_CACHE_TRACE_H__
@@ -115,4 +115,65 @@ TEST(DiskCacheBasedSSLHostInfo, Update) {
   RemoveMockTransaction(&kHostInfoTransaction);
 }
 
+// Tests that the TLS session is stored encrypted, and only read back with the
+// same secret.
+TEST(DiskCacheBasedSSLHostInfo, SessionState) {
+  MockHttpCache cache;
+  AddMockTransaction(&kHostInfoTransaction);
+  net::TestCompletionCallback callback;
+  net::SSLHostInfo::EnableSessionPersistence("secret");
+
+  scoped_ptr<net::CertVerifier> cert_verifier(new net::MockCertVerifier);
+  net::SSLConfig ssl_config;
+  scoped_ptr<net::SSLHostInfo> ssl_host_info(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  int rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+
+  net::SSLHostInfo::State* state = ssl_host_info->mutable_state();
+  EXPECT_TRUE(state->session_state.empty());
+  state->session_host_and_port = "www.google.com:443";
+  state->session_state = "session";
+  ssl_host_info->Persist();
+  MessageLoop::current()->RunAllPending();
+
+  ssl_host_info.reset(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+  EXPECT_EQ("www.google.com:443", ssl_host_info->state().session_host_and_port);
+  EXPECT_EQ("session", ssl_host_info->state().session_state);
+
+  // A different secret can't read the session.
+  net::SSLHostInfo::EnableSessionPersistence("other secret");
+  ssl_host_info.reset(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+  EXPECT_TRUE(ssl_host_info->state().session_host_and_port.empty());
+  EXPECT_TRUE(ssl_host_info->state().session_state.empty());
+
+  // Nor can we when session persistence is disabled.
+  net::SSLHostInfo::EnableSessionPersistence("");
+  ssl_host_info.reset(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+  EXPECT_TRUE(ssl_host_info->state().session_state.empty());
+
+  RemoveMockTransaction(&kHostInfoTransaction);
+}
+
 }  // namespace
@@ -106,7 +106,8 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      tailing_allowed(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -279,6 +280,92 @@ void HttpCache::MetadataWriter::OnIOComplete(int result) {
 
 //-----------------------------------------------------------------------------
 
+// This class fetches a resource into the cache, without a consumer: it
+// revalidates the entries that are being used while stale, and it implements
+// HttpCache::Prefetch. It behaves as any other transaction, so it becomes the
+// writer of the ActiveEntry and the requests for the same resource wait for the
+// response instead of going to the network. The body of a network response is
+// read and ignored; the cache stores it along the way.
+class HttpCache::BackgroundFetch {
+ public:
+  BackgroundFetch(const HttpRequestInfo& request, HttpCache* cache)
+      : request_(request),
+        cache_(cache),
+        read_buf_(new IOBuffer(kBufferSize)) {
+  }
+
+  ~BackgroundFetch() {}
+
+  // Starts fetching the cache entry with |key|.
+  void Start(const std::string& key);
+
+ private:
+  enum { kBufferSize = 32 * 1024 };
+
+  void OnStarted(int result);
+  void DoRead();
+  void OnRead(int result);
+
+  // Deletes this object.
+  void Terminate();
+
+  HttpRequestInfo request_;
+  HttpCache* const cache_;
+  std::string key_;
+  scoped_ptr<Transaction> transaction_;
+  scoped_refptr<IOBuffer> read_buf_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundFetch);
+};
+
+void HttpCache::BackgroundFetch::Start(const std::string& key) {
+  key_ = key;
+  transaction_.reset(new Transaction(cache_));
+
+  int rv = transaction_->Start(
+      &request_,
+      base::Bind(&BackgroundFetch::OnStarted, base::Unretained(this)),
+      BoundNetLog());
+  if (rv != ERR_IO_PENDING)
+    OnStarted(rv);
+}
+
+void HttpCache::BackgroundFetch::OnStarted(int result) {
+  if (result != OK)
+    return Terminate();
+
+  // There is no need to read a body that the cache already has.
+  if (transaction_->GetResponseInfo()->was_cached)
+    return Terminate();
+
+  DoRead();
+}
+
+void HttpCache::BackgroundFetch::DoRead() {
+  int rv = 0;
+  do {
+    rv = transaction_->Read(
+        read_buf_, kBufferSize,
+        base::Bind(&BackgroundFetch::OnRead, base::Unretained(this)));
+  } while (rv > 0);
+
+  if (rv != ERR_IO_PENDING)
+    Terminate();
+}
+
+void HttpCache::BackgroundFetch::OnRead(int result) {
+  if (result <= 0)
+    return Terminate();
+
+  DoRead();
+}
+
+void HttpCache::BackgroundFetch::Terminate() {
+  cache_->DeleteBackgroundFetch(key_);
+}
+
+//-----------------------------------------------------------------------------
+
 class HttpCache::SSLHostInfoFactoryAdaptor : public SSLHostInfoFactory {
  public:
   SSLHostInfoFactoryAdaptor(CertVerifier* cert_verifier, HttpCache* http_cache)
@@ -333,7 +420,9 @@ HttpCache::HttpCache(HostResolver* host_resolver,
                   network_delegate,
                   http_server_properties,
                   net_log,
-                  trusted_spdy_proxy))) {
+                  trusted_spdy_proxy)),
+      stale_while_revalidate_enabled_(false),
+      tailing_readers_enabled_(false) {
 }
 
 
@@ -346,7 +435,9 @@ HttpCache::HttpCache(HttpNetworkSession* session,
       ssl_host_info_factory_(new SSLHostInfoFactoryAdaptor(
           session->cert_verifier(),
           ALLOW_THIS_IN_INITIALIZER_LIST(this))),
-      network_layer_(new HttpNetworkLayer(session)) {
+      network_layer_(new HttpNetworkLayer(session),
+      stale_while_revalidate_enabled_(false),
+      tailing_readers_enabled_(false) {
 }
 
 HttpCache::HttpCache(HttpTransactionFactory* network_layer,
@@ -356,10 +447,16 @@ HttpCache::HttpCache(HttpTransactionFactory* network_layer,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
-      network_layer_(network_layer) {
+      network_layer_(network_layer,
+      stale_while_revalidate_enabled_(false),
+      tailing_readers_enabled_(false) {
 }
 
 HttpCache::~HttpCache() {
+  // The fetches own transactions that have to be removed from the entries.
+  while (!background_fetches_.empty())
+    DeleteBackgroundFetch(background_fetches_.begin()->first);
+
   // If we have any active entries remaining, then we need to deactivate them.
   // We may have some pending calls to OnProcessPendingQueue, but since those
   // won't run (due to our destruction), we can simply ignore the corresponding
@@ -446,6 +543,27 @@ void HttpCache::WriteMetadata(const GURL& url,
   writer->Write(url, expected_response_time, buf, buf_len);
 }
 
+void HttpCache::Prefetch(const GURL& url, RequestPriority priority) {
+  HttpRequestInfo request;
+  request.url = url;
+  request.method = "GET";
+  request.priority = priority;
+  request.load_flags = LOAD_PREFETCH | LOAD_DO_NOT_PROMPT_FOR_LOGIN;
+
+  // Somebody is already fetching or reading this resource.
+  std::string key = GenerateCacheKey(&request);
+  if (pending_ops_.find(key) != pending_ops_.end() || FindActiveEntry(key))
+    return;
+
+  // Do lazy initialization of disk cache if needed.
+  if (!disk_cache_.get()) {
+    // We don't care about the result.
+    CreateBackend(NULL, net::CompletionCallback());
+  }
+
+  StartBackgroundFetch(request);
+}
+
 void HttpCache::CloseAllConnections() {
   net::HttpNetworkLayer* network =
       static_cast<net::HttpNetworkLayer*>(network_layer_.get());
@@ -818,6 +936,9 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
 
   if (entry->writer || entry->will_process_pending_queue) {
     entry->pending_queue.push_back(trans);
+    // The writer may let this transaction read before it is done.
+    if (entry->tailing_allowed)
+      ProcessPendingQueue(entry);
     return ERR_IO_PENDING;
   }
 
@@ -847,11 +968,13 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
-  if (entry->will_process_pending_queue && entry->readers.empty())
+  if (entry->will_process_pending_queue && entry->readers.empty() &&
+      entry->writer != trans)
     return;
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
+  if (entry->writer == trans) {
+    // The readers that follow this writer will not get the whole response.
+    NotifyTailingReaders(entry, ERR_CACHE_READ_FAILURE);
 
     // Assume there was a failure.
     bool success = false;
@@ -868,21 +991,30 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
 }
 
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
-  DCHECK(entry->readers.empty());
+  DCHECK(entry->readers.empty() || entry->tailing_allowed);
+
+  // The readers that follow the writer keep the entry alive until they find
+  // out about a failure, so it has to be doomed now.
+  bool keep_entry = !success && (!entry->readers.empty() ||
+                                 entry->will_process_pending_queue);
+  if (keep_entry && !entry->doomed)
+    DoomActiveEntry(entry->disk_entry->GetKey());
 
+  NotifyTailingReaders(entry, success ? OK : ERR_CACHE_READ_FAILURE);
+  entry->tailing_allowed = false;
   entry->writer = NULL;
 
   if (success) {
     ProcessPendingQueue(entry);
   } else {
-    DCHECK(!entry->will_process_pending_queue);
-
     // We failed to create this entry.
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (!keep_entry) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -895,7 +1027,7 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
+  DCHECK(!entry->writer || entry->tailing_allowed);
 
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
@@ -919,6 +1051,27 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::AllowTailingReaders(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  DCHECK(entry->readers.empty());
+  if (!tailing_readers_enabled_)
+    return;
+
+  entry->tailing_allowed = true;
+  if (!entry->pending_queue.empty())
+    ProcessPendingQueue(entry);
+}
+
+void HttpCache::NotifyTailingReaders(ActiveEntry* entry, int result) {
+  if (!entry->tailing_allowed)
+    return;
+
+  for (TransactionList::iterator it = entry->readers.begin();
+       it != entry->readers.end(); ++it) {
+    (*it)->OnWriterProgress(result);
+  }
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1012,9 +1165,51 @@ void HttpCache::ProcessPendingQueue(ActiveEntry* entry) {
                  entry));
 }
 
+void HttpCache::PerformAsyncValidation(const HttpRequestInfo& request) {
+  HttpRequestInfo validation_request(request);
+  validation_request.load_flags |= LOAD_VALIDATE_CACHE;
+  StartBackgroundFetch(validation_request);
+}
+
+void HttpCache::StartBackgroundFetch(const HttpRequestInfo& request) {
+  std::string key = GenerateCacheKey(&request);
+  if (background_fetches_.find(key) != background_fetches_.end())
+    return;  // Join the fetch in progress.
+
+  BackgroundFetch* fetch = new BackgroundFetch(request, this);
+  background_fetches_[key] = fetch;
+  fetch->Start(key);
+}
+
+void HttpCache::DeleteBackgroundFetch(const std::string& key) {
+  BackgroundFetchMap::iterator it = background_fetches_.find(key);
+  DCHECK(it != background_fetches_.end());
+  BackgroundFetch* fetch = it->second;
+  background_fetches_.erase(it);
+  delete fetch;
+}
+
 void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   entry->will_process_pending_queue = false;
-  DCHECK(!entry->writer);
+
+  if (entry->writer) {
+    // The transactions that can follow the writer don't have to wait for it,
+    // as long as they don't skip the queue.
+    if (!entry->tailing_allowed || entry->pending_queue.empty())
+      return;
+
+    Transaction* next = entry->pending_queue.front();
+    if (!next->StartTailingWriter())
+      return;  // Have to wait.
+
+    entry->pending_queue.erase(entry->pending_queue.begin());
+    entry->readers.push_back(next);
+    if (!entry->pending_queue.empty())
+      ProcessPendingQueue(entry);
+
+    next->io_callback().Run(OK);
+    return;
+  }
 
   // If no one is interested in this entry, then we can deactivate it.
   if (entry->pending_queue.empty()) {
@@ -31,7 +31,9 @@
 #include "net/base/completion_callback.h"
 #include "net/base/load_states.h"
 #include "net/base/net_export.h"
+#include "net/base/request_priority.h"
 #include "net/http/http_transaction_factory.h"
+#include "net/http/sparse_range_cache.h"
 
 class GURL;
 
@@ -175,10 +177,44 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   void WriteMetadata(const GURL& url, base::Time expected_response_time,
                      IOBuffer* buf, int buf_len);
 
+  // Loads the resource at |url| into the cache, headers and body, without a
+  // consumer for the response, with the network |priority|. Nothing is done if
+  // the resource is already being loaded, or read from the cache. The request
+  // has no cookies or credentials, so this is meant for resources that don't
+  // depend on them. This method returns without blocking, and there is no
+  // completion notification.
+  void Prefetch(const GURL& url, RequestPriority priority);
+
   // Get/Set the cache's mode.
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
 
+  // Get/Set the policy for revalidating stale responses in the background.
+  // When enabled, a response that has been stale for less than its
+  // stale-while-revalidate time is returned right away while a conditional
+  // request updates the cache. |default_stale_while_revalidate| is the time
+  // used for the responses without a stale-while-revalidate directive.
+  void set_stale_while_revalidate_enabled(bool value) {
+    stale_while_revalidate_enabled_ = value;
+  }
+  bool stale_while_revalidate_enabled() const {
+    return stale_while_revalidate_enabled_;
+  }
+  void set_default_stale_while_revalidate(base::TimeDelta value) {
+    default_stale_while_revalidate_ = value;
+  }
+  base::TimeDelta default_stale_while_revalidate() const {
+    return default_stale_while_revalidate_;
+  }
+
+  // Get/Set whether requests for a resource that is being stored can read the
+  // part of the response that is already in the cache while the network
+  // transaction keeps writing the rest, instead of waiting for it to finish.
+  void set_tailing_readers_enabled(bool value) {
+    tailing_readers_enabled_ = value;
+  }
+  bool tailing_readers_enabled() const { return tailing_readers_enabled_; }
+
   // Close currently active sockets so that fresh page loads will not use any
   // recycled connections.  For sockets currently in use, they may not close
   // immediately, but they will not be reusable. This is for debugging.
@@ -211,6 +247,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
  private:
   // Types --------------------------------------------------------------------
 
+  class BackgroundFetch;
   class MetadataWriter;
   class SSLHostInfoFactoryAdaptor;
   class Transaction;
@@ -231,12 +268,16 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+    bool               tailing_allowed;  // Readers can follow the writer.
+    // The stored ranges of a sparse entry, shared by its transactions.
+    SparseRangeCache   sparse_ranges;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
   typedef base::hash_map<std::string, PendingOp*> PendingOpsMap;
   typedef std::set<ActiveEntry*> ActiveEntriesSet;
   typedef base::hash_map<std::string, int> PlaybackCacheMap;
+  typedef base::hash_map<std::string, BackgroundFetch*> BackgroundFetchMap;
 
   // Methods ------------------------------------------------------------------
 
@@ -330,6 +371,15 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Lets the transactions waiting for |entry| read the response that its writer
+  // is storing, while it is being written.
+  void AllowTailingReaders(ActiveEntry* entry);
+
+  // Tells the readers that follow the writer of |entry| that more data is
+  // available (|result| > 0), that the writer is done (OK), or that it failed
+  // to store the whole response (a net error).
+  void NotifyTailingReaders(ActiveEntry* entry, int result);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -348,6 +398,18 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // Resumes processing the pending list of |entry|.
   void ProcessPendingQueue(ActiveEntry* entry);
 
+  // Revalidates in the background the cached response for |request|, which
+  // is being served stale. Requests that want to revalidate the same entry
+  // while the validation is running join it instead of starting another one.
+  void PerformAsyncValidation(const HttpRequestInfo& request);
+
+  // Fetches |request| into the cache without a consumer, unless the same
+  // resource is already being fetched that way.
+  void StartBackgroundFetch(const HttpRequestInfo& request);
+
+  // Called by |BackgroundFetch| when it completes, to delete itself.
+  void DeleteBackgroundFetch(const std::string& key);
+
   // Events (called via PostTask) ---------------------------------------------
 
   void OnProcessPendingQueue(ActiveEntry* entry);
@@ -396,6 +458,14 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   scoped_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  bool stale_while_revalidate_enabled_;
+  base::TimeDelta default_stale_while_revalidate_;
+  bool tailing_readers_enabled_;
+
+  // The validations and prefetches running in the background, indexed by
+  // cache key.
+  BackgroundFetchMap background_fetches_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpCache);
 };
 
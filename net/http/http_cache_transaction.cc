@@ -15,6 +15,7 @@
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/string_util.h"
@@ -118,6 +119,9 @@ HttpCache::Transaction::Transaction(HttpCache* cache)
       handling_206_(false),
       cache_pending_(false),
       done_reading_(false),
+      tailing_writer_(false),
+      writer_failed_(false),
+      waiting_for_writer_(false),
       read_offset_(0),
       effective_load_flags_(0),
       write_len_(0),
@@ -199,6 +203,42 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
   return true;
 }
 
+bool HttpCache::Transaction::StartTailingWriter() {
+  if (mode_ != READ_WRITE && mode_ != READ)
+    return false;
+
+  // Byte ranges are always served from complete entries.
+  if (partial_.get() || request_->method != "GET")
+    return false;
+
+  // The response that is being stored is as fresh as it gets, so there is no
+  // need to validate it.
+  mode_ = READ;
+  tailing_writer_ = true;
+  return true;
+}
+
+void HttpCache::Transaction::OnWriterProgress(int result) {
+  if (!tailing_writer_ || writer_failed_)
+    return;
+
+  if (result < 0) {
+    writer_failed_ = true;
+  } else if (result == OK) {
+    tailing_writer_ = false;
+  }
+
+  if (!waiting_for_writer_)
+    return;
+
+  // Resume the read from a new task, instead of from within the writer.
+  waiting_for_writer_ = false;
+  next_state_ = STATE_CACHE_READ_DATA;
+  MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&Transaction::OnIOComplete, weak_factory_.GetWeakPtr(), OK));
+}
+
 LoadState HttpCache::Transaction::GetWriterLoadState() const {
   if (network_trans_.get())
     return network_trans_->GetLoadState();
@@ -1014,7 +1054,8 @@ int HttpCache::Transaction::DoStartPartialCacheValidation() {
     return OK;
 
   next_state_ = STATE_COMPLETE_PARTIAL_CACHE_VALIDATION;
-  return partial_->ShouldValidateCache(entry_->disk_entry, io_callback_);
+  return partial_->ShouldValidateCache(entry_->disk_entry,
+                                       &entry_->sparse_ranges, io_callback_);
 }
 
 int HttpCache::Transaction::DoCompletePartialCacheValidation(int result) {
@@ -1032,7 +1073,7 @@ int HttpCache::Transaction::DoCompletePartialCacheValidation(int result) {
   if (result < 0)
     return result;
 
-  partial_->PrepareCacheValidation(entry_->disk_entry,
+  partial_->PrepareCacheValidation(entry_->disk_entry, &entry_->sparse_ranges,
                                    &custom_request_->extra_headers);
 
   if (reading_ && partial_->IsCurrentRangeCached()) {
@@ -1135,6 +1176,8 @@ int HttpCache::Transaction::DoTruncateCachedData() {
   if (net_log_.IsLoggingAllEvents())
     net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_WRITE_DATA, NULL);
 
+  entry_->sparse_ranges.Clear();
+
   // Truncate the stream.
   return WriteToEntry(kResponseContentIndex, 0, NULL, 0, io_callback_);
 }
@@ -1169,6 +1212,8 @@ int HttpCache::Transaction::DoTruncateCachedMetadataComplete(int result) {
   // need to cache the response body of a redirect.)
   if (response_.headers->IsRedirect(NULL))
     DoneWritingToEntry(true);
+  else if (entry_ && CanBeTailed())
+    cache_->AllowTailingReaders(entry_);
   next_state_ = STATE_PARTIAL_HEADERS_RECEIVED;
   return OK;
 }
@@ -1348,6 +1393,8 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
 
   if (result > 0) {
     read_offset_ += result;
+  } else if (result == 0 && tailing_writer_) {
+    return WaitForWriter();
   } else if (result == 0) {  // End of file.
     cache_->DoneReadingFromEntry(entry_, this);
     entry_ = NULL;
@@ -1389,6 +1436,12 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       done_reading_ = true;
   }
 
+  if (partial_.get() && entry_ && result > 0)
+    partial_->OnCacheWriteCompleted(&entry_->sparse_ranges, result);
+
+  if (result > 0 && entry_)
+    cache_->NotifyTailingReaders(entry_, result);
+
   if (partial_.get()) {
     // This may be the last request.
     if (!(result == 0 && !truncated_ &&
@@ -1564,8 +1617,15 @@ int HttpCache::Transaction::BeginCacheRead() {
 int HttpCache::Transaction::BeginCacheValidation() {
   DCHECK(mode_ == READ_WRITE);
 
+  ValidationType required_validation = RequiresValidation();
   bool skip_validation = effective_load_flags_ & LOAD_PREFERRING_CACHE ||
-                         !RequiresValidation();
+                         required_validation == VALIDATION_NONE;
+
+  // Partial entries are always validated before using them.
+  bool async_validation = !skip_validation && !partial_.get() &&
+                          required_validation == VALIDATION_ASYNCHRONOUS;
+  if (async_validation)
+    skip_validation = true;
 
   if (truncated_)
     skip_validation = !partial_->initial_validation();
@@ -1583,6 +1643,11 @@ int HttpCache::Transaction::BeginCacheValidation() {
     cache_->ConvertWriterToReader(entry_);
     mode_ = READ;
 
+    // The validation waits for us to finish reading the stale response, and
+    // the requests that come after it wait for the updated one.
+    if (async_validation)
+      cache_->PerformAsyncValidation(*request_);
+
     if (entry_->disk_entry->GetDataSize(kMetadataIndex))
       next_state_ = STATE_CACHE_READ_METADATA;
   } else {
@@ -1713,27 +1778,38 @@ int HttpCache::Transaction::RestartNetworkRequestWithAuth(
   return rv;
 }
 
-bool HttpCache::Transaction::RequiresValidation() {
+HttpCache::Transaction::ValidationType
+HttpCache::Transaction::RequiresValidation() {
   // TODO(darin): need to do more work here:
   //  - make sure we have a matching request method
   //  - watch out for cached responses that depend on authentication
   // In playback mode, nothing requires validation.
   if (cache_->mode() == net::HttpCache::PLAYBACK)
-    return false;
+    return VALIDATION_NONE;
 
   if (effective_load_flags_ & LOAD_VALIDATE_CACHE)
-    return true;
+    return VALIDATION_SYNCHRONOUS;
 
+  ValidationType validation = VALIDATION_NONE;
+  Time now = Time::Now();
   if (response_.headers->RequiresValidation(
-          response_.request_time, response_.response_time, Time::Now()))
-    return true;
+          response_.request_time, response_.response_time, now)) {
+    if (!cache_->stale_while_revalidate_enabled() ||
+        request_->method != "GET" ||
+        !response_.headers->IsStaleWhileRevalidateAllowed(
+            response_.request_time, response_.response_time, now,
+            cache_->default_stale_while_revalidate())) {
+      return VALIDATION_SYNCHRONOUS;
+    }
+    validation = VALIDATION_ASYNCHRONOUS;
+  }
 
   // Since Vary header computation is fairly expensive, we save it for last.
   if (response_.vary_data.is_valid() &&
       !response_.vary_data.MatchesRequest(*request_, *response_.headers))
-    return true;
+    return VALIDATION_SYNCHRONOUS;
 
-  return false;
+  return validation;
 }
 
 bool HttpCache::Transaction::ConditionalizeRequest() {
@@ -2089,6 +2165,28 @@ int HttpCache::Transaction::DoPartialCacheReadCompleted(int result) {
 //   Strong Validator + ranges.... 24%
 //   Strong Validator + CL........ 49%
 //
+bool HttpCache::Transaction::CanBeTailed() {
+  return mode_ == WRITE && !partial_.get() && request_->method == "GET" &&
+         cache_->mode() == NORMAL &&
+         response_.headers->response_code() == 200 &&
+         !response_.headers->HasHeader("vary");
+}
+
+int HttpCache::Transaction::WaitForWriter() {
+  // The writer already doomed the entry.
+  if (writer_failed_)
+    return ERR_CACHE_READ_FAILURE;
+
+  // The writer may have stored more data while we were reading.
+  if (read_offset_ < entry_->disk_entry->GetDataSize(kResponseContentIndex)) {
+    next_state_ = STATE_CACHE_READ_DATA;
+    return OK;
+  }
+
+  waiting_for_writer_ = true;
+  return ERR_IO_PENDING;
+}
+
 bool HttpCache::Transaction::CanResume(bool has_data) {
   // Double check that there is something worth keeping.
   if (has_data && !entry_->disk_entry->GetDataSize(kResponseContentIndex))
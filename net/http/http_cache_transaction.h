@@ -96,6 +96,15 @@ class HttpCache::Transaction : public HttpTransaction {
 
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // Called by the cache when this transaction is at the front of the queue of
+  // an entry whose writer lets other transactions read the response while it
+  // is being stored. Returns true if this transaction can read that response.
+  bool StartTailingWriter();
+
+  // Called by the cache when the writer that this transaction follows appends
+  // data to the entry (|result| > 0), finishes (OK) or fails (a net error).
+  void OnWriterProgress(int result);
+
   const BoundNetLog& net_log() const;
 
   // HttpTransaction methods:
@@ -129,6 +138,13 @@ class HttpCache::Transaction : public HttpTransaction {
     bool initialized;
   };
 
+  // The kind of validation that a cache entry requires.
+  enum ValidationType {
+    VALIDATION_NONE,          // The entry can be used as it is.
+    VALIDATION_SYNCHRONOUS,   // The entry must be validated before using it.
+    VALIDATION_ASYNCHRONOUS   // The entry can be used while it is validated.
+  };
+
   enum State {
     STATE_NONE,
     STATE_GET_BACKEND,
@@ -264,8 +280,9 @@ class HttpCache::Transaction : public HttpTransaction {
   // Returns network error code.
   int RestartNetworkRequestWithAuth(const AuthCredentials& credentials);
 
-  // Called to determine if we need to validate the cache entry before using it.
-  bool RequiresValidation();
+  // Called to determine if we need to validate the cache entry before using it,
+  // or if it can be used while it is validated in the background.
+  ValidationType RequiresValidation();
 
   // Called to make the request conditional (to ask the server if the cached
   // copy is valid).  Returns true if able to make the request conditional.
@@ -324,6 +341,14 @@ class HttpCache::Transaction : public HttpTransaction {
   // working with range requests.
   int DoPartialCacheReadCompleted(int result);
 
+  // Returns true if other transactions can read the response that we are
+  // storing while it is being written.
+  bool CanBeTailed();
+
+  // Called when the reader of a response that is still being written reaches
+  // the end of the stored data.
+  int WaitForWriter();
+
   // Returns true if we should bother attempting to resume this request if it
   // is aborted while in progress. If |has_data| is true, the size of the stored
   // data is considered for the result.
@@ -360,6 +385,9 @@ class HttpCache::Transaction : public HttpTransaction {
   bool handling_206_;  // We must deal with this 206 response.
   bool cache_pending_;  // We are waiting for the HttpCache.
   bool done_reading_;
+  bool tailing_writer_;  // We read what the writer of the entry stores.
+  bool writer_failed_;  // The writer that we follow did not finish.
+  bool waiting_for_writer_;  // We have to wait for the writer to store data.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
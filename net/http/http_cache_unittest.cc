@@ -921,6 +921,46 @@ TEST(HttpCache, SimpleGET_ManyReaders) {
   }
 }
 
+// Tests that a request can read the response that another one is storing,
+// while it is being written.
+TEST(HttpCache, SimpleGET_TailingReader) {
+  MockHttpCache cache;
+  cache.http_cache()->set_tailing_readers_enabled(true);
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+  net::TestCompletionCallback callback1, callback2;
+  scoped_ptr<net::HttpTransaction> writer, reader;
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&writer));
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&reader));
+
+  int rv = writer->Start(&request, callback1.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, callback1.GetResult(rv));
+
+  // The reader gets the headers before the writer reads the body.
+  rv = reader->Start(&request, callback2.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, callback2.GetResult(rv));
+  EXPECT_TRUE(reader->GetResponseInfo()->was_cached);
+
+  // And it waits for the body.
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  rv = reader->Read(buf, 256, callback2.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  ReadAndVerifyTransaction(writer.get(), kSimpleGET_Transaction);
+
+  std::string expected(kSimpleGET_Transaction.data);
+  rv = callback2.WaitForResult();
+  ASSERT_EQ(static_cast<int>(expected.size()), rv);
+  EXPECT_EQ(expected, std::string(buf->data(), rv));
+
+  rv = reader->Read(buf, 256, callback2.callback());
+  EXPECT_EQ(0, callback2.GetResult(rv));
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
 // This is a test for http://code.google.com/p/chromium/issues/detail?id=4769.
 // If cancelling a request is racing with another request for the same resource
 // finishing, we have to make sure that we remove both transactions from the
@@ -1686,6 +1726,104 @@ TEST(HttpCache, ETagGET_ConditionalRequest_304_NoStore) {
   EXPECT_EQ(2, cache.disk_cache()->create_count());
 }
 
+// Tests that a prefetch stores the response, and that it does nothing when the
+// response is already in the cache.
+TEST(HttpCache, SimpleGET_Prefetch) {
+  MockHttpCache cache;
+
+  cache.http_cache()->Prefetch(GURL(kSimpleGET_Transaction.url), net::IDLE);
+  MessageLoop::current()->RunAllPending();
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  net::HttpResponseInfo response;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), kSimpleGET_Transaction,
+                                     &response);
+  EXPECT_TRUE(response.was_cached);
+
+  cache.http_cache()->Prefetch(GURL(kSimpleGET_Transaction.url), net::IDLE);
+  MessageLoop::current()->RunAllPending();
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a stale response within its stale-while-revalidate time is
+// returned from the cache, and revalidated in the background.
+TEST(HttpCache, ETagGET_StaleWhileRevalidate) {
+  MockHttpCache cache;
+  cache.http_cache()->set_stale_while_revalidate_enabled(true);
+
+  ScopedMockTransaction transaction(kETagGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=0, stale-while-revalidate=3600\n"
+      "Etag: foopy\n";
+
+  // Write to the cache.
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  // The stale entry is used, and a conditional request updates it.
+  transaction.handler = ETagGet_ConditionalRequest_Handler;
+  net::HttpResponseInfo response;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), transaction,
+                                     &response);
+  EXPECT_TRUE(response.was_cached);
+  MessageLoop::current()->RunAllPending();
+
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  // The 304 made the entry fresh again.
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a request that arrives while a stale entry is being revalidated
+// waits for the validation instead of starting another one.
+TEST(HttpCache, ETagGET_StaleWhileRevalidate_Join) {
+  MockHttpCache cache;
+  cache.http_cache()->set_stale_while_revalidate_enabled(true);
+
+  ScopedMockTransaction transaction(kETagGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=0, stale-while-revalidate=3600\n"
+      "Etag: foopy\n";
+
+  // Write to the cache.
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  transaction.handler = ETagGet_ConditionalRequest_Handler;
+  MockHttpRequest request(transaction);
+  net::TestCompletionCallback callback1, callback2;
+  scoped_ptr<net::HttpTransaction> trans1, trans2;
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&trans1));
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&trans2));
+
+  int rv = trans1->Start(&request, callback1.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, callback1.GetResult(rv));
+  EXPECT_TRUE(trans1->GetResponseInfo()->was_cached);
+
+  // The second request is queued behind the validation.
+  rv = trans2->Start(&request, callback2.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  ReadAndVerifyTransaction(trans1.get(), transaction);
+  trans1.reset();
+
+  EXPECT_EQ(net::OK, callback2.WaitForResult());
+  ReadAndVerifyTransaction(trans2.get(), transaction);
+
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
 // Helper that does 4 requests using HttpCache:
 //
 // (1) loads |kUrl| -- expects |net_response_1| to be returned.
@@ -43,6 +43,7 @@ void HttpNetworkLayer::EnableSpdy(const std::string& mode) {
   static const char kSSL[] = "ssl";
   static const char kDisableSSL[] = "no-ssl";
   static const char kDisablePing[] = "no-ping";
+  static const char kWindowAutotuning[] = "window-autotuning";
   static const char kExclude[] = "exclude";  // Hosts to exclude
   static const char kDisableCompression[] = "no-compress";
   static const char kDisableAltProtocols[] = "no-alt-protocols";
@@ -74,6 +75,8 @@ void HttpNetworkLayer::EnableSpdy(const std::string& mode) {
       HttpStreamFactory::set_force_spdy_always(true);
     } else if (option == kDisablePing) {
       SpdySession::set_enable_ping_based_connection_checking(false);
+    } else if (option == kWindowAutotuning) {
+      SpdySession::set_enable_window_autotuning(true);
     } else if (option == kExclude) {
       HttpStreamFactory::add_forced_spdy_exclusion(value);
     } else if (option == kDisableCompression) {
@@ -132,6 +132,15 @@ void CheckDoesNotHaveEmbededNulls(const std::string& str) {
   CHECK(str.find('\0') == std::string::npos);
 }
 
+// Returns a hash of a header name which ignores the case.
+size_t HashHeaderName(std::string::const_iterator name_begin,
+                      std::string::const_iterator name_end) {
+  size_t hash = 0;
+  for (; name_begin != name_end; ++name_begin)
+    hash = hash * 31 + base::ToLowerASCII(*name_begin);
+  return hash;
+}
+
 }  // namespace
 
 struct HttpResponseHeaders::ParsedHeader {
@@ -143,6 +152,10 @@ struct HttpResponseHeaders::ParsedHeader {
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
   std::string::const_iterator value_end;
+
+  // Index in parsed_ of the next header whose name has the same hash, or
+  // string::npos.  Unused by continuations.
+  size_t next_same_hash;
 };
 
 //-----------------------------------------------------------------------------
@@ -393,6 +406,7 @@ void HttpResponseHeaders::ReplaceStatusLine(const std::string& new_status) {
 }
 
 void HttpResponseHeaders::Parse(const std::string& raw_input) {
+  header_index_.clear();
   raw_headers_.reserve(raw_input.size());
 
   // ParseStatusLine adds a normalized status line to raw_headers_
@@ -735,8 +749,14 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const std::string& search) const {
-  for (size_t i = from; i < parsed_.size(); ++i) {
-    if (parsed_[i].is_continuation())
+  HeaderIndex::const_iterator it =
+      header_index_.find(HashHeaderName(search.begin(), search.end()));
+  if (it == header_index_.end())
+    return std::string::npos;
+
+  for (size_t i = it->second.first; i != std::string::npos;
+       i = parsed_[i].next_same_hash) {
+    if (i < from)
       continue;
     const std::string::const_iterator& name_begin = parsed_[i].name_begin;
     const std::string::const_iterator& name_end = parsed_[i].name_end;
@@ -776,6 +796,18 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
   header.name_end = name_end;
   header.value_begin = value_begin;
   header.value_end = value_end;
+  header.next_same_hash = std::string::npos;
+
+  if (!header.is_continuation()) {
+    size_t index = parsed_.size();
+    std::pair<HeaderIndex::iterator, bool> result = header_index_.insert(
+        std::make_pair(HashHeaderName(name_begin, name_end),
+                       std::make_pair(index, index)));
+    if (!result.second) {
+      parsed_[result.first->second.second].next_same_hash = index;
+      result.first->second.second = index;
+    }
+  }
   parsed_.push_back(header);
 }
 
@@ -932,6 +964,42 @@ bool HttpResponseHeaders::RequiresValidation(const Time& request_time,
   return lifetime <= GetCurrentAge(request_time, response_time, current_time);
 }
 
+// From RFC 5861 section 3:
+//
+//   When present in an HTTP response, the stale-while-revalidate Cache-Control
+//   extension indicates that caches MAY serve the response in which it
+//   appears after it becomes stale, up to the indicated number of seconds.
+//
+// The directive does not override no-cache, no-store or must-revalidate, which
+// demand a validation before every use of a stale response.  A default window
+// is only applied to responses that were fresh for some time.
+//
+bool HttpResponseHeaders::IsStaleWhileRevalidateAllowed(
+    const Time& request_time,
+    const Time& response_time,
+    const Time& current_time,
+    const TimeDelta& default_window) const {
+  if (HasHeaderValue("cache-control", "no-cache") ||
+      HasHeaderValue("cache-control", "no-store") ||
+      HasHeaderValue("cache-control", "must-revalidate") ||
+      HasHeaderValue("pragma", "no-cache"))
+    return false;
+
+  TimeDelta lifetime = GetFreshnessLifetime(response_time);
+  TimeDelta window;
+  if (!GetStaleWhileRevalidateValue(&window)) {
+    if (lifetime == TimeDelta())
+      return false;
+    window = default_window;
+  }
+  if (window <= TimeDelta())
+    return false;
+
+  TimeDelta staleness =
+      GetCurrentAge(request_time, response_time, current_time) - lifetime;
+  return staleness < window;
+}
+
 // From RFC 2616 section 13.2.4:
 //
 // The max-age directive takes priority over Expires, so if max-age is present
@@ -1077,21 +1145,21 @@ TimeDelta HttpResponseHeaders::GetCurrentAge(const Time& request_time,
   return current_age;
 }
 
-bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
+bool HttpResponseHeaders::GetCacheControlDirective(const std::string& directive,
+                                                   TimeDelta* result) const {
   std::string name = "cache-control";
   std::string value;
 
-  const char kMaxAgePrefix[] = "max-age=";
-  const size_t kMaxAgePrefixLen = arraysize(kMaxAgePrefix) - 1;
+  size_t directive_size = directive.size();
 
   void* iter = NULL;
   while (EnumerateHeader(&iter, name, &value)) {
-    if (value.size() > kMaxAgePrefixLen) {
+    if (value.size() > directive_size) {
       if (LowerCaseEqualsASCII(value.begin(),
-                               value.begin() + kMaxAgePrefixLen,
-                               kMaxAgePrefix)) {
+                               value.begin() + directive_size,
+                               directive.c_str())) {
         int64 seconds;
-        base::StringToInt64(StringPiece(value.begin() + kMaxAgePrefixLen,
+        base::StringToInt64(StringPiece(value.begin() + directive_size,
                                         value.end()),
                             &seconds);
         *result = TimeDelta::FromSeconds(seconds);
@@ -1103,6 +1171,15 @@ bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
   return false;
 }
 
+bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
+  return GetCacheControlDirective("max-age=", result);
+}
+
+bool HttpResponseHeaders::GetStaleWhileRevalidateValue(
+    TimeDelta* result) const {
+  return GetCacheControlDirective("stale-while-revalidate=", result);
+}
+
 bool HttpResponseHeaders::GetAgeValue(TimeDelta* result) const {
   std::string value;
   if (!EnumerateHeader(NULL, "Age", &value))
@@ -206,10 +206,22 @@ class NET_EXPORT HttpResponseHeaders
                                 const base::Time& response_time,
                                 const base::Time& current_time) const;
 
+  // Returns true if the response, once it requires validation, can still be
+  // used while it is revalidated in the background, because it has been stale
+  // for less than its stale-while-revalidate time (RFC 5861) or, when there is
+  // no such directive, less than |default_window|.  See RequiresValidation for
+  // a description of the other parameters.
+  bool IsStaleWhileRevalidateAllowed(const base::Time& request_time,
+                                     const base::Time& response_time,
+                                     const base::Time& current_time,
+                                     const base::TimeDelta& default_window)
+      const;
+
   // The following methods extract values from the response headers.  If a
   // value is not present, then false is returned.  Otherwise, true is returned
   // and the out param is assigned to the corresponding value.
   bool GetMaxAgeValue(base::TimeDelta* value) const;
+  bool GetStaleWhileRevalidateValue(base::TimeDelta* value) const;
   bool GetAgeValue(base::TimeDelta* value) const;
   bool GetDateValue(base::Time* value) const;
   bool GetLastModifiedValue(base::Time* value) const;
@@ -261,6 +273,10 @@ class NET_EXPORT HttpResponseHeaders
   struct ParsedHeader;
   typedef std::vector<ParsedHeader> HeaderList;
 
+  // Maps the case-insensitive hash of a header name to the indices in
+  // parsed_ of the first and the last headers with a name of that hash.
+  typedef base::hash_map<size_t, std::pair<size_t, size_t> > HeaderIndex;
+
   HttpResponseHeaders();
   ~HttpResponseHeaders();
 
@@ -285,8 +301,15 @@ class NET_EXPORT HttpResponseHeaders
                        std::string::const_iterator line_end,
                        bool has_headers);
 
+  // Looks for a Cache-Control directive of the form |directive|=<seconds>,
+  // where |directive| includes the '=' sign, and returns its value in
+  // |result|.  Returns false if the directive is not present.
+  bool GetCacheControlDirective(const std::string& directive,
+                                base::TimeDelta* result) const;
+
   // Find the header in our list (case-insensitive) starting with parsed_ at
-  // index |from|.  Returns string::npos if not found.
+  // index |from|.  Returns string::npos if not found.  Only the headers with
+  // the same name hash are compared, using header_index_.
   size_t FindHeader(size_t from, const std::string& name) const;
 
   // Add a header->value pair to our list.  If we already have header in our
@@ -344,6 +367,9 @@ class NET_EXPORT HttpResponseHeaders
   // header-value pairs within raw_headers_.
   HeaderList parsed_;
 
+  // Index of the names of parsed_, built with it.
+  HeaderIndex header_index_;
+
   // The raw_headers_ consists of the normalized status line (terminated with a
   // null byte) and then followed by the raw null-terminated headers from the
   // input that was passed to our constructor.  We preserve the input [*] to
@@ -0,0 +1,149 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_response_headers.h"
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/perftimer.h"
+#include "base/time.h"
+#include "net/http/http_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 20000;
+
+// Response headers captured from popular sites.
+const char* const kCorpus[] = {
+  "HTTP/1.1 200 OK\n"
+  "Date: Mon, 14 May 2012 18:34:56 GMT\n"
+  "Expires: -1\n"
+  "Cache-Control: private, max-age=0\n"
+  "Content-Type: text/html; charset=UTF-8\n"
+  "Set-Cookie: PREF=ID=1bc0a2b3c4d5e6f7:FF=0:TM=1337020496:LM=1337020496:"
+      "S=AbCdEfGhIjKlMnOp; expires=Wed, 14-May-2014 18:34:56 GMT; path=/; "
+      "domain=.example.com\n"
+  "Set-Cookie: NID=59=AbCdEfGhIjKlMnOpQrStUvWxYz; expires=Tue, 13-Nov-2012 "
+      "18:34:56 GMT; path=/; domain=.example.com; HttpOnly\n"
+  "P3P: CP=\"This is not a P3P policy!\"\n"
+  "Content-Encoding: gzip\n"
+  "Server: gws\n"
+  "Content-Length: 17865\n"
+  "X-XSS-Protection: 1; mode=block\n"
+  "X-Frame-Options: SAMEORIGIN\n\n",
+
+  "HTTP/1.1 200 OK\n"
+  "Server: Apache\n"
+  "Last-Modified: Fri, 11 May 2012 09:12:43 GMT\n"
+  "ETag: \"1a2b3c-5d6e-4bf01234abcde\"\n"
+  "Accept-Ranges: bytes\n"
+  "Content-Type: image/png\n"
+  "Cache-Control: max-age=31536000\n"
+  "Expires: Tue, 14 May 2013 18:34:56 GMT\n"
+  "Date: Mon, 14 May 2012 18:34:56 GMT\n"
+  "Content-Length: 3942\n"
+  "Connection: keep-alive\n\n",
+
+  "HTTP/1.1 304 Not Modified\n"
+  "Date: Mon, 14 May 2012 18:34:57 GMT\n"
+  "Server: nginx\n"
+  "Connection: keep-alive\n"
+  "Keep-Alive: timeout=20\n"
+  "ETag: \"4fb01234-1f2e\"\n"
+  "Expires: Thu, 14 Jun 2012 18:34:57 GMT\n"
+  "Cache-Control: max-age=2678400, public\n"
+  "Vary: Accept-Encoding\n\n",
+
+  "HTTP/1.1 302 Found\n"
+  "Location: http://www.example.com/landing?src=redirect\n"
+  "Cache-Control: private\n"
+  "Content-Type: text/html; charset=UTF-8\n"
+  "Date: Mon, 14 May 2012 18:34:58 GMT\n"
+  "Server: GFE/2.0\n"
+  "Content-Length: 231\n"
+  "X-XSS-Protection: 1; mode=block\n\n",
+
+  "HTTP/1.1 200 OK\n"
+  "Content-Type: application/javascript\n"
+  "Content-Encoding: gzip\n"
+  "Vary: Accept-Encoding, User-Agent\n"
+  "Cache-Control: public, max-age=86400, s-maxage=3600\n"
+  "Access-Control-Allow-Origin: *\n"
+  "Age: 1234\n"
+  "Date: Mon, 14 May 2012 18:34:59 GMT\n"
+  "Last-Modified: Thu, 10 May 2012 01:02:03 GMT\n"
+  "X-Cache: HIT from cache.example.net\n"
+  "X-Cache-Lookup: HIT from cache.example.net:80\n"
+  "Via: 1.1 cache.example.net:80 (squid/2.7.STABLE9)\n"
+  "Connection: keep-alive\n"
+  "Content-Length: 48211\n\n",
+};
+
+// The lookups done on most responses by the HTTP cache and the URL request
+// job.
+void LookUpHeaders(const HttpResponseHeaders& headers) {
+  std::string value;
+  headers.GetNormalizedHeader("content-type", &value);
+  headers.HasHeaderValue("cache-control", "no-store");
+  headers.HasHeaderValue("cache-control", "no-cache");
+  headers.HasHeaderValue("pragma", "no-cache");
+  headers.HasHeader("vary");
+  headers.HasHeader("content-encoding");
+  headers.HasHeader("etag");
+  headers.HasHeader("last-modified");
+  void* iter = NULL;
+  while (headers.EnumerateHeader(&iter, "set-cookie", &value)) {}
+  base::TimeDelta max_age;
+  headers.GetMaxAgeValue(&max_age);
+  base::Time time;
+  headers.GetDateValue(&time);
+  headers.GetExpiresValue(&time);
+  headers.GetContentLength();
+  headers.IsKeepAlive();
+}
+
+}  // namespace
+
+TEST(HttpResponseHeadersPerfTest, ParseAndLookUp) {
+  std::vector<std::string> raw_headers;
+  for (size_t i = 0; i < arraysize(kCorpus); ++i) {
+    std::string input(kCorpus[i]);
+    raw_headers.push_back(HttpUtil::AssembleRawHeaders(input.data(),
+                                                       input.size()));
+  }
+
+  PerfTimeLogger timer("HttpResponseHeaders_ParseAndLookUp");
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < raw_headers.size(); ++j) {
+      scoped_refptr<HttpResponseHeaders> headers(
+          new HttpResponseHeaders(raw_headers[j]));
+      LookUpHeaders(*headers);
+    }
+  }
+  timer.Done();
+}
+
+TEST(HttpResponseHeadersPerfTest, LookUp) {
+  std::vector<scoped_refptr<HttpResponseHeaders> > headers;
+  for (size_t i = 0; i < arraysize(kCorpus); ++i) {
+    std::string input(kCorpus[i]);
+    headers.push_back(new HttpResponseHeaders(
+        HttpUtil::AssembleRawHeaders(input.data(), input.size())));
+  }
+
+  PerfTimeLogger timer("HttpResponseHeaders_LookUp");
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < headers.size(); ++j)
+      LookUpHeaders(*headers[j]);
+  }
+  timer.Done();
+}
+
+}  // namespace net
@@ -527,6 +527,46 @@ TEST(HttpResponseHeadersTest, EnumerateHeader_Challenge) {
   EXPECT_FALSE(parsed->EnumerateHeader(&iter, "WWW-Authenticate", &value));
 }
 
+TEST(HttpResponseHeadersTest, EnumerateHeader_Interleaved) {
+  // Repeated headers are found in order, across other headers and after the
+  // headers are modified.
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Set-Cookie: a=1\n"
+      "Content-Type: text/html\n"
+      "set-cookie: b=2\n"
+      "Vary: Accept-Encoding\n"
+      "SET-COOKIE: c=3\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<net::HttpResponseHeaders> parsed(
+      new net::HttpResponseHeaders(headers));
+
+  void* iter = NULL;
+  std::string value;
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "Set-Cookie", &value));
+  EXPECT_EQ("a=1", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "Set-Cookie", &value));
+  EXPECT_EQ("b=2", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "Set-Cookie", &value));
+  EXPECT_EQ("c=3", value);
+  EXPECT_FALSE(parsed->EnumerateHeader(&iter, "Set-Cookie", &value));
+  EXPECT_FALSE(parsed->HasHeader("Cookie"));
+
+  parsed->RemoveHeader("content-type");
+  parsed->AddHeader("Set-Cookie: d=4");
+  EXPECT_FALSE(parsed->HasHeader("Content-Type"));
+  EXPECT_TRUE(parsed->HasHeader("vary"));
+  iter = NULL;
+  std::string last_value;
+  int count = 0;
+  while (parsed->EnumerateHeader(&iter, "set-cookie", &value)) {
+    last_value = value;
+    ++count;
+  }
+  EXPECT_EQ(4, count);
+  EXPECT_EQ("d=4", last_value);
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_DateValued) {
   // The comma in a date valued header should not be treated as a
   // field-value separator
@@ -840,6 +880,94 @@ TEST(HttpResponseHeadersTest, RequiresValidation) {
   }
 }
 
+TEST(HttpResponseHeadersTest, IsStaleWhileRevalidateAllowed) {
+  const struct {
+    const char* headers;
+    int default_window;  // In seconds.
+    bool allowed;
+  } tests[] = {
+    // stale for 5 minutes, within the window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=0, stale-while-revalidate=3600\n"
+      "\n",
+      0,
+      true
+    },
+    // stale for 5 minutes, outside of the window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=0, stale-while-revalidate=60\n"
+      "\n",
+      0,
+      false
+    },
+    // the window starts when the response becomes stale
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=260, stale-while-revalidate=60\n"
+      "\n",
+      0,
+      true
+    },
+    // the directive overrides the default window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10, stale-while-revalidate=60\n"
+      "\n",
+      3600,
+      false
+    },
+    // default window for a response that was fresh for a while
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10\n"
+      "\n",
+      3600,
+      true
+    },
+    // no default window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10\n"
+      "\n",
+      0,
+      false
+    },
+    // no expiry info: the default window does not apply
+    { "HTTP/1.1 200 OK\n"
+      "\n",
+      3600,
+      false
+    },
+    // must-revalidate overrides the directive
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=0, must-revalidate\n"
+      "cache-control: stale-while-revalidate=3600\n"
+      "\n",
+      3600,
+      false
+    },
+    // no-cache overrides the directive
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: no-cache, stale-while-revalidate=3600\n"
+      "\n",
+      3600,
+      false
+    },
+  };
+  base::Time request_time, response_time, current_time;
+  base::Time::FromString("Wed, 28 Nov 2007 00:40:09 GMT", &request_time);
+  base::Time::FromString("Wed, 28 Nov 2007 00:40:12 GMT", &response_time);
+  base::Time::FromString("Wed, 28 Nov 2007 00:45:20 GMT", &current_time);
+
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(tests); ++i) {
+    std::string headers(tests[i].headers);
+    HeadersToRaw(&headers);
+    scoped_refptr<net::HttpResponseHeaders> parsed(
+        new net::HttpResponseHeaders(headers));
+
+    bool allowed = parsed->IsStaleWhileRevalidateAllowed(
+        request_time, response_time, current_time,
+        base::TimeDelta::FromSeconds(tests[i].default_window));
+    EXPECT_EQ(tests[i].allowed, allowed) << i;
+  }
+}
+
 TEST(HttpResponseHeadersTest, Update) {
   const struct {
     const char* orig_headers;
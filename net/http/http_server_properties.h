@@ -43,6 +43,7 @@ typedef std::map<HostPortPair, PortAlternateProtocolPair> AlternateProtocolMap;
 typedef std::map<HostPortPair, SettingsMap> SpdySettingsMap;
 typedef std::map<HostPortPair,
         HttpPipelinedHostCapability> PipelineCapabilityMap;
+typedef std::map<HostPortPair, int> ConnectionDemandMap;
 
 extern const char kAlternateProtocolHeader[];
 extern const char* const kAlternateProtocolStrings[NUM_ALTERNATE_PROTOCOLS];
@@ -52,6 +53,7 @@ extern const char* const kAlternateProtocolStrings[NUM_ALTERNATE_PROTOCOLS];
 // * SPDY support (based on NPN results)
 // * Alternate-Protocol support
 // * Spdy Settings (like CWND ID field)
+// * The number of connections that servers needed at once
 class NET_EXPORT HttpServerProperties {
  public:
   HttpServerProperties() {}
@@ -116,6 +118,16 @@ class NET_EXPORT HttpServerProperties {
 
   virtual PipelineCapabilityMap GetPipelineCapabilityMap() const = 0;
 
+  // Returns the number of HTTP connections that |server| needed at once, or
+  // zero if it is not known.
+  virtual int GetConnectionDemand(const HostPortPair& server) const = 0;
+
+  // Records that |server| needed |demand| HTTP connections at once.
+  virtual void SetConnectionDemand(const HostPortPair& server, int demand) = 0;
+
+  // Returns the connection demand of all the servers.
+  virtual const ConnectionDemandMap& connection_demand_map() const = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(HttpServerProperties);
 };
@@ -66,6 +66,11 @@ void HttpServerPropertiesImpl::InitializePipelineCapabilities(
   }
 }
 
+void HttpServerPropertiesImpl::InitializeConnectionDemand(
+    ConnectionDemandMap* connection_demand_map) {
+  connection_demand_map_.swap(*connection_demand_map);
+}
+
 void HttpServerPropertiesImpl::SetNumPipelinedHostsToRemember(int max_size) {
   DCHECK(pipeline_capability_map_->empty());
   pipeline_capability_map_.reset(new CachedPipelineCapabilityMap(max_size));
@@ -118,6 +123,7 @@ void HttpServerPropertiesImpl::Clear() {
   alternate_protocol_map_.clear();
   spdy_settings_map_.clear();
   pipeline_capability_map_->Clear();
+  connection_demand_map_.clear();
 }
 
 bool HttpServerPropertiesImpl::SupportsSpdy(
@@ -290,4 +296,23 @@ HttpServerPropertiesImpl::GetPipelineCapabilityMap() const {
   return result;
 }
 
+int HttpServerPropertiesImpl::GetConnectionDemand(
+    const HostPortPair& server) const {
+  ConnectionDemandMap::const_iterator it = connection_demand_map_.find(server);
+  if (it == connection_demand_map_.end())
+    return 0;
+  return it->second;
+}
+
+void HttpServerPropertiesImpl::SetConnectionDemand(const HostPortPair& server,
+                                                   int demand) {
+  DCHECK_GT(demand, 0);
+  connection_demand_map_[server] = demand;
+}
+
+const ConnectionDemandMap&
+HttpServerPropertiesImpl::connection_demand_map() const {
+  return connection_demand_map_;
+}
+
 }  // namespace net
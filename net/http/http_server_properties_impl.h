@@ -49,6 +49,9 @@ class NET_EXPORT HttpServerPropertiesImpl
   void InitializePipelineCapabilities(
       const PipelineCapabilityMap* pipeline_capability_map);
 
+  // Initializes |connection_demand_map_| with |connection_demand_map|.
+  void InitializeConnectionDemand(ConnectionDemandMap* connection_demand_map);
+
   // Get the list of servers (host/port) that support SPDY.
   void GetSpdyServerList(base::ListValue* spdy_server_list) const;
 
@@ -132,6 +135,13 @@ class NET_EXPORT HttpServerPropertiesImpl
 
   virtual PipelineCapabilityMap GetPipelineCapabilityMap() const OVERRIDE;
 
+  virtual int GetConnectionDemand(const HostPortPair& server) const OVERRIDE;
+
+  virtual void SetConnectionDemand(const HostPortPair& server,
+                                   int demand) OVERRIDE;
+
+  virtual const ConnectionDemandMap& connection_demand_map() const OVERRIDE;
+
  private:
   typedef base::MRUCache<
       HostPortPair, HttpPipelinedHostCapability> CachedPipelineCapabilityMap;
@@ -143,6 +153,7 @@ class NET_EXPORT HttpServerPropertiesImpl
   AlternateProtocolMap alternate_protocol_map_;
   SpdySettingsMap spdy_settings_map_;
   scoped_ptr<CachedPipelineCapabilityMap> pipeline_capability_map_;
+  ConnectionDemandMap connection_demand_map_;
 
   DISALLOW_COPY_AND_ASSIGN(HttpServerPropertiesImpl);
 };
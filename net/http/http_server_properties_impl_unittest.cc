@@ -399,6 +399,38 @@ TEST_F(SpdySettingsServerPropertiesTest, Clear) {
   EXPECT_EQ(0U, impl_.GetSpdySettings(spdy_server_docs).size());
 }
 
+typedef HttpServerPropertiesImplTest ConnectionDemandServerPropertiesTest;
+
+TEST_F(ConnectionDemandServerPropertiesTest, Initialize) {
+  HostPortPair server_google("www.google.com", 80);
+  HostPortPair server_docs("docs.google.com", 80);
+
+  ConnectionDemandMap connection_demand_map;
+  connection_demand_map[server_google] = 4;
+  impl_.InitializeConnectionDemand(&connection_demand_map);
+
+  EXPECT_EQ(4, impl_.GetConnectionDemand(server_google));
+  EXPECT_EQ(0, impl_.GetConnectionDemand(server_docs));
+  EXPECT_EQ(1U, impl_.connection_demand_map().size());
+}
+
+TEST_F(ConnectionDemandServerPropertiesTest, SetConnectionDemand) {
+  HostPortPair server_google("www.google.com", 80);
+  HostPortPair server_docs("docs.google.com", 80);
+
+  impl_.SetConnectionDemand(server_google, 3);
+  impl_.SetConnectionDemand(server_docs, 6);
+  EXPECT_EQ(3, impl_.GetConnectionDemand(server_google));
+  EXPECT_EQ(6, impl_.GetConnectionDemand(server_docs));
+
+  impl_.SetConnectionDemand(server_google, 2);
+  EXPECT_EQ(2, impl_.GetConnectionDemand(server_google));
+
+  impl_.Clear();
+  EXPECT_EQ(0, impl_.GetConnectionDemand(server_google));
+  EXPECT_TRUE(impl_.connection_demand_map().empty());
+}
+
 }  // namespace
 
 }  // namespace net
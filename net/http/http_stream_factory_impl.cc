@@ -4,6 +4,8 @@
 
 #include "net/http/http_stream_factory_impl.h"
 
+#include <algorithm>
+
 #include "base/string_number_conversions.h"
 #include "base/stl_util.h"
 #include "googleurl/src/gurl.h"
@@ -16,12 +18,20 @@
 #include "net/http/http_server_properties.h"
 #include "net/http/http_stream_factory_impl_job.h"
 #include "net/http/http_stream_factory_impl_request.h"
+#include "net/socket/client_socket_pool_manager.h"
 #include "net/spdy/spdy_http_stream.h"
 
 namespace net {
 
 namespace {
 
+// New connections to a server that are opened within this time of the first
+// one are considered to be needed at the same time.
+const int kConnectionBurstSeconds = 10;
+
+// The number of servers for which connection bursts are tracked at once.
+const size_t kMaxConnectionBursts = 100;
+
 GURL UpgradeUrlToHttps(const GURL& original_url, int port) {
   GURL::Replacements replacements;
   // new_sheme and new_port need to be in scope here because GURL::Replacements
@@ -218,6 +228,42 @@ void HttpStreamFactoryImpl::OnOrphanedJobComplete(const Job* job) {
   delete job;
 }
 
+void HttpStreamFactoryImpl::OnNewHttpConnection(const HostPortPair& origin) {
+  HttpServerProperties* http_server_properties =
+      session_->http_server_properties();
+  if (!http_server_properties)
+    return;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta burst_length =
+      base::TimeDelta::FromSeconds(kConnectionBurstSeconds);
+  if (connection_bursts_.size() >= kMaxConnectionBursts &&
+      connection_bursts_.find(origin) == connection_bursts_.end()) {
+    for (ConnectionBurstMap::iterator it = connection_bursts_.begin();
+         it != connection_bursts_.end();) {
+      if (now - it->second.start > burst_length)
+        connection_bursts_.erase(it++);
+      else
+        ++it;
+    }
+    if (connection_bursts_.size() >= kMaxConnectionBursts)
+      return;
+  }
+
+  ConnectionBurst& burst = connection_bursts_[origin];
+  if (!burst.count || now - burst.start > burst_length) {
+    burst.start = now;
+    burst.count = 0;
+  }
+  burst.count++;
+
+  int demand = std::min(burst.count,
+                        ClientSocketPoolManager::max_sockets_per_group(
+                            HttpNetworkSession::NORMAL_SOCKET_POOL));
+  if (demand > http_server_properties->GetConnectionDemand(origin))
+    http_server_properties->SetConnectionDemand(origin, demand);
+}
+
 void HttpStreamFactoryImpl::OnPreconnectsComplete(const Job* job) {
   preconnect_job_set_.erase(job);
   delete job;
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/time.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/net_log.h"
 #include "net/http/http_pipelined_host_pool.h"
@@ -58,6 +59,14 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
   typedef std::map<HttpPipelinedHost::Key,
                    RequestVector> HttpPipeliningRequestMap;
 
+  // The new HTTP connections opened to a server in a short period of time.
+  struct ConnectionBurst {
+    ConnectionBurst() : count(0) {}
+    base::TimeTicks start;
+    int count;
+  };
+  typedef std::map<HostPortPair, ConnectionBurst> ConnectionBurstMap;
+
   bool GetAlternateProtocolRequestFor(const GURL& original_url,
                                       GURL* alternate_url) const;
 
@@ -84,6 +93,11 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
   // Invoked when an orphaned Job finishes.
   void OnOrphanedJobComplete(const Job* job);
 
+  // Called when a Job opens a new, direct HTTP connection to |origin|. Records
+  // the largest number of connections that |origin| needed at once in
+  // HttpServerProperties, so that they can be preconnected the next time.
+  void OnNewHttpConnection(const HostPortPair& origin);
+
   // Invoked when the Job finishes preconnecting sockets.
   void OnPreconnectsComplete(const Job* job);
 
@@ -107,6 +121,8 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
 
   HttpPipelinedHostPool http_pipelined_host_pool_;
 
+  ConnectionBurstMap connection_bursts_;
+
   // These jobs correspond to jobs orphaned by Requests and now owned by
   // HttpStreamFactoryImpl. Since they are no longer tied to Requests, they will
   // not be canceled when Requests are canceled. Therefore, in
@@ -910,6 +910,10 @@ int HttpStreamFactoryImpl::Job::DoCreateStream() {
   if (!using_spdy_) {
     bool using_proxy = (proxy_info_.is_http() || proxy_info_.is_https()) &&
         request_info_.url.SchemeIs("http");
+    if (connection_->socket() && !connection_->is_reused() &&
+        proxy_info_.is_direct()) {
+      stream_factory_->OnNewHttpConnection(origin_);
+    }
     if (stream_factory_->http_pipelined_host_pool_.
             IsExistingPipelineAvailableForKey(*http_pipelining_key_.get())) {
       stream_.reset(stream_factory_->http_pipelined_host_pool_.
@@ -183,7 +183,7 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
 }
 
 HttpStreamParser::~HttpStreamParser() {
-  if (request_body_ != NULL && request_body_->is_chunked())
+  if (request_body_ != NULL)
     request_body_->set_chunk_callback(NULL);
 }
 
@@ -219,8 +219,10 @@ int HttpStreamParser::SendRequest(const std::string& request_line,
   request_body_.reset(request_body);
   if (request_body_ != NULL) {
     request_body_buf_ = new SeekableIOBuffer(kRequestBodyBufferSize);
+    // Chunked bodies wait for more chunks, and file-backed bodies for file
+    // data being read ahead.
+    request_body_->set_chunk_callback(this);
     if (request_body_->is_chunked()) {
-      request_body_->set_chunk_callback(this);
       // The chunk buffer is adjusted to guarantee that |request_body_buf_|
       // is large enough to hold the encoded chunk.
       chunk_buf_ = new IOBufferWithSize(kRequestBodyBufferSize -
@@ -345,11 +347,15 @@ void HttpStreamParser::OnChunkAvailable() {
   // This method may get called while sending the headers or body, so check
   // before processing the new data. If we were still initializing or sending
   // headers, we will automatically start reading the chunks once we get into
-  // STATE_SENDING_CHUNKED_BODY so nothing to do here.
+  // STATE_SENDING_CHUNKED_BODY so nothing to do here. A non-chunked body only
+  // calls this after Read() returned ERR_IO_PENDING for pending file data.
   DCHECK(io_state_ == STATE_SENDING_HEADERS ||
-         io_state_ == STATE_SENDING_CHUNKED_BODY);
-  if (io_state_ == STATE_SENDING_CHUNKED_BODY)
+         io_state_ == STATE_SENDING_CHUNKED_BODY ||
+         io_state_ == STATE_SENDING_NON_CHUNKED_BODY);
+  if (io_state_ == STATE_SENDING_CHUNKED_BODY ||
+      io_state_ == STATE_SENDING_NON_CHUNKED_BODY) {
     OnIOComplete(0);
+  }
 }
 
 int HttpStreamParser::DoLoop(int result) {
@@ -507,8 +513,11 @@ int HttpStreamParser::DoSendNonChunkedBody(int result) {
     result = connection_->socket()->Write(request_body_buf_,
                                           request_body_buf_->BytesRemaining(),
                                           io_callback_);
+  } else if (consumed == ERR_IO_PENDING) {
+    // File data is still being read. OnChunkAvailable() resumes the loop.
+    result = ERR_IO_PENDING;
   } else {
-    // UploadDataStream::Read() won't fail if not chunked.
+    // UploadDataStream::Read() won't fail otherwise.
     NOTREACHED();
   }
   return result;
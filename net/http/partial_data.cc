@@ -15,6 +15,7 @@
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_util.h"
+#include "net/http/sparse_range_cache.h"
 
 namespace net {
 
@@ -25,6 +26,10 @@ const char kLengthHeader[] = "Content-Length";
 const char kRangeHeader[] = "Content-Range";
 const int kDataStream = 1;
 
+// Stored runs shorter than this are fetched again as part of the surrounding
+// network request, instead of splitting that request in two.
+const int kMinCachedRunToRead = 32 * 1024;
+
 void AddRangeHeader(int64 start, int64 end, HttpRequestHeaders* headers) {
   DCHECK(start >= 0 || end >= 0);
   std::string my_start, my_end;
@@ -115,6 +120,7 @@ PartialData::PartialData()
       sparse_entry_(true),
       truncated_(false),
       initial_validation_(false),
+      cached_range_mismatch_(false),
       core_(NULL) {
 }
 
@@ -161,6 +167,7 @@ void PartialData::RestoreHeaders(HttpRequestHeaders* headers) const {
 }
 
 int PartialData::ShouldValidateCache(disk_cache::Entry* entry,
+                                     SparseRangeCache* ranges,
                                      const CompletionCallback& callback) {
   DCHECK_GE(current_range_start_, 0);
 
@@ -172,6 +179,16 @@ int PartialData::ShouldValidateCache(disk_cache::Entry* entry,
   DVLOG(3) << "ShouldValidateCache len: " << len;
 
   if (sparse_entry_) {
+    if (cached_range_mismatch_) {
+      // The entry doesn't have what |ranges| said; ask the entry from now on.
+      ranges->Clear();
+      cached_range_mismatch_ = false;
+    }
+    if (ranges->GetAvailableRange(current_range_start_, len, &cached_start_,
+                                  &cached_min_len_)) {
+      return 1;
+    }
+
     DCHECK(callback_.is_null());
     Core* core = Core::CreateCore(this);
     cached_min_len_ = core->GetAvailableRange(entry, current_range_start_, len,
@@ -200,6 +217,7 @@ int PartialData::ShouldValidateCache(disk_cache::Entry* entry,
 }
 
 void PartialData::PrepareCacheValidation(disk_cache::Entry* entry,
+                                         SparseRangeCache* ranges,
                                          HttpRequestHeaders* headers) {
   DCHECK_GE(current_range_start_, 0);
   DCHECK_GE(cached_min_len_, 0);
@@ -208,6 +226,11 @@ void PartialData::PrepareCacheValidation(disk_cache::Entry* entry,
   DCHECK_NE(0, len);
   range_present_ = false;
 
+  if (sparse_entry_) {
+    ranges->OnAvailableRange(current_range_start_, len, cached_start_,
+                             cached_min_len_);
+  }
+
   headers->CopyFrom(extra_headers_);
 
   if (!cached_min_len_) {
@@ -225,8 +248,18 @@ void PartialData::PrepareCacheValidation(disk_cache::Entry* entry,
     AddRangeHeader(current_range_start_, cached_start_ + cached_min_len_ - 1,
                    headers);
   } else {
-    // This range is not in the cache.
-    AddRangeHeader(current_range_start_, cached_start_ - 1, headers);
+    // This range is not in the cache. Fetch the short stored runs that follow
+    // it as well, instead of going back and forth between the cache and the
+    // network.
+    int64 end = cached_start_;
+    if (sparse_entry_ && byte_range_.HasLastBytePosition()) {
+      int64 limit = current_range_start_ + len;
+      end = ranges->CoalesceMissingRange(cached_start_, limit,
+                                         kMinCachedRunToRead);
+      if (end == limit)
+        final_range_ = true;
+    }
+    AddRangeHeader(current_range_start_, end - 1, headers);
   }
 }
 
@@ -461,9 +494,16 @@ void PartialData::OnCacheReadCompleted(int result) {
     current_range_start_ += result;
     cached_min_len_ -= result;
     DCHECK_GE(cached_min_len_, 0);
+  } else if (!result && cached_min_len_ > 0) {
+    cached_range_mismatch_ = true;
   }
 }
 
+void PartialData::OnCacheWriteCompleted(SparseRangeCache* ranges, int result) {
+  if (sparse_entry_ && result > 0)
+    ranges->OnWrite(current_range_start_, result);
+}
+
 void PartialData::OnNetworkReadCompleted(int result) {
   if (result > 0)
     current_range_start_ += result;
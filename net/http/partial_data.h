@@ -19,6 +19,7 @@ namespace net {
 
 class HttpResponseHeaders;
 class IOBuffer;
+class SparseRangeCache;
 
 // This class provides support for dealing with range requests and the
 // subsequent partial-content responses. We use sparse cache entries to store
@@ -53,13 +54,17 @@ class PartialData {
   // (so 0 bytes should be actually returned to the user), a positive number to
   // indicate that PrepareCacheValidation should be called, or an appropriate
   // error code. If this method returns ERR_IO_PENDING, the |callback| will be
-  // notified when the result is ready.
-  int ShouldValidateCache(disk_cache::Entry* entry,
+  // notified when the result is ready. |ranges| holds what is known about the
+  // data stored by |entry|, and is used instead of asking |entry| when
+  // possible.
+  int ShouldValidateCache(disk_cache::Entry* entry, SparseRangeCache* ranges,
                           const CompletionCallback& callback);
 
   // Builds the required |headers| to perform the proper cache validation for
-  // the next range to be fetched.
+  // the next range to be fetched, and updates |ranges| with what was learned
+  // by ShouldValidateCache().
   void PrepareCacheValidation(disk_cache::Entry* entry,
+                              SparseRangeCache* ranges,
                               HttpRequestHeaders* headers);
 
   // Returns true if the current range is stored in the cache.
@@ -109,6 +114,10 @@ class PartialData {
   // the internal state about the current range.
   void OnCacheReadCompleted(int result);
 
+  // This method should be called when CacheWrite() successfully stores
+  // |result| bytes, before OnNetworkReadCompleted(), to update |ranges|.
+  void OnCacheWriteCompleted(SparseRangeCache* ranges, int result);
+
   // This method should be called after receiving data from the network, to
   // update the internal state about the current range.
   void OnNetworkReadCompleted(int result);
@@ -135,6 +144,8 @@ class PartialData {
   bool sparse_entry_;
   bool truncated_;  // We have an incomplete 200 stored.
   bool initial_validation_;  // Only used for truncated entries.
+  // True if a cache read found less data than |cached_min_len_| said.
+  bool cached_range_mismatch_;
   Core* core_;
   CompletionCallback callback_;
 
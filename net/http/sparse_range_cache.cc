@@ -0,0 +1,140 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/sparse_range_cache.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace net {
+
+SparseRangeCache::SparseRangeCache() {}
+
+SparseRangeCache::~SparseRangeCache() {}
+
+void SparseRangeCache::OnAvailableRange(int64 offset, int len, int64 start,
+                                        int min_len) {
+  if (len <= 0)
+    return;
+
+  if (min_len <= 0) {
+    AddRange(offset, offset + len, &known_);
+    return;
+  }
+
+  DCHECK_GE(start, offset);
+  AddRange(offset, start + min_len, &known_);
+  AddRange(start, start + min_len, &stored_);
+}
+
+void SparseRangeCache::OnWrite(int64 offset, int len) {
+  if (len <= 0)
+    return;
+  AddRange(offset, offset + len, &known_);
+  AddRange(offset, offset + len, &stored_);
+}
+
+bool SparseRangeCache::GetAvailableRange(int64 offset, int len, int64* start,
+                                         int* min_len) const {
+  if (len <= 0)
+    return false;
+  int64 end = offset + len;
+
+  // The first stored range that ends after |offset|.
+  RangeMap::const_iterator it = stored_.upper_bound(offset);
+  if (it != stored_.begin()) {
+    RangeMap::const_iterator previous = it;
+    --previous;
+    if (previous->second > offset)
+      it = previous;
+  }
+
+  if (it == stored_.end() || it->first >= end) {
+    if (!IsKnown(offset, end))
+      return false;
+    *start = offset;
+    *min_len = 0;
+    return true;
+  }
+
+  int64 found = std::max(it->first, offset);
+  if (found > offset && !IsKnown(offset, found))
+    return false;
+  *start = found;
+  *min_len = static_cast<int>(std::min(it->second, end) - found);
+  return true;
+}
+
+int64 SparseRangeCache::CoalesceMissingRange(int64 missing_end, int64 limit,
+                                             int min_run_len) const {
+  int64 end = missing_end;
+  while (end < limit) {
+    RangeMap::const_iterator run = FindRange(stored_, end);
+    if (run == stored_.end())
+      break;
+    int64 run_end = std::min(run->second, limit);
+    if (run_end - end >= min_run_len)
+      break;
+
+    // The run is short enough to be fetched again. Keep going only while the
+    // data that follows it is known to be missing.
+    end = run_end;
+    if (end == limit)
+      break;
+    RangeMap::const_iterator next_run = stored_.upper_bound(end);
+    int64 next_start = limit;
+    if (next_run != stored_.end())
+      next_start = std::min(next_run->first, limit);
+    if (!IsKnown(end, next_start))
+      break;
+    end = next_start;
+  }
+  return end;
+}
+
+void SparseRangeCache::Clear() {
+  known_.clear();
+  stored_.clear();
+}
+
+// static
+void SparseRangeCache::AddRange(int64 start, int64 end, RangeMap* ranges) {
+  if (start >= end)
+    return;
+
+  // Merge with the ranges that overlap or touch [start, end).
+  RangeMap::iterator it = ranges->upper_bound(start);
+  if (it != ranges->begin()) {
+    RangeMap::iterator previous = it;
+    --previous;
+    if (previous->second >= start) {
+      start = previous->first;
+      end = std::max(end, previous->second);
+      it = previous;
+    }
+  }
+  while (it != ranges->end() && it->first <= end) {
+    end = std::max(end, it->second);
+    ranges->erase(it++);
+  }
+  (*ranges)[start] = end;
+}
+
+// static
+SparseRangeCache::RangeMap::const_iterator SparseRangeCache::FindRange(
+    const RangeMap& ranges, int64 offset) {
+  RangeMap::const_iterator it = ranges.upper_bound(offset);
+  if (it == ranges.begin())
+    return ranges.end();
+  --it;
+  return it->second > offset ? it : ranges.end();
+}
+
+bool SparseRangeCache::IsKnown(int64 start, int64 end) const {
+  RangeMap::const_iterator it = FindRange(known_, start);
+  return it != known_.end() && it->second >= end;
+}
+
+}  // namespace net
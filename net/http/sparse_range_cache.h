@@ -0,0 +1,73 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_SPARSE_RANGE_CACHE_H_
+#define NET_HTTP_SPARSE_RANGE_CACHE_H_
+#pragma once
+
+#include <map>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// This class remembers which parts of a sparse cache entry are stored, as
+// reported by disk_cache::Entry::GetAvailableRange() and by the writes done
+// since then, so that the transactions of a range request can find the
+// stored ranges without asking the disk cache again. It only knows about the
+// parts of the entry that were looked up or written while it was alive.
+class NET_EXPORT_PRIVATE SparseRangeCache {
+ public:
+  SparseRangeCache();
+  ~SparseRangeCache();
+
+  // Records that GetAvailableRange() for |len| bytes at |offset| found
+  // |min_len| stored bytes at |start|.
+  void OnAvailableRange(int64 offset, int len, int64 start, int min_len);
+
+  // Records that |len| bytes were stored at |offset|.
+  void OnWrite(int64 offset, int len);
+
+  // Returns false if the result of GetAvailableRange() for |len| bytes at
+  // |offset| is unknown. Otherwise returns true and sets |start| and
+  // |min_len| the way GetAvailableRange() would.
+  bool GetAvailableRange(int64 offset, int len, int64* start,
+                         int* min_len) const;
+
+  // Returns where a network request for missing data that ends at
+  // |missing_end| should stop so that the stored runs shorter than
+  // |min_run_len| before |limit| are fetched with it, instead of being read in
+  // between two network requests.
+  int64 CoalesceMissingRange(int64 missing_end, int64 limit,
+                             int min_run_len) const;
+
+  // Forgets all the ranges, for instance because the entry was truncated.
+  void Clear();
+
+  bool empty() const { return known_.empty(); }
+
+ private:
+  // Disjoint and non-adjacent ranges, from start to end (exclusive).
+  typedef std::map<int64, int64> RangeMap;
+
+  static void AddRange(int64 start, int64 end, RangeMap* ranges);
+
+  // Returns the range of |ranges| that contains |offset|, or |ranges.end()|.
+  static RangeMap::const_iterator FindRange(const RangeMap& ranges,
+                                            int64 offset);
+
+  // Returns true if [start, end) is part of |known_|.
+  bool IsKnown(int64 start, int64 end) const;
+
+  // The ranges whose state is known, and the ones among them that are stored.
+  RangeMap known_;
+  RangeMap stored_;
+
+  DISALLOW_COPY_AND_ASSIGN(SparseRangeCache);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_SPARSE_RANGE_CACHE_H_
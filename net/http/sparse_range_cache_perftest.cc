@@ -0,0 +1,111 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/sparse_range_cache.h"
+
+#include <string.h>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/mem_backend_impl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A long media file played with many seeks: every other chunk is stored.
+const int kChunkSize = 64 * 1024;
+const int kNumChunks = 256;
+const int kNumSeeks = 2000;
+// What a media player asks for after each seek.
+const int kSeekWindow = 1024 * 1024;
+
+class SparseRangeCachePerfTest : public testing::Test {
+ protected:
+  SparseRangeCachePerfTest() : entry_(NULL) {}
+
+  virtual void SetUp() OVERRIDE {
+    backend_.reset(disk_cache::MemBackendImpl::CreateBackend(
+        kChunkSize * kNumChunks * 2, NULL));
+    ASSERT_TRUE(backend_.get());
+    TestCompletionCallback callback;
+    int rv = backend_->CreateEntry("http://www.example.com/movie.webm",
+                                   &entry_, callback.callback());
+    ASSERT_EQ(OK, callback.GetResult(rv));
+
+    scoped_refptr<IOBuffer> buffer(new IOBuffer(kChunkSize));
+    memset(buffer->data(), 'a', kChunkSize);
+    for (int i = 0; i < kNumChunks; i += 2) {
+      int64 offset = static_cast<int64>(i) * kChunkSize;
+      rv = entry_->WriteSparseData(offset, buffer, kChunkSize,
+                                   callback.callback());
+      ASSERT_EQ(kChunkSize, callback.GetResult(rv));
+      ranges_.OnWrite(offset, kChunkSize);
+      // The next chunk was found missing.
+      ranges_.OnAvailableRange(offset + kChunkSize, kChunkSize, 0, 0);
+    }
+  }
+
+  virtual void TearDown() OVERRIDE {
+    if (entry_)
+      entry_->Close();
+  }
+
+  // Returns the offset of the |i|-th seek.
+  static int64 SeekOffset(int i) {
+    uint32 state = static_cast<uint32>(i) * 1103515245 + 12345;
+    return (state >> 8) % (kChunkSize * (kNumChunks - 16));
+  }
+
+  // Finds the stored and missing runs of the window of every seek, the way
+  // PartialData does.
+  void Seek(bool use_ranges) {
+    TestCompletionCallback callback;
+    for (int i = 0; i < kNumSeeks; ++i) {
+      int64 offset = SeekOffset(i);
+      int64 end = offset + kSeekWindow;
+      while (offset < end) {
+        int len = static_cast<int>(end - offset);
+        int64 start;
+        int min_len;
+        if (!use_ranges ||
+            !ranges_.GetAvailableRange(offset, len, &start, &min_len)) {
+          min_len = callback.GetResult(entry_->GetAvailableRange(
+              offset, len, &start, callback.callback()));
+        }
+        ASSERT_GE(min_len, 0);
+        if (!min_len)
+          break;
+        offset = start == offset ? start + min_len : start;
+      }
+    }
+  }
+
+  scoped_ptr<disk_cache::Backend> backend_;
+  disk_cache::Entry* entry_;
+  SparseRangeCache ranges_;
+};
+
+}  // namespace
+
+TEST_F(SparseRangeCachePerfTest, SeekWithEntry) {
+  PerfTimeLogger timer("SparseRangeCache_Seek_Entry");
+  Seek(false);
+  timer.Done();
+}
+
+TEST_F(SparseRangeCachePerfTest, SeekWithRanges) {
+  PerfTimeLogger timer("SparseRangeCache_Seek_Ranges");
+  Seek(true);
+  timer.Done();
+}
+
+}  // namespace net
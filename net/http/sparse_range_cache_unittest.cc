@@ -0,0 +1,109 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/sparse_range_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+TEST(SparseRangeCacheTest, Unknown) {
+  SparseRangeCache ranges;
+  int64 start;
+  int min_len;
+  EXPECT_TRUE(ranges.empty());
+  EXPECT_FALSE(ranges.GetAvailableRange(0, 100, &start, &min_len));
+
+  // Nothing stored in [100, 200).
+  ranges.OnAvailableRange(100, 100, 0, 0);
+  EXPECT_FALSE(ranges.empty());
+  EXPECT_TRUE(ranges.GetAvailableRange(100, 100, &start, &min_len));
+  EXPECT_EQ(0, min_len);
+  EXPECT_TRUE(ranges.GetAvailableRange(150, 20, &start, &min_len));
+  EXPECT_EQ(0, min_len);
+
+  // The window goes beyond what is known.
+  EXPECT_FALSE(ranges.GetAvailableRange(50, 100, &start, &min_len));
+  EXPECT_FALSE(ranges.GetAvailableRange(150, 100, &start, &min_len));
+}
+
+TEST(SparseRangeCacheTest, AvailableRange) {
+  SparseRangeCache ranges;
+  int64 start;
+  int min_len;
+
+  // [0, 1000) holds 200 bytes at 300, and maybe more after 500.
+  ranges.OnAvailableRange(0, 1000, 300, 200);
+  EXPECT_TRUE(ranges.GetAvailableRange(0, 1000, &start, &min_len));
+  EXPECT_EQ(300, start);
+  EXPECT_EQ(200, min_len);
+  EXPECT_TRUE(ranges.GetAvailableRange(0, 400, &start, &min_len));
+  EXPECT_EQ(300, start);
+  EXPECT_EQ(100, min_len);
+  EXPECT_TRUE(ranges.GetAvailableRange(350, 1000, &start, &min_len));
+  EXPECT_EQ(350, start);
+  EXPECT_EQ(150, min_len);
+  EXPECT_TRUE(ranges.GetAvailableRange(0, 300, &start, &min_len));
+  EXPECT_EQ(0, min_len);
+
+  // Nothing is known after the stored run.
+  EXPECT_FALSE(ranges.GetAvailableRange(500, 100, &start, &min_len));
+}
+
+TEST(SparseRangeCacheTest, Writes) {
+  SparseRangeCache ranges;
+  int64 start;
+  int min_len;
+
+  ranges.OnAvailableRange(0, 1000, 0, 0);
+  ranges.OnWrite(100, 50);
+  ranges.OnWrite(150, 50);
+  EXPECT_TRUE(ranges.GetAvailableRange(0, 1000, &start, &min_len));
+  EXPECT_EQ(100, start);
+  EXPECT_EQ(100, min_len);
+
+  // A write that covers two stored runs merges them.
+  ranges.OnWrite(400, 100);
+  ranges.OnWrite(180, 300);
+  EXPECT_TRUE(ranges.GetAvailableRange(0, 1000, &start, &min_len));
+  EXPECT_EQ(100, start);
+  EXPECT_EQ(400, min_len);
+
+  // Writes beyond the known ranges are known as well.
+  ranges.OnWrite(2000, 10);
+  EXPECT_TRUE(ranges.GetAvailableRange(2000, 100, &start, &min_len));
+  EXPECT_EQ(2000, start);
+  EXPECT_EQ(10, min_len);
+  EXPECT_FALSE(ranges.GetAvailableRange(1500, 1000, &start, &min_len));
+
+  ranges.Clear();
+  EXPECT_TRUE(ranges.empty());
+  EXPECT_FALSE(ranges.GetAvailableRange(0, 1000, &start, &min_len));
+}
+
+TEST(SparseRangeCacheTest, CoalesceMissingRange) {
+  SparseRangeCache ranges;
+
+  // Stored: [100, 110), [200, 400) and [500, 510) out of a known [0, 1000).
+  ranges.OnAvailableRange(0, 1000, 0, 0);
+  ranges.OnWrite(100, 10);
+  ranges.OnWrite(200, 200);
+  ranges.OnWrite(500, 10);
+
+  // The short run at 100 is fetched with the data around it.
+  EXPECT_EQ(200, ranges.CoalesceMissingRange(100, 1000, 50));
+  // Up to the limit.
+  EXPECT_EQ(150, ranges.CoalesceMissingRange(100, 150, 50));
+  // Long runs are read from the cache.
+  EXPECT_EQ(1000, ranges.CoalesceMissingRange(100, 1000, 500));
+  EXPECT_EQ(100, ranges.CoalesceMissingRange(100, 1000, 5));
+  // The run at 500 is followed by missing data up to the limit.
+  EXPECT_EQ(1000, ranges.CoalesceMissingRange(500, 1000, 50));
+
+  // Nothing is known after 2000.
+  ranges.OnWrite(2000, 10);
+  EXPECT_EQ(2010, ranges.CoalesceMissingRange(2000, 3000, 50));
+}
+
+}  // namespace net
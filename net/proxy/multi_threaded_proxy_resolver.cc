@@ -22,6 +22,11 @@ namespace net {
 
 namespace {
 
+// The number of times a GetProxyForURL() job may be restarted because the
+// PAC script's DNS lookups missed the cache. Past this, the job is allowed
+// to block on DNS so that it is guaranteed to make progress.
+const int kMaxDnsRestarts = 10;
+
 class PurgeMemoryTask : public base::RefCountedThreadSafe<PurgeMemoryTask> {
  public:
   explicit PurgeMemoryTask(ProxyResolver* resolver) : resolver_(resolver) {}
@@ -55,6 +60,10 @@ class MultiThreadedProxyResolver::Executor
   // Callback for when a job has completed running on the executor's thread.
   void OnJobCompleted(Job* job);
 
+  // Callback for when a job has stopped running on the executor's thread to
+  // wait for a DNS lookup, after which it will be restarted.
+  void OnJobWaitingForDns(Job* job);
+
   // Cleanup the executor. Cancels all outstanding work, and frees the thread
   // and resolver.
   void Destroy();
@@ -223,15 +232,20 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
  public:
   // |url|         -- the URL of the query.
   // |results|     -- the structure to fill with proxy resolve results.
+  // |coordinator| -- the resolver to hand the job back to after a DNS lookup.
   GetProxyForURLJob(const GURL& url,
                     ProxyInfo* results,
                     const CompletionCallback& callback,
-                    const BoundNetLog& net_log)
+                    const BoundNetLog& net_log,
+                    MultiThreadedProxyResolver* coordinator)
       : Job(TYPE_GET_PROXY_FOR_URL, callback),
         results_(results),
         net_log_(net_log),
         url_(url),
-        was_waiting_for_thread_(false) {
+        was_waiting_for_thread_(false),
+        coordinator_(coordinator),
+        num_dns_restarts_(0),
+        num_restart_signals_(0) {
     DCHECK(!callback.is_null());
   }
 
@@ -260,9 +274,24 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
   // Runs on the worker thread.
   virtual void Run(scoped_refptr<base::MessageLoopProxy> origin_loop) OVERRIDE {
     ProxyResolver* resolver = executor()->resolver();
+
+    // Unless this job keeps missing the DNS cache, let the resolver abort
+    // the query rather than park this thread on a DNS lookup.
+    CompletionCallback dns_callback;
+    if (num_dns_restarts_ < kMaxDnsRestarts) {
+      dns_callback = base::Bind(&GetProxyForURLJob::OnDnsLookupComplete, this,
+                                origin_loop);
+    }
+
     int rv = resolver->GetProxyForURL(
-        url_, &results_buf_, CompletionCallback(), NULL, net_log_);
-    DCHECK_NE(rv, ERR_IO_PENDING);
+        url_, &results_buf_, dns_callback, NULL, net_log_);
+    if (rv == ERR_IO_PENDING) {
+      DCHECK(!dns_callback.is_null());
+      origin_loop->PostTask(
+          FROM_HERE,
+          base::Bind(&GetProxyForURLJob::QueryWaitingForDns, this));
+      return;
+    }
 
     origin_loop->PostTask(
         FROM_HERE,
@@ -285,6 +314,36 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
     OnJobCompleted();
   }
 
+  // Runs on the origin thread once the query was aborted by a DNS cache miss.
+  void QueryWaitingForDns() {
+    // |executor()| will be NULL if the executor has already been deleted.
+    if (executor())
+      executor()->OnJobWaitingForDns(this);
+    OnRestartSignal();
+  }
+
+  // Runs on the host resolver's thread once the DNS lookup has completed.
+  void OnDnsLookupComplete(scoped_refptr<base::MessageLoopProxy> origin_loop,
+                           int result) {
+    origin_loop->PostTask(
+        FROM_HERE,
+        base::Bind(&GetProxyForURLJob::OnRestartSignal, this));
+  }
+
+  // Restarts the query once both the executor has been released and the DNS
+  // lookup has completed, whichever comes last.
+  void OnRestartSignal() {
+    // A cancelled job has already been dropped by |coordinator_|, which may
+    // no longer exist.
+    if (was_cancelled())
+      return;
+    if (++num_restart_signals_ < 2)
+      return;
+    num_restart_signals_ = 0;
+    num_dns_restarts_++;
+    coordinator_->RestartJobAfterDns(this);
+  }
+
   // Must only be used on the "origin" thread.
   ProxyInfo* results_;
 
@@ -296,6 +355,12 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
   ProxyInfo results_buf_;
 
   bool was_waiting_for_thread_;
+
+  // Must only be used on the "origin" thread, unless noted otherwise.
+  MultiThreadedProxyResolver* const coordinator_;
+  // Also read on the worker thread, while no restart is in progress.
+  int num_dns_restarts_;
+  int num_restart_signals_;
 };
 
 // MultiThreadedProxyResolver::Executor ----------------------------------------
@@ -337,6 +402,14 @@ void MultiThreadedProxyResolver::Executor::OnJobCompleted(Job* job) {
   coordinator_->OnExecutorReady(this);
 }
 
+void MultiThreadedProxyResolver::Executor::OnJobWaitingForDns(Job* job) {
+  DCHECK_EQ(job, outstanding_job_.get());
+  job->set_executor(NULL);
+  coordinator_->OnJobWaitingForDns(job);
+  outstanding_job_ = NULL;
+  coordinator_->OnExecutorReady(this);
+}
+
 void MultiThreadedProxyResolver::Executor::Destroy() {
   DCHECK(coordinator_);
 
@@ -399,6 +472,11 @@ MultiThreadedProxyResolver::MultiThreadedProxyResolver(
 MultiThreadedProxyResolver::~MultiThreadedProxyResolver() {
   // We will cancel all outstanding requests.
   pending_jobs_.clear();
+  for (PendingJobsQueue::iterator it = jobs_waiting_for_dns_.begin();
+       it != jobs_waiting_for_dns_.end(); ++it) {
+    (*it)->Cancel();
+  }
+  jobs_waiting_for_dns_.clear();
   ReleaseAllExecutors();
 }
 
@@ -411,7 +489,7 @@ int MultiThreadedProxyResolver::GetProxyForURL(
       << "Resolver is un-initialized. Must call SetPacScript() first!";
 
   scoped_refptr<GetProxyForURLJob> job(
-      new GetProxyForURLJob(url, results, callback, net_log));
+      new GetProxyForURLJob(url, results, callback, net_log, this));
 
   // Completion will be notified through |callback|, unless the caller cancels
   // the request using |request|.
@@ -454,9 +532,18 @@ void MultiThreadedProxyResolver::CancelRequest(RequestHandle req) {
     // as cancelled so the user callback isn't run on completion.
     job->Cancel();
   } else {
-    // Otherwise the job is just sitting in a queue.
+    // Otherwise the job is just sitting in a queue, either for a thread or for
+    // a DNS lookup to complete. Mark it as cancelled too, so that a pending
+    // DNS completion does not restart it.
+    job->Cancel();
     PendingJobsQueue::iterator it =
-        std::find(pending_jobs_.begin(), pending_jobs_.end(), job);
+        std::find(jobs_waiting_for_dns_.begin(), jobs_waiting_for_dns_.end(),
+                  job);
+    if (it != jobs_waiting_for_dns_.end()) {
+      jobs_waiting_for_dns_.erase(it);
+      return;
+    }
+    it = std::find(pending_jobs_.begin(), pending_jobs_.end(), job);
     DCHECK(it != pending_jobs_.end());
     pending_jobs_.erase(it);
   }
@@ -469,6 +556,10 @@ LoadState MultiThreadedProxyResolver::GetLoadState(RequestHandle req) const {
   Job* job = reinterpret_cast<Job*>(req);
   if (job->executor())
     return job->executor()->resolver()->GetLoadStateThreadSafe(NULL);
+  if (std::find(jobs_waiting_for_dns_.begin(), jobs_waiting_for_dns_.end(),
+                job) != jobs_waiting_for_dns_.end()) {
+    return LOAD_STATE_RESOLVING_HOST_IN_PROXY_SCRIPT;
+  }
   return LOAD_STATE_RESOLVING_PROXY_FOR_URL;
 }
 
@@ -527,6 +618,7 @@ int MultiThreadedProxyResolver::SetPacScript(
 void MultiThreadedProxyResolver::CheckNoOutstandingUserRequests() const {
   DCHECK(CalledOnValidThread());
   CHECK_EQ(0u, pending_jobs_.size());
+  CHECK_EQ(0u, jobs_waiting_for_dns_.size());
 
   for (ExecutorList::const_iterator it = executors_.begin();
        it != executors_.end(); ++it) {
@@ -589,4 +681,30 @@ void MultiThreadedProxyResolver::OnExecutorReady(Executor* executor) {
   executor->StartJob(job);
 }
 
+void MultiThreadedProxyResolver::OnJobWaitingForDns(Job* job) {
+  DCHECK(CalledOnValidThread());
+  if (!job->was_cancelled())
+    jobs_waiting_for_dns_.push_back(job);
+}
+
+void MultiThreadedProxyResolver::RestartJobAfterDns(Job* job) {
+  DCHECK(CalledOnValidThread());
+  PendingJobsQueue::iterator it =
+      std::find(jobs_waiting_for_dns_.begin(), jobs_waiting_for_dns_.end(),
+                job);
+  DCHECK(it != jobs_waiting_for_dns_.end());
+  scoped_refptr<Job> restarted_job = *it;
+  jobs_waiting_for_dns_.erase(it);
+
+  Executor* executor = FindIdleExecutor();
+  if (executor) {
+    executor->StartJob(restarted_job);
+    return;
+  }
+
+  // The job was started before anything still in the queue, so it goes first.
+  restarted_job->WaitingForThread();
+  pending_jobs_.push_front(restarted_job);
+}
+
 }  // namespace net
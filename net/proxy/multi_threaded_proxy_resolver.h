@@ -57,6 +57,12 @@ class ProxyResolverFactory {
 // For each new thread that we spawn, a corresponding new ProxyResolver is
 // created using ProxyResolverFactory.
 //
+// GetProxyForURL() requests are run with a completion callback, letting
+// resolvers that support it (ProxyResolverV8) abort a request whose PAC
+// script misses the DNS cache instead of blocking the thread on the lookup.
+// The thread is then free for other requests, and the aborted one is queued
+// again once the lookup has completed.
+//
 // Because we are creating multiple ProxyResolver instances, this means we
 // are duplicating script contexts for what is ordinarily seen as being a
 // single script. This can affect compatibility on some classes of PAC
@@ -134,9 +140,18 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
   // Starts the next job from |pending_jobs_| if possible.
   void OnExecutorReady(Executor* executor);
 
+  // Moves |job| to |jobs_waiting_for_dns_| after its executor aborted it on
+  // a DNS cache miss (unless it was cancelled).
+  void OnJobWaitingForDns(Job* job);
+
+  // Schedules |job| again once the DNS lookup it was waiting for completed.
+  void RestartJobAfterDns(Job* job);
+
   const scoped_ptr<ProxyResolverFactory> resolver_factory_;
   const size_t max_num_threads_;
   PendingJobsQueue pending_jobs_;
+  // GetProxyForURL() jobs that gave up their thread for a DNS lookup.
+  PendingJobsQueue jobs_waiting_for_dns_;
   ExecutorList executors_;
   scoped_refptr<ProxyResolverScriptData> current_script_data_;
 };
@@ -26,13 +26,15 @@ namespace {
 // A synchronous mock ProxyResolver implementation, which can be used in
 // conjunction with MultiThreadedProxyResolver.
 //       - returns a single-item proxy list with the query's host.
+//       - can simulate DNS cache misses, which complete immediately.
 class MockProxyResolver : public ProxyResolver {
  public:
   MockProxyResolver()
       : ProxyResolver(true /*expects_pac_bytes*/),
         wrong_loop_(MessageLoop::current()),
         request_count_(0),
-        purge_count_(0) {}
+        purge_count_(0),
+        dns_miss_count_(0) {}
 
   // ProxyResolver implementation.
   virtual int GetProxyForURL(const GURL& query_url,
@@ -45,9 +47,16 @@ class MockProxyResolver : public ProxyResolver {
 
     CheckIsOnWorkerThread();
 
-    EXPECT_TRUE(callback.is_null());
     EXPECT_TRUE(request == NULL);
 
+    // Simulate a DNS lookup that missed the cache, which requires a callback
+    // to report its completion through.
+    if (dns_miss_count_ > 0 && !callback.is_null()) {
+      --dns_miss_count_;
+      callback.Run(OK);
+      return ERR_IO_PENDING;
+    }
+
     // Write something into |net_log| (doesn't really have any meaning.)
     net_log.BeginEvent(NetLog::TYPE_PAC_JAVASCRIPT_DNS_RESOLVE, NULL);
 
@@ -100,6 +109,10 @@ class MockProxyResolver : public ProxyResolver {
     resolve_latency_ = latency;
   }
 
+  // Makes the next |count| queries miss the DNS cache.
+  void SetDnsMissCount(int count) { dns_miss_count_ = count; }
+  int dns_miss_count() const { return dns_miss_count_; }
+
  private:
   void CheckIsOnWorkerThread() {
     // We should be running on the worker thread -- while we don't know the
@@ -114,6 +127,7 @@ class MockProxyResolver : public ProxyResolver {
   int purge_count_;
   scoped_refptr<ProxyResolverScriptData> last_script_data_;
   base::TimeDelta resolve_latency_;
+  int dns_miss_count_;
 };
 
 
@@ -614,6 +628,48 @@ TEST(MultiThreadedProxyResolverTest, SingleThread_CancelSetPacScript) {
   EXPECT_FALSE(set_pac_script_callback.have_result());
 }
 
+// Tests that a request aborted by DNS cache misses is restarted until it
+// completes.
+TEST(MultiThreadedProxyResolverTest, SingleThread_RestartAfterDnsMiss) {
+  const size_t kNumThreads = 1u;
+  scoped_ptr<MockProxyResolver> mock(new MockProxyResolver);
+  MultiThreadedProxyResolver resolver(
+      new ForwardingProxyResolverFactory(mock.get()), kNumThreads);
+
+  int rv;
+
+  TestCompletionCallback set_script_callback;
+  rv = resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8("pac script bytes"),
+      set_script_callback.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, set_script_callback.WaitForResult());
+
+  // The first two attempts at request 0 miss the DNS cache.
+  mock->SetDnsMissCount(2);
+
+  TestCompletionCallback callback0;
+  ProxyInfo results0;
+  rv = resolver.GetProxyForURL(GURL("http://request0"), &results0,
+                               callback0.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  // The third attempt completes.
+  rv = callback0.WaitForResult();
+  EXPECT_EQ(0, rv);
+  EXPECT_EQ("PROXY request0:80", results0.ToPacString());
+  EXPECT_EQ(0, mock->dns_miss_count());
+
+  // Requests keep being served by the same thread afterwards.
+  TestCompletionCallback callback1;
+  ProxyInfo results1;
+  rv = resolver.GetProxyForURL(GURL("http://request1"), &results1,
+                               callback1.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(1, callback1.WaitForResult());
+  EXPECT_EQ("PROXY request1:80", results1.ToPacString());
+}
+
 // Tests setting the PAC script once, lazily creating new threads, and
 // cancelling requests.
 TEST(MultiThreadedProxyResolverTest, ThreeThreads_Basic) {
@@ -243,7 +243,9 @@ class DefaultJSBindings : public ProxyResolverJSBindings {
   }
 
   // Helper to execute a synchronous DNS resolve, using the per-request
-  // DNS cache if there is one.
+  // DNS cache if there is one. If the current request does not allow
+  // blocking on DNS, fails with ERR_DNS_CACHE_MISS instead of waiting on the
+  // network.
   int DnsResolveHelper(const HostResolver::RequestInfo& info,
                        AddressList* address_list) {
     HostCache::Key cache_key(info.hostname(),
@@ -268,9 +270,27 @@ class DefaultJSBindings : public ProxyResolverJSBindings {
 
     // Otherwise ask the host resolver.
     const BoundNetLog* net_log = GetNetLogForCurrentRequest();
-    int result = host_resolver_->Resolve(info,
-                                         address_list,
-                                         net_log ? *net_log : BoundNetLog());
+    ProxyResolverRequestContext* context = current_request_context();
+    int result;
+    if (context && !context->dns_miss_callback.is_null()) {
+      // Rather than parking this thread on the network, fail the lookup and
+      // let the caller retry FindProxyForURL() once the answer is cached.
+      result = host_resolver_->ResolveFromCache(
+          info, address_list, net_log ? *net_log : BoundNetLog());
+      if (result == ERR_DNS_CACHE_MISS) {
+        if (!context->dns_missed) {
+          context->dns_missed = true;
+          host_resolver_->StartResolve(info,
+                                       net_log ? *net_log : BoundNetLog(),
+                                       context->dns_miss_callback);
+        }
+        return result;
+      }
+    } else {
+      result = host_resolver_->Resolve(info,
+                                       address_list,
+                                       net_log ? *net_log : BoundNetLog());
+    }
 
     // Save the result back to the per-request DNS cache.
     if (host_cache) {
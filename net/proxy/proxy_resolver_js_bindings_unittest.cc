@@ -4,6 +4,9 @@
 
 #include "net/proxy/proxy_resolver_js_bindings.h"
 
+#include <set>
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/string_util.h"
@@ -90,6 +93,49 @@ class MockSyncHostResolver : public SyncHostResolver {
   MockHostResolver resolver_;
 };
 
+// A SyncHostResolver whose cache starts out empty. Lookups started with
+// StartResolve() complete immediately and populate the cache.
+class MockCachingHostResolver : public SyncHostResolver {
+ public:
+  MockCachingHostResolver() : blocking_count_(0) {}
+
+  virtual int Resolve(const HostResolver::RequestInfo& info,
+                      AddressList* addresses,
+                      const net::BoundNetLog& bound_net_log) OVERRIDE {
+    blocking_count_++;
+    return ParseAddressList("192.168.1.1", "", addresses);
+  }
+
+  virtual int ResolveFromCache(const HostResolver::RequestInfo& info,
+                               AddressList* addresses,
+                               const BoundNetLog& net_log) OVERRIDE {
+    if (!cached_hosts_.count(info.hostname()))
+      return ERR_DNS_CACHE_MISS;
+    return ParseAddressList("192.168.1.1", "", addresses);
+  }
+
+  virtual void StartResolve(const HostResolver::RequestInfo& info,
+                            const BoundNetLog& net_log,
+                            const CompletionCallback& callback) OVERRIDE {
+    started_hosts_.push_back(info.hostname());
+    cached_hosts_.insert(info.hostname());
+    callback.Run(OK);
+  }
+
+  virtual void Shutdown() OVERRIDE {}
+
+  // Returns the number of times Resolve() has been called.
+  int blocking_count() const { return blocking_count_; }
+  const std::vector<std::string>& started_hosts() const {
+    return started_hosts_;
+  }
+
+ private:
+  int blocking_count_;
+  std::set<std::string> cached_hosts_;
+  std::vector<std::string> started_hosts_;
+};
+
 TEST(ProxyResolverJSBindingsTest, DnsResolve) {
   MockSyncHostResolver* host_resolver = new MockSyncHostResolver;
 
@@ -262,6 +308,44 @@ TEST(ProxyResolverJSBindingsTest, PerRequestDNSCache) {
   bindings->set_current_request_context(NULL);
 }
 
+// Test that lookups do not block when the request context asks for it, and
+// that the first cache miss starts a lookup in the background.
+TEST(ProxyResolverJSBindingsTest, NonBlockingDns) {
+  MockCachingHostResolver* host_resolver = new MockCachingHostResolver;
+
+  // Get a hold of a DefaultJSBindings* (it is a hidden impl class).
+  scoped_ptr<ProxyResolverJSBindings> bindings(
+      ProxyResolverJSBindings::CreateDefault(host_resolver, NULL, NULL));
+
+  TestCompletionCallback dns_callback;
+  ProxyResolverRequestContext context(NULL, NULL);
+  context.dns_miss_callback = dns_callback.callback();
+  bindings->set_current_request_context(&context);
+
+  // Only the first miss starts a lookup.
+  std::string ip_address;
+  EXPECT_FALSE(bindings->DnsResolve("foo", &ip_address));
+  EXPECT_TRUE(context.dns_missed);
+  EXPECT_FALSE(bindings->DnsResolve("bar", &ip_address));
+  ASSERT_EQ(1u, host_resolver->started_hosts().size());
+  EXPECT_EQ("foo", host_resolver->started_hosts()[0]);
+  EXPECT_EQ(OK, dns_callback.WaitForResult());
+
+  // Once the lookup has completed, a new request finds it in the cache.
+  ProxyResolverRequestContext context2(NULL, NULL);
+  context2.dns_miss_callback = dns_callback.callback();
+  bindings->set_current_request_context(&context2);
+  EXPECT_TRUE(bindings->DnsResolve("foo", &ip_address));
+  EXPECT_EQ("192.168.1.1", ip_address);
+  EXPECT_FALSE(context2.dns_missed);
+  EXPECT_EQ(0, host_resolver->blocking_count());
+
+  // Without a callback, lookups block as before.
+  bindings->set_current_request_context(NULL);
+  EXPECT_TRUE(bindings->DnsResolve("bar", &ip_address));
+  EXPECT_EQ(1, host_resolver->blocking_count());
+}
+
 // Test that when a binding is called, it logs to the per-request NetLog.
 TEST(ProxyResolverJSBindingsTest, NetLog) {
   MockFailingHostResolver* host_resolver = new MockFailingHostResolver;
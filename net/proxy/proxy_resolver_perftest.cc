@@ -48,6 +48,9 @@ struct PacQuery {
 // rather than a length, to simplify using initializer lists.
 struct PacPerfTest {
   const char* pac_name;
+  // Whether the script's answers depend only on the origin of the query URL,
+  // so that it can also be run against resolvers that cache results.
+  bool origin_keyed;
   PacQuery queries[100];
 
   // Returns the actual number of entries in |queries| (assumes NULL sentinel).
@@ -60,6 +63,7 @@ static PacPerfTest kPerfTests[] = {
   // regular expression oriented, and has no dependencies on the current
   // IP address, or DNS resolving of hosts.
   { "no-ads.pac",
+    false,
     { // queries:
       {"http://www.google.com", "DIRECT"},
       {"http://www.imdb.com/photos/cmsicons/x", "PROXY 0.0.0.0:3421"},
@@ -75,6 +79,32 @@ static PacPerfTest kPerfTests[] = {
       {NULL, NULL}
     },
   },
+  // This test uses a PAC script modelled on large corporate deployments: long
+  // domain and pattern lists, subnet checks on IP literals and per-protocol
+  // fallbacks. Its answers depend only on the scheme and host.
+  { "corporate.pac",
+    true,
+    { // queries:
+      {"http://intranet/home", "DIRECT"},
+      {"http://wiki.corp.example.com/page", "DIRECT"},
+      {"https://ci.build.example.com/job/42", "DIRECT"},
+      {"http://10.1.2.3/status", "DIRECT"},
+      {"http://8.8.8.8/",
+       "PROXY proxy.example.com:8080;PROXY backup-proxy.example.com:8080"},
+      {"http://www.ads.example.org/x", "PROXY blackhole.example.com:80"},
+      {"http://portal.partner3.com/",
+       "PROXY partner-proxy.example.com:8080;DIRECT"},
+      {"http://www.supplier-acme.com/orders",
+       "PROXY partner-proxy.example.com:8080;DIRECT"},
+      {"https://mail.google.com/",
+       "PROXY secure-proxy.example.com:8443;PROXY proxy.example.com:8080"},
+      {"http://www.google.com/search?q=x",
+       "PROXY proxy.example.com:8080;PROXY backup-proxy.example.com:8080"},
+      {"http://news.example.org/",
+       "PROXY proxy.example.com:8080;PROXY backup-proxy.example.com:8080"},
+      {NULL, NULL}
+    },
+  },
 };
 
 int PacPerfTest::NumQueries() const {
@@ -93,11 +123,15 @@ const int kNumIterations = 500;
 // proxy resolver implementation.
 class PacPerfSuiteRunner {
  public:
-  // |resolver_name| is the label used when logging the results.
+  // |resolver_name| is the label used when logging the results. If
+  // |caches_results| is true, only the tests whose answers depend solely on
+  // the query origin are run.
   PacPerfSuiteRunner(net::ProxyResolver* resolver,
-                     const std::string& resolver_name)
+                     const std::string& resolver_name,
+                     bool caches_results)
       : resolver_(resolver),
         resolver_name_(resolver_name),
+        caches_results_(caches_results),
         test_server_(
             net::TestServer::TYPE_HTTP,
             net::TestServer::kLocalhost,
@@ -108,6 +142,8 @@ class PacPerfSuiteRunner {
     ASSERT_TRUE(test_server_.Start());
     for (size_t i = 0; i < arraysize(kPerfTests); ++i) {
       const PacPerfTest& test_data = kPerfTests[i];
+      if (caches_results_ && !test_data.origin_keyed)
+        continue;
       RunTest(test_data.pac_name,
               test_data.queries,
               test_data.NumQueries());
@@ -190,19 +226,20 @@ class PacPerfSuiteRunner {
 
   net::ProxyResolver* resolver_;
   std::string resolver_name_;
+  bool caches_results_;
   net::TestServer test_server_;
 };
 
 #if defined(OS_WIN)
 TEST(ProxyResolverPerfTest, ProxyResolverWinHttp) {
   net::ProxyResolverWinHttp resolver;
-  PacPerfSuiteRunner runner(&resolver, "ProxyResolverWinHttp");
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverWinHttp", false);
   runner.RunAllTests();
 }
 #elif defined(OS_MACOSX)
 TEST(ProxyResolverPerfTest, ProxyResolverMac) {
   net::ProxyResolverMac resolver;
-  PacPerfSuiteRunner runner(&resolver, "ProxyResolverMac");
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverMac", false);
   runner.RunAllTests();
 }
 #endif
@@ -213,7 +250,18 @@ TEST(ProxyResolverPerfTest, ProxyResolverV8) {
           new MockSyncHostResolver, NULL, NULL);
 
   net::ProxyResolverV8 resolver(js_bindings);
-  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8");
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8", false);
+  runner.RunAllTests();
+}
+
+TEST(ProxyResolverPerfTest, ProxyResolverV8WithResultCache) {
+  net::ProxyResolverJSBindings* js_bindings =
+      net::ProxyResolverJSBindings::CreateDefault(
+          new MockSyncHostResolver, NULL, NULL);
+
+  net::ProxyResolverV8 resolver(js_bindings);
+  resolver.EnableResultCache(100, base::TimeDelta::FromMinutes(1));
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8WithResultCache", true);
   runner.RunAllTests();
 }
 
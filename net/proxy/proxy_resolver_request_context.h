@@ -6,6 +6,8 @@
 #define NET_PROXY_PROXY_RESOLVER_REQUEST_CONTEXT_H_
 #pragma once
 
+#include "net/base/completion_callback.h"
+
 namespace net {
 
 class HostCache;
@@ -20,11 +22,18 @@ struct ProxyResolverRequestContext {
   ProxyResolverRequestContext(const BoundNetLog* net_log,
                               HostCache* host_cache)
     : net_log(net_log),
-      host_cache(host_cache) {
+      host_cache(host_cache),
+      dns_missed(false) {
   }
 
   const BoundNetLog* net_log;
   HostCache* host_cache;
+
+  // If non-null, DNS lookups do not block: one that misses the host cache is
+  // started in the background instead, with this callback run on completion,
+  // and |dns_missed| is set so that FindProxyForURL() gets aborted.
+  CompletionCallback dns_miss_callback;
+  bool dns_missed;
 };
 
 }  // namespace net
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/string_tokenizer.h"
 #include "base/string_util.h"
@@ -329,6 +330,39 @@ bool IsInNetEx(const std::string& ip_address, const std::string& ip_prefix) {
   return IPNumberMatchesPrefix(address, prefix, prefix_length_in_bits);
 }
 
+// Pre-parse data for the most recently loaded PAC script. The executor
+// threads of MultiThreadedProxyResolver each load the same script into their
+// own context; the first one to do so pre-parses it, and the others reuse
+// the result to skip straight to compiling.
+class SharedPreparseData {
+ public:
+  SharedPreparseData() {}
+
+  // Returns pre-parse data for |script|, or NULL if it cannot be produced.
+  // Must be called while holding the v8::Locker. The caller owns the result.
+  v8::ScriptData* Get(const string16& script, v8::Handle<v8::String> source) {
+    base::AutoLock auto_lock(lock_);
+    if (script != script_) {
+      scoped_ptr<v8::ScriptData> preparse(v8::ScriptData::PreCompile(source));
+      if (!preparse.get() || preparse->HasError())
+        return NULL;
+      script_ = script;
+      data_.assign(preparse->Data(), preparse->Length());
+    }
+    return v8::ScriptData::New(data_.data(), static_cast<int>(data_.size()));
+  }
+
+ private:
+  base::Lock lock_;
+  string16 script_;
+  std::string data_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedPreparseData);
+};
+
+base::LazyInstance<SharedPreparseData>::Leaky g_shared_preparse_data =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // ProxyResolverV8::Context ---------------------------------------------------
@@ -376,6 +410,13 @@ class ProxyResolverV8::Context {
     v8::Local<v8::Value> ret = v8::Function::Cast(*function)->Call(
         v8_context_->Global(), arraysize(argv), argv);
 
+    // A DNS lookup missed the cache and terminated the script; the request
+    // will be restarted once the lookup completes.
+    ProxyResolverRequestContext* request =
+        js_bindings_->current_request_context();
+    if (request && request->dns_missed)
+      return ERR_IO_PENDING;
+
     if (try_catch.HasCaught()) {
       HandleError(try_catch.Message());
       return ERR_PAC_SCRIPT_FAILED;
@@ -460,14 +501,17 @@ class ProxyResolverV8::Context {
         ASCIILiteralToV8String(
             PROXY_RESOLVER_SCRIPT
             PROXY_RESOLVER_SCRIPT_EX),
-        kPacUtilityResourceName);
+        kPacUtilityResourceName, NULL);
     if (rv != OK) {
       NOTREACHED();
       return rv;
     }
 
     // Add the user's PAC code to the environment.
-    rv = RunScript(ScriptDataToV8String(pac_script), kPacResourceName);
+    v8::Local<v8::String> source = ScriptDataToV8String(pac_script);
+    scoped_ptr<v8::ScriptData> preparse(
+        g_shared_preparse_data.Get().Get(pac_script->utf16(), source));
+    rv = RunScript(source, kPacResourceName, preparse.get());
     if (rv != OK)
       return rv;
 
@@ -498,6 +542,17 @@ class ProxyResolverV8::Context {
   }
 
  private:
+  // Aborts the running script if the current request's DNS lookup missed the
+  // host cache (see ProxyResolverRequestContext). Returns true if so.
+  bool TerminateIfDnsMissed() {
+    ProxyResolverRequestContext* request =
+        js_bindings_->current_request_context();
+    if (!request || !request->dns_missed)
+      return false;
+    v8::V8::TerminateExecution();
+    return true;
+  }
+
   class ScopedHostResolve {
    public:
     explicit ScopedHostResolve(Context* context)
@@ -544,15 +599,18 @@ class ProxyResolverV8::Context {
     js_bindings_->OnError(line_number, error_message);
   }
 
-  // Compiles and runs |script| in the current V8 context.
+  // Compiles and runs |script| in the current V8 context, using |preparse|
+  // (which may be NULL) to speed up compilation.
   // Returns OK on success, otherwise an error code.
-  int RunScript(v8::Handle<v8::String> script, const char* script_name) {
+  int RunScript(v8::Handle<v8::String> script, const char* script_name,
+                v8::ScriptData* preparse) {
     v8::TryCatch try_catch;
 
     // Compile the script.
     v8::ScriptOrigin origin =
         v8::ScriptOrigin(ASCIILiteralToV8String(script_name));
-    v8::Local<v8::Script> code = v8::Script::Compile(script, &origin);
+    v8::Local<v8::Script> code =
+        v8::Script::Compile(script, &origin, preparse);
 
     // Execute.
     if (!code.IsEmpty())
@@ -603,6 +661,9 @@ class ProxyResolverV8::Context {
       success = context->js_bindings_->MyIpAddress(&result);
     }
 
+    if (context->TerminateIfDnsMissed())
+      return v8::Undefined();
+
     if (!success)
       return ASCIILiteralToV8String("127.0.0.1");
     return ASCIIStringToV8String(result);
@@ -626,6 +687,9 @@ class ProxyResolverV8::Context {
       success = context->js_bindings_->MyIpAddressEx(&ip_address_list);
     }
 
+    if (context->TerminateIfDnsMissed())
+      return v8::Undefined();
+
     if (!success)
       ip_address_list = std::string();
     return ASCIIStringToV8String(ip_address_list);
@@ -650,6 +714,9 @@ class ProxyResolverV8::Context {
       success = context->js_bindings_->DnsResolve(hostname, &ip_address);
     }
 
+    if (context->TerminateIfDnsMissed())
+      return v8::Undefined();
+
     return success ? ASCIIStringToV8String(ip_address) : v8::Null();
   }
 
@@ -672,6 +739,9 @@ class ProxyResolverV8::Context {
       success = context->js_bindings_->DnsResolveEx(hostname, &ip_address_list);
     }
 
+    if (context->TerminateIfDnsMissed())
+      return v8::Undefined();
+
     if (!success)
       ip_address_list = std::string();
 
@@ -728,9 +798,15 @@ ProxyResolverV8::ProxyResolverV8(
 
 ProxyResolverV8::~ProxyResolverV8() {}
 
+void ProxyResolverV8::EnableResultCache(size_t max_entries,
+                                        base::TimeDelta ttl) {
+  result_cache_.reset(new ResultCache(max_entries));
+  result_cache_ttl_ = ttl;
+}
+
 int ProxyResolverV8::GetProxyForURL(
     const GURL& query_url, ProxyInfo* results,
-    const CompletionCallback& /*callback*/,
+    const CompletionCallback& callback,
     RequestHandle* /*request*/,
     const BoundNetLog& net_log) {
   // If the V8 instance has not been initialized (either because
@@ -738,6 +814,17 @@ int ProxyResolverV8::GetProxyForURL(
   if (!context_.get())
     return ERR_FAILED;
 
+  std::string cache_key;
+  if (result_cache_.get()) {
+    cache_key = query_url.GetOrigin().spec();
+    const std::string* pac_string =
+        result_cache_->Get(cache_key, base::TimeTicks::Now());
+    if (pac_string) {
+      results->UsePacString(*pac_string);
+      return OK;
+    }
+  }
+
   // Associate some short-lived context with this request. This context will be
   // available to any of the javascript "bindings" that are subsequently invoked
   // from the javascript.
@@ -748,12 +835,18 @@ int ProxyResolverV8::GetProxyForURL(
   HostCache host_cache(kMaxCacheEntries);
 
   ProxyResolverRequestContext request_context(&net_log, &host_cache);
+  request_context.dns_miss_callback = callback;
 
   // Otherwise call into V8.
   context_->SetCurrentRequestContext(&request_context);
   int rv = context_->ResolveProxy(query_url, results);
   context_->SetCurrentRequestContext(NULL);
 
+  if (rv == OK && result_cache_.get()) {
+    result_cache_->Put(cache_key, results->ToPacString(),
+                       base::TimeTicks::Now(), result_cache_ttl_);
+  }
+
   return rv;
 }
 
@@ -778,6 +871,8 @@ void ProxyResolverV8::CancelSetPacScript() {
 }
 
 void ProxyResolverV8::PurgeMemory() {
+  if (result_cache_.get())
+    result_cache_->Clear();
   context_->PurgeMemory();
 }
 
@@ -790,6 +885,8 @@ int ProxyResolverV8::SetPacScript(
     const CompletionCallback& /*callback*/) {
   DCHECK(script_data.get());
   context_.reset();
+  if (result_cache_.get())
+    result_cache_->Clear();
   if (script_data->utf16().empty())
     return ERR_PAC_SCRIPT_FAILED;
 
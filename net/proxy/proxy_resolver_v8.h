@@ -6,8 +6,12 @@
 #define NET_PROXY_PROXY_RESOLVER_V8_H_
 #pragma once
 
+#include <string>
+
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time.h"
+#include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 #include "net/proxy/proxy_resolver.h"
 
@@ -44,10 +48,27 @@ class NET_EXPORT_PRIVATE ProxyResolverV8 : public ProxyResolver {
 
   ProxyResolverJSBindings* js_bindings() const { return js_bindings_.get(); }
 
+  // Remembers up to |max_entries| results of FindProxyForURL() for |ttl|,
+  // keyed on the origin (scheme, host and port) of the query URL. The cache
+  // is emptied whenever a new PAC script is set.
+  //
+  // Enabling this assumes the PAC script does not look at the URL's path and
+  // that its answers do not change faster than |ttl| -- which holds for
+  // typical corporate PAC files, but not for every script. Also, cached
+  // queries skip any side-effects the script would have had (e.g. alert()).
+  void EnableResultCache(size_t max_entries, base::TimeDelta ttl);
+
   // ProxyResolver implementation:
+  //
+  // GetProxyForURL() normally completes synchronously, blocking on any DNS
+  // lookups the PAC script makes. If |callback| is non-null, a lookup that
+  // misses the host cache instead aborts the script: the lookup continues in
+  // the background, ERR_IO_PENDING is returned, and |callback| is run (on the
+  // host resolver's thread) once the lookup has completed. The caller should
+  // then issue the request again, which will find the answer in the cache.
   virtual int GetProxyForURL(const GURL& url,
                              ProxyInfo* results,
-                             const net::CompletionCallback& /*callback*/,
+                             const net::CompletionCallback& callback,
                              RequestHandle* /*request*/,
                              const BoundNetLog& net_log) OVERRIDE;
   virtual void CancelRequest(RequestHandle request) OVERRIDE;
@@ -70,6 +91,12 @@ class NET_EXPORT_PRIVATE ProxyResolverV8 : public ProxyResolver {
 
   scoped_ptr<ProxyResolverJSBindings> js_bindings_;
 
+  // Maps query URL origins to the PAC string FindProxyForURL() returned for
+  // them. NULL unless EnableResultCache() was called.
+  typedef ExpiringCache<std::string, std::string> ResultCache;
+  scoped_ptr<ResultCache> result_cache_;
+  base::TimeDelta result_cache_ttl_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyResolverV8);
 };
 
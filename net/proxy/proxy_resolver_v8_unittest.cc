@@ -300,6 +300,45 @@ TEST(ProxyResolverV8Test, SideEffects) {
   }
 }
 
+// Run a PAC script which has side-effects, with results being cached.
+TEST(ProxyResolverV8Test, ResultCache) {
+  ProxyResolverV8WithMockBindings resolver;
+  resolver.EnableResultCache(10, base::TimeDelta::FromHours(1));
+  int result = resolver.SetPacScriptFromDisk("side_effects.js");
+  EXPECT_EQ(OK, result);
+
+  // Only the first query for an origin runs the script, whatever the path.
+  for (int i = 0; i < 3; ++i) {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        GURL(base::StringPrintf("http://www.google.com/%d", i)), &proxy_info,
+        CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_0:80", proxy_info.proxy_server().ToURI());
+  }
+
+  // Another origin runs the script again.
+  {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        GURL("https://www.google.com"), &proxy_info, CompletionCallback(),
+        NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_1:80", proxy_info.proxy_server().ToURI());
+  }
+
+  // Reloading the script empties the cache.
+  result = resolver.SetPacScriptFromDisk("side_effects.js");
+  EXPECT_EQ(OK, result);
+  {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_0:80", proxy_info.proxy_server().ToURI());
+  }
+}
+
 // Execute a PAC script which throws an exception in FindProxyForURL.
 TEST(ProxyResolverV8Test, UnhandledException) {
   ProxyResolverV8WithMockBindings resolver;
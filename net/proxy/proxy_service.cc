@@ -52,6 +52,10 @@ namespace {
 const size_t kMaxNumNetLogEntries = 100;
 const size_t kDefaultNumPacThreads = 4;
 
+// Bounds on the FindProxyForURL() results each V8 resolver remembers.
+const size_t kMaxPacResultCacheEntries = 100;
+const int kPacResultCacheTTLSeconds = 60;
+
 // When the IP address changes we don't immediately re-run proxy auto-config.
 // Instead, we  wait for |kDelayAfterNetworkChangesMs| before
 // attempting to re-valuate proxy auto-config.
@@ -291,7 +295,13 @@ class ProxyResolverFactoryForV8 : public ProxyResolverFactory {
             sync_host_resolver, net_log_, error_observer);
 
     // ProxyResolverV8 takes ownership of |js_bindings|.
-    return new ProxyResolverV8(js_bindings);
+    ProxyResolverV8* resolver = new ProxyResolverV8(js_bindings);
+    // Large PAC scripts take milliseconds per evaluation; remember answers
+    // for recently seen origins rather than re-running them for each request.
+    resolver->EnableResultCache(
+        kMaxPacResultCacheEntries,
+        base::TimeDelta::FromSeconds(kPacResultCacheTTLSeconds));
+    return resolver;
   }
 
  private:
@@ -6,7 +6,9 @@
 #define NET_PROXY_SYNC_HOST_RESOLVER_H_
 #pragma once
 
+#include "net/base/completion_callback.h"
 #include "net/base/host_resolver.h"
+#include "net/base/net_errors.h"
 #include "net/base/net_export.h"
 
 namespace net {
@@ -23,6 +25,26 @@ class NET_EXPORT_PRIVATE SyncHostResolver {
                       AddressList* addresses,
                       const BoundNetLog& net_log) = 0;
 
+  // Like Resolve(), but only answers from the host cache (or HOSTS file),
+  // returning ERR_DNS_CACHE_MISS if a network round trip would be needed.
+  // The default implementation has no cache to consult and just resolves.
+  virtual int ResolveFromCache(const HostResolver::RequestInfo& info,
+                               AddressList* addresses,
+                               const BoundNetLog& net_log) {
+    return Resolve(info, addresses, net_log);
+  }
+
+  // Starts resolving |info| without blocking, so that a later
+  // ResolveFromCache() can be answered from the cache. |callback| is run with
+  // the result once the lookup completes, possibly on another thread. Only
+  // called after ResolveFromCache() missed, which the default implementation
+  // never does.
+  virtual void StartResolve(const HostResolver::RequestInfo& info,
+                            const BoundNetLog& net_log,
+                            const CompletionCallback& callback) {
+    callback.Run(ERR_NOT_IMPLEMENTED);
+  }
+
   // Optionally aborts any blocking resolves that are in progress.
   virtual void Shutdown() = 0;
 };
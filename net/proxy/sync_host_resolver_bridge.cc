@@ -4,10 +4,13 @@
 
 #include "net/proxy/sync_host_resolver_bridge.h"
 
+#include <set>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/message_loop.h"
+#include "base/stl_util.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
 #include "net/base/net_errors.h"
@@ -26,6 +29,15 @@ class SyncHostResolverBridge::Core
                            AddressList* addresses,
                            const BoundNetLog& net_log);
 
+  int ResolveFromCacheSynchronously(const HostResolver::RequestInfo& info,
+                                    AddressList* addresses,
+                                    const BoundNetLog& net_log);
+
+  // Called on |host_resolver_loop_|.
+  void StartAsyncResolve(const HostResolver::RequestInfo& info,
+                         const BoundNetLog& net_log,
+                         const CompletionCallback& callback);
+
   // Returns true if Shutdown() has been called.
   bool HasShutdown() const {
     base::AutoLock l(lock_);
@@ -37,6 +49,16 @@ class SyncHostResolverBridge::Core
 
  private:
   friend class base::RefCountedThreadSafe<SyncHostResolverBridge::Core>;
+
+  // A resolve started by StartAsyncResolve().
+  struct AsyncResolve {
+    AsyncResolve() : request(NULL) {}
+
+    HostResolver::RequestHandle request;
+    AddressList addresses;
+    CompletionCallback callback;
+  };
+
   ~Core() {}
 
   bool HasShutdownLocked() const {
@@ -48,9 +70,17 @@ class SyncHostResolverBridge::Core
                     AddressList* addresses,
                     const BoundNetLog& net_log);
 
+  // Called on |host_resolver_loop_|.
+  void StartResolveFromCache(const HostResolver::RequestInfo& info,
+                             AddressList* addresses,
+                             const BoundNetLog& net_log);
+
   // Called on |host_resolver_loop_|.
   void OnResolveCompletion(int result);
 
+  // Called on |host_resolver_loop_|.
+  void OnAsyncResolveCompletion(AsyncResolve* resolve, int result);
+
   // Not called on |host_resolver_loop_|.
   int WaitForResolveCompletion();
 
@@ -61,6 +91,10 @@ class SyncHostResolverBridge::Core
   // The currently outstanding request to |host_resolver_|, or NULL.
   HostResolver::RequestHandle outstanding_request_;
 
+  // Resolves started by StartAsyncResolve() that have not completed yet. Only
+  // accessed on |host_resolver_loop_|.
+  std::set<AsyncResolve*> async_resolves_;
+
   // Event to notify completion of resolve request.  We always Signal() on
   // |host_resolver_loop_| and Wait() on a different thread.
   base::WaitableEvent event_;
@@ -95,6 +129,40 @@ int SyncHostResolverBridge::Core::ResolveSynchronously(
   return WaitForResolveCompletion();
 }
 
+int SyncHostResolverBridge::Core::ResolveFromCacheSynchronously(
+    const HostResolver::RequestInfo& info,
+    net::AddressList* addresses,
+    const BoundNetLog& net_log) {
+  // The host cache lives on the resolver's thread, so this still waits on a
+  // task there -- but never on the network.
+  host_resolver_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&Core::StartResolveFromCache, this, info, addresses,
+                 net_log));
+
+  return WaitForResolveCompletion();
+}
+
+void SyncHostResolverBridge::Core::StartAsyncResolve(
+    const HostResolver::RequestInfo& info,
+    const BoundNetLog& net_log,
+    const CompletionCallback& callback) {
+  DCHECK_EQ(MessageLoop::current(), host_resolver_loop_);
+
+  if (HasShutdown())
+    return;
+
+  AsyncResolve* resolve = new AsyncResolve;
+  resolve->callback = callback;
+  int error = host_resolver_->Resolve(
+      info, &resolve->addresses,
+      base::Bind(&Core::OnAsyncResolveCompletion, this, resolve),
+      &resolve->request, net_log);
+  async_resolves_.insert(resolve);
+  if (error != ERR_IO_PENDING)
+    OnAsyncResolveCompletion(resolve, error);  // Completed synchronously.
+}
+
 void SyncHostResolverBridge::Core::StartResolve(
     const HostResolver::RequestInfo& info,
     net::AddressList* addresses,
@@ -112,6 +180,19 @@ void SyncHostResolverBridge::Core::StartResolve(
     OnResolveCompletion(error);  // Completed synchronously.
 }
 
+void SyncHostResolverBridge::Core::StartResolveFromCache(
+    const HostResolver::RequestInfo& info,
+    net::AddressList* addresses,
+    const BoundNetLog& net_log) {
+  DCHECK_EQ(MessageLoop::current(), host_resolver_loop_);
+
+  if (HasShutdown())
+    return;
+
+  OnResolveCompletion(
+      host_resolver_->ResolveFromCache(info, addresses, net_log));
+}
+
 void SyncHostResolverBridge::Core::OnResolveCompletion(int result) {
   DCHECK_EQ(MessageLoop::current(), host_resolver_loop_);
   err_ = result;
@@ -119,6 +200,14 @@ void SyncHostResolverBridge::Core::OnResolveCompletion(int result) {
   event_.Signal();
 }
 
+void SyncHostResolverBridge::Core::OnAsyncResolveCompletion(
+    AsyncResolve* resolve, int result) {
+  DCHECK_EQ(MessageLoop::current(), host_resolver_loop_);
+  async_resolves_.erase(resolve);
+  scoped_ptr<AsyncResolve> deleter(resolve);
+  resolve->callback.Run(result);
+}
+
 int SyncHostResolverBridge::Core::WaitForResolveCompletion() {
   DCHECK_NE(MessageLoop::current(), host_resolver_loop_);
   event_.Wait();
@@ -141,6 +230,12 @@ void SyncHostResolverBridge::Core::Shutdown() {
     outstanding_request_ = NULL;
   }
 
+  for (std::set<AsyncResolve*>::iterator it = async_resolves_.begin();
+       it != async_resolves_.end(); ++it) {
+    host_resolver_->CancelRequest((*it)->request);
+  }
+  STLDeleteElements(&async_resolves_);
+
   {
     base::AutoLock l(lock_);
     has_shutdown_ = true;
@@ -169,6 +264,23 @@ int SyncHostResolverBridge::Resolve(const HostResolver::RequestInfo& info,
   return core_->ResolveSynchronously(info, addresses, net_log);
 }
 
+int SyncHostResolverBridge::ResolveFromCache(
+    const HostResolver::RequestInfo& info,
+    AddressList* addresses,
+    const BoundNetLog& net_log) {
+  return core_->ResolveFromCacheSynchronously(info, addresses, net_log);
+}
+
+void SyncHostResolverBridge::StartResolve(
+    const HostResolver::RequestInfo& info,
+    const BoundNetLog& net_log,
+    const CompletionCallback& callback) {
+  host_resolver_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&Core::StartAsyncResolve, core_.get(), info, net_log,
+                 callback));
+}
+
 void SyncHostResolverBridge::Shutdown() {
   DCHECK_EQ(MessageLoop::current(), host_resolver_loop_);
   core_->Shutdown();
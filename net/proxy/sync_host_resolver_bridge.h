@@ -26,10 +26,17 @@ class NET_EXPORT_PRIVATE SyncHostResolverBridge : public SyncHostResolver {
   virtual int Resolve(const HostResolver::RequestInfo& info,
                       AddressList* addresses,
                       const BoundNetLog& net_log) OVERRIDE;
+  virtual int ResolveFromCache(const HostResolver::RequestInfo& info,
+                               AddressList* addresses,
+                               const BoundNetLog& net_log) OVERRIDE;
+  virtual void StartResolve(const HostResolver::RequestInfo& info,
+                            const BoundNetLog& net_log,
+                            const CompletionCallback& callback) OVERRIDE;
 
   // The Shutdown() method should be called prior to destruction, from
   // |host_resolver_loop_|. It aborts any in progress synchronous resolves, to
-  // prevent deadlocks from happening.
+  // prevent deadlocks from happening. Background resolves started by
+  // StartResolve() are cancelled without running their callbacks.
   virtual void Shutdown() OVERRIDE;
 
  private:
@@ -62,9 +62,38 @@ void HttpConnection::Send500(const std::string& message) {
       message.c_str()));
 }
 
+void HttpConnection::Send200Chunked(const std::string& content_type) {
+  if (!socket_)
+    return;
+  socket_->Send(base::StringPrintf(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type:%s\r\n"
+      "Transfer-Encoding:chunked\r\n"
+      "\r\n",
+      content_type.c_str()));
+}
+
+void HttpConnection::SendChunk(const std::string& data) {
+  // An empty chunk would end the response.
+  if (!socket_ || data.empty())
+    return;
+  socket_->Send(base::StringPrintf("%X\r\n",
+                                   static_cast<unsigned>(data.length())));
+  socket_->Send(data);
+  socket_->Send("\r\n");
+}
+
+void HttpConnection::SendLastChunk() {
+  if (!socket_)
+    return;
+  socket_->Send("0\r\n\r\n");
+}
+
 HttpConnection::HttpConnection(HttpServer* server, ListenSocket* sock)
     : server_(server),
-      socket_(sock) {
+      socket_(sock),
+      headers_scan_pos_(0),
+      close_after_response_(false) {
   id_ = last_id_++;
 }
 
@@ -78,7 +107,8 @@ void HttpConnection::DetachSocket() {
 }
 
 void HttpConnection::Shift(int num_bytes) {
-  recv_data_ = recv_data_.substr(num_bytes);
+  recv_data_.erase(0, num_bytes);
+  headers_scan_pos_ = 0;
 }
 
 }  // namespace net
@@ -26,6 +26,12 @@ class HttpConnection {
   void Send404();
   void Send500(const std::string& message);
 
+  // Sends the headers of a 200 response whose body follows in chunks sent
+  // with SendChunk(), up to SendLastChunk().
+  void Send200Chunked(const std::string& content_type);
+  void SendChunk(const std::string& data);
+  void SendLastChunk();
+
   void Shift(int num_bytes);
 
   const std::string& recv_data() const { return recv_data_; }
@@ -44,6 +50,10 @@ class HttpConnection {
   scoped_refptr<ListenSocket> socket_;
   scoped_ptr<WebSocket> web_socket_;
   std::string recv_data_;
+  // Where to resume looking for the end of the request headers.
+  size_t headers_scan_pos_;
+  // True if the client asked to close the connection after the response.
+  bool close_after_response_;
   int id_;
   DISALLOW_COPY_AND_ASSIGN(HttpConnection);
 };
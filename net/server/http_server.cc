@@ -6,6 +6,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/logging.h"
+#include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/sys_byteorder.h"
@@ -17,6 +18,14 @@
 
 namespace net {
 
+namespace {
+
+// Connections that send more than this without a complete request are closed.
+const size_t kMaxRequestHeadersSize = 64 * 1024;
+const int64 kMaxRequestBodySize = 1024 * 1024;
+
+}  // namespace
+
 HttpServer::HttpServer(const std::string& host,
                        int port,
                        HttpServer::Delegate* del)
@@ -66,6 +75,7 @@ void HttpServer::Send200(int connection_id,
   if (connection == NULL)
     return;
   connection->Send200(data, content_type);
+  OnResponseSent(connection);
 }
 
 void HttpServer::Send404(int connection_id) {
@@ -73,6 +83,7 @@ void HttpServer::Send404(int connection_id) {
   if (connection == NULL)
     return;
   connection->Send404();
+  OnResponseSent(connection);
 }
 
 void HttpServer::Send500(int connection_id, const std::string& message) {
@@ -80,6 +91,30 @@ void HttpServer::Send500(int connection_id, const std::string& message) {
   if (connection == NULL)
     return;
   connection->Send500(message);
+  OnResponseSent(connection);
+}
+
+void HttpServer::Send200Chunked(int connection_id,
+                                const std::string& content_type) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  connection->Send200Chunked(content_type);
+}
+
+void HttpServer::SendChunk(int connection_id, const std::string& data) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  connection->SendChunk(data);
+}
+
+void HttpServer::SendLastChunk(int connection_id) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  connection->SendLastChunk();
+  OnResponseSent(connection);
 }
 
 void HttpServer::Close(int connection_id)
@@ -108,6 +143,8 @@ void HttpServer::DidRead(ListenSocket* socket,
   if (connection == NULL)
     return;
 
+  // The delegate may close the connection while handling what it receives.
+  int connection_id = connection->id();
   connection->recv_data_.append(data, len);
   while (connection->recv_data_.length()) {
     if (connection->web_socket_.get()) {
@@ -121,14 +158,30 @@ void HttpServer::DidRead(ListenSocket* socket,
         Close(connection->id());
         break;
       }
-      delegate_->OnWebSocketMessage(connection->id(), message);
+      delegate_->OnWebSocketMessage(connection_id, message);
+      if (!FindConnection(connection_id))
+        return;
       continue;
     }
 
+    if (connection->close_after_response_) {
+      // Nothing may follow a request that closes the connection.
+      connection->recv_data_.clear();
+      break;
+    }
+
+    if (!HasCompleteHeaders(connection)) {
+      if (connection->recv_data_.length() > kMaxRequestHeadersSize)
+        Close(connection_id);
+      break;
+    }
+
     HttpServerRequestInfo request;
     size_t pos = 0;
-    if (!ParseHeaders(connection, &request, &pos))
+    if (!ParseHeaders(connection, &request, &pos)) {
+      Close(connection_id);
       break;
+    }
 
     std::string connection_header = request.GetHeaderValue("Connection");
     if (connection_header == "Upgrade") {
@@ -138,13 +191,37 @@ void HttpServer::DidRead(ListenSocket* socket,
 
       if (!connection->web_socket_.get())  // Not enought data was received.
         break;
-      delegate_->OnWebSocketRequest(connection->id(), request);
+      delegate_->OnWebSocketRequest(connection_id, request);
+      if (!FindConnection(connection_id))
+        return;
       connection->Shift(pos);
       continue;
     }
-    // Request body is not supported. It is always empty.
-    delegate_->OnHttpRequest(connection->id(), request);
+
+    std::string content_length = request.GetHeaderValue("Content-Length");
+    if (!content_length.empty()) {
+      int64 body_size = 0;
+      if (!base::StringToInt64(content_length, &body_size) || body_size < 0 ||
+          body_size > kMaxRequestBodySize) {
+        Close(connection_id);
+        break;
+      }
+      // Wait for the rest of the body.
+      if (static_cast<int64>(connection->recv_data_.length() - pos) <
+          body_size) {
+        break;
+      }
+      request.data = connection->recv_data_.substr(
+          pos, static_cast<size_t>(body_size));
+      pos += static_cast<size_t>(body_size);
+    }
+
+    if (LowerCaseEqualsASCII(request.GetHeaderValue("Connection"), "close"))
+      connection->close_after_response_ = true;
     connection->Shift(pos);
+    delegate_->OnHttpRequest(connection_id, request);
+    if (!FindConnection(connection_id))
+      return;
   }
 }
 
@@ -226,6 +303,19 @@ int charToInput(char ch) {
   return INPUT_DEFAULT;
 }
 
+bool HttpServer::HasCompleteHeaders(HttpConnection* connection) {
+  // The headers end with an empty line, which the parser accepts after either
+  // "\r\n" or "\n".
+  const std::string& data = connection->recv_data_;
+  size_t end = data.find("\n\r\n", connection->headers_scan_pos_);
+  if (end == std::string::npos) {
+    connection->headers_scan_pos_ = data.length() < 2 ? 0 : data.length() - 2;
+    return false;
+  }
+  connection->headers_scan_pos_ = end;
+  return true;
+}
+
 bool HttpServer::ParseHeaders(HttpConnection* connection,
                               HttpServerRequestInfo* info,
                               size_t* ppos) {
@@ -309,4 +399,9 @@ HttpConnection* HttpServer::FindConnection(ListenSocket* socket) {
   return it->second;
 }
 
+void HttpServer::OnResponseSent(HttpConnection* connection) {
+  if (connection->close_after_response_)
+    Close(connection->id());
+}
+
 }  // namespace net
@@ -51,6 +51,11 @@ class HttpServer : public ListenSocket::ListenSocketDelegate,
                const std::string& mime_type);
   void Send404(int connection_id);
   void Send500(int connection_id, const std::string& message);
+  // Streams a 200 response: the headers, then each piece of the body as it
+  // becomes available, then the end of the body.
+  void Send200Chunked(int connection_id, const std::string& mime_type);
+  void SendChunk(int connection_id, const std::string& data);
+  void SendLastChunk(int connection_id);
   void Close(int connection_id);
 
   // ListenSocketDelegate
@@ -67,9 +72,12 @@ class HttpServer : public ListenSocket::ListenSocketDelegate,
   friend class base::RefCountedThreadSafe<HttpServer>;
   friend class HttpConnection;
 
+  // Returns true if the headers of a request are in recv_data_. Only looks at
+  // the data that was not searched by previous calls.
+  bool HasCompleteHeaders(HttpConnection* connection);
+
   // Expects the raw data to be stored in recv_data_. If parsing is successful,
-  // will remove the data parsed from recv_data_, leaving only the unused
-  // recv data.
+  // |pos| is set to the end of the headers.
   bool ParseHeaders(HttpConnection* connection,
                     HttpServerRequestInfo* info,
                     size_t* pos);
@@ -77,6 +85,9 @@ class HttpServer : public ListenSocket::ListenSocketDelegate,
   HttpConnection* FindConnection(int connection_id);
   HttpConnection* FindConnection(ListenSocket* socket);
 
+  // Closes |connection| if the client asked for it, once a response was sent.
+  void OnResponseSent(HttpConnection* connection);
+
   HttpServer::Delegate* delegate_;
   scoped_refptr<ListenSocket> server_;
   typedef std::map<int, HttpConnection*> IdToConnectionMap;
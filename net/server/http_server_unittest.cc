@@ -0,0 +1,170 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/server/http_server.h"
+
+#include <string>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop.h"
+#include "net/base/listen_socket.h"
+#include "net/server/http_server_request_info.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A connected socket that keeps what is sent to it.
+class TestListenSocket : public ListenSocket {
+ public:
+  explicit TestListenSocket(ListenSocketDelegate* del) : ListenSocket(del) {}
+
+  const std::string& sent() const { return sent_; }
+
+ protected:
+  virtual void SendInternal(const char* bytes, int len) OVERRIDE {
+    sent_.append(bytes, len);
+  }
+
+ private:
+  virtual ~TestListenSocket() {}
+
+  std::string sent_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestListenSocket);
+};
+
+class HttpServerTest : public testing::Test,
+                       public HttpServer::Delegate {
+ protected:
+  HttpServerTest() : last_connection_id_(-1), num_closed_(0) {}
+
+  virtual void SetUp() OVERRIDE {
+    server_ = new HttpServer("127.0.0.1", 0, this);
+    socket_ = new TestListenSocket(server_.get());
+    server_->DidAccept(NULL, socket_);
+  }
+
+  virtual void TearDown() OVERRIDE {
+    server_ = NULL;
+  }
+
+  void Read(const std::string& data) {
+    server_->DidRead(socket_, data.data(), static_cast<int>(data.length()));
+  }
+
+  // HttpServer::Delegate implementation.
+  virtual void OnHttpRequest(int connection_id,
+                             const HttpServerRequestInfo& info) OVERRIDE {
+    last_connection_id_ = connection_id;
+    requests_.push_back(info);
+  }
+  virtual void OnWebSocketRequest(int connection_id,
+                                  const HttpServerRequestInfo& info) OVERRIDE {
+  }
+  virtual void OnWebSocketMessage(int connection_id,
+                                  const std::string& data) OVERRIDE {
+  }
+  virtual void OnClose(int connection_id) OVERRIDE {
+    num_closed_++;
+  }
+
+  MessageLoopForIO message_loop_;
+  scoped_refptr<HttpServer> server_;
+  scoped_refptr<TestListenSocket> socket_;
+  std::vector<HttpServerRequestInfo> requests_;
+  int last_connection_id_;
+  int num_closed_;
+};
+
+TEST_F(HttpServerTest, RequestSplitAcrossReads) {
+  std::string request(
+      "GET /json/version HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "\r\n");
+  for (size_t i = 0; i < request.length(); ++i) {
+    EXPECT_EQ(0u, requests_.size());
+    Read(request.substr(i, 1));
+  }
+  ASSERT_EQ(1u, requests_.size());
+  EXPECT_EQ("GET", requests_[0].method);
+  EXPECT_EQ("/json/version", requests_[0].path);
+  EXPECT_EQ("localhost", requests_[0].GetHeaderValue("Host"));
+}
+
+TEST_F(HttpServerTest, KeepAlive) {
+  Read("GET /a HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\n\r\nGET /c HTTP/1.1\r\n");
+  ASSERT_EQ(2u, requests_.size());
+  EXPECT_EQ("/a", requests_[0].path);
+  EXPECT_EQ("/b", requests_[1].path);
+
+  server_->Send200(last_connection_id_, "ok", "text/plain");
+  EXPECT_EQ(0, num_closed_);
+
+  Read("\r\n");
+  ASSERT_EQ(3u, requests_.size());
+  EXPECT_EQ("/c", requests_[2].path);
+}
+
+TEST_F(HttpServerTest, RequestBody) {
+  Read("POST /upload HTTP/1.1\r\nContent-Length: 10\r\n\r\n01234");
+  EXPECT_EQ(0u, requests_.size());
+  Read("56789GET /next HTTP/1.1\r\n\r\n");
+  ASSERT_EQ(2u, requests_.size());
+  EXPECT_EQ("0123456789", requests_[0].data);
+  EXPECT_EQ("/next", requests_[1].path);
+  EXPECT_EQ("", requests_[1].data);
+}
+
+TEST_F(HttpServerTest, ConnectionClose) {
+  Read("GET /a HTTP/1.1\r\nConnection: close\r\n\r\nGET /b HTTP/1.1\r\n\r\n");
+  ASSERT_EQ(1u, requests_.size());
+  EXPECT_EQ(0, num_closed_);
+
+  server_->Send404(last_connection_id_);
+  EXPECT_EQ(1, num_closed_);
+}
+
+TEST_F(HttpServerTest, HeadersTooLarge) {
+  Read("GET / HTTP/1.1\r\n");
+  std::string header("X-Padding: " + std::string(1024, 'a') + "\r\n");
+  for (int i = 0; i < 100 && !num_closed_; ++i)
+    Read(header);
+  EXPECT_EQ(1, num_closed_);
+  EXPECT_EQ(0u, requests_.size());
+}
+
+TEST_F(HttpServerTest, BodyTooLarge) {
+  Read("POST / HTTP/1.1\r\nContent-Length: 100000000\r\n\r\n");
+  EXPECT_EQ(1, num_closed_);
+  EXPECT_EQ(0u, requests_.size());
+}
+
+TEST_F(HttpServerTest, ChunkedResponse) {
+  Read("GET /trace HTTP/1.1\r\n\r\n");
+  ASSERT_EQ(1u, requests_.size());
+
+  server_->Send200Chunked(last_connection_id_, "application/json");
+  server_->SendChunk(last_connection_id_, "[1,2");
+  server_->SendChunk(last_connection_id_, std::string(16, '3'));
+  server_->SendChunk(last_connection_id_, "]");
+  server_->SendLastChunk(last_connection_id_);
+  EXPECT_EQ("HTTP/1.1 200 OK\r\n"
+            "Content-Type:application/json\r\n"
+            "Transfer-Encoding:chunked\r\n"
+            "\r\n"
+            "4\r\n[1,2\r\n"
+            "10\r\n3333333333333333\r\n"
+            "1\r\n]\r\n"
+            "0\r\n\r\n",
+            socket_->sent());
+  EXPECT_EQ(0, num_closed_);
+}
+
+}  // namespace
+
+}  // namespace net
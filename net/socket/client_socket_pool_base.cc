@@ -271,6 +271,7 @@ int ClientSocketPoolBaseHelper::RequestSocket(
     delete request;
   } else {
     InsertRequestIntoQueue(request, group->mutable_pending_requests());
+    UpdateGroupIndexes(group_name, group);
   }
   return rv;
 }
@@ -338,7 +339,7 @@ int ClientSocketPoolBaseHelper::RequestSocketInternal(
 
   if (!(request->flags() & NO_IDLE_SOCKETS)) {
     // Try to reuse a socket.
-    if (AssignIdleSocketToGroup(request, group))
+    if (AssignIdleSocketToGroup(request, group_name, group))
       return OK;
   }
 
@@ -389,7 +390,7 @@ int ClientSocketPoolBaseHelper::RequestSocketInternal(
       HandOutSocket(connect_job->ReleaseSocket(), false /* not reused */,
                     handle, base::TimeDelta(), group, request->net_log());
     } else {
-      AddIdleSocket(connect_job->ReleaseSocket(), group);
+      AddIdleSocket(connect_job->ReleaseSocket(), group_name, group);
     }
   } else if (rv == ERR_IO_PENDING) {
     // If we don't have any sockets in this group, set a timer for potentially
@@ -423,7 +424,7 @@ int ClientSocketPoolBaseHelper::RequestSocketInternal(
 }
 
 bool ClientSocketPoolBaseHelper::AssignIdleSocketToGroup(
-    const Request* request, Group* group) {
+    const Request* request, const std::string& group_name, Group* group) {
   std::list<IdleSocket>* idle_sockets = group->mutable_idle_sockets();
   std::list<IdleSocket>::iterator idle_socket_it = idle_sockets->end();
   double max_score = -1;
@@ -476,6 +477,7 @@ bool ClientSocketPoolBaseHelper::AssignIdleSocketToGroup(
         base::TimeTicks::Now() - idle_socket_it->start_time;
     IdleSocket idle_socket = *idle_socket_it;
     idle_sockets->erase(idle_socket_it);
+    UpdateGroupIndexes(group_name, group);
     HandOutSocket(
         idle_socket.socket,
         idle_socket.socket->WasEverUsed(),
@@ -486,6 +488,7 @@ bool ClientSocketPoolBaseHelper::AssignIdleSocketToGroup(
     return true;
   }
 
+  UpdateGroupIndexes(group_name, group);
   return false;
 }
 
@@ -522,6 +525,7 @@ void ClientSocketPoolBaseHelper::CancelRequest(
   for (; it != group->pending_requests().end(); ++it) {
     if ((*it)->handle() == handle) {
       scoped_ptr<const Request> req(RemoveRequestFromQueue(it, group));
+      UpdateGroupIndexes(group_name, group);
       req->net_log().AddEvent(NetLog::TYPE_CANCELLED, NULL);
       req->net_log().EndEvent(NetLog::TYPE_SOCKET_POOL, NULL);
 
@@ -668,9 +672,13 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
   // inside the inner loop, since it shouldn't change by any meaningful amount.
   base::TimeTicks now = base::TimeTicks::Now();
 
-  GroupMap::iterator i = group_map_.begin();
-  while (i != group_map_.end()) {
+  GroupMap::iterator i = idle_socket_groups_.begin();
+  while (i != idle_socket_groups_.end()) {
+    // Copy the name, since |i| is advanced before the group's entry may be
+    // removed.
+    const std::string group_name = i->first;
     Group* group = i->second;
+    ++i;
 
     std::list<IdleSocket>::iterator j = group->mutable_idle_sockets()->begin();
     while (j != group->idle_sockets().end()) {
@@ -687,11 +695,10 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
     }
 
     // Delete group if no longer needed.
-    if (group->IsEmpty()) {
-      RemoveGroup(i++);
-    } else {
-      ++i;
-    }
+    if (group->IsEmpty())
+      RemoveGroup(group_name);
+    else
+      UpdateGroupIndexes(group_name, group);
   }
 }
 
@@ -713,10 +720,25 @@ void ClientSocketPoolBaseHelper::RemoveGroup(const std::string& group_name) {
 }
 
 void ClientSocketPoolBaseHelper::RemoveGroup(GroupMap::iterator it) {
+  pending_request_groups_.erase(it->first);
+  idle_socket_groups_.erase(it->first);
   delete it->second;
   group_map_.erase(it);
 }
 
+void ClientSocketPoolBaseHelper::UpdateGroupIndexes(
+    const std::string& group_name, Group* group) {
+  if (group->pending_requests().empty())
+    pending_request_groups_.erase(group_name);
+  else
+    pending_request_groups_[group_name] = group;
+
+  if (group->idle_sockets().empty())
+    idle_socket_groups_.erase(group_name);
+  else
+    idle_socket_groups_[group_name] = group;
+}
+
 // static
 bool ClientSocketPoolBaseHelper::connect_backup_jobs_enabled() {
   return g_connect_backup_jobs_enabled;
@@ -778,7 +800,7 @@ void ClientSocketPoolBaseHelper::ReleaseSocket(const std::string& group_name,
       id == pool_generation_number_;
   if (can_reuse) {
     // Add it to the idle list.
-    AddIdleSocket(socket, group);
+    AddIdleSocket(socket, group_name, group);
     OnAvailableSocketSlot(group_name, group);
   } else {
     delete socket;
@@ -822,12 +844,10 @@ bool ClientSocketPoolBaseHelper::FindTopStalledGroup(
   Group* top_group = NULL;
   const std::string* top_group_name = NULL;
   bool has_stalled_group = false;
-  for (GroupMap::const_iterator i = group_map_.begin();
-       i != group_map_.end(); ++i) {
+  for (GroupMap::const_iterator i = pending_request_groups_.begin();
+       i != pending_request_groups_.end(); ++i) {
     Group* curr_group = i->second;
-    const RequestQueue& queue = curr_group->pending_requests();
-    if (queue.empty())
-      continue;
+    DCHECK(!curr_group->pending_requests().empty());
     if (curr_group->IsStalledOnPoolMaxSockets(max_sockets_per_group_)) {
       if (!group)
         return true;
@@ -869,6 +889,7 @@ void ClientSocketPoolBaseHelper::OnConnectJobComplete(
     if (!group->pending_requests().empty()) {
       scoped_ptr<const Request> r(RemoveRequestFromQueue(
           group->mutable_pending_requests()->begin(), group));
+      UpdateGroupIndexes(group_name, group);
       LogBoundConnectJobToRequest(job_log.source(), r.get());
       HandOutSocket(
           socket.release(), false /* unused socket */, r->handle(),
@@ -876,7 +897,7 @@ void ClientSocketPoolBaseHelper::OnConnectJobComplete(
       r->net_log().EndEvent(NetLog::TYPE_SOCKET_POOL, NULL);
       InvokeUserCallbackLater(r->handle(), r->callback(), result);
     } else {
-      AddIdleSocket(socket.release(), group);
+      AddIdleSocket(socket.release(), group_name, group);
       OnAvailableSocketSlot(group_name, group);
       CheckForStalledSocketGroups();
     }
@@ -887,6 +908,7 @@ void ClientSocketPoolBaseHelper::OnConnectJobComplete(
     if (!group->pending_requests().empty()) {
       scoped_ptr<const Request> r(RemoveRequestFromQueue(
           group->mutable_pending_requests()->begin(), group));
+      UpdateGroupIndexes(group_name, group);
       LogBoundConnectJobToRequest(job_log.source(), r.get());
       job->GetAdditionalErrorState(r->handle());
       RemoveConnectJob(job, group);
@@ -930,8 +952,8 @@ bool ClientSocketPoolBaseHelper::IsStalled() const {
   // than |max_sockets_per_group_|.  (If the number of jobs is equal to
   // |max_sockets_per_group_|, then the request is stalled on the group,
   // which does not count.)
-  for (GroupMap::const_iterator it = group_map_.begin();
-       it != group_map_.end(); ++it) {
+  for (GroupMap::const_iterator it = pending_request_groups_.begin();
+       it != pending_request_groups_.end(); ++it) {
     if (it->second->IsStalledOnPoolMaxSockets(max_sockets_per_group_))
       return true;
   }
@@ -974,6 +996,8 @@ void ClientSocketPoolBaseHelper::ProcessPendingRequest(
           group->mutable_pending_requests()->begin(), group));
     if (group->IsEmpty())
       RemoveGroup(group_name);
+    else
+      UpdateGroupIndexes(group_name, group);
 
     request->net_log().EndEventWithNetErrorCode(NetLog::TYPE_SOCKET_POOL, rv);
     InvokeUserCallbackLater(request->handle(), request->callback(), rv);
@@ -1009,7 +1033,7 @@ void ClientSocketPoolBaseHelper::HandOutSocket(
 }
 
 void ClientSocketPoolBaseHelper::AddIdleSocket(
-    StreamSocket* socket, Group* group) {
+    StreamSocket* socket, const std::string& group_name, Group* group) {
   DCHECK(socket);
   IdleSocket idle_socket;
   idle_socket.socket = socket;
@@ -1017,6 +1041,7 @@ void ClientSocketPoolBaseHelper::AddIdleSocket(
 
   group->mutable_idle_sockets()->push_back(idle_socket);
   IncrementIdleCount();
+  UpdateGroupIndexes(group_name, group);
 }
 
 void ClientSocketPoolBaseHelper::CancelAllConnectJobs() {
@@ -1050,6 +1075,7 @@ void ClientSocketPoolBaseHelper::AbortAllRequests() {
       InvokeUserCallbackLater(
           request->handle(), request->callback(), ERR_ABORTED);
     }
+    UpdateGroupIndexes(i->first, group);
 
     // Delete group if no longer needed.
     if (group->IsEmpty()) {
@@ -1084,21 +1110,25 @@ bool ClientSocketPoolBaseHelper::CloseOneIdleSocketExceptInGroup(
     const Group* exception_group) {
   CHECK_GT(idle_socket_count(), 0);
 
-  for (GroupMap::iterator i = group_map_.begin(); i != group_map_.end(); ++i) {
+  for (GroupMap::iterator i = idle_socket_groups_.begin();
+       i != idle_socket_groups_.end(); ++i) {
     Group* group = i->second;
     if (exception_group == group)
       continue;
     std::list<IdleSocket>* idle_sockets = group->mutable_idle_sockets();
+    DCHECK(!idle_sockets->empty());
 
-    if (!idle_sockets->empty()) {
-      delete idle_sockets->front().socket;
-      idle_sockets->pop_front();
-      DecrementIdleCount();
-      if (group->IsEmpty())
-        RemoveGroup(i);
+    // Copy the name, since the entry of |i| may be removed.
+    const std::string group_name = i->first;
+    delete idle_sockets->front().socket;
+    idle_sockets->pop_front();
+    DecrementIdleCount();
+    if (group->IsEmpty())
+      RemoveGroup(group_name);
+    else
+      UpdateGroupIndexes(group_name, group);
 
-      return true;
-    }
+    return true;
   }
 
   return false;
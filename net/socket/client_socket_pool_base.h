@@ -467,6 +467,11 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   void RemoveGroup(const std::string& group_name);
   void RemoveGroup(GroupMap::iterator it);
 
+  // Adds or removes |group| from |pending_request_groups_| and
+  // |idle_socket_groups_|. Must be called whenever the pending requests or the
+  // idle sockets of a group change between empty and non-empty.
+  void UpdateGroupIndexes(const std::string& group_name, Group* group);
+
   // Called when the number of idle sockets changes.
   void IncrementIdleCount();
   void DecrementIdleCount();
@@ -474,8 +479,8 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   // Start cleanup timer for idle sockets.
   void StartIdleSocketTimer();
 
-  // Scans the group map for groups which have an available socket slot and
-  // at least one pending request. Returns true if any groups are stalled, and
+  // Scans the groups with pending requests for groups which have an available
+  // socket slot. Returns true if any groups are stalled, and
   // if so (and if both |group| and |group_name| are not NULL), fills |group|
   // and |group_name| with data of the stalled group having highest priority.
   bool FindTopStalledGroup(Group** group, std::string* group_name) const;
@@ -504,7 +509,9 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
                      const BoundNetLog& net_log);
 
   // Adds |socket| to the list of idle sockets for |group|.
-  void AddIdleSocket(StreamSocket* socket, Group* group);
+  void AddIdleSocket(StreamSocket* socket,
+                     const std::string& group_name,
+                     Group* group);
 
   // Iterates through |group_map_|, canceling all ConnectJobs and deleting
   // groups if they are no longer needed.
@@ -525,7 +532,9 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
   // Assigns an idle socket for the group to the request.
   // Returns |true| if an idle socket is available, false otherwise.
-  bool AssignIdleSocketToGroup(const Request* request, Group* group);
+  bool AssignIdleSocketToGroup(const Request* request,
+                               const std::string& group_name,
+                               Group* group);
 
   static void LogBoundConnectJobToRequest(
       const NetLog::Source& connect_job_source, const Request* request);
@@ -553,6 +562,13 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
   GroupMap group_map_;
 
+  // The groups of |group_map_| that have pending requests, and the ones that
+  // have idle sockets. They are kept in the order of |group_map_| so that scans
+  // for stalled groups and idle sockets give the same results as scanning all
+  // the groups, without visiting the many groups that only hold active sockets.
+  GroupMap pending_request_groups_;
+  GroupMap idle_socket_groups_;
+
   // Map of the ClientSocketHandles for which we have a pending Task to invoke a
   // callback.  This is necessary since, before we invoke said callback, it's
   // possible that the request is cancelled.
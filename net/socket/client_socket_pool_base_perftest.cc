@@ -0,0 +1,175 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/client_socket_pool_base.h"
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/socket/client_socket_handle.h"
+#include "net/socket/client_socket_pool_histograms.h"
+#include "net/socket/stream_socket.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A proxy-heavy setup, with an idle socket to each of many hosts.
+const int kNumGroups = 10000;
+const int kMaxSocketsPerGroup = 6;
+const int kIterations = 20000;
+
+class TestSocketParams : public base::RefCounted<TestSocketParams> {
+ public:
+  TestSocketParams() {}
+
+  bool ignore_limits() { return false; }
+
+ private:
+  friend class base::RefCounted<TestSocketParams>;
+  ~TestSocketParams() {}
+};
+typedef ClientSocketPoolBase<TestSocketParams> TestClientSocketPoolBase;
+
+// A socket that is always connected and idle, and was used once.
+class IdleClientSocket : public StreamSocket {
+ public:
+  IdleClientSocket() {}
+
+  // Socket implementation.
+  virtual int Read(IOBuffer* buf, int buf_len,
+                   const CompletionCallback& callback) OVERRIDE {
+    return ERR_FAILED;
+  }
+  virtual int Write(IOBuffer* buf, int buf_len,
+                    const CompletionCallback& callback) OVERRIDE {
+    return ERR_FAILED;
+  }
+  virtual bool SetReceiveBufferSize(int32 size) OVERRIDE { return true; }
+  virtual bool SetSendBufferSize(int32 size) OVERRIDE { return true; }
+
+  // StreamSocket implementation.
+  virtual int Connect(const CompletionCallback& callback) OVERRIDE {
+    return OK;
+  }
+  virtual void Disconnect() OVERRIDE {}
+  virtual bool IsConnected() const OVERRIDE { return true; }
+  virtual bool IsConnectedAndIdle() const OVERRIDE { return true; }
+  virtual int GetPeerAddress(AddressList* address) const OVERRIDE {
+    return ERR_UNEXPECTED;
+  }
+  virtual int GetLocalAddress(IPEndPoint* address) const OVERRIDE {
+    return ERR_UNEXPECTED;
+  }
+  virtual const BoundNetLog& NetLog() const OVERRIDE { return net_log_; }
+  virtual void SetSubresourceSpeculation() OVERRIDE {}
+  virtual void SetOmniboxSpeculation() OVERRIDE {}
+  virtual bool WasEverUsed() const OVERRIDE { return true; }
+  virtual bool UsingTCPFastOpen() const OVERRIDE { return false; }
+  virtual int64 NumBytesRead() const OVERRIDE { return 1024; }
+  virtual base::TimeDelta GetConnectTimeMicros() const OVERRIDE {
+    return base::TimeDelta::FromMicroseconds(10);
+  }
+  virtual NextProto GetNegotiatedProtocol() const OVERRIDE {
+    return kProtoUnknown;
+  }
+
+ private:
+  BoundNetLog net_log_;
+
+  DISALLOW_COPY_AND_ASSIGN(IdleClientSocket);
+};
+
+// A ConnectJob that connects synchronously.
+class SyncConnectJob : public ConnectJob {
+ public:
+  SyncConnectJob(const std::string& group_name, Delegate* delegate)
+      : ConnectJob(group_name, base::TimeDelta(), delegate, BoundNetLog()) {}
+
+  virtual LoadState GetLoadState() const OVERRIDE {
+    return LOAD_STATE_IDLE;
+  }
+
+ private:
+  virtual int ConnectInternal() OVERRIDE {
+    set_socket(new IdleClientSocket());
+    return OK;
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(SyncConnectJob);
+};
+
+class SyncConnectJobFactory
+    : public TestClientSocketPoolBase::ConnectJobFactory {
+ public:
+  SyncConnectJobFactory() {}
+
+  virtual ConnectJob* NewConnectJob(
+      const std::string& group_name,
+      const TestClientSocketPoolBase::Request& request,
+      ConnectJob::Delegate* delegate) const OVERRIDE {
+    return new SyncConnectJob(group_name, delegate);
+  }
+
+  virtual base::TimeDelta ConnectionTimeout() const OVERRIDE {
+    return base::TimeDelta::FromSeconds(240);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SyncConnectJobFactory);
+};
+
+void NoOpCallback(int result) {}
+
+class ClientSocketPoolBasePerfTest : public testing::Test {
+ protected:
+  ClientSocketPoolBasePerfTest()
+      : params_(new TestSocketParams()),
+        histograms_("PerfTest"),
+        pool_(2 * kNumGroups, kMaxSocketsPerGroup, &histograms_,
+              base::TimeDelta::FromMinutes(10),
+              base::TimeDelta::FromMinutes(10),
+              new SyncConnectJobFactory()) {
+  }
+
+  // Takes a socket from |group_name| and gives it back to the pool.
+  void UseSocket(const std::string& group_name) {
+    ClientSocketHandle handle;
+    EXPECT_EQ(OK, pool_.RequestSocket(group_name, params_, MEDIUM, &handle,
+                                      base::Bind(&NoOpCallback),
+                                      BoundNetLog()));
+    pool_.ReleaseSocket(group_name, handle.release_socket(), handle.id());
+  }
+
+  MessageLoop message_loop_;
+  scoped_refptr<TestSocketParams> params_;
+  ClientSocketPoolHistograms histograms_;
+  TestClientSocketPoolBase pool_;
+};
+
+// Each release of a socket looks for stalled groups, and each request looks
+// for idle sockets, which should not depend on the number of groups.
+TEST_F(ClientSocketPoolBasePerfTest, ReuseWithManyIdleGroups) {
+  for (int i = 0; i < kNumGroups; ++i)
+    UseSocket(base::StringPrintf("host%d:80", i));
+  EXPECT_EQ(kNumGroups, pool_.idle_socket_count());
+
+  PerfTimeLogger timer("ClientSocketPoolBase_ReuseWithManyIdleGroups");
+  for (int i = 0; i < kIterations; ++i)
+    UseSocket(base::StringPrintf("host%d:80", i % 100));
+  timer.Done();
+
+  EXPECT_EQ(kNumGroups, pool_.idle_socket_count());
+}
+
+}  // namespace
+
+}  // namespace net
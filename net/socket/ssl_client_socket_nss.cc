@@ -450,6 +450,10 @@ SSLClientSocketNSS::SSLClientSocketNSS(ClientSocketHandle* transport_socket,
       ssl_session_cache_shard_(context.ssl_session_cache_shard),
       eset_mitm_detected_(false),
       predicted_cert_chain_correct_(false),
+      persisted_session_imported_(false),
+      early_cert_verification_started_(false),
+      early_cert_verification_result_(ERR_IO_PENDING),
+      waiting_for_early_cert_verification_(false),
       next_handshake_state_(STATE_NONE),
       nss_fd_(NULL),
       nss_bufs_(NULL),
@@ -590,7 +594,8 @@ int SSLClientSocketNSS::Connect(const CompletionCallback& callback) {
     return rv;
   }
 
-  if (ssl_config_.cached_info_enabled && ssl_host_info_.get()) {
+  if (ssl_host_info_.get() && (ssl_config_.cached_info_enabled ||
+                               SSLHostInfo::session_persistence_enabled())) {
     GotoState(STATE_LOAD_SSL_HOST_INFO);
   } else {
     GotoState(STATE_HANDSHAKE);
@@ -650,6 +655,10 @@ void SSLClientSocketNSS::Disconnect() {
   eset_mitm_detected_    = false;
   start_cert_verification_time_ = base::TimeTicks();
   predicted_cert_chain_correct_ = false;
+  persisted_session_imported_ = false;
+  early_cert_verification_started_ = false;
+  early_cert_verification_result_ = ERR_IO_PENDING;
+  waiting_for_early_cert_verification_ = false;
   nss_bufs_              = NULL;
   client_certs_.clear();
   client_auth_cert_needed_ = false;
@@ -1397,6 +1406,27 @@ bool SSLClientSocketNSS::LoadSSLHostInfo() {
   return rv == SECSuccess;
 }
 
+// LoadSSLSession adds the session saved by SaveSSLHostInfo to the session cache
+// of NSS, so that a session established before a restart can be resumed.
+void SSLClientSocketNSS::LoadSSLSession() {
+  const SSLHostInfo::State& state(ssl_host_info_->state());
+
+  if (!SSLHostInfo::session_persistence_enabled() ||
+      state.session_state.empty() ||
+      state.session_host_and_port != host_and_port_.ToString()) {
+    return;
+  }
+
+  SECItem session_state;
+  session_state.type = siBuffer;
+  session_state.data = const_cast<uint8*>(
+      reinterpret_cast<const uint8*>(state.session_state.data()));
+  session_state.len = state.session_state.size();
+  // This fails if NSS already has a session for this server.
+  persisted_session_imported_ =
+      SSL_ImportSessionState(nss_fd_, &session_state) == SECSuccess;
+}
+
 int SSLClientSocketNSS::DoLoadSSLHostInfo() {
   EnterFunction("");
   int rv = ssl_host_info_->WaitForDataReady(
@@ -1405,8 +1435,9 @@ int SSLClientSocketNSS::DoLoadSSLHostInfo() {
   GotoState(STATE_HANDSHAKE);
 
   if (rv == OK) {
-    if (!LoadSSLHostInfo())
+    if (ssl_config_.cached_info_enabled && !LoadSSLHostInfo())
       LOG(WARNING) << "LoadSSLHostInfo failed: " << host_and_port_.ToString();
+    LoadSSLSession();
   } else {
     DCHECK_EQ(ERR_IO_PENDING, rv);
     GotoState(STATE_LOAD_SSL_HOST_INFO);
@@ -1509,6 +1540,15 @@ int SSLClientSocketNSS::DoHandshake() {
         }
 #endif
 
+        PRBool resumed;
+        if (SSL_HandshakeResumedSession(nss_fd_, &resumed) == SECSuccess) {
+          UMA_HISTOGRAM_BOOLEAN("Net.SSLSessionResumed", !!resumed);
+          if (persisted_session_imported_) {
+            UMA_HISTOGRAM_BOOLEAN("Net.SSLPersistedSessionResumed",
+                                  !!resumed);
+          }
+        }
+
         SaveSSLHostInfo();
         // SSL handshake is completed. Let's verify the certificate.
         GotoState(STATE_VERIFY_DNSSEC);
@@ -1665,14 +1705,15 @@ int SSLClientSocketNSS::DoVerifyCert(int result) {
     return ERR_CERT_INVALID;
   }
 
-  start_cert_verification_time_ = base::TimeTicks::Now();
-
   if (ssl_host_info_.get() && !ssl_host_info_->state().certs.empty() &&
       predicted_cert_chain_correct_) {
     // If the SSLHostInfo had a prediction for the certificate chain of this
     // server then it will have optimistically started a verification of that
     // chain. So, if the prediction was correct, we should wait for that
-    // verification to finish rather than start our own.
+    // verification to finish rather than start our own. It started before
+    // the one of StartEarlyCertVerification(), which we cancel.
+    verifier_.reset();
+    start_cert_verification_time_ = base::TimeTicks::Now();
     net_log_.AddEvent(NetLog::TYPE_SSL_VERIFICATION_MERGED, NULL);
     UMA_HISTOGRAM_ENUMERATION("Net.SSLVerificationMerged", 1 /* true */, 2);
     base::TimeTicks end_time = ssl_host_info_->verification_end_time();
@@ -1688,17 +1729,22 @@ int SSLClientSocketNSS::DoVerifyCert(int result) {
     UMA_HISTOGRAM_ENUMERATION("Net.SSLVerificationMerged", 0 /* false */, 2);
   }
 
-  int flags = 0;
-  if (ssl_config_.rev_checking_enabled)
-    flags |= X509Certificate::VERIFY_REV_CHECKING_ENABLED;
-  if (ssl_config_.verify_ev_cert)
-    flags |= X509Certificate::VERIFY_EV_CERT;
-  if (ssl_config_.cert_io_enabled)
-    flags |= X509Certificate::VERIFY_CERT_IO_ENABLED;
+  if (early_cert_verification_started_) {
+    // The verification started when the certificate was received.
+    UMA_HISTOGRAM_BOOLEAN("Net.SSLEarlyCertVerificationDone",
+                          early_cert_verification_result_ != ERR_IO_PENDING);
+    server_cert_verify_result_ = &local_server_cert_verify_result_;
+    if (early_cert_verification_result_ != ERR_IO_PENDING)
+      return early_cert_verification_result_;
+    waiting_for_early_cert_verification_ = true;
+    return ERR_IO_PENDING;
+  }
+
+  start_cert_verification_time_ = base::TimeTicks::Now();
   verifier_.reset(new SingleRequestCertVerifier(cert_verifier_));
   server_cert_verify_result_ = &local_server_cert_verify_result_;
   return verifier_->Verify(
-      server_cert_, host_and_port_.host(), flags,
+      server_cert_, host_and_port_.host(), GetCertVerifyFlags(),
       SSLConfigService::GetCRLSet(),
       &local_server_cert_verify_result_,
       base::Bind(&SSLClientSocketNSS::OnHandshakeIOComplete,
@@ -1878,7 +1924,8 @@ void SSLClientSocketNSS::LogConnectionTypeMetrics() const {
 }
 
 // SaveSSLHostInfo saves the certificate chain of the connection so that we can
-// start verification faster in the future.
+// start verification faster in the future, and its session so that it can be
+// resumed after a restart.
 void SSLClientSocketNSS::SaveSSLHostInfo() {
   if (!ssl_host_info_.get())
     return;
@@ -1901,6 +1948,17 @@ void SSLClientSocketNSS::SaveSSLHostInfo() {
           certs[i]->derCert.len));
   }
 
+  state->session_host_and_port.clear();
+  state->session_state.clear();
+  SECItem session_state;
+  if (SSLHostInfo::session_persistence_enabled() &&
+      SSL_ExportSessionState(nss_fd_, &session_state) == SECSuccess) {
+    state->session_host_and_port = host_and_port_.ToString();
+    state->session_state.assign(
+        reinterpret_cast<const char*>(session_state.data), session_state.len);
+    SECITEM_ZfreeItem(&session_state, PR_FALSE);
+  }
+
   ssl_host_info_->Persist();
 }
 
@@ -1979,7 +2037,15 @@ int SSLClientSocketNSS::BufferRecv(void) {
     // buffer too full to read into, so no I/O possible at moment
     rv = ERR_IO_PENDING;
   } else {
+#if defined(OS_WIN)
+    // An overlapped read may write to its buffer after we are gone, so it
+    // cannot use the memio buffer directly.
     recv_buffer_ = new IOBuffer(nb);
+#else
+    // Read straight into the memio buffer, saving a copy of every byte that we
+    // receive. The transport is disconnected before the buffer goes away.
+    recv_buffer_ = new WrappedIOBuffer(buf);
+#endif
     rv = transport_->socket()->Read(
         recv_buffer_, nb,
         base::Bind(&SSLClientSocketNSS::BufferRecvComplete,
@@ -1987,7 +2053,7 @@ int SSLClientSocketNSS::BufferRecv(void) {
     if (rv == ERR_IO_PENDING) {
       transport_recv_busy_ = true;
     } else {
-      if (rv > 0)
+      if (rv > 0 && recv_buffer_->data() != buf)
         memcpy(buf, recv_buffer_->data(), rv);
       memio_PutReadResult(nss_bufs_, MapErrorToNSS(rv));
       recv_buffer_ = NULL;
@@ -2002,7 +2068,8 @@ void SSLClientSocketNSS::BufferRecvComplete(int result) {
   if (result > 0) {
     char* buf;
     memio_GetReadParams(nss_bufs_, &buf);
-    memcpy(buf, recv_buffer_->data(), result);
+    if (recv_buffer_->data() != buf)
+      memcpy(buf, recv_buffer_->data(), result);
   }
   recv_buffer_ = NULL;
   memio_PutReadResult(nss_bufs_, MapErrorToNSS(result));
@@ -2053,9 +2120,9 @@ SECStatus SSLClientSocketNSS::OwnAuthCertHandler(void* arg,
                                                  PRFileDesc* socket,
                                                  PRBool checksig,
                                                  PRBool is_server) {
-#ifdef SSL_ENABLE_FALSE_START
   SSLClientSocketNSS* that = reinterpret_cast<SSLClientSocketNSS*>(arg);
   if (!that->server_cert_nss_) {
+#ifdef SSL_ENABLE_FALSE_START
     // Only need to turn off False Start in the initial handshake. Also, it is
     // unsafe to call SSL_OptionSet in a renegotiation because the "first
     // handshake" lock isn't already held, which will result in an assertion
@@ -2069,9 +2136,13 @@ SECStatus SSLClientSocketNSS::OwnAuthCertHandler(void* arg,
       // it.
       SSL_OptionSet(socket, SSL_ENABLE_FALSE_START, PR_FALSE);
     }
-  }
 #endif
 
+    // Rather than waiting for the end of the handshake, start verifying the
+    // certificate while NSS finishes the handshake.
+    that->StartEarlyCertVerification();
+  }
+
   // Tell NSS to not verify the certificate.
   return SECSuccess;
 }
@@ -2532,6 +2603,50 @@ SECStatus SSLClientSocketNSS::ClientAuthHandler(
 // NSS calls this when handshake is completed.
 // After the SSL handshake is finished, use CertVerifier to verify
 // the saved server certificate.
+void SSLClientSocketNSS::StartEarlyCertVerification() {
+  UpdateServerCert();
+  if (!server_cert_)
+    return;  // DoVerifyCert() will fail.
+
+  // Expected bad certificates aren't verified, see DoVerifyCert().
+  base::StringPiece der_cert(
+      reinterpret_cast<char*>(server_cert_nss_->derCert.data),
+      server_cert_nss_->derCert.len);
+  CertStatus cert_status;
+  if (ssl_config_.IsAllowedBadCert(der_cert, &cert_status))
+    return;
+
+  early_cert_verification_started_ = true;
+  start_cert_verification_time_ = base::TimeTicks::Now();
+  verifier_.reset(new SingleRequestCertVerifier(cert_verifier_));
+  early_cert_verification_result_ = verifier_->Verify(
+      server_cert_, host_and_port_.host(), GetCertVerifyFlags(),
+      SSLConfigService::GetCRLSet(),
+      &local_server_cert_verify_result_,
+      base::Bind(&SSLClientSocketNSS::OnEarlyCertVerificationComplete,
+                 base::Unretained(this)),
+      net_log_);
+}
+
+void SSLClientSocketNSS::OnEarlyCertVerificationComplete(int result) {
+  early_cert_verification_result_ = result;
+  if (waiting_for_early_cert_verification_) {
+    waiting_for_early_cert_verification_ = false;
+    OnHandshakeIOComplete(result);
+  }
+}
+
+int SSLClientSocketNSS::GetCertVerifyFlags() const {
+  int flags = 0;
+  if (ssl_config_.rev_checking_enabled)
+    flags |= X509Certificate::VERIFY_REV_CHECKING_ENABLED;
+  if (ssl_config_.verify_ev_cert)
+    flags |= X509Certificate::VERIFY_EV_CERT;
+  if (ssl_config_.cert_io_enabled)
+    flags |= X509Certificate::VERIFY_CERT_IO_ENABLED;
+  return flags;
+}
+
 void SSLClientSocketNSS::HandshakeCallback(PRFileDesc* socket,
                                            void* arg) {
   SSLClientSocketNSS* that = reinterpret_cast<SSLClientSocketNSS*>(arg);
@@ -115,6 +115,11 @@ class SSLClientSocketNSS : public SSLClientSocket {
   int InitializeSSLPeerName();
 
   void UpdateServerCert();
+  // Starts verifying the server certificate as soon as NSS has received it,
+  // so that the verification overlaps with the rest of the handshake.
+  void StartEarlyCertVerification();
+  void OnEarlyCertVerificationComplete(int result);
+  int GetCertVerifyFlags() const;
   void UpdateConnectionStatus();
   void DoReadCallback(int result);
   void DoWriteCallback(int result);
@@ -128,6 +133,7 @@ class SSLClientSocketNSS : public SSLClientSocket {
   int DoWriteLoop(int result);
 
   bool LoadSSLHostInfo();
+  void LoadSSLSession();
   int DoLoadSSLHostInfo();
 
   int DoHandshake();
@@ -276,6 +282,18 @@ class SSLClientSocketNSS : public SSLClientSocket {
   // that we found the prediction to be correct.
   bool predicted_cert_chain_correct_;
 
+  // True iff the session saved in |ssl_host_info_| was added to the session
+  // cache of NSS for this handshake.
+  bool persisted_session_imported_;
+
+  // True iff StartEarlyCertVerification() started verifying the certificate
+  // with |verifier_|, whose result is in |early_cert_verification_result_|,
+  // or ERR_IO_PENDING until it completes.
+  bool early_cert_verification_started_;
+  int early_cert_verification_result_;
+  // True while DoVerifyCert() waits for the early verification to complete.
+  bool waiting_for_early_cert_verification_;
+
   State next_handshake_state_;
 
   // The NSS SSL state machine
@@ -0,0 +1,136 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/ssl_client_socket.h"
+
+#include <map>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "net/base/address_list.h"
+#include "net/base/cert_verifier.h"
+#include "net/base/cert_verify_result.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/base/ssl_config_service.h"
+#include "net/base/test_completion_callback.h"
+#include "net/socket/client_socket_factory.h"
+#include "net/socket/tcp_client_socket.h"
+#include "net/test/test_server.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 20;
+// About the time of an online revocation check.
+const int kVerificationDelayMs = 50;
+
+// A CertVerifier that accepts every certificate after a delay.
+class SlowCertVerifier : public CertVerifier {
+ public:
+  SlowCertVerifier() : next_id_(1), weak_factory_(this) {}
+
+  virtual int Verify(X509Certificate* cert,
+                     const std::string& hostname,
+                     int flags,
+                     CRLSet* crl_set,
+                     CertVerifyResult* verify_result,
+                     const CompletionCallback& callback,
+                     RequestHandle* out_req,
+                     const BoundNetLog& net_log) OVERRIDE {
+    verify_result->Reset();
+    verify_result->verified_cert = cert;
+    int id = next_id_++;
+    callbacks_[id] = callback;
+    if (out_req)
+      *out_req = reinterpret_cast<RequestHandle>(id);
+    MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&SlowCertVerifier::Complete, weak_factory_.GetWeakPtr(),
+                   id),
+        base::TimeDelta::FromMilliseconds(kVerificationDelayMs));
+    return ERR_IO_PENDING;
+  }
+
+  virtual void CancelRequest(RequestHandle req) OVERRIDE {
+    callbacks_.erase(reinterpret_cast<intptr_t>(req));
+  }
+
+ private:
+  typedef std::map<intptr_t, CompletionCallback> CallbackMap;
+
+  void Complete(intptr_t id) {
+    CallbackMap::iterator it = callbacks_.find(id);
+    if (it == callbacks_.end())
+      return;
+    CompletionCallback callback = it->second;
+    callbacks_.erase(it);
+    callback.Run(OK);
+  }
+
+  intptr_t next_id_;
+  CallbackMap callbacks_;
+  base::WeakPtrFactory<SlowCertVerifier> weak_factory_;
+};
+
+// Connects to |test_server|, sends a request and waits for the first byte of
+// the response.
+void FetchFirstByte(TestServer* test_server,
+                    const SSLClientSocketContext& context) {
+  AddressList addr;
+  ASSERT_TRUE(test_server->GetAddressList(&addr));
+
+  TestCompletionCallback callback;
+  StreamSocket* transport = new TCPClientSocket(addr, NULL, NetLog::Source());
+  int rv = transport->Connect(callback.callback());
+  ASSERT_EQ(OK, callback.GetResult(rv));
+
+  scoped_ptr<SSLClientSocket> sock(
+      ClientSocketFactory::GetDefaultFactory()->CreateSSLClientSocket(
+          transport, test_server->host_port_pair(), SSLConfig(), NULL,
+          context));
+  rv = sock->Connect(callback.callback());
+  ASSERT_EQ(OK, callback.GetResult(rv));
+
+  const char request_text[] = "GET / HTTP/1.0\r\n\r\n";
+  scoped_refptr<IOBuffer> request_buffer(
+      new IOBuffer(arraysize(request_text) - 1));
+  memcpy(request_buffer->data(), request_text, arraysize(request_text) - 1);
+  rv = sock->Write(request_buffer, arraysize(request_text) - 1,
+                   callback.callback());
+  ASSERT_EQ(static_cast<int>(arraysize(request_text) - 1),
+            callback.GetResult(rv));
+
+  scoped_refptr<IOBuffer> buf(new IOBuffer(1));
+  rv = sock->Read(buf, 1, callback.callback());
+  ASSERT_EQ(1, callback.GetResult(rv));
+}
+
+}  // namespace
+
+// The verification of the certificate should overlap with the rest of the
+// handshake rather than delay the first byte by its whole duration.
+TEST(SSLClientSocketPerfTest, HandshakeToFirstByteWithSlowVerifier) {
+  TestServer test_server(TestServer::TYPE_HTTPS, TestServer::kLocalhost,
+                         FilePath());
+  ASSERT_TRUE(test_server.Start());
+
+  SlowCertVerifier cert_verifier;
+  SSLClientSocketContext context;
+  context.cert_verifier = &cert_verifier;
+
+  PerfTimeLogger timer("SSLClientSocket_HandshakeToFirstByte");
+  for (int i = 0; i < kIterations; ++i)
+    FetchFirstByte(&test_server, context);
+  timer.Done();
+}
+
+}  // namespace net
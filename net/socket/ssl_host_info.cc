@@ -5,9 +5,15 @@
 #include "net/socket/ssl_host_info.h"
 
 #include "base/bind.h"
+#include "base/lazy_instance.h"
 #include "base/metrics/histogram.h"
 #include "base/pickle.h"
+#include "base/rand_util.h"
 #include "base/string_piece.h"
+#include "crypto/encryptor.h"
+#include "crypto/hmac.h"
+#include "crypto/sha2.h"
+#include "crypto/symmetric_key.h"
 #include "net/base/crl_set.h"
 #include "net/base/ssl_config_service.h"
 #include "net/base/x509_certificate.h"
@@ -15,12 +21,88 @@
 
 namespace net {
 
+namespace {
+
+// Sessions are encrypted with AES-128-CBC and authenticated with HMAC-SHA256.
+const size_t kSessionKeySize = 16;
+const size_t kSessionIVSize = 16;
+const size_t kSessionMACSize = crypto::kSHA256Length;
+
+// We don't care to save the sessions over this size.
+const size_t kMaxSessionStateSize = 16 * 1024;
+
+// SessionStateKeys holds the keys that protect the sessions stored on disk.
+class SessionStateKeys {
+ public:
+  void Set(const std::string& secret) {
+    encryption_key_.reset();
+    mac_key_.clear();
+    if (secret.empty())
+      return;
+
+    encryption_key_.reset(crypto::SymmetricKey::Import(
+        crypto::SymmetricKey::AES,
+        crypto::SHA256HashString(secret + "encryption").substr(
+            0, kSessionKeySize)));
+    mac_key_ = crypto::SHA256HashString(secret + "authentication");
+  }
+
+  bool enabled() const { return encryption_key_.get() != NULL; }
+
+  bool Encrypt(const std::string& plaintext, std::string* output) const {
+    std::string iv = base::RandBytesAsString(kSessionIVSize);
+    crypto::Encryptor encryptor;
+    std::string ciphertext;
+    if (!encryptor.Init(encryption_key_.get(), crypto::Encryptor::CBC, iv) ||
+        !encryptor.Encrypt(plaintext, &ciphertext)) {
+      return false;
+    }
+
+    std::string data = iv + ciphertext;
+    crypto::HMAC hmac(crypto::HMAC::SHA256);
+    unsigned char mac[kSessionMACSize];
+    if (!hmac.Init(mac_key_) || !hmac.Sign(data, mac, sizeof(mac)))
+      return false;
+
+    output->swap(data);
+    output->append(reinterpret_cast<const char*>(mac), sizeof(mac));
+    return true;
+  }
+
+  bool Decrypt(const std::string& data, std::string* plaintext) const {
+    if (data.size() < kSessionIVSize + kSessionMACSize)
+      return false;
+
+    base::StringPiece signed_data(data.data(), data.size() - kSessionMACSize);
+    base::StringPiece mac(data.data() + signed_data.size(), kSessionMACSize);
+    crypto::HMAC hmac(crypto::HMAC::SHA256);
+    if (!hmac.Init(mac_key_) || !hmac.Verify(signed_data, mac))
+      return false;
+
+    crypto::Encryptor encryptor;
+    return encryptor.Init(encryption_key_.get(), crypto::Encryptor::CBC,
+                          signed_data.substr(0, kSessionIVSize)) &&
+           encryptor.Decrypt(signed_data.substr(kSessionIVSize), plaintext);
+  }
+
+ private:
+  scoped_ptr<crypto::SymmetricKey> encryption_key_;
+  std::string mac_key_;
+};
+
+base::LazyInstance<SessionStateKeys>::Leaky g_session_state_keys =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 SSLHostInfo::State::State() {}
 
 SSLHostInfo::State::~State() {}
 
 void SSLHostInfo::State::Clear() {
   certs.clear();
+  session_host_and_port.clear();
+  session_state.clear();
 }
 
 SSLHostInfo::SSLHostInfo(
@@ -99,6 +181,11 @@ bool SSLHostInfo::ParseInner(const std::string& data) {
     }
   }
 
+  // The encrypted session is missing from the data of older versions.
+  std::string encrypted_session;
+  if (p.ReadString(&iter, &encrypted_session) && !encrypted_session.empty())
+    ParseSessionState(encrypted_session);
+
   if (!state->certs.empty()) {
     std::vector<base::StringPiece> der_certs(state->certs.size());
     for (size_t i = 0; i < state->certs.size(); i++)
@@ -161,9 +248,62 @@ std::string SSLHostInfo::Serialize() const {
     return "";
   }
 
+  if (!p.WriteString(SerializeSessionState()))
+    return "";
+
   return std::string(reinterpret_cast<const char *>(p.data()), p.size());
 }
 
+// static
+void SSLHostInfo::EnableSessionPersistence(const std::string& secret) {
+  g_session_state_keys.Get().Set(secret);
+}
+
+// static
+bool SSLHostInfo::session_persistence_enabled() {
+  return g_session_state_keys.Get().enabled();
+}
+
+void SSLHostInfo::ParseSessionState(const std::string& data) {
+  const SessionStateKeys& keys = g_session_state_keys.Get();
+  std::string plaintext;
+  if (!keys.enabled() || !keys.Decrypt(data, &plaintext))
+    return;
+
+  Pickle p(plaintext.data(), plaintext.size());
+  PickleIterator iter(p);
+  std::string host_and_port;
+  std::string session_state;
+  if (!p.ReadString(&iter, &host_and_port) ||
+      !p.ReadString(&iter, &session_state)) {
+    return;
+  }
+  state_.session_host_and_port.swap(host_and_port);
+  state_.session_state.swap(session_state);
+}
+
+std::string SSLHostInfo::SerializeSessionState() const {
+  const SessionStateKeys& keys = g_session_state_keys.Get();
+  if (!keys.enabled() || state_.session_state.empty() ||
+      state_.session_state.size() > kMaxSessionStateSize) {
+    return "";
+  }
+
+  Pickle p(sizeof(Pickle::Header));
+  if (!p.WriteString(state_.session_host_and_port) ||
+      !p.WriteString(state_.session_state)) {
+    return "";
+  }
+
+  std::string data;
+  if (!keys.Encrypt(
+          std::string(reinterpret_cast<const char*>(p.data()), p.size()),
+          &data)) {
+    return "";
+  }
+  return data;
+}
+
 const CertVerifyResult& SSLHostInfo::cert_verify_result() const {
   return cert_verify_result_;
 }
@@ -25,9 +25,9 @@ class X509Certificate;
 struct SSLConfig;
 
 // SSLHostInfo is an interface for fetching information about an SSL server.
-// This information may be stored on disk so does not include keys or session
-// information etc. Primarily it's intended for caching the server's
-// certificates.
+// This information may be stored on disk so does not include keys, and only
+// includes session information encrypted. Primarily it's intended for caching
+// the server's certificates.
 class NET_EXPORT_PRIVATE SSLHostInfo {
  public:
   SSLHostInfo(const std::string& hostname,
@@ -69,6 +69,13 @@ class NET_EXPORT_PRIVATE SSLHostInfo {
     // returned them and in the same order.
     std::vector<std::string> certs;
 
+    // session_state is the TLS session of the last connection to
+    // |session_host_and_port|, as exported by the SSL library, so that it can
+    // be resumed after a restart. It is only stored while session persistence
+    // is enabled, encrypted.
+    std::string session_host_and_port;
+    std::string session_state;
+
    private:
     DISALLOW_COPY_AND_ASSIGN(State);
   };
@@ -97,6 +104,12 @@ class NET_EXPORT_PRIVATE SSLHostInfo {
     return verification_end_time_;
   }
 
+  // Enables storing the TLS sessions in |State|, encrypted with keys derived
+  // from |secret|, which the embedder must keep across restarts. An empty
+  // |secret| disables it. Must be called before any connection is made.
+  static void EnableSessionPersistence(const std::string& secret);
+  static bool session_persistence_enabled();
+
  protected:
   // Parse parses an opaque blob of data and fills out the public member fields
   // of this object. It returns true iff the parse was successful. The public
@@ -114,6 +127,10 @@ class NET_EXPORT_PRIVATE SSLHostInfo {
   // ParseInner is a helper function for Parse.
   bool ParseInner(const std::string& data);
 
+  // These decrypt and encrypt the session members of |state_|.
+  void ParseSessionState(const std::string& data);
+  std::string SerializeSessionState() const;
+
   // This is the hostname that we'll validate the certificates against.
   const std::string hostname_;
   bool cert_parsing_failed_;
@@ -31,33 +31,62 @@ const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
 namespace {
 
-bool AddressListStartsWithIPv6AndHasAnIPv4Addr(const AddressList& addrlist) {
-  const struct addrinfo* ai = addrlist.head();
-  if (ai->ai_family != AF_INET6)
-    return false;
-
-  ai = ai->ai_next;
-  while (ai) {
-    if (ai->ai_family != AF_INET6)
-      return true;
-    ai = ai->ai_next;
-  }
+// The number of hosts whose preferred address family is remembered.
+const size_t kMaxAddressFamilyHistorySize = 500;
+
+int g_fallback_delay_ms = TransportConnectJob::kIPv6FallbackTimerInMs;
 
-  return false;
+AddressFamily GetAddressFamily(const struct addrinfo* ai) {
+  switch (ai->ai_family) {
+    case AF_INET:
+      return ADDRESS_FAMILY_IPV4;
+    case AF_INET6:
+      return ADDRESS_FAMILY_IPV6;
+    default:
+      return ADDRESS_FAMILY_UNSPECIFIED;
+  }
 }
 
-bool AddressListOnlyContainsIPv6Addresses(const AddressList& addrlist) {
-  DCHECK(addrlist.head());
+// Returns the addresses of |addrlist| whose family is |family| if |matching|,
+// or the other ones otherwise, in order.
+AddressList FilterAddressList(const AddressList& addrlist,
+                              int family,
+                              bool matching) {
+  AddressList result;
   for (const struct addrinfo* ai = addrlist.head(); ai; ai = ai->ai_next) {
-    if (ai->ai_family != AF_INET6)
-      return false;
+    if ((ai->ai_family == family) != matching)
+      continue;
+    AddressList address = AddressList::CreateByCopyingFirstAddress(ai);
+    if (result.head())
+      result.Append(address.head());
+    else
+      result = address;
   }
-
-  return true;
+  return result;
 }
 
 }  // namespace
 
+AddressFamilyHistory::AddressFamilyHistory()
+    : families_(kMaxAddressFamilyHistorySize) {
+}
+
+AddressFamilyHistory::~AddressFamilyHistory() {}
+
+AddressFamily AddressFamilyHistory::GetPreferredFamily(
+    const HostPortPair& host) {
+  base::MRUCache<HostPortPair, AddressFamily>::iterator it =
+      families_.Peek(host);
+  if (it == families_.end())
+    return ADDRESS_FAMILY_UNSPECIFIED;
+  return it->second;
+}
+
+void AddressFamilyHistory::SetPreferredFamily(const HostPortPair& host,
+                                              AddressFamily family) {
+  families_.Put(host, family);
+}
+
 TransportSocketParams::TransportSocketParams(
     const HostPortPair& host_port_pair,
     RequestPriority priority,
@@ -93,6 +122,7 @@ TransportConnectJob::TransportConnectJob(
     base::TimeDelta timeout_duration,
     ClientSocketFactory* client_socket_factory,
     HostResolver* host_resolver,
+    AddressFamilyHistory* family_history,
     Delegate* delegate,
     NetLog* net_log)
     : ConnectJob(group_name, timeout_duration, delegate,
@@ -100,6 +130,7 @@ TransportConnectJob::TransportConnectJob(
       params_(params),
       client_socket_factory_(client_socket_factory),
       resolver_(host_resolver),
+      family_history_(family_history),
       next_state_(STATE_NONE) {
 }
 
@@ -154,6 +185,13 @@ void TransportConnectJob::MakeAddrListStartWithIPv4(AddressList* addrlist) {
   FreeCopyOfAddrinfo(head);
 }
 
+// static
+int TransportConnectJob::set_fallback_delay_ms(int delay_ms) {
+  int old_delay_ms = g_fallback_delay_ms;
+  g_fallback_delay_ms = delay_ms;
+  return old_delay_ms;
+}
+
 void TransportConnectJob::OnIOComplete(int result) {
   int rv = DoLoop(result);
   if (rv != ERR_IO_PENDING)
@@ -208,16 +246,33 @@ int TransportConnectJob::DoResolveHostComplete(int result) {
 
 int TransportConnectJob::DoTransportConnect() {
   next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
+
+  // Try the family of the first address, unless the other one won the last
+  // race to this host.
+  int family = addresses_.head()->ai_family;
+  if (family_history_) {
+    AddressFamily preferred_family = family_history_->GetPreferredFamily(
+        params_->destination().host_port_pair());
+    for (const struct addrinfo* ai = addresses_.head(); ai; ai = ai->ai_next) {
+      if (GetAddressFamily(ai) == preferred_family) {
+        family = ai->ai_family;
+        break;
+      }
+    }
+  }
+  fallback_addresses_ = FilterAddressList(addresses_, family, false);
+  if (fallback_addresses_.head())
+    addresses_ = FilterAddressList(addresses_, family, true);
+
   transport_socket_.reset(client_socket_factory_->CreateTransportClientSocket(
         addresses_, net_log().net_log(), net_log().source()));
   connect_start_time_ = base::TimeTicks::Now();
   int rv = transport_socket_->Connect(
       base::Bind(&TransportConnectJob::OnIOComplete, base::Unretained(this)));
-  if (rv == ERR_IO_PENDING &&
-      AddressListStartsWithIPv6AndHasAnIPv4Addr(addresses_)) {
+  if (rv == ERR_IO_PENDING && fallback_addresses_.head()) {
     fallback_timer_.Start(FROM_HERE,
-        base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
-        this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
+        base::TimeDelta::FromMilliseconds(g_fallback_delay_ms),
+        this, &TransportConnectJob::DoFallbackTransportConnect);
   }
   return rv;
 }
@@ -244,13 +299,15 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
         100);
 
     if (is_ipv4) {
-      UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_No_Race",
-                                 connect_duration,
-                                 base::TimeDelta::FromMilliseconds(1),
-                                 base::TimeDelta::FromMinutes(10),
-                                 100);
+      if (!fallback_addresses_.head()) {
+        UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_No_Race",
+                                   connect_duration,
+                                   base::TimeDelta::FromMilliseconds(1),
+                                   base::TimeDelta::FromMinutes(10),
+                                   100);
+      }
     } else {
-      if (AddressListOnlyContainsIPv6Addresses(addresses_)) {
+      if (!fallback_addresses_.head()) {
         UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Solo",
                                    connect_duration,
                                    base::TimeDelta::FromMilliseconds(1),
@@ -264,18 +321,37 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
                                    100);
       }
     }
+    RecordRaceWinner(GetAddressFamily(addresses_.head()));
     set_socket(transport_socket_.release());
     fallback_timer_.Stop();
-  } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
     fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
+    return result;
   }
 
-  return result;
+  transport_socket_.reset();
+  if (!fallback_addresses_.head())
+    return result;
+
+  // Keep waiting for the other family, starting it now if it is not racing
+  // yet.
+  next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
+  if (fallback_transport_socket_.get())
+    return ERR_IO_PENDING;
+
+  fallback_timer_.Stop();
+  int rv = StartFallbackTransportConnect();
+  if (rv == ERR_IO_PENDING)
+    return rv;
+
+  next_state_ = STATE_NONE;
+  if (rv == OK)
+    OnFallbackTransportConnected();
+  else
+    fallback_transport_socket_.reset();
+  return rv;
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnect() {
+void TransportConnectJob::DoFallbackTransportConnect() {
   // The timer should only fire while we're waiting for the main connect to
   // succeed.
   if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
@@ -283,24 +359,12 @@ void TransportConnectJob::DoIPv6FallbackTransportConnect() {
     return;
   }
 
-  DCHECK(!fallback_transport_socket_.get());
-  DCHECK(!fallback_addresses_.get());
-
-  fallback_addresses_.reset(new AddressList(addresses_));
-  MakeAddrListStartWithIPv4(fallback_addresses_.get());
-  fallback_transport_socket_.reset(
-      client_socket_factory_->CreateTransportClientSocket(
-          *fallback_addresses_, net_log().net_log(), net_log().source()));
-  fallback_connect_start_time_ = base::TimeTicks::Now();
-  int rv = fallback_transport_socket_->Connect(
-      base::Bind(
-          &TransportConnectJob::DoIPv6FallbackTransportConnectComplete,
-          base::Unretained(this)));
+  int rv = StartFallbackTransportConnect();
   if (rv != ERR_IO_PENDING)
-    DoIPv6FallbackTransportConnectComplete(rv);
+    DoFallbackTransportConnectComplete(rv);
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
+void TransportConnectJob::DoFallbackTransportConnectComplete(int result) {
   // This should only happen when we're waiting for the main connect to succeed.
   if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
     NOTREACHED();
@@ -309,41 +373,77 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
 
   DCHECK_NE(ERR_IO_PENDING, result);
   DCHECK(fallback_transport_socket_.get());
-  DCHECK(fallback_addresses_.get());
 
   if (result == OK) {
-    DCHECK(fallback_connect_start_time_ != base::TimeTicks());
-    DCHECK(start_time_ != base::TimeTicks());
-    base::TimeTicks now = base::TimeTicks::Now();
-    base::TimeDelta total_duration = now - start_time_;
-    UMA_HISTOGRAM_CUSTOM_TIMES(
-        "Net.DNS_Resolution_And_TCP_Connection_Latency2",
-        total_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
+    OnFallbackTransportConnected();
+    next_state_ = STATE_NONE;
+    transport_socket_.reset();
+  } else {
+    // Be a bit paranoid and kill off the fallback socket to prevent reuse.
+    fallback_transport_socket_.reset();
+    // The main connect may still win.
+    if (transport_socket_.get())
+      return;
+    next_state_ = STATE_NONE;
+  }
+  NotifyDelegateOfCompletion(result);  // Deletes |this|
+}
 
-    base::TimeDelta connect_duration = now - fallback_connect_start_time_;
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
+int TransportConnectJob::StartFallbackTransportConnect() {
+  DCHECK(!fallback_transport_socket_.get());
+  DCHECK(fallback_addresses_.head());
+
+  fallback_transport_socket_.reset(
+      client_socket_factory_->CreateTransportClientSocket(
+          fallback_addresses_, net_log().net_log(), net_log().source()));
+  fallback_connect_start_time_ = base::TimeTicks::Now();
+  return fallback_transport_socket_->Connect(
+      base::Bind(
+          &TransportConnectJob::DoFallbackTransportConnectComplete,
+          base::Unretained(this)));
+}
+
+void TransportConnectJob::OnFallbackTransportConnected() {
+  DCHECK(fallback_connect_start_time_ != base::TimeTicks());
+  DCHECK(start_time_ != base::TimeTicks());
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta total_duration = now - start_time_;
+  UMA_HISTOGRAM_CUSTOM_TIMES(
+      "Net.DNS_Resolution_And_TCP_Connection_Latency2",
+      total_duration,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromMinutes(10),
+      100);
+
+  base::TimeDelta connect_duration = now - fallback_connect_start_time_;
+  UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
+      connect_duration,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromMinutes(10),
+      100);
+
+  if (fallback_addresses_.head()->ai_family != AF_INET6) {
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
         connect_duration,
         base::TimeDelta::FromMilliseconds(1),
         base::TimeDelta::FromMinutes(10),
         100);
-
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
+  } else {
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Wins_Race",
         connect_duration,
         base::TimeDelta::FromMilliseconds(1),
         base::TimeDelta::FromMinutes(10),
         100);
-    set_socket(fallback_transport_socket_.release());
-    next_state_ = STATE_NONE;
-    transport_socket_.reset();
-  } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
   }
-  NotifyDelegateOfCompletion(result);  // Deletes |this|
+  RecordRaceWinner(GetAddressFamily(fallback_addresses_.head()));
+  set_socket(fallback_transport_socket_.release());
+}
+
+void TransportConnectJob::RecordRaceWinner(AddressFamily family) {
+  if (!family_history_ || !fallback_addresses_.head())
+    return;
+  family_history_->SetPreferredFamily(params_->destination().host_port_pair(),
+                                      family);
 }
 
 int TransportConnectJob::ConnectInternal() {
@@ -362,6 +462,7 @@ ConnectJob*
                                  ConnectionTimeout(),
                                  client_socket_factory_,
                                  host_resolver_,
+                                 &family_history_,
                                  delegate,
                                  net_log_);
 }
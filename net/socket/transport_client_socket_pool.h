@@ -10,9 +10,11 @@
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time.h"
 #include "base/timer.h"
+#include "net/base/address_family.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/host_resolver.h"
 #include "net/base/single_request_host_resolver.h"
@@ -47,21 +49,44 @@ class NET_EXPORT_PRIVATE TransportSocketParams
   DISALLOW_COPY_AND_ASSIGN(TransportSocketParams);
 };
 
+// Remembers the address family that won the last connect race to each host, so
+// that the next TransportConnectJob to that host starts with it.
+class NET_EXPORT_PRIVATE AddressFamilyHistory {
+ public:
+  AddressFamilyHistory();
+  ~AddressFamilyHistory();
+
+  // Returns the family that won the last race to |host|, or
+  // ADDRESS_FAMILY_UNSPECIFIED if there was none.
+  AddressFamily GetPreferredFamily(const HostPortPair& host);
+
+  void SetPreferredFamily(const HostPortPair& host, AddressFamily family);
+
+ private:
+  base::MRUCache<HostPortPair, AddressFamily> families_;
+
+  DISALLOW_COPY_AND_ASSIGN(AddressFamilyHistory);
+};
+
 // TransportConnectJob handles the host resolution necessary for socket creation
-// and the transport (likely TCP) connect. TransportConnectJob also has fallback
-// logic for IPv6 connect() timeouts (which may happen due to networks / routers
-// with broken IPv6 support). Those timeouts take 20s, so rather than make the
-// user wait 20s for the timeout to fire, we use a fallback timer
-// (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
-// fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
-// a headstart) and return the one that completes first to the socket pool.
+// and the transport (likely TCP) connect. TransportConnectJob also races the
+// address families of dual-stack hosts, since connect() timeouts to one of them
+// (which may happen due to networks / routers with broken IPv6 support) take
+// 20s. The addresses of the preferred family (the one of the first address, or
+// the one that won the last race to the host) are tried first; if that connect
+// has not finished after a fallback delay (kIPv6FallbackTimerInMs by default),
+// or fails, a connect() to the addresses of the other family is started. The
+// two connects race and the one that completes first is returned to the socket
+// pool, and its family is recorded in the AddressFamilyHistory.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
+  // |family_history| may be NULL.
   TransportConnectJob(const std::string& group_name,
                       const scoped_refptr<TransportSocketParams>& params,
                       base::TimeDelta timeout_duration,
                       ClientSocketFactory* client_socket_factory,
                       HostResolver* host_resolver,
+                      AddressFamilyHistory* family_history,
                       Delegate* delegate,
                       NetLog* net_log);
   virtual ~TransportConnectJob();
@@ -76,6 +101,10 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // hack.  It is a public method for the unit tests.
   static void MakeAddrListStartWithIPv4(AddressList* addrlist);
 
+  // Sets the delay before the connect to the other address family starts, and
+  // returns the previous value.
+  static int set_fallback_delay_ms(int delay_ms);
+
   static const int kIPv6FallbackTimerInMs;
 
  private:
@@ -98,8 +127,17 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   int DoTransportConnectComplete(int result);
 
   // Not part of the state machine.
-  void DoIPv6FallbackTransportConnect();
-  void DoIPv6FallbackTransportConnectComplete(int result);
+  void DoFallbackTransportConnect();
+  void DoFallbackTransportConnectComplete(int result);
+
+  // Starts the connect to |fallback_addresses_|.
+  int StartFallbackTransportConnect();
+
+  // Hands the winner of a race over to the pool and records its family.
+  void OnFallbackTransportConnected();
+
+  // Records a race won by |family| in |family_history_|.
+  void RecordRaceWinner(AddressFamily family);
 
   // Begins the host resolution and the TCP connect.  Returns OK on success
   // and ERR_IO_PENDING if it cannot immediately service the request.
@@ -109,6 +147,7 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   scoped_refptr<TransportSocketParams> params_;
   ClientSocketFactory* const client_socket_factory_;
   SingleRequestHostResolver resolver_;
+  AddressFamilyHistory* const family_history_;
   AddressList addresses_;
   State next_state_;
 
@@ -120,8 +159,10 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
 
   scoped_ptr<StreamSocket> transport_socket_;
 
+  // The addresses of the family that is not tried first. Empty if the host
+  // only has addresses of one family.
+  AddressList fallback_addresses_;
   scoped_ptr<StreamSocket> fallback_transport_socket_;
-  scoped_ptr<AddressList> fallback_addresses_;
   base::TimeTicks fallback_connect_start_time_;
   base::OneShotTimer<TransportConnectJob> fallback_timer_;
 
@@ -202,6 +243,8 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
     ClientSocketFactory* const client_socket_factory_;
     HostResolver* const host_resolver_;
     NetLog* net_log_;
+    // Shared by the jobs, which need to update it from NewConnectJob().
+    mutable AddressFamilyHistory family_history_;
 
     DISALLOW_COPY_AND_ASSIGN(TransportConnectJobFactory);
   };
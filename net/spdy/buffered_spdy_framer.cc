@@ -263,7 +263,8 @@ void BufferedSpdyFramer::set_enable_compression_default(bool value) {
 }
 
 void BufferedSpdyFramer::InitHeaderStreaming(const SpdyControlFrame* frame) {
-  memset(header_buffer_, 0, kHeaderBufferSize);
+  // Only the first |header_buffer_used_| bytes of the buffer are ever read, so
+  // there is no need to clear it for every frame.
   header_buffer_used_ = 0;
   header_buffer_valid_ = true;
   header_stream_id_ = SpdyFramer::GetControlFrameStreamId(frame);
@@ -51,6 +51,27 @@ struct DictionaryIds {
 // initialized lazily to avoid static initializers.
 base::LazyInstance<DictionaryIds>::Leaky g_dictionary_ids;
 
+// Stores the headers of a block in a SpdyHeaderBlock, rejecting duplicates.
+class HeaderBlockBuilder : public SpdyHeaderBlockVisitorInterface {
+ public:
+  explicit HeaderBlockBuilder(SpdyHeaderBlock* block) : block_(block) {}
+
+  virtual bool OnHeader(const base::StringPiece& name,
+                        const base::StringPiece& value) OVERRIDE {
+    std::string name_string = name.as_string();
+    SpdyHeaderBlock::iterator it = block_->lower_bound(name_string);
+    if (it != block_->end() && it->first == name_string)
+      return false;
+    block_->insert(it, std::make_pair(name_string, value.as_string()));
+    return true;
+  }
+
+ private:
+  SpdyHeaderBlock* block_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderBlockBuilder);
+};
+
 }  // namespace
 
 const int SpdyFramer::kMinSpdyVersion = 2;
@@ -914,6 +935,14 @@ size_t SpdyFramer::ProcessDataFramePayload(const char* data, size_t len) {
 bool SpdyFramer::ParseHeaderBlockInBuffer(const char* header_data,
                                           size_t header_length,
                                           SpdyHeaderBlock* block) {
+  HeaderBlockBuilder builder(block);
+  return ParseHeaderBlockInBuffer(header_data, header_length, &builder);
+}
+
+bool SpdyFramer::ParseHeaderBlockInBuffer(
+    const char* header_data,
+    size_t header_length,
+    SpdyHeaderBlockVisitorInterface* visitor) {
   SpdyFrameReader reader(header_data, header_length);
 
   // Read number of headers.
@@ -934,35 +963,30 @@ bool SpdyFramer::ParseHeaderBlockInBuffer(const char* header_data,
 
   // Read each header.
   for (uint32 index = 0; index < num_headers; ++index) {
-    base::StringPiece temp;
+    base::StringPiece name;
+    base::StringPiece value;
 
     // Read header name.
-    if ((spdy_version_ < 3) ? !reader.ReadStringPiece16(&temp)
-                            : !reader.ReadStringPiece32(&temp)) {
+    if ((spdy_version_ < 3) ? !reader.ReadStringPiece16(&name)
+                            : !reader.ReadStringPiece32(&name)) {
       DLOG(INFO) << "Unable to read header name (" << index + 1 << " of "
                  << num_headers << ").";
       return false;
     }
-    std::string name = temp.as_string();
 
     // Read header value.
-    if ((spdy_version_ < 3) ? !reader.ReadStringPiece16(&temp)
-                            : !reader.ReadStringPiece32(&temp)) {
+    if ((spdy_version_ < 3) ? !reader.ReadStringPiece16(&value)
+                            : !reader.ReadStringPiece32(&value)) {
       DLOG(INFO) << "Unable to read header value (" << index + 1 << " of "
                  << num_headers << ").";
       return false;
     }
-    std::string value = temp.as_string();
 
-    // Ensure no duplicates.
-    if (block->find(name) != block->end()) {
-      DLOG(INFO) << "Duplicate header '" << name << "' (" << index + 1 << " of "
-                 << num_headers << ").";
+    if (!visitor->OnHeader(name, value)) {
+      DLOG(INFO) << "Rejected header '" << name << "' (" << index + 1
+                 << " of " << num_headers << ").";
       return false;
     }
-
-    // Store header.
-    (*block)[name] = value;
   }
   return true;
 }
@@ -15,6 +15,7 @@
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/string_piece.h"
 #include "base/sys_byteorder.h"
 #include "net/base/net_export.h"
 #include "net/spdy/spdy_protocol.h"
@@ -128,6 +129,20 @@ struct NET_EXPORT_PRIVATE SpdySettingsScratch {
 // decompressor to lose synchronization with the sender's header compressor,
 // making the SPDY session unusable for future work. The visitor's OnError
 // function should deal with this condition by closing the SPDY connection.
+// SpdyHeaderBlockVisitorInterface receives the name/value pairs of a header
+// block as SpdyFramer::ParseHeaderBlockInBuffer() parses them, without
+// building a SpdyHeaderBlock. The pieces point into the buffer being parsed,
+// so they are only valid for the duration of the call.
+class NET_EXPORT_PRIVATE SpdyHeaderBlockVisitorInterface {
+ public:
+  virtual ~SpdyHeaderBlockVisitorInterface() {}
+
+  // Called for each header, in the order they appear in the block. Returning
+  // false stops the parsing, which then fails.
+  virtual bool OnHeader(const base::StringPiece& name,
+                        const base::StringPiece& value) = 0;
+};
+
 class NET_EXPORT_PRIVATE SpdyFramerVisitorInterface {
  public:
   virtual ~SpdyFramerVisitorInterface() {}
@@ -273,6 +288,12 @@ class NET_EXPORT_PRIVATE SpdyFramer {
                                 size_t header_length,
                                 SpdyHeaderBlock* block);
 
+  // Same as above, but hands every name/value pair to |visitor| instead of
+  // storing it. Duplicate names are not detected here.
+  bool ParseHeaderBlockInBuffer(const char* header_data,
+                                size_t header_length,
+                                SpdyHeaderBlockVisitorInterface* visitor);
+
   // Create a SpdySynStreamControlFrame.
   // |stream_id| is the id for this stream.
   // |associated_stream_id| is the associated stream id for this stream.
@@ -0,0 +1,115 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "net/spdy/buffered_spdy_framer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A page with many resources, served over a single session.
+const int kNumStreams = 500;
+const int kIterations = 20;
+
+// Counts the header blocks delivered by the framer.
+class CountingVisitor : public BufferedSpdyFramerVisitorInterface {
+ public:
+  CountingVisitor() : error_count_(0), header_count_(0) {}
+
+  virtual void OnError(SpdyFramer::SpdyError error_code) OVERRIDE {
+    error_count_++;
+  }
+  virtual void OnStreamError(SpdyStreamId stream_id,
+                             const std::string& description) OVERRIDE {
+    error_count_++;
+  }
+  virtual void OnSynStream(const SpdySynStreamControlFrame& frame,
+                           const linked_ptr<SpdyHeaderBlock>& headers) OVERRIDE {
+    header_count_ += headers->size();
+  }
+  virtual void OnSynReply(const SpdySynReplyControlFrame& frame,
+                          const linked_ptr<SpdyHeaderBlock>& headers) OVERRIDE {
+    header_count_ += headers->size();
+  }
+  virtual void OnHeaders(const SpdyHeadersControlFrame& frame,
+                         const linked_ptr<SpdyHeaderBlock>& headers) OVERRIDE {
+    header_count_ += headers->size();
+  }
+  virtual void OnRstStream(const SpdyRstStreamControlFrame& frame) OVERRIDE {}
+  virtual void OnGoAway(const SpdyGoAwayControlFrame& frame) OVERRIDE {}
+  virtual void OnPing(const SpdyPingControlFrame& frame) OVERRIDE {}
+  virtual void OnWindowUpdate(
+      const SpdyWindowUpdateControlFrame& frame) OVERRIDE {}
+  virtual void OnStreamFrameData(SpdyStreamId stream_id,
+                                 const char* data,
+                                 size_t len) OVERRIDE {}
+  virtual void OnSetting(SpdySettingsIds id, uint8 flags,
+                         uint32 value) OVERRIDE {}
+
+  int error_count_;
+  size_t header_count_;
+};
+
+// Returns the SYN_REPLY frames of |kNumStreams| responses, compressed with a
+// single header compressor as a server would send them.
+std::string BuildSynReplies(int version) {
+  SpdyFramer framer(version);
+  std::string input;
+  for (int i = 0; i < kNumStreams; ++i) {
+    SpdyHeaderBlock headers;
+    headers[version < 3 ? "status" : ":status"] = "200";
+    headers[version < 3 ? "version" : ":version"] = "HTTP/1.1";
+    headers["cache-control"] = "private, max-age=0";
+    headers["content-type"] = "image/png";
+    headers["content-length"] = base::StringPrintf("%d", 1000 + i);
+    headers["date"] = "Mon, 14 May 2012 18:34:56 GMT";
+    headers["expires"] = "-1";
+    headers["server"] = "gws";
+    headers["x-xss-protection"] = "1; mode=block";
+    scoped_ptr<SpdySynReplyControlFrame> frame(
+        framer.CreateSynReply(2 * i + 1, CONTROL_FLAG_NONE, true, &headers));
+    input.append(frame->data(), frame->length() + SpdyFrame::kHeaderSize);
+  }
+  return input;
+}
+
+void RunSynReplies(const char* name, int version) {
+  std::string input = BuildSynReplies(version);
+  CountingVisitor visitor;
+
+  PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; ++i) {
+    BufferedSpdyFramer framer(version);
+    framer.set_visitor(&visitor);
+    const char* data = input.data();
+    size_t remaining = input.size();
+    while (remaining && !framer.HasError()) {
+      size_t processed = framer.ProcessInput(data, remaining);
+      data += processed;
+      remaining -= processed;
+    }
+  }
+  timer.Done();
+
+  EXPECT_EQ(0, visitor.error_count_);
+  EXPECT_EQ(9u * kNumStreams * kIterations, visitor.header_count_);
+}
+
+}  // namespace
+
+TEST(SpdyFramerPerfTest, SynRepliesSpdy2) {
+  RunSynReplies("SpdyFramer_SynReplies_Spdy2", 2);
+}
+
+TEST(SpdyFramerPerfTest, SynRepliesSpdy3) {
+  RunSynReplies("SpdyFramer_SynReplies_Spdy3", 3);
+}
+
+}  // namespace net
@@ -41,6 +41,12 @@ class MockVisitor : public SpdyFramerVisitorInterface {
   MOCK_METHOD3(OnSetting, void(SpdySettingsIds id, uint8 flags, uint32 value));
 };
 
+class MockHeaderBlockVisitor : public SpdyHeaderBlockVisitorInterface {
+ public:
+  MOCK_METHOD2(OnHeader, bool(const base::StringPiece& name,
+                              const base::StringPiece& value));
+};
+
 class SpdyFramerTestUtil {
  public:
   // Decompress a single frame using the decompression context held by
@@ -452,6 +458,7 @@ class TestSpdyVisitor : public SpdyFramerVisitorInterface  {
 }  // namespace net
 
 using test::CompareCharArraysWithHexError;
+using test::MockHeaderBlockVisitor;
 using test::SpdyFramerTestUtil;
 using test::TestSpdyVisitor;
 
@@ -606,6 +613,47 @@ TEST_P(SpdyFramerTest, UndersizedHeaderBlockInBuffer) {
                                                &new_headers));
 }
 
+// Test that a header block can be parsed without building a SpdyHeaderBlock.
+TEST_P(SpdyFramerTest, HeaderBlockInBufferToVisitor) {
+  SpdyHeaderBlock headers;
+  headers["alpha"] = "beta";
+  headers["gamma"] = "charlie";
+  SpdyFramer framer(spdy_version_);
+
+  scoped_ptr<SpdySynStreamControlFrame> frame(
+      framer.CreateSynStream(1,  // stream id
+                             0,  // associated stream id
+                             1,  // priority
+                             0,  // credential slot
+                             CONTROL_FLAG_NONE,
+                             false,  // compress
+                             &headers));
+  EXPECT_TRUE(frame.get() != NULL);
+  string serialized_headers(frame->header_block(), frame->header_block_len());
+
+  MockHeaderBlockVisitor visitor;
+  {
+    testing::InSequence s;
+    EXPECT_CALL(visitor, OnHeader(base::StringPiece("alpha"),
+                                  base::StringPiece("beta")))
+        .WillOnce(testing::Return(true));
+    EXPECT_CALL(visitor, OnHeader(base::StringPiece("gamma"),
+                                  base::StringPiece("charlie")))
+        .WillOnce(testing::Return(true));
+  }
+  EXPECT_TRUE(framer.ParseHeaderBlockInBuffer(serialized_headers.c_str(),
+                                              serialized_headers.size(),
+                                              &visitor));
+
+  // The visitor can stop the parsing.
+  MockHeaderBlockVisitor rejecting_visitor;
+  EXPECT_CALL(rejecting_visitor, OnHeader(_, _))
+      .WillOnce(testing::Return(false));
+  EXPECT_FALSE(framer.ParseHeaderBlockInBuffer(serialized_headers.c_str(),
+                                               serialized_headers.size(),
+                                               &rejecting_visitor));
+}
+
 TEST_P(SpdyFramerTest, OutOfOrderHeaders) {
   // Frame builder with plentiful buffer size.
   SpdyFrameBuilder frame(SYN_STREAM, CONTROL_FLAG_NONE, 1, 1024);
@@ -319,9 +319,10 @@ int SpdyHttpStream::OnSendBodyComplete(int status, bool* eof) {
   // Read the data from the request body stream.
   const int bytes_read = request_body_stream_->Read(
       raw_request_body_buf_, raw_request_body_buf_->size());
-  if (request_body_stream_->is_chunked() && bytes_read == ERR_IO_PENDING)
+  // More chunks are to come, or file data is still being read.
+  if (bytes_read == ERR_IO_PENDING)
     return ERR_IO_PENDING;
-  // ERR_IO_PENDING with chunked encoding is the only possible error.
+  // ERR_IO_PENDING is the only possible error.
   DCHECK_GE(bytes_read, 0);
 
   request_body_buf_ = new DrainableIOBuffer(raw_request_body_buf_,
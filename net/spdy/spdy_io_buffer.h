@@ -34,6 +34,7 @@ class NET_EXPORT_PRIVATE SpdyIOBuffer {
   size_t size() const { return buffer_->size(); }
   void release();
   RequestPriority priority() const { return priority_; }
+  void set_priority(RequestPriority priority) { priority_ = priority; }
   const scoped_refptr<SpdyStream>& stream() const { return stream_; }
 
   // Comparison operator to support sorting.
@@ -302,6 +302,7 @@ NextProto g_default_protocol = kProtoUnknown;
 size_t g_init_max_concurrent_streams = 10;
 size_t g_max_concurrent_stream_limit = 256;
 bool g_enable_ping_based_connection_checking = true;
+bool g_enable_window_autotuning = false;
 
 }  // namespace
 
@@ -320,6 +321,11 @@ void SpdySession::set_enable_ping_based_connection_checking(bool enable) {
   g_enable_ping_based_connection_checking = enable;
 }
 
+// static
+void SpdySession::set_enable_window_autotuning(bool enable) {
+  g_enable_window_autotuning = enable;
+}
+
 // static
 void SpdySession::set_init_max_concurrent_streams(size_t value) {
   g_init_max_concurrent_streams =
@@ -333,6 +339,7 @@ void SpdySession::ResetStaticSettingsToInit() {
   g_init_max_concurrent_streams = 10;
   g_max_concurrent_stream_limit = 256;
   g_enable_ping_based_connection_checking = true;
+  g_enable_window_autotuning = false;
 }
 
 SpdySession::SpdySession(const HostPortProxyPair& host_port_proxy_pair,
@@ -813,6 +820,14 @@ int SpdySession::WriteStreamData(SpdyStreamId stream_id,
   return ERR_IO_PENDING;
 }
 
+void SpdySession::SetStreamPriority(SpdyStream* stream,
+                                    RequestPriority priority) {
+  if (stream->priority() == priority)
+    return;
+  stream->set_priority(priority);
+  write_queue_.ChangePriority(stream, priority);
+}
+
 void SpdySession::CloseStream(SpdyStreamId stream_id, int status) {
   // TODO(mbelshe): We should send a RST_STREAM control frame here
   //                so that the server can cancel a large send.
@@ -1025,11 +1040,11 @@ void SpdySession::WriteSocket() {
   // Loop sending frames until we've sent everything or until the write
   // returns error (or ERR_IO_PENDING).
   DCHECK(buffered_spdy_framer_.get());
-  while (in_flight_write_.buffer() || !queue_.empty()) {
+  while (in_flight_write_.buffer() || !write_queue_.IsEmpty()) {
     if (!in_flight_write_.buffer()) {
       // Grab the next SpdyFrame to send.
-      SpdyIOBuffer next_buffer = queue_.top();
-      queue_.pop();
+      SpdyIOBuffer next_buffer;
+      write_queue_.Dequeue(&next_buffer);
 
       // We've deferred compression until just before we write it to the socket,
       // which is now.  At this time, we don't compress our data frames.
@@ -1117,8 +1132,7 @@ void SpdySession::CloseAllStreams(net::Error status) {
   }
 
   // We also need to drain the queue.
-  while (queue_.size())
-    queue_.pop();
+  write_queue_.Clear();
 }
 
 int SpdySession::GetNewStreamId() {
@@ -1135,7 +1149,7 @@ void SpdySession::QueueFrame(SpdyFrame* frame,
   int length = SpdyFrame::kHeaderSize + frame->length();
   IOBuffer* buffer = new IOBuffer(length);
   memcpy(buffer->data(), frame->data(), length);
-  queue_.push(SpdyIOBuffer(buffer, length, priority, stream));
+  write_queue_.Enqueue(SpdyIOBuffer(buffer, length, priority, stream));
 
   WriteSocketLater();
 }
@@ -1634,7 +1648,8 @@ void SpdySession::OnPing(const SpdyPingControlFrame& frame) {
 
   // We will record RTT in histogram when there are no more client sent
   // pings_in_flight_.
-  RecordPingRTTHistogram(base::TimeTicks::Now() - last_ping_sent_time_);
+  last_ping_rtt_ = base::TimeTicks::Now() - last_ping_sent_time_;
+  RecordPingRTTHistogram(last_ping_rtt_);
 
   if (!need_to_send_ping_)
     return;
@@ -1672,6 +1687,10 @@ void SpdySession::OnWindowUpdate(
     stream->IncreaseSendWindowSize(delta_window_size);
 }
 
+bool SpdySession::IsWindowAutotuningEnabled() const {
+  return flow_control_ && g_enable_window_autotuning;
+}
+
 void SpdySession::SendWindowUpdate(SpdyStreamId stream_id,
                                    int32 delta_window_size) {
   CHECK(IsStreamActive(stream_id));
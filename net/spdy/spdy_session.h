@@ -31,6 +31,7 @@
 #include "net/spdy/spdy_io_buffer.h"
 #include "net/spdy/spdy_protocol.h"
 #include "net/spdy/spdy_session_pool.h"
+#include "net/spdy/spdy_write_queue.h"
 
 namespace base {
 class Value;
@@ -180,6 +181,11 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
                       int len,
                       SpdyDataFlags flags);
 
+  // Changes the priority of |stream|, including the frames that it has queued
+  // and not sent yet. The server is not told about it, as SPDY has no frame
+  // for that.
+  void SetStreamPriority(SpdyStream* stream, RequestPriority priority);
+
   // Close a stream.
   void CloseStream(SpdyStreamId stream_id, int status);
 
@@ -228,6 +234,10 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   // Enable sending of PING frame with each request.
   static void set_enable_ping_based_connection_checking(bool enable);
 
+  // Enable growing the receive windows of the streams toward the
+  // bandwidth-delay product of the session.
+  static void set_enable_window_autotuning(bool enable);
+
   // The initial max concurrent streams per session, can be overridden by the
   // server via SETTINGS.
   static void set_init_max_concurrent_streams(size_t value);
@@ -298,6 +308,13 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
     initial_recv_window_size_ = window_size;
   }
 
+  // Returns true if the streams should grow their receive windows.
+  bool IsWindowAutotuningEnabled() const;
+
+  // Returns the round trip time measured by the last PING, or zero if none
+  // completed yet.
+  base::TimeDelta last_ping_rtt() const { return last_ping_rtt_; }
+
   const BoundNetLog& net_log() const { return net_log_; }
 
   int GetPeerAddress(AddressList* address) const;
@@ -354,7 +371,6 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   typedef std::map<int, scoped_refptr<SpdyStream> > ActiveStreamMap;
   // Only HTTP push a stream.
   typedef std::map<std::string, scoped_refptr<SpdyStream> > PushedStreamMap;
-  typedef std::priority_queue<SpdyIOBuffer> OutputQueue;
 
   struct CallbackResultPair {
     CallbackResultPair(const CompletionCallback& callback_in, int result_in)
@@ -573,8 +589,8 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   // server, but do not have consumers yet.
   PushedStreamMap unclaimed_pushed_streams_;
 
-  // As we gather data to be sent, we put it into the output queue.
-  OutputQueue queue_;
+  // As we gather data to be sent, we put it into the write queue.
+  SpdyWriteQueue write_queue_;
 
   // The packet we are currently sending.
   bool write_pending_;            // Will be true when a write is in progress.
@@ -621,6 +637,9 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   // This is the last time we have sent a PING.
   base::TimeTicks last_ping_sent_time_;
 
+  // The round trip time of the last PING.
+  base::TimeDelta last_ping_rtt_;
+
   // This is the last time we have received data.
   base::TimeTicks received_data_time_;
 
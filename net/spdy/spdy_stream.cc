@@ -4,6 +4,8 @@
 
 #include "net/spdy/spdy_stream.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/message_loop.h"
@@ -60,6 +62,10 @@ class NetLogSpdyStreamWindowUpdateParameter : public NetLog::EventParameters {
   DISALLOW_COPY_AND_ASSIGN(NetLogSpdyStreamWindowUpdateParameter);
 };
 
+// The receive window never grows beyond this, to bound the memory that a
+// stream's data can use on a slow consumer.
+const int32 kMaxAutotunedRecvWindowSize = 16 * 1024 * 1024;
+
 bool ContainsUpperAscii(const std::string& str) {
   for (std::string::const_iterator i(str.begin()); i != str.end(); ++i) {
     if (*i >= 'A' && *i <= 'Z') {
@@ -83,6 +89,8 @@ SpdyStream::SpdyStream(SpdySession* session,
       send_window_size_(kSpdyStreamInitialWindowSize),
       recv_window_size_(kSpdyStreamInitialWindowSize),
       unacked_recv_window_bytes_(0),
+      recv_window_growth_(0),
+      autotune_bytes_read_(0),
       pushed_(pushed),
       response_received_(false),
       session_(session),
@@ -256,7 +264,15 @@ void SpdyStream::IncreaseRecvWindowSize(int32 delta_window_size) {
           stream_id_, delta_window_size, recv_window_size_)));
 
   unacked_recv_window_bytes_ += delta_window_size;
-  if (unacked_recv_window_bytes_ > session_->initial_recv_window_size() / 2) {
+  if (session_->IsWindowAutotuningEnabled()) {
+    int32 growth = AutotuneRecvWindow(delta_window_size);
+    recv_window_size_ += growth;
+    unacked_recv_window_bytes_ += growth;
+  }
+
+  int32 window_size = session_->initial_recv_window_size() +
+      recv_window_growth_;
+  if (unacked_recv_window_bytes_ > window_size / 2) {
     session_->SendWindowUpdate(stream_id_, unacked_recv_window_bytes_);
     unacked_recv_window_bytes_ = 0;
   }
@@ -757,6 +773,49 @@ int SpdyStream::DoOpen(int result) {
   return result;
 }
 
+int32 SpdyStream::AutotuneRecvWindow(int32 bytes_read) {
+  base::TimeDelta rtt = session_->last_ping_rtt();
+  if (rtt <= base::TimeDelta())
+    return 0;  // We need a round trip time first.
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (autotune_start_time_.is_null()) {
+    autotune_start_time_ = now;
+    autotune_bytes_read_ = 0;
+    return 0;
+  }
+  autotune_bytes_read_ += bytes_read;
+  base::TimeDelta elapsed = now - autotune_start_time_;
+  if (elapsed < rtt)
+    return 0;
+
+  // The data consumed per round trip is what the current window lets the peer
+  // send, up to the bandwidth-delay product of the session.
+  int64 bdp = autotune_bytes_read_ * rtt.InMicroseconds() /
+      elapsed.InMicroseconds();
+  autotune_start_time_ = now;
+  autotune_bytes_read_ = 0;
+
+  // Like TCP receive buffer auto-tuning, keep the window at twice what one
+  // round trip brings, so that the window does not limit the throughput, and
+  // at most double it each time.
+  int64 window_size = session_->initial_recv_window_size() +
+      recv_window_growth_;
+  int64 new_window_size = std::min(2 * bdp, 2 * window_size);
+  new_window_size = std::min<int64>(new_window_size,
+                                    kMaxAutotunedRecvWindowSize);
+  if (new_window_size <= window_size)
+    return 0;
+
+  int32 growth = static_cast<int32>(new_window_size - window_size);
+  recv_window_growth_ += growth;
+  net_log_.AddEvent(
+      NetLog::TYPE_SPDY_STREAM_UPDATE_RECV_WINDOW,
+      make_scoped_refptr(new NetLogSpdyStreamWindowUpdateParameter(
+          stream_id_, growth, recv_window_size_ + growth)));
+  return growth;
+}
+
 void SpdyStream::UpdateHistograms() {
   // We need all timers to be filled in, otherwise metrics can be bogus.
   if (send_time_.is_null() || recv_first_byte_time_.is_null() ||
@@ -772,6 +831,14 @@ void SpdyStream::UpdateHistograms() {
 
   UMA_HISTOGRAM_COUNTS("Net.SpdySendBytes", send_bytes_);
   UMA_HISTOGRAM_COUNTS("Net.SpdyRecvBytes", recv_bytes_);
+
+  if (session_->IsWindowAutotuningEnabled()) {
+    // The final receive window, in KB.
+    UMA_HISTOGRAM_CUSTOM_COUNTS(
+        "Net.SpdyStreamRecvWindowSize",
+        (session_->initial_recv_window_size() + recv_window_growth_) / 1024,
+        1, kMaxAutotunedRecvWindowSize / 1024, 50);
+  }
 }
 
 }  // namespace net
@@ -301,6 +301,11 @@ class NET_EXPORT_PRIVATE SpdyStream
   int DoReadHeadersComplete(int result);
   int DoOpen(int result);
 
+  // Grows the receive window if the peer sent close to a window worth of data
+  // in the last round trip, given that |bytes_read| more bytes were consumed.
+  // Returns the number of bytes the window grew by.
+  int32 AutotuneRecvWindow(int32 bytes_read);
+
   // Update the histograms.  Can safely be called repeatedly, but should only
   // be called after the stream has completed.
   void UpdateHistograms();
@@ -325,6 +330,12 @@ class NET_EXPORT_PRIVATE SpdyStream
   int32 recv_window_size_;
   int32 unacked_recv_window_bytes_;
 
+  // Receive window auto-tuning: how much the window grew beyond the initial
+  // size of the session, and the data consumed since |autotune_start_time_|.
+  int32 recv_window_growth_;
+  base::TimeTicks autotune_start_time_;
+  int64 autotune_bytes_read_;
+
   const bool pushed_;
   ScopedBandwidthMetrics metrics_;
   bool response_received_;
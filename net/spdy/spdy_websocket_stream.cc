@@ -74,7 +74,15 @@ int SpdyWebSocketStream::SendData(const char* data, int length) {
   }
   scoped_refptr<IOBuffer> buf(new IOBuffer(length));
   memcpy(buf->data(), data, length);
-  return stream_->WriteStreamData(buf.get(), length, DATA_FLAG_NONE);
+  return SendData(buf.get(), length);
+}
+
+int SpdyWebSocketStream::SendData(IOBuffer* data, int length) {
+  if (!stream_) {
+    NOTREACHED();
+    return ERR_UNEXPECTED;
+  }
+  return stream_->WriteStreamData(data, length, DATA_FLAG_NONE);
 }
 
 void SpdyWebSocketStream::Close() {
@@ -66,6 +66,8 @@ class NET_EXPORT_PRIVATE SpdyWebSocketStream
 
   int SendRequest(const linked_ptr<SpdyHeaderBlock>& headers);
   int SendData(const char* data, int length);
+  // Like above, but sends |data| without copying it first.
+  int SendData(IOBuffer* data, int length);
   void Close();
 
   // SpdyStream::Delegate
@@ -0,0 +1,93 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_write_queue.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "net/spdy/spdy_stream.h"
+
+namespace net {
+
+SpdyWriteQueue::PriorityLevel::PriorityLevel() {}
+
+SpdyWriteQueue::PriorityLevel::~PriorityLevel() {}
+
+SpdyWriteQueue::SpdyWriteQueue() : num_frames_(0) {}
+
+SpdyWriteQueue::~SpdyWriteQueue() {}
+
+void SpdyWriteQueue::Enqueue(const SpdyIOBuffer& frame) {
+  DCHECK_GE(frame.priority(), MINIMUM_PRIORITY);
+  DCHECK_LT(frame.priority(), NUM_PRIORITIES);
+  PriorityLevel* level = &levels_[frame.priority()];
+  SpdyStream* stream = frame.stream().get();
+  FrameQueue* frames = &level->frames[stream];
+  if (frames->empty())
+    level->turns.push_back(stream);
+  frames->push_back(frame);
+  num_frames_++;
+}
+
+bool SpdyWriteQueue::Dequeue(SpdyIOBuffer* frame) {
+  for (int i = NUM_PRIORITIES - 1; i >= MINIMUM_PRIORITY; --i) {
+    PriorityLevel* level = &levels_[i];
+    if (level->turns.empty())
+      continue;
+
+    SpdyStream* stream = level->turns.front();
+    level->turns.pop_front();
+    StreamFrameMap::iterator it = level->frames.find(stream);
+    DCHECK(it != level->frames.end());
+    *frame = it->second.front();
+    it->second.pop_front();
+    if (it->second.empty())
+      level->frames.erase(it);
+    else
+      level->turns.push_back(stream);  // Wait for the next turn.
+    num_frames_--;
+    return true;
+  }
+  DCHECK(IsEmpty());
+  return false;
+}
+
+void SpdyWriteQueue::ChangePriority(SpdyStream* stream,
+                                    RequestPriority priority) {
+  DCHECK(stream);
+  DCHECK_GE(priority, MINIMUM_PRIORITY);
+  DCHECK_LT(priority, NUM_PRIORITIES);
+  for (int i = MINIMUM_PRIORITY; i < NUM_PRIORITIES; ++i) {
+    if (i == priority)
+      continue;
+    PriorityLevel* level = &levels_[i];
+    StreamFrameMap::iterator it = level->frames.find(stream);
+    if (it == level->frames.end())
+      continue;
+
+    level->turns.erase(
+        std::find(level->turns.begin(), level->turns.end(), stream));
+    PriorityLevel* new_level = &levels_[priority];
+    FrameQueue* frames = &new_level->frames[stream];
+    if (frames->empty())
+      new_level->turns.push_back(stream);
+    for (FrameQueue::iterator frame = it->second.begin();
+         frame != it->second.end(); ++frame) {
+      frame->set_priority(priority);
+      frames->push_back(*frame);
+    }
+    level->frames.erase(it);
+  }
+}
+
+void SpdyWriteQueue::Clear() {
+  for (int i = MINIMUM_PRIORITY; i < NUM_PRIORITIES; ++i) {
+    levels_[i].turns.clear();
+    levels_[i].frames.clear();
+  }
+  num_frames_ = 0;
+}
+
+}  // namespace net
@@ -0,0 +1,71 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_SPDY_WRITE_QUEUE_H_
+#define NET_SPDY_SPDY_WRITE_QUEUE_H_
+#pragma once
+
+#include <deque>
+#include <map>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+#include "net/base/request_priority.h"
+#include "net/spdy/spdy_io_buffer.h"
+
+namespace net {
+
+class SpdyStream;
+
+// The frames that a SpdySession has to send, in the order it should send them.
+// Frames of a higher priority always go first. Within a priority, the streams
+// that have frames take turns, one frame each, so that a stream with a lot of
+// data queued does not delay the other streams of the same priority. The
+// frames that are not tied to a stream take their turn as if they were from
+// one more stream. The frames of a given stream are always sent in the order
+// they were queued.
+class NET_EXPORT_PRIVATE SpdyWriteQueue {
+ public:
+  SpdyWriteQueue();
+  ~SpdyWriteQueue();
+
+  bool IsEmpty() const { return num_frames_ == 0; }
+  size_t size() const { return num_frames_; }
+
+  // Adds |frame| with the priority and the stream that it has.
+  void Enqueue(const SpdyIOBuffer& frame);
+
+  // Removes the next frame to send and stores it in |frame|. Returns false if
+  // the queue is empty.
+  bool Dequeue(SpdyIOBuffer* frame);
+
+  // Moves the frames queued for |stream| to |priority|, keeping their order.
+  void ChangePriority(SpdyStream* stream, RequestPriority priority);
+
+  // Discards all the frames.
+  void Clear();
+
+ private:
+  typedef std::deque<SpdyIOBuffer> FrameQueue;
+  typedef std::map<SpdyStream*, FrameQueue> StreamFrameMap;
+
+  // The frames of a given priority.
+  struct PriorityLevel {
+    PriorityLevel();
+    ~PriorityLevel();
+
+    // The streams with frames queued, in the order of their turns.
+    std::deque<SpdyStream*> turns;
+    StreamFrameMap frames;
+  };
+
+  PriorityLevel levels_[NUM_PRIORITIES];
+  size_t num_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyWriteQueue);
+};
+
+}  // namespace net
+
+#endif  // NET_SPDY_SPDY_WRITE_QUEUE_H_
@@ -0,0 +1,146 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_write_queue.h"
+
+#include "net/base/io_buffer.h"
+#include "net/base/net_log.h"
+#include "net/spdy/spdy_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kBulkFrameSize = 2800;
+const int kSmallFrameSize = 100;
+
+scoped_refptr<SpdyStream> CreateStream(SpdyStreamId stream_id,
+                                       RequestPriority priority) {
+  scoped_refptr<SpdyStream> stream(
+      new SpdyStream(NULL, stream_id, false, BoundNetLog()));
+  stream->set_priority(priority);
+  return stream;
+}
+
+SpdyIOBuffer CreateFrame(int size, SpdyStream* stream) {
+  return SpdyIOBuffer(new IOBuffer(size), size, stream->priority(), stream);
+}
+
+}  // namespace
+
+// Frames of higher priority go first, and equal priorities are FIFO.
+TEST(SpdyWriteQueueTest, Priorities) {
+  scoped_refptr<SpdyStream> low(CreateStream(1, LOW));
+  scoped_refptr<SpdyStream> highest(CreateStream(3, HIGHEST));
+  SpdyWriteQueue queue;
+
+  queue.Enqueue(CreateFrame(1, low));
+  queue.Enqueue(CreateFrame(2, low));
+  queue.Enqueue(CreateFrame(3, highest));
+  EXPECT_EQ(3u, queue.size());
+
+  SpdyIOBuffer frame;
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  EXPECT_EQ(highest.get(), frame.stream().get());
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  EXPECT_EQ(1u, frame.size());
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  EXPECT_EQ(2u, frame.size());
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.Dequeue(&frame));
+}
+
+// The streams of a given priority take turns, and frames without a stream
+// take their turn too.
+TEST(SpdyWriteQueueTest, RoundRobin) {
+  scoped_refptr<SpdyStream> stream1(CreateStream(1, MEDIUM));
+  scoped_refptr<SpdyStream> stream3(CreateStream(3, MEDIUM));
+  SpdyWriteQueue queue;
+
+  for (int i = 0; i < 3; ++i)
+    queue.Enqueue(CreateFrame(1, stream1));
+  queue.Enqueue(CreateFrame(3, stream3));
+  queue.Enqueue(SpdyIOBuffer(new IOBuffer(5), 5, MEDIUM, NULL));
+  queue.Enqueue(CreateFrame(3, stream3));
+
+  const SpdyStream* expected[] = {
+    stream1, stream3, NULL, stream1, stream3, stream1,
+  };
+  for (size_t i = 0; i < arraysize(expected); ++i) {
+    SpdyIOBuffer frame;
+    ASSERT_TRUE(queue.Dequeue(&frame));
+    EXPECT_EQ(expected[i], frame.stream().get()) << i;
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// The frames of a stream follow its priority, in order.
+TEST(SpdyWriteQueueTest, ChangePriority) {
+  scoped_refptr<SpdyStream> stream1(CreateStream(1, LOW));
+  scoped_refptr<SpdyStream> stream3(CreateStream(3, MEDIUM));
+  SpdyWriteQueue queue;
+
+  queue.Enqueue(CreateFrame(1, stream1));
+  queue.Enqueue(CreateFrame(2, stream1));
+  queue.Enqueue(CreateFrame(3, stream3));
+
+  stream1->set_priority(HIGHEST);
+  queue.ChangePriority(stream1, HIGHEST);
+  EXPECT_EQ(3u, queue.size());
+
+  SpdyIOBuffer frame;
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  EXPECT_EQ(1u, frame.size());
+  EXPECT_EQ(HIGHEST, frame.priority());
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  EXPECT_EQ(2u, frame.size());
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  EXPECT_EQ(stream3.get(), frame.stream().get());
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// Measures how many bytes go out before the first byte of a stream, when it
+// starts behind a bulk transfer: with a higher priority it only waits for the
+// frame being written, and with the same priority for one frame of each
+// stream that has its turn first.
+TEST(SpdyWriteQueueTest, FirstByteUnderBulkLoad) {
+  const int kBulkFrames = 100;
+  scoped_refptr<SpdyStream> bulk1(CreateStream(1, LOWEST));
+  scoped_refptr<SpdyStream> bulk3(CreateStream(3, LOWEST));
+  scoped_refptr<SpdyStream> css(CreateStream(5, HIGHEST));
+  scoped_refptr<SpdyStream> image(CreateStream(7, LOWEST));
+
+  SpdyWriteQueue queue;
+  for (int i = 0; i < kBulkFrames; ++i) {
+    queue.Enqueue(CreateFrame(kBulkFrameSize, bulk1));
+    queue.Enqueue(CreateFrame(kBulkFrameSize, bulk3));
+  }
+
+  // Start writing the bulk data, then request the other resources.
+  SpdyIOBuffer frame;
+  ASSERT_TRUE(queue.Dequeue(&frame));
+  size_t bytes_written = frame.size();
+  queue.Enqueue(CreateFrame(kSmallFrameSize, image));
+  queue.Enqueue(CreateFrame(kSmallFrameSize, css));
+
+  size_t css_first_byte = 0;
+  size_t image_first_byte = 0;
+  while (queue.Dequeue(&frame)) {
+    if (frame.stream() == css && !css_first_byte)
+      css_first_byte = bytes_written;
+    if (frame.stream() == image && !image_first_byte)
+      image_first_byte = bytes_written;
+    bytes_written += frame.size();
+  }
+
+  EXPECT_EQ(static_cast<size_t>(kBulkFrameSize), css_first_byte);
+  EXPECT_EQ(static_cast<size_t>(3 * kBulkFrameSize + kSmallFrameSize),
+            image_first_byte);
+  EXPECT_EQ(static_cast<size_t>(2 * kBulkFrames * kBulkFrameSize +
+                                2 * kSmallFrameSize),
+            bytes_written);
+}
+
+}  // namespace net
@@ -947,6 +947,26 @@ SSL_IMPORT SECStatus SSL_HandshakeNegotiatedExtension(PRFileDesc * socket,
 SSL_IMPORT SECStatus SSL_HandshakeResumedSession(PRFileDesc *fd,
                                                  PRBool *last_handshake_resumed);
 
+/*
+** Export the client session of the last handshake on fd, so that it can be
+** resumed by another process with SSL_ImportSessionState. The exported state
+** contains the master secret of the session: the caller must protect it.
+** |state| is allocated with SECITEM_AllocItem and must be freed with
+** SECITEM_ZfreeItem(state, PR_FALSE). Fails if the session cannot be
+** resumed, used client authentication or its master secret can't be
+** extracted from the token.
+*/
+SSL_IMPORT SECStatus SSL_ExportSessionState(PRFileDesc *fd, SECItem *state);
+
+/*
+** Add a session exported with SSL_ExportSessionState to the client session
+** cache, so that the next handshake on fd can resume it. Must be called after
+** the peer address, SSL_SetURL and SSL_SetSockPeerID have been set up, and
+** before the handshake starts. Expired and malformed states are rejected.
+*/
+SSL_IMPORT SECStatus SSL_ImportSessionState(PRFileDesc *fd,
+                                            const SECItem *state);
+
 /*
 ** How long should we wait before retransmitting the next flight of
 ** the DTLS handshake? Returns SECFailure if not DTLS or not in a
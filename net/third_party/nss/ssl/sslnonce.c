@@ -40,6 +40,7 @@
 
 #include "cert.h"
 #include "pk11pub.h"
+#include "secmod.h"
 #include "secitem.h"
 #include "ssl.h"
 #include "nss.h"
@@ -535,3 +536,399 @@ ssl3_SetSIDSessionTicket(sslSessionID *sid, NewSessionTicket *session_ticket)
     UNLOCK_CACHE;
     return SECSuccess;
 }
+
+/* Version of the format written by SSL_ExportSessionState. */
+#define SSL_SESSION_STATE_VERSION 1
+
+/* The state is a sequence of big-endian integers and of opaque vectors
+ * preceded by their length, written with these helpers.
+ */
+static unsigned char *
+ssl_EncodeSessionUint(unsigned char *p, PRUint32 value, int bytes)
+{
+    while (bytes--)
+	*p++ = (unsigned char)(value >> (8 * bytes));
+    return p;
+}
+
+static unsigned char *
+ssl_EncodeSessionOpaque(unsigned char *p, const unsigned char *data,
+			unsigned int len, int lenBytes)
+{
+    p = ssl_EncodeSessionUint(p, len, lenBytes);
+    if (len)
+	PORT_Memcpy(p, data, len);
+    return p + len;
+}
+
+typedef struct {
+    const unsigned char *data;
+    unsigned int         len;
+} sslSessionStateReader;
+
+static SECStatus
+ssl_DecodeSessionUint(sslSessionStateReader *r, int bytes, PRUint32 *value)
+{
+    if (r->len < (unsigned int)bytes)
+	return SECFailure;
+    *value = 0;
+    while (bytes--) {
+	*value = (*value << 8) | *r->data++;
+	r->len--;
+    }
+    return SECSuccess;
+}
+
+/* |item| points into the data of the reader. */
+static SECStatus
+ssl_DecodeSessionOpaque(sslSessionStateReader *r, int lenBytes, SECItem *item)
+{
+    PRUint32 len;
+
+    if (ssl_DecodeSessionUint(r, lenBytes, &len) != SECSuccess ||
+	r->len < len)
+	return SECFailure;
+    item->type = siBuffer;
+    item->data = (unsigned char *)r->data;
+    item->len  = len;
+    r->data += len;
+    r->len  -= len;
+    return SECSuccess;
+}
+
+/* Copies the unwrapped master secret of |sid| to |ms|. */
+static SECStatus
+ssl_GetSIDMasterSecret(sslSocket *ss, sslSessionID *sid,
+		       unsigned char *ms, unsigned int *msLen)
+{
+    PK11SlotInfo *slot;
+    PK11SymKey *  wrapKey;
+    PK11SymKey *  masterSecret;
+    SECItem       wrappedMS;
+    SECItem *     keyData;
+    CK_FLAGS      keyFlags = 0;
+    SECStatus     rv = SECFailure;
+
+    if (!sid->u.ssl3.keys.msIsWrapped) {
+	*msLen = sid->u.ssl3.keys.wrapped_master_secret_len;
+	PORT_Memcpy(ms, sid->u.ssl3.keys.wrapped_master_secret, *msLen);
+	return SECSuccess;
+    }
+
+    if (!sid->u.ssl3.masterValid)
+	return SECFailure;
+    slot = SECMOD_LookupSlot(sid->u.ssl3.masterModuleID,
+			     sid->u.ssl3.masterSlotID);
+    if (slot == NULL)
+	return SECFailure;
+    wrapKey = PK11_GetWrapKey(slot, sid->u.ssl3.masterWrapIndex,
+			      sid->u.ssl3.masterWrapMech,
+			      sid->u.ssl3.masterWrapSeries,
+			      ss->pkcs11PinArg);
+    PK11_FreeSlot(slot);
+    if (wrapKey == NULL)
+	return SECFailure;
+
+    if (sid->version > SSL_LIBRARY_VERSION_3_0)	/* isTLS */
+	keyFlags = CKF_SIGN | CKF_VERIFY;
+    wrappedMS.data = sid->u.ssl3.keys.wrapped_master_secret;
+    wrappedMS.len  = sid->u.ssl3.keys.wrapped_master_secret_len;
+    masterSecret = PK11_UnwrapSymKeyWithFlags(wrapKey,
+			sid->u.ssl3.masterWrapMech, NULL, &wrappedMS,
+			CKM_SSL3_MASTER_KEY_DERIVE, CKA_DERIVE,
+			sizeof(SSL3MasterSecret), keyFlags);
+    PK11_FreeSymKey(wrapKey);
+    if (masterSecret == NULL)
+	return SECFailure;
+
+    /* This fails if the token doesn't let the key out, e.g. in FIPS mode. */
+    if (PK11_ExtractKeyValue(masterSecret) == SECSuccess) {
+	keyData = PK11_GetKeyData(masterSecret);
+	if (keyData && keyData->len == SSL3_MASTER_SECRET_LENGTH) {
+	    PORT_Memcpy(ms, keyData->data, keyData->len);
+	    *msLen = keyData->len;
+	    rv = SECSuccess;
+	}
+    }
+    PK11_FreeSymKey(masterSecret);
+    return rv;
+}
+
+SECStatus
+SSL_ExportSessionState(PRFileDesc *fd, SECItem *state)
+{
+    sslSocket *    ss = ssl_FindSocket(fd);
+    sslSessionID * sid;
+    unsigned char  ms[SSL3_MASTER_SECRET_LENGTH];
+    unsigned int   msLen = 0;
+    unsigned int   numCerts = 0;
+    unsigned int   len;
+    unsigned char *p;
+    PRUint32       negotiatedECCurves = 0;
+    SECStatus      rv = SECFailure;
+
+    if (!ss) {
+	SSL_DBG(("%d: SSL[%d]: bad socket in SSL_ExportSessionState",
+		 SSL_GETPID(), fd));
+	return SECFailure;
+    }
+    if (!state) {
+	PORT_SetError(SEC_ERROR_INVALID_ARGS);
+	return SECFailure;
+    }
+
+    ssl_Get1stHandshakeLock(ss);
+    ssl_GetSSL3HandshakeLock(ss);
+
+    sid = ss->sec.ci.sid;
+    if (ss->sec.isServer || !sid || sid->cached != in_client_cache ||
+	sid->version < SSL_LIBRARY_VERSION_3_0 ||
+	!sid->u.ssl3.keys.resumable || sid->localCert ||
+	sid->u.ssl3.clAuthValid || !sid->peerCert ||
+	ssl_GetSIDMasterSecret(ss, sid, ms, &msLen) != SECSuccess) {
+	goto loser;
+    }
+#ifdef NSS_ENABLE_ECC
+    negotiatedECCurves = sid->u.ssl3.negotiatedECCurves;
+#endif
+
+    len = 1 + 2 + 2 + 1 + 4 * 8 + 1 + sid->u.ssl3.sessionIDLength +
+	  1 + msLen + 4 + 4 + 2 + sid->u.ssl3.sessionTicket.ticket.len +
+	  2 + sid->u.ssl3.srvName.len + 1 + 3 + sid->peerCert->derCert.len;
+    while (numCerts < MAX_PEER_CERT_CHAIN_SIZE &&
+	   sid->peerCertChain[numCerts]) {
+	len += 3 + sid->peerCertChain[numCerts]->derCert.len;
+	numCerts++;
+    }
+    if (sid->u.ssl3.sessionTicket.ticket.len > 0xffff ||
+	sid->u.ssl3.srvName.len > 0xffff) {
+	goto loser;
+    }
+
+    if (!SECITEM_AllocItem(NULL, state, len))
+	goto loser;
+    p = state->data;
+    p = ssl_EncodeSessionUint(p, SSL_SESSION_STATE_VERSION, 1);
+    p = ssl_EncodeSessionUint(p, sid->version, 2);
+    p = ssl_EncodeSessionUint(p, sid->u.ssl3.cipherSuite, 2);
+    p = ssl_EncodeSessionUint(p, sid->u.ssl3.compression, 1);
+    p = ssl_EncodeSessionUint(p, sid->u.ssl3.exchKeyType, 4);
+    p = ssl_EncodeSessionUint(p, sid->authAlgorithm, 4);
+    p = ssl_EncodeSessionUint(p, sid->authKeyBits, 4);
+    p = ssl_EncodeSessionUint(p, sid->keaType, 4);
+    p = ssl_EncodeSessionUint(p, sid->keaKeyBits, 4);
+    p = ssl_EncodeSessionUint(p, sid->creationTime, 4);
+    p = ssl_EncodeSessionUint(p, sid->expirationTime, 4);
+    p = ssl_EncodeSessionUint(p, negotiatedECCurves, 4);
+    p = ssl_EncodeSessionOpaque(p, sid->u.ssl3.sessionID,
+				sid->u.ssl3.sessionIDLength, 1);
+    p = ssl_EncodeSessionOpaque(p, ms, msLen, 1);
+    p = ssl_EncodeSessionUint(p,
+	    sid->u.ssl3.sessionTicket.received_timestamp, 4);
+    p = ssl_EncodeSessionUint(p,
+	    sid->u.ssl3.sessionTicket.ticket_lifetime_hint, 4);
+    p = ssl_EncodeSessionOpaque(p, sid->u.ssl3.sessionTicket.ticket.data,
+				sid->u.ssl3.sessionTicket.ticket.len, 2);
+    p = ssl_EncodeSessionOpaque(p, sid->u.ssl3.srvName.data,
+				sid->u.ssl3.srvName.len, 2);
+    p = ssl_EncodeSessionUint(p, numCerts, 1);
+    p = ssl_EncodeSessionOpaque(p, sid->peerCert->derCert.data,
+				sid->peerCert->derCert.len, 3);
+    for (numCerts = 0; numCerts < MAX_PEER_CERT_CHAIN_SIZE &&
+		       sid->peerCertChain[numCerts]; numCerts++) {
+	p = ssl_EncodeSessionOpaque(p,
+		sid->peerCertChain[numCerts]->derCert.data,
+		sid->peerCertChain[numCerts]->derCert.len, 3);
+    }
+    PORT_Assert(p == state->data + state->len);
+    rv = SECSuccess;
+
+loser:
+    PORT_Memset(ms, 0, sizeof(ms));
+    ssl_ReleaseSSL3HandshakeLock(ss);
+    ssl_Release1stHandshakeLock(ss);
+    return rv;
+}
+
+static CERTCertificate *
+ssl_DecodeSessionCert(sslSessionStateReader *r)
+{
+    SECItem derCert;
+
+    if (ssl_DecodeSessionOpaque(r, 3, &derCert) != SECSuccess ||
+	!derCert.len)
+	return NULL;
+    return CERT_NewTempCertificate(CERT_GetDefaultCertDB(), &derCert,
+				   NULL, PR_FALSE, PR_TRUE);
+}
+
+SECStatus
+SSL_ImportSessionState(PRFileDesc *fd, const SECItem *state)
+{
+    sslSocket *           ss = ssl_FindSocket(fd);
+    sslSessionID *        sid;
+    sslSessionStateReader r;
+    PRFileDesc *          osfd;
+    PRNetAddr             peer;
+    PRIPv6Addr            addr;
+    PRUint16              port;
+    PRUint32              value;
+    PRUint32              numCerts;
+    PRUint32              i;
+    SECItem               item;
+
+    if (!ss) {
+	SSL_DBG(("%d: SSL[%d]: bad socket in SSL_ImportSessionState",
+		 SSL_GETPID(), fd));
+	return SECFailure;
+    }
+    if (!state || !state->data || ss->sec.isServer || !ss->url ||
+	ss->opt.noCache) {
+	PORT_SetError(SEC_ERROR_INVALID_ARGS);
+	return SECFailure;
+    }
+
+    /* The session is keyed by the peer address, like the sessions of the
+     * handshakes of this process. */
+    osfd = ss->fd->lower;
+    PORT_Memset(&peer, 0, sizeof(peer));
+    if (osfd->methods->getpeername(osfd, &peer) != PR_SUCCESS)
+	return SECFailure;
+    if (peer.inet.family == PR_AF_INET) {
+	PR_ConvertIPv4AddrToIPv6(peer.inet.ip, &addr);
+	port = peer.inet.port;
+    } else if (peer.ipv6.family == PR_AF_INET6) {
+	addr = peer.ipv6.ip;
+	port = peer.ipv6.port;
+    } else {
+	PORT_SetError(PR_ADDRESS_NOT_SUPPORTED_ERROR);
+	return SECFailure;
+    }
+
+    /* Don't replace a session of this process, which is at least as recent. */
+    sid = ssl_LookupSID(&addr, port, ss->peerID, ss->url);
+    if (sid) {
+	ssl_FreeSID(sid);
+	PORT_SetError(SEC_ERROR_INVALID_ARGS);
+	return SECFailure;
+    }
+
+    r.data = state->data;
+    r.len  = state->len;
+    if (ssl_DecodeSessionUint(&r, 1, &value) != SECSuccess ||
+	value != SSL_SESSION_STATE_VERSION) {
+	PORT_SetError(SEC_ERROR_BAD_DATA);
+	return SECFailure;
+    }
+
+    sid = PORT_ZNew(sslSessionID);
+    if (!sid)
+	return SECFailure;
+    sid->references = 1;
+    sid->cached = never_cached;
+    sid->addr = addr;
+    sid->port = port;
+    sid->urlSvrName = PORT_Strdup(ss->url);
+    if (!sid->urlSvrName)
+	goto loser;
+    if (ss->peerID) {
+	sid->peerID = PORT_Strdup(ss->peerID);
+	if (!sid->peerID)
+	    goto loser;
+    }
+
+    if (ssl_DecodeSessionUint(&r, 2, &value) != SECSuccess ||
+	value < SSL_LIBRARY_VERSION_3_0)
+	goto bad_data;
+    sid->version = (SSL3ProtocolVersion)value;
+    if (ssl_DecodeSessionUint(&r, 2, &value) != SECSuccess)
+	goto bad_data;
+    sid->u.ssl3.cipherSuite = (ssl3CipherSuite)value;
+    if (ssl_DecodeSessionUint(&r, 1, &value) != SECSuccess)
+	goto bad_data;
+    sid->u.ssl3.compression = (SSLCompressionMethod)value;
+    if (ssl_DecodeSessionUint(&r, 4, &value) != SECSuccess)
+	goto bad_data;
+    sid->u.ssl3.exchKeyType = (SSL3KEAType)value;
+    if (ssl_DecodeSessionUint(&r, 4, &value) != SECSuccess)
+	goto bad_data;
+    sid->authAlgorithm = (SSLSignType)value;
+    if (ssl_DecodeSessionUint(&r, 4, &sid->authKeyBits) != SECSuccess ||
+	ssl_DecodeSessionUint(&r, 4, &value) != SECSuccess)
+	goto bad_data;
+    sid->keaType = (SSLKEAType)value;
+    if (ssl_DecodeSessionUint(&r, 4, &sid->keaKeyBits) != SECSuccess ||
+	ssl_DecodeSessionUint(&r, 4, &sid->creationTime) != SECSuccess ||
+	ssl_DecodeSessionUint(&r, 4, &sid->expirationTime) != SECSuccess ||
+	ssl_DecodeSessionUint(&r, 4, &value) != SECSuccess)
+	goto bad_data;
+#ifdef NSS_ENABLE_ECC
+    sid->u.ssl3.negotiatedECCurves = value;
+#endif
+    if (sid->expirationTime <= ssl_Time())
+	goto bad_data;
+    sid->lastAccessTime = sid->creationTime;
+
+    if (ssl_DecodeSessionOpaque(&r, 1, &item) != SECSuccess ||
+	item.len > SSL3_SESSIONID_BYTES)
+	goto bad_data;
+    sid->u.ssl3.sessionIDLength = item.len;
+    if (item.len)
+	PORT_Memcpy(sid->u.ssl3.sessionID, item.data, item.len);
+
+    /* The master secret is imported to the token when the session is
+     * resumed, like the master secret of a session cached by a socket that
+     * bypasses PKCS#11. */
+    if (ssl_DecodeSessionOpaque(&r, 1, &item) != SECSuccess ||
+	item.len != SSL3_MASTER_SECRET_LENGTH)
+	goto bad_data;
+    PORT_Memcpy(sid->u.ssl3.keys.wrapped_master_secret, item.data, item.len);
+    sid->u.ssl3.keys.wrapped_master_secret_len = item.len;
+    sid->u.ssl3.keys.msIsWrapped = PR_FALSE;
+    sid->u.ssl3.keys.resumable = PR_TRUE;
+    sid->u.ssl3.masterValid = PR_TRUE;
+    sid->u.ssl3.policy = ss->ssl3.policy;
+
+    if (ssl_DecodeSessionUint(&r, 4,
+	    &sid->u.ssl3.sessionTicket.received_timestamp) != SECSuccess ||
+	ssl_DecodeSessionUint(&r, 4,
+	    &sid->u.ssl3.sessionTicket.ticket_lifetime_hint) != SECSuccess ||
+	ssl_DecodeSessionOpaque(&r, 2, &item) != SECSuccess)
+	goto bad_data;
+    if (item.len &&
+	SECITEM_CopyItem(NULL, &sid->u.ssl3.sessionTicket.ticket,
+			 &item) != SECSuccess)
+	goto loser;
+    if (ssl_DecodeSessionOpaque(&r, 2, &item) != SECSuccess)
+	goto bad_data;
+    if (item.len &&
+	SECITEM_CopyItem(NULL, &sid->u.ssl3.srvName, &item) != SECSuccess)
+	goto loser;
+    if (sid->u.ssl3.sessionIDLength == 0 &&
+	sid->u.ssl3.sessionTicket.ticket.data == NULL)
+	goto bad_data;
+
+    if (ssl_DecodeSessionUint(&r, 1, &numCerts) != SECSuccess ||
+	numCerts > MAX_PEER_CERT_CHAIN_SIZE)
+	goto bad_data;
+    sid->peerCert = ssl_DecodeSessionCert(&r);
+    if (!sid->peerCert)
+	goto bad_data;
+    for (i = 0; i < numCerts; i++) {
+	sid->peerCertChain[i] = ssl_DecodeSessionCert(&r);
+	if (!sid->peerCertChain[i])
+	    goto bad_data;
+    }
+    if (r.len)
+	goto bad_data;
+
+    CacheSID(sid);
+    ssl_FreeSID(sid);
+    return SECSuccess;
+
+bad_data:
+    PORT_SetError(SEC_ERROR_BAD_DATA);
+loser:
+    ssl_FreeSID(sid);
+    return SECFailure;
+}
@@ -46,7 +46,11 @@ class SMAcceptorThread : public base::SimpleThread,
                          public EpollCallbackInterface,
                          public SMConnectionPoolInterface {
  public:
-  SMAcceptorThread(FlipAcceptor *acceptor, MemoryCache* memory_cache);
+  // Accepts the connections of |acceptor| from |listen_fd|, which is either
+  // the socket of |acceptor| or another socket bound to the same port with
+  // SO_REUSEPORT. |memory_cache| may be shared with other threads.
+  SMAcceptorThread(FlipAcceptor *acceptor, MemoryCache* memory_cache,
+                   int listen_fd);
   virtual ~SMAcceptorThread();
 
   // EpollCallbackInteface interface
@@ -80,9 +84,11 @@ class SMAcceptorThread : public base::SimpleThread,
  private:
   EpollServer epoll_server_;
   FlipAcceptor* acceptor_;
+  int listen_fd_;
   SSLState* ssl_state_;
   bool use_ssl_;
   int idle_socket_timeout_s_;
+  time_t oldest_idle_time_;
 
   std::vector<SMConnection*> unused_server_connections_;
   std::vector<SMConnection*> tmp_unused_server_connections_;
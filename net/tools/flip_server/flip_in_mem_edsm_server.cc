@@ -46,6 +46,11 @@ int32 FLAGS_accept_backlog_size = 1024;
 //  SO_REUSEPORT);
 bool FLAGS_reuseport = false;
 
+// The number of threads accepting and serving the connections of each
+//  acceptor. With reuseport each thread has its own listening socket,
+//  otherwise they share one);
+int32 FLAGS_acceptor_threads = 1;
+
 // Flag to force spdy, even if NPN is not negotiated.
 bool FLAGS_force_spdy = false;
 
@@ -204,6 +209,12 @@ int main (int argc, char**argv)
     cout << "\t--ssl-session-expiry=<seconds> (default is 300)\n";
     cout << "\t--ssl-disable-compression\n";
     cout << "\t--idle-timeout=<seconds> (default is 300)\n";
+    cout << "\t--acceptor-threads=<count> (default is 1)\n";
+    cout << "\t  * The number of threads serving each listen ip:port.\n";
+    cout << "\t--reuseport\n";
+    cout << "\t  * Gives each acceptor thread its own listening socket."
+         << " Requires\n"
+         << "\t    kernel support for SO_REUSEPORT.\n";
     cout << "\t--pidfile=<filepath> (default /var/run/flip-server.pid)\n";
     cout << "\t--help\n";
     exit(0);
@@ -272,6 +283,16 @@ int main (int argc, char**argv)
   if (cl.HasSwitch("force_spdy"))
     net::SMConnection::set_force_spdy(true);
 
+  if (cl.HasSwitch("reuseport"))
+    FLAGS_reuseport = true;
+
+  if (cl.HasSwitch("acceptor-threads")) {
+    FLAGS_acceptor_threads =
+      atoi(cl.GetSwitchValueASCII("acceptor-threads").c_str());
+    if (FLAGS_acceptor_threads < 1)
+      LOG(FATAL) << "There must be at least one acceptor thread.";
+  }
+
   InitLogging(g_proxy_config.log_filename_.c_str(),
               g_proxy_config.log_destination_,
               logging::DONT_LOCK_LOG_FILE,
@@ -291,6 +312,7 @@ int main (int argc, char**argv)
             << (FLAGS_disable_nagle?"true":"false");
   LOG(INFO) << "Reuseport               : "
             << (FLAGS_reuseport?"true":"false");
+  LOG(INFO) << "Acceptor threads        : " << FLAGS_acceptor_threads;
   LOG(INFO) << "Force SPDY              : "
             << (FLAGS_force_spdy?"true":"false");
   LOG(INFO) << "SSL session expiry      : "
@@ -375,19 +397,38 @@ int main (int argc, char**argv)
   for (i = 0; i < g_proxy_config.acceptors_.size(); i++) {
     net::FlipAcceptor *acceptor = g_proxy_config.acceptors_[i];
 
-    sm_worker_threads_.push_back(
-        new net::SMAcceptorThread(acceptor,
-                                  (net::MemoryCache *)acceptor->memory_cache_));
-    // Note that spdy_memory_cache is not threadsafe, it is merely
-    // thread compatible. Thus, if ever we are to spawn multiple threads,
-    // we either must make the MemoryCache threadsafe, or use
-    // a separate MemoryCache for each thread.
-    //
-    // The latter is what is currently being done as we spawn
-    // a separate thread for each http and spdy server acceptor.
-
-    sm_worker_threads_.back()->InitWorker();
-    sm_worker_threads_.back()->Start();
+    for (int j = 0; j < FLAGS_acceptor_threads; ++j) {
+      int listen_fd = acceptor->listen_fd_;
+      if (j > 0 && FLAGS_reuseport) {
+        // Let the kernel spread the connections over the threads.
+        int fd = -1;
+        if (net::CreateListeningSocket(acceptor->listen_ip_,
+                                       acceptor->listen_port_,
+                                       true,
+                                       acceptor->accept_backlog_size_,
+                                       true,
+                                       true,
+                                       wait_for_iface,
+                                       acceptor->disable_nagle_,
+                                       &fd) == 0) {
+          net::SetNonBlocking(fd);
+          listen_fd = fd;
+        } else {
+          LOG(ERROR) << "Unable to create another listening socket for "
+                     << acceptor->listen_ip_ << ":" << acceptor->listen_port_
+                     << ", sharing the first one.";
+        }
+      }
+
+      // The memory caches are never modified once filled, so the threads
+      // of an acceptor share its cache.
+      sm_worker_threads_.push_back(
+          new net::SMAcceptorThread(acceptor,
+                                    (net::MemoryCache *)acceptor->memory_cache_,
+                                    listen_fd));
+      sm_worker_threads_.back()->InitWorker();
+      sm_worker_threads_.back()->Start();
+    }
   }
 
   while (!wantExit) {
@@ -0,0 +1,214 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A load generator for the HTTP server mode of the flip server. Each
+// connection sends back to back keep-alive requests for the same path, and
+// the run reports the requests and body bytes served per second.
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/format_macros.h"
+#include "base/logging.h"
+#include "base/string_number_conversions.h"
+#include "base/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/time.h"
+#include "net/tools/flip_server/balsa_frame.h"
+#include "net/tools/flip_server/mem_cache.h"
+
+namespace {
+
+void Usage(const char* program_name) {
+  printf("usage: %s --server=<ip> --port=<port> --path=<path>\n"
+         "          [--connections=<count>] [--seconds=<duration>]\n",
+         program_name);
+  exit(1);
+}
+
+int ConnectTo(const std::string& host, const std::string& port) {
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = PF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_NUMERICHOST;
+  struct addrinfo* results = NULL;
+  int err = getaddrinfo(host.c_str(), port.c_str(), &hints, &results);
+  if (err) {
+    LOG(ERROR) << "getaddrinfo for " << host << ":" << port << ": "
+               << gai_strerror(err);
+    return -1;
+  }
+
+  int fd = socket(results->ai_family, results->ai_socktype,
+                  results->ai_protocol);
+  if (fd != -1 && connect(fd, results->ai_addr, results->ai_addrlen) != 0) {
+    LOG(ERROR) << "connect to " << host << ":" << port << ": "
+               << strerror(errno);
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(results);
+  if (fd != -1) {
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+  return fd;
+}
+
+// Keeps one connection busy until |deadline|.
+class LoadThread : public base::SimpleThread {
+ public:
+  LoadThread(const std::string& host,
+             const std::string& port,
+             const std::string& path,
+             base::TimeTicks deadline)
+      : base::SimpleThread("LoadThread"),
+        host_(host),
+        port_(port),
+        request_(base::StringPrintf("GET %s HTTP/1.1\r\n"
+                                    "Host: %s\r\n"
+                                    "Connection: keep-alive\r\n"
+                                    "\r\n",
+                                    path.c_str(), host.c_str())),
+        deadline_(deadline),
+        num_responses_(0),
+        num_body_bytes_(0),
+        num_errors_(0) {}
+
+  virtual void Run() OVERRIDE {
+    int fd = -1;
+    while (base::TimeTicks::Now() < deadline_) {
+      if (fd == -1) {
+        fd = ConnectTo(host_, port_);
+        if (fd == -1) {
+          ++num_errors_;
+          return;
+        }
+      }
+      if (!FetchOnce(fd)) {
+        ++num_errors_;
+        close(fd);
+        fd = -1;
+      }
+    }
+    if (fd != -1)
+      close(fd);
+  }
+
+  int64 num_responses() const { return num_responses_; }
+  int64 num_body_bytes() const { return num_body_bytes_; }
+  int64 num_errors() const { return num_errors_; }
+
+ private:
+  // Sends the request and reads the whole response from |fd|.
+  bool FetchOnce(int fd) {
+    if (send(fd, request_.data(), request_.size(), MSG_NOSIGNAL) !=
+        static_cast<ssize_t>(request_.size())) {
+      return false;
+    }
+
+    net::StoreBodyAndHeadersVisitor visitor;
+    net::BalsaFrame framer;
+    framer.set_balsa_visitor(&visitor);
+    framer.set_balsa_headers(&visitor.headers);
+    framer.set_is_request(false);
+    char buffer[16 * 1024];
+    while (!framer.MessageFullyRead()) {
+      ssize_t len = read(fd, buffer, sizeof(buffer));
+      if (len <= 0)
+        return false;
+      size_t pos = 0;
+      while (pos < static_cast<size_t>(len) && !framer.MessageFullyRead()) {
+        size_t consumed = framer.ProcessInput(buffer + pos, len - pos);
+        if (framer.Error() || !consumed)
+          return false;
+        pos += consumed;
+      }
+    }
+    ++num_responses_;
+    num_body_bytes_ += visitor.body.size();
+    return true;
+  }
+
+  const std::string host_;
+  const std::string port_;
+  const std::string request_;
+  const base::TimeTicks deadline_;
+  int64 num_responses_;
+  int64 num_body_bytes_;
+  int64 num_errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadThread);
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine& cl = *CommandLine::ForCurrentProcess();
+
+  if (!cl.HasSwitch("server") || !cl.HasSwitch("port") ||
+      !cl.HasSwitch("path")) {
+    Usage(argv[0]);
+  }
+
+  int connections = 100;
+  if (cl.HasSwitch("connections") &&
+      (!base::StringToInt(cl.GetSwitchValueASCII("connections"),
+                          &connections) || connections < 1)) {
+    Usage(argv[0]);
+  }
+  int seconds = 10;
+  if (cl.HasSwitch("seconds") &&
+      (!base::StringToInt(cl.GetSwitchValueASCII("seconds"), &seconds) ||
+       seconds < 1)) {
+    Usage(argv[0]);
+  }
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  base::TimeTicks deadline = start + base::TimeDelta::FromSeconds(seconds);
+  std::vector<LoadThread*> threads;
+  for (int i = 0; i < connections; ++i) {
+    threads.push_back(new LoadThread(cl.GetSwitchValueASCII("server"),
+                                     cl.GetSwitchValueASCII("port"),
+                                     cl.GetSwitchValueASCII("path"),
+                                     deadline));
+    threads.back()->Start();
+  }
+
+  int64 num_responses = 0;
+  int64 num_body_bytes = 0;
+  int64 num_errors = 0;
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Join();
+    num_responses += threads[i]->num_responses();
+    num_body_bytes += threads[i]->num_body_bytes();
+    num_errors += threads[i]->num_errors();
+    delete threads[i];
+  }
+  double elapsed = (base::TimeTicks::Now() - start).InSecondsF();
+
+  printf("connections:      %d\n", connections);
+  printf("responses:        %" PRId64 "\n", num_responses);
+  printf("errors:           %" PRId64 "\n", num_errors);
+  printf("responses/second: %.1f\n", num_responses / elapsed);
+  printf("MB/second:        %.2f\n",
+         num_body_bytes / elapsed / (1024 * 1024));
+  return 0;
+}
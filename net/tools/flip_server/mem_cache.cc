@@ -14,6 +14,7 @@
 #include <deque>
 
 #include "base/string_piece.h"
+#include "base/string_util.h"
 #include "net/tools/dump_cache/url_to_filename_encoder.h"
 #include "net/tools/dump_cache/url_utilities.h"
 #include "net/tools/flip_server/balsa_frame.h"
@@ -205,7 +206,7 @@ void MemoryCache::ReadAndStoreFileContents(const char* filename) {
 
 FileData* MemoryCache::GetFileData(const std::string& filename) {
   Files::iterator fi = files_.end();
-  if (filename.compare(filename.length() - 5, 5, ".html", 5) == 0) {
+  if (EndsWith(filename, ".html", true)) {
     std::string new_filename(filename.data(), filename.size() - 5);
     new_filename += ".http";
     fi = files_.find(new_filename);
@@ -5,11 +5,11 @@
 #ifndef NET_TOOLS_FLIP_SERVER_MEM_CACHE_H_
 #define NET_TOOLS_FLIP_SERVER_MEM_CACHE_H_
 
-#include <map>
 #include <string>
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/hash_tables.h"
 #include "net/tools/flip_server/balsa_headers.h"
 #include "net/tools/flip_server/balsa_visitor_interface.h"
 #include "net/tools/flip_server/constants.h"
@@ -106,9 +106,12 @@ class MemCacheIter {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// The responses served by the SPDY and HTTP servers. The cache is filled by
+// AddFiles() before the acceptor threads start and is only read afterwards,
+// so all the threads share one MemoryCache without locking.
 class MemoryCache {
  public:
-  typedef std::map<std::string, FileData> Files;
+  typedef base::hash_map<std::string, FileData> Files;
 
  public:
   MemoryCache();
@@ -7,7 +7,9 @@
 #include <errno.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
 
@@ -20,6 +22,13 @@
 
 namespace net {
 
+namespace {
+
+// The most frames written by one call to SendOutputList().
+const int kMaxFramesPerSend = 64;
+
+}  // namespace
+
 // static
 bool SMConnection::force_spdy_ = false;
 
@@ -224,6 +233,28 @@ int SMConnection::Send(const char* data, int len, int flags) {
   return rv;
 }
 
+int SMConnection::SendOutputList(int flags) {
+  DCHECK(!ssl_);
+  struct iovec iov[kMaxFramesPerSend];
+  int num_frames = 0;
+  for (OutputList::const_iterator it = output_list_.begin();
+       it != output_list_.end() && num_frames < kMaxFramesPerSend; ++it) {
+    const DataFrame* data_frame = *it;
+    if (data_frame->index >= data_frame->size)
+      continue;
+    iov[num_frames].iov_base =
+        const_cast<char*>(data_frame->data + data_frame->index);
+    iov[num_frames].iov_len = data_frame->size - data_frame->index;
+    ++num_frames;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = num_frames;
+  return sendmsg(fd_, &msg, flags);
+}
+
 void SMConnection::OnRegistration(EpollServer* eps, int fd, int event_mask) {
   registered_in_epoll_server_ = true;
 }
@@ -575,7 +606,13 @@ bool SMConnection::DoWrite() {
       flags |= MSG_MORE;
     }
     VLOG(2) << log_prefix_ << "Attempting to send " << size << " bytes.";
-    ssize_t bytes_written = Send(bytes, size, flags);
+    ssize_t bytes_written;
+    if (!ssl_ && output_list_.size() > 1) {
+      // Write the queued frames together rather than one send() each.
+      bytes_written = SendOutputList(flags);
+    } else {
+      bytes_written = Send(bytes, size, flags);
+    }
     int stored_errno = errno;
     if (bytes_written == -1) {
       switch (stored_errno) {
@@ -597,7 +634,7 @@ bool SMConnection::DoWrite() {
     } else if (bytes_written > 0) {
       VLOG(2) << log_prefix_ << ACCEPTOR_CLIENT_IDENT << "Wrote: "
               << bytes_written << " bytes";
-      data_frame->index += bytes_written;
+      AdvanceOutputList(bytes_written);
       bytes_sent += bytes_written;
       continue;
     } else if (bytes_written == -2) {
@@ -622,6 +659,18 @@ bool SMConnection::DoWrite() {
   return false;
 }
 
+void SMConnection::AdvanceOutputList(size_t bytes) {
+  for (OutputList::iterator it = output_list_.begin();
+       it != output_list_.end() && bytes > 0; ++it) {
+    DataFrame* data_frame = *it;
+    size_t remaining = data_frame->size - data_frame->index;
+    size_t consumed = std::min(remaining, bytes);
+    data_frame->index += consumed;
+    bytes -= consumed;
+  }
+  DCHECK_EQ(0u, bytes);
+}
+
 void SMConnection::Reset() {
   VLOG(2) << log_prefix_ << ACCEPTOR_CLIENT_IDENT << "Resetting";
   if (ssl_) {
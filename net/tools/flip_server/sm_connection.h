@@ -79,6 +79,10 @@ class SMConnection : public SMConnectionInterface,
 
   int Send(const char* data, int len, int flags);
 
+  // Sends as many of the frames of |output_list_| as possible with a single
+  // call. Does not support SSL.
+  int SendOutputList(int flags);
+
   // EpollCallbackInterface interface.
   virtual void OnRegistration(EpollServer* eps,
                               int fd,
@@ -107,6 +111,8 @@ class SMConnection : public SMConnectionInterface,
 
   bool DoRead();
   bool DoWrite();
+  // Marks |bytes| more bytes of |output_list_| as sent.
+  void AdvanceOutputList(size_t bytes);
   bool DoConsumeReadData();
   void Reset();
 
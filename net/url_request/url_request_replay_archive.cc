@@ -0,0 +1,109 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request_replay_archive.h"
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+
+namespace net {
+
+namespace {
+
+// Bump when the layout written by Save() changes; older archives are then
+// rejected rather than misread.
+const int kArchiveVersion = 1;
+
+}  // namespace
+
+URLRequestReplayArchive::Entry::Entry() {}
+
+URLRequestReplayArchive::Entry::~Entry() {}
+
+URLRequestReplayArchive::URLRequestReplayArchive() {}
+
+URLRequestReplayArchive::~URLRequestReplayArchive() {}
+
+void URLRequestReplayArchive::AddEntry(const Entry& entry) {
+  entries_[GetKey(entry.method, entry.url)] = entry;
+}
+
+const URLRequestReplayArchive::Entry* URLRequestReplayArchive::FindEntry(
+    const std::string& method, const GURL& url) const {
+  EntryMap::const_iterator it = entries_.find(GetKey(method, url));
+  return it == entries_.end() ? NULL : &it->second;
+}
+
+bool URLRequestReplayArchive::Load(const FilePath& path) {
+  entries_.clear();
+  std::string contents;
+  if (!file_util::ReadFileToString(path, &contents)) {
+    LOG(ERROR) << "Unable to read replay archive: " << path.value();
+    return false;
+  }
+
+  Pickle pickle(contents.data(), static_cast<int>(contents.size()));
+  PickleIterator iter(pickle);
+  int version = 0;
+  int count = 0;
+  if (!pickle.ReadInt(&iter, &version) || version != kArchiveVersion ||
+      !pickle.ReadInt(&iter, &count) || count < 0) {
+    LOG(ERROR) << "Bad replay archive header: " << path.value();
+    return false;
+  }
+  for (int i = 0; i < count; ++i) {
+    Entry entry;
+    std::string url;
+    int64 time_to_first_byte = 0;
+    int64 transfer_time = 0;
+    if (!pickle.ReadString(&iter, &entry.method) ||
+        !pickle.ReadString(&iter, &url) ||
+        !pickle.ReadString(&iter, &entry.raw_headers) ||
+        !pickle.ReadString(&iter, &entry.body) ||
+        !pickle.ReadInt64(&iter, &time_to_first_byte) ||
+        !pickle.ReadInt64(&iter, &transfer_time)) {
+      LOG(ERROR) << "Replay archive entry #" << i << " is corrupt: "
+                 << path.value();
+      entries_.clear();
+      return false;
+    }
+    entry.url = GURL(url);
+    entry.time_to_first_byte =
+        base::TimeDelta::FromMicroseconds(time_to_first_byte);
+    entry.transfer_time = base::TimeDelta::FromMicroseconds(transfer_time);
+    AddEntry(entry);
+  }
+  return true;
+}
+
+bool URLRequestReplayArchive::Save(const FilePath& path) const {
+  Pickle pickle;
+  pickle.WriteInt(kArchiveVersion);
+  pickle.WriteInt(static_cast<int>(entries_.size()));
+  for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+       ++it) {
+    const Entry& entry = it->second;
+    pickle.WriteString(entry.method);
+    pickle.WriteString(entry.url.spec());
+    pickle.WriteString(entry.raw_headers);
+    pickle.WriteString(entry.body);
+    pickle.WriteInt64(entry.time_to_first_byte.InMicroseconds());
+    pickle.WriteInt64(entry.transfer_time.InMicroseconds());
+  }
+  int size = static_cast<int>(pickle.size());
+  return file_util::WriteFile(
+      path, static_cast<const char*>(pickle.data()), size) == size;
+}
+
+// static
+std::string URLRequestReplayArchive::GetKey(const std::string& method,
+                                            const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return method + " " + url.ReplaceComponents(replacements).spec();
+}
+
+}  // namespace net
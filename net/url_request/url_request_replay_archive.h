@@ -0,0 +1,82 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A URLRequestReplayArchive holds recorded responses, along with how long the
+// server took to send them, so that page loads can be replayed reproducibly
+// through URLRequestReplayProtocolHandler.
+
+#ifndef NET_URL_REQUEST_URL_REQUEST_REPLAY_ARCHIVE_H_
+#define NET_URL_REQUEST_URL_REQUEST_REPLAY_ARCHIVE_H_
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/time.h"
+#include "googleurl/src/gurl.h"
+#include "net/base/net_export.h"
+
+class FilePath;
+
+namespace net {
+
+// Shared by the protocol handler and the jobs it creates; read-only once
+// loaded, so it may be used from any thread.
+class NET_EXPORT URLRequestReplayArchive
+    : public base::RefCountedThreadSafe<URLRequestReplayArchive> {
+ public:
+  struct NET_EXPORT Entry {
+    Entry();
+    ~Entry();
+
+    std::string method;
+    GURL url;
+    // In the format of HttpResponseHeaders::raw_headers(): lines separated
+    // by '\0'.
+    std::string raw_headers;
+    // The decoded body; |raw_headers| carries no Content-Encoding.
+    std::string body;
+    // From the start of the request to the arrival of the headers.
+    base::TimeDelta time_to_first_byte;
+    // From the arrival of the headers to the last byte of the body.
+    base::TimeDelta transfer_time;
+  };
+
+  URLRequestReplayArchive();
+
+  // Adds |entry|, replacing any earlier entry for the same method and URL.
+  void AddEntry(const Entry& entry);
+
+  // Returns the entry for |method| and |url|, or NULL. The reference
+  // fragment of |url| is ignored, as it is never sent to the server.
+  const Entry* FindEntry(const std::string& method, const GURL& url) const;
+
+  size_t size() const { return entries_.size(); }
+
+  // Replaces the contents with the archive at |path|. Returns false, leaving
+  // the archive empty, if the file is missing or malformed.
+  bool Load(const FilePath& path);
+
+  // Writes the archive to |path|.
+  bool Save(const FilePath& path) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<URLRequestReplayArchive>;
+
+  typedef std::map<std::string, Entry> EntryMap;
+
+  ~URLRequestReplayArchive();
+
+  static std::string GetKey(const std::string& method, const GURL& url);
+
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestReplayArchive);
+};
+
+}  // namespace net
+
+#endif  // NET_URL_REQUEST_URL_REQUEST_REPLAY_ARCHIVE_H_
@@ -0,0 +1,197 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request_replay_job.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_error_job.h"
+#include "net/url_request/url_request_status.h"
+
+namespace net {
+
+namespace {
+
+// Returns true if |request_header| of |request| is present and equal to
+// |response_header| of |headers|.
+bool HeaderMatches(const URLRequest* request,
+                   const char* request_header,
+                   const HttpResponseHeaders* headers,
+                   const char* response_header) {
+  std::string request_value;
+  std::string response_value;
+  return request->extra_request_headers().GetHeader(request_header,
+                                                    &request_value) &&
+      headers->EnumerateHeader(NULL, response_header, &response_value) &&
+      request_value == response_value;
+}
+
+}  // namespace
+
+URLRequestReplayJob::URLRequestReplayJob(
+    URLRequest* request,
+    URLRequestReplayArchive* archive,
+    const URLRequestReplayArchive::Entry* entry,
+    bool replay_timing)
+    : URLRequestJob(request),
+      archive_(archive),
+      entry_(entry),
+      replay_timing_(replay_timing),
+      offset_(0),
+      pending_buf_size_(0) {
+  DCHECK(entry_);
+}
+
+URLRequestReplayJob::~URLRequestReplayJob() {}
+
+void URLRequestReplayJob::Start() {
+  headers_ = new HttpResponseHeaders(entry_->raw_headers);
+  if (IsNotModified()) {
+    headers_->ReplaceStatusLine("HTTP/1.1 304 Not Modified");
+    headers_->RemoveHeader("Content-Length");
+  } else {
+    body_ = entry_->body;
+  }
+
+  // Always asynchronous, like a network job, even without a delay.
+  base::TimeDelta delay =
+      replay_timing_ ? entry_->time_to_first_byte : base::TimeDelta();
+  timer_.Start(FROM_HERE, delay, this, &URLRequestReplayJob::OnHeadersReady);
+}
+
+void URLRequestReplayJob::Kill() {
+  timer_.Stop();
+  pending_buf_ = NULL;
+  URLRequestJob::Kill();
+}
+
+bool URLRequestReplayJob::ReadRawData(IOBuffer* buf,
+                                      int buf_size,
+                                      int* bytes_read) {
+  DCHECK(bytes_read);
+  DCHECK(!pending_buf_);
+  if (offset_ < body_.size() && GetBytesAvailable() <= offset_) {
+    pending_buf_ = buf;
+    pending_buf_size_ = buf_size;
+    SetStatus(URLRequestStatus(URLRequestStatus::IO_PENDING, 0));
+    SchedulePendingRead();
+    return false;
+  }
+  *bytes_read = CopyBody(buf, buf_size);
+  return true;
+}
+
+bool URLRequestReplayJob::GetMimeType(std::string* mime_type) const {
+  return headers_ && headers_->GetMimeType(mime_type);
+}
+
+bool URLRequestReplayJob::GetCharset(std::string* charset) {
+  return headers_ && headers_->GetCharset(charset);
+}
+
+void URLRequestReplayJob::GetResponseInfo(HttpResponseInfo* info) {
+  info->headers = headers_;
+}
+
+int URLRequestReplayJob::GetResponseCode() const {
+  return headers_ ? headers_->response_code() : -1;
+}
+
+bool URLRequestReplayJob::IsRedirectResponse(GURL* location,
+                                             int* http_status_code) {
+  std::string value;
+  if (!headers_ || !headers_->IsRedirect(&value))
+    return false;
+  *location = request_->url().Resolve(value);
+  *http_status_code = headers_->response_code();
+  return true;
+}
+
+bool URLRequestReplayJob::IsNotModified() const {
+  if (request_->method() != "GET" || headers_->response_code() != 200)
+    return false;
+  return HeaderMatches(request_, HttpRequestHeaders::kIfNoneMatch,
+                       headers_, "ETag") ||
+      HeaderMatches(request_, HttpRequestHeaders::kIfModifiedSince,
+                    headers_, "Last-Modified");
+}
+
+void URLRequestReplayJob::OnHeadersReady() {
+  headers_time_ = base::TimeTicks::Now();
+  NotifyHeadersComplete();
+}
+
+size_t URLRequestReplayJob::GetBytesAvailable() const {
+  int64 transfer_us = entry_->transfer_time.InMicroseconds();
+  if (!replay_timing_ || transfer_us <= 0)
+    return body_.size();
+  int64 elapsed_us = (base::TimeTicks::Now() - headers_time_).InMicroseconds();
+  if (elapsed_us >= transfer_us)
+    return body_.size();
+  return static_cast<size_t>(
+      static_cast<int64>(body_.size()) * elapsed_us / transfer_us);
+}
+
+int URLRequestReplayJob::CopyBody(IOBuffer* buf, int buf_size) {
+  size_t available = std::max(GetBytesAvailable(), offset_);
+  size_t length = std::min(static_cast<size_t>(buf_size), available - offset_);
+  memcpy(buf->data(), body_.data() + offset_, length);
+  offset_ += length;
+  return static_cast<int>(length);
+}
+
+void URLRequestReplayJob::SchedulePendingRead() {
+  // Wake up once the whole buffer could be filled, instead of after every
+  // byte.
+  size_t wanted = std::min(body_.size(),
+                           offset_ + static_cast<size_t>(pending_buf_size_));
+  int64 transfer_us = entry_->transfer_time.InMicroseconds();
+  int64 size = static_cast<int64>(body_.size());
+  base::TimeTicks ready = headers_time_ + base::TimeDelta::FromMicroseconds(
+      (transfer_us * static_cast<int64>(wanted) + size - 1) / size);
+  base::TimeDelta delay = std::max(ready - base::TimeTicks::Now(),
+                                   base::TimeDelta());
+  timer_.Start(FROM_HERE, delay, this, &URLRequestReplayJob::OnReadReady);
+}
+
+void URLRequestReplayJob::OnReadReady() {
+  if (GetBytesAvailable() <= offset_) {
+    SchedulePendingRead();
+    return;
+  }
+  scoped_refptr<IOBuffer> buf;
+  buf.swap(pending_buf_);
+  int bytes_read = CopyBody(buf, pending_buf_size_);
+  SetStatus(URLRequestStatus());  // Clear the IO_PENDING status.
+  NotifyReadComplete(bytes_read);
+}
+
+URLRequestReplayProtocolHandler::URLRequestReplayProtocolHandler(
+    URLRequestReplayArchive* archive, bool replay_timing)
+    : archive_(archive),
+      replay_timing_(replay_timing) {
+}
+
+URLRequestReplayProtocolHandler::~URLRequestReplayProtocolHandler() {}
+
+URLRequestJob* URLRequestReplayProtocolHandler::MaybeCreateJob(
+    URLRequest* request) const {
+  const URLRequestReplayArchive::Entry* entry =
+      archive_->FindEntry(request->method(), request->url());
+  if (!entry) {
+    VLOG(1) << "Not in replay archive: " << request->method() << " "
+            << request->url().spec();
+    return new URLRequestErrorJob(request, ERR_CONNECTION_REFUSED);
+  }
+  return new URLRequestReplayJob(request, archive_, entry, replay_timing_);
+}
+
+}  // namespace net
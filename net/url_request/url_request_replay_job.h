@@ -0,0 +1,113 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// URLRequestReplayJob serves a response from a URLRequestReplayArchive,
+// delaying the headers and pacing the body as they were when recorded.
+// URLRequestReplayProtocolHandler creates these jobs; registering it for
+// http and https makes every page load replay from the archive.
+
+#ifndef NET_URL_REQUEST_URL_REQUEST_REPLAY_JOB_H_
+#define NET_URL_REQUEST_URL_REQUEST_REPLAY_JOB_H_
+#pragma once
+
+#include <string>
+
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/string_piece.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "net/base/net_export.h"
+#include "net/url_request/url_request_job.h"
+#include "net/url_request/url_request_job_factory.h"
+#include "net/url_request/url_request_replay_archive.h"
+
+namespace net {
+
+class HttpResponseHeaders;
+class IOBuffer;
+
+class NET_EXPORT URLRequestReplayJob : public URLRequestJob {
+ public:
+  // |entry| is owned by |archive|. When |replay_timing| is false the
+  // response is served as fast as the reader takes it.
+  URLRequestReplayJob(URLRequest* request,
+                      URLRequestReplayArchive* archive,
+                      const URLRequestReplayArchive::Entry* entry,
+                      bool replay_timing);
+
+  // URLRequestJob:
+  virtual void Start() OVERRIDE;
+  virtual void Kill() OVERRIDE;
+  virtual bool ReadRawData(IOBuffer* buf,
+                           int buf_size,
+                           int* bytes_read) OVERRIDE;
+  virtual bool GetMimeType(std::string* mime_type) const OVERRIDE;
+  virtual bool GetCharset(std::string* charset) OVERRIDE;
+  virtual void GetResponseInfo(HttpResponseInfo* info) OVERRIDE;
+  virtual int GetResponseCode() const OVERRIDE;
+  virtual bool IsRedirectResponse(GURL* location,
+                                  int* http_status_code) OVERRIDE;
+
+ private:
+  virtual ~URLRequestReplayJob();
+
+  // Returns true if the request is a revalidation that the recorded
+  // response satisfies, in which case a 304 is served instead.
+  bool IsNotModified() const;
+
+  void OnHeadersReady();
+
+  // Returns how many body bytes the recorded transfer had sent by now.
+  size_t GetBytesAvailable() const;
+
+  // Copies as much of the body as is available into |buf|.
+  int CopyBody(IOBuffer* buf, int buf_size);
+
+  // Waits until the body of a pending read has "arrived".
+  void SchedulePendingRead();
+  void OnReadReady();
+
+  scoped_refptr<URLRequestReplayArchive> archive_;
+  const URLRequestReplayArchive::Entry* entry_;
+  const bool replay_timing_;
+
+  scoped_refptr<HttpResponseHeaders> headers_;
+  // Empty for a 304.
+  base::StringPiece body_;
+  size_t offset_;
+  base::TimeTicks headers_time_;
+
+  // The buffer of a read waiting for more of the body to "arrive".
+  scoped_refptr<IOBuffer> pending_buf_;
+  int pending_buf_size_;
+
+  base::OneShotTimer<URLRequestReplayJob> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestReplayJob);
+};
+
+class NET_EXPORT URLRequestReplayProtocolHandler
+    : public URLRequestJobFactory::ProtocolHandler {
+ public:
+  // Requests missing from |archive| fail with ERR_CONNECTION_REFUSED rather
+  // than going to the network, so that a replay never depends on live
+  // servers.
+  URLRequestReplayProtocolHandler(URLRequestReplayArchive* archive,
+                                  bool replay_timing);
+  virtual ~URLRequestReplayProtocolHandler();
+
+  // URLRequestJobFactory::ProtocolHandler:
+  virtual URLRequestJob* MaybeCreateJob(URLRequest* request) const OVERRIDE;
+
+ private:
+  scoped_refptr<URLRequestReplayArchive> archive_;
+  const bool replay_timing_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestReplayProtocolHandler);
+};
+
+}  // namespace net
+
+#endif  // NET_URL_REQUEST_URL_REQUEST_REPLAY_JOB_H_
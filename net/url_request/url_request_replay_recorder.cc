@@ -0,0 +1,138 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request_replay_recorder.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/message_loop.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/http/http_response_headers.h"
+
+namespace net {
+
+namespace {
+
+const int kBufferSize = 32 * 1024;
+
+}  // namespace
+
+URLRequestReplayRecorder::URLRequestReplayRecorder(
+    const URLRequestContext* context,
+    URLRequestReplayArchive* archive)
+    : context_(context),
+      archive_(archive),
+      next_url_(0),
+      buffer_(new IOBuffer(kBufferSize)),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+}
+
+URLRequestReplayRecorder::~URLRequestReplayRecorder() {}
+
+void URLRequestReplayRecorder::Record(const std::vector<GURL>& urls,
+                                      const base::Closure& callback) {
+  DCHECK(!request_.get());
+  urls_ = urls;
+  next_url_ = 0;
+  callback_ = callback;
+  StartNextRequest();
+}
+
+void URLRequestReplayRecorder::OnReceivedRedirect(URLRequest* request,
+                                                  const GURL& new_url,
+                                                  bool* defer_redirect) {
+  // The redirect is replayed as its own entry; the next hop is timed anew.
+  response_time_ = base::TimeTicks::Now();
+  AddEntry(std::string());
+  start_time_ = base::TimeTicks::Now();
+}
+
+void URLRequestReplayRecorder::OnResponseStarted(URLRequest* request) {
+  response_time_ = base::TimeTicks::Now();
+  if (!request->status().is_success() || !request->response_headers()) {
+    LOG(WARNING) << "Not recorded: " << request->url().spec();
+    OnRequestDone();
+    return;
+  }
+  ReadBody();
+}
+
+void URLRequestReplayRecorder::OnReadCompleted(URLRequest* request,
+                                               int bytes_read) {
+  if (bytes_read > 0) {
+    body_.append(buffer_->data(), bytes_read);
+    ReadBody();
+    return;
+  }
+  if (request->status().is_success())
+    AddEntry(body_);
+  else
+    LOG(WARNING) << "Not recorded: " << request->url().spec();
+  OnRequestDone();
+}
+
+void URLRequestReplayRecorder::StartNextRequest() {
+  request_.reset();
+  if (next_url_ == urls_.size()) {
+    base::Closure callback = callback_;
+    callback_.Reset();
+    callback.Run();
+    return;
+  }
+
+  body_.clear();
+  request_.reset(new URLRequest(urls_[next_url_++], this));
+  request_->set_context(context_);
+  request_->set_load_flags(LOAD_BYPASS_CACHE | LOAD_DISABLE_CACHE);
+  start_time_ = base::TimeTicks::Now();
+  request_->Start();
+}
+
+void URLRequestReplayRecorder::ReadBody() {
+  int bytes_read = 0;
+  while (request_->Read(buffer_, kBufferSize, &bytes_read)) {
+    if (bytes_read <= 0) {
+      OnReadCompleted(request_.get(), bytes_read);
+      return;
+    }
+    body_.append(buffer_->data(), bytes_read);
+  }
+  if (!request_->status().is_io_pending())
+    OnReadCompleted(request_.get(), -1);
+}
+
+void URLRequestReplayRecorder::AddEntry(const std::string& body) {
+  HttpResponseHeaders* response_headers = request_->response_headers();
+  if (!response_headers)
+    return;
+
+  // The body was read decoded, so the headers must not claim an encoding,
+  // nor the length of the encoded body.
+  scoped_refptr<HttpResponseHeaders> headers =
+      new HttpResponseHeaders(response_headers->raw_headers());
+  if (headers->HasHeader("Content-Encoding")) {
+    headers->RemoveHeader("Content-Encoding");
+    headers->RemoveHeader("Content-Length");
+  }
+
+  URLRequestReplayArchive::Entry entry;
+  entry.method = request_->method();
+  entry.url = request_->url();
+  entry.raw_headers = headers->raw_headers();
+  entry.body = body;
+  entry.time_to_first_byte = response_time_ - start_time_;
+  entry.transfer_time = base::TimeTicks::Now() - response_time_;
+  archive_->AddEntry(entry);
+}
+
+void URLRequestReplayRecorder::OnRequestDone() {
+  // The request may not be deleted from within its own callbacks.
+  MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&URLRequestReplayRecorder::StartNextRequest,
+                 weak_factory_.GetWeakPtr()));
+}
+
+}  // namespace net
@@ -0,0 +1,82 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// URLRequestReplayRecorder fetches a list of URLs through a real
+// URLRequestContext and adds each response, and each redirect on the way to
+// it, to a URLRequestReplayArchive together with its timing.
+
+#ifndef NET_URL_REQUEST_URL_REQUEST_REPLAY_RECORDER_H_
+#define NET_URL_REQUEST_URL_REQUEST_REPLAY_RECORDER_H_
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time.h"
+#include "googleurl/src/gurl.h"
+#include "net/base/net_export.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_replay_archive.h"
+
+namespace net {
+
+class IOBuffer;
+class URLRequestContext;
+
+class NET_EXPORT URLRequestReplayRecorder : public URLRequest::Delegate {
+ public:
+  URLRequestReplayRecorder(const URLRequestContext* context,
+                           URLRequestReplayArchive* archive);
+  virtual ~URLRequestReplayRecorder();
+
+  // Fetches |urls| one at a time, bypassing the cache so that the recorded
+  // timing is that of the server, and runs |callback| once all are in the
+  // archive. URLs that fail are left out.
+  void Record(const std::vector<GURL>& urls, const base::Closure& callback);
+
+  // URLRequest::Delegate:
+  virtual void OnReceivedRedirect(URLRequest* request,
+                                  const GURL& new_url,
+                                  bool* defer_redirect) OVERRIDE;
+  virtual void OnResponseStarted(URLRequest* request) OVERRIDE;
+  virtual void OnReadCompleted(URLRequest* request, int bytes_read) OVERRIDE;
+
+ private:
+  void StartNextRequest();
+
+  // Reads until the body is complete or a read is pending.
+  void ReadBody();
+
+  // Adds the current response, with |body|, to the archive.
+  void AddEntry(const std::string& body);
+
+  void OnRequestDone();
+
+  const URLRequestContext* context_;
+  scoped_refptr<URLRequestReplayArchive> archive_;
+
+  std::vector<GURL> urls_;
+  size_t next_url_;
+  base::Closure callback_;
+
+  scoped_ptr<URLRequest> request_;
+  scoped_refptr<IOBuffer> buffer_;
+  std::string body_;
+  // When the current hop of the request started and when its headers came.
+  base::TimeTicks start_time_;
+  base::TimeTicks response_time_;
+
+  base::WeakPtrFactory<URLRequestReplayRecorder> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestReplayRecorder);
+};
+
+}  // namespace net
+
+#endif  // NET_URL_REQUEST_URL_REQUEST_REPLAY_RECORDER_H_
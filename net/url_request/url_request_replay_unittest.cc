@@ -0,0 +1,193 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/file_path.h"
+#include "base/message_loop.h"
+#include "base/scoped_temp_dir.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request_job_factory.h"
+#include "net/url_request/url_request_replay_archive.h"
+#include "net/url_request/url_request_replay_job.h"
+#include "net/url_request/url_request_replay_recorder.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const char kPageUrl[] = "http://www.example.com/page.html";
+const char kMovedUrl[] = "http://www.example.com/moved";
+const char kPageBody[] = "<html>recorded</html>";
+
+URLRequestReplayArchive::Entry MakeEntry(const std::string& url,
+                                         const std::string& headers,
+                                         const std::string& body) {
+  URLRequestReplayArchive::Entry entry;
+  entry.method = "GET";
+  entry.url = GURL(url);
+  entry.raw_headers = HttpUtil::AssembleRawHeaders(headers.data(),
+                                                   headers.size());
+  entry.body = body;
+  return entry;
+}
+
+class URLRequestReplayTest : public testing::Test {
+ public:
+  URLRequestReplayTest()
+      : archive_(new URLRequestReplayArchive),
+        context_(new TestURLRequestContext) {
+    archive_->AddEntry(MakeEntry(
+        kPageUrl,
+        "HTTP/1.1 200 OK\n"
+        "Content-Type: text/html\n"
+        "ETag: \"v1\"\n\n",
+        kPageBody));
+    archive_->AddEntry(MakeEntry(
+        kMovedUrl,
+        "HTTP/1.1 302 Found\n"
+        "Location: /page.html\n\n",
+        ""));
+    context_->set_job_factory(&job_factory_);
+  }
+
+ protected:
+  void InstallHandler(bool replay_timing) {
+    job_factory_.SetProtocolHandler(
+        "http", new URLRequestReplayProtocolHandler(archive_, replay_timing));
+  }
+
+  scoped_refptr<URLRequestReplayArchive> archive_;
+  URLRequestJobFactory job_factory_;
+  scoped_refptr<TestURLRequestContext> context_;
+};
+
+}  // namespace
+
+TEST_F(URLRequestReplayTest, SaveAndLoad) {
+  URLRequestReplayArchive::Entry entry = MakeEntry(
+      "http://www.example.com/a", "HTTP/1.1 200 OK\n\n", "body");
+  entry.time_to_first_byte = base::TimeDelta::FromMilliseconds(40);
+  entry.transfer_time = base::TimeDelta::FromMilliseconds(7);
+  archive_->AddEntry(entry);
+
+  ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  FilePath path = dir.path().AppendASCII("archive");
+  ASSERT_TRUE(archive_->Save(path));
+
+  scoped_refptr<URLRequestReplayArchive> loaded(new URLRequestReplayArchive);
+  ASSERT_TRUE(loaded->Load(path));
+  EXPECT_EQ(3u, loaded->size());
+  const URLRequestReplayArchive::Entry* found =
+      loaded->FindEntry("GET", GURL("http://www.example.com/a#fragment"));
+  ASSERT_TRUE(found);
+  EXPECT_EQ("body", found->body);
+  EXPECT_EQ(entry.raw_headers, found->raw_headers);
+  EXPECT_EQ(40, found->time_to_first_byte.InMilliseconds());
+  EXPECT_EQ(7, found->transfer_time.InMilliseconds());
+  EXPECT_FALSE(loaded->FindEntry("POST", GURL("http://www.example.com/a")));
+
+  EXPECT_FALSE(loaded->Load(dir.path().AppendASCII("missing")));
+  EXPECT_EQ(0u, loaded->size());
+}
+
+TEST_F(URLRequestReplayTest, ServesRecordedResponse) {
+  InstallHandler(false);
+  TestDelegate delegate;
+  URLRequest request(GURL(kMovedUrl), &delegate);
+  request.set_context(context_);
+  request.Start();
+  MessageLoop::current()->Run();
+
+  EXPECT_TRUE(request.status().is_success());
+  EXPECT_EQ(1, delegate.received_redirect_count());
+  EXPECT_EQ(GURL(kPageUrl), request.url());
+  EXPECT_EQ(200, request.GetResponseCode());
+  EXPECT_EQ(kPageBody, delegate.data_received());
+  std::string mime_type;
+  request.GetMimeType(&mime_type);
+  EXPECT_EQ("text/html", mime_type);
+}
+
+TEST_F(URLRequestReplayTest, UnrecordedRequestsFail) {
+  InstallHandler(false);
+  TestDelegate delegate;
+  URLRequest request(GURL("http://www.example.com/other"), &delegate);
+  request.set_context(context_);
+  request.Start();
+  MessageLoop::current()->Run();
+
+  EXPECT_EQ(URLRequestStatus::FAILED, request.status().status());
+  EXPECT_EQ(ERR_CONNECTION_REFUSED, request.status().error());
+}
+
+TEST_F(URLRequestReplayTest, RevalidationGetsNotModified) {
+  InstallHandler(false);
+  TestDelegate delegate;
+  URLRequest request(GURL(kPageUrl), &delegate);
+  request.set_context(context_);
+  HttpRequestHeaders headers;
+  headers.SetHeader(HttpRequestHeaders::kIfNoneMatch, "\"v1\"");
+  request.SetExtraRequestHeaders(headers);
+  request.Start();
+  MessageLoop::current()->Run();
+
+  EXPECT_TRUE(request.status().is_success());
+  EXPECT_EQ(304, request.GetResponseCode());
+  EXPECT_EQ("", delegate.data_received());
+}
+
+TEST_F(URLRequestReplayTest, ReplaysTiming) {
+  URLRequestReplayArchive::Entry entry = MakeEntry(
+      "http://www.example.com/slow", "HTTP/1.1 200 OK\n\n",
+      std::string(10000, 'x'));
+  entry.time_to_first_byte = base::TimeDelta::FromMilliseconds(30);
+  entry.transfer_time = base::TimeDelta::FromMilliseconds(30);
+  archive_->AddEntry(entry);
+  InstallHandler(true);
+
+  TestDelegate delegate;
+  URLRequest request(entry.url, &delegate);
+  request.set_context(context_);
+  base::TimeTicks start = base::TimeTicks::Now();
+  request.Start();
+  MessageLoop::current()->Run();
+
+  EXPECT_TRUE(request.status().is_success());
+  EXPECT_EQ(entry.body, delegate.data_received());
+  EXPECT_GE((base::TimeTicks::Now() - start).InMilliseconds(), 60);
+}
+
+TEST_F(URLRequestReplayTest, RecordsResponsesAndRedirects) {
+  // Record from a context that itself replays |archive_|.
+  InstallHandler(false);
+  scoped_refptr<URLRequestReplayArchive> recorded(
+      new URLRequestReplayArchive);
+  URLRequestReplayRecorder recorder(context_, recorded);
+  std::vector<GURL> urls;
+  urls.push_back(GURL(kMovedUrl));
+  urls.push_back(GURL("http://www.example.com/other"));
+  recorder.Record(urls, MessageLoop::QuitClosure());
+  MessageLoop::current()->Run();
+
+  EXPECT_EQ(2u, recorded->size());
+  const URLRequestReplayArchive::Entry* redirect =
+      recorded->FindEntry("GET", GURL(kMovedUrl));
+  ASSERT_TRUE(redirect);
+  scoped_refptr<HttpResponseHeaders> headers(
+      new HttpResponseHeaders(redirect->raw_headers));
+  EXPECT_EQ(302, headers->response_code());
+
+  const URLRequestReplayArchive::Entry* page =
+      recorded->FindEntry("GET", GURL(kPageUrl));
+  ASSERT_TRUE(page);
+  EXPECT_EQ(kPageBody, page->body);
+}
+
+}  // namespace net
@@ -14,10 +14,10 @@
 namespace net {
 
 const unsigned int URLRequestThrottlerManager::kMaximumNumberOfEntries = 1500;
-const unsigned int URLRequestThrottlerManager::kRequestsBetweenCollecting = 200;
+const unsigned int URLRequestThrottlerManager::kEntriesToCollectPerRequest = 2;
 
 URLRequestThrottlerManager::URLRequestThrottlerManager()
-    : requests_since_last_gc_(0),
+    : url_entries_(kMaximumNumberOfEntries),
       enforce_throttling_(true),
       enable_thread_checks_(false),
       logged_for_localhost_disabled_(false),
@@ -48,7 +48,7 @@ URLRequestThrottlerManager::~URLRequestThrottlerManager() {
   }
 
   // Delete all entries.
-  url_entries_.clear();
+  url_entries_.Clear();
 }
 
 scoped_refptr<URLRequestThrottlerEntryInterface>
@@ -58,23 +58,25 @@ scoped_refptr<URLRequestThrottlerEntryInterface>
   // Normalize the url.
   std::string url_id = GetIdFromUrl(url);
 
-  // Periodically garbage collect old entries.
+  // Incrementally garbage collect old entries.
   GarbageCollectEntriesIfNecessary();
 
-  // Find the entry in the map or create a new NULL entry.
-  scoped_refptr<URLRequestThrottlerEntry>& entry = url_entries_[url_id];
+  // Find the entry in the map, moving it to the front.
+  UrlEntryMap::iterator it = url_entries_.Get(url_id);
 
   // If the entry exists but could be garbage collected at this point, we
   // start with a fresh entry so that we possibly back off a bit less
   // aggressively (i.e. this resets the error count when the entry's URL
   // hasn't been requested in long enough).
-  if (entry.get() && entry->IsEntryOutdated()) {
-    entry = NULL;
+  if (it != url_entries_.end() && it->second->IsEntryOutdated()) {
+    url_entries_.Erase(it);
+    it = url_entries_.end();
   }
 
   // Create the entry if needed.
-  if (entry.get() == NULL) {
-    entry = new URLRequestThrottlerEntry(this, url_id);
+  if (it == url_entries_.end()) {
+    it = url_entries_.Put(url_id, new URLRequestThrottlerEntry(this, url_id));
+    URLRequestThrottlerEntry* entry = it->second;
 
     // We only disable back-off throttling on an entry that we have
     // just constructed.  This is to allow unit tests to explicitly override
@@ -99,7 +101,7 @@ scoped_refptr<URLRequestThrottlerEntryInterface>
     }
   }
 
-  return entry;
+  return it->second;
 }
 
 void URLRequestThrottlerManager::AddToOptOutList(const std::string& host) {
@@ -124,16 +126,18 @@ void URLRequestThrottlerManager::OverrideEntryForTests(
   // Normalize the url.
   std::string url_id = GetIdFromUrl(url);
 
-  // Periodically garbage collect old entries.
+  // Incrementally garbage collect old entries.
   GarbageCollectEntriesIfNecessary();
 
-  url_entries_[url_id] = entry;
+  url_entries_.Put(url_id, entry);
 }
 
 void URLRequestThrottlerManager::EraseEntryForTests(const GURL& url) {
   // Normalize the url.
   std::string url_id = GetIdFromUrl(url);
-  url_entries_.erase(url_id);
+  UrlEntryMap::iterator it = url_entries_.Peek(url_id);
+  if (it != url_entries_.end())
+    url_entries_.Erase(it);
 }
 
 void URLRequestThrottlerManager::set_enable_thread_checks(bool enable) {
@@ -179,28 +183,27 @@ std::string URLRequestThrottlerManager::GetIdFromUrl(const GURL& url) const {
 }
 
 void URLRequestThrottlerManager::GarbageCollectEntriesIfNecessary() {
-  requests_since_last_gc_++;
-  if (requests_since_last_gc_ < kRequestsBetweenCollecting)
-    return;
-  requests_since_last_gc_ = 0;
-
-  GarbageCollectEntries();
+  for (unsigned int i = 0;
+       i < kEntriesToCollectPerRequest && i < url_entries_.size(); ++i) {
+    UrlEntryMap::reverse_iterator oldest = url_entries_.rbegin();
+    if (oldest->second->IsEntryOutdated()) {
+      url_entries_.Erase(oldest);
+    } else {
+      // Still in use; check it again once the rest have been checked.
+      url_entries_.Get(oldest->first);
+    }
+  }
 }
 
 void URLRequestThrottlerManager::GarbageCollectEntries() {
   UrlEntryMap::iterator i = url_entries_.begin();
   while (i != url_entries_.end()) {
     if ((i->second)->IsEntryOutdated()) {
-      url_entries_.erase(i++);
+      i = url_entries_.Erase(i);
     } else {
       ++i;
     }
   }
-
-  // In case something broke we want to make sure not to grow indefinitely.
-  while (url_entries_.size() > kMaximumNumberOfEntries) {
-    url_entries_.erase(url_entries_.begin());
-  }
 }
 
 void URLRequestThrottlerManager::OnNetworkChange() {
@@ -208,8 +211,7 @@ void URLRequestThrottlerManager::OnNetworkChange() {
   // to will live until those requests end, and these entries may be
   // inconsistent with new entries for the same URLs, but since what we
   // want is a clean slate for the new connection state, this is OK.
-  url_entries_.clear();
-  requests_since_last_gc_ = 0;
+  url_entries_.Clear();
 }
 
 }  // namespace net
@@ -6,11 +6,11 @@
 #define NET_URL_REQUEST_URL_REQUEST_THROTTLER_MANAGER_H_
 #pragma once
 
-#include <map>
 #include <set>
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
 #include "base/threading/platform_thread.h"
@@ -28,11 +28,12 @@ class NetLog;
 // in order to supervise traffic. URL requests for HTTP contents should
 // register their URLs in this manager on each request.
 //
-// URLRequestThrottlerManager maintains a map of URL IDs to URL request
-// throttler entries. It creates URL request throttler entries when new URLs
-// are registered, and does garbage collection from time to time in order to
-// clean out outdated entries. URL ID consists of lowercased scheme, host, port
-// and path. All URLs converted to the same ID will share the same entry.
+// URLRequestThrottlerManager maintains a hashed map of URL IDs to URL request
+// throttler entries, ordered by when they were last used. It creates URL
+// request throttler entries when new URLs are registered, and checks a few of
+// the least recently used entries on each registration in order to clean out
+// outdated entries. URL ID consists of lowercased scheme, host, port and path.
+// All URLs converted to the same ID will share the same entry.
 class NET_EXPORT URLRequestThrottlerManager
     : NON_EXPORTED_BASE(public base::NonThreadSafe),
       public NetworkChangeNotifier::IPAddressObserver,
@@ -91,12 +92,13 @@ class NET_EXPORT URLRequestThrottlerManager
   // transformation.
   std::string GetIdFromUrl(const GURL& url) const;
 
-  // Method that ensures the map gets cleaned from time to time. The period at
-  // which garbage collecting happens is adjustable with the
-  // kRequestBetweenCollecting constant.
+  // Method that ensures the map gets cleaned incrementally. Checks up to
+  // kEntriesToCollectPerRequest of the least recently used entries, erasing
+  // the outdated ones and moving the others to the front, so that the cost of
+  // a full pass is spread over many requests.
   void GarbageCollectEntriesIfNecessary();
 
-  // Method that does the actual work of garbage collecting.
+  // Method that erases all outdated entries at once.
   void GarbageCollectEntries();
 
   // When we switch from online to offline or change IP addresses, we
@@ -113,18 +115,21 @@ class NET_EXPORT URLRequestThrottlerManager
 
  private:
   // From each URL we generate an ID composed of the scheme, host, port and path
-  // that allows us to uniquely map an entry to it.
-  typedef std::map<std::string, scoped_refptr<URLRequestThrottlerEntry> >
+  // that allows us to uniquely map an entry to it. The most recently used
+  // entries come first.
+  typedef base::HashingMRUCache<std::string,
+                                scoped_refptr<URLRequestThrottlerEntry> >
       UrlEntryMap;
 
   // We maintain a set of hosts that have opted out of exponential
   // back-off throttling.
   typedef std::set<std::string> OptOutHosts;
 
-  // Maximum number of entries that we are willing to collect in our map.
+  // Maximum number of entries that we are willing to collect in our map. The
+  // least recently used entries are evicted past this.
   static const unsigned int kMaximumNumberOfEntries;
-  // Number of requests that will be made between garbage collection.
-  static const unsigned int kRequestsBetweenCollecting;
+  // Number of entries checked for garbage collection on each request.
+  static const unsigned int kEntriesToCollectPerRequest;
 
   // Map that contains a list of URL ID and their matching
   // URLRequestThrottlerEntry.
@@ -133,10 +138,6 @@ class NET_EXPORT URLRequestThrottlerManager
   // Set of hosts that have opted out.
   OptOutHosts opt_out_hosts_;
 
-  // This keeps track of how many requests have been made. Used with
-  // GarbageCollectEntries.
-  unsigned int requests_since_last_gc_;
-
   // Valid after construction.
   GURL::Replacements url_id_replacements_;
 
@@ -0,0 +1,45 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request_throttler_manager.h"
+
+#include <vector>
+
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "googleurl/src/gurl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// Roughly what crawling many hosts looks like: each URL is requested a few
+// times, and then never again.
+const int kNumUrls = 100000;
+const int kRequestsPerUrl = 3;
+
+TEST(URLRequestThrottlerManagerPerfTest, RegisterDistinctUrls) {
+  std::vector<GURL> urls;
+  urls.reserve(kNumUrls);
+  for (int i = 0; i < kNumUrls; ++i) {
+    urls.push_back(GURL(base::StringPrintf(
+        "http://host%d.example.com/path/%d?query", i % 5000, i)));
+  }
+
+  URLRequestThrottlerManager manager;
+  PerfTimeLogger timer("URLRequestThrottlerManager_RegisterRequestUrl");
+  for (int i = 0; i < kNumUrls; ++i) {
+    for (int j = 0; j < kRequestsPerUrl; ++j) {
+      scoped_refptr<URLRequestThrottlerEntryInterface> entry =
+          manager.RegisterRequestUrl(urls[i]);
+      EXPECT_FALSE(entry->ShouldRejectRequest(0));
+    }
+  }
+  timer.Done();
+}
+
+}  // namespace
+
+}  // namespace net
@@ -116,6 +116,12 @@ class MockURLRequestThrottlerManager : public URLRequestThrottlerManager {
   // Method to use the garbage collecting method of URLRequestThrottlerManager.
   void DoGarbageCollectEntries() { GarbageCollectEntries(); }
 
+  // Method to use the incremental garbage collecting method of
+  // URLRequestThrottlerManager.
+  void DoGarbageCollectEntriesIfNecessary() {
+    GarbageCollectEntriesIfNecessary();
+  }
+
   // Returns the number of entries in the map.
   int GetNumberOfEntries() const { return GetNumberOfEntriesForTests(); }
 
@@ -423,6 +429,28 @@ TEST(URLRequestThrottlerManager, AreEntriesBeingCollected) {
   EXPECT_EQ(3, manager.GetNumberOfEntries());
 }
 
+TEST(URLRequestThrottlerManager, AreEntriesCollectedIncrementally) {
+  MockURLRequestThrottlerManager manager;
+
+  // Each new entry checks the least recently used ones.
+  for (int i = 0; i < 5; ++i)
+    manager.CreateEntry(true);  // true = Entry is outdated.
+  EXPECT_EQ(1, manager.GetNumberOfEntries());
+  manager.DoGarbageCollectEntriesIfNecessary();
+  EXPECT_EQ(0, manager.GetNumberOfEntries());
+
+  // Entries still in use are moved out of the way of the outdated one.
+  manager.CreateEntry(false);
+  manager.CreateEntry(false);
+  manager.CreateEntry(false);
+  manager.CreateEntry(true);
+  EXPECT_EQ(4, manager.GetNumberOfEntries());
+  manager.DoGarbageCollectEntriesIfNecessary();
+  EXPECT_EQ(4, manager.GetNumberOfEntries());
+  manager.DoGarbageCollectEntriesIfNecessary();
+  EXPECT_EQ(3, manager.GetNumberOfEntries());
+}
+
 TEST(URLRequestThrottlerManager, IsHostBeingRegistered) {
   MockURLRequestThrottlerManager manager;
 
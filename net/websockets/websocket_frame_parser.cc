@@ -0,0 +1,208 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/websockets/websocket_frame_parser.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace {
+
+const uint8 kFinalBit = 0x80;
+const uint8 kReserved1Bit = 0x40;
+const uint8 kReserved2Bit = 0x20;
+const uint8 kReserved3Bit = 0x10;
+const uint8 kOpCodeMask = 0x0F;
+const uint8 kMaskBit = 0x80;
+const uint8 kPayloadLengthMask = 0x7F;
+
+// Payload length values with a special meaning.
+const uint8 kPayloadLengthWithTwoByteExtendedLengthField = 126;
+const uint8 kPayloadLengthWithEightByteExtendedLengthField = 127;
+
+// Two bytes of flags and length, eight bytes of extended length, and the
+// masking key.
+const size_t kMaximumFrameHeaderSize =
+    2 + 8 + net::WebSocketFrameHeader::kMaskingKeyLength;
+
+}  // namespace
+
+namespace net {
+
+const WebSocketFrameHeader::OpCode WebSocketFrameHeader::kOpCodeContinuation =
+    0x0;
+const WebSocketFrameHeader::OpCode WebSocketFrameHeader::kOpCodeText = 0x1;
+const WebSocketFrameHeader::OpCode WebSocketFrameHeader::kOpCodeBinary = 0x2;
+const WebSocketFrameHeader::OpCode WebSocketFrameHeader::kOpCodeClose = 0x8;
+const WebSocketFrameHeader::OpCode WebSocketFrameHeader::kOpCodePing = 0x9;
+const WebSocketFrameHeader::OpCode WebSocketFrameHeader::kOpCodePong = 0xA;
+
+WebSocketFrameHeader::WebSocketFrameHeader()
+    : final(false),
+      reserved1(false),
+      reserved2(false),
+      reserved3(false),
+      opcode(kOpCodeContinuation),
+      masked(false),
+      payload_length(0) {
+  memset(masking_key, 0, sizeof(masking_key));
+}
+
+WebSocketFrameChunk::WebSocketFrameChunk()
+    : first_chunk(false),
+      final_chunk(false),
+      payload_offset(0) {
+}
+
+WebSocketFrameParser::WebSocketFrameParser()
+    : in_frame_(false),
+      payload_offset_(0),
+      failed_(false) {
+}
+
+WebSocketFrameParser::~WebSocketFrameParser() {
+}
+
+bool WebSocketFrameParser::Decode(
+    const char* data,
+    size_t length,
+    std::vector<WebSocketFrameChunk>* frame_chunks) {
+  if (failed_)
+    return false;
+
+  size_t pos = 0;
+  while (pos < length) {
+    if (!in_frame_) {
+      int header_size;
+      if (incomplete_header_.empty()) {
+        header_size = DecodeHeader(data + pos, length - pos);
+        if (header_size == 0) {
+          // The rest of |data| is the start of a header.
+          incomplete_header_.assign(data + pos, length - pos);
+          return true;
+        }
+        if (header_size > 0)
+          pos += header_size;
+      } else {
+        // Complete the header from the last call with the new data.
+        size_t old_size = incomplete_header_.size();
+        size_t appended = std::min(length - pos,
+                                   kMaximumFrameHeaderSize - old_size);
+        incomplete_header_.append(data + pos, appended);
+        header_size = DecodeHeader(incomplete_header_.data(),
+                                   incomplete_header_.size());
+        if (header_size == 0) {
+          DCHECK_EQ(length, pos + appended);
+          return true;
+        }
+        if (header_size > 0) {
+          DCHECK_GT(static_cast<size_t>(header_size), old_size);
+          pos += header_size - old_size;
+          incomplete_header_.clear();
+        }
+      }
+      if (header_size < 0) {
+        failed_ = true;
+        return false;
+      }
+
+      in_frame_ = true;
+      payload_offset_ = 0;
+      if (current_header_.payload_length == 0) {
+        // Frames without payload, e.g. most control frames, still get a
+        // chunk, so that the consumer sees them.
+        WebSocketFrameChunk chunk;
+        chunk.header = current_header_;
+        chunk.first_chunk = true;
+        chunk.final_chunk = true;
+        frame_chunks->push_back(chunk);
+        in_frame_ = false;
+      }
+      continue;
+    }
+
+    uint64 frame_remaining = current_header_.payload_length - payload_offset_;
+    size_t chunk_size = static_cast<size_t>(
+        std::min(frame_remaining, static_cast<uint64>(length - pos)));
+    WebSocketFrameChunk chunk;
+    chunk.header = current_header_;
+    chunk.first_chunk = payload_offset_ == 0;
+    chunk.final_chunk = chunk_size == frame_remaining;
+    chunk.payload_offset = payload_offset_;
+    chunk.data = base::StringPiece(data + pos, chunk_size);
+    frame_chunks->push_back(chunk);
+
+    pos += chunk_size;
+    payload_offset_ += chunk_size;
+    if (chunk.final_chunk)
+      in_frame_ = false;
+  }
+  return true;
+}
+
+int WebSocketFrameParser::DecodeHeader(const char* data, size_t length) {
+  if (length < 2)
+    return 0;
+
+  const uint8 first_byte = data[0];
+  const uint8 second_byte = data[1];
+  size_t header_size = 2;
+
+  WebSocketFrameHeader header;
+  header.final = (first_byte & kFinalBit) != 0;
+  header.reserved1 = (first_byte & kReserved1Bit) != 0;
+  header.reserved2 = (first_byte & kReserved2Bit) != 0;
+  header.reserved3 = (first_byte & kReserved3Bit) != 0;
+  header.opcode = first_byte & kOpCodeMask;
+  header.masked = (second_byte & kMaskBit) != 0;
+
+  uint64 payload_length = second_byte & kPayloadLengthMask;
+  size_t extended_length_size = 0;
+  if (payload_length == kPayloadLengthWithTwoByteExtendedLengthField)
+    extended_length_size = 2;
+  else if (payload_length == kPayloadLengthWithEightByteExtendedLengthField)
+    extended_length_size = 8;
+  if (extended_length_size) {
+    if (length < header_size + extended_length_size)
+      return 0;
+    payload_length = 0;
+    for (size_t i = 0; i < extended_length_size; ++i) {
+      payload_length = (payload_length << 8) |
+          static_cast<uint8>(data[header_size + i]);
+    }
+    header_size += extended_length_size;
+    // The most significant bit of a 64-bit length must be 0.
+    if (extended_length_size == 8 && (payload_length >> 63))
+      return -1;
+  }
+  header.payload_length = payload_length;
+
+  if (header.masked) {
+    if (length < header_size + WebSocketFrameHeader::kMaskingKeyLength)
+      return 0;
+    memcpy(header.masking_key, data + header_size,
+           WebSocketFrameHeader::kMaskingKeyLength);
+    header_size += WebSocketFrameHeader::kMaskingKeyLength;
+  }
+
+  current_header_ = header;
+  return static_cast<int>(header_size);
+}
+
+void UnmaskWebSocketFramePayload(const WebSocketFrameHeader& header,
+                                 uint64 payload_offset,
+                                 char* data,
+                                 size_t length) {
+  if (!header.masked)
+    return;
+  for (size_t i = 0; i < length; ++i) {
+    data[i] ^= header.masking_key[
+        (payload_offset + i) % WebSocketFrameHeader::kMaskingKeyLength];
+  }
+}
+
+}  // namespace net
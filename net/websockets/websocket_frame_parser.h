@@ -0,0 +1,110 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_WEBSOCKETS_WEBSOCKET_FRAME_PARSER_H_
+#define NET_WEBSOCKETS_WEBSOCKET_FRAME_PARSER_H_
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/string_piece.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// Header of a WebSocket frame, as defined in RFC 6455 section 5.2.
+struct NET_EXPORT WebSocketFrameHeader {
+  typedef int OpCode;
+  static const OpCode kOpCodeContinuation;
+  static const OpCode kOpCodeText;
+  static const OpCode kOpCodeBinary;
+  static const OpCode kOpCodeClose;
+  static const OpCode kOpCodePing;
+  static const OpCode kOpCodePong;
+
+  // Size of the masking key, in bytes.
+  static const size_t kMaskingKeyLength = 4;
+
+  WebSocketFrameHeader();
+
+  bool final;
+  bool reserved1;
+  bool reserved2;
+  bool reserved3;
+  OpCode opcode;
+  bool masked;
+  char masking_key[kMaskingKeyLength];
+  uint64 payload_length;
+};
+
+// A piece of a WebSocket frame's payload. A frame whose payload spans several
+// reads is handed out as several chunks.
+struct NET_EXPORT WebSocketFrameChunk {
+  WebSocketFrameChunk();
+
+  // The header of the frame this chunk belongs to.
+  WebSocketFrameHeader header;
+
+  // True for the first and last chunks of the frame, respectively. Both are
+  // true for a frame that is received in one piece.
+  bool first_chunk;
+  bool final_chunk;
+
+  // Offset of |data| from the start of the frame's payload.
+  uint64 payload_offset;
+
+  // The payload bytes, as a slice of the data passed to Decode(). It is only
+  // valid as long as that data is. If |header.masked|, the bytes are still
+  // masked; see UnmaskWebSocketFramePayload().
+  base::StringPiece data;
+};
+
+// Splits a stream of WebSocket data into frames. Payloads are not copied:
+// the parser only hands out slices of the data it is given, and buffers no
+// more than a partially received header between calls.
+class NET_EXPORT WebSocketFrameParser {
+ public:
+  WebSocketFrameParser();
+  ~WebSocketFrameParser();
+
+  // Decodes the next |length| bytes of the stream, appending the payload
+  // chunks found to |frame_chunks|. Returns false if the data is not a valid
+  // frame stream; the parser can't be used after that.
+  bool Decode(const char* data,
+              size_t length,
+              std::vector<WebSocketFrameChunk>* frame_chunks);
+
+  bool failed() const { return failed_; }
+
+ private:
+  // Parses the frame header at |data| into |current_header_|. Returns the
+  // size of the header, 0 if |length| bytes are not enough for the full
+  // header, or -1 if the header is invalid.
+  int DecodeHeader(const char* data, size_t length);
+
+  // Bytes of a header that was cut off at the end of the last Decode().
+  std::string incomplete_header_;
+
+  // The frame being parsed, if |in_frame_|.
+  bool in_frame_;
+  WebSocketFrameHeader current_header_;
+  uint64 payload_offset_;
+
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketFrameParser);
+};
+
+// Unmasks |length| bytes of a masked frame payload in place. |payload_offset|
+// is the offset of |data| from the start of the payload.
+NET_EXPORT void UnmaskWebSocketFramePayload(const WebSocketFrameHeader& header,
+                                            uint64 payload_offset,
+                                            char* data,
+                                            size_t length);
+
+}  // namespace net
+
+#endif  // NET_WEBSOCKETS_WEBSOCKET_FRAME_PARSER_H_
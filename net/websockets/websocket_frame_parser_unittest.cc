@@ -0,0 +1,115 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/websockets/websocket_frame_parser.h"
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const char kHelloFrame[] = "\x81\x05Hello";
+const size_t kHelloFrameLength = arraysize(kHelloFrame) - 1;
+
+// The masked frame example from RFC 6455 section 5.7.
+const char kMaskedHelloFrame[] =
+    "\x81\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58";
+const size_t kMaskedHelloFrameLength = arraysize(kMaskedHelloFrame) - 1;
+
+const char kPingFrame[] = "\x89\x00";
+const size_t kPingFrameLength = arraysize(kPingFrame) - 1;
+
+}  // namespace
+
+TEST(WebSocketFrameParserTest, DecodeFrameWithoutCopying) {
+  WebSocketFrameParser parser;
+  std::vector<WebSocketFrameChunk> chunks;
+  EXPECT_TRUE(parser.Decode(kHelloFrame, kHelloFrameLength, &chunks));
+  ASSERT_EQ(1U, chunks.size());
+
+  const WebSocketFrameChunk& chunk = chunks[0];
+  EXPECT_TRUE(chunk.first_chunk);
+  EXPECT_TRUE(chunk.final_chunk);
+  EXPECT_TRUE(chunk.header.final);
+  EXPECT_FALSE(chunk.header.masked);
+  EXPECT_EQ(WebSocketFrameHeader::kOpCodeText, chunk.header.opcode);
+  EXPECT_EQ(5U, chunk.header.payload_length);
+  EXPECT_EQ("Hello", chunk.data.as_string());
+  // The payload points into the decoded data.
+  EXPECT_EQ(kHelloFrame + 2, chunk.data.data());
+}
+
+TEST(WebSocketFrameParserTest, DecodeSeveralFrames) {
+  std::string data = std::string(kHelloFrame, kHelloFrameLength) +
+                     std::string(kPingFrame, kPingFrameLength) +
+                     std::string(kHelloFrame, kHelloFrameLength);
+  WebSocketFrameParser parser;
+  std::vector<WebSocketFrameChunk> chunks;
+  EXPECT_TRUE(parser.Decode(data.data(), data.size(), &chunks));
+  ASSERT_EQ(3U, chunks.size());
+  EXPECT_EQ("Hello", chunks[0].data.as_string());
+  EXPECT_EQ(WebSocketFrameHeader::kOpCodePing, chunks[1].header.opcode);
+  EXPECT_TRUE(chunks[1].first_chunk);
+  EXPECT_TRUE(chunks[1].final_chunk);
+  EXPECT_TRUE(chunks[1].data.empty());
+  EXPECT_EQ("Hello", chunks[2].data.as_string());
+}
+
+// Splitting the data anywhere, including inside the header, yields the same
+// payload.
+TEST(WebSocketFrameParserTest, DecodeSplitFrame) {
+  std::string payload(300, 'x');
+  std::string frame("\x82\x7e\x01\x2c", 4);  // Binary, 300 byte payload.
+  frame.append(payload);
+
+  for (size_t split = 0; split <= frame.size(); ++split) {
+    WebSocketFrameParser parser;
+    std::vector<WebSocketFrameChunk> chunks;
+    EXPECT_TRUE(parser.Decode(frame.data(), split, &chunks));
+    EXPECT_TRUE(parser.Decode(frame.data() + split, frame.size() - split,
+                              &chunks));
+
+    std::string decoded;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      EXPECT_EQ(i == 0, chunks[i].first_chunk);
+      EXPECT_EQ(i == chunks.size() - 1, chunks[i].final_chunk);
+      EXPECT_EQ(decoded.size(), chunks[i].payload_offset);
+      EXPECT_EQ(300U, chunks[i].header.payload_length);
+      decoded.append(chunks[i].data.data(), chunks[i].data.size());
+    }
+    EXPECT_EQ(payload, decoded) << "split at " << split;
+  }
+}
+
+TEST(WebSocketFrameParserTest, DecodeMaskedFrame) {
+  WebSocketFrameParser parser;
+  std::vector<WebSocketFrameChunk> chunks;
+  EXPECT_TRUE(parser.Decode(kMaskedHelloFrame, kMaskedHelloFrameLength,
+                            &chunks));
+  ASSERT_EQ(1U, chunks.size());
+  EXPECT_TRUE(chunks[0].header.masked);
+
+  std::string payload = chunks[0].data.as_string();
+  UnmaskWebSocketFramePayload(chunks[0].header, 0, &payload[0],
+                              payload.size());
+  EXPECT_EQ("Hello", payload);
+}
+
+TEST(WebSocketFrameParserTest, InvalidPayloadLength) {
+  // The most significant bit of a 64-bit length must be 0.
+  const char kFrame[] = "\x81\x7f\x80\x00\x00\x00\x00\x00\x00\x00";
+  WebSocketFrameParser parser;
+  std::vector<WebSocketFrameChunk> chunks;
+  EXPECT_FALSE(parser.Decode(kFrame, arraysize(kFrame) - 1, &chunks));
+  EXPECT_TRUE(parser.failed());
+  EXPECT_FALSE(parser.Decode(kHelloFrame, kHelloFrameLength, &chunks));
+  EXPECT_TRUE(chunks.empty());
+}
+
+}  // namespace net
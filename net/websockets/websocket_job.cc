@@ -114,7 +114,7 @@ bool WebSocketJob::SendData(const char* data, int len) {
           return true;
         }
         current_send_buffer_ = new DrainableIOBuffer(buffer.get(), len);
-        return SendDataInternal(current_send_buffer_->data(),
+        return SendDataInternal(current_send_buffer_,
                                 current_send_buffer_->BytesRemaining());
       }
 
@@ -622,11 +622,11 @@ void WebSocketJob::CompleteIO(int result) {
   }
 }
 
-bool WebSocketJob::SendDataInternal(const char* data, int length) {
+bool WebSocketJob::SendDataInternal(IOBuffer* data, int length) {
   if (spdy_websocket_stream_.get())
     return ERR_IO_PENDING == spdy_websocket_stream_->SendData(data, length);
   if (socket_.get())
-    return socket_->SendData(data, length);
+    return socket_->SendData(data->data(), length);
   return false;
 }
 
@@ -649,11 +649,35 @@ void WebSocketJob::SendPending() {
     return;
   }
 
+  // Batch the queued messages into a single write, so that a burst of small
+  // frames doesn't cost a socket write each.  The delegate never has more
+  // than kMaxPendingSendAllowed bytes pending, so neither does the batch.  It
+  // is told about the whole batch at once in OnSentData().
   scoped_refptr<IOBufferWithSize> next_buffer = send_buffer_queue_.front();
   send_buffer_queue_.pop_front();
+  size_t num_batched = 0;
+  int batch_size = next_buffer->size();
+  while (num_batched < send_buffer_queue_.size() &&
+         batch_size + send_buffer_queue_[num_batched]->size() <=
+             kMaxPendingSendAllowed) {
+    batch_size += send_buffer_queue_[num_batched]->size();
+    ++num_batched;
+  }
+  if (num_batched > 0) {
+    scoped_refptr<IOBufferWithSize> batch = new IOBufferWithSize(batch_size);
+    memcpy(batch->data(), next_buffer->data(), next_buffer->size());
+    int offset = next_buffer->size();
+    for (size_t i = 0; i < num_batched; ++i) {
+      memcpy(batch->data() + offset, send_buffer_queue_.front()->data(),
+             send_buffer_queue_.front()->size());
+      offset += send_buffer_queue_.front()->size();
+      send_buffer_queue_.pop_front();
+    }
+    next_buffer = batch;
+  }
   current_send_buffer_ = new DrainableIOBuffer(next_buffer,
                                                next_buffer->size());
-  SendDataInternal(current_send_buffer_->data(),
+  SendDataInternal(current_send_buffer_,
                    current_send_buffer_->BytesRemaining());
 }
 
@@ -8,19 +8,23 @@
 
 #include <limits>
 
+#include "base/stl_util.h"
+
 namespace ppapi {
 
 PluginArrayBufferVar::PluginArrayBufferVar(uint32 size_in_bytes)
-    : buffer_(size_in_bytes) {
+    : buffer_(size_in_bytes, '\0') {
+}
+
+PluginArrayBufferVar::PluginArrayBufferVar(std::string* data) {
+  buffer_.swap(*data);
 }
 
 PluginArrayBufferVar::~PluginArrayBufferVar() {
 }
 
 void* PluginArrayBufferVar::Map() {
-  if (buffer_.empty())
-    return NULL;
-  return &(buffer_[0]);
+  return string_as_array(&buffer_);
 }
 
 void PluginArrayBufferVar::Unmap() {
@@ -28,7 +32,7 @@ void PluginArrayBufferVar::Unmap() {
 }
 
 uint32 PluginArrayBufferVar::ByteLength() {
-  return buffer_.size();
+  return static_cast<uint32>(buffer_.size());
 }
 
 }  // namespace ppapi
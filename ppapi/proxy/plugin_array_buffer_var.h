@@ -5,7 +5,7 @@
 #ifndef PPAPI_PROXY_PLUGIN_ARRAY_BUFFER_VAR_H_
 #define PPAPI_PROXY_PLUGIN_ARRAY_BUFFER_VAR_H_
 
-#include <vector>
+#include <string>
 
 #include "base/basictypes.h"
 #include "ppapi/c/pp_stdint.h"
@@ -14,10 +14,12 @@
 namespace ppapi {
 
 // Represents a plugin-side ArrayBufferVar. In the plugin process, it's
-// owned as a vector.
+// owned as a string.
 class PluginArrayBufferVar : public ArrayBufferVar {
  public:
   explicit PluginArrayBufferVar(uint32 size_in_bytes);
+  // Takes the contents of |data| without copying them, leaving it empty.
+  explicit PluginArrayBufferVar(std::string* data);
   virtual ~PluginArrayBufferVar();
 
   // ArrayBufferVar implementation.
@@ -27,7 +29,7 @@ class PluginArrayBufferVar : public ArrayBufferVar {
 
  private:
   // TODO(dmichael): Use shared memory for this.
-  std::vector<uint8> buffer_;
+  std::string buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(PluginArrayBufferVar);
 };
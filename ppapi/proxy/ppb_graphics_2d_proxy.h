@@ -5,6 +5,8 @@
 #ifndef PPAPI_PPB_GRAPHICS_2D_PROXY_H_
 #define PPAPI_PPB_GRAPHICS_2D_PROXY_H_
 
+#include <vector>
+
 #include "ppapi/c/pp_bool.h"
 #include "ppapi/c/pp_completion_callback.h"
 #include "ppapi/c/pp_module.h"
@@ -23,6 +25,8 @@ struct PP_Rect;
 namespace ppapi {
 namespace proxy {
 
+struct PPBGraphics2D_Op;
+
 class PPB_Graphics2D_Proxy : public InterfaceProxy {
  public:
   PPB_Graphics2D_Proxy(Dispatcher* dispatcher);
@@ -43,18 +47,8 @@ class PPB_Graphics2D_Proxy : public InterfaceProxy {
                        const PP_Size& size,
                        PP_Bool is_always_opaque,
                        HostResource* result);
-  void OnHostMsgPaintImageData(const HostResource& graphics_2d,
-                               const HostResource& image_data,
-                               const PP_Point& top_left,
-                               bool src_rect_specified,
-                               const PP_Rect& src_rect);
-  void OnHostMsgScroll(const HostResource& graphics_2d,
-                       bool clip_specified,
-                       const PP_Rect& clip,
-                       const PP_Point& amount);
-  void OnHostMsgReplaceContents(const HostResource& graphics_2d,
-                                const HostResource& image_data);
-  void OnHostMsgFlush(const HostResource& graphics_2d);
+  void OnHostMsgFlush(const HostResource& graphics_2d,
+                      const std::vector<PPBGraphics2D_Op>& ops);
 
   // Host->plugin message handlers.
   void OnPluginMsgFlushACK(const HostResource& graphics_2d,
@@ -78,5 +78,16 @@ PPBFlash_DrawGlyphs_Params::PPBFlash_DrawGlyphs_Params()
 
 PPBFlash_DrawGlyphs_Params::~PPBFlash_DrawGlyphs_Params() {}
 
+PPBGraphics2D_Op::PPBGraphics2D_Op()
+    : type(PAINT_IMAGE_DATA),
+      rect_specified(false) {
+  point.x = 0;
+  point.y = 0;
+  rect.point.x = 0;
+  rect.point.y = 0;
+  rect.size.height = 0;
+  rect.size.width = 0;
+}
+
 }  // namespace proxy
 }  // namespace ppapi
@@ -109,6 +109,25 @@ struct PPPVideoCapture_Buffer {
   base::SharedMemoryHandle handle;
 };
 
+// A PPB_Graphics2D drawing call. The plugin queues these and sends them with
+// the Flush that makes them visible, so a frame costs one message.
+struct PPBGraphics2D_Op {
+  enum Type {
+    PAINT_IMAGE_DATA,
+    SCROLL,
+    REPLACE_CONTENTS
+  };
+
+  PPBGraphics2D_Op();
+
+  Type type;
+  ppapi::HostResource image_data;  // For PAINT_IMAGE_DATA and
+                                   // REPLACE_CONTENTS.
+  PP_Point point;  // The top left for PAINT_IMAGE_DATA, the amount for SCROLL.
+  bool rect_specified;
+  PP_Rect rect;  // The source rect for PAINT_IMAGE_DATA, the clip for SCROLL.
+};
+
 #if defined(OS_WIN)
 typedef HANDLE ImageHandle;
 #elif defined(OS_MACOSX) || defined(OS_ANDROID)
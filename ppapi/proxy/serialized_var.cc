@@ -248,8 +248,10 @@ void SerializedVar::Inner::ConvertRawVarData() {
       break;
     }
     case PP_VARTYPE_ARRAY_BUFFER: {
-      var_ = PpapiGlobals::Get()->GetVarTracker()->MakeArrayBufferPPVar(
-          raw_var_data_->data.size(), raw_var_data_->data.data());
+      // The bytes were already copied out of the message; hand them to the
+      // tracker rather than copying them again.
+      var_ = PpapiGlobals::Get()->GetVarTracker()->
+          SwapDataIntoArrayBufferPPVar(&raw_var_data_->data);
       break;
     }
     default:
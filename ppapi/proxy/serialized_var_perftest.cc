@@ -0,0 +1,67 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ppapi/proxy/ppapi_proxy_test.h"
+
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "ipc/ipc_message.h"
+#include "ppapi/proxy/ppapi_param_traits.h"
+#include "ppapi/proxy/serialized_var.h"
+#include "ppapi/shared_impl/proxy_lock.h"
+#include "ppapi/shared_impl/var.h"
+
+namespace ppapi {
+namespace proxy {
+
+namespace {
+
+// Bytes moved per payload size, so that every size does the same amount of
+// copying.
+const uint32 kTotalBytes = 256 * 1024 * 1024;
+
+class SerializedVarPerfTest : public PluginProxyTest {
+ public:
+  SerializedVarPerfTest() {}
+
+ protected:
+  // Sends ArrayBuffers of |size| bytes through messages the way PostMessage
+  // does, and receives them as input parameters on the other side.
+  void SendArrayBuffers(uint32 size) {
+    ProxyAutoLock lock;
+    PP_Var buffer = var_tracker().MakeArrayBufferPPVar(size);
+    ASSERT_EQ(PP_VARTYPE_ARRAY_BUFFER, buffer.type);
+
+    PerfTimeLogger timer(
+        base::StringPrintf("PPAPI_post_array_buffer_%u", size).c_str());
+    for (uint32 sent = 0; sent < kTotalBytes; sent += size) {
+      IPC::Message message;
+      IPC::ParamTraits<SerializedVar>::Write(
+          &message, SerializedVarSendInput(plugin_dispatcher(), buffer));
+
+      SerializedVar serialized;
+      PickleIterator iter(message);
+      ASSERT_TRUE(IPC::ParamTraits<SerializedVar>::Read(&message, &iter,
+                                                        &serialized));
+      SerializedVarReceiveInput receive_input(serialized);
+      PP_Var received = receive_input.Get(plugin_dispatcher());
+      ASSERT_EQ(size, ArrayBufferVar::FromPPVar(received)->ByteLength());
+    }
+    timer.Done();
+
+    var_tracker().ReleaseVar(buffer);
+  }
+};
+
+}  // namespace
+
+TEST_F(SerializedVarPerfTest, PostArrayBuffer) {
+  SendArrayBuffers(1024);
+  SendArrayBuffers(64 * 1024);
+  SendArrayBuffers(1024 * 1024);
+  SendArrayBuffers(16 * 1024 * 1024);
+}
+
+}  // namespace proxy
+}  // namespace ppapi
@@ -4,8 +4,13 @@
 
 #include "ppapi/proxy/ppapi_proxy_test.h"
 
+#include <string>
+
+#include "ipc/ipc_message.h"
+#include "ppapi/proxy/ppapi_param_traits.h"
 #include "ppapi/proxy/serialized_var.h"
 #include "ppapi/shared_impl/proxy_lock.h"
+#include "ppapi/shared_impl/var.h"
 
 namespace ppapi {
 namespace proxy {
@@ -344,5 +349,38 @@ TEST_F(SerializedVarTest, PluginReturnValue) {
   EXPECT_EQ(1u, sink().message_count());
 }
 
+// Tests sending an ArrayBuffer through a message and receiving it as an
+// input parameter.
+TEST_F(SerializedVarTest, PluginArrayBufferSendReceive) {
+  ProxyAutoLock lock;
+  const std::string kTestData("array buffer contents");
+  PP_Var plugin_buffer = var_tracker().MakeArrayBufferPPVar(
+      static_cast<uint32>(kTestData.size()), kTestData.data());
+
+  IPC::Message message;
+  IPC::ParamTraits<SerializedVar>::Write(
+      &message, SerializedVarSendInput(plugin_dispatcher(), plugin_buffer));
+  var_tracker().ReleaseVar(plugin_buffer);
+
+  SerializedVar serialized;
+  PickleIterator iter(message);
+  ASSERT_TRUE(IPC::ParamTraits<SerializedVar>::Read(&message, &iter,
+                                                    &serialized));
+  PP_Var received;
+  {
+    SerializedVarReceiveInput receive_input(serialized);
+    received = receive_input.Get(plugin_dispatcher());
+    EXPECT_EQ(1, var_tracker().GetRefCountForObject(received));
+
+    ArrayBufferVar* buffer_var = ArrayBufferVar::FromPPVar(received);
+    ASSERT_TRUE(buffer_var != NULL);
+    ASSERT_EQ(kTestData.size(), buffer_var->ByteLength());
+    EXPECT_EQ(kTestData, std::string(static_cast<char*>(buffer_var->Map()),
+                                     buffer_var->ByteLength()));
+  }
+  // The receive input released the only reference.
+  EXPECT_EQ(-1, var_tracker().GetRefCountForObject(received));
+}
+
 }  // namespace proxy
 }  // namespace ppapi
@@ -195,6 +195,15 @@ PP_Var VarTracker::MakeArrayBufferPPVar(uint32 size_in_bytes,
   return array_buffer->GetPPVar();
 }
 
+PP_Var VarTracker::SwapDataIntoArrayBufferPPVar(std::string* data) {
+  DCHECK(CalledOnValidThread());
+
+  scoped_refptr<ArrayBufferVar> array_buffer(CreateArrayBufferFromData(data));
+  if (!array_buffer)
+    return PP_MakeNull();
+  return array_buffer->GetPPVar();
+}
+
 std::vector<PP_Var> VarTracker::GetLiveVars() {
   DCHECK(CalledOnValidThread());
 
@@ -226,4 +235,13 @@ bool VarTracker::DeleteObjectInfoIfNecessary(VarMap::iterator iter) {
   return true;
 }
 
+ArrayBufferVar* VarTracker::CreateArrayBufferFromData(std::string* data) {
+  uint32 size_in_bytes = static_cast<uint32>(data->size());
+  ArrayBufferVar* array_buffer = CreateArrayBuffer(size_in_bytes);
+  if (array_buffer && size_in_bytes)
+    memcpy(array_buffer->Map(), data->data(), size_in_bytes);
+  data->clear();
+  return array_buffer;
+}
+
 }  // namespace ppapi
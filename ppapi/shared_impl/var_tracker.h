@@ -5,6 +5,7 @@
 #ifndef PPAPI_SHARED_IMPL_VAR_TRACKER_H_
 #define PPAPI_SHARED_IMPL_VAR_TRACKER_H_
 
+#include <string>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -71,6 +72,10 @@ class PPAPI_SHARED_EXPORT VarTracker
   PP_Var MakeArrayBufferPPVar(uint32 size_in_bytes);
   // Same as above, but copy the contents of |data| in to the new array buffer.
   PP_Var MakeArrayBufferPPVar(uint32 size_in_bytes, const void* data);
+  // Same as above, but takes the contents of |data|, leaving it empty. Where
+  // the tracker can adopt the string as the buffer's storage nothing is
+  // copied.
+  PP_Var SwapDataIntoArrayBufferPPVar(std::string* data);
 
   // Return a vector containing all PP_Vars that are in the tracker. This is
   // to help implement PPB_Testing_Dev.GetLiveVars and should generally not be
@@ -162,6 +167,10 @@ class PPAPI_SHARED_EXPORT VarTracker
   // a real WebKit ArrayBuffer on the host side.
   virtual ArrayBufferVar* CreateArrayBuffer(uint32 size_in_bytes) = 0;
 
+  // Create an ArrayBufferVar holding the contents of |data|. The default
+  // copies them into a buffer from CreateArrayBuffer().
+  virtual ArrayBufferVar* CreateArrayBufferFromData(std::string* data);
+
   DISALLOW_COPY_AND_ASSIGN(VarTracker);
 };
 
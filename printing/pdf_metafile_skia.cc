@@ -28,12 +28,18 @@
 namespace printing {
 
 struct PdfMetafileSkiaData {
+  PdfMetafileSkiaData() : draft_mode_(false) {}
+  explicit PdfMetafileSkiaData(SkPDFDocument::Flags flags)
+      : pdf_doc_(flags),
+        draft_mode_((flags & SkPDFDocument::kDraftMode_Flags) != 0) {}
+
   SkRefPtr<SkPDFDevice> current_page_;
   SkPDFDocument pdf_doc_;
   SkDynamicMemoryWStream pdf_stream_;
 #if defined(OS_MACOSX)
   PdfMetafileCg pdf_cg_;
 #endif
+  bool draft_mode_;
 };
 
 PdfMetafileSkia::~PdfMetafileSkia() {}
@@ -94,6 +100,11 @@ bool PdfMetafileSkia::FinishDocument() {
 
   data_->current_page_ = NULL;
 
+  // The pages of draft documents are also in the print ready document, whose
+  // fonts are counted.
+  if (data_->draft_mode_)
+    return data_->pdf_doc_.emitPDF(&data_->pdf_stream_);
+
   int font_counts[SkAdvancedTypefaceMetrics::kNotEmbeddable_Font + 1];
   data_->pdf_doc_.getCountOfFontTypes(font_counts);
   for (int type = 0;
@@ -229,6 +240,11 @@ PdfMetafileSkia::PdfMetafileSkia()
       page_outstanding_(false) {
 }
 
+PdfMetafileSkia::PdfMetafileSkia(PdfMetafileSkiaData* data)
+    : data_(data),
+      page_outstanding_(false) {
+}
+
 PdfMetafileSkia* PdfMetafileSkia::GetMetafileForCurrentPage() {
   SkPDFDocument pdf_doc(SkPDFDocument::kDraftMode_Flags);
   SkDynamicMemoryWStream pdf_stream;
@@ -247,4 +263,15 @@ PdfMetafileSkia* PdfMetafileSkia::GetMetafileForCurrentPage() {
   return metafile;
 }
 
+PdfMetafileSkia* PdfMetafileSkia::GetUnfinishedMetafileForCurrentPage() {
+  PdfMetafileSkiaData* data =
+      new PdfMetafileSkiaData(SkPDFDocument::kDraftMode_Flags);
+  PdfMetafileSkia* metafile = new PdfMetafileSkia(data);
+  if (!data->pdf_doc_.appendPage(data_->current_page_.get())) {
+    delete metafile;
+    return NULL;
+  }
+  return metafile;
+}
+
 }  // namespace printing
@@ -73,7 +73,15 @@ class PRINTING_EXPORT PdfMetafileSkia : public Metafile {
   // Return a new metafile containing just the current page in draft mode.
   PdfMetafileSkia* GetMetafileForCurrentPage();
 
+  // Like GetMetafileForCurrentPage(), but the page is only serialized by
+  // FinishDocument() on the returned metafile. That may run on another thread
+  // while this metafile renders the next pages, but not while this metafile
+  // is finished.
+  PdfMetafileSkia* GetUnfinishedMetafileForCurrentPage();
+
  private:
+  explicit PdfMetafileSkia(PdfMetafileSkiaData* data);
+
   scoped_ptr<PdfMetafileSkiaData> data_;
 
   // True when finish page is outstanding for current page.
@@ -0,0 +1,63 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "printing/pdf_metafile_skia.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/size.h"
+
+namespace printing {
+
+namespace {
+
+void FinishDocument(PdfMetafileSkia* metafile, bool* success) {
+  *success = metafile->FinishDocument();
+}
+
+std::string GetData(const PdfMetafileSkia& metafile) {
+  std::vector<char> data(metafile.GetDataSize());
+  if (data.empty() || !metafile.GetData(&data[0], data.size()))
+    return std::string();
+  return std::string(data.begin(), data.end());
+}
+
+}  // namespace
+
+TEST(PdfMetafileSkiaTest, UnfinishedMetafileForCurrentPage) {
+  PdfMetafileSkia metafile;
+  ASSERT_TRUE(metafile.Init());
+  gfx::Size page_size(612, 792);
+  ASSERT_TRUE(metafile.StartPageForVectorCanvas(
+      page_size, gfx::Rect(page_size), 1.0f));
+
+  scoped_ptr<PdfMetafileSkia> draft(
+      metafile.GetUnfinishedMetafileForCurrentPage());
+  ASSERT_TRUE(draft.get());
+  EXPECT_EQ(0u, draft->GetDataSize());
+
+  // Print preview serializes the draft on another thread, while the next
+  // page renders.
+  bool success = false;
+  base::Thread thread("PdfMetafileSkiaTest");
+  ASSERT_TRUE(thread.Start());
+  thread.message_loop()->PostTask(
+      FROM_HERE, base::Bind(&FinishDocument, draft.get(), &success));
+  thread.Stop();
+  EXPECT_TRUE(success);
+  EXPECT_EQ(0u, GetData(*draft).find("%PDF"));
+
+  // The page is still in the document.
+  EXPECT_TRUE(metafile.FinishPage());
+  EXPECT_TRUE(metafile.FinishDocument());
+  EXPECT_EQ(0u, GetData(metafile).find("%PDF"));
+}
+
+}  // namespace printing
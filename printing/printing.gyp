@@ -206,6 +206,7 @@
         'page_range_unittest.cc',
         'page_setup_unittest.cc',
         'pdf_metafile_cg_mac_unittest.cc',
+        'pdf_metafile_skia_unittest.cc',
         'printed_page_unittest.cc',
         'run_all_unittests.cc',
         'units_unittest.cc',
@@ -214,6 +215,11 @@
         ['toolkit_uses_gtk == 0', {'sources/': [['exclude', '_gtk_unittest\\.cc$']]}],
         ['OS!="mac"', {'sources/': [['exclude', '_mac_unittest\\.(cc|mm?)$']]}],
         ['OS!="win"', {'sources/': [['exclude', '_win_unittest\\.cc$']]}],
+        ['OS=="mac" and use_skia==0', {
+          'sources/': [
+            ['exclude', 'pdf_metafile_skia_unittest\\.cc$'],
+          ],
+        }],
         ['OS=="win" and use_aura == 0', {
           'sources': [
             'printing_context_win_unittest.cc',
@@ -4,6 +4,8 @@
 
 #include "remoting/base/encoder_vp8.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/sys_info.h"
 #include "media/base/yuv_convert.h"
@@ -23,7 +25,34 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
-}  // namespace remoting
+// Screens with more pixels than this (1080p) are encoded with up to
+// |kMaxThreadsLargeScreen| threads; smaller ones with at most two.
+const int kLargeScreenPixels = 1920 * 1080;
+const int kMaxThreadsLargeScreen = 4;
+
+// Returns the number of encoder threads to use for a screen of |size|.
+int GetEncoderThreadCount(const SkISize& size) {
+  // Going to multiple threads on low end windows systems can really hurt
+  // performance. http://crbug.com/99179
+  int processors = base::SysInfo::NumberOfProcessors();
+  if (processors <= 2)
+    return 1;
+  if (size.width() * size.height() > kLargeScreenPixels)
+    return std::min(processors / 2, kMaxThreadsLargeScreen);
+  return 2;
+}
+
+// Returns the token partition setting that lets each of |threads| threads
+// pack its own partition.
+vp8e_token_partitions GetTokenPartitions(int threads) {
+  if (threads >= 4)
+    return VP8_FOUR_TOKENPARTITION;
+  if (threads >= 2)
+    return VP8_TWO_TOKENPARTITION;
+  return VP8_ONE_TOKENPARTITION;
+}
+
+}  // namespace
 
 namespace remoting {
 
@@ -125,10 +154,8 @@ bool EncoderVp8::Init(const SkISize& size) {
   config.g_profile = 2;
 
   // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
+  // adequate processing power, and large screens need more to keep up.
+  config.g_threads = GetEncoderThreadCount(size);
   config.rc_min_quantizer = 20;
   config.rc_max_quantizer = 30;
   config.g_timebase.num = 1;
@@ -146,6 +173,13 @@ bool EncoderVp8::Init(const SkISize& size) {
   // on motion estimation and inter-prediction mode.
   if (vpx_codec_control(codec_.get(), VP8E_SET_NOISE_SENSITIVITY, 0))
     return false;
+
+  // Without multiple token partitions the threads serialize on packing the
+  // bitstream.
+  if (vpx_codec_control(codec_.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        GetTokenPartitions(config.g_threads))) {
+    return false;
+  }
   return true;
 }
 
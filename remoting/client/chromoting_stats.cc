@@ -19,6 +19,7 @@ namespace remoting {
 ChromotingStats::ChromotingStats()
     : video_bandwidth_(base::TimeDelta::FromSeconds(kTimeWindow)),
       video_frame_rate_(base::TimeDelta::FromSeconds(kTimeWindow)),
+      video_paint_rate_(base::TimeDelta::FromSeconds(kTimeWindow)),
       video_capture_ms_(kLatencyWindow),
       video_encode_ms_(kLatencyWindow),
       video_decode_ms_(kLatencyWindow),
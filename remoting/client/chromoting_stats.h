@@ -20,6 +20,9 @@ class ChromotingStats {
 
   RateCounter* video_bandwidth() { return &video_bandwidth_; }
   RateCounter* video_frame_rate() { return &video_frame_rate_; }
+  // Rate at which updates are flushed to the screen. Updates are merged when
+  // flushing can't keep up, so this drops below the rate frames arrive at.
+  RateCounter* video_paint_rate() { return &video_paint_rate_; }
   RunningAverage* video_capture_ms() { return &video_capture_ms_; }
   RunningAverage* video_encode_ms() { return &video_encode_ms_; }
   RunningAverage* video_decode_ms() { return &video_decode_ms_; }
@@ -29,6 +32,7 @@ class ChromotingStats {
  private:
   RateCounter video_bandwidth_;
   RateCounter video_frame_rate_;
+  RateCounter video_paint_rate_;
   RunningAverage video_capture_ms_;
   RunningAverage video_encode_ms_;
   RunningAverage video_decode_ms_;
@@ -333,6 +333,7 @@ void PepperView::OnFlushDone(base::Time paint_start,
 
   instance_->GetStats()->video_paint_ms()->Record(
       (base::Time::Now() - paint_start).InMilliseconds());
+  instance_->GetStats()->video_paint_rate()->Record(1);
 
   flush_pending_ = false;
   ReturnBuffer(buffer);
@@ -0,0 +1,102 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "remoting/base/capture_data.h"
+#include "remoting/base/encoder_vp8.h"
+#include "remoting/host/capturer_fake.h"
+#include "remoting/proto/video.pb.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace remoting {
+
+namespace {
+
+const int kBytesPerPixel = 4;
+const int kFrameCount = 50;
+
+class CaptureEncodePerfTest : public testing::Test {
+ protected:
+  CaptureEncodePerfTest() : encoded_bytes_(0) {}
+
+  void OnCaptureCompleted(scoped_refptr<CaptureData> capture_data) {
+    encoder_.Encode(capture_data, false,
+                    base::Bind(&CaptureEncodePerfTest::OnEncoded,
+                               base::Unretained(this)));
+  }
+
+  void OnEncoded(scoped_ptr<VideoPacket> packet) {
+    encoded_bytes_ += packet->data().size();
+  }
+
+  // Encodes |kFrameCount| synthetic frames of |width| x |height| in which a
+  // |dirty_size| square moves across the screen, as when a window is
+  // dragged. A |dirty_size| of 0 dirties the whole screen every frame.
+  void EncodeSyntheticFrames(int width, int height, int dirty_size) {
+    std::vector<uint8> buffer(width * height * kBytesPerPixel);
+    DataPlanes planes;
+    planes.data[0] = &buffer.front();
+    planes.strides[0] = width * kBytesPerPixel;
+
+    std::string name = base::StringPrintf(
+        "Remoting_encode_%dx%d_dirty_%d", width, height, dirty_size);
+    PerfTimeLogger timer(name.c_str());
+    for (int i = 0; i < kFrameCount; ++i) {
+      SkIRect dirty = SkIRect::MakeWH(width, height);
+      if (dirty_size) {
+        dirty = SkIRect::MakeXYWH((i * 37) % (width - dirty_size),
+                                  (i * 23) % (height - dirty_size),
+                                  dirty_size, dirty_size);
+      }
+      for (int y = dirty.fTop; y < dirty.fBottom; ++y) {
+        memset(&buffer[(y * width + dirty.fLeft) * kBytesPerPixel], i * 5,
+               dirty.width() * kBytesPerPixel);
+      }
+
+      scoped_refptr<CaptureData> capture_data(new CaptureData(
+          planes, SkISize::Make(width, height), media::VideoFrame::RGB32));
+      capture_data->mutable_dirty_region().setRect(dirty);
+      OnCaptureCompleted(capture_data);
+    }
+    timer.Done();
+  }
+
+  EncoderVp8 encoder_;
+  size_t encoded_bytes_;
+};
+
+}  // namespace
+
+// Times the whole capture-to-encode path with the fake capturer.
+TEST_F(CaptureEncodePerfTest, FakeCapturer) {
+  CapturerFake capturer;
+  capturer.Start();
+
+  PerfTimeLogger timer("Remoting_capture_encode_fake");
+  for (int i = 0; i < kFrameCount; ++i) {
+    capturer.CaptureInvalidRegion(
+        base::Bind(&CaptureEncodePerfTest::OnCaptureCompleted,
+                   base::Unretained(this)));
+  }
+  timer.Done();
+
+  capturer.Stop();
+  EXPECT_GT(encoded_bytes_, 0u);
+}
+
+// Large screens, with everything or only a small area changing. The latter
+// shows what the active map saves.
+TEST_F(CaptureEncodePerfTest, LargeScreens) {
+  EncodeSyntheticFrames(1920, 1080, 0);
+  EncodeSyntheticFrames(1920, 1080, 256);
+  EncodeSyntheticFrames(3840, 2160, 0);
+  EncodeSyntheticFrames(3840, 2160, 256);
+  EXPECT_GT(encoded_bytes_, 0u);
+}
+
+}  // namespace remoting
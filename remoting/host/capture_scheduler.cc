@@ -24,6 +24,9 @@ const int64 kMinimumRecordingDelay = 50;
 // available while 1 means using 100% of all CPUs available.
 const double kRecordingCpuConsumption = 0.5;
 
+// Maximum number of frames that can be processed simultaneously.
+const int kMaxPendingFrames = 2;
+
 }  // namespace
 
 namespace remoting {
@@ -32,7 +35,8 @@ namespace remoting {
 CaptureScheduler::CaptureScheduler()
     : num_of_processors_(base::SysInfo::NumberOfProcessors()),
       capture_time_(kStatisticsWindow),
-      encode_time_(kStatisticsWindow) {
+      encode_time_(kStatisticsWindow),
+      send_time_(kStatisticsWindow) {
   DCHECK(num_of_processors_);
 }
 
@@ -52,6 +56,17 @@ base::TimeDelta CaptureScheduler::NextCaptureDelay() {
   return base::TimeDelta::FromMilliseconds(delay);
 }
 
+int CaptureScheduler::MaxPendingFrames() {
+  // A second frame in flight keeps the network busy while the next frame is
+  // captured and encoded. But when sending takes longer than capturing and
+  // encoding, that frame only waits for the network and is stale by the time
+  // it is sent. In that case capture the next frame once the previous one has
+  // been sent, so that it shows the newest screen contents.
+  if (send_time_.Average() > capture_time_.Average() + encode_time_.Average())
+    return 1;
+  return kMaxPendingFrames;
+}
+
 void CaptureScheduler::RecordCaptureTime(base::TimeDelta capture_time) {
   capture_time_.Record(capture_time.InMilliseconds());
 }
@@ -60,4 +75,8 @@ void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time) {
   encode_time_.Record(encode_time.InMilliseconds());
 }
 
+void CaptureScheduler::RecordSendTime(base::TimeDelta send_time) {
+  send_time_.Record(send_time.InMilliseconds());
+}
+
 }  // namespace remoting
@@ -4,7 +4,8 @@
 
 // This class chooses a capture interval so as to limit CPU usage to not exceed
 // a specified %age. It bases this on the CPU usage of recent capture and encode
-// operations, and on the number of available CPUs.
+// operations, and on the number of available CPUs. It also decides how many
+// frames may be in the capture/encode/send pipeline at once.
 
 #ifndef REMOTING_HOST_CAPTURE_SCHEDULER_H_
 #define REMOTING_HOST_CAPTURE_SCHEDULER_H_
@@ -22,14 +23,20 @@ class CaptureScheduler {
   // Determine the time delay from current time to perform next capture.
   base::TimeDelta NextCaptureDelay();
 
-  // Record time spent on capturing and encoding.
+  // Returns the number of frames that may be captured, encoded or sent at
+  // the same time.
+  int MaxPendingFrames();
+
+  // Record time spent on capturing, encoding and sending.
   void RecordCaptureTime(base::TimeDelta capture_time);
   void RecordEncodeTime(base::TimeDelta encode_time);
+  void RecordSendTime(base::TimeDelta send_time);
 
  private:
   int num_of_processors_;
   RunningAverage capture_time_;
   RunningAverage encode_time_;
+  RunningAverage send_time_;
 
   DISALLOW_COPY_AND_ASSIGN(CaptureScheduler);
 };
@@ -0,0 +1,39 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "remoting/host/capture_scheduler.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace remoting {
+
+static void RecordFrame(CaptureScheduler* scheduler,
+                        int capture_ms, int encode_ms, int send_ms) {
+  scheduler->RecordCaptureTime(base::TimeDelta::FromMilliseconds(capture_ms));
+  scheduler->RecordEncodeTime(base::TimeDelta::FromMilliseconds(encode_ms));
+  scheduler->RecordSendTime(base::TimeDelta::FromMilliseconds(send_ms));
+}
+
+TEST(CaptureSchedulerTest, PipelinesWhenNetworkKeepsUp) {
+  CaptureScheduler scheduler;
+  EXPECT_EQ(2, scheduler.MaxPendingFrames());
+
+  for (int i = 0; i < 5; ++i)
+    RecordFrame(&scheduler, 10, 30, 20);
+  EXPECT_EQ(2, scheduler.MaxPendingFrames());
+}
+
+TEST(CaptureSchedulerTest, StopsPipeliningWhenNetworkBound) {
+  CaptureScheduler scheduler;
+  for (int i = 0; i < 5; ++i)
+    RecordFrame(&scheduler, 10, 30, 400);
+  EXPECT_EQ(1, scheduler.MaxPendingFrames());
+
+  // Back to pipelining once the link recovers.
+  for (int i = 0; i < 5; ++i)
+    RecordFrame(&scheduler, 10, 30, 20);
+  EXPECT_EQ(2, scheduler.MaxPendingFrames());
+}
+
+}  // namespace remoting
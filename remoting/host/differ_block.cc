@@ -27,9 +27,11 @@ int BlockDifference(const uint8* image1, const uint8* image2, int stride) {
 
   if (!diff_proc) {
 #if defined(ARCH_CPU_ARM_FAMILY)
-    // For ARM processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
+#if defined(__ARM_NEON__)
+    diff_proc = &BlockDifference_NEON;
+#else
     diff_proc = &BlockDifference_C;
+#endif
 #else
     // For x86 processors, check if SSE2 is supported.
     if (media::hasSSE2() && kBlockSize == 32)
@@ -2,13 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-// This header file is used only differ_block.h. It defines the SSE2 rountines
-// for finding block difference.
+// This header file is used only differ_block.h. It defines the SSE2 and NEON
+// rountines for finding block difference.
 
 #ifndef REMOTING_HOST_DIFFER_BLOCK_INTERNAL_H_
 #define REMOTING_HOST_DIFFER_BLOCK_INTERNAL_H_
 
 #include "base/basictypes.h"
+#include "build/build_config.h"
 
 namespace remoting {
 
@@ -20,6 +21,12 @@ extern int BlockDifference_SSE2_W16(const uint8* image1, const uint8* image2,
 extern int BlockDifference_SSE2_W32(const uint8* image1, const uint8* image2,
                                     int stride);
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+// Find block difference of dimension |kBlockSize|x|kBlockSize|.
+extern int BlockDifference_NEON(const uint8* image1, const uint8* image2,
+                                int stride);
+#endif
+
 }  // namespace remoting
 
 #endif  // REMOTING_HOST_DIFFER_BLOCK_INTERNAL_H_
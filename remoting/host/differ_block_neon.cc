@@ -0,0 +1,32 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "remoting/host/differ_block.h"
+#include "remoting/host/differ_block_internal.h"
+
+namespace remoting {
+
+int BlockDifference_NEON(const uint8* image1, const uint8* image2,
+                         int stride) {
+  const int kBytesPerRow = kBlockSize * kBytesPerPixel;
+  for (int y = 0; y < kBlockSize; ++y) {
+    // OR together the XOR of every 16 byte chunk in the row; any set bit
+    // means the rows differ.
+    uint8x16_t acc = vdupq_n_u8(0);
+    for (int x = 0; x < kBytesPerRow; x += 16)
+      acc = vorrq_u8(acc, veorq_u8(vld1q_u8(image1 + x), vld1q_u8(image2 + x)));
+
+    uint64x2_t acc64 = vreinterpretq_u64_u8(acc);
+    uint64x1_t diff = vorr_u64(vget_low_u64(acc64), vget_high_u64(acc64));
+    if (vget_lane_u64(diff, 0))
+      return 1;
+    image1 += stride;
+    image2 += stride;
+  }
+  return 0;
+}
+
+}  // namespace remoting
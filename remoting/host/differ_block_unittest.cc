@@ -4,6 +4,7 @@
 
 #include "base/memory/ref_counted.h"
 #include "remoting/host/differ_block.h"
+#include "remoting/host/differ_block_internal.h"
 #include "testing/gmock/include/gmock/gmock.h"
 
 namespace remoting {
@@ -78,4 +79,24 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+TEST(BlockDifferenceTestNEON, BlockDifference) {
+  uint8* block1;
+  uint8* block2;
+  PrepareBuffers(block1, block2);
+  EXPECT_EQ(0, BlockDifference_NEON(block1, block2,
+                                    kBlockSize * kBytesPerPixel));
+
+  // A change to any byte, including the last in a row, must be detected.
+  const int kOffsets[] = { 0, 15, kBlockSize * kBytesPerPixel - 1,
+                           kSizeOfBlock / 2 + 1, kSizeOfBlock - 1 };
+  for (size_t i = 0; i < arraysize(kOffsets); ++i) {
+    block2[kOffsets[i]] += 1;
+    EXPECT_EQ(1, BlockDifference_NEON(block1, block2,
+                                      kBlockSize * kBytesPerPixel));
+    block2[kOffsets[i]] -= 1;
+  }
+}
+#endif  // defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+
 }  // namespace remoting
@@ -26,10 +26,6 @@ using remoting::protocol::ConnectionToClient;
 
 namespace remoting {
 
-// Maximum number of frames that can be processed similtaneously.
-// TODO(hclam): Move this value to CaptureScheduler.
-static const int kMaxRecordings = 2;
-
 ScreenRecorder::ScreenRecorder(
     MessageLoop* capture_loop,
     MessageLoop* encode_loop,
@@ -43,7 +39,6 @@ ScreenRecorder::ScreenRecorder(
       encoder_(encoder),
       network_stopped_(false),
       encoder_stopped_(false),
-      max_recordings_(kMaxRecordings),
       recordings_(0),
       frame_skipped_(false),
       sequence_number_(0) {
@@ -160,10 +155,10 @@ void ScreenRecorder::StartCaptureTimer() {
 
 void ScreenRecorder::DoCapture() {
   DCHECK_EQ(capture_loop_, MessageLoop::current());
-  // Make sure we have at most two oustanding recordings. We can simply return
-  // if we can't make a capture now, the next capture will be started by the
-  // end of an encode operation.
-  if (recordings_ >= max_recordings_ || !is_recording()) {
+  // Make sure we have at most as many outstanding recordings as the scheduler
+  // allows. We can simply return if we can't make a capture now, the next
+  // capture will be started once a frame has been sent.
+  if (recordings_ >= scheduler_.MaxPendingFrames() || !is_recording()) {
     frame_skipped_ = true;
     return;
   }
@@ -173,7 +168,6 @@ void ScreenRecorder::DoCapture() {
 
   // At this point we are going to perform one capture so save the current time.
   ++recordings_;
-  DCHECK_LE(recordings_, max_recordings_);
 
   // Before doing a capture schedule for the next one.
   capture_timer_->Stop();
@@ -214,12 +208,14 @@ void ScreenRecorder::CaptureDoneCallback(
       FROM_HERE, base::Bind(&ScreenRecorder::DoEncode, this, capture_data));
 }
 
-void ScreenRecorder::DoFinishOneRecording() {
+void ScreenRecorder::DoFinishOneRecording(base::TimeDelta send_time) {
   DCHECK_EQ(capture_loop_, MessageLoop::current());
 
   if (!is_recording())
     return;
 
+  scheduler_.RecordSendTime(send_time);
+
   // Decrement the number of recording in process since we have completed
   // one cycle.
   --recordings_;
@@ -247,7 +243,8 @@ void ScreenRecorder::DoSendVideoPacket(scoped_ptr<VideoPacket> packet) {
 
   base::Closure callback;
   if ((packet->flags() & VideoPacket::LAST_PARTITION) != 0)
-    callback = base::Bind(&ScreenRecorder::VideoFrameSentCallback, this);
+    callback = base::Bind(&ScreenRecorder::VideoFrameSentCallback, this,
+                          base::Time::Now());
 
   // TODO(sergeyu): Currently we send the data only to the first
   // connection. Send it to all connections if necessary.
@@ -255,14 +252,15 @@ void ScreenRecorder::DoSendVideoPacket(scoped_ptr<VideoPacket> packet) {
       packet.Pass(), callback);
 }
 
-void ScreenRecorder::VideoFrameSentCallback() {
+void ScreenRecorder::VideoFrameSentCallback(base::Time send_start_time) {
   DCHECK(network_loop_->BelongsToCurrentThread());
 
   if (network_stopped_)
     return;
 
   capture_loop_->PostTask(
-      FROM_HERE, base::Bind(&ScreenRecorder::DoFinishOneRecording, this));
+      FROM_HERE, base::Bind(&ScreenRecorder::DoFinishOneRecording, this,
+                            base::Time::Now() - send_start_time));
 }
 
 void ScreenRecorder::DoStopOnNetworkThread(const base::Closure& done_task) {
@@ -1551,6 +1551,11 @@
             'differ_block_sse2',
           ],
         }],
+        [ 'target_arch == "arm" and arm_neon == 1', {
+          'sources': [
+            'host/differ_block_neon.cc',
+          ],
+        }],
       ],
       'sources': [
         'host/differ_block.cc',
@@ -1611,6 +1616,7 @@
         'base/base_mock_objects.h',
         'base/util_unittest.cc',
         'client/key_event_mapper_unittest.cc',
+        'host/capture_scheduler_unittest.cc',
 	'host/capturer_helper_unittest.cc',
         'host/capturer_linux_unittest.cc',
         'host/capturer_mac_unittest.cc',
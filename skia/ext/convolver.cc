@@ -723,6 +723,21 @@ void BGRAConvolve2D(const unsigned char* source_data,
                     int output_byte_row_stride,
                     unsigned char* output,
                     bool use_sse2) {
+  BGRAConvolve2DRows(source_data, source_byte_row_stride, source_has_alpha,
+                     filter_x, filter_y, 0, filter_y.num_values(),
+                     output_byte_row_stride, output, use_sse2);
+}
+
+void BGRAConvolve2DRows(const unsigned char* source_data,
+                        int source_byte_row_stride,
+                        bool source_has_alpha,
+                        const ConvolutionFilter1D& filter_x,
+                        const ConvolutionFilter1D& filter_y,
+                        int first_output_row,
+                        int end_output_row,
+                        int output_byte_row_stride,
+                        unsigned char* output,
+                        bool use_sse2) {
 #if !defined(SIMD_SSE2)
   // Even we have runtime support for SSE2 instructions, since the binary
   // was not built with SSE2 support, we had to fallback to C version.
@@ -738,7 +753,8 @@ void BGRAConvolve2D(const unsigned char* source_data,
   // row for convolution as the first pixel for the first vertical filter.
   int filter_offset, filter_length;
   const ConvolutionFilter1D::Fixed* filter_values =
-      filter_y.FilterForValue(0, &filter_offset, &filter_length);
+      filter_y.FilterForValue(first_output_row, &filter_offset,
+                              &filter_length);
   int next_x_row = filter_offset;
 
   // We loop over each row in the input doing a horizontal convolution. This
@@ -760,15 +776,18 @@ void BGRAConvolve2D(const unsigned char* source_data,
   // Loop over every possible output row, processing just enough horizontal
   // convolutions to run each subsequent vertical convolution.
   SkASSERT(output_byte_row_stride >= filter_x.num_values() * 4);
-  int num_output_rows = filter_y.num_values();
+  SkASSERT(0 <= first_output_row && first_output_row < end_output_row &&
+           end_output_row <= filter_y.num_values());
 
   // We need to check which is the last line to convolve before we advance 4
-  // lines in one iteration.
+  // lines in one iteration. This is the last line of the whole image, not of
+  // this band: reading past it is what must be avoided, and lines converted
+  // beyond the band are simply never used.
   int last_filter_offset, last_filter_length;
-  filter_y.FilterForValue(num_output_rows - 1, &last_filter_offset,
+  filter_y.FilterForValue(filter_y.num_values() - 1, &last_filter_offset,
                           &last_filter_length);
 
-  for (int out_y = 0; out_y < num_output_rows; out_y++) {
+  for (int out_y = first_output_row; out_y < end_output_row; out_y++) {
     filter_values = filter_y.FilterForValue(out_y,
                                             &filter_offset, &filter_length);
 
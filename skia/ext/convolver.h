@@ -168,6 +168,20 @@ SK_API void BGRAConvolve2D(const unsigned char* source_data,
                            int output_byte_row_stride,
                            unsigned char* output,
                            bool use_sse2);
+
+// Same as BGRAConvolve2D, but only computes output rows [|first_output_row|,
+// |end_output_row|). |output| still points at output row 0. Disjoint bands
+// of the same image may be computed concurrently.
+SK_API void BGRAConvolve2DRows(const unsigned char* source_data,
+                               int source_byte_row_stride,
+                               bool source_has_alpha,
+                               const ConvolutionFilter1D& xfilter,
+                               const ConvolutionFilter1D& yfilter,
+                               int first_output_row,
+                               int end_output_row,
+                               int output_byte_row_stride,
+                               unsigned char* output,
+                               bool use_sse2);
 }  // namespace skia
 
 #endif  // SKIA_EXT_CONVOLVER_H_
@@ -10,10 +10,17 @@
 #include "skia/ext/image_operations.h"
 
 // TODO(pkasting): skia/ext should not depend on base/!
+#include "base/bind.h"
 #include "base/debug/trace_event.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/metrics/histogram.h"
 #include "base/stack_container.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
 #include "base/time.h"
 #include "build/build_config.h"
 #include "skia/ext/convolver.h"
@@ -26,6 +33,116 @@ namespace skia {
 
 namespace {
 
+// Resizes touching fewer source and output pixels than this run on the
+// calling thread; handing them to other threads costs more than it saves.
+const int kMinPixelsForThreading = 512 * 512;
+
+// Each band of output rows handed to a thread is at least this tall, so the
+// rows convolved twice at band edges stay a small share of the work.
+const int kMinRowsPerBand = 32;
+
+// Upper bound on the threads a single resize uses, including the caller.
+const int kDefaultMaxThreads = 4;
+
+int g_max_threads = 0;
+
+int GetMaxThreads() {
+  if (g_max_threads > 0)
+    return g_max_threads;
+  return std::min(base::SysInfo::NumberOfProcessors(), kDefaultMaxThreads);
+}
+
+// Convolves an image in horizontal bands of output rows on several threads.
+// The calling thread takes bands too and then waits for the bands other
+// threads have started, so it never waits on a worker that hasn't run yet.
+// Workers that start after every band was taken return without touching the
+// image, which lets the caller's stack data go away before they run.
+class ParallelConvolution
+    : public base::RefCountedThreadSafe<ParallelConvolution> {
+ public:
+  ParallelConvolution(const unsigned char* source_data,
+                      int source_byte_row_stride,
+                      bool source_has_alpha,
+                      const ConvolutionFilter1D& filter_x,
+                      const ConvolutionFilter1D& filter_y,
+                      int output_byte_row_stride,
+                      unsigned char* output,
+                      bool use_sse2,
+                      int num_bands)
+      : source_data_(source_data),
+        source_byte_row_stride_(source_byte_row_stride),
+        source_has_alpha_(source_has_alpha),
+        filter_x_(filter_x),
+        filter_y_(filter_y),
+        output_byte_row_stride_(output_byte_row_stride),
+        output_(output),
+        use_sse2_(use_sse2),
+        num_bands_(num_bands),
+        next_band_(0),
+        finished_bands_(0),
+        all_finished_(&lock_) {
+  }
+
+  void Run() {
+    for (int i = 1; i < num_bands_; ++i) {
+      base::WorkerPool::PostTask(
+          FROM_HERE, base::Bind(&ParallelConvolution::ConvolveBands, this),
+          false);
+    }
+    ConvolveBands();
+
+    base::AutoLock auto_lock(lock_);
+    while (finished_bands_ < num_bands_)
+      all_finished_.Wait();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ParallelConvolution>;
+  ~ParallelConvolution() {}
+
+  void ConvolveBands() {
+    while (true) {
+      int band;
+      {
+        base::AutoLock auto_lock(lock_);
+        if (next_band_ == num_bands_)
+          return;
+        band = next_band_++;
+      }
+
+      int num_rows = filter_y_.num_values();
+      BGRAConvolve2DRows(source_data_, source_byte_row_stride_,
+                         source_has_alpha_, filter_x_, filter_y_,
+                         num_rows * band / num_bands_,
+                         num_rows * (band + 1) / num_bands_,
+                         output_byte_row_stride_, output_, use_sse2_);
+
+      base::AutoLock auto_lock(lock_);
+      if (++finished_bands_ == num_bands_)
+        all_finished_.Signal();
+    }
+  }
+
+  const unsigned char* source_data_;
+  int source_byte_row_stride_;
+  bool source_has_alpha_;
+  const ConvolutionFilter1D& filter_x_;
+  const ConvolutionFilter1D& filter_y_;
+  int output_byte_row_stride_;
+  unsigned char* output_;
+  bool use_sse2_;
+
+  const int num_bands_;
+
+  // Protects |next_band_| and |finished_bands_|.
+  base::Lock lock_;
+  int next_band_;
+  int finished_bands_;
+  base::ConditionVariable all_finished_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelConvolution);
+};
+
 // Returns the ceiling/floor as an integer.
 inline int CeilInt(float val) {
   return static_cast<int>(ceil(val));
@@ -522,11 +639,27 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 cpu.has_sse2());
+  int num_bands = 1;
+  if (source.width() * source.height() +
+      dest_subset.width() * dest_subset.height() >= kMinPixelsForThreading) {
+    num_bands = std::min(GetMaxThreads(),
+                         dest_subset.height() / kMinRowsPerBand);
+  }
+  if (num_bands > 1) {
+    scoped_refptr<ParallelConvolution> convolution(new ParallelConvolution(
+        source_subset, static_cast<int>(source.rowBytes()),
+        !source.isOpaque(), filter.x_filter(), filter.y_filter(),
+        static_cast<int>(result.rowBytes()),
+        static_cast<unsigned char*>(result.getPixels()),
+        cpu.has_sse2(), num_bands));
+    convolution->Run();
+  } else {
+    BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
+                   !source.isOpaque(), filter.x_filter(), filter.y_filter(),
+                   static_cast<int>(result.rowBytes()),
+                   static_cast<unsigned char*>(result.getPixels()),
+                   cpu.has_sse2());
+  }
 
   // Preserve the "opaque" flag for use as an optimization later.
   result.setIsOpaque(source.isOpaque());
@@ -537,6 +670,11 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   return result;
 }
 
+// static
+void ImageOperations::SetMaxThreads(int max_threads) {
+  g_max_threads = max_threads;
+}
+
 // static
 SkBitmap ImageOperations::Resize(const SkBitmap& source,
                                  ResizeMethod method,
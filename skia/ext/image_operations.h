@@ -110,6 +110,12 @@ class SK_API ImageOperations {
                          ResizeMethod method,
                          int dest_width, int dest_height);
 
+  // Large resizes are split across up to this many threads, counting the
+  // calling thread. Passing 1 keeps all work on the calling thread, and 0
+  // restores the default of one thread per core, up to 4. Meant for
+  // benchmarks and tests; call it before resizing.
+  static void SetMaxThreads(int max_threads);
+
  private:
   ImageOperations();  // Class for scoping only.
 
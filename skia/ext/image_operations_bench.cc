@@ -12,7 +12,9 @@
 // To present a single number in MB/s, it calculates the 'speed' by taking
 // source surface + destination surface and dividing by the elapsed time.
 // This number is somewhat reasonable way to measure this, given our current
-// implementation which somewhat scales this way.
+// implementation which somewhat scales this way. The same total is also
+// reported in megapixels per second, along with the method and the number of
+// threads the resize was allowed to use.
 
 #include <stdio.h>
 
@@ -141,6 +143,7 @@ class Benchmark {
 
   Benchmark()
       : num_iterations_(kDefaultNumberIterations),
+        num_threads_(0),
         method_(kDefaultResizeMethod) {}
 
   // Returns true if command line parsing was successful, false otherwise.
@@ -152,6 +155,7 @@ class Benchmark {
   static void Usage();
  private:
   int num_iterations_;
+  int num_threads_;
   skia::ImageOperations::ResizeMethod method_;
   Dimensions source_;
   Dimensions dest_;
@@ -165,10 +169,12 @@ const skia::ImageOperations::ResizeMethod Benchmark::kDefaultResizeMethod =
 // argument management
 void Benchmark::Usage() {
   printf("image_operations_bench -source wxh -destination wxh "
-         "[-iterations i] [-method m] [-help]\n"
+         "[-iterations i] [-threads t] [-method m] [-help]\n"
          "  -source wxh: specify source width and height\n"
          "  -destination wxh: specify destination width and height\n"
          "  -iter i: perform i iterations (default:%d)\n"
+         "  -threads t: use at most t threads per resize (default: one per "
+         "core)\n"
          "  -method m: use method m (default:%s), which can be:",
          Benchmark::kDefaultNumberIterations,
          MethodToString(Benchmark::kDefaultResizeMethod));
@@ -198,6 +204,12 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
       if (base::StringToInt(value, &num_iterations_) == false) {
         fNeedHelp = true;
       }
+    } else if (s == "threads") {
+      if (base::StringToInt(value, &num_threads_) == false ||
+          num_threads_ <= 0) {
+        printf("Invalid number of threads '%s' specified\n", value.c_str());
+        fNeedHelp = true;
+      }
     } else if (s == "method") {
       if (!StringToMethod(value, &method_)) {
         printf("Invalid method '%s' specified\n", value.c_str());
@@ -236,6 +248,8 @@ bool Benchmark::Run() const {
 
   SkBitmap dest;
 
+  skia::ImageOperations::SetMaxThreads(num_threads_);
+
   const base::TimeTicks start = base::TimeTicks::Now();
 
   for (int i = 0; i < num_iterations_; ++i) {
@@ -249,8 +263,13 @@ bool Benchmark::Run() const {
   const uint64 num_bytes = static_cast<uint64>(num_iterations_) *
       (GetBitmapSize(&source) + GetBitmapSize(&dest));
 
-  printf("%"PRIu64" MB/s,\telapsed = %"PRIu64" source=%d dest=%d\n",
+  const uint64 num_pixels = num_bytes / source.bytesPerPixel();
+
+  printf("%"PRIu64" MB/s,\t%.1f MP/s,\tmethod=%s threads=%d "
+         "elapsed = %"PRIu64" source=%d dest=%d\n",
          static_cast<uint64>(elapsed_us == 0 ? 0 : num_bytes / elapsed_us),
+         elapsed_us == 0 ? 0.0 : static_cast<double>(num_pixels) / elapsed_us,
+         MethodToString(method_), num_threads_,
          static_cast<uint64>(elapsed_us),
          GetBitmapSize(&source), GetBitmapSize(&dest));
 
@@ -643,3 +643,31 @@ TEST(ImageOperations, CompareLanczosMethods) {
 #endif  // #if DEBUG_BITMAP_GENERATION
   }
 }
+
+// Splitting a large resize across threads must not change a single pixel.
+TEST(ImageOperations, ThreadedResizeMatchesSingleThreaded) {
+  const int src_w = 640, src_h = 480;
+  SkBitmap src;
+  FillDataToBitmap(src_w, src_h, &src);
+
+  const skia::ImageOperations::ResizeMethod kMethods[] = {
+    skia::ImageOperations::RESIZE_BOX,
+    skia::ImageOperations::RESIZE_HAMMING1,
+    skia::ImageOperations::RESIZE_LANCZOS3,
+  };
+  for (size_t i = 0; i < arraysize(kMethods); ++i) {
+    skia::ImageOperations::SetMaxThreads(1);
+    SkBitmap expected = skia::ImageOperations::Resize(
+        src, kMethods[i], src_w * 3 / 4, src_h * 3 / 4);
+    skia::ImageOperations::SetMaxThreads(4);
+    SkBitmap actual = skia::ImageOperations::Resize(
+        src, kMethods[i], src_w * 3 / 4, src_h * 3 / 4);
+    skia::ImageOperations::SetMaxThreads(0);
+
+    SkAutoLockPixels expected_lock(expected);
+    SkAutoLockPixels actual_lock(actual);
+    ASSERT_EQ(expected.getSize(), actual.getSize());
+    EXPECT_EQ(0, memcmp(expected.getPixels(), actual.getPixels(),
+                        expected.getSize())) << "method " << kMethods[i];
+  }
+}
@@ -8,6 +8,7 @@
 
 #include "base/file_path.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
@@ -87,6 +88,12 @@ Connection::Connection()
       page_size_(0),
       cache_size_(0),
       exclusive_locking_(false),
+      write_ahead_logging_(false),
+      temp_store_in_memory_(false),
+      statement_cache_size_(0),
+      statement_cache_(CachedStatementMap::NO_AUTO_EVICT),
+      statement_cache_hits_(0),
+      statement_cache_misses_(0),
       transaction_nesting_(0),
       needs_rollback_(false) {
 }
@@ -95,6 +102,11 @@ Connection::~Connection() {
   Close();
 }
 
+// static
+void Connection::SetMemoryLimit(int64 bytes) {
+  sqlite3_soft_heap_limit64(bytes > 0 ? bytes : 0);
+}
+
 bool Connection::Open(const FilePath& path) {
 #if defined(OS_WIN)
   return OpenInternal(WideToUTF8(path.value()));
@@ -116,9 +128,21 @@ void Connection::Close() {
   // sqlite3_close() needs all prepared statements to be finalized.
   // Release all cached statements, then assert that the client has
   // released all statements.
-  statement_cache_.clear();
+  statement_cache_.Clear();
   DCHECK(open_statements_.empty());
 
+  if (db_ && !histogram_tag_.empty()) {
+    int cache_used = 0;
+    int unused_highwater = 0;
+    if (sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_USED, &cache_used,
+                          &unused_highwater, 0) == SQLITE_OK) {
+      base::Histogram* histogram = base::Histogram::FactoryGet(
+          "Sqlite.CacheUsed." + histogram_tag_, 1, 64 * 1024, 50,
+          base::Histogram::kUmaTargetedHistogramFlag);
+      histogram->Add(cache_used / 1024);
+    }
+  }
+
   // Additionally clear the prepared statements, because they contain
   // weak references to this connection.  This case has come up when
   // error-handling code is hit in production.
@@ -332,13 +356,13 @@ bool Connection::ExecuteWithTimeout(const char* sql, base::TimeDelta timeout) {
 }
 
 bool Connection::HasCachedStatement(const StatementID& id) const {
-  return statement_cache_.find(id) != statement_cache_.end();
+  return statement_cache_.Peek(id) != statement_cache_.end();
 }
 
 scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     const StatementID& id,
     const char* sql) {
-  CachedStatementMap::iterator i = statement_cache_.find(id);
+  CachedStatementMap::iterator i = statement_cache_.Get(id);
   if (i != statement_cache_.end()) {
     // Statement is in the cache. It should still be active (we're the only
     // one invalidating cached statements, and we'll remove it from the cache
@@ -346,12 +370,19 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     // case it still has some stuff bound.
     DCHECK(i->second->is_valid());
     sqlite3_reset(i->second->stmt());
+    statement_cache_hits_++;
     return i->second;
   }
 
+  statement_cache_misses_++;
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
-    statement_cache_[id] = statement;  // Only cache valid statements.
+  if (statement->is_valid()) {
+    // Only cache valid statements. Evicted statements stay alive for as long
+    // as a caller still holds them.
+    statement_cache_.Put(id, statement);
+    if (statement_cache_size_)
+      statement_cache_.ShrinkToSize(statement_cache_size_);
+  }
   return statement;
 }
 
@@ -497,10 +528,14 @@ bool Connection::OpenInternal(const std::string& file_name) {
   // TRUNCATE - truncate -journal file to commit.
   // PERSIST - zero out header of -journal file to commit.
   // journal_size_limit provides size to trim to in PERSIST.
+  // WAL - append to -wal file to commit, checkpoint into the database later.
   // TODO(shess): Figure out if PERSIST and journal_size_limit really
   // matter.  In theory, it keeps pages pre-allocated, so if
   // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  if (write_ahead_logging_)
+    ignore_result(Execute("PRAGMA journal_mode = WAL"));
+  else
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
   ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
 
   const base::TimeDelta kBusyTimeout =
@@ -523,6 +558,11 @@ bool Connection::OpenInternal(const std::string& file_name) {
       DLOG(FATAL) << "Could not set cache size: " << GetErrorMessage();
   }
 
+  if (temp_store_in_memory_) {
+    if (!ExecuteWithTimeout("PRAGMA temp_store=MEMORY", kBusyTimeout))
+      DLOG(FATAL) << "Could not set temp store: " << GetErrorMessage();
+  }
+
   if (!ExecuteWithTimeout("PRAGMA secure_delete=ON", kBusyTimeout)) {
     DLOG(FATAL) << "Could not enable secure_delete: " << GetErrorMessage();
     Close();
@@ -552,7 +592,7 @@ void Connection::StatementRefDeleted(StatementRef* ref) {
 }
 
 void Connection::ClearCache() {
-  statement_cache_.clear();
+  statement_cache_.Clear();
 
   // The cache clear will get most statements. There may be still be references
   // to some statements that are held by others (including one-shot statements).
@@ -12,6 +12,7 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/time.h"
 #include "sql/sql_export.h"
@@ -139,6 +140,36 @@ class SQL_EXPORT Connection {
   // This must be called before Open() to have an effect.
   void set_exclusive_locking() { exclusive_locking_ = true; }
 
+  // Call to use a write-ahead log instead of a rollback journal. Commits then
+  // append to the -wal file rather than rewriting the database pages and the
+  // journal, which suits databases with frequent small transactions. Opening
+  // the database without it switches back to a rollback journal.
+  //
+  // This must be called before Open() to have an effect.
+  void set_write_ahead_logging() { write_ahead_logging_ = true; }
+
+  // Bounds the number of prepared statements kept by GetCachedStatement(). When
+  // the cache is full the least recently used statement is finalized to make
+  // room. Zero, the default, keeps every statement for the connection's
+  // lifetime.
+  void set_statement_cache_size(size_t size) { statement_cache_size_ = size; }
+
+  // Keeps temporary tables and indices, including the ones SQLite builds for
+  // sorting and DISTINCT, in memory rather than in temporary files. This
+  // must be called before Open() to have an effect.
+  void set_temp_store_in_memory() { temp_store_in_memory_ = true; }
+
+  // Names this database in histograms. When set, the page cache memory in use
+  // when the connection closes is recorded as "Sqlite.CacheUsed.<tag>". This
+  // must be called before Open() to have an effect.
+  void set_histogram_tag(const std::string& tag) { histogram_tag_ = tag; }
+
+  // Bounds the memory used by SQLite across every connection in the process.
+  // Once the heap passes |bytes|, connections recycle their own page cache
+  // instead of growing it, so databases under heavy use keep more pages than
+  // idle ones. Zero or a negative value removes the limit.
+  static void SetMemoryLimit(int64 bytes);
+
   // Sets the object that will handle errors. Recomended that it should be set
   // before calling Open(). If not set, the default is to ignore errors on
   // release and assert on debug builds.
@@ -241,6 +272,12 @@ class SQL_EXPORT Connection {
   // cached.
   bool HasCachedStatement(const StatementID& id) const;
 
+  // The number of GetCachedStatement() calls that were served from the cache
+  // and that had to prepare a new statement, respectively. Useful for sizing
+  // the cache with set_statement_cache_size().
+  int statement_cache_hits() const { return statement_cache_hits_; }
+  int statement_cache_misses() const { return statement_cache_misses_; }
+
   // Returns a statement for the given SQL using the statement cache. It can
   // take a nontrivial amount of work to parse and compile a statement, so
   // keeping commonly-used ones around for future use is important for
@@ -397,12 +434,23 @@ class SQL_EXPORT Connection {
   int page_size_;
   int cache_size_;
   bool exclusive_locking_;
+  bool write_ahead_logging_;
+  bool temp_store_in_memory_;
+
+  // See set_histogram_tag().
+  std::string histogram_tag_;
+
+  // Maximum number of entries in |statement_cache_|, zero for unbounded.
+  size_t statement_cache_size_;
 
-  // All cached statements. Keeping a reference to these statements means that
-  // they'll remain active.
-  typedef std::map<StatementID, scoped_refptr<StatementRef> >
+  // All cached statements, most recently used first. Keeping a reference to
+  // these statements means that they'll remain active. Mutable so that
+  // HasCachedStatement() can look without touching the recency order.
+  typedef base::MRUCache<StatementID, scoped_refptr<StatementRef> >
       CachedStatementMap;
-  CachedStatementMap statement_cache_;
+  mutable CachedStatementMap statement_cache_;
+  int statement_cache_hits_;
+  int statement_cache_misses_;
 
   // A list of all StatementRefs we've given out. Each ref must register with
   // us when it's created or destroyed. This allows us to potentially close
@@ -86,6 +86,30 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, CachedStatementEviction) {
+  sql::StatementID id1("foo", 1);
+  sql::StatementID id2("foo", 2);
+  sql::StatementID id3("foo", 3);
+
+  db().set_statement_cache_size(2);
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+
+  { sql::Statement s(db().GetCachedStatement(id1, "SELECT a FROM foo")); }
+  { sql::Statement s(db().GetCachedStatement(id2, "SELECT b FROM foo")); }
+  EXPECT_EQ(0, db().statement_cache_hits());
+  EXPECT_EQ(2, db().statement_cache_misses());
+
+  // Touch |id1| so that |id2| is the least recently used.
+  { sql::Statement s(db().GetCachedStatement(id1, "SELECT a FROM foo")); }
+  EXPECT_EQ(1, db().statement_cache_hits());
+
+  { sql::Statement s(db().GetCachedStatement(id3, "SELECT * FROM foo")); }
+  EXPECT_EQ(3, db().statement_cache_misses());
+  EXPECT_TRUE(db().HasCachedStatement(id1));
+  EXPECT_FALSE(db().HasCachedStatement(id2));
+  EXPECT_TRUE(db().HasCachedStatement(id3));
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
@@ -200,6 +224,31 @@ TEST_F(SQLConnectionTest, RazePageSize) {
   ASSERT_EQ(kPageSize, s.ColumnInt(0));
 }
 
+TEST_F(SQLConnectionTest, WriteAheadLogging) {
+  db().Close();
+  sql::Connection wal_db;
+  wal_db.set_write_ahead_logging();
+  ASSERT_TRUE(wal_db.Open(db_path()));
+
+  sql::Statement s(wal_db.GetUniqueStatement("PRAGMA journal_mode"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ("wal", s.ColumnString(0));
+  s.Clear();
+
+  ASSERT_TRUE(wal_db.Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(wal_db.Execute("INSERT INTO foo VALUES (1, 2)"));
+  wal_db.Close();
+
+  // Without the flag the database goes back to a rollback journal.
+  ASSERT_TRUE(db().Open(db_path()));
+  sql::Statement mode(db().GetUniqueStatement("PRAGMA journal_mode"));
+  ASSERT_TRUE(mode.Step());
+  EXPECT_EQ("persist", mode.ColumnString(0));
+  sql::Statement count(db().GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  ASSERT_TRUE(count.Step());
+  EXPECT_EQ(1, count.ColumnInt(0));
+}
+
 // Test that Raze() results are seen in other connections.
 TEST_F(SQLConnectionTest, RazeMultiple) {
   const char* kCreateSql = "CREATE TABLE foo (id INTEGER PRIMARY KEY, value)";
@@ -258,6 +307,17 @@ TEST_F(SQLConnectionTest, RazeLocked) {
   ASSERT_TRUE(db().Raze());
 }
 
+TEST_F(SQLConnectionTest, TempStoreInMemory) {
+  sql::Connection other_db;
+  other_db.set_temp_store_in_memory();
+  ASSERT_TRUE(other_db.Open(db_path()));
+
+  // 2 is MEMORY; the default is 0, which defers to the compile-time setting.
+  sql::Statement s(other_db.GetUniqueStatement("PRAGMA temp_store"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(2, s.ColumnInt(0));
+}
+
 // TODO(shess): Spin up a background thread to hold other_db, to more
 // closely match real life.  That would also allow testing
 // RazeWithTimeout().
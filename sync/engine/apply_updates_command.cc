@@ -4,6 +4,11 @@
 
 #include "sync/engine/apply_updates_command.h"
 
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
 #include "base/location.h"
 #include "sync/engine/update_applicator.h"
 #include "sync/sessions/sync_session.h"
@@ -13,6 +18,61 @@ namespace browser_sync {
 
 using sessions::SyncSession;
 
+namespace {
+
+// Reorders |handles| so that each update comes after the update to its
+// server parent, if that is in the list too. UpdateApplicator can't apply a
+// child before its parent, so on an initial sync, where updates arrive in no
+// particular order, this saves a pass over every update per level of the
+// bookmark tree.
+void SortParentsFirst(syncable::BaseTransaction* trans,
+                      std::vector<int64>* handles) {
+  const size_t count = handles->size();
+  std::map<syncable::Id, size_t> index_of_id;
+  std::vector<syncable::Id> parent_ids(count);
+  for (size_t i = 0; i < count; ++i) {
+    syncable::Entry entry(trans, syncable::GET_BY_HANDLE, (*handles)[i]);
+    index_of_id[entry.Get(syncable::ID)] = i;
+    parent_ids[i] = entry.Get(syncable::SERVER_PARENT_ID);
+  }
+
+  // The depth of an update is the number of its ancestors that are also in
+  // the list. Walk up from each update until reaching one whose depth is
+  // known, then fill in the path on the way back down.
+  std::vector<int> depths(count, -1);
+  std::vector<size_t> path;
+  for (size_t i = 0; i < count; ++i) {
+    size_t current = i;
+    int depth = 0;
+    while (depths[current] == -1) {
+      path.push_back(current);
+      std::map<syncable::Id, size_t>::const_iterator parent =
+          index_of_id.find(parent_ids[current]);
+      // Stop at the top of the list's hierarchy, and on malformed data that
+      // loops back on itself.
+      if (parent == index_of_id.end() || path.size() > count)
+        break;
+      current = parent->second;
+    }
+    if (depths[current] != -1)
+      depth = depths[current] + 1;
+    while (!path.empty()) {
+      if (depths[path.back()] == -1)
+        depths[path.back()] = depth++;
+      path.pop_back();
+    }
+  }
+
+  std::vector<std::pair<int, int64> > sorted(count);
+  for (size_t i = 0; i < count; ++i)
+    sorted[i] = std::make_pair(depths[i], (*handles)[i]);
+  std::stable_sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < count; ++i)
+    (*handles)[i] = sorted[i].second;
+}
+
+}  // namespace
+
 ApplyUpdatesCommand::ApplyUpdatesCommand() {}
 ApplyUpdatesCommand::~ApplyUpdatesCommand() {}
 
@@ -58,6 +118,7 @@ SyncerError ApplyUpdatesCommand::ModelChangingExecuteImpl(
   std::vector<int64> handles;
   dir->GetUnappliedUpdateMetaHandles(
       &trans, server_type_restriction, &handles);
+  SortParentsFirst(&trans, &handles);
 
   UpdateApplicator applicator(
       session->context()->resolver(),
@@ -5,6 +5,7 @@
 #include "sync/engine/syncer_proto_util.h"
 
 #include "base/format_macros.h"
+#include "base/metrics/histogram.h"
 #include "base/stringprintf.h"
 #include "sync/engine/net/server_connection_manager.h"
 #include "sync/engine/syncer.h"
@@ -165,6 +166,8 @@ bool SyncerProtoUtil::PostAndProcessHeaders(ServerConnectionManager* scm,
                                             ClientToServerResponse* response) {
   ServerConnectionManager::PostBufferParams params;
   msg.SerializeToString(&params.buffer_in);
+  UMA_HISTOGRAM_COUNTS("Sync.ClientToServerMessageSize",
+                       params.buffer_in.size());
 
   ScopedServerStatusWatcher server_status_watcher(scm, &params.response);
   // Fills in params.buffer_out and params.response.
@@ -180,6 +183,9 @@ bool SyncerProtoUtil::PostAndProcessHeaders(ServerConnectionManager* scm,
     session->context()->NotifyListeners(event);
   }
 
+  UMA_HISTOGRAM_COUNTS("Sync.ClientToServerResponseSize",
+                       params.buffer_out.size());
+
   if (response->ParseFromString(params.buffer_out)) {
     // TODO(tim): This is an egregious layering violation (bug 35060).
     switch (response->error_code()) {
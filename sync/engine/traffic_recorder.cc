@@ -16,15 +16,18 @@ namespace browser_sync {
 
 TrafficRecorder::TrafficRecord::TrafficRecord(const std::string& message,
                                               TrafficMessageType message_type,
-                                              bool truncated) :
+                                              bool truncated,
+                                              int size) :
     message(message),
     message_type(message_type),
-    truncated(truncated) {
+    truncated(truncated),
+    size(size) {
 }
 
 TrafficRecorder::TrafficRecord::TrafficRecord()
     : message_type(UNKNOWN_MESSAGE_TYPE),
-      truncated(false) {
+      truncated(false),
+      size(0) {
 }
 
 TrafficRecorder::TrafficRecord::~TrafficRecord() {
@@ -33,7 +36,9 @@ TrafficRecorder::TrafficRecord::~TrafficRecord() {
 TrafficRecorder::TrafficRecorder(unsigned int max_messages,
     unsigned int max_message_size)
     : max_messages_(max_messages),
-      max_message_size_(max_message_size) {
+      max_message_size_(max_message_size),
+      bytes_sent_(0),
+      bytes_received_(0) {
 }
 
 TrafficRecorder::~TrafficRecorder() {
@@ -76,6 +81,8 @@ DictionaryValue* TrafficRecorder::TrafficRecord::ToValue() const {
     NOTREACHED();
   }
 
+  if (value.get())
+    value->SetInteger("size", size);
   return value.release();
 }
 
@@ -108,14 +115,20 @@ void TrafficRecorder::StoreProtoInQueue(
     TrafficMessageType type) {
   bool truncated = false;
   std::string message;
-  if (static_cast<unsigned int>(msg.ByteSize()) >= max_message_size_) {
+  int size = msg.ByteSize();
+  if (type == CLIENT_TO_SERVER_MESSAGE)
+    bytes_sent_ += size;
+  else
+    bytes_received_ += size;
+
+  if (static_cast<unsigned int>(size) >= max_message_size_) {
     // TODO(lipalani): Trim the specifics to fit in size.
     truncated = true;
   } else {
     msg.SerializeToString(&message);
   }
 
-  TrafficRecord record(message, type, truncated);
+  TrafficRecord record(message, type, truncated, size);
   AddTrafficToQueue(&record);
 }
 
@@ -37,10 +37,14 @@ class TrafficRecorder {
     // truncated. For now the entire message is omitted if it is too big.
     // TODO(lipalani): Truncate the specifics to fit within size.
     bool truncated;
+    // Size of the serialized message in bytes, recorded even when the message
+    // itself is truncated.
+    int size;
 
     TrafficRecord(const std::string& message,
                   TrafficMessageType message_type,
-                  bool truncated);
+                  bool truncated,
+                  int size);
     TrafficRecord();
     ~TrafficRecord();
     DictionaryValue* ToValue() const;
@@ -58,6 +62,11 @@ class TrafficRecorder {
     return records_;
   }
 
+  // Total serialized size of every message and response recorded, including
+  // those no longer in |records_|.
+  int64 bytes_sent() const { return bytes_sent_; }
+  int64 bytes_received() const { return bytes_received_; }
+
  private:
   void AddTrafficToQueue(TrafficRecord* record);
   void StoreProtoInQueue(const ::google::protobuf::MessageLite& msg,
@@ -69,6 +78,10 @@ class TrafficRecorder {
   // Maximum size of each message.
   unsigned int max_message_size_;
   std::deque<TrafficRecord> records_;
+
+  int64 bytes_sent_;
+  int64 bytes_received_;
+
   DISALLOW_COPY_AND_ASSIGN(TrafficRecorder);
 };
 
@@ -37,6 +37,24 @@ TEST(TrafficRecorderTest, MaxMessageSizeTest) {
   TrafficRecorder::TrafficRecord record = recorder.records().front();
   EXPECT_TRUE(record.truncated);
   EXPECT_TRUE(record.message.empty());
+  EXPECT_EQ(response.ByteSize(), record.size);
+}
+
+// Ensure byte totals cover every message, not just those still recorded.
+TEST(TrafficRecorderTest, ByteTotalsTest) {
+  sync_pb::ClientToServerMessage message;
+  message.set_share("share");
+  sync_pb::ClientToServerResponse response;
+  response.set_store_birthday("birthday");
+
+  TrafficRecorder recorder(kMaxMessages, kMaxMessageSize);
+  for (unsigned int i = 0; i < 2*kMaxMessages; ++i) {
+    recorder.RecordClientToServerMessage(message);
+    recorder.RecordClientToServerResponse(response);
+  }
+
+  EXPECT_EQ(2 * kMaxMessages * message.ByteSize(), recorder.bytes_sent());
+  EXPECT_EQ(2 * kMaxMessages * response.ByteSize(), recorder.bytes_received());
 }
 
 }  //namespace browser_sync
@@ -27,6 +27,7 @@ UpdateApplicator::UpdateApplicator(ConflictResolver* resolver,
       begin_(begin),
       end_(end),
       pointer_(begin),
+      retry_end_(begin),
       group_filter_(group_filter),
       progress_(false),
       routing_info_(routes),
@@ -41,15 +42,20 @@ UpdateApplicator::~UpdateApplicator() {
 // Returns true if there's more to do.
 bool UpdateApplicator::AttemptOneApplication(
     syncable::WriteTransaction* trans) {
-  // If there are no updates left to consider, we're done.
-  if (end_ == begin_)
-    return false;
   if (pointer_ == end_) {
-    if (!progress_)
+    // The pass is over. Only the updates that failed in it are left, still in
+    // their original order.
+    end_ = retry_end_;
+    pointer_ = end_;
+
+    // If there are no updates left to consider, or the last pass applied
+    // none, we're done.
+    if (end_ == begin_ || !progress_)
       return false;
 
     DVLOG(1) << "UpdateApplicator doing additional pass.";
     pointer_ = begin_;
+    retry_end_ = begin_;
     progress_ = false;
 
     // Clear the tracked failures to avoid double-counting.
@@ -72,15 +78,15 @@ bool UpdateApplicator::AttemptOneApplication(
       application_results_.AddSuccess(entry.Get(syncable::ID));
       break;
     case CONFLICT_SIMPLE:
-      pointer_++;
+      Retry();
       application_results_.AddSimpleConflict(entry.Get(syncable::ID));
       break;
     case CONFLICT_ENCRYPTION:
-      pointer_++;
+      Retry();
       application_results_.AddEncryptionConflict(entry.Get(syncable::ID));
       break;
     case CONFLICT_HIERARCHY:
-      pointer_++;
+      Retry();
       application_results_.AddHierarchyConflict(entry.Get(syncable::ID));
       break;
     default:
@@ -94,8 +100,13 @@ bool UpdateApplicator::AttemptOneApplication(
 }
 
 void UpdateApplicator::Advance() {
-  --end_;
-  *pointer_ = *end_;
+  ++pointer_;
+}
+
+void UpdateApplicator::Retry() {
+  *retry_end_ = *pointer_;
+  ++retry_end_;
+  ++pointer_;
 }
 
 bool UpdateApplicator::SkipUpdate(const syncable::Entry& entry) {
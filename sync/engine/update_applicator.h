@@ -7,6 +7,8 @@
 //
 // UpdateApplicator might resemble an iterator, but it actually keeps retrying
 // failed updates until no remaining updates can be successfully applied.
+// Every pass visits the remaining updates in the order they were given, so
+// putting parents before their children lets a hierarchy apply in one pass.
 
 #ifndef SYNC_ENGINE_UPDATE_APPLICATOR_H_
 #define SYNC_ENGINE_UPDATE_APPLICATOR_H_
@@ -81,9 +83,12 @@ class UpdateApplicator {
   // If true, AttemptOneApplication will skip over |entry| and return true.
   bool SkipUpdate(const syncable::Entry& entry);
 
-  // Adjusts the UpdateIterator members to move ahead by one update.
+  // Moves ahead by one update, dropping the current one.
   void Advance();
 
+  // Moves ahead by one update, keeping the current one for the next pass.
+  void Retry();
+
   // Used to resolve conflicts when trying to apply updates.
   ConflictResolver* const resolver_;
 
@@ -93,6 +98,9 @@ class UpdateApplicator {
   UpdateIterator const begin_;
   UpdateIterator end_;
   UpdateIterator pointer_;
+  // Updates in [begin_, retry_end_) failed during the current pass and will
+  // be retried in the next one.
+  UpdateIterator retry_end_;
   ModelSafeGroup group_filter_;
   bool progress_;
 
@@ -12,6 +12,7 @@
 #include <limits>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/debug/trace_event.h"
@@ -875,16 +876,25 @@ bool Directory::SaveChanges() {
 }
 
 bool Directory::VacuumAfterSaveChanges(const SaveChangesSnapshot& snapshot) {
-  if (snapshot.dirty_metas.empty())
+  // Only entries that were deleted when the snapshot was taken can be purged.
+  // An entry deleted since then is dirty again and waits for the next save.
+  // Most saves purge nothing, and skipping them avoids a write transaction.
+  std::vector<int64> purge_candidates;
+  for (EntryKernelSet::const_iterator i = snapshot.dirty_metas.begin();
+       i != snapshot.dirty_metas.end(); ++i) {
+    if (i->ref(IS_DEL))
+      purge_candidates.push_back(i->ref(META_HANDLE));
+  }
+  if (purge_candidates.empty())
     return true;
 
   // Need a write transaction as we are about to permanently purge entries.
   WriteTransaction trans(FROM_HERE, VACUUM_AFTER_SAVE, this);
   ScopedKernelLock lock(this);
   // Now drop everything we can out of memory.
-  for (EntryKernelSet::const_iterator i = snapshot.dirty_metas.begin();
-       i != snapshot.dirty_metas.end(); ++i) {
-    kernel_->needle.put(META_HANDLE, i->ref(META_HANDLE));
+  for (std::vector<int64>::const_iterator i = purge_candidates.begin();
+       i != purge_candidates.end(); ++i) {
+    kernel_->needle.put(META_HANDLE, *i);
     MetahandlesIndex::iterator found =
         kernel_->metahandles_index->find(&kernel_->needle);
     EntryKernel* entry = (found == kernel_->metahandles_index->end() ?
@@ -0,0 +1,112 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/file_path.h"
+#include "base/location.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/scoped_temp_dir.h"
+#include "base/stringprintf.h"
+#include "sync/protocol/bookmark_specifics.pb.h"
+#include "sync/syncable/syncable.h"
+#include "sync/test/engine/test_id_factory.h"
+#include "sync/test/fake_encryptor.h"
+#include "sync/test/null_directory_change_delegate.h"
+#include "sync/test/null_transaction_observer.h"
+#include "sync/util/test_unrecoverable_error_handler.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using browser_sync::FakeEncryptor;
+using browser_sync::TestIdFactory;
+using browser_sync::TestUnrecoverableErrorHandler;
+
+namespace syncable {
+
+namespace {
+
+// Roughly the size of a large imported bookmark collection.
+const int kEntryCount = 100000;
+
+// Number of entries touched between saves in the incremental scenario.
+const int kModifiedCount = 100;
+
+class SyncableDirectoryPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    dir_.reset(new Directory(&encryptor_, &handler_, NULL));
+    ASSERT_EQ(OPENED, dir_->Open(
+        temp_dir_.path().Append(Directory::kSyncDatabaseFilename),
+        "PerfTest", &delegate_, NullTransactionObserver()));
+  }
+
+  virtual void TearDown() {
+    dir_->SaveChanges();
+    dir_.reset();
+  }
+
+  // Creates |kEntryCount| synced bookmarks under the root and returns their
+  // metahandles.
+  void CreateEntries(std::vector<int64>* metahandles) {
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir_.get());
+    for (int i = 0; i < kEntryCount; ++i) {
+      MutableEntry entry(&trans, CREATE, trans.root_id(),
+                         base::StringPrintf("bookmark %d", i));
+      ASSERT_TRUE(entry.good());
+      entry.Put(ID, TestIdFactory::FromNumber(i + 1));
+      entry.Put(BASE_VERSION, 1);
+      sync_pb::EntitySpecifics specifics;
+      specifics.mutable_bookmark()->set_url(
+          base::StringPrintf("http://www.example.com/page%d", i));
+      entry.Put(SPECIFICS, specifics);
+      entry.Put(SERVER_SPECIFICS, specifics);
+      metahandles->push_back(entry.Get(META_HANDLE));
+    }
+  }
+
+  MessageLoop message_loop_;
+  ScopedTempDir temp_dir_;
+  FakeEncryptor encryptor_;
+  TestUnrecoverableErrorHandler handler_;
+  NullDirectoryChangeDelegate delegate_;
+  scoped_ptr<Directory> dir_;
+};
+
+}  // namespace
+
+// Measures saving a large directory for the first time, then saving after a
+// handful of entries change, which is what happens on every sync cycle.
+TEST_F(SyncableDirectoryPerfTest, SaveChanges) {
+  std::vector<int64> metahandles;
+  CreateEntries(&metahandles);
+
+  PerfTimeLogger full_timer("Syncable_save_all_entries");
+  ASSERT_TRUE(dir_->SaveChanges());
+  full_timer.Done();
+
+  {
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir_.get());
+    for (int i = 0; i < kModifiedCount; ++i) {
+      MutableEntry entry(&trans, GET_BY_HANDLE,
+                         metahandles[i * (kEntryCount / kModifiedCount)]);
+      ASSERT_TRUE(entry.good());
+      entry.Put(NON_UNIQUE_NAME, base::StringPrintf("renamed %d", i));
+      entry.Put(IS_UNSYNCED, true);
+    }
+  }
+
+  PerfTimeLogger incremental_timer("Syncable_save_few_entries");
+  ASSERT_TRUE(dir_->SaveChanges());
+  incremental_timer.Done();
+
+  // Nothing is dirty now, so this is the fixed cost of a save.
+  PerfTimeLogger empty_timer("Syncable_save_no_entries");
+  ASSERT_TRUE(dir_->SaveChanges());
+  empty_timer.Done();
+}
+
+}  // namespace syncable
@@ -401,7 +401,11 @@ bool RootWindowHostLinux::Dispatch(const base::NativeEvent& event) {
 
   switch (xev->type) {
     case Expose:
-      root_window_->ScheduleFullDraw();
+      // The X server sends one Expose event per exposed rectangle, and
+      // |count| says how many more follow. The whole window is redrawn
+      // anyway, so do it once for the last event of the series.
+      if (xev->xexpose.count == 0)
+        root_window_->ScheduleFullDraw();
       break;
     case KeyPress: {
       KeyEvent keydown_event(xev, false);
@@ -182,6 +182,14 @@ base::RefCountedStaticMemory* DataPack::GetStaticMemory(
       reinterpret_cast<const unsigned char*>(piece.data()), piece.length());
 }
 
+void DataPack::GetResourceIds(std::vector<uint16>* resource_ids) const {
+  for (size_t i = 0; i < resource_count_; ++i) {
+    const DataPackEntry* entry = reinterpret_cast<const DataPackEntry*>(
+        mmap_->data() + kHeaderLength + (i * sizeof(DataPackEntry)));
+    resource_ids->push_back(entry->resource_id);
+  }
+}
+
 ResourceHandle::TextEncodingType DataPack::GetTextEncodingType() const {
   return text_encoding_type_;
 }
@@ -0,0 +1,186 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ui/base/resource/decoded_image_pack.h"
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+// File layout, all little endian:
+//   uint32 magic, uint32 version, uint32 entry count
+//   entry count * Entry, sorted by resource id
+//   pixels of each entry, width * height * 4 bytes, at 4 byte aligned offsets
+
+namespace {
+
+const uint32 kMagic = 0x474d4944;  // "DIMG"
+const uint32 kFileFormatVersion = 1;
+const size_t kHeaderLength = 3 * sizeof(uint32);
+const size_t kBytesPerPixel = 4;
+
+// Images larger than this in either direction are rejected as corrupt.
+const uint32 kMaxDimension = 1 << 14;
+
+bool WriteUint32(FILE* file, uint32 value) {
+  return fwrite(&value, sizeof(value), 1, file) == 1;
+}
+
+}  // namespace
+
+namespace ui {
+
+#pragma pack(push, 4)
+struct DecodedImagePack::Entry {
+  uint16 resource_id;
+  uint16 padding;
+  uint32 width;
+  uint32 height;
+  uint32 offset;
+
+  static int CompareById(const void* void_key, const void* void_entry) {
+    uint16 key = *reinterpret_cast<const uint16*>(void_key);
+    const Entry* entry = reinterpret_cast<const Entry*>(void_entry);
+    if (key < entry->resource_id)
+      return -1;
+    if (key > entry->resource_id)
+      return 1;
+    return 0;
+  }
+};
+#pragma pack(pop)
+
+DecodedImagePack::DecodedImagePack() : entries_(NULL), entry_count_(0) {
+  COMPILE_ASSERT(sizeof(Entry) == 16, size_of_entry_must_be_16);
+}
+
+DecodedImagePack::~DecodedImagePack() {
+}
+
+bool DecodedImagePack::Load(const FilePath& path) {
+  mmap_.reset(new file_util::MemoryMappedFile);
+  if (!mmap_->Initialize(path)) {
+    mmap_.reset();
+    return false;
+  }
+
+  const size_t length = mmap_->length();
+  const uint32* header = reinterpret_cast<const uint32*>(mmap_->data());
+  if (length < kHeaderLength || header[0] != kMagic ||
+      header[1] != kFileFormatVersion) {
+    LOG(ERROR) << "Bad decoded image pack header: " << path.value();
+    mmap_.reset();
+    return false;
+  }
+  entry_count_ = header[2];
+  if (entry_count_ > (length - kHeaderLength) / sizeof(Entry)) {
+    LOG(ERROR) << "Decoded image pack index truncated: " << path.value();
+    mmap_.reset();
+    return false;
+  }
+  entries_ = reinterpret_cast<const Entry*>(mmap_->data() + kHeaderLength);
+
+  // Validate every entry up front so that lookups can trust the index.
+  for (size_t i = 0; i < entry_count_; ++i) {
+    const Entry& entry = entries_[i];
+    bool valid = entry.width > 0 && entry.width <= kMaxDimension &&
+        entry.height > 0 && entry.height <= kMaxDimension &&
+        entry.offset % kBytesPerPixel == 0 && entry.offset <= length &&
+        (i == 0 || entries_[i - 1].resource_id < entry.resource_id);
+    if (valid) {
+      uint64 size = static_cast<uint64>(entry.width) * entry.height *
+          kBytesPerPixel;
+      valid = size <= length - entry.offset;
+    }
+    if (!valid) {
+      LOG(ERROR) << "Decoded image pack entry #" << i << " is corrupt: "
+                 << path.value();
+      mmap_.reset();
+      entries_ = NULL;
+      entry_count_ = 0;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DecodedImagePack::GetBitmap(uint16 resource_id, SkBitmap* bitmap) const {
+  if (!mmap_.get())
+    return false;
+  const Entry* entry = reinterpret_cast<const Entry*>(
+      bsearch(&resource_id, entries_, entry_count_, sizeof(Entry),
+              Entry::CompareById));
+  if (!entry)
+    return false;
+
+  bitmap->setConfig(SkBitmap::kARGB_8888_Config, entry->width, entry->height,
+                    entry->width * kBytesPerPixel);
+  // The mapping is read-only; Skia won't write to immutable pixels.
+  bitmap->setPixels(const_cast<uint8*>(mmap_->data() + entry->offset));
+  bitmap->setImmutable();
+  return true;
+}
+
+// static
+bool DecodedImagePack::WritePack(const FilePath& path,
+                                 const std::map<uint16, SkBitmap>& bitmaps) {
+  std::vector<Entry> entries;
+  std::vector<const SkBitmap*> sources;
+  uint32 offset = 0;
+  for (std::map<uint16, SkBitmap>::const_iterator it = bitmaps.begin();
+       it != bitmaps.end(); ++it) {
+    const SkBitmap& bitmap = it->second;
+    if (bitmap.config() != SkBitmap::kARGB_8888_Config || bitmap.isNull() ||
+        bitmap.width() <= 0 || bitmap.height() <= 0 ||
+        static_cast<uint32>(bitmap.width()) > kMaxDimension ||
+        static_cast<uint32>(bitmap.height()) > kMaxDimension) {
+      continue;
+    }
+    Entry entry;
+    entry.resource_id = it->first;
+    entry.padding = 0;
+    entry.width = bitmap.width();
+    entry.height = bitmap.height();
+    entry.offset = offset;
+    offset += entry.width * entry.height * kBytesPerPixel;
+    entries.push_back(entry);
+    sources.push_back(&bitmap);
+  }
+
+  // Offsets so far are relative to the start of the pixels.
+  const uint32 pixels_offset = kHeaderLength + entries.size() * sizeof(Entry);
+  for (size_t i = 0; i < entries.size(); ++i)
+    entries[i].offset += pixels_offset;
+
+  FILE* file = file_util::OpenFile(path, "wb");
+  if (!file)
+    return false;
+  bool ok = WriteUint32(file, kMagic) &&
+      WriteUint32(file, kFileFormatVersion) &&
+      WriteUint32(file, static_cast<uint32>(entries.size())) &&
+      (entries.empty() ||
+       fwrite(&entries[0], sizeof(Entry), entries.size(), file) ==
+           entries.size());
+  for (size_t i = 0; ok && i < sources.size(); ++i) {
+    const SkBitmap& bitmap = *sources[i];
+    SkAutoLockPixels lock(bitmap);
+    const size_t row_length = bitmap.width() * kBytesPerPixel;
+    for (int y = 0; ok && y < bitmap.height(); ++y)
+      ok = fwrite(bitmap.getAddr32(0, y), row_length, 1, file) == 1;
+  }
+  if (!file_util::CloseFile(file))
+    ok = false;
+  if (!ok) {
+    LOG(ERROR) << "Failed to write decoded image pack: " << path.value();
+    file_util::Delete(path, false);
+  }
+  return ok;
+}
+
+}  // namespace ui
@@ -0,0 +1,62 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// DecodedImagePack is a file of image resources that are already decoded to
+// 32 bit premultiplied pixels. Every process that loads the same file maps it
+// read-only, so the pixels are shared through the page cache instead of being
+// decoded from PNG into private memory in each process.
+//
+// The pixel layout is that of SkBitmap on the machine that wrote the file, so
+// a pack must only be read by the build that wrote it.
+
+#ifndef UI_BASE_RESOURCE_DECODED_IMAGE_PACK_H_
+#define UI_BASE_RESOURCE_DECODED_IMAGE_PACK_H_
+#pragma once
+
+#include <map>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "ui/base/ui_export.h"
+
+class FilePath;
+class SkBitmap;
+
+namespace file_util {
+class MemoryMappedFile;
+}
+
+namespace ui {
+
+class UI_EXPORT DecodedImagePack {
+ public:
+  DecodedImagePack();
+  ~DecodedImagePack();
+
+  // Maps the pack at |path|, returning false if it is missing or malformed.
+  bool Load(const FilePath& path);
+
+  // Points |bitmap| at the pixels of |resource_id| in the mapped file. The
+  // bitmap is immutable and must not outlive this pack. Returns false if the
+  // pack has no such image.
+  bool GetBitmap(uint16 resource_id, SkBitmap* bitmap) const;
+
+  // Writes the ARGB_8888 bitmaps of |bitmaps| to a pack at |path|. Bitmaps
+  // in other configurations are skipped.
+  static bool WritePack(const FilePath& path,
+                        const std::map<uint16, SkBitmap>& bitmaps);
+
+ private:
+  struct Entry;
+
+  scoped_ptr<file_util::MemoryMappedFile> mmap_;
+  const Entry* entries_;
+  size_t entry_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(DecodedImagePack);
+};
+
+}  // namespace ui
+
+#endif  // UI_BASE_RESOURCE_DECODED_IMAGE_PACK_H_
@@ -0,0 +1,99 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ui/base/resource/decoded_image_pack.h"
+
+#include <map>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace ui {
+
+namespace {
+
+SkBitmap MakeBitmap(int width, int height, SkColor color) {
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+  bitmap.allocPixels();
+  bitmap.eraseColor(color);
+  return bitmap;
+}
+
+}  // namespace
+
+TEST(DecodedImagePackTest, WriteAndLoad) {
+  ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  FilePath path = dir.path().Append(FILE_PATH_LITERAL("images.pak"));
+
+  std::map<uint16, SkBitmap> bitmaps;
+  bitmaps[7] = MakeBitmap(3, 5, SK_ColorRED);
+  bitmaps[2] = MakeBitmap(16, 1, SK_ColorBLUE);
+  SkBitmap a8;
+  a8.setConfig(SkBitmap::kA8_Config, 4, 4);
+  a8.allocPixels();
+  bitmaps[9] = a8;
+  ASSERT_TRUE(DecodedImagePack::WritePack(path, bitmaps));
+
+  DecodedImagePack pack;
+  ASSERT_TRUE(pack.Load(path));
+
+  SkBitmap bitmap;
+  ASSERT_TRUE(pack.GetBitmap(7, &bitmap));
+  EXPECT_EQ(3, bitmap.width());
+  EXPECT_EQ(5, bitmap.height());
+  EXPECT_TRUE(bitmap.isImmutable());
+  {
+    SkAutoLockPixels lock(bitmap);
+    EXPECT_EQ(SK_ColorRED, bitmap.getColor(2, 4));
+  }
+
+  ASSERT_TRUE(pack.GetBitmap(2, &bitmap));
+  EXPECT_EQ(16, bitmap.width());
+  EXPECT_EQ(1, bitmap.height());
+  {
+    SkAutoLockPixels lock(bitmap);
+    EXPECT_EQ(SK_ColorBLUE, bitmap.getColor(15, 0));
+  }
+
+  // Only ARGB_8888 bitmaps are stored.
+  EXPECT_FALSE(pack.GetBitmap(9, &bitmap));
+  EXPECT_FALSE(pack.GetBitmap(3, &bitmap));
+}
+
+TEST(DecodedImagePackTest, RejectsCorruptFiles) {
+  ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  FilePath path = dir.path().Append(FILE_PATH_LITERAL("images.pak"));
+
+  std::map<uint16, SkBitmap> bitmaps;
+  bitmaps[1] = MakeBitmap(8, 8, SK_ColorGREEN);
+  ASSERT_TRUE(DecodedImagePack::WritePack(path, bitmaps));
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(path, &contents));
+
+  // Pixels cut short.
+  ASSERT_EQ(static_cast<int>(contents.size() - 4),
+            file_util::WriteFile(path, contents.data(), contents.size() - 4));
+  DecodedImagePack truncated;
+  EXPECT_FALSE(truncated.Load(path));
+  SkBitmap bitmap;
+  EXPECT_FALSE(truncated.GetBitmap(1, &bitmap));
+
+  // Wrong magic.
+  contents[0] = 'X';
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            file_util::WriteFile(path, contents.data(), contents.size()));
+  DecodedImagePack bad_magic;
+  EXPECT_FALSE(bad_magic.Load(path));
+
+  DecodedImagePack missing;
+  EXPECT_FALSE(missing.Load(dir.path().Append(FILE_PATH_LITERAL("none"))));
+}
+
+}  // namespace ui
@@ -4,6 +4,8 @@
 
 #include "ui/base/resource/resource_bundle.h"
 
+#include <string.h>
+
 #include <vector>
 
 #include "base/command_line.h"
@@ -20,6 +22,7 @@
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/base/l10n/l10n_util.h"
 #include "ui/base/resource/data_pack.h"
+#include "ui/base/resource/decoded_image_pack.h"
 #include "ui/base/ui_base_paths.h"
 #include "ui/base/ui_base_switches.h"
 #include "ui/gfx/codec/jpeg_codec.h"
@@ -242,8 +245,17 @@ gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
 
   DCHECK(!data_packs_.empty()) << "Missing call to SetResourcesDataDLL?";
   ScopedVector<const SkBitmap> bitmaps;
+  size_t decoded_bytes = 0;
+  size_t mapped_bytes = 0;
   for (size_t i = 0; i < data_packs_.size(); ++i) {
-    SkBitmap* bitmap = LoadBitmap(*data_packs_[i], resource_id);
+    SkBitmap* bitmap = LoadMappedBitmap(*data_packs_[i], resource_id);
+    if (bitmap) {
+      mapped_bytes += bitmap->getSize();
+    } else {
+      bitmap = LoadBitmap(*data_packs_[i], resource_id);
+      if (bitmap)
+        decoded_bytes += bitmap->getSize();
+    }
     if (bitmap)
       bitmaps.push_back(bitmap);
   }
@@ -267,9 +279,64 @@ gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
   // Takes ownership of bitmaps.
   gfx::Image* image = new gfx::Image(tmp_bitmaps);
   images_[resource_id] = image;
+  decoded_image_bytes_ += decoded_bytes;
+  mapped_image_bytes_ += mapped_bytes;
   return *image;
 }
 
+bool ResourceBundle::WriteDecodedImagePack(float scale_factor,
+                                           const FilePath& path) {
+  static const unsigned char kPNGSignature[] = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+  };
+
+  std::map<uint16, SkBitmap> bitmaps;
+  for (size_t i = 0; i < data_packs_.size(); ++i) {
+    if (data_packs_[i]->GetScaleFactor() != scale_factor)
+      continue;
+    std::vector<uint16> resource_ids;
+    data_packs_[i]->GetResourceIds(&resource_ids);
+    for (size_t j = 0; j < resource_ids.size(); ++j) {
+      base::StringPiece data;
+      if (bitmaps.count(resource_ids[j]) ||
+          !data_packs_[i]->GetStringPiece(resource_ids[j], &data) ||
+          data.size() < sizeof(kPNGSignature) ||
+          memcmp(data.data(), kPNGSignature, sizeof(kPNGSignature)) != 0) {
+        continue;
+      }
+      SkBitmap bitmap;
+      if (gfx::PNGCodec::Decode(
+              reinterpret_cast<const unsigned char*>(data.data()),
+              data.size(), &bitmap)) {
+        bitmaps[resource_ids[j]] = bitmap;
+      }
+    }
+  }
+  return DecodedImagePack::WritePack(path, bitmaps);
+}
+
+bool ResourceBundle::LoadDecodedImagePack(float scale_factor,
+                                          const FilePath& path) {
+  scoped_ptr<DecodedImagePack> pack(new DecodedImagePack);
+  if (!pack->Load(path))
+    return false;
+  delete decoded_image_packs_[scale_factor];
+  decoded_image_packs_[scale_factor] = pack.release();
+  return true;
+}
+
+void ResourceBundle::GetImageMemoryStats(size_t* decoded_bytes,
+                                         size_t* mapped_bytes) {
+  base::AutoLock lock_scope(*images_and_fonts_lock_);
+  *decoded_bytes = decoded_image_bytes_;
+  *mapped_bytes = mapped_image_bytes_;
+}
+
+void ResourceBundle::PreloadImages(const std::vector<int>& resource_ids) {
+  for (size_t i = 0; i < resource_ids.size(); ++i)
+    GetImageNamed(resource_ids[i]);
+}
+
 gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id) {
   return GetNativeImageNamed(resource_id, RTL_DISABLED);
 }
@@ -331,18 +398,25 @@ void ResourceBundle::ReloadFonts() {
 
 ResourceBundle::ResourceBundle()
     : images_and_fonts_lock_(new base::Lock),
-      locale_resources_data_lock_(new base::Lock) {
+      locale_resources_data_lock_(new base::Lock),
+      decoded_image_bytes_(0),
+      mapped_image_bytes_(0) {
 }
 
 ResourceBundle::~ResourceBundle() {
   FreeImages();
   UnloadLocaleResources();
+  // The images pointing into the packs are gone.
+  STLDeleteContainerPairSecondPointers(decoded_image_packs_.begin(),
+                                       decoded_image_packs_.end());
 }
 
 void ResourceBundle::FreeImages() {
   STLDeleteContainerPairSecondPointers(images_.begin(),
                                        images_.end());
   images_.clear();
+  decoded_image_bytes_ = 0;
+  mapped_image_bytes_ = 0;
 }
 
 void ResourceBundle::LoadFontsIfNecessary() {
@@ -396,6 +470,18 @@ SkBitmap* ResourceBundle::LoadBitmap(const ResourceHandle& data_handle,
   return NULL;
 }
 
+SkBitmap* ResourceBundle::LoadMappedBitmap(const ResourceHandle& data_handle,
+                                           int resource_id) {
+  DecodedImagePackMap::const_iterator pack =
+      decoded_image_packs_.find(data_handle.GetScaleFactor());
+  if (pack == decoded_image_packs_.end())
+    return NULL;
+  scoped_ptr<SkBitmap> bitmap(new SkBitmap);
+  if (!pack->second->GetBitmap(resource_id, bitmap.get()))
+    return NULL;
+  return bitmap.release();
+}
+
 gfx::Image* ResourceBundle::GetEmptyImage() {
   base::AutoLock lock(*images_and_fonts_lock_);
 
@@ -10,6 +10,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/file_path.h"
@@ -35,6 +36,7 @@ class Image;
 
 namespace ui {
 
+class DecodedImagePack;
 class ResourceHandle;
 
 // ResourceBundle is a central facility to load images and other resources,
@@ -92,6 +94,22 @@ class UI_EXPORT ResourceBundle {
   // safe! You should call it immediately after calling InitSharedInstance.
   void AddDataPack(const FilePath& path, float scale_factor);
 
+  // Decodes the PNG images of the data packs with |scale_factor| and writes
+  // them to a DecodedImagePack at |path|. This decodes every image, so call
+  // it on a background thread.
+  bool WriteDecodedImagePack(float scale_factor, const FilePath& path);
+
+  // Maps the DecodedImagePack at |path|. Images of the data packs with
+  // |scale_factor| are then taken from it, shared read-only with the other
+  // processes that map it, instead of being decoded into private memory.
+  // Like AddDataPack(), this is not thread safe.
+  bool LoadDecodedImagePack(float scale_factor, const FilePath& path);
+
+  // Returns the bytes of image pixels cached by this process that were
+  // decoded into private memory, and that were mapped from a
+  // DecodedImagePack.
+  void GetImageMemoryStats(size_t* decoded_bytes, size_t* mapped_bytes);
+
   // Changes the locale for an already-initialized ResourceBundle, returning the
   // name of the newly-loaded locale.  Future calls to get strings will return
   // the strings for this new locale.  This has no effect on existing or future
@@ -111,6 +129,11 @@ class UI_EXPORT ResourceBundle {
   // image in Skia format by default. The ResourceBundle owns this.
   gfx::Image& GetImageNamed(int resource_id);
 
+  // Decodes and caches the images for |resource_ids| that aren't cached yet.
+  // May be called on any thread, so that images needed early can be decoded
+  // off the UI thread before it asks for them.
+  void PreloadImages(const std::vector<int>& resource_ids);
+
   // Similar to GetImageNamed, but rather than loading the image in Skia format,
   // it will load in the native platform type. This can avoid conversion from
   // one image type to another. ResourceBundle owns the result.
@@ -184,6 +207,11 @@ class UI_EXPORT ResourceBundle {
   // done.
   SkBitmap* LoadBitmap(const ResourceHandle& dll_inst, int resource_id);
 
+  // Returns a new SkBitmap pointing at the pixels of |resource_id| in the
+  // decoded image pack for |data_handle|'s scale, or NULL if there is none.
+  SkBitmap* LoadMappedBitmap(const ResourceHandle& data_handle,
+                             int resource_id);
+
   // Returns an empty image for when a resource cannot be loaded. This is a
   // bright red bitmap.
   gfx::Image* GetEmptyImage();
@@ -200,11 +228,20 @@ class UI_EXPORT ResourceBundle {
   scoped_ptr<ResourceHandle> locale_resources_data_;
   ScopedVector<ResourceHandle> data_packs_;
 
+  // Decoded images by scale factor. Owned.
+  typedef std::map<float, DecodedImagePack*> DecodedImagePackMap;
+  DecodedImagePackMap decoded_image_packs_;
+
   // Cached images. The ResourceBundle caches all retrieved images and keeps
   // ownership of the pointers.
   typedef std::map<int, gfx::Image*> ImageMap;
   ImageMap images_;
 
+  // Bytes of pixels in |images_| decoded privately and mapped from
+  // |decoded_image_packs_|.
+  size_t decoded_image_bytes_;
+  size_t mapped_image_bytes_;
+
   // The various fonts used. Cached to avoid repeated GDI creation/destruction.
   scoped_ptr<gfx::Font> base_font_;
   scoped_ptr<gfx::Font> bold_font_;
@@ -4,10 +4,27 @@
 
 #include "ui/base/resource/resource_data_dll_win.h"
 
+#include <vector>
+
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/win/resource_util.h"
 
+namespace {
+
+BOOL CALLBACK AppendResourceId(HMODULE module,
+                               LPCWSTR type,
+                               LPWSTR name,
+                               LONG_PTR param) {
+  if (IS_INTRESOURCE(name)) {
+    reinterpret_cast<std::vector<uint16>*>(param)->push_back(
+        static_cast<uint16>(reinterpret_cast<ULONG_PTR>(name)));
+  }
+  return TRUE;
+}
+
+}  // namespace
+
 namespace ui {
 
 ResourceDataDLL::ResourceDataDLL(HINSTANCE module) : module_(module) {
@@ -44,6 +61,13 @@ base::RefCountedStaticMemory* ResourceDataDLL::GetStaticMemory(
   return NULL;
 }
 
+void ResourceDataDLL::GetResourceIds(
+    std::vector<uint16>* resource_ids) const {
+  // Data resources are stored as BINDATA, see base::win::GetResourceFromModule.
+  EnumResourceNames(module_, L"BINDATA", &AppendResourceId,
+                    reinterpret_cast<LONG_PTR>(resource_ids));
+}
+
 ResourceHandle::TextEncodingType ResourceDataDLL::GetTextEncodingType() const {
   return BINARY;
 }
@@ -23,6 +23,8 @@ class ResourceDataDLL : public ResourceHandle {
                               base::StringPiece* data) const OVERRIDE;
   virtual base::RefCountedStaticMemory* GetStaticMemory(
       uint16 resource_id) const OVERRIDE;
+  virtual void GetResourceIds(
+      std::vector<uint16>* resource_ids) const OVERRIDE;
   virtual TextEncodingType GetTextEncodingType() const OVERRIDE;
   virtual float GetScaleFactor() const OVERRIDE;
 
@@ -6,6 +6,8 @@
 #define UI_BASE_RESOURCE_RESOURCE_HANDLE_H_
 #pragma once
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/string_piece.h"
 #include "ui/base/ui_export.h"
@@ -42,6 +44,9 @@ class UI_EXPORT ResourceHandle {
   virtual base::RefCountedStaticMemory* GetStaticMemory(
       uint16 resource_id) const = 0;
 
+  // Appends the ids of all the resources to |resource_ids|.
+  virtual void GetResourceIds(std::vector<uint16>* resource_ids) const = 0;
+
   // Get the encoding type of text resources.
   virtual TextEncodingType GetTextEncodingType() const = 0;
 
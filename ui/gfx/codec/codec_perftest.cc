@@ -0,0 +1,95 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "base/perftimer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/zlib/zlib.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/size.h"
+
+namespace gfx {
+
+namespace {
+
+// Roughly a maximized window screenshot.
+const int kWidth = 1280;
+const int kHeight = 800;
+
+// Encodes per measurement.
+const int kIterations = 10;
+
+// Fills |bitmap| with gradients and noise so that neither codec finds the
+// image trivially compressible.
+void MakeTestBitmap(SkBitmap* bitmap) {
+  bitmap->setConfig(SkBitmap::kARGB_8888_Config, kWidth, kHeight);
+  bitmap->allocPixels();
+  uint32 seed = 1;
+  for (int y = 0; y < kHeight; ++y) {
+    uint32* row = bitmap->getAddr32(0, y);
+    for (int x = 0; x < kWidth; ++x) {
+      seed = seed * 1103515245 + 12345;
+      row[x] = SkPackARGB32(255, x & 0xFF, y & 0xFF, (seed >> 16) & 0x3F);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(CodecPerfTest, PNGEncode) {
+  SkBitmap bitmap;
+  MakeTestBitmap(&bitmap);
+  SkAutoLockPixels lock(bitmap);
+  const unsigned char* pixels =
+      reinterpret_cast<const unsigned char*>(bitmap.getPixels());
+  std::vector<unsigned char> output;
+
+  const struct {
+    const char* name;
+    int level;
+  } kLevels[] = {
+    { "PNGEncode_default", Z_DEFAULT_COMPRESSION },
+    { "PNGEncode_fast", Z_BEST_SPEED },
+  };
+  for (size_t i = 0; i < arraysize(kLevels); ++i) {
+    PerfTimeLogger timer(kLevels[i].name);
+    for (int j = 0; j < kIterations; ++j) {
+      ASSERT_TRUE(PNGCodec::EncodeWithCompressionLevel(
+          pixels, PNGCodec::FORMAT_BGRA, Size(kWidth, kHeight),
+          bitmap.rowBytes(), true, std::vector<PNGCodec::Comment>(),
+          kLevels[i].level, &output));
+    }
+    timer.Done();
+  }
+
+  PerfTimeLogger timer("PNGEncode_alpha");
+  for (int j = 0; j < kIterations; ++j) {
+    ASSERT_TRUE(PNGCodec::EncodeWithCompressionLevel(
+        pixels, PNGCodec::FORMAT_BGRA, Size(kWidth, kHeight),
+        bitmap.rowBytes(), false, std::vector<PNGCodec::Comment>(),
+        Z_BEST_SPEED, &output));
+  }
+  timer.Done();
+}
+
+TEST(CodecPerfTest, JPEGEncode) {
+  SkBitmap bitmap;
+  MakeTestBitmap(&bitmap);
+  SkAutoLockPixels lock(bitmap);
+  std::vector<unsigned char> output;
+
+  PerfTimeLogger timer("JPEGEncode");
+  for (int j = 0; j < kIterations; ++j) {
+    ASSERT_TRUE(JPEGCodec::Encode(
+        reinterpret_cast<const unsigned char*>(bitmap.getPixels()),
+        JPEGCodec::FORMAT_SkBitmap, kWidth, kHeight, bitmap.rowBytes(), 90,
+        &output));
+  }
+  timer.Done();
+}
+
+}  // namespace gfx
@@ -7,6 +7,7 @@
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/string_util.h"
+#include "build/build_config.h"
 #include "ui/gfx/size.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkUnPreMultiply.h"
@@ -26,6 +27,14 @@ extern "C" {
 #endif
 }
 
+#if defined(ARCH_CPU_X86_FAMILY) && (defined(__SSE2__) || defined(_M_X64))
+#define PNG_CODEC_USE_SSE2
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#define PNG_CODEC_USE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace gfx {
 
 namespace {
@@ -33,7 +42,31 @@ namespace {
 // Converts BGRA->RGBA and RGBA->BGRA.
 void ConvertBetweenBGRAandRGBA(const unsigned char* input, int pixel_width,
                                unsigned char* output, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
+  int x = 0;
+#if defined(PNG_CODEC_USE_SSE2)
+  // Swap bytes 0 and 2 of each 32-bit pixel, four pixels at a time.
+  const __m128i green_alpha_mask = _mm_set1_epi32(0xFF00FF00);
+  const __m128i low_byte_mask = _mm_set1_epi32(0x000000FF);
+  for (; x + 4 <= pixel_width; x += 4) {
+    __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[x * 4]));
+    __m128i swapped = _mm_or_si128(
+        _mm_and_si128(pixels, green_alpha_mask),
+        _mm_or_si128(
+            _mm_slli_epi32(_mm_and_si128(pixels, low_byte_mask), 16),
+            _mm_and_si128(_mm_srli_epi32(pixels, 16), low_byte_mask)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[x * 4]), swapped);
+  }
+#elif defined(PNG_CODEC_USE_NEON)
+  for (; x + 16 <= pixel_width; x += 16) {
+    uint8x16x4_t pixels = vld4q_u8(&input[x * 4]);
+    uint8x16_t first = pixels.val[0];
+    pixels.val[0] = pixels.val[2];
+    pixels.val[2] = first;
+    vst4q_u8(&output[x * 4], pixels);
+  }
+#endif
+  for (; x < pixel_width; x++) {
     const unsigned char* pixel_in = &input[x * 4];
     unsigned char* pixel_out = &output[x * 4];
     pixel_out[0] = pixel_in[2];
@@ -45,7 +78,15 @@ void ConvertBetweenBGRAandRGBA(const unsigned char* input, int pixel_width,
 
 void ConvertRGBAtoRGB(const unsigned char* rgba, int pixel_width,
                       unsigned char* rgb, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
+  int x = 0;
+#if defined(PNG_CODEC_USE_NEON)
+  for (; x + 16 <= pixel_width; x += 16) {
+    uint8x16x4_t pixels = vld4q_u8(&rgba[x * 4]);
+    uint8x16x3_t out = { { pixels.val[0], pixels.val[1], pixels.val[2] } };
+    vst3q_u8(&rgb[x * 3], out);
+  }
+#endif
+  for (; x < pixel_width; x++) {
     const unsigned char* pixel_in = &rgba[x * 4];
     unsigned char* pixel_out = &rgb[x * 3];
     pixel_out[0] = pixel_in[0];
@@ -556,7 +597,15 @@ void FakeFlushCallback(png_structp png) {
 
 void ConvertBGRAtoRGB(const unsigned char* bgra, int pixel_width,
                       unsigned char* rgb, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
+  int x = 0;
+#if defined(PNG_CODEC_USE_NEON)
+  for (; x + 16 <= pixel_width; x += 16) {
+    uint8x16x4_t pixels = vld4q_u8(&bgra[x * 4]);
+    uint8x16x3_t out = { { pixels.val[2], pixels.val[1], pixels.val[0] } };
+    vst3q_u8(&rgb[x * 3], out);
+  }
+#endif
+  for (; x < pixel_width; x++) {
     const unsigned char* pixel_in = &bgra[x * 4];
     unsigned char* pixel_out = &rgb[x * 3];
     pixel_out[0] = pixel_in[2];
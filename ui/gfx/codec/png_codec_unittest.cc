@@ -357,6 +357,50 @@ TEST(PNGCodec, EncodeDecodeBGRA) {
   ASSERT_TRUE(original == decoded);
 }
 
+// The row converters handle several pixels at a time; an odd width exercises
+// the leftover pixels at the end of each row.
+TEST(PNGCodec, EncodeBGRAOddWidth) {
+  const int w = 37, h = 5;
+  std::vector<unsigned char> original;
+  MakeRGBAImage(w, h, true, &original);
+
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(PNGCodec::Encode(&original[0], PNGCodec::FORMAT_BGRA,
+                               Size(w, h), w * 4, false,
+                               std::vector<PNGCodec::Comment>(),
+                               &encoded));
+  std::vector<unsigned char> decoded;
+  int outw, outh;
+  ASSERT_TRUE(PNGCodec::Decode(&encoded[0], encoded.size(),
+                               PNGCodec::FORMAT_RGBA, &decoded,
+                               &outw, &outh));
+  ASSERT_EQ(w, outw);
+  ASSERT_EQ(h, outh);
+  ASSERT_EQ(original.size(), decoded.size());
+  for (size_t i = 0; i < original.size(); i += 4) {
+    EXPECT_EQ(original[i + 2], decoded[i]);
+    EXPECT_EQ(original[i + 1], decoded[i + 1]);
+    EXPECT_EQ(original[i], decoded[i + 2]);
+    EXPECT_EQ(original[i + 3], decoded[i + 3]);
+  }
+
+  // Discarding transparency packs each pixel into three bytes.
+  ASSERT_TRUE(PNGCodec::Encode(&original[0], PNGCodec::FORMAT_BGRA,
+                               Size(w, h), w * 4, true,
+                               std::vector<PNGCodec::Comment>(),
+                               &encoded));
+  ASSERT_TRUE(PNGCodec::Decode(&encoded[0], encoded.size(),
+                               PNGCodec::FORMAT_RGBA, &decoded,
+                               &outw, &outh));
+  ASSERT_EQ(original.size(), decoded.size());
+  for (size_t i = 0; i < original.size(); i += 4) {
+    EXPECT_EQ(original[i + 2], decoded[i]);
+    EXPECT_EQ(original[i + 1], decoded[i + 1]);
+    EXPECT_EQ(original[i], decoded[i + 2]);
+    EXPECT_EQ(0xFF, decoded[i + 3]);
+  }
+}
+
 TEST(PNGCodec, DecodePalette) {
   const int w = 20, h = 20;
 
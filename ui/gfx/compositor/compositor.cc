@@ -5,6 +5,7 @@
 #include "ui/gfx/compositor/compositor.h"
 
 #include "base/command_line.h"
+#include "base/metrics/histogram.h"
 #include "base/threading/thread_restrictions.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebCompositor.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebFloatPoint.h"
@@ -27,6 +28,10 @@ namespace {
 const double kDefaultRefreshRate = 60.0;
 const double kTestRefreshRate = 100.0;
 
+// Frames ending further apart than this aren't part of the same animation, so
+// the time between them isn't recorded as a frame interval.
+const int kMaxFrameIntervalMs = 1000;
+
 webkit_glue::WebThreadImpl* g_compositor_thread = NULL;
 
 bool test_compositor_enabled = false;
@@ -331,6 +336,18 @@ void Compositor::SwizzleRGBAToBGRAAndFlip(unsigned char* pixels,
 }
 
 void Compositor::NotifyEnd() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!last_frame_end_.is_null()) {
+    base::TimeDelta interval = now - last_frame_end_;
+    if (interval.InMilliseconds() < kMaxFrameIntervalMs) {
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Compositor.FrameInterval", interval,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMilliseconds(kMaxFrameIntervalMs), 50);
+    }
+  }
+  last_frame_end_ = now;
+
   FOR_EACH_OBSERVER(CompositorObserver,
                     observer_list_,
                     OnCompositingEnded(this));
@@ -9,6 +9,7 @@
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/observer_list.h"
+#include "base/time.h"
 #include "third_party/WebKit/Source/Platform/chromium/public/WebLayer.h"
 #include "third_party/WebKit/Source/Platform/chromium/public/WebLayerTreeView.h"
 #include "third_party/WebKit/Source/Platform/chromium/public/WebLayerTreeViewClient.h"
@@ -237,6 +238,9 @@ class COMPOSITOR_EXPORT Compositor
   // for completion.
   bool swap_posted_;
 
+  // When the last frame finished, for measuring the time between frames.
+  base::TimeTicks last_frame_end_;
+
   friend class base::RefCounted<Compositor>;
 };
 
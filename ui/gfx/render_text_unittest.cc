@@ -980,6 +980,30 @@ TEST_F(RenderTextTest, StringSizeHeight) {
   }
 }
 
+// Laying out the same text again, possibly from shaping results cached by an
+// earlier instance, must give the same metrics.
+TEST_F(RenderTextTest, RepeatedLayoutMatches) {
+  const wchar_t* kTexts[] = {
+    L"Hello World!",
+    L"abc\x05d0\x05d1\x05d2def",
+    L"\x0915\x093f\x0915\x094d\x0915",
+  };
+
+  for (size_t i = 0; i < arraysize(kTexts); ++i) {
+    scoped_ptr<RenderText> first(RenderText::CreateRenderText());
+    first->SetText(WideToUTF16(kTexts[i]));
+    scoped_ptr<RenderText> second(RenderText::CreateRenderText());
+    second->SetText(WideToUTF16(kTexts[i]));
+
+    EXPECT_EQ(first->GetStringSize(), second->GetStringSize());
+    for (size_t j = 0; j <= first->text().length(); ++j) {
+      SelectionModel model(j, CURSOR_FORWARD);
+      EXPECT_EQ(first->GetCursorBounds(model, true),
+                second->GetCursorBounds(model, true)) << i << " " << j;
+    }
+  }
+}
+
 TEST_F(RenderTextTest, CursorBoundsInReplacementMode) {
   scoped_ptr<RenderText> render_text(RenderText::CreateRenderText());
   render_text->SetText(ASCIIToUTF16("abcdefg"));
@@ -7,7 +7,10 @@
 #include <algorithm>
 
 #include "base/i18n/break_iterator.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/mru_cache.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/threading/thread_restrictions.h"
@@ -29,6 +32,33 @@ const int kMaxItems = 10000;
 // TODO(msw): Review memory use/failure? Max string length? Alternate approach?
 const int kMaxGlyphs = 100000;
 
+// The number of shaped runs kept for reuse by all RenderTextWin instances.
+const size_t kMaxShapedRuns = 500;
+
+// The glyphs and placement Uniscribe produced for a run, after any font
+// substitution. Tab titles, labels and omnibox suggestions re-create the same
+// strings constantly, so shaping a run is cached across RenderTextWin
+// instances.
+struct ShapedRun {
+  gfx::Font font;
+  SCRIPT_ANALYSIS script_analysis;
+  std::vector<WORD> glyphs;
+  std::vector<WORD> logical_clusters;
+  std::vector<SCRIPT_VISATTR> visible_attributes;
+  std::vector<int> advance_widths;
+  std::vector<GOFFSET> offsets;
+  ABC abc_widths;
+};
+
+// Shaped runs keyed by ShapedRunKey(). Only used on the UI thread.
+struct ShapedRunCache {
+  ShapedRunCache() : runs(kMaxShapedRuns) {}
+  base::OwningMRUCache<std::string, ShapedRun*> runs;
+};
+
+base::LazyInstance<ShapedRunCache>::Leaky g_shaped_run_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Callback to |EnumEnhMetaFile()| to intercept font creation.
 int CALLBACK MetaFileEnumProc(HDC hdc,
                               HANDLETABLE* table,
@@ -185,6 +215,73 @@ int GetGlyphXBoundary(internal::TextRun* run, size_t index, bool trailing) {
 
 }  // namespace internal
 
+namespace {
+
+// Returns the key identifying the shaping of |run_text| with the font and
+// script analysis (including direction) of |run|.
+std::string ShapedRunKey(const internal::TextRun* run,
+                         const wchar_t* run_text) {
+  const int kStyleMask = (Font::BOLD | Font::ITALIC);
+  const int font_info[] = { run->font.GetFontSize(), run->font.GetHeight(),
+                            run->font_style & kStyleMask };
+  std::string key(reinterpret_cast<const char*>(&run->script_analysis),
+                  sizeof(run->script_analysis));
+  key.append(reinterpret_cast<const char*>(font_info), sizeof(font_info));
+  key.append(run->font.GetFontName());
+  key.push_back('\0');
+  key.append(reinterpret_cast<const char*>(run_text),
+             run->range.length() * sizeof(wchar_t));
+  return key;
+}
+
+// Fills |run| with the glyphs and placement of |shaped|.
+void ApplyShapedRun(const ShapedRun& shaped, internal::TextRun* run) {
+  run->font = shaped.font;
+  run->script_analysis = shaped.script_analysis;
+  run->glyph_count = shaped.glyphs.size();
+  run->logical_clusters.reset(new WORD[run->range.length()]);
+  std::copy(shaped.logical_clusters.begin(), shaped.logical_clusters.end(),
+            run->logical_clusters.get());
+  run->glyphs.reset(new WORD[run->glyph_count]);
+  std::copy(shaped.glyphs.begin(), shaped.glyphs.end(), run->glyphs.get());
+  run->visible_attributes.reset(new SCRIPT_VISATTR[run->glyph_count]);
+  std::copy(shaped.visible_attributes.begin(),
+            shaped.visible_attributes.end(),
+            run->visible_attributes.get());
+  run->advance_widths.reset(new int[run->glyph_count]);
+  std::copy(shaped.advance_widths.begin(), shaped.advance_widths.end(),
+            run->advance_widths.get());
+  run->offsets.reset(new GOFFSET[run->glyph_count]);
+  std::copy(shaped.offsets.begin(), shaped.offsets.end(), run->offsets.get());
+  run->abc_widths = shaped.abc_widths;
+}
+
+// Returns a copy of the glyphs and placement of |run|.
+ShapedRun* CreateShapedRun(const internal::TextRun* run) {
+  ShapedRun* shaped = new ShapedRun;
+  shaped->font = run->font;
+  shaped->script_analysis = run->script_analysis;
+  shaped->logical_clusters.assign(
+      run->logical_clusters.get(),
+      run->logical_clusters.get() + run->range.length());
+  if (run->glyph_count > 0) {
+    shaped->glyphs.assign(run->glyphs.get(),
+                          run->glyphs.get() + run->glyph_count);
+    shaped->visible_attributes.assign(
+        run->visible_attributes.get(),
+        run->visible_attributes.get() + run->glyph_count);
+    shaped->advance_widths.assign(
+        run->advance_widths.get(),
+        run->advance_widths.get() + run->glyph_count);
+    shaped->offsets.assign(run->offsets.get(),
+                           run->offsets.get() + run->glyph_count);
+  }
+  shaped->abc_widths = run->abc_widths;
+  return shaped;
+}
+
+}  // namespace
+
 // static
 HDC RenderTextWin::cached_hdc_ = NULL;
 
@@ -617,6 +714,21 @@ void RenderTextWin::LayoutVisualText() {
     const std::vector<Font>* linked_fonts = NULL;
     Font original_font = run->font;
 
+    // Reuse the shaping of an identical run, if there is one.
+    ShapedRunCache* cache = g_shaped_run_cache.Pointer();
+    const std::string key = ShapedRunKey(run, run_text);
+    base::OwningMRUCache<std::string, ShapedRun*>::iterator cached =
+        cache->runs.Get(key);
+    UMA_HISTOGRAM_BOOLEAN("RenderText.ShapedRunCacheHit",
+                          cached != cache->runs.end());
+    if (cached != cache->runs.end()) {
+      ApplyShapedRun(*cached->second, run);
+      string_size_.set_height(std::max(string_size_.height(),
+                                       run->font.GetHeight()));
+      common_baseline_ = std::max(common_baseline_, run->font.GetBaseline());
+      continue;
+    }
+
     // Select the font desired for glyph generation.
     SelectObject(cached_hdc_, run->font.GetNativeFont());
 
@@ -740,6 +852,7 @@ void RenderTextWin::LayoutVisualText() {
                        &(run->abc_widths));
       DCHECK(SUCCEEDED(hr));
     }
+    cache->runs.Put(key, CreateShapedRun(run));
   }
 
   // Build the array of bidirectional embedding levels.
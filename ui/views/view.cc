@@ -138,6 +138,8 @@ View::View()
       registered_for_visible_bounds_notification_(false),
       clip_insets_(0, 0, 0, 0),
       needs_layout_(true),
+      cache_paint_(false),
+      paint_cache_valid_(false),
       flip_canvas_on_paint_for_rtl_ui_(false),
       paint_to_layer_(false),
       accelerator_registration_delayed_(false),
@@ -711,6 +713,7 @@ void View::SchedulePaint() {
 }
 
 void View::SchedulePaintInRect(const gfx::Rect& rect_in_dip) {
+  paint_cache_valid_ = false;
   if (!visible_ || !painting_enabled_)
     return;
 
@@ -724,7 +727,8 @@ void View::SchedulePaintInRect(const gfx::Rect& rect_in_dip) {
 }
 
 void View::Paint(gfx::Canvas* canvas) {
-  TRACE_EVENT0("views", "View::Paint");
+  TRACE_EVENT1("views", "View::Paint",
+               "class", TRACE_STR_COPY(GetClassName().c_str()));
 
   ScopedCanvas scoped_canvas(canvas);
 
@@ -747,7 +751,16 @@ void View::Paint(gfx::Canvas* canvas) {
   canvas->Translate(GetMirroredPosition());
   canvas->Transform(GetTransform());
 
-  PaintCommon(canvas);
+  if (cache_paint_)
+    PaintFromCache(canvas);
+  else
+    PaintCommon(canvas);
+}
+
+void View::SetCachePaint(bool cache_paint) {
+  cache_paint_ = cache_paint;
+  paint_cache_.reset();
+  paint_cache_valid_ = false;
 }
 
 ThemeProvider* View::GetThemeProvider() const {
@@ -1519,7 +1532,12 @@ void View::SchedulePaintBoundsChanged(SchedulePaintType type) {
   // If we have a layer and the View's size did not change, we do not need to
   // schedule any paints since the layer will be redrawn at its new location
   // during the next Draw() cycle in the compositor.
-  if (!layer() || type == SCHEDULE_PAINT_SIZE_CHANGED) {
+  if (!layer() && cache_paint_ && type == SCHEDULE_PAINT_SIZE_SAME) {
+    // Moving doesn't change what a View paints, so keep |paint_cache_| and
+    // only repaint the area around the View in its parent.
+    if (parent_ && painting_enabled_)
+      parent_->SchedulePaintInRect(ConvertRectToParent(GetLocalBounds()));
+  } else if (!layer() || type == SCHEDULE_PAINT_SIZE_CHANGED) {
     // Otherwise, if the size changes or we don't have a layer then we need to
     // use SchedulePaint to invalidate the area occupied by the View.
     SchedulePaint();
@@ -1554,6 +1572,29 @@ void View::PaintCommon(gfx::Canvas* canvas) {
   PaintChildren(canvas);
 }
 
+void View::PaintFromCache(gfx::Canvas* canvas) {
+  if (!visible_ || !painting_enabled_ || size().IsEmpty())
+    return;
+
+  if (!paint_cache_.get() ||
+      paint_cache_->sk_canvas()->getDevice()->width() != width() ||
+      paint_cache_->sk_canvas()->getDevice()->height() != height()) {
+    paint_cache_.reset(new gfx::Canvas(size(), false));
+    paint_cache_valid_ = false;
+  }
+
+  if (!paint_cache_valid_) {
+    TRACE_EVENT1("views", "View::PaintFromCache",
+                 "class", TRACE_STR_COPY(GetClassName().c_str()));
+    paint_cache_->DrawColor(SK_ColorTRANSPARENT, SkXfermode::kClear_Mode);
+    PaintCommon(paint_cache_.get());
+    paint_cache_valid_ = true;
+  }
+
+  canvas->DrawBitmapInt(
+      paint_cache_->sk_canvas()->getDevice()->accessBitmap(false), 0, 0);
+}
+
 // Tree operations -------------------------------------------------------------
 
 void View::DoRemoveChildView(View* view,
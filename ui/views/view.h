@@ -461,6 +461,16 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // the hierarchy beneath it.
   virtual void Paint(gfx::Canvas* canvas);
 
+  // Sets whether this View keeps what it and its children painted in an
+  // offscreen bitmap, and draws that bitmap instead of painting again until
+  // SchedulePaint() is called on it or one of its descendants. Meant for
+  // complex views that get repainted because of changes around them, such as
+  // an animation in a sibling. The bitmap is transparent where nothing was
+  // painted, but text drawn onto a transparent area loses subpixel
+  // antialiasing, so views that draw text should paint a background. Has no
+  // effect while the View paints to a layer.
+  void SetCachePaint(bool cache_paint);
+
   // The background object is owned by this object and may be NULL.
   void set_background(Background* b) { background_.reset(b); }
   const Background* background() const { return background_.get(); }
@@ -1147,6 +1157,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // invoke OnPaint() on the View.
   void PaintCommon(gfx::Canvas* canvas);
 
+  // Paints the View from |paint_cache_|, painting into the cache first if it
+  // is out of date.
+  void PaintFromCache(gfx::Canvas* canvas);
+
   // Tree operations -----------------------------------------------------------
 
   // Removes |view| from the hierarchy tree.  If |update_focus_cycle| is true,
@@ -1410,6 +1424,12 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Background
   scoped_ptr<Background> background_;
 
+  // The result of the last paint when SetCachePaint(true) was called, and
+  // whether it still matches what the View would paint.
+  bool cache_paint_;
+  scoped_ptr<gfx::Canvas> paint_cache_;
+  bool paint_cache_valid_;
+
   // Border.
   scoped_ptr<Border> border_;
 
@@ -2133,6 +2133,69 @@ TEST_F(ViewTest, SetBoundsPaint) {
   EXPECT_EQ(gfx::Rect(10, 10, 40, 40), paint_rect);
 }
 
+namespace {
+
+class PaintCountingView : public View {
+ public:
+  PaintCountingView() : paint_count_(0) {}
+
+  int paint_count() const { return paint_count_; }
+
+  virtual void OnPaint(gfx::Canvas* canvas) OVERRIDE {
+    ++paint_count_;
+  }
+
+ private:
+  int paint_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintCountingView);
+};
+
+}  // namespace
+
+// A View caching its paint only repaints itself and its children after it or
+// a descendant schedules a paint.
+TEST_F(ViewTest, CachePaint) {
+  View top_view;
+  PaintCountingView* cached = new PaintCountingView;
+  PaintCountingView* child = new PaintCountingView;
+  top_view.SetBoundsRect(gfx::Rect(0, 0, 100, 100));
+  cached->SetBoundsRect(gfx::Rect(10, 10, 50, 50));
+  child->SetBoundsRect(gfx::Rect(5, 5, 10, 10));
+  top_view.AddChildView(cached);
+  cached->AddChildView(child);
+  cached->SetCachePaint(true);
+
+  gfx::Canvas canvas(gfx::Size(100, 100), false);
+  top_view.Paint(&canvas);
+  EXPECT_EQ(1, cached->paint_count());
+  EXPECT_EQ(1, child->paint_count());
+
+  top_view.Paint(&canvas);
+  EXPECT_EQ(1, cached->paint_count());
+  EXPECT_EQ(1, child->paint_count());
+
+  // Moving the cached view doesn't change its contents.
+  cached->SetBoundsRect(gfx::Rect(20, 20, 50, 50));
+  top_view.Paint(&canvas);
+  EXPECT_EQ(1, cached->paint_count());
+
+  child->SchedulePaint();
+  top_view.Paint(&canvas);
+  EXPECT_EQ(2, cached->paint_count());
+  EXPECT_EQ(2, child->paint_count());
+
+  // Resizing repaints.
+  cached->SetBoundsRect(gfx::Rect(20, 20, 60, 60));
+  top_view.Paint(&canvas);
+  EXPECT_EQ(3, cached->paint_count());
+
+  cached->SetCachePaint(false);
+  top_view.Paint(&canvas);
+  top_view.Paint(&canvas);
+  EXPECT_EQ(5, cached->paint_count());
+}
+
 // Tests conversion methods with a transform.
 TEST_F(ViewTest, ConvertPointToViewWithTransform) {
   TestView top_view;
@@ -128,6 +128,7 @@ class APPCACHE_EXPORT AppCache : public base::RefCounted<AppCache> {
   friend class AppCacheHost;
   friend class AppCacheStorageImplTest;
   friend class AppCacheUpdateJobTest;
+  friend class AppCacheWorkingSet;
   friend class base::RefCounted<AppCache>;
 
   ~AppCache();
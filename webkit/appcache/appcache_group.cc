@@ -87,14 +87,18 @@ void AppCacheGroup::AddCache(AppCache* complete_cache) {
   DCHECK(complete_cache->is_complete());
   complete_cache->set_owning_group(this);
 
+  AppCacheWorkingSet* working_set = service_->storage()->working_set();
   if (!newest_complete_cache_) {
     newest_complete_cache_ = complete_cache;
+    working_set->AddNamespaces(complete_cache);
     return;
   }
 
   if (complete_cache->IsNewerThan(newest_complete_cache_)) {
+    working_set->RemoveNamespaces(newest_complete_cache_);
     old_caches_.push_back(newest_complete_cache_);
     newest_complete_cache_ = complete_cache;
+    working_set->AddNamespaces(complete_cache);
 
     // Update hosts of older caches to add a reference to the newest cache.
     for (Caches::iterator it = old_caches_.begin();
@@ -113,6 +117,7 @@ void AppCacheGroup::AddCache(AppCache* complete_cache) {
 void AppCacheGroup::RemoveCache(AppCache* cache) {
   DCHECK(cache->associated_hosts().empty());
   if (cache == newest_complete_cache_) {
+    service_->storage()->working_set()->RemoveNamespaces(cache);
     AppCache* tmp_cache = newest_complete_cache_;
     newest_complete_cache_ = NULL;
     tmp_cache->set_owning_group(NULL);  // may cause this group to be deleted
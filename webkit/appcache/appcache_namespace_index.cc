@@ -0,0 +1,126 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "webkit/appcache/appcache_namespace_index.h"
+
+#include "base/logging.h"
+#include "base/stl_util.h"
+
+namespace appcache {
+
+AppCacheNamespaceIndex::Node::Node() {}
+
+AppCacheNamespaceIndex::Node::~Node() {
+  STLDeleteValues(&children);
+}
+
+AppCacheNamespaceIndex::AppCacheNamespaceIndex() {}
+
+AppCacheNamespaceIndex::~AppCacheNamespaceIndex() {}
+
+void AppCacheNamespaceIndex::AddNamespaces(
+    int64 cache_id,
+    const NamespaceVector& intercepts,
+    const NamespaceVector& fallbacks,
+    const std::vector<GURL>& online_whitelist) {
+  DCHECK(cached_ids_.find(cache_id) == cached_ids_.end());
+  for (size_t i = 0; i < intercepts.size(); ++i)
+    AddItem(cache_id, false, intercepts[i]);
+  for (size_t i = 0; i < fallbacks.size(); ++i)
+    AddItem(cache_id, false, fallbacks[i]);
+  for (size_t i = 0; i < online_whitelist.size(); ++i)
+    AddItem(cache_id, true, Namespace(INTERCEPT_NAMESPACE,
+                                      online_whitelist[i], GURL()));
+}
+
+void AppCacheNamespaceIndex::RemoveNamespaces(int64 cache_id) {
+  std::map<int64, int>::iterator found = cached_ids_.find(cache_id);
+  if (found == cached_ids_.end())
+    return;
+  cached_ids_.erase(found);
+  RemoveItems(&root_, cache_id);
+}
+
+void AppCacheNamespaceIndex::Clear() {
+  STLDeleteValues(&root_.children);
+  root_.items.clear();
+  cached_ids_.clear();
+}
+
+void AppCacheNamespaceIndex::FindNamespaces(
+    int64 cache_id,
+    const GURL& url,
+    const Namespace** intercept,
+    const Namespace** fallback,
+    bool* in_network_namespace) const {
+  *intercept = NULL;
+  *fallback = NULL;
+  *in_network_namespace = false;
+  if (cached_ids_.find(cache_id) == cached_ids_.end())
+    return;
+
+  // Items deeper in the trie belong to longer namespaces, so the last match
+  // seen on the way down is the one that wins.
+  const std::string& spec = url.spec();
+  const Node* node = &root_;
+  for (size_t i = 0; node; ++i) {
+    for (size_t j = 0; j < node->items.size(); ++j) {
+      const Item& item = node->items[j];
+      if (item.cache_id != cache_id)
+        continue;
+      if (item.is_network)
+        *in_network_namespace = true;
+      else if (item.ns.type == INTERCEPT_NAMESPACE)
+        *intercept = &item.ns;
+      else
+        *fallback = &item.ns;
+    }
+    if (i == spec.length())
+      break;
+    std::map<char, Node*>::const_iterator child = node->children.find(spec[i]);
+    node = child != node->children.end() ? child->second : NULL;
+  }
+}
+
+void AppCacheNamespaceIndex::AddItem(
+    int64 cache_id, bool is_network, const Namespace& ns) {
+  const std::string& spec = ns.namespace_url.spec();
+  Node* node = &root_;
+  for (size_t i = 0; i < spec.length(); ++i) {
+    Node*& child = node->children[spec[i]];
+    if (!child)
+      child = new Node;
+    node = child;
+  }
+  Item item;
+  item.cache_id = cache_id;
+  item.is_network = is_network;
+  item.ns = ns;
+  node->items.push_back(item);
+  ++cached_ids_[cache_id];
+}
+
+// static
+bool AppCacheNamespaceIndex::RemoveItems(Node* node, int64 cache_id) {
+  std::vector<Item>::iterator item = node->items.begin();
+  while (item != node->items.end()) {
+    if (item->cache_id == cache_id)
+      item = node->items.erase(item);
+    else
+      ++item;
+  }
+
+  std::map<char, Node*>::iterator child = node->children.begin();
+  while (child != node->children.end()) {
+    if (RemoveItems(child->second, cache_id)) {
+      delete child->second;
+      node->children.erase(child++);
+    } else {
+      ++child;
+    }
+  }
+  return node->items.empty() && node->children.empty();
+}
+
+}  // namespace appcache
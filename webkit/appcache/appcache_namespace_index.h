@@ -0,0 +1,75 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef WEBKIT_APPCACHE_APPCACHE_NAMESPACE_INDEX_H_
+#define WEBKIT_APPCACHE_APPCACHE_NAMESPACE_INDEX_H_
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "googleurl/src/gurl.h"
+#include "webkit/appcache/appcache_export.h"
+#include "webkit/appcache/appcache_interfaces.h"
+
+namespace appcache {
+
+// A prefix trie over the intercept, fallback and online whitelist namespaces
+// of many caches, keyed by the namespace url spec. Finding the namespaces
+// that contain a url costs one walk down the trie along the url's spec
+// rather than a prefix comparison against every namespace.
+class APPCACHE_EXPORT AppCacheNamespaceIndex {
+ public:
+  AppCacheNamespaceIndex();
+  ~AppCacheNamespaceIndex();
+
+  void AddNamespaces(int64 cache_id,
+                     const NamespaceVector& intercepts,
+                     const NamespaceVector& fallbacks,
+                     const std::vector<GURL>& online_whitelist);
+  void RemoveNamespaces(int64 cache_id);
+  void Clear();
+
+  bool empty() const { return cached_ids_.empty(); }
+
+  // Looks up |url| in the namespaces of |cache_id|. The longest matching
+  // intercept and fallback namespaces are returned, or NULL if there is
+  // none; |in_network_namespace| is set if the url is in the online
+  // whitelist. The returned pointers are valid until the index changes.
+  void FindNamespaces(int64 cache_id,
+                      const GURL& url,
+                      const Namespace** intercept,
+                      const Namespace** fallback,
+                      bool* in_network_namespace) const;
+
+ private:
+  struct Item {
+    int64 cache_id;
+    bool is_network;
+    Namespace ns;
+  };
+
+  struct Node {
+    Node();
+    ~Node();
+
+    std::map<char, Node*> children;
+    std::vector<Item> items;
+  };
+
+  void AddItem(int64 cache_id, bool is_network, const Namespace& ns);
+
+  // Drops the items of |cache_id| below |node|. Returns true if |node| is
+  // left with neither items nor children.
+  static bool RemoveItems(Node* node, int64 cache_id);
+
+  Node root_;
+  std::map<int64, int> cached_ids_;  // cache id -> number of items
+
+  DISALLOW_COPY_AND_ASSIGN(AppCacheNamespaceIndex);
+};
+
+}  // namespace appcache
+
+#endif  // WEBKIT_APPCACHE_APPCACHE_NAMESPACE_INDEX_H_
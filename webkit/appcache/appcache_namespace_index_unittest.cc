@@ -0,0 +1,73 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webkit/appcache/appcache_namespace_index.h"
+
+namespace appcache {
+
+TEST(AppCacheNamespaceIndexTest, FindNamespaces) {
+  const GURL kUrl("http://blah/a/b/page.html");
+  NamespaceVector intercepts;
+  intercepts.push_back(Namespace(INTERCEPT_NAMESPACE,
+                                 GURL("http://blah/a/"),
+                                 GURL("http://blah/intercept")));
+  NamespaceVector fallbacks;
+  fallbacks.push_back(Namespace(FALLBACK_NAMESPACE,
+                                GURL("http://blah/"),
+                                GURL("http://blah/fallback1")));
+  fallbacks.push_back(Namespace(FALLBACK_NAMESPACE,
+                                GURL("http://blah/a/b/"),
+                                GURL("http://blah/fallback2")));
+  std::vector<GURL> whitelist;
+  whitelist.push_back(GURL("http://blah/a/c/"));
+
+  AppCacheNamespaceIndex index;
+  EXPECT_TRUE(index.empty());
+  index.AddNamespaces(1, intercepts, fallbacks, whitelist);
+  index.AddNamespaces(2, NamespaceVector(), fallbacks, std::vector<GURL>());
+  EXPECT_FALSE(index.empty());
+
+  const Namespace* intercept = NULL;
+  const Namespace* fallback = NULL;
+  bool in_network_namespace = true;
+  index.FindNamespaces(1, kUrl, &intercept, &fallback, &in_network_namespace);
+  ASSERT_TRUE(intercept);
+  EXPECT_EQ(GURL("http://blah/intercept"), intercept->target_url);
+  ASSERT_TRUE(fallback);
+  EXPECT_EQ(GURL("http://blah/fallback2"), fallback->target_url);
+  EXPECT_FALSE(in_network_namespace);
+
+  // Only the namespaces of the requested cache are considered.
+  index.FindNamespaces(2, GURL("http://blah/a/c/page.html"),
+                       &intercept, &fallback, &in_network_namespace);
+  EXPECT_FALSE(intercept);
+  ASSERT_TRUE(fallback);
+  EXPECT_EQ(GURL("http://blah/fallback1"), fallback->target_url);
+  EXPECT_FALSE(in_network_namespace);
+
+  index.FindNamespaces(1, GURL("http://blah/a/c/page.html"),
+                       &intercept, &fallback, &in_network_namespace);
+  EXPECT_TRUE(intercept);
+  EXPECT_TRUE(in_network_namespace);
+
+  index.FindNamespaces(1, GURL("http://other/a/b/page.html"),
+                       &intercept, &fallback, &in_network_namespace);
+  EXPECT_FALSE(intercept);
+  EXPECT_FALSE(fallback);
+  EXPECT_FALSE(in_network_namespace);
+
+  index.RemoveNamespaces(1);
+  index.FindNamespaces(1, kUrl, &intercept, &fallback, &in_network_namespace);
+  EXPECT_FALSE(intercept);
+  EXPECT_FALSE(fallback);
+  index.FindNamespaces(2, kUrl, &intercept, &fallback, &in_network_namespace);
+  ASSERT_TRUE(fallback);
+  EXPECT_EQ(GURL("http://blah/fallback2"), fallback->target_url);
+
+  index.RemoveNamespaces(2);
+  EXPECT_TRUE(index.empty());
+}
+
+}  // namespace appcache
@@ -1475,8 +1475,10 @@ void AppCacheStorageImpl::FindResponseForMainRequest(
       AppCacheWorkingSet::GroupMap::const_iterator found =
           groups_in_use->find(preferred_manifest_url);
       if (found != groups_in_use->end() &&
-          FindResponseForMainRequestInGroup(
-              found->second, *url_ptr, delegate)) {
+          (FindResponseForMainRequestInGroup(
+               found->second, *url_ptr, delegate) ||
+           FindNamespaceResponseForMainRequestInGroup(
+               found->second, *url_ptr, delegate))) {
           return;
       }
     } else {
@@ -1530,6 +1532,37 @@ bool AppCacheStorageImpl::FindResponseForMainRequestInGroup(
   return true;
 }
 
+bool AppCacheStorageImpl::FindNamespaceResponseForMainRequestInGroup(
+    AppCacheGroup* group,  const GURL& url, Delegate* delegate) {
+  AppCache* cache = group->newest_complete_cache();
+  if (group->is_obsolete() || !cache)
+    return false;
+
+  // Like the database lookup, intercepts beat fallbacks and urls in the
+  // cache's network namespace are left alone. Anything less clear cut is
+  // left to the database task.
+  const Namespace* intercept = NULL;
+  const Namespace* fallback = NULL;
+  bool in_network_namespace = false;
+  working_set()->namespace_index()->FindNamespaces(
+      cache->cache_id(), url, &intercept, &fallback, &in_network_namespace);
+  const Namespace* found_namespace = intercept ? intercept : fallback;
+  if (!found_namespace || in_network_namespace)
+    return false;
+
+  AppCacheEntry* entry = cache->GetEntry(found_namespace->target_url);
+  if (!entry || entry->IsForeign())
+    return false;
+
+  ScheduleSimpleTask(
+      base::Bind(
+          &AppCacheStorageImpl::DeliverShortCircuitedFindNamespaceResponse,
+          weak_factory_.GetWeakPtr(), url, *entry, *found_namespace,
+          make_scoped_refptr(group), make_scoped_refptr(cache),
+          make_scoped_refptr(GetOrCreateDelegateReference(delegate))));
+  return true;
+}
+
 void AppCacheStorageImpl::DeliverShortCircuitedFindMainResponse(
     const GURL& url,
     const AppCacheEntry& found_entry,
@@ -1547,6 +1580,25 @@ void AppCacheStorageImpl::DeliverShortCircuitedFindMainResponse(
   }
 }
 
+void AppCacheStorageImpl::DeliverShortCircuitedFindNamespaceResponse(
+    const GURL& url,
+    const AppCacheEntry& found_entry,
+    const Namespace& found_namespace,
+    scoped_refptr<AppCacheGroup> group,
+    scoped_refptr<AppCache> cache,
+    scoped_refptr<DelegateReference> delegate_ref) {
+  if (delegate_ref->delegate) {
+    bool is_fallback = found_namespace.type == FALLBACK_NAMESPACE;
+    DelegateReferenceVector delegates(1, delegate_ref);
+    CallOnMainResponseFound(
+        &delegates, url,
+        is_fallback ? AppCacheEntry() : found_entry,
+        found_namespace.target_url,
+        is_fallback ? found_entry : AppCacheEntry(),
+        cache->cache_id(), group->group_id(), group->manifest_url());
+  }
+}
+
 void AppCacheStorageImpl::CallOnMainResponseFound(
     DelegateReferenceVector* delegates,
     const GURL& url, const AppCacheEntry& entry,
@@ -114,12 +114,21 @@ class AppCacheStorageImpl : public AppCacheStorage {
   // Sometimes we can respond without having to query the database.
   bool FindResponseForMainRequestInGroup(
       AppCacheGroup* group,  const GURL& url, Delegate* delegate);
+  bool FindNamespaceResponseForMainRequestInGroup(
+      AppCacheGroup* group,  const GURL& url, Delegate* delegate);
   void DeliverShortCircuitedFindMainResponse(
       const GURL& url,
       const AppCacheEntry& found_entry,
       scoped_refptr<AppCacheGroup> group,
       scoped_refptr<AppCache> newest_cache,
       scoped_refptr<DelegateReference> delegate_ref);
+  void DeliverShortCircuitedFindNamespaceResponse(
+      const GURL& url,
+      const AppCacheEntry& found_entry,
+      const Namespace& found_namespace,
+      scoped_refptr<AppCacheGroup> group,
+      scoped_refptr<AppCache> newest_cache,
+      scoped_refptr<DelegateReference> delegate_ref);
 
   void CallOnMainResponseFound(
       DelegateReferenceVector* delegates,
@@ -22,6 +22,9 @@ namespace appcache {
 
 static const int kBufferSize = 32768;
 static const size_t kMaxConcurrentUrlFetches = 2;
+// SPDY multiplexes requests over one connection, so servers that speak it can
+// take many more fetches at once without tying up sockets.
+static const size_t kMaxConcurrentSpdyUrlFetches = 16;
 static const int kMax503Retries = 3;
 
 // Helper class for collecting hosts per frontend when sending notifications
@@ -301,6 +304,7 @@ AppCacheUpdateJob::AppCacheUpdateJob(AppCacheService* service,
       internal_state_(FETCH_MANIFEST),
       master_entries_completed_(0),
       url_fetches_completed_(0),
+      max_concurrent_url_fetches_(kMaxConcurrentUrlFetches),
       manifest_fetcher_(NULL),
       stored_state_(UNSTORED) {
 }
@@ -449,6 +453,8 @@ void AppCacheUpdateJob::HandleManifestFetchCompleted(
     manifest_data_ = fetcher->manifest_data();
     manifest_response_info_.reset(
         new net::HttpResponseInfo(request->response_info()));
+    if (request->response_info().was_fetched_via_spdy)
+      max_concurrent_url_fetches_ = kMaxConcurrentSpdyUrlFetches;
     if (update_type_ == UPGRADE_ATTEMPT)
       CheckIfManifestChanged();  // continues asynchronously
     else
@@ -543,6 +549,11 @@ void AppCacheUpdateJob::HandleUrlFetchCompleted(URLFetcher* fetcher) {
       ? request->GetResponseCode() : -1;
   AppCacheEntry& entry = url_file_list_.find(url)->second;
 
+  // Entries can be on other hosts than the manifest; widen the window as soon
+  // as any of them turns out to be served over SPDY.
+  if (request->response_info().was_fetched_via_spdy)
+    max_concurrent_url_fetches_ = kMaxConcurrentSpdyUrlFetches;
+
   if (response_code / 100 == 2) {
     // Associate storage with the new entry.
     DCHECK(fetcher->response_writer());
@@ -931,7 +942,7 @@ void AppCacheUpdateJob::FetchUrls() {
   // Fetch each URL in the list according to section 6.9.4 step 17.1-17.3.
   // Fetch up to the concurrent limit. Other fetches will be triggered as each
   // each fetch completes.
-  while (pending_url_fetches_.size() < kMaxConcurrentUrlFetches &&
+  while (pending_url_fetches_.size() < max_concurrent_url_fetches_ &&
          !urls_to_fetch_.empty()) {
     UrlToFetch url_to_fetch = urls_to_fetch_.front();
     urls_to_fetch_.pop_front();
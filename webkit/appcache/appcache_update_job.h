@@ -260,6 +260,10 @@ class APPCACHE_EXPORT AppCacheUpdateJob : public AppCacheStorage::Delegate,
   AppCache::EntryMap url_file_list_;
   size_t url_fetches_completed_;
 
+  // How many URL fetches may be in flight at once. Raised once a response
+  // shows the server speaks SPDY.
+  size_t max_concurrent_url_fetches_;
+
   // Helper container to track which urls have not been fetched yet. URLs are
   // removed when the fetch is initiated. Flag indicates whether an attempt
   // to load the URL from storage has already been tried and failed.
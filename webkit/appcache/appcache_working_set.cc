@@ -17,6 +17,7 @@ AppCacheWorkingSet::~AppCacheWorkingSet() {
   DCHECK(caches_.empty());
   DCHECK(groups_.empty());
   DCHECK(groups_by_origin_.empty());
+  DCHECK(namespace_index_.empty());
 }
 
 void AppCacheWorkingSet::Disable() {
@@ -27,6 +28,7 @@ void AppCacheWorkingSet::Disable() {
   groups_.clear();
   groups_by_origin_.clear();
   response_infos_.clear();
+  namespace_index_.Clear();
 }
 
 void AppCacheWorkingSet::AddCache(AppCache* cache) {
@@ -64,6 +66,19 @@ void AppCacheWorkingSet::RemoveGroup(AppCacheGroup* group) {
   }
 }
 
+void AppCacheWorkingSet::AddNamespaces(AppCache* cache) {
+  if (is_disabled_)
+    return;
+  namespace_index_.AddNamespaces(cache->cache_id(),
+                                 cache->intercept_namespaces_,
+                                 cache->fallback_namespaces_,
+                                 cache->online_whitelist_namespaces_);
+}
+
+void AppCacheWorkingSet::RemoveNamespaces(AppCache* cache) {
+  namespace_index_.RemoveNamespaces(cache->cache_id());
+}
+
 void AppCacheWorkingSet::AddResponseInfo(AppCacheResponseInfo* info) {
   if (is_disabled_)
     return;
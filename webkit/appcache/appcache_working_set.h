@@ -10,6 +10,7 @@
 #include "base/hash_tables.h"
 #include "googleurl/src/gurl.h"
 #include "webkit/appcache/appcache_export.h"
+#include "webkit/appcache/appcache_namespace_index.h"
 
 namespace appcache {
 
@@ -54,6 +55,14 @@ class APPCACHE_EXPORT AppCacheWorkingSet {
     return (it != response_infos_.end()) ? it->second : NULL;
   }
 
+  // The namespaces of the newest complete cache of each group in the working
+  // set. Groups add their caches as they are committed.
+  void AddNamespaces(AppCache* cache);
+  void RemoveNamespaces(AppCache* cache);
+  const AppCacheNamespaceIndex* namespace_index() const {
+    return &namespace_index_;
+  }
+
  private:
   typedef base::hash_map<int64, AppCache*> CacheMap;
   typedef std::map<GURL, GroupMap> GroupsByOriginMap;
@@ -68,6 +77,7 @@ class APPCACHE_EXPORT AppCacheWorkingSet {
   GroupMap groups_;
   GroupsByOriginMap groups_by_origin_;  // origin -> (manifest -> group)
   ResponseInfoMap response_infos_;
+  AppCacheNamespaceIndex namespace_index_;
   bool is_disabled_;
 };
 
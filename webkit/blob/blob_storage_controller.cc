@@ -4,7 +4,13 @@
 
 #include "webkit/blob/blob_storage_controller.h"
 
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
+#include "base/platform_file.h"
 #include "googleurl/src/gurl.h"
 #include "net/base/upload_data.h"
 #include "webkit/blob/blob_data.h"
@@ -31,10 +37,63 @@ GURL ClearBlobUrlRef(const GURL& url) {
 
 static const int64 kMaxMemoryUsage = 1024 * 1024 * 1024;  // 1G
 
+// Past this much memory, finished blobs are written to disk if they are at
+// least kMinSpillSize. Smaller blobs aren't worth a file of their own.
+static const int64 kMemoryBudget = 256 * 1024 * 1024;  // 256M
+static const int64 kMinSpillSize = 1024 * 1024;  // 1M
+
 }  // namespace
 
+struct BlobStorageController::SpillResult {
+  SpillResult() : success(false) {}
+
+  bool success;
+  FilePath file_path;
+  base::Time modification_time;
+};
+
+// Runs on the file thread. The data items of a finished blob are never
+// modified, and the reply's reference keeps them alive until it runs.
+// static
+void BlobStorageController::WriteToTempFile(BlobData* blob_data,
+                                            SpillResult* result) {
+  FILE* file = file_util::CreateAndOpenTemporaryFile(&result->file_path);
+  if (!file)
+    return;
+  bool success = true;
+  for (std::vector<BlobData::Item>::const_iterator iter =
+           blob_data->items().begin();
+       iter != blob_data->items().end() && success; ++iter) {
+    if (iter->type != BlobData::TYPE_DATA)
+      continue;
+    size_t length = static_cast<size_t>(iter->length);
+    success = fwrite(iter->data.data() + static_cast<size_t>(iter->offset),
+                     1, length, file) == length;
+  }
+  if (!file_util::CloseFile(file))
+    success = false;
+
+  base::PlatformFileInfo file_info;
+  if (success && file_util::GetFileInfo(result->file_path, &file_info)) {
+    result->modification_time = file_info.last_modified;
+    result->success = true;
+  } else {
+    file_util::Delete(result->file_path, false);
+  }
+}
+
 BlobStorageController::BlobStorageController()
-    : memory_usage_(0) {
+    : memory_usage_(0),
+      memory_budget_(kMemoryBudget),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+}
+
+BlobStorageController::BlobStorageController(
+    base::MessageLoopProxy* file_thread)
+    : memory_usage_(0),
+      memory_budget_(kMemoryBudget),
+      file_thread_(file_thread),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
 }
 
 BlobStorageController::~BlobStorageController() {
@@ -98,9 +157,9 @@ void BlobStorageController::AppendBlobDataItem(
 
   memory_usage_ += target_blob_data->GetMemoryUsage();
 
-  // If we're using too much memory, drop this blob.
-  // TODO(michaeln): Blob memory storage does not yet spill over to disk,
-  // until it does, we'll prevent memory usage over a max amount.
+  // If we're using too much memory, drop this blob. Blobs are only spilled
+  // to disk once they are finished, so this still caps the memory held by
+  // blobs under construction.
   if (memory_usage_ > kMaxMemoryUsage)
     RemoveBlob(url);
 }
@@ -112,9 +171,14 @@ void BlobStorageController::FinishBuildingBlob(
   BlobMap::iterator found = unfinalized_blob_map_.find(url.spec());
   if (found == unfinalized_blob_map_.end())
     return;
-  found->second->set_content_type(content_type);
-  blob_map_[url.spec()] = found->second;
+  scoped_refptr<BlobData> blob_data = found->second;
+  blob_data->set_content_type(content_type);
+  blob_map_[url.spec()] = blob_data;
   unfinalized_blob_map_.erase(found);
+
+  UMA_HISTOGRAM_MEMORY_KB("Storage.Blob.TotalMemoryUsage",
+                          static_cast<int>(memory_usage_ / 1024));
+  MaybeSpillToDisk(blob_data);
 }
 
 void BlobStorageController::AddFinishedBlob(const GURL& url,
@@ -161,6 +225,94 @@ bool BlobStorageController::RemoveFromMapHelper(
   return true;
 }
 
+void BlobStorageController::MaybeSpillToDisk(BlobData* blob_data) {
+  if (!file_thread_ || memory_usage_ <= memory_budget_)
+    return;
+  if (blob_data->GetMemoryUsage() < kMinSpillSize ||
+      spilling_blobs_.count(blob_data)) {
+    return;
+  }
+
+  spilling_blobs_.insert(blob_data);
+  SpillResult* result = new SpillResult;
+  file_thread_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&BlobStorageController::WriteToTempFile, make_scoped_refptr(blob_data), result),
+      base::Bind(&BlobStorageController::DidSpillToDisk,
+                 weak_factory_.GetWeakPtr(), file_thread_,
+                 make_scoped_refptr(blob_data), base::Owned(result)));
+}
+
+// static
+void BlobStorageController::DidSpillToDisk(
+    base::WeakPtr<BlobStorageController> controller,
+    scoped_refptr<base::MessageLoopProxy> file_thread,
+    scoped_refptr<BlobData> blob_data,
+    SpillResult* result) {
+  UMA_HISTOGRAM_BOOLEAN("Storage.Blob.SpillSucceeded", result->success);
+  if (!result->success) {
+    if (controller)
+      controller->spilling_blobs_.erase(blob_data.get());
+    return;
+  }
+
+  // Take ownership of the file first so that it is deleted if nothing ends
+  // up using it.
+  scoped_refptr<ShareableFileReference> spilled_file =
+      ShareableFileReference::GetOrCreate(
+          result->file_path,
+          ShareableFileReference::DELETE_ON_FINAL_RELEASE,
+          file_thread);
+  if (controller) {
+    controller->SwapInSpilledBlob(blob_data, spilled_file,
+                                  result->modification_time);
+  }
+}
+
+void BlobStorageController::SwapInSpilledBlob(
+    BlobData* blob_data,
+    ShareableFileReference* spilled_file,
+    const base::Time& modification_time) {
+  spilling_blobs_.erase(blob_data);
+  BlobDataUsageMap::iterator found = blob_data_usage_count_.find(blob_data);
+  if (found == blob_data_usage_count_.end())
+    return;  // Removed while it was being written.
+
+  // Requests already reading |blob_data| hold their own reference and keep
+  // reading from memory; anything that looks the blob up from now on gets
+  // the copy backed by the file. Slices of the copy share the file.
+  scoped_refptr<BlobData> spilled_blob_data(new BlobData);
+  spilled_blob_data->set_content_type(blob_data->content_type());
+  spilled_blob_data->set_content_disposition(
+      blob_data->content_disposition());
+  uint64 file_offset = 0;
+  for (std::vector<BlobData::Item>::const_iterator iter =
+           blob_data->items().begin();
+       iter != blob_data->items().end(); ++iter) {
+    if (iter->type == BlobData::TYPE_DATA) {
+      spilled_blob_data->AppendFile(spilled_file->path(), file_offset,
+                                    iter->length, modification_time);
+      file_offset += iter->length;
+    } else {
+      DCHECK(iter->type == BlobData::TYPE_FILE);
+      AppendFileItem(spilled_blob_data, iter->file_path, iter->offset,
+                     iter->length, iter->expected_modification_time);
+    }
+  }
+  spilled_blob_data->AttachShareableFileReference(spilled_file);
+
+  blob_data_usage_count_[spilled_blob_data] = found->second;
+  blob_data_usage_count_.erase(found);
+  for (BlobMap::iterator iter = blob_map_.begin();
+       iter != blob_map_.end(); ++iter) {
+    if (iter->second == blob_data)
+      iter->second = spilled_blob_data;
+  }
+
+  memory_usage_ -= blob_data->GetMemoryUsage();
+  UMA_HISTOGRAM_MEMORY_KB("Storage.Blob.SpilledSize",
+                          static_cast<int>(file_offset / 1024));
+}
 
 BlobData* BlobStorageController::GetBlobDataFromUrl(const GURL& url) {
   BlobMap::iterator found = blob_map_.find(
@@ -6,10 +6,12 @@
 #define WEBKIT_BLOB_BLOB_STORAGE_CONTROLLER_H_
 
 #include <map>
+#include <set>
 #include <string>
 
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/process.h"
 #include "webkit/blob/blob_data.h"
 #include "webkit/blob/blob_export.h"
@@ -18,6 +20,7 @@ class GURL;
 class FilePath;
 
 namespace base {
+class MessageLoopProxy;
 class Time;
 }
 namespace net {
@@ -30,6 +33,11 @@ namespace webkit_blob {
 class BLOB_EXPORT BlobStorageController {
  public:
   BlobStorageController();
+
+  // Once the bytes held in memory exceed the memory budget, large blobs are
+  // written to temporary files on |file_thread| as they are finished and
+  // from then on are served from those files.
+  explicit BlobStorageController(base::MessageLoopProxy* file_thread);
   ~BlobStorageController();
 
   void StartBuildingBlob(const GURL& url);
@@ -44,6 +52,10 @@ class BLOB_EXPORT BlobStorageController {
   // and updated in place.
   void ResolveBlobReferencesInUploadData(net::UploadData* upload_data);
 
+  int64 memory_usage() const { return memory_usage_; }
+
+  void set_memory_budget_for_testing(int64 budget) { memory_budget_ = budget; }
+
  private:
   friend class ViewBlobInternalsJob;
 
@@ -60,6 +72,22 @@ class BLOB_EXPORT BlobStorageController {
 
   bool RemoveFromMapHelper(BlobMap* map, const GURL& url);
 
+  // Writes the in-memory items of |blob_data| to a temporary file if it is
+  // large and the memory budget has been exceeded.
+  void MaybeSpillToDisk(BlobData* blob_data);
+  struct SpillResult;
+  static void WriteToTempFile(BlobData* blob_data, SpillResult* result);
+  static void DidSpillToDisk(
+      base::WeakPtr<BlobStorageController> controller,
+      scoped_refptr<base::MessageLoopProxy> file_thread,
+      scoped_refptr<BlobData> blob_data,
+      SpillResult* result);
+  // Replaces |blob_data| with a copy whose in-memory items are read from the
+  // file behind |spilled_file| instead.
+  void SwapInSpilledBlob(BlobData* blob_data,
+                         ShareableFileReference* spilled_file,
+                         const base::Time& modification_time);
+
   void IncrementBlobDataUsage(BlobData* blob_data);
   // Returns true if no longer in use.
   bool DecrementBlobDataUsage(BlobData* blob_data);
@@ -71,11 +99,20 @@ class BLOB_EXPORT BlobStorageController {
   // we count only the items of TYPE_DATA which are held in memory and not
   // items of TYPE_FILE.
   int64 memory_usage_;
+  int64 memory_budget_;
+
+  // NULL if blobs are never spilled to disk.
+  scoped_refptr<base::MessageLoopProxy> file_thread_;
+
+  // Blobs whose bytes are being written to disk.
+  std::set<BlobData*> spilling_blobs_;
 
   // Multiple urls can refer to the same blob data, this map keeps track of
   // how many urls refer to a BlobData.
   BlobDataUsageMap blob_data_usage_count_;
 
+  base::WeakPtrFactory<BlobStorageController> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(BlobStorageController);
 };
 
@@ -3,8 +3,11 @@
 // found in the LICENSE file.
 
 #include "base/file_path.h"
+#include "base/file_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/message_loop_proxy.h"
 #include "base/time.h"
 #include "net/base/upload_data.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -233,4 +236,78 @@ TEST(BlobStorageControllerTest, ResolveBlobReferencesInUploadData) {
   EXPECT_TRUE(upload_data->elements()->at(7) == upload_element2);
 }
 
+TEST(BlobStorageControllerTest, SpillToDisk) {
+  MessageLoop message_loop;
+  BlobStorageController blob_storage_controller(
+      base::MessageLoopProxy::current());
+  blob_storage_controller.set_memory_budget_for_testing(0);
+
+  const std::string data1(1024 * 1024, 'a');
+  const std::string data2("Data2");
+  scoped_refptr<BlobData> blob_data(new BlobData());
+  blob_data->AppendData(data1);
+  blob_data->AppendFile(FilePath(FILE_PATH_LITERAL("File1.txt")),
+                        10, 1024, base::Time());
+  blob_data->AppendData(data2);
+
+  GURL blob_url1("blob://url_1");
+  blob_storage_controller.AddFinishedBlob(blob_url1, blob_data);
+  GURL blob_url2("blob://url_2");
+  blob_storage_controller.CloneBlob(blob_url2, blob_url1);
+  EXPECT_EQ(static_cast<int64>(data1.size() + data2.size()),
+            blob_storage_controller.memory_usage());
+
+  // Until the write completes the blob is still served from memory.
+  BlobData* blob_data_found =
+      blob_storage_controller.GetBlobDataFromUrl(blob_url1);
+  ASSERT_TRUE(blob_data_found != NULL);
+  EXPECT_TRUE(*blob_data_found == *blob_data);
+
+  message_loop.RunAllPending();
+  EXPECT_EQ(0, blob_storage_controller.memory_usage());
+
+  blob_data_found = blob_storage_controller.GetBlobDataFromUrl(blob_url1);
+  ASSERT_TRUE(blob_data_found != NULL);
+  EXPECT_EQ(blob_data_found,
+            blob_storage_controller.GetBlobDataFromUrl(blob_url2));
+  ASSERT_EQ(3U, blob_data_found->items().size());
+  const BlobData::Item& item1 = blob_data_found->items().at(0);
+  const BlobData::Item& item3 = blob_data_found->items().at(2);
+  EXPECT_EQ(BlobData::TYPE_FILE, item1.type);
+  EXPECT_EQ(0U, item1.offset);
+  EXPECT_EQ(data1.size(), item1.length);
+  EXPECT_TRUE(blob_data->items().at(1) == blob_data_found->items().at(1));
+  EXPECT_EQ(BlobData::TYPE_FILE, item3.type);
+  EXPECT_EQ(item1.file_path, item3.file_path);
+  EXPECT_EQ(data1.size(), item3.offset);
+  EXPECT_EQ(data2.size(), item3.length);
+
+  const FilePath spilled_path = item1.file_path;
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(spilled_path, &contents));
+  EXPECT_EQ(data1 + data2, contents);
+
+  // Slices of the spilled blob refer to the same file.
+  scoped_refptr<BlobData> slice_data(new BlobData());
+  slice_data->AppendBlob(blob_url1, data1.size() - 2, 4);
+  GURL blob_url3("blob://url_3");
+  blob_storage_controller.AddFinishedBlob(blob_url3, slice_data);
+  blob_data_found = blob_storage_controller.GetBlobDataFromUrl(blob_url3);
+  ASSERT_TRUE(blob_data_found != NULL);
+  ASSERT_EQ(2U, blob_data_found->items().size());
+  EXPECT_EQ(spilled_path, blob_data_found->items().at(0).file_path);
+  EXPECT_EQ(data1.size() - 2, blob_data_found->items().at(0).offset);
+  EXPECT_EQ(2U, blob_data_found->items().at(0).length);
+  EXPECT_EQ(0, blob_storage_controller.memory_usage());
+
+  // The file is deleted once no blob refers to it.
+  blob_storage_controller.RemoveBlob(blob_url1);
+  blob_storage_controller.RemoveBlob(blob_url2);
+  message_loop.RunAllPending();
+  EXPECT_TRUE(file_util::PathExists(spilled_path));
+  blob_storage_controller.RemoveBlob(blob_url3);
+  message_loop.RunAllPending();
+  EXPECT_FALSE(file_util::PathExists(spilled_path));
+}
+
 }  // namespace webkit_blob
@@ -4,10 +4,13 @@
 
 #include "webkit/dom_storage/dom_storage_area.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/time.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebString.h"
 #include "webkit/database/database_util.h"
@@ -24,11 +27,28 @@ namespace dom_storage {
 
 static const int kCommitTimerSeconds = 1;
 
+// After a commit, the next one waits long enough that the average write
+// rate of an area stays under this many bytes per second, within the
+// maximum delay. Origins rewriting large values keep batching them instead
+// of keeping the disk busy.
+static const size_t kMaxCommitBytesPerSecond = 64 * 1024;
+static const int kMaxCommitDelaySeconds = 10;
+
 DomStorageArea::CommitBatch::CommitBatch()
   : clear_all_first(false) {
 }
 DomStorageArea::CommitBatch::~CommitBatch() {}
 
+size_t DomStorageArea::CommitBatch::GetDataSize() const {
+  size_t count = 0;
+  for (ValuesMap::const_iterator it = changed_values.begin();
+       it != changed_values.end(); ++it) {
+    count += (it->first.length() + it->second.string().length()) *
+        sizeof(char16);
+  }
+  return count;
+}
+
 
 // static
 const FilePath::CharType DomStorageArea::kDatabaseFileExtension[] =
@@ -60,7 +80,8 @@ DomStorageArea::DomStorageArea(
       task_runner_(task_runner),
       map_(new DomStorageMap(kPerAreaQuota)),
       is_initial_import_done_(true),
-      is_shutdown_(false) {
+      is_shutdown_(false),
+      last_commit_size_(0) {
   if (namespace_id == kLocalStorageNamespaceId && !directory.empty()) {
     FilePath path = directory.Append(DatabaseFileNameFromOrigin(origin_));
     backing_.reset(new DomStorageDatabase(path));
@@ -240,12 +261,19 @@ DomStorageArea::CommitBatch* DomStorageArea::CreateCommitBatchIfNeeded() {
       task_runner_->PostDelayedTask(
           FROM_HERE,
           base::Bind(&DomStorageArea::OnCommitTimer, this),
-          base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+          ComputeCommitDelay());
     }
   }
   return commit_batch_.get();
 }
 
+base::TimeDelta DomStorageArea::ComputeCommitDelay() const {
+  int64 delay_ms = last_commit_size_ * 1000 / kMaxCommitBytesPerSecond;
+  delay_ms = std::max<int64>(delay_ms, kCommitTimerSeconds * 1000);
+  delay_ms = std::min<int64>(delay_ms, kMaxCommitDelaySeconds * 1000);
+  return base::TimeDelta::FromMilliseconds(delay_ms);
+}
+
 void DomStorageArea::OnCommitTimer() {
   DCHECK_EQ(kLocalStorageNamespaceId, namespace_id_);
   if (is_shutdown_)
@@ -259,6 +287,7 @@ void DomStorageArea::OnCommitTimer() {
   // a task for immediate execution on the commit sequence.
   DCHECK(task_runner_->IsRunningOnPrimarySequence());
   in_flight_commit_batch_ = commit_batch_.Pass();
+  last_commit_size_ = in_flight_commit_batch_->GetDataSize();
   bool success = task_runner_->PostShutdownBlockingTask(
       FROM_HERE,
       DomStorageTaskRunner::COMMIT_SEQUENCE,
@@ -270,10 +299,15 @@ void DomStorageArea::CommitChanges() {
   // This method executes on the commit sequence.
   DCHECK(task_runner_->IsRunningOnCommitSequence());
   DCHECK(in_flight_commit_batch_.get());
+  base::TimeTicks start_time = base::TimeTicks::Now();
   bool success = backing_->CommitChanges(
       in_flight_commit_batch_->clear_all_first,
       in_flight_commit_batch_->changed_values);
   DCHECK(success);  // TODO(michaeln): what if it fails?
+  UMA_HISTOGRAM_TIMES("LocalStorage.CommitTime",
+                      base::TimeTicks::Now() - start_time);
+  UMA_HISTOGRAM_COUNTS("LocalStorage.CommitSizeKB",
+                       in_flight_commit_batch_->GetDataSize() / 1024);
   task_runner_->PostTask(
       FROM_HERE,
       base::Bind(&DomStorageArea::OnCommitComplete, this));
@@ -290,7 +324,7 @@ void DomStorageArea::OnCommitComplete() {
     task_runner_->PostDelayedTask(
         FROM_HERE,
         base::Bind(&DomStorageArea::OnCommitTimer, this),
-        base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+        ComputeCommitDelay());
   }
 }
 
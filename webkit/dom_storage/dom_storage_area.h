@@ -11,6 +11,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/nullable_string16.h"
 #include "base/string16.h"
+#include "base/time.h"
 #include "googleurl/src/gurl.h"
 #include "webkit/dom_storage/dom_storage_database.h"
 #include "webkit/dom_storage/dom_storage_types.h"
@@ -75,6 +76,7 @@ class DomStorageArea
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, TestDatabaseFilePath);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitTasks);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitChangesAtShutdown);
+  FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitDelay);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, PurgeMemory);
   friend class base::RefCountedThreadSafe<DomStorageArea>;
@@ -84,6 +86,9 @@ class DomStorageArea
     ValuesMap changed_values;
     CommitBatch();
     ~CommitBatch();
+
+    // Returns the number of bytes of keys and values to write.
+    size_t GetDataSize() const;
   };
 
   ~DomStorageArea();
@@ -97,6 +102,7 @@ class DomStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  base::TimeDelta ComputeCommitDelay() const;
   void OnCommitTimer();
   void CommitChanges();
   void OnCommitComplete();
@@ -113,6 +119,8 @@ class DomStorageArea
   bool is_shutdown_;
   scoped_ptr<CommitBatch> commit_batch_;
   scoped_ptr<CommitBatch> in_flight_commit_batch_;
+  // Size of the last batch committed, which sets the delay of the next one.
+  size_t last_commit_size_;
 };
 
 }  // namespace dom_storage
@@ -192,6 +192,23 @@ TEST_F(DomStorageAreaTest, BackingDatabaseOpened) {
   }
 }
 
+TEST_F(DomStorageAreaTest, CommitDelay) {
+  scoped_refptr<DomStorageArea> area(
+      new DomStorageArea(kLocalStorageNamespaceId, kOrigin, FilePath(), NULL));
+  const base::TimeDelta kMinDelay = area->ComputeCommitDelay();
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1), kMinDelay);
+
+  // Small commits don't slow down the next one.
+  area->last_commit_size_ = 1024;
+  EXPECT_EQ(kMinDelay, area->ComputeCommitDelay());
+
+  // Large ones do, up to a point.
+  area->last_commit_size_ = 256 * 1024;
+  EXPECT_EQ(base::TimeDelta::FromSeconds(4), area->ComputeCommitDelay());
+  area->last_commit_size_ = kPerAreaQuota;
+  EXPECT_EQ(base::TimeDelta::FromSeconds(10), area->ComputeCommitDelay());
+}
+
 TEST_F(DomStorageAreaTest, CommitTasks) {
   ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
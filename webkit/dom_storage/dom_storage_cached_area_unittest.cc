@@ -0,0 +1,255 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <list>
+
+#include "base/bind.h"
+#include "base/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webkit/dom_storage/dom_storage_cached_area.h"
+#include "webkit/dom_storage/dom_storage_proxy.h"
+
+namespace dom_storage {
+
+namespace {
+// A mock implementation of the DomStorageProxy interface.
+class MockProxy : public DomStorageProxy {
+ public:
+  MockProxy() {
+    ResetObservations();
+  }
+
+  // DomStorageProxy interface for use by DomStorageCachedArea.
+
+  virtual void LoadArea(int connection_id, ValuesMap* values) OVERRIDE {
+    observed_load_area_ = true;
+    observed_connection_id_ = connection_id;
+    *values = load_area_return_values_;
+  }
+
+  virtual void SetItem(int connection_id, const string16& key,
+                       const string16& value, const GURL& page_url,
+                       const CompletionCallback& callback) OVERRIDE {
+    observed_set_item_ = true;
+    observed_connection_id_ = connection_id;
+    observed_key_ = key;
+    observed_value_ = value;
+    observed_page_url_ = page_url;
+    pending_callbacks_.push_back(callback);
+  }
+
+  virtual void RemoveItem(int connection_id, const string16& key,
+                          const GURL& page_url,
+                          const CompletionCallback& callback) OVERRIDE {
+    observed_remove_item_ = true;
+    observed_connection_id_ = connection_id;
+    observed_key_ = key;
+    observed_page_url_ = page_url;
+    pending_callbacks_.push_back(callback);
+  }
+
+  virtual void ClearArea(int connection_id,
+                         const GURL& page_url,
+                         const CompletionCallback& callback) OVERRIDE {
+    observed_clear_area_ = true;
+    observed_connection_id_ = connection_id;
+    observed_page_url_ = page_url;
+    pending_callbacks_.push_back(callback);
+  }
+
+  // Methods and members for use by test fixtures.
+
+  void ResetObservations() {
+    observed_load_area_ = false;
+    observed_set_item_ = false;
+    observed_remove_item_ = false;
+    observed_clear_area_ = false;
+    observed_connection_id_ = 0;
+    observed_key_.clear();
+    observed_value_.clear();
+    observed_page_url_ = GURL();
+  }
+
+  void CompleteAllPendingCallbacks() {
+    while (!pending_callbacks_.empty())
+      CompleteOnePendingCallback(true);
+  }
+
+  void CompleteOnePendingCallback(bool success) {
+    ASSERT_TRUE(!pending_callbacks_.empty());
+    pending_callbacks_.front().Run(success);
+    pending_callbacks_.pop_front();
+  }
+
+  typedef std::list<CompletionCallback> CallbackList;
+
+  ValuesMap load_area_return_values_;
+  CallbackList pending_callbacks_;
+  bool observed_load_area_;
+  bool observed_set_item_;
+  bool observed_remove_item_;
+  bool observed_clear_area_;
+  int observed_connection_id_;
+  string16 observed_key_;
+  string16 observed_value_;
+  GURL observed_page_url_;
+
+ private:
+  virtual ~MockProxy() {}
+};
+}  // namespace
+
+class DomStorageCachedAreaTest : public testing::Test {
+ public:
+  DomStorageCachedAreaTest()
+    : kNamespaceId(10),
+      kOrigin("http://dom_storage/"),
+      kKey(ASCIIToUTF16("key")),
+      kValue(ASCIIToUTF16("value")),
+      kPageUrl("http://dom_storage/page"),
+      mock_proxy_(new MockProxy()) {
+  }
+
+  const int64 kNamespaceId;
+  const GURL kOrigin;
+  const string16 kKey;
+  const string16 kValue;
+  const GURL kPageUrl;
+
+  scoped_refptr<MockProxy> mock_proxy_;
+
+  bool IsPrimed(DomStorageCachedArea* cached_area) {
+    return cached_area->map_.get();
+  }
+
+  bool IsIgnoringAllMutations(DomStorageCachedArea* cached_area) {
+    return cached_area->ignore_all_mutations_;
+  }
+
+  bool IsIgnoringKeyMutations(DomStorageCachedArea* cached_area,
+                              const string16& key) {
+    return cached_area->should_ignore_key_mutation(key);
+  }
+
+  void ResetCacheOnly(DomStorageCachedArea* cached_area) {
+    cached_area->Reset();
+  }
+};
+
+TEST_F(DomStorageCachedAreaTest, Basics) {
+  scoped_refptr<DomStorageCachedArea> cached_area =
+      new DomStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_);
+  EXPECT_EQ(kNamespaceId, cached_area->namespace_id());
+  EXPECT_EQ(kOrigin, cached_area->origin());
+  EXPECT_FALSE(IsPrimed(cached_area));
+
+  // Reading primes the cache once, later reads don't hit the proxy.
+  const int kConnectionId = 1;
+  EXPECT_EQ(0u, cached_area->GetLength(kConnectionId));
+  EXPECT_TRUE(IsPrimed(cached_area));
+  EXPECT_TRUE(mock_proxy_->observed_load_area_);
+  EXPECT_EQ(kConnectionId, mock_proxy_->observed_connection_id_);
+  mock_proxy_->ResetObservations();
+  EXPECT_TRUE(cached_area->GetItem(kConnectionId, kKey).is_null());
+  EXPECT_TRUE(cached_area->GetKey(kConnectionId, 0).is_null());
+  EXPECT_FALSE(mock_proxy_->observed_load_area_);
+
+  // Writes are applied locally and forwarded to the proxy.
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  EXPECT_TRUE(mock_proxy_->observed_set_item_);
+  EXPECT_EQ(kKey, mock_proxy_->observed_key_);
+  EXPECT_EQ(kValue, mock_proxy_->observed_value_);
+  EXPECT_EQ(kPageUrl, mock_proxy_->observed_page_url_);
+  EXPECT_EQ(1u, cached_area->GetLength(kConnectionId));
+  EXPECT_EQ(kKey, cached_area->GetKey(kConnectionId, 0).string());
+  EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey).string());
+  cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
+  EXPECT_TRUE(mock_proxy_->observed_remove_item_);
+  EXPECT_EQ(0u, cached_area->GetLength(kConnectionId));
+  mock_proxy_->CompleteAllPendingCallbacks();
+  EXPECT_FALSE(mock_proxy_->observed_load_area_);
+}
+
+TEST_F(DomStorageCachedAreaTest, Prime) {
+  mock_proxy_->load_area_return_values_[kKey] = NullableString16(kValue, false);
+  scoped_refptr<DomStorageCachedArea> cached_area =
+      new DomStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_);
+  const int kConnectionId = 7;
+  EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey).string());
+  EXPECT_TRUE(mock_proxy_->observed_load_area_);
+  EXPECT_EQ(1u, cached_area->GetLength(kConnectionId));
+
+  // Clear doesn't need a primed cache.
+  ResetCacheOnly(cached_area);
+  mock_proxy_->ResetObservations();
+  cached_area->Clear(kConnectionId, kPageUrl);
+  EXPECT_TRUE(mock_proxy_->observed_clear_area_);
+  EXPECT_FALSE(mock_proxy_->observed_load_area_);
+  EXPECT_TRUE(IsPrimed(cached_area));
+  EXPECT_EQ(0u, cached_area->GetLength(kConnectionId));
+}
+
+TEST_F(DomStorageCachedAreaTest, ApplyMutation) {
+  scoped_refptr<DomStorageCachedArea> cached_area =
+      new DomStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_);
+  const int kConnectionId = 1;
+
+  // Mutations are dropped before the cache has been primed.
+  cached_area->ApplyMutation(NullableString16(kKey, false),
+                             NullableString16(kValue, false));
+  EXPECT_FALSE(IsPrimed(cached_area));
+
+  // Changes made elsewhere are reflected once primed.
+  EXPECT_EQ(0u, cached_area->GetLength(kConnectionId));
+  cached_area->ApplyMutation(NullableString16(kKey, false),
+                             NullableString16(kValue, false));
+  EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey).string());
+  cached_area->ApplyMutation(NullableString16(kKey, false),
+                             NullableString16(true));
+  EXPECT_TRUE(cached_area->GetItem(kConnectionId, kKey).is_null());
+
+  // Changes to keys with local mutations in flight are ignored.
+  const string16 kOtherValue(ASCIIToUTF16("other"));
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  EXPECT_TRUE(IsIgnoringKeyMutations(cached_area, kKey));
+  cached_area->ApplyMutation(NullableString16(kKey, false),
+                             NullableString16(kOtherValue, false));
+  EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey).string());
+
+  // A clear from elsewhere retains local changes still in flight.
+  cached_area->ApplyMutation(NullableString16(true), NullableString16(true));
+  EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey).string());
+  mock_proxy_->CompleteAllPendingCallbacks();
+  EXPECT_FALSE(IsIgnoringKeyMutations(cached_area, kKey));
+  cached_area->ApplyMutation(NullableString16(kKey, false),
+                             NullableString16(kOtherValue, false));
+  EXPECT_EQ(kOtherValue, cached_area->GetItem(kConnectionId, kKey).string());
+
+  // Everything is ignored while a local clear is in flight.
+  cached_area->Clear(kConnectionId, kPageUrl);
+  EXPECT_TRUE(IsIgnoringAllMutations(cached_area));
+  cached_area->ApplyMutation(NullableString16(kKey, false),
+                             NullableString16(kValue, false));
+  EXPECT_EQ(0u, cached_area->GetLength(kConnectionId));
+  mock_proxy_->CompleteAllPendingCallbacks();
+  EXPECT_FALSE(IsIgnoringAllMutations(cached_area));
+}
+
+TEST_F(DomStorageCachedAreaTest, RejectedSetItemResetsCache) {
+  scoped_refptr<DomStorageCachedArea> cached_area =
+      new DomStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_);
+  const int kConnectionId = 1;
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  EXPECT_TRUE(IsPrimed(cached_area));
+  mock_proxy_->CompleteOnePendingCallback(false);
+  EXPECT_FALSE(IsPrimed(cached_area));
+  EXPECT_FALSE(IsIgnoringKeyMutations(cached_area, kKey));
+
+  // The next access reloads from the backend.
+  mock_proxy_->ResetObservations();
+  EXPECT_TRUE(cached_area->GetItem(kConnectionId, kKey).is_null());
+  EXPECT_TRUE(mock_proxy_->observed_load_area_);
+}
+
+}  // namespace dom_storage
@@ -43,6 +43,7 @@ class DomStorageMap
   DomStorageMap* DeepCopy() const;
 
   size_t bytes_used() const { return bytes_used_; }
+  void set_quota(size_t quota) { quota_ = quota; }
 
  private:
   friend class base::RefCountedThreadSafe<DomStorageMap>;
@@ -6,8 +6,10 @@
 
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/stringprintf.h"
 #include "base/string_number_conversions.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "googleurl/src/gurl.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
@@ -37,11 +39,14 @@
 
 namespace dom_storage {
 
+const int SessionStorageDatabase::kDeletionsBeforeCompaction = 20;
+
 SessionStorageDatabase::SessionStorageDatabase(const FilePath& file_path)
     : file_path_(file_path),
       db_error_(false),
       is_inconsistent_(false),
-      namespace_offset_(0) { }
+      namespace_offset_(0),
+      deletions_since_compaction_(0) { }
 
 SessionStorageDatabase::~SessionStorageDatabase() {
 }
@@ -53,12 +58,17 @@ void SessionStorageDatabase::ReadAreaValues(int64 namespace_id,
   // nothing to be added to the result.
   if (!LazyOpen(false))
     return;
+  base::TimeTicks before = base::TimeTicks::Now();
   std::string map_id;
   bool exists;
   if (!GetMapForArea(namespace_id, origin, &exists, &map_id))
     return;
-  if (exists)
-    ReadMap(map_id, result, false);
+  if (exists && ReadMap(map_id, result, false)) {
+    UMA_HISTOGRAM_TIMES("SessionStorageDatabase.ReadAreaTime",
+                        base::TimeTicks::Now() - before);
+    UMA_HISTOGRAM_COUNTS_10000("SessionStorageDatabase.ReadAreaItems",
+                               result->size());
+  }
 }
 
 bool SessionStorageDatabase::CommitAreaChanges(int64 namespace_id,
@@ -238,7 +248,11 @@ bool SessionStorageDatabase::DeleteNamespace(int64 namespace_id) {
   }
   batch.Delete(NamespaceStartKey(namespace_id, namespace_offset_));
   leveldb::Status s = db_->Write(leveldb::WriteOptions(), &batch);
-  return DatabaseErrorCheck(s.ok());
+  if (!DatabaseErrorCheck(s.ok()))
+    return false;
+  ++deletions_since_compaction_;
+  CompactIfNeeded();
+  return true;
 }
 
 bool SessionStorageDatabase::LazyOpen(bool create_if_needed) {
@@ -260,6 +274,7 @@ bool SessionStorageDatabase::LazyOpen(bool create_if_needed) {
     return false;
   }
 
+  base::TimeTicks before = base::TimeTicks::Now();
   leveldb::DB* db;
   leveldb::Status s = TryToOpen(file_path_, &db);
   if (!s.ok()) {
@@ -280,7 +295,22 @@ bool SessionStorageDatabase::LazyOpen(bool create_if_needed) {
   }
   db_.reset(db);
 
-  return GetNextNamespaceId(&namespace_offset_);
+  bool success = GetNextNamespaceId(&namespace_offset_);
+  UMA_HISTOGRAM_TIMES("SessionStorageDatabase.OpenTime",
+                      base::TimeTicks::Now() - before);
+  return success;
+}
+
+void SessionStorageDatabase::CompactIfNeeded() {
+  if (deletions_since_compaction_ < kDeletionsBeforeCompaction)
+    return;
+  deletions_since_compaction_ = 0;
+  base::TimeTicks before = base::TimeTicks::Now();
+  // Compacting the whole key space is simplest; the maps of the deleted
+  // namespaces are spread all over it.
+  db_->CompactRange(NULL, NULL);
+  UMA_HISTOGRAM_TIMES("SessionStorageDatabase.CompactTime",
+                      base::TimeTicks::Now() - before);
 }
 
 leveldb::Status SessionStorageDatabase::TryToOpen(const FilePath& file_path,
@@ -33,10 +33,15 @@ class SessionStorageDatabase :
  public:
   explicit SessionStorageDatabase(const FilePath& file_path);
 
+  // Number of namespaces deleted before the freed key ranges are compacted.
+  static const int kDeletionsBeforeCompaction;
+
   // Reads the (key, value) pairs for |namespace_id| and |origin|. |result| is
   // assumed to be empty and any duplicate keys will be overwritten. If the
   // database exists on disk then it will be opened. If it does not exist then
-  // it will not be created and |result| will be unmodified.
+  // it will not be created and |result| will be unmodified. Only the requested
+  // area is read, so restored namespaces are loaded one area at a time as
+  // they are first accessed rather than all at once at startup.
   void ReadAreaValues(int64 namespace_id,
                       const GURL& origin,
                       ValuesMap* result);
@@ -60,7 +65,9 @@ class SessionStorageDatabase :
   // Deletes the data for |namespace_id| and |origin|.
   bool DeleteArea(int64 namespace_id, const GURL& origin);
 
-  // Deletes the data for |namespace_id|.
+  // Deletes the data for |namespace_id|. Once kDeletionsBeforeCompaction
+  // namespaces have been deleted the database is compacted, so callers should
+  // invoke this on a background sequence.
   bool DeleteNamespace(int64 namespace_id);
 
  private:
@@ -70,6 +77,10 @@ class SessionStorageDatabase :
   ~SessionStorageDatabase();
 
   bool LazyOpen(bool create_if_needed);
+  // Compacts the database if enough namespaces have been deleted since the
+  // last compaction. Deleted keys linger as tombstones until then, and they
+  // make the next startup open and iterate more data than is live.
+  void CompactIfNeeded();
   leveldb::Status TryToOpen(const FilePath& file_path, leveldb::DB** db);
   bool IsOpen() const;
 
@@ -194,6 +205,9 @@ class SessionStorageDatabase :
   // namesapce_id_str) contain the offset.
   int64 namespace_offset_;
 
+  // Number of namespaces deleted since the database was last compacted.
+  int deletions_since_compaction_;
+
   DISALLOW_COPY_AND_ASSIGN(SessionStorageDatabase);
 };
 
@@ -596,6 +596,23 @@ TEST_F(SessionStorageDatabaseTest, DeleteNamespace) {
   CheckEmptyDatabase();
 }
 
+TEST_F(SessionStorageDatabaseTest, DeleteNamespacesCompacts) {
+  ValuesMap data1;
+  data1[kKey1] = kValue1;
+  const int kNamespaces = SessionStorageDatabase::kDeletionsBeforeCompaction;
+  for (int i = 1; i <= kNamespaces; ++i)
+    ASSERT_TRUE(db_->CommitAreaChanges(i, kOrigin1, false, data1));
+  for (int i = 1; i < kNamespaces; ++i)
+    EXPECT_TRUE(db_->DeleteNamespace(i));
+  EXPECT_EQ(kNamespaces - 1, db_->deletions_since_compaction_);
+
+  // The last deletion triggers a compaction, which leaves the data intact.
+  EXPECT_TRUE(db_->DeleteNamespace(kNamespaces));
+  EXPECT_EQ(0, db_->deletions_since_compaction_);
+  CheckDatabaseConsistency();
+  CheckEmptyDatabase();
+}
+
 TEST_F(SessionStorageDatabaseTest, DeleteNamespaceWithShallowCopy) {
   // Write data for a namespace, for 2 origins.
   ValuesMap data1;
@@ -70,6 +70,7 @@ const char kChildLookupSeparator[] = ":";
 const char kLastFileIdKey[] = "LAST_FILE_ID";
 const char kLastIntegerKey[] = "LAST_INTEGER";
 const int64 kMinimumReportIntervalHours = 1;
+const size_t kChildLookupCacheSize = 1024;
 const char kInitStatusHistogramLabel[] = "FileSystem.DirectoryDatabaseInit";
 
 enum InitStatus {
@@ -380,7 +381,8 @@ FileSystemDirectoryDatabase::FileInfo::~FileInfo() {
 
 FileSystemDirectoryDatabase::FileSystemDirectoryDatabase(
     const FilePath& filesystem_data_directory)
-    : filesystem_data_directory_(filesystem_data_directory) {
+    : filesystem_data_directory_(filesystem_data_directory),
+      child_lookup_cache_(kChildLookupCacheSize) {
 }
 
 FileSystemDirectoryDatabase::~FileSystemDirectoryDatabase() {
@@ -392,6 +394,11 @@ bool FileSystemDirectoryDatabase::GetChildWithName(
     return false;
   DCHECK(child_id);
   std::string child_key = GetChildLookupKey(parent_id, name);
+  ChildLookupCache::iterator found = child_lookup_cache_.Get(child_key);
+  if (found != child_lookup_cache_.end()) {
+    *child_id = found->second;
+    return true;
+  }
   std::string child_id_string;
   leveldb::Status status =
       db_->Get(leveldb::ReadOptions(), child_key, &child_id_string);
@@ -402,6 +409,7 @@ bool FileSystemDirectoryDatabase::GetChildWithName(
       LOG(ERROR) << "Hit database corruption!";
       return false;
     }
+    child_lookup_cache_.Put(child_key, *child_id);
     return true;
   }
   HandleError(FROM_HERE, status);
@@ -680,6 +688,7 @@ bool FileSystemDirectoryDatabase::Init(RecoveryOption recovery_option) {
   ReportInitStatus(status);
   if (status.ok()) {
     db_.reset(db);
+    child_lookup_cache_.Clear();
     return true;
   }
   HandleError(FROM_HERE, status);
@@ -853,7 +862,11 @@ bool FileSystemDirectoryDatabase::RemoveFileInfoHelper(
       return false;
     }
   }
-  batch->Delete(GetChildLookupKey(info.parent_id, info.name));
+  std::string child_key = GetChildLookupKey(info.parent_id, info.name);
+  ChildLookupCache::iterator cached = child_lookup_cache_.Peek(child_key);
+  if (cached != child_lookup_cache_.end())
+    child_lookup_cache_.Erase(cached);
+  batch->Delete(child_key);
   batch->Delete(GetFileLookupKey(file_id));
   return true;
 }
@@ -864,6 +877,7 @@ void FileSystemDirectoryDatabase::HandleError(
   LOG(ERROR) << "FileSystemDirectoryDatabase failed at: "
              << from_here.ToString() << " with error: " << status.ToString();
   db_.reset();
+  child_lookup_cache_.Clear();
 }
 
 }  // namespace fileapi
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/file_path.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time.h"
 
@@ -113,6 +114,14 @@ class FileSystemDirectoryDatabase {
   FilePath filesystem_data_directory_;
   scoped_ptr<leveldb::DB> db_;
   base::Time last_reported_time_;
+
+  // Recently resolved child lookups, keyed like the database's child lookup
+  // records. Resolving a path reads one of these per component, so caching
+  // them keeps repeated operations on a deep tree out of LevelDB. Entries are
+  // dropped whenever the record they mirror is deleted.
+  typedef base::MRUCache<std::string, FileId> ChildLookupCache;
+  ChildLookupCache child_lookup_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(FileSystemDirectoryDatabase);
 };
 
@@ -283,6 +283,37 @@ TEST_F(FileSystemDirectoryDatabaseTest, TestGetChildWithName) {
   EXPECT_EQ(file_id1, check_file_id);
 }
 
+TEST_F(FileSystemDirectoryDatabaseTest, TestGetChildWithNameAfterChanges) {
+  const FilePath::StringType kDirName = FILE_PATH_LITERAL("dir");
+  const FilePath::StringType kFileName = FILE_PATH_LITERAL("file");
+  const FilePath::StringType kNewName = FILE_PATH_LITERAL("renamed");
+  FileId dir_id;
+  FileId file_id;
+  CreateDirectory(0, kDirName, &dir_id);
+  CreateDirectory(dir_id, kFileName, &file_id);
+
+  // Look the entries up once so that they are cached.
+  FileId check_file_id;
+  EXPECT_TRUE(db()->GetChildWithName(0, kDirName, &check_file_id));
+  EXPECT_TRUE(db()->GetChildWithName(dir_id, kFileName, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // A move must not leave the old name resolvable.
+  FileInfo info;
+  ASSERT_TRUE(db()->GetFileInfo(file_id, &info));
+  info.parent_id = 0;
+  info.name = kNewName;
+  EXPECT_TRUE(db()->UpdateFileInfo(file_id, info));
+  EXPECT_FALSE(db()->GetChildWithName(dir_id, kFileName, &check_file_id));
+  EXPECT_TRUE(db()->GetChildWithName(0, kNewName, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // Nor a removal.
+  EXPECT_TRUE(db()->RemoveFileInfo(dir_id));
+  EXPECT_FALSE(db()->GetChildWithName(0, kDirName, &check_file_id));
+  EXPECT_FALSE(db()->GetFileWithPath(FilePath(kDirName), &check_file_id));
+}
+
 TEST_F(FileSystemDirectoryDatabaseTest, TestGetFileWithPath) {
   FileInfo info;
   FileId file_id0;
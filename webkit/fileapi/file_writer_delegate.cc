@@ -4,6 +4,8 @@
 
 #include "webkit/fileapi/file_writer_delegate.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/file_util_proxy.h"
@@ -19,6 +21,7 @@
 namespace fileapi {
 
 static const int kReadBufSize = 32768;
+static const int kMaxReadBufSize = 1024 * 1024;
 
 namespace {
 
@@ -97,11 +100,15 @@ FileWriterDelegate::FileWriterDelegate(
       offset_(offset),
       proxy_(proxy),
       bytes_written_backlog_(0),
-      bytes_written_(0),
-      bytes_read_(0),
+      usage_backlog_(0),
       total_bytes_written_(0),
       allowed_bytes_to_write_(0),
-      io_buffer_(new net::IOBufferWithSize(kReadBufSize)),
+      read_buffer_(new net::IOBufferWithSize(kReadBufSize)),
+      bytes_pending_write_(0),
+      read_in_progress_(false),
+      write_in_progress_(false),
+      read_finished_(false),
+      pending_error_(base::PLATFORM_FILE_OK),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
 }
 
@@ -200,29 +207,55 @@ void FileWriterDelegate::OnReadCompleted(net::URLRequest* request,
 }
 
 void FileWriterDelegate::Read() {
-  bytes_written_ = 0;
-  bytes_read_ = 0;
-  if (request_->Read(io_buffer_.get(), io_buffer_->size(),
-                     &bytes_read_)) {
+  DCHECK(!read_in_progress_);
+  DCHECK(!bytes_pending_write_);
+  read_in_progress_ = true;
+  int bytes_read = 0;
+  if (request_->Read(read_buffer_.get(), read_buffer_->size(), &bytes_read)) {
     MessageLoop::current()->PostTask(
         FROM_HERE,
         base::Bind(&FileWriterDelegate::OnDataReceived,
-                   weak_factory_.GetWeakPtr(), bytes_read_));
+                   weak_factory_.GetWeakPtr(), bytes_read));
   } else if (!request_->status().is_io_pending()) {
     OnError(base::PLATFORM_FILE_ERROR_FAILED);
   }
 }
 
 void FileWriterDelegate::OnDataReceived(int bytes_read) {
-  bytes_read_ = bytes_read;
-  if (!bytes_read_) {  // We're done.
-    OnProgress(0, true);
-  } else {
-    // This could easily be optimized to rotate between a pool of buffers, so
-    // that we could read and write at the same time.  It's not yet clear that
-    // it's necessary.
-    cursor_ = new net::DrainableIOBuffer(io_buffer_, bytes_read_);
-    Write();
+  read_in_progress_ = false;
+  if (pending_error_ != base::PLATFORM_FILE_OK)
+    return;
+  if (!bytes_read) {
+    read_finished_ = true;
+    if (!write_in_progress_)
+      OnProgress(0, true);  // We're done.
+    return;
+  }
+  bytes_pending_write_ = bytes_read;
+  if (!write_in_progress_)
+    StartWrite();
+}
+
+void FileWriterDelegate::StartWrite() {
+  DCHECK(!write_in_progress_);
+  DCHECK(bytes_pending_write_);
+  read_buffer_.swap(write_buffer_);
+  cursor_ = new net::DrainableIOBuffer(write_buffer_, bytes_pending_write_);
+
+  int next_size = write_buffer_->size();
+  if (bytes_pending_write_ == next_size)
+    next_size = std::min(next_size * 2, kMaxReadBufSize);
+  if (!read_buffer_ || read_buffer_->size() != next_size)
+    read_buffer_ = new net::IOBufferWithSize(next_size);
+  bytes_pending_write_ = 0;
+
+  write_in_progress_ = true;
+  base::WeakPtr<FileWriterDelegate> alive(weak_factory_.GetWeakPtr());
+  Write();
+  // Fetch the next chunk while this one is being written.
+  if (alive && !read_finished_ && !read_in_progress_ &&
+      pending_error_ == base::PLATFORM_FILE_OK) {
+    Read();
   }
 }
 
@@ -234,11 +267,12 @@ void FileWriterDelegate::Write() {
   DCHECK(total_bytes_written_ <= allowed_bytes_to_write_ ||
          allowed_bytes_to_write_ < 0);
   if (total_bytes_written_ >= allowed_bytes_to_write_) {
+    write_in_progress_ = false;
     OnError(base::PLATFORM_FILE_ERROR_NO_SPACE);
     return;
   }
 
-  int64 bytes_to_write = bytes_read_ - bytes_written_;
+  int64 bytes_to_write = cursor_->BytesRemaining();
   if (bytes_to_write > allowed_bytes_to_write_ - total_bytes_written_)
     bytes_to_write = allowed_bytes_to_write_ - total_bytes_written_;
 
@@ -247,36 +281,60 @@ void FileWriterDelegate::Write() {
                           static_cast<int>(bytes_to_write),
                           base::Bind(&FileWriterDelegate::OnDataWritten,
                                      weak_factory_.GetWeakPtr()));
-  if (write_response > 0)
+  if (write_response > 0) {
     MessageLoop::current()->PostTask(
         FROM_HERE,
         base::Bind(&FileWriterDelegate::OnDataWritten,
                    weak_factory_.GetWeakPtr(), write_response));
-  else if (net::ERR_IO_PENDING != write_response)
+  } else if (net::ERR_IO_PENDING != write_response) {
+    write_in_progress_ = false;
     OnError(base::PLATFORM_FILE_ERROR_FAILED);
+  }
 }
 
 void FileWriterDelegate::OnDataWritten(int write_response) {
-  if (write_response > 0) {
-    OnProgress(write_response, false);
-    cursor_->DidConsume(write_response);
-    bytes_written_ += write_response;
-    total_bytes_written_ += write_response;
-    if (bytes_written_ == bytes_read_)
-      Read();
-    else
-      Write();
-  } else {
+  if (write_response <= 0) {
+    write_in_progress_ = false;
     OnError(base::PLATFORM_FILE_ERROR_FAILED);
+    return;
+  }
+
+  OnProgress(write_response, false);
+  cursor_->DidConsume(write_response);
+  total_bytes_written_ += write_response;
+
+  if (pending_error_ != base::PLATFORM_FILE_OK) {
+    write_in_progress_ = false;
+    OnError(pending_error_);
+  } else if (cursor_->BytesRemaining()) {
+    Write();
+  } else {
+    write_in_progress_ = false;
+    if (bytes_pending_write_)
+      StartWrite();
+    else if (read_finished_)
+      OnProgress(0, true);
+    // Otherwise the next chunk is still being read.
   }
 }
 
 void FileWriterDelegate::OnError(base::PlatformFileError error) {
-  request_->set_delegate(NULL);
-  request_->Cancel();
+  if (pending_error_ == base::PLATFORM_FILE_OK) {
+    request_->set_delegate(NULL);
+    request_->Cancel();
+  }
 
-  if (quota_util())
+  if (write_in_progress_) {
+    // Finish once the write in flight lands.
+    if (pending_error_ == base::PLATFORM_FILE_OK)
+      pending_error_ = error;
+    return;
+  }
+
+  if (quota_util()) {
+    FlushUsageBacklog();
     quota_util()->proxy()->EndUpdateOrigin(path_.origin(), path_.type());
+  }
 
   file_system_operation_->DidWrite(error, 0, true);
 }
@@ -289,10 +347,7 @@ void FileWriterDelegate::OnProgress(int bytes_written, bool done) {
     int overlapped = 0;
     if (total_bytes_written_ + offset_ < size_)
       overlapped = size_ - total_bytes_written_ - offset_;
-    quota_util()->proxy()->UpdateOriginUsage(
-        file_system_operation_->file_system_context()->quota_manager_proxy(),
-        path_.origin(), path_.type(),
-        bytes_written - overlapped);
+    usage_backlog_ += bytes_written - overlapped;
   }
   static const int kMinProgressDelayMS = 200;
   base::Time currentTime = base::Time::Now();
@@ -302,8 +357,13 @@ void FileWriterDelegate::OnProgress(int bytes_written, bool done) {
     bytes_written += bytes_written_backlog_;
     last_progress_event_time_ = currentTime;
     bytes_written_backlog_ = 0;
-    if (done && quota_util())
-      quota_util()->proxy()->EndUpdateOrigin(path_.origin(), path_.type());
+    if (quota_util()) {
+      // Usage is reported along with progress rather than per chunk; the
+      // quota for the whole write was checked up front.
+      FlushUsageBacklog();
+      if (done)
+        quota_util()->proxy()->EndUpdateOrigin(path_.origin(), path_.type());
+    }
     file_system_operation_->DidWrite(
         base::PLATFORM_FILE_OK, bytes_written, done);
     return;
@@ -311,6 +371,15 @@ void FileWriterDelegate::OnProgress(int bytes_written, bool done) {
   bytes_written_backlog_ += bytes_written;
 }
 
+void FileWriterDelegate::FlushUsageBacklog() {
+  if (!usage_backlog_)
+    return;
+  quota_util()->proxy()->UpdateOriginUsage(
+      file_system_operation_->file_system_context()->quota_manager_proxy(),
+      path_.origin(), path_.type(), usage_backlog_);
+  usage_backlog_ = 0;
+}
+
 FileSystemOperationContext*
 FileWriterDelegate::file_system_operation_context() const {
   DCHECK(file_system_operation_);
@@ -58,10 +58,12 @@ class FileWriterDelegate : public net::URLRequest::Delegate {
       const base::PlatformFileInfo& file_info);
   void Read();
   void OnDataReceived(int bytes_read);
+  void StartWrite();
   void Write();
   void OnDataWritten(int write_response);
   void OnError(base::PlatformFileError error);
   void OnProgress(int bytes_read, bool done);
+  void FlushUsageBacklog();
 
   FileSystemOperationContext* file_system_operation_context() const;
   FileSystemQuotaUtil* quota_util() const;
@@ -74,12 +76,23 @@ class FileWriterDelegate : public net::URLRequest::Delegate {
   scoped_refptr<base::MessageLoopProxy> proxy_;
   base::Time last_progress_event_time_;
   int bytes_written_backlog_;
-  int bytes_written_;
-  int bytes_read_;
+  int64 usage_backlog_;
   int64 total_bytes_written_;
   int64 allowed_bytes_to_write_;
-  scoped_refptr<net::IOBufferWithSize> io_buffer_;
+
+  // The blob is read into |read_buffer_| while the previous chunk is written
+  // out of |write_buffer_|. A read that fills its buffer doubles the size of
+  // the next one, up to a limit.
+  scoped_refptr<net::IOBufferWithSize> read_buffer_;
+  scoped_refptr<net::IOBufferWithSize> write_buffer_;
   scoped_refptr<net::DrainableIOBuffer> cursor_;
+  int bytes_pending_write_;  // Read into |read_buffer_| but not yet written.
+  bool read_in_progress_;
+  bool write_in_progress_;
+  bool read_finished_;
+  // An error reported while a write was in flight, delivered once the write
+  // completes so the bytes it wrote are still accounted for.
+  base::PlatformFileError pending_error_;
   scoped_ptr<net::FileStream> file_stream_;
   net::URLRequest* request_;
   base::WeakPtrFactory<FileWriterDelegate> weak_factory_;
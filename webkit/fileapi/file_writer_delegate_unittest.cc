@@ -13,6 +13,7 @@
 
 #include "base/basictypes.h"
 #include "base/bind.h"
+#include "base/file_util.h"
 #include "base/file_util_proxy.h"
 #include "base/message_loop.h"
 #include "base/scoped_temp_dir.h"
@@ -298,6 +299,35 @@ TEST_F(FileWriterDelegateTest, WriteZeroBytesSuccessfullyWithZeroQuota) {
   EXPECT_TRUE(result_->complete());
 }
 
+TEST_F(FileWriterDelegateTest, WriteLargeBlob) {
+  const GURL kBlobURL("blob:large");
+  // Large enough for the read buffer to grow to its limit while the previous
+  // chunk is being written.
+  std::string large_content;
+  while (large_content.size() < 3 * 1024 * 1024)
+    large_content.append(kData);
+  content_ = large_content.c_str();
+  const int64 kContentSize = large_content.size();
+
+  PrepareForWrite(kBlobURL, 0, QuotaFileUtil::kNoLimit);
+
+  ASSERT_EQ(0, test_helper_.GetCachedOriginUsage());
+  file_writer_delegate_->Start(file_, request_.get());
+  MessageLoop::current()->Run();
+  ASSERT_EQ(kContentSize, test_helper_.GetCachedOriginUsage());
+  EXPECT_EQ(ComputeCurrentOriginUsage(), test_helper_.GetCachedOriginUsage());
+
+  EXPECT_EQ(kContentSize, result_->bytes_written());
+  EXPECT_EQ(base::PLATFORM_FILE_OK, result_->status());
+  EXPECT_TRUE(result_->complete());
+
+  file_writer_delegate_.reset();
+
+  std::string written;
+  ASSERT_TRUE(file_util::ReadFileToString(file_path_, &written));
+  EXPECT_TRUE(written == large_content);
+}
+
 TEST_F(FileWriterDelegateTest, WriteSuccessWithoutQuotaLimitConcurrent) {
   scoped_ptr<FileWriterDelegate> file_writer_delegate2;
   scoped_ptr<net::URLRequest> request2;
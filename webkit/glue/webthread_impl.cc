@@ -23,9 +23,9 @@ public:
       : observer_(observer) { }
 
   // WebThread::TaskObserver does not have a willProcessTask method.
-  virtual void WillProcessTask(base::TimeTicks) OVERRIDE { }
+  virtual void WillProcessTask(const base::PendingTask&) OVERRIDE { }
 
-  virtual void DidProcessTask(base::TimeTicks) OVERRIDE {
+  virtual void DidProcessTask(const base::PendingTask&) OVERRIDE {
     observer_->didProcessTask();
   }
 
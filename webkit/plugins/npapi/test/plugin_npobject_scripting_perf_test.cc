@@ -0,0 +1,92 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "webkit/plugins/npapi/test/plugin_npobject_scripting_perf_test.h"
+
+#include "base/basictypes.h"
+#include "base/time.h"
+
+namespace NPAPIClient {
+
+namespace {
+
+const int kIterations = 5000;
+
+double CallsPerSecond(base::TimeTicks start) {
+  double seconds = (base::TimeTicks::Now() - start).InSecondsF();
+  return seconds > 0 ? kIterations / seconds : 0;
+}
+
+}  // namespace
+
+NPObjectScriptingPerfTest::NPObjectScriptingPerfTest(
+    NPP id, NPNetscapeFuncs *host_functions)
+    : PluginTest(id, host_functions),
+      measured_(false) {
+}
+
+NPError NPObjectScriptingPerfTest::SetWindow(NPWindow* pNPWindow) {
+  if (pNPWindow->window == NULL || measured_)
+    return NPERR_NO_ERROR;
+  measured_ = true;
+
+  NPObject *window_obj = NULL;
+  HostFunctions()->getvalue(id(), NPNVWindowNPObject, &window_obj);
+  if (!window_obj) {
+    SetError("Failed to get the window object");
+    SignalTestCompleted();
+    return NPERR_NO_ERROR;
+  }
+
+  double invokes_per_second = MeasureInvokes(window_obj);
+  double gets_per_second = MeasureGets(window_obj);
+
+  NPVariant args[2];
+  DOUBLE_TO_NPVARIANT(invokes_per_second, args[0]);
+  DOUBLE_TO_NPVARIANT(gets_per_second, args[1]);
+  NPVariant result;
+  NPIdentifier report_id =
+      HostFunctions()->getstringidentifier("reportPerfResults");
+  if (!HostFunctions()->invoke(id(), window_obj, report_id, args, 2, &result))
+    SetError("Failed to report the results");
+  else
+    HostFunctions()->releasevariantvalue(&result);
+
+  HostFunctions()->releaseobject(window_obj);
+  SignalTestCompleted();
+  return NPERR_NO_ERROR;
+}
+
+double NPObjectScriptingPerfTest::MeasureInvokes(NPObject* window_obj) {
+  NPIdentifier noop_id = HostFunctions()->getstringidentifier("perfNoop");
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    NPVariant arg;
+    INT32_TO_NPVARIANT(i, arg);
+    NPVariant result;
+    if (!HostFunctions()->invoke(id(), window_obj, noop_id, &arg, 1,
+                                 &result)) {
+      SetError("Failed to invoke perfNoop");
+      return 0;
+    }
+    HostFunctions()->releasevariantvalue(&result);
+  }
+  return CallsPerSecond(start);
+}
+
+double NPObjectScriptingPerfTest::MeasureGets(NPObject* window_obj) {
+  NPIdentifier value_id = HostFunctions()->getstringidentifier("perfValue");
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    NPVariant result;
+    if (!HostFunctions()->getproperty(id(), window_obj, value_id, &result)) {
+      SetError("Failed to get perfValue");
+      return 0;
+    }
+    HostFunctions()->releasevariantvalue(&result);
+  }
+  return CallsPerSecond(start);
+}
+
+}  // namespace NPAPIClient
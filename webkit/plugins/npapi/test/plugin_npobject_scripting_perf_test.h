@@ -0,0 +1,34 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef WEBKIT_PLUGINS_NPAPI_TEST_PLUGIN_NPOBJECT_SCRIPTING_PERF_TEST_H_
+#define WEBKIT_PLUGINS_NPAPI_TEST_PLUGIN_NPOBJECT_SCRIPTING_PERF_TEST_H_
+
+#include "base/compiler_specific.h"
+#include "webkit/plugins/npapi/test/plugin_test.h"
+
+namespace NPAPIClient {
+
+// The NPObjectScriptingPerfTest measures how many calls per second the plugin
+// can make on the page's window object: invokes of the perfNoop() function,
+// which returns nothing, and gets of the perfValue property. The rates are
+// handed to the page's reportPerfResults(invokes, gets) function.
+class NPObjectScriptingPerfTest : public PluginTest {
+ public:
+  NPObjectScriptingPerfTest(NPP id, NPNetscapeFuncs *host_functions);
+
+  // NPAPI SetWindow handler.
+  virtual NPError SetWindow(NPWindow* pNPWindow) OVERRIDE;
+
+ private:
+  // Returns the number of calls per second, or 0 if a call failed.
+  double MeasureInvokes(NPObject* window_obj);
+  double MeasureGets(NPObject* window_obj);
+
+  bool measured_;
+};
+
+}  // namespace NPAPIClient
+
+#endif  // WEBKIT_PLUGINS_NPAPI_TEST_PLUGIN_NPOBJECT_SCRIPTING_PERF_TEST_H_
@@ -15,6 +15,7 @@
 #include "webkit/plugins/npapi/test/plugin_npobject_identity_test.h"
 #include "webkit/plugins/npapi/test/plugin_npobject_lifetime_test.h"
 #include "webkit/plugins/npapi/test/plugin_npobject_proxy_test.h"
+#include "webkit/plugins/npapi/test/plugin_npobject_scripting_perf_test.h"
 #include "webkit/plugins/npapi/test/plugin_private_test.h"
 #include "webkit/plugins/npapi/test/plugin_schedule_timer_test.h"
 #include "webkit/plugins/npapi/test/plugin_setup_test.h"
@@ -43,6 +44,8 @@ PluginTest* CreatePluginTest(const std::string& test_name,
     new_test = new NPObjectIdentityTest(instance, host_functions);
   } else if (test_name == "npobject_proxy") {
     new_test = new NPObjectProxyTest(instance, host_functions);
+  } else if (test_name == "npobject_scripting_perf") {
+    new_test = new NPObjectScriptingPerfTest(instance, host_functions);
 #if defined(OS_WIN) || defined(OS_MACOSX)
   // TODO(port): plugin_windowless_test.*.
   } else if (test_name == "execute_script_delete_in_paint" ||
@@ -1013,24 +1013,26 @@ class QuotaManager::UpdateAccessTimeTask
 class QuotaManager::UpdateModifiedTimeTask
     : public QuotaManager::DatabaseTaskBase {
  public:
+  // Takes the contents of |modified_times|.
   UpdateModifiedTimeTask(
       QuotaManager* manager,
-      const GURL& origin,
-      StorageType type,
-      base::Time modified_time)
-      : DatabaseTaskBase(manager),
-        origin_(origin),
-        type_(type),
-        modified_time_(modified_time) {}
+      ModifiedTimeMap* modified_times)
+      : DatabaseTaskBase(manager) {
+    modified_times_.swap(*modified_times);
+  }
 
  protected:
   virtual ~UpdateModifiedTimeTask() {}
 
   // QuotaThreadTask:
   virtual void RunOnTargetThread() OVERRIDE {
-    if (!database()->SetOriginLastModifiedTime(
-            origin_, type_, modified_time_)) {
-      set_db_disabled(true);
+    for (ModifiedTimeMap::const_iterator itr = modified_times_.begin();
+         itr != modified_times_.end(); ++itr) {
+      if (!database()->SetOriginLastModifiedTime(
+              itr->first.first, itr->first.second, itr->second)) {
+        set_db_disabled(true);
+        return;
+      }
     }
   }
 
@@ -1038,9 +1040,7 @@ class QuotaManager::UpdateModifiedTimeTask
   virtual void DatabaseTaskCompleted() OVERRIDE {}
 
  private:
-  GURL origin_;
-  StorageType type_;
-  base::Time modified_time_;
+  ModifiedTimeMap modified_times_;
 };
 
 class QuotaManager::GetModifiedSinceTask
@@ -1325,6 +1325,7 @@ void QuotaManager::GetOriginsModifiedSince(StorageType type,
                                            base::Time modified_since,
                                            const GetOriginsCallback& callback) {
   LazyInitialize();
+  FlushModifiedTimes();
   make_scoped_refptr(new GetModifiedSinceTask(
       this, type, modified_since, callback))->Start();
 }
@@ -1333,8 +1334,10 @@ QuotaManager::~QuotaManager() {
   proxy_->manager_ = NULL;
   std::for_each(clients_.begin(), clients_.end(),
                 std::mem_fun(&QuotaClient::OnQuotaManagerDestroyed));
-  if (database_.get())
+  if (database_.get()) {
+    FlushModifiedTimes();
     db_thread_->DeleteSoon(FROM_HERE, database_.release());
+  }
 }
 
 void QuotaManager::LazyInitialize() {
@@ -1498,8 +1501,28 @@ void QuotaManager::NotifyStorageModifiedInternal(
     base::Time modified_time) {
   LazyInitialize();
   GetUsageTracker(type)->UpdateUsageCache(client_id, origin, delta);
+
+  if (db_disabled_)
+    return;
+
+  // Writes tend to come in bursts, so the modified times are written to the
+  // database in one task once the current burst has been handled.
+  if (pending_modified_times_.empty()) {
+    io_thread_->PostTask(
+        FROM_HERE, base::Bind(&QuotaManager::FlushModifiedTimes,
+                              weak_factory_.GetWeakPtr()));
+  }
+  base::Time& pending_time =
+      pending_modified_times_[std::make_pair(origin, type)];
+  pending_time = std::max(pending_time, modified_time);
+}
+
+void QuotaManager::FlushModifiedTimes() {
+  if (pending_modified_times_.empty() || db_disabled_)
+    return;
   make_scoped_refptr(new UpdateModifiedTimeTask(
-      this, origin, type, modified_time))->Start();
+      this, &pending_modified_times_))->Start();
+  DCHECK(pending_modified_times_.empty());
 }
 
 void QuotaManager::GetUsageAndQuotaInternal(
@@ -1548,6 +1571,7 @@ void QuotaManager::DumpQuotaTable(const DumpQuotaTableCallback& callback) {
 
 void QuotaManager::DumpOriginInfoTable(
     const DumpOriginInfoTableCallback& callback) {
+  FlushModifiedTimes();
   make_scoped_refptr(new DumpOriginInfoTableTask(this, callback))->Start();
 }
 
@@ -1557,6 +1581,8 @@ void QuotaManager::DeleteOriginFromDatabase(
   LazyInitialize();
   if (db_disabled_)
     return;
+  // A modified time written after the delete would bring the origin back.
+  FlushModifiedTimes();
   scoped_refptr<DeleteOriginInfo> task =
       new DeleteOriginInfo(this, origin, type);
   task->Start();
@@ -1780,10 +1806,16 @@ void QuotaManagerProxy::NotifyStorageModified(
     StorageType type,
     int64 delta) {
   if (!io_thread_->BelongsToCurrentThread()) {
-    io_thread_->PostTask(
-        FROM_HERE,
-        base::Bind(&QuotaManagerProxy::NotifyStorageModified, this, client_id,
-                   origin, type, delta));
+    // Fold the deltas of writes made before the io thread gets around to
+    // them into one notification per client and origin.
+    base::AutoLock lock(pending_modifications_lock_);
+    if (pending_modifications_.empty()) {
+      io_thread_->PostTask(
+          FROM_HERE,
+          base::Bind(&QuotaManagerProxy::FlushPendingModifications, this));
+    }
+    pending_modifications_[
+        std::make_pair(client_id, std::make_pair(origin, type))] += delta;
     return;
   }
 
@@ -1791,6 +1823,22 @@ void QuotaManagerProxy::NotifyStorageModified(
     manager_->NotifyStorageModified(client_id, origin, type, delta);
 }
 
+void QuotaManagerProxy::FlushPendingModifications() {
+  DCHECK(io_thread_->BelongsToCurrentThread());
+  PendingModificationMap modifications;
+  {
+    base::AutoLock lock(pending_modifications_lock_);
+    modifications.swap(pending_modifications_);
+  }
+  if (!manager_)
+    return;
+  for (PendingModificationMap::const_iterator itr = modifications.begin();
+       itr != modifications.end(); ++itr) {
+    manager_->NotifyStorageModified(itr->first.first, itr->first.second.first,
+                                    itr->first.second.second, itr->second);
+  }
+}
+
 void QuotaManagerProxy::NotifyOriginInUse(
     const GURL& origin) {
   if (!io_thread_->BelongsToCurrentThread()) {
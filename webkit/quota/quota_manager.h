@@ -22,6 +22,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequenced_task_runner_helpers.h"
+#include "base/synchronization/lock.h"
 #include "webkit/quota/quota_database.h"
 #include "webkit/quota/quota_client.h"
 #include "webkit/quota/quota_task.h"
@@ -261,6 +262,7 @@ class QuotaManager : public QuotaTaskObserver,
   };
 
   typedef std::pair<std::string, StorageType> HostAndType;
+  typedef std::map<std::pair<GURL, StorageType>, base::Time> ModifiedTimeMap;
   typedef std::map<HostAndType, UsageAndQuotaDispatcherTask*>
       UsageAndQuotaDispatcherTaskMap;
 
@@ -297,6 +299,9 @@ class QuotaManager : public QuotaTaskObserver,
       int64 delta,
       base::Time modified_time);
 
+  // Writes the modified times recorded since the last flush to the database.
+  void FlushModifiedTimes();
+
   // |origin| can be empty if |global| is true.
   void GetUsageAndQuotaInternal(
       const GURL& origin,
@@ -359,6 +364,9 @@ class QuotaManager : public QuotaTaskObserver,
   GetLRUOriginCallback lru_origin_callback_;
   std::set<GURL> access_notified_origins_;
 
+  // Modified times not yet handed to the database.
+  ModifiedTimeMap pending_modified_times_;
+
   QuotaClientList clients_;
 
   scoped_ptr<UsageTracker> temporary_usage_tracker_;
@@ -421,9 +429,18 @@ class QuotaManagerProxy
   QuotaManagerProxy(QuotaManager* manager, base::MessageLoopProxy* io_thread);
   virtual ~QuotaManagerProxy();
 
+  // Delivers the modifications queued by calls made off the io thread.
+  void FlushPendingModifications();
+
   QuotaManager* manager_;  // only accessed on the io thread
   scoped_refptr<base::MessageLoopProxy> io_thread_;
 
+  typedef std::pair<QuotaClient::ID, std::pair<GURL, StorageType> >
+      ClientOriginAndType;
+  typedef std::map<ClientOriginAndType, int64> PendingModificationMap;
+  PendingModificationMap pending_modifications_;
+  base::Lock pending_modifications_lock_;
+
   DISALLOW_COPY_AND_ASSIGN(QuotaManagerProxy);
 };
 
@@ -15,6 +15,7 @@
 #include "base/scoped_temp_dir.h"
 #include "base/stl_util.h"
 #include "base/sys_info.h"
+#include "base/threading/thread.h"
 #include "base/time.h"
 #include "googleurl/src/gurl.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -1750,6 +1751,40 @@ TEST_F(QuotaManagerTest, GetOriginsModifiedSince) {
   EXPECT_EQ(modified_origins_type(), kTemp);
 }
 
+TEST_F(QuotaManagerTest, NotifyStorageModifiedFromOtherThread) {
+  static const MockOriginData kData[] = {
+    { "http://foo.com/", kTemp, 10 },
+  };
+  RegisterClient(CreateClient(kData, ARRAYSIZE_UNSAFE(kData),
+      QuotaClient::kFileSystem));
+
+  GetHostUsage("foo.com", kTemp);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(10, usage());
+
+  // The proxy folds these into a single notification on this thread.
+  base::Thread thread("QuotaManagerTestThread");
+  ASSERT_TRUE(thread.Start());
+  for (int i = 0; i < 10; ++i) {
+    thread.message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&QuotaManagerProxy::NotifyStorageModified,
+                   make_scoped_refptr(quota_manager()->proxy()),
+                   QuotaClient::kFileSystem, GURL("http://foo.com/"),
+                   kTemp, 1));
+  }
+  thread.Stop();
+  MessageLoop::current()->RunAllPending();
+
+  GetHostUsage("foo.com", kTemp);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(20, usage());
+
+  GetOriginsModifiedSince(kTemp, base::Time());
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(1U, modified_origins().count(GURL("http://foo.com/")));
+}
+
 TEST_F(QuotaManagerTest, DumpQuotaTable) {
   SetPersistentHostQuota("example1.com", 1);
   SetPersistentHostQuota("example2.com", 20);